@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+#include "../src/modules/cad/constraint_solver.hpp"
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace qcs::cad;
+
+namespace {
+
+// A row of N rectangles, each sharing its left edge's corners with its
+// neighbour's right edge, drawn slightly skewed the way sketches are before
+// the solver squares them: per rectangle two horizontal, two vertical and
+// two dimension constraints, all one connected cluster
+struct RectangleSketch {
+    ConstraintSolver solver;
+    std::vector<std::pair<VariableID, Precision>> initial;
+
+    explicit RectangleSketch(int rectangles) {
+        ConstraintSystem& system = *solver.get_system();
+        VariableManager& manager = system.get_variable_manager();
+
+        auto point = [&](Precision x, Precision y) {
+            const VariableID px = manager.create_variable("x", x);
+            const VariableID py = manager.create_variable("y", y);
+            initial.emplace_back(px, x);
+            initial.emplace_back(py, y);
+            return std::make_pair(px, py);
+        };
+
+        size_t id = 0;
+        auto bottomLeft = point(0.0, 0.0), topLeft = point(0.1, 1.9);
+        manager.get_variable(bottomLeft.first)->set_fixed(true);
+        manager.get_variable(bottomLeft.second)->set_fixed(true);
+        for (int i = 0; i < rectangles; ++i) {
+            const Precision x = 3.0 * (i + 1);
+            const auto bottomRight = point(x + 0.2, 0.15 * (i % 3));
+            const auto topRight = point(x - 0.1, 2.1 - 0.1 * (i % 2));
+
+            system.add_constraint(std::make_unique<HorizontalConstraint>(id++, bottomLeft.second, bottomRight.second));
+            system.add_constraint(std::make_unique<HorizontalConstraint>(id++, topLeft.second, topRight.second));
+            system.add_constraint(std::make_unique<VerticalConstraint>(id++, bottomRight.first, topRight.first));
+            if (i == 0) {
+                system.add_constraint(std::make_unique<VerticalConstraint>(id++, bottomLeft.first, topLeft.first));
+                system.add_constraint(std::make_unique<DistanceConstraint>(
+                    id++, bottomLeft.first, bottomLeft.second, topLeft.first, topLeft.second, 2.0));
+            }
+            system.add_constraint(std::make_unique<DistanceConstraint>(
+                id++, bottomLeft.first, bottomLeft.second, bottomRight.first, bottomRight.second, 3.0));
+
+            bottomLeft = bottomRight;
+            topLeft = topRight;
+        }
+    }
+
+    void reset() {
+        VariableManager& manager = solver.get_system()->get_variable_manager();
+        for (const auto& [id, value] : initial) {
+            manager.set_value(id, value);
+        }
+    }
+};
+
+// Cold solve of the whole sketch from its drawn positions, per rectangle count
+void BM_SolveSketch(benchmark::State& state) {
+    RectangleSketch sketch(static_cast<int>(state.range(0)));
+    ConstraintSystem& system = *sketch.solver.get_system();
+
+    int64_t converged = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        sketch.reset();
+        state.ResumeTiming();
+
+        const SolverStatus status = system.solve();
+        converged += status == SolverStatus::Success || status == SolverStatus::Converged;
+        benchmark::DoNotOptimize(status);
+    }
+
+    state.counters["converged"] = benchmark::Counter(static_cast<double>(converged),
+                                                     benchmark::Counter::kAvgIterations);
+}
+
+} // namespace
+
+BENCHMARK(BM_SolveSketch)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "../src/modules/raster/raster_image.hpp"
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+
+// Synthetic documents shared by the end-to-end benchmarks. Everything is
+// generated from fixed seeds, so every run and every machine measures the
+// same work and results stay comparable with the stored baseline.
+namespace QuantumCanvas::Benchmarks {
+
+// 16:9 canvases by width: 1K, 2K, 4K and 8K
+inline uint32_t heightFor(uint32_t width) {
+    return width / 16 * 9;
+}
+
+// Smooth gradients with soft blobs on top, so blurs, sharpening and the
+// codecs see image-like content rather than noise or flat colour
+inline Raster::Image makePainting(uint32_t width, uint32_t height, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    struct Blob {
+        float x, y, radius;
+        Raster::Image::Pixel color;
+    };
+    Blob blobs[8];
+    for (Blob& blob : blobs) {
+        blob = {unit(rng) * width, unit(rng) * height, (0.05f + 0.2f * unit(rng)) * height,
+                {unit(rng), unit(rng), unit(rng), 1.0f}};
+    }
+
+    Raster::Image image(width, height);
+    for (uint32_t y = 0; y < height; ++y) {
+        const float v = float(y) / float(height);
+        for (uint32_t x = 0; x < width; ++x) {
+            const float u = float(x) / float(width);
+            Raster::Image::Pixel pixel = {0.2f + 0.6f * u, 0.3f + 0.4f * v, 0.8f - 0.5f * u * v, 1.0f};
+            for (const Blob& blob : blobs) {
+                const float dx = float(x) - blob.x, dy = float(y) - blob.y;
+                const float weight = std::exp(-(dx * dx + dy * dy) / (blob.radius * blob.radius));
+                for (int c = 0; c < 3; ++c) {
+                    pixel[c] += (blob.color[c] - pixel[c]) * weight;
+                }
+            }
+            image.setPixel(x, y, pixel);
+        }
+    }
+    return image;
+}
+
+// A layer of a layered document: a translucent shape over part of the
+// canvas, the rest left transparent, as strokes and placed images are
+inline Raster::Image makeLayer(uint32_t width, uint32_t height, uint32_t index) {
+    std::mt19937 rng(index + 1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    const uint32_t shapeWidth = width / 3, shapeHeight = height / 3;
+    const uint32_t left = uint32_t(unit(rng) * float(width - shapeWidth));
+    const uint32_t top = uint32_t(unit(rng) * float(height - shapeHeight));
+    const Raster::Image::Pixel color = {unit(rng), unit(rng), unit(rng), 1.0f};
+
+    Raster::Image layer(width, height);
+    for (uint32_t y = top; y < top + shapeHeight; ++y) {
+        for (uint32_t x = left; x < left + shapeWidth; ++x) {
+            const float alpha = 0.3f + 0.6f * float(x - left) / float(shapeWidth);
+            layer.setPixel(x, y, {color[0] * alpha, color[1] * alpha, color[2] * alpha, alpha});
+        }
+    }
+    return layer;
+}
+
+// Random cubic outlines, the bulk of what illustrations are made of
+inline std::string makePathData(std::mt19937& rng, int segments) {
+    std::uniform_real_distribution<float> coordinate(0.0f, 1000.0f);
+    std::ostringstream d;
+    d << "M" << coordinate(rng) << "," << coordinate(rng);
+    for (int i = 0; i < segments; ++i) {
+        d << " C" << coordinate(rng) << "," << coordinate(rng) << " " << coordinate(rng) << ","
+          << coordinate(rng) << " " << coordinate(rng) << "," << coordinate(rng);
+    }
+    d << " Z";
+    return d.str();
+}
+
+// An illustration: paths of eight curves each, styled and grouped by tens
+inline std::string makeSVGDocument(int pathCount) {
+    std::mt19937 rng(7);
+    std::ostringstream svg;
+    svg << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"1000\" height=\"1000\" viewBox=\"0 0 1000 1000\">\n";
+    for (int i = 0; i < pathCount; ++i) {
+        if (i % 10 == 0) {
+            svg << (i ? "</g>\n" : "") << "<g id=\"group" << i / 10 << "\" opacity=\"0.9\">\n";
+        }
+        svg << "<path d=\"" << makePathData(rng, 8) << "\" fill=\"#" << std::hex << (rng() & 0xFFFFFF)
+            << std::dec << "\" stroke=\"#000\" stroke-width=\"1.5\"/>\n";
+    }
+    svg << (pathCount ? "</g>\n" : "") << "</svg>\n";
+    return svg.str();
+}
+
+// A floor plan's worth of ASCII DXF: lines, arcs, closed polylines and
+// text spread over a few layers, after a small header and tables section
+inline std::string makeDXFDrawing(int entityCount) {
+    std::ostringstream dxf;
+    auto group = [&dxf](int code, const auto& value) { dxf << code << "\n" << value << "\n"; };
+
+    group(0, "SECTION"); group(2, "HEADER");
+    group(9, "$ACADVER"); group(1, "AC1027");
+    group(9, "$INSUNITS"); group(70, 6);
+    group(0, "ENDSEC");
+    group(0, "SECTION"); group(2, "TABLES");
+    group(0, "TABLE"); group(2, "LAYER"); group(70, 4);
+    const char* layers[] = {"Walls", "Doors", "Furniture", "Notes"};
+    for (const char* layer : layers) {
+        group(0, "LAYER"); group(2, layer); group(70, 0); group(62, 7); group(6, "CONTINUOUS");
+    }
+    group(0, "ENDTAB");
+    group(0, "ENDSEC");
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> coordinate(0.0f, 10000.0f);
+    group(0, "SECTION"); group(2, "ENTITIES");
+    for (int i = 0; i < entityCount; ++i) {
+        std::ostringstream handle;
+        handle << std::hex << std::uppercase << i + 0x100;
+        const char* layer = layers[i % 4];
+        switch (i % 5) {
+        case 0:
+        case 1:
+            group(0, "LINE"); group(5, handle.str()); group(8, layer);
+            group(10, coordinate(rng)); group(20, coordinate(rng)); group(11, coordinate(rng)); group(21, coordinate(rng));
+            break;
+        case 2:
+            group(0, "ARC"); group(5, handle.str()); group(8, layer);
+            group(10, coordinate(rng)); group(20, coordinate(rng)); group(40, 50.0f);
+            group(50, 0.0f); group(51, 90.0f);
+            break;
+        case 3:
+            group(0, "LWPOLYLINE"); group(5, handle.str()); group(8, layer); group(90, 4); group(70, 1);
+            for (int v = 0; v < 4; ++v) {
+                group(10, coordinate(rng)); group(20, coordinate(rng));
+            }
+            break;
+        default:
+            group(0, "TEXT"); group(5, handle.str()); group(8, layer);
+            group(10, coordinate(rng)); group(20, coordinate(rng)); group(40, 2.5f); group(1, "Room " + handle.str());
+            break;
+        }
+    }
+    group(0, "ENDSEC");
+    group(0, "EOF");
+    return dxf.str();
+}
+
+} // namespace QuantumCanvas::Benchmarks
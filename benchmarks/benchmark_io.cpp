@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+#include "benchmark_data.hpp"
+#include "../src/modules/io/dxf_stream_reader.hpp"
+#include "../src/modules/io/parallel_encoders.hpp"
+#include "../src/modules/io/svg_stream_parser.hpp"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace QuantumCanvas;
+using namespace QuantumCanvas::Benchmarks;
+
+namespace {
+
+// Load of a drawing of N entities: header and tables, then the entities
+// parsed in chunks on the kernel's scheduler and handed over in batches
+void BM_LoadDXF(benchmark::State& state) {
+    const std::string text = makeDXFDrawing(static_cast<int>(state.range(0)));
+    IO::DXFStreamReader reader;
+
+    size_t entities = 0;
+    for (auto _ : state) {
+        std::istringstream input(text);
+        const auto result = reader.read(
+            input, [](const IO::DWGDrawingTables&) {}, [](IO::DWGEntityBatch&&) { return true; }, {});
+        entities = result.entityCount;
+    }
+
+    state.counters["entities"] = benchmark::Counter(static_cast<double>(entities));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+// Parse of an illustration of N paths into the element store
+void BM_LoadSVG(benchmark::State& state) {
+    const std::string text = makeSVGDocument(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        const IO::SVGElementStore svg = IO::SVGElementStore::parseText(text);
+        benchmark::DoNotOptimize(svg.stats().pathCount);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+enum class Codec { PNG, JPEG, TIFF };
+
+// Export of a 4K painting through each banded encoder
+void BM_Encode(benchmark::State& state, Codec codec) {
+    const Raster::Image image = makePainting(3840, 2160, 1);
+    IO::ParallelEncodeSettings settings;
+
+    size_t encodedSize = 0;
+    for (auto _ : state) {
+        std::vector<uint8_t> encoded;
+        switch (codec) {
+        case Codec::PNG:
+            encoded = IO::ParallelEncoders::encodePNG(image, settings);
+            break;
+        case Codec::JPEG:
+            encoded = IO::ParallelEncoders::encodeJPEG(image, settings);
+            break;
+        case Codec::TIFF:
+            encoded = IO::ParallelEncoders::encodeTIFF(image, settings);
+            break;
+        }
+        encodedSize = encoded.size();
+        benchmark::DoNotOptimize(encoded.data());
+    }
+
+    state.counters["ratio"] = benchmark::Counter(static_cast<double>(image.width() * image.height() * 4) /
+                                                 static_cast<double>(encodedSize));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * image.width() * image.height());
+}
+
+} // namespace
+
+BENCHMARK(BM_LoadDXF)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_LoadSVG)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Encode, PNG, Codec::PNG)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Encode, JPEG, Codec::JPEG)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Encode, TIFF, Codec::TIFF)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,46 @@
+#include <benchmark/benchmark.h>
+#include "../src/core/kernel/telemetry.hpp"
+
+using namespace QuantumCanvas::Core;
+
+namespace {
+
+// What an always-on counter costs the code it counts, per thread count
+void BM_CounterAdd(benchmark::State& state) {
+    static const Counter counter = Telemetry::instance().counter("benchmark.counter");
+    for (auto _ : state) {
+        counter.add();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// A span around an empty scope, with and without a trace capture running
+void BM_TraceSpan(benchmark::State& state) {
+    const bool capture = state.range(0) != 0;
+    if (capture && state.thread_index() == 0) {
+        Telemetry::instance().start_capture(4096);
+    }
+
+    for (auto _ : state) {
+        QCS_TRACE_SCOPE("benchmark.span");
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (capture && state.thread_index() == 0) {
+        benchmark::DoNotOptimize(Telemetry::instance().stop_capture().events.size());
+    }
+}
+
+// Summing every slab and running the module sources, as an exporter does
+void BM_Snapshot(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Telemetry::instance().snapshot().counters.size());
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_CounterAdd)->ThreadRange(1, 8);
+BENCHMARK(BM_TraceSpan)->Arg(0)->Arg(1)->ThreadRange(1, 8);
+BENCHMARK(BM_Snapshot)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include "benchmark_data.hpp"
+#include "../src/modules/io/svg_stream_parser.hpp"
+#include "../src/modules/vector/spatial_index.hpp"
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace QuantumCanvas;
+using namespace QuantumCanvas::Benchmarks;
+using Vector::SpatialIndex;
+
+namespace {
+
+std::vector<std::string> makePaths(size_t count) {
+    std::mt19937 rng(5);
+    std::vector<std::string> paths;
+    paths.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        paths.push_back(makePathData(rng, 8));
+    }
+    return paths;
+}
+
+// Objects of a document scattered over a 100k square, most small, as the
+// shapes of a large illustration or map are
+std::vector<std::pair<SpatialIndex::Key, SpatialIndex::Bounds>> makeObjects(size_t count,
+                                                                            std::vector<char>& storage) {
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> position(0.0f, 100000.0f);
+    std::exponential_distribution<float> extent(1.0f / 200.0f);
+
+    storage.assign(count, 0);
+    std::vector<std::pair<SpatialIndex::Key, SpatialIndex::Bounds>> objects;
+    objects.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const float x = position(rng), y = position(rng);
+        objects.emplace_back(reinterpret_cast<SpatialIndex::Key>(&storage[i]),
+                             SpatialIndex::Bounds{x, y, x + extent(rng), y + extent(rng)});
+    }
+    return objects;
+}
+
+// Path data decoded into the flat verb and point arrays, per path count
+void BM_DecodePaths(benchmark::State& state) {
+    const std::vector<std::string> paths = makePaths(static_cast<size_t>(state.range(0)));
+    size_t bytes = 0;
+    for (const std::string& path : paths) {
+        bytes += path.size();
+    }
+
+    for (auto _ : state) {
+        IO::SVGPathStore store;
+        for (const std::string& path : paths) {
+            store.addPathData(path);
+        }
+        benchmark::DoNotOptimize(store.points().data());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+
+// Bulk build of the culling index as a document opens
+void BM_BuildSpatialIndex(benchmark::State& state) {
+    std::vector<char> storage;
+    const auto objects = makeObjects(static_cast<size_t>(state.range(0)), storage);
+
+    for (auto _ : state) {
+        SpatialIndex index;
+        index.build(objects);
+        benchmark::DoNotOptimize(index.height());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+// View culling while panning a screen-sized viewport across the document
+void BM_CullViewport(benchmark::State& state) {
+    std::vector<char> storage;
+    SpatialIndex index;
+    index.build(makeObjects(static_cast<size_t>(state.range(0)), storage));
+
+    std::vector<SpatialIndex::Key> visible;
+    int64_t frame = 0, found = 0;
+    for (auto _ : state) {
+        const float x = static_cast<float>((frame * 997) % 96000);
+        const float y = static_cast<float>((frame * 613) % 97000);
+        ++frame;
+        visible.clear();
+        index.query({x, y, x + 4000.0f, y + 2250.0f}, visible);
+        found += static_cast<int64_t>(visible.size());
+        benchmark::DoNotOptimize(visible.data());
+    }
+
+    state.counters["visible"] = benchmark::Counter(static_cast<double>(found) / static_cast<double>(frame));
+}
+
+} // namespace
+
+BENCHMARK(BM_DecodePaths)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BuildSpatialIndex)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CullViewport)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""Regression gate for the end-to-end benchmark suite.
+
+Compares a Google Benchmark JSON report against a stored baseline from the
+same machine and fails when any benchmark got slower by more than the
+threshold. Medians are compared when the runs were repeated, otherwise the
+single measurement; benchmarks missing from either side are reported but do
+not fail the gate.
+
+    compare_baseline.py RESULTS BASELINE [--threshold 0.10] [--run SUITE]
+
+With --run, the suite is run first and writes RESULTS itself.
+
+Exit codes: 0 within threshold, 1 regression, 2 bad input or a failed run,
+3 no baseline recorded yet.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+TIME_UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load_times(path):
+    """Real time in nanoseconds per benchmark name."""
+    with open(path, encoding="utf-8") as report:
+        benchmarks = json.load(report).get("benchmarks", [])
+
+    medians = {}
+    singles = {}
+    for entry in benchmarks:
+        if "error_occurred" in entry and entry["error_occurred"]:
+            continue
+        time = entry["real_time"] * TIME_UNITS[entry.get("time_unit", "ns")]
+        if entry.get("run_type") == "aggregate":
+            if entry.get("aggregate_name") == "median":
+                medians[entry["run_name"]] = time
+        else:
+            singles[entry.get("run_name", entry["name"])] = time
+
+    # With repetitions there are several single runs per name; the median
+    # aggregate stands for them all
+    return {**singles, **medians}
+
+
+def format_time(nanoseconds):
+    for unit in ("s", "ms", "us"):
+        if nanoseconds >= TIME_UNITS[unit]:
+            return f"{nanoseconds / TIME_UNITS[unit]:10.3f} {unit:<2}"
+    return f"{nanoseconds:10.3f} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("results")
+    parser.add_argument("baseline")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="allowed slowdown as a fraction (default 0.10)")
+    parser.add_argument("--run", metavar="SUITE",
+                        help="benchmark executable to run into RESULTS first")
+    parser.add_argument("--repetitions", type=int, default=5,
+                        help="repetitions per benchmark with --run (default 5)")
+    args = parser.parse_args()
+
+    if not os.path.exists(args.baseline):
+        print(f"No baseline at {args.baseline}; record one with the "
+              f"benchmark_update_baseline target", file=sys.stderr)
+        return 3
+
+    if args.run:
+        command = [args.run, f"--benchmark_out={args.results}", "--benchmark_out_format=json",
+                   f"--benchmark_repetitions={args.repetitions}",
+                   "--benchmark_report_aggregates_only=true"]
+        if subprocess.call(command) != 0:
+            print(f"Benchmark suite failed: {args.run}", file=sys.stderr)
+            return 2
+
+    try:
+        results = load_times(args.results)
+        baseline = load_times(args.baseline)
+    except (OSError, ValueError, KeyError) as error:
+        print(f"Cannot read benchmark report: {error}", file=sys.stderr)
+        return 2
+
+    regressions = []
+    width = max((len(name) for name in results), default=0)
+    for name, time in sorted(results.items()):
+        if name not in baseline:
+            print(f"{name:<{width}}  new, no baseline")
+            continue
+        change = time / baseline[name] - 1.0
+        verdict = "REGRESSION" if change > args.threshold else "ok"
+        print(f"{name:<{width}}  {format_time(baseline[name])} -> {format_time(time)}  "
+              f"{change:+8.1%}  {verdict}")
+        if change > args.threshold:
+            regressions.append(name)
+
+    for name in sorted(set(baseline) - set(results)):
+        print(f"{name:<{width}}  missing from results")
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) slower than the baseline by more than "
+              f"{args.threshold:.0%}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace QuantumCanvas::Core {
+
+// Bounded lock-free multi-producer / single-consumer queue of polymorphic events.
+// Event types that fit in InlineSize bytes are constructed directly in the slot;
+// larger ones are published as heap pointers. Based on Vyukov's bounded queue:
+// each slot carries a sequence number, so producers only contend on one CAS.
+template<typename Event, size_t InlineSize = 96>
+class BoundedEventQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t INLINE_SIZE = InlineSize;
+
+    template<typename T>
+    static constexpr bool fits_inline = sizeof(T) <= InlineSize &&
+                                        alignof(T) <= alignof(std::max_align_t);
+
+    explicit BoundedEventQueue(size_t capacity = 4096) {
+        size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        mask_ = rounded - 1;
+        slots_ = std::make_unique<Slot[]>(rounded);
+        for (size_t i = 0; i < rounded; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~BoundedEventQueue() {
+        consume([](const Event&, Clock::time_point) {}, capacity());
+    }
+
+    BoundedEventQueue(const BoundedEventQueue&) = delete;
+    BoundedEventQueue& operator=(const BoundedEventQueue&) = delete;
+
+    // Construct T in place; returns false if the queue is full
+    template<typename T, typename... Args>
+    bool try_emplace(Args&&... args) {
+        static_assert(std::is_base_of_v<Event, T>, "T must derive from the queue's event type");
+
+        size_t pos;
+        Slot* slot = claim(pos);
+        if (!slot) {
+            return false;
+        }
+
+        if constexpr (fits_inline<T>) {
+            slot->event = new(slot->storage) T(std::forward<Args>(args)...);
+            slot->heap = false;
+        } else {
+            slot->event = new T(std::forward<Args>(args)...);
+            slot->heap = true;
+        }
+        publish(slot, pos);
+        return true;
+    }
+
+    // Takes ownership on success; on failure the event is left with the caller
+    bool try_push(std::unique_ptr<Event>& event) {
+        size_t pos;
+        Slot* slot = claim(pos);
+        if (!slot) {
+            return false;
+        }
+
+        slot->event = event.release();
+        slot->heap = true;
+        publish(slot, pos);
+        return true;
+    }
+
+    // Single consumer only. fn(event, enqueue_time) runs while the event is still
+    // in its slot; the event is destroyed right after. Returns events consumed.
+    template<typename Fn>
+    size_t consume(Fn&& fn, size_t max_events) {
+        size_t consumed = 0;
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+
+        while (consumed < max_events) {
+            Slot& slot = slots_[pos & mask_];
+            if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+                break; // Empty, or the producer of this slot hasn't finished
+            }
+
+            fn(*slot.event, slot.enqueued);
+
+            if (slot.heap) {
+                delete slot.event;
+            } else {
+                slot.event->~Event();
+            }
+            slot.event = nullptr;
+
+            slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+            ++pos;
+            ++consumed;
+        }
+
+        dequeue_pos_.store(pos, std::memory_order_relaxed);
+        return consumed;
+    }
+
+    size_t size_approx() const {
+        size_t enqueued = enqueue_pos_.load(std::memory_order_relaxed);
+        size_t dequeued = dequeue_pos_.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<size_t> sequence{0};
+        Event* event = nullptr;
+        bool heap = false;
+        Clock::time_point enqueued;
+        alignas(std::max_align_t) unsigned char storage[InlineSize];
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<size_t> dequeue_pos_{0};
+
+    Slot* claim(size_t& pos) {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    return &slot;
+                }
+            } else if (diff < 0) {
+                return nullptr; // Full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void publish(Slot* slot, size_t pos) {
+        slot->enqueued = Clock::now();
+        slot->sequence.store(pos + 1, std::memory_order_release);
+    }
+};
+
+} // namespace QuantumCanvas::Core
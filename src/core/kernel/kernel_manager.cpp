@@ -10,12 +10,15 @@
  */
 
 #include "kernel_manager.hpp"
+#include "task_scheduler.hpp"
 #include "../memory/memory_manager.hpp"
 #include "../resources/resource_manager.hpp"
 #include "../events/event.hpp"
 #include <filesystem>
 #include <algorithm>
 #include <iostream>
+#include <climits>
+#include <cstdint>
 
 #ifdef _WIN32
     #include <windows.h>
@@ -36,7 +39,8 @@ KernelManager& KernelManager::instance() {
 }
 
 KernelManager::KernelManager() 
-    : start_time_(std::chrono::system_clock::now()) {
+    : dispatch_table_(std::make_shared<DispatchTable>())
+    , start_time_(std::chrono::system_clock::now()) {
 }
 
 KernelManager::~KernelManager() {
@@ -57,6 +61,7 @@ bool KernelManager::initialize() {
         
         // Initialize core services
         initialize_core_services();
+        register_telemetry();
         
         is_initialized_ = true;
         is_running_ = true;
@@ -114,8 +119,10 @@ bool KernelManager::is_running() const {
 }
 
 void KernelManager::initialize_core_services() {
-    // Core services initialization happens here
-    // This will be expanded as services are implemented
+    // Shared worker pool; modules submit work here instead of spawning threads
+    if (!has_service<TaskScheduler>()) {
+        register_service(std::make_shared<TaskScheduler>());
+    }
 }
 
 void KernelManager::shutdown_all_services() {
@@ -139,11 +146,23 @@ void KernelManager::shutdown_all_services() {
 }
 
 void KernelManager::cleanup_resources() {
+    // Waits out a snapshot still reading the managers
+    telemetry_source_.reset();
+    
     // Clean up event handlers
     {
         std::lock_guard<std::mutex> lock(events_mutex_);
         event_handlers_.clear();
-        event_queue_.clear();
+        rebuild_dispatch_table();
+        overflow_events_.clear();
+        has_overflow_ = false;
+    }
+    
+    // Drop anything still queued
+    {
+        std::lock_guard<std::mutex> lock(consumer_mutex_);
+        event_queue_.consume([](const IEvent&, EventQueue::Clock::time_point) {},
+                             event_queue_.capacity());
     }
     
     // Clean up managers
@@ -255,8 +274,18 @@ void KernelManager::publish_event(std::unique_ptr<IEvent> event) {
         return;
     }
     
+    // Once events overflow, later ones queue behind them until they are drained
+    if (has_overflow_.load(std::memory_order_acquire) || !event_queue_.try_push(event)) {
+        push_overflow_event(std::move(event));
+    }
+}
+
+void KernelManager::push_overflow_event(std::unique_ptr<IEvent> event) {
+    // Ring is full - keep the event rather than drop it, at the cost of a lock
     std::lock_guard<std::mutex> lock(events_mutex_);
-    event_queue_.push_back(std::move(event));
+    overflow_events_.push_back(std::move(event));
+    has_overflow_.store(true, std::memory_order_release);
+    events_overflowed_.fetch_add(1, std::memory_order_relaxed);
 }
 
 void KernelManager::subscribe(EventType type, IEventHandler* handler) {
@@ -270,10 +299,12 @@ void KernelManager::subscribe(EventType type, IEventHandler* handler) {
     event_handlers_[type].push_back(subscription);
     
     // Sort by priority
-    std::sort(event_handlers_[type].begin(), event_handlers_[type].end(),
-              [](const EventSubscription& a, const EventSubscription& b) {
-                  return a.priority > b.priority;
-              });
+    std::stable_sort(event_handlers_[type].begin(), event_handlers_[type].end(),
+                     [](const EventSubscription& a, const EventSubscription& b) {
+                         return a.priority > b.priority;
+                     });
+    
+    rebuild_dispatch_table();
 }
 
 void KernelManager::unsubscribe(EventType type, IEventHandler* handler) {
@@ -293,33 +324,102 @@ void KernelManager::unsubscribe(EventType type, IEventHandler* handler) {
                           }),
             handlers.end()
         );
+        if (handlers.empty()) {
+            event_handlers_.erase(it);
+        }
     }
+    
+    rebuild_dispatch_table();
+}
+
+void KernelManager::rebuild_dispatch_table() {
+    auto table = std::make_shared<DispatchTable>();
+    
+    for (const auto& [type, subscriptions] : event_handlers_) {
+        std::vector<IEventHandler*> handlers;
+        handlers.reserve(subscriptions.size());
+        for (const auto& subscription : subscriptions) {
+            if (subscription.handler && subscription.handler->can_handle(type)) {
+                handlers.push_back(subscription.handler);
+            }
+        }
+        if (handlers.empty()) {
+            continue;
+        }
+        
+        if (type < DispatchTable::DIRECT_TYPES) {
+            table->direct[type] = std::move(handlers);
+        } else {
+            table->sparse[type] = std::move(handlers);
+        }
+    }
+    
+    dispatch_table_ = std::move(table);
 }
 
 void KernelManager::process_events() {
-    std::vector<std::unique_ptr<IEvent>> events_to_process;
+    std::lock_guard<std::mutex> consumer_lock(consumer_mutex_);
     
+    // One snapshot per batch; handlers may (un)subscribe while we dispatch and
+    // the change takes effect from the next batch
+    std::shared_ptr<const DispatchTable> table;
     {
         std::lock_guard<std::mutex> lock(events_mutex_);
-        events_to_process = std::move(event_queue_);
-        event_queue_.clear();
+        table = dispatch_table_;
     }
     
-    for (const auto& event : events_to_process) {
-        if (!event) continue;
-        
-        EventType type = event->type();
-        
+    // Every overflowed event is newer than what the ring held when it began
+    // to overflow, and nothing enters the ring again until it is drained. So
+    // taking the overflow with the ring depth at that moment, then dispatching
+    // those ring events before it, keeps publish order.
+    std::vector<std::unique_ptr<IEvent>> overflow;
+    size_t depth = 0;
+    if (has_overflow_.load(std::memory_order_acquire)) {
         std::lock_guard<std::mutex> lock(events_mutex_);
-        auto it = event_handlers_.find(type);
-        if (it != event_handlers_.end()) {
-            for (const auto& subscription : it->second) {
-                if (subscription.handler && subscription.handler->can_handle(type)) {
-                    subscription.handler->handle_event(*event);
-                }
-            }
+        overflow.swap(overflow_events_);
+        depth = event_queue_.size_approx();
+        has_overflow_ = false;
+    } else {
+        depth = event_queue_.size_approx();
+    }
+    
+    // Bound the batch so events published by handlers wait for the next call
+    record_queue_depth(depth + overflow.size());
+    
+    event_queue_.consume([this, &table](const IEvent& event, EventQueue::Clock::time_point enqueued) {
+        dispatch_event(table.get(), event);
+        
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            EventQueue::Clock::now() - enqueued
+        ).count();
+        uint64_t sample = latency_sample_count_.fetch_add(1, std::memory_order_relaxed);
+        latency_samples_us_[sample % EVENT_SAMPLE_COUNT].store(
+            static_cast<uint32_t>(std::min<int64_t>(latency, UINT32_MAX)), std::memory_order_relaxed);
+    }, depth);
+    
+    for (const auto& event : overflow) {
+        dispatch_event(table.get(), *event);
+    }
+}
+
+void KernelManager::dispatch_event(const DispatchTable* table, const IEvent& event) {
+    if (const auto* handlers = table->find(event.type())) {
+        for (IEventHandler* handler : *handlers) {
+            handler->handle_event(event);
         }
     }
+    events_dispatched_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void KernelManager::record_queue_depth(size_t depth) {
+    uint64_t sample = depth_sample_count_.fetch_add(1, std::memory_order_relaxed);
+    depth_samples_[sample % EVENT_SAMPLE_COUNT].store(
+        static_cast<uint32_t>(std::min<size_t>(depth, UINT32_MAX)), std::memory_order_relaxed);
+    
+    size_t peak = peak_queue_depth_.load(std::memory_order_relaxed);
+    while (depth > peak &&
+           !peak_queue_depth_.compare_exchange_weak(peak, depth, std::memory_order_relaxed)) {
+    }
 }
 
 IMemoryManager& KernelManager::memory_manager() {
@@ -356,11 +456,45 @@ KernelManager::PerformanceStats KernelManager::get_performance_stats() const {
         stats.plugin_count = plugins_.size();
     }
     
-    // Event queue size
+    // Event queue size and health
     {
         std::lock_guard<std::mutex> lock(events_mutex_);
-        stats.event_queue_size = event_queue_.size();
-    }
+        stats.event_queue_size = event_queue_.size_approx() + overflow_events_.size();
+    }
+    stats.event_queue_capacity = event_queue_.capacity();
+    stats.event_queue_peak_depth = peak_queue_depth_.load(std::memory_order_relaxed);
+    stats.events_dispatched = events_dispatched_.load(std::memory_order_relaxed);
+    stats.events_overflowed = events_overflowed_.load(std::memory_order_relaxed);
+    
+    auto percentiles = [](const std::array<std::atomic<uint32_t>, EVENT_SAMPLE_COUNT>& ring,
+                          uint64_t total) -> std::array<uint32_t, 3> {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(total, EVENT_SAMPLE_COUNT));
+        if (count == 0) {
+            return {0, 0, 0};
+        }
+        std::vector<uint32_t> samples(count);
+        for (size_t i = 0; i < count; ++i) {
+            samples[i] = ring[i].load(std::memory_order_relaxed);
+        }
+        std::array<uint32_t, 3> result{};
+        const double ranks[] = {0.50, 0.95, 0.99};
+        for (size_t i = 0; i < 3; ++i) {
+            auto nth = samples.begin() + static_cast<size_t>(ranks[i] * (count - 1));
+            std::nth_element(samples.begin(), nth, samples.end());
+            result[i] = *nth;
+        }
+        return result;
+    };
+    
+    auto depth = percentiles(depth_samples_, depth_sample_count_.load(std::memory_order_relaxed));
+    stats.event_queue_depth_p50 = depth[0];
+    stats.event_queue_depth_p95 = depth[1];
+    stats.event_queue_depth_p99 = depth[2];
+    
+    auto latency = percentiles(latency_samples_us_, latency_sample_count_.load(std::memory_order_relaxed));
+    stats.event_latency_p50 = std::chrono::microseconds(latency[0]);
+    stats.event_latency_p95 = std::chrono::microseconds(latency[1]);
+    stats.event_latency_p99 = std::chrono::microseconds(latency[2]);
     
     // Calculate uptime
     auto now = std::chrono::system_clock::now();
@@ -390,6 +524,48 @@ KernelManager::PerformanceStats KernelManager::get_performance_stats() const {
     return stats;
 }
 
+TelemetrySnapshot KernelManager::snapshot_telemetry() const {
+    return Telemetry::instance().snapshot();
+}
+
+void KernelManager::register_telemetry() {
+    telemetry_source_ = Telemetry::instance().add_source("kernel", [this](MetricWriter& writer) {
+        const PerformanceStats stats = get_performance_stats();
+        writer.gauge("services", static_cast<double>(stats.service_count));
+        writer.gauge("plugins", static_cast<double>(stats.plugin_count));
+        writer.gauge("uptime_ms", static_cast<double>(stats.uptime.count()));
+        writer.gauge("resident_bytes", static_cast<double>(stats.total_memory_usage));
+        writer.gauge("event_queue.depth", static_cast<double>(stats.event_queue_size));
+        writer.gauge("event_queue.peak_depth", static_cast<double>(stats.event_queue_peak_depth));
+        writer.gauge("event_queue.latency_p99_us", static_cast<double>(stats.event_latency_p99.count()));
+        writer.counter("events.dispatched", stats.events_dispatched);
+        writer.counter("events.overflowed", stats.events_overflowed);
+        
+        if (memory_manager_) {
+            const MemoryStats memory = memory_manager_->get_stats();
+            writer.counter("memory.allocations", memory.allocation_count);
+            writer.counter("memory.deallocations", memory.deallocation_count);
+            writer.counter("memory.pool_hits", memory.pool_hits);
+            writer.counter("memory.pool_misses", memory.pool_misses);
+            writer.counter("memory.size_class_hits", memory.size_class_hits);
+            writer.gauge("memory.current_bytes", static_cast<double>(memory.current_usage));
+            writer.gauge("memory.peak_bytes", static_cast<double>(memory.peak_usage));
+            writer.gauge("memory.huge_page_coverage", memory.huge_page_coverage());
+        }
+        
+        if (auto scheduler = get_service<TaskScheduler>()) {
+            const TaskScheduler::Stats tasks = scheduler->get_stats();
+            writer.counter("scheduler.submitted", tasks.tasks_submitted);
+            writer.counter("scheduler.executed", tasks.tasks_executed);
+            writer.counter("scheduler.stolen", tasks.tasks_stolen);
+            writer.counter("scheduler.interactive_executed", tasks.interactive_executed);
+            writer.counter("scheduler.background_executed", tasks.background_executed);
+            writer.gauge("scheduler.queued", static_cast<double>(tasks.tasks_queued));
+            writer.gauge("scheduler.workers", tasks.worker_count);
+        }
+    });
+}
+
 void KernelManager::notify_service_registered(const ServiceId& id) {
     auto event = std::make_unique<SystemEvent>(
         CoreEventType::ServiceRegistered,
@@ -9,6 +9,12 @@
 #include <typeindex>
 #include <chrono>
 #include <string>
+#include <array>
+#include <filesystem>
+#include <stdexcept>
+
+#include "event_queue.hpp"
+#include "telemetry.hpp"
 
 namespace QuantumCanvas::Core {
 
@@ -45,6 +51,9 @@ public:
     virtual size_t size() const = 0;
 };
 
+// Event queue storing events up to 96 bytes inline
+using EventQueue = BoundedEventQueue<IEvent, 96>;
+
 // Base service interface
 class IService {
 public:
@@ -97,8 +106,16 @@ public:
     std::vector<PluginId> get_loaded_plugins() const;
     IPlugin* get_plugin(PluginId plugin_id);
     
-    // Event System
+    // Event System. Publishing is lock-free; handlers are resolved through a
+    // per-type dispatch table rebuilt on (un)subscribe, and can_handle() is
+    // evaluated once at subscription time.
+    static constexpr size_t EVENT_QUEUE_CAPACITY = 8192;
+    
     void publish_event(std::unique_ptr<IEvent> event);
+    
+    template<typename T, typename... Args>
+    void emplace_event(Args&&... args);  // No heap allocation when T fits inline
+    
     void subscribe(EventType type, IEventHandler* handler);
     void unsubscribe(EventType type, IEventHandler* handler);
     void process_events();
@@ -120,10 +137,27 @@ public:
         size_t event_queue_size;
         double cpu_usage_percent;
         std::chrono::milliseconds uptime;
+        
+        // Event queue health, percentiles over the most recent samples
+        size_t event_queue_capacity;
+        size_t event_queue_peak_depth;
+        size_t event_queue_depth_p50;
+        size_t event_queue_depth_p95;
+        size_t event_queue_depth_p99;
+        std::chrono::microseconds event_latency_p50;
+        std::chrono::microseconds event_latency_p95;
+        std::chrono::microseconds event_latency_p99;
+        uint64_t events_dispatched;
+        uint64_t events_overflowed;  // Published while the ring was full
     };
     
     PerformanceStats get_performance_stats() const;
     
+    // Process-wide metrics: the kernel's, those of every module source and
+    // all spans. Export with to_prometheus() and to_chrome_trace().
+    Telemetry& telemetry() { return Telemetry::instance(); }
+    TelemetrySnapshot snapshot_telemetry() const;
+    
 private:
     KernelManager();
     ~KernelManager();
@@ -144,12 +178,46 @@ private:
     };
     mutable std::mutex events_mutex_;
     std::unordered_map<EventType, std::vector<EventSubscription>> event_handlers_;
-    std::vector<std::unique_ptr<IEvent>> event_queue_;
+    
+    // Immutable snapshot of event_handlers_, swapped under events_mutex_
+    struct DispatchTable {
+        static constexpr EventType DIRECT_TYPES = 256;
+        std::array<std::vector<IEventHandler*>, DIRECT_TYPES> direct;
+        std::unordered_map<EventType, std::vector<IEventHandler*>> sparse;
+        
+        const std::vector<IEventHandler*>* find(EventType type) const {
+            if (type < DIRECT_TYPES) {
+                return direct[type].empty() ? nullptr : &direct[type];
+            }
+            auto it = sparse.find(type);
+            return it != sparse.end() ? &it->second : nullptr;
+        }
+    };
+    std::shared_ptr<const DispatchTable> dispatch_table_;
+    
+    EventQueue event_queue_{EVENT_QUEUE_CAPACITY};
+    std::mutex consumer_mutex_;  // process_events is the queue's single consumer
+    std::vector<std::unique_ptr<IEvent>> overflow_events_;  // Guarded by events_mutex_
+    std::atomic<bool> has_overflow_{false};
+    
+    // Event metrics: ring buffers of recent samples, written by the consumer
+    static constexpr size_t EVENT_SAMPLE_COUNT = 1024;
+    std::array<std::atomic<uint32_t>, EVENT_SAMPLE_COUNT> latency_samples_us_{};
+    std::array<std::atomic<uint32_t>, EVENT_SAMPLE_COUNT> depth_samples_{};
+    std::atomic<uint64_t> latency_sample_count_{0};
+    std::atomic<uint64_t> depth_sample_count_{0};
+    std::atomic<size_t> peak_queue_depth_{0};
+    std::atomic<uint64_t> events_dispatched_{0};
+    std::atomic<uint64_t> events_overflowed_{0};
     
     // Core managers
     std::unique_ptr<IMemoryManager> memory_manager_;
     std::unique_ptr<IResourceManager> resource_manager_;
     
+    // The "kernel" source, with memory and scheduler stats; registered
+    // while initialized
+    Telemetry::SourceRegistration telemetry_source_;
+    
     // State
     std::atomic<bool> is_initialized_{false};
     std::atomic<bool> is_running_{false};
@@ -159,8 +227,13 @@ private:
     void initialize_core_services();
     void shutdown_all_services();
     void cleanup_resources();
+    void register_telemetry();
     void notify_service_registered(const ServiceId& id);
     void notify_service_unregistered(const ServiceId& id);
+    void rebuild_dispatch_table();  // Caller holds events_mutex_
+    void dispatch_event(const DispatchTable* table, const IEvent& event);
+    void push_overflow_event(std::unique_ptr<IEvent> event);
+    void record_queue_depth(size_t depth);
 };
 
 // Template implementations
@@ -201,6 +274,18 @@ std::shared_ptr<T> KernelManager::get_service() {
     return nullptr;
 }
 
+template<typename T, typename... Args>
+void KernelManager::emplace_event(Args&&... args) {
+    static_assert(std::is_base_of<IEvent, T>::value, 
+                  "T must inherit from IEvent");
+    
+    // Behind a non-empty overflow, so neither path overtakes the other
+    if (has_overflow_.load(std::memory_order_acquire) ||
+        !event_queue_.template try_emplace<T>(std::forward<Args>(args)...)) {
+        push_overflow_event(std::make_unique<T>(std::forward<Args>(args)...));
+    }
+}
+
 template<typename T>
 bool KernelManager::has_service() const {
     static_assert(std::is_base_of<IService, T>::value, 
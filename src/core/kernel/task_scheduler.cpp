@@ -0,0 +1,454 @@
+/*
+ * Copyright (c) 2024 Francisco Molina (QuantumCanvas Studio)
+ * Licensed under Dual License Agreement - See LICENSE file for details
+ *
+ * ATTRIBUTION REQUIRED: This software must include attribution to Francisco Molina
+ * COMMERCIAL USE: Requires separate license and royalties - contact pako.molina@gmail.com
+ *
+ * Project: https://github.com/Yatrogenesis/QuantumCanvas-Studio
+ * Author: Francisco Molina <pako.molina@gmail.com>
+ */
+
+#include "task_scheduler.hpp"
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace QuantumCanvas::Core {
+
+// Per-worker state. Counters are only written by the owning worker.
+struct alignas(64) TaskScheduler::Worker {
+    TaskScheduler* owner = nullptr;
+    uint32_t index = 0;
+    std::thread thread;
+
+    std::mutex mutex;
+    std::deque<Task> queues[TASK_PRIORITY_COUNT];
+
+    std::atomic<uint64_t> executed[TASK_PRIORITY_COUNT]{};
+    uint32_t steal_seed = 0;
+};
+
+thread_local TaskScheduler::Worker* TaskScheduler::current_worker_ = nullptr;
+
+// TaskGroup implementation
+void TaskGroup::capture_exception(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    if (!error_) {
+        error_ = error;
+    }
+    failed_.store(true, std::memory_order_release);
+}
+
+// TaskGraph implementation
+TaskGraph::NodeId TaskGraph::add_task(std::function<void()> fn, TaskPriority priority) {
+    auto node = std::make_unique<Node>();
+    node->fn = std::move(fn);
+    node->priority = priority;
+    nodes_.push_back(std::move(node));
+    return nodes_.size() - 1;
+}
+
+void TaskGraph::add_dependency(NodeId before, NodeId after) {
+    if (before >= nodes_.size() || after >= nodes_.size()) {
+        throw std::out_of_range("TaskGraph node id out of range");
+    }
+
+    nodes_[before]->successors.push_back(after);
+    ++nodes_[after]->dependency_count;
+}
+
+bool TaskGraph::is_acyclic() const {
+    // Kahn's algorithm: every node must be reachable through a topological order
+    std::vector<uint32_t> in_degree(nodes_.size());
+    std::vector<NodeId> ready;
+    for (NodeId id = 0; id < nodes_.size(); ++id) {
+        in_degree[id] = nodes_[id]->dependency_count;
+        if (in_degree[id] == 0) {
+            ready.push_back(id);
+        }
+    }
+
+    size_t visited = 0;
+    while (!ready.empty()) {
+        NodeId id = ready.back();
+        ready.pop_back();
+        ++visited;
+
+        for (NodeId successor : nodes_[id]->successors) {
+            if (--in_degree[successor] == 0) {
+                ready.push_back(successor);
+            }
+        }
+    }
+
+    return visited == nodes_.size();
+}
+
+// TaskScheduler implementation
+TaskScheduler::TaskScheduler(uint32_t worker_count)
+    : worker_count_(worker_count) {
+    if (worker_count_ == 0) {
+        // The thread that waits on work helps run it, so leave it a core
+        uint32_t hardware_threads = std::thread::hardware_concurrency();
+        worker_count_ = hardware_threads > 1 ? hardware_threads - 1 : 1;
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    shutdown();
+}
+
+bool TaskScheduler::initialize() {
+    if (running_.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    stopping_.store(false, std::memory_order_release);
+
+    workers_.clear();
+    workers_.reserve(worker_count_);
+    for (uint32_t i = 0; i < worker_count_; ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->owner = this;
+        worker->index = i;
+        worker->steal_seed = i * 2654435761u + 1;
+        workers_.push_back(std::move(worker));
+    }
+
+    // Workers may steal from each other as soon as they start, so the
+    // whole vector must exist before the first thread runs
+    running_.store(true, std::memory_order_release);
+    for (auto& worker : workers_) {
+        Worker* self = worker.get();
+        self->thread = std::thread([this, self]() { worker_loop(self); });
+    }
+
+    std::cout << "[TaskScheduler] Initialized with " << worker_count_ << " worker threads" << std::endl;
+    return true;
+}
+
+void TaskScheduler::shutdown() {
+    if (!running_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    // New submissions now run inline; workers exit once the queues are empty
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_.store(true, std::memory_order_seq_cst);
+    }
+    wake_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+
+    // Anything pushed while the workers were exiting
+    Task task;
+    TaskPriority priority;
+    while (pop(task, priority, nullptr)) {
+        execute(task, priority, nullptr);
+    }
+
+    workers_.clear();
+}
+
+size_t TaskScheduler::memory_usage() const {
+    return sizeof(*this) +
+           workers_.size() * sizeof(Worker) +
+           queued_.load(std::memory_order_relaxed) * sizeof(Task);
+}
+
+void TaskScheduler::submit(Task task, TaskPriority priority) {
+    if (!task) {
+        return;
+    }
+
+    if (!running_.load(std::memory_order_acquire)) {
+        execute(task, priority, current_worker());
+        return;
+    }
+
+    push(std::move(task), priority);
+}
+
+void TaskScheduler::submit(TaskGroup& group, Task task, TaskPriority priority) {
+    if (!task) {
+        return;
+    }
+
+    group.pending_.fetch_add(1, std::memory_order_relaxed);
+    submit([&group, task = std::move(task)]() {
+        try {
+            task();
+        } catch (...) {
+            group.capture_exception(std::current_exception());
+        }
+        // Last access to the group: the waiter may destroy it right after
+        group.pending_.fetch_sub(1, std::memory_order_acq_rel);
+    }, priority);
+}
+
+void TaskScheduler::wait(TaskGroup& group) {
+    while (!group.is_done()) {
+        if (!try_run_pending_task()) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (group.failed_.load(std::memory_order_acquire)) {
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock(group.error_mutex_);
+            error = std::exchange(group.error_, nullptr);
+            group.failed_.store(false, std::memory_order_relaxed);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+void TaskScheduler::run(TaskGraph& graph) {
+    if (graph.nodes_.empty()) {
+        return;
+    }
+
+    if (!graph.is_acyclic()) {
+        throw std::invalid_argument("TaskGraph contains a dependency cycle");
+    }
+
+    for (auto& node : graph.nodes_) {
+        node->remaining.store(node->dependency_count, std::memory_order_relaxed);
+    }
+
+    TaskGroup group;
+    for (TaskGraph::NodeId id = 0; id < graph.nodes_.size(); ++id) {
+        if (graph.nodes_[id]->dependency_count == 0) {
+            submit_graph_node(graph, id, group);
+        }
+    }
+
+    wait(group);
+}
+
+void TaskScheduler::submit_graph_node(TaskGraph& graph, TaskGraph::NodeId id, TaskGroup& group) {
+    TaskGraph::Node* node = graph.nodes_[id].get();
+
+    // Successors are submitted before this node's group slot is released,
+    // so the group cannot drain while the graph still has runnable work
+    submit(group, [this, &graph, &group, node]() {
+        if (node->fn) {
+            node->fn();
+        }
+        for (TaskGraph::NodeId successor : node->successors) {
+            if (graph.nodes_[successor]->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                submit_graph_node(graph, successor, group);
+            }
+        }
+    }, node->priority);
+}
+
+bool TaskScheduler::try_run_pending_task() {
+    Worker* self = current_worker();
+    Task task;
+    TaskPriority priority;
+    if (!pop(task, priority, self)) {
+        return false;
+    }
+
+    execute(task, priority, self);
+    return true;
+}
+
+bool TaskScheduler::is_worker_thread() const {
+    return current_worker() != nullptr;
+}
+
+TaskScheduler::Stats TaskScheduler::get_stats() const {
+    Stats stats;
+    stats.tasks_submitted = tasks_submitted_.load(std::memory_order_relaxed);
+    stats.tasks_stolen = tasks_stolen_.load(std::memory_order_relaxed);
+    stats.tasks_queued = queued_.load(std::memory_order_relaxed);
+    stats.worker_count = worker_count_;
+
+    stats.interactive_executed = external_executed_[0].load(std::memory_order_relaxed);
+    stats.background_executed = external_executed_[1].load(std::memory_order_relaxed);
+    for (const auto& worker : workers_) {
+        stats.interactive_executed += worker->executed[0].load(std::memory_order_relaxed);
+        stats.background_executed += worker->executed[1].load(std::memory_order_relaxed);
+    }
+    stats.tasks_executed = stats.interactive_executed + stats.background_executed;
+
+    return stats;
+}
+
+void TaskScheduler::push(Task task, TaskPriority priority) {
+    const size_t level = static_cast<size_t>(priority);
+    Worker* self = current_worker();
+
+    if (self) {
+        std::lock_guard<std::mutex> lock(self->mutex);
+        self->queues[level].push_back(std::move(task));
+    } else {
+        std::lock_guard<std::mutex> lock(injection_mutex_);
+        injection_[level].push_back(std::move(task));
+    }
+
+    // Pairs with the sleeping_ increment in worker_loop: either the worker
+    // sees this task or we see the sleeper
+    queued_.fetch_add(1, std::memory_order_seq_cst);
+    tasks_submitted_.fetch_add(1, std::memory_order_relaxed);
+    notify_one();
+}
+
+bool TaskScheduler::pop(Task& task, TaskPriority& priority, Worker* self) {
+    if (queued_.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    const size_t worker_total = workers_.size();
+
+    for (size_t level = 0; level < TASK_PRIORITY_COUNT; ++level) {
+        priority = static_cast<TaskPriority>(level);
+
+        // Own deque, newest first
+        if (self) {
+            std::lock_guard<std::mutex> lock(self->mutex);
+            auto& queue = self->queues[level];
+            if (!queue.empty()) {
+                task = std::move(queue.back());
+                queue.pop_back();
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // Work submitted from outside the pool
+        {
+            std::lock_guard<std::mutex> lock(injection_mutex_);
+            auto& queue = injection_[level];
+            if (!queue.empty()) {
+                task = std::move(queue.front());
+                queue.pop_front();
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // Steal the oldest task from another worker, starting at a random victim
+        if (worker_total == 0) {
+            continue;
+        }
+
+        size_t start = 0;
+        if (self) {
+            self->steal_seed = self->steal_seed * 1664525u + 1013904223u;
+            start = self->steal_seed % worker_total;
+        } else {
+            start = static_cast<size_t>(tasks_submitted_.load(std::memory_order_relaxed)) % worker_total;
+        }
+
+        for (size_t offset = 0; offset < worker_total; ++offset) {
+            Worker* victim = workers_[(start + offset) % worker_total].get();
+            if (victim == self) {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(victim->mutex, std::try_to_lock);
+            if (!lock.owns_lock()) {
+                continue;
+            }
+
+            auto& queue = victim->queues[level];
+            if (!queue.empty()) {
+                task = std::move(queue.front());
+                queue.pop_front();
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+                tasks_stolen_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void TaskScheduler::execute(Task& task, TaskPriority priority, Worker* self) {
+    try {
+        task();
+    } catch (const std::exception& e) {
+        std::cerr << "[TaskScheduler] Unhandled exception in task: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "[TaskScheduler] Unhandled unknown exception in task" << std::endl;
+    }
+    task = nullptr;
+
+    const size_t level = static_cast<size_t>(priority);
+    if (self) {
+        self->executed[level].fetch_add(1, std::memory_order_relaxed);
+    } else {
+        external_executed_[level].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void TaskScheduler::worker_loop(Worker* self) {
+    current_worker_ = self;
+
+    constexpr int SPIN_ATTEMPTS = 64;
+
+    for (;;) {
+        Task task;
+        TaskPriority priority;
+        if (pop(task, priority, self)) {
+            execute(task, priority, self);
+            continue;
+        }
+
+        // Stay hot briefly before parking; bursts of small tasks are common
+        bool found_work = false;
+        for (int spin = 0; spin < SPIN_ATTEMPTS; ++spin) {
+            if (queued_.load(std::memory_order_relaxed) > 0) {
+                found_work = true;
+                break;
+            }
+            std::this_thread::yield();
+        }
+        if (found_work) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleeping_.fetch_add(1, std::memory_order_seq_cst);
+        wake_.wait(lock, [this]() {
+            return queued_.load(std::memory_order_seq_cst) > 0 ||
+                   stopping_.load(std::memory_order_seq_cst);
+        });
+        sleeping_.fetch_sub(1, std::memory_order_relaxed);
+
+        if (stopping_.load(std::memory_order_acquire) &&
+            queued_.load(std::memory_order_acquire) == 0) {
+            break;
+        }
+    }
+
+    current_worker_ = nullptr;
+}
+
+void TaskScheduler::notify_one() {
+    if (sleeping_.load(std::memory_order_seq_cst) > 0) {
+        // Taking the mutex orders us after a worker that is between its
+        // predicate check and the wait
+        { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+        wake_.notify_one();
+    }
+}
+
+TaskScheduler::Worker* TaskScheduler::current_worker() const {
+    return current_worker_ && current_worker_->owner == this ? current_worker_ : nullptr;
+}
+
+} // namespace QuantumCanvas::Core
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "kernel_manager.hpp"
+
+#include <memory>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <exception>
+#include <type_traits>
+#include <algorithm>
+#include <string>
+
+namespace QuantumCanvas::Core {
+
+// Interactive work (UI-visible, latency sensitive) is always picked before
+// background work (batch filters, file IO) on every worker
+enum class TaskPriority : uint8_t {
+    Interactive = 0,
+    Background = 1
+};
+
+constexpr size_t TASK_PRIORITY_COUNT = 2;
+
+// Tracks a set of submitted tasks. TaskScheduler::wait() runs queued work on
+// the calling thread until the group drains, then rethrows the first exception.
+class TaskGroup {
+public:
+    TaskGroup() = default;
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    bool is_done() const { return pending_.load(std::memory_order_acquire) == 0; }
+    size_t pending() const { return pending_.load(std::memory_order_acquire); }
+
+private:
+    friend class TaskScheduler;
+
+    void capture_exception(std::exception_ptr error);
+
+    std::atomic<size_t> pending_{0};
+    std::atomic<bool> failed_{false};
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+};
+
+// Static DAG of tasks. A node becomes runnable once all of its predecessors
+// have finished; a node that throws does not release its successors.
+class TaskGraph {
+public:
+    using NodeId = size_t;
+
+    NodeId add_task(std::function<void()> fn, TaskPriority priority = TaskPriority::Background);
+    void add_dependency(NodeId before, NodeId after);  // 'after' waits for 'before'
+
+    size_t size() const { return nodes_.size(); }
+    void clear() { nodes_.clear(); }
+
+private:
+    friend class TaskScheduler;
+
+    struct Node {
+        std::function<void()> fn;
+        TaskPriority priority;
+        std::vector<NodeId> successors;
+        uint32_t dependency_count = 0;
+        std::atomic<uint32_t> remaining{0};
+    };
+    std::vector<std::unique_ptr<Node>> nodes_;
+
+    bool is_acyclic() const;
+};
+
+// Shared work-stealing thread pool, registered with the KernelManager as a core
+// service. Each worker owns a deque per priority: it pushes and pops its own
+// work LIFO for cache locality, and idle workers steal FIFO from the others.
+// Threads outside the pool submit through a shared injection queue. Waiting
+// (wait, parallel_for, run) always helps execute work instead of blocking, so
+// nested parallelism cannot deadlock the pool.
+class TaskScheduler : public IService {
+public:
+    using Task = std::function<void()>;
+
+    explicit TaskScheduler(uint32_t worker_count = 0);  // 0 = hardware threads - 1
+    ~TaskScheduler() override;
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    // IService
+    bool initialize() override;
+    void shutdown() override;  // Drains queued work, then joins the workers
+    std::string name() const override { return "TaskScheduler"; }
+    std::string version() const override { return "1.0.0"; }
+    bool is_initialized() const override { return running_.load(std::memory_order_acquire); }
+    size_t memory_usage() const override;
+
+    // Fire-and-forget. Runs inline if the scheduler is not running.
+    void submit(Task task, TaskPriority priority = TaskPriority::Background);
+    void submit(TaskGroup& group, Task task, TaskPriority priority = TaskPriority::Background);
+
+    template<typename F>
+    auto async(F&& fn, TaskPriority priority = TaskPriority::Background)
+        -> std::future<std::invoke_result_t<std::decay_t<F>>>;
+
+    void wait(TaskGroup& group);
+
+    // Calls fn(i) for every i in [begin, end). Chunks of 'grain' indices are
+    // handed out dynamically, and the calling thread takes part.
+    template<typename Fn>
+    void parallel_for(size_t begin, size_t end, size_t grain, Fn&& fn,
+                      TaskPriority priority = TaskPriority::Interactive);
+
+    // Blocks until every node has run; throws std::invalid_argument on a cycle
+    void run(TaskGraph& graph);
+
+    // Runs a single queued task on the calling thread, if any is available
+    bool try_run_pending_task();
+
+    uint32_t worker_count() const { return worker_count_; }
+    uint32_t concurrency() const { return worker_count_ + 1; }  // Workers plus the caller
+    bool is_worker_thread() const;
+
+    struct Stats {
+        uint64_t tasks_submitted = 0;
+        uint64_t tasks_executed = 0;
+        uint64_t tasks_stolen = 0;
+        uint64_t interactive_executed = 0;
+        uint64_t background_executed = 0;
+        size_t tasks_queued = 0;
+        uint32_t worker_count = 0;
+    };
+    Stats get_stats() const;
+
+private:
+    struct Worker;
+
+    uint32_t worker_count_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    // Queues for threads outside the pool
+    mutable std::mutex injection_mutex_;
+    std::deque<Task> injection_[TASK_PRIORITY_COUNT];
+
+    std::atomic<size_t> queued_{0};
+    std::atomic<uint32_t> sleeping_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stopping_{false};
+
+    std::atomic<uint64_t> tasks_submitted_{0};
+    std::atomic<uint64_t> tasks_stolen_{0};
+    std::atomic<uint64_t> external_executed_[TASK_PRIORITY_COUNT]{};  // Run by waiting callers
+
+    static thread_local Worker* current_worker_;
+
+    void push(Task task, TaskPriority priority);
+    bool pop(Task& task, TaskPriority& priority, Worker* self);
+    void execute(Task& task, TaskPriority priority, Worker* self);
+    void worker_loop(Worker* self);
+    void notify_one();
+    Worker* current_worker() const;
+    void submit_graph_node(TaskGraph& graph, TaskGraph::NodeId id, TaskGroup& group);
+};
+
+// Runs on the kernel's scheduler when one is registered, otherwise inline.
+// Lets modules parallelise without owning threads of their own.
+template<typename Fn>
+void parallel_for(size_t begin, size_t end, size_t grain, Fn&& fn,
+                  TaskPriority priority = TaskPriority::Interactive);
+
+// Template implementations
+template<typename F>
+auto TaskScheduler::async(F&& fn, TaskPriority priority)
+    -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+    using result_type = std::invoke_result_t<std::decay_t<F>>;
+
+    // std::function needs a copyable callable, so the packaged_task is shared
+    auto task = std::make_shared<std::packaged_task<result_type()>>(std::forward<F>(fn));
+    std::future<result_type> result = task->get_future();
+    submit([task]() { (*task)(); }, priority);
+    return result;
+}
+
+template<typename Fn>
+void TaskScheduler::parallel_for(size_t begin, size_t end, size_t grain, Fn&& fn,
+                                 TaskPriority priority) {
+    if (begin >= end) {
+        return;
+    }
+
+    grain = std::max<size_t>(grain, 1);
+    const size_t chunks = (end - begin + grain - 1) / grain;
+
+    if (chunks == 1 || !is_initialized()) {
+        for (size_t i = begin; i < end; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next{begin};
+    auto run_chunks = [&]() {
+        for (;;) {
+            size_t first = next.fetch_add(grain, std::memory_order_relaxed);
+            if (first >= end) {
+                return;
+            }
+            size_t last = std::min(first + grain, end);
+            for (size_t i = first; i < last; ++i) {
+                fn(i);
+            }
+        }
+    };
+
+    TaskGroup group;
+    const size_t helpers = std::min<size_t>(chunks - 1, worker_count_);
+    for (size_t h = 0; h < helpers; ++h) {
+        submit(group, [&run_chunks, &next, end]() {
+            try {
+                run_chunks();
+            } catch (...) {
+                next.store(end, std::memory_order_relaxed);  // Stop handing out chunks
+                throw;
+            }
+        }, priority);
+    }
+
+    try {
+        run_chunks();
+    } catch (...) {
+        next.store(end, std::memory_order_relaxed);
+        group.capture_exception(std::current_exception());
+    }
+
+    wait(group);
+}
+
+template<typename Fn>
+void parallel_for(size_t begin, size_t end, size_t grain, Fn&& fn, TaskPriority priority) {
+    auto scheduler = KernelManager::instance().get_service<TaskScheduler>();
+    if (scheduler) {
+        scheduler->parallel_for(begin, end, grain, std::forward<Fn>(fn), priority);
+        return;
+    }
+
+    for (size_t i = begin; i < end; ++i) {
+        fn(i);
+    }
+}
+
+} // namespace QuantumCanvas::Core
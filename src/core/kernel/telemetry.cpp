@@ -0,0 +1,475 @@
+#include "telemetry.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace QuantumCanvas::Core {
+
+namespace {
+
+// Written by the slab's owner only, so an update needs no read-modify-write
+inline void bump(std::atomic<uint64_t>& slot, uint64_t amount) {
+    slot.store(slot.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+inline size_t bucket_of(uint64_t value) {
+    return std::min<size_t>(std::bit_width(value), HISTOGRAM_BUCKETS - 1);
+}
+
+inline uint64_t bucket_upper_bound(size_t bucket) {
+    return bucket + 1 < HISTOGRAM_BUCKETS ? (uint64_t(1) << bucket) - 1 : std::numeric_limits<uint64_t>::max();
+}
+
+// [a-zA-Z0-9_:] only, as Prometheus requires
+std::string prometheus_name(std::string_view name) {
+    std::string result = "qcs_";
+    for (char c : name) {
+        const bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        result += valid ? c : '_';
+    }
+    return result;
+}
+
+std::string json_string(std::string_view text) {
+    std::string result = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            result += escaped;
+        } else {
+            result += c;
+        }
+    }
+    return result + "\"";
+}
+
+template<typename Value>
+const Value* find_named(const std::vector<Value>& values, std::string_view name) {
+    for (const Value& value : values) {
+        if (value.name == name) {
+            return &value;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+std::atomic<bool> Telemetry::enabled_{true};
+
+// Telemetry::SlabLease
+struct Telemetry::SlabLease {
+    Slab* slab = nullptr;
+
+    ~SlabLease() {
+        if (slab) {
+            Telemetry::instance().release_slab(slab);
+        }
+    }
+};
+
+// Counter, Histogram, TraceSpan
+void Counter::add(uint64_t amount) const {
+    if (id_ == INVALID_METRIC || !Telemetry::is_enabled()) {
+        return;
+    }
+    bump(Telemetry::local_slab().counters[id_], amount);
+}
+
+void Histogram::record(uint64_t value) const {
+    if (id_ == INVALID_METRIC || !Telemetry::is_enabled()) {
+        return;
+    }
+    Telemetry::HistogramSlots& slots = Telemetry::local_slab().histograms[id_];
+    bump(slots.buckets[bucket_of(value)], 1);
+    bump(slots.sum, value);
+}
+
+TraceSpan::TraceSpan(const Histogram& span)
+    : id_(Telemetry::is_enabled() ? span.id() : INVALID_METRIC)
+    , start_ns_(id_ != INVALID_METRIC ? Telemetry::now_ns() : 0) {
+}
+
+TraceSpan::~TraceSpan() {
+    if (id_ == INVALID_METRIC) {
+        return;
+    }
+    const uint64_t duration = Telemetry::now_ns() - start_ns_;
+    Telemetry::Slab& slab = Telemetry::local_slab();
+    Telemetry::HistogramSlots& slots = slab.histograms[id_];
+    bump(slots.buckets[bucket_of(duration)], 1);
+    bump(slots.sum, duration);
+
+    Telemetry& telemetry = Telemetry::instance();
+    if (telemetry.is_capturing()) {
+        telemetry.record_event(slab, id_, start_ns_, duration);
+    }
+}
+
+// TelemetrySnapshot
+uint64_t TelemetrySnapshot::HistogramValue::quantile(double q) const {
+    if (count == 0) {
+        return 0;
+    }
+    const double rank = std::clamp(q, 0.0, 1.0) * static_cast<double>(count);
+    const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(rank)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+        seen += buckets[i];
+        if (seen >= target) {
+            return bucket_upper_bound(i);
+        }
+    }
+    return bucket_upper_bound(HISTOGRAM_BUCKETS - 1);
+}
+
+const TelemetrySnapshot::CounterValue* TelemetrySnapshot::find_counter(std::string_view name) const {
+    return find_named(counters, name);
+}
+
+const TelemetrySnapshot::GaugeValue* TelemetrySnapshot::find_gauge(std::string_view name) const {
+    return find_named(gauges, name);
+}
+
+const TelemetrySnapshot::HistogramValue* TelemetrySnapshot::find_histogram(std::string_view name) const {
+    return find_named(histograms, name);
+}
+
+// MetricWriter
+MetricWriter::MetricWriter(TelemetrySnapshot& snapshot, std::string_view prefix, uint32_t instance)
+    : snapshot_(snapshot), prefix_(std::string(prefix) + "."), instance_(instance) {
+}
+
+void MetricWriter::counter(std::string_view name, uint64_t value) {
+    snapshot_.counters.push_back({prefix_ + std::string(name), value, instance_, true});
+}
+
+void MetricWriter::gauge(std::string_view name, double value) {
+    snapshot_.gauges.push_back({prefix_ + std::string(name), value, instance_});
+}
+
+// Telemetry::SourceRegistration
+Telemetry::SourceRegistration& Telemetry::SourceRegistration::operator=(SourceRegistration&& other) noexcept {
+    if (this != &other) {
+        reset();
+        id_ = other.id_;
+        other.id_ = 0;
+    }
+    return *this;
+}
+
+void Telemetry::SourceRegistration::reset() {
+    if (id_ == 0) {
+        return;
+    }
+    Telemetry& telemetry = Telemetry::instance();
+    std::lock_guard<std::mutex> lock(telemetry.sources_mutex_);
+    auto& sources = telemetry.sources_;
+    sources.erase(std::remove_if(sources.begin(), sources.end(),
+                                 [this](const SourceEntry& entry) { return entry.id == id_; }),
+                  sources.end());
+    id_ = 0;
+}
+
+// Telemetry::Slab
+void Telemetry::Slab::lock_ring() {
+    while (ring_locked.exchange(true, std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+// Telemetry
+Telemetry& Telemetry::instance() {
+    static Telemetry* telemetry = new Telemetry();
+    return *telemetry;
+}
+
+Telemetry::Telemetry() : epoch_(std::chrono::steady_clock::now()) {
+}
+
+uint64_t Telemetry::now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - instance().epoch_).count());
+}
+
+Counter Telemetry::counter(std::string_view name) {
+    std::lock_guard<std::mutex> lock(metrics_mutex_);
+    for (size_t i = 0; i < counter_info_.size(); ++i) {
+        if (counter_info_[i].name == name) {
+            return Counter(static_cast<MetricId>(i));
+        }
+    }
+    if (counter_info_.size() == MAX_COUNTERS) {
+        throw std::runtime_error("Too many telemetry counters registered: " + std::string(name));
+    }
+    counter_info_.push_back({std::string(name), {}});
+    return Counter(static_cast<MetricId>(counter_info_.size() - 1));
+}
+
+Histogram Telemetry::histogram(std::string_view name, std::string_view unit) {
+    std::lock_guard<std::mutex> lock(metrics_mutex_);
+    for (size_t i = 0; i < histogram_info_.size(); ++i) {
+        if (histogram_info_[i].name == name) {
+            return Histogram(static_cast<MetricId>(i));
+        }
+    }
+    if (histogram_info_.size() == MAX_HISTOGRAMS) {
+        throw std::runtime_error("Too many telemetry histograms registered: " + std::string(name));
+    }
+    histogram_info_.push_back({std::string(name), std::string(unit)});
+    return Histogram(static_cast<MetricId>(histogram_info_.size() - 1));
+}
+
+Telemetry::SourceRegistration Telemetry::add_source(std::string_view name, Source source) {
+    std::lock_guard<std::mutex> lock(sources_mutex_);
+
+    // Lowest instance number not taken by another source of this name
+    uint32_t instance = 0;
+    for (bool taken = true; taken; ) {
+        taken = std::any_of(sources_.begin(), sources_.end(), [&](const SourceEntry& entry) {
+            return entry.name == name && entry.instance == instance;
+        });
+        instance += taken;
+    }
+
+    const uint64_t id = next_source_++;
+    sources_.push_back({id, std::string(name), instance, std::move(source)});
+    return SourceRegistration(id);
+}
+
+TelemetrySnapshot Telemetry::snapshot() const {
+    TelemetrySnapshot snapshot;
+    snapshot.taken_at = std::chrono::system_clock::now();
+
+    std::vector<MetricInfo> counters, histograms;
+    {
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        counters = counter_info_;
+        histograms = histogram_info_;
+    }
+
+    snapshot.counters.reserve(counters.size());
+    for (MetricInfo& info : counters) {
+        snapshot.counters.push_back({std::move(info.name), 0, 0, false});
+    }
+    snapshot.histograms.reserve(histograms.size());
+    for (MetricInfo& info : histograms) {
+        TelemetrySnapshot::HistogramValue value;
+        value.name = std::move(info.name);
+        value.unit = std::move(info.unit);
+        snapshot.histograms.push_back(std::move(value));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(slabs_mutex_);
+        for (const auto& slab : slabs_) {
+            for (size_t i = 0; i < counters.size(); ++i) {
+                snapshot.counters[i].value += slab->counters[i].load(std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < histograms.size(); ++i) {
+                TelemetrySnapshot::HistogramValue& value = snapshot.histograms[i];
+                const HistogramSlots& slots = slab->histograms[i];
+                for (size_t b = 0; b < HISTOGRAM_BUCKETS; ++b) {
+                    value.buckets[b] += slots.buckets[b].load(std::memory_order_relaxed);
+                }
+                value.sum += slots.sum.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    for (TelemetrySnapshot::HistogramValue& value : snapshot.histograms) {
+        for (uint64_t bucket : value.buckets) {
+            value.count += bucket;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(sources_mutex_);
+    for (const SourceEntry& entry : sources_) {
+        MetricWriter writer(snapshot, entry.name, entry.instance);
+        entry.source(writer);
+    }
+    return snapshot;
+}
+
+void Telemetry::start_capture(size_t events_per_thread) {
+    events_per_thread = std::max<size_t>(events_per_thread, 1);
+    std::lock_guard<std::mutex> lock(slabs_mutex_);
+    ring_size_ = events_per_thread;
+    for (const auto& slab : slabs_) {
+        slab->lock_ring();
+        slab->ring = std::make_unique<TraceCapture::Event[]>(ring_size_);
+        slab->ring_size = ring_size_;
+        slab->ring_written = 0;
+        slab->unlock_ring();
+    }
+    capturing_.store(true, std::memory_order_relaxed);
+}
+
+TraceCapture Telemetry::stop_capture() {
+    TraceCapture capture;
+    {
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        for (const MetricInfo& info : histogram_info_) {
+            capture.span_names.push_back(info.name);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(slabs_mutex_);
+    capturing_.store(false, std::memory_order_relaxed);
+    ring_size_ = 0;
+    for (const auto& slab : slabs_) {
+        slab->lock_ring();
+        if (slab->ring) {
+            const uint64_t kept = std::min<uint64_t>(slab->ring_written, slab->ring_size);
+            capture.dropped += slab->ring_written - kept;
+            for (uint64_t i = slab->ring_written - kept; i < slab->ring_written; ++i) {
+                capture.events.push_back(slab->ring[i % slab->ring_size]);
+            }
+            slab->ring.reset();
+            slab->ring_size = 0;
+            slab->ring_written = 0;
+        }
+        slab->unlock_ring();
+    }
+
+    std::sort(capture.events.begin(), capture.events.end(),
+              [](const TraceCapture::Event& a, const TraceCapture::Event& b) { return a.start_ns < b.start_ns; });
+    return capture;
+}
+
+Telemetry::Slab& Telemetry::local_slab() {
+    thread_local SlabLease lease;
+    if (!lease.slab) {
+        lease.slab = instance().acquire_slab();
+    }
+    return *lease.slab;
+}
+
+Telemetry::Slab* Telemetry::acquire_slab() {
+    std::lock_guard<std::mutex> lock(slabs_mutex_);
+    Slab* slab;
+    if (!free_slabs_.empty()) {
+        slab = free_slabs_.back();
+        free_slabs_.pop_back();
+    } else {
+        slabs_.push_back(std::make_unique<Slab>());
+        slab = slabs_.back().get();
+    }
+    slab->thread = next_thread_++;
+
+    if (ring_size_ && !slab->ring) {
+        slab->lock_ring();
+        slab->ring = std::make_unique<TraceCapture::Event[]>(ring_size_);
+        slab->ring_size = ring_size_;
+        slab->ring_written = 0;
+        slab->unlock_ring();
+    }
+    return slab;
+}
+
+void Telemetry::release_slab(Slab* slab) {
+    std::lock_guard<std::mutex> lock(slabs_mutex_);
+    free_slabs_.push_back(slab);
+}
+
+void Telemetry::record_event(Slab& slab, MetricId span, uint64_t start_ns, uint64_t duration_ns) {
+    slab.lock_ring();
+    if (slab.ring) {
+        slab.ring[slab.ring_written % slab.ring_size] = {span, slab.thread, start_ns, duration_ns};
+        ++slab.ring_written;
+    }
+    slab.unlock_ring();
+}
+
+// Exporters
+std::string to_prometheus(const TelemetrySnapshot& snapshot) {
+    std::ostringstream out;
+    out.precision(15);
+    std::string previous;
+
+    auto header = [&](const std::string& name, const char* type) {
+        if (name != previous) {
+            out << "# TYPE " << name << " " << type << "\n";
+            previous = name;
+        }
+    };
+    auto labels = [](bool from_source, uint32_t instance) {
+        return from_source ? "{instance=\"" + std::to_string(instance) + "\"}" : std::string();
+    };
+
+    // Every instance of a source's metric goes under one family
+    auto counters = snapshot.counters;
+    auto gauges = snapshot.gauges;
+    auto by_name = [](const auto& a, const auto& b) { return a.name < b.name; };
+    std::stable_sort(counters.begin(), counters.end(), by_name);
+    std::stable_sort(gauges.begin(), gauges.end(), by_name);
+
+    for (const auto& counter : counters) {
+        const std::string name = prometheus_name(counter.name) + "_total";
+        header(name, "counter");
+        out << name << labels(counter.from_source, counter.instance) << " " << counter.value << "\n";
+    }
+    for (const auto& gauge : gauges) {
+        const std::string name = prometheus_name(gauge.name);
+        header(name, "gauge");
+        out << name << labels(true, gauge.instance) << " " << gauge.value << "\n";
+    }
+    for (const auto& histogram : snapshot.histograms) {
+        std::string name = prometheus_name(histogram.name);
+        if (histogram.unit == "ns") {
+            name += "_nanoseconds";
+        } else if (!histogram.unit.empty()) {
+            name += "_" + prometheus_name(histogram.unit).substr(4);
+        }
+        header(name, "histogram");
+
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i + 1 < HISTOGRAM_BUCKETS; ++i) {
+            cumulative += histogram.buckets[i];
+            out << name << "_bucket{le=\"" << bucket_upper_bound(i) << "\"} " << cumulative << "\n";
+        }
+        out << name << "_bucket{le=\"+Inf\"} " << histogram.count << "\n";
+        out << name << "_sum " << histogram.sum << "\n";
+        out << name << "_count " << histogram.count << "\n";
+    }
+    return out.str();
+}
+
+std::string to_chrome_trace(const TraceCapture& capture) {
+    std::ostringstream out;
+    out << "{\"traceEvents\":[";
+    const char* separator = "";
+    for (const auto& [thread, name] : capture.thread_names) {
+        out << separator << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread
+            << ",\"args\":{\"name\":" << json_string(name) << "}}";
+        separator = ",";
+    }
+    for (const TraceCapture::Event& event : capture.events) {
+        const std::string_view name =
+            event.span < capture.span_names.size() ? std::string_view(capture.span_names[event.span]) : "unknown";
+        const std::string_view category = event.span < capture.span_categories.size()
+            ? std::string_view(capture.span_categories[event.span])
+            : name.substr(0, name.find('.'));
+
+        // Complete events, in microseconds
+        char times[64];
+        std::snprintf(times, sizeof(times), "\"ts\":%.3f,\"dur\":%.3f",
+                      static_cast<double>(event.start_ns) / 1000.0, static_cast<double>(event.duration_ns) / 1000.0);
+        out << separator << "\n{\"name\":" << json_string(name) << ",\"cat\":" << json_string(category)
+            << ",\"ph\":\"X\"," << times << ",\"pid\":1,\"tid\":" << event.thread << "}";
+        separator = ",";
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":" << capture.dropped << "}}\n";
+    return out.str();
+}
+
+} // namespace QuantumCanvas::Core
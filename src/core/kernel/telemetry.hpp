@@ -0,0 +1,315 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace QuantumCanvas::Core {
+
+using MetricId = uint32_t;
+
+constexpr MetricId INVALID_METRIC = ~MetricId(0);
+
+// Values with the same bit width share a bucket: bucket 0 holds zero and
+// bucket i holds [2^(i-1), 2^i), the last one everything above
+constexpr size_t HISTOGRAM_BUCKETS = 48;
+
+// Monotonic count, summed over every thread that added to it. A default
+// constructed counter is unregistered and drops its updates.
+class Counter {
+public:
+    Counter() = default;
+
+    void add(uint64_t amount = 1) const;
+    MetricId id() const { return id_; }
+
+private:
+    friend class Telemetry;
+    explicit Counter(MetricId id) : id_(id) {}
+
+    MetricId id_ = INVALID_METRIC;
+};
+
+// Distribution of non-negative integer samples in log2 buckets, with their
+// exact count and sum
+class Histogram {
+public:
+    Histogram() = default;
+
+    void record(uint64_t value) const;
+    MetricId id() const { return id_; }
+
+private:
+    friend class Telemetry;
+    explicit Histogram(MetricId id) : id_(id) {}
+
+    MetricId id_ = INVALID_METRIC;
+};
+
+// Times the enclosing scope into a span's histogram, in nanoseconds, and
+// while a trace capture runs also records it as a trace event
+class TraceSpan {
+public:
+    explicit TraceSpan(const Histogram& span);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    MetricId id_;
+    uint64_t start_ns_;
+};
+
+// Everything registered, summed over threads at one moment
+struct TelemetrySnapshot {
+    struct CounterValue {
+        std::string name;
+        uint64_t value = 0;
+        uint32_t instance = 0;  // Which of several sources of the same name
+        bool from_source = false;
+    };
+
+    struct GaugeValue {
+        std::string name;
+        double value = 0.0;
+        uint32_t instance = 0;
+    };
+
+    struct HistogramValue {
+        std::string name;
+        std::string unit;
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        std::array<uint64_t, HISTOGRAM_BUCKETS> buckets{};
+
+        // Upper bound of the bucket holding the q-th quantile, 0 <= q <= 1
+        uint64_t quantile(double q) const;
+        double mean() const { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+    };
+
+    std::vector<CounterValue> counters;
+    std::vector<GaugeValue> gauges;
+    std::vector<HistogramValue> histograms;
+    std::chrono::system_clock::time_point taken_at;
+
+    // Null if absent; source metrics match their first instance
+    const CounterValue* find_counter(std::string_view name) const;
+    const GaugeValue* find_gauge(std::string_view name) const;
+    const HistogramValue* find_histogram(std::string_view name) const;
+};
+
+// Spans recorded between start_capture() and stop_capture()
+struct TraceCapture {
+    struct Event {
+        MetricId span = INVALID_METRIC;
+        uint32_t thread = 0;       // Serial of the recording thread, from 1
+        uint64_t start_ns = 0;     // Since the process started tracing
+        uint64_t duration_ns = 0;
+    };
+
+    std::vector<std::string> span_names;       // By span id
+    std::vector<std::string> span_categories;  // By span id; without one, the name up to its first dot
+    std::vector<std::pair<uint32_t, std::string>> thread_names;  // Track labels, by thread
+    std::vector<Event> events;                 // Sorted by start
+    uint64_t dropped = 0;                      // Overwritten in full per-thread rings
+};
+
+// Where sources write what their module's stats struct holds. Names are
+// prefixed with the source's name.
+class MetricWriter {
+public:
+    void counter(std::string_view name, uint64_t value);
+    void gauge(std::string_view name, double value);
+
+private:
+    friend class Telemetry;
+    MetricWriter(TelemetrySnapshot& snapshot, std::string_view prefix, uint32_t instance);
+
+    TelemetrySnapshot& snapshot_;
+    std::string prefix_;
+    uint32_t instance_;
+};
+
+// Always-on counters, histograms and trace spans shared by every module
+//
+// Metrics are registered once by name, usually into a static, and updated
+// through their handles. Each thread updates its own slab of slots with
+// relaxed loads and stores, so an update costs a few nanoseconds, takes no
+// lock and shares no cache line with another thread; snapshot() sums the
+// slabs. The slab of a thread that exits passes, totals intact, to the
+// next thread that starts updating.
+//
+// Modules that keep their own stats struct join through sources: callbacks
+// that write it into the snapshot when one is taken. A span is a histogram
+// in nanoseconds that TraceSpan and QCS_TRACE_SCOPE fill; while a capture
+// runs, spans are also kept as trace events in a ring per thread.
+class Telemetry {
+public:
+    static constexpr size_t MAX_COUNTERS = 256;
+    static constexpr size_t MAX_HISTOGRAMS = 64;
+    static constexpr size_t DEFAULT_TRACE_EVENTS = size_t(1) << 16;  // Per thread
+
+    using Source = std::function<void(MetricWriter& writer)>;
+
+    // Unregisters its source when destroyed, waiting out a snapshot using
+    // it. A source reads its owner's members, so the owner declares the
+    // registration after all of them: members are destroyed in reverse
+    // order, and the source is gone before anything it reads.
+    class SourceRegistration {
+    public:
+        SourceRegistration() = default;
+        ~SourceRegistration() { reset(); }
+
+        SourceRegistration(SourceRegistration&& other) noexcept : id_(other.id_) { other.id_ = 0; }
+        SourceRegistration& operator=(SourceRegistration&& other) noexcept;
+        SourceRegistration(const SourceRegistration&) = delete;
+        SourceRegistration& operator=(const SourceRegistration&) = delete;
+
+        void reset();
+
+    private:
+        friend class Telemetry;
+        explicit SourceRegistration(uint64_t id) : id_(id) {}
+
+        uint64_t id_ = 0;
+    };
+
+    // Never destroyed, so threads may update metrics while the process exits
+    static Telemetry& instance();
+
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+
+    // The same name returns the same metric. Throws std::runtime_error when
+    // all slots of the kind are taken.
+    Counter counter(std::string_view name);
+    Histogram histogram(std::string_view name, std::string_view unit = {});
+    Histogram span(std::string_view name) { return histogram(name, "ns"); }
+
+    // Sources run while a snapshot is taken, on that thread, and must not
+    // register or unregister sources themselves
+    [[nodiscard]] SourceRegistration add_source(std::string_view name, Source source);
+
+    // A source for a module's stats struct: get copies it, under the
+    // module's own lock, and write puts the copy into the snapshot
+    template<typename Owner, typename Stats>
+    [[nodiscard]] SourceRegistration add_stats_source(std::string_view name, const Owner& owner,
+                                                      Stats (Owner::*get)() const,
+                                                      void (*write)(const Stats& stats, MetricWriter& writer)) {
+        return add_source(name, [&owner, get, write](MetricWriter& writer) { write((owner.*get)(), writer); });
+    }
+
+    // Disabled, updates and spans return at once; what was counted stays
+    static void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    static bool is_enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    TelemetrySnapshot snapshot() const;
+
+    // Starting a capture discards one already running
+    void start_capture(size_t events_per_thread = DEFAULT_TRACE_EVENTS);
+    TraceCapture stop_capture();
+    bool is_capturing() const { return capturing_.load(std::memory_order_relaxed); }
+
+    // Nanoseconds on the clock trace events use
+    static uint64_t now_ns();
+
+private:
+    friend class Counter;
+    friend class Histogram;
+    friend class TraceSpan;
+
+    struct HistogramSlots {
+        std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> buckets{};
+        std::atomic<uint64_t> sum{0};
+    };
+
+    // One thread's slots. Only the owner writes them; readers sum them.
+    struct alignas(64) Slab {
+        std::array<std::atomic<uint64_t>, MAX_COUNTERS> counters{};
+        std::array<HistogramSlots, MAX_HISTOGRAMS> histograms{};
+        uint32_t thread = 0;
+
+        // Trace ring, guarded by its flag: the owner appends, captures
+        // allocate and drain it
+        std::atomic<bool> ring_locked{false};
+        std::unique_ptr<TraceCapture::Event[]> ring;
+        size_t ring_size = 0;
+        uint64_t ring_written = 0;
+
+        void lock_ring();
+        void unlock_ring() { ring_locked.store(false, std::memory_order_release); }
+    };
+
+    struct MetricInfo {
+        std::string name;
+        std::string unit;
+    };
+
+    struct SourceEntry {
+        uint64_t id;
+        std::string name;
+        uint32_t instance;
+        Source source;
+    };
+
+    // Holds the calling thread's slab, returned when the thread exits
+    struct SlabLease;
+
+    Telemetry();
+
+    static Slab& local_slab();
+    Slab* acquire_slab();
+    void release_slab(Slab* slab);
+    void record_event(Slab& slab, MetricId span, uint64_t start_ns, uint64_t duration_ns);
+
+    static std::atomic<bool> enabled_;
+
+    std::atomic<bool> capturing_{false};
+    const std::chrono::steady_clock::time_point epoch_;
+
+    mutable std::mutex metrics_mutex_;
+    std::vector<MetricInfo> counter_info_;
+    std::vector<MetricInfo> histogram_info_;
+
+    // Slabs are never freed, only passed to new threads
+    mutable std::mutex slabs_mutex_;
+    std::vector<std::unique_ptr<Slab>> slabs_;
+    std::vector<Slab*> free_slabs_;
+    uint32_t next_thread_ = 1;
+    size_t ring_size_ = 0;  // Of the capture running, 0 if none
+
+    mutable std::mutex sources_mutex_;
+    std::vector<SourceEntry> sources_;
+    uint64_t next_source_ = 1;
+};
+
+// Prometheus text exposition format. Names are prefixed "qcs_" with dots
+// turned into underscores; counters gain "_total", spans "_nanoseconds",
+// and source metrics an instance label.
+std::string to_prometheus(const TelemetrySnapshot& snapshot);
+
+// Chrome trace event JSON, for chrome://tracing or Perfetto. Rendering's
+// Profiler exports through this too, on the same clock.
+std::string to_chrome_trace(const TraceCapture& capture);
+
+} // namespace QuantumCanvas::Core
+
+#define QCS_TRACE_CONCAT_INNER(a, b) a##b
+#define QCS_TRACE_CONCAT(a, b) QCS_TRACE_CONCAT_INNER(a, b)
+
+// Times the rest of the scope as the named span, registered on first use
+#define QCS_TRACE_SCOPE(name)                                                                   \
+    static const ::QuantumCanvas::Core::Histogram QCS_TRACE_CONCAT(qcs_trace_span_, __LINE__) = \
+        ::QuantumCanvas::Core::Telemetry::instance().span(name);                                \
+    const ::QuantumCanvas::Core::TraceSpan QCS_TRACE_CONCAT(qcs_trace_scope_, __LINE__)(        \
+        QCS_TRACE_CONCAT(qcs_trace_span_, __LINE__))
@@ -16,23 +16,238 @@
 #include <cstdlib>
 #include <chrono>
 #include <sstream>
+#include <new>
 
 #ifdef _WIN32
     #include <windows.h>
     #include <malloc.h>
 #elif defined(__linux__)
     #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
     #include <unistd.h>
 #elif defined(__APPLE__)
     #include <mach/mach.h>
     #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
 #endif
 
 namespace QuantumCanvas::Core {
 
+namespace {
+    std::atomic<uint64_t> next_instance_id{1};
+    std::atomic<size_t> next_stats_shard{0};
+    thread_local int thread_numa_node = -1;
+    
+    // Prefer (not require) the given node for the pages of a fresh mapping; must run
+    // before first touch. Raw syscall so we don't depend on libnuma.
+    bool bind_to_numa_node(void* ptr, size_t size, int node) {
+    #if defined(__linux__) && defined(SYS_mbind)
+        constexpr int MPOL_PREFERRED_POLICY = 1;
+        constexpr size_t MASK_WORD_BITS = sizeof(unsigned long) * 8;
+        constexpr size_t MAX_NODES = 1024;
+        if (node < 0 || static_cast<size_t>(node) >= MAX_NODES - 1) {
+            return false;
+        }
+        unsigned long mask[MAX_NODES / MASK_WORD_BITS] = {};
+        mask[node / MASK_WORD_BITS] |= 1UL << (node % MASK_WORD_BITS);
+        return syscall(SYS_mbind, ptr, size, MPOL_PREFERRED_POLICY, mask, MAX_NODES, 0) == 0;
+    #else
+        (void)ptr;
+        (void)size;
+        (void)node;
+        return false;
+    #endif
+    }
+}
+
+// Per-thread magazine of free blocks for every pool of one manager
+struct MemoryManager::ThreadCache {
+    struct Magazine {
+        std::array<void*, MAGAZINE_CAPACITY> blocks{};
+        size_t count = 0;
+    };
+    std::array<Magazine, NUM_POOLS> magazines;
+    MemoryManager* owner = nullptr;  // Guarded by thread_cache_registry_mutex()
+};
+
+// Thread-local list of caches, one per manager this thread has allocated from.
+// On thread exit the cached blocks are handed back to any manager still alive.
+struct MemoryManager::ThreadCacheHolder {
+    struct Slot {
+        uint64_t owner_id;
+        std::shared_ptr<ThreadCache> cache;
+    };
+    std::vector<Slot> slots;
+    uint64_t last_owner_id = 0;
+    ThreadCache* last_cache = nullptr;
+    
+    ~ThreadCacheHolder() {
+        std::lock_guard<std::mutex> lock(thread_cache_registry_mutex());
+        for (auto& slot : slots) {
+            if (slot.cache->owner) {
+                slot.cache->owner->return_thread_cache(*slot.cache);
+                auto& caches = slot.cache->owner->thread_caches_;
+                caches.erase(std::remove(caches.begin(), caches.end(), slot.cache), caches.end());
+                slot.cache->owner = nullptr;
+            }
+        }
+    }
+};
+
+// A span is one page-aligned system allocation: either a binned size-class
+// buffer (recycled through size_class_bins_) or an individual large allocation
+struct MemoryManager::Span {
+    enum class Backing : uint8_t {
+        Heap,              // posix_memalign / _aligned_malloc
+        Mapped,            // Anonymous mapping with ordinary pages
+        TransparentHuge,   // Huge-page aligned mapping advised for THP
+        ExplicitHuge       // Reserved huge pages
+    };
+    
+    void* base;
+    size_t size;         // Bytes reserved, a multiple of SPAN_PAGE_SIZE
+    size_t alignment;
+    size_t size_class;   // NUM_SIZE_CLASSES for unbinned large allocations
+    Backing backing = Backing::Heap;
+    bool numa_bound = false;
+};
+
+// Three-level radix tree from page number to owner. Entries are tagged words:
+// pool pages store (pool_index << 1) | 1, span pages store the Span pointer.
+// Pools register every page so interior pointers resolve; spans only register
+// their first page since they are always freed through their base address.
+// Lookups and updates are lock-free; nodes are only freed with the map.
+class MemoryManager::PageMap {
+public:
+    static constexpr size_t ADDRESS_BITS = 48;
+    static constexpr size_t LEAF_BITS = 12;
+    static constexpr size_t MID_BITS = 12;
+    static constexpr size_t ROOT_BITS = ADDRESS_BITS - SPAN_PAGE_SHIFT - LEAF_BITS - MID_BITS;
+    
+    static constexpr uintptr_t POOL_TAG = 1;
+    
+    ~PageMap() {
+        for (auto& root_entry : root_) {
+            Mid* mid = root_entry.load(std::memory_order_relaxed);
+            if (!mid) {
+                continue;
+            }
+            for (auto& mid_entry : mid->leaves) {
+                delete mid_entry.load(std::memory_order_relaxed);
+            }
+            delete mid;
+        }
+    }
+    
+    uintptr_t lookup(const void* ptr) const {
+        uint64_t address = reinterpret_cast<uintptr_t>(ptr);
+        if (address >> ADDRESS_BITS) {
+            return 0;
+        }
+        uint64_t page = address >> SPAN_PAGE_SHIFT;
+        Mid* mid = root_[page >> (MID_BITS + LEAF_BITS)].load(std::memory_order_acquire);
+        if (!mid) {
+            return 0;
+        }
+        Leaf* leaf = mid->leaves[(page >> LEAF_BITS) & mask(MID_BITS)].load(std::memory_order_acquire);
+        if (!leaf) {
+            return 0;
+        }
+        return leaf->entries[page & mask(LEAF_BITS)].load(std::memory_order_acquire);
+    }
+    
+    bool set(const void* ptr, uintptr_t value) {
+        uint64_t address = reinterpret_cast<uintptr_t>(ptr);
+        if (address >> ADDRESS_BITS) {
+            return false;
+        }
+        uint64_t page = address >> SPAN_PAGE_SHIFT;
+        Mid* mid = get_or_create(root_[page >> (MID_BITS + LEAF_BITS)]);
+        Leaf* leaf = get_or_create(mid->leaves[(page >> LEAF_BITS) & mask(MID_BITS)]);
+        leaf->entries[page & mask(LEAF_BITS)].store(value, std::memory_order_release);
+        return true;
+    }
+    
+    bool set_range(const void* begin, size_t size, uintptr_t value) {
+        const uint8_t* page = static_cast<const uint8_t*>(begin);
+        for (size_t offset = 0; offset < size; offset += SPAN_PAGE_SIZE) {
+            if (!set(page + offset, value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    // Visit every non-empty entry; not safe against concurrent updates
+    template<typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const auto& root_entry : root_) {
+            Mid* mid = root_entry.load(std::memory_order_acquire);
+            if (!mid) {
+                continue;
+            }
+            for (const auto& mid_entry : mid->leaves) {
+                Leaf* leaf = mid_entry.load(std::memory_order_acquire);
+                if (!leaf) {
+                    continue;
+                }
+                for (const auto& entry : leaf->entries) {
+                    uintptr_t value = entry.load(std::memory_order_acquire);
+                    if (value) {
+                        fn(value);
+                    }
+                }
+            }
+        }
+    }
+    
+private:
+    struct Leaf {
+        std::array<std::atomic<uintptr_t>, size_t(1) << LEAF_BITS> entries{};
+    };
+    struct Mid {
+        std::array<std::atomic<Leaf*>, size_t(1) << MID_BITS> leaves{};
+    };
+    
+    std::array<std::atomic<Mid*>, size_t(1) << ROOT_BITS> root_{};
+    
+    static constexpr uint64_t mask(size_t bits) { return (uint64_t(1) << bits) - 1; }
+    
+    template<typename Node>
+    static Node* get_or_create(std::atomic<Node*>& slot) {
+        Node* node = slot.load(std::memory_order_acquire);
+        if (node) {
+            return node;
+        }
+        auto* created = new Node();
+        if (slot.compare_exchange_strong(node, created, std::memory_order_acq_rel)) {
+            return created;
+        }
+        delete created;  // Lost the race; node now holds the winner
+        return node;
+    }
+};
+
+std::mutex& MemoryManager::thread_cache_registry_mutex() {
+    static std::mutex registry_mutex;
+    return registry_mutex;
+}
+
 // Implementation of MemoryManager
 MemoryManager::MemoryManager(size_t initial_heap_size) 
-    : memory_limit_(initial_heap_size * 2) { // Set limit to 2x initial heap size
+    : page_map_(std::make_unique<PageMap>())
+    , instance_id_(next_instance_id.fetch_add(1, std::memory_order_relaxed))
+    , memory_limit_(initial_heap_size * 2) { // Set limit to 2x initial heap size
+    
+    // Size classes: MIN_SIZE_CLASS doubling up to MAX_SIZE_CLASS in quarter steps
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        size_t octave = MIN_SIZE_CLASS << (i / SIZE_CLASS_STEPS);
+        size_class_sizes_[i] = octave + (octave / SIZE_CLASS_STEPS) * (i % SIZE_CLASS_STEPS);
+    }
     
     // Initialize memory pools with default configurations
     for (size_t i = 0; i < NUM_POOLS; ++i) {
@@ -51,16 +266,25 @@ MemoryManager::~MemoryManager() {
         check_leaks();
     }
     
-    // Clean up large allocations
+    // Detach thread caches so exiting threads don't return blocks to freed pools
     {
-        std::lock_guard<std::mutex> lock(large_alloc_mutex_);
-        for (auto& [ptr, info] : large_allocations_) {
-            #ifdef _WIN32
-                _aligned_free(ptr);
-            #else
-                free(ptr);
-            #endif
+        std::lock_guard<std::mutex> lock(thread_cache_registry_mutex());
+        for (auto& cache : thread_caches_) {
+            cache->owner = nullptr;
         }
+        thread_caches_.clear();
+    }
+    
+    // Clean up large allocations and cached spans - each span is registered
+    // under exactly one page, so the map doubles as the registry of live spans
+    std::vector<Span*> spans;
+    page_map_->for_each([&spans](uintptr_t value) {
+        if (!(value & PageMap::POOL_TAG)) {
+            spans.push_back(reinterpret_cast<Span*>(value));
+        }
+    });
+    for (Span* span : spans) {
+        release_span(span);
     }
     
     // Pools are automatically cleaned up via RAII
@@ -68,6 +292,10 @@ MemoryManager::~MemoryManager() {
 }
 
 void* MemoryManager::allocate(size_t size, size_t alignment) {
+    return allocate_with_hint(size, alignment, AllocationHint::None);
+}
+
+void* MemoryManager::allocate_with_hint(size_t size, size_t alignment, AllocationHint hint) {
     if (size == 0) {
         return nullptr;
     }
@@ -78,23 +306,24 @@ void* MemoryManager::allocate(size_t size, size_t alignment) {
     }
     
     // Check memory limit
-    if (memory_limit_ > 0 && stats_.current_usage + size > memory_limit_) {
+    if (memory_limit_ > 0 && current_usage_.load(std::memory_order_relaxed) + size > memory_limit_) {
         throw std::bad_alloc();
     }
     
     void* ptr = nullptr;
     bool from_pool = false;
     
-    // Try to allocate from pools first for small allocations
-    size_t pool_index = find_pool_index(size);
-    if (pool_index < NUM_POOLS && alignment <= alignof(std::max_align_t)) {
+    // Try to allocate from pools first for small allocations. Pool blocks are
+    // power-of-two sized from a page-aligned base, so they are naturally aligned
+    size_t pool_index = alignment <= SPAN_PAGE_SIZE ? find_pool_index(std::max(size, alignment)) : NUM_POOLS;
+    if (pool_index < NUM_POOLS) {
         ptr = allocate_from_pool(pool_index);
-        from_pool = true;
+        from_pool = ptr != nullptr;
     }
     
     // Fall back to large allocation
     if (!ptr) {
-        ptr = allocate_large(size, alignment);
+        ptr = allocate_large(size, alignment, hint);
     }
     
     if (ptr) {
@@ -112,27 +341,12 @@ void MemoryManager::deallocate(void* ptr, size_t size) {
         return;
     }
     
-    bool deallocated = false;
-    
-    // Try pool deallocation first
-    size_t pool_index = find_pool_index(size);
-    if (pool_index < NUM_POOLS) {
-        // Check if this pointer belongs to the pool
-        auto& pool = pools_[pool_index];
-        std::lock_guard<std::mutex> lock(pool.mutex);
-        
-        uint8_t* pool_start = pool.memory.get();
-        uint8_t* pool_end = pool_start + (pool.block_count * pool.block_size);
-        
-        if (ptr >= pool_start && ptr < pool_end) {
-            deallocate_to_pool(ptr, pool_index);
-            deallocated = true;
-        }
-    }
-    
-    // Large allocation deallocation
-    if (!deallocated) {
-        deallocate_large(ptr);
+    // Resolve the owner from the address alone
+    uintptr_t owner = page_map_->lookup(ptr);
+    if (owner & PageMap::POOL_TAG) {
+        deallocate_to_pool(ptr, owner >> 1);
+    } else if (owner && reinterpret_cast<Span*>(owner)->base == ptr) {
+        deallocate_large(reinterpret_cast<Span*>(owner));
     }
     
     update_stats_deallocation(size);
@@ -141,68 +355,86 @@ void MemoryManager::deallocate(void* ptr, size_t size) {
     }
 }
 
-void* MemoryManager::allocate_aligned(size_t size, size_t alignment) {
-    if (alignment <= alignof(std::max_align_t)) {
-        return allocate(size, alignment);
-    }
-    
-    // For large alignments, use system-specific aligned allocation
-    void* ptr = nullptr;
-    
-    #ifdef _WIN32
-        ptr = _aligned_malloc(size, alignment);
-    #else
-        if (posix_memalign(&ptr, alignment, size) != 0) {
-            ptr = nullptr;
-        }
-    #endif
-    
-    if (ptr) {
-        // Track as large allocation
-        std::lock_guard<std::mutex> lock(large_alloc_mutex_);
-        large_allocations_[ptr] = {ptr, size, alignment};
-        update_stats_allocation(size, false);
-        if (tracking_enabled_) {
-            track_allocation(ptr, size);
-        }
+void* MemoryManager::allocate_aligned(size_t size, size_t alignment, AllocationHint hint) {
+    // Pools, size classes and large spans all honour alignment directly
+    return allocate_with_hint(size, alignment, hint);
+}
+
+void MemoryManager::deallocate_aligned(void* ptr, size_t size, size_t /*alignment*/) {
+    // The page map finds the owner from the address; alignment changes nothing
+    deallocate(ptr, size);
+}
+
+bool MemoryManager::owns(const void* ptr) const {
+    uintptr_t owner = page_map_->lookup(ptr);
+    if (owner & PageMap::POOL_TAG) {
+        return true;
     }
-    
-    return ptr;
+    return owner && reinterpret_cast<Span*>(owner)->base == ptr;
 }
 
-void MemoryManager::deallocate_aligned(void* ptr, size_t size, size_t alignment) {
-    if (!ptr) {
-        return;
+MemoryStats MemoryManager::get_stats() const {
+    MemoryStats stats;
+    for (const auto& shard : stat_shards_) {
+        stats.total_allocated += shard.total_allocated.load(std::memory_order_relaxed);
+        stats.total_deallocated += shard.total_deallocated.load(std::memory_order_relaxed);
+        stats.allocation_count += shard.allocation_count.load(std::memory_order_relaxed);
+        stats.deallocation_count += shard.deallocation_count.load(std::memory_order_relaxed);
+        stats.pool_hits += shard.pool_hits.load(std::memory_order_relaxed);
+        stats.pool_misses += shard.pool_misses.load(std::memory_order_relaxed);
+        stats.size_class_hits += shard.size_class_hits.load(std::memory_order_relaxed);
     }
-    
-    // Remove from large allocations tracking
-    {
-        std::lock_guard<std::mutex> lock(large_alloc_mutex_);
-        auto it = large_allocations_.find(ptr);
-        if (it != large_allocations_.end()) {
-            #ifdef _WIN32
-                _aligned_free(ptr);
-            #else
-                free(ptr);
-            #endif
-            large_allocations_.erase(it);
-        }
+    stats.size_class_cached_bytes = size_class_cached_bytes_.load(std::memory_order_relaxed);
+    stats.large_span_bytes = large_span_bytes_.load(std::memory_order_relaxed);
+    stats.huge_page_bytes = huge_page_bytes_.load(std::memory_order_relaxed);
+    stats.explicit_huge_page_bytes = explicit_huge_page_bytes_.load(std::memory_order_relaxed);
+    stats.numa_bound_bytes = numa_bound_bytes_.load(std::memory_order_relaxed);
+    stats.current_usage = current_usage_.load(std::memory_order_relaxed);
+    stats.peak_usage = peak_usage_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void MemoryManager::reset_stats() {
+    for (auto& shard : stat_shards_) {
+        shard.total_allocated.store(0, std::memory_order_relaxed);
+        shard.total_deallocated.store(0, std::memory_order_relaxed);
+        shard.allocation_count.store(0, std::memory_order_relaxed);
+        shard.deallocation_count.store(0, std::memory_order_relaxed);
+        shard.pool_hits.store(0, std::memory_order_relaxed);
+        shard.pool_misses.store(0, std::memory_order_relaxed);
+        shard.size_class_hits.store(0, std::memory_order_relaxed);
     }
-    
-    update_stats_deallocation(size);
-    if (tracking_enabled_) {
-        track_deallocation(ptr);
+    // Live usage is state, not a statistic - keep it so later frees don't underflow
+    peak_usage_.store(current_usage_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void MemoryManager::flush_thread_cache() {
+    auto& cache = get_thread_cache();
+    for (size_t i = 0; i < NUM_POOLS; ++i) {
+        drain_magazine(i, cache, 0);
     }
 }
 
-MemoryStats MemoryManager::get_stats() const {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-    return stats_;
+void MemoryManager::set_thread_numa_node(int node) {
+    thread_numa_node = node < 0 ? -1 : node;
 }
 
-void MemoryManager::reset_stats() {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-    stats_ = MemoryStats{};
+int MemoryManager::get_thread_numa_node() {
+    return thread_numa_node;
+}
+
+void MemoryManager::trim_size_class_cache() {
+    for (auto& bin : size_class_bins_) {
+        std::vector<Span*> spans;
+        {
+            std::lock_guard<std::mutex> lock(bin.mutex);
+            spans.swap(bin.free_spans);
+        }
+        for (Span* span : spans) {
+            size_class_cached_bytes_.fetch_sub(span->size, std::memory_order_relaxed);
+            release_span(span);
+        }
+    }
 }
 
 void MemoryManager::check_leaks() const {
@@ -272,6 +504,11 @@ void MemoryManager::resize_pool(size_t pool_index, size_t new_block_count) {
         return;
     }
     
+    // Blocks parked in the calling thread's magazine would otherwise pin the pool
+    if (thread_cache_enabled_) {
+        drain_magazine(pool_index, get_thread_cache(), 0);
+    }
+    
     auto& pool = pools_[pool_index];
     std::lock_guard<std::mutex> lock(pool.mutex);
     
@@ -295,7 +532,7 @@ void MemoryManager::defragment_pools() {
     
     std::cout << "[MemoryManager] Pool statistics:" << std::endl;
     for (size_t i = 0; i < NUM_POOLS; ++i) {
-        const auto& pool = pools_[i];
+        auto& pool = pools_[i];
         std::lock_guard<std::mutex> lock(pool.mutex);
         
         double usage = (double)pool.allocated_count / pool.block_count * 100.0;
@@ -321,19 +558,30 @@ void* MemoryManager::allocate_from_pool(size_t pool_index) {
         return nullptr;
     }
     
+    // Fast path: pop from this thread's magazine without touching shared state
+    if (thread_cache_enabled_.load(std::memory_order_relaxed)) {
+        auto& cache = get_thread_cache();
+        auto& magazine = cache.magazines[pool_index];
+        if (magazine.count == 0) {
+            refill_magazine(pool_index, cache);
+        }
+        if (magazine.count == 0) {
+            return nullptr; // Pool is exhausted
+        }
+        return magazine.blocks[--magazine.count];
+    }
+    
     auto& pool = pools_[pool_index];
     std::lock_guard<std::mutex> lock(pool.mutex);
     
-    if (pool.free_blocks.empty()) {
+    if (pool.free_blocks.empty() && !grow_pool(pool_index)) {
         // Pool is exhausted
-        stats_.pool_misses++;
         return nullptr;
     }
     
     void* ptr = pool.free_blocks.top();
     pool.free_blocks.pop();
     pool.allocated_count++;
-    stats_.pool_hits++;
     
     return ptr;
 }
@@ -344,58 +592,351 @@ void MemoryManager::deallocate_to_pool(void* ptr, size_t pool_index) {
     }
     
     auto& pool = pools_[pool_index];
-    // Note: mutex should already be locked by caller
-    
-    pool.free_blocks.push(ptr);
-    pool.allocated_count--;
     
     // Optional: clear memory for security/debugging
     #ifdef DEBUG
         std::memset(ptr, 0xDE, pool.block_size); // "Dead" pattern
     #endif
+    
+    // Fast path: push onto this thread's magazine, draining half when it is full
+    if (thread_cache_enabled_.load(std::memory_order_relaxed)) {
+        auto& cache = get_thread_cache();
+        auto& magazine = cache.magazines[pool_index];
+        if (magazine.count == MAGAZINE_CAPACITY) {
+            drain_magazine(pool_index, cache, MAGAZINE_CAPACITY / 2);
+        }
+        magazine.blocks[magazine.count++] = ptr;
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.free_blocks.push(ptr);
+    pool.allocated_count--;
+}
+
+MemoryManager::ThreadCache& MemoryManager::get_thread_cache() {
+    static thread_local ThreadCacheHolder holder;
+    
+    if (holder.last_owner_id == instance_id_) {
+        return *holder.last_cache;
+    }
+    
+    for (auto& slot : holder.slots) {
+        if (slot.owner_id == instance_id_) {
+            holder.last_owner_id = instance_id_;
+            holder.last_cache = slot.cache.get();
+            return *slot.cache;
+        }
+    }
+    
+    // First allocation from this manager on this thread - register a new cache
+    // and drop slots belonging to managers that have since been destroyed
+    std::lock_guard<std::mutex> lock(thread_cache_registry_mutex());
+    holder.slots.erase(
+        std::remove_if(holder.slots.begin(), holder.slots.end(),
+                      [](const ThreadCacheHolder::Slot& slot) {
+                          return slot.cache->owner == nullptr;
+                      }),
+        holder.slots.end()
+    );
+    
+    auto cache = std::make_shared<ThreadCache>();
+    cache->owner = this;
+    thread_caches_.push_back(cache);
+    holder.slots.push_back({instance_id_, cache});
+    
+    holder.last_owner_id = instance_id_;
+    holder.last_cache = cache.get();
+    return *cache;
+}
+
+void MemoryManager::refill_magazine(size_t pool_index, ThreadCache& cache) {
+    auto& pool = pools_[pool_index];
+    auto& magazine = cache.magazines[pool_index];
+    
+    // Transfer half a magazine per lock acquisition
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    if (pool.free_blocks.empty()) {
+        grow_pool(pool_index);
+    }
+    size_t transferred = 0;
+    while (magazine.count < MAGAZINE_CAPACITY / 2 && !pool.free_blocks.empty()) {
+        magazine.blocks[magazine.count++] = pool.free_blocks.top();
+        pool.free_blocks.pop();
+        ++transferred;
+    }
+    pool.allocated_count += transferred;
+}
+
+void MemoryManager::drain_magazine(size_t pool_index, ThreadCache& cache, size_t keep) {
+    auto& pool = pools_[pool_index];
+    auto& magazine = cache.magazines[pool_index];
+    if (magazine.count <= keep) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    size_t returned = magazine.count - keep;
+    while (magazine.count > keep) {
+        pool.free_blocks.push(magazine.blocks[--magazine.count]);
+    }
+    pool.allocated_count -= returned;
+}
+
+void MemoryManager::return_thread_cache(ThreadCache& cache) {
+    // Caller holds thread_cache_registry_mutex()
+    for (size_t i = 0; i < NUM_POOLS; ++i) {
+        drain_magazine(i, cache, 0);
+    }
 }
 
-void* MemoryManager::allocate_large(size_t size, size_t alignment) {
+MemoryManager::StatsShard& MemoryManager::local_stats_shard() {
+    static thread_local size_t shard_index =
+        next_stats_shard.fetch_add(1, std::memory_order_relaxed) % NUM_STAT_SHARDS;
+    return stat_shards_[shard_index];
+}
+
+void* MemoryManager::allocate_large(size_t size, size_t alignment, AllocationHint hint) {
+    bool huge_pages = wants_huge_pages(size, hint);
+    
+    size_t size_class = find_size_class(size);
+    if (!huge_pages && size_class < NUM_SIZE_CLASSES && alignment <= SPAN_PAGE_SIZE) {
+        auto& bin = size_class_bins_[size_class];
+        Span* span = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(bin.mutex);
+            if (!bin.free_spans.empty()) {
+                span = bin.free_spans.back();
+                bin.free_spans.pop_back();
+            }
+        }
+        
+        if (span) {
+            size_class_cached_bytes_.fetch_sub(span->size, std::memory_order_relaxed);
+            local_stats_shard().size_class_hits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            span = create_span(size_class_sizes_[size_class], SPAN_PAGE_SIZE, size_class);
+        }
+        if (span) {
+            account_span(span, true);
+        }
+        return span ? span->base : nullptr;
+    }
+    
+    // Huge pages and NUMA placement need a private mapping; fall back to the heap
+    Span* span = nullptr;
+    int numa_node = thread_numa_node;
+    if (huge_pages || numa_node >= 0) {
+        span = create_mapped_span(size, alignment, huge_pages, numa_node);
+    }
+    if (!span) {
+        span = create_span(align_up(size, SPAN_PAGE_SIZE), std::max(alignment, SPAN_PAGE_SIZE),
+                           NUM_SIZE_CLASSES);
+    }
+    if (span) {
+        account_span(span, true);
+    }
+    return span ? span->base : nullptr;
+}
+
+void MemoryManager::deallocate_large(Span* span) {
+    account_span(span, false);
+    
+    if (span->size_class < NUM_SIZE_CLASSES &&
+        size_class_cached_bytes_.load(std::memory_order_relaxed) + span->size <= size_class_cache_limit_) {
+        size_class_cached_bytes_.fetch_add(span->size, std::memory_order_relaxed);
+        auto& bin = size_class_bins_[span->size_class];
+        std::lock_guard<std::mutex> lock(bin.mutex);
+        bin.free_spans.push_back(span);
+        return;
+    }
+    
+    release_span(span);
+}
+
+size_t MemoryManager::find_size_class(size_t size) const {
+    if (size < MIN_SIZE_CLASS || size > MAX_SIZE_CLASS) {
+        return NUM_SIZE_CLASSES;
+    }
+    auto it = std::lower_bound(size_class_sizes_.begin(), size_class_sizes_.end(), size);
+    return static_cast<size_t>(it - size_class_sizes_.begin());
+}
+
+bool MemoryManager::wants_huge_pages(size_t size, AllocationHint hint) const {
+    if (has_hint(hint, AllocationHint::NoHugePages) || size < HUGE_PAGE_SIZE) {
+        return false;
+    }
+    if (has_hint(hint, AllocationHint::HugePages)) {
+        return true;
+    }
+    return huge_page_mode_ != HugePageMode::Disabled && size >= huge_page_threshold_;
+}
+
+MemoryManager::Span* MemoryManager::create_span(size_t size, size_t alignment, size_t size_class) {
     void* ptr = nullptr;
     
-    if (alignment <= alignof(std::max_align_t)) {
-        ptr = std::malloc(size);
-    } else {
+    #ifdef _WIN32
+        ptr = _aligned_malloc(size, alignment);
+    #else
+        if (posix_memalign(&ptr, alignment, size) != 0) {
+            ptr = nullptr;
+        }
+    #endif
+    
+    if (!ptr) {
+        return nullptr;
+    }
+    
+    auto* span = new Span{ptr, size, alignment, size_class};
+    if (!page_map_->set(ptr, reinterpret_cast<uintptr_t>(span))) {
+        // Address outside the mapped range; can never be freed through the map
+        delete span;
         #ifdef _WIN32
-            ptr = _aligned_malloc(size, alignment);
+            _aligned_free(ptr);
         #else
-            if (posix_memalign(&ptr, alignment, size) != 0) {
-                ptr = nullptr;
-            }
+            free(ptr);
         #endif
+        return nullptr;
     }
+    return span;
+}
+
+MemoryManager::Span* MemoryManager::create_mapped_span(size_t size, size_t alignment,
+                                                       bool huge_pages, int numa_node) {
+    void* ptr = nullptr;
+    auto backing = Span::Backing::Mapped;
+    bool explicit_pages = huge_pages && huge_page_mode_ == HugePageMode::Explicit;
     
-    if (ptr) {
-        std::lock_guard<std::mutex> lock(large_alloc_mutex_);
-        large_allocations_[ptr] = {ptr, size, alignment};
-    }
+    #ifdef _WIN32
+        const DWORD allocation_type = MEM_RESERVE | MEM_COMMIT;
+        auto map = [numa_node](size_t bytes, DWORD type) -> void* {
+            if (numa_node >= 0) {
+                return VirtualAllocExNuma(GetCurrentProcess(), nullptr, bytes, type, PAGE_READWRITE,
+                                          static_cast<DWORD>(numa_node));
+            }
+            return VirtualAlloc(nullptr, bytes, type, PAGE_READWRITE);
+        };
+        
+        // Large pages need SeLockMemoryPrivilege; without it this simply fails
+        SIZE_T large_page = GetLargePageMinimum();
+        if (explicit_pages && large_page && alignment <= large_page) {
+            size_t rounded = align_up(size, large_page);
+            ptr = map(rounded, allocation_type | MEM_LARGE_PAGES);
+            if (ptr) {
+                size = rounded;
+                backing = Span::Backing::ExplicitHuge;
+            }
+        }
+        
+        // Windows has no transparent huge pages; VirtualAlloc is 64KB aligned
+        if (!ptr) {
+            if (alignment > 64 * 1024) {
+                return nullptr;
+            }
+            size = align_up(size, SPAN_PAGE_SIZE);
+            ptr = map(size, allocation_type);
+        }
+        if (!ptr) {
+            return nullptr;
+        }
+        bool numa_bound = numa_node >= 0;
+    #else
+        #ifdef MAP_HUGETLB
+            if (explicit_pages) {
+                size_t rounded = align_up(size, HUGE_PAGE_SIZE);
+                void* mapping = mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                if (mapping != MAP_FAILED) {
+                    if (reinterpret_cast<uintptr_t>(mapping) % alignment == 0) {
+                        ptr = mapping;
+                        size = rounded;
+                        backing = Span::Backing::ExplicitHuge;
+                    } else {
+                        munmap(mapping, rounded);
+                    }
+                }
+            }
+        #endif
+        
+        if (!ptr) {
+            // Over-map and trim so the span starts on a huge-page boundary, which
+            // is what lets the kernel back it with huge pages at all
+            size_t map_alignment = std::max(alignment, huge_pages ? HUGE_PAGE_SIZE : SPAN_PAGE_SIZE);
+            size = align_up(size, huge_pages ? HUGE_PAGE_SIZE : SPAN_PAGE_SIZE);
+            size_t reserve = size + map_alignment - SPAN_PAGE_SIZE;
+            
+            void* mapping = mmap(nullptr, reserve, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (mapping == MAP_FAILED) {
+                return nullptr;
+            }
+            
+            uintptr_t begin = reinterpret_cast<uintptr_t>(mapping);
+            uintptr_t aligned = align_up(begin, map_alignment);
+            if (aligned > begin) {
+                munmap(mapping, aligned - begin);
+            }
+            size_t tail = (begin + reserve) - (aligned + size);
+            if (tail) {
+                munmap(reinterpret_cast<void*>(aligned + size), tail);
+            }
+            ptr = reinterpret_cast<void*>(aligned);
+            
+            #ifdef MADV_HUGEPAGE
+                if (huge_pages && madvise(ptr, size, MADV_HUGEPAGE) == 0) {
+                    backing = Span::Backing::TransparentHuge;
+                }
+            #endif
+        }
+        
+        bool numa_bound = numa_node >= 0 && bind_to_numa_node(ptr, size, numa_node);
+    #endif
     
-    return ptr;
+    auto* span = new Span{ptr, size, alignment, NUM_SIZE_CLASSES, backing, numa_bound};
+    if (!page_map_->set(ptr, reinterpret_cast<uintptr_t>(span))) {
+        release_span(span);
+        return nullptr;
+    }
+    return span;
 }
 
-void MemoryManager::deallocate_large(void* ptr) {
-    if (!ptr) {
-        return;
+void MemoryManager::release_span(Span* span) {
+    page_map_->set(span->base, 0);
+    
+    if (span->backing == Span::Backing::Heap) {
+        #ifdef _WIN32
+            _aligned_free(span->base);
+        #else
+            free(span->base);
+        #endif
+    } else {
+        #ifdef _WIN32
+            VirtualFree(span->base, 0, MEM_RELEASE);
+        #else
+            munmap(span->base, span->size);
+        #endif
     }
     
-    std::lock_guard<std::mutex> lock(large_alloc_mutex_);
-    auto it = large_allocations_.find(ptr);
-    if (it != large_allocations_.end()) {
-        if (it->second.alignment <= alignof(std::max_align_t)) {
-            std::free(ptr);
+    delete span;
+}
+
+void MemoryManager::account_span(const Span* span, bool in_use) {
+    auto adjust = [in_use, span](std::atomic<size_t>& counter) {
+        if (in_use) {
+            counter.fetch_add(span->size, std::memory_order_relaxed);
         } else {
-            #ifdef _WIN32
-                _aligned_free(ptr);
-            #else
-                free(ptr);
-            #endif
+            counter.fetch_sub(span->size, std::memory_order_relaxed);
         }
-        large_allocations_.erase(it);
+    };
+    
+    adjust(large_span_bytes_);
+    if (span->backing == Span::Backing::TransparentHuge || span->backing == Span::Backing::ExplicitHuge) {
+        adjust(huge_page_bytes_);
+    }
+    if (span->backing == Span::Backing::ExplicitHuge) {
+        adjust(explicit_huge_page_bytes_);
+    }
+    if (span->numa_bound) {
+        adjust(numa_bound_bytes_);
     }
 }
 
@@ -406,6 +947,20 @@ void MemoryManager::initialize_pool(size_t index, size_t block_size, size_t bloc
     
     auto& pool = pools_[index];
     
+    // Unmap the previous pool memory before it is released
+    if (pool.base) {
+        size_t primary_size = pool.range_end.load(std::memory_order_relaxed) -
+                              pool.range_begin.load(std::memory_order_relaxed);
+        page_map_->set_range(pool.base, align_up(primary_size, SPAN_PAGE_SIZE), 0);
+        
+        size_t slab_size = align_up(pool.block_size * growth_block_count(pool.block_size), SPAN_PAGE_SIZE);
+        for (const auto& slab : pool.growth_slabs) {
+            auto* slab_base = reinterpret_cast<uint8_t*>(align_up(reinterpret_cast<uintptr_t>(slab.get()), SPAN_PAGE_SIZE));
+            page_map_->set_range(slab_base, slab_size, 0);
+        }
+        pool.growth_slabs.clear();
+    }
+    
     // Clear existing pool
     pool.free_blocks = std::stack<void*>();
     pool.allocated_count = 0;
@@ -416,11 +971,17 @@ void MemoryManager::initialize_pool(size_t index, size_t block_size, size_t bloc
     pool.blocks_in_use = 0;
     pool.total_memory = block_size * block_count;
     
-    // Allocate memory for the pool
-    pool.memory = std::make_unique<uint8_t[]>(pool.total_memory);
+    // Allocate memory for the pool, padded so it can own whole pages
+    size_t mapped_size = align_up(pool.total_memory, SPAN_PAGE_SIZE);
+    pool.memory = std::make_unique<uint8_t[]>(mapped_size + SPAN_PAGE_SIZE);
+    pool.base = reinterpret_cast<uint8_t*>(align_up(reinterpret_cast<uintptr_t>(pool.memory.get()), SPAN_PAGE_SIZE));
+    pool.range_begin.store(reinterpret_cast<uintptr_t>(pool.base), std::memory_order_relaxed);
+    pool.range_end.store(reinterpret_cast<uintptr_t>(pool.base) + pool.total_memory,
+                         std::memory_order_relaxed);
+    page_map_->set_range(pool.base, mapped_size, (uintptr_t(index) << 1) | PageMap::POOL_TAG);
     
     // Initialize free block list
-    uint8_t* current = pool.memory.get();
+    uint8_t* current = pool.base;
     for (size_t i = 0; i < block_count; ++i) {
         pool.free_blocks.push(current);
         current += block_size;
@@ -430,30 +991,55 @@ void MemoryManager::initialize_pool(size_t index, size_t block_size, size_t bloc
               << block_count << " blocks of " << block_size << " bytes each" << std::endl;
 }
 
-void MemoryManager::update_stats_allocation(size_t size, bool from_pool) {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
+bool MemoryManager::grow_pool(size_t index) {
+    auto& pool = pools_[index];
     
-    stats_.total_allocated += size;
-    stats_.current_usage += size;
-    stats_.allocation_count++;
+    size_t block_count = growth_block_count(pool.block_size);
+    size_t slab_size = align_up(pool.block_size * block_count, SPAN_PAGE_SIZE);
+    auto slab = std::unique_ptr<uint8_t[]>(new (std::nothrow) uint8_t[slab_size + SPAN_PAGE_SIZE]);
+    if (!slab) {
+        return false;
+    }
     
-    if (stats_.current_usage > stats_.peak_usage) {
-        stats_.peak_usage = stats_.current_usage;
+    auto* slab_base = reinterpret_cast<uint8_t*>(align_up(reinterpret_cast<uintptr_t>(slab.get()), SPAN_PAGE_SIZE));
+    if (!page_map_->set_range(slab_base, slab_size, (uintptr_t(index) << 1) | PageMap::POOL_TAG)) {
+        return false;
     }
     
+    uint8_t* current = slab_base;
+    for (size_t i = 0; i < block_count; ++i) {
+        pool.free_blocks.push(current);
+        current += pool.block_size;
+    }
+    pool.block_count += block_count;
+    pool.total_memory += pool.block_size * block_count;
+    pool.growth_slabs.push_back(std::move(slab));
+    return true;
+}
+
+void MemoryManager::update_stats_allocation(size_t size, bool from_pool) {
+    auto& shard = local_stats_shard();
+    shard.total_allocated.fetch_add(size, std::memory_order_relaxed);
+    shard.allocation_count.fetch_add(1, std::memory_order_relaxed);
+    
     if (from_pool) {
-        stats_.pool_hits++;
+        shard.pool_hits.fetch_add(1, std::memory_order_relaxed);
     } else {
-        stats_.pool_misses++;
+        shard.pool_misses.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    size_t current = current_usage_.fetch_add(size, std::memory_order_relaxed) + size;
+    size_t peak = peak_usage_.load(std::memory_order_relaxed);
+    while (current > peak &&
+           !peak_usage_.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
     }
 }
 
 void MemoryManager::update_stats_deallocation(size_t size) {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-    
-    stats_.total_deallocated += size;
-    stats_.current_usage -= size;
-    stats_.deallocation_count++;
+    auto& shard = local_stats_shard();
+    shard.total_deallocated.fetch_add(size, std::memory_order_relaxed);
+    shard.deallocation_count.fetch_add(1, std::memory_order_relaxed);
+    current_usage_.fetch_sub(size, std::memory_order_relaxed);
 }
 
 void MemoryManager::track_allocation(void* ptr, size_t size) {
@@ -480,6 +1066,270 @@ void MemoryManager::track_deallocation(void* ptr) {
     tracked_allocations_.erase(ptr);
 }
 
+// FrameArena implementation
+FrameArena::FrameArena(size_t initial_size) {
+    blocks_.push_back(make_block(std::max<size_t>(initial_size, 64)));
+    capacity_ = blocks_.front()->size;
+    current_.store(blocks_.front().get(), std::memory_order_release);
+}
+
+FrameArena::~FrameArena() {
+    run_destructors();
+}
+
+std::unique_ptr<FrameArena::Block> FrameArena::make_block(size_t size) {
+    auto block = std::make_unique<Block>();
+    block->memory = std::make_unique<uint8_t[]>(size);
+    block->size = size;
+    return block;
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment) {
+    if (size == 0) {
+        size = 1;
+    }
+    
+    Block* block = current_.load(std::memory_order_acquire);
+    for (;;) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(block->memory.get());
+        size_t offset = block->offset.load(std::memory_order_relaxed);
+        
+        for (;;) {
+            size_t aligned = ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+            if (aligned + size > block->size) {
+                break;
+            }
+            if (block->offset.compare_exchange_weak(offset, aligned + size, std::memory_order_relaxed)) {
+                return block->memory.get() + aligned;
+            }
+        }
+        
+        void* ptr = allocate_slow(size, alignment, block);
+        if (ptr) {
+            return ptr;
+        }
+        block = current_.load(std::memory_order_acquire);
+    }
+}
+
+void* FrameArena::allocate_slow(size_t size, size_t alignment, Block* exhausted) {
+    std::lock_guard<std::mutex> lock(grow_mutex_);
+    
+    // Another thread already installed a fresh block; retry on it
+    if (current_.load(std::memory_order_acquire) != exhausted) {
+        return nullptr;
+    }
+    
+    size_t block_size = std::max(capacity_.load(std::memory_order_relaxed), size + alignment);
+    auto block = make_block(block_size);
+    
+    // Carve the request out before publishing so other threads can't exhaust it first
+    uintptr_t base = reinterpret_cast<uintptr_t>(block->memory.get());
+    size_t aligned = ((base + alignment - 1) & ~(alignment - 1)) - base;
+    block->offset.store(aligned + size, std::memory_order_relaxed);
+    void* ptr = block->memory.get() + aligned;
+    
+    capacity_.fetch_add(block_size, std::memory_order_relaxed);
+    overflow_count_.fetch_add(1, std::memory_order_relaxed);
+    current_.store(block.get(), std::memory_order_release);
+    blocks_.push_back(std::move(block));
+    return ptr;
+}
+
+void FrameArena::register_destructor(void* object, void (*destroy)(void*)) {
+    auto* node = static_cast<DestructorNode*>(allocate(sizeof(DestructorNode), alignof(DestructorNode)));
+    node->destroy = destroy;
+    node->object = object;
+    node->next = destructors_.load(std::memory_order_relaxed);
+    while (!destructors_.compare_exchange_weak(node->next, node,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+    }
+}
+
+void FrameArena::run_destructors() {
+    // The destructor list is LIFO, so objects die in reverse creation order
+    DestructorNode* node = destructors_.exchange(nullptr, std::memory_order_acquire);
+    while (node) {
+        DestructorNode* next = node->next;
+        node->destroy(node->object);
+        node = next;
+    }
+}
+
+void FrameArena::reset() {
+    run_destructors();
+    
+    std::lock_guard<std::mutex> lock(grow_mutex_);
+    
+    size_t used = 0;
+    for (const auto& block : blocks_) {
+        used += block->offset.load(std::memory_order_relaxed);
+    }
+    if (used > high_water_mark_.load(std::memory_order_relaxed)) {
+        high_water_mark_.store(used, std::memory_order_relaxed);
+    }
+    
+    if (blocks_.size() > 1) {
+        // Coalesce so a frame of the same size fits in a single block next time
+        size_t total = capacity_.load(std::memory_order_relaxed);
+        blocks_.clear();
+        blocks_.push_back(make_block(total));
+    } else {
+        blocks_.front()->offset.store(0, std::memory_order_relaxed);
+    }
+    
+    current_.store(blocks_.front().get(), std::memory_order_release);
+    frame_index_.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t FrameArena::bytes_used() const {
+    std::lock_guard<std::mutex> lock(grow_mutex_);
+    size_t used = 0;
+    for (const auto& block : blocks_) {
+        used += block->offset.load(std::memory_order_relaxed);
+    }
+    return used;
+}
+
+// MappedFile implementation
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+#ifdef _WIN32
+    , file_handle_(std::exchange(other.file_handle_, nullptr))
+    , mapping_handle_(std::exchange(other.mapping_handle_, nullptr))
+#endif
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+#ifdef _WIN32
+        file_handle_ = std::exchange(other.file_handle_, nullptr);
+        mapping_handle_ = std::exchange(other.mapping_handle_, nullptr);
+#endif
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::filesystem::path& path, Access access) {
+    close();
+    
+#ifdef _WIN32
+    DWORD flags = FILE_ATTRIBUTE_NORMAL;
+    if (access == Access::Sequential) flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+    if (access == Access::Random) flags |= FILE_FLAG_RANDOM_ACCESS;
+    
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, flags, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    
+    LARGE_INTEGER file_size;
+    if (GetFileType(file) != FILE_TYPE_DISK || !GetFileSizeEx(file, &file_size) ||
+        file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    
+    file_handle_ = file;
+    mapping_handle_ = mapping;
+    data_ = static_cast<const uint8_t*>(view);
+    size_ = static_cast<size_t>(file_size.QuadPart);
+    return true;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode) || file_stat.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    
+    // The mapping keeps the file referenced, so the descriptor can go now
+    const auto size = static_cast<size_t>(file_stat.st_size);
+    void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    
+    switch (access) {
+        case Access::Sequential: madvise(view, size, MADV_SEQUENTIAL); break;
+        case Access::Random: madvise(view, size, MADV_RANDOM); break;
+        case Access::Normal: break;
+    }
+    
+    data_ = static_cast<const uint8_t*>(view);
+    size_ = size;
+    return true;
+#endif
+}
+
+void MappedFile::prefetch(size_t offset, size_t length) const {
+    if (!data_ || offset >= size_) {
+        return;
+    }
+    length = std::min(length, size_ - offset);
+    
+#ifdef _WIN32
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+    WIN32_MEMORY_RANGE_ENTRY entry{const_cast<uint8_t*>(data_ + offset), length};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &entry, 0);
+#endif
+#else
+    // madvise takes page-aligned addresses; the view itself is page-aligned
+    const auto page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t begin = offset / page * page;
+    madvise(const_cast<uint8_t*>(data_) + begin, offset + length - begin, MADV_WILLNEED);
+#endif
+}
+
+void MappedFile::close() {
+    if (!data_) {
+        return;
+    }
+    
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_handle_);
+    CloseHandle(file_handle_);
+    mapping_handle_ = nullptr;
+    file_handle_ = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+    
+    data_ = nullptr;
+    size_ = 0;
+}
+
 } // namespace QuantumCanvas::Core
 
 // Debug macros for tracking allocations with file/line info
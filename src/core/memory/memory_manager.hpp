@@ -6,12 +6,41 @@
 #include <mutex>
 #include <atomic>
 #include <cstdint>
+#include <cstddef>
 #include <cstring>
 #include <array>
+#include <chrono>
+#include <string>
 #include <unordered_map>
+#include <filesystem>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
 
 namespace QuantumCanvas::Core {
 
+// Per-allocation hints for allocate_aligned
+enum class AllocationHint : uint32_t {
+    None = 0,
+    HugePages = 1 << 0,    // Prefer huge-page backing regardless of the threshold
+    NoHugePages = 1 << 1   // Never use huge pages, e.g. for short-lived staging buffers
+};
+
+inline AllocationHint operator|(AllocationHint a, AllocationHint b) {
+    return static_cast<AllocationHint>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+
+inline bool has_hint(AllocationHint hints, AllocationHint flag) {
+    return (static_cast<uint32_t>(hints) & static_cast<uint32_t>(flag)) != 0;
+}
+
+// How large allocations above the huge-page threshold are backed
+enum class HugePageMode {
+    Disabled,     // Ordinary pages
+    Transparent,  // Huge-page aligned mappings advised for THP (madvise)
+    Explicit      // Reserved huge pages (MAP_HUGETLB / MEM_LARGE_PAGES), falling back to Transparent
+};
+
 // Memory statistics
 struct MemoryStats {
     size_t total_allocated = 0;
@@ -22,6 +51,19 @@ struct MemoryStats {
     size_t deallocation_count = 0;
     size_t pool_hits = 0;
     size_t pool_misses = 0;
+    size_t size_class_hits = 0;         // Large allocations served from a cached span
+    size_t size_class_cached_bytes = 0; // Free spans held for reuse
+    
+    // Huge-page coverage of live large spans; transparent coverage is what was
+    // advised to the kernel, which may back part of it with ordinary pages
+    size_t large_span_bytes = 0;
+    size_t huge_page_bytes = 0;
+    size_t explicit_huge_page_bytes = 0;
+    size_t numa_bound_bytes = 0;
+    
+    double huge_page_coverage() const {
+        return large_span_bytes ? static_cast<double>(huge_page_bytes) / large_span_bytes : 0.0;
+    }
 };
 
 // Memory pool info
@@ -31,9 +73,91 @@ struct PoolInfo {
     size_t blocks_in_use;
     size_t total_memory;
     std::unique_ptr<uint8_t[]> memory;
+    uint8_t* base = nullptr;  // Page-aligned start of the blocks within memory
+    std::vector<std::unique_ptr<uint8_t[]>> growth_slabs;  // Added when the pool runs dry
     std::stack<void*> free_blocks;
-    std::atomic<size_t> allocated_count{0};
+    std::atomic<size_t> allocated_count{0};  // Blocks outside the shared free list (in use or in a thread cache)
     std::mutex mutex;
+    
+    // Address range of the initial slab, readable without taking the mutex
+    std::atomic<uintptr_t> range_begin{0};
+    std::atomic<uintptr_t> range_end{0};
+    
+    bool owns(const void* ptr) const {
+        uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+        return address >= range_begin.load(std::memory_order_relaxed) &&
+               address < range_end.load(std::memory_order_relaxed);
+    }
+};
+
+// Linear per-frame allocator. Allocation is a lock-free pointer bump; all memory
+// is released at once by reset(), which the owning manager calls from end_frame().
+// Overflow blocks are coalesced into a single block on reset, so once the arena has
+// seen a peak frame it performs no further heap allocations.
+class FrameArena {
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 1024 * 1024; // 1MB
+    
+    explicit FrameArena(size_t initial_size = DEFAULT_BLOCK_SIZE);
+    ~FrameArena();
+    
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+    
+    // Thread-safe; memory stays valid until the next reset()
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    
+    template<typename T>
+    T* allocate_array(size_t count) {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+    
+    // Objects with non-trivial destructors are destroyed in reverse order on reset()
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        T* object = new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            register_destructor(object, [](void* p) { static_cast<T*>(p)->~T(); });
+        }
+        return object;
+    }
+    
+    // Must not race with allocate(); called once per frame by the owner
+    void reset();
+    
+    size_t bytes_used() const;
+    size_t capacity() const { return capacity_.load(std::memory_order_relaxed); }
+    size_t high_water_mark() const { return high_water_mark_.load(std::memory_order_relaxed); }
+    size_t overflow_count() const { return overflow_count_.load(std::memory_order_relaxed); }
+    uint64_t frame_index() const { return frame_index_.load(std::memory_order_relaxed); }
+    
+private:
+    struct Block {
+        std::unique_ptr<uint8_t[]> memory;
+        size_t size = 0;
+        std::atomic<size_t> offset{0};
+    };
+    
+    struct DestructorNode {
+        void (*destroy)(void*);
+        void* object;
+        DestructorNode* next;
+    };
+    
+    std::vector<std::unique_ptr<Block>> blocks_;  // Guarded by grow_mutex_
+    std::atomic<Block*> current_{nullptr};
+    std::atomic<DestructorNode*> destructors_{nullptr};
+    mutable std::mutex grow_mutex_;
+    
+    std::atomic<size_t> capacity_{0};
+    std::atomic<size_t> high_water_mark_{0};
+    std::atomic<size_t> overflow_count_{0};
+    std::atomic<uint64_t> frame_index_{0};
+    
+    void* allocate_slow(size_t size, size_t alignment, Block* exhausted);
+    void register_destructor(void* object, void (*destroy)(void*));
+    void run_destructors();
+    static std::unique_ptr<Block> make_block(size_t size);
 };
 
 // Base interface for memory management
@@ -54,6 +178,10 @@ public:
     virtual void enable_tracking(bool enable) = 0;
     virtual void check_leaks() const = 0;
     virtual void dump_allocations() const = 0;
+    
+    // Per-frame scratch memory, released in bulk by end_frame()
+    virtual FrameArena& frame_arena() = 0;
+    virtual void end_frame() = 0;
 };
 
 // High-performance memory manager with pooling
@@ -66,6 +194,29 @@ public:
     static constexpr size_t NUM_POOLS = sizeof(POOL_SIZES) / sizeof(POOL_SIZES[0]);
     static constexpr size_t DEFAULT_BLOCKS_PER_POOL = 256;
     
+    // Thread cache configuration: each thread keeps a magazine of free blocks per
+    // pool and only touches the pool mutex to refill or drain half a magazine
+    static constexpr size_t MAGAZINE_CAPACITY = 32;
+    static constexpr size_t NUM_STAT_SHARDS = 16;
+    
+    // Every pool and span owns whole pages, so a page-number -> owner radix map
+    // resolves any pointer on free without trusting the caller's size
+    static constexpr size_t SPAN_PAGE_SHIFT = 12;
+    static constexpr size_t SPAN_PAGE_SIZE = size_t(1) << SPAN_PAGE_SHIFT;
+    
+    // Binned tier for tile and image buffers: quarter-power-of-two classes from
+    // 64KB to 16MB whose freed spans are kept for reuse up to a byte budget
+    static constexpr size_t MIN_SIZE_CLASS = 64 * 1024;
+    static constexpr size_t MAX_SIZE_CLASS = 16 * 1024 * 1024;
+    static constexpr size_t SIZE_CLASS_STEPS = 4;
+    static constexpr size_t NUM_SIZE_CLASSES = 8 * SIZE_CLASS_STEPS + 1;
+    static constexpr size_t DEFAULT_SIZE_CLASS_CACHE = 256 * 1024 * 1024; // 256MB
+    static constexpr size_t POOL_GROWTH_BYTES = 64 * 1024;
+    
+    // Huge-page backing for large image buffers
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+    static constexpr size_t DEFAULT_HUGE_PAGE_THRESHOLD = 8 * 1024 * 1024;
+    
     explicit MemoryManager(size_t initial_heap_size = 64 * 1024 * 1024); // 64MB default
     ~MemoryManager() override;
     
@@ -73,7 +224,7 @@ public:
     void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) override;
     void deallocate(void* ptr, size_t size) override;
     MemoryStats get_stats() const override;
-    size_t get_total_allocated() const override { return stats_.current_usage; }
+    size_t get_total_allocated() const override { return current_usage_.load(std::memory_order_relaxed); }
     void reset_stats() override;
     
     // Memory tracking and debugging
@@ -81,6 +232,10 @@ public:
     void check_leaks() const override;
     void dump_allocations() const override;
     
+    // Frame arena
+    FrameArena& frame_arena() override { return frame_arena_; }
+    void end_frame() override { frame_arena_.reset(); }
+    
     // Pool management
     void configure_pool(size_t block_size, size_t block_count);
     void resize_pool(size_t pool_index, size_t new_block_count);
@@ -89,7 +244,30 @@ public:
     // Memory limits
     void set_memory_limit(size_t limit_bytes) { memory_limit_ = limit_bytes; }
     size_t get_memory_limit() const { return memory_limit_; }
-    bool is_memory_limit_exceeded() const { return stats_.current_usage > memory_limit_; }
+    bool is_memory_limit_exceeded() const { return get_total_allocated() > memory_limit_; }
+    
+    // Thread-local caching
+    void set_thread_cache_enabled(bool enable) { thread_cache_enabled_ = enable; }
+    bool is_thread_cache_enabled() const { return thread_cache_enabled_; }
+    void flush_thread_cache();  // Return the calling thread's cached blocks to the shared pools
+    
+    // Size-class span cache
+    void set_size_class_cache_limit(size_t limit_bytes) { size_class_cache_limit_ = limit_bytes; }
+    size_t get_size_class_cache_limit() const { return size_class_cache_limit_; }
+    void trim_size_class_cache();  // Release every cached span to the system
+    
+    // Pool, size class, or large-allocation owner of a pointer; O(1), lock-free
+    bool owns(const void* ptr) const;
+    
+    // Huge pages and NUMA placement for large allocations
+    void set_huge_page_mode(HugePageMode mode) { huge_page_mode_ = mode; }
+    HugePageMode get_huge_page_mode() const { return huge_page_mode_; }
+    void set_huge_page_threshold(size_t bytes) { huge_page_threshold_ = bytes; }
+    size_t get_huge_page_threshold() const { return huge_page_threshold_; }
+    
+    // Preferred NUMA node for large allocations made by the calling thread (-1 for none)
+    static void set_thread_numa_node(int node);
+    static int get_thread_numa_node();
     
     // Custom allocators for specific types
     template<typename T>
@@ -128,21 +306,34 @@ public:
     }
     
     // Aligned allocation
-    void* allocate_aligned(size_t size, size_t alignment);
+    void* allocate_aligned(size_t size, size_t alignment, AllocationHint hint = AllocationHint::None);
     void deallocate_aligned(void* ptr, size_t size, size_t alignment);
     
 private:
     // Memory pools for different sizes
     std::array<PoolInfo, NUM_POOLS> pools_;
     
-    // Large allocation tracking
-    struct LargeAllocation {
-        void* ptr;
-        size_t size;
-        size_t alignment;
+    // Address-to-owner map and large spans
+    struct Span;
+    class PageMap;
+    std::unique_ptr<PageMap> page_map_;
+    
+    struct SizeClassBin {
+        std::mutex mutex;
+        std::vector<Span*> free_spans;
     };
-    std::unordered_map<void*, LargeAllocation> large_allocations_;
-    mutable std::mutex large_alloc_mutex_;
+    std::array<size_t, NUM_SIZE_CLASSES> size_class_sizes_{};
+    std::array<SizeClassBin, NUM_SIZE_CLASSES> size_class_bins_;
+    std::atomic<size_t> size_class_cached_bytes_{0};
+    size_t size_class_cache_limit_ = DEFAULT_SIZE_CLASS_CACHE;
+    
+    // Huge-page configuration and live coverage counters
+    std::atomic<HugePageMode> huge_page_mode_{HugePageMode::Disabled};
+    std::atomic<size_t> huge_page_threshold_{DEFAULT_HUGE_PAGE_THRESHOLD};
+    std::atomic<size_t> large_span_bytes_{0};
+    std::atomic<size_t> huge_page_bytes_{0};
+    std::atomic<size_t> explicit_huge_page_bytes_{0};
+    std::atomic<size_t> numa_bound_bytes_{0};
     
     // Memory tracking
     struct AllocationInfo {
@@ -156,9 +347,30 @@ private:
     mutable std::mutex tracking_mutex_;
     std::atomic<bool> tracking_enabled_{false};
     
-    // Statistics
-    mutable std::mutex stats_mutex_;
-    MemoryStats stats_;
+    // Statistics - counters are sharded per thread group so allocation paths never
+    // share a lock; current/peak usage are single relaxed atomics for limit checks
+    struct alignas(64) StatsShard {
+        std::atomic<size_t> total_allocated{0};
+        std::atomic<size_t> total_deallocated{0};
+        std::atomic<size_t> allocation_count{0};
+        std::atomic<size_t> deallocation_count{0};
+        std::atomic<size_t> pool_hits{0};
+        std::atomic<size_t> pool_misses{0};
+        std::atomic<size_t> size_class_hits{0};
+    };
+    std::array<StatsShard, NUM_STAT_SHARDS> stat_shards_;
+    std::atomic<size_t> current_usage_{0};
+    std::atomic<size_t> peak_usage_{0};
+    
+    // Thread-local magazine caches
+    struct ThreadCache;
+    struct ThreadCacheHolder;
+    std::vector<std::shared_ptr<ThreadCache>> thread_caches_;  // Guarded by thread_cache_registry_mutex()
+    const uint64_t instance_id_;
+    std::atomic<bool> thread_cache_enabled_{true};
+    
+    // Per-frame linear allocator
+    FrameArena frame_arena_;
     
     // Configuration
     size_t memory_limit_ = 0; // 0 means no limit
@@ -166,21 +378,40 @@ private:
     
     // Internal methods
     size_t find_pool_index(size_t size) const;
-    void* allocate_from_pool(size_t pool_index);
+    void* allocate_from_pool(size_t pool_index);  // Grows the pool by a slab when it runs dry
     void deallocate_to_pool(void* ptr, size_t pool_index);
-    void* allocate_large(size_t size, size_t alignment);
-    void deallocate_large(void* ptr);
+    void* allocate_with_hint(size_t size, size_t alignment, AllocationHint hint);
+    void* allocate_large(size_t size, size_t alignment, AllocationHint hint);
+    void deallocate_large(Span* span);
+    size_t find_size_class(size_t size) const;
+    bool wants_huge_pages(size_t size, AllocationHint hint) const;
+    Span* create_span(size_t size, size_t alignment, size_t size_class);
+    Span* create_mapped_span(size_t size, size_t alignment, bool huge_pages, int numa_node);
+    void release_span(Span* span);
+    void account_span(const Span* span, bool in_use);
     void initialize_pool(size_t index, size_t block_size, size_t block_count);
+    bool grow_pool(size_t index);  // Caller holds the pool mutex
     void update_stats_allocation(size_t size, bool from_pool);
     void update_stats_deallocation(size_t size);
     void track_allocation(void* ptr, size_t size);
     void track_deallocation(void* ptr);
     
+    ThreadCache& get_thread_cache();
+    void refill_magazine(size_t pool_index, ThreadCache& cache);
+    void drain_magazine(size_t pool_index, ThreadCache& cache, size_t keep);
+    void return_thread_cache(ThreadCache& cache);
+    StatsShard& local_stats_shard();
+    static std::mutex& thread_cache_registry_mutex();
+    
     // Alignment helpers
     static size_t align_up(size_t value, size_t alignment) {
         return (value + alignment - 1) & ~(alignment - 1);
     }
     
+    static size_t growth_block_count(size_t block_size) {
+        return std::max(DEFAULT_BLOCKS_PER_POOL, POOL_GROWTH_BYTES / block_size);
+    }
+    
     static bool is_power_of_two(size_t value) {
         return value && !(value & (value - 1));
     }
@@ -189,7 +420,7 @@ private:
 // RAII memory scope for automatic cleanup
 class MemoryScope {
 public:
-    explicit MemoryScope(MemoryManager& manager) : manager_(manager) {
+    explicit MemoryScope(IMemoryManager& manager) : manager_(manager) {
         start_usage_ = manager_.get_total_allocated();
     }
     
@@ -202,8 +433,16 @@ public:
         }
     }
     
+    // Scratch memory for the current frame; must not outlive end_frame()
+    FrameArena& frame_arena() { return manager_.frame_arena(); }
+    
+    template<typename T, typename... Args>
+    T* frame_create(Args&&... args) {
+        return manager_.frame_arena().create<T>(std::forward<Args>(args)...);
+    }
+    
 private:
-    MemoryManager& manager_;
+    IMemoryManager& manager_;
     size_t start_usage_;
 };
 
@@ -269,4 +508,91 @@ private:
     friend class PoolAllocator;
 };
 
-} // namespace QuantumCanvas::Core
\ No newline at end of file
+// Frame arena adapter for STL containers. Deallocation is a no-op; storage is
+// reclaimed when the arena is reset, so containers must not outlive the frame.
+template<typename T>
+class FrameAllocator {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    
+    template<typename U>
+    struct rebind {
+        using other = FrameAllocator<U>;
+    };
+    
+    explicit FrameAllocator(FrameArena* arena) noexcept : arena_(arena) {}
+    
+    template<typename U>
+    FrameAllocator(const FrameAllocator<U>& other) noexcept : arena_(other.arena_) {}
+    
+    T* allocate(size_t n) {
+        return arena_->allocate_array<T>(n);
+    }
+    
+    void deallocate(T*, size_t) noexcept {}
+    
+    FrameArena* arena() const noexcept { return arena_; }
+    
+    template<typename U>
+    bool operator==(const FrameAllocator<U>& other) const noexcept {
+        return arena_ == other.arena_;
+    }
+    
+    template<typename U>
+    bool operator!=(const FrameAllocator<U>& other) const noexcept {
+        return arena_ != other.arena_;
+    }
+    
+private:
+    FrameArena* arena_;
+    
+    template<typename U>
+    friend class FrameAllocator;
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+// Read-only view of a whole file, mapped rather than read so large caches and
+// assets are paged in on demand and shared with the OS file cache
+class MappedFile {
+public:
+    // How the caller will walk the bytes, passed on as a read-ahead hint
+    enum class Access {
+        Normal,
+        Sequential,  // Whole-file reads: read ahead aggressively
+        Random       // Header probes and lookups: fault in only the pages touched
+    };
+    
+    MappedFile() = default;
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    
+    // False if the file is missing, empty or cannot be mapped
+    bool open(const std::filesystem::path& path, Access access = Access::Normal);
+    void close();
+    
+    bool is_open() const { return data_ != nullptr; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    
+    // Asks the OS to start reading [offset, offset + length) in ahead of
+    // use; clamped to the file, no-op when closed
+    void prefetch(size_t offset, size_t length) const;
+    
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+#endif
+};
+
+} // namespace QuantumCanvas::Core
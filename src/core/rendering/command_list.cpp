@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2024 Francisco Molina (QuantumCanvas Studio)
+ * Licensed under Dual License Agreement - See LICENSE file for details
+ *
+ * ATTRIBUTION REQUIRED: This software must include attribution to Francisco Molina
+ * COMMERCIAL USE: Requires separate license and royalties - contact pako.molina@gmail.com
+ *
+ * Project: https://github.com/Yatrogenesis/QuantumCanvas-Studio
+ * Author: Francisco Molina <pako.molina@gmail.com>
+ */
+
+#include "command_list.hpp"
+#include "../kernel/task_scheduler.hpp"
+#include <algorithm>
+
+namespace QuantumCanvas::Rendering {
+
+namespace {
+
+// Key layout: [63..40] pipeline, [39..16] bindings hash, [15..0] vertex buffer
+constexpr uint32_t PIPELINE_SHIFT = 40;
+constexpr uint32_t BINDINGS_SHIFT = 16;
+constexpr uint64_t PIPELINE_MASK = (1ull << 24) - 1;
+constexpr uint64_t BINDINGS_MASK = (1ull << 24) - 1;
+constexpr uint64_t VERTEX_BUFFER_MASK = (1ull << 16) - 1;
+
+uint64_t hash_bindings(const DrawCall& call) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    auto mix = [&hash](uint64_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    };
+    for (ResourceId texture : call.textures) {
+        mix(texture);
+    }
+    mix(call.textures.size());
+    for (ResourceId buffer : call.uniformBuffers) {
+        mix(buffer);
+    }
+    return hash ^ (hash >> 24) ^ (hash >> 48);
+}
+
+bool same_state(const DrawCall& a, const DrawCall& b) {
+    return a.pipelineId == b.pipelineId &&
+           a.vertexBufferId == b.vertexBufferId &&
+           a.indexBufferId == b.indexBufferId &&
+           a.textures == b.textures &&
+           a.uniformBuffers == b.uniformBuffers;
+}
+
+} // namespace
+
+void CommandList::draw(const DrawCall& call) {
+    draws_.push_back(call);
+
+    if (call.type == DrawCall::Type::Triangles) {
+        triangleCount_ += call.vertexCount / 3 * call.instanceCount;
+    }
+    vertexCount_ += uint64_t(call.vertexCount) * call.instanceCount;
+}
+
+void CommandList::dispatch(const ComputeDispatch& dispatch) {
+    dispatches_.push_back(dispatch);
+}
+
+void CommandList::clear() {
+    draws_.clear();
+    dispatches_.clear();
+    sortedDraws_.clear();
+    orderedDraws_.clear();
+    triangleCount_ = 0;
+    vertexCount_ = 0;
+}
+
+bool CommandList::is_order_independent(const DrawCall& call) {
+    return call.depthTest && !call.blendEnabled;
+}
+
+DrawSortKey CommandList::compute_sort_key(const DrawCall& call) {
+    return ((call.pipelineId & PIPELINE_MASK) << PIPELINE_SHIFT) |
+           ((hash_bindings(call) & BINDINGS_MASK) << BINDINGS_SHIFT) |
+           (call.vertexBufferId & VERTEX_BUFFER_MASK);
+}
+
+void CommandList::sort() {
+    sortedDraws_.clear();
+    orderedDraws_.clear();
+
+    for (uint32_t i = 0; i < draws_.size(); ++i) {
+        if (is_order_independent(draws_[i])) {
+            sortedDraws_.push_back({compute_sort_key(draws_[i]), i});
+        } else {
+            orderedDraws_.push_back(i);
+        }
+    }
+
+    // Stable so equal keys keep their recording order
+    std::stable_sort(sortedDraws_.begin(), sortedDraws_.end(),
+                     [](const SortedDraw& a, const SortedDraw& b) { return a.key < b.key; });
+}
+
+void CommandListMerger::merge(const std::vector<CommandList*>& lists, Core::TaskScheduler* scheduler) {
+    commands_.clear();
+    stats_ = Stats{};
+
+    // Sorting is the expensive part and lists are independent
+    auto sortList = [&lists](size_t i) { lists[i]->sort(); };
+    if (scheduler && lists.size() > 1) {
+        scheduler->parallel_for(0, lists.size(), 1, sortList);
+    } else {
+        for (size_t i = 0; i < lists.size(); ++i) {
+            sortList(i);
+        }
+    }
+
+    size_t total = 0;
+    for (const CommandList* list : lists) {
+        total += list->draws_.size() + list->dispatches_.size();
+        stats_.triangleCount += list->triangleCount_;
+        stats_.vertexCount += list->vertexCount_;
+    }
+    commands_.reserve(total);
+
+    // Compute work usually produces what the draws consume
+    for (const CommandList* list : lists) {
+        for (const auto& dispatch : list->dispatches_) {
+            commands_.push_back({nullptr, &dispatch});
+        }
+    }
+    stats_.dispatchCount = static_cast<uint32_t>(commands_.size());
+
+    const DrawCall* previous = nullptr;
+
+    // K-way merge of the sorted runs; ties go to the earlier list
+    heap_.clear();
+    for (size_t i = 0; i < lists.size(); ++i) {
+        if (!lists[i]->sortedDraws_.empty()) {
+            heap_.push_back({lists[i], i, 0});
+        }
+    }
+
+    auto later = [](const Cursor& a, const Cursor& b) {
+        DrawSortKey keyA = a.list->sortedDraws_[a.position].key;
+        DrawSortKey keyB = b.list->sortedDraws_[b.position].key;
+        return keyA != keyB ? keyA > keyB : a.listIndex > b.listIndex;
+    };
+    std::make_heap(heap_.begin(), heap_.end(), later);
+
+    while (!heap_.empty()) {
+        std::pop_heap(heap_.begin(), heap_.end(), later);
+        Cursor& cursor = heap_.back();
+
+        const auto& entry = cursor.list->sortedDraws_[cursor.position];
+        append_draw(cursor.list->draws_[entry.index], previous);
+
+        if (++cursor.position < cursor.list->sortedDraws_.size()) {
+            std::push_heap(heap_.begin(), heap_.end(), later);
+        } else {
+            heap_.pop_back();
+        }
+    }
+
+    for (const CommandList* list : lists) {
+        for (uint32_t index : list->orderedDraws_) {
+            append_draw(list->draws_[index], previous);
+        }
+    }
+}
+
+void CommandListMerger::append_draw(const DrawCall& call, const DrawCall*& previous) {
+    if (previous && same_state(*previous, call)) {
+        stats_.batchedDrawCalls++;
+    } else {
+        stats_.stateChanges++;
+    }
+    previous = &call;
+
+    commands_.push_back({&call, nullptr});
+    stats_.drawCount++;
+}
+
+} // namespace QuantumCanvas::Rendering
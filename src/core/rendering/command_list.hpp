@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "rendering_engine.hpp"
+
+namespace QuantumCanvas::Core {
+class TaskScheduler;
+}
+
+namespace QuantumCanvas::Rendering {
+
+// Sort key for state-sorted draws: pipeline, then bindings, then vertex buffer,
+// so draws that share state end up adjacent after the merge
+using DrawSortKey = uint64_t;
+
+// Draws and dispatches recorded by one thread. The engine keeps one list per
+// recording thread, so recording takes no locks; end_frame() merges them all.
+//
+// Draws that write depth-tested, unblended pixels are order independent and
+// are sorted by state. Everything else (blending, no depth test) keeps its
+// recording order, so order-dependent draws which must interleave should be
+// recorded on one thread.
+class CommandList {
+public:
+    CommandList() = default;
+    CommandList(const CommandList&) = delete;
+    CommandList& operator=(const CommandList&) = delete;
+
+    void draw(const DrawCall& call);
+    void dispatch(const ComputeDispatch& dispatch);
+
+    size_t draw_count() const { return draws_.size(); }
+    size_t dispatch_count() const { return dispatches_.size(); }
+    bool empty() const { return draws_.empty() && dispatches_.empty(); }
+
+    // Keeps capacity for the next frame
+    void clear();
+
+    static bool is_order_independent(const DrawCall& call);
+    static DrawSortKey compute_sort_key(const DrawCall& call);
+
+private:
+    friend class CommandListMerger;
+
+    struct SortedDraw {
+        DrawSortKey key;
+        uint32_t index;
+    };
+
+    std::vector<DrawCall> draws_;
+    std::vector<ComputeDispatch> dispatches_;
+    std::vector<SortedDraw> sortedDraws_;   // Built by sort()
+    std::vector<uint32_t> orderedDraws_;    // Recording order
+
+    uint64_t triangleCount_ = 0;
+    uint64_t vertexCount_ = 0;
+
+    void sort();
+};
+
+// Combines the per-thread lists into one submission order: compute dispatches
+// first, then the state-sorted draws of all lists, then the order-dependent
+// draws list by list. Each list is sorted on its own (in parallel when a
+// scheduler is given) and the sorted runs are k-way merged.
+class CommandListMerger {
+public:
+    struct Command {
+        const DrawCall* draw = nullptr;            // Exactly one of these is set
+        const ComputeDispatch* dispatch = nullptr;
+    };
+
+    struct Stats {
+        uint32_t drawCount = 0;
+        uint32_t dispatchCount = 0;
+        uint64_t triangleCount = 0;
+        uint64_t vertexCount = 0;
+        uint32_t stateChanges = 0;       // Pipeline or binding switches between draws
+        uint32_t batchedDrawCalls = 0;   // Draws issued without a state change
+    };
+
+    void merge(const std::vector<CommandList*>& lists, Core::TaskScheduler* scheduler = nullptr);
+
+    const std::vector<Command>& commands() const { return commands_; }
+    const Stats& stats() const { return stats_; }
+
+private:
+    std::vector<Command> commands_;
+    Stats stats_;
+
+    struct Cursor {
+        const CommandList* list;
+        size_t listIndex;   // Breaks key ties in list order
+        size_t position;
+    };
+    std::vector<Cursor> heap_;
+
+    void append_draw(const DrawCall& call, const DrawCall*& previous);
+};
+
+} // namespace QuantumCanvas::Rendering
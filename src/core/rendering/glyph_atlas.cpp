@@ -0,0 +1,612 @@
+/*
+ * Copyright (c) 2024 Francisco Molina (QuantumCanvas Studio)
+ * Licensed under Dual License Agreement - See LICENSE file for details
+ *
+ * ATTRIBUTION REQUIRED: This software must include attribution to Francisco Molina
+ * COMMERCIAL USE: Requires separate license and royalties - contact pako.molina@gmail.com
+ *
+ * Project: https://github.com/Yatrogenesis/QuantumCanvas-Studio
+ * Author: Francisco Molina <pako.molina@gmail.com>
+ */
+
+#include "glyph_atlas.hpp"
+#include "rendering_engine.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace QuantumCanvas::Rendering {
+
+namespace {
+
+using Point = std::array<float, 2>;
+
+// Channels an edge contributes to
+constexpr uint8_t RED = 1;
+constexpr uint8_t GREEN = 2;
+constexpr uint8_t BLUE = 4;
+constexpr uint8_t CYAN = GREEN | BLUE;
+constexpr uint8_t MAGENTA = RED | BLUE;
+constexpr uint8_t YELLOW = RED | GREEN;
+constexpr uint8_t WHITE = RED | GREEN | BLUE;
+
+// Tangents turning by more than about 8 degrees make a corner
+constexpr float CORNER_SIN = 0.14112f;  // sin(3), as in msdfgen
+
+constexpr uint32_t GLYPH_PADDING = 1;   // Texels between glyphs, against bilinear bleed
+
+// An outline edge flattened to a polyline; curves are flattened finely
+// enough that the chords stay well inside a texel at EM_SIZE
+struct FlatEdge {
+    std::vector<Point> points;
+    uint8_t color = WHITE;
+};
+
+struct EdgeDistance {
+    float distance = std::numeric_limits<float>::max();  // True, unsigned
+    float orthogonality = 0.0f;                          // Breaks ties at shared ends
+    float pseudo = 0.0f;                                 // Signed, ends extended along their tangent
+};
+
+inline bool closer(const EdgeDistance& a, const EdgeDistance& b) {
+    constexpr float EPSILON = 1e-6f;
+    return a.distance < b.distance - EPSILON ||
+           (std::abs(a.distance - b.distance) <= EPSILON && a.orthogonality > b.orthogonality);
+}
+
+inline float cross(const Point& a, const Point& b) {
+    return a[0] * b[1] - a[1] * b[0];
+}
+
+inline Point sub(const Point& a, const Point& b) {
+    return {a[0] - b[0], a[1] - b[1]};
+}
+
+Point evaluate(const GlyphOutline::Edge& edge, float t) {
+    const auto& p = edge.points;
+    const float mt = 1.0f - t;
+    switch (edge.type) {
+        case GlyphOutline::Edge::Type::Quadratic:
+            return {mt * mt * p[0][0] + 2.0f * mt * t * p[1][0] + t * t * p[2][0],
+                    mt * mt * p[0][1] + 2.0f * mt * t * p[1][1] + t * t * p[2][1]};
+        case GlyphOutline::Edge::Type::Cubic:
+            return {mt * mt * mt * p[0][0] + 3.0f * mt * mt * t * p[1][0] + 3.0f * mt * t * t * p[2][0] + t * t * t * p[3][0],
+                    mt * mt * mt * p[0][1] + 3.0f * mt * mt * t * p[1][1] + 3.0f * mt * t * t * p[2][1] + t * t * t * p[3][1]};
+        default:
+            return {mt * p[0][0] + t * p[1][0], mt * p[0][1] + t * p[1][1]};
+    }
+}
+
+FlatEdge flatten(const GlyphOutline::Edge& edge) {
+    FlatEdge flat;
+    const int steps = edge.type == GlyphOutline::Edge::Type::Cubic     ? 16
+                      : edge.type == GlyphOutline::Edge::Type::Quadratic ? 12
+                                                                         : 1;
+    for (int i = 0; i <= steps; ++i) {
+        Point p = evaluate(edge, static_cast<float>(i) / steps);
+        if (flat.points.empty() || p != flat.points.back()) {
+            flat.points.push_back(p);
+        }
+    }
+    return flat;
+}
+
+Point start_tangent(const FlatEdge& edge) {
+    return sub(edge.points[1], edge.points[0]);
+}
+
+Point end_tangent(const FlatEdge& edge) {
+    return sub(edge.points.back(), edge.points[edge.points.size() - 2]);
+}
+
+bool is_corner(const Point& incoming, const Point& outgoing) {
+    float lengths = std::hypot(incoming[0], incoming[1]) * std::hypot(outgoing[0], outgoing[1]);
+    if (lengths <= 0.0f) {
+        return false;
+    }
+    float dot = incoming[0] * outgoing[0] + incoming[1] * outgoing[1];
+    return dot <= 0.0f || std::abs(cross(incoming, outgoing)) > CORNER_SIN * lengths;
+}
+
+// Gives the edges meeting at each corner different channel pairs sharing
+// one channel, so the median of the channels keeps the corner sharp
+void color_contour(std::vector<FlatEdge>& edges) {
+    const size_t count = edges.size();
+    std::vector<size_t> corners;
+    for (size_t i = 0; i < count; ++i) {
+        if (is_corner(end_tangent(edges[(i + count - 1) % count]), start_tangent(edges[i]))) {
+            corners.push_back(i);
+        }
+    }
+
+    if (corners.empty()) {
+        for (auto& edge : edges) {
+            edge.color = WHITE;
+        }
+        return;
+    }
+
+    if (corners.size() == 1) {
+        // A teardrop: the two sides of the corner differ, the rest is white
+        const size_t corner = corners[0];
+        for (size_t i = 0; i < count; ++i) {
+            edges[(corner + i) % count].color = WHITE;
+        }
+        edges[corner].color = MAGENTA;
+        if (count > 1) {
+            edges[(corner + count - 1) % count].color = YELLOW;
+        }
+        return;
+    }
+
+    // Cycle through the pairs corner to corner, never ending on the colour
+    // the contour starts with
+    const uint8_t cycle[3] = {YELLOW, CYAN, MAGENTA};
+    const size_t splines = corners.size();
+    std::vector<uint8_t> colors(splines);
+    for (size_t s = 0; s < splines; ++s) {
+        colors[s] = cycle[s % 3];
+    }
+    if (colors[splines - 1] == colors[0]) {
+        for (uint8_t candidate : cycle) {
+            if (candidate != colors[0] && candidate != colors[splines - 2]) {
+                colors[splines - 1] = candidate;
+                break;
+            }
+        }
+    }
+    for (size_t s = 0; s < splines; ++s) {
+        const size_t begin = corners[s];
+        const size_t end = s + 1 < splines ? corners[s + 1] : corners[0] + count;
+        for (size_t i = begin; i < end; ++i) {
+            edges[i % count].color = colors[s];
+        }
+    }
+}
+
+EdgeDistance edge_distance(const FlatEdge& edge, const Point& p) {
+    EdgeDistance best;
+    const size_t segments = edge.points.size() - 1;
+    for (size_t i = 0; i < segments; ++i) {
+        const Point& a = edge.points[i];
+        const Point ab = sub(edge.points[i + 1], a);
+        const Point ap = sub(p, a);
+        const float lengthSq = ab[0] * ab[0] + ab[1] * ab[1];
+        const float t = (ap[0] * ab[0] + ap[1] * ab[1]) / lengthSq;
+        const float tc = std::clamp(t, 0.0f, 1.0f);
+        const Point q{a[0] + tc * ab[0], a[1] + tc * ab[1]};
+        const Point qp = sub(p, q);
+
+        EdgeDistance candidate;
+        candidate.distance = std::hypot(qp[0], qp[1]);
+        const float side = cross(ab, ap);
+        const float length = std::sqrt(lengthSq);
+        candidate.orthogonality = candidate.distance > 0.0f ? std::abs(side) / (length * candidate.distance) : 1.0f;
+
+        // Past the ends of the edge, measure from its tangent line instead
+        const bool beyondStart = i == 0 && t < 0.0f;
+        const bool beyondEnd = i + 1 == segments && t > 1.0f;
+        if (beyondStart || beyondEnd) {
+            candidate.pseudo = side / length;
+        } else {
+            candidate.pseudo = side >= 0.0f ? candidate.distance : -candidate.distance;
+        }
+        if (closer(candidate, best)) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+// Non-zero winding of the flattened outline around p
+int winding(const std::vector<FlatEdge>& edges, const Point& p) {
+    int count = 0;
+    for (const auto& edge : edges) {
+        for (size_t i = 0; i + 1 < edge.points.size(); ++i) {
+            const Point& a = edge.points[i];
+            const Point& b = edge.points[i + 1];
+            const float side = cross(sub(b, a), sub(p, a));
+            if (a[1] <= p[1]) {
+                if (b[1] > p[1] && side > 0.0f) {
+                    count++;
+                }
+            } else if (b[1] <= p[1] && side < 0.0f) {
+                count--;
+            }
+        }
+    }
+    return count;
+}
+
+inline float median(float a, float b, float c) {
+    return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+inline uint8_t encode(float distance_px) {
+    float v = 0.5f + distance_px / GlyphAtlas::DISTANCE_RANGE;
+    return static_cast<uint8_t>(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+inline uint64_t glyph_key(FontId font, char32_t codepoint) {
+    return (static_cast<uint64_t>(font) << 32) | static_cast<uint32_t>(codepoint);
+}
+
+// Decodes one codepoint and advances; malformed bytes become U+FFFD
+char32_t next_codepoint(std::string_view text, size_t& i) {
+    const auto lead = static_cast<uint8_t>(text[i++]);
+    int extra = lead < 0x80 ? 0 : (lead >> 5) == 0x6 ? 1 : (lead >> 4) == 0xE ? 2 : (lead >> 3) == 0x1E ? 3 : -1;
+    if (extra < 0) {
+        return 0xFFFD;
+    }
+    char32_t codepoint = extra == 0 ? lead : lead & (0x3F >> extra);
+    for (int k = 0; k < extra; ++k) {
+        if (i >= text.size() || (static_cast<uint8_t>(text[i]) & 0xC0) != 0x80) {
+            return 0xFFFD;
+        }
+        codepoint = (codepoint << 6) | (static_cast<uint8_t>(text[i++]) & 0x3F);
+    }
+    return codepoint;
+}
+
+} // namespace
+
+GlyphAtlas::GlyphAtlas(size_t max_pages)
+    : maxPages_(std::max<size_t>(1, max_pages)) {
+}
+
+GlyphAtlas::~GlyphAtlas() {
+    if (engine_) {
+        for (const Page& page : pages_) {
+            if (page.texture != 0) {
+                engine_->destroy_resource(page.texture);
+            }
+        }
+        for (ResourceId texture : retiredTextures_) {
+            engine_->destroy_resource(texture);
+        }
+    }
+}
+
+std::shared_ptr<GlyphAtlas> GlyphAtlas::shared() {
+    static std::shared_ptr<GlyphAtlas> atlas = std::make_shared<GlyphAtlas>();
+    return atlas;
+}
+
+FontId GlyphAtlas::register_font(const std::string& name, GlyphProvider provider) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fonts_.push_back({name, std::move(provider)});
+    return static_cast<FontId>(fonts_.size() - 1);
+}
+
+std::optional<FontId> GlyphAtlas::find_font(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < fonts_.size(); ++i) {
+        if (fonts_[i].name == name) {
+            return static_cast<FontId>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<FontId> GlyphAtlas::default_font() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fonts_.empty() ? std::nullopt : std::optional<FontId>(0);
+}
+
+std::optional<GlyphAtlas::Glyph> GlyphAtlas::glyph(FontId font, char32_t codepoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return glyph_locked(font, codepoint);
+}
+
+float GlyphAtlas::layout(FontId font, std::string_view utf8, std::vector<PlacedGlyph>& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    float pen = 0.0f;
+    for (size_t i = 0; i < utf8.size();) {
+        if (auto glyph = glyph_locked(font, next_codepoint(utf8, i))) {
+            out.push_back({*glyph, pen});
+            pen += glyph->advance;
+        }
+    }
+    return pen;
+}
+
+void GlyphAtlas::begin_frame() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    frame_++;
+
+    // Pages added past the limit while every page was in use
+    while (pages_.size() > maxPages_) {
+        evict_page_locked(static_cast<uint32_t>(pages_.size() - 1));
+        if (pages_.back().texture != 0) {
+            retiredTextures_.push_back(pages_.back().texture);
+        }
+        pages_.pop_back();
+    }
+}
+
+void GlyphAtlas::upload(RenderingEngine& engine) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    engine_ = &engine;
+    for (ResourceId texture : retiredTextures_) {
+        engine.destroy_resource(texture);
+    }
+    retiredTextures_.clear();
+
+    for (Page& page : pages_) {
+        if (page.texture == 0) {
+            TextureDescriptor desc;
+            desc.width = PAGE_SIZE;
+            desc.height = PAGE_SIZE;
+            desc.format = TextureDescriptor::Format::RGBA8Unorm;
+            desc.usage = static_cast<uint32_t>(TextureDescriptor::Usage::TextureBinding) |
+                         static_cast<uint32_t>(TextureDescriptor::Usage::CopyDst);
+            page.texture = engine.create_texture(desc, page.pixels.data());
+            page.dirty = page.texture == 0;
+        } else if (page.dirty) {
+            engine.write_texture(page.texture, page.pixels.data());
+            page.dirty = false;
+        }
+    }
+}
+
+uint32_t GlyphAtlas::page_generation(uint32_t page) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return page < pages_.size() ? pages_[page].generation : 0;
+}
+
+ResourceId GlyphAtlas::page_texture(uint32_t page) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return page < pages_.size() ? pages_[page].texture : 0;
+}
+
+size_t GlyphAtlas::page_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pages_.size();
+}
+
+size_t GlyphAtlas::glyph_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return glyphs_.size();
+}
+
+size_t GlyphAtlas::memory_usage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pages_.size() * PAGE_SIZE * PAGE_SIZE * 4 +
+           glyphs_.size() * (sizeof(uint64_t) + sizeof(Glyph));
+}
+
+void GlyphAtlas::set_max_pages(size_t pages) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxPages_ = std::max<size_t>(1, pages);
+}
+
+void GlyphAtlas::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    glyphs_.clear();
+    for (Page& page : pages_) {
+        std::fill(page.pixels.begin(), page.pixels.end(), uint8_t(0));
+        page.shelves.clear();
+        page.nextShelfY = 0;
+        page.generation = ++generations_;
+        page.dirty = true;
+    }
+}
+
+GlyphAtlas::Stats GlyphAtlas::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::optional<GlyphAtlas::Glyph> GlyphAtlas::glyph_locked(FontId font, char32_t codepoint) {
+    const uint64_t key = glyph_key(font, codepoint);
+    auto it = glyphs_.find(key);
+    if (it != glyphs_.end()) {
+        if (!it->second.empty) {
+            pages_[it->second.page].lastUsedFrame = frame_;
+        }
+        stats_.hits++;
+        return it->second;
+    }
+    if (font >= fonts_.size() || !fonts_[font].provider) {
+        return std::nullopt;
+    }
+    auto outline = fonts_[font].provider(codepoint);
+    if (!outline) {
+        return std::nullopt;
+    }
+    stats_.misses++;
+
+    Glyph glyph;
+    glyph.advance = outline->advance;
+
+    float minX = std::numeric_limits<float>::max(), minY = minX;
+    float maxX = std::numeric_limits<float>::lowest(), maxY = maxX;
+    for (const auto& contour : outline->contours) {
+        for (const auto& edge : contour) {
+            const int points = edge.type == GlyphOutline::Edge::Type::Cubic       ? 4
+                               : edge.type == GlyphOutline::Edge::Type::Quadratic ? 3
+                                                                                  : 2;
+            // Control points bound the curve
+            for (int i = 0; i < points; ++i) {
+                minX = std::min(minX, edge.points[i][0]);
+                minY = std::min(minY, edge.points[i][1]);
+                maxX = std::max(maxX, edge.points[i][0]);
+                maxY = std::max(maxY, edge.points[i][1]);
+            }
+        }
+    }
+
+    // The field extends half the distance range beyond the outline
+    const float margin = 0.5f * DISTANCE_RANGE / EM_SIZE;
+    const uint32_t width = minX <= maxX ? static_cast<uint32_t>(std::ceil((maxX - minX) * EM_SIZE + DISTANCE_RANGE)) : 0;
+    const uint32_t height = minY <= maxY ? static_cast<uint32_t>(std::ceil((maxY - minY) * EM_SIZE + DISTANCE_RANGE)) : 0;
+    uint32_t page = 0, x = 0, y = 0;
+    if (width == 0 || height == 0 || !allocate_locked(width, height, page, x, y)) {
+        // Blank, or too large for a page: it still advances the pen
+        glyph.empty = true;
+        glyphs_.emplace(key, glyph);
+        return glyph;
+    }
+
+    glyph.page = page;
+    glyph.generation = pages_[page].generation;
+    glyph.plane = {minX - margin, minY - margin, 0.0f, 0.0f};
+    glyph.plane[2] = glyph.plane[0] + width / EM_SIZE;
+    glyph.plane[3] = glyph.plane[1] + height / EM_SIZE;
+    glyph.uv = {static_cast<float>(x) / PAGE_SIZE, static_cast<float>(y) / PAGE_SIZE,
+                static_cast<float>(x + width) / PAGE_SIZE, static_cast<float>(y + height) / PAGE_SIZE};
+
+    Page& target = pages_[page];
+    render_distance_field(*outline, EM_SIZE, glyph.plane[0], glyph.plane[3], width, height,
+                          target.pixels.data() + (size_t(y) * PAGE_SIZE + x) * 4, PAGE_SIZE * 4);
+    target.lastUsedFrame = frame_;
+    target.dirty = true;
+    glyphs_.emplace(key, glyph);
+    return glyph;
+}
+
+bool GlyphAtlas::allocate_locked(uint32_t width, uint32_t height, uint32_t& page, uint32_t& x, uint32_t& y) {
+    if (width + GLYPH_PADDING > PAGE_SIZE || height + GLYPH_PADDING > PAGE_SIZE) {
+        return false;
+    }
+    for (uint32_t i = 0; i < pages_.size(); ++i) {
+        if (allocate_in_page(pages_[i], width, height, x, y)) {
+            page = i;
+            return true;
+        }
+    }
+
+    // Recycle the least recently used page, unless it is needed this frame
+    if (pages_.size() >= maxPages_) {
+        auto lru = std::min_element(pages_.begin(), pages_.end(), [](const Page& a, const Page& b) {
+            return a.lastUsedFrame < b.lastUsedFrame;
+        });
+        if (lru->lastUsedFrame < frame_) {
+            page = static_cast<uint32_t>(lru - pages_.begin());
+            evict_page_locked(page);
+            stats_.pageEvictions++;
+            return allocate_in_page(*lru, width, height, x, y);
+        }
+    }
+
+    pages_.emplace_back();
+    pages_.back().pixels.assign(size_t(PAGE_SIZE) * PAGE_SIZE * 4, 0);
+    pages_.back().generation = ++generations_;
+    page = static_cast<uint32_t>(pages_.size() - 1);
+    return allocate_in_page(pages_.back(), width, height, x, y);
+}
+
+bool GlyphAtlas::allocate_in_page(Page& page, uint32_t width, uint32_t height, uint32_t& x, uint32_t& y) const {
+    const uint32_t w = width + GLYPH_PADDING;
+    const uint32_t h = height + GLYPH_PADDING;
+
+    // The lowest shelf that fits, without wasting more than a third of it
+    Shelf* best = nullptr;
+    for (Shelf& shelf : page.shelves) {
+        if (shelf.height >= h && shelf.height * 2 <= h * 3 && shelf.x + w <= PAGE_SIZE &&
+            (!best || shelf.height < best->height)) {
+            best = &shelf;
+        }
+    }
+    if (!best) {
+        if (page.nextShelfY + h > PAGE_SIZE) {
+            return false;
+        }
+        page.shelves.push_back({page.nextShelfY, h, 0});
+        page.nextShelfY += h;
+        best = &page.shelves.back();
+    }
+    x = best->x;
+    y = best->y;
+    best->x += w;
+    return true;
+}
+
+void GlyphAtlas::evict_page_locked(uint32_t page) {
+    for (auto it = glyphs_.begin(); it != glyphs_.end();) {
+        if (!it->second.empty && it->second.page == page) {
+            it = glyphs_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    Page& target = pages_[page];
+    std::fill(target.pixels.begin(), target.pixels.end(), uint8_t(0));
+    target.shelves.clear();
+    target.nextShelfY = 0;
+    target.generation = ++generations_;
+    target.dirty = true;
+}
+
+void GlyphAtlas::render_distance_field(const GlyphOutline& outline, float scale, float origin_x, float origin_y,
+                                       uint32_t width, uint32_t height, uint8_t* rgba, size_t stride) {
+    std::vector<FlatEdge> edges;
+    float area = 0.0f;
+    for (const auto& contour : outline.contours) {
+        std::vector<FlatEdge> contourEdges;
+        for (const auto& edge : contour) {
+            FlatEdge flat = flatten(edge);
+            if (flat.points.size() >= 2) {
+                contourEdges.push_back(std::move(flat));
+            }
+        }
+        if (contourEdges.empty()) {
+            continue;
+        }
+        color_contour(contourEdges);
+        for (auto& edge : contourEdges) {
+            for (size_t i = 0; i + 1 < edge.points.size(); ++i) {
+                area += cross(edge.points[i], edge.points[i + 1]);
+            }
+            edges.push_back(std::move(edge));
+        }
+    }
+
+    // Edge distances are positive on the left; with clockwise outer
+    // contours the inside is on the right
+    const float orientation = area < 0.0f ? -1.0f : 1.0f;
+
+    for (uint32_t row = 0; row < height; ++row) {
+        uint8_t* out = rgba + row * stride;
+        for (uint32_t column = 0; column < width; ++column, out += 4) {
+            const Point p{origin_x + (column + 0.5f) / scale, origin_y - (row + 0.5f) / scale};
+
+            EdgeDistance channel[3];
+            EdgeDistance nearest;
+            for (const auto& edge : edges) {
+                EdgeDistance d = edge_distance(edge, p);
+                for (int c = 0; c < 3; ++c) {
+                    if ((edge.color & (1 << c)) && closer(d, channel[c])) {
+                        channel[c] = d;
+                    }
+                }
+                if (closer(d, nearest)) {
+                    nearest = d;
+                }
+            }
+
+            const bool inside = winding(edges, p) != 0;
+            const float trueDistance = (inside ? 1.0f : -1.0f) * (edges.empty() ? 1e6f : nearest.distance);
+            float r = orientation * channel[0].pseudo;
+            float g = orientation * channel[1].pseudo;
+            float b = orientation * channel[2].pseudo;
+            for (int c = 0; c < 3; ++c) {
+                if (channel[c].distance == std::numeric_limits<float>::max()) {
+                    (c == 0 ? r : c == 1 ? g : b) = trueDistance;
+                }
+            }
+
+            // Where the channels disagree with the outline about which side
+            // the texel is on, fall back to the true distance
+            if ((median(r, g, b) > 0.0f) != inside) {
+                r = g = b = trueDistance;
+            }
+            out[0] = encode(r * scale);
+            out[1] = encode(g * scale);
+            out[2] = encode(b * scale);
+            out[3] = encode(trueDistance * scale);
+        }
+    }
+}
+
+} // namespace QuantumCanvas::Rendering
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace QuantumCanvas::Rendering {
+
+class RenderingEngine;
+using ResourceId = uint64_t;
+using FontId = uint32_t;
+
+// A glyph's outline in em units, y up. Contours are closed and may wind
+// either way, as long as all of a glyph's outer contours wind alike.
+struct GlyphOutline {
+    struct Edge {
+        enum class Type {
+            Line,       // points[0..1]
+            Quadratic,  // points[0..2]
+            Cubic       // points[0..3]
+        };
+        Type type = Type::Line;
+        std::array<std::array<float, 2>, 4> points{};
+    };
+    using Contour = std::vector<Edge>;
+
+    std::vector<Contour> contours;
+    float advance = 0.0f;
+};
+
+// Outlines of one font, by codepoint; nullopt for codepoints it lacks.
+// Called with the atlas locked, once per glyph the atlas does not hold.
+using GlyphProvider = std::function<std::optional<GlyphOutline>(char32_t codepoint)>;
+
+// Multi-channel signed distance fields of glyphs, packed into RGBA8 pages
+// shared by every renderer that draws text
+//
+// A glyph is rendered once, at EM_SIZE pixels per em, and drawn at any size:
+// sampling the median of the three channels gives back sharp corners that a
+// single-channel field would round off. Alpha holds the true distance, for
+// outlines and glows. Pages are recycled least recently used first once
+// there are max_pages of them, but never during the frame that uses them.
+class GlyphAtlas {
+public:
+    static constexpr uint32_t PAGE_SIZE = 1024;
+    static constexpr float EM_SIZE = 32.0f;         // Atlas pixels per em
+    static constexpr float DISTANCE_RANGE = 4.0f;   // Atlas pixels of distance across the 0..1 range
+    static constexpr size_t DEFAULT_MAX_PAGES = 4;
+
+    struct Glyph {
+        uint32_t page = 0;
+        std::array<float, 4> uv{};     // Left, top, right, bottom in the page
+        std::array<float, 4> plane{};  // Quad in em units: min x, min y, max x, max y
+        float advance = 0.0f;
+        uint32_t generation = 0;       // Of the page, renewed when it is recycled
+        bool empty = false;            // Nothing to draw, e.g. a space
+    };
+
+    // A glyph of a laid-out line, at pen position x (em) on the baseline
+    struct PlacedGlyph {
+        Glyph glyph;
+        float x = 0.0f;
+    };
+
+    explicit GlyphAtlas(size_t max_pages = DEFAULT_MAX_PAGES);
+    ~GlyphAtlas();
+
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    // The process-wide atlas the vector and CAD renderers default to
+    static std::shared_ptr<GlyphAtlas> shared();
+
+    FontId register_font(const std::string& name, GlyphProvider provider);
+    std::optional<FontId> find_font(const std::string& name) const;
+    std::optional<FontId> default_font() const;  // The first registered
+
+    // Renders the glyph into a page on first use. Nullopt if the font lacks it.
+    std::optional<Glyph> glyph(FontId font, char32_t codepoint);
+
+    // Places the glyphs of a UTF-8 line and returns its advance in em;
+    // codepoints the font lacks are skipped
+    float layout(FontId font, std::string_view utf8, std::vector<PlacedGlyph>& out);
+
+    // Pages used before this call may be recycled from now on. TextBatch
+    // calls it once its quads are submitted.
+    void begin_frame();
+
+    // Glyphs placed from a page before it was recycled must not be drawn
+    uint32_t page_generation(uint32_t page) const;
+
+    // Creates page textures and rewrites those whose pixels changed; call
+    // before drawing with page_texture()
+    void upload(RenderingEngine& engine);
+    ResourceId page_texture(uint32_t page) const;
+
+    // RGBA8 texels, rows top down
+    const std::vector<uint8_t>& page_pixels(uint32_t page) const { return pages_[page].pixels; }
+
+    size_t page_count() const;
+    size_t glyph_count() const;
+    size_t memory_usage() const;
+    void set_max_pages(size_t pages);
+    size_t max_pages() const { return maxPages_; }
+
+    // Drops every glyph; fonts stay registered
+    void clear();
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;           // Glyphs rendered
+        uint64_t pageEvictions = 0;
+    };
+    Stats get_stats() const;
+
+    // Renders an outline into a width x height RGBA8 block. Texel (0, 0) is
+    // the top left; its centre lies at em (origin_x + 0.5 / scale,
+    // origin_y - 0.5 / scale), with scale in pixels per em.
+    static void render_distance_field(const GlyphOutline& outline, float scale, float origin_x, float origin_y,
+                                      uint32_t width, uint32_t height, uint8_t* rgba, size_t stride);
+
+private:
+    struct Shelf {
+        uint32_t y = 0;
+        uint32_t height = 0;
+        uint32_t x = 0;  // Next free column
+    };
+
+    struct Page {
+        std::vector<uint8_t> pixels;
+        std::vector<Shelf> shelves;
+        uint32_t nextShelfY = 0;
+        uint64_t lastUsedFrame = 0;
+        uint32_t generation = 0;
+        ResourceId texture = 0;
+        bool dirty = true;
+    };
+
+    struct Font {
+        std::string name;
+        GlyphProvider provider;
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<Font> fonts_;
+    std::vector<Page> pages_;
+    std::unordered_map<uint64_t, Glyph> glyphs_;  // By font << 32 | codepoint
+    std::vector<ResourceId> retiredTextures_;     // Of trimmed pages
+    RenderingEngine* engine_ = nullptr;           // Of the textures
+    size_t maxPages_;
+    uint64_t frame_ = 1;
+    uint32_t generations_ = 0;  // Last handed to a page; unique across trims
+    Stats stats_;
+
+    std::optional<Glyph> glyph_locked(FontId font, char32_t codepoint);
+    bool allocate_locked(uint32_t width, uint32_t height, uint32_t& page, uint32_t& x, uint32_t& y);
+    bool allocate_in_page(Page& page, uint32_t width, uint32_t height, uint32_t& x, uint32_t& y) const;
+    void evict_page_locked(uint32_t page);
+};
+
+} // namespace QuantumCanvas::Rendering
@@ -0,0 +1,477 @@
+/*
+ * Copyright (c) 2024 Francisco Molina (QuantumCanvas Studio)
+ * Licensed under Dual License Agreement - See LICENSE file for details
+ *
+ * ATTRIBUTION REQUIRED: This software must include attribution to Francisco Molina
+ * COMMERCIAL USE: Requires separate license and royalties - contact pako.molina@gmail.com
+ *
+ * Project: https://github.com/Yatrogenesis/QuantumCanvas-Studio
+ * Author: Francisco Molina <pako.molina@gmail.com>
+ */
+
+#include "profiler.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+
+// WGPU includes - would be actual WGPU headers in real implementation
+#include "wgpu_wrapper.hpp"
+
+namespace QuantumCanvas::Rendering {
+
+namespace {
+
+constexpr uint32_t TIMESTAMP_SIZE = sizeof(uint64_t);
+
+// resolveQuerySet needs 256-byte aligned destinations, i.e. 32 queries
+constexpr uint32_t RESOLVE_ALIGNMENT = 256 / TIMESTAMP_SIZE;
+
+constexpr uint32_t GPU_TRACK = 0;
+
+std::atomic<uint32_t> nextThreadIndex{GPU_TRACK + 1};
+thread_local uint32_t threadIndex = 0;
+thread_local uint32_t threadScopeDepth = 0;
+
+uint32_t current_thread_index() {
+    if (threadIndex == 0) {
+        threadIndex = nextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+    }
+    return threadIndex;
+}
+
+uint32_t align_queries(uint32_t count) {
+    return (count + RESOLVE_ALIGNMENT - 1) / RESOLVE_ALIGNMENT * RESOLVE_ALIGNMENT;
+}
+
+void on_readback_mapped(bool success, void* userdata) {
+    auto* state = static_cast<std::atomic<int>*>(userdata);
+    state->store(success ? 2 : 3, std::memory_order_release);  // MAP_DONE / MAP_FAILED
+}
+
+} // namespace
+
+Profiler::Profiler(size_t frameHistory)
+    : history_(std::max<size_t>(frameHistory, 1)) {
+}
+
+Profiler::~Profiler() {
+    shutdown_gpu();
+}
+
+bool Profiler::initialize_gpu(WGPUDevice* device, uint32_t framesInFlight, uint32_t maxScopesPerFrame) {
+    shutdown_gpu();
+
+    if (!device || !WGPUWrapper::device_has_feature(device, WGPUFeatureName_TimestampQuery)) {
+        std::cout << "[Profiler] Timestamp queries unsupported; GPU timing disabled" << std::endl;
+        return false;
+    }
+
+    framesInFlight = std::max(framesInFlight, 1u);
+    queriesPerFrame_ = align_queries(std::max(maxScopesPerFrame, 1u) * 2);
+    const uint32_t totalQueries = queriesPerFrame_ * framesInFlight;
+
+    WGPUQuerySetDescriptor queryDesc = {};
+    queryDesc.label = "profiler_timestamps";
+    queryDesc.type = WGPUQueryType_Timestamp;
+    queryDesc.count = totalQueries;
+    querySet_ = WGPUWrapper::device_create_query_set(device, &queryDesc);
+
+    WGPUBufferDescriptor resolveDesc = {};
+    resolveDesc.label = "profiler_resolve";
+    resolveDesc.size = static_cast<uint64_t>(totalQueries) * TIMESTAMP_SIZE;
+    resolveDesc.usage = WGPUBufferUsage_QueryResolve | WGPUBufferUsage_CopySrc;
+    resolveBuffer_ = WGPUWrapper::device_create_buffer(device, &resolveDesc);
+
+    if (!querySet_ || !resolveBuffer_) {
+        shutdown_gpu();
+        return false;
+    }
+
+    device_ = device;
+    for (uint32_t i = 0; i < framesInFlight; ++i) {
+        WGPUBufferDescriptor readbackDesc = {};
+        readbackDesc.label = "profiler_readback";
+        readbackDesc.size = static_cast<uint64_t>(queriesPerFrame_) * TIMESTAMP_SIZE;
+        readbackDesc.usage = WGPUBufferUsage_MapRead | WGPUBufferUsage_CopyDst;
+
+        auto gpuFrame = std::make_unique<GpuFrame>();
+        gpuFrame->queryBase = i * queriesPerFrame_;
+        gpuFrame->readback = WGPUWrapper::device_create_buffer(device, &readbackDesc);
+        if (!gpuFrame->readback) {
+            shutdown_gpu();
+            return false;
+        }
+        gpuFrames_.push_back(std::move(gpuFrame));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    currentGpuFrame_ = 0;
+    gpuFrames_[0]->frame = frameNumber_;
+    return true;
+}
+
+void Profiler::shutdown_gpu() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto& gpuFrame : gpuFrames_) {
+        while (device_ && gpuFrame->mapState.load(std::memory_order_acquire) == MAP_PENDING) {
+            WGPUWrapper::device_poll(device_, true);
+        }
+        if (gpuFrame->mapState.load(std::memory_order_acquire) == MAP_DONE) {
+            WGPUWrapper::buffer_unmap(gpuFrame->readback);
+        }
+        if (gpuFrame->readback) {
+            WGPUWrapper::buffer_release(gpuFrame->readback);
+        }
+    }
+    gpuFrames_.clear();
+
+    if (resolveBuffer_) {
+        WGPUWrapper::buffer_release(resolveBuffer_);
+        resolveBuffer_ = nullptr;
+    }
+    if (querySet_) {
+        WGPUWrapper::query_set_release(querySet_);
+        querySet_ = nullptr;
+    }
+    device_ = nullptr;
+    queriesPerFrame_ = 0;
+}
+
+uint64_t Profiler::now_ns() const {
+    return Core::Telemetry::now_ns();
+}
+
+uint64_t Profiler::frame_number() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return frameNumber_;
+}
+
+Profiler::FrameRecord& Profiler::current_record() {
+    FrameRecord& record = history_[frameNumber_ % history_.size()];
+    if (record.frame != frameNumber_) {
+        record.frame = frameNumber_;
+        record.completed = false;
+        record.events.clear();
+    }
+    return record;
+}
+
+Profiler::FrameRecord* Profiler::find_record(uint64_t frame) {
+    FrameRecord& record = history_[frame % history_.size()];
+    return record.frame == frame ? &record : nullptr;
+}
+
+void Profiler::begin_frame() {
+    if (device_) {
+        WGPUWrapper::device_poll(device_, false);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++frameNumber_;
+    current_record();
+
+    if (gpuFrames_.empty()) {
+        return;
+    }
+
+    for (auto& gpuFrame : gpuFrames_) {
+        collect_readback(*gpuFrame);
+    }
+
+    // The slot was last used maxFramesInFlight frames ago, so its readback is
+    // normally done; wait for it rather than lose the results
+    currentGpuFrame_ = (currentGpuFrame_ + 1) % gpuFrames_.size();
+    GpuFrame& gpuFrame = *gpuFrames_[currentGpuFrame_];
+    while (gpuFrame.mapState.load(std::memory_order_acquire) == MAP_PENDING) {
+        WGPUWrapper::device_poll(device_, true);
+    }
+    collect_readback(gpuFrame);
+
+    gpuFrame.frame = frameNumber_;
+    gpuFrame.queriesUsed = 0;
+    gpuFrame.queriesResolved = 0;
+    gpuFrame.anchorNs = 0;
+    gpuFrame.scopes.clear();
+}
+
+void Profiler::end_frame() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    current_record().completed = true;
+
+    if (!gpuFrames_.empty()) {
+        GpuFrame& gpuFrame = *gpuFrames_[currentGpuFrame_];
+        if (gpuFrame.queriesResolved > 0 && gpuFrame.mapState.load(std::memory_order_acquire) == MAP_IDLE) {
+            request_readback(gpuFrame);
+        }
+    }
+}
+
+void Profiler::record_cpu_scope(std::string name, const char* category,
+                                uint64_t beginNs, uint64_t endNs, uint32_t depth) {
+    if (!is_enabled()) {
+        return;
+    }
+
+    ProfileEvent event;
+    event.name = std::move(name);
+    event.category = category;
+    event.domain = ProfileDomain::Cpu;
+    event.threadIndex = current_thread_index();
+    event.depth = depth;
+    event.beginNs = beginNs;
+    event.endNs = endNs;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    FrameRecord& record = current_record();
+    event.frame = record.frame;
+    record.events.push_back(std::move(event));
+}
+
+uint32_t Profiler::begin_gpu_scope(const std::string& name, const char* category) {
+    if (!is_enabled() || !querySet_) {
+        return INVALID_QUERY;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    GpuFrame& gpuFrame = *gpuFrames_[currentGpuFrame_];
+    if (gpuFrame.queriesUsed + 2 > queriesPerFrame_) {
+        return INVALID_QUERY;
+    }
+
+    if (gpuFrame.scopes.empty()) {
+        gpuFrame.anchorNs = now_ns();
+    }
+
+    uint32_t query = gpuFrame.queryBase + gpuFrame.queriesUsed;
+    gpuFrame.queriesUsed += 2;
+    gpuFrame.scopes.push_back({name, category, query});
+    return query;
+}
+
+void Profiler::write_timestamp(WGPUCommandEncoder* encoder, uint32_t queryIndex) {
+    if (queryIndex != INVALID_QUERY && querySet_) {
+        WGPUWrapper::command_encoder_write_timestamp(encoder, querySet_, queryIndex);
+    }
+}
+
+void Profiler::resolve(WGPUCommandEncoder* encoder) {
+    if (!querySet_) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    GpuFrame& gpuFrame = *gpuFrames_[currentGpuFrame_];
+    if (gpuFrame.queriesUsed <= gpuFrame.queriesResolved) {
+        return;
+    }
+
+    const uint32_t first = gpuFrame.queriesResolved;
+    const uint32_t count = gpuFrame.queriesUsed - first;
+    const uint64_t resolveOffset = static_cast<uint64_t>(gpuFrame.queryBase + first) * TIMESTAMP_SIZE;
+
+    WGPUWrapper::command_encoder_resolve_query_set(encoder, querySet_, gpuFrame.queryBase + first, count,
+                                                   resolveBuffer_, resolveOffset);
+    WGPUWrapper::command_encoder_copy_buffer_to_buffer(encoder, resolveBuffer_, resolveOffset,
+                                                       gpuFrame.readback,
+                                                       static_cast<uint64_t>(first) * TIMESTAMP_SIZE,
+                                                       static_cast<uint64_t>(count) * TIMESTAMP_SIZE);
+
+    // The next encoder's range must start on an aligned query
+    gpuFrame.queriesResolved = gpuFrame.queriesUsed;
+    gpuFrame.queriesUsed = std::min(align_queries(gpuFrame.queriesUsed), queriesPerFrame_);
+}
+
+void Profiler::request_readback(GpuFrame& gpuFrame) {
+    gpuFrame.mapState.store(MAP_PENDING, std::memory_order_release);
+    WGPUWrapper::buffer_map_async(gpuFrame.readback, WGPUMapMode_Read, 0,
+                                  static_cast<size_t>(gpuFrame.queriesResolved) * TIMESTAMP_SIZE,
+                                  on_readback_mapped, &gpuFrame.mapState);
+}
+
+void Profiler::collect_readback(GpuFrame& gpuFrame) {
+    int state = gpuFrame.mapState.load(std::memory_order_acquire);
+    if (state == MAP_FAILED) {
+        gpuFrame.mapState.store(MAP_IDLE, std::memory_order_relaxed);
+        gpuFrame.scopes.clear();
+        return;
+    }
+    if (state != MAP_DONE) {
+        return;
+    }
+
+    const size_t size = static_cast<size_t>(gpuFrame.queriesResolved) * TIMESTAMP_SIZE;
+    const auto* ticks = static_cast<const uint64_t*>(
+        WGPUWrapper::buffer_get_mapped_range(gpuFrame.readback, 0, size));
+
+    // Timestamps are in nanoseconds on the GPU's own clock; keep their
+    // spacing and pin the earliest one to the frame's CPU anchor
+    uint64_t firstTick = std::numeric_limits<uint64_t>::max();
+    uint64_t lastTick = 0;
+    auto valid = [&](const GpuScope& scope) {
+        uint32_t local = scope.query - gpuFrame.queryBase;
+        return ticks && local + 1 < gpuFrame.queriesResolved &&
+               ticks[local] != 0 && ticks[local + 1] >= ticks[local];
+    };
+    for (const auto& scope : gpuFrame.scopes) {
+        if (valid(scope)) {
+            uint32_t local = scope.query - gpuFrame.queryBase;
+            firstTick = std::min(firstTick, ticks[local]);
+            lastTick = std::max(lastTick, ticks[local + 1]);
+        }
+    }
+
+    std::vector<ProfileEvent> events;
+    for (const auto& scope : gpuFrame.scopes) {
+        if (!valid(scope)) {
+            continue;
+        }
+        uint32_t local = scope.query - gpuFrame.queryBase;
+
+        ProfileEvent event;
+        event.name = scope.name;
+        event.category = scope.category;
+        event.domain = ProfileDomain::Gpu;
+        event.threadIndex = GPU_TRACK;
+        event.frame = gpuFrame.frame;
+        event.beginNs = gpuFrame.anchorNs + (ticks[local] - firstTick);
+        event.endNs = gpuFrame.anchorNs + (ticks[local + 1] - firstTick);
+        events.push_back(std::move(event));
+    }
+
+    WGPUWrapper::buffer_unmap(gpuFrame.readback);
+    gpuFrame.mapState.store(MAP_IDLE, std::memory_order_relaxed);
+    gpuFrame.scopes.clear();
+
+    if (events.empty()) {
+        return;
+    }
+
+    if (FrameRecord* record = find_record(gpuFrame.frame)) {
+        record->events.insert(record->events.end(), events.begin(), events.end());
+    }
+    lastGpuFrameNs_ = lastTick - firstTick;
+    lastGpuEvents_ = std::move(events);
+}
+
+std::vector<ProfileEvent> Profiler::get_events(size_t frames) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const size_t retained = std::min<size_t>(history_.size(), frameNumber_ + 1);
+    const size_t count = frames == 0 ? retained : std::min(frames, retained);
+
+    std::vector<ProfileEvent> events;
+    for (uint64_t frame = frameNumber_ + 1 - count; frame <= frameNumber_; ++frame) {
+        const FrameRecord& record = history_[frame % history_.size()];
+        if (record.frame == frame) {
+            events.insert(events.end(), record.events.begin(), record.events.end());
+        }
+    }
+    return events;
+}
+
+std::vector<ScopeTiming> Profiler::get_last_frame_timings() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::vector<ScopeTiming> timings;
+    auto accumulate = [&timings](const ProfileEvent& event) {
+        auto it = std::find_if(timings.begin(), timings.end(), [&](const ScopeTiming& timing) {
+            return timing.domain == event.domain && timing.name == event.name;
+        });
+        if (it == timings.end()) {
+            timings.push_back({event.name, event.category, event.domain, 0, 0.0});
+            it = timings.end() - 1;
+        }
+        it->count++;
+        it->totalMs += event.duration_ms();
+    };
+
+    const FrameRecord& current = history_[frameNumber_ % history_.size()];
+    const FrameRecord* last = nullptr;
+    if (current.frame == frameNumber_ && current.completed) {
+        last = &current;
+    } else if (frameNumber_ > 0) {
+        const FrameRecord& previous = history_[(frameNumber_ - 1) % history_.size()];
+        if (previous.frame == frameNumber_ - 1) {
+            last = &previous;
+        }
+    }
+
+    if (last) {
+        for (const auto& event : last->events) {
+            if (event.domain == ProfileDomain::Cpu) {
+                accumulate(event);
+            }
+        }
+    }
+    for (const auto& event : lastGpuEvents_) {
+        accumulate(event);
+    }
+    return timings;
+}
+
+std::chrono::microseconds Profiler::get_last_gpu_frame_time() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::chrono::microseconds(lastGpuFrameNs_ / 1000);
+}
+
+Core::TraceCapture Profiler::get_trace(size_t frames) const {
+    Core::TraceCapture trace;
+    trace.thread_names.emplace_back(GPU_TRACK, "GPU");
+
+    // A span per name and category
+    std::unordered_map<std::string, Core::MetricId> spans;
+    for (const auto& event : get_events(frames)) {
+        auto [span, added] = spans.try_emplace(std::string(event.category) + '\0' + event.name,
+                                               static_cast<Core::MetricId>(trace.span_names.size()));
+        if (added) {
+            trace.span_names.push_back(event.name);
+            trace.span_categories.emplace_back(event.category);
+        }
+        if (event.domain == ProfileDomain::Cpu &&
+            std::none_of(trace.thread_names.begin(), trace.thread_names.end(),
+                         [&](const auto& track) { return track.first == event.threadIndex; })) {
+            trace.thread_names.emplace_back(event.threadIndex, "CPU " + std::to_string(event.threadIndex));
+        }
+        trace.events.push_back({span->second, event.threadIndex, event.beginNs, event.endNs - event.beginNs});
+    }
+
+    std::sort(trace.events.begin(), trace.events.end(),
+              [](const auto& a, const auto& b) { return a.start_ns < b.start_ns; });
+    return trace;
+}
+
+std::string Profiler::export_chrome_trace(size_t frames) const {
+    return Core::to_chrome_trace(get_trace(frames));
+}
+
+bool Profiler::save_chrome_trace(const std::filesystem::path& path, size_t frames) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "[Profiler] Cannot write trace: " << path << std::endl;
+        return false;
+    }
+    out << export_chrome_trace(frames);
+    return static_cast<bool>(out);
+}
+
+ProfileScope::ProfileScope(Profiler& profiler, std::string_view name, const char* category)
+    : profiler_(profiler.is_enabled() ? &profiler : nullptr)
+    , category_(category) {
+    if (profiler_) {
+        name_ = name;
+        beginNs_ = profiler_->now_ns();
+        depth_ = threadScopeDepth++;
+    }
+}
+
+ProfileScope::~ProfileScope() {
+    if (profiler_) {
+        --threadScopeDepth;
+        profiler_->record_cpu_scope(std::move(name_), category_, beginNs_, profiler_->now_ns(), depth_);
+    }
+}
+
+} // namespace QuantumCanvas::Rendering
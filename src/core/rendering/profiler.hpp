@@ -0,0 +1,183 @@
+#pragma once
+
+#include "../kernel/telemetry.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Forward declare WGPU types
+struct WGPUDevice;
+struct WGPUBuffer;
+struct WGPUQuerySet;
+struct WGPUCommandEncoder;
+
+namespace QuantumCanvas::Rendering {
+
+enum class ProfileDomain : uint8_t {
+    Cpu,
+    Gpu
+};
+
+// One finished scope. Times are nanoseconds on Telemetry's trace clock, so
+// scopes line up with Telemetry captures; GPU scopes are shifted onto it at
+// the CPU time their frame first wrote a timestamp.
+struct ProfileEvent {
+    std::string name;
+    const char* category = "";     // String literal naming the module
+    ProfileDomain domain = ProfileDomain::Cpu;
+    uint32_t threadIndex = 0;      // CPU only; small ids in order of first use
+    uint32_t depth = 0;            // Nesting on its thread
+    uint64_t frame = 0;
+    uint64_t beginNs = 0;
+    uint64_t endNs = 0;
+
+    double duration_ms() const { return static_cast<double>(endNs - beginNs) / 1.0e6; }
+};
+
+// Scopes of one frame summed by name
+struct ScopeTiming {
+    std::string name;
+    const char* category = "";
+    ProfileDomain domain = ProfileDomain::Cpu;
+    uint32_t count = 0;
+    double totalMs = 0.0;
+};
+
+// Frame profiler. CPU scopes come from ProfileScope on any thread; GPU scopes
+// are timestamp query pairs around render graph passes and the engine's
+// command pass. Events are kept for the last frameHistory frames in a ring.
+//
+// GPU results are read back asynchronously and land maxFramesInFlight frames
+// after they were recorded, so the newest frame has CPU scopes only.
+class Profiler {
+public:
+    static constexpr uint32_t INVALID_QUERY = ~0u;
+    static constexpr size_t DEFAULT_FRAME_HISTORY = 120;
+    static constexpr uint32_t DEFAULT_GPU_SCOPES_PER_FRAME = 256;
+
+    explicit Profiler(size_t frameHistory = DEFAULT_FRAME_HISTORY);
+    ~Profiler();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool is_enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // GPU timing needs the device's timestamp-query feature; without it
+    // initialize_gpu() fails and only CPU scopes are recorded
+    bool initialize_gpu(WGPUDevice* device, uint32_t framesInFlight,
+                        uint32_t maxScopesPerFrame = DEFAULT_GPU_SCOPES_PER_FRAME);
+    void shutdown_gpu();
+    bool has_gpu_timing() const { return querySet_ != nullptr; }
+
+    // Frame boundaries; begin_frame() also collects GPU results that came back
+    void begin_frame();
+    void end_frame();
+    uint64_t frame_number() const;
+
+    // CPU scopes (thread-safe). Prefer ProfileScope.
+    uint64_t now_ns() const;
+    void record_cpu_scope(std::string name, const char* category,
+                          uint64_t beginNs, uint64_t endNs, uint32_t depth);
+
+    // GPU scopes, from the recording thread. begin_gpu_scope() returns the
+    // begin query index (end is the next one), or INVALID_QUERY when GPU
+    // timing is off or this frame's queries are used up. Use the pair as a
+    // pass's timestampWrites or with write_timestamp() outside passes.
+    uint32_t begin_gpu_scope(const std::string& name, const char* category);
+    WGPUQuerySet* query_set() const { return querySet_; }
+    void write_timestamp(WGPUCommandEncoder* encoder, uint32_t queryIndex);
+
+    // Call before finishing every encoder that wrote timestamps
+    void resolve(WGPUCommandEncoder* encoder);
+
+    // History. get_events() returns the retained events of the last 'frames'
+    // frames, or all of them when 0.
+    std::vector<ProfileEvent> get_events(size_t frames = 0) const;
+    std::vector<ScopeTiming> get_last_frame_timings() const;  // Last CPU frame plus last resolved GPU frame
+    std::chrono::microseconds get_last_gpu_frame_time() const;
+
+    // The events of get_events() as a trace, one track per CPU thread plus
+    // one for the GPU; export_chrome_trace() writes it with to_chrome_trace()
+    Core::TraceCapture get_trace(size_t frames = 0) const;
+    std::string export_chrome_trace(size_t frames = 0) const;
+    bool save_chrome_trace(const std::filesystem::path& path, size_t frames = 0) const;
+
+private:
+    struct FrameRecord {
+        uint64_t frame = 0;
+        bool completed = false;
+        std::vector<ProfileEvent> events;
+    };
+
+    struct GpuScope {
+        std::string name;
+        const char* category;
+        uint32_t query;
+    };
+
+    // One per frame in flight, each owning a slice of the query set
+    struct GpuFrame {
+        uint64_t frame = 0;
+        uint32_t queryBase = 0;
+        uint32_t queriesUsed = 0;      // Relative to queryBase
+        uint32_t queriesResolved = 0;
+        uint64_t anchorNs = 0;         // CPU time of the first scope
+        std::vector<GpuScope> scopes;
+        WGPUBuffer* readback = nullptr;
+        std::atomic<int> mapState{0};  // MapState
+    };
+
+    enum MapState {
+        MAP_IDLE,
+        MAP_PENDING,
+        MAP_DONE,
+        MAP_FAILED
+    };
+
+    std::atomic<bool> enabled_{false};
+
+    mutable std::mutex mutex_;
+    std::vector<FrameRecord> history_;
+    uint64_t frameNumber_ = 0;
+    std::vector<ProfileEvent> lastGpuEvents_;
+    uint64_t lastGpuFrameNs_ = 0;
+
+    WGPUDevice* device_ = nullptr;
+    WGPUQuerySet* querySet_ = nullptr;
+    WGPUBuffer* resolveBuffer_ = nullptr;
+    std::vector<std::unique_ptr<GpuFrame>> gpuFrames_;
+    size_t currentGpuFrame_ = 0;
+    uint32_t queriesPerFrame_ = 0;
+
+    FrameRecord& current_record();                   // Caller holds mutex_
+    FrameRecord* find_record(uint64_t frame);        // Caller holds mutex_
+    void request_readback(GpuFrame& gpuFrame);
+    void collect_readback(GpuFrame& gpuFrame);       // Caller holds mutex_
+};
+
+// Times the enclosing block on the calling thread; free while disabled
+class ProfileScope {
+public:
+    ProfileScope(Profiler& profiler, std::string_view name, const char* category);
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Profiler* profiler_;   // Null while the profiler is disabled
+    std::string name_;
+    const char* category_;
+    uint64_t beginNs_ = 0;
+    uint32_t depth_ = 0;
+};
+
+} // namespace QuantumCanvas::Rendering
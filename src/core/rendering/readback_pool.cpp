@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2024 Francisco Molina (QuantumCanvas Studio)
+ * Licensed under Dual License Agreement - See LICENSE file for details
+ *
+ * ATTRIBUTION REQUIRED: This software must include attribution to Francisco Molina
+ * COMMERCIAL USE: Requires separate license and royalties - contact pako.molina@gmail.com
+ *
+ * Project: https://github.com/Yatrogenesis/QuantumCanvas-Studio
+ * Author: Francisco Molina <pako.molina@gmail.com>
+ */
+
+#include "readback_pool.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <utility>
+
+namespace QuantumCanvas::Rendering {
+
+namespace {
+
+void erase_from(std::vector<ReadbackSlot*>& slots, ReadbackSlot* slot) {
+    auto it = std::find(slots.begin(), slots.end(), slot);
+    if (it != slots.end()) {
+        *it = slots.back();
+        slots.pop_back();
+    }
+}
+
+} // namespace
+
+// Readback
+
+Readback::Readback(Readback&& other) noexcept
+    : pool_(std::move(other.pool_))
+    , slot_(std::exchange(other.slot_, nullptr)) {
+}
+
+Readback& Readback::operator=(Readback&& other) noexcept {
+    if (this != &other) {
+        reset();
+        pool_ = std::move(other.pool_);
+        slot_ = std::exchange(other.slot_, nullptr);
+    }
+    return *this;
+}
+
+bool Readback::is_ready() const {
+    return slot_ && slot_->state.load(std::memory_order_acquire) != ReadbackSlot::State::Pending;
+}
+
+bool Readback::succeeded() const {
+    return slot_ && slot_->state.load(std::memory_order_acquire) == ReadbackSlot::State::Ready;
+}
+
+bool Readback::copy_to(void* data, uint32_t bytesPerRow) const {
+    if (!data || !succeeded()) {
+        return false;
+    }
+    if (bytesPerRow == 0) {
+        bytesPerRow = slot_->rowBytes;
+    }
+
+    auto* out = static_cast<uint8_t*>(data);
+    for (uint32_t y = 0; y < slot_->height; ++y) {
+        std::memcpy(out + static_cast<size_t>(y) * bytesPerRow,
+                    slot_->mapped + static_cast<size_t>(y) * slot_->paddedRowBytes, slot_->rowBytes);
+    }
+    return true;
+}
+
+void Readback::reset() {
+    if (slot_) {
+        pool_->release(std::exchange(slot_, nullptr));
+        pool_.reset();
+    }
+}
+
+// ReadbackPool
+
+ReadbackPool::ReadbackPool(BufferFn unmap, BufferFn release, size_t idleBudget)
+    : unmap_(unmap)
+    , release_(release)
+    , idleBudget_(idleBudget) {
+}
+
+ReadbackPool::~ReadbackPool() {
+    shutdown();
+}
+
+ReadbackSlot* ReadbackPool::acquire(size_t size) {
+    const size_t capacity = std::bit_ceil(std::max(size, MIN_CAPACITY));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Smallest idle buffer that fits, normally one of the same size class
+    ReadbackSlot* slot = nullptr;
+    for (ReadbackSlot* candidate : idle_) {
+        if (candidate->capacity >= capacity && (!slot || candidate->capacity < slot->capacity)) {
+            slot = candidate;
+        }
+    }
+
+    if (slot) {
+        erase_from(idle_, slot);
+        idleBytes_ -= slot->capacity;
+    } else {
+        slots_.push_back(std::make_unique<ReadbackSlot>());
+        slot = slots_.back().get();
+        slot->capacity = capacity;
+        created_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    slot->mapped = nullptr;
+    slot->held = false;
+    slot->state.store(ReadbackSlot::State::Pending, std::memory_order_relaxed);
+    inFlight_.push_back(slot);
+    return slot;
+}
+
+Readback ReadbackPool::track(ReadbackSlot* slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    slot->held = true;
+    return Readback(shared_from_this(), slot);
+}
+
+void ReadbackPool::abandon(ReadbackSlot* slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    slot->state.store(ReadbackSlot::State::Failed, std::memory_order_relaxed);
+    recycle(slot);
+}
+
+void ReadbackPool::complete(ReadbackSlot& slot, const uint8_t* mapped) {
+    slot.mapped = mapped;
+    slot.state.store(mapped ? ReadbackSlot::State::Ready : ReadbackSlot::State::Failed,
+                     std::memory_order_release);
+}
+
+void ReadbackPool::collect() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // recycle() edits inFlight_, so walk a copy
+    const std::vector<ReadbackSlot*> inFlight = inFlight_;
+    for (ReadbackSlot* slot : inFlight) {
+        if (!slot->held && slot->state.load(std::memory_order_acquire) != ReadbackSlot::State::Pending) {
+            recycle(slot);
+        }
+    }
+}
+
+void ReadbackPool::release(ReadbackSlot* slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    slot->held = false;
+
+    // Still in flight: the map callback will need the slot, collect() takes it later
+    if (slot->state.load(std::memory_order_acquire) != ReadbackSlot::State::Pending) {
+        recycle(slot);
+    }
+}
+
+void ReadbackPool::recycle(ReadbackSlot* slot) {
+    erase_from(inFlight_, slot);
+
+    if (slot->buffer && slot->state.load(std::memory_order_relaxed) == ReadbackSlot::State::Ready) {
+        unmap_(slot->buffer);
+    }
+    slot->mapped = nullptr;
+    slot->state.store(ReadbackSlot::State::Idle, std::memory_order_relaxed);
+
+    if (!slot->buffer) {
+        // Never created, or released by shutdown()
+        slots_.erase(std::find_if(slots_.begin(), slots_.end(),
+                                  [slot](const auto& owned) { return owned.get() == slot; }));
+        return;
+    }
+
+    idle_.push_back(slot);
+    idleBytes_ += slot->capacity;
+    trim();
+}
+
+void ReadbackPool::trim() {
+    while (idleBytes_ > idleBudget_ && !idle_.empty()) {
+        auto largest = std::max_element(idle_.begin(), idle_.end(), [](const ReadbackSlot* a, const ReadbackSlot* b) {
+            return a->capacity < b->capacity;
+        });
+        ReadbackSlot* slot = *largest;
+        idle_.erase(largest);
+        idleBytes_ -= slot->capacity;
+
+        release_(slot->buffer);
+        slots_.erase(std::find_if(slots_.begin(), slots_.end(),
+                                  [slot](const auto& owned) { return owned.get() == slot; }));
+    }
+}
+
+void ReadbackPool::shutdown() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto& slot : slots_) {
+        if (!slot->buffer) {
+            continue;
+        }
+        if (slot->state.load(std::memory_order_acquire) == ReadbackSlot::State::Ready) {
+            unmap_(slot->buffer);
+        }
+        release_(slot->buffer);
+        slot->buffer = nullptr;
+        slot->mapped = nullptr;
+        slot->state.store(ReadbackSlot::State::Failed, std::memory_order_release);
+    }
+
+    // Held slots stay until their readback lets go of them
+    std::vector<ReadbackSlot*> held;
+    for (ReadbackSlot* slot : inFlight_) {
+        if (slot->held) {
+            held.push_back(slot);
+        }
+    }
+    slots_.erase(std::remove_if(slots_.begin(), slots_.end(), [](const auto& slot) { return !slot->held; }),
+                 slots_.end());
+    idle_.clear();
+    inFlight_ = std::move(held);
+    idleBytes_ = 0;
+}
+
+size_t ReadbackPool::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(std::count_if(inFlight_.begin(), inFlight_.end(), [](const ReadbackSlot* slot) {
+        return slot->state.load(std::memory_order_acquire) == ReadbackSlot::State::Pending;
+    }));
+}
+
+size_t ReadbackPool::buffer_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(std::count_if(slots_.begin(), slots_.end(), [](const auto& slot) {
+        return slot->buffer != nullptr;
+    }));
+}
+
+size_t ReadbackPool::idle_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idleBytes_;
+}
+
+} // namespace QuantumCanvas::Rendering
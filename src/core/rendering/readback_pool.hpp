@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct WGPUBuffer;
+
+namespace QuantumCanvas::Rendering {
+
+class ReadbackPool;
+
+// A staging buffer and the texture copy it receives. The engine fills in the
+// buffer and layout, requests the map, and reports its result through
+// ReadbackPool::complete().
+struct ReadbackSlot {
+    enum class State : uint8_t {
+        Idle,
+        Pending,   // Copy submitted, map requested
+        Ready,     // Mapped; 'mapped' holds the copy
+        Failed
+    };
+
+    WGPUBuffer* buffer = nullptr;
+    size_t capacity = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t rowBytes = 0;        // Of the texture
+    uint32_t paddedRowBytes = 0;  // In the buffer, aligned for the copy
+    const uint8_t* mapped = nullptr;
+    std::atomic<State> state{State::Idle};
+    bool held = false;            // A Readback refers to it; guarded by the pool
+};
+
+// A texture copy on its way back from the GPU. Poll or wait through the
+// engine that started it; once ready the pixels can be copied out any number
+// of times. Dropping it returns the staging buffer to the pool, even while
+// the copy is still in flight.
+class Readback {
+public:
+    Readback() = default;
+    ~Readback() { reset(); }
+
+    Readback(Readback&& other) noexcept;
+    Readback& operator=(Readback&& other) noexcept;
+    Readback(const Readback&) = delete;
+    Readback& operator=(const Readback&) = delete;
+
+    bool is_valid() const { return slot_ != nullptr; }
+    bool is_ready() const;   // Finished, successfully or not
+    bool succeeded() const;
+
+    uint32_t width() const { return slot_ ? slot_->width : 0; }
+    uint32_t height() const { return slot_ ? slot_->height : 0; }
+    uint32_t row_bytes() const { return slot_ ? slot_->rowBytes : 0; }
+
+    // Rows into 'data', bytesPerRow = 0 meaning tightly packed. False until
+    // the copy succeeded.
+    bool copy_to(void* data, uint32_t bytesPerRow = 0) const;
+
+    void reset();
+
+private:
+    friend class ReadbackPool;
+    Readback(std::shared_ptr<ReadbackPool> pool, ReadbackSlot* slot) : pool_(std::move(pool)), slot_(slot) {}
+
+    std::shared_ptr<ReadbackPool> pool_;
+    ReadbackSlot* slot_ = nullptr;
+};
+
+// Staging buffers for GPU-to-CPU copies, kept for reuse by power-of-two size
+// class so steady readbacks allocate nothing. Buffers left idle beyond the
+// budget are released, the largest first. The pool tracks buffers; creating,
+// unmapping and releasing them is left to the engine through the functions
+// it supplies, like the upload ring leaves the buffer to it.
+//
+// Thread-safe. Readbacks keep the pool alive, but not the device: the engine
+// waits out pending copies and calls shutdown() before releasing it.
+class ReadbackPool : public std::enable_shared_from_this<ReadbackPool> {
+public:
+    using BufferFn = void (*)(WGPUBuffer* buffer);
+
+    static constexpr size_t MIN_CAPACITY = 64 * 1024;
+    static constexpr size_t DEFAULT_IDLE_BUDGET = 64 * 1024 * 1024;
+
+    ReadbackPool(BufferFn unmap, BufferFn release, size_t idleBudget = DEFAULT_IDLE_BUDGET);
+    ~ReadbackPool();
+
+    ReadbackPool(const ReadbackPool&) = delete;
+    ReadbackPool& operator=(const ReadbackPool&) = delete;
+
+    // An idle slot of at least 'size' bytes, marked pending. Its buffer is
+    // null when none was free: create one of 'capacity' bytes and set it.
+    ReadbackSlot* acquire(size_t size);
+
+    // Hands out an acquired slot once its map has been requested
+    Readback track(ReadbackSlot* slot);
+
+    // Gives back a slot whose copy could not be started
+    void abandon(ReadbackSlot* slot);
+
+    // From the map callback; 'mapped' is null when mapping failed
+    static void complete(ReadbackSlot& slot, const uint8_t* mapped);
+
+    // Recycles finished slots whose readback was dropped while in flight
+    void collect();
+
+    // Releases every buffer once nothing is pending; readbacks still held
+    // fail from here on
+    void shutdown();
+
+    size_t pending() const;
+    size_t buffer_count() const;
+    size_t idle_bytes() const;
+    size_t buffers_created() const { return created_.load(std::memory_order_relaxed); }
+
+private:
+    friend class Readback;
+
+    void release(ReadbackSlot* slot);
+    void recycle(ReadbackSlot* slot);  // Caller holds mutex_
+    void trim();                       // Caller holds mutex_
+
+    BufferFn unmap_;
+    BufferFn release_;
+    size_t idleBudget_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ReadbackSlot>> slots_;  // Freed only when neither in flight nor held
+    std::vector<ReadbackSlot*> idle_;
+    std::vector<ReadbackSlot*> inFlight_;
+    size_t idleBytes_ = 0;
+    std::atomic<size_t> created_{0};
+};
+
+} // namespace QuantumCanvas::Rendering
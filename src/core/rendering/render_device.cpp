@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024 Francisco Molina (QuantumCanvas Studio)
+ * Licensed under Dual License Agreement - See LICENSE file for details
+ *
+ * ATTRIBUTION REQUIRED: This software must include attribution to Francisco Molina
+ * COMMERCIAL USE: Requires separate license and royalties - contact pako.molina@gmail.com
+ *
+ * Project: https://github.com/Yatrogenesis/QuantumCanvas-Studio
+ * Author: Francisco Molina <pako.molina@gmail.com>
+ */
+
+#include "render_device.hpp"
+#include "rendering_engine.hpp"
+#include "wgpu_wrapper.hpp"
+
+namespace QuantumCanvas::Rendering {
+
+std::shared_ptr<RenderDevice> RenderDevice::create(bool preferDiscreteGPU) {
+    std::shared_ptr<RenderDevice> device(new RenderDevice());
+
+    // Request adapter
+    WGPURequestAdapterOptions adapterOptions = {};
+    adapterOptions.powerPreference = preferDiscreteGPU ?
+        WGPUPowerPreference_HighPerformance : WGPUPowerPreference_LowPower;
+
+    device->adapter_ = WGPUWrapper::instance_request_adapter(&adapterOptions);
+    if (!device->adapter_) {
+        return nullptr;
+    }
+
+    // Request device
+    WGPUDeviceDescriptor deviceDesc = {};
+    deviceDesc.requiredFeatureCount = 0;
+    deviceDesc.requiredLimits = nullptr;
+
+    device->device_ = WGPUWrapper::adapter_request_device(device->adapter_, &deviceDesc);
+    if (!device->device_) {
+        return nullptr;
+    }
+
+    device->queue_ = WGPUWrapper::device_get_queue(device->device_);
+    return device;
+}
+
+RenderDevice::~RenderDevice() {
+    if (queue_) {
+        WGPUWrapper::queue_release(queue_);
+    }
+    if (device_) {
+        WGPUWrapper::device_release(device_);
+    }
+    if (adapter_) {
+        WGPUWrapper::adapter_release(adapter_);
+    }
+}
+
+} // namespace QuantumCanvas::Rendering
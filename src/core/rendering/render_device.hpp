@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+
+struct WGPUAdapter;
+struct WGPUDevice;
+struct WGPUQueue;
+
+namespace QuantumCanvas::Rendering {
+
+// An adapter with its device and queue, shared by every engine created on
+// it. Each engine is an independent render context with its own resources,
+// command buffers, upload ring and readbacks; all of them submit to the one
+// queue, which WebGPU lets any thread use. Released with the last engine.
+class RenderDevice {
+public:
+    // Null when no adapter or device is available
+    static std::shared_ptr<RenderDevice> create(bool preferDiscreteGPU = true);
+    ~RenderDevice();
+
+    RenderDevice(const RenderDevice&) = delete;
+    RenderDevice& operator=(const RenderDevice&) = delete;
+
+    WGPUAdapter* adapter() const { return adapter_; }
+    WGPUDevice* device() const { return device_; }
+    WGPUQueue* queue() const { return queue_; }
+
+private:
+    RenderDevice() = default;
+
+    WGPUAdapter* adapter_ = nullptr;
+    WGPUDevice* device_ = nullptr;
+    WGPUQueue* queue_ = nullptr;
+};
+
+} // namespace QuantumCanvas::Rendering
@@ -0,0 +1,811 @@
+/*
+ * Copyright (c) 2024 Francisco Molina (QuantumCanvas Studio)
+ * Licensed under Dual License Agreement - See LICENSE file for details
+ *
+ * ATTRIBUTION REQUIRED: This software must include attribution to Francisco Molina
+ * COMMERCIAL USE: Requires separate license and royalties - contact pako.molina@gmail.com
+ *
+ * Project: https://github.com/Yatrogenesis/QuantumCanvas-Studio
+ * Author: Francisco Molina <pako.molina@gmail.com>
+ */
+
+#include "render_graph.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+// WGPU includes - would be actual WGPU headers in real implementation
+#include "wgpu_wrapper.hpp"
+
+namespace QuantumCanvas::Rendering {
+
+namespace {
+
+constexpr uint32_t TEXTURE_USAGE_COPY_SRC = static_cast<uint32_t>(TextureDescriptor::Usage::CopySrc);
+constexpr uint32_t TEXTURE_USAGE_COPY_DST = static_cast<uint32_t>(TextureDescriptor::Usage::CopyDst);
+constexpr uint32_t TEXTURE_USAGE_SAMPLED = static_cast<uint32_t>(TextureDescriptor::Usage::TextureBinding);
+constexpr uint32_t TEXTURE_USAGE_STORAGE = static_cast<uint32_t>(TextureDescriptor::Usage::StorageBinding);
+constexpr uint32_t TEXTURE_USAGE_ATTACHMENT = static_cast<uint32_t>(TextureDescriptor::Usage::RenderAttachment);
+
+uint32_t texture_usage_for(RGAccess access) {
+    switch (access) {
+        case RGAccess::ShaderRead:      return TEXTURE_USAGE_SAMPLED;
+        case RGAccess::StorageRead:
+        case RGAccess::StorageWrite:    return TEXTURE_USAGE_STORAGE;
+        case RGAccess::ColorAttachment:
+        case RGAccess::DepthAttachment:
+        case RGAccess::DepthRead:       return TEXTURE_USAGE_ATTACHMENT;
+        case RGAccess::CopySrc:         return TEXTURE_USAGE_COPY_SRC;
+        case RGAccess::CopyDst:         return TEXTURE_USAGE_COPY_DST;
+        case RGAccess::Present:         return 0;
+    }
+    return 0;
+}
+
+uint32_t buffer_usage_for(RGAccess access) {
+    switch (access) {
+        case RGAccess::ShaderRead:   return static_cast<uint32_t>(BufferUsage::Uniform);
+        case RGAccess::StorageRead:
+        case RGAccess::StorageWrite: return static_cast<uint32_t>(BufferUsage::Storage);
+        case RGAccess::CopySrc:      return static_cast<uint32_t>(BufferUsage::CopySrc);
+        case RGAccess::CopyDst:      return static_cast<uint32_t>(BufferUsage::CopyDst);
+        default:                     return 0;
+    }
+}
+
+const char* access_name(RGAccess access) {
+    switch (access) {
+        case RGAccess::ShaderRead:      return "ShaderRead";
+        case RGAccess::StorageRead:     return "StorageRead";
+        case RGAccess::StorageWrite:    return "StorageWrite";
+        case RGAccess::ColorAttachment: return "ColorAttachment";
+        case RGAccess::DepthAttachment: return "DepthAttachment";
+        case RGAccess::DepthRead:       return "DepthRead";
+        case RGAccess::CopySrc:         return "CopySrc";
+        case RGAccess::CopyDst:         return "CopyDst";
+        case RGAccess::Present:         return "Present";
+    }
+    return "Unknown";
+}
+
+} // namespace
+
+// RGTextureDesc implementation
+bool RGTextureDesc::is_compatible(const RGTextureDesc& other) const {
+    return width == other.width && height == other.height && depth == other.depth &&
+           mipLevelCount == other.mipLevelCount && sampleCount == other.sampleCount &&
+           dimension == other.dimension && format == other.format;
+}
+
+size_t RGTextureDesc::estimate_size() const {
+    size_t total = 0;
+    uint32_t w = width;
+    uint32_t h = height;
+    for (uint32_t mip = 0; mip < std::max(mipLevelCount, 1u); ++mip) {
+        total += static_cast<size_t>(w) * h * depth;
+        w = std::max(w / 2, 1u);
+        h = std::max(h / 2, 1u);
+    }
+    return total * bytes_per_pixel(format) * std::max(sampleCount, 1u);
+}
+
+// RenderGraphBuilder implementation
+RGResourceHandle RenderGraphBuilder::create_texture(const std::string& name, const RGTextureDesc& desc) {
+    RenderGraph::Resource resource;
+    resource.name = name;
+    resource.isTexture = true;
+    resource.textureDesc = desc;
+    return graph_.add_resource(std::move(resource));
+}
+
+RGResourceHandle RenderGraphBuilder::create_buffer(const std::string& name, const RGBufferDesc& desc) {
+    RenderGraph::Resource resource;
+    resource.name = name;
+    resource.isTexture = false;
+    resource.bufferDesc = desc;
+    resource.usage = desc.usage;
+    return graph_.add_resource(std::move(resource));
+}
+
+RGResourceHandle RenderGraphBuilder::read(RGResourceHandle resource, RGAccess access) {
+    return graph_.record_read(pass_, resource, access);
+}
+
+RGResourceHandle RenderGraphBuilder::write(RGResourceHandle resource, RGAccess access) {
+    return graph_.record_write(pass_, resource, access);
+}
+
+RGResourceHandle RenderGraphBuilder::write_color(RGResourceHandle resource, RGLoadOp loadOp,
+                                                 const std::array<float, 4>& clearColor) {
+    auto& pass = graph_.passes_[pass_];
+    if (pass.type != RGPassType::Render) {
+        throw std::logic_error("Color attachments require a render pass: " + pass.name);
+    }
+
+    RGResourceHandle written = graph_.record_write(pass_, resource, RGAccess::ColorAttachment,
+                                                   loadOp != RGLoadOp::Load);
+
+    RenderGraph::Attachment attachment;
+    attachment.handle = written;
+    attachment.loadOp = loadOp;
+    attachment.clearColor = clearColor;
+    pass.colorAttachments.push_back(attachment);
+    return written;
+}
+
+RGResourceHandle RenderGraphBuilder::write_depth(RGResourceHandle resource, RGLoadOp loadOp, float clearDepth) {
+    auto& pass = graph_.passes_[pass_];
+    if (pass.type != RGPassType::Render) {
+        throw std::logic_error("Depth attachments require a render pass: " + pass.name);
+    }
+
+    RGResourceHandle written = graph_.record_write(pass_, resource, RGAccess::DepthAttachment,
+                                                   loadOp != RGLoadOp::Load);
+
+    pass.depthAttachment.handle = written;
+    pass.depthAttachment.loadOp = loadOp;
+    pass.depthAttachment.clearDepth = clearDepth;
+    return written;
+}
+
+void RenderGraphBuilder::set_side_effect() {
+    graph_.passes_[pass_].hasSideEffect = true;
+}
+
+// RenderPassContext implementation
+ResourceId RenderPassContext::get_texture(RGResourceHandle resource) const {
+    return graph_.physical_resource(resource);
+}
+
+ResourceId RenderPassContext::get_buffer(RGResourceHandle resource) const {
+    return graph_.physical_resource(resource);
+}
+
+// RenderGraph implementation
+RGPassId RenderGraph::add_pass(const std::string& name, RGPassType type,
+                               const SetupFunction& setup, ExecuteFunction execute) {
+    RGPassId id = static_cast<RGPassId>(passes_.size());
+
+    Pass pass;
+    pass.name = name;
+    pass.type = type;
+    pass.execute = std::move(execute);
+    passes_.push_back(std::move(pass));
+
+    if (setup) {
+        RenderGraphBuilder builder(*this, id);
+        setup(builder);
+    }
+
+    compiled_ = false;
+    return id;
+}
+
+RGResourceHandle RenderGraph::import_texture(const std::string& name, ResourceId texture,
+                                             const RGTextureDesc& desc) {
+    Resource resource;
+    resource.name = name;
+    resource.isTexture = true;
+    resource.imported = true;
+    resource.textureDesc = desc;
+    resource.external = texture;
+    return add_resource(std::move(resource));
+}
+
+RGResourceHandle RenderGraph::import_buffer(const std::string& name, ResourceId buffer,
+                                            const RGBufferDesc& desc) {
+    Resource resource;
+    resource.name = name;
+    resource.isTexture = false;
+    resource.imported = true;
+    resource.bufferDesc = desc;
+    resource.external = buffer;
+    return add_resource(std::move(resource));
+}
+
+void RenderGraph::mark_output(RGResourceHandle handle) {
+    resource(handle).output = true;
+    compiled_ = false;
+}
+
+void RenderGraph::reset() {
+    passes_.clear();
+    resources_.clear();
+    physicalSlots_.clear();
+    executionOrder_.clear();
+    compileStats_ = CompileStats{};
+    compiled_ = false;
+}
+
+RenderGraph::Resource& RenderGraph::resource(RGResourceHandle handle) {
+    if (!handle.is_valid() || handle.index >= resources_.size()) {
+        throw std::out_of_range("Invalid render graph resource handle");
+    }
+    return resources_[handle.index];
+}
+
+const RenderGraph::Resource& RenderGraph::resource(RGResourceHandle handle) const {
+    if (!handle.is_valid() || handle.index >= resources_.size()) {
+        throw std::out_of_range("Invalid render graph resource handle");
+    }
+    return resources_[handle.index];
+}
+
+RGResourceHandle RenderGraph::add_resource(Resource resource) {
+    RGResourceHandle handle;
+    handle.index = static_cast<uint32_t>(resources_.size());
+    handle.version = 0;
+    resources_.push_back(std::move(resource));
+    compiled_ = false;
+    return handle;
+}
+
+RGResourceHandle RenderGraph::record_read(RGPassId pass, RGResourceHandle handle, RGAccess access) {
+    Resource& res = resource(handle);
+    res.usage |= res.isTexture ? texture_usage_for(access) : buffer_usage_for(access);
+    passes_[pass].reads.push_back({handle, access, false});
+    return handle;
+}
+
+RGResourceHandle RenderGraph::record_write(RGPassId pass, RGResourceHandle handle, RGAccess access,
+                                           bool overwrites) {
+    Resource& res = resource(handle);
+    if (handle.version != res.version) {
+        // Writing an old version would fork the resource's history
+        throw std::logic_error("Render graph write to stale version of " + res.name);
+    }
+
+    res.usage |= res.isTexture ? texture_usage_for(access) : buffer_usage_for(access);
+    res.version++;
+    res.producers.push_back(pass);
+
+    RGResourceHandle written{handle.index, res.version};
+    passes_[pass].writes.push_back({written, access, overwrites});
+    return written;
+}
+
+void RenderGraph::compile() {
+    compileStats_ = CompileStats{};
+    compileStats_.passesDeclared = static_cast<uint32_t>(passes_.size());
+
+    for (auto& pass : passes_) {
+        pass.culled = false;
+        pass.mergedWithPrevious = false;
+        pass.hazard = false;
+    }
+    for (auto& res : resources_) {
+        res.firstUse = RGResourceHandle::INVALID_INDEX;
+        res.lastUse = 0;
+        res.physicalSlot = RGResourceHandle::INVALID_INDEX;
+    }
+
+    cull_passes();
+
+    // Declaration order is a valid topological order: a pass can only
+    // reference versions that earlier passes produced
+    executionOrder_.clear();
+    for (RGPassId id = 0; id < passes_.size(); ++id) {
+        if (!passes_[id].culled) {
+            executionOrder_.push_back(id);
+        } else {
+            compileStats_.passesCulled++;
+        }
+    }
+
+    compute_lifetimes(executionOrder_);
+    find_hazards(executionOrder_);
+    merge_passes(executionOrder_);
+    alias_transients();
+
+    compiled_ = true;
+}
+
+void RenderGraph::cull_passes() {
+    // A pass survives if it has side effects or (transitively) produces
+    // something an imported or output resource ends up containing
+    std::vector<bool> alive(passes_.size(), false);
+    std::vector<RGPassId> stack;
+
+    auto require_version = [&](const Resource& res, uint32_t version) {
+        if (version > 0 && version <= res.producers.size()) {
+            stack.push_back(res.producers[version - 1]);
+        }
+    };
+
+    for (RGPassId id = 0; id < passes_.size(); ++id) {
+        if (passes_[id].hasSideEffect) {
+            stack.push_back(id);
+        }
+    }
+    for (const auto& res : resources_) {
+        if (res.imported || res.output) {
+            require_version(res, res.version);
+        }
+    }
+
+    while (!stack.empty()) {
+        RGPassId id = stack.back();
+        stack.pop_back();
+        if (alive[id]) {
+            continue;
+        }
+        alive[id] = true;
+
+        const Pass& pass = passes_[id];
+        for (const auto& read : pass.reads) {
+            require_version(resources_[read.handle.index], read.handle.version);
+        }
+        for (const auto& write : pass.writes) {
+            // Partial writes keep whatever the previous version contained
+            if (!write.overwrites) {
+                require_version(resources_[write.handle.index], write.handle.version - 1);
+            }
+        }
+    }
+
+    for (RGPassId id = 0; id < passes_.size(); ++id) {
+        passes_[id].culled = !alive[id];
+    }
+}
+
+void RenderGraph::compute_lifetimes(const std::vector<RGPassId>& order) {
+    for (uint32_t position = 0; position < order.size(); ++position) {
+        const Pass& pass = passes_[order[position]];
+
+        auto touch = [&](const ResourceAccess& access) {
+            Resource& res = resources_[access.handle.index];
+            res.firstUse = std::min(res.firstUse, position);
+            res.lastUse = std::max(res.lastUse, position);
+        };
+        std::for_each(pass.reads.begin(), pass.reads.end(), touch);
+        std::for_each(pass.writes.begin(), pass.writes.end(), touch);
+    }
+
+    // Outputs are read after the graph, so nothing may take their memory
+    // once their last pass has run
+    for (auto& res : resources_) {
+        if (res.output && res.firstUse != RGResourceHandle::INVALID_INDEX) {
+            res.lastUse = static_cast<uint32_t>(order.size());
+        }
+    }
+}
+
+void RenderGraph::find_hazards(const std::vector<RGPassId>& order) {
+    // Last access state per resource across surviving passes
+    std::vector<RGAccess> lastAccess(resources_.size(), RGAccess::ShaderRead);
+    std::vector<bool> accessed(resources_.size(), false);
+
+    for (RGPassId id : order) {
+        Pass& pass = passes_[id];
+
+        auto check = [&](const ResourceAccess& access) {
+            uint32_t index = access.handle.index;
+            if (accessed[index]) {
+                RGAccess before = lastAccess[index];
+                // Storage writes must be visible to the next pass even in the same state
+                pass.hazard |= before != access.access ||
+                               (before == RGAccess::StorageWrite && access.access == RGAccess::StorageWrite);
+            }
+            accessed[index] = true;
+        };
+
+        std::for_each(pass.reads.begin(), pass.reads.end(), check);
+        std::for_each(pass.writes.begin(), pass.writes.end(), check);
+
+        // States are updated after the whole pass so read+write in one pass is one state
+        for (const auto& read : pass.reads) {
+            lastAccess[read.handle.index] = read.access;
+        }
+        for (const auto& write : pass.writes) {
+            lastAccess[write.handle.index] = write.access;
+        }
+    }
+}
+
+bool RenderGraph::can_merge(const Pass& previous, const Pass& next) const {
+    if (previous.type != RGPassType::Render || next.type != RGPassType::Render) {
+        return false;
+    }
+
+    if (previous.colorAttachments.size() != next.colorAttachments.size() ||
+        previous.depthAttachment.handle.is_valid() != next.depthAttachment.handle.is_valid()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < next.colorAttachments.size(); ++i) {
+        const auto& attachment = next.colorAttachments[i];
+        if (attachment.handle.index != previous.colorAttachments[i].handle.index ||
+            attachment.loadOp != RGLoadOp::Load) {
+            return false;
+        }
+    }
+
+    if (next.depthAttachment.handle.is_valid() &&
+        (next.depthAttachment.handle.index != previous.depthAttachment.handle.index ||
+         next.depthAttachment.loadOp != RGLoadOp::Load)) {
+        return false;
+    }
+
+    return !next.colorAttachments.empty() || next.depthAttachment.handle.is_valid();
+}
+
+void RenderGraph::merge_passes(const std::vector<RGPassId>& order) {
+    const Pass* previous = nullptr;
+    for (RGPassId id : order) {
+        Pass& pass = passes_[id];
+        bool compatible = previous && can_merge(*previous, pass);
+        // Anything that needs a transition (sampling a target the group just
+        // rendered, for example) forces a pass boundary
+        if (compatible && !pass.hazard) {
+            pass.mergedWithPrevious = true;
+            compileStats_.passesMerged++;
+        } else if (pass.type == RGPassType::Render) {
+            if (compatible) {
+                compileStats_.hazardSplits++;
+            }
+            compileStats_.renderPassCount++;
+        }
+        previous = &pass;
+    }
+}
+
+void RenderGraph::alias_transients() {
+    physicalSlots_.clear();
+
+    std::vector<uint32_t> transients;
+    for (uint32_t index = 0; index < resources_.size(); ++index) {
+        const Resource& res = resources_[index];
+        if (!res.imported && res.firstUse != RGResourceHandle::INVALID_INDEX) {
+            transients.push_back(index);
+        }
+    }
+
+    std::sort(transients.begin(), transients.end(), [this](uint32_t a, uint32_t b) {
+        return resources_[a].firstUse < resources_[b].firstUse;
+    });
+
+    // Greedy interval packing: reuse any compatible slot whose previous
+    // occupant finished before this resource is first touched
+    for (uint32_t index : transients) {
+        Resource& res = resources_[index];
+        compileStats_.transientResources++;
+        compileStats_.transientBytesRequested += res.isTexture ? res.textureDesc.estimate_size()
+                                                               : res.bufferDesc.size;
+
+        uint32_t best = RGResourceHandle::INVALID_INDEX;
+        for (uint32_t slotIndex = 0; slotIndex < physicalSlots_.size(); ++slotIndex) {
+            const PhysicalSlot& slot = physicalSlots_[slotIndex];
+            if (slot.isTexture != res.isTexture || slot.lastUse >= res.firstUse) {
+                continue;
+            }
+            if (res.isTexture) {
+                if (slot.textureDesc.is_compatible(res.textureDesc)) {
+                    best = slotIndex;
+                    break;
+                }
+            } else if (best == RGResourceHandle::INVALID_INDEX ||
+                       std::abs(static_cast<long long>(slot.bufferSize) - static_cast<long long>(res.bufferDesc.size)) <
+                       std::abs(static_cast<long long>(physicalSlots_[best].bufferSize) - static_cast<long long>(res.bufferDesc.size))) {
+                // Closest size wastes the least when the slot has to grow
+                best = slotIndex;
+            }
+        }
+
+        if (best == RGResourceHandle::INVALID_INDEX) {
+            PhysicalSlot slot;
+            slot.isTexture = res.isTexture;
+            slot.textureDesc = res.textureDesc;
+            physicalSlots_.push_back(slot);
+            best = static_cast<uint32_t>(physicalSlots_.size() - 1);
+        }
+
+        PhysicalSlot& slot = physicalSlots_[best];
+        slot.usage |= res.usage;
+        slot.lastUse = res.lastUse;
+        if (!res.isTexture) {
+            slot.bufferSize = std::max(slot.bufferSize, res.bufferDesc.size);
+        }
+        res.physicalSlot = best;
+    }
+
+    compileStats_.physicalResources = static_cast<uint32_t>(physicalSlots_.size());
+    for (const auto& slot : physicalSlots_) {
+        compileStats_.transientBytesAllocated += slot.isTexture ? slot.textureDesc.estimate_size()
+                                                                : slot.bufferSize;
+    }
+}
+
+ResourceId RenderGraph::physical_resource(RGResourceHandle handle) const {
+    const Resource& res = resource(handle);
+    if (res.imported) {
+        return res.external;
+    }
+    if (res.physicalSlot == RGResourceHandle::INVALID_INDEX) {
+        return 0;
+    }
+    return physicalSlots_[res.physicalSlot].resource;
+}
+
+void RenderGraph::execute(RenderingEngine& engine) {
+    Profiler& profiler = engine.profiler();
+    ProfileScope executeScope(profiler, "render_graph", "render_graph");
+    
+    if (!compiled_) {
+        ProfileScope compileScope(profiler, "render_graph_compile", "render_graph");
+        compile();
+    }
+
+    if (executionOrder_.empty()) {
+        return;
+    }
+
+    TransientResourcePool& pool = engine.transient_pool();
+    for (auto& slot : physicalSlots_) {
+        slot.resource = slot.isTexture ? pool.acquire_texture(engine, slot.textureDesc, slot.usage)
+                                       : pool.acquire_buffer(engine, slot.bufferSize, slot.usage);
+    }
+
+    WGPUCommandEncoderDescriptor encoderDesc = {};
+    WGPUCommandEncoder* encoder = WGPUWrapper::device_create_command_encoder(engine.device_, &encoderDesc);
+
+    RenderPassContext context(engine, *this);
+    context.commandEncoder_ = encoder;
+
+    std::vector<WGPUTextureView*> attachmentViews;
+    WGPURenderPassEncoder* passEncoder = nullptr;
+
+    auto end_render_pass = [&]() {
+        if (!passEncoder) {
+            return;
+        }
+        WGPUWrapper::render_pass_encoder_end(passEncoder);
+        WGPUWrapper::render_pass_encoder_release(passEncoder);
+        for (WGPUTextureView* view : attachmentViews) {
+            WGPUWrapper::texture_view_release(view);
+        }
+        attachmentViews.clear();
+        passEncoder = nullptr;
+        context.renderPassEncoder_ = nullptr;
+    };
+
+    for (size_t position = 0; position < executionOrder_.size(); ++position) {
+        Pass& pass = passes_[executionOrder_[position]];
+
+        if (!pass.mergedWithPrevious) {
+            end_render_pass();
+        }
+
+        if (pass.type == RGPassType::Render && !pass.mergedWithPrevious) {
+            // Find the last pass folded into this one to decide store ops
+            size_t groupEnd = position;
+            while (groupEnd + 1 < executionOrder_.size() &&
+                   passes_[executionOrder_[groupEnd + 1]].mergedWithPrevious) {
+                ++groupEnd;
+            }
+
+            std::vector<WGPURenderPassColorAttachment> colorAttachments;
+            colorAttachments.reserve(pass.colorAttachments.size());
+            for (const auto& attachment : pass.colorAttachments) {
+                const Resource& res = resources_[attachment.handle.index];
+                WGPUTextureView* view = engine.create_texture_view(physical_resource(attachment.handle));
+                attachmentViews.push_back(view);
+
+                WGPURenderPassColorAttachment colorAttachment = {};
+                colorAttachment.view = view;
+                colorAttachment.loadOp = attachment.loadOp == RGLoadOp::Load ? WGPULoadOp_Load : WGPULoadOp_Clear;
+                // Transients nobody reads after this group never need to reach memory
+                bool needed = res.imported || res.output || res.lastUse > groupEnd;
+                colorAttachment.storeOp = needed ? WGPUStoreOp_Store : WGPUStoreOp_Discard;
+                colorAttachment.clearValue = {attachment.clearColor[0], attachment.clearColor[1],
+                                              attachment.clearColor[2], attachment.clearColor[3]};
+                colorAttachments.push_back(colorAttachment);
+            }
+
+            // The wrapper has no depth-stencil attachment type yet; depth
+            // attachments still take part in merging, lifetimes and aliasing
+            WGPURenderPassDescriptor passDesc = {};
+            passDesc.label = pass.name.c_str();
+            passDesc.colorAttachmentCount = static_cast<uint32_t>(colorAttachments.size());
+            passDesc.colorAttachments = colorAttachments.data();
+
+            // Merged passes share one render pass, so they are timed as a group
+            WGPUPassTimestampWrites timestampWrites = {};
+            uint32_t query = profiler.begin_gpu_scope(pass.name, "render_graph");
+            if (query != Profiler::INVALID_QUERY) {
+                timestampWrites = {profiler.query_set(), query, query + 1};
+                passDesc.timestampWriteCount = 1;
+                passDesc.timestampWrites = &timestampWrites;
+            }
+
+            passEncoder = WGPUWrapper::command_encoder_begin_render_pass(encoder, &passDesc);
+            context.renderPassEncoder_ = passEncoder;
+        }
+
+        // Compute and copy passes are outside any render pass, so the
+        // encoder can write their timestamps directly
+        uint32_t query = Profiler::INVALID_QUERY;
+        if (pass.type != RGPassType::Render) {
+            query = profiler.begin_gpu_scope(pass.name, "render_graph");
+            profiler.write_timestamp(encoder, query);
+        }
+
+        if (pass.execute) {
+            ProfileScope passScope(profiler, pass.name, "render_graph");
+            pass.execute(context);
+        }
+
+        if (query != Profiler::INVALID_QUERY) {
+            profiler.write_timestamp(encoder, query + 1);
+        }
+    }
+    end_render_pass();
+    profiler.resolve(encoder);
+
+    WGPUCommandBufferDescriptor cmdBufferDesc = {};
+    WGPUCommandBuffer* commandBuffer = WGPUWrapper::command_encoder_finish(encoder, &cmdBufferDesc);
+    // Passes may bind upload ring allocations
+    engine.write_uploads();
+    WGPUWrapper::queue_submit(engine.queue_, 1, &commandBuffer);
+    WGPUWrapper::command_buffer_release(commandBuffer);
+    WGPUWrapper::command_encoder_release(encoder);
+
+    // Submitted work is ordered on the queue, so the next graph may reuse these
+    for (auto& slot : physicalSlots_) {
+        pool.release(slot.resource);
+        slot.resource = 0;
+    }
+}
+
+bool RenderGraph::is_pass_culled(RGPassId pass) const {
+    return pass < passes_.size() && passes_[pass].culled;
+}
+
+bool RenderGraph::is_pass_merged(RGPassId pass) const {
+    return pass < passes_.size() && passes_[pass].mergedWithPrevious;
+}
+
+uint32_t RenderGraph::get_physical_slot(RGResourceHandle handle) const {
+    return resource(handle).physicalSlot;
+}
+
+std::string RenderGraph::export_graphviz() const {
+    std::ostringstream dot;
+    dot << "digraph RenderGraph {\n";
+    dot << "  rankdir=LR;\n";
+
+    for (RGPassId id = 0; id < passes_.size(); ++id) {
+        const Pass& pass = passes_[id];
+        dot << "  pass" << id << " [shape=box, label=\"" << pass.name << "\"";
+        if (pass.culled) {
+            dot << ", style=dashed";
+        } else if (pass.mergedWithPrevious) {
+            dot << ", style=filled, fillcolor=lightblue";
+        }
+        dot << "];\n";
+    }
+
+    for (uint32_t index = 0; index < resources_.size(); ++index) {
+        const Resource& res = resources_[index];
+        dot << "  res" << index << " [shape=ellipse, label=\"" << res.name;
+        if (res.physicalSlot != RGResourceHandle::INVALID_INDEX) {
+            dot << "\\nslot " << res.physicalSlot;
+        }
+        dot << "\"" << (res.imported ? ", style=bold" : "") << "];\n";
+    }
+
+    for (RGPassId id = 0; id < passes_.size(); ++id) {
+        const Pass& pass = passes_[id];
+        for (const auto& read : pass.reads) {
+            dot << "  res" << read.handle.index << " -> pass" << id
+                << " [label=\"" << access_name(read.access) << "\"];\n";
+        }
+        for (const auto& write : pass.writes) {
+            dot << "  pass" << id << " -> res" << write.handle.index
+                << " [label=\"" << access_name(write.access) << " v" << write.handle.version << "\"];\n";
+        }
+    }
+
+    dot << "}\n";
+    return dot.str();
+}
+
+// TransientResourcePool implementation
+ResourceId TransientResourcePool::acquire_texture(RenderingEngine& engine, const RGTextureDesc& desc,
+                                                  uint32_t usage) {
+    for (auto& entry : entries_) {
+        if (!entry.inUse && entry.isTexture && entry.textureDesc.is_compatible(desc) &&
+            (entry.usage & usage) == usage) {
+            entry.inUse = true;
+            entry.usedThisFrame = true;
+            return entry.resource;
+        }
+    }
+
+    TextureDescriptor textureDesc;
+    textureDesc.width = desc.width;
+    textureDesc.height = desc.height;
+    textureDesc.depth = desc.depth;
+    textureDesc.mipLevelCount = desc.mipLevelCount;
+    textureDesc.sampleCount = desc.sampleCount;
+    textureDesc.dimension = desc.dimension;
+    textureDesc.format = desc.format;
+    textureDesc.usage = usage;
+
+    Entry entry;
+    entry.isTexture = true;
+    entry.textureDesc = desc;
+    entry.usage = usage;
+    entry.resource = engine.create_texture(textureDesc);
+    entry.bytes = desc.estimate_size();
+    entry.inUse = true;
+    entry.usedThisFrame = true;
+
+    allocatedBytes_ += entry.bytes;
+    entries_.push_back(entry);
+    return entry.resource;
+}
+
+ResourceId TransientResourcePool::acquire_buffer(RenderingEngine& engine, size_t size, uint32_t usage) {
+    Entry* best = nullptr;
+    for (auto& entry : entries_) {
+        if (!entry.inUse && !entry.isTexture && entry.bufferSize >= size &&
+            (entry.usage & usage) == usage && (!best || entry.bufferSize < best->bufferSize)) {
+            best = &entry;
+        }
+    }
+
+    if (best) {
+        best->inUse = true;
+        best->usedThisFrame = true;
+        return best->resource;
+    }
+
+    Entry entry;
+    entry.isTexture = false;
+    entry.bufferSize = size;
+    entry.usage = usage;
+    entry.resource = engine.create_buffer(size, static_cast<BufferUsage>(usage));
+    entry.bytes = size;
+    entry.inUse = true;
+    entry.usedThisFrame = true;
+
+    allocatedBytes_ += entry.bytes;
+    entries_.push_back(entry);
+    return entry.resource;
+}
+
+void TransientResourcePool::release(ResourceId resource) {
+    for (auto& entry : entries_) {
+        if (entry.resource == resource) {
+            entry.inUse = false;
+            return;
+        }
+    }
+}
+
+void TransientResourcePool::end_frame(RenderingEngine& engine) {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->usedThisFrame || it->inUse) {
+            it->usedThisFrame = false;
+            it->idleFrames = 0;
+            ++it;
+        } else if (++it->idleFrames > RETIRE_AFTER_FRAMES) {
+            engine.destroy_resource(it->resource);
+            allocatedBytes_ -= it->bytes;
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void TransientResourcePool::clear(RenderingEngine& engine) {
+    for (const auto& entry : entries_) {
+        engine.destroy_resource(entry.resource);
+    }
+    entries_.clear();
+    allocatedBytes_ = 0;
+}
+
+} // namespace QuantumCanvas::Rendering
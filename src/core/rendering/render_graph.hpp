@@ -0,0 +1,313 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <array>
+#include <string>
+#include <functional>
+#include <cstdint>
+#include <limits>
+
+#include "rendering_engine.hpp"
+
+struct WGPUCommandEncoder;
+struct WGPURenderPassEncoder;
+struct WGPUTextureView;
+
+namespace QuantumCanvas::Rendering {
+
+// Frame graph: passes declare what they read and write during setup, then
+// compile() culls passes whose results are never consumed, merges adjacent
+// render passes that share attachments, and packs transient resources with
+// disjoint lifetimes onto the same physical allocation. WebGPU transitions
+// resources itself between passes, so the graph only has to end a render
+// pass where the next one uses something in a different state.
+
+// Versioned handle to a graph resource. Every write produces a new version,
+// which is how the graph orders read-modify-write chains such as a stack of
+// blends into one target.
+struct RGResourceHandle {
+    static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+    uint32_t index = INVALID_INDEX;
+    uint32_t version = 0;
+
+    bool is_valid() const { return index != INVALID_INDEX; }
+    bool operator==(const RGResourceHandle& other) const {
+        return index == other.index && version == other.version;
+    }
+    bool operator!=(const RGResourceHandle& other) const { return !(*this == other); }
+};
+
+using RGPassId = uint32_t;
+
+enum class RGPassType {
+    Render,   // Runs inside a render pass begun by the graph
+    Compute,
+    Copy
+};
+
+// How a pass touches a resource; accesses in different states cannot share a render pass
+enum class RGAccess {
+    ShaderRead,
+    StorageRead,
+    StorageWrite,
+    ColorAttachment,
+    DepthAttachment,
+    DepthRead,
+    CopySrc,
+    CopyDst,
+    Present
+};
+
+enum class RGLoadOp {
+    Load,
+    Clear,
+    DontCare
+};
+
+struct RGTextureDesc {
+    uint32_t width = 1;
+    uint32_t height = 1;
+    uint32_t depth = 1;
+    uint32_t mipLevelCount = 1;
+    uint32_t sampleCount = 1;
+    TextureDescriptor::Dimension dimension = TextureDescriptor::Dimension::D2;
+    TextureDescriptor::Format format = TextureDescriptor::Format::RGBA8Unorm;
+
+    bool is_compatible(const RGTextureDesc& other) const;  // Can share one allocation
+    size_t estimate_size() const;
+};
+
+struct RGBufferDesc {
+    size_t size = 0;
+    uint32_t usage = 0;  // BufferUsage bits required beyond those implied by accesses
+};
+
+class RenderGraph;
+class TransientResourcePool;
+
+// Passed to a pass's setup callback, which runs inside add_pass()
+class RenderGraphBuilder {
+public:
+    RGResourceHandle create_texture(const std::string& name, const RGTextureDesc& desc);
+    RGResourceHandle create_buffer(const std::string& name, const RGBufferDesc& desc);
+
+    RGResourceHandle read(RGResourceHandle resource, RGAccess access = RGAccess::ShaderRead);
+    RGResourceHandle write(RGResourceHandle resource, RGAccess access = RGAccess::StorageWrite);
+
+    // Render passes only; attachments decide which passes can be merged
+    RGResourceHandle write_color(RGResourceHandle resource, RGLoadOp loadOp = RGLoadOp::Load,
+                                 const std::array<float, 4>& clearColor = {0.0f, 0.0f, 0.0f, 0.0f});
+    RGResourceHandle write_depth(RGResourceHandle resource, RGLoadOp loadOp = RGLoadOp::Load,
+                                 float clearDepth = 1.0f);
+
+    // Keep the pass even if nothing reads its output (readback, present, queries)
+    void set_side_effect();
+
+private:
+    friend class RenderGraph;
+    RenderGraphBuilder(RenderGraph& graph, RGPassId pass) : graph_(graph), pass_(pass) {}
+
+    RenderGraph& graph_;
+    RGPassId pass_;
+};
+
+// Passed to a pass's execute callback
+class RenderPassContext {
+public:
+    RenderingEngine& engine() const { return engine_; }
+
+    ResourceId get_texture(RGResourceHandle resource) const;
+    ResourceId get_buffer(RGResourceHandle resource) const;
+
+    // Null outside Render passes
+    WGPURenderPassEncoder* render_pass_encoder() const { return renderPassEncoder_; }
+    WGPUCommandEncoder* command_encoder() const { return commandEncoder_; }
+
+private:
+    friend class RenderGraph;
+    RenderPassContext(RenderingEngine& engine, const RenderGraph& graph)
+        : engine_(engine), graph_(graph) {}
+
+    RenderingEngine& engine_;
+    const RenderGraph& graph_;
+    WGPUCommandEncoder* commandEncoder_ = nullptr;
+    WGPURenderPassEncoder* renderPassEncoder_ = nullptr;
+};
+
+class RenderGraph {
+public:
+    using SetupFunction = std::function<void(RenderGraphBuilder&)>;
+    using ExecuteFunction = std::function<void(RenderPassContext&)>;
+
+    RenderGraph() = default;
+    ~RenderGraph() = default;
+
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    // Building. Setup runs immediately, so handles it creates can be used
+    // by passes added afterwards; declaration order is execution order.
+    RGPassId add_pass(const std::string& name, RGPassType type,
+                      const SetupFunction& setup, ExecuteFunction execute);
+
+    // External resources live outside the graph and are never aliased
+    RGResourceHandle import_texture(const std::string& name, ResourceId texture,
+                                    const RGTextureDesc& desc = {});
+    RGResourceHandle import_buffer(const std::string& name, ResourceId buffer,
+                                   const RGBufferDesc& desc = {});
+
+    // Passes contributing to the latest version of this resource are kept
+    void mark_output(RGResourceHandle resource);
+
+    // Cull, merge and assign transient memory. Called by
+    // execute() when the graph changed since the last compile.
+    void compile();
+    bool is_compiled() const { return compiled_; }
+
+    // Records every surviving pass into one command encoder and submits it
+    void execute(RenderingEngine& engine);
+
+    // Drop passes and resources but keep allocations for the next frame
+    void reset();
+
+    struct CompileStats {
+        uint32_t passesDeclared = 0;
+        uint32_t passesCulled = 0;
+        uint32_t passesMerged = 0;       // Folded into the preceding render pass
+        uint32_t renderPassCount = 0;    // Render passes actually begun
+        uint32_t hazardSplits = 0;       // Render passes ended for a state change
+        uint32_t transientResources = 0;
+        uint32_t physicalResources = 0;  // Allocations backing the transients
+        size_t transientBytesRequested = 0;
+        size_t transientBytesAllocated = 0;
+    };
+    const CompileStats& get_compile_stats() const { return compileStats_; }
+
+    // Debugging
+    bool is_pass_culled(RGPassId pass) const;
+    bool is_pass_merged(RGPassId pass) const;  // Shares the preceding pass's render pass
+    uint32_t get_physical_slot(RGResourceHandle resource) const;  // INVALID_INDEX if not transient
+    std::string export_graphviz() const;
+
+private:
+    friend class RenderGraphBuilder;
+    friend class RenderPassContext;
+
+    struct ResourceAccess {
+        RGResourceHandle handle;
+        RGAccess access;
+        bool overwrites = false;  // Cleared write: prior contents are not needed
+    };
+
+    struct Attachment {
+        RGResourceHandle handle;
+        RGLoadOp loadOp = RGLoadOp::Load;
+        std::array<float, 4> clearColor{0.0f, 0.0f, 0.0f, 0.0f};
+        float clearDepth = 1.0f;
+    };
+
+    struct Pass {
+        std::string name;
+        RGPassType type;
+        ExecuteFunction execute;
+        std::vector<ResourceAccess> reads;
+        std::vector<ResourceAccess> writes;
+        std::vector<Attachment> colorAttachments;
+        Attachment depthAttachment;  // handle invalid if none
+        bool hasSideEffect = false;
+
+        // Compile results
+        bool culled = false;
+        bool mergedWithPrevious = false;
+        bool hazard = false;  // Uses a resource in another state than the pass before
+    };
+
+    struct Resource {
+        std::string name;
+        bool isTexture = true;
+        bool imported = false;
+        bool output = false;
+        RGTextureDesc textureDesc;
+        RGBufferDesc bufferDesc;
+        ResourceId external = 0;
+        uint32_t usage = 0;                       // Accumulated WGPU usage bits
+        uint32_t version = 0;                     // Latest version
+        std::vector<RGPassId> producers;          // producers[v - 1] wrote version v
+
+        // Compile results
+        uint32_t firstUse = RGResourceHandle::INVALID_INDEX;
+        uint32_t lastUse = 0;
+        uint32_t physicalSlot = RGResourceHandle::INVALID_INDEX;
+    };
+
+    struct PhysicalSlot {
+        bool isTexture = true;
+        RGTextureDesc textureDesc;
+        size_t bufferSize = 0;
+        uint32_t usage = 0;
+        uint32_t lastUse = 0;
+        ResourceId resource = 0;  // Filled in at execute time from the pool
+    };
+
+    std::vector<Pass> passes_;
+    std::vector<Resource> resources_;
+    std::vector<PhysicalSlot> physicalSlots_;
+    std::vector<RGPassId> executionOrder_;  // Surviving passes
+    bool compiled_ = false;
+    CompileStats compileStats_;
+
+    Resource& resource(RGResourceHandle handle);
+    const Resource& resource(RGResourceHandle handle) const;
+    RGResourceHandle add_resource(Resource resource);
+    RGResourceHandle record_read(RGPassId pass, RGResourceHandle handle, RGAccess access);
+    RGResourceHandle record_write(RGPassId pass, RGResourceHandle handle, RGAccess access,
+                                  bool overwrites = false);
+
+    void cull_passes();
+    void compute_lifetimes(const std::vector<RGPassId>& order);
+    void find_hazards(const std::vector<RGPassId>& order);
+    void merge_passes(const std::vector<RGPassId>& order);
+    void alias_transients();
+    bool can_merge(const Pass& previous, const Pass& next) const;
+    ResourceId physical_resource(RGResourceHandle handle) const;
+};
+
+// Physical transient textures and buffers, kept across frames so an unchanged
+// graph allocates nothing in steady state. Owned by the RenderingEngine.
+class TransientResourcePool {
+public:
+    // Entries unused for this many frames are destroyed
+    static constexpr uint32_t RETIRE_AFTER_FRAMES = 3;
+
+    ResourceId acquire_texture(RenderingEngine& engine, const RGTextureDesc& desc, uint32_t usage);
+    ResourceId acquire_buffer(RenderingEngine& engine, size_t size, uint32_t usage);
+
+    // Work is submitted in order on one queue, so an entry can be handed to
+    // the next graph as soon as the graph using it has been submitted
+    void release(ResourceId resource);
+
+    void end_frame(RenderingEngine& engine);  // Retires entries idle for too long
+    void clear(RenderingEngine& engine);
+
+    size_t get_allocated_bytes() const { return allocatedBytes_; }
+    size_t get_entry_count() const { return entries_.size(); }
+
+private:
+    struct Entry {
+        bool isTexture = true;
+        RGTextureDesc textureDesc;
+        size_t bufferSize = 0;
+        uint32_t usage = 0;
+        ResourceId resource = 0;
+        size_t bytes = 0;
+        bool inUse = false;
+        bool usedThisFrame = false;
+        uint32_t idleFrames = 0;
+    };
+    std::vector<Entry> entries_;
+    size_t allocatedBytes_ = 0;
+};
+
+} // namespace QuantumCanvas::Rendering
@@ -13,18 +13,41 @@
 #include "render_command.hpp"
 #include "render_resource.hpp"
 #include "render_graph.hpp"
+#include "command_list.hpp"
 #include "shader_compiler.hpp"
+#include "../kernel/task_scheduler.hpp"
 #include <iostream>
 #include <cassert>
 #include <algorithm>
+#include <cstring>
 
 // WGPU includes - would be actual WGPU headers in real implementation
 #include "wgpu_wrapper.hpp"
 
 namespace QuantumCanvas::Rendering {
 
+namespace {
+
+std::atomic<uint64_t> nextEngineSerial{1};
+
+// Last list this thread recorded into; serials are never reused, so a stale
+// entry from a destroyed engine can never match
+struct ThreadCommandListCache {
+    uint64_t engineSerial = 0;
+    CommandList* list = nullptr;
+};
+thread_local ThreadCommandListCache threadListCache;
+
+} // namespace
+
 RenderingEngine::RenderingEngine(const RenderConfig& config)
-    : config_(config) {
+    : commandMerger_(std::make_unique<CommandListMerger>())
+    , serial_(nextEngineSerial.fetch_add(1, std::memory_order_relaxed))
+    , localFrameArena_(std::make_unique<Core::FrameArena>())
+    , transientPool_(std::make_unique<TransientResourcePool>())
+    , uploadRing_(std::make_unique<UploadRing>())
+    , config_(config)
+    , profiler_(std::make_unique<Profiler>(config.profilerFrameHistory)) {
     
     // Initialize shader compiler
     shaderCompiler_ = std::make_unique<ShaderCompiler>();
@@ -34,6 +57,7 @@ RenderingEngine::RenderingEngine(const RenderConfig& config)
         buffer.commands.reserve(1024);
         buffer.transientResources.reserve(256);
     }
+    register_telemetry();
 }
 
 RenderingEngine::~RenderingEngine() {
@@ -50,14 +74,31 @@ RenderingEngine::RenderingEngine(RenderingEngine&& other) noexcept
     , currentFrameIndex_(other.currentFrameIndex_)
     , commandBuffers_(std::move(other.commandBuffers_))
     , currentBuffer_(other.currentBuffer_.load())
+    , commandLists_(std::move(other.commandLists_))
+    , threadCommandLists_(std::move(other.threadCommandLists_))
+    , commandMerger_(std::move(other.commandMerger_))
+    , serial_(std::exchange(other.serial_, nextEngineSerial.fetch_add(1, std::memory_order_relaxed)))
+    , memoryManager_(std::exchange(other.memoryManager_, nullptr))
+    , localFrameArena_(std::move(other.localFrameArena_))
     , pipelineCache_(std::move(other.pipelineCache_))
     , resources_(std::move(other.resources_))
     , nextResourceId_(other.nextResourceId_.load())
     , shaderCompiler_(std::move(other.shaderCompiler_))
     , renderGraph_(std::move(other.renderGraph_))
+    , transientPool_(std::move(other.transientPool_))
+    , uploadRing_(std::move(other.uploadRing_))
+    , uploadStaging_(std::move(other.uploadStaging_))
+    , readbackPool_(std::move(other.readbackPool_))
+    , renderDevice_(std::move(other.renderDevice_))
+    , headless_(std::exchange(other.headless_, false))
+    , offscreenTarget_(std::exchange(other.offscreenTarget_, 0))
+    , renderTarget_(std::exchange(other.renderTarget_, 0))
+    , frameOnTexture_(other.frameOnTexture_)
     , config_(other.config_)
     , initialized_(other.initialized_.load())
-    , stats_(other.stats_) {
+    , stats_(other.stats_)
+    , profiler_(std::move(other.profiler_)) {
+    register_telemetry();
 }
 
 RenderingEngine& RenderingEngine::operator=(RenderingEngine&& other) noexcept {
@@ -73,14 +114,30 @@ RenderingEngine& RenderingEngine::operator=(RenderingEngine&& other) noexcept {
         currentFrameIndex_ = other.currentFrameIndex_;
         commandBuffers_ = std::move(other.commandBuffers_);
         currentBuffer_ = other.currentBuffer_.load();
+        commandLists_ = std::move(other.commandLists_);
+        threadCommandLists_ = std::move(other.threadCommandLists_);
+        commandMerger_ = std::move(other.commandMerger_);
+        serial_ = std::exchange(other.serial_, nextEngineSerial.fetch_add(1, std::memory_order_relaxed));
+        memoryManager_ = std::exchange(other.memoryManager_, nullptr);
+        localFrameArena_ = std::move(other.localFrameArena_);
         pipelineCache_ = std::move(other.pipelineCache_);
         resources_ = std::move(other.resources_);
         nextResourceId_ = other.nextResourceId_.load();
         shaderCompiler_ = std::move(other.shaderCompiler_);
         renderGraph_ = std::move(other.renderGraph_);
+        transientPool_ = std::move(other.transientPool_);
+        uploadRing_ = std::move(other.uploadRing_);
+        uploadStaging_ = std::move(other.uploadStaging_);
+        readbackPool_ = std::move(other.readbackPool_);
+        renderDevice_ = std::move(other.renderDevice_);
+        headless_ = std::exchange(other.headless_, false);
+        offscreenTarget_ = std::exchange(other.offscreenTarget_, 0);
+        renderTarget_ = std::exchange(other.renderTarget_, 0);
+        frameOnTexture_ = other.frameOnTexture_;
         config_ = other.config_;
         initialized_ = other.initialized_.load();
         stats_ = other.stats_;
+        profiler_ = std::move(other.profiler_);
     }
     return *this;
 }
@@ -104,21 +161,79 @@ bool RenderingEngine::initialize(void* nativeWindow) {
             return false;
         }
         
-        // Initialize shader compiler
-        if (!shaderCompiler_->initialize(device_)) {
-            std::cerr << "Failed to initialize shader compiler" << std::endl;
-            destroy_device();
+        return initialize_context();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Rendering engine initialization failed: " << e.what() << std::endl;
+        destroy_device();
+        return false;
+    }
+}
+
+bool RenderingEngine::initialize_headless(uint32_t width, uint32_t height, std::shared_ptr<RenderDevice> device) {
+    if (initialized_) {
+        return true;
+    }
+    
+    try {
+        renderDevice_ = std::move(device);
+        if (!create_device()) {
+            std::cerr << "Failed to create WGPU device" << std::endl;
             return false;
         }
         
-        initialized_ = true;
+        headless_ = true;
+        if (!initialize_context()) {
+            headless_ = false;
+            return false;
+        }
+        
+        // Stands in for the swap chain; readable like any texture
+        TextureDescriptor targetDesc;
+        targetDesc.width = width;
+        targetDesc.height = height;
+        targetDesc.format = TextureDescriptor::Format::RGBA8Unorm;
+        targetDesc.usage = static_cast<uint32_t>(TextureDescriptor::Usage::RenderAttachment) |
+                           static_cast<uint32_t>(TextureDescriptor::Usage::CopySrc) |
+                           static_cast<uint32_t>(TextureDescriptor::Usage::TextureBinding);
+        offscreenTarget_ = create_texture(targetDesc);
         return true;
     }
     catch (const std::exception& e) {
-        std::cerr << "Rendering engine initialization failed: " << e.what() << std::endl;
+        std::cerr << "Headless rendering engine initialization failed: " << e.what() << std::endl;
+        if (initialized_) {
+            shutdown();
+        } else {
+            destroy_device();
+        }
+        headless_ = false;
+        return false;
+    }
+}
+
+bool RenderingEngine::initialize_context() {
+    // Initialize shader compiler; its disk cache is only valid for this adapter and driver
+    shaderCompiler_->set_device_fingerprint(get_device_capabilities().fingerprint());
+    if (!shaderCompiler_->initialize(device_)) {
+        std::cerr << "Failed to initialize shader compiler" << std::endl;
+        destroy_device();
+        return false;
+    }
+    
+    if (!create_upload_ring(config_.uploadRingSizeKB * 1024)) {
+        std::cerr << "Failed to create upload ring" << std::endl;
         destroy_device();
         return false;
     }
+    
+    readbackPool_ = std::make_shared<ReadbackPool>(
+        [](WGPUBuffer* buffer) { WGPUWrapper::buffer_unmap(buffer); },
+        [](WGPUBuffer* buffer) { WGPUWrapper::buffer_release(buffer); },
+        config_.readbackPoolSizeKB * 1024);
+    
+    initialized_ = true;
+    enable_profiling(config_.enableProfiling);
+    return true;
 }
 
 void RenderingEngine::shutdown() {
@@ -129,6 +244,31 @@ void RenderingEngine::shutdown() {
     // Wait for GPU to finish
     WGPUWrapper::device_poll(device_, true);
     
+    // Map callbacks point at the staging slots, so none may still be due
+    if (readbackPool_) {
+        while (readbackPool_->pending() > 0) {
+            WGPUWrapper::device_poll(device_, true);
+        }
+        readbackPool_->shutdown();
+        readbackPool_.reset();
+    }
+    
+    if (currentTextureView_) {
+        WGPUWrapper::texture_view_release(currentTextureView_);
+        currentTextureView_ = nullptr;
+    }
+    offscreenTarget_ = 0;
+    renderTarget_ = 0;
+    headless_ = false;
+    
+    // Pooled transients are ordinary resources; drop the pool's references first
+    if (transientPool_) {
+        transientPool_->clear(*this);
+    }
+    
+    destroy_upload_ring();
+    profiler_->shutdown_gpu();
+    
     // Clear resources
     {
         std::lock_guard<std::mutex> lock(resourcesMutex_);
@@ -147,6 +287,19 @@ void RenderingEngine::shutdown() {
         buffer.commands.clear();
         buffer.transientResources.clear();
     }
+    {
+        std::lock_guard<std::mutex> lock(commandListsMutex_);
+        for (auto& list : commandLists_) {
+            list->clear();
+        }
+    }
+    
+    // Destroy any commands still held by the frame arena
+    if (memoryManager_) {
+        memoryManager_->end_frame();
+    } else if (localFrameArena_) {
+        localFrameArena_->reset();
+    }
     
     // Shutdown components
     if (shaderCompiler_) {
@@ -161,9 +314,21 @@ void RenderingEngine::begin_frame() {
     assert(initialized_);
     
     frameStartTime_ = std::chrono::high_resolution_clock::now();
-    
-    // Get current swap chain texture
-    WGPUTextureView textureView = WGPUWrapper::swapchain_get_current_texture_view(swapChain_);
+    profiler_->begin_frame();
+    
+    // Current swap chain texture, or the texture frames render to
+    frameOnTexture_ = headless_ || renderTarget_ != 0;
+    WGPUTextureView* textureView = nullptr;
+    if (frameOnTexture_) {
+        // Headless frames need not be presented; drop the last one's view
+        if (currentTextureView_) {
+            WGPUWrapper::texture_view_release(currentTextureView_);
+            currentTextureView_ = nullptr;
+        }
+        textureView = create_texture_view(get_frame_target());
+    } else {
+        textureView = WGPUWrapper::swapchain_get_current_texture_view(swapChain_);
+    }
     if (!textureView) {
         // Handle swap chain recreation
         return;
@@ -172,6 +337,18 @@ void RenderingEngine::begin_frame() {
     currentTextureView_ = textureView;
     currentFrameIndex_ = (currentFrameIndex_ + 1) % config_.maxFramesInFlight;
     
+    // Grow the upload ring if the last frame ran out. Frames in flight still
+    // read the old buffer, so this waits for the GPU once.
+    if (uploadRing_->overflows_this_frame() > 0) {
+        size_t capacity = uploadRing_->frame_capacity() * 2;
+        WGPUWrapper::device_poll(device_, true);
+        destroy_upload_ring();
+        if (!create_upload_ring(capacity)) {
+            std::cerr << "Failed to grow upload ring" << std::endl;
+        }
+    }
+    uploadRing_->begin_frame(currentFrameIndex_);
+    
     // Switch to next command buffer
     size_t nextBuffer = (currentBuffer_ + 1) % 2;
     auto& cmdBuffer = commandBuffers_[nextBuffer];
@@ -195,18 +372,100 @@ void RenderingEngine::begin_frame() {
 void RenderingEngine::end_frame() {
     assert(initialized_);
     
-    // Process current command buffer
-    process_command_buffer();
+    submit_recorded_commands();
+    submittedThisFrame_ = false;
+    
+    // Retire render graph transients that went unused for a few frames
+    transientPool_->end_frame(*this);
+    
+    // Everything for this frame is submitted, so its timestamps can be read back
+    profiler_->end_frame();
+    
+    // Finish readbacks whose copies the GPU has run
+    poll_readbacks();
     
     // Update statistics
     update_statistics();
+    
+    // Release this frame's scratch memory
+    if (memoryManager_) {
+        memoryManager_->end_frame();
+    } else {
+        localFrameArena_->reset();
+    }
+}
+
+void RenderingEngine::flush() {
+    assert(initialized_);
+    
+    submit_recorded_commands();
+}
+
+void RenderingEngine::submit_recorded_commands() {
+    // Merge the per-thread lists, then process current command buffer
+    {
+        ProfileScope scope(*profiler_, "merge_command_lists", "engine");
+        optimize_draw_calls();
+    }
+    {
+        ProfileScope scope(*profiler_, "submit_commands", "engine");
+        process_command_buffer();
+    }
+    
+    // Commands live in the frame arena, so drop them before it is recycled
+    {
+        auto& cmdBuffer = commandBuffers_[currentBuffer_.load()];
+        std::lock_guard<std::mutex> lock(cmdBuffer.mutex);
+        cmdBuffer.commands.clear();
+    }
+    {
+        std::lock_guard<std::mutex> lock(commandListsMutex_);
+        for (auto& list : commandLists_) {
+            list->clear();
+        }
+    }
+}
+
+void RenderingEngine::set_render_graph(std::unique_ptr<RenderGraph> graph) {
+    renderGraph_ = std::move(graph);
+}
+
+void RenderingEngine::execute_render_graph() {
+    if (!initialized_ || !renderGraph_) {
+        return;
+    }
+    
+    renderGraph_->execute(*this);
+    
+    const auto& graphStats = renderGraph_->get_compile_stats();
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats_.renderGraphPassesCulled = graphStats.passesCulled;
+    stats_.renderGraphPassesMerged = graphStats.passesMerged;
+}
+
+WGPUTextureView* RenderingEngine::create_texture_view(ResourceId texture) {
+    std::lock_guard<std::mutex> lock(resourcesMutex_);
+    
+    auto it = resources_.find(texture);
+    if (it == resources_.end()) {
+        return nullptr;
+    }
+    
+    auto* textureResource = static_cast<TextureResource*>(it->second.get());
+    return WGPUWrapper::texture_create_view(textureResource->handle, nullptr);
+}
+
+Core::FrameArena& RenderingEngine::frame_arena() {
+    return memoryManager_ ? memoryManager_->frame_arena() : *localFrameArena_;
 }
 
 void RenderingEngine::present() {
     assert(initialized_);
     
-    // Present the frame
-    WGPUWrapper::swapchain_present(swapChain_);
+    // Present the frame; one rendered to a texture stays there
+    if (!frameOnTexture_) {
+        WGPUWrapper::swapchain_present(swapChain_);
+    }
     
     // Release current texture view
     if (currentTextureView_) {
@@ -215,37 +474,72 @@ void RenderingEngine::present() {
     }
 }
 
+CommandList& RenderingEngine::thread_command_list() {
+    if (threadListCache.engineSerial == serial_) {
+        return *threadListCache.list;
+    }
+    
+    std::lock_guard<std::mutex> lock(commandListsMutex_);
+    
+    auto& list = threadCommandLists_[std::this_thread::get_id()];
+    if (!list) {
+        commandLists_.push_back(std::make_unique<CommandList>());
+        list = commandLists_.back().get();
+    }
+    
+    threadListCache = {serial_, list};
+    return *list;
+}
+
 void RenderingEngine::submit_draw_call(const DrawCall& call) {
-    size_t bufferIndex = currentBuffer_.load();
-    auto& cmdBuffer = commandBuffers_[bufferIndex];
+    thread_command_list().draw(call);
+}
+
+void RenderingEngine::submit_compute(const ComputeDispatch& dispatch) {
+    thread_command_list().dispatch(dispatch);
+}
+
+void RenderingEngine::optimize_draw_calls() {
+    std::vector<CommandList*> lists;
+    {
+        std::lock_guard<std::mutex> lock(commandListsMutex_);
+        lists.reserve(commandLists_.size());
+        for (auto& list : commandLists_) {
+            if (!list->empty()) {
+                lists.push_back(list.get());
+            }
+        }
+    }
     
-    std::lock_guard<std::mutex> lock(cmdBuffer.mutex);
+    if (lists.empty()) {
+        return;
+    }
     
-    // Create render command
-    auto renderCmd = std::make_unique<DrawRenderCommand>(call);
-    cmdBuffer.commands.push_back(std::move(renderCmd));
+    // Lists are sorted in parallel on the kernel scheduler when there is one
+    auto scheduler = Core::KernelManager::instance().get_service<Core::TaskScheduler>();
+    commandMerger_->merge(lists, scheduler.get());
     
-    // Update statistics
+    auto& cmdBuffer = commandBuffers_[currentBuffer_.load()];
     {
-        std::lock_guard<std::mutex> statsLock(statsMutex_);
-        stats_.drawCallCount++;
+        std::lock_guard<std::mutex> lock(cmdBuffer.mutex);
         
-        if (call.type == DrawCall::Type::Triangles) {
-            stats_.triangleCount += call.vertexCount / 3;
+        auto& arena = frame_arena();
+        for (const auto& command : commandMerger_->commands()) {
+            if (command.draw) {
+                cmdBuffer.commands.push_back(arena.create<DrawRenderCommand>(*command.draw));
+            } else {
+                cmdBuffer.commands.push_back(arena.create<ComputeRenderCommand>(*command.dispatch));
+            }
         }
-        stats_.vertexCount += call.vertexCount;
     }
-}
-
-void RenderingEngine::submit_compute(const ComputeDispatch& dispatch) {
-    size_t bufferIndex = currentBuffer_.load();
-    auto& cmdBuffer = commandBuffers_[bufferIndex];
-    
-    std::lock_guard<std::mutex> lock(cmdBuffer.mutex);
     
-    // Create compute command
-    auto computeCmd = std::make_unique<ComputeRenderCommand>(dispatch);
-    cmdBuffer.commands.push_back(std::move(computeCmd));
+    const auto& mergeStats = commandMerger_->stats();
+    std::lock_guard<std::mutex> statsLock(statsMutex_);
+    stats_.drawCallCount += mergeStats.drawCount;
+    stats_.triangleCount += static_cast<uint32_t>(mergeStats.triangleCount);
+    stats_.vertexCount += mergeStats.vertexCount;
+    stats_.stateChanges = mergeStats.stateChanges;
+    stats_.batchedDrawCalls = mergeStats.batchedDrawCalls;
 }
 
 ResourceId RenderingEngine::create_buffer(size_t size, BufferUsage usage, const void* data) {
@@ -300,15 +594,17 @@ ResourceId RenderingEngine::create_texture(const TextureDescriptor& desc, const
         destination.mipLevel = 0;
         destination.origin = {0, 0, 0};
         
+        const uint32_t bytesPerRow = desc.width * bytes_per_pixel(desc.format);
+        
         WGPUTextureDataLayout dataLayout = {};
         dataLayout.offset = 0;
-        dataLayout.bytesPerRow = desc.width * 4; // Assuming RGBA8
+        dataLayout.bytesPerRow = bytesPerRow;
         dataLayout.rowsPerImage = desc.height;
         
         WGPUExtent3D writeSize = {desc.width, desc.height, desc.depth};
         
         WGPUWrapper::queue_write_texture(queue_, &destination, data, 
-                                        desc.width * desc.height * 4, 
+                                        static_cast<size_t>(bytesPerRow) * desc.height * desc.depth, 
                                         &dataLayout, &writeSize);
     }
     
@@ -323,6 +619,139 @@ ResourceId RenderingEngine::create_texture(const TextureDescriptor& desc, const
     return id;
 }
 
+void RenderingEngine::write_texture(ResourceId id, const void* data, uint32_t bytesPerRow) {
+    WGPUTexture* handle = nullptr;
+    TextureDescriptor desc;
+    {
+        std::lock_guard<std::mutex> lock(resourcesMutex_);
+        auto it = resources_.find(id);
+        if (it == resources_.end() || !data) {
+            return;
+        }
+        auto* texture = static_cast<TextureResource*>(it->second.get());
+        handle = texture->handle;
+        desc = texture->descriptor;
+    }
+    
+    if (bytesPerRow == 0) {
+        bytesPerRow = desc.width * bytes_per_pixel(desc.format);
+    }
+    
+    WGPUImageCopyTexture destination = {};
+    destination.texture = handle;
+    
+    WGPUTextureDataLayout dataLayout = {};
+    dataLayout.bytesPerRow = bytesPerRow;
+    dataLayout.rowsPerImage = desc.height;
+    
+    WGPUExtent3D writeSize = {desc.width, desc.height, 1};
+    WGPUWrapper::queue_write_texture(queue_, &destination, data,
+                                     static_cast<size_t>(bytesPerRow) * desc.height,
+                                     &dataLayout, &writeSize);
+}
+
+bool RenderingEngine::read_texture(ResourceId id, void* data, uint32_t bytesPerRow) {
+    if (!data) {
+        return false;
+    }
+    
+    Readback readback = read_texture_async(id);
+    return wait_readback(readback) && readback.copy_to(data, bytesPerRow);
+}
+
+Readback RenderingEngine::read_texture_async(ResourceId id) {
+    WGPUTexture* handle = nullptr;
+    TextureDescriptor desc;
+    {
+        std::lock_guard<std::mutex> lock(resourcesMutex_);
+        auto it = resources_.find(id);
+        if (it == resources_.end() || !readbackPool_) {
+            return {};
+        }
+        auto* texture = static_cast<TextureResource*>(it->second.get());
+        handle = texture->handle;
+        desc = texture->descriptor;
+    }
+    
+    // Texture-to-buffer copies need rows aligned to 256 bytes
+    constexpr uint32_t COPY_ROW_ALIGNMENT = 256;
+    const uint32_t rowBytes = desc.width * bytes_per_pixel(desc.format);
+    const uint32_t paddedRow = (rowBytes + COPY_ROW_ALIGNMENT - 1) / COPY_ROW_ALIGNMENT * COPY_ROW_ALIGNMENT;
+    const size_t stagingSize = static_cast<size_t>(paddedRow) * desc.height;
+    
+    ReadbackSlot* slot = readbackPool_->acquire(stagingSize);
+    if (!slot->buffer) {
+        WGPUBufferDescriptor bufferDesc = {};
+        bufferDesc.size = slot->capacity;
+        bufferDesc.usage = static_cast<WGPUBufferUsage>(WGPUBufferUsage_MapRead | WGPUBufferUsage_CopyDst);
+        slot->buffer = WGPUWrapper::device_create_buffer(device_, &bufferDesc);
+        if (!slot->buffer) {
+            readbackPool_->abandon(slot);
+            return {};
+        }
+    }
+    slot->width = desc.width;
+    slot->height = desc.height;
+    slot->rowBytes = rowBytes;
+    slot->paddedRowBytes = paddedRow;
+    
+    WGPUCommandEncoderDescriptor encoderDesc = {};
+    WGPUCommandEncoder* encoder = WGPUWrapper::device_create_command_encoder(device_, &encoderDesc);
+    
+    WGPUImageCopyTexture source = {};
+    source.texture = handle;
+    
+    WGPUImageCopyBuffer destination = {};
+    destination.buffer = slot->buffer;
+    destination.layout.bytesPerRow = paddedRow;
+    destination.layout.rowsPerImage = desc.height;
+    
+    WGPUExtent3D copySize = {desc.width, desc.height, 1};
+    WGPUWrapper::command_encoder_copy_texture_to_buffer(encoder, &source, &destination, &copySize);
+    
+    WGPUCommandBufferDescriptor cmdBufferDesc = {};
+    WGPUCommandBuffer* commandBuffer = WGPUWrapper::command_encoder_finish(encoder, &cmdBufferDesc);
+    WGPUWrapper::queue_submit(queue_, 1, &commandBuffer);
+    WGPUWrapper::command_buffer_release(commandBuffer);
+    WGPUWrapper::command_encoder_release(encoder);
+    
+    // Held before the map is requested, so collect() on another thread
+    // cannot recycle the slot once it completes
+    Readback readback = readbackPool_->track(slot);
+    
+    // The queue runs in order, so once the copy is mapped everything
+    // submitted before it has finished
+    WGPUWrapper::buffer_map_async(slot->buffer, WGPUMapMode_Read, 0, stagingSize,
+        [](bool success, void* userdata) {
+            auto* target = static_cast<ReadbackSlot*>(userdata);
+            const size_t size = static_cast<size_t>(target->paddedRowBytes) * target->height;
+            ReadbackPool::complete(*target, success ? static_cast<const uint8_t*>(
+                WGPUWrapper::buffer_get_mapped_range(target->buffer, 0, size)) : nullptr);
+        }, slot);
+    
+    return readback;
+}
+
+void RenderingEngine::poll_readbacks() {
+    if (!readbackPool_) {
+        return;
+    }
+    
+    WGPUWrapper::device_poll(device_, false);
+    readbackPool_->collect();
+}
+
+bool RenderingEngine::wait_readback(const Readback& readback) {
+    if (!readback.is_valid()) {
+        return false;
+    }
+    
+    while (!readback.is_ready()) {
+        WGPUWrapper::device_poll(device_, true);
+    }
+    return readback.succeeded();
+}
+
 ResourceId RenderingEngine::create_sampler(const SamplerDescriptor& desc) {
     auto sampler = std::make_unique<SamplerResource>();
     
@@ -352,6 +781,99 @@ ResourceId RenderingEngine::create_sampler(const SamplerDescriptor& desc) {
     return id;
 }
 
+UploadAllocation RenderingEngine::allocate_upload(size_t size, size_t alignment) {
+    return uploadRing_->allocate(size, alignment);
+}
+
+UploadAllocation RenderingEngine::upload(const void* data, size_t size, size_t alignment) {
+    UploadAllocation allocation = uploadRing_->allocate(size, alignment);
+    if (allocation.is_valid()) {
+        std::memcpy(allocation.data, data, size);
+    }
+    return allocation;
+}
+
+bool RenderingEngine::create_upload_ring(size_t frameCapacity) {
+    const uint32_t frames = std::max<uint32_t>(config_.maxFramesInFlight, 1);
+    frameCapacity = (frameCapacity + UploadRing::UNIFORM_ALIGNMENT - 1) /
+                    UploadRing::UNIFORM_ALIGNMENT * UploadRing::UNIFORM_ALIGNMENT;
+    
+    auto buffer = std::make_unique<BufferResource>();
+    
+    BufferUsage usage = BufferUsage::Uniform | BufferUsage::Vertex | BufferUsage::Index |
+                        BufferUsage::Storage | BufferUsage::CopySrc | BufferUsage::CopyDst;
+    
+    // Filled by queue writes from the staging memory; a submit may not use
+    // a mapped buffer
+    WGPUBufferDescriptor desc = {};
+    desc.size = frameCapacity * frames;
+    desc.usage = static_cast<WGPUBufferUsage>(usage);
+    desc.mappedAtCreation = false;
+    
+    buffer->handle = WGPUWrapper::device_create_buffer(device_, &desc);
+    if (!buffer->handle) {
+        return false;
+    }
+    buffer->size = desc.size;
+    buffer->usage = static_cast<uint32_t>(usage);
+    
+    uploadStaging_.assign(desc.size, 0);
+    
+    ResourceId id = nextResourceId_++;
+    buffer->id = id;
+    
+    {
+        std::lock_guard<std::mutex> lock(resourcesMutex_);
+        resources_[id] = std::move(buffer);
+    }
+    
+    uploadRing_->attach(id, uploadStaging_.data(), frameCapacity, frames);
+    return true;
+}
+
+void RenderingEngine::destroy_upload_ring() {
+    if (!uploadRing_ || !uploadRing_->is_attached()) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(resourcesMutex_);
+        auto it = resources_.find(uploadRing_->buffer());
+        if (it != resources_.end()) {
+            resources_.erase(it);
+        }
+    }
+    
+    uploadRing_->detach();
+    uploadStaging_.clear();
+    uploadStaging_.shrink_to_fit();
+}
+
+void RenderingEngine::write_uploads() {
+    if (!uploadRing_ || !uploadRing_->is_attached()) {
+        return;
+    }
+    
+    UploadRing::Range range = uploadRing_->take_unwritten();
+    if (range.size == 0) {
+        return;
+    }
+    
+    WGPUBuffer* handle = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(resourcesMutex_);
+        auto it = resources_.find(uploadRing_->buffer());
+        if (it != resources_.end()) {
+            handle = static_cast<BufferResource*>(it->second.get())->handle;
+        }
+    }
+    
+    // Runs on the queue ahead of the commands submitted after it
+    if (handle) {
+        WGPUWrapper::queue_write_buffer(queue_, handle, range.offset, range.data, range.size);
+    }
+}
+
 void RenderingEngine::destroy_resource(ResourceId id) {
     std::lock_guard<std::mutex> lock(resourcesMutex_);
     
@@ -362,29 +884,17 @@ void RenderingEngine::destroy_resource(ResourceId id) {
 }
 
 bool RenderingEngine::create_device() {
-    // Request adapter
-    WGPURequestAdapterOptions adapterOptions = {};
-    adapterOptions.powerPreference = config_.preferDiscreteGPU ? 
-        WGPUPowerPreference_HighPerformance : WGPUPowerPreference_LowPower;
-    
-    adapter_ = WGPUWrapper::instance_request_adapter(&adapterOptions);
-    if (!adapter_) {
-        return false;
-    }
-    
-    // Request device
-    WGPUDeviceDescriptor deviceDesc = {};
-    deviceDesc.requiredFeatureCount = 0;
-    deviceDesc.requiredLimits = nullptr;
-    
-    device_ = WGPUWrapper::adapter_request_device(adapter_, &deviceDesc);
-    if (!device_) {
-        return false;
+    // A device handed in by initialize_headless() is shared, not created
+    if (!renderDevice_) {
+        renderDevice_ = RenderDevice::create(config_.preferDiscreteGPU);
+        if (!renderDevice_) {
+            return false;
+        }
     }
     
-    // Get queue
-    queue_ = WGPUWrapper::device_get_queue(device_);
-    
+    adapter_ = renderDevice_->adapter();
+    device_ = renderDevice_->device();
+    queue_ = renderDevice_->queue();
     return true;
 }
 
@@ -420,20 +930,11 @@ void RenderingEngine::destroy_device() {
         surface_ = nullptr;
     }
     
-    if (queue_) {
-        WGPUWrapper::queue_release(queue_);
-        queue_ = nullptr;
-    }
-    
-    if (device_) {
-        WGPUWrapper::device_release(device_);
-        device_ = nullptr;
-    }
-    
-    if (adapter_) {
-        WGPUWrapper::adapter_release(adapter_);
-        adapter_ = nullptr;
-    }
+    // Released with the last engine using it
+    queue_ = nullptr;
+    device_ = nullptr;
+    adapter_ = nullptr;
+    renderDevice_.reset();
 }
 
 void RenderingEngine::process_command_buffer() {
@@ -454,7 +955,7 @@ void RenderingEngine::process_command_buffer() {
     // Create render pass
     WGPURenderPassColorAttachment colorAttachment = {};
     colorAttachment.view = currentTextureView_;
-    colorAttachment.loadOp = WGPULoadOp_Clear;
+    colorAttachment.loadOp = submittedThisFrame_ ? WGPULoadOp_Load : WGPULoadOp_Clear;
     colorAttachment.storeOp = WGPUStoreOp_Store;
     colorAttachment.clearValue = {0.0, 0.0, 0.0, 1.0};
     
@@ -462,6 +963,15 @@ void RenderingEngine::process_command_buffer() {
     renderPassDesc.colorAttachmentCount = 1;
     renderPassDesc.colorAttachments = &colorAttachment;
     
+    // Time the frame's merged draws and dispatches as one GPU scope
+    WGPUPassTimestampWrites timestampWrites = {};
+    uint32_t timestampQuery = profiler_->begin_gpu_scope("frame_commands", "engine");
+    if (timestampQuery != Profiler::INVALID_QUERY) {
+        timestampWrites = {profiler_->query_set(), timestampQuery, timestampQuery + 1};
+        renderPassDesc.timestampWriteCount = 1;
+        renderPassDesc.timestampWrites = &timestampWrites;
+    }
+    
     WGPURenderPassEncoder passEncoder = WGPUWrapper::command_encoder_begin_render_pass(encoder, &renderPassDesc);
     
     // Execute commands
@@ -471,13 +981,16 @@ void RenderingEngine::process_command_buffer() {
     
     // End render pass
     WGPUWrapper::render_pass_encoder_end(passEncoder);
+    profiler_->resolve(encoder);
     
     // Finish command buffer
     WGPUCommandBufferDescriptor cmdBufferDesc = {};
     WGPUCommandBuffer commandBuffer = WGPUWrapper::command_encoder_finish(encoder, &cmdBufferDesc);
     
-    // Submit to queue
+    // Submit to queue, behind this frame's uploads
+    write_uploads();
     WGPUWrapper::queue_submit(queue_, 1, &commandBuffer);
+    submittedThisFrame_ = true;
     
     // Clean up
     WGPUWrapper::command_buffer_release(commandBuffer);
@@ -491,11 +1004,88 @@ void RenderingEngine::update_statistics() {
     auto now = std::chrono::high_resolution_clock::now();
     auto frameDuration = std::chrono::duration_cast<std::chrono::microseconds>(now - frameStartTime_);
     
+    std::vector<ScopeTiming> scopeTimings;
+    std::chrono::microseconds gpuTime{0};
+    if (profiler_->is_enabled()) {
+        scopeTimings = profiler_->get_last_frame_timings();
+        gpuTime = profiler_->get_last_gpu_frame_time();
+    }
+    
     std::lock_guard<std::mutex> lock(statsMutex_);
     stats_.frameTime = frameDuration;
+    stats_.scopeTimings = std::move(scopeTimings);
+    if (profiler_->has_gpu_timing()) {
+        stats_.gpuTime = gpuTime;
+    }
+    stats_.transientMemoryUsed = transientPool_->get_allocated_bytes();
+    stats_.uploadBytes = uploadRing_->bytes_this_frame();
+    stats_.uploadRingOverflows = uploadRing_->overflows_this_frame();
+    stats_.readbacksPending = static_cast<uint32_t>(readbackPool_->pending());
+    stats_.readbackPoolMemory = readbackPool_->idle_bytes();
     
     if (frameDuration.count() > 0) {
         stats_.fps = 1000000.0f / frameDuration.count();
+        
+        // Bytes per microsecond is MB/s
+        stats_.uploadBandwidthMBps = static_cast<float>(stats_.uploadBytes) / frameDuration.count();
+    }
+}
+
+RenderingEngine::DeviceCapabilities RenderingEngine::get_device_capabilities() const {
+    // WebGPU default limits; every conforming adapter supports at least these
+    DeviceCapabilities caps;
+    caps.maxTextureSize = 8192;
+    caps.maxTextureArrayLayers = 256;
+    caps.maxBindGroups = 4;
+    caps.maxUniformBufferSize = 65536;
+    caps.maxStorageBufferSize = 134217728;
+    caps.maxVertexBuffers = 8;
+    caps.maxVertexAttributes = 16;
+    caps.maxComputeWorkgroupSize[0] = 256;
+    caps.maxComputeWorkgroupSize[1] = 256;
+    caps.maxComputeWorkgroupSize[2] = 64;
+    caps.supportsRayTracing = false;
+    caps.supportsMeshShaders = false;
+    caps.supportsVariableRateShading = false;
+    caps.supportsBindlessResources = false;
+    
+    WGPUAdapterInfo info = {};
+    if (adapter_ && WGPUWrapper::adapter_get_info(adapter_, &info)) {
+        caps.deviceName = info.device ? info.device : "";
+        caps.driverDescription = info.description ? info.description : "";
+        caps.vendorId = info.vendorID;
+        caps.deviceId = info.deviceID;
+        caps.backendType = info.backendType;
+    }
+    
+    return caps;
+}
+
+uint64_t RenderingEngine::DeviceCapabilities::fingerprint() const {
+    // FNV-1a over everything that identifies the adapter and driver
+    uint64_t hash = 0xcbf29ce484222325ull;
+    auto mix_bytes = [&hash](const void* data, size_t size) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+        }
+    };
+    
+    mix_bytes(&vendorId, sizeof(vendorId));
+    mix_bytes(&deviceId, sizeof(deviceId));
+    mix_bytes(&backendType, sizeof(backendType));
+    mix_bytes(deviceName.data(), deviceName.size());
+    mix_bytes(driverDescription.data(), driverDescription.size());
+    return hash;
+}
+
+void RenderingEngine::enable_profiling(bool enable) {
+    config_.enableProfiling = enable;
+    profiler_->set_enabled(enable);
+    
+    // Query sets cost memory, so they are only created once someone asks
+    if (enable && initialized_ && !profiler_->has_gpu_timing()) {
+        profiler_->initialize_gpu(device_, config_.maxFramesInFlight);
     }
 }
 
@@ -509,4 +1099,34 @@ void RenderingEngine::reset_stats() {
     stats_ = RenderStats{};
 }
 
+namespace {
+
+// Everything the engine keeps is of the last frame
+void write_telemetry(const RenderStats& stats, Core::MetricWriter& writer) {
+    writer.gauge("draw_calls", stats.drawCallCount);
+    writer.gauge("batched_draw_calls", stats.batchedDrawCalls);
+    writer.gauge("state_changes", stats.stateChanges);
+    writer.gauge("triangles", stats.triangleCount);
+    writer.gauge("vertices", static_cast<double>(stats.vertexCount));
+    writer.gauge("frame_us", static_cast<double>(stats.frameTime.count()));
+    writer.gauge("gpu_us", static_cast<double>(stats.gpuTime.count()));
+    writer.gauge("fps", stats.fps);
+    writer.gauge("gpu_memory_bytes", static_cast<double>(stats.gpuMemoryUsed));
+    writer.gauge("texture_memory_bytes", static_cast<double>(stats.textureMemoryUsed));
+    writer.gauge("transient_memory_bytes", static_cast<double>(stats.transientMemoryUsed));
+    writer.gauge("graph_passes_culled", stats.renderGraphPassesCulled);
+    writer.gauge("graph_passes_merged", stats.renderGraphPassesMerged);
+    writer.gauge("upload_bytes", static_cast<double>(stats.uploadBytes));
+    writer.gauge("upload_ring_overflows", stats.uploadRingOverflows);
+    writer.gauge("readbacks_pending", stats.readbacksPending);
+    writer.gauge("readback_pool_bytes", static_cast<double>(stats.readbackPoolMemory));
+}
+
+} // namespace
+
+void RenderingEngine::register_telemetry() {
+    telemetrySource_ = Core::Telemetry::instance().add_stats_source(
+        "rendering.engine", *this, &RenderingEngine::get_stats, write_telemetry);
+}
+
 } // namespace QuantumCanvas::Rendering
\ No newline at end of file
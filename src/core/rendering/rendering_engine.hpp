@@ -8,6 +8,14 @@
 #include <mutex>
 #include <functional>
 #include <chrono>
+#include <thread>
+
+#include "../memory/memory_manager.hpp"
+#include "upload_ring.hpp"
+#include "readback_pool.hpp"
+#include "render_device.hpp"
+#include "profiler.hpp"
+#include "../kernel/telemetry.hpp"
 
 // Forward declare WGPU types
 struct WGPUDevice;
@@ -28,6 +36,9 @@ namespace QuantumCanvas::Rendering {
 class RenderCommand;
 class IRenderResource;
 class RenderGraph;
+class TransientResourcePool;
+class CommandList;
+class CommandListMerger;
 class ComputedPipeline;
 class ShaderCompiler;
 
@@ -45,6 +56,10 @@ struct RenderConfig {
     float targetFPS = 120.0f;
     bool enableVSync = false;
     uint32_t maxFramesInFlight = 2;
+    size_t uploadRingSizeKB = 4096;  // Per frame in flight; doubles when a frame runs out
+    bool enableProfiling = false;    // CPU scopes, plus GPU timestamps when the device has them
+    size_t profilerFrameHistory = Profiler::DEFAULT_FRAME_HISTORY;
+    size_t readbackPoolSizeKB = ReadbackPool::DEFAULT_IDLE_BUDGET / 1024;  // Idle staging buffers kept
     
     // GPU preferences
     bool preferDiscreteGPU = true;
@@ -79,10 +94,13 @@ struct DrawCall {
     
     ResourceId vertexBufferId = 0;
     ResourceId indexBufferId = 0;
+    uint64_t vertexBufferOffset = 0;  // e.g. upload ring allocations
+    uint64_t indexBufferOffset = 0;
     PipelineId pipelineId = 0;
     
     std::vector<ResourceId> textures;
     std::vector<ResourceId> uniformBuffers;
+    std::vector<uint32_t> uniformOffsets;  // Dynamic offsets, e.g. upload ring allocations
     
     // Render state
     bool depthTest = true;
@@ -107,6 +125,24 @@ struct RenderStats {
     float fps = 0.0f;
     uint32_t batchedDrawCalls = 0;
     uint32_t stateChanges = 0;
+    
+    // Render graph
+    uint32_t renderGraphPassesCulled = 0;
+    uint32_t renderGraphPassesMerged = 0;
+    size_t transientMemoryUsed = 0;  // Pooled render graph transients
+    
+    // Upload ring
+    uint64_t uploadBytes = 0;          // Written through the ring last frame
+    float uploadBandwidthMBps = 0.0f;
+    uint32_t uploadRingOverflows = 0;  // Allocations refused last frame
+    
+    // Readbacks
+    uint32_t readbacksPending = 0;
+    size_t readbackPoolMemory = 0;     // Idle staging buffers
+    
+    // Profiler (empty unless profiling is enabled). gpuTime above is the span
+    // of the newest frame whose timestamps have been read back.
+    std::vector<ScopeTiming> scopeTimings;
 };
 
 // Main Rendering Engine
@@ -126,14 +162,39 @@ public:
     void shutdown();
     bool is_initialized() const { return initialized_; }
     
+    // Headless rendering, without a window or surface: frames render into an
+    // offscreen RGBA8 target of the given size and present() only ends them.
+    // Engines given the same device are independent contexts sharing its
+    // queue, so one GPU can serve many concurrent render jobs.
+    bool initialize_headless(uint32_t width, uint32_t height, std::shared_ptr<RenderDevice> device = nullptr);
+    bool is_headless() const { return headless_; }
+    std::shared_ptr<RenderDevice> get_device() const { return renderDevice_; }
+    
+    // Where frames render from the next begin_frame(): a texture created with
+    // RenderAttachment usage, or 0 for the window or the offscreen target
+    void set_render_target(ResourceId texture) { renderTarget_ = texture; }
+    ResourceId get_frame_target() const { return renderTarget_ ? renderTarget_ : offscreenTarget_; }
+    
     // Frame management
     void begin_frame();
     void end_frame();
     void present();
     
-    // Command submission (thread-safe)
+    // Submits what has been recorded so far without ending the frame, e.g.
+    // before reading results back. Later submissions this frame draw over
+    // the frame's target instead of clearing it.
+    void flush();
+    
+    // Per-frame scratch memory; everything allocated from it is released at end_frame()
+    void set_memory_manager(Core::IMemoryManager* manager) { memoryManager_ = manager; }
+    Core::FrameArena& frame_arena();
+    
+    // Command submission (thread-safe). Every thread records into its own
+    // CommandList without locking; end_frame() merges and state-sorts them,
+    // so recording must be finished by then.
     void submit_draw_call(const DrawCall& call);
     void submit_compute(const ComputeDispatch& dispatch);
+    CommandList& thread_command_list();
     
     // Resource creation
     ResourceId create_buffer(size_t size, BufferUsage usage, const void* data = nullptr);
@@ -148,16 +209,45 @@ public:
     void* map_buffer(ResourceId id, size_t offset, size_t size);
     void unmap_buffer(ResourceId id);
     
-    // Render graph for optimization
+    // Whole-texture transfers of mip 0; bytesPerRow = 0 means tightly packed
+    // rows. read_texture() waits for the GPU to finish everything submitted
+    // before it, so flush() first to include this frame's work.
+    void write_texture(ResourceId id, const void* data, uint32_t bytesPerRow = 0);
+    bool read_texture(ResourceId id, void* data, uint32_t bytesPerRow = 0);
+    
+    // The same copy without waiting, into a pooled staging buffer. It is
+    // ready once the GPU has run everything submitted before it, which
+    // end_frame() and poll_readbacks() notice and wait_readback() blocks
+    // for. Invalid when the texture does not exist.
+    Readback read_texture_async(ResourceId id);
+    void poll_readbacks();
+    bool wait_readback(const Readback& readback);
+    
+    // Per-frame uploads (thread-safe). A sub-allocation of the upload ring;
+    // bind the returned buffer at its offset. The data is copied to the GPU
+    // at the next submit, so it must be written before end_frame(). Invalid
+    // when the ring is full this frame, in which case use update_buffer().
+    UploadAllocation allocate_upload(size_t size, size_t alignment = UploadRing::UNIFORM_ALIGNMENT);
+    UploadAllocation upload(const void* data, size_t size, size_t alignment = UploadRing::UNIFORM_ALIGNMENT);
+    
+    // Render graph for optimization. Graphs can also be executed directly
+    // with RenderGraph::execute(); both draw transients from the same pool.
     void set_render_graph(std::unique_ptr<RenderGraph> graph);
+    RenderGraph* get_render_graph() { return renderGraph_.get(); }
     void execute_render_graph();
     
+    // Shader compilation, permutations and the shader caches
+    ShaderCompiler* get_shader_compiler() { return shaderCompiler_.get(); }
+    
     // Advanced features
     void setup_ray_tracing(const RTConfig& config);
     void enable_variable_rate_shading(const VRSConfig& config);
     void enable_mesh_shaders(bool enable);
     
-    // Performance and debugging
+    // Performance and debugging. Modules time their work with
+    // ProfileScope(engine.profiler(), ...); see Profiler for the trace export.
+    Profiler& profiler() { return *profiler_; }
+    void enable_profiling(bool enable);
     RenderStats get_stats() const;
     void reset_stats();
     void capture_frame(const std::string& filename);
@@ -182,6 +272,14 @@ public:
         bool supportsMeshShaders;
         bool supportsVariableRateShading;
         bool supportsBindlessResources;
+        
+        // Adapter identity; a change invalidates on-disk pipeline caches
+        uint32_t vendorId = 0;
+        uint32_t deviceId = 0;
+        uint32_t backendType = 0;
+        std::string driverDescription;
+        
+        uint64_t fingerprint() const;
     };
     
     DeviceCapabilities get_device_capabilities() const;
@@ -197,10 +295,11 @@ private:
     // Current frame state
     WGPUTextureView* currentTextureView_ = nullptr;
     uint32_t currentFrameIndex_ = 0;
+    bool submittedThisFrame_ = false;  // flush() already cleared the target
     
     // Command buffers (double-buffered)
     struct CommandBuffer {
-        std::vector<RenderCommand> commands;
+        std::vector<RenderCommand*> commands;  // Owned by the frame arena
         std::vector<std::unique_ptr<IRenderResource>> transientResources;
         std::atomic<bool> isReady{false};
         std::mutex mutex;
@@ -208,6 +307,17 @@ private:
     std::array<CommandBuffer, 2> commandBuffers_;
     std::atomic<size_t> currentBuffer_{0};
     
+    // Per-thread recording, merged into the current CommandBuffer at end_frame
+    std::vector<std::unique_ptr<CommandList>> commandLists_;
+    std::unordered_map<std::thread::id, CommandList*> threadCommandLists_;
+    std::mutex commandListsMutex_;  // Taken on a thread's first submission only
+    std::unique_ptr<CommandListMerger> commandMerger_;
+    uint64_t serial_;               // Identifies this engine in per-thread caches
+    
+    // Frame memory - the memory manager's arena when one is set, otherwise our own
+    Core::IMemoryManager* memoryManager_ = nullptr;
+    std::unique_ptr<Core::FrameArena> localFrameArena_;
+    
     // Pipeline cache
     std::unordered_map<ShaderHash, std::unique_ptr<ComputedPipeline>> pipelineCache_;
     std::mutex pipelineCacheMutex_;
@@ -222,6 +332,25 @@ private:
     
     // Render graph
     std::unique_ptr<RenderGraph> renderGraph_;
+    std::unique_ptr<TransientResourcePool> transientPool_;
+    friend class RenderGraph;
+    
+    // Dynamic uniform/vertex uploads, staged here and written to the ring buffer
+    std::unique_ptr<UploadRing> uploadRing_;
+    std::vector<uint8_t> uploadStaging_;
+    
+    // GPU-to-CPU copies
+    std::shared_ptr<ReadbackPool> readbackPool_;
+    
+    // Shared with other engines on the same device; device_, queue_ and
+    // adapter_ are its handles
+    std::shared_ptr<RenderDevice> renderDevice_;
+    
+    // Offscreen rendering
+    bool headless_ = false;
+    ResourceId offscreenTarget_ = 0;  // Headless frame target
+    ResourceId renderTarget_ = 0;     // Set by set_render_target()
+    bool frameOnTexture_ = false;     // This frame renders to a texture, not the swap chain
     
     // Configuration
     RenderConfig config_;
@@ -230,16 +359,27 @@ private:
     // Statistics
     mutable std::mutex statsMutex_;
     RenderStats stats_;
+    std::unique_ptr<Profiler> profiler_;
     std::chrono::high_resolution_clock::time_point frameStartTime_;
     
     // Internal methods
     bool create_device();
     bool create_swap_chain(void* nativeWindow);
+    bool initialize_context();
     void destroy_device();
+    bool create_upload_ring(size_t frameCapacity);
+    void destroy_upload_ring();
+    void write_uploads();  // Before every submit
+    void submit_recorded_commands();
     void process_command_buffer();
     void optimize_draw_calls();
     void update_statistics();
     ShaderHash compute_shader_hash(const ShaderDescriptor& desc) const;
+    TransientResourcePool& transient_pool() { return *transientPool_; }
+    WGPUTextureView* create_texture_view(ResourceId texture);
+    void register_telemetry();
+    
+    Core::Telemetry::SourceRegistration telemetrySource_;
 };
 
 // Buffer usage flags
@@ -297,6 +437,16 @@ struct TextureDescriptor {
     uint32_t usage = static_cast<uint32_t>(Usage::TextureBinding);
 };
 
+inline uint32_t bytes_per_pixel(TextureDescriptor::Format format) {
+    switch (format) {
+        case TextureDescriptor::Format::RGBA16Float: return 8;
+        case TextureDescriptor::Format::RGBA32Float: return 16;
+        case TextureDescriptor::Format::R8Unorm: return 1;
+        case TextureDescriptor::Format::R16Float: return 2;
+        default: return 4;
+    }
+}
+
 // Sampler descriptor
 struct SamplerDescriptor {
     enum class FilterMode {
@@ -342,6 +492,7 @@ struct ComputeDispatch {
     uint32_t workgroupsY = 1;
     uint32_t workgroupsZ = 1;
     std::vector<ResourceId> buffers;
+    std::vector<uint32_t> bufferOffsets;  // Dynamic offsets, e.g. upload ring allocations
     std::vector<ResourceId> textures;
 };
 
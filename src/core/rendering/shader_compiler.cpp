@@ -11,6 +11,8 @@
 
 #include "shader_compiler.hpp"
 #include "wgpu_wrapper.hpp"
+#include "../kernel/task_scheduler.hpp"
+#include "../memory/memory_manager.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -18,6 +20,10 @@
 #include <regex>
 #include <chrono>
 #include <cassert>
+#include <cstring>
+#include <thread>
+#include <optional>
+#include <stdexcept>
 
 // Platform-specific includes for file watching
 #ifdef _WIN32
@@ -32,6 +38,175 @@
 
 namespace QuantumCanvas::Rendering {
 
+namespace {
+
+// Pre-warm list: magic, entry count, then per entry the descriptor fields
+// with strings stored as a u32 length followed by the bytes
+constexpr char PREWARM_MAGIC[8] = {'Q', 'C', 'S', 'P', 'W', 'L', '0', '1'};
+constexpr uint32_t PREWARM_MAX_STRING = 16 * 1024 * 1024;
+
+void write_u32(std::ostream& out, uint32_t value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void write_string(std::ostream& out, const std::string& value) {
+    write_u32(out, static_cast<uint32_t>(value.size()));
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+bool read_u32(std::istream& in, uint32_t& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+bool read_string(std::istream& in, std::string& value) {
+    uint32_t size = 0;
+    if (!read_u32(in, size) || size > PREWARM_MAX_STRING) {
+        return false;
+    }
+    value.resize(size);
+    return static_cast<bool>(in.read(value.data(), size));
+}
+
+// Disk cache: header, index of (hash, offset, size), then one blob per shader.
+// Bump SHADER_COMPILER_VERSION whenever compiled output would change.
+constexpr char CACHE_MAGIC[8] = {'Q', 'C', 'S', 'S', 'H', 'D', 'R', 'C'};
+constexpr uint32_t CACHE_FORMAT_VERSION = 1;
+constexpr char SHADER_COMPILER_VERSION[] = "qcs-shader-compiler-1";
+
+struct CacheFileHeader {
+    char magic[8];
+    uint32_t format_version;
+    uint32_t entry_count;
+    uint64_t device_fingerprint;
+    uint64_t compiler_version;
+};
+
+// Offsets are relative to the end of the index
+struct CacheIndexEntry {
+    uint64_t hash;
+    uint64_t offset;
+    uint64_t size;
+};
+
+uint64_t compiler_version_hash() {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const char* c = SHADER_COMPILER_VERSION; *c; ++c) {
+        hash = (hash ^ static_cast<uint8_t>(*c)) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+class ByteWriter {
+public:
+    explicit ByteWriter(std::vector<uint8_t>& out) : out_(out) {}
+    
+    template<typename T>
+    void write(const T& value) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out_.insert(out_.end(), bytes, bytes + sizeof(T));
+    }
+    
+    void write_bytes(const void* data, size_t size) {
+        write(static_cast<uint32_t>(size));
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        out_.insert(out_.end(), bytes, bytes + size);
+    }
+    
+    void write_string(const std::string& value) { write_bytes(value.data(), value.size()); }
+    
+private:
+    std::vector<uint8_t>& out_;
+};
+
+// Bounds-checked reads from the mapped file; any overrun poisons the reader
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : cursor_(data), end_(data + size) {}
+    
+    template<typename T>
+    bool read(T& value) {
+        if (!ok_ || static_cast<size_t>(end_ - cursor_) < sizeof(T)) {
+            return ok_ = false;
+        }
+        std::memcpy(&value, cursor_, sizeof(T));
+        cursor_ += sizeof(T);
+        return true;
+    }
+    
+    bool read_span(const uint8_t*& data, uint32_t& size) {
+        if (!read(size) || static_cast<size_t>(end_ - cursor_) < size) {
+            return ok_ = false;
+        }
+        data = cursor_;
+        cursor_ += size;
+        return true;
+    }
+    
+    bool read_string(std::string& value) {
+        const uint8_t* data = nullptr;
+        uint32_t size = 0;
+        if (!read_span(data, size)) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(data), size);
+        return true;
+    }
+    
+    bool ok() const { return ok_; }
+    
+private:
+    const uint8_t* cursor_;
+    const uint8_t* end_;
+    bool ok_ = true;
+};
+
+void encode_cache_entry(std::vector<uint8_t>& out, const ShaderDescriptor& desc,
+                        const ShaderCompilationResult& result) {
+    ByteWriter writer(out);
+    writer.write(static_cast<uint8_t>(desc.stage));
+    writer.write(static_cast<uint8_t>(desc.language));
+    writer.write_string(desc.entry_point);
+    writer.write_bytes(result.bytecode.data(), result.bytecode.size());
+    
+    // Reflected pipeline layout
+    writer.write(static_cast<uint32_t>(result.bindings.size()));
+    for (const auto& binding : result.bindings) {
+        writer.write(binding.binding);
+        writer.write(binding.group);
+        writer.write(static_cast<uint8_t>((binding.is_buffer ? 1 : 0) | (binding.is_texture ? 2 : 0) |
+                                          (binding.is_sampler ? 4 : 0)));
+        writer.write_string(binding.name);
+        writer.write_string(binding.type);
+    }
+    
+    writer.write(static_cast<uint32_t>(result.attributes.size()));
+    for (const auto& attribute : result.attributes) {
+        writer.write(attribute.location);
+        writer.write_string(attribute.name);
+        writer.write_string(attribute.type);
+        writer.write(static_cast<uint64_t>(attribute.offset));
+        writer.write(static_cast<uint64_t>(attribute.size));
+    }
+}
+
+PermutationKey constant_mask(uint32_t bits) {
+    return bits >= 64 ? ~PermutationKey{0} : (PermutationKey{1} << bits) - 1;
+}
+
+void write_telemetry(const ShaderCompiler::CompilerStats& stats, Core::MetricWriter& writer) {
+    writer.counter("compiled", stats.shaders_compiled);
+    writer.counter("cache_hits", stats.cache_hits);
+    writer.counter("cache_misses", stats.cache_misses);
+    writer.counter("disk_cache_hits", stats.disk_cache_hits);
+    writer.counter("compilation_errors", stats.compilation_errors);
+    writer.counter("prewarmed", stats.shaders_prewarmed);
+    writer.counter("compiler_invocations", stats.compiler_invocations);
+    writer.counter("permutation_variants", stats.permutation_variants);
+    writer.counter("compilation_ms", static_cast<uint64_t>(stats.total_compilation_time.count()));
+}
+
+} // namespace
+
 // Built-in shader sources
 namespace BuiltinShaders {
     const char* FULLSCREEN_VERTEX = R"(
@@ -222,6 +397,54 @@ uint64_t ShaderDescriptor::compute_hash() const {
     return hash;
 }
 
+// ShaderPermutationTemplate implementation
+uint32_t ShaderPermutationTemplate::key_bits() const {
+    uint32_t bits = static_cast<uint32_t>(features.size());
+    for (const auto& constant : constants) {
+        bits += constant.bits;
+    }
+    return bits;
+}
+
+PermutationKey ShaderPermutationTemplate::feature_bit(const std::string& feature) const {
+    for (size_t i = 0; i < features.size(); ++i) {
+        if (features[i] == feature) {
+            return PermutationKey{1} << i;
+        }
+    }
+    return 0;
+}
+
+PermutationKey ShaderPermutationTemplate::constant_value(const std::string& constant, uint32_t value) const {
+    uint32_t shift = static_cast<uint32_t>(features.size());
+    for (const auto& entry : constants) {
+        if (entry.name == constant) {
+            return (static_cast<PermutationKey>(value) & constant_mask(entry.bits)) << shift;
+        }
+        shift += entry.bits;
+    }
+    return 0;
+}
+
+std::string ShaderPermutationTemplate::variant_source(PermutationKey key) const {
+    std::ostringstream prelude;
+    prelude << "// " << name << " permutation 0x" << std::hex << key << std::dec << "\n";
+    
+    for (size_t i = 0; i < features.size(); ++i) {
+        bool enabled = (key >> i) & 1;
+        prelude << "const " << features[i] << ": bool = " << (enabled ? "true" : "false") << ";\n";
+    }
+    
+    uint32_t shift = static_cast<uint32_t>(features.size());
+    for (const auto& constant : constants) {
+        prelude << "const " << constant.name << ": u32 = " << ((key >> shift) & constant_mask(constant.bits))
+                << "u;\n";
+        shift += constant.bits;
+    }
+    
+    return prelude.str() + source;
+}
+
 // CompiledShader implementation
 CompiledShader::CompiledShader(WGPUShaderModule* module, const ShaderCompilationResult& result)
     : module_(module), result_(result) {
@@ -270,6 +493,8 @@ ShaderCompiler::ShaderCompiler()
     
     // Initialize statistics
     stats_ = CompilerStats{};
+    telemetry_source_ = Core::Telemetry::instance().add_stats_source(
+        "rendering.shaders", *this, &ShaderCompiler::get_stats, write_telemetry);
     
     std::cout << "[ShaderCompiler] Initialized" << std::endl;
 }
@@ -290,16 +515,19 @@ bool ShaderCompiler::initialize(WGPUDevice* device) {
         return false;
     }
     
-    // Create built-in shaders
-    create_builtin_shaders();
-    
-    // Set default cache directory
-    cache_directory_ = std::filesystem::current_path() / "shader_cache";
+    // Set default cache directory unless one was configured
+    if (cache_directory_.empty()) {
+        cache_directory_ = std::filesystem::current_path() / "shader_cache";
+    }
     std::filesystem::create_directories(cache_directory_);
     
     // Load cache from disk
     load_cache_from_disk();
     
+    // Create built-in shaders, then everything the last session used
+    create_builtin_shaders();
+    prewarm();
+    
     std::cout << "[ShaderCompiler] Initialized with device" << std::endl;
     return true;
 }
@@ -309,7 +537,16 @@ void ShaderCompiler::shutdown() {
         return;
     }
     
-    // Save cache to disk
+    // Batch tasks reference this compiler; help drain them before tearing down
+    auto scheduler = Core::KernelManager::instance().get_service<Core::TaskScheduler>();
+    while (batch_tasks_in_flight_.load(std::memory_order_acquire) > 0) {
+        if (!scheduler || !scheduler->try_run_pending_task()) {
+            std::this_thread::yield();
+        }
+    }
+    
+    // Save cache and pre-warm list to disk
+    save_prewarm_list();
     save_cache_to_disk();
     
     // Clear cache
@@ -318,6 +555,14 @@ void ShaderCompiler::shutdown() {
         shader_cache_.clear();
     }
     
+    // Variants hold modules too; templates stay registered for a re-initialize
+    {
+        std::lock_guard<std::mutex> lock(permutation_mutex_);
+        for (auto& set : permutation_sets_) {
+            set->variants.clear();
+        }
+    }
+    
     // Clear built-in shaders
     {
         std::lock_guard<std::mutex> lock(builtin_mutex_);
@@ -338,8 +583,47 @@ std::shared_ptr<CompiledShader> ShaderCompiler::compile_shader(const ShaderDescr
     
     auto start_time = std::chrono::high_resolution_clock::now();
     
-    // Check cache first
+    // Owns this thread's entry in pending_compiles_. However the compile
+    // ends, the entry is erased and its waiters released; if it throws they
+    // get an exception rather than a broken promise, and later callers
+    // start a fresh compile instead of waiting on a dead future.
+    struct PendingCompile {
+        ShaderCompiler& compiler;
+        uint64_t hash;
+        std::promise<std::shared_ptr<CompiledShader>> promise;
+        bool settled = false;
+        
+        void settle(const std::shared_ptr<CompiledShader>& shader) {
+            {
+                std::lock_guard<std::mutex> lock(compiler.cache_mutex_);
+                if (shader) {
+                    compiler.shader_cache_[hash] = shader;
+                }
+                compiler.pending_compiles_.erase(hash);
+            }
+            settled = true;
+            promise.set_value(shader);
+        }
+        
+        ~PendingCompile() {
+            if (settled) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(compiler.cache_mutex_);
+                compiler.pending_compiles_.erase(hash);
+            }
+            promise.set_exception(std::make_exception_ptr(
+                std::runtime_error("Shader compilation was abandoned by the compiling thread")));
+        }
+    };
+    
+    // Check cache first, then join a compile another thread already started
     uint64_t hash = desc.compute_hash();
+    std::optional<PendingCompile> owned;
+    std::shared_future<std::shared_ptr<CompiledShader>> pending;
+    DiskCacheEntry disk_entry;
+    bool on_disk = false;
     {
         std::lock_guard<std::mutex> lock(cache_mutex_);
         auto it = shader_cache_.find(hash);
@@ -350,6 +634,56 @@ std::shared_ptr<CompiledShader> ShaderCompiler::compile_shader(const ShaderDescr
             }
             return it->second;
         }
+        
+        auto pending_it = pending_compiles_.find(hash);
+        if (pending_it != pending_compiles_.end()) {
+            pending = pending_it->second;
+        } else {
+            owned.emplace(*this, hash);
+            pending_compiles_[hash] = owned->promise.get_future().share();
+            
+            auto disk_it = disk_index_.find(hash);
+            if (disk_it != disk_index_.end()) {
+                disk_entry = disk_it->second;
+                on_disk = true;
+            }
+        }
+    }
+    
+    if (pending.valid()) {
+        {
+            std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+            stats_.cache_hits++;
+        }
+        return pending.get();
+    }
+    
+    // A warm start decodes the module from the mapped cache without compiling
+    std::shared_ptr<CompiledShader> compiled_shader;
+    if (on_disk) {
+        compiled_shader = load_from_disk_cache(desc, disk_entry);
+    }
+    if (!compiled_shader) {
+        compiled_shader = compile_uncached(desc, start_time);
+    }
+    
+    // Add to cache and release any threads waiting on this compile
+    owned->settle(compiled_shader);
+    
+    if (compiled_shader) {
+        std::lock_guard<std::mutex> lock(usage_mutex_);
+        used_shaders_.emplace(hash, desc);
+    }
+    
+    return compiled_shader;
+}
+
+std::shared_ptr<CompiledShader> ShaderCompiler::compile_uncached(
+    const ShaderDescriptor& desc, std::chrono::high_resolution_clock::time_point start_time) {
+    
+    {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        stats_.compiler_invocations++;
     }
     
     // Compile shader
@@ -396,12 +730,6 @@ std::shared_ptr<CompiledShader> ShaderCompiler::compile_shader(const ShaderDescr
     // Create compiled shader
     auto compiled_shader = std::make_shared<CompiledShader>(module, result);
     
-    // Add to cache
-    {
-        std::lock_guard<std::mutex> lock(cache_mutex_);
-        shader_cache_[hash] = compiled_shader;
-    }
-    
     // Update statistics
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
@@ -467,15 +795,286 @@ std::shared_ptr<CompiledShader> ShaderCompiler::compile_shader_from_file(
 std::vector<std::shared_ptr<CompiledShader>> ShaderCompiler::compile_shaders(
     const std::vector<ShaderDescriptor>& descriptors) {
     
-    std::vector<std::shared_ptr<CompiledShader>> results;
-    results.reserve(descriptors.size());
+    std::vector<std::shared_ptr<CompiledShader>> results(descriptors.size());
+    
+    Core::parallel_for(0, descriptors.size(), 1, [&](size_t i) {
+        results[i] = compile_shader(descriptors[i]);
+    });
+    
+    return results;
+}
+
+std::vector<std::future<std::shared_ptr<CompiledShader>>> ShaderCompiler::compile_shaders_batch(
+    const std::vector<ShaderDescriptor>& descriptors) {
+    
+    std::vector<std::future<std::shared_ptr<CompiledShader>>> futures;
+    futures.reserve(descriptors.size());
+    
+    auto scheduler = Core::KernelManager::instance().get_service<Core::TaskScheduler>();
     
     for (const auto& desc : descriptors) {
-        auto compiled = compile_shader(desc);
-        results.push_back(compiled);
+        if (!scheduler) {
+            std::promise<std::shared_ptr<CompiledShader>> promise;
+            promise.set_value(compile_shader(desc));
+            futures.push_back(promise.get_future());
+            continue;
+        }
+        
+        // The descriptor is copied; the caller's vector may be gone by the time this runs
+        batch_tasks_in_flight_.fetch_add(1, std::memory_order_relaxed);
+        futures.push_back(scheduler->async([this, desc]() {
+            struct InFlightGuard {
+                std::atomic<size_t>& count;
+                ~InFlightGuard() { count.fetch_sub(1, std::memory_order_release); }
+            } guard{batch_tasks_in_flight_};
+            
+            return compile_shader(desc);
+        }, Core::TaskPriority::Background));
     }
     
-    return results;
+    return futures;
+}
+
+PermutationSetId ShaderCompiler::register_permutations(ShaderPermutationTemplate tmpl) {
+    // Every constant needs at least one bit and the whole layout must fit the key
+    bool valid_constants = std::all_of(tmpl.constants.begin(), tmpl.constants.end(),
+                                       [](const auto& constant) { return constant.bits > 0; });
+    if (!valid_constants || tmpl.key_bits() > 64) {
+        std::cerr << "[ShaderCompiler] Permutation template '" << tmpl.name
+                  << "' does not fit a 64-bit key" << std::endl;
+        return 0;
+    }
+    
+    auto set = std::make_unique<PermutationSet>();
+    set->tmpl = std::move(tmpl);
+    
+    std::lock_guard<std::mutex> lock(permutation_mutex_);
+    permutation_sets_.push_back(std::move(set));
+    return static_cast<PermutationSetId>(permutation_sets_.size());
+}
+
+ShaderCompiler::PermutationSet* ShaderCompiler::find_permutation_set(PermutationSetId set) const {
+    if (set == 0 || set > permutation_sets_.size()) {
+        return nullptr;
+    }
+    return permutation_sets_[set - 1].get();
+}
+
+const ShaderPermutationTemplate* ShaderCompiler::get_permutation_template(PermutationSetId set) const {
+    std::lock_guard<std::mutex> lock(permutation_mutex_);
+    PermutationSet* entry = find_permutation_set(set);
+    return entry ? &entry->tmpl : nullptr;
+}
+
+ShaderDescriptor ShaderCompiler::make_permutation_descriptor(PermutationSetId set, PermutationKey key) const {
+    // Templates are immutable once registered, so only the lookup needs the lock
+    const ShaderPermutationTemplate* tmpl = get_permutation_template(set);
+    
+    ShaderDescriptor desc;
+    if (!tmpl) {
+        return desc;
+    }
+    desc.stage = tmpl->stage;
+    desc.language = ShaderLanguage::WGSL;
+    desc.source = tmpl->variant_source(key);
+    desc.entry_point = tmpl->entry_point;
+    return desc;
+}
+
+std::shared_ptr<CompiledShader> ShaderCompiler::get_permutation(PermutationSetId set, PermutationKey key) {
+    {
+        std::lock_guard<std::mutex> lock(permutation_mutex_);
+        PermutationSet* entry = find_permutation_set(set);
+        if (!entry) {
+            return nullptr;
+        }
+        
+        auto it = entry->variants.find(key);
+        if (it != entry->variants.end()) {
+            return it->second;
+        }
+    }
+    
+    // compile_shader() joins a concurrent compile of the same variant
+    auto shader = compile_shader(make_permutation_descriptor(set, key));
+    if (!shader) {
+        return nullptr;
+    }
+    
+    std::lock_guard<std::mutex> lock(permutation_mutex_);
+    auto [it, inserted] = find_permutation_set(set)->variants.emplace(key, shader);
+    if (inserted) {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        stats_.permutation_variants++;
+    }
+    return it->second;
+}
+
+size_t ShaderCompiler::precompile_permutations(PermutationSetId set, const std::vector<PermutationKey>& keys) {
+    std::vector<PermutationKey> missing;
+    {
+        std::lock_guard<std::mutex> lock(permutation_mutex_);
+        PermutationSet* entry = find_permutation_set(set);
+        if (!entry) {
+            return 0;
+        }
+        
+        for (PermutationKey key : keys) {
+            if (!entry->variants.count(key) &&
+                std::find(missing.begin(), missing.end(), key) == missing.end()) {
+                missing.push_back(key);
+            }
+        }
+    }
+    
+    std::vector<ShaderDescriptor> descriptors;
+    descriptors.reserve(missing.size());
+    for (PermutationKey key : missing) {
+        descriptors.push_back(make_permutation_descriptor(set, key));
+    }
+    auto compiled = compile_shaders(descriptors);
+    
+    size_t count = keys.size() - missing.size();
+    std::lock_guard<std::mutex> lock(permutation_mutex_);
+    PermutationSet* entry = find_permutation_set(set);
+    for (size_t i = 0; i < missing.size(); ++i) {
+        if (!compiled[i]) {
+            continue;
+        }
+        if (entry->variants.emplace(missing[i], compiled[i]).second) {
+            std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+            stats_.permutation_variants++;
+        }
+        count++;
+    }
+    return count;
+}
+
+size_t ShaderCompiler::prewarm() {
+    auto descriptors = load_prewarm_list();
+    if (descriptors.empty()) {
+        return 0;
+    }
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    auto compiled = compile_shaders(descriptors);
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start_time);
+    
+    size_t count = std::count_if(compiled.begin(), compiled.end(),
+                                 [](const auto& shader) { return shader != nullptr; });
+    {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        stats_.shaders_prewarmed += count;
+    }
+    
+    std::cout << "[ShaderCompiler] Pre-warmed " << count << " of " << descriptors.size()
+              << " shaders in " << duration.count() << "ms" << std::endl;
+    return count;
+}
+
+bool ShaderCompiler::save_prewarm_list() const {
+    if (cache_directory_.empty()) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(usage_mutex_);
+    if (used_shaders_.empty()) {
+        return false;
+    }
+    
+    // Write to a temporary file first so a crash never leaves a torn list
+    auto path = prewarm_list_path();
+    auto temp_path = path;
+    temp_path += ".tmp";
+    
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        
+        out.write(PREWARM_MAGIC, sizeof(PREWARM_MAGIC));
+        write_u32(out, static_cast<uint32_t>(used_shaders_.size()));
+        
+        for (const auto& [hash, desc] : used_shaders_) {
+            uint8_t header[3] = {
+                static_cast<uint8_t>(desc.stage),
+                static_cast<uint8_t>(desc.language),
+                static_cast<uint8_t>((desc.optimize ? 1 : 0) | (desc.debug_info ? 2 : 0) |
+                                     (desc.warnings_as_errors ? 4 : 0))
+            };
+            out.write(reinterpret_cast<const char*>(header), sizeof(header));
+            write_string(out, desc.entry_point);
+            write_string(out, desc.source);
+            write_u32(out, static_cast<uint32_t>(desc.defines.size()));
+            for (const auto& define : desc.defines) {
+                write_string(out, define);
+            }
+        }
+        
+        if (!out) {
+            return false;
+        }
+    }
+    
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    return !error;
+}
+
+std::vector<ShaderDescriptor> ShaderCompiler::load_prewarm_list() const {
+    std::vector<ShaderDescriptor> descriptors;
+    
+    std::ifstream in(prewarm_list_path(), std::ios::binary);
+    if (!in.is_open()) {
+        return descriptors;
+    }
+    
+    char magic[sizeof(PREWARM_MAGIC)];
+    uint32_t count = 0;
+    if (!in.read(magic, sizeof(magic)) ||
+        !std::equal(magic, magic + sizeof(magic), PREWARM_MAGIC) ||
+        !read_u32(in, count)) {
+        std::cerr << "[ShaderCompiler] Ignoring unreadable pre-warm list" << std::endl;
+        return descriptors;
+    }
+    
+    // A truncated file still yields the entries before the damage
+    for (uint32_t i = 0; i < count; ++i) {
+        uint8_t header[3];
+        ShaderDescriptor desc;
+        uint32_t define_count = 0;
+        
+        if (!in.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+            header[0] > static_cast<uint8_t>(ShaderStage::Compute) ||
+            header[1] > static_cast<uint8_t>(ShaderLanguage::SPIRV) ||
+            !read_string(in, desc.entry_point) ||
+            !read_string(in, desc.source) ||
+            !read_u32(in, define_count)) {
+            break;
+        }
+        
+        desc.stage = static_cast<ShaderStage>(header[0]);
+        desc.language = static_cast<ShaderLanguage>(header[1]);
+        desc.optimize = (header[2] & 1) != 0;
+        desc.debug_info = (header[2] & 2) != 0;
+        desc.warnings_as_errors = (header[2] & 4) != 0;
+        
+        bool complete = true;
+        for (uint32_t d = 0; d < define_count && complete; ++d) {
+            std::string define;
+            complete = read_string(in, define);
+            desc.defines.push_back(std::move(define));
+        }
+        if (!complete) {
+            break;
+        }
+        
+        descriptors.push_back(std::move(desc));
+    }
+    
+    return descriptors;
 }
 
 void ShaderCompiler::watch_shader_files(bool enable) {
@@ -547,13 +1146,215 @@ size_t ShaderCompiler::get_cache_size() const {
 }
 
 void ShaderCompiler::save_cache_to_disk() {
-    // Cache persistence would be implemented here
-    std::cout << "[ShaderCompiler] Saving cache to disk (not yet implemented)" << std::endl;
+    if (cache_directory_.empty()) {
+        return;
+    }
+    
+    std::vector<uint8_t> blobs;
+    std::vector<CacheIndexEntry> index;
+    
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        
+        for (const auto& [hash, shader] : shader_cache_) {
+            if (!shader) {
+                continue;
+            }
+            
+            std::lock_guard<std::mutex> usage_lock(usage_mutex_);
+            auto used = used_shaders_.find(hash);
+            if (used == used_shaders_.end()) {
+                continue;
+            }
+            
+            size_t offset = blobs.size();
+            encode_cache_entry(blobs, used->second, shader->compilation_result());
+            index.push_back({hash, offset, blobs.size() - offset});
+        }
+        
+        // Keep entries from the previous file that this session never touched
+        if (cache_file_ && cache_file_->is_open()) {
+            for (const auto& [hash, entry] : disk_index_) {
+                if (shader_cache_.count(hash)) {
+                    continue;
+                }
+                size_t offset = blobs.size();
+                blobs.insert(blobs.end(), cache_file_->data() + entry.offset,
+                             cache_file_->data() + entry.offset + entry.size);
+                index.push_back({hash, offset, entry.size});
+            }
+        }
+        
+        // Rename cannot replace a file that is still mapped on every platform
+        if (cache_file_) {
+            cache_file_->close();
+        }
+        disk_index_.clear();
+    }
+    
+    if (index.empty()) {
+        return;
+    }
+    
+    CacheFileHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.format_version = CACHE_FORMAT_VERSION;
+    header.entry_count = static_cast<uint32_t>(index.size());
+    header.device_fingerprint = device_fingerprint_;
+    header.compiler_version = compiler_version_hash();
+    
+    auto path = cache_file_path();
+    auto temp_path = path;
+    temp_path += ".tmp";
+    
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "[ShaderCompiler] Cannot write shader cache: " << temp_path << std::endl;
+            return;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(index.data()),
+                  static_cast<std::streamsize>(index.size() * sizeof(CacheIndexEntry)));
+        out.write(reinterpret_cast<const char*>(blobs.data()), static_cast<std::streamsize>(blobs.size()));
+        if (!out) {
+            std::cerr << "[ShaderCompiler] Failed writing shader cache" << std::endl;
+            return;
+        }
+    }
+    
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    if (error) {
+        std::cerr << "[ShaderCompiler] Failed to replace shader cache: " << error.message() << std::endl;
+        return;
+    }
+    
+    std::cout << "[ShaderCompiler] Saved " << index.size() << " shaders to disk cache" << std::endl;
 }
 
 void ShaderCompiler::load_cache_from_disk() {
-    // Cache loading would be implemented here
-    std::cout << "[ShaderCompiler] Loading cache from disk (not yet implemented)" << std::endl;
+    auto file = std::make_unique<Core::MappedFile>();
+    if (!file->open(cache_file_path())) {
+        return;
+    }
+    
+    CacheFileHeader header{};
+    if (file->size() < sizeof(header)) {
+        return;
+    }
+    std::memcpy(&header, file->data(), sizeof(header));
+    
+    if (!std::equal(header.magic, header.magic + sizeof(header.magic), CACHE_MAGIC) ||
+        header.format_version != CACHE_FORMAT_VERSION) {
+        std::cerr << "[ShaderCompiler] Ignoring shader cache with unknown format" << std::endl;
+        return;
+    }
+    if (header.device_fingerprint != device_fingerprint_ ||
+        header.compiler_version != compiler_version_hash()) {
+        std::cout << "[ShaderCompiler] Shader cache was built for another device, driver or "
+                  << "compiler; rebuilding" << std::endl;
+        return;
+    }
+    
+    const size_t index_size = static_cast<size_t>(header.entry_count) * sizeof(CacheIndexEntry);
+    if (file->size() - sizeof(header) < index_size) {
+        std::cerr << "[ShaderCompiler] Shader cache index is truncated" << std::endl;
+        return;
+    }
+    
+    const size_t blobs_start = sizeof(header) + index_size;
+    const size_t blobs_size = file->size() - blobs_start;
+    
+    std::unordered_map<uint64_t, DiskCacheEntry> index;
+    index.reserve(header.entry_count);
+    for (uint32_t i = 0; i < header.entry_count; ++i) {
+        CacheIndexEntry entry;
+        std::memcpy(&entry, file->data() + sizeof(header) + i * sizeof(CacheIndexEntry), sizeof(entry));
+        if (entry.offset > blobs_size || entry.size > blobs_size - entry.offset) {
+            continue;
+        }
+        index[entry.hash] = {blobs_start + entry.offset, entry.size};
+    }
+    
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    disk_index_ = std::move(index);
+    cache_file_ = std::move(file);
+    
+    std::cout << "[ShaderCompiler] Mapped disk cache with " << disk_index_.size() << " shaders" << std::endl;
+}
+
+std::shared_ptr<CompiledShader> ShaderCompiler::load_from_disk_cache(const ShaderDescriptor& desc,
+                                                                     const DiskCacheEntry& entry) {
+    // The mapping stays open until save_cache_to_disk(), which runs after all compiles
+    ByteReader reader(cache_file_->data() + entry.offset, static_cast<size_t>(entry.size));
+    
+    uint8_t stage = 0;
+    uint8_t language = 0;
+    std::string entry_point;
+    const uint8_t* bytecode = nullptr;
+    uint32_t bytecode_size = 0;
+    reader.read(stage);
+    reader.read(language);
+    reader.read_string(entry_point);
+    reader.read_span(bytecode, bytecode_size);
+    
+    // Guards against hash collisions as much as against corruption
+    if (!reader.ok() || stage != static_cast<uint8_t>(desc.stage) ||
+        language != static_cast<uint8_t>(desc.language) || entry_point != desc.entry_point) {
+        return nullptr;
+    }
+    
+    ShaderCompilationResult result;
+    result.success = true;
+    result.bytecode.assign(bytecode, bytecode + bytecode_size);
+    
+    uint32_t binding_count = 0;
+    reader.read(binding_count);
+    for (uint32_t i = 0; i < binding_count && reader.ok(); ++i) {
+        ShaderCompilationResult::BindingInfo binding;
+        uint8_t flags = 0;
+        reader.read(binding.binding);
+        reader.read(binding.group);
+        reader.read(flags);
+        reader.read_string(binding.name);
+        reader.read_string(binding.type);
+        binding.is_buffer = (flags & 1) != 0;
+        binding.is_texture = (flags & 2) != 0;
+        binding.is_sampler = (flags & 4) != 0;
+        result.bindings.push_back(std::move(binding));
+    }
+    
+    uint32_t attribute_count = 0;
+    reader.read(attribute_count);
+    for (uint32_t i = 0; i < attribute_count && reader.ok(); ++i) {
+        ShaderCompilationResult::AttributeInfo attribute;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        reader.read(attribute.location);
+        reader.read_string(attribute.name);
+        reader.read_string(attribute.type);
+        reader.read(offset);
+        reader.read(size);
+        attribute.offset = static_cast<size_t>(offset);
+        attribute.size = static_cast<size_t>(size);
+        result.attributes.push_back(std::move(attribute));
+    }
+    
+    if (!reader.ok()) {
+        return nullptr;
+    }
+    
+    WGPUShaderModule* module = create_shader_module(result.bytecode);
+    if (!module) {
+        return nullptr;
+    }
+    
+    {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        stats_.disk_cache_hits++;
+    }
+    return std::make_shared<CompiledShader>(module, result);
 }
 
 std::string ShaderCompiler::preprocess_shader(
@@ -676,23 +1477,27 @@ ShaderCompilationResult ShaderCompiler::reflect_shader(const std::vector<uint8_t
 void ShaderCompiler::create_builtin_shaders() {
     std::lock_guard<std::mutex> lock(builtin_mutex_);
     
-    load_builtin_shader(BuiltinShaders::FULLSCREEN_VERTEX, ShaderStage::Vertex, fullscreen_vertex_shader_);
-    load_builtin_shader(BuiltinShaders::BLIT_FRAGMENT, ShaderStage::Fragment, blit_fragment_shader_);
-    load_builtin_shader(BuiltinShaders::CLEAR_COMPUTE, ShaderStage::Compute, clear_compute_shader_);
+    auto compiled = compile_shaders({
+        make_builtin_descriptor(BuiltinShaders::FULLSCREEN_VERTEX, ShaderStage::Vertex),
+        make_builtin_descriptor(BuiltinShaders::BLIT_FRAGMENT, ShaderStage::Fragment),
+        make_builtin_descriptor(BuiltinShaders::CLEAR_COMPUTE, ShaderStage::Compute)
+    });
+    
+    fullscreen_vertex_shader_ = compiled[0];
+    blit_fragment_shader_ = compiled[1];
+    clear_compute_shader_ = compiled[2];
     
     std::cout << "[ShaderCompiler] Built-in shaders created" << std::endl;
 }
 
-void ShaderCompiler::load_builtin_shader(const std::string& source, ShaderStage stage,
-                                        std::shared_ptr<CompiledShader>& target) {
+ShaderDescriptor ShaderCompiler::make_builtin_descriptor(const std::string& source, ShaderStage stage) const {
     ShaderDescriptor desc;
     desc.stage = stage;
     desc.language = ShaderLanguage::WGSL;
     desc.source = source;
     desc.entry_point = stage == ShaderStage::Compute ? "cs_main" : 
                       (stage == ShaderStage::Vertex ? "vs_main" : "fs_main");
-    
-    target = compile_shader(desc);
+    return desc;
 }
 
 void ShaderCompiler::handle_compilation_error(const std::string& error, const ShaderDescriptor& desc) {
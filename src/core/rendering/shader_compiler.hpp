@@ -7,11 +7,20 @@
 #include <mutex>
 #include <filesystem>
 #include <functional>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "../kernel/telemetry.hpp"
 
 // Forward declare WGPU types
 struct WGPUDevice;
 struct WGPUShaderModule;
 
+namespace QuantumCanvas::Core {
+class MappedFile;
+}
+
 namespace QuantumCanvas::Rendering {
 
 // Shader types
@@ -78,6 +87,38 @@ struct ShaderDescriptor {
     uint64_t compute_hash() const;
 };
 
+// Shader permutations. A template declares its feature bits and integer
+// specialization constants once. Each variant is the template source behind
+// a prelude of WGSL `const` declarations, so branches on them fold away at
+// compile time instead of testing a mode uniform per pixel.
+using PermutationKey = uint64_t;
+using PermutationSetId = uint32_t;
+
+struct ShaderPermutationTemplate {
+    std::string name;
+    ShaderStage stage = ShaderStage::Fragment;
+    std::string source;                  // Refers to features and constants by name
+    std::string entry_point = "main";
+    
+    // features[i] is key bit i, emitted as `const NAME: bool`
+    std::vector<std::string> features;
+    
+    // Packed into the key after the features, emitted as `const NAME: u32`
+    struct Constant {
+        std::string name;
+        uint32_t bits = 0;
+    };
+    std::vector<Constant> constants;
+    
+    // Resolve names once at setup; at draw time keys are combined with '|'
+    PermutationKey feature_bit(const std::string& feature) const;           // 0 if unknown
+    PermutationKey constant_value(const std::string& constant, uint32_t value) const;
+    uint32_t key_bits() const;
+    
+    // The WGSL source of one variant
+    std::string variant_source(PermutationKey key) const;
+};
+
 // Compiled shader resource
 class CompiledShader {
 public:
@@ -126,15 +167,37 @@ public:
     void shutdown();
     bool is_initialized() const { return device_ != nullptr; }
     
-    // Compilation
+    // Compilation (thread-safe; concurrent requests for one shader compile it once)
     std::shared_ptr<CompiledShader> compile_shader(const ShaderDescriptor& desc);
     std::shared_ptr<CompiledShader> compile_shader_from_file(const std::filesystem::path& path,
                                                            ShaderStage stage,
                                                            const std::string& entry_point = "main");
     
-    // Batch compilation
+    // Batch compilation on the kernel's TaskScheduler. compile_shaders blocks
+    // (helping run the work) until all are done; compile_shaders_batch returns
+    // at once with one future per descriptor, null on failure.
     std::vector<std::shared_ptr<CompiledShader>> compile_shaders(
         const std::vector<ShaderDescriptor>& descriptors);
+    std::vector<std::future<std::shared_ptr<CompiledShader>>> compile_shaders_batch(
+        const std::vector<ShaderDescriptor>& descriptors);
+    
+    // Pre-warming. Every shader compiled in a session is written to the cache
+    // directory at shutdown; initialize() compiles that list in parallel so the
+    // pipelines the last session used hit the cache on the first frame.
+    size_t prewarm();
+    bool save_prewarm_list() const;
+    std::vector<ShaderDescriptor> load_prewarm_list() const;
+    std::filesystem::path prewarm_list_path() const { return cache_directory_ / "prewarm.bin"; }
+    
+    // Permutations (thread-safe). Variants compile lazily on first
+    // get_permutation() or ahead of time with precompile_permutations(); both
+    // go through compile_shader(), so variants share the memory, disk and
+    // pre-warm caches. A cached variant is found by its key alone.
+    PermutationSetId register_permutations(ShaderPermutationTemplate tmpl);    // 0 on failure
+    const ShaderPermutationTemplate* get_permutation_template(PermutationSetId set) const;
+    std::shared_ptr<CompiledShader> get_permutation(PermutationSetId set, PermutationKey key);
+    size_t precompile_permutations(PermutationSetId set, const std::vector<PermutationKey>& keys);
+    ShaderDescriptor make_permutation_descriptor(PermutationSetId set, PermutationKey key) const;
     
     // Hot reload support
     void watch_shader_files(bool enable);
@@ -152,7 +215,11 @@ public:
                                          ShaderLanguage to,
                                          ShaderStage stage);
     
-    // Cache management
+    // Cache management. The disk cache holds compiled modules with their
+    // reflected layout; it is discarded when the device fingerprint or the
+    // compiler version differs, so set the fingerprint before initialize().
+    void set_device_fingerprint(uint64_t fingerprint) { device_fingerprint_ = fingerprint; }
+    std::filesystem::path cache_file_path() const { return cache_directory_ / "shader_cache.bin"; }
     void clear_cache();
     void set_cache_directory(const std::filesystem::path& path);
     size_t get_cache_size() const;
@@ -179,6 +246,10 @@ public:
         size_t cache_hits = 0;
         size_t cache_misses = 0;
         size_t compilation_errors = 0;
+        size_t shaders_prewarmed = 0;
+        size_t disk_cache_hits = 0;        // Loaded from the disk cache without compiling
+        size_t compiler_invocations = 0;
+        size_t permutation_variants = 0;   // Variants compiled across all templates
         std::chrono::milliseconds total_compilation_time{0};
         std::chrono::milliseconds average_compilation_time{0};
     };
@@ -192,8 +263,35 @@ private:
     // Shader cache
     mutable std::mutex cache_mutex_;
     std::unordered_map<uint64_t, std::shared_ptr<CompiledShader>> shader_cache_;
+    std::unordered_map<uint64_t, std::shared_future<std::shared_ptr<CompiledShader>>> pending_compiles_;
     std::filesystem::path cache_directory_;
     
+    // Disk cache, mapped on load; entries are decoded on first use
+    struct DiskCacheEntry {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+    };
+    std::unique_ptr<Core::MappedFile> cache_file_;
+    std::unordered_map<uint64_t, DiskCacheEntry> disk_index_;  // Guarded by cache_mutex_
+    uint64_t device_fingerprint_ = 0;
+    
+    // Shaders compiled this session, saved as the next session's pre-warm list
+    mutable std::mutex usage_mutex_;
+    std::unordered_map<uint64_t, ShaderDescriptor> used_shaders_;
+    
+    // Permutation templates; ids are index + 1 and sets are never removed
+    struct PermutationSet {
+        ShaderPermutationTemplate tmpl;
+        std::unordered_map<PermutationKey, std::shared_ptr<CompiledShader>> variants;
+    };
+    mutable std::mutex permutation_mutex_;
+    std::vector<std::unique_ptr<PermutationSet>> permutation_sets_;
+    
+    PermutationSet* find_permutation_set(PermutationSetId set) const;  // Caller holds permutation_mutex_
+    
+    // compile_shaders_batch tasks not yet finished; shutdown() waits for them
+    std::atomic<size_t> batch_tasks_in_flight_{0};
+    
     // Built-in shaders
     mutable std::mutex builtin_mutex_;
     std::shared_ptr<CompiledShader> fullscreen_vertex_shader_;
@@ -213,6 +311,10 @@ private:
     CompilerStats stats_;
     
     // Internal methods
+    std::shared_ptr<CompiledShader> load_from_disk_cache(const ShaderDescriptor& desc,
+                                                         const DiskCacheEntry& entry);
+    std::shared_ptr<CompiledShader> compile_uncached(const ShaderDescriptor& desc,
+                                                     std::chrono::high_resolution_clock::time_point start_time);
     ShaderCompilationResult compile_wgsl(const ShaderDescriptor& desc);
     ShaderCompilationResult compile_hlsl(const ShaderDescriptor& desc);
     ShaderCompilationResult compile_glsl(const ShaderDescriptor& desc);
@@ -222,9 +324,7 @@ private:
     ShaderCompilationResult reflect_shader(const std::vector<uint8_t>& spirv);
     
     void create_builtin_shaders();
-    void load_builtin_shader(const std::string& source, 
-                           ShaderStage stage,
-                           std::shared_ptr<CompiledShader>& target);
+    ShaderDescriptor make_builtin_descriptor(const std::string& source, ShaderStage stage) const;
     
     void handle_compilation_error(const std::string& error, const ShaderDescriptor& desc);
     uint64_t hash_descriptor(const ShaderDescriptor& desc) const;
@@ -233,6 +333,8 @@ private:
     std::unique_ptr<class SPIRVCross> spirv_cross_;
     std::unique_ptr<class DXCCompiler> dxc_compiler_;
     std::unique_ptr<class GLSLangValidator> glslang_;
+    
+    Core::Telemetry::SourceRegistration telemetry_source_;
 };
 
 // Utility functions
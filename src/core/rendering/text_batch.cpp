@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2024 Francisco Molina (QuantumCanvas Studio)
+ * Licensed under Dual License Agreement - See LICENSE file for details
+ *
+ * ATTRIBUTION REQUIRED: This software must include attribution to Francisco Molina
+ * COMMERCIAL USE: Requires separate license and royalties - contact pako.molina@gmail.com
+ *
+ * Project: https://github.com/Yatrogenesis/QuantumCanvas-Studio
+ * Author: Francisco Molina <pako.molina@gmail.com>
+ */
+
+#include "text_batch.hpp"
+#include "rendering_engine.hpp"
+#include <algorithm>
+
+namespace QuantumCanvas::Rendering {
+
+TextBatch::TextBatch(std::shared_ptr<GlyphAtlas> atlas)
+    : atlas_(atlas ? std::move(atlas) : GlyphAtlas::shared()) {
+}
+
+TextBatch::~TextBatch() {
+    if (engine_ && instanceBufferId_ != 0) {
+        engine_->destroy_resource(instanceBufferId_);
+    }
+}
+
+void TextBatch::set_atlas(std::shared_ptr<GlyphAtlas> atlas) {
+    clear();
+    atlas_ = atlas ? std::move(atlas) : GlyphAtlas::shared();
+}
+
+float TextBatch::add_text(FontId font, std::string_view utf8, const std::array<float, 3>& origin,
+                          const std::array<float, 3>& advance, const std::array<float, 3>& up,
+                          const std::array<float, 4>& color) {
+    placed_.clear();
+    const float width = atlas_->layout(font, utf8, placed_);
+
+    auto at = [&](float x, float y) {
+        return std::array<float, 4>{origin[0] + advance[0] * x + up[0] * y,
+                                    origin[1] + advance[1] * x + up[1] * y,
+                                    origin[2] + advance[2] * x + up[2] * y, 0.0f};
+    };
+    for (const auto& placed : placed_) {
+        const auto& glyph = placed.glyph;
+        if (glyph.empty) {
+            continue;
+        }
+        if (glyph.page >= pages_.size()) {
+            pages_.resize(glyph.page + 1);
+        }
+        PageQuads& page = pages_[glyph.page];
+        if (page.generation != glyph.generation) {
+            // The page was recycled since its earlier quads were placed
+            count_ -= page.quads.size();
+            page.quads.clear();
+            page.generation = glyph.generation;
+        }
+
+        const float w = glyph.plane[2] - glyph.plane[0];
+        const float h = glyph.plane[3] - glyph.plane[1];
+        GlyphInstance quad;
+        quad.origin = at(placed.x + glyph.plane[0], glyph.plane[1]);
+        quad.xAxis = {advance[0] * w, advance[1] * w, advance[2] * w, 0.0f};
+        quad.yAxis = {up[0] * h, up[1] * h, up[2] * h, 0.0f};
+        quad.uv = glyph.uv;
+        quad.color = color;
+        page.quads.push_back(quad);
+        count_++;
+    }
+    return width;
+}
+
+void TextBatch::clear() {
+    for (auto& page : pages_) {
+        page.quads.clear();
+    }
+    count_ = 0;
+}
+
+void TextBatch::gather(std::vector<GlyphInstance>& instances,
+                       std::vector<std::pair<uint32_t, uint32_t>>& pages) const {
+    instances.clear();
+    pages.clear();
+    for (uint32_t i = 0; i < pages_.size(); ++i) {
+        const PageQuads& page = pages_[i];
+        if (page.quads.empty() || atlas_->page_generation(i) != page.generation) {
+            continue;
+        }
+        instances.insert(instances.end(), page.quads.begin(), page.quads.end());
+        pages.emplace_back(i, static_cast<uint32_t>(page.quads.size()));
+    }
+}
+
+uint32_t TextBatch::render(RenderingEngine& engine, ResourceId view_projection) {
+    if (count_ == 0) {
+        return 0;
+    }
+    if (engine_ && engine_ != &engine && instanceBufferId_ != 0) {
+        engine_->destroy_resource(instanceBufferId_);
+        instanceBufferId_ = 0;
+        instanceCapacity_ = 0;
+        pipelineId_ = 0;
+        samplerId_ = 0;
+    }
+    engine_ = &engine;
+    if (pipelineId_ == 0 && !create_pipeline(engine)) {
+        clear();
+        return 0;
+    }
+
+    atlas_->upload(engine);
+    gather(staging_, runs_);
+    const size_t bytes = staging_.size() * sizeof(GlyphInstance);
+    if (instanceBufferId_ == 0 || instanceCapacity_ < bytes) {
+        if (instanceBufferId_ != 0) {
+            engine.destroy_resource(instanceBufferId_);
+        }
+        instanceCapacity_ = std::max(bytes, instanceCapacity_ * 2);
+        instanceBufferId_ = engine.create_buffer(instanceCapacity_, BufferUsage::Storage | BufferUsage::CopyDst);
+        if (instanceBufferId_ == 0) {
+            instanceCapacity_ = 0;
+            clear();
+            return 0;
+        }
+    }
+    engine.update_buffer(instanceBufferId_, 0, bytes, staging_.data());
+
+    // Six vertices per quad, generated in the shader from the instance
+    uint32_t draws = 0;
+    uint32_t first = 0;
+    for (const auto& [page, count] : runs_) {
+        ResourceId texture = atlas_->page_texture(page);
+        if (texture != 0) {
+            DrawCall call;
+            call.vertexCount = 6;
+            call.instanceCount = count;
+            call.firstInstance = first;
+            call.pipelineId = pipelineId_;
+            call.textures = {texture, samplerId_};
+            call.uniformBuffers = {view_projection, instanceBufferId_};
+            call.depthTest = false;
+            call.depthWrite = false;
+            call.cullFace = false;
+            call.blendEnabled = true;
+            engine.submit_draw_call(call);
+            draws++;
+        }
+        first += count;
+    }
+
+    // The next render rewrites the instance buffer and may recycle atlas
+    // pages, and both take effect ahead of anything not yet submitted
+    engine.flush();
+    atlas_->begin_frame();
+    clear();
+    return draws;
+}
+
+bool TextBatch::create_pipeline(RenderingEngine& engine) {
+    samplerId_ = engine.create_sampler(SamplerDescriptor{});
+
+    // The distance range is GlyphAtlas::DISTANCE_RANGE / PAGE_SIZE in uv units
+    pipelineId_ = engine.createPipeline(R"(
+struct GlyphQuad {
+    origin: vec4<f32>,
+    xAxis: vec4<f32>,
+    yAxis: vec4<f32>,
+    uv: vec4<f32>,
+    color: vec4<f32>,
+};
+
+@group(0) @binding(0) var<uniform> viewProjection: mat4x4<f32>;
+@group(0) @binding(1) var<storage, read> quads: array<GlyphQuad>;
+@group(0) @binding(2) var atlas: texture_2d<f32>;
+@group(0) @binding(3) var atlasSampler: sampler;
+
+const DISTANCE_RANGE_UV: f32 = 0.00390625;
+
+struct VertexOutput {
+    @builtin(position) position: vec4<f32>,
+    @location(0) uv: vec2<f32>,
+    @location(1) color: vec4<f32>,
+};
+
+@vertex
+fn vs_main(@builtin(vertex_index) vertex: u32, @builtin(instance_index) instance: u32) -> VertexOutput {
+    var corners = array<vec2<f32>, 6>(
+        vec2<f32>(0.0, 0.0), vec2<f32>(1.0, 0.0), vec2<f32>(1.0, 1.0),
+        vec2<f32>(0.0, 0.0), vec2<f32>(1.0, 1.0), vec2<f32>(0.0, 1.0));
+    let corner = corners[vertex];
+    let quad = quads[instance];
+    let p = quad.origin.xyz + corner.x * quad.xAxis.xyz + corner.y * quad.yAxis.xyz;
+
+    var out: VertexOutput;
+    out.position = viewProjection * vec4<f32>(p, 1.0);
+    // Atlas rows run top down while the quad's y runs up
+    out.uv = vec2<f32>(mix(quad.uv.x, quad.uv.z, corner.x), mix(quad.uv.w, quad.uv.y, corner.y));
+    out.color = quad.color;
+    return out;
+}
+
+fn median(r: f32, g: f32, b: f32) -> f32 {
+    return max(min(r, g), min(max(r, g), b));
+}
+
+@fragment
+fn fs_main(in: VertexOutput) -> @location(0) vec4<f32> {
+    let texel = textureSample(atlas, atlasSampler, in.uv);
+    // Screen pixels spanned by the distance range, so the edge stays one
+    // pixel soft however far the text is zoomed
+    let screenTexels = vec2<f32>(1.0) / fwidth(in.uv);
+    let screenRange = max(0.5 * dot(vec2<f32>(DISTANCE_RANGE_UV), screenTexels), 1.0);
+    let distance = median(texel.r, texel.g, texel.b) - 0.5;
+    let coverage = clamp(distance * screenRange + 0.5, 0.0, 1.0);
+    return vec4<f32>(in.color.rgb, in.color.a * coverage);
+}
+)");
+    return pipelineId_ != 0 && samplerId_ != 0;
+}
+
+} // namespace QuantumCanvas::Rendering
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "glyph_atlas.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace QuantumCanvas::Rendering {
+
+using PipelineId = uint64_t;
+
+// One glyph quad as the text shader reads it; matches struct GlyphQuad there
+struct GlyphInstance {
+    std::array<float, 4> origin{};  // Corner at the glyph's plane minimum; w unused
+    std::array<float, 4> xAxis{};   // Quad edge along the baseline
+    std::array<float, 4> yAxis{};   // Quad edge toward the ascenders
+    std::array<float, 4> uv{};      // As GlyphAtlas::Glyph::uv
+    std::array<float, 4> color{};
+};
+static_assert(sizeof(GlyphInstance) == 80, "GlyphInstance must match the shader's layout");
+
+// Text gathered over a frame and drawn from a glyph atlas as instanced
+// quads, one draw per atlas page however many labels there are
+//
+// The quads sample the atlas's distance fields with a screen-space range,
+// so edges stay one pixel soft at any zoom. Quads live in whatever space
+// the view-projection uniform maps from: document space for the vector
+// renderer, world space for CAD.
+class TextBatch {
+public:
+    explicit TextBatch(std::shared_ptr<GlyphAtlas> atlas = GlyphAtlas::shared());
+    ~TextBatch();
+
+    TextBatch(const TextBatch&) = delete;
+    TextBatch& operator=(const TextBatch&) = delete;
+
+    GlyphAtlas& atlas() { return *atlas_; }
+    const std::shared_ptr<GlyphAtlas>& shared_atlas() const { return atlas_; }
+    void set_atlas(std::shared_ptr<GlyphAtlas> atlas);  // Drops text not yet drawn
+
+    // Lays out one line from the baseline origin. 'advance' runs along the
+    // baseline and 'up' toward the ascenders, each one em long, so their
+    // lengths set the size; a slanted 'up' gives oblique text. Returns the
+    // line's advance in em.
+    float add_text(FontId font, std::string_view utf8, const std::array<float, 3>& origin,
+                   const std::array<float, 3>& advance, const std::array<float, 3>& up,
+                   const std::array<float, 4>& color);
+
+    size_t glyph_count() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    void clear();  // Keeps capacity
+
+    // Uploads the atlas, submits one instanced draw per page and clears.
+    // view_projection is a uniform buffer holding the column-major mat4x4
+    // from the text's space to clip space. Returns the draws submitted.
+    uint32_t render(RenderingEngine& engine, ResourceId view_projection);
+
+    // The quads of each page in submission order, as render() would upload them
+    void gather(std::vector<GlyphInstance>& instances, std::vector<std::pair<uint32_t, uint32_t>>& pages) const;
+
+private:
+    struct PageQuads {
+        uint32_t generation = 0;  // Of the atlas page the quads sample
+        std::vector<GlyphInstance> quads;
+    };
+
+    std::shared_ptr<GlyphAtlas> atlas_;
+    std::vector<PageQuads> pages_;  // By atlas page
+    std::vector<GlyphAtlas::PlacedGlyph> placed_;
+    size_t count_ = 0;
+
+    // GPU state, created on the first render()
+    RenderingEngine* engine_ = nullptr;
+    PipelineId pipelineId_ = 0;
+    ResourceId samplerId_ = 0;
+    ResourceId instanceBufferId_ = 0;
+    size_t instanceCapacity_ = 0;  // In bytes
+    std::vector<GlyphInstance> staging_;
+    std::vector<std::pair<uint32_t, uint32_t>> runs_;  // Page, quad count
+
+    bool create_pipeline(RenderingEngine& engine);
+};
+
+} // namespace QuantumCanvas::Rendering
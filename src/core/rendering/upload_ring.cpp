@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2024 Francisco Molina (QuantumCanvas Studio)
+ * Licensed under Dual License Agreement - See LICENSE file for details
+ *
+ * ATTRIBUTION REQUIRED: This software must include attribution to Francisco Molina
+ * COMMERCIAL USE: Requires separate license and royalties - contact pako.molina@gmail.com
+ *
+ * Project: https://github.com/Yatrogenesis/QuantumCanvas-Studio
+ * Author: Francisco Molina <pako.molina@gmail.com>
+ */
+
+#include "upload_ring.hpp"
+
+namespace QuantumCanvas::Rendering {
+
+void UploadRing::attach(ResourceId buffer, void* memory, size_t frameCapacity, uint32_t framesInFlight) {
+    buffer_ = buffer;
+    memory_ = static_cast<uint8_t*>(memory);
+    frameCapacity_ = frameCapacity;
+    framesInFlight_ = framesInFlight > 0 ? framesInFlight : 1;
+    regionOffset_ = 0;
+    used_.store(0, std::memory_order_relaxed);
+    written_ = 0;
+    overflows_.store(0, std::memory_order_relaxed);
+}
+
+void UploadRing::detach() {
+    buffer_ = 0;
+    memory_ = nullptr;
+    frameCapacity_ = 0;
+    regionOffset_ = 0;
+    used_.store(0, std::memory_order_relaxed);
+    written_ = 0;
+}
+
+UploadAllocation UploadRing::allocate(size_t size, size_t alignment) {
+    if (!memory_ || size == 0) {
+        return {};
+    }
+
+    // Alignment is relative to the buffer start, which is what the GPU checks
+    alignment = alignment > 0 ? alignment : 1;
+    size_t current = used_.load(std::memory_order_relaxed);
+    size_t aligned;
+    do {
+        size_t absolute = regionOffset_ + current;
+        aligned = (absolute + alignment - 1) / alignment * alignment - regionOffset_;
+        if (aligned + size > frameCapacity_) {
+            overflows_.fetch_add(1, std::memory_order_relaxed);
+            return {};
+        }
+    } while (!used_.compare_exchange_weak(current, aligned + size, std::memory_order_relaxed));
+
+    totalBytes_.fetch_add(size, std::memory_order_relaxed);
+
+    UploadAllocation allocation;
+    allocation.buffer = buffer_;
+    allocation.offset = regionOffset_ + aligned;
+    allocation.size = size;
+    allocation.data = memory_ + allocation.offset;
+    return allocation;
+}
+
+void UploadRing::begin_frame(uint32_t frameIndex) {
+    lastFrameBytes_ = used_.load(std::memory_order_relaxed);
+    lastFrameOverflows_ = overflows_.load(std::memory_order_relaxed);
+
+    regionOffset_ = static_cast<size_t>(frameIndex % (framesInFlight_ > 0 ? framesInFlight_ : 1)) * frameCapacity_;
+    used_.store(0, std::memory_order_relaxed);
+    written_ = 0;
+    overflows_.store(0, std::memory_order_relaxed);
+}
+
+UploadRing::Range UploadRing::take_unwritten() {
+    size_t used = used_.load(std::memory_order_relaxed);
+    if (!memory_ || used <= written_) {
+        return {};
+    }
+
+    // Alignment gaps between allocations are copied too; one write is cheaper
+    Range range;
+    range.offset = regionOffset_ + written_;
+    range.size = used - written_;
+    range.data = memory_ + range.offset;
+    written_ = used;
+    return range;
+}
+
+} // namespace QuantumCanvas::Rendering
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace QuantumCanvas::Rendering {
+
+using ResourceId = uint64_t;
+
+// A sub-allocation of the upload ring. Write through 'data', then bind
+// 'buffer' at 'offset' (a dynamic offset for uniforms). The bytes reach the
+// buffer when the frame is submitted, so writing must be finished by then.
+// Valid until the frame that made it has left the GPU.
+struct UploadAllocation {
+    ResourceId buffer = 0;
+    uint64_t offset = 0;
+    size_t size = 0;
+    void* data = nullptr;
+
+    bool is_valid() const { return data != nullptr; }
+};
+
+// CPU staging memory mirroring a GPU buffer, split into one region per frame
+// in flight. Allocation is a lock-free bump within the current frame's
+// region, so any thread can upload without touching the buffer API. Before
+// each submit the owner copies what was allocated since the last one into
+// the buffer with queue.writeBuffer; the queue orders that copy ahead of the
+// commands using it, and the buffer itself is never mapped. A region is
+// reused only after maxFramesInFlight frames.
+class UploadRing {
+public:
+    static constexpr size_t UNIFORM_ALIGNMENT = 256;  // minUniformBufferOffsetAlignment
+    static constexpr size_t DEFAULT_FRAME_CAPACITY = 4 * 1024 * 1024;
+
+    UploadRing() = default;
+    UploadRing(const UploadRing&) = delete;
+    UploadRing& operator=(const UploadRing&) = delete;
+
+    // 'memory' must hold frameCapacity * framesInFlight bytes, the size of 'buffer'
+    void attach(ResourceId buffer, void* memory, size_t frameCapacity, uint32_t framesInFlight);
+    void detach();
+    bool is_attached() const { return memory_ != nullptr; }
+
+    // Thread-safe. Returns an invalid allocation when this frame's region is full.
+    UploadAllocation allocate(size_t size, size_t alignment = UNIFORM_ALIGNMENT);
+
+    // Switches to the region of the given frame; not thread-safe with allocate()
+    void begin_frame(uint32_t frameIndex);
+
+    // The bytes of this frame's region allocated since the last call, at
+    // 'offset' in both the buffer and the staging memory. Called by the owner
+    // before it submits, on the thread that calls begin_frame(); empty when
+    // nothing new was allocated.
+    struct Range {
+        uint64_t offset = 0;
+        size_t size = 0;
+        const void* data = nullptr;
+    };
+    Range take_unwritten();
+
+    ResourceId buffer() const { return buffer_; }
+    size_t frame_capacity() const { return frameCapacity_; }
+    uint32_t frames_in_flight() const { return framesInFlight_; }
+
+    size_t bytes_this_frame() const { return used_.load(std::memory_order_relaxed); }
+    size_t bytes_last_frame() const { return lastFrameBytes_; }
+    uint64_t total_bytes() const { return totalBytes_.load(std::memory_order_relaxed); }
+
+    // Allocations refused this frame; the owner grows the ring when non-zero
+    uint32_t overflows_this_frame() const { return overflows_.load(std::memory_order_relaxed); }
+    uint32_t overflows_last_frame() const { return lastFrameOverflows_; }
+
+private:
+    ResourceId buffer_ = 0;
+    uint8_t* memory_ = nullptr;
+    size_t frameCapacity_ = 0;
+    uint32_t framesInFlight_ = 0;
+
+    size_t regionOffset_ = 0;   // Start of the current frame's region
+    std::atomic<size_t> used_{0};
+    size_t written_ = 0;        // Bytes of the region already copied to the buffer
+    std::atomic<uint32_t> overflows_{0};
+    std::atomic<uint64_t> totalBytes_{0};
+
+    size_t lastFrameBytes_ = 0;
+    uint32_t lastFrameOverflows_ = 0;
+};
+
+} // namespace QuantumCanvas::Rendering
@@ -22,6 +22,7 @@ struct WGPUCommandEncoder;
 struct WGPURenderPassEncoder;
 struct WGPUCommandBuffer;
 struct WGPUBindGroup;
+struct WGPUQuerySet;
 
 // Enums
 enum WGPUPowerPreference {
@@ -50,6 +51,25 @@ enum WGPUBufferUsage {
     WGPUBufferUsage_QueryResolve = 1 << 9
 };
 
+enum WGPUMapMode {
+    WGPUMapMode_None = 0,
+    WGPUMapMode_Read = 1 << 0,
+    WGPUMapMode_Write = 1 << 1
+};
+
+enum WGPUQueryType {
+    WGPUQueryType_Occlusion,
+    WGPUQueryType_Timestamp
+};
+
+enum WGPUFeatureName {
+    WGPUFeatureName_DepthClipControl,
+    WGPUFeatureName_Depth32FloatStencil8,
+    WGPUFeatureName_TimestampQuery,
+    WGPUFeatureName_TextureCompressionBC,
+    WGPUFeatureName_ShaderF16
+};
+
 enum WGPUTextureDimension {
     WGPUTextureDimension_1D,
     WGPUTextureDimension_2D,
@@ -160,6 +180,16 @@ struct WGPURequestAdapterOptions {
     bool forceFallbackAdapter = false;
 };
 
+struct WGPUAdapterInfo {
+    const char* vendor = nullptr;
+    const char* architecture = nullptr;
+    const char* device = nullptr;
+    const char* description = nullptr;  // Driver name and version
+    uint32_t backendType = 0;
+    uint32_t vendorID = 0;
+    uint32_t deviceID = 0;
+};
+
 struct WGPUDeviceDescriptor {
     const char* label = nullptr;
     uint32_t requiredFeatureCount = 0;
@@ -207,6 +237,19 @@ struct WGPUSamplerDescriptor {
     uint16_t maxAnisotropy = 1;
 };
 
+struct WGPUQuerySetDescriptor {
+    const char* label = nullptr;
+    WGPUQueryType type;
+    uint32_t count;
+};
+
+// Timestamps written when a pass begins and ends; values are nanoseconds
+struct WGPUPassTimestampWrites {
+    WGPUQuerySet* querySet;
+    uint32_t beginningOfPassWriteIndex;
+    uint32_t endOfPassWriteIndex;
+};
+
 struct WGPUCommandEncoderDescriptor {
     const char* label = nullptr;
 };
@@ -226,7 +269,7 @@ struct WGPURenderPassDescriptor {
     const void* depthStencilAttachment = nullptr;
     const void* occlusionQuerySet = nullptr;
     uint64_t timestampWriteCount = 0;
-    const void* timestampWrites = nullptr;
+    const WGPUPassTimestampWrites* timestampWrites = nullptr;
 };
 
 struct WGPUCommandBufferDescriptor {
@@ -246,18 +289,25 @@ struct WGPUTextureDataLayout {
     uint32_t rowsPerImage;
 };
 
+struct WGPUImageCopyBuffer {
+    WGPUTextureDataLayout layout;
+    WGPUBuffer* buffer;
+};
+
 // WGPU Wrapper class
 class WGPUWrapper {
 public:
     // Instance management
     static WGPUAdapter* instance_request_adapter(const WGPURequestAdapterOptions* options);
     static void adapter_release(WGPUAdapter* adapter);
+    static bool adapter_get_info(WGPUAdapter* adapter, WGPUAdapterInfo* info);
     
     // Device management
     static WGPUDevice* adapter_request_device(WGPUAdapter* adapter, const WGPUDeviceDescriptor* descriptor);
     static void device_release(WGPUDevice* device);
     static WGPUQueue* device_get_queue(WGPUDevice* device);
     static void device_poll(WGPUDevice* device, bool wait);
+    static bool device_has_feature(WGPUDevice* device, WGPUFeatureName feature);
     
     // Surface and swap chain
     static WGPUSurface* create_surface(void* nativeWindow);
@@ -272,6 +322,13 @@ public:
     static void buffer_release(WGPUBuffer* buffer);
     static void* buffer_get_mapped_range(WGPUBuffer* buffer, size_t offset, size_t size);
     static void buffer_unmap(WGPUBuffer* buffer);
+    using BufferMapCallback = void (*)(bool success, void* userdata);
+    static void buffer_map_async(WGPUBuffer* buffer, uint32_t mode, size_t offset, size_t size,
+                                 BufferMapCallback callback, void* userdata);
+    
+    // Queries
+    static WGPUQuerySet* device_create_query_set(WGPUDevice* device, const WGPUQuerySetDescriptor* descriptor);
+    static void query_set_release(WGPUQuerySet* querySet);
     
     // Texture management
     static WGPUTexture* device_create_texture(WGPUDevice* device, const WGPUTextureDescriptor* descriptor);
@@ -289,6 +346,10 @@ public:
     static WGPURenderPassEncoder* command_encoder_begin_render_pass(WGPUCommandEncoder* commandEncoder, const WGPURenderPassDescriptor* descriptor);
     static void render_pass_encoder_release(WGPURenderPassEncoder* renderPassEncoder);
     static void render_pass_encoder_end(WGPURenderPassEncoder* renderPassEncoder);
+    static void command_encoder_write_timestamp(WGPUCommandEncoder* commandEncoder, WGPUQuerySet* querySet, uint32_t queryIndex);
+    static void command_encoder_resolve_query_set(WGPUCommandEncoder* commandEncoder, WGPUQuerySet* querySet, uint32_t firstQuery, uint32_t queryCount, WGPUBuffer* destination, uint64_t destinationOffset);
+    static void command_encoder_copy_buffer_to_buffer(WGPUCommandEncoder* commandEncoder, WGPUBuffer* source, uint64_t sourceOffset, WGPUBuffer* destination, uint64_t destinationOffset, uint64_t size);
+    static void command_encoder_copy_texture_to_buffer(WGPUCommandEncoder* commandEncoder, const WGPUImageCopyTexture* source, const WGPUImageCopyBuffer* destination, const WGPUExtent3D* copySize);
     static WGPUCommandBuffer* command_encoder_finish(WGPUCommandEncoder* commandEncoder, const WGPUCommandBufferDescriptor* descriptor);
     static void command_buffer_release(WGPUCommandBuffer* commandBuffer);
     
@@ -296,6 +357,7 @@ public:
     static void queue_release(WGPUQueue* queue);
     static void queue_submit(WGPUQueue* queue, uint32_t commandCount, WGPUCommandBuffer* const* commands);
     static void queue_write_texture(WGPUQueue* queue, const WGPUImageCopyTexture* destination, const void* data, size_t dataSize, const WGPUTextureDataLayout* dataLayout, const WGPUExtent3D* writeSize);
+    static void queue_write_buffer(WGPUQueue* queue, WGPUBuffer* buffer, uint64_t bufferOffset, const void* data, size_t size);
     
 private:
     WGPUWrapper() = delete;
@@ -0,0 +1,589 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace QuantumCanvas::Core {
+
+// How a node's bounds relate to a query region
+enum class BVHOverlap {
+    Disjoint,
+    Partial,    // Leaves are reported, interior nodes descended into
+    Contained   // The whole subtree is reported without further tests
+};
+
+// Dynamic bounding volume hierarchy over axis-aligned bounds, shared by the
+// 2D object index, the CAD entity index and the Boolean face hierarchies
+//
+// Leaves keep the item's exact bounds; the tree is built over bounds
+// enlarged by a margin, so edits that move an item a little only rewrite
+// its leaf. Larger moves reinsert the leaf at the cheapest sibling by
+// surface area, and the tree is rebuilt top-down once edits have made it
+// much deeper than a balanced one. Top-down builds split each range at the
+// cheapest of 16 binned planes by the surface area heuristic.
+//
+// Axes adapts the bounds type: it names the Scalar, reads a bound's
+// lower(b, axis) and upper(b, axis), and make(lower, upper) builds one from
+// per-axis arrays.
+template<size_t Dimension, typename BoundsType, typename KeyType, typename Axes>
+class DynamicBVH {
+public:
+    using Bounds = BoundsType;
+    using Key = KeyType;
+    using Scalar = typename Axes::Scalar;
+
+    static constexpr int32_t NULL_NODE = -1;
+
+    struct Node {
+        Bounds bounds{};   // Enlarged for leaves, the children's union otherwise
+        Bounds exact{};    // Leaves only
+        Key key{};
+        int32_t parent = NULL_NODE;
+        int32_t child1 = NULL_NODE;  // NULL_NODE for leaves
+        int32_t child2 = NULL_NODE;
+        int32_t height = 0;          // 0 for leaves; -1 while on the free list
+
+        bool is_leaf() const { return child1 == NULL_NODE; }
+    };
+
+    // Margin added around each item, as a fraction of its largest side
+    explicit DynamicBVH(Scalar margin = Scalar(0.1))
+        : margin_(std::max(Scalar(0), margin)) {
+    }
+
+    // Replaces the contents with a tree built top-down, which is much
+    // faster and better balanced than inserting the items one by one
+    void build(const std::vector<std::pair<Key, Bounds>>& items);
+
+    // Inserts the key, or moves it if already present
+    void insert(Key key, const Bounds& bounds);
+    bool remove(Key key);
+    void clear();
+
+    bool contains(Key key) const { return leaves_.count(key) != 0; }
+    const Bounds* bounds(Key key) const;  // Exact bounds, null if absent
+    size_t size() const { return leaves_.size(); }
+    bool empty() const { return leaves_.empty(); }
+    uint32_t height() const;
+
+    // For traversals of several trees at once; root() is NULL_NODE while empty
+    int32_t root() const { return root_; }
+    const Node& node(int32_t index) const { return nodes_[index]; }
+
+    // Calls fn(key) for every item whose bounds overlap the region, borders
+    // included, in no particular order
+    template<typename Fn> void query(const Bounds& region, Fn&& fn) const;
+    void query(const Bounds& region, std::vector<Key>& out) const;
+
+    // Calls fn(key) for every item test() does not call Disjoint. test
+    // classifies an interior node's bounds and a leaf's exact bounds.
+    template<typename Test, typename Fn> void query_if(Test&& test, Fn&& fn) const;
+
+    static Bounds unite(const Bounds& a, const Bounds& b);
+    static bool encloses(const Bounds& outer, const Bounds& inner);
+    static bool overlaps(const Bounds& a, const Bounds& b);
+    // Half the perimeter in 2D, half the surface area in 3D: the insertion cost
+    static Scalar surface_area(const Bounds& b);
+
+private:
+    // Deep enough for any tree that needs_rebuild() lets through
+    static constexpr size_t STACK_DEPTH = 128;
+    static constexpr size_t SAH_BINS = 16;
+
+    Scalar margin_;
+    std::vector<Node> nodes_;
+    int32_t root_ = NULL_NODE;
+    int32_t free_list_ = NULL_NODE;  // Threaded through Node::parent
+    std::unordered_map<Key, int32_t> leaves_;
+
+    int32_t allocate_node();
+    void free_node(int32_t index);
+    Bounds enlarged(const Bounds& bounds) const;
+
+    void insert_leaf(int32_t leaf);
+    void remove_leaf(int32_t leaf);
+    void refit(int32_t index);
+    int32_t build_range(int32_t* leaves, size_t count, uint32_t sah_levels);
+    int32_t* sah_split(int32_t* leaves, size_t count, size_t axis, Scalar lower, Scalar upper);
+    void rebuild();
+    bool needs_rebuild() const;
+
+    // A balanced tree over n leaves has height ceil(log2(n))
+    static uint32_t balanced_height(size_t n) {
+        return n < 2 ? 0 : static_cast<uint32_t>(std::ceil(std::log2(static_cast<double>(n))));
+    }
+    static Scalar centre(const Bounds& b, size_t axis) {
+        return Scalar(0.5) * (Axes::lower(b, axis) + Axes::upper(b, axis));
+    }
+};
+
+// =============================================================================
+// Template Implementations
+// =============================================================================
+
+template<size_t D, typename B, typename K, typename A>
+B DynamicBVH<D, B, K, A>::unite(const Bounds& a, const Bounds& b) {
+    std::array<Scalar, D> lower, upper;
+    for (size_t axis = 0; axis < D; ++axis) {
+        lower[axis] = std::min(A::lower(a, axis), A::lower(b, axis));
+        upper[axis] = std::max(A::upper(a, axis), A::upper(b, axis));
+    }
+    return A::make(lower, upper);
+}
+
+template<size_t D, typename B, typename K, typename A>
+bool DynamicBVH<D, B, K, A>::encloses(const Bounds& outer, const Bounds& inner) {
+    for (size_t axis = 0; axis < D; ++axis) {
+        if (A::lower(outer, axis) > A::lower(inner, axis) || A::upper(outer, axis) < A::upper(inner, axis)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<size_t D, typename B, typename K, typename A>
+bool DynamicBVH<D, B, K, A>::overlaps(const Bounds& a, const Bounds& b) {
+    for (size_t axis = 0; axis < D; ++axis) {
+        if (A::lower(a, axis) > A::upper(b, axis) || A::lower(b, axis) > A::upper(a, axis)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<size_t D, typename B, typename K, typename A>
+typename A::Scalar DynamicBVH<D, B, K, A>::surface_area(const Bounds& b) {
+    // Sum over the axes of the extent of the face across each
+    Scalar area = 0;
+    for (size_t skip = 0; skip < D; ++skip) {
+        Scalar face = 1;
+        for (size_t axis = 0; axis < D; ++axis) {
+            if (axis != skip) {
+                face *= A::upper(b, axis) - A::lower(b, axis);
+            }
+        }
+        area += face;
+    }
+    return area;
+}
+
+template<size_t D, typename B, typename K, typename A>
+void DynamicBVH<D, B, K, A>::build(const std::vector<std::pair<Key, Bounds>>& items) {
+    clear();
+    nodes_.reserve(items.size() * 2);
+    leaves_.reserve(items.size());
+
+    for (const auto& [key, bounds] : items) {
+        auto it = leaves_.find(key);
+        const int32_t leaf = it != leaves_.end() ? it->second : allocate_node();
+        nodes_[leaf].key = key;
+        nodes_[leaf].exact = bounds;
+        nodes_[leaf].bounds = enlarged(bounds);
+        leaves_[key] = leaf;
+    }
+    rebuild();
+}
+
+template<size_t D, typename B, typename K, typename A>
+void DynamicBVH<D, B, K, A>::insert(Key key, const Bounds& bounds) {
+    auto it = leaves_.find(key);
+    if (it != leaves_.end()) {
+        const int32_t leaf = it->second;
+        nodes_[leaf].exact = bounds;
+        if (encloses(nodes_[leaf].bounds, bounds)) {
+            return;  // Still inside its margin, so the tree is unchanged
+        }
+        remove_leaf(leaf);
+        nodes_[leaf].bounds = enlarged(bounds);
+        insert_leaf(leaf);
+    } else {
+        const int32_t leaf = allocate_node();
+        nodes_[leaf].key = key;
+        nodes_[leaf].exact = bounds;
+        nodes_[leaf].bounds = enlarged(bounds);
+        leaves_.emplace(key, leaf);
+        insert_leaf(leaf);
+    }
+
+    if (needs_rebuild()) {
+        rebuild();
+    }
+}
+
+template<size_t D, typename B, typename K, typename A>
+bool DynamicBVH<D, B, K, A>::remove(Key key) {
+    auto it = leaves_.find(key);
+    if (it == leaves_.end()) {
+        return false;
+    }
+    remove_leaf(it->second);
+    free_node(it->second);
+    leaves_.erase(it);
+    return true;
+}
+
+template<size_t D, typename B, typename K, typename A>
+void DynamicBVH<D, B, K, A>::clear() {
+    nodes_.clear();
+    leaves_.clear();
+    root_ = NULL_NODE;
+    free_list_ = NULL_NODE;
+}
+
+template<size_t D, typename B, typename K, typename A>
+const B* DynamicBVH<D, B, K, A>::bounds(Key key) const {
+    auto it = leaves_.find(key);
+    return it != leaves_.end() ? &nodes_[it->second].exact : nullptr;
+}
+
+template<size_t D, typename B, typename K, typename A>
+uint32_t DynamicBVH<D, B, K, A>::height() const {
+    return root_ == NULL_NODE ? 0 : static_cast<uint32_t>(nodes_[root_].height);
+}
+
+template<size_t D, typename B, typename K, typename A>
+template<typename Fn>
+void DynamicBVH<D, B, K, A>::query(const Bounds& region, Fn&& fn) const {
+    if (root_ == NULL_NODE) {
+        return;
+    }
+
+    int32_t stack[STACK_DEPTH];
+    size_t top = 0;
+    stack[top++] = root_;
+    while (top > 0) {
+        const Node& node = nodes_[stack[--top]];
+        if (!overlaps(node.bounds, region)) {
+            continue;
+        }
+        if (node.is_leaf()) {
+            if (overlaps(node.exact, region)) {
+                fn(node.key);
+            }
+        } else {
+            stack[top++] = node.child1;
+            stack[top++] = node.child2;
+        }
+    }
+}
+
+template<size_t D, typename B, typename K, typename A>
+void DynamicBVH<D, B, K, A>::query(const Bounds& region, std::vector<Key>& out) const {
+    query(region, [&out](Key key) { out.push_back(key); });
+}
+
+template<size_t D, typename B, typename K, typename A>
+template<typename Test, typename Fn>
+void DynamicBVH<D, B, K, A>::query_if(Test&& test, Fn&& fn) const {
+    if (root_ == NULL_NODE) {
+        return;
+    }
+
+    // Contained subtrees go on a second stack that reports without testing
+    int32_t stack[STACK_DEPTH];
+    int32_t contained[STACK_DEPTH];
+    size_t top = 0;
+    stack[top++] = root_;
+    while (top > 0) {
+        const int32_t index = stack[--top];
+        const Node& node = nodes_[index];
+        const BVHOverlap overlap = test(node.is_leaf() ? node.exact : node.bounds);
+        if (overlap == BVHOverlap::Disjoint) {
+            continue;
+        }
+        if (node.is_leaf()) {
+            fn(node.key);
+        } else if (overlap == BVHOverlap::Contained) {
+            size_t inner = 0;
+            contained[inner++] = index;
+            while (inner > 0) {
+                const Node& child = nodes_[contained[--inner]];
+                if (child.is_leaf()) {
+                    fn(child.key);
+                } else {
+                    contained[inner++] = child.child1;
+                    contained[inner++] = child.child2;
+                }
+            }
+        } else {
+            stack[top++] = node.child1;
+            stack[top++] = node.child2;
+        }
+    }
+}
+
+template<size_t D, typename B, typename K, typename A>
+int32_t DynamicBVH<D, B, K, A>::allocate_node() {
+    int32_t index;
+    if (free_list_ != NULL_NODE) {
+        index = free_list_;
+        free_list_ = nodes_[index].parent;
+    } else {
+        index = static_cast<int32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    nodes_[index] = Node{};
+    return index;
+}
+
+template<size_t D, typename B, typename K, typename A>
+void DynamicBVH<D, B, K, A>::free_node(int32_t index) {
+    Node& node = nodes_[index];
+    node.key = Key{};
+    node.child1 = NULL_NODE;
+    node.child2 = NULL_NODE;
+    node.height = -1;
+    node.parent = free_list_;
+    free_list_ = index;
+}
+
+template<size_t D, typename B, typename K, typename A>
+B DynamicBVH<D, B, K, A>::enlarged(const Bounds& bounds) const {
+    Scalar largest = 0;
+    for (size_t axis = 0; axis < D; ++axis) {
+        largest = std::max(largest, A::upper(bounds, axis) - A::lower(bounds, axis));
+    }
+    const Scalar m = margin_ * largest;
+    std::array<Scalar, D> lower, upper;
+    for (size_t axis = 0; axis < D; ++axis) {
+        lower[axis] = A::lower(bounds, axis) - m;
+        upper[axis] = A::upper(bounds, axis) + m;
+    }
+    return A::make(lower, upper);
+}
+
+template<size_t D, typename B, typename K, typename A>
+void DynamicBVH<D, B, K, A>::insert_leaf(int32_t leaf) {
+    if (root_ == NULL_NODE) {
+        root_ = leaf;
+        nodes_[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // Descend toward the sibling that grows the tree's total surface area
+    // the least, counting the growth of every ancestor on the way down
+    const Bounds leaf_bounds = nodes_[leaf].bounds;
+    int32_t index = root_;
+    while (!nodes_[index].is_leaf()) {
+        const Node& node = nodes_[index];
+        const Scalar combined = surface_area(unite(node.bounds, leaf_bounds));
+        const Scalar cost = 2 * combined;
+        const Scalar inherited = 2 * (combined - surface_area(node.bounds));
+
+        auto descend_cost = [&](int32_t child) {
+            const Bounds& b = nodes_[child].bounds;
+            const Scalar grown = surface_area(unite(b, leaf_bounds));
+            return (nodes_[child].is_leaf() ? grown : grown - surface_area(b)) + inherited;
+        };
+        const Scalar cost1 = descend_cost(node.child1);
+        const Scalar cost2 = descend_cost(node.child2);
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const int32_t sibling = index;
+    const int32_t old_parent = nodes_[sibling].parent;
+    const int32_t new_parent = allocate_node();  // May move nodes_
+    nodes_[new_parent].parent = old_parent;
+    nodes_[new_parent].child1 = sibling;
+    nodes_[new_parent].child2 = leaf;
+    nodes_[sibling].parent = new_parent;
+    nodes_[leaf].parent = new_parent;
+
+    if (old_parent == NULL_NODE) {
+        root_ = new_parent;
+    } else if (nodes_[old_parent].child1 == sibling) {
+        nodes_[old_parent].child1 = new_parent;
+    } else {
+        nodes_[old_parent].child2 = new_parent;
+    }
+    refit(new_parent);
+}
+
+template<size_t D, typename B, typename K, typename A>
+void DynamicBVH<D, B, K, A>::remove_leaf(int32_t leaf) {
+    if (leaf == root_) {
+        root_ = NULL_NODE;
+        return;
+    }
+
+    const int32_t parent = nodes_[leaf].parent;
+    const int32_t grand_parent = nodes_[parent].parent;
+    const int32_t sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+    nodes_[leaf].parent = NULL_NODE;
+
+    // The sibling takes the parent's place
+    nodes_[sibling].parent = grand_parent;
+    if (grand_parent == NULL_NODE) {
+        root_ = sibling;
+    } else if (nodes_[grand_parent].child1 == parent) {
+        nodes_[grand_parent].child1 = sibling;
+    } else {
+        nodes_[grand_parent].child2 = sibling;
+    }
+    free_node(parent);
+    refit(grand_parent);
+}
+
+template<size_t D, typename B, typename K, typename A>
+void DynamicBVH<D, B, K, A>::refit(int32_t index) {
+    while (index != NULL_NODE) {
+        Node& node = nodes_[index];
+        const Node& a = nodes_[node.child1];
+        const Node& b = nodes_[node.child2];
+        node.bounds = unite(a.bounds, b.bounds);
+        node.height = 1 + std::max(a.height, b.height);
+        index = node.parent;
+    }
+}
+
+template<size_t D, typename B, typename K, typename A>
+int32_t DynamicBVH<D, B, K, A>::build_range(int32_t* leaves, size_t count, uint32_t sah_levels) {
+    if (count == 1) {
+        return leaves[0];
+    }
+
+    // Split along the longest side of the centres' extent
+    std::array<Scalar, D> lower, upper;
+    for (size_t axis = 0; axis < D; ++axis) {
+        lower[axis] = upper[axis] = centre(nodes_[leaves[0]].bounds, axis);
+    }
+    for (size_t i = 1; i < count; ++i) {
+        for (size_t axis = 0; axis < D; ++axis) {
+            const Scalar c = centre(nodes_[leaves[i]].bounds, axis);
+            lower[axis] = std::min(lower[axis], c);
+            upper[axis] = std::max(upper[axis], c);
+        }
+    }
+    size_t axis = 0;
+    for (size_t a = 1; a < D; ++a) {
+        if (upper[a] - lower[a] > upper[axis] - lower[axis]) {
+            axis = a;
+        }
+    }
+
+    int32_t* const end = leaves + count;
+    int32_t* middle = nullptr;
+    if (sah_levels > 0 && upper[axis] > lower[axis]) {
+        middle = sah_split(leaves, count, axis, lower[axis], upper[axis]);
+    }
+    // Coincident centres, every leaf in one bin, or already deep: split at
+    // the median, which keeps the rest of the range balanced
+    if (middle == nullptr || middle == leaves || middle == end) {
+        middle = leaves + count / 2;
+        std::nth_element(leaves, middle, end, [&](int32_t a, int32_t b) {
+            return centre(nodes_[a].bounds, axis) < centre(nodes_[b].bounds, axis);
+        });
+    }
+
+    const size_t left_count = static_cast<size_t>(middle - leaves);
+    const uint32_t child_levels = sah_levels > 0 ? sah_levels - 1 : 0;
+    const int32_t left = build_range(leaves, left_count, child_levels);
+    const int32_t right = build_range(middle, count - left_count, child_levels);
+    const int32_t node = allocate_node();
+    nodes_[node].child1 = left;
+    nodes_[node].child2 = right;
+    nodes_[node].bounds = unite(nodes_[left].bounds, nodes_[right].bounds);
+    nodes_[node].height = 1 + std::max(nodes_[left].height, nodes_[right].height);
+    nodes_[left].parent = node;
+    nodes_[right].parent = node;
+    return node;
+}
+
+template<size_t D, typename B, typename K, typename A>
+int32_t* DynamicBVH<D, B, K, A>::sah_split(int32_t* leaves, size_t count, size_t axis, Scalar lower, Scalar upper) {
+    struct Bin {
+        Bounds bounds{};
+        uint32_t count = 0;
+    };
+    std::array<Bin, SAH_BINS> bins;
+    const Scalar scale = static_cast<Scalar>(SAH_BINS) / (upper - lower);
+    auto bin_of = [&](int32_t leaf) {
+        const auto bin = static_cast<size_t>((centre(nodes_[leaf].bounds, axis) - lower) * scale);
+        return std::min(bin, SAH_BINS - 1);
+    };
+    auto add = [](Bounds& bounds, uint32_t& total, const Bounds& more, uint32_t count) {
+        if (count > 0) {
+            bounds = total > 0 ? unite(bounds, more) : more;
+            total += count;
+        }
+    };
+    for (size_t i = 0; i < count; ++i) {
+        Bin& bin = bins[bin_of(leaves[i])];
+        add(bin.bounds, bin.count, nodes_[leaves[i]].bounds, 1);
+    }
+
+    // Sweep from the right for the suffix costs, then from the left
+    std::array<Scalar, SAH_BINS> right_cost{};
+    Bounds right_bounds{};
+    uint32_t right_count = 0;
+    for (size_t split = SAH_BINS - 1; split > 0; --split) {
+        add(right_bounds, right_count, bins[split].bounds, bins[split].count);
+        right_cost[split] = right_count > 0 ? surface_area(right_bounds) * right_count : Scalar(0);
+    }
+
+    Bounds left_bounds{};
+    uint32_t left_count = 0;
+    Scalar best_cost = 0;
+    size_t best_split = 0;
+    for (size_t split = 1; split < SAH_BINS; ++split) {
+        add(left_bounds, left_count, bins[split - 1].bounds, bins[split - 1].count);
+        if (left_count == 0 || left_count == count) {
+            continue;
+        }
+        const Scalar cost = surface_area(left_bounds) * left_count + right_cost[split];
+        if (best_split == 0 || cost < best_cost) {
+            best_cost = cost;
+            best_split = split;
+        }
+    }
+
+    if (best_split == 0) {
+        return nullptr;
+    }
+    return std::partition(leaves, leaves + count, [&](int32_t leaf) { return bin_of(leaf) < best_split; });
+}
+
+template<size_t D, typename B, typename K, typename A>
+void DynamicBVH<D, B, K, A>::rebuild() {
+    // Leaves keep their slots, so leaves_ stays valid; internal nodes are
+    // all freed and rebuilt
+    for (int32_t i = 0; i < static_cast<int32_t>(nodes_.size()); ++i) {
+        if (nodes_[i].height > 0) {
+            free_node(i);
+        }
+    }
+
+    root_ = NULL_NODE;
+    if (leaves_.empty()) {
+        return;
+    }
+    std::vector<int32_t> leaves;
+    leaves.reserve(leaves_.size());
+    for (const auto& entry : leaves_) {
+        leaves.push_back(entry.second);
+    }
+    // SAH splits for as many levels as a balanced tree has, plus slack; the
+    // median splits below them keep the height within needs_rebuild()
+    const uint32_t sah_levels = balanced_height(leaves.size()) + 8;
+    root_ = build_range(leaves.data(), leaves.size(), sah_levels);
+    nodes_[root_].parent = NULL_NODE;
+}
+
+template<size_t D, typename B, typename K, typename A>
+bool DynamicBVH<D, B, K, A>::needs_rebuild() const {
+    // Allow twice a balanced tree's height plus slack, which also bounds
+    // the traversal stacks
+    const size_t n = leaves_.size();
+    return n >= 2 && height() > 2 * balanced_height(n) + 8;
+}
+
+} // namespace QuantumCanvas::Core
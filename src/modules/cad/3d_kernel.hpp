@@ -12,6 +12,10 @@
 
 #include "cad_types.hpp"
 #include "cad_common.hpp"
+#include "face_bvh.hpp"
+#include "mesh_cache.hpp"
+#include "brep_store.hpp"
+#include "feature_graph.hpp"
 
 #include <memory>
 #include <vector>
@@ -111,19 +115,6 @@ enum class FeatureType {
     Stitch          ///< Surface stitching
 };
 
-/// Model validation states
-enum class ValidationState {
-    Valid,              ///< Model is geometrically valid
-    Warning,            ///< Minor issues that don't affect functionality
-    InvalidTopology,    ///< Topological inconsistency
-    InvalidGeometry,    ///< Geometric degeneracy
-    SelfIntersection,   ///< Self-intersecting geometry
-    NonManifold,        ///< Non-manifold topology
-    OpenVolume,         ///< Volume with openings
-    InvalidOrientation, ///< Inconsistent face orientations
-    Failed             ///< Validation failed to complete
-};
-
 // =============================================================================
 // Topological Entities (BREP Structure)
 // =============================================================================
@@ -136,6 +127,7 @@ protected:
     std::shared_ptr<GeometryEntity> geometry_;
     BoundingBox3D bounds_;
     bool is_valid_;
+    uint64_t revision_ = 0;
     
     // Topological relationships
     std::vector<std::weak_ptr<TopologyEntity>> parents_;
@@ -151,6 +143,11 @@ public:
     bool is_valid() const { return is_valid_; }
     const BoundingBox3D& get_bounds() const { return bounds_; }
     
+    /// Advances whenever the entity's shape changes, so cached meshes and
+    /// other derived data can tell they are stale
+    uint64_t get_revision() const { return revision_; }
+    void mark_modified() { ++revision_; }
+    
     // Geometry association
     std::shared_ptr<GeometryEntity> get_geometry() const { return geometry_; }
     void set_geometry(std::shared_ptr<GeometryEntity> geometry);
@@ -288,8 +285,13 @@ public:
     void remove_inner_boundary(std::shared_ptr<Wire> boundary);
     
     bool has_forward_orientation() const { return forward_orientation_; }
-    void set_orientation(bool forward) { forward_orientation_ = forward; }
-    void reverse_orientation() { forward_orientation_ = !forward_orientation_; }
+    void set_orientation(bool forward) {
+        if (forward != forward_orientation_) {
+            forward_orientation_ = forward;
+            mark_modified();
+        }
+    }
+    void reverse_orientation() { set_orientation(!forward_orientation_); }
     
     SurfaceContinuity get_continuity_level() const { return continuity_level_; }
     void set_continuity_level(SurfaceContinuity level) { continuity_level_ = level; }
@@ -534,7 +536,10 @@ protected:
     std::string name_;
     FeatureType type_;
     std::vector<size_t> input_entity_ids_;
+    std::vector<size_t> dependency_ids_;                          // Features whose results this consumes
+    std::vector<std::shared_ptr<TopologyEntity>> input_results_;  // Their results, set before execute()
     std::shared_ptr<TopologyEntity> result_;
+    uint64_t revision_ = 0;
     bool is_suppressed_;
     bool is_valid_;
 
@@ -554,6 +559,17 @@ public:
     std::shared_ptr<TopologyEntity> get_result() const { return result_; }
     const std::vector<size_t>& get_input_entity_ids() const { return input_entity_ids_; }
     
+    /// Upstream features, in the order execute() sees their results
+    const std::vector<size_t>& get_dependencies() const { return dependency_ids_; }
+    void set_dependencies(std::vector<size_t> feature_ids) { dependency_ids_ = std::move(feature_ids); mark_modified(); }
+    const std::vector<std::shared_ptr<TopologyEntity>>& get_input_results() const { return input_results_; }
+    void set_input_results(std::vector<std::shared_ptr<TopologyEntity>> results) { input_results_ = std::move(results); }
+    
+    /// Bumped by every parameter change, so the kernel regenerates the
+    /// feature and what depends on it
+    uint64_t get_revision() const { return revision_; }
+    void mark_modified() { ++revision_; }
+    
     virtual bool execute() = 0;
     virtual bool validate() = 0;
     virtual std::unique_ptr<Feature> clone() const = 0;
@@ -578,10 +594,10 @@ public:
     bool is_both_directions() const { return both_directions_; }
     Precision get_taper_angle() const { return taper_angle_; }
     
-    void set_direction(const Vector3D& direction) { direction_ = direction; }
-    void set_distance(Precision distance) { distance_ = distance; }
-    void set_both_directions(bool both) { both_directions_ = both; }
-    void set_taper_angle(Precision angle) { taper_angle_ = angle; }
+    void set_direction(const Vector3D& direction) { direction_ = direction; mark_modified(); }
+    void set_distance(Precision distance) { distance_ = distance; mark_modified(); }
+    void set_both_directions(bool both) { both_directions_ = both; mark_modified(); }
+    void set_taper_angle(Precision angle) { taper_angle_ = angle; mark_modified(); }
     
     // Inherited methods
     bool execute() override;
@@ -610,7 +626,7 @@ public:
     
     void set_axis(const Point3D& origin, const Vector3D& direction);
     void set_angle(Precision angle);
-    void set_full_revolution(bool full) { full_revolution_ = full; }
+    void set_full_revolution(bool full) { full_revolution_ = full; mark_modified(); }
     
     // Inherited methods
     bool execute() override;
@@ -630,6 +646,7 @@ private:
     std::unordered_map<size_t, std::shared_ptr<TopologyEntity>> topology_entities_;
     std::unordered_map<size_t, std::shared_ptr<GeometryEntity>> geometry_entities_;
     std::unordered_map<size_t, std::unique_ptr<Feature>> features_;
+    FeatureGraph feature_graph_;  // Dependencies and cached results of features_
     
     size_t next_entity_id_;
     size_t next_geometry_id_;
@@ -640,6 +657,21 @@ private:
     Precision angular_tolerance_;
     bool enable_validation_;
     bool enable_healing_;
+    
+    // Boolean operation progress
+    BooleanProgressCallback boolean_progress_;
+    
+    // Display meshes, shared by every view of the model
+    struct SolidMesh {
+        TessellationTolerance tolerance;
+        std::vector<std::shared_ptr<const IndexedMesh>> faces;  // The face meshes it was merged from
+        std::shared_ptr<const IndexedMesh> mesh;
+    };
+    std::shared_ptr<MeshCache> mesh_cache_ = std::make_shared<MeshCache>();
+    std::unordered_map<size_t, SolidMesh> solid_meshes_;  // By solid ID
+    
+    // Compact copies of solids for traversal-heavy passes
+    BRepStore topology_store_;
 
 public:
     ModelingKernel();
@@ -687,6 +719,20 @@ public:
     std::shared_ptr<Solid> boolean_symmetric_difference(std::shared_ptr<Solid> solid1, 
                                                        std::shared_ptr<Solid> solid2);
     
+    /// Reports progress of the face-face intersection stage of each Boolean
+    /// operation; returning false cancels it and the operation returns null
+    void set_boolean_progress_callback(BooleanProgressCallback callback) { boolean_progress_ = std::move(callback); }
+    
+    /// Runs intersect on every pair of faces, one from each solid, whose
+    /// bounds overlap within the modeling tolerance. Pairs are culled through
+    /// a BVH per solid and intersected in parallel, so intersect must be
+    /// thread-safe. Returns false if the progress callback cancelled.
+    bool intersect_overlapping_faces(const Solid& solid1, const Solid& solid2,
+                                     const std::function<void(const Face& face1, const Face& face2)>& intersect);
+    
+    /// The faces of every shell of a solid, outer shell first
+    static std::vector<std::shared_ptr<Face>> collect_solid_faces(const Solid& solid);
+    
     // Advanced operations
     std::shared_ptr<Solid> fillet_edges(std::shared_ptr<Solid> solid,
                                        const std::vector<std::shared_ptr<Edge>>& edges,
@@ -703,9 +749,15 @@ public:
     size_t add_feature(std::unique_ptr<Feature> feature);
     void remove_feature(size_t feature_id);
     Feature* get_feature(size_t feature_id);
+    /// Regenerates the feature and everything downstream of it
     void execute_feature(size_t feature_id);
+    /// Regenerates the features changed since the last run and everything
+    /// downstream of them; independent branches run in parallel
     void execute_all_features();
+    /// Regenerates the whole history, cached results or not
+    void rebuild_all_features();
     void suppress_feature(size_t feature_id, bool suppress);
+    const FeatureGraph& get_feature_graph() const { return feature_graph_; }
     
     // Model validation and repair
     ValidationState validate_model(std::shared_ptr<TopologyEntity> entity);
@@ -730,11 +782,32 @@ public:
     // Tessellation and discretization
     std::vector<Point3D> tessellate_curve(std::shared_ptr<CurveGeometry> curve, 
                                          Precision tolerance = 1e-6);
+    /// Triangle soup of one face; must be safe to call from several threads
     std::vector<std::array<Point3D, 3>> tessellate_face(std::shared_ptr<Face> face,
-                                                       Precision tolerance = 1e-6);
+                                                       Precision tolerance = 1e-6,
+                                                       Precision angular_tolerance = 0.2);
     std::vector<std::array<Point3D, 3>> tessellate_solid(std::shared_ptr<Solid> solid,
                                                         Precision tolerance = 1e-6);
     
+    /// Indexed mesh of a face, tessellated on first use and cached by the
+    /// face's revision and the quantized tolerance
+    std::shared_ptr<const IndexedMesh> tessellate_face_mesh(std::shared_ptr<Face> face,
+                                                            const TessellationTolerance& tolerance);
+    
+    /// Indexed mesh of a whole solid. Faces missing from the cache are
+    /// tessellated in parallel; the merged mesh is kept until a face changes.
+    std::shared_ptr<const IndexedMesh> tessellate_solid_mesh(std::shared_ptr<Solid> solid,
+                                                             const TessellationTolerance& tolerance);
+    
+    const std::shared_ptr<MeshCache>& get_mesh_cache() const { return mesh_cache_; }
+    void set_mesh_cache(std::shared_ptr<MeshCache> cache);
+    
+    /// Copies a solid into the kernel's half-edge store, where validation,
+    /// neighbourhood walks and copies touch contiguous arrays only
+    SolidHandle store_solid(const Solid& solid) { return topology_store_.import_solid(solid); }
+    BRepStore& get_topology_store() { return topology_store_; }
+    const BRepStore& get_topology_store() const { return topology_store_; }
+    
     // Entity management
     void remove_entity(size_t entity_id);
     void clear_all_entities();
@@ -765,6 +838,7 @@ private:
     size_t allocate_entity_id() { return ++next_entity_id_; }
     size_t allocate_geometry_id() { return ++next_geometry_id_; }
     size_t allocate_feature_id() { return ++next_feature_id_; }
+    FeatureGraph::RegenerationStats regenerate_features();
 };
 
 } // namespace qcs::cad
\ No newline at end of file
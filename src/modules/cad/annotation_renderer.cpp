@@ -0,0 +1,89 @@
+/**
+ * @file annotation_renderer.cpp
+ * @brief Implementation of the technical annotation and dimensioning system
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Annotation text drawn from the glyph atlas shared with the vector renderer
+ */
+
+#include "annotation_renderer.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace qcs::cad {
+
+// =============================================================================
+// AnnotationRenderer Text Implementation
+// =============================================================================
+
+void AnnotationRenderer::render_dimension_text(const std::string& text, const Point3D& position,
+                                               const Vector3D& direction, const TextStyle& style) {
+    if (!render_text_ || !render_context_ || text.empty()) {
+        return;
+    }
+
+    // Styles naming a font the atlas lacks fall back to the current one
+    render_context_->set_font(style.get_font_name());
+    render_context_->set_color(style.get_text_color());
+    render_context_->render_text(text, position, direction,
+                                 style.get_font_size() * annotation_scale_,
+                                 style.get_width_factor(), style.get_oblique_angle());
+}
+
+BoundingBox2D AnnotationRenderer::measure_text(const std::string& text, const TextStyle& style) const {
+    if (!render_context_) {
+        return BoundingBox2D();
+    }
+
+    auto atlas = render_context_->get_shared_glyph_atlas();
+    auto font = atlas->find_font(style.get_font_name());
+    if (!font) {
+        font = render_context_->get_font();
+    }
+    if (!font) {
+        return BoundingBox2D();
+    }
+
+    // Lines stack downward from the first baseline, which sits at y = 0
+    const Precision height = style.get_font_size() * annotation_scale_;
+    const Precision spacing = height * style.get_line_spacing_factor();
+    const auto lines = split_text_into_lines(text);
+    std::vector<QuantumCanvas::Rendering::GlyphAtlas::PlacedGlyph> placed;
+    Precision width = 0.0;
+    for (const auto& line : lines) {
+        placed.clear();
+        width = std::max(width, static_cast<Precision>(atlas->layout(*font, line, placed)));
+    }
+    width *= height * style.get_width_factor();
+
+    const Precision descent = lines.empty() ? 0.0 : spacing * static_cast<Precision>(lines.size() - 1);
+    return BoundingBox2D(Point2D(0.0, -descent), Point2D(width, height));
+}
+
+std::vector<std::string> AnnotationRenderer::split_text_into_lines(const std::string& text) const {
+    std::vector<std::string> lines;
+    size_t start = 0;
+    while (true) {
+        size_t end = text.find('\n', start);
+        lines.push_back(text.substr(start, end == std::string::npos ? std::string::npos : end - start));
+        if (end == std::string::npos) {
+            break;
+        }
+        start = end + 1;
+    }
+    return lines;
+}
+
+void AnnotationRenderer::clear_text_cache() {
+    if (render_context_) {
+        render_context_->get_glyph_atlas().clear();
+    }
+}
+
+size_t AnnotationRenderer::get_cache_memory_usage() const {
+    return render_context_ ? render_context_->get_shared_glyph_atlas()->memory_usage() : 0;
+}
+
+} // namespace qcs::cad
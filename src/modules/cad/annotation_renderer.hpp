@@ -559,9 +559,9 @@ private:
     bool render_arrowheads_;
     bool render_text_;
     
-    // Performance optimization
+    // Performance optimization. Glyphs live in the render context's atlas,
+    // shared with the vector renderer, rather than per annotation.
     bool enable_text_caching_;
-    std::unordered_map<size_t, std::vector<Point3D>> text_glyph_cache_;
 
 public:
     AnnotationRenderer(std::shared_ptr<PrecisionRenderContext> context);
@@ -650,7 +650,7 @@ public:
     // Performance and caching
     void enable_text_caching(bool enable) { enable_text_caching_ = enable; }
     void clear_text_cache();
-    size_t get_cache_memory_usage() const;
+    size_t get_cache_memory_usage() const;  ///< Of the glyph atlas
     
     // Export and documentation
     void export_annotation_styles(const std::string& filename) const;
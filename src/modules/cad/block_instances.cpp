@@ -0,0 +1,110 @@
+/**
+ * @file block_instances.cpp
+ * @brief Implementation of per-block placement storage
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Slot allocation, swap removal and range coalescing
+ */
+
+#include "block_instances.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace qcs::cad {
+
+// =============================================================================
+// BlockInstanceBatch Editing
+// =============================================================================
+
+BlockInstanceBatch::BlockInstanceBatch(const Point3D& origin)
+    : origin_(origin) {
+}
+
+void BlockInstanceBatch::set_instance(EntityID id, const Matrix4D& model) {
+    auto [it, added] = slots_.try_emplace(id, static_cast<uint32_t>(placements_.size()));
+    if (added) {
+        placements_.emplace_back();
+        ids_.push_back(id);
+    }
+    const uint32_t slot = it->second;
+
+    Matrix4D relative = model;
+    relative.col(3).head<3>() -= origin_;
+    const Eigen::Matrix4f single = relative.cast<float>();
+
+    BlockPlacement& placement = placements_[slot];
+    std::copy(single.data(), single.data() + 16, placement.model.begin());
+    // Patterns follow the average scale of the placement's plane
+    const Precision area_scale = std::abs(model.topLeftCorner<2, 2>().determinant());
+    placement.distance_scale = static_cast<float>(area_scale > 0.0 ? std::sqrt(area_scale) : 1.0);
+    dirty_.push_back({slot, 1});
+}
+
+bool BlockInstanceBatch::remove_instance(EntityID id) {
+    auto it = slots_.find(id);
+    if (it == slots_.end()) {
+        return false;
+    }
+
+    const uint32_t slot = it->second;
+    const auto last = static_cast<uint32_t>(placements_.size() - 1);
+    slots_.erase(it);
+    if (slot != last) {
+        placements_[slot] = placements_[last];
+        ids_[slot] = ids_[last];
+        slots_[ids_[slot]] = slot;
+        dirty_.push_back({slot, 1});
+    }
+    placements_.pop_back();
+    ids_.pop_back();
+
+    // Slots past the end are never drawn, so need no upload
+    dirty_.erase(std::remove_if(dirty_.begin(), dirty_.end(), [last](const Range& range) { return range.first >= last; }),
+                 dirty_.end());
+    return true;
+}
+
+void BlockInstanceBatch::clear() {
+    placements_.clear();
+    ids_.clear();
+    slots_.clear();
+    dirty_.clear();
+}
+
+// =============================================================================
+// BlockInstanceBatch Ranges
+// =============================================================================
+
+std::vector<BlockInstanceBatch::Range> BlockInstanceBatch::take_dirty_ranges(uint32_t max_gap) {
+    std::vector<Range> ranges;
+    ranges.swap(dirty_);
+    LineBatch::merge_ranges(ranges, max_gap);
+    return ranges;
+}
+
+std::vector<BlockInstanceBatch::Range> BlockInstanceBatch::get_draw_ranges(std::span<const EntityID> ids,
+                                                                           uint32_t max_gap,
+                                                                           size_t max_ranges) const {
+    std::vector<Range> ranges;
+    ranges.reserve(ids.size());
+    for (EntityID id : ids) {
+        auto it = slots_.find(id);
+        if (it != slots_.end()) {
+            ranges.push_back({it->second, 1});
+        }
+    }
+
+    // A few culled placements cost less than another draw per style
+    LineBatch::merge_ranges(ranges, max_gap);
+    uint32_t gap = std::max<uint32_t>(max_gap, 1);
+    while (ranges.size() > std::max<size_t>(max_ranges, 1) && gap < std::numeric_limits<uint32_t>::max() / 4) {
+        gap *= 4;
+        LineBatch::merge_ranges(ranges, gap);
+    }
+    return ranges;
+}
+
+} // namespace qcs::cad
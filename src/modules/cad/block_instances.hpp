@@ -0,0 +1,83 @@
+/**
+ * @file block_instances.hpp
+ * @brief Per-block placement storage for instanced block rendering
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Dense placement slots, dirty range tracking and culled draw ranges
+ */
+
+#pragma once
+
+#include "line_batch.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace qcs::cad {
+
+// =============================================================================
+// Block Placements
+// =============================================================================
+
+/// One placement of a block as the block line shader reads it; matches
+/// struct BlockPlacement there
+struct BlockPlacement {
+    std::array<float, 16> model{};  ///< Column-major, from block segments to positions relative to the batch origin
+    float distance_scale = 1.0f;    ///< Drawing units per block unit, for linetype patterns
+    std::array<float, 3> padding{};
+};
+static_assert(sizeof(BlockPlacement) == 80, "BlockPlacement must match the shader's layout");
+
+/// Placements of one block definition, kept between frames
+///
+/// Each reference owns one slot; slots stay dense, the last one moving into
+/// any slot freed, so the whole batch is drawable as one instanced range.
+/// Matrices are composed in double precision and stored in single precision
+/// relative to the origin, and every write is recorded so callers upload
+/// only the slots that changed.
+class BlockInstanceBatch {
+public:
+    using Range = LineBatch::Range;
+
+    explicit BlockInstanceBatch(const Point3D& origin = Point3D::Zero());
+
+    /// Places or moves the reference; model maps the block's segment
+    /// positions to world space
+    void set_instance(EntityID id, const Matrix4D& model);
+    bool remove_instance(EntityID id);
+    void clear();
+
+    bool contains(EntityID id) const { return slots_.count(id) != 0; }
+    size_t size() const { return placements_.size(); }
+    bool empty() const { return placements_.empty(); }
+
+    const Point3D& get_origin() const { return origin_; }
+    const std::vector<BlockPlacement>& get_placements() const { return placements_; }
+    /// The reference in each slot
+    const std::vector<EntityID>& get_ids() const { return ids_; }
+
+    bool has_dirty_ranges() const { return !dirty_.empty(); }
+    /// Slots written since the last call, sorted, with ranges closer than
+    /// max_gap slots merged
+    std::vector<Range> take_dirty_ranges(uint32_t max_gap = 32);
+
+    /// Ranges covering the given references' slots, sorted, for drawing.
+    /// Ranges closer than max_gap slots are merged, the gap widened until
+    /// there are at most max_ranges; references not in the batch are skipped.
+    std::vector<Range> get_draw_ranges(std::span<const EntityID> ids, uint32_t max_gap = 16,
+                                       size_t max_ranges = 64) const;
+
+private:
+    Point3D origin_;
+    std::vector<BlockPlacement> placements_;
+    std::vector<EntityID> ids_;
+    std::unordered_map<EntityID, uint32_t> slots_;
+    std::vector<Range> dirty_;
+};
+
+} // namespace qcs::cad
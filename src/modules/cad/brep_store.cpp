@@ -0,0 +1,579 @@
+/**
+ * @file brep_store.cpp
+ * @brief Implementation of the index-based half-edge B-rep store
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Twin pairing through edge keys, face removal, compaction and validation
+ */
+
+#include "brep_store.hpp"
+#include "3d_kernel.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace qcs::cad {
+
+namespace {
+
+/// Set on caller-supplied keys so they never collide with vertex-pair keys
+constexpr uint64_t EXPLICIT_KEY = 1ull << 63;
+
+uint64_t vertex_pair_key(VertexHandle a, VertexHandle b) {
+    const uint64_t low = std::min(a.index, b.index), high = std::max(a.index, b.index);
+    return (low << 32) | high;
+}
+
+/// Order of precedence when a solid has several problems at once
+int severity(ValidationState state) {
+    switch (state) {
+        case ValidationState::InvalidTopology: return 4;
+        case ValidationState::NonManifold: return 3;
+        case ValidationState::InvalidOrientation: return 2;
+        case ValidationState::OpenVolume: return 1;
+        default: return 0;
+    }
+}
+
+/// Renumbering of a record compact() discards
+constexpr uint32_t DROPPED = 0xFFFFFFFFu;
+
+template<typename Handle>
+Handle remap(Handle handle, const std::vector<uint32_t>& map) {
+    return handle ? Handle(map[handle.index]) : Handle();
+}
+
+} // namespace
+
+// =============================================================================
+// BRepStore Construction
+// =============================================================================
+
+VertexHandle BRepStore::add_vertex(const Point3D& position, Precision tolerance) {
+    vertices_.push_back({position, tolerance, {}});
+    return VertexHandle(static_cast<uint32_t>(vertices_.size() - 1));
+}
+
+SolidHandle BRepStore::add_solid() {
+    solids_.push_back({});
+    return SolidHandle(static_cast<uint32_t>(solids_.size() - 1));
+}
+
+ShellHandle BRepStore::add_shell(SolidHandle solid) {
+    const ShellHandle handle(static_cast<uint32_t>(shells_.size()));
+    shells_.push_back({});
+    shells_.back().solid = solid;
+    if (solid) {
+        // Appended, so the first shell added stays the outer one
+        SolidRecord& record = solids_[solid.index];
+        if (!record.first_shell) {
+            record.first_shell = handle;
+        } else {
+            ShellHandle last = record.first_shell;
+            while (shells_[last.index].next) {
+                last = shells_[last.index].next;
+            }
+            shells_[last.index].next = handle;
+        }
+        record.shell_count++;
+    }
+    return handle;
+}
+
+FaceHandle BRepStore::add_face(ShellHandle shell, std::span<const VertexHandle> boundary,
+                               std::span<const uint64_t> edge_keys, uint32_t surface) {
+    if (boundary.empty()) {
+        throw std::invalid_argument("BRepStore::add_face: empty boundary");
+    }
+
+    const FaceHandle handle(static_cast<uint32_t>(faces_.size()));
+    faces_.push_back({});
+    faces_.back().shell = shell;
+    faces_.back().surface = surface;
+    faces_[handle.index].outer = add_loop(handle, boundary, edge_keys);
+
+    ShellRecord& record = shells_[shell.index];
+    if (record.last_face) {
+        faces_[record.last_face.index].next = handle;
+    } else {
+        record.first_face = handle;
+    }
+    record.last_face = handle;
+    record.face_count++;
+    live_faces_++;
+    return handle;
+}
+
+LoopHandle BRepStore::add_hole(FaceHandle face, std::span<const VertexHandle> boundary,
+                               std::span<const uint64_t> edge_keys) {
+    if (boundary.empty()) {
+        throw std::invalid_argument("BRepStore::add_hole: empty boundary");
+    }
+
+    LoopHandle last = faces_[face.index].outer;
+    while (loops_[last.index].next) {
+        last = loops_[last.index].next;
+    }
+    const LoopHandle hole = add_loop(face, boundary, edge_keys);
+    loops_[last.index].next = hole;
+    return hole;
+}
+
+LoopHandle BRepStore::add_loop(FaceHandle face, std::span<const VertexHandle> boundary,
+                               std::span<const uint64_t> edge_keys) {
+    if (!edge_keys.empty() && edge_keys.size() != boundary.size()) {
+        throw std::invalid_argument("BRepStore: one edge key per boundary vertex expected");
+    }
+
+    const auto n = static_cast<uint32_t>(boundary.size());
+    const LoopHandle loop(static_cast<uint32_t>(loops_.size()));
+    const auto first = static_cast<uint32_t>(half_edges_.size());
+    loops_.push_back({HalfEdgeHandle(first), face, {}, n});
+
+    // Link the ring first, so pairing can see each half-edge's destination
+    for (uint32_t i = 0; i < n; ++i) {
+        HalfEdgeRecord record;
+        record.origin = boundary[i];
+        record.next = HalfEdgeHandle(first + (i + 1) % n);
+        record.prev = HalfEdgeHandle(first + (i + n - 1) % n);
+        record.loop = loop;
+        half_edges_.push_back(record);
+
+        VertexRecord& vertex = vertices_[boundary[i].index];
+        if (!vertex.outgoing || !is_alive(vertex.outgoing)) {
+            vertex.outgoing = HalfEdgeHandle(first + i);
+        }
+    }
+    for (uint32_t i = 0; i < n; ++i) {
+        const uint64_t key = edge_keys.empty() ? vertex_pair_key(boundary[i], boundary[(i + 1) % n])
+                                               : EXPLICIT_KEY | edge_keys[i];
+        attach_half_edge(HalfEdgeHandle(first + i), key);
+    }
+    live_half_edges_ += n;
+    return loop;
+}
+
+void BRepStore::attach_half_edge(HalfEdgeHandle handle, uint64_t key) {
+    auto [it, inserted] = edge_index_.try_emplace(key, EdgeHandle(static_cast<uint32_t>(edges_.size())));
+    half_edges_[handle.index].edge = it->second;
+    if (inserted) {
+        edges_.push_back({key, handle, 1});
+        live_edges_++;
+        return;
+    }
+
+    EdgeRecord& edge = edges_[it->second.index];
+    if (edge.uses++ == 0) {
+        // Revived after every face on it was removed
+        edge.half_edge = handle;
+        live_edges_++;
+        return;
+    }
+
+    // The second use pairs with the first if it runs the other way; anything
+    // else stays unpaired for validate() to report
+    HalfEdgeRecord& other = half_edges_[edge.half_edge.index];
+    if (edge.uses == 2 && !other.twin && other.origin == destination(handle)) {
+        other.twin = handle;
+        half_edges_[handle.index].twin = edge.half_edge;
+    }
+}
+
+// =============================================================================
+// BRepStore Editing
+// =============================================================================
+
+void BRepStore::remove_face(FaceHandle face) {
+    if (!is_alive(face)) {
+        return;
+    }
+
+    size_t removed = 0;
+    for_each_loop(face, [&](LoopHandle loop) {
+        for_each_half_edge(loop, [&](HalfEdgeHandle he) {
+            HalfEdgeRecord& record = half_edges_[he.index];
+            const HalfEdgeHandle twin = record.twin;
+            if (twin) {
+                half_edges_[twin.index].twin = {};
+            }
+
+            EdgeRecord& edge = edges_[record.edge.index];
+            if (--edge.uses == 0) {
+                edge.half_edge = {};
+                live_edges_--;
+            } else if (edge.half_edge == he) {
+                edge.half_edge = twin;
+                for (uint32_t i = 0; !edge.half_edge && i < half_edges_.size(); ++i) {
+                    const HalfEdgeRecord& candidate = half_edges_[i];
+                    if (candidate.edge == record.edge && candidate.loop && loops_[candidate.loop.index].face != face) {
+                        edge.half_edge = HalfEdgeHandle(i);
+                    }
+                }
+            }
+
+            // Hand the vertex over to the neighbour's half-edge leaving it
+            VertexRecord& vertex = vertices_[record.origin.index];
+            if (vertex.outgoing == he) {
+                vertex.outgoing = twin ? half_edges_[twin.index].next : HalfEdgeHandle();
+            }
+            record.twin = {};
+            removed++;
+        });
+    });
+
+    // Marked dead only now; the walks above still needed the links
+    for_each_loop(face, [&](LoopHandle loop) {
+        for_each_half_edge(loop, [&](HalfEdgeHandle he) { half_edges_[he.index].loop = {}; });
+        loops_[loop.index].face = {};
+    });
+    faces_[face.index].outer = {};
+
+    shells_[faces_[face.index].shell.index].face_count--;
+    live_faces_--;
+    live_half_edges_ -= removed;
+}
+
+void BRepStore::compact() {
+    auto renumber = [](size_t size, auto&& keep) {
+        std::vector<uint32_t> map(size, DROPPED);
+        uint32_t next = 0;
+        for (size_t i = 0; i < size; ++i) {
+            if (keep(i)) {
+                map[i] = next++;
+            }
+        }
+        return map;
+    };
+
+    const auto face_map = renumber(faces_.size(), [&](size_t i) { return faces_[i].outer.is_valid(); });
+    const auto loop_map = renumber(loops_.size(), [&](size_t i) { return loops_[i].face.is_valid(); });
+    const auto half_edge_map = renumber(half_edges_.size(), [&](size_t i) { return half_edges_[i].loop.is_valid(); });
+    const auto edge_map = renumber(edges_.size(), [&](size_t i) { return edges_[i].uses > 0; });
+
+    std::vector<bool> used(vertices_.size(), false);
+    for (const HalfEdgeRecord& record : half_edges_) {
+        if (record.loop) {
+            used[record.origin.index] = true;
+        }
+    }
+    const auto vertex_map = renumber(vertices_.size(), [&](size_t i) { return used[i]; });
+
+    // Shell face chains skip the dead faces, still in their original order
+    for (ShellRecord& shell : shells_) {
+        FaceHandle last;
+        FaceHandle face = shell.first_face;
+        shell.first_face = {};
+        while (face) {
+            const FaceHandle next = faces_[face.index].next;
+            if (faces_[face.index].outer) {
+                faces_[face.index].next = {};
+                if (last) {
+                    faces_[last.index].next = face;
+                } else {
+                    shell.first_face = face;
+                }
+                last = face;
+            }
+            face = next;
+        }
+        shell.first_face = remap(shell.first_face, face_map);
+        shell.last_face = remap(last, face_map);
+    }
+
+    auto compact_array = [](auto& records, const std::vector<uint32_t>& map, auto&& relink) {
+        size_t kept = 0;
+        for (size_t i = 0; i < records.size(); ++i) {
+            if (map[i] != DROPPED) {
+                relink(records[i]);
+                records[kept++] = records[i];
+            }
+        }
+        records.resize(kept);
+    };
+
+    compact_array(faces_, face_map, [&](FaceRecord& record) {
+        record.outer = remap(record.outer, loop_map);
+        record.next = remap(record.next, face_map);
+    });
+    compact_array(loops_, loop_map, [&](LoopRecord& record) {
+        record.first = remap(record.first, half_edge_map);
+        record.face = remap(record.face, face_map);
+        record.next = remap(record.next, loop_map);
+    });
+    compact_array(half_edges_, half_edge_map, [&](HalfEdgeRecord& record) {
+        record.origin = remap(record.origin, vertex_map);
+        record.twin = remap(record.twin, half_edge_map);
+        record.next = remap(record.next, half_edge_map);
+        record.prev = remap(record.prev, half_edge_map);
+        record.edge = remap(record.edge, edge_map);
+        record.loop = remap(record.loop, loop_map);
+    });
+    compact_array(edges_, edge_map, [&](EdgeRecord& record) {
+        record.half_edge = remap(record.half_edge, half_edge_map);
+    });
+    compact_array(vertices_, vertex_map, [](VertexRecord& record) { record.outgoing = {}; });
+
+    for (uint32_t i = 0; i < half_edges_.size(); ++i) {
+        HalfEdgeHandle& outgoing = vertices_[half_edges_[i].origin.index].outgoing;
+        if (!outgoing) {
+            outgoing = HalfEdgeHandle(i);
+        }
+    }
+
+    // Vertex-pair keys name the old vertex numbers
+    edge_index_.clear();
+    edge_index_.reserve(edges_.size());
+    for (uint32_t i = 0; i < edges_.size(); ++i) {
+        EdgeRecord& edge = edges_[i];
+        if (!(edge.key & EXPLICIT_KEY)) {
+            edge.key = vertex_pair_key(half_edges_[edge.half_edge.index].origin, destination(edge.half_edge));
+        }
+        edge_index_.emplace(edge.key, EdgeHandle(i));
+    }
+}
+
+void BRepStore::clear() {
+    vertices_.clear();
+    half_edges_.clear();
+    edges_.clear();
+    loops_.clear();
+    faces_.clear();
+    shells_.clear();
+    solids_.clear();
+    edge_index_.clear();
+    live_edges_ = 0;
+    live_half_edges_ = 0;
+    live_faces_ = 0;
+}
+
+void BRepStore::reserve(size_t vertices, size_t faces, size_t half_edges) {
+    vertices_.reserve(vertices);
+    faces_.reserve(faces);
+    loops_.reserve(faces);
+    half_edges_.reserve(half_edges);
+    edges_.reserve(half_edges / 2);
+    edge_index_.reserve(half_edges / 2);
+}
+
+// =============================================================================
+// BRepStore Import
+// =============================================================================
+
+SolidHandle BRepStore::import_solid(const Solid& solid) {
+    const SolidHandle handle = add_solid();
+    std::unordered_map<const Vertex*, VertexHandle> vertex_map;
+    std::vector<VertexHandle> boundary;
+    std::vector<uint64_t> keys;
+
+    auto vertex_of = [&](const std::shared_ptr<Vertex>& vertex) {
+        auto [it, inserted] = vertex_map.try_emplace(vertex.get());
+        if (inserted) {
+            it->second = add_vertex(vertex->get_position(), vertex->get_tolerance());
+        }
+        return it->second;
+    };
+
+    // Wires list their edges in order but each edge keeps its own direction,
+    // so a loop's vertices come from how consecutive edges meet
+    auto build_loop = [&](const std::shared_ptr<Wire>& wire, bool reversed) {
+        boundary.clear();
+        keys.clear();
+        if (!wire) {
+            return false;
+        }
+        const auto& edges = wire->get_edges();
+        const size_t n = edges.size();
+        for (size_t i = 0; i < n; ++i) {
+            const auto& edge = edges[i];
+            const auto& next = edges[(i + 1) % n];
+            if (!edge || !next || !edge->get_start_vertex() || !edge->get_end_vertex()) {
+                return false;
+            }
+            const auto end = edge->get_end_vertex();
+            const bool forward = n == 1 || end == next->get_start_vertex() || end == next->get_end_vertex();
+            boundary.push_back(vertex_of(forward ? edge->get_start_vertex() : end));
+            // Edge IDs are kernel-wide; the solid keeps another solid's
+            // faces from pairing with its own across a shared edge
+            keys.push_back((static_cast<uint64_t>(handle.index) << 40) ^ edge->get_id());
+        }
+
+        // Reversed, the edge from each vertex to the next is the one before
+        if (reversed && n > 1) {
+            std::reverse(boundary.begin(), boundary.end());
+            std::reverse(keys.begin(), keys.end());
+            std::rotate(keys.begin(), keys.begin() + 1, keys.end());
+        }
+        return n > 0;
+    };
+
+    auto import_shell = [&](const std::shared_ptr<Shell>& source) {
+        if (!source) {
+            return;
+        }
+        const ShellHandle shell = add_shell(handle);
+        for (const auto& face : source->get_faces()) {
+            if (!face) {
+                continue;
+            }
+            const bool reversed = !face->has_forward_orientation();
+            if (!build_loop(face->get_outer_boundary(), reversed)) {
+                continue;
+            }
+            const FaceHandle added = add_face(shell, boundary, keys);
+            faces_[added.index].forward = face->has_forward_orientation();
+            for (const auto& hole : face->get_inner_boundaries()) {
+                if (build_loop(hole, reversed)) {
+                    add_hole(added, boundary, keys);
+                }
+            }
+        }
+    };
+
+    import_shell(solid.get_outer_shell());
+    for (const auto& shell : solid.get_inner_shells()) {
+        import_shell(shell);
+    }
+    return handle;
+}
+
+// =============================================================================
+// BRepStore Queries
+// =============================================================================
+
+FaceHandle BRepStore::face_of(HalfEdgeHandle handle) const {
+    const LoopHandle loop = half_edges_[handle.index].loop;
+    return loop ? loops_[loop.index].face : FaceHandle();
+}
+
+std::pair<FaceHandle, FaceHandle> BRepStore::get_edge_faces(EdgeHandle edge) const {
+    const HalfEdgeHandle first = edges_[edge.index].half_edge;
+    if (!first) {
+        return {};
+    }
+    const HalfEdgeHandle twin = half_edges_[first.index].twin;
+    return {face_of(first), twin ? face_of(twin) : FaceHandle()};
+}
+
+ValidationState BRepStore::validate(SolidHandle solid) const {
+    ValidationState worst = ValidationState::Valid;
+    auto report = [&worst](ValidationState state) {
+        if (severity(state) > severity(worst)) {
+            worst = state;
+        }
+    };
+
+    for_each_shell(solid, [&](ShellHandle shell) {
+        for_each_face(shell, [&](FaceHandle face) {
+            if (faces_[face.index].shell != shell) {
+                report(ValidationState::InvalidTopology);
+            }
+            for_each_loop(face, [&](LoopHandle loop) {
+                const LoopRecord& record = loops_[loop.index];
+                if (record.face != face || record.size == 0) {
+                    report(ValidationState::InvalidTopology);
+                    return;
+                }
+
+                // The ring must come back to its start after exactly size steps
+                HalfEdgeHandle current = record.first;
+                for (uint32_t i = 0; i < record.size; ++i) {
+                    const HalfEdgeRecord& he = half_edges_[current.index];
+                    if (he.loop != loop || half_edges_[he.next.index].prev != current) {
+                        report(ValidationState::InvalidTopology);
+                        return;
+                    }
+                    current = he.next;
+                    if (current == record.first && i + 1 < record.size) {
+                        report(ValidationState::InvalidTopology);
+                        return;
+                    }
+                }
+                if (current != record.first) {
+                    report(ValidationState::InvalidTopology);
+                    return;
+                }
+
+                for_each_half_edge(loop, [&](HalfEdgeHandle handle) {
+                    const HalfEdgeRecord& he = half_edges_[handle.index];
+                    const EdgeRecord& edge = edges_[he.edge.index];
+                    if (edge.uses > 2) {
+                        report(ValidationState::NonManifold);
+                    }
+                    if (he.twin) {
+                        const HalfEdgeRecord& twin = half_edges_[he.twin.index];
+                        const FaceHandle twin_face = face_of(he.twin);
+                        if (twin.twin != handle || twin.edge != he.edge || twin.origin != destination(handle) ||
+                            !twin_face || faces_[twin_face.index].shell != shell) {
+                            report(ValidationState::InvalidTopology);
+                        }
+                    } else if (edge.uses == 2) {
+                        report(ValidationState::InvalidOrientation);
+                    } else if (edge.uses == 1) {
+                        report(ValidationState::OpenVolume);
+                    }
+                });
+            });
+        });
+    });
+    return worst;
+}
+
+size_t BRepStore::memory_usage() const {
+    // Each index entry is a node plus its share of the bucket array
+    const size_t index_bytes = edge_index_.size() * (sizeof(std::pair<const uint64_t, EdgeHandle>) + 2 * sizeof(void*)) +
+                               edge_index_.bucket_count() * sizeof(void*);
+    return sizeof(BRepStore) + vertices_.capacity() * sizeof(VertexRecord) +
+           half_edges_.capacity() * sizeof(HalfEdgeRecord) + edges_.capacity() * sizeof(EdgeRecord) +
+           loops_.capacity() * sizeof(LoopRecord) + faces_.capacity() * sizeof(FaceRecord) +
+           shells_.capacity() * sizeof(ShellRecord) + solids_.capacity() * sizeof(SolidRecord) + index_bytes;
+}
+
+// =============================================================================
+// Topology Views
+// =============================================================================
+
+std::vector<EdgeView> WireView::get_edges() const {
+    std::vector<EdgeView> edges;
+    edges.reserve(get_edge_count());
+    store_->for_each_half_edge(handle_, [&](HalfEdgeHandle he) {
+        edges.emplace_back(*store_, store_->half_edge(he).edge);
+    });
+    return edges;
+}
+
+std::vector<VertexView> WireView::get_vertices() const {
+    std::vector<VertexView> vertices;
+    vertices.reserve(get_edge_count());
+    store_->for_each_half_edge(handle_, [&](HalfEdgeHandle he) {
+        vertices.emplace_back(*store_, store_->half_edge(he).origin);
+    });
+    return vertices;
+}
+
+std::vector<WireView> FaceView::get_inner_boundaries() const {
+    std::vector<WireView> holes;
+    for (LoopHandle loop = store_->loop(store_->face(handle_).outer).next; loop; loop = store_->loop(loop).next) {
+        holes.emplace_back(*store_, loop);
+    }
+    return holes;
+}
+
+std::vector<FaceView> ShellView::get_faces() const {
+    std::vector<FaceView> faces;
+    faces.reserve(get_face_count());
+    store_->for_each_face(handle_, [&](FaceHandle face) { faces.emplace_back(*store_, face); });
+    return faces;
+}
+
+std::vector<ShellView> SolidView::get_inner_shells() const {
+    std::vector<ShellView> shells;
+    const ShellHandle outer = store_->solid(handle_).first_shell;
+    for (ShellHandle shell = outer ? store_->shell(outer).next : ShellHandle(); shell;
+         shell = store_->shell(shell).next) {
+        shells.emplace_back(*store_, shell);
+    }
+    return shells;
+}
+
+} // namespace qcs::cad
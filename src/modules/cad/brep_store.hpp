@@ -0,0 +1,387 @@
+/**
+ * @file brep_store.hpp
+ * @brief Compact, index-based half-edge B-rep topology storage
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Contiguous per-type topology arrays addressed by 32-bit handles
+ */
+
+#pragma once
+
+#include "cad_types.hpp"
+#include "cad_common.hpp"
+
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace qcs::cad {
+
+class Solid;
+
+/// Model validation states
+enum class ValidationState {
+    Valid,              ///< Model is geometrically valid
+    Warning,            ///< Minor issues that don't affect functionality
+    InvalidTopology,    ///< Topological inconsistency
+    InvalidGeometry,    ///< Geometric degeneracy
+    SelfIntersection,   ///< Self-intersecting geometry
+    NonManifold,        ///< Non-manifold topology
+    OpenVolume,         ///< Volume with openings
+    InvalidOrientation, ///< Inconsistent face orientations
+    Failed             ///< Validation failed to complete
+};
+
+// =============================================================================
+// Topology Handles
+// =============================================================================
+
+/// Index of a record in one of a BRepStore's arrays, typed by what it names.
+/// Handles stay valid until BRepStore::compact().
+template<typename Tag>
+struct TopologyHandle {
+    static constexpr uint32_t INVALID = 0xFFFFFFFFu;
+
+    uint32_t index = INVALID;
+
+    constexpr TopologyHandle() = default;
+    constexpr explicit TopologyHandle(uint32_t i) : index(i) {}
+
+    constexpr bool is_valid() const { return index != INVALID; }
+    constexpr explicit operator bool() const { return is_valid(); }
+    constexpr bool operator==(const TopologyHandle& other) const = default;
+};
+
+using VertexHandle = TopologyHandle<struct VertexTag>;
+using HalfEdgeHandle = TopologyHandle<struct HalfEdgeTag>;
+using EdgeHandle = TopologyHandle<struct EdgeTag>;
+using LoopHandle = TopologyHandle<struct LoopTag>;
+using FaceHandle = TopologyHandle<struct FaceTag>;
+using ShellHandle = TopologyHandle<struct ShellTag>;
+using SolidHandle = TopologyHandle<struct SolidTag>;
+
+// =============================================================================
+// Half-Edge Store
+// =============================================================================
+
+/// Arena of B-rep topology in contiguous per-type arrays
+///
+/// Each face boundary loop is a ring of half-edges; the two faces on either
+/// side of an edge hold its two opposite half-edges, which are each other's
+/// twins. Faces, loops and shells are chained through intrusive next links,
+/// so no entity owns a container. Copying a store deep-copies the model.
+///
+/// Faces added to a shell find their neighbours through edge keys. Without
+/// explicit keys, an edge is named by its two end vertices; callers whose
+/// vertex pairs can bound more than one edge (two arcs closing a circle)
+/// pass a key per boundary edge. Edges used by more than two half-edges,
+/// or twice in the same direction, are kept but reported by validate().
+class BRepStore {
+public:
+    static constexpr uint32_t NO_GEOMETRY = 0xFFFFFFFFu;
+
+    struct VertexRecord {
+        Point3D position;
+        Precision tolerance;
+        HalfEdgeHandle outgoing;   ///< Any half-edge leaving the vertex
+    };
+
+    struct HalfEdgeRecord {
+        VertexHandle origin;
+        HalfEdgeHandle twin;       ///< Invalid on an open boundary
+        HalfEdgeHandle next;
+        HalfEdgeHandle prev;
+        EdgeHandle edge;
+        LoopHandle loop;           ///< Invalid once the face is removed
+    };
+
+    struct EdgeRecord {
+        uint64_t key = 0;
+        HalfEdgeHandle half_edge;  ///< The first of its half-edges
+        uint32_t uses = 0;         ///< Half-edges on it: two on a closed manifold
+        uint32_t curve = NO_GEOMETRY;
+    };
+
+    struct LoopRecord {
+        HalfEdgeHandle first;
+        FaceHandle face;           ///< Invalid once the face is removed
+        LoopHandle next;           ///< Next loop of the face, holes after the outer one
+        uint32_t size = 0;
+    };
+
+    struct FaceRecord {
+        LoopHandle outer;          ///< Invalid once removed
+        ShellHandle shell;
+        FaceHandle next;
+        uint32_t surface = NO_GEOMETRY;
+        bool forward = true;
+    };
+
+    struct ShellRecord {
+        FaceHandle first_face;
+        FaceHandle last_face;
+        SolidHandle solid;
+        ShellHandle next;
+        uint32_t face_count = 0;
+    };
+
+    struct SolidRecord {
+        ShellHandle first_shell;   ///< The outer shell; cavities follow it
+        uint32_t shell_count = 0;
+    };
+
+    // Construction
+    VertexHandle add_vertex(const Point3D& position, Precision tolerance = GEOMETRIC_TOLERANCE);
+    SolidHandle add_solid();
+    ShellHandle add_shell(SolidHandle solid = {});
+
+    /// Adds a face bounded by the loop through the vertices, wound
+    /// counter-clockwise seen from outside the shell. edge_keys, if given,
+    /// names the edge from each vertex to the next.
+    FaceHandle add_face(ShellHandle shell, std::span<const VertexHandle> boundary,
+                        std::span<const uint64_t> edge_keys = {}, uint32_t surface = NO_GEOMETRY);
+    /// Adds a hole to a face, wound opposite to its outer loop
+    LoopHandle add_hole(FaceHandle face, std::span<const VertexHandle> boundary,
+                        std::span<const uint64_t> edge_keys = {});
+
+    void set_vertex_position(VertexHandle vertex, const Point3D& position) { vertices_[vertex.index].position = position; }
+    void set_edge_curve(EdgeHandle edge, uint32_t curve) { edges_[edge.index].curve = curve; }
+
+    /// Detaches a face from its neighbours, leaving their edges open. Its
+    /// records stay in place, marked dead, until compact().
+    void remove_face(FaceHandle face);
+
+    /// Drops dead records and vertices no face uses any more, and renumbers
+    /// the rest. Invalidates every handle held outside the store.
+    void compact();
+
+    void clear();
+    void reserve(size_t vertices, size_t faces, size_t half_edges);
+
+    /// Copies the faces of a shared-pointer solid, shells, holes and
+    /// orientation included, sharing vertices and edges as the source does
+    SolidHandle import_solid(const Solid& solid);
+
+    // Records
+    const VertexRecord& vertex(VertexHandle handle) const { return vertices_[handle.index]; }
+    const HalfEdgeRecord& half_edge(HalfEdgeHandle handle) const { return half_edges_[handle.index]; }
+    const EdgeRecord& edge(EdgeHandle handle) const { return edges_[handle.index]; }
+    const LoopRecord& loop(LoopHandle handle) const { return loops_[handle.index]; }
+    const FaceRecord& face(FaceHandle handle) const { return faces_[handle.index]; }
+    const ShellRecord& shell(ShellHandle handle) const { return shells_[handle.index]; }
+    const SolidRecord& solid(SolidHandle handle) const { return solids_[handle.index]; }
+
+    bool is_alive(FaceHandle handle) const { return faces_[handle.index].outer.is_valid(); }
+    bool is_alive(HalfEdgeHandle handle) const { return half_edges_[handle.index].loop.is_valid(); }
+
+    // Live entity counts
+    size_t get_vertex_count() const { return vertices_.size(); }
+    size_t get_edge_count() const { return live_edges_; }
+    size_t get_half_edge_count() const { return live_half_edges_; }
+    size_t get_face_count() const { return live_faces_; }
+    size_t get_shell_count() const { return shells_.size(); }
+    size_t get_solid_count() const { return solids_.size(); }
+
+    // Traversal
+    VertexHandle destination(HalfEdgeHandle handle) const { return half_edge(half_edge(handle).next).origin; }
+    FaceHandle face_of(HalfEdgeHandle handle) const;
+
+    template<typename Fn> void for_each_half_edge(LoopHandle loop, Fn&& fn) const;
+    template<typename Fn> void for_each_loop(FaceHandle face, Fn&& fn) const;
+    template<typename Fn> void for_each_face(ShellHandle shell, Fn&& fn) const;
+    template<typename Fn> void for_each_shell(SolidHandle solid, Fn&& fn) const;
+
+    /// Calls fn for each half-edge leaving the vertex, fanning around it
+    /// through twins across open edges too
+    template<typename Fn> void for_each_outgoing(VertexHandle vertex, Fn&& fn) const;
+
+    /// The faces either side of an edge; the second is invalid on an open edge
+    std::pair<FaceHandle, FaceHandle> get_edge_faces(EdgeHandle edge) const;
+
+    /// Checks loops close and link both ways, twins agree, and every edge
+    /// of the solid is shared by exactly two faces running it oppositely
+    ValidationState validate(SolidHandle solid) const;
+
+    size_t memory_usage() const;
+
+private:
+    std::vector<VertexRecord> vertices_;
+    std::vector<HalfEdgeRecord> half_edges_;
+    std::vector<EdgeRecord> edges_;
+    std::vector<LoopRecord> loops_;
+    std::vector<FaceRecord> faces_;
+    std::vector<ShellRecord> shells_;
+    std::vector<SolidRecord> solids_;
+    std::unordered_map<uint64_t, EdgeHandle> edge_index_;  // By key
+
+    size_t live_edges_ = 0;
+    size_t live_half_edges_ = 0;
+    size_t live_faces_ = 0;
+
+    LoopHandle add_loop(FaceHandle face, std::span<const VertexHandle> boundary, std::span<const uint64_t> edge_keys);
+    void attach_half_edge(HalfEdgeHandle handle, uint64_t key);
+};
+
+// =============================================================================
+// Topology Views
+// =============================================================================
+
+/// Read-only views over a BRepStore with the accessors of the shared-pointer
+/// topology classes. Two words each, cheap to pass by value.
+class VertexView {
+public:
+    VertexView(const BRepStore& store, VertexHandle handle) : store_(&store), handle_(handle) {}
+
+    VertexHandle get_handle() const { return handle_; }
+    const Point3D& get_position() const { return store_->vertex(handle_).position; }
+    Precision get_tolerance() const { return store_->vertex(handle_).tolerance; }
+
+private:
+    const BRepStore* store_;
+    VertexHandle handle_;
+};
+
+class EdgeView {
+public:
+    EdgeView(const BRepStore& store, EdgeHandle handle) : store_(&store), handle_(handle) {}
+
+    EdgeHandle get_handle() const { return handle_; }
+    VertexView get_start_vertex() const {
+        return {*store_, store_->half_edge(store_->edge(handle_).half_edge).origin};
+    }
+    VertexView get_end_vertex() const { return {*store_, store_->destination(store_->edge(handle_).half_edge)}; }
+    bool is_closed() const { return get_start_vertex().get_handle() == get_end_vertex().get_handle(); }
+    Precision length() const { return (get_end_vertex().get_position() - get_start_vertex().get_position()).norm(); }
+
+private:
+    const BRepStore* store_;
+    EdgeHandle handle_;
+};
+
+class WireView {
+public:
+    WireView(const BRepStore& store, LoopHandle handle) : store_(&store), handle_(handle) {}
+
+    LoopHandle get_handle() const { return handle_; }
+    size_t get_edge_count() const { return store_->loop(handle_).size; }
+    std::vector<EdgeView> get_edges() const;
+    std::vector<VertexView> get_vertices() const;
+    bool is_closed() const { return true; }
+
+private:
+    const BRepStore* store_;
+    LoopHandle handle_;
+};
+
+class FaceView {
+public:
+    FaceView(const BRepStore& store, FaceHandle handle) : store_(&store), handle_(handle) {}
+
+    FaceHandle get_handle() const { return handle_; }
+    WireView get_outer_boundary() const { return {*store_, store_->face(handle_).outer}; }
+    std::vector<WireView> get_inner_boundaries() const;
+    bool has_forward_orientation() const { return store_->face(handle_).forward; }
+
+private:
+    const BRepStore* store_;
+    FaceHandle handle_;
+};
+
+class ShellView {
+public:
+    ShellView(const BRepStore& store, ShellHandle handle) : store_(&store), handle_(handle) {}
+
+    ShellHandle get_handle() const { return handle_; }
+    std::vector<FaceView> get_faces() const;
+    size_t get_face_count() const { return store_->shell(handle_).face_count; }
+
+private:
+    const BRepStore* store_;
+    ShellHandle handle_;
+};
+
+class SolidView {
+public:
+    SolidView(const BRepStore& store, SolidHandle handle) : store_(&store), handle_(handle) {}
+
+    SolidHandle get_handle() const { return handle_; }
+    ShellView get_outer_shell() const { return {*store_, store_->solid(handle_).first_shell}; }
+    std::vector<ShellView> get_inner_shells() const;
+    bool is_valid_solid() const { return store_->validate(handle_) == ValidationState::Valid; }
+
+private:
+    const BRepStore* store_;
+    SolidHandle handle_;
+};
+
+// =============================================================================
+// Template Implementations
+// =============================================================================
+
+template<typename Fn>
+void BRepStore::for_each_half_edge(LoopHandle loop, Fn&& fn) const {
+    const HalfEdgeHandle first = loops_[loop.index].first;
+    HalfEdgeHandle current = first;
+    for (uint32_t i = 0; i < loops_[loop.index].size; ++i) {
+        fn(current);
+        current = half_edges_[current.index].next;
+    }
+}
+
+template<typename Fn>
+void BRepStore::for_each_loop(FaceHandle face, Fn&& fn) const {
+    for (LoopHandle loop = faces_[face.index].outer; loop; loop = loops_[loop.index].next) {
+        fn(loop);
+    }
+}
+
+template<typename Fn>
+void BRepStore::for_each_face(ShellHandle shell, Fn&& fn) const {
+    for (FaceHandle face = shells_[shell.index].first_face; face; face = faces_[face.index].next) {
+        if (is_alive(face)) {
+            fn(face);
+        }
+    }
+}
+
+template<typename Fn>
+void BRepStore::for_each_shell(SolidHandle solid, Fn&& fn) const {
+    for (ShellHandle shell = solids_[solid.index].first_shell; shell; shell = shells_[shell.index].next) {
+        fn(shell);
+    }
+}
+
+template<typename Fn>
+void BRepStore::for_each_outgoing(VertexHandle vertex, Fn&& fn) const {
+    const HalfEdgeHandle start = vertices_[vertex.index].outgoing;
+    if (!start || !is_alive(start)) {
+        return;
+    }
+
+    // Clockwise through twin-then-next until the fan closes or hits an open
+    // edge, then counter-clockwise from the start through prev-then-twin
+    HalfEdgeHandle current = start;
+    do {
+        fn(current);
+        const HalfEdgeHandle twin = half_edges_[current.index].twin;
+        if (!twin) {
+            break;
+        }
+        current = half_edges_[twin.index].next;
+        if (current == start) {
+            return;
+        }
+    } while (true);
+
+    current = half_edges_[half_edges_[start.index].prev.index].twin;
+    while (current && current != start) {
+        fn(current);
+        current = half_edges_[half_edges_[current.index].prev.index].twin;
+    }
+}
+
+} // namespace qcs::cad
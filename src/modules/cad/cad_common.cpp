@@ -546,23 +546,28 @@ DegeneracyType detect_degeneracy(const CubicBezier2D& curve) {
     return DegeneracyType::None;
 }
 
-#ifdef QCS_DEBUG_BUILD
 // =============================================================================
-// Performance Profiling (Debug Only)
+// Performance Profiling
 // =============================================================================
 
-GeometricTimer::GeometricTimer(const std::string& name) 
-    : start_time_(std::chrono::high_resolution_clock::now())
-    , operation_name_(name) {
+GeometricTimer::GeometricTimer(const QuantumCanvas::Core::Histogram& span, const char* name)
+    : span_(span)
+#ifdef QCS_DEBUG_BUILD
+    , start_time_(std::chrono::high_resolution_clock::now())
+    , operation_name_(name)
+#endif
+{
+    (void)name;
 }
 
 GeometricTimer::~GeometricTimer() {
+#ifdef QCS_DEBUG_BUILD
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time_);
     
     std::cout << "[GEOMETRY PROFILE] " << operation_name_ 
               << " took " << duration.count() << " μs" << std::endl;
-}
 #endif
+}
 
 } // namespace qcs::cad
\ No newline at end of file
@@ -11,9 +11,13 @@
 #pragma once
 
 #include "cad_types.hpp"
+#include "../../core/kernel/telemetry.hpp"
+#include "../../core/spatial/dynamic_bvh.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstddef>
 #include <functional>
 #include <limits>
 #include <type_traits>
@@ -248,6 +252,21 @@ bool is_degenerate(const BoundingBoxType& bbox);
 template<typename BoundingBoxType, typename VectorType>
 BoundingBoxType expand_bounding_box(const BoundingBoxType& bbox, const VectorType& margin);
 
+/// Reads BoundingBox3D for the shared bounding volume hierarchy
+struct BoxAxes {
+    using Scalar = Precision;
+
+    static Precision lower(const BoundingBox3D& box, size_t axis) { return box.min[axis]; }
+    static Precision upper(const BoundingBox3D& box, size_t axis) { return box.max[axis]; }
+    static BoundingBox3D make(const std::array<Precision, 3>& lower, const std::array<Precision, 3>& upper) {
+        return BoundingBox3D(Point3D(lower[0], lower[1], lower[2]), Point3D(upper[0], upper[1], upper[2]));
+    }
+};
+
+/// Bounding volume hierarchy over boxes, for entity culling and face pairing
+template<typename Key>
+using BoxHierarchy = QuantumCanvas::Core::DynamicBVH<3, BoundingBox3D, Key, BoxAxes>;
+
 // =============================================================================
 // Hash Functions for Geometric Types
 // =============================================================================
@@ -307,20 +326,27 @@ public:
 // Performance Profiling Helpers
 // =============================================================================
 
-#ifdef QCS_DEBUG_BUILD
 /// RAII timer for profiling geometric operations
+///
+/// Records the operation into its span, so it shows in telemetry snapshots
+/// and trace captures in every build; debug builds also print each timing.
 class GeometricTimer {
+    QuantumCanvas::Core::TraceSpan span_;
+#ifdef QCS_DEBUG_BUILD
     std::chrono::high_resolution_clock::time_point start_time_;
-    std::string operation_name_;
+    const char* operation_name_;
+#endif
     
 public:
-    explicit GeometricTimer(const std::string& name);
+    GeometricTimer(const QuantumCanvas::Core::Histogram& span, const char* name);
     ~GeometricTimer();
 };
 
-#define QCS_PROFILE_GEOMETRY(name) GeometricTimer timer(name)
-#else
-#define QCS_PROFILE_GEOMETRY(name)
-#endif
+/// Profiles the rest of the scope as span "cad.<name>"; name must be a literal
+#define QCS_PROFILE_GEOMETRY(name)                                                                 \
+    static const ::QuantumCanvas::Core::Histogram QCS_TRACE_CONCAT(qcs_geometry_span_, __LINE__) = \
+        ::QuantumCanvas::Core::Telemetry::instance().span("cad." name);                            \
+    const ::qcs::cad::GeometricTimer QCS_TRACE_CONCAT(qcs_geometry_timer_, __LINE__)(              \
+        QCS_TRACE_CONCAT(qcs_geometry_span_, __LINE__), name)
 
 } // namespace qcs::cad
\ No newline at end of file
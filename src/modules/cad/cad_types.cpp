@@ -10,8 +10,10 @@
 
 #include "cad_types.hpp"
 #include "cad_common.hpp"
+#include "nurbs_tessellator.hpp"
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
 namespace qcs::cad {
 
@@ -261,12 +263,10 @@ void CADEntity::remove_associated_entity(EntityID id) {
 }
 
 BoundingBox3D CADArc::calculate_bounds() const {
-    BoundingBox3D bbox;
-    
-    // Add start and end points
+    // Add start and end points; a default box would hold the origin
     Point3D start = start_point();
     Point3D end = end_point();
-    bbox.expand(start);
+    BoundingBox3D bbox(start, start);
     bbox.expand(end);
     
     // Check for extrema in the arc
@@ -286,6 +286,54 @@ BoundingBox3D CADArc::calculate_bounds() const {
     return bbox;
 }
 
+namespace {
+
+// Bounds of the box's corners through the transform
+void expand_transformed(BoundingBox3D& bounds, const BoundingBox3D& box, const Matrix4D& transform) {
+    for (int corner = 0; corner < 8; ++corner) {
+        const Point3D point((corner & 1) ? box.max.x() : box.min.x(), (corner & 2) ? box.max.y() : box.min.y(),
+                            (corner & 4) ? box.max.z() : box.min.z());
+        const Point3D placed = (transform * point.homogeneous()).hnormalized();
+        bounds.min = bounds.min.cwiseMin(placed);
+        bounds.max = bounds.max.cwiseMax(placed);
+    }
+}
+
+BoundingBox3D empty_bounds() {
+    return BoundingBox3D(Point3D::Constant(std::numeric_limits<Precision>::infinity()),
+                         Point3D::Constant(-std::numeric_limits<Precision>::infinity()));
+}
+
+} // namespace
+
+BoundingBox3D CADBlockDefinition::calculate_bounds() const {
+    BoundingBox3D bounds = empty_bounds();
+    for (const CADEntityPtr& entity : entities) {
+        if (entity) {
+            expand_transformed(bounds, entity->bounds, entity->transform);
+        }
+    }
+    return bounds.is_valid() ? bounds : BoundingBox3D(base_point, base_point);
+}
+
+Matrix4D CADBlockReference::get_block_transform() const {
+    Matrix4D block_transform = transform;
+    if (definition) {
+        block_transform.col(3).head<3>() -= transform.topLeftCorner<3, 3>() * definition->base_point;
+    }
+    return block_transform;
+}
+
+BoundingBox3D CADBlockReference::calculate_bounds() const {
+    if (!definition) {
+        const Point3D origin = transform.col(3).head<3>();
+        return BoundingBox3D(origin, origin);
+    }
+    BoundingBox3D bounds = empty_bounds();
+    expand_transformed(bounds, definition->bounds, get_block_transform());
+    return bounds;
+}
+
 Point3D CADArc::start_point() const {
     Vector3D u_axis = Vector3D::UnitX();
     Vector3D v_axis = normal.cross(u_axis).normalized();
@@ -391,40 +439,21 @@ std::string UnitConverter::unit_symbol(LengthUnit unit) {
 }
 
 // =============================================================================
-// NURBS Implementations (Basic)
+// NURBS Implementations
 // =============================================================================
 
 Point3D NURBSCurve::evaluate(Precision u) const {
-    // Basic NURBS evaluation - would need proper basis function implementation
-    // This is a simplified placeholder
-    if (control_points.empty()) return Point3D::Zero();
-    
-    // For now, simple linear interpolation as placeholder
-    size_t n = control_points.size();
-    if (n == 1) return control_points[0];
-    
-    Precision param = clamp(u, static_cast<Precision>(0), static_cast<Precision>(1));
-    Precision scaled_param = param * (n - 1);
-    size_t index = static_cast<size_t>(scaled_param);
-    Precision t = scaled_param - index;
-    
-    if (index >= n - 1) return control_points.back();
-    
-    return lerp(control_points[index], control_points[index + 1], t);
+    std::vector<Point3D> points;
+    evaluate_curve(*this, std::span<const Precision>(&u, 1), points);
+    return points[0];
 }
 
 Vector3D NURBSCurve::tangent(Precision u) const {
-    // Placeholder implementation - proper NURBS tangent calculation needed
-    if (control_points.size() < 2) return Vector3D::UnitX();
-    
-    size_t n = control_points.size();
-    Precision param = clamp(u, static_cast<Precision>(0), static_cast<Precision>(1));
-    Precision scaled_param = param * (n - 1);
-    size_t index = static_cast<size_t>(scaled_param);
-    
-    if (index >= n - 1) index = n - 2;
-    
-    return (control_points[index + 1] - control_points[index]).normalized();
+    std::vector<Point3D> points;
+    std::vector<Vector3D> tangents;
+    evaluate_curve(*this, std::span<const Precision>(&u, 1), points, &tangents);
+    const Precision length = tangents[0].norm();
+    return length > 0.0 ? Vector3D(tangents[0] / length) : Vector3D::UnitX();
 }
 
 BoundingBox3D NURBSCurve::bounds() const {
@@ -448,44 +477,15 @@ bool NURBSCurve::is_rational() const {
 }
 
 Point3D NURBSSurface::evaluate(Precision u, Precision v) const {
-    // Placeholder implementation for NURBS surface evaluation
-    if (control_points.empty() || control_points[0].empty()) {
-        return Point3D::Zero();
-    }
-    
-    // Simple bilinear interpolation as placeholder
-    size_t u_count = control_points.size();
-    size_t v_count = control_points[0].size();
-    
-    Precision u_param = clamp(u, static_cast<Precision>(0), static_cast<Precision>(1));
-    Precision v_param = clamp(v, static_cast<Precision>(0), static_cast<Precision>(1));
-    
-    Precision u_scaled = u_param * (u_count - 1);
-    Precision v_scaled = v_param * (v_count - 1);
-    
-    size_t u_index = static_cast<size_t>(u_scaled);
-    size_t v_index = static_cast<size_t>(v_scaled);
-    
-    Precision u_t = u_scaled - u_index;
-    Precision v_t = v_scaled - v_index;
-    
-    if (u_index >= u_count - 1) { u_index = u_count - 2; u_t = 1.0; }
-    if (v_index >= v_count - 1) { v_index = v_count - 2; v_t = 1.0; }
-    
-    Point3D p00 = control_points[u_index][v_index];
-    Point3D p01 = control_points[u_index][v_index + 1];
-    Point3D p10 = control_points[u_index + 1][v_index];
-    Point3D p11 = control_points[u_index + 1][v_index + 1];
-    
-    Point3D p0 = lerp(p00, p01, v_t);
-    Point3D p1 = lerp(p10, p11, v_t);
-    
-    return lerp(p0, p1, u_t);
+    SurfaceGrid grid;
+    evaluate_surface_grid(*this, std::span<const Precision>(&u, 1), std::span<const Precision>(&v, 1), grid);
+    return grid.points[0];
 }
 
 Vector3D NURBSSurface::normal(Precision u, Precision v) const {
-    // Placeholder - would need proper surface derivative calculation
-    return Vector3D::UnitZ();
+    SurfaceGrid grid;
+    evaluate_surface_grid(*this, std::span<const Precision>(&u, 1), std::span<const Precision>(&v, 1), grid);
+    return grid.normals[0].isZero(0.0) ? Vector3D::UnitZ() : grid.normals[0];
 }
 
 BoundingBox3D NURBSSurface::bounds() const {
@@ -271,6 +271,7 @@ public:
     BoundingBox3D bounds;
     bool visible;
     bool selectable;
+    uint64_t revision;  ///< Bumped by mark_modified(), so renderers re-upload only edited entities
     
     CADEntity(EntityID entity_id = INVALID_ENTITY_ID)
         : id(entity_id)
@@ -280,11 +281,14 @@ public:
         , transform(Matrix4D::Identity())
         , visible(true)
         , selectable(true)
+        , revision(0)
     {}
     
     virtual ~CADEntity() = default;
     virtual BoundingBox3D calculate_bounds() const = 0;
     virtual void update_bounds() { bounds = calculate_bounds(); }
+    /// Call after changing the entity's geometry or appearance
+    void mark_modified() { update_bounds(); ++revision; }
     virtual std::unique_ptr<CADEntity> clone() const = 0;
 };
 
@@ -327,10 +331,7 @@ public:
     }
     
     BoundingBox3D calculate_bounds() const override {
-        BoundingBox3D bbox;
-        bbox.expand(start);
-        bbox.expand(end);
-        return bbox;
+        return BoundingBox3D(start.cwiseMin(end), start.cwiseMax(end));
     }
     
     std::unique_ptr<CADEntity> clone() const override {
@@ -375,6 +376,52 @@ public:
 /// Collection of CAD entities
 using CADEntityCollection = std::vector<CADEntityPtr>;
 
+/// Shared contents of a block, drawn wherever a CADBlockReference places it
+///
+/// The entities are stored once, in block coordinates, however many
+/// references there are; renderers upload them once and instance them.
+struct CADBlockDefinition {
+    std::string name;
+    Point3D base_point = Point3D::Zero();  ///< Lands on the reference's insertion point
+    CADEntityCollection entities;
+    BoundingBox3D bounds;   ///< Of the entities, in block coordinates, as of mark_modified()
+    uint64_t revision = 0;  ///< Bumped by mark_modified(), so renderers rebuild the block
+
+    BoundingBox3D calculate_bounds() const;
+    /// Call after editing the entities, before placing new references
+    void mark_modified() { bounds = calculate_bounds(); ++revision; }
+};
+
+using CADBlockDefinitionPtr = std::shared_ptr<const CADBlockDefinition>;
+
+/// One placement of a block definition, with its attribute values
+///
+/// The reference's transform places the block's base point: a block point
+/// p lands at transform * (p - base_point).
+class CADBlockReference : public CADEntity {
+public:
+    CADBlockDefinitionPtr definition;
+    std::unordered_map<std::string, std::string> attributes;  ///< Values by tag
+    
+    CADBlockReference(CADBlockDefinitionPtr block, const Matrix4D& placement = Matrix4D::Identity(),
+                      EntityID id = INVALID_ENTITY_ID)
+        : CADEntity(id), definition(std::move(block)) {
+        transform = placement;
+        update_bounds();
+    }
+    
+    /// Where the block lands, in the reference's parent space. Unlike the
+    /// bounds of geometric entities, these already include the transform.
+    BoundingBox3D calculate_bounds() const override;
+    
+    std::unique_ptr<CADEntity> clone() const override {
+        return std::make_unique<CADBlockReference>(*this);
+    }
+    
+    /// Maps block coordinates to the reference's parent space
+    Matrix4D get_block_transform() const;
+};
+
 /// Entity lookup map
 using EntityMap = std::unordered_map<EntityID, CADEntityPtr>;
 
@@ -386,6 +433,7 @@ struct CADLayer {
     bool locked;
     bool printable;
     Precision line_weight;
+    std::string linetype;
     
     CADLayer(const std::string& layer_name = "Default")
         : name(layer_name)
@@ -394,6 +442,7 @@ struct CADLayer {
         , locked(false)
         , printable(true)
         , line_weight(0.25)
+        , linetype("Continuous")
     {}
 };
 
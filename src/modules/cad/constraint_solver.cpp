@@ -10,11 +10,14 @@
 
 #include "constraint_solver.hpp"
 #include "cad_common.hpp"
+#include "../../core/kernel/task_scheduler.hpp"
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <numeric>
 #include <sstream>
 #include <iomanip>
+#include <type_traits>
 
 namespace qcs::cad {
 
@@ -36,65 +39,78 @@ ConstraintVariable::ConstraintVariable(VariableID id, const std::string& name, P
 }
 
 void ConstraintVariable::set_value(Precision value) {
-    value_ = clamp_to_bounds(value);
+    (storage_ ? storage_->values[id_] : value_) = clamp_to_bounds(value);
 }
 
 void ConstraintVariable::set_bounds(Precision lower, Precision upper) {
-    lower_bound_ = lower;
-    upper_bound_ = std::max(upper, lower);
-    value_ = clamp_to_bounds(value_);
+    (storage_ ? storage_->lower_bounds[id_] : lower_bound_) = lower;
+    (storage_ ? storage_->upper_bounds[id_] : upper_bound_) = std::max(upper, lower);
+    set_value(get_value());
 }
 
 bool ConstraintVariable::is_in_bounds(Precision value) const {
-    return value >= lower_bound_ - tolerance_ && value <= upper_bound_ + tolerance_;
+    return value >= get_lower_bound() - tolerance_ && value <= get_upper_bound() + tolerance_;
 }
 
 bool ConstraintVariable::is_within_tolerance(Precision value) const {
-    return std::abs(value - value_) <= tolerance_;
+    return std::abs(value - get_value()) <= tolerance_;
 }
 
 Precision ConstraintVariable::clamp_to_bounds(Precision value) const {
-    return clamp(value, lower_bound_, upper_bound_);
+    return clamp(value, get_lower_bound(), get_upper_bound());
 }
 
 // =============================================================================
 // VariableManager Implementation
 // =============================================================================
 
-VariableManager::VariableManager() : next_id_(1) {}
+VariableManager::VariableManager()
+    : variables_(1)  // Slot 0 is INVALID_VARIABLE_ID
+    , storage_(std::make_unique<VariableStorage>())
+    , variable_count_(0)
+    , next_id_(1) {
+    storage_->values.resize(1, 0.0);
+    storage_->lower_bounds.resize(1, 0.0);
+    storage_->upper_bounds.resize(1, 0.0);
+    storage_->deltas.resize(1, 0.0);
+}
 
 VariableID VariableManager::create_variable(const std::string& name, Precision initial_value) {
     VariableID id = next_id_++;
     auto variable = std::make_unique<ConstraintVariable>(id, name, initial_value);
     
+    // The object's own fields seed its slot, which holds them from now on
+    storage_->values.push_back(variable->value_);
+    storage_->lower_bounds.push_back(variable->lower_bound_);
+    storage_->upper_bounds.push_back(variable->upper_bound_);
+    storage_->deltas.push_back(variable->delta_);
+    variable->storage_ = storage_.get();
+    
     name_to_id_[name] = id;
-    variables_[id] = std::move(variable);
+    variables_.push_back(std::move(variable));
+    variable_count_++;
     
     return id;
 }
 
 void VariableManager::remove_variable(VariableID id) {
-    auto it = variables_.find(id);
-    if (it != variables_.end()) {
-        name_to_id_.erase(it->second->get_name());
-        variables_.erase(it);
+    if (contains(id)) {
+        name_to_id_.erase(variables_[id]->get_name());
+        variables_[id].reset();
+        variable_count_--;
     }
 }
 
 void VariableManager::clear_variables() {
-    variables_.clear();
-    name_to_id_.clear();
-    next_id_ = 1;
+    *this = VariableManager();
 }
 
 ConstraintVariable* VariableManager::get_variable(VariableID id) {
-    auto it = variables_.find(id);
-    return it != variables_.end() ? it->second.get() : nullptr;
+    return contains(id) ? variables_[id].get() : nullptr;
 }
 
 const ConstraintVariable* VariableManager::get_variable(VariableID id) const {
-    auto it = variables_.find(id);
-    return it != variables_.end() ? it->second.get() : nullptr;
+    return contains(id) ? variables_[id].get() : nullptr;
 }
 
 ConstraintVariable* VariableManager::get_variable_by_name(const std::string& name) {
@@ -109,20 +125,22 @@ const ConstraintVariable* VariableManager::get_variable_by_name(const std::strin
 
 size_t VariableManager::get_active_variable_count() const {
     return std::count_if(variables_.begin(), variables_.end(),
-        [](const auto& pair) { return pair.second->is_active(); });
+        [](const auto& variable) { return variable && variable->is_active(); });
 }
 
 size_t VariableManager::get_free_variable_count() const {
     return std::count_if(variables_.begin(), variables_.end(),
-        [](const auto& pair) { return pair.second->is_active() && !pair.second->is_fixed(); });
+        [](const auto& variable) { return variable && variable->is_active() && !variable->is_fixed(); });
 }
 
 std::vector<VariableID> VariableManager::get_all_variable_ids() const {
     std::vector<VariableID> ids;
-    ids.reserve(variables_.size());
+    ids.reserve(variable_count_);
     
-    for (const auto& pair : variables_) {
-        ids.push_back(pair.first);
+    for (const auto& variable : variables_) {
+        if (variable) {
+            ids.push_back(variable->get_id());
+        }
     }
     
     return ids;
@@ -131,9 +149,9 @@ std::vector<VariableID> VariableManager::get_all_variable_ids() const {
 std::vector<VariableID> VariableManager::get_active_variable_ids() const {
     std::vector<VariableID> ids;
     
-    for (const auto& pair : variables_) {
-        if (pair.second->is_active()) {
-            ids.push_back(pair.first);
+    for (const auto& variable : variables_) {
+        if (variable && variable->is_active()) {
+            ids.push_back(variable->get_id());
         }
     }
     
@@ -141,14 +159,18 @@ std::vector<VariableID> VariableManager::get_active_variable_ids() const {
 }
 
 void VariableManager::set_all_initial_values() {
-    for (auto& pair : variables_) {
-        pair.second->set_initial_value(pair.second->get_value());
+    for (auto& variable : variables_) {
+        if (variable) {
+            variable->set_initial_value(variable->get_value());
+        }
     }
 }
 
 void VariableManager::restore_initial_values() {
-    for (auto& pair : variables_) {
-        pair.second->set_value(pair.second->get_initial_value());
+    for (auto& variable : variables_) {
+        if (variable) {
+            variable->set_value(variable->get_initial_value());
+        }
     }
 }
 
@@ -157,8 +179,7 @@ std::vector<Precision> VariableManager::get_variable_values(const std::vector<Va
     values.reserve(ids.size());
     
     for (VariableID id : ids) {
-        const auto* var = get_variable(id);
-        values.push_back(var ? var->get_value() : 0.0);
+        values.push_back(contains(id) ? get_value(id) : 0.0);
     }
     
     return values;
@@ -168,9 +189,8 @@ void VariableManager::set_variable_values(const std::vector<VariableID>& ids, co
     size_t count = std::min(ids.size(), values.size());
     
     for (size_t i = 0; i < count; ++i) {
-        auto* var = get_variable(ids[i]);
-        if (var) {
-            var->set_value(values[i]);
+        if (contains(ids[i])) {
+            set_value(ids[i], values[i]);
         }
     }
 }
@@ -179,10 +199,12 @@ void VariableManager::set_variable_values(const std::vector<VariableID>& ids, co
 // GeometricConstraint Implementation
 // =============================================================================
 
-GeometricConstraint::GeometricConstraint(size_t id, const std::string& name, ConstraintCategory category)
+GeometricConstraint::GeometricConstraint(size_t id, const std::string& name, ConstraintCategory category,
+                                         ConstraintKind kind)
     : id_(id)
     , name_(name)
     , category_(category)
+    , kind_(kind)
     , priority_(ConstraintPriority::Medium)
     , state_(ConstraintState::Inactive)
     , tolerance_(GEOMETRIC_TOLERANCE)
@@ -192,6 +214,22 @@ GeometricConstraint::GeometricConstraint(size_t id, const std::string& name, Con
     , max_error_(0.0) {
 }
 
+Precision GeometricConstraint::evaluate_error(const VariableManager& vars) const {
+    for (VariableID id : variables_) {
+        if (!vars.contains(id)) return 0.0;
+    }
+    return evaluate_error(vars.get_values());
+}
+
+std::vector<Precision> GeometricConstraint::evaluate_gradient(const VariableManager& vars) const {
+    std::vector<Precision> gradient(variables_.size(), 0.0);
+    for (VariableID id : variables_) {
+        if (!vars.contains(id)) return gradient;
+    }
+    evaluate_gradient(vars.get_values(), gradient);
+    return gradient;
+}
+
 bool GeometricConstraint::is_satisfied(const VariableManager& vars) const {
     return std::abs(evaluate_error(vars)) <= tolerance_;
 }
@@ -213,7 +251,7 @@ void GeometricConstraint::update_state(const VariableManager& vars) {
 
 DistanceConstraint::DistanceConstraint(size_t id, VariableID p1x, VariableID p1y, VariableID p2x, VariableID p2y,
                                      Precision distance)
-    : GeometricConstraint(id, "Distance", ConstraintCategory::Dimensional)
+    : GeometricConstraint(id, "Distance", ConstraintCategory::Dimensional, ConstraintKind::Distance)
     , point1_x_(p1x), point1_y_(p1y)
     , point2_x_(p2x), point2_y_(p2y)
     , target_distance_(distance) {
@@ -221,44 +259,29 @@ DistanceConstraint::DistanceConstraint(size_t id, VariableID p1x, VariableID p1y
     variables_ = {p1x, p1y, p2x, p2y};
 }
 
-Precision DistanceConstraint::evaluate_error(const VariableManager& vars) const {
-    const auto* p1x = vars.get_variable(point1_x_);
-    const auto* p1y = vars.get_variable(point1_y_);
-    const auto* p2x = vars.get_variable(point2_x_);
-    const auto* p2y = vars.get_variable(point2_y_);
-    
-    if (!p1x || !p1y || !p2x || !p2y) return 0.0;
-    
-    Precision dx = p2x->get_value() - p1x->get_value();
-    Precision dy = p2y->get_value() - p1y->get_value();
+Precision DistanceConstraint::evaluate_error(VariableValues values) const {
+    Precision dx = values[point2_x_] - values[point1_x_];
+    Precision dy = values[point2_y_] - values[point1_y_];
     Precision actual_distance = std::sqrt(dx * dx + dy * dy);
     
     return actual_distance - target_distance_;
 }
 
-std::vector<Precision> DistanceConstraint::evaluate_gradient(const VariableManager& vars) const {
-    const auto* p1x = vars.get_variable(point1_x_);
-    const auto* p1y = vars.get_variable(point1_y_);
-    const auto* p2x = vars.get_variable(point2_x_);
-    const auto* p2y = vars.get_variable(point2_y_);
-    
-    std::vector<Precision> gradient(4, 0.0);
-    
-    if (!p1x || !p1y || !p2x || !p2y) return gradient;
-    
-    Precision dx = p2x->get_value() - p1x->get_value();
-    Precision dy = p2y->get_value() - p1y->get_value();
+void DistanceConstraint::evaluate_gradient(VariableValues values, std::span<Precision> gradient) const {
+    Precision dx = values[point2_x_] - values[point1_x_];
+    Precision dy = values[point2_y_] - values[point1_y_];
     Precision distance = std::sqrt(dx * dx + dy * dy);
     
-    if (is_zero(distance)) return gradient;
+    if (is_zero(distance)) {
+        std::fill(gradient.begin(), gradient.begin() + 4, 0.0);
+        return;
+    }
     
     // Partial derivatives: d/dx(sqrt((x2-x1)² + (y2-y1)²))
     gradient[0] = -dx / distance;  // d/dp1x
     gradient[1] = -dy / distance;  // d/dp1y
     gradient[2] = dx / distance;   // d/dp2x
     gradient[3] = dy / distance;   // d/dp2y
-    
-    return gradient;
 }
 
 std::unique_ptr<GeometricConstraint> DistanceConstraint::clone() const {
@@ -272,23 +295,19 @@ std::string DistanceConstraint::get_description() const {
 }
 
 HorizontalConstraint::HorizontalConstraint(size_t id, VariableID p1y, VariableID p2y)
-    : GeometricConstraint(id, "Horizontal", ConstraintCategory::Geometric)
+    : GeometricConstraint(id, "Horizontal", ConstraintCategory::Geometric, ConstraintKind::Horizontal)
     , point1_y_(p1y), point2_y_(p2y) {
     
     variables_ = {p1y, p2y};
 }
 
-Precision HorizontalConstraint::evaluate_error(const VariableManager& vars) const {
-    const auto* p1y = vars.get_variable(point1_y_);
-    const auto* p2y = vars.get_variable(point2_y_);
-    
-    if (!p1y || !p2y) return 0.0;
-    
-    return p2y->get_value() - p1y->get_value();
+Precision HorizontalConstraint::evaluate_error(VariableValues values) const {
+    return values[point2_y_] - values[point1_y_];
 }
 
-std::vector<Precision> HorizontalConstraint::evaluate_gradient(const VariableManager& vars) const {
-    return {-1.0, 1.0}; // d/dp1y = -1, d/dp2y = 1
+void HorizontalConstraint::evaluate_gradient(VariableValues, std::span<Precision> gradient) const {
+    gradient[0] = -1.0;  // d/dp1y
+    gradient[1] = 1.0;   // d/dp2y
 }
 
 std::unique_ptr<GeometricConstraint> HorizontalConstraint::clone() const {
@@ -300,23 +319,19 @@ std::string HorizontalConstraint::get_description() const {
 }
 
 VerticalConstraint::VerticalConstraint(size_t id, VariableID p1x, VariableID p2x)
-    : GeometricConstraint(id, "Vertical", ConstraintCategory::Geometric)
+    : GeometricConstraint(id, "Vertical", ConstraintCategory::Geometric, ConstraintKind::Vertical)
     , point1_x_(p1x), point2_x_(p2x) {
     
     variables_ = {p1x, p2x};
 }
 
-Precision VerticalConstraint::evaluate_error(const VariableManager& vars) const {
-    const auto* p1x = vars.get_variable(point1_x_);
-    const auto* p2x = vars.get_variable(point2_x_);
-    
-    if (!p1x || !p2x) return 0.0;
-    
-    return p2x->get_value() - p1x->get_value();
+Precision VerticalConstraint::evaluate_error(VariableValues values) const {
+    return values[point2_x_] - values[point1_x_];
 }
 
-std::vector<Precision> VerticalConstraint::evaluate_gradient(const VariableManager& vars) const {
-    return {-1.0, 1.0}; // d/dp1x = -1, d/dp2x = 1
+void VerticalConstraint::evaluate_gradient(VariableValues, std::span<Precision> gradient) const {
+    gradient[0] = -1.0;  // d/dp1x
+    gradient[1] = 1.0;   // d/dp2x
 }
 
 std::unique_ptr<GeometricConstraint> VerticalConstraint::clone() const {
@@ -329,71 +344,39 @@ std::string VerticalConstraint::get_description() const {
 
 ParallelConstraint::ParallelConstraint(size_t id, VariableID l1sx, VariableID l1sy, VariableID l1ex, VariableID l1ey,
                                      VariableID l2sx, VariableID l2sy, VariableID l2ex, VariableID l2ey)
-    : GeometricConstraint(id, "Parallel", ConstraintCategory::Geometric)
+    : GeometricConstraint(id, "Parallel", ConstraintCategory::Geometric, ConstraintKind::Parallel)
     , line1_start_x_(l1sx), line1_start_y_(l1sy), line1_end_x_(l1ex), line1_end_y_(l1ey)
     , line2_start_x_(l2sx), line2_start_y_(l2sy), line2_end_x_(l2ex), line2_end_y_(l2ey) {
     
     variables_ = {l1sx, l1sy, l1ex, l1ey, l2sx, l2sy, l2ex, l2ey};
 }
 
-Precision ParallelConstraint::evaluate_error(const VariableManager& vars) const {
-    // Get all variables
-    const auto* l1sx = vars.get_variable(line1_start_x_);
-    const auto* l1sy = vars.get_variable(line1_start_y_);
-    const auto* l1ex = vars.get_variable(line1_end_x_);
-    const auto* l1ey = vars.get_variable(line1_end_y_);
-    const auto* l2sx = vars.get_variable(line2_start_x_);
-    const auto* l2sy = vars.get_variable(line2_start_y_);
-    const auto* l2ex = vars.get_variable(line2_end_x_);
-    const auto* l2ey = vars.get_variable(line2_end_y_);
-    
-    if (!l1sx || !l1sy || !l1ex || !l1ey || !l2sx || !l2sy || !l2ex || !l2ey) return 0.0;
-    
+Precision ParallelConstraint::evaluate_error(VariableValues values) const {
     // Calculate direction vectors
-    Precision dx1 = l1ex->get_value() - l1sx->get_value();
-    Precision dy1 = l1ey->get_value() - l1sy->get_value();
-    Precision dx2 = l2ex->get_value() - l2sx->get_value();
-    Precision dy2 = l2ey->get_value() - l2sy->get_value();
+    Precision dx1 = values[line1_end_x_] - values[line1_start_x_];
+    Precision dy1 = values[line1_end_y_] - values[line1_start_y_];
+    Precision dx2 = values[line2_end_x_] - values[line2_start_x_];
+    Precision dy2 = values[line2_end_y_] - values[line2_start_y_];
     
     // Cross product (should be zero for parallel lines)
     return dx1 * dy2 - dy1 * dx2;
 }
 
-std::vector<Precision> ParallelConstraint::evaluate_gradient(const VariableManager& vars) const {
-    const auto* l2sx = vars.get_variable(line2_start_x_);
-    const auto* l2sy = vars.get_variable(line2_start_y_);
-    const auto* l2ex = vars.get_variable(line2_end_x_);
-    const auto* l2ey = vars.get_variable(line2_end_y_);
-    
-    std::vector<Precision> gradient(8, 0.0);
-    
-    if (!l2sx || !l2sy || !l2ex || !l2ey) return gradient;
-    
-    Precision dx2 = l2ex->get_value() - l2sx->get_value();
-    Precision dy2 = l2ey->get_value() - l2sy->get_value();
+void ParallelConstraint::evaluate_gradient(VariableValues values, std::span<Precision> gradient) const {
+    Precision dx1 = values[line1_end_x_] - values[line1_start_x_];
+    Precision dy1 = values[line1_end_y_] - values[line1_start_y_];
+    Precision dx2 = values[line2_end_x_] - values[line2_start_x_];
+    Precision dy2 = values[line2_end_y_] - values[line2_start_y_];
     
     // Gradients for cross product dx1*dy2 - dy1*dx2
     gradient[0] = -dy2;  // d/dl1sx
     gradient[1] = dx2;   // d/dl1sy  
     gradient[2] = dy2;   // d/dl1ex
     gradient[3] = -dx2;  // d/dl1ey
-    
-    const auto* l1sx = vars.get_variable(line1_start_x_);
-    const auto* l1sy = vars.get_variable(line1_start_y_);
-    const auto* l1ex = vars.get_variable(line1_end_x_);
-    const auto* l1ey = vars.get_variable(line1_end_y_);
-    
-    if (l1sx && l1sy && l1ex && l1ey) {
-        Precision dx1 = l1ex->get_value() - l1sx->get_value();
-        Precision dy1 = l1ey->get_value() - l1sy->get_value();
-        
-        gradient[4] = dy1;   // d/dl2sx
-        gradient[5] = -dx1;  // d/dl2sy
-        gradient[6] = -dy1;  // d/dl2ex  
-        gradient[7] = dx1;   // d/dl2ey
-    }
-    
-    return gradient;
+    gradient[4] = dy1;   // d/dl2sx
+    gradient[5] = -dx1;  // d/dl2sy
+    gradient[6] = -dy1;  // d/dl2ex  
+    gradient[7] = dx1;   // d/dl2ey
 }
 
 std::unique_ptr<GeometricConstraint> ParallelConstraint::clone() const {
@@ -406,54 +389,29 @@ std::string ParallelConstraint::get_description() const {
 
 PerpendicularConstraint::PerpendicularConstraint(size_t id, VariableID l1sx, VariableID l1sy, VariableID l1ex, VariableID l1ey,
                                                VariableID l2sx, VariableID l2sy, VariableID l2ex, VariableID l2ey)
-    : GeometricConstraint(id, "Perpendicular", ConstraintCategory::Geometric)
+    : GeometricConstraint(id, "Perpendicular", ConstraintCategory::Geometric, ConstraintKind::Perpendicular)
     , line1_start_x_(l1sx), line1_start_y_(l1sy), line1_end_x_(l1ex), line1_end_y_(l1ey)
     , line2_start_x_(l2sx), line2_start_y_(l2sy), line2_end_x_(l2ex), line2_end_y_(l2ey) {
     
     variables_ = {l1sx, l1sy, l1ex, l1ey, l2sx, l2sy, l2ex, l2ey};
 }
 
-Precision PerpendicularConstraint::evaluate_error(const VariableManager& vars) const {
-    // Get all variables
-    const auto* l1sx = vars.get_variable(line1_start_x_);
-    const auto* l1sy = vars.get_variable(line1_start_y_);
-    const auto* l1ex = vars.get_variable(line1_end_x_);
-    const auto* l1ey = vars.get_variable(line1_end_y_);
-    const auto* l2sx = vars.get_variable(line2_start_x_);
-    const auto* l2sy = vars.get_variable(line2_start_y_);
-    const auto* l2ex = vars.get_variable(line2_end_x_);
-    const auto* l2ey = vars.get_variable(line2_end_y_);
-    
-    if (!l1sx || !l1sy || !l1ex || !l1ey || !l2sx || !l2sy || !l2ex || !l2ey) return 0.0;
-    
+Precision PerpendicularConstraint::evaluate_error(VariableValues values) const {
     // Calculate direction vectors
-    Precision dx1 = l1ex->get_value() - l1sx->get_value();
-    Precision dy1 = l1ey->get_value() - l1sy->get_value();
-    Precision dx2 = l2ex->get_value() - l2sx->get_value();
-    Precision dy2 = l2ey->get_value() - l2sy->get_value();
+    Precision dx1 = values[line1_end_x_] - values[line1_start_x_];
+    Precision dy1 = values[line1_end_y_] - values[line1_start_y_];
+    Precision dx2 = values[line2_end_x_] - values[line2_start_x_];
+    Precision dy2 = values[line2_end_y_] - values[line2_start_y_];
     
     // Dot product (should be zero for perpendicular lines)
     return dx1 * dx2 + dy1 * dy2;
 }
 
-std::vector<Precision> PerpendicularConstraint::evaluate_gradient(const VariableManager& vars) const {
-    const auto* l1sx = vars.get_variable(line1_start_x_);
-    const auto* l1sy = vars.get_variable(line1_start_y_);
-    const auto* l1ex = vars.get_variable(line1_end_x_);
-    const auto* l1ey = vars.get_variable(line1_end_y_);
-    const auto* l2sx = vars.get_variable(line2_start_x_);
-    const auto* l2sy = vars.get_variable(line2_start_y_);
-    const auto* l2ex = vars.get_variable(line2_end_x_);
-    const auto* l2ey = vars.get_variable(line2_end_y_);
-    
-    std::vector<Precision> gradient(8, 0.0);
-    
-    if (!l1sx || !l1sy || !l1ex || !l1ey || !l2sx || !l2sy || !l2ex || !l2ey) return gradient;
-    
-    Precision dx1 = l1ex->get_value() - l1sx->get_value();
-    Precision dy1 = l1ey->get_value() - l1sy->get_value();
-    Precision dx2 = l2ex->get_value() - l2sx->get_value();
-    Precision dy2 = l2ey->get_value() - l2sy->get_value();
+void PerpendicularConstraint::evaluate_gradient(VariableValues values, std::span<Precision> gradient) const {
+    Precision dx1 = values[line1_end_x_] - values[line1_start_x_];
+    Precision dy1 = values[line1_end_y_] - values[line1_start_y_];
+    Precision dx2 = values[line2_end_x_] - values[line2_start_x_];
+    Precision dy2 = values[line2_end_y_] - values[line2_start_y_];
     
     // Gradients for dot product dx1*dx2 + dy1*dy2
     gradient[0] = -dx2;  // d/dl1sx
@@ -464,8 +422,6 @@ std::vector<Precision> PerpendicularConstraint::evaluate_gradient(const Variable
     gradient[5] = -dy1;  // d/dl2sy
     gradient[6] = dx1;   // d/dl2ex
     gradient[7] = dy1;   // d/dl2ey
-    
-    return gradient;
 }
 
 std::unique_ptr<GeometricConstraint> PerpendicularConstraint::clone() const {
@@ -477,49 +433,34 @@ std::string PerpendicularConstraint::get_description() const {
 }
 
 CoincidentConstraint::CoincidentConstraint(size_t id, VariableID p1x, VariableID p1y, VariableID p2x, VariableID p2y)
-    : GeometricConstraint(id, "Coincident", ConstraintCategory::Geometric)
+    : GeometricConstraint(id, "Coincident", ConstraintCategory::Geometric, ConstraintKind::Coincident)
     , point1_x_(p1x), point1_y_(p1y)
     , point2_x_(p2x), point2_y_(p2y) {
     
     variables_ = {p1x, p1y, p2x, p2y};
 }
 
-Precision CoincidentConstraint::evaluate_error(const VariableManager& vars) const {
-    const auto* p1x = vars.get_variable(point1_x_);
-    const auto* p1y = vars.get_variable(point1_y_);
-    const auto* p2x = vars.get_variable(point2_x_);
-    const auto* p2y = vars.get_variable(point2_y_);
-    
-    if (!p1x || !p1y || !p2x || !p2y) return 0.0;
-    
+Precision CoincidentConstraint::evaluate_error(VariableValues values) const {
     // Distance between points (should be zero)
-    Precision dx = p2x->get_value() - p1x->get_value();
-    Precision dy = p2y->get_value() - p1y->get_value();
+    Precision dx = values[point2_x_] - values[point1_x_];
+    Precision dy = values[point2_y_] - values[point1_y_];
     return std::sqrt(dx * dx + dy * dy);
 }
 
-std::vector<Precision> CoincidentConstraint::evaluate_gradient(const VariableManager& vars) const {
-    const auto* p1x = vars.get_variable(point1_x_);
-    const auto* p1y = vars.get_variable(point1_y_);
-    const auto* p2x = vars.get_variable(point2_x_);
-    const auto* p2y = vars.get_variable(point2_y_);
-    
-    std::vector<Precision> gradient(4, 0.0);
-    
-    if (!p1x || !p1y || !p2x || !p2y) return gradient;
-    
-    Precision dx = p2x->get_value() - p1x->get_value();
-    Precision dy = p2y->get_value() - p1y->get_value();
+void CoincidentConstraint::evaluate_gradient(VariableValues values, std::span<Precision> gradient) const {
+    Precision dx = values[point2_x_] - values[point1_x_];
+    Precision dy = values[point2_y_] - values[point1_y_];
     Precision distance = std::sqrt(dx * dx + dy * dy);
     
-    if (is_zero(distance)) return gradient;
+    if (is_zero(distance)) {
+        std::fill(gradient.begin(), gradient.begin() + 4, 0.0);
+        return;
+    }
     
     gradient[0] = -dx / distance;  // d/dp1x
     gradient[1] = -dy / distance;  // d/dp1y
     gradient[2] = dx / distance;   // d/dp2x
     gradient[3] = dy / distance;   // d/dp2y
-    
-    return gradient;
 }
 
 std::unique_ptr<GeometricConstraint> CoincidentConstraint::clone() const {
@@ -530,4 +471,948 @@ std::string CoincidentConstraint::get_description() const {
     return "Coincident constraint: points are at same location";
 }
 
-} // namespace qcs::cad
\ No newline at end of file
+// =============================================================================
+// ConstraintEvaluator Implementation
+// =============================================================================
+
+namespace {
+/// Calls fn with a null pointer to the kind's class, so it can evaluate a
+/// batch through the final class without virtual calls. Kinds without a
+/// kernel here get the base class and dispatch virtually.
+template <typename Fn>
+void with_constraint_class(ConstraintKind kind, Fn&& fn) {
+    switch (kind) {
+        case ConstraintKind::Distance: fn(static_cast<const DistanceConstraint*>(nullptr)); break;
+        case ConstraintKind::Horizontal: fn(static_cast<const HorizontalConstraint*>(nullptr)); break;
+        case ConstraintKind::Vertical: fn(static_cast<const VerticalConstraint*>(nullptr)); break;
+        case ConstraintKind::Parallel: fn(static_cast<const ParallelConstraint*>(nullptr)); break;
+        case ConstraintKind::Perpendicular: fn(static_cast<const PerpendicularConstraint*>(nullptr)); break;
+        case ConstraintKind::Coincident: fn(static_cast<const CoincidentConstraint*>(nullptr)); break;
+        default: fn(static_cast<const GeometricConstraint*>(nullptr)); break;
+    }
+}
+}
+
+void ConstraintEvaluator::prepare(const std::vector<const GeometricConstraint*>& constraints) {
+    batches_.clear();
+    rows_ = constraints;
+    gradient_offsets_.assign(1, 0);
+    gradient_offsets_.reserve(constraints.size() + 1);
+
+    std::array<int, static_cast<size_t>(ConstraintKind::Custom) + 1> batch_of_kind;
+    batch_of_kind.fill(-1);
+    for (size_t row = 0; row < constraints.size(); ++row) {
+        const GeometricConstraint* constraint = constraints[row];
+        int& batch = batch_of_kind[static_cast<size_t>(constraint->get_kind())];
+        if (batch < 0) {
+            batch = static_cast<int>(batches_.size());
+            batches_.push_back({constraint->get_kind(), {}, {}});
+        }
+        batches_[batch].rows.push_back(static_cast<uint32_t>(row));
+        batches_[batch].constraints.push_back(constraint);
+        gradient_offsets_.push_back(gradient_offsets_.back() + constraint->get_variables().size());
+    }
+    residuals_.assign(constraints.size(), 0.0);
+    gradients_.assign(gradient_offsets_.back(), 0.0);
+}
+
+void ConstraintEvaluator::evaluate_residuals(VariableValues values) {
+    for (const Batch& batch : batches_) {
+        with_constraint_class(batch.kind, [&](auto* type) {
+            using Constraint = std::remove_const_t<std::remove_pointer_t<decltype(type)>>;
+            for (size_t k = 0; k < batch.rows.size(); ++k) {
+                const auto& constraint = static_cast<const Constraint&>(*batch.constraints[k]);
+                residuals_[batch.rows[k]] = constraint.evaluate_error(values);
+            }
+        });
+    }
+}
+
+void ConstraintEvaluator::evaluate_gradients(VariableValues values) {
+    for (const Batch& batch : batches_) {
+        with_constraint_class(batch.kind, [&](auto* type) {
+            using Constraint = std::remove_const_t<std::remove_pointer_t<decltype(type)>>;
+            for (size_t k = 0; k < batch.rows.size(); ++k) {
+                const auto& constraint = static_cast<const Constraint&>(*batch.constraints[k]);
+                const uint32_t row = batch.rows[k];
+                constraint.evaluate_gradient(values, std::span<Precision>(
+                    gradients_.data() + gradient_offsets_[row], gradient_offsets_[row + 1] - gradient_offsets_[row]));
+            }
+        });
+    }
+}
+
+// =============================================================================
+// ConstraintSystem Implementation
+// =============================================================================
+
+ConstraintSystem::ConstraintSystem()
+    : next_constraint_id_(1)
+    , is_solved_(false)
+    , last_solve_status_(SolverStatus::NotStarted)
+    , degrees_of_freedom_(0)
+    , max_iterations_(100)
+    , convergence_tolerance_(1e-10)
+    , step_size_(1.0)
+    , enable_line_search_(false)
+    , enable_trust_region_(false) {
+}
+
+ConstraintSystem::~ConstraintSystem() = default;
+
+size_t ConstraintSystem::add_constraint(std::unique_ptr<GeometricConstraint> constraint) {
+    if (!constraint) {
+        return std::numeric_limits<size_t>::max();
+    }
+
+    const size_t id = constraint->get_id();
+    next_constraint_id_ = std::max(next_constraint_id_, id + 1);
+    for (VariableID variable : constraint->get_variables()) {
+        if (auto* var = variable_manager_.get_variable(variable)) {
+            var->add_constraint_ref(id);
+        }
+    }
+
+    constraint_id_to_index_[id] = constraints_.size();
+    constraints_.push_back(std::move(constraint));
+    graph_dirty_ = true;
+    is_solved_ = false;
+    return id;
+}
+
+void ConstraintSystem::remove_constraint(size_t constraint_id) {
+    auto it = constraint_id_to_index_.find(constraint_id);
+    if (it == constraint_id_to_index_.end()) {
+        return;
+    }
+
+    const size_t index = it->second;
+    for (VariableID variable : constraints_[index]->get_variables()) {
+        if (auto* var = variable_manager_.get_variable(variable)) {
+            var->remove_constraint_ref(constraint_id);
+        }
+    }
+    constraints_.erase(constraints_.begin() + static_cast<std::ptrdiff_t>(index));
+    constraint_id_to_index_.erase(it);
+    for (size_t i = index; i < constraints_.size(); ++i) {
+        constraint_id_to_index_[constraints_[i]->get_id()] = i;
+    }
+    graph_dirty_ = true;
+    is_solved_ = false;
+}
+
+void ConstraintSystem::clear_constraints() {
+    for (const auto& constraint : constraints_) {
+        for (VariableID variable : constraint->get_variables()) {
+            if (auto* var = variable_manager_.get_variable(variable)) {
+                var->remove_constraint_ref(constraint->get_id());
+            }
+        }
+    }
+    constraints_.clear();
+    constraint_id_to_index_.clear();
+    graph_dirty_ = true;
+    is_solved_ = false;
+}
+
+GeometricConstraint* ConstraintSystem::get_constraint(size_t constraint_id) {
+    auto it = constraint_id_to_index_.find(constraint_id);
+    return it != constraint_id_to_index_.end() ? constraints_[it->second].get() : nullptr;
+}
+
+const GeometricConstraint* ConstraintSystem::get_constraint(size_t constraint_id) const {
+    auto it = constraint_id_to_index_.find(constraint_id);
+    return it != constraint_id_to_index_.end() ? constraints_[it->second].get() : nullptr;
+}
+
+void ConstraintSystem::set_solver_settings(int max_iter, Precision tolerance, Precision step) {
+    max_iterations_ = max_iter;
+    convergence_tolerance_ = tolerance;
+    step_size_ = step;
+}
+
+// =============================================================================
+// ConstraintSystem Matrix Assembly
+// =============================================================================
+
+namespace {
+/// Constraints per scheduler chunk; evaluations are cheap, so batch them
+constexpr size_t CONSTRAINT_BATCH_SIZE = 64;
+
+/// A chord step reusing an older factorisation must cut the error at least
+/// this much, or the following iteration refactors
+constexpr Precision CHORD_CONTRACTION = 0.1;
+
+/// Backtracking past this step fraction means the sketch sits at a least
+/// squares minimum the held values cannot improve on
+constexpr Precision MIN_STEP_SCALE = 1.0 / 1024.0;
+
+/// Column of each VariableID, -1 for those that are not columns
+using ColumnIndex = std::vector<int>;
+using JacobianRow = std::vector<std::pair<int, Precision>>;
+
+void make_column_index(const std::vector<VariableID>& columns, size_t id_limit, ColumnIndex& index) {
+    index.assign(id_limit, -1);
+    for (size_t col = 0; col < columns.size(); ++col) {
+        index[columns[col]] = static_cast<int>(col);
+    }
+}
+
+/// A subsystem's columns in a per-thread index over all IDs, cleared again
+/// on leaving scope, so a small block pays for its own columns only
+class ScopedColumnIndex {
+public:
+    ScopedColumnIndex(const std::vector<VariableID>& columns, size_t id_limit) : columns_(columns) {
+        ColumnIndex& index = storage();
+        if (index.size() < id_limit) {
+            index.resize(id_limit, -1);
+        }
+        for (size_t col = 0; col < columns.size(); ++col) {
+            index[columns[col]] = static_cast<int>(col);
+        }
+    }
+    ~ScopedColumnIndex() {
+        ColumnIndex& index = storage();
+        for (VariableID id : columns_) {
+            index[id] = -1;
+        }
+    }
+    const ColumnIndex& get() const { return storage(); }
+
+private:
+    static ColumnIndex& storage() {
+        thread_local ColumnIndex index;
+        return index;
+    }
+    const std::vector<VariableID>& columns_;
+};
+
+/// Every column the constraint names, zero gradients included, so the
+/// pattern stays the same from one iteration to the next. The gradient
+/// lines up with the constraint's variable list.
+void assemble_jacobian_row(const std::vector<VariableID>& variables, std::span<const Precision> gradient,
+                           const ColumnIndex& columns, JacobianRow& entries) {
+    entries.clear();
+
+    const size_t count = std::min(gradient.size(), variables.size());
+    for (size_t k = 0; k < count; ++k) {
+        const int col = variables[k] < columns.size() ? columns[variables[k]] : -1;
+        if (col >= 0) {
+            entries.emplace_back(col, gradient[k]);
+        }
+    }
+
+    // A variable named twice contributes once, summed
+    std::sort(entries.begin(), entries.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    size_t merged = 0;
+    for (size_t k = 0; k < entries.size(); ++k) {
+        if (merged > 0 && entries[merged - 1].first == entries[k].first) {
+            entries[merged - 1].second += entries[k].second;
+        } else {
+            entries[merged++] = entries[k];
+        }
+    }
+    entries.resize(merged);
+}
+
+void pack_jacobian(const std::vector<JacobianRow>& rows, size_t cols, JacobianMatrix& jacobian) {
+    jacobian.resize(static_cast<Eigen::Index>(rows.size()), static_cast<Eigen::Index>(cols));
+    size_t nonzeros = 0;
+    for (const auto& entries : rows) {
+        nonzeros += entries.size();
+    }
+    jacobian.resizeNonZeros(static_cast<Eigen::Index>(nonzeros));
+
+    auto* outer = jacobian.outerIndexPtr();
+    auto* inner = jacobian.innerIndexPtr();
+    Precision* values = jacobian.valuePtr();
+    outer[0] = 0;
+    for (size_t row = 0; row < rows.size(); ++row) {
+        auto offset = outer[row];
+        for (const auto& [col, value] : rows[row]) {
+            inner[offset] = col;
+            values[offset] = value;
+            ++offset;
+        }
+        outer[row + 1] = offset;
+    }
+}
+
+Precision residual_norm(const std::vector<Precision>& residuals) {
+    return std::sqrt(std::inner_product(residuals.begin(), residuals.end(), residuals.begin(), Precision(0)));
+}
+
+/// The worst of several clusters' results decides the system's
+SolverStatus worst_status(const std::vector<SolverStatus>& statuses) {
+    auto severity = [](SolverStatus status) {
+        switch (status) {
+            case SolverStatus::Success:
+            case SolverStatus::Converged: return 0;
+            case SolverStatus::NoProgress: return 1;
+            case SolverStatus::MaxIterations: return 2;
+            case SolverStatus::Overconstrained: return 3;
+            case SolverStatus::Diverging: return 4;
+            default: return 5;
+        }
+    };
+    SolverStatus worst = SolverStatus::Converged;
+    for (SolverStatus status : statuses) {
+        if (severity(status) > severity(worst)) {
+            worst = status;
+        }
+    }
+    return worst;
+}
+}
+
+bool ConstraintSystem::solve_least_squares(LinearSolverCache& cache, const JacobianMatrix& A,
+                                           const std::vector<Precision>& b, std::vector<Precision>& x) {
+    x.assign(static_cast<size_t>(A.cols()), 0.0);
+    if (A.rows() == 0 || A.cols() == 0) {
+        return true;
+    }
+    if (static_cast<Eigen::Index>(b.size()) != A.rows() || !factorize_least_squares(cache, A)) {
+        return false;
+    }
+    if (solve_factorized(cache, b, x)) {
+        return true;
+    }
+    if (cache.use_qr) {
+        return false;
+    }
+
+    // Ill-conditioned beyond what the damping absorbs: factor J itself
+    cache.qr.compute(cache.jacobian);
+    if (cache.qr.info() != Eigen::Success) {
+        return false;
+    }
+    cache.use_qr = true;
+    return solve_factorized(cache, b, x);
+}
+
+bool ConstraintSystem::factorize_least_squares(LinearSolverCache& cache, const JacobianMatrix& A) {
+    using SparseMatrix = Eigen::SparseMatrix<Precision>;
+
+    // Normal equations on the smaller side: J^T J x = J^T b when there are
+    // more constraints than variables, else J J^T y = b with x = J^T y for
+    // the least-norm step of an underconstrained sketch. A slight damping
+    // keeps redundant constraints from making the matrix singular.
+    cache.jacobian = A;
+    cache.tall = A.rows() >= A.cols();
+    cache.use_qr = false;
+    const SparseMatrix& J = cache.jacobian;
+    if (cache.tall) {
+        cache.normal = SparseMatrix(J.transpose()) * J;
+    } else {
+        cache.normal = J * SparseMatrix(J.transpose());
+    }
+    Precision max_diagonal = 1.0;
+    for (Eigen::Index i = 0; i < cache.normal.rows(); ++i) {
+        max_diagonal = std::max(max_diagonal, std::abs(cache.normal.coeff(i, i)));
+    }
+    SparseMatrix damping(cache.normal.rows(), cache.normal.cols());
+    damping.setIdentity();
+    cache.normal += damping * (max_diagonal * 1e-12);
+    cache.normal.makeCompressed();
+
+    const auto nonzeros = cache.normal.nonZeros();
+    const auto outer_size = cache.normal.outerSize() + 1;
+    const bool same_pattern = cache.analyzed &&
+        static_cast<Eigen::Index>(cache.outer.size()) == outer_size &&
+        static_cast<Eigen::Index>(cache.inner.size()) == nonzeros &&
+        std::equal(cache.outer.begin(), cache.outer.end(), cache.normal.outerIndexPtr()) &&
+        std::equal(cache.inner.begin(), cache.inner.end(), cache.normal.innerIndexPtr());
+    if (!same_pattern) {
+        cache.cholesky.analyzePattern(cache.normal);
+        cache.outer.assign(cache.normal.outerIndexPtr(), cache.normal.outerIndexPtr() + outer_size);
+        cache.inner.assign(cache.normal.innerIndexPtr(), cache.normal.innerIndexPtr() + nonzeros);
+        cache.analyzed = true;
+        symbolic_factorizations_.fetch_add(1, std::memory_order_relaxed);
+    }
+    cache.cholesky.factorize(cache.normal);
+    numeric_factorizations_.fetch_add(1, std::memory_order_relaxed);
+    if (cache.cholesky.info() == Eigen::Success) {
+        return true;
+    }
+
+    cache.qr.compute(J);
+    cache.use_qr = cache.qr.info() == Eigen::Success;
+    return cache.use_qr;
+}
+
+bool ConstraintSystem::solve_factorized(LinearSolverCache& cache, const std::vector<Precision>& b,
+                                        std::vector<Precision>& x) {
+    using Vector = Eigen::Matrix<Precision, Eigen::Dynamic, 1>;
+
+    const Eigen::Index rows = cache.jacobian.rows();
+    const Eigen::Index cols = cache.jacobian.cols();
+    x.assign(static_cast<size_t>(cols), 0.0);
+    if (rows == 0 || cols == 0) {
+        return true;
+    }
+    if (static_cast<Eigen::Index>(b.size()) != rows) {
+        return false;
+    }
+
+    const Eigen::Map<const Vector> rhs(b.data(), rows);
+    Eigen::Map<Vector> solution(x.data(), cols);
+    if (cache.use_qr) {
+        solution = cache.qr.solve(rhs);
+    } else if (cache.tall) {
+        solution = cache.cholesky.solve(cache.jacobian.transpose() * rhs);
+    } else {
+        solution = cache.jacobian.transpose() * cache.cholesky.solve(rhs);
+    }
+    if (!solution.allFinite()) {
+        solution.setZero();
+        return false;
+    }
+    return true;
+}
+
+// =============================================================================
+// ConstraintSystem Solving
+// =============================================================================
+
+void ConstraintSystem::prepare_evaluator(const std::vector<size_t>& constraints,
+                                         ConstraintEvaluator& evaluator) const {
+    std::vector<const GeometricConstraint*> rows;
+    rows.reserve(constraints.size());
+    for (size_t index : constraints) {
+        rows.push_back(constraints_[index].get());
+    }
+    evaluator.prepare(rows);
+}
+
+SolverStatus ConstraintSystem::solve_subsystem(ConstraintEvaluator& evaluator,
+                                               const std::vector<VariableID>& variables,
+                                               LinearSolverCache& cache) {
+    const VariableValues values = variable_manager_.get_values();
+    const std::vector<Precision>& residuals = evaluator.get_residuals();
+    auto evaluate = [&]() {
+        evaluator.evaluate_residuals(values);
+        return residual_norm(residuals) <= convergence_tolerance_;
+    };
+    if (variables.empty()) {
+        return evaluate() ? SolverStatus::Converged : SolverStatus::Overconstrained;
+    }
+
+    const size_t row_count = evaluator.get_row_count();
+    const ScopedColumnIndex column_index(variables, variable_manager_.get_id_limit());
+    std::vector<JacobianRow> rows(row_count);
+    std::vector<Precision> rhs(row_count);
+    std::vector<Precision> delta;
+    JacobianMatrix jacobian;
+
+    for (int iteration = 0; iteration < max_iterations_; ++iteration) {
+        if (evaluate()) {
+            return SolverStatus::Converged;
+        }
+        evaluator.evaluate_gradients(values);
+        for (size_t i = 0; i < row_count; ++i) {
+            assemble_jacobian_row(evaluator.get_constraint(i).get_variables(), evaluator.get_gradient(i),
+                                  column_index.get(), rows[i]);
+            rhs[i] = -residuals[i];
+        }
+        pack_jacobian(rows, variables.size(), jacobian);
+        if (!solve_least_squares(cache, jacobian, rhs, delta)) {
+            return SolverStatus::Failed;
+        }
+
+        Precision step_norm = 0.0;
+        for (size_t col = 0; col < variables.size(); ++col) {
+            const VariableID id = variables[col];
+            const Precision step = step_size_ * delta[col];
+            variable_manager_.set_delta(id, step);
+            variable_manager_.set_value(id, variable_manager_.get_value(id) + step);
+            step_norm = std::max(step_norm, std::abs(step));
+        }
+        if (step_norm <= GEOMETRIC_TOLERANCE) {
+            return evaluate() ? SolverStatus::Converged : SolverStatus::NoProgress;
+        }
+    }
+    return evaluate() ? SolverStatus::Converged : SolverStatus::MaxIterations;
+}
+
+SolverStatus ConstraintSystem::solve_cluster(ConstraintCluster& cluster) {
+    bool planned = true;
+    for (auto& block : cluster.blocks) {
+        if (solve_subsystem(block->evaluator, block->variables, block->solver) != SolverStatus::Converged) {
+            planned = false;
+            break;
+        }
+    }
+    if (planned) {
+        return SolverStatus::Converged;
+    }
+
+    // A block can be singular where its structure is not, e.g. parallel
+    // lines asked to meet; solve the cluster as a whole in least squares
+    return solve_subsystem(cluster.evaluator, cluster.variables, cluster.solver);
+}
+
+SolverStatus ConstraintSystem::solve_clusters(const std::vector<size_t>& clusters) {
+    // Clusters share no free variables, so they solve concurrently
+    std::vector<SolverStatus> statuses(clusters.size(), SolverStatus::Converged);
+    QuantumCanvas::Core::parallel_for(0, clusters.size(), 1,
+        [this, &clusters, &statuses](size_t i) {
+            statuses[i] = solve_cluster(*clusters_[clusters[i]]);
+        });
+
+    const SolverStatus status = worst_status(statuses);
+    last_solved_clusters_ = clusters.size();
+    last_solve_status_ = status;
+    last_solve_time_ = std::chrono::steady_clock::now();
+    is_solved_ = status == SolverStatus::Converged;
+    return status;
+}
+
+SolverStatus ConstraintSystem::solve() {
+    QCS_PROFILE_GEOMETRY("solve");
+    if (graph_dirty_) {
+        build_constraint_dependency_graph();
+    }
+    std::vector<size_t> clusters(clusters_.size());
+    std::iota(clusters.begin(), clusters.end(), size_t(0));
+    return solve_clusters(clusters);
+}
+
+SolverStatus ConstraintSystem::solve_drag(const std::vector<VariableID>& ids, const std::vector<Precision>& values) {
+    QCS_PROFILE_GEOMETRY("solve_drag");
+    begin_drag(ids);
+    const SolverStatus status = drag_to(values, max_iterations_);
+    end_drag();
+    return status;
+}
+
+// =============================================================================
+// ConstraintSystem Interactive Dragging
+// =============================================================================
+
+void ConstraintSystem::begin_drag(const std::vector<VariableID>& ids) {
+    if (graph_dirty_) {
+        build_constraint_dependency_graph();
+    }
+    drag_.active = true;
+    drag_.held = ids;
+    drag_.clusters.clear();
+
+    // Clusters of the constraints that name a dragged variable, fixed or not
+    std::vector<size_t> clusters;
+    for (VariableID id : ids) {
+        const auto* variable = variable_manager_.get_variable(id);
+        if (!variable) {
+            continue;
+        }
+        for (size_t constraint_id : variable->get_constraint_refs()) {
+            auto it = constraint_id_to_index_.find(constraint_id);
+            if (it != constraint_id_to_index_.end() && constraint_cluster_[it->second] < clusters_.size()) {
+                clusters.push_back(constraint_cluster_[it->second]);
+            }
+        }
+    }
+    std::sort(clusters.begin(), clusters.end());
+    clusters.erase(std::unique(clusters.begin(), clusters.end()), clusters.end());
+
+    // The dragged variables are constants for the session's frames
+    const std::unordered_set<VariableID> held(ids.begin(), ids.end());
+    for (size_t index : clusters) {
+        const ConstraintCluster& cluster = *clusters_[index];
+        auto drag = std::make_unique<DragCluster>();
+        prepare_evaluator(cluster.constraints, drag->evaluator);
+        for (VariableID id : cluster.variables) {
+            if (!held.count(id)) {
+                drag->variables.push_back(id);
+            }
+        }
+        make_column_index(drag->variables, variable_manager_.get_id_limit(), drag->column_index);
+        drag->rows.resize(cluster.constraints.size());
+        drag->rhs.resize(cluster.constraints.size());
+        drag_.clusters.push_back(std::move(drag));
+    }
+}
+
+SolverStatus ConstraintSystem::drag_to(const std::vector<Precision>& values, int iteration_budget) {
+    if (!drag_.active) {
+        return SolverStatus::Failed;
+    }
+    variable_manager_.set_variable_values(drag_.held, values);
+    for (auto& cluster : drag_.clusters) {
+        cluster->converged = false;
+        cluster->fresh = false;
+    }
+    return drag_frame(iteration_budget);
+}
+
+SolverStatus ConstraintSystem::continue_drag(int iteration_budget) {
+    if (!drag_.active) {
+        return SolverStatus::Failed;
+    }
+    return drag_frame(iteration_budget);
+}
+
+void ConstraintSystem::end_drag() {
+    drag_.active = false;
+    drag_.held.clear();
+    drag_.clusters.clear();
+}
+
+SolverStatus ConstraintSystem::drag_frame(int iteration_budget) {
+    std::vector<SolverStatus> statuses(drag_.clusters.size(), SolverStatus::Converged);
+    QuantumCanvas::Core::parallel_for(0, drag_.clusters.size(), 1,
+        [this, iteration_budget, &statuses](size_t i) {
+            DragCluster& cluster = *drag_.clusters[i];
+            if (!cluster.converged) {
+                statuses[i] = iterate_drag_cluster(cluster, iteration_budget);
+            }
+        });
+
+    const SolverStatus status = worst_status(statuses);
+    last_solved_clusters_ = drag_.clusters.size();
+    last_solve_status_ = status;
+    last_solve_time_ = std::chrono::steady_clock::now();
+    is_solved_ = status == SolverStatus::Converged;
+    return status;
+}
+
+SolverStatus ConstraintSystem::iterate_drag_cluster(DragCluster& cluster, int iteration_budget) {
+    ConstraintEvaluator& evaluator = cluster.evaluator;
+    const VariableValues values = variable_manager_.get_values();
+    const std::vector<Precision>& residuals = evaluator.get_residuals();
+    const size_t row_count = evaluator.get_row_count();
+    auto evaluate = [&]() {
+        evaluator.evaluate_residuals(values);
+        return residual_norm(residuals);
+    };
+    auto keep_best = [&]() {
+        for (size_t col = 0; col < cluster.variables.size(); ++col) {
+            cluster.best_values[col] = variable_manager_.get_value(cluster.variables[col]);
+        }
+    };
+
+    // Warm start: the previous frame's solution is the first iterate
+    Precision error = evaluate();
+    cluster.best_values.resize(cluster.variables.size());
+    keep_best();
+
+    // Only steps that lower the error are kept, so whenever the budget
+    // runs out the sketch shows the best state reached. Chord steps reuse
+    // the last factorisation, even one from an earlier frame, for as long
+    // as they contract the error enough.
+    for (int iteration = 0; iteration < iteration_budget && error > convergence_tolerance_ &&
+                            !cluster.variables.empty(); ++iteration) {
+        for (size_t i = 0; i < row_count; ++i) {
+            cluster.rhs[i] = -residuals[i];
+        }
+        if (cluster.stale) {
+            evaluator.evaluate_gradients(values);
+            for (size_t i = 0; i < row_count; ++i) {
+                assemble_jacobian_row(evaluator.get_constraint(i).get_variables(), evaluator.get_gradient(i),
+                                      cluster.column_index, cluster.rows[i]);
+            }
+            pack_jacobian(cluster.rows, cluster.variables.size(), cluster.jacobian);
+            cluster.factorized = solve_least_squares(cluster.solver, cluster.jacobian, cluster.rhs, cluster.delta);
+            if (!cluster.factorized) {
+                break;
+            }
+            cluster.stale = false;
+            cluster.fresh = true;
+        } else if (!solve_factorized(cluster.solver, cluster.rhs, cluster.delta)) {
+            cluster.stale = true;
+            continue;
+        }
+        const bool chord = !cluster.fresh;
+
+        Precision step_norm = 0.0;
+        for (size_t col = 0; col < cluster.variables.size(); ++col) {
+            const VariableID id = cluster.variables[col];
+            const Precision step = cluster.step_scale * step_size_ * cluster.delta[col];
+            variable_manager_.set_delta(id, step);
+            variable_manager_.set_value(id, cluster.best_values[col] + step);
+            step_norm = std::max(step_norm, std::abs(step));
+        }
+        const Precision stepped = evaluate();
+        if (stepped < error) {
+            cluster.stale = chord && stepped > CHORD_CONTRACTION * error;
+            if (!chord) {
+                cluster.step_scale = std::min(Precision(1.0), cluster.step_scale * 2.0);
+            }
+            error = stepped;
+            cluster.fresh = false;
+            keep_best();
+            // Steps this short mean the held values cannot be met
+            if (step_norm <= GEOMETRIC_TOLERANCE && error > convergence_tolerance_) {
+                return SolverStatus::NoProgress;
+            }
+            continue;
+        }
+
+        // Overshot: back to the best state, then refactor a stale chord or
+        // shorten a fresh step
+        for (size_t col = 0; col < cluster.variables.size(); ++col) {
+            variable_manager_.set_value(cluster.variables[col], cluster.best_values[col]);
+        }
+        evaluate();
+        if (chord) {
+            cluster.stale = true;
+        } else {
+            cluster.step_scale *= 0.5;
+            if (cluster.step_scale < MIN_STEP_SCALE) {
+                cluster.step_scale = 1.0;
+                return SolverStatus::NoProgress;
+            }
+        }
+    }
+
+    cluster.converged = error <= convergence_tolerance_;
+    if (cluster.converged) {
+        return SolverStatus::Converged;
+    }
+    if (cluster.variables.empty()) {
+        return SolverStatus::Overconstrained;
+    }
+    return cluster.factorized ? SolverStatus::MaxIterations : SolverStatus::Failed;
+}
+
+size_t ConstraintSystem::get_cluster_count() {
+    if (graph_dirty_) {
+        build_constraint_dependency_graph();
+    }
+    return clusters_.size();
+}
+
+// =============================================================================
+// ConstraintSystem Graph Decomposition
+// =============================================================================
+
+void ConstraintSystem::build_constraint_dependency_graph() {
+    identify_constraint_clusters();
+    order_constraints_for_solving();
+    for (auto& cluster : clusters_) {
+        prepare_evaluator(cluster->constraints, cluster->evaluator);
+        for (auto& block : cluster->blocks) {
+            prepare_evaluator(block->constraints, block->evaluator);
+        }
+    }
+    graph_dirty_ = false;
+}
+
+void ConstraintSystem::identify_constraint_clusters() {
+    const size_t none = std::numeric_limits<size_t>::max();
+    clusters_.clear();
+    constraint_cluster_.assign(constraints_.size(), none);
+
+    // Union-find over constraints, joined through the references of each
+    // free variable; fixed variables are constants and couple nothing
+    std::vector<size_t> parent(constraints_.size());
+    std::iota(parent.begin(), parent.end(), size_t(0));
+    auto find = [&parent](size_t i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+    std::vector<bool> has_free_variable(constraints_.size(), false);
+    for (VariableID id : variable_manager_.get_active_variable_ids()) {
+        const auto* variable = variable_manager_.get_variable(id);
+        if (variable->is_fixed()) {
+            continue;
+        }
+        size_t first = none;
+        for (size_t constraint_id : variable->get_constraint_refs()) {
+            auto it = constraint_id_to_index_.find(constraint_id);
+            if (it == constraint_id_to_index_.end() || !constraints_[it->second]->is_active()) {
+                continue;
+            }
+            has_free_variable[it->second] = true;
+            if (first == none) {
+                first = it->second;
+            } else {
+                parent[find(it->second)] = find(first);
+            }
+        }
+    }
+
+    // Constraints with nothing free to move cannot be solved for
+    std::unordered_map<size_t, size_t> root_cluster;
+    for (size_t i = 0; i < constraints_.size(); ++i) {
+        if (!has_free_variable[i]) {
+            continue;
+        }
+        auto [it, created] = root_cluster.try_emplace(find(i), clusters_.size());
+        if (created) {
+            clusters_.push_back(std::make_unique<ConstraintCluster>());
+        }
+        constraint_cluster_[i] = it->second;
+        clusters_[it->second]->constraints.push_back(i);
+    }
+
+    for (auto& cluster : clusters_) {
+        for (size_t index : cluster->constraints) {
+            for (VariableID id : constraints_[index]->get_variables()) {
+                const auto* variable = variable_manager_.get_variable(id);
+                if (variable && variable->is_active() && !variable->is_fixed()) {
+                    cluster->variables.push_back(id);
+                }
+            }
+        }
+        std::sort(cluster->variables.begin(), cluster->variables.end());
+        cluster->variables.erase(std::unique(cluster->variables.begin(), cluster->variables.end()),
+                                 cluster->variables.end());
+    }
+}
+
+void ConstraintSystem::order_constraints_for_solving() {
+    // A DR-plan per cluster: match each constraint to a variable it
+    // determines, then split the dependency graph into strongly connected
+    // components. Each component is a square subsystem that needs only the
+    // variables of those before it, and Tarjan's algorithm emits them in
+    // that order. Variables no constraint determines keep their values.
+    for (auto& cluster_ptr : clusters_) {
+        ConstraintCluster& cluster = *cluster_ptr;
+        cluster.blocks.clear();
+        const size_t m = cluster.constraints.size();
+        const size_t n = cluster.variables.size();
+
+        std::unordered_map<VariableID, int> local;
+        local.reserve(n);
+        for (size_t v = 0; v < n; ++v) {
+            local[cluster.variables[v]] = static_cast<int>(v);
+        }
+        std::vector<std::vector<int>> adjacency(m);
+        for (size_t c = 0; c < m; ++c) {
+            for (VariableID id : constraints_[cluster.constraints[c]]->get_variables()) {
+                auto it = local.find(id);
+                if (it != local.end()) {
+                    adjacency[c].push_back(it->second);
+                }
+            }
+            std::sort(adjacency[c].begin(), adjacency[c].end());
+            adjacency[c].erase(std::unique(adjacency[c].begin(), adjacency[c].end()), adjacency[c].end());
+        }
+
+        // Maximum matching by breadth-first augmenting paths
+        std::vector<int> matched_variable(m, -1);
+        std::vector<int> matched_constraint(n, -1);
+        std::vector<size_t> visited(n, 0);
+        std::vector<int> reached_from(n, -1);
+        std::vector<int> queue;
+        size_t stamp = 0;
+        bool complete = true;
+        for (size_t start = 0; start < m; ++start) {
+            ++stamp;
+            queue.assign(1, static_cast<int>(start));
+            bool augmented = false;
+            for (size_t head = 0; head < queue.size() && !augmented; ++head) {
+                const int c = queue[head];
+                for (int v : adjacency[c]) {
+                    if (visited[v] == stamp) {
+                        continue;
+                    }
+                    visited[v] = stamp;
+                    reached_from[v] = c;
+                    if (matched_constraint[v] < 0) {
+                        for (int free = v; free >= 0;) {
+                            const int owner = reached_from[free];
+                            const int previous = matched_variable[owner];
+                            matched_variable[owner] = free;
+                            matched_constraint[free] = owner;
+                            free = previous;
+                        }
+                        augmented = true;
+                        break;
+                    }
+                    queue.push_back(matched_constraint[v]);
+                }
+            }
+            complete = complete && augmented;
+        }
+
+        // More constraints than the variables can absorb: no square plan
+        if (!complete) {
+            auto block = std::make_unique<SolveBlock>();
+            block->constraints = cluster.constraints;
+            block->variables = cluster.variables;
+            cluster.blocks.push_back(std::move(block));
+            continue;
+        }
+
+        // c depends on d where c reads the variable d determines
+        std::vector<std::vector<int>> depends(m);
+        for (size_t c = 0; c < m; ++c) {
+            for (int v : adjacency[c]) {
+                const int d = matched_constraint[v];
+                if (d >= 0 && d != static_cast<int>(c)) {
+                    depends[c].push_back(d);
+                }
+            }
+        }
+
+        // Iterative Tarjan; a component is complete once everything it
+        // depends on has been emitted
+        std::vector<int> index(m, -1);
+        std::vector<int> low(m, 0);
+        std::vector<bool> on_stack(m, false);
+        std::vector<int> stack;
+        std::vector<std::pair<int, size_t>> calls;
+        int counter = 0;
+        auto visit = [&](int c) {
+            index[c] = low[c] = counter++;
+            stack.push_back(c);
+            on_stack[c] = true;
+            calls.emplace_back(c, 0);
+        };
+        for (size_t root = 0; root < m; ++root) {
+            if (index[root] >= 0) {
+                continue;
+            }
+            visit(static_cast<int>(root));
+            while (!calls.empty()) {
+                const int c = calls.back().first;
+                if (calls.back().second < depends[c].size()) {
+                    const int d = depends[c][calls.back().second++];
+                    if (index[d] < 0) {
+                        visit(d);
+                    } else if (on_stack[d]) {
+                        low[c] = std::min(low[c], index[d]);
+                    }
+                    continue;
+                }
+                calls.pop_back();
+                if (!calls.empty()) {
+                    const int caller = calls.back().first;
+                    low[caller] = std::min(low[caller], low[c]);
+                }
+                if (low[c] != index[c]) {
+                    continue;
+                }
+                auto block = std::make_unique<SolveBlock>();
+                int member;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    on_stack[member] = false;
+                    block->constraints.push_back(cluster.constraints[member]);
+                    block->variables.push_back(cluster.variables[matched_variable[member]]);
+                } while (member != c);
+                std::sort(block->constraints.begin(), block->constraints.end());
+                std::sort(block->variables.begin(), block->variables.end());
+                cluster.blocks.push_back(std::move(block));
+            }
+        }
+    }
+}
+
+// =============================================================================
+// ConstraintSolver Implementation
+// =============================================================================
+
+ConstraintSolver::ConstraintSolver() : system_(std::make_unique<ConstraintSystem>()) {
+    system_->set_solver_settings(config_.max_iterations, config_.convergence_tolerance, config_.step_size);
+}
+
+ConstraintSolver::~ConstraintSolver() = default;
+
+} // namespace qcs::cad
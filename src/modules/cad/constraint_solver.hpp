@@ -20,7 +20,9 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <functional>
+#include <atomic>
 #include <chrono>
+#include <span>
 
 namespace qcs::cad {
 
@@ -43,6 +45,20 @@ enum class ConstraintCategory {
     Construction    ///< Construction geometry constraints
 };
 
+/// Concrete constraint type, so solver loops can evaluate constraints of
+/// one kind in a batch without a virtual call each
+enum class ConstraintKind {
+    Distance,
+    Horizontal,
+    Vertical,
+    Parallel,
+    Perpendicular,
+    Angle,
+    Coincident,
+    FixedPoint,
+    Custom          ///< Any other subclass, evaluated through virtual calls
+};
+
 /// Constraint priority for conflict resolution
 enum class ConstraintPriority {
     Required = 0,   ///< Must be satisfied (causes failure if violated)
@@ -85,6 +101,18 @@ enum class SolverStatus {
 using VariableID = uint32_t;
 constexpr VariableID INVALID_VARIABLE_ID = 0;
 
+/// Variable values indexed by VariableID, as VariableManager::get_values() gives
+using VariableValues = std::span<const Precision>;
+
+/// Per-variable solving data in dense arrays indexed by VariableID, which
+/// the solver's loops read and write without going through the variables
+struct VariableStorage {
+    std::vector<Precision> values;
+    std::vector<Precision> lower_bounds;
+    std::vector<Precision> upper_bounds;
+    std::vector<Precision> deltas;
+};
+
 /// Constraint variable with bounds and metadata
 class ConstraintVariable {
 private:
@@ -101,6 +129,11 @@ private:
     Precision initial_value_;
     Precision delta_;
     std::set<size_t> constraint_refs_;  // Constraints using this variable
+    
+    // Set while a VariableManager owns the variable; the value, bounds and
+    // delta then live in its storage rather than in the fields above
+    VariableStorage* storage_ = nullptr;
+    friend class VariableManager;
 
 public:
     ConstraintVariable(VariableID id, const std::string& name, Precision initial_value = 0);
@@ -108,9 +141,9 @@ public:
     // Accessors
     VariableID get_id() const { return id_; }
     const std::string& get_name() const { return name_; }
-    Precision get_value() const { return value_; }
-    Precision get_lower_bound() const { return lower_bound_; }
-    Precision get_upper_bound() const { return upper_bound_; }
+    Precision get_value() const { return storage_ ? storage_->values[id_] : value_; }
+    Precision get_lower_bound() const { return storage_ ? storage_->lower_bounds[id_] : lower_bound_; }
+    Precision get_upper_bound() const { return storage_ ? storage_->upper_bounds[id_] : upper_bound_; }
     bool is_fixed() const { return is_fixed_; }
     bool is_active() const { return is_active_; }
     Precision get_tolerance() const { return tolerance_; }
@@ -125,8 +158,8 @@ public:
     // Solving support
     void set_initial_value(Precision value) { initial_value_ = value; }
     Precision get_initial_value() const { return initial_value_; }
-    void set_delta(Precision delta) { delta_ = delta; }
-    Precision get_delta() const { return delta_; }
+    void set_delta(Precision delta) { (storage_ ? storage_->deltas[id_] : delta_) = delta; }
+    Precision get_delta() const { return storage_ ? storage_->deltas[id_] : delta_; }
     
     // Constraint references
     void add_constraint_ref(size_t constraint_id) { constraint_refs_.insert(constraint_id); }
@@ -142,7 +175,11 @@ public:
 /// Variable collection and management
 class VariableManager {
 private:
-    std::unordered_map<VariableID, std::unique_ptr<ConstraintVariable>> variables_;
+    // IDs are handed out in sequence, so both are indexed by VariableID;
+    // removed variables leave a null slot
+    std::vector<std::unique_ptr<ConstraintVariable>> variables_;
+    std::unique_ptr<VariableStorage> storage_;
+    size_t variable_count_;
     VariableID next_id_;
     std::unordered_map<std::string, VariableID> name_to_id_;
 
@@ -160,8 +197,19 @@ public:
     ConstraintVariable* get_variable_by_name(const std::string& name);
     const ConstraintVariable* get_variable_by_name(const std::string& name) const;
     
+    // Solver access by ID, bypassing the variable objects. IDs must name
+    // live variables; set_value() clamps to the bounds.
+    VariableValues get_values() const { return storage_->values; }
+    Precision get_value(VariableID id) const { return storage_->values[id]; }
+    void set_value(VariableID id, Precision value) {
+        storage_->values[id] = clamp(value, storage_->lower_bounds[id], storage_->upper_bounds[id]);
+    }
+    void set_delta(VariableID id, Precision delta) { storage_->deltas[id] = delta; }
+    bool contains(VariableID id) const { return id < variables_.size() && variables_[id]; }
+    size_t get_id_limit() const { return variables_.size(); }  ///< One past the largest ID handed out
+    
     // Variable queries
-    size_t get_variable_count() const { return variables_.size(); }
+    size_t get_variable_count() const { return variable_count_; }
     size_t get_active_variable_count() const;
     size_t get_free_variable_count() const;  // Not fixed variables
     std::vector<VariableID> get_all_variable_ids() const;
@@ -184,6 +232,7 @@ protected:
     size_t id_;
     std::string name_;
     ConstraintCategory category_;
+    ConstraintKind kind_;
     ConstraintPriority priority_;
     ConstraintState state_;
     std::vector<VariableID> variables_;
@@ -197,13 +246,15 @@ protected:
     std::vector<Precision> jacobian_row_;
 
 public:
-    GeometricConstraint(size_t id, const std::string& name, ConstraintCategory category);
+    GeometricConstraint(size_t id, const std::string& name, ConstraintCategory category,
+                        ConstraintKind kind = ConstraintKind::Custom);
     virtual ~GeometricConstraint() = default;
     
     // Basic properties
     size_t get_id() const { return id_; }
     const std::string& get_name() const { return name_; }
     ConstraintCategory get_category() const { return category_; }
+    ConstraintKind get_kind() const { return kind_; }
     ConstraintPriority get_priority() const { return priority_; }
     ConstraintState get_state() const { return state_; }
     bool is_active() const { return is_active_; }
@@ -218,9 +269,15 @@ public:
     void add_variable(VariableID id) { variables_.push_back(id); }
     void clear_variables() { variables_.clear(); }
     
-    // Constraint evaluation
-    virtual Precision evaluate_error(const VariableManager& vars) const = 0;
-    virtual std::vector<Precision> evaluate_gradient(const VariableManager& vars) const = 0;
+    // Constraint evaluation on values indexed by VariableID, which must
+    // cover every variable of the constraint. The gradient lines up with
+    // get_variables() and fills the caller's span, which holds that many.
+    virtual Precision evaluate_error(VariableValues values) const = 0;
+    virtual void evaluate_gradient(VariableValues values, std::span<Precision> gradient) const = 0;
+    
+    // The same on a manager; zero where a variable is missing
+    Precision evaluate_error(const VariableManager& vars) const;
+    std::vector<Precision> evaluate_gradient(const VariableManager& vars) const;
     virtual bool is_satisfied(const VariableManager& vars) const;
     
     // Solving support
@@ -245,7 +302,7 @@ public:
 // =============================================================================
 
 /// Distance constraint between two points
-class DistanceConstraint : public GeometricConstraint {
+class DistanceConstraint final : public GeometricConstraint {
 private:
     VariableID point1_x_, point1_y_;
     VariableID point2_x_, point2_y_;
@@ -255,8 +312,10 @@ public:
     DistanceConstraint(size_t id, VariableID p1x, VariableID p1y, VariableID p2x, VariableID p2y,
                       Precision distance);
     
-    Precision evaluate_error(const VariableManager& vars) const override;
-    std::vector<Precision> evaluate_gradient(const VariableManager& vars) const override;
+    using GeometricConstraint::evaluate_error;
+    using GeometricConstraint::evaluate_gradient;
+    Precision evaluate_error(VariableValues values) const override;
+    void evaluate_gradient(VariableValues values, std::span<Precision> gradient) const override;
     std::unique_ptr<GeometricConstraint> clone() const override;
     std::string get_description() const override;
     int get_degree_of_freedom_reduction() const override { return 1; }
@@ -266,15 +325,17 @@ public:
 };
 
 /// Horizontal constraint (y-coordinates equal)
-class HorizontalConstraint : public GeometricConstraint {
+class HorizontalConstraint final : public GeometricConstraint {
 private:
     VariableID point1_y_, point2_y_;
 
 public:
     HorizontalConstraint(size_t id, VariableID p1y, VariableID p2y);
     
-    Precision evaluate_error(const VariableManager& vars) const override;
-    std::vector<Precision> evaluate_gradient(const VariableManager& vars) const override;
+    using GeometricConstraint::evaluate_error;
+    using GeometricConstraint::evaluate_gradient;
+    Precision evaluate_error(VariableValues values) const override;
+    void evaluate_gradient(VariableValues values, std::span<Precision> gradient) const override;
     std::unique_ptr<GeometricConstraint> clone() const override;
     std::string get_description() const override;
     bool is_linear() const override { return true; }
@@ -282,15 +343,17 @@ public:
 };
 
 /// Vertical constraint (x-coordinates equal)
-class VerticalConstraint : public GeometricConstraint {
+class VerticalConstraint final : public GeometricConstraint {
 private:
     VariableID point1_x_, point2_x_;
 
 public:
     VerticalConstraint(size_t id, VariableID p1x, VariableID p2x);
     
-    Precision evaluate_error(const VariableManager& vars) const override;
-    std::vector<Precision> evaluate_gradient(const VariableManager& vars) const override;
+    using GeometricConstraint::evaluate_error;
+    using GeometricConstraint::evaluate_gradient;
+    Precision evaluate_error(VariableValues values) const override;
+    void evaluate_gradient(VariableValues values, std::span<Precision> gradient) const override;
     std::unique_ptr<GeometricConstraint> clone() const override;
     std::string get_description() const override;
     bool is_linear() const override { return true; }
@@ -298,7 +361,7 @@ public:
 };
 
 /// Parallel constraint between two line segments
-class ParallelConstraint : public GeometricConstraint {
+class ParallelConstraint final : public GeometricConstraint {
 private:
     VariableID line1_start_x_, line1_start_y_, line1_end_x_, line1_end_y_;
     VariableID line2_start_x_, line2_start_y_, line2_end_x_, line2_end_y_;
@@ -307,15 +370,17 @@ public:
     ParallelConstraint(size_t id, VariableID l1sx, VariableID l1sy, VariableID l1ex, VariableID l1ey,
                       VariableID l2sx, VariableID l2sy, VariableID l2ex, VariableID l2ey);
     
-    Precision evaluate_error(const VariableManager& vars) const override;
-    std::vector<Precision> evaluate_gradient(const VariableManager& vars) const override;
+    using GeometricConstraint::evaluate_error;
+    using GeometricConstraint::evaluate_gradient;
+    Precision evaluate_error(VariableValues values) const override;
+    void evaluate_gradient(VariableValues values, std::span<Precision> gradient) const override;
     std::unique_ptr<GeometricConstraint> clone() const override;
     std::string get_description() const override;
     int get_degree_of_freedom_reduction() const override { return 1; }
 };
 
 /// Perpendicular constraint between two line segments
-class PerpendicularConstraint : public GeometricConstraint {
+class PerpendicularConstraint final : public GeometricConstraint {
 private:
     VariableID line1_start_x_, line1_start_y_, line1_end_x_, line1_end_y_;
     VariableID line2_start_x_, line2_start_y_, line2_end_x_, line2_end_y_;
@@ -324,15 +389,17 @@ public:
     PerpendicularConstraint(size_t id, VariableID l1sx, VariableID l1sy, VariableID l1ex, VariableID l1ey,
                            VariableID l2sx, VariableID l2sy, VariableID l2ex, VariableID l2ey);
     
-    Precision evaluate_error(const VariableManager& vars) const override;
-    std::vector<Precision> evaluate_gradient(const VariableManager& vars) const override;
+    using GeometricConstraint::evaluate_error;
+    using GeometricConstraint::evaluate_gradient;
+    Precision evaluate_error(VariableValues values) const override;
+    void evaluate_gradient(VariableValues values, std::span<Precision> gradient) const override;
     std::unique_ptr<GeometricConstraint> clone() const override;
     std::string get_description() const override;
     int get_degree_of_freedom_reduction() const override { return 1; }
 };
 
 /// Angle constraint between two line segments
-class AngleConstraint : public GeometricConstraint {
+class AngleConstraint final : public GeometricConstraint {
 private:
     VariableID line1_start_x_, line1_start_y_, line1_end_x_, line1_end_y_;
     VariableID line2_start_x_, line2_start_y_, line2_end_x_, line2_end_y_;
@@ -343,8 +410,10 @@ public:
                    VariableID l2sx, VariableID l2sy, VariableID l2ex, VariableID l2ey, 
                    Precision angle);
     
-    Precision evaluate_error(const VariableManager& vars) const override;
-    std::vector<Precision> evaluate_gradient(const VariableManager& vars) const override;
+    using GeometricConstraint::evaluate_error;
+    using GeometricConstraint::evaluate_gradient;
+    Precision evaluate_error(VariableValues values) const override;
+    void evaluate_gradient(VariableValues values, std::span<Precision> gradient) const override;
     std::unique_ptr<GeometricConstraint> clone() const override;
     std::string get_description() const override;
     int get_degree_of_freedom_reduction() const override { return 1; }
@@ -354,7 +423,7 @@ public:
 };
 
 /// Coincident constraint (two points at same location)
-class CoincidentConstraint : public GeometricConstraint {
+class CoincidentConstraint final : public GeometricConstraint {
 private:
     VariableID point1_x_, point1_y_;
     VariableID point2_x_, point2_y_;
@@ -362,8 +431,10 @@ private:
 public:
     CoincidentConstraint(size_t id, VariableID p1x, VariableID p1y, VariableID p2x, VariableID p2y);
     
-    Precision evaluate_error(const VariableManager& vars) const override;
-    std::vector<Precision> evaluate_gradient(const VariableManager& vars) const override;
+    using GeometricConstraint::evaluate_error;
+    using GeometricConstraint::evaluate_gradient;
+    Precision evaluate_error(VariableValues values) const override;
+    void evaluate_gradient(VariableValues values, std::span<Precision> gradient) const override;
     std::unique_ptr<GeometricConstraint> clone() const override;
     std::string get_description() const override;
     bool is_linear() const override { return true; }
@@ -371,7 +442,7 @@ public:
 };
 
 /// Fixed point constraint
-class FixedPointConstraint : public GeometricConstraint {
+class FixedPointConstraint final : public GeometricConstraint {
 private:
     VariableID point_x_, point_y_;
     Point2D target_position_;
@@ -379,8 +450,10 @@ private:
 public:
     FixedPointConstraint(size_t id, VariableID px, VariableID py, const Point2D& position);
     
-    Precision evaluate_error(const VariableManager& vars) const override;
-    std::vector<Precision> evaluate_gradient(const VariableManager& vars) const override;
+    using GeometricConstraint::evaluate_error;
+    using GeometricConstraint::evaluate_gradient;
+    Precision evaluate_error(VariableValues values) const override;
+    void evaluate_gradient(VariableValues values, std::span<Precision> gradient) const override;
     std::unique_ptr<GeometricConstraint> clone() const override;
     std::string get_description() const override;
     bool is_linear() const override { return true; }
@@ -390,6 +463,43 @@ public:
     void set_target_position(const Point2D& position) { target_position_ = position; }
 };
 
+// =============================================================================
+// Constraint Evaluation
+// =============================================================================
+
+/// The constraints of one subsystem grouped by kind, so evaluating them runs
+/// one non-virtual kernel per kind rather than a virtual call each.
+/// Residuals and gradients land in flat arrays by row, sized by prepare().
+class ConstraintEvaluator {
+private:
+    struct Batch {
+        ConstraintKind kind;
+        std::vector<uint32_t> rows;
+        std::vector<const GeometricConstraint*> constraints;
+    };
+    std::vector<Batch> batches_;
+    std::vector<const GeometricConstraint*> rows_;
+    std::vector<size_t> gradient_offsets_;                    ///< Of each row, then the total
+    std::vector<Precision> residuals_;
+    std::vector<Precision> gradients_;
+
+public:
+    /// Rows follow the given order; the constraints must outlive their use here
+    void prepare(const std::vector<const GeometricConstraint*>& constraints);
+    
+    void evaluate_residuals(VariableValues values);
+    void evaluate_gradients(VariableValues values);
+    
+    size_t get_row_count() const { return rows_.size(); }
+    size_t get_batch_count() const { return batches_.size(); }
+    const GeometricConstraint& get_constraint(size_t row) const { return *rows_[row]; }
+    const std::vector<Precision>& get_residuals() const { return residuals_; }
+    /// Lines up with get_constraint(row).get_variables()
+    std::span<const Precision> get_gradient(size_t row) const {
+        return {gradients_.data() + gradient_offsets_[row], gradient_offsets_[row + 1] - gradient_offsets_[row]};
+    }
+};
+
 // =============================================================================
 // Constraint System
 // =============================================================================
@@ -414,6 +524,69 @@ private:
     Precision step_size_;
     bool enable_line_search_;
     bool enable_trust_region_;
+    
+    // Linear solve state, one per block, cluster and drag cluster. The
+    // normal matrix keeps the Jacobian's sparsity pattern, which follows
+    // the constraints' variable lists rather than their values, so its
+    // symbolic factorisation is reused across iterations until the
+    // system's structure changes.
+    struct LinearSolverCache {
+        Eigen::SparseMatrix<Precision> normal;                ///< J^T J or J J^T, damped
+        Eigen::SimplicialLDLT<Eigen::SparseMatrix<Precision>> cholesky;
+        std::vector<Eigen::SparseMatrix<Precision>::StorageIndex> outer;  ///< Pattern analysed
+        std::vector<Eigen::SparseMatrix<Precision>::StorageIndex> inner;
+        Eigen::SparseMatrix<Precision> jacobian;              ///< As last factorised
+        Eigen::SparseQR<Eigen::SparseMatrix<Precision>, Eigen::COLAMDOrdering<int>> qr;
+        bool tall = true;                                     ///< Normal matrix is J^T J
+        bool use_qr = false;                                  ///< The normal matrix would not factor
+        bool analyzed = false;
+    };
+    // Summed over every cache; clusters factorise concurrently
+    std::atomic<size_t> symbolic_factorizations_{0};
+    std::atomic<size_t> numeric_factorizations_{0};
+    
+    // Decomposition. Constraints sharing a free variable form a cluster,
+    // solved independently of the others; within one, the plan's blocks
+    // are square subsystems solved in dependency order.
+    struct SolveBlock {
+        std::vector<size_t> constraints;                      ///< Indices into constraints_
+        std::vector<VariableID> variables;                    ///< Those the block determines
+        ConstraintEvaluator evaluator;
+        LinearSolverCache solver;
+    };
+    struct ConstraintCluster {
+        std::vector<size_t> constraints;
+        std::vector<VariableID> variables;                    ///< Free variables, ascending
+        std::vector<std::unique_ptr<SolveBlock>> blocks;      ///< In solving order
+        ConstraintEvaluator evaluator;
+        LinearSolverCache solver;                             ///< Whole-cluster solves
+    };
+    std::vector<std::unique_ptr<ConstraintCluster>> clusters_;
+    std::vector<size_t> constraint_cluster_;                  ///< Cluster of each constraint
+    bool graph_dirty_ = true;
+    size_t last_solved_clusters_ = 0;
+    
+    // Drag session: each affected cluster with the dragged variables held
+    // out of its columns, and its last Jacobian and factorisation
+    struct DragCluster {
+        ConstraintEvaluator evaluator;
+        std::vector<VariableID> variables;
+        std::vector<int> column_index;                        ///< By VariableID, -1 if held
+        std::vector<std::vector<std::pair<int, Precision>>> rows;
+        std::vector<Precision> rhs, delta, best_values;
+        JacobianMatrix jacobian;
+        LinearSolverCache solver;
+        Precision step_scale = 1.0;                           ///< Shortened after overshooting
+        bool factorized = false;
+        bool stale = true;                                    ///< Refactor before the next step
+        bool fresh = false;                                   ///< Factorised at the current state
+        bool converged = false;
+    };
+    struct DragSession {
+        bool active = false;
+        std::vector<VariableID> held;
+        std::vector<std::unique_ptr<DragCluster>> clusters;
+    } drag_;
 
 public:
     ConstraintSystem();
@@ -444,10 +617,32 @@ public:
     std::vector<size_t> find_redundant_constraints();
     bool validate_system();
     
-    // Solving
+    // Solving. Independent clusters are solved in parallel on the task
+    // scheduler.
     SolverStatus solve();
     SolverStatus solve_iterative();
     SolverStatus solve_with_timeout(std::chrono::milliseconds timeout);
+    /// Sets the dragged variables and re-solves only the clusters they
+    /// touch, holding them at the given values
+    SolverStatus solve_drag(const std::vector<VariableID>& ids, const std::vector<Precision>& values);
+    
+    /// Interactive dragging. Each frame starts from the last one's solution
+    /// and reuses the affected clusters' Jacobian structure and
+    /// factorisation, refactoring only once a step stops contracting the
+    /// error. Clusters spend at most iteration_budget iterations a frame
+    /// and keep their best state; MaxIterations means later frames carry on
+    /// converging, through continue_drag() while the pointer rests.
+    void begin_drag(const std::vector<VariableID>& ids);
+    SolverStatus drag_to(const std::vector<Precision>& values, int iteration_budget = 4);
+    SolverStatus continue_drag(int iteration_budget = 4);
+    void end_drag();
+    bool is_dragging() const { return drag_.active; }
+    
+    /// The decomposition follows constraints as they are added and removed;
+    /// call this after fixing, freeing or deactivating variables
+    void mark_structure_changed() { graph_dirty_ = true; }
+    size_t get_cluster_count();
+    size_t get_last_solved_cluster_count() const { return last_solved_clusters_; }
     
     void set_solver_settings(int max_iter, Precision tolerance, Precision step);
     SolverStatus get_last_solve_status() const { return last_solve_status_; }
@@ -463,19 +658,16 @@ public:
     std::string get_system_report() const;
     std::vector<std::string> get_constraint_errors() const;
     void print_constraint_status() const;
+    /// Factorisations performed by solve() and drags. The symbolic count
+    /// stays put while only values change; the numeric one grows with
+    /// every refactorisation.
+    size_t get_symbolic_factorization_count() const { return symbolic_factorizations_.load(); }
+    size_t get_numeric_factorization_count() const { return numeric_factorizations_.load(); }
 
 private:
     // Internal solving methods
     SolverStatus solve_newton_raphson();
     SolverStatus solve_levenberg_marquardt();
-    SolverStatus solve_gauss_newton();
-    
-    // Matrix operations
-    void build_jacobian_matrix(std::vector<std::vector<Precision>>& jacobian);
-    void build_residual_vector(std::vector<Precision>& residuals);
-    bool solve_linear_system(const std::vector<std::vector<Precision>>& A,
-                            const std::vector<Precision>& b,
-                            std::vector<Precision>& x);
     
     // Convergence testing
     bool test_convergence(const std::vector<Precision>& residuals, 
@@ -486,6 +678,22 @@ private:
     void build_constraint_dependency_graph();
     void identify_constraint_clusters();
     void order_constraints_for_solving();
+    
+    // Decomposed solving
+    SolverStatus solve_clusters(const std::vector<size_t>& clusters);
+    SolverStatus solve_cluster(ConstraintCluster& cluster);
+    void prepare_evaluator(const std::vector<size_t>& constraints, ConstraintEvaluator& evaluator) const;
+    SolverStatus solve_subsystem(ConstraintEvaluator& evaluator, const std::vector<VariableID>& variables,
+                                 LinearSolverCache& cache);
+    SolverStatus drag_frame(int iteration_budget);
+    SolverStatus iterate_drag_cluster(DragCluster& cluster, int iteration_budget);
+    /// Least-squares solution of A x = b, least-norm when A has more
+    /// columns than rows
+    bool solve_least_squares(LinearSolverCache& cache, const JacobianMatrix& A,
+                             const std::vector<Precision>& b, std::vector<Precision>& x);
+    bool factorize_least_squares(LinearSolverCache& cache, const JacobianMatrix& A);
+    static bool solve_factorized(LinearSolverCache& cache, const std::vector<Precision>& b,
+                                 std::vector<Precision>& x);
 };
 
 // =============================================================================
@@ -543,6 +751,15 @@ public:
     // Solving and results
     bool solve();
     bool solve_with_progress_callback(std::function<bool(int, Precision)> callback);
+    
+    // Interactive dragging; see ConstraintSystem::begin_drag
+    void begin_drag(const std::vector<VariableID>& ids) { system_->begin_drag(ids); }
+    SolverStatus drag_to(const std::vector<Precision>& values, int iteration_budget = 4) {
+        return system_->drag_to(values, iteration_budget);
+    }
+    SolverStatus continue_drag(int iteration_budget = 4) { return system_->continue_drag(iteration_budget); }
+    void end_drag() { system_->end_drag(); }
+    
     SolverStatus get_solve_status() const;
     std::string get_solve_report() const;
     
@@ -12,6 +12,8 @@
 
 #include "cad_types.hpp"
 
+#include <Eigen/Sparse>
+
 namespace qcs::cad {
 
 // Forward declarations for constraint system
@@ -29,8 +31,9 @@ using ConstraintCollection = std::vector<ConstraintPtr>;
 using VariableCollection = std::vector<std::unique_ptr<ConstraintVariable>>;
 using VariableIDSet = std::set<VariableID>;
 
-// Jacobian matrix types
-using JacobianMatrix = std::vector<std::vector<Precision>>;
+// Jacobian matrix types. Each constraint touches a handful of variables,
+// so the Jacobian is kept in compressed sparse row form.
+using JacobianMatrix = Eigen::SparseMatrix<Precision, Eigen::RowMajor>;
 using ResidualVector = std::vector<Precision>;
 using SolutionVector = std::vector<Precision>;
 
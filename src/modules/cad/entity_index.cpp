@@ -0,0 +1,76 @@
+/**
+ * @file entity_index.cpp
+ * @brief Implementation of the entity bounds hierarchy and frustum tests
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Frustum plane extraction and culling over the shared hierarchy
+ */
+
+#include "entity_index.hpp"
+#include <algorithm>
+
+namespace qcs::cad {
+
+// =============================================================================
+// ViewFrustum Implementation
+// =============================================================================
+
+ViewFrustum ViewFrustum::from_view_projection(const Matrix4D& m) {
+    // Gribb and Hartmann: each clip plane is the last row plus or minus one
+    // of the others, here for OpenGL's -w <= z <= w depth range
+    ViewFrustum frustum;
+    const Eigen::Vector4<Precision> r0 = m.row(0).transpose();
+    const Eigen::Vector4<Precision> r1 = m.row(1).transpose();
+    const Eigen::Vector4<Precision> r2 = m.row(2).transpose();
+    const Eigen::Vector4<Precision> r3 = m.row(3).transpose();
+    frustum.planes = {r3 + r0, r3 - r0, r3 + r1, r3 - r1, r3 + r2, r3 - r2};
+
+    for (auto& plane : frustum.planes) {
+        const Precision length = plane.head<3>().norm();
+        if (length > 0.0) {
+            plane /= length;
+        }
+    }
+    return frustum;
+}
+
+ViewFrustum::Containment ViewFrustum::classify(const BoundingBox3D& bounds) const {
+    Containment result = Containment::Inside;
+    for (const auto& plane : planes) {
+        // The corners furthest along and against the plane's normal
+        const Point3D far_corner = (plane.head<3>().array() >= 0.0).select(bounds.max, bounds.min);
+        const Point3D near_corner = (plane.head<3>().array() >= 0.0).select(bounds.min, bounds.max);
+        if (plane.head<3>().dot(far_corner) + plane.w() < 0.0) {
+            return Containment::Outside;
+        }
+        if (plane.head<3>().dot(near_corner) + plane.w() < 0.0) {
+            result = Containment::Intersecting;
+        }
+    }
+    return result;
+}
+
+bool ViewFrustum::contains(const Point3D& point) const {
+    return std::all_of(planes.begin(), planes.end(), [&](const Eigen::Vector4<Precision>& plane) {
+        return plane.head<3>().dot(point) + plane.w() >= 0.0;
+    });
+}
+
+// =============================================================================
+// EntityIndex Implementation
+// =============================================================================
+
+BoundingBox3D EntityIndex::get_total_bounds() const {
+    if (root() == NULL_NODE) {
+        return BoundingBox3D(Point3D::Constant(1.0), Point3D::Constant(-1.0));
+    }
+    return node(root()).bounds;
+}
+
+void EntityIndex::query(const ViewFrustum& frustum, std::vector<EntityID>& out) const {
+    query(frustum, [&out](EntityID id) { out.push_back(id); });
+}
+
+} // namespace qcs::cad
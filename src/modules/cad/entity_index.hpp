@@ -0,0 +1,76 @@
+/**
+ * @file entity_index.hpp
+ * @brief Spatial index over CAD entity bounds for view culling
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Dynamic bounding volume hierarchy and view frustum classification
+ */
+
+#pragma once
+
+#include "cad_types.hpp"
+#include "cad_common.hpp"
+
+#include <array>
+#include <vector>
+
+namespace qcs::cad {
+
+// =============================================================================
+// View Frustum
+// =============================================================================
+
+/// The six clip planes of a view, facing inwards
+struct ViewFrustum {
+    enum class Containment { Outside, Intersecting, Inside };
+
+    std::array<Eigen::Vector4<Precision>, 6> planes;  ///< Left, right, bottom, top, near, far
+
+    /// Planes of the clip volume -w <= x, y, z <= w of a view-projection matrix
+    static ViewFrustum from_view_projection(const Matrix4D& view_projection);
+
+    Containment classify(const BoundingBox3D& bounds) const;
+    bool intersects(const BoundingBox3D& bounds) const { return classify(bounds) != Containment::Outside; }
+    bool contains(const Point3D& point) const;
+};
+
+// =============================================================================
+// Entity Index
+// =============================================================================
+
+/// Dynamic bounding volume hierarchy over entity bounds, with frustum queries
+class EntityIndex : public BoxHierarchy<EntityID> {
+public:
+    using Tree = BoxHierarchy<EntityID>;
+    using Tree::Tree;
+    using Tree::query;
+
+    const BoundingBox3D* get_bounds(EntityID id) const { return bounds(id); }  ///< Exact bounds, null if absent
+
+    /// Bounds of everything indexed; invalid while empty
+    BoundingBox3D get_total_bounds() const;
+
+    /// Calls fn(id) for every entity whose bounds the frustum may see.
+    /// Subtrees wholly inside are reported without testing their leaves.
+    template<typename Fn> void query(const ViewFrustum& frustum, Fn&& fn) const;
+    void query(const ViewFrustum& frustum, std::vector<EntityID>& out) const;
+};
+
+// =============================================================================
+// Template Implementations
+// =============================================================================
+
+template<typename Fn>
+void EntityIndex::query(const ViewFrustum& frustum, Fn&& fn) const {
+    query_if([&frustum](const BoundingBox3D& bounds) {
+        switch (frustum.classify(bounds)) {
+            case ViewFrustum::Containment::Outside: return QuantumCanvas::Core::BVHOverlap::Disjoint;
+            case ViewFrustum::Containment::Inside: return QuantumCanvas::Core::BVHOverlap::Contained;
+            default: return QuantumCanvas::Core::BVHOverlap::Partial;
+        }
+    }, fn);
+}
+
+} // namespace qcs::cad
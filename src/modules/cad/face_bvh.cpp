@@ -0,0 +1,169 @@
+/**
+ * @file face_bvh.cpp
+ * @brief Implementation of face hierarchies and the Boolean broad phase
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Face hierarchy construction, dual-tree pair culling and parallel pair dispatch
+ */
+
+#include "face_bvh.hpp"
+#include "../../core/kernel/task_scheduler.hpp"
+#include <algorithm>
+
+namespace qcs::cad {
+
+namespace {
+
+constexpr size_t MIN_PARALLEL_TASKS = 64;  // Node pairs to split the traversal into
+constexpr size_t PAIR_SLICE = 2048;        // Narrow-phase pairs between progress reports
+constexpr size_t PAIR_GRAIN = 16;
+
+using Tree = FaceBVH::Tree;
+using NodePair = std::pair<int32_t, int32_t>;
+
+/// Replaces an overlapping node pair by its overlapping child pairs,
+/// descending into the larger interior node
+template<typename Visit>
+void split_node_pair(const Tree& first, const Tree& second, const NodePair& pair, Visit&& visit) {
+    const Tree::Node& a = first.node(pair.first);
+    const Tree::Node& b = second.node(pair.second);
+
+    const bool split_first =
+        !a.is_leaf() && (b.is_leaf() || Tree::surface_area(a.bounds) >= Tree::surface_area(b.bounds));
+    if (split_first) {
+        for (int32_t child : {a.child1, a.child2}) {
+            if (first.node(child).bounds.intersects(b.bounds)) {
+                visit(NodePair{child, pair.second});
+            }
+        }
+    } else {
+        for (int32_t child : {b.child1, b.child2}) {
+            if (a.bounds.intersects(second.node(child).bounds)) {
+                visit(NodePair{pair.first, child});
+            }
+        }
+    }
+}
+
+/// Only overlapping node pairs are ever visited, so two leaves are a face pair
+void traverse(const Tree& first, const Tree& second, const NodePair& root, std::vector<FacePair>& pairs) {
+    std::vector<NodePair> stack{root};
+    while (!stack.empty()) {
+        const NodePair pair = stack.back();
+        stack.pop_back();
+        const Tree::Node& a = first.node(pair.first);
+        const Tree::Node& b = second.node(pair.second);
+        if (a.is_leaf() && b.is_leaf()) {
+            pairs.emplace_back(a.key, b.key);
+        } else {
+            split_node_pair(first, second, pair, [&stack](const NodePair& child) { stack.push_back(child); });
+        }
+    }
+}
+
+} // namespace
+
+// =============================================================================
+// FaceBVH Implementation
+// =============================================================================
+
+FaceBVH::FaceBVH(const std::vector<BoundingBox3D>& face_bounds, Precision tolerance) {
+    build(face_bounds, tolerance);
+}
+
+void FaceBVH::clear() {
+    tree_.clear();
+    face_bounds_.clear();
+}
+
+void FaceBVH::build(const std::vector<BoundingBox3D>& face_bounds, Precision tolerance) {
+    clear();
+    const Vector3D margin = Vector3D::Constant(tolerance);
+    face_bounds_.reserve(face_bounds.size());
+
+    // Faces without valid bounds can overlap nothing and stay out of the tree
+    std::vector<std::pair<FaceIndex, BoundingBox3D>> faces;
+    faces.reserve(face_bounds.size());
+    for (size_t face = 0; face < face_bounds.size(); ++face) {
+        const BoundingBox3D& bounds = face_bounds[face];
+        face_bounds_.emplace_back(bounds.min - margin, bounds.max + margin);
+        if (bounds.is_valid()) {
+            faces.emplace_back(static_cast<FaceIndex>(face), face_bounds_.back());
+        }
+    }
+    tree_.build(faces);
+}
+
+void FaceBVH::query(const BoundingBox3D& bounds, std::vector<FaceIndex>& faces) const {
+    if (bounds.is_valid()) {
+        tree_.query(bounds, faces);
+    }
+}
+
+// =============================================================================
+// Boolean Broad Phase Implementation
+// =============================================================================
+
+std::vector<FacePair> find_overlapping_faces(const FaceBVH& first, const FaceBVH& second) {
+    std::vector<FacePair> pairs;
+    const Tree& tree_a = first.get_tree();
+    const Tree& tree_b = second.get_tree();
+    if (tree_a.empty() || tree_b.empty() ||
+        !tree_a.node(tree_a.root()).bounds.intersects(tree_b.node(tree_b.root()).bounds)) {
+        return pairs;
+    }
+
+    // Expand the overlapping node pairs breadth first until there are enough
+    // to keep the workers busy; each then traverses on its own
+    std::vector<NodePair> frontier{{tree_a.root(), tree_b.root()}}, next;
+    while (frontier.size() < MIN_PARALLEL_TASKS) {
+        next.clear();
+        bool split = false;
+        for (const NodePair& pair : frontier) {
+            if (tree_a.node(pair.first).is_leaf() && tree_b.node(pair.second).is_leaf()) {
+                next.push_back(pair);
+            } else {
+                split = true;
+                split_node_pair(tree_a, tree_b, pair, [&next](const NodePair& child) { next.push_back(child); });
+            }
+        }
+        frontier.swap(next);
+        if (!split) {
+            break;
+        }
+    }
+
+    std::vector<std::vector<FacePair>> found(frontier.size());
+    QuantumCanvas::Core::parallel_for(0, frontier.size(), 1, [&](size_t task) {
+        traverse(tree_a, tree_b, frontier[task], found[task]);
+    });
+
+    size_t total = 0;
+    for (const auto& task_pairs : found) {
+        total += task_pairs.size();
+    }
+    pairs.reserve(total);
+    for (const auto& task_pairs : found) {
+        pairs.insert(pairs.end(), task_pairs.begin(), task_pairs.end());
+    }
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+bool for_each_face_pair(const std::vector<FacePair>& pairs,
+                        const std::function<void(const FacePair& pair)>& intersect,
+                        const BooleanProgressCallback& progress) {
+    for (size_t begin = 0; begin < pairs.size(); begin += PAIR_SLICE) {
+        const size_t end = std::min(begin + PAIR_SLICE, pairs.size());
+        QuantumCanvas::Core::parallel_for(begin, end, PAIR_GRAIN, [&](size_t i) { intersect(pairs[i]); });
+
+        if (progress && !progress(static_cast<Precision>(end) / static_cast<Precision>(pairs.size()))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace qcs::cad
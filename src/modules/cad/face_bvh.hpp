@@ -0,0 +1,80 @@
+/**
+ * @file face_bvh.hpp
+ * @brief Bounding volume hierarchies over solid faces for Boolean operations
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Broad-phase face pair culling and parallel narrow-phase dispatch for CSG
+ */
+
+#pragma once
+
+#include "cad_types.hpp"
+#include "cad_common.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace qcs::cad {
+
+// =============================================================================
+// Face Bounding Volume Hierarchy
+// =============================================================================
+
+/// Index of a face in the list a FaceBVH was built from
+using FaceIndex = uint32_t;
+
+/// A face of each operand whose bounds overlap, the first from the first solid
+using FacePair = std::pair<FaceIndex, FaceIndex>;
+
+/// Reports the fraction of face pairs intersected so far; returning false
+/// cancels the operation. Always called on the thread that started it.
+using BooleanProgressCallback = std::function<bool(Precision progress)>;
+
+/// Hierarchy over face bounding boxes, one face per leaf
+///
+/// Boxes are grown by the build tolerance, so faces that only touch within
+/// tolerance still overlap. Built top-down with binned SAH splits; a face
+/// hierarchy is rebuilt rather than edited.
+class FaceBVH {
+public:
+    using Tree = BoxHierarchy<FaceIndex>;
+
+    FaceBVH() = default;
+    explicit FaceBVH(const std::vector<BoundingBox3D>& face_bounds, Precision tolerance = GEOMETRIC_TOLERANCE);
+
+    void build(const std::vector<BoundingBox3D>& face_bounds, Precision tolerance = GEOMETRIC_TOLERANCE);
+    void clear();
+
+    bool empty() const { return tree_.empty(); }
+    size_t get_face_count() const { return face_bounds_.size(); }
+    const Tree& get_tree() const { return tree_; }
+    const BoundingBox3D& get_face_bounds(FaceIndex face) const { return face_bounds_[face]; }
+
+    /// Appends the faces whose grown bounds overlap the box
+    void query(const BoundingBox3D& bounds, std::vector<FaceIndex>& faces) const;
+
+private:
+    Tree tree_{0.0};                           // Leaves hold the grown bounds exactly
+    std::vector<BoundingBox3D> face_bounds_;   // Grown by the tolerance
+};
+
+// =============================================================================
+// Boolean Broad Phase
+// =============================================================================
+
+/// Every pair of overlapping faces between two hierarchies, sorted. Disjoint
+/// subtrees are culled whole and the traversal runs on the task scheduler.
+std::vector<FacePair> find_overlapping_faces(const FaceBVH& first, const FaceBVH& second);
+
+/// Calls intersect for every pair, in parallel on the task scheduler. Pairs
+/// are handed out in slices; progress is reported after each and a false
+/// return stops before the next. Returns false if cancelled.
+bool for_each_face_pair(const std::vector<FacePair>& pairs,
+                        const std::function<void(const FacePair& pair)>& intersect,
+                        const BooleanProgressCallback& progress = nullptr);
+
+} // namespace qcs::cad
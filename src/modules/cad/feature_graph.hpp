@@ -0,0 +1,105 @@
+/**
+ * @file feature_graph.hpp
+ * @brief Dependency graph of modeling features for incremental regeneration
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Per-feature result caching and parallel regeneration of changed branches
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace qcs::cad {
+
+class TopologyEntity;
+
+// =============================================================================
+// Feature Dependency Graph
+// =============================================================================
+
+/// DAG of a part's features, each keeping the solid it produced last time
+///
+/// A feature consumes the results of the features it depends on, in the
+/// order they were given. Changing a feature (a new revision, new inputs,
+/// suppression) dirties it and everything downstream; regenerate() runs
+/// just those, reusing the cached results of the rest. Features on
+/// independent branches are run in parallel on the task scheduler, so the
+/// execute callback must be safe to call for different features at once.
+///
+/// A suppressed feature passes its first input's result through. A feature
+/// that fails, and everything downstream of it, has no result and stays
+/// dirty until the next regeneration.
+class FeatureGraph {
+public:
+    using Result = std::shared_ptr<TopologyEntity>;
+
+    /// Runs a feature on its inputs' results; null reports a failure
+    using ExecuteFn = std::function<Result(size_t feature_id, const std::vector<Result>& inputs)>;
+
+    /// Adds a feature after the features it depends on, which must exist
+    void add_feature(size_t id, std::span<const size_t> depends_on = {});
+    /// Removes a feature; its dependents lose that input and are dirtied
+    void remove_feature(size_t id);
+    /// Throws std::invalid_argument on an unknown feature or a cycle
+    void set_dependencies(size_t id, std::span<const size_t> depends_on);
+
+    /// Dirties the feature if its revision differs from the last one seen
+    void set_revision(size_t id, uint64_t revision);
+    void set_suppressed(size_t id, bool suppressed);
+    void mark_dirty(size_t id);
+    void mark_all_dirty();
+
+    struct RegenerationStats {
+        size_t executed = 0;   ///< Features run
+        size_t reused = 0;     ///< Clean features whose cached results were kept
+        size_t failed = 0;     ///< Features that failed or had a failed input
+    };
+
+    /// Regenerates dirty features and everything downstream of them
+    RegenerationStats regenerate(const ExecuteFn& execute);
+
+    bool contains(size_t id) const { return nodes_.count(id) > 0; }
+    /// Would be run by the next regenerate()
+    bool is_dirty(size_t id) const;
+    bool has_failed(size_t id) const;
+    Result get_result(size_t id) const;
+    const std::vector<size_t>& get_dependencies(size_t id) const;
+    const std::vector<size_t>& get_dependents(size_t id) const;
+
+    /// The feature and everything that depends on it, upstream first
+    std::vector<size_t> get_downstream(size_t id) const;
+
+    size_t size() const { return nodes_.size(); }
+    void clear() { nodes_.clear(); }
+
+private:
+    struct Node {
+        std::vector<size_t> inputs;       ///< Features depended on, in input order
+        std::vector<size_t> dependents;
+        Result result;
+        uint64_t revision = 0;
+        uint64_t order = 0;               ///< Insertion order, for deterministic schedules
+        bool dirty = true;
+        bool suppressed = false;
+        bool failed = false;
+    };
+
+    std::unordered_map<size_t, Node> nodes_;
+    uint64_t next_order_ = 0;
+
+    Node& get_node(size_t id);
+    const Node& get_node(size_t id) const;
+
+    /// The given features and their dependents, upstream first
+    std::vector<size_t> collect_downstream(std::vector<size_t> roots) const;
+};
+
+} // namespace qcs::cad
@@ -0,0 +1,195 @@
+/**
+ * @file line_batch.cpp
+ * @brief Implementation of persistent per-style segment storage
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Span allocation, reuse, compaction and range coalescing
+ */
+
+#include "line_batch.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace qcs::cad {
+
+// =============================================================================
+// LineBatch Editing
+// =============================================================================
+
+LineBatch::LineBatch(const Point3D& origin)
+    : origin_(origin) {
+}
+
+void LineBatch::set_entity(EntityID id, std::span<const Point3D> polyline, uint32_t rgba) {
+    if (polyline.size() < 2) {
+        remove_entity(id);
+        return;
+    }
+
+    const auto count = static_cast<uint32_t>(polyline.size() - 1);
+    auto it = spans_.find(id);
+    if (it == spans_.end()) {
+        it = spans_.emplace(id, allocate(count)).first;
+    } else if (it->second.capacity < count) {
+        release(it->second);
+        it->second = allocate(count);
+    }
+    write(it->second, polyline, rgba);
+}
+
+bool LineBatch::remove_entity(EntityID id) {
+    auto it = spans_.find(id);
+    if (it == spans_.end()) {
+        return false;
+    }
+    release(it->second);
+    spans_.erase(it);
+    return true;
+}
+
+void LineBatch::clear() {
+    segments_.clear();
+    spans_.clear();
+    free_spans_.clear();
+    dirty_.clear();
+    used_segments_ = 0;
+}
+
+LineBatch::Range LineBatch::get_span(EntityID id) const {
+    auto it = spans_.find(id);
+    return it != spans_.end() ? Range{it->second.first, it->second.count} : Range{};
+}
+
+LineBatch::Span LineBatch::allocate(uint32_t capacity) {
+    auto it = free_spans_.find(capacity);
+    if (it != free_spans_.end()) {
+        Span span{it->second.back(), capacity, 0};
+        it->second.pop_back();
+        if (it->second.empty()) {
+            free_spans_.erase(it);
+        }
+        return span;
+    }
+
+    Span span{static_cast<uint32_t>(segments_.size()), capacity, 0};
+    segments_.resize(segments_.size() + capacity);
+    return span;
+}
+
+void LineBatch::release(const Span& span) {
+    std::fill_n(segments_.begin() + span.first, span.count, LineSegment{});
+    if (span.count > 0) {
+        dirty_.push_back({span.first, span.count});
+    }
+    used_segments_ -= span.count;
+    free_spans_[span.capacity].push_back(span.first);
+}
+
+void LineBatch::write(Span& span, std::span<const Point3D> polyline, uint32_t rgba) {
+    auto to_float = [this](const Point3D& p) {
+        const Point3D relative = p - origin_;
+        return std::array<float, 3>{static_cast<float>(relative.x()), static_cast<float>(relative.y()),
+                                    static_cast<float>(relative.z())};
+    };
+
+    // Distances run on in double precision so long polylines keep their
+    // dash phase
+    const auto count = static_cast<uint32_t>(polyline.size() - 1);
+    Precision distance = 0.0;
+    for (uint32_t i = 0; i < count; ++i) {
+        LineSegment& segment = segments_[span.first + i];
+        segment.start = to_float(polyline[i]);
+        segment.end = to_float(polyline[i + 1]);
+        segment.distance = static_cast<float>(distance);
+        segment.color = rgba;
+        distance += (polyline[i + 1] - polyline[i]).norm();
+    }
+
+    // Slots the shorter polyline no longer reaches become unused
+    const uint32_t written = std::max(count, span.count);
+    std::fill(segments_.begin() + span.first + count, segments_.begin() + span.first + written, LineSegment{});
+    used_segments_ = used_segments_ - span.count + count;
+    span.count = count;
+    dirty_.push_back({span.first, written});
+}
+
+void LineBatch::compact() {
+    // Spans keep their relative order, so runs of neighbours stay together
+    std::vector<std::pair<uint32_t, Span*>> order;
+    order.reserve(spans_.size());
+    for (auto& [id, span] : spans_) {
+        order.emplace_back(span.first, &span);
+    }
+    std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<LineSegment> packed;
+    packed.reserve(used_segments_);
+    for (auto& [first, span] : order) {
+        const auto begin = segments_.begin() + span->first;
+        span->first = static_cast<uint32_t>(packed.size());
+        span->capacity = span->count;
+        packed.insert(packed.end(), begin, begin + span->count);
+    }
+
+    segments_ = std::move(packed);
+    free_spans_.clear();
+    dirty_.clear();
+    if (!segments_.empty()) {
+        dirty_.push_back({0, static_cast<uint32_t>(segments_.size())});
+    }
+}
+
+// =============================================================================
+// LineBatch Ranges
+// =============================================================================
+
+void LineBatch::merge_ranges(std::vector<Range>& ranges, uint32_t max_gap) {
+    if (ranges.empty()) {
+        return;
+    }
+    std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b) { return a.first < b.first; });
+
+    size_t out = 0;
+    for (size_t i = 1; i < ranges.size(); ++i) {
+        const uint64_t end = uint64_t(ranges[out].first) + ranges[out].count;
+        if (ranges[i].first <= end + max_gap) {
+            const uint64_t merged_end = std::max<uint64_t>(end, uint64_t(ranges[i].first) + ranges[i].count);
+            ranges[out].count = static_cast<uint32_t>(merged_end - ranges[out].first);
+        } else {
+            ranges[++out] = ranges[i];
+        }
+    }
+    ranges.resize(out + 1);
+}
+
+std::vector<LineBatch::Range> LineBatch::take_dirty_ranges(uint32_t max_gap) {
+    std::vector<Range> ranges;
+    ranges.swap(dirty_);
+    merge_ranges(ranges, max_gap);
+    return ranges;
+}
+
+std::vector<LineBatch::Range> LineBatch::get_draw_ranges(std::span<const EntityID> ids, uint32_t max_gap,
+                                                         size_t max_ranges) const {
+    std::vector<Range> ranges;
+    ranges.reserve(ids.size());
+    for (EntityID id : ids) {
+        auto it = spans_.find(id);
+        if (it != spans_.end() && it->second.count > 0) {
+            ranges.push_back({it->second.first, it->second.count});
+        }
+    }
+
+    // Drawing a few unused or culled slots costs less than another draw call
+    merge_ranges(ranges, max_gap);
+    uint32_t gap = std::max<uint32_t>(max_gap, 1);
+    while (ranges.size() > std::max<size_t>(max_ranges, 1) && gap < std::numeric_limits<uint32_t>::max() / 4) {
+        gap *= 4;
+        merge_ranges(ranges, gap);
+    }
+    return ranges;
+}
+
+} // namespace qcs::cad
@@ -0,0 +1,109 @@
+/**
+ * @file line_batch.hpp
+ * @brief Persistent per-style segment storage for GPU line rendering
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Entity spans, in-place edits and dirty range tracking for partial uploads
+ */
+
+#pragma once
+
+#include "cad_types.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace qcs::cad {
+
+// =============================================================================
+// Line Segments
+// =============================================================================
+
+/// One segment as the line shader reads it; matches struct LineSegment there
+struct LineSegment {
+    std::array<float, 3> start{};  ///< Relative to the batch origin
+    float distance = -1.0f;        ///< Along the entity up to start; negative marks an unused slot
+    std::array<float, 3> end{};
+    uint32_t color = 0;            ///< RGBA, as cad_color_to_rgba packs it
+
+    bool is_used() const { return distance >= 0.0f; }
+};
+static_assert(sizeof(LineSegment) == 32, "LineSegment must match the shader's layout");
+
+/// Segments of the lines and arcs drawn in one style, kept between frames
+///
+/// Each entity owns a contiguous span of segments. Editing an entity
+/// rewrites its span in place when the new polyline fits and moves it
+/// otherwise; freed spans are left as unused slots, which the shader
+/// discards, and reused by entities needing exactly that many segments.
+/// Every write is recorded so callers upload only the ranges that changed.
+class LineBatch {
+public:
+    /// A range of segment slots
+    struct Range {
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+
+    /// Positions are stored in single precision relative to origin
+    explicit LineBatch(const Point3D& origin = Point3D::Zero());
+
+    /// Stores the entity as the segments between consecutive points,
+    /// replacing what it had; fewer than two points removes it
+    void set_entity(EntityID id, std::span<const Point3D> polyline, uint32_t rgba);
+    bool remove_entity(EntityID id);
+    void clear();
+
+    bool contains(EntityID id) const { return spans_.count(id) != 0; }
+    /// The entity's segments, or an empty range if absent
+    Range get_span(EntityID id) const;
+    size_t get_entity_count() const { return spans_.size(); }
+
+    const Point3D& get_origin() const { return origin_; }
+    const std::vector<LineSegment>& get_segments() const { return segments_; }
+    size_t get_used_segment_count() const { return used_segments_; }
+    size_t get_unused_segment_count() const { return segments_.size() - used_segments_; }
+
+    /// Moves every span to the front, dropping the unused slots; the whole
+    /// batch becomes dirty
+    void compact();
+
+    bool has_dirty_ranges() const { return !dirty_.empty(); }
+    /// Ranges written since the last call, sorted, with ranges closer than
+    /// max_gap slots merged
+    std::vector<Range> take_dirty_ranges(uint32_t max_gap = 32);
+
+    /// Ranges covering the given entities' segments, sorted, for drawing.
+    /// Ranges closer than max_gap slots are merged, the gap widened until
+    /// there are at most max_ranges; entities not in the batch are skipped.
+    std::vector<Range> get_draw_ranges(std::span<const EntityID> ids, uint32_t max_gap = 64,
+                                       size_t max_ranges = 256) const;
+
+    /// Sorts the ranges and merges those closer than max_gap slots
+    static void merge_ranges(std::vector<Range>& ranges, uint32_t max_gap);
+
+private:
+    struct Span {
+        uint32_t first = 0;
+        uint32_t capacity = 0;
+        uint32_t count = 0;
+    };
+
+    Point3D origin_;
+    std::vector<LineSegment> segments_;
+    std::unordered_map<EntityID, Span> spans_;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> free_spans_;  // First slots by capacity
+    std::vector<Range> dirty_;
+    size_t used_segments_ = 0;
+
+    Span allocate(uint32_t capacity);
+    void release(const Span& span);
+    void write(Span& span, std::span<const Point3D> polyline, uint32_t rgba);
+};
+
+} // namespace qcs::cad
@@ -0,0 +1,325 @@
+/**
+ * @file mesh_cache.cpp
+ * @brief Implementation of indexed display meshes and the tessellation cache
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Vertex welding, mesh merging and least-recently-used mesh eviction
+ */
+
+#include "mesh_cache.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace qcs::cad {
+
+namespace {
+
+/// Exact position of a soup vertex; tessellators emit shared corners bit
+/// for bit, so no tolerance is needed to weld them
+struct PositionKey {
+    std::array<uint64_t, 3> bits;
+
+    explicit PositionKey(const Point3D& point) {
+        for (int axis = 0; axis < 3; ++axis) {
+            const Precision value = point[axis] == 0.0 ? 0.0 : point[axis];  // -0 welds with +0
+            std::memcpy(&bits[axis], &value, sizeof(value));
+        }
+    }
+
+    bool operator==(const PositionKey& other) const { return bits == other.bits; }
+};
+
+struct PositionKeyHash {
+    size_t operator()(const PositionKey& key) const {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (uint64_t bits : key.bits) {
+            hash = (hash ^ bits) * 0x100000001b3ull;
+            hash ^= hash >> 29;
+        }
+        return static_cast<size_t>(hash);
+    }
+};
+
+std::array<float, 3> to_float(const Vector3D& v) {
+    return {static_cast<float>(v.x()), static_cast<float>(v.y()), static_cast<float>(v.z())};
+}
+
+Precision floor_power_of_two(Precision value) {
+    if (!(value > 0.0) || !std::isfinite(value)) {
+        return value;
+    }
+    return std::exp2(std::floor(std::log2(value)));
+}
+
+} // namespace
+
+// =============================================================================
+// TessellationTolerance Implementation
+// =============================================================================
+
+TessellationTolerance TessellationTolerance::quantized() const {
+    return {floor_power_of_two(chordal), floor_power_of_two(angular)};
+}
+
+// =============================================================================
+// IndexedMesh Implementation
+// =============================================================================
+
+IndexedMesh IndexedMesh::from_triangles(const std::vector<std::array<Point3D, 3>>& triangles, size_t face_id) {
+    IndexedMesh mesh;
+    for (const auto& triangle : triangles) {
+        for (const Point3D& corner : triangle) {
+            mesh.bounds.expand(corner);
+        }
+    }
+    if (!mesh.bounds.is_valid()) {
+        return mesh;
+    }
+    mesh.origin = mesh.bounds.center();
+
+    std::unordered_map<PositionKey, uint32_t, PositionKeyHash> welded;
+    welded.reserve(triangles.size());
+    std::vector<Vector3D> normals;
+    mesh.indices.reserve(triangles.size() * 3);
+
+    auto weld = [&](const Point3D& point) {
+        auto [it, inserted] = welded.try_emplace(PositionKey(point), static_cast<uint32_t>(mesh.vertices.size()));
+        if (inserted) {
+            mesh.vertices.push_back({to_float(point - mesh.origin), {}});
+            normals.push_back(Vector3D::Zero());
+        }
+        return it->second;
+    };
+
+    for (const auto& [a, b, c] : triangles) {
+        if (PositionKey(a) == PositionKey(b) || PositionKey(b) == PositionKey(c) || PositionKey(a) == PositionKey(c)) {
+            continue;
+        }
+
+        // Area-weighted, so slivers barely tilt their corners' normals
+        const Vector3D normal = (b - a).cross(c - a);
+        for (const Point3D* corner : {&a, &b, &c}) {
+            const uint32_t index = weld(*corner);
+            normals[index] += normal;
+            mesh.indices.push_back(index);
+        }
+    }
+
+    for (size_t i = 0; i < normals.size(); ++i) {
+        const Precision length = normals[i].norm();
+        if (length > 0.0) {
+            mesh.vertices[i].normal = to_float(normals[i] / length);
+        }
+    }
+    if (!mesh.indices.empty()) {
+        mesh.faces.push_back({face_id, 0, static_cast<uint32_t>(mesh.indices.size())});
+    }
+    return mesh;
+}
+
+void IndexedMesh::append(const IndexedMesh& other) {
+    if (other.empty()) {
+        return;
+    }
+    if (vertices.empty()) {
+        origin = other.origin;
+    }
+
+    const auto base_vertex = static_cast<uint32_t>(vertices.size());
+    const auto base_index = static_cast<uint32_t>(indices.size());
+    const Vector3D offset = other.origin - origin;
+    if (offset.isZero()) {
+        vertices.insert(vertices.end(), other.vertices.begin(), other.vertices.end());
+    } else {
+        vertices.reserve(vertices.size() + other.vertices.size());
+        for (const MeshVertex& vertex : other.vertices) {
+            const Vector3D position(vertex.position[0], vertex.position[1], vertex.position[2]);
+            vertices.push_back({to_float(position + offset), vertex.normal});
+        }
+    }
+
+    indices.reserve(indices.size() + other.indices.size());
+    for (uint32_t index : other.indices) {
+        indices.push_back(base_vertex + index);
+    }
+    for (FaceRange range : other.faces) {
+        range.first_index += base_index;
+        faces.push_back(range);
+    }
+    bounds.expand(other.bounds);
+}
+
+Point3D IndexedMesh::get_position(uint32_t vertex) const {
+    const auto& position = vertices[vertex].position;
+    return origin + Vector3D(position[0], position[1], position[2]);
+}
+
+size_t IndexedMesh::memory_usage() const {
+    return sizeof(IndexedMesh) + vertices.capacity() * sizeof(MeshVertex) +
+           indices.capacity() * sizeof(uint32_t) + faces.capacity() * sizeof(FaceRange);
+}
+
+// =============================================================================
+// MeshCache Implementation
+// =============================================================================
+
+MeshCache::MeshCache(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+std::shared_ptr<const IndexedMesh> MeshCache::find(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return find_locked(key);
+}
+
+std::shared_ptr<const IndexedMesh> MeshCache::find_locked(const Key& key) {
+    auto it = faces_.find(key.face_id);
+    Entry* best = nullptr;
+    if (it != faces_.end()) {
+        for (Entry& entry : it->second) {
+            if (entry.revision != key.revision || !entry.tolerance.satisfies(key.tolerance)) {
+                continue;
+            }
+            // The coarsest mesh that is fine enough draws fastest
+            if (!best || best->tolerance.satisfies(entry.tolerance)) {
+                best = &entry;
+            }
+        }
+    }
+    if (!best) {
+        stats_.misses++;
+        return nullptr;
+    }
+    stats_.hits++;
+    best->last_used = ++clock_;
+    return best->mesh;
+}
+
+std::shared_ptr<const IndexedMesh> MeshCache::insert(const Key& key, IndexedMesh mesh) {
+    auto shared = std::make_shared<const IndexedMesh>(std::move(mesh));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entries = faces_[key.face_id];
+    for (const Entry& entry : entries) {
+        // A tessellation of a revision already superseded is not worth keeping
+        if (entry.revision > key.revision) {
+            return shared;
+        }
+        if (entry.revision == key.revision && entry.tolerance == key.tolerance) {
+            return entry.mesh;
+        }
+    }
+
+    auto stale = std::remove_if(entries.begin(), entries.end(), [&](const Entry& entry) {
+        return entry.revision < key.revision;
+    });
+    for (auto it = stale; it != entries.end(); ++it) {
+        bytes_ -= it->bytes;
+        entry_count_--;
+    }
+    entries.erase(stale, entries.end());
+
+    Entry entry;
+    entry.revision = key.revision;
+    entry.tolerance = key.tolerance;
+    entry.mesh = shared;
+    entry.bytes = shared->memory_usage();
+    entry.last_used = ++clock_;
+    bytes_ += entry.bytes;
+    entry_count_++;
+    entries.push_back(std::move(entry));
+
+    evict_locked();
+    return shared;
+}
+
+std::shared_ptr<const IndexedMesh> MeshCache::get_or_create(const Key& key,
+                                                            const std::function<IndexedMesh()>& tessellate) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (auto mesh = find_locked(key)) {
+            return mesh;
+        }
+    }
+    return insert(key, tessellate());
+}
+
+void MeshCache::evict_locked() {
+    if (bytes_ <= max_bytes_) {
+        return;
+    }
+
+    // Evict down to three quarters of the budget, so that a cache at its
+    // limit does not sort on every insert
+    std::vector<std::pair<uint64_t, size_t>> by_age;  // Last use, face ID
+    by_age.reserve(entry_count_);
+    for (const auto& [face_id, entries] : faces_) {
+        for (const Entry& entry : entries) {
+            by_age.emplace_back(entry.last_used, face_id);
+        }
+    }
+    std::sort(by_age.begin(), by_age.end());
+
+    const size_t target = max_bytes_ / 4 * 3;
+    for (const auto& [last_used, face_id] : by_age) {
+        if (bytes_ <= target) {
+            break;
+        }
+        auto face = faces_.find(face_id);
+        auto& entries = face->second;
+        auto it = std::find_if(entries.begin(), entries.end(), [used = last_used](const Entry& entry) {
+            return entry.last_used == used;
+        });
+        bytes_ -= it->bytes;
+        entry_count_--;
+        stats_.evictions++;
+        entries.erase(it);
+        if (entries.empty()) {
+            faces_.erase(face);
+        }
+    }
+}
+
+void MeshCache::invalidate(size_t face_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto face = faces_.find(face_id);
+    if (face == faces_.end()) {
+        return;
+    }
+    for (const Entry& entry : face->second) {
+        bytes_ -= entry.bytes;
+        entry_count_--;
+    }
+    faces_.erase(face);
+}
+
+void MeshCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    faces_.clear();
+    bytes_ = 0;
+    entry_count_ = 0;
+}
+
+size_t MeshCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entry_count_;
+}
+
+size_t MeshCache::memory_usage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+void MeshCache::set_max_bytes(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_bytes_ = bytes;
+    evict_locked();
+}
+
+MeshCache::Stats MeshCache::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace qcs::cad
@@ -0,0 +1,163 @@
+/**
+ * @file mesh_cache.hpp
+ * @brief Indexed display meshes and the tessellation cache shared by views
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Deduplicated vertex/index meshes cached by face revision and tolerance
+ */
+
+#pragma once
+
+#include "cad_types.hpp"
+#include "cad_common.hpp"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace qcs::cad {
+
+// =============================================================================
+// Tessellation Tolerance
+// =============================================================================
+
+/// How far a tessellation may depart from the exact surface
+struct TessellationTolerance {
+    Precision chordal = 1e-3;   ///< Maximum distance from the surface, model units
+    Precision angular = 0.2;    ///< Maximum normal deviation between neighbours, radians
+
+    /// Rounded down to powers of two, so tolerances derived from a smoothly
+    /// changing zoom share a few cache entries
+    TessellationTolerance quantized() const;
+
+    /// A mesh made to this tolerance is good enough for the other
+    bool satisfies(const TessellationTolerance& other) const {
+        return chordal <= other.chordal && angular <= other.angular;
+    }
+
+    bool operator==(const TessellationTolerance& other) const {
+        return chordal == other.chordal && angular == other.angular;
+    }
+};
+
+// =============================================================================
+// Indexed Mesh
+// =============================================================================
+
+/// Vertex as the mesh shader reads it
+struct MeshVertex {
+    std::array<float, 3> position{};  ///< Relative to the mesh origin
+    std::array<float, 3> normal{};
+};
+static_assert(sizeof(MeshVertex) == 24, "MeshVertex must match the shader's layout");
+
+/// Triangle mesh with shared vertices, ready for upload
+///
+/// Positions are single precision relative to a double-precision origin
+/// near the mesh, so parts far from the world origin keep sub-micron
+/// detail. Vertices are welded within each face but not across faces,
+/// which keeps creases between faces sharp.
+struct IndexedMesh {
+    /// The indices of one face of a solid mesh
+    struct FaceRange {
+        size_t face_id = 0;
+        uint32_t first_index = 0;
+        uint32_t index_count = 0;
+    };
+
+    Point3D origin = Point3D::Zero();
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;              ///< Three per triangle, counter-clockwise
+    std::vector<FaceRange> faces;
+    BoundingBox3D bounds{Point3D::Ones(), -Point3D::Ones()};  ///< Invalid while empty
+
+    /// Welds the vertices of a triangle soup and derives smooth normals.
+    /// Triangles that collapse once welded are dropped.
+    static IndexedMesh from_triangles(const std::vector<std::array<Point3D, 3>>& triangles, size_t face_id = 0);
+
+    /// Appends another mesh, rebasing its positions onto this origin
+    void append(const IndexedMesh& other);
+
+    bool empty() const { return indices.empty(); }
+    size_t get_vertex_count() const { return vertices.size(); }
+    size_t get_triangle_count() const { return indices.size() / 3; }
+    Point3D get_position(uint32_t vertex) const;
+    size_t memory_usage() const;
+};
+
+// =============================================================================
+// Mesh Cache
+// =============================================================================
+
+/// Face meshes shared by every view of a model
+///
+/// Entries are keyed by face ID, the face's revision and the tolerance they
+/// were made to; a lookup takes the coarsest entry that satisfies the
+/// requested tolerance. Inserting a newer revision of a face drops the
+/// older ones. Past the memory budget, least recently used meshes go first;
+/// meshes still held by a caller stay alive until released. Thread-safe.
+class MeshCache {
+public:
+    static constexpr size_t DEFAULT_MAX_BYTES = size_t(512) << 20;
+
+    struct Key {
+        size_t face_id = 0;
+        uint64_t revision = 0;
+        TessellationTolerance tolerance;
+    };
+
+    explicit MeshCache(size_t max_bytes = DEFAULT_MAX_BYTES);
+
+    MeshCache(const MeshCache&) = delete;
+    MeshCache& operator=(const MeshCache&) = delete;
+
+    std::shared_ptr<const IndexedMesh> find(const Key& key);
+    std::shared_ptr<const IndexedMesh> insert(const Key& key, IndexedMesh mesh);
+
+    /// Finds the mesh or makes it with tessellate, outside the lock. Threads
+    /// missing the same key at once may both tessellate; the first insert wins.
+    std::shared_ptr<const IndexedMesh> get_or_create(const Key& key, const std::function<IndexedMesh()>& tessellate);
+
+    void invalidate(size_t face_id);
+    void clear();
+
+    size_t size() const;
+    size_t memory_usage() const;
+    void set_max_bytes(size_t bytes);
+    size_t get_max_bytes() const { return max_bytes_; }
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+    Stats get_stats() const;
+
+private:
+    struct Entry {
+        uint64_t revision = 0;
+        TessellationTolerance tolerance;
+        std::shared_ptr<const IndexedMesh> mesh;
+        size_t bytes = 0;
+        uint64_t last_used = 0;
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<size_t, std::vector<Entry>> faces_;  // By face ID
+    size_t max_bytes_;
+    size_t bytes_ = 0;
+    size_t entry_count_ = 0;
+    uint64_t clock_ = 0;
+    Stats stats_;
+
+    std::shared_ptr<const IndexedMesh> find_locked(const Key& key);
+    void evict_locked();
+};
+
+} // namespace qcs::cad
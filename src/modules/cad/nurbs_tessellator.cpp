@@ -0,0 +1,657 @@
+/**
+ * @file nurbs_tessellator.cpp
+ * @brief Implementation of batched NURBS evaluation and tessellation
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Blocked Cox-de Boor recurrence, breadth-first bisection and grid meshing
+ */
+
+#include "nurbs_tessellator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace qcs::cad {
+
+namespace {
+
+using Homogeneous = Eigen::Matrix<Precision, 4, 1>;
+
+/// Knots, degree and weights a curve actually evaluates with
+struct ResolvedCurve {
+    int degree = 0;
+    std::vector<Precision> knots;
+    std::vector<Precision> weights;
+};
+
+int resolve_degree(int degree, size_t control_count) {
+    return std::clamp(degree, 0, static_cast<int>(control_count) - 1);
+}
+
+std::vector<Precision> resolve_knots(const std::vector<Precision>& knots, int requested_degree, int degree,
+                                     size_t control_count) {
+    if (degree == requested_degree && knots.size() == control_count + degree + 1) {
+        return knots;
+    }
+    return clamped_uniform_knots(control_count, degree);
+}
+
+ResolvedCurve resolve(const NURBSCurve& curve) {
+    const size_t count = curve.control_points.size();
+    ResolvedCurve resolved;
+    resolved.degree = resolve_degree(curve.degree, count);
+    resolved.knots = resolve_knots(curve.knot_vector, curve.degree, resolved.degree, count);
+    resolved.weights = curve.weights.size() == count ? curve.weights : std::vector<Precision>(count, 1.0);
+    return resolved;
+}
+
+/// Index of the last knot span of non-zero length
+uint32_t last_span(std::span<const Precision> knots, int degree, size_t control_count) {
+    const auto begin = knots.begin() + degree;
+    const auto it = std::lower_bound(begin, knots.begin() + control_count + 1, knots[control_count]);
+    return static_cast<uint32_t>(std::max<ptrdiff_t>(it - knots.begin() - 1, degree));
+}
+
+/// Parameters splitting every non-empty knot span into pieces(span) equal parts
+template <typename Pieces>
+std::vector<Precision> span_parameters(std::span<const Precision> knots, int degree, size_t control_count,
+                                       Pieces pieces) {
+    std::vector<Precision> params{knots[degree]};
+    for (size_t s = degree; s < control_count; ++s) {
+        const Precision a = knots[s], b = knots[s + 1];
+        if (!(b > a)) {
+            continue;
+        }
+        const int count = pieces(s);
+        for (int k = 1; k < count; ++k) {
+            params.push_back(a + (b - a) * k / count);
+        }
+        params.push_back(b);
+    }
+    return params;
+}
+
+Precision distance_to_segment(const Point3D& point, const Point3D& a, const Point3D& b) {
+    const Vector3D chord = b - a;
+    const Precision length_squared = chord.squaredNorm();
+    if (length_squared == 0.0) {
+        return (point - a).norm();
+    }
+    const Precision t = std::clamp((point - a).dot(chord) / length_squared, Precision(0), Precision(1));
+    return (point - (a + t * chord)).norm();
+}
+
+std::array<float, 3> to_float(const Vector3D& v) {
+    return {static_cast<float>(v.x()), static_cast<float>(v.y()), static_cast<float>(v.z())};
+}
+
+/// FNV-1a over raw bytes
+struct Fingerprint {
+    uint64_t hash = 0xcbf29ce484222325ull;
+
+    void add(const void* data, size_t bytes) {
+        const auto* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; ++i) {
+            hash = (hash ^ p[i]) * 0x100000001b3ull;
+        }
+    }
+    template <typename T>
+    void add(const T& value) { add(&value, sizeof(value)); }
+    void add(const std::vector<Precision>& values) {
+        add(values.size());
+        add(values.data(), values.size() * sizeof(Precision));
+    }
+    void add(const Point3D& point) { add(point.data(), 3 * sizeof(Precision)); }
+};
+
+} // namespace
+
+// =============================================================================
+// Basis Functions
+// =============================================================================
+
+std::vector<Precision> clamped_uniform_knots(size_t control_count, int degree) {
+    std::vector<Precision> knots(control_count + degree + 1, 0.0);
+    const size_t interior = control_count - degree;  // Number of spans
+    for (size_t i = 0; i < knots.size(); ++i) {
+        const ptrdiff_t k = static_cast<ptrdiff_t>(i) - degree;
+        knots[i] = static_cast<Precision>(std::clamp<ptrdiff_t>(k, 0, interior)) / interior;
+    }
+    return knots;
+}
+
+BasisTable evaluate_basis(std::span<const Precision> knots, int degree, size_t control_count,
+                          std::span<const Precision> params, bool derivatives) {
+    if (degree < 0 || control_count < static_cast<size_t>(degree) + 1 ||
+        knots.size() != control_count + degree + 1) {
+        throw std::invalid_argument("Knot vector does not match the control points and degree");
+    }
+    if (!std::is_sorted(knots.begin(), knots.end()) || !(knots[control_count] > knots[degree])) {
+        throw std::invalid_argument("Knot vector must be non-decreasing with a non-empty range");
+    }
+
+    const int p = degree;
+    const size_t stride = p + 1;
+    const size_t n = params.size();
+    BasisTable table;
+    table.degree = p;
+    table.spans.resize(n);
+    table.values.resize(n * stride);
+    if (derivatives) {
+        table.derivatives.assign(n * stride, 0.0);
+    }
+
+    const Precision lo = knots[p], hi = knots[control_count];
+    const uint32_t top = last_span(knots, p, control_count);
+    std::vector<Precision> u;
+    for (size_t i = 0; i < n; ++i) {
+        const Precision t = std::clamp(params[i], lo, hi);
+        if (t >= hi) {
+            table.spans[i] = top;
+        } else {
+            const auto it = std::upper_bound(knots.begin() + p, knots.begin() + control_count + 1, t);
+            table.spans[i] = static_cast<uint32_t>(it - knots.begin() - 1);
+        }
+    }
+
+    // Each block of parameters sharing a span runs the recurrence level by
+    // level with the parameter loop innermost; the denominators depend only
+    // on the span, and are never zero inside a non-empty one
+    std::vector<Precision> N, left, right, saved, lower;
+    for (size_t begin = 0; begin < n;) {
+        const uint32_t s = table.spans[begin];
+        size_t end = begin + 1;
+        while (end < n && table.spans[end] == s) {
+            ++end;
+        }
+        const size_t m = end - begin;
+
+        u.resize(m);
+        for (size_t t = 0; t < m; ++t) {
+            u[t] = std::clamp(params[begin + t], lo, hi);
+        }
+        N.assign(stride * m, 0.0);
+        left.resize(stride * m);
+        right.resize(stride * m);
+        saved.resize(m);
+        std::fill_n(N.begin(), m, 1.0);
+
+        for (int j = 1; j <= p; ++j) {
+            if (derivatives && j == p) {
+                lower.assign(N.begin(), N.begin() + p * m);
+            }
+            Precision* lj = left.data() + j * m;
+            Precision* rj = right.data() + j * m;
+            const Precision kl = knots[s + 1 - j], kr = knots[s + j];
+            for (size_t t = 0; t < m; ++t) {
+                lj[t] = u[t] - kl;
+                rj[t] = kr - u[t];
+            }
+            std::fill(saved.begin(), saved.end(), 0.0);
+            for (int r = 0; r < j; ++r) {
+                const Precision inverse = 1.0 / (knots[s + r + 1] - knots[s + r + 1 - j]);
+                Precision* nr = N.data() + r * m;
+                const Precision* rr = right.data() + (r + 1) * m;
+                const Precision* lr = left.data() + (j - r) * m;
+                for (size_t t = 0; t < m; ++t) {
+                    const Precision temp = nr[t] * inverse;
+                    nr[t] = saved[t] + rr[t] * temp;
+                    saved[t] = lr[t] * temp;
+                }
+            }
+            std::copy(saved.begin(), saved.end(), N.begin() + j * m);
+        }
+
+        for (size_t t = 0; t < m; ++t) {
+            for (size_t k = 0; k < stride; ++k) {
+                table.values[(begin + t) * stride + k] = N[k * m + t];
+            }
+        }
+
+        // N'(i,p) = p N(i,p-1) / (u[i+p] - u[i]) - p N(i+1,p-1) / (u[i+p+1] - u[i+1])
+        if (derivatives && p > 0) {
+            for (int k = 0; k <= p; ++k) {
+                const Precision a = k > 0 ? p / (knots[s + k] - knots[s - p + k]) : 0.0;
+                const Precision b = k < p ? p / (knots[s + k + 1] - knots[s - p + k + 1]) : 0.0;
+                for (size_t t = 0; t < m; ++t) {
+                    const Precision below = k > 0 ? lower[(k - 1) * m + t] : 0.0;
+                    const Precision here = k < p ? lower[k * m + t] : 0.0;
+                    table.derivatives[(begin + t) * stride + k] = a * below - b * here;
+                }
+            }
+        }
+        begin = end;
+    }
+    return table;
+}
+
+// =============================================================================
+// Batched Evaluation
+// =============================================================================
+
+std::pair<Precision, Precision> get_parameter_range(const NURBSCurve& curve) {
+    const size_t count = curve.control_points.size();
+    if (count == 0) {
+        return {0.0, 1.0};
+    }
+    const ResolvedCurve resolved = resolve(curve);
+    return {resolved.knots[resolved.degree], resolved.knots[count]};
+}
+
+void evaluate_curve(const NURBSCurve& curve, std::span<const Precision> params,
+                    std::vector<Point3D>& points, std::vector<Vector3D>* tangents) {
+    const size_t count = curve.control_points.size();
+    points.assign(params.size(), count == 1 ? curve.control_points[0] : Point3D::Zero());
+    if (tangents) {
+        tangents->assign(params.size(), Vector3D::Zero());
+    }
+    if (count < 2) {
+        return;
+    }
+
+    const ResolvedCurve resolved = resolve(curve);
+    const BasisTable basis = evaluate_basis(resolved.knots, resolved.degree, count, params, tangents != nullptr);
+    for (size_t i = 0; i < params.size(); ++i) {
+        const size_t first = basis.spans[i] - resolved.degree;
+        const Precision* N = basis.get_values(i);
+        Vector3D a = Vector3D::Zero();
+        Precision w = 0.0;
+        for (int k = 0; k <= resolved.degree; ++k) {
+            const Precision nw = N[k] * resolved.weights[first + k];
+            a += nw * curve.control_points[first + k];
+            w += nw;
+        }
+        points[i] = a / w;
+
+        // C' = (A' - w' C) / w
+        if (tangents) {
+            const Precision* dN = basis.get_derivatives(i);
+            Vector3D da = Vector3D::Zero();
+            Precision dw = 0.0;
+            for (int k = 0; k <= resolved.degree; ++k) {
+                const Precision nw = dN[k] * resolved.weights[first + k];
+                da += nw * curve.control_points[first + k];
+                dw += nw;
+            }
+            (*tangents)[i] = (da - dw * points[i]) / w;
+        }
+    }
+}
+
+void evaluate_surface_grid(const NURBSSurface& surface, std::span<const Precision> u_params,
+                           std::span<const Precision> v_params, SurfaceGrid& grid) {
+    const size_t nu = surface.control_points.size();
+    const size_t nv = nu > 0 ? surface.control_points[0].size() : 0;
+    grid.u_count = u_params.size();
+    grid.v_count = v_params.size();
+    grid.points.assign(grid.u_count * grid.v_count, Point3D::Zero());
+    grid.normals.assign(grid.points.size(), Vector3D::Zero());
+    if (nu == 0 || nv == 0) {
+        return;
+    }
+    for (const auto& row : surface.control_points) {
+        if (row.size() != nv) {
+            throw std::invalid_argument("Every row of a NURBS surface's control net must be the same length");
+        }
+    }
+
+    const int pu = resolve_degree(surface.u_degree, nu);
+    const int pv = resolve_degree(surface.v_degree, nv);
+    const auto u_knots = resolve_knots(surface.u_knots, surface.u_degree, pu, nu);
+    const auto v_knots = resolve_knots(surface.v_knots, surface.v_degree, pv, nv);
+    const bool rational = surface.weights.size() == nu &&
+        std::all_of(surface.weights.begin(), surface.weights.end(), [nv](const auto& row) { return row.size() == nv; });
+
+    const BasisTable bu = evaluate_basis(u_knots, pu, nu, u_params, true);
+    const BasisTable bv = evaluate_basis(v_knots, pv, nv, v_params, true);
+
+    // The u basis folds the net down to one homogeneous curve per row of
+    // the grid, with its u derivative; the v basis then finishes each point
+    std::vector<Homogeneous> R(nv), dR(nv);
+    for (size_t i = 0; i < grid.u_count; ++i) {
+        const size_t first_u = bu.spans[i] - pu;
+        const Precision* Nu = bu.get_values(i);
+        const Precision* dNu = bu.get_derivatives(i);
+        for (size_t c = 0; c < nv; ++c) {
+            Homogeneous r = Homogeneous::Zero(), dr = Homogeneous::Zero();
+            for (int k = 0; k <= pu; ++k) {
+                const Point3D& point = surface.control_points[first_u + k][c];
+                const Precision w = rational ? surface.weights[first_u + k][c] : 1.0;
+                const Homogeneous h(point.x() * w, point.y() * w, point.z() * w, w);
+                r += Nu[k] * h;
+                dr += dNu[k] * h;
+            }
+            R[c] = r;
+            dR[c] = dr;
+        }
+
+        for (size_t j = 0; j < grid.v_count; ++j) {
+            const size_t first_v = bv.spans[j] - pv;
+            const Precision* Nv = bv.get_values(j);
+            const Precision* dNv = bv.get_derivatives(j);
+            Homogeneous S = Homogeneous::Zero(), Su = Homogeneous::Zero(), Sv = Homogeneous::Zero();
+            for (int l = 0; l <= pv; ++l) {
+                S += Nv[l] * R[first_v + l];
+                Su += Nv[l] * dR[first_v + l];
+                Sv += dNv[l] * R[first_v + l];
+            }
+            const Point3D point = S.head<3>() / S.w();
+            const Vector3D du = (Su.head<3>() - Su.w() * point) / S.w();
+            const Vector3D dv = (Sv.head<3>() - Sv.w() * point) / S.w();
+            const Vector3D normal = du.cross(dv);
+            const Precision length = normal.norm();
+
+            const size_t index = grid.index(i, j);
+            grid.points[index] = point;
+            grid.normals[index] = length > 0.0 ? Vector3D(normal / length) : Vector3D::Zero();
+        }
+    }
+}
+
+// =============================================================================
+// Tessellation
+// =============================================================================
+
+std::vector<Point3D> tessellate_curve(const NURBSCurve& curve, Precision tolerance, int max_depth) {
+    if (!(tolerance > 0.0)) {
+        throw std::invalid_argument("Tessellation tolerance must be positive");
+    }
+    const size_t count = curve.control_points.size();
+    if (count < 2) {
+        return curve.control_points;
+    }
+
+    // Enough samples per span that an S-bend cannot hide between two of
+    // them with its midpoint on the chord
+    const ResolvedCurve resolved = resolve(curve);
+    const int p = resolved.degree;
+    std::vector<Precision> params =
+        span_parameters(resolved.knots, p, count, [p](size_t) { return p <= 1 ? 1 : 2 * p; });
+    std::vector<Point3D> points;
+    evaluate_curve(curve, params, points);
+    if (p <= 1) {
+        return points;
+    }
+
+    std::vector<char> settled(params.size() - 1, 0);
+    std::vector<Precision> middles;
+    std::vector<size_t> segments;
+    std::vector<Point3D> middle_points;
+    for (int depth = 0; depth < max_depth; ++depth) {
+        middles.clear();
+        segments.clear();
+        for (size_t i = 0; i + 1 < params.size(); ++i) {
+            if (!settled[i]) {
+                middles.push_back(0.5 * (params[i] + params[i + 1]));
+                segments.push_back(i);
+            }
+        }
+        if (middles.empty()) {
+            break;
+        }
+        evaluate_curve(curve, middles, middle_points);
+
+        std::vector<Precision> next_params;
+        std::vector<Point3D> next_points;
+        std::vector<char> next_settled;
+        next_params.reserve(params.size() + middles.size());
+        next_points.reserve(params.size() + middles.size());
+        next_settled.reserve(params.size() + middles.size());
+        size_t m = 0;
+        for (size_t i = 0; i + 1 < params.size(); ++i) {
+            next_params.push_back(params[i]);
+            next_points.push_back(points[i]);
+            if (m < segments.size() && segments[m] == i) {
+                if (distance_to_segment(middle_points[m], points[i], points[i + 1]) > tolerance) {
+                    next_params.push_back(middles[m]);
+                    next_points.push_back(middle_points[m]);
+                    next_settled.push_back(0);
+                    next_settled.push_back(0);
+                } else {
+                    next_settled.push_back(1);
+                }
+                ++m;
+            } else {
+                next_settled.push_back(1);
+            }
+        }
+        next_params.push_back(params.back());
+        next_points.push_back(points.back());
+
+        const bool refined = next_params.size() > params.size();
+        params.swap(next_params);
+        points.swap(next_points);
+        settled.swap(next_settled);
+        if (!refined) {
+            break;
+        }
+    }
+    return points;
+}
+
+IndexedMesh tessellate_surface(const NURBSSurface& surface, Precision tolerance, int max_depth) {
+    if (!(tolerance > 0.0)) {
+        throw std::invalid_argument("Tessellation tolerance must be positive");
+    }
+    IndexedMesh mesh;
+    const size_t nu = surface.control_points.size();
+    const size_t nv = nu > 0 ? surface.control_points[0].size() : 0;
+    if (nu < 2 || nv < 2) {
+        return mesh;
+    }
+
+    const int pu = resolve_degree(surface.u_degree, nu);
+    const int pv = resolve_degree(surface.v_degree, nv);
+    const auto u_knots = resolve_knots(surface.u_knots, surface.u_degree, pu, nu);
+    const auto v_knots = resolve_knots(surface.v_knots, surface.v_degree, pv, nv);
+    const int max_pieces = 1 << std::clamp(max_depth, 0, 16);
+    const auto& net = surface.control_points;
+
+    // A degree p Bezier strays at most p(p - 1)/8 max|second difference| / n^2
+    // from its n-segment polyline; applied per span to the control points
+    // that span depends on
+    auto pieces = [&](int degree, bool along_u, size_t span) {
+        if (degree <= 1) {
+            return 1;
+        }
+        Precision second = 0.0;
+        const size_t other = along_u ? nv : nu;
+        for (size_t r = span - degree + 1; r < span; ++r) {
+            for (size_t c = 0; c < other; ++c) {
+                const Vector3D d = along_u ? Vector3D(net[r + 1][c] - 2.0 * net[r][c] + net[r - 1][c])
+                                           : Vector3D(net[c][r + 1] - 2.0 * net[c][r] + net[c][r - 1]);
+                second = std::max(second, d.norm());
+            }
+        }
+        const Precision n = std::ceil(std::sqrt(degree * (degree - 1) / 8.0 * second / tolerance));
+        return static_cast<int>(std::clamp<Precision>(n, 1, max_pieces));
+    };
+    const auto u_params = span_parameters(u_knots, pu, nu, [&](size_t s) { return pieces(pu, true, s); });
+    const auto v_params = span_parameters(v_knots, pv, nv, [&](size_t s) { return pieces(pv, false, s); });
+
+    SurfaceGrid grid;
+    evaluate_surface_grid(surface, u_params, v_params, grid);
+    for (const Point3D& point : grid.points) {
+        mesh.bounds.expand(point);
+    }
+    mesh.origin = mesh.bounds.center();
+
+    // Poles and creases have no normal of their own; they take the
+    // area-weighted average of their triangles'
+    std::vector<Vector3D> fallback(grid.points.size(), Vector3D::Zero());
+    mesh.indices.reserve((grid.u_count - 1) * (grid.v_count - 1) * 6);
+    auto add = [&](size_t a, size_t b, size_t c) {
+        const Vector3D normal = (grid.points[b] - grid.points[a]).cross(grid.points[c] - grid.points[a]);
+        if (normal.isZero(0.0)) {
+            return;
+        }
+        for (size_t index : {a, b, c}) {
+            fallback[index] += normal;
+            mesh.indices.push_back(static_cast<uint32_t>(index));
+        }
+    };
+    for (size_t i = 0; i + 1 < grid.u_count; ++i) {
+        for (size_t j = 0; j + 1 < grid.v_count; ++j) {
+            const size_t a = grid.index(i, j), b = grid.index(i + 1, j);
+            const size_t c = grid.index(i + 1, j + 1), d = grid.index(i, j + 1);
+            add(a, b, c);
+            add(a, c, d);
+        }
+    }
+
+    mesh.vertices.resize(grid.points.size());
+    for (size_t i = 0; i < grid.points.size(); ++i) {
+        Vector3D normal = grid.normals[i];
+        if (normal.isZero(0.0) && fallback[i].norm() > 0.0) {
+            normal = fallback[i].normalized();
+        }
+        mesh.vertices[i] = {to_float(grid.points[i] - mesh.origin), to_float(normal)};
+    }
+    if (!mesh.indices.empty()) {
+        mesh.faces.push_back({0, 0, static_cast<uint32_t>(mesh.indices.size())});
+    }
+    return mesh;
+}
+
+uint64_t fingerprint(const NURBSCurve& curve) {
+    Fingerprint hash;
+    hash.add(curve.degree);
+    hash.add(curve.control_points.size());
+    for (const Point3D& point : curve.control_points) {
+        hash.add(point);
+    }
+    hash.add(curve.weights);
+    hash.add(curve.knot_vector);
+    return hash.hash;
+}
+
+uint64_t fingerprint(const NURBSSurface& surface) {
+    Fingerprint hash;
+    hash.add(surface.u_degree);
+    hash.add(surface.v_degree);
+    hash.add(surface.control_points.size());
+    for (const auto& row : surface.control_points) {
+        hash.add(row.size());
+        for (const Point3D& point : row) {
+            hash.add(point);
+        }
+    }
+    hash.add(surface.weights.size());
+    for (const auto& row : surface.weights) {
+        hash.add(row);
+    }
+    hash.add(surface.u_knots);
+    hash.add(surface.v_knots);
+    return hash.hash;
+}
+
+// =============================================================================
+// PolylineCache Implementation
+// =============================================================================
+
+PolylineCache::PolylineCache(size_t max_points) : max_points_(max_points) {}
+
+std::shared_ptr<const PolylineCache::Polyline> PolylineCache::find(uint64_t key, Precision tolerance) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = curves_.find(key);
+    Entry* best = nullptr;
+    if (it != curves_.end()) {
+        for (Entry& entry : it->second) {
+            if (entry.tolerance <= tolerance && (!best || entry.tolerance > best->tolerance)) {
+                best = &entry;
+            }
+        }
+    }
+    if (!best) {
+        stats_.misses++;
+        return nullptr;
+    }
+    stats_.hits++;
+    best->last_used = ++clock_;
+    return best->polyline;
+}
+
+std::shared_ptr<const PolylineCache::Polyline> PolylineCache::insert(uint64_t key, Precision tolerance,
+                                                                     Polyline polyline) {
+    auto shared = std::make_shared<const Polyline>(std::move(polyline));
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entries = curves_[key];
+    for (Entry& entry : entries) {
+        if (entry.tolerance == tolerance) {
+            entry.last_used = ++clock_;
+            return entry.polyline;
+        }
+    }
+
+    Entry entry;
+    entry.tolerance = tolerance;
+    entry.polyline = shared;
+    entry.last_used = ++clock_;
+    points_ += shared->size();
+    entry_count_++;
+    entries.push_back(std::move(entry));
+    evict_locked();
+    return shared;
+}
+
+void PolylineCache::evict_locked() {
+    if (points_ <= max_points_) {
+        return;
+    }
+
+    // As MeshCache: down to three quarters of the budget at a time
+    std::vector<std::pair<uint64_t, uint64_t>> by_age;  // Last use, key
+    by_age.reserve(entry_count_);
+    for (const auto& [key, entries] : curves_) {
+        for (const Entry& entry : entries) {
+            by_age.emplace_back(entry.last_used, key);
+        }
+    }
+    std::sort(by_age.begin(), by_age.end());
+
+    const size_t target = max_points_ / 4 * 3;
+    for (const auto& [last_used, key] : by_age) {
+        if (points_ <= target) {
+            break;
+        }
+        auto curve = curves_.find(key);
+        auto& entries = curve->second;
+        auto it = std::find_if(entries.begin(), entries.end(), [used = last_used](const Entry& entry) {
+            return entry.last_used == used;
+        });
+        points_ -= it->polyline->size();
+        entry_count_--;
+        stats_.evictions++;
+        entries.erase(it);
+        if (entries.empty()) {
+            curves_.erase(curve);
+        }
+    }
+}
+
+void PolylineCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    curves_.clear();
+    points_ = 0;
+    entry_count_ = 0;
+}
+
+size_t PolylineCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entry_count_;
+}
+
+size_t PolylineCache::get_point_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return points_;
+}
+
+PolylineCache::Stats PolylineCache::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace qcs::cad
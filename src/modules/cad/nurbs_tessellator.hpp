@@ -0,0 +1,153 @@
+/**
+ * @file nurbs_tessellator.hpp
+ * @brief Batched NURBS evaluation and tolerance-driven tessellation
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * De Boor basis tables, adaptive polylines, surface grids and LOD caching
+ */
+
+#pragma once
+
+#include "cad_types.hpp"
+#include "mesh_cache.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace qcs::cad {
+
+// =============================================================================
+// Basis Functions
+// =============================================================================
+
+/// B-spline basis functions of one knot vector at many parameters
+///
+/// Parameters falling in the same knot span are evaluated together, one
+/// level of the de Boor triangle at a time across the whole block, so the
+/// inner loops run over parameters and vectorise. Tensor-product surfaces
+/// evaluate a table per direction and reuse it across the whole grid.
+struct BasisTable {
+    int degree = 0;
+    std::vector<uint32_t> spans;         ///< Knot span of each parameter
+    std::vector<Precision> values;       ///< degree + 1 per parameter, for control points span - degree on
+    std::vector<Precision> derivatives;  ///< Same layout; empty unless asked for
+
+    size_t size() const { return spans.size(); }
+    const Precision* get_values(size_t i) const { return values.data() + i * (degree + 1); }
+    const Precision* get_derivatives(size_t i) const { return derivatives.data() + i * (degree + 1); }
+};
+
+/// Throws std::invalid_argument unless knots has control_count + degree + 1
+/// non-decreasing entries. Parameters are clamped to the knots' range.
+BasisTable evaluate_basis(std::span<const Precision> knots, int degree, size_t control_count,
+                          std::span<const Precision> params, bool derivatives = false);
+
+/// Clamped knots spaced evenly over [0, 1]
+std::vector<Precision> clamped_uniform_knots(size_t control_count, int degree);
+
+// =============================================================================
+// Batched Evaluation
+// =============================================================================
+
+/// Curve points at many parameters, and tangents (not normalised) if asked.
+/// Missing or mismatched knots and weights fall back to clamped uniform
+/// knots and unit weights.
+void evaluate_curve(const NURBSCurve& curve, std::span<const Precision> params,
+                    std::vector<Point3D>& points, std::vector<Vector3D>* tangents = nullptr);
+
+/// Surface points and unit normals over the grid of u_params by v_params,
+/// u-major
+struct SurfaceGrid {
+    size_t u_count = 0;
+    size_t v_count = 0;
+    std::vector<Point3D> points;
+    std::vector<Vector3D> normals;
+
+    size_t index(size_t i, size_t j) const { return i * v_count + j; }
+};
+
+void evaluate_surface_grid(const NURBSSurface& surface, std::span<const Precision> u_params,
+                           std::span<const Precision> v_params, SurfaceGrid& grid);
+
+/// The curve's parameter range, from its knots
+std::pair<Precision, Precision> get_parameter_range(const NURBSCurve& curve);
+
+// =============================================================================
+// Tessellation
+// =============================================================================
+
+/// Polyline within tolerance of the curve
+///
+/// Starts from a few samples per knot span, then bisects every segment
+/// whose midpoint strays further than tolerance from its chord, up to
+/// max_depth times. All midpoints of a pass are evaluated in one batch.
+std::vector<Point3D> tessellate_curve(const NURBSCurve& curve, Precision tolerance, int max_depth = 8);
+
+/// Triangle mesh within roughly tolerance of the surface
+///
+/// Each knot span is divided as finely as the control net's second
+/// differences require for the tolerance, capped at 2^max_depth, and the
+/// resulting grid is evaluated in one pass.
+IndexedMesh tessellate_surface(const NURBSSurface& surface, Precision tolerance, int max_depth = 8);
+
+/// Hash of everything the geometry's shape depends on, as a cache key
+uint64_t fingerprint(const NURBSCurve& curve);
+uint64_t fingerprint(const NURBSSurface& surface);
+
+// =============================================================================
+// Polyline Cache
+// =============================================================================
+
+/// Curve tessellations kept across frames at a few levels of detail
+///
+/// Entries are keyed by geometry fingerprint and chordal tolerance; a
+/// lookup takes the coarsest entry at or below the requested tolerance, so
+/// callers passing power-of-two tolerances share a handful of levels per
+/// curve. Past the point budget, least recently used entries go first.
+/// Thread-safe.
+class PolylineCache {
+public:
+    using Polyline = std::vector<Point3D>;
+    static constexpr size_t DEFAULT_MAX_POINTS = size_t(8) << 20;
+
+    explicit PolylineCache(size_t max_points = DEFAULT_MAX_POINTS);
+
+    std::shared_ptr<const Polyline> find(uint64_t key, Precision tolerance);
+    std::shared_ptr<const Polyline> insert(uint64_t key, Precision tolerance, Polyline polyline);
+
+    void clear();
+    size_t size() const;
+    size_t get_point_count() const;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+    Stats get_stats() const;
+
+private:
+    struct Entry {
+        Precision tolerance = 0.0;
+        std::shared_ptr<const Polyline> polyline;
+        uint64_t last_used = 0;
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, std::vector<Entry>> curves_;
+    size_t max_points_;
+    size_t points_ = 0;
+    size_t entry_count_ = 0;
+    uint64_t clock_ = 0;
+    Stats stats_;
+
+    void evict_locked();
+};
+
+} // namespace qcs::cad
@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <cmath>
 #include <fstream>
+#include <limits>
 #include <sstream>
 
 namespace qcs::cad {
@@ -233,29 +234,37 @@ bool CADViewport::is_point_visible(const Point3D& point) const {
            screen_point.y() < viewport_rect_.y + viewport_rect_.height;
 }
 
+const ViewFrustum& CADViewport::get_frustum() const {
+    const_cast<CADViewport*>(this)->update_matrices();
+    return view_frustum_;
+}
+
 bool CADViewport::is_bounds_visible(const BoundingBox3D& bounds) const {
     if (!bounds.is_valid()) return false;
     
-    // Test all 8 corners of the bounding box
-    std::array<Point3D, 8> corners = {
-        Point3D(bounds.min.x(), bounds.min.y(), bounds.min.z()),
-        Point3D(bounds.max.x(), bounds.min.y(), bounds.min.z()),
-        Point3D(bounds.min.x(), bounds.max.y(), bounds.min.z()),
-        Point3D(bounds.max.x(), bounds.max.y(), bounds.min.z()),
-        Point3D(bounds.min.x(), bounds.min.y(), bounds.max.z()),
-        Point3D(bounds.max.x(), bounds.min.y(), bounds.max.z()),
-        Point3D(bounds.min.x(), bounds.max.y(), bounds.max.z()),
-        Point3D(bounds.max.x(), bounds.max.y(), bounds.max.z())
-    };
-    
-    // If any corner is visible, the bounds intersect the view frustum
-    for (const auto& corner : corners) {
-        if (is_point_visible(corner)) {
-            return true;
-        }
+    // Against the frustum planes rather than projected corners, so boxes
+    // larger than the view with every corner outside it still count
+    return get_frustum().intersects(bounds);
+}
+
+Precision CADViewport::get_world_units_per_pixel(const BoundingBox3D& bounds) const {
+    const Precision height = std::max(viewport_rect_.height, 1);
+    if (view_params_.orthographic) {
+        return view_params_.ortho_scale / height;
     }
     
-    return false;
+    // Perspective pixels grow with distance; the nearest corner in front of
+    // the camera sets the finest detail needed
+    Precision depth = std::numeric_limits<Precision>::infinity();
+    const Matrix4D& view = get_view_matrix();
+    for (int corner = 0; corner < 8; ++corner) {
+        const Point3D point((corner & 1) ? bounds.max.x() : bounds.min.x(),
+                            (corner & 2) ? bounds.max.y() : bounds.min.y(),
+                            (corner & 4) ? bounds.max.z() : bounds.min.z());
+        depth = std::min(depth, -(view * point.homogeneous()).z());
+    }
+    depth = std::max(depth, view_params_.near_plane);
+    return 2.0 * depth * std::tan(view_params_.fov * 0.5) / height;
 }
 
 void CADViewport::update_matrices() {
@@ -310,9 +319,7 @@ void CADViewport::update_matrices() {
 }
 
 void CADViewport::update_frustum() {
-    // Update view frustum for culling
-    // Implementation would calculate frustum planes from view-projection matrix
-    // For now, we use the simple bounding box approach
+    view_frustum_ = ViewFrustum::from_view_projection(view_projection_matrix_);
 }
 
 // =============================================================================
@@ -357,13 +364,13 @@ bool TechnicalLinetype::is_visible_at_parameter(Precision t) const {
     Precision param = std::fmod(t * total_length_, total_length_);
     if (param < 0) param += total_length_;
     
+    // Everything but gaps is drawn, as in the line shader
     Precision current_pos = 0;
     for (const auto& element : pattern_) {
         Precision element_length = element.length * element.scale;
         
         if (param >= current_pos && param < current_pos + element_length) {
-            return (element.type == LinePatternElement::Line || 
-                    element.type == LinePatternElement::Dot);
+            return element.type != LinePatternElement::Gap;
         }
         
         current_pos += element_length;
@@ -466,6 +473,1263 @@ TechnicalLinetype TechnicalLinetype::divide() {
     return linetype;
 }
 
+// =============================================================================
+// LinetypePatternTable Implementation
+// =============================================================================
+
+LinetypePatternTable::LinetypePatternTable()
+    : texels_(PATTERN_TEXELS, 0.0f) {
+}
+
+uint32_t LinetypePatternTable::get_row(const TechnicalLinetype& linetype) {
+    if (linetype.is_continuous()) {
+        return 0;
+    }
+    
+    std::array<float, PATTERN_TEXELS> row{};
+    uint32_t count = 0;
+    Precision period = 0.0;
+    for (const auto& element : linetype.get_pattern()) {
+        if (count == MAX_ELEMENTS) {
+            break;
+        }
+        const Precision length = std::abs(element.length * element.scale);
+        row[2 + count++] = static_cast<float>(element.type == LinePatternElement::Gap ? -length : length);
+        period += length;
+    }
+    if (period <= 0.0) {
+        return 0;
+    }
+    row[0] = static_cast<float>(period);
+    row[1] = static_cast<float>(count);
+    
+    auto [it, added] = rows_.try_emplace(linetype.get_name(), get_row_count());
+    if (added) {
+        texels_.resize(texels_.size() + PATTERN_TEXELS, 0.0f);
+    }
+    float* texels = texels_.data() + static_cast<size_t>(it->second) * PATTERN_TEXELS;
+    if (added || !std::equal(row.begin(), row.end(), texels)) {
+        std::copy(row.begin(), row.end(), texels);
+        dirty_ = true;
+    }
+    return it->second;
+}
+
+// =============================================================================
+// PrecisionRenderContext Text Implementation
+// =============================================================================
+
+void PrecisionRenderContext::render_text(const std::string& text, const Point3D& position,
+                                         const Vector3D& direction, Precision height,
+                                         Precision width_factor, Precision oblique_angle) {
+    auto font = get_font();
+    if (!font || text.empty() || height <= 0.0) {
+        return;
+    }
+    
+    Vector3D advance = direction.norm() > GEOMETRIC_TOLERANCE ? direction.normalized() : Vector3D::UnitX();
+    Vector3D up = Vector3D::UnitZ().cross(advance);
+    if (up.norm() <= GEOMETRIC_TOLERANCE) {
+        up = Vector3D::UnitY();
+    }
+    up = up.normalized() * height;
+    up += advance * (height * std::tan(oblique_angle));
+    advance *= height * width_factor;
+    
+    auto to_float = [](const Vector3D& v) {
+        return std::array<float, 3>{static_cast<float>(v.x()), static_cast<float>(v.y()), static_cast<float>(v.z())};
+    };
+    text_batch_->add_text(*font, text, to_float(position), to_float(advance), to_float(up),
+                          {static_cast<float>(current_color_.r), static_cast<float>(current_color_.g),
+                           static_cast<float>(current_color_.b), static_cast<float>(current_color_.a)});
+}
+
+void PrecisionRenderContext::flush_text() {
+    if (text_batch_->empty() || !rendering_engine_) {
+        return;
+    }
+    
+    if (text_uniform_id_ == 0) {
+        text_uniform_id_ = rendering_engine_->create_buffer(
+            sizeof(float) * 16,
+            QuantumCanvas::Rendering::BufferUsage::Uniform | QuantumCanvas::Rendering::BufferUsage::CopyDst);
+        if (text_uniform_id_ == 0) {
+            text_batch_->clear();
+            return;
+        }
+    }
+    
+    // Quads are in world space; the shader takes the single-precision
+    // column-major matrix, which is Eigen's default layout
+    const Eigen::Matrix4f view_projection = viewport_.get_view_projection_matrix().cast<float>();
+    rendering_engine_->update_buffer(text_uniform_id_, 0, sizeof(float) * 16, view_projection.data());
+    text_batch_->render(*rendering_engine_, text_uniform_id_);
+}
+
+bool PrecisionRenderContext::set_font(const std::string& name) {
+    auto font = text_batch_->atlas().find_font(name);
+    if (!font) {
+        return false;
+    }
+    current_font_ = font;
+    return true;
+}
+
+void PrecisionRenderContext::set_glyph_atlas(std::shared_ptr<QuantumCanvas::Rendering::GlyphAtlas> atlas) {
+    text_batch_->set_atlas(std::move(atlas));
+    current_font_.reset();
+}
+
+std::optional<QuantumCanvas::Rendering::FontId> PrecisionRenderContext::get_font() const {
+    return current_font_ ? current_font_ : text_batch_->shared_atlas()->default_font();
+}
+
+// =============================================================================
+// PrecisionRenderContext Layer Implementation
+// =============================================================================
+
+void PrecisionRenderContext::add_layer(const CADLayer& layer) {
+    layers_[layer.name] = layer;
+    layer_revision_++;
+}
+
+void PrecisionRenderContext::set_layer_visibility(const std::string& name, bool visible) {
+    auto it = layers_.find(name);
+    if (it != layers_.end() && it->second.visible != visible) {
+        it->second.visible = visible;
+        layer_revision_++;
+    }
+}
+
+const CADLayer* PrecisionRenderContext::get_layer(const std::string& name) const {
+    auto it = layers_.find(name);
+    return it != layers_.end() ? &it->second : nullptr;
+}
+
+void PrecisionRenderContext::add_linetype(const TechnicalLinetype& linetype) {
+    // Patterns are read each frame, so batched entities need no update
+    linetypes_.insert_or_assign(linetype.get_name(), linetype);
+}
+
+const TechnicalLinetype* PrecisionRenderContext::get_linetype(const std::string& name) const {
+    auto it = linetypes_.find(name);
+    return it != linetypes_.end() ? &it->second : nullptr;
+}
+
+// =============================================================================
+// PrecisionRenderContext Drawing Implementation
+// =============================================================================
+
+namespace {
+
+/// Per-style constants of the line shaders; matches struct LineStyle there
+struct LineStyle {
+    std::array<float, 16> view_projection{};  ///< Column-major, from batch-relative positions
+    std::array<float, 2> viewport{};          ///< In pixels
+    float width = 1.0f;                       ///< In pixels
+    float pattern_row = 0.0f;                 ///< In the linetype pattern texture
+    float pattern_scale = 1.0f;               ///< Drawing units per pattern unit
+    std::array<float, 3> padding{};
+};
+static_assert(sizeof(LineStyle) == 96, "LineStyle must match the shader's layout");
+
+constexpr Precision MM_PER_INCH = 25.4;
+
+bool is_batched(const CADEntity& entity) {
+    return entity.id != INVALID_ENTITY_ID &&
+           (dynamic_cast<const CADLine*>(&entity) != nullptr || dynamic_cast<const CADArc*>(&entity) != nullptr);
+}
+
+bool is_instanced(const CADEntity& entity) {
+    return entity.id != INVALID_ENTITY_ID && dynamic_cast<const CADBlockReference*>(&entity) != nullptr;
+}
+
+/// Kept between frames rather than drawn one by one
+bool is_retained(const CADEntity& entity) {
+    return is_batched(entity) || is_instanced(entity);
+}
+
+/// Declarations, quad expansion and the dashed, antialiased fragment stage
+/// shared by the line and block line shaders; each adds its own bindings
+/// from 2 on, including the patterns texture, and its vertex stage
+constexpr const char* LINE_SHADER_COMMON = R"(
+// LineStyle
+struct LineStyle {
+    viewProjection: mat4x4<f32>,
+    viewport: vec2<f32>,
+    width: f32,
+    patternRow: f32,
+    patternScale: f32,
+};
+
+// LineSegment
+struct LineSegment {
+    start: vec3<f32>,
+    distance: f32,
+    end: vec3<f32>,
+    color: u32,
+};
+
+@group(0) @binding(0) var<uniform> style: LineStyle;
+@group(0) @binding(1) var<storage, read> segments: array<LineSegment>;
+
+struct VertexOutput {
+    @builtin(position) position: vec4<f32>,
+    @location(0) color: vec4<f32>,
+    @location(1) distance: f32,
+    @location(2) across: f32,
+};
+
+// Unused slot: a degenerate quad outside the clip volume
+fn unused_vertex() -> VertexOutput {
+    var out: VertexOutput;
+    out.position = vec4<f32>(2.0, 2.0, 2.0, 1.0);
+    return out;
+}
+
+// One of the six vertices of the screen-space quad covering a segment;
+// distance is along the entity up to the segment's start
+fn expand_segment(clip0: vec4<f32>, clip1: vec4<f32>, vertex: u32, distance: f32, length: f32,
+                  color: u32) -> VertexOutput {
+    // x picks the end, y the side of the line
+    var corners = array<vec2<f32>, 6>(
+        vec2<f32>(0.0, -1.0), vec2<f32>(1.0, -1.0), vec2<f32>(1.0, 1.0),
+        vec2<f32>(0.0, -1.0), vec2<f32>(1.0, 1.0), vec2<f32>(0.0, 1.0));
+    let corner = corners[vertex];
+
+    let screen0 = clip0.xy / clip0.w * style.viewport;
+    let screen1 = clip1.xy / clip1.w * style.viewport;
+    let delta = screen1 - screen0;
+    let direction = select(vec2<f32>(1.0, 0.0), normalize(delta), dot(delta, delta) > 0.0);
+    let side = vec2<f32>(-direction.y, direction.x);
+
+    // Half a pixel more on each side for the antialiased edge, and square
+    // caps so segments of a polyline overlap at their joints
+    let half_width = 0.5 * style.width + 0.5;
+    let offset = (side * corner.y + direction * (corner.x * 2.0 - 1.0)) * half_width;
+    var position = mix(clip0, clip1, corner.x);
+    position = vec4<f32>(position.xy + offset * 2.0 / style.viewport * position.w, position.zw);
+
+    var out: VertexOutput;
+    out.position = position;
+    out.color = unpack4x8unorm(color).wzyx;
+    out.distance = distance + corner.x * length;
+    out.across = corner.y * half_width;
+    return out;
+}
+
+fn pattern_texel(row: i32, column: i32) -> f32 {
+    return textureLoad(patterns, vec2<i32>(column, row), 0).r;
+}
+
+@fragment
+fn fs_main(in: VertexOutput) -> @location(0) vec4<f32> {
+    // Drawing units per pixel along the line, so dots stay at least a
+    // pixel long however far out the view is zoomed
+    let pixel = fwidth(in.distance);
+    let row = i32(style.patternRow);
+    let period = pattern_texel(row, 0) * style.patternScale;
+    if (period > 0.0) {
+        let count = i32(pattern_texel(row, 1));
+        let phase = in.distance - floor(in.distance / period) * period;
+        var start = 0.0;
+        var drawn = false;
+        for (var i = 0; i < count; i++) {
+            let element = pattern_texel(row, 2 + i) * style.patternScale;
+            if (element >= 0.0 && phase >= start && phase < start + max(element, pixel)) {
+                drawn = true;
+                break;
+            }
+            start += abs(element);
+        }
+        if (!drawn) {
+            discard;
+        }
+    }
+
+    let coverage = clamp(0.5 * style.width + 0.5 - abs(in.across), 0.0, 1.0);
+    return vec4<f32>(in.color.rgb, in.color.a * coverage);
+}
+)";
+
+} // namespace
+
+void PrecisionRenderContext::render_entities(const CADEntityCollection& entities) {
+    set_drawing(entities);
+    render_drawing();
+}
+
+void PrecisionRenderContext::set_drawing(const CADEntityCollection& entities) {
+    const uint64_t generation = ++drawing_generation_;
+    unbatched_entities_.clear();
+    for (const CADEntityPtr& entity : entities) {
+        if (!entity) {
+            continue;
+        }
+        if (!is_retained(*entity)) {
+            unbatched_entities_.push_back(entity);
+            continue;
+        }
+        
+        auto [it, added] = drawn_entities_.try_emplace(entity->id);
+        DrawnEntity& drawn = it->second;
+        drawn.generation = generation;
+        if (added || drawn.entity != entity || drawn.revision != entity->revision || drawn.visible != entity->visible) {
+            drawn.entity = entity;
+            sync_entity(entity->id, drawn);
+        }
+    }
+    
+    for (auto it = drawn_entities_.begin(); it != drawn_entities_.end();) {
+        if (it->second.generation != generation) {
+            drop_entity(it->second, it->first);
+            it = drawn_entities_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void PrecisionRenderContext::update_entity(const CADEntityPtr& entity) {
+    if (!entity) {
+        return;
+    }
+    if (!is_retained(*entity)) {
+        if (std::find(unbatched_entities_.begin(), unbatched_entities_.end(), entity) == unbatched_entities_.end()) {
+            unbatched_entities_.push_back(entity);
+        }
+        return;
+    }
+    
+    DrawnEntity& drawn = drawn_entities_[entity->id];
+    drawn.entity = entity;
+    drawn.generation = drawing_generation_;
+    sync_entity(entity->id, drawn);
+}
+
+void PrecisionRenderContext::remove_entity(EntityID id) {
+    auto it = drawn_entities_.find(id);
+    if (it != drawn_entities_.end()) {
+        drop_entity(it->second, id);
+        drawn_entities_.erase(it);
+        return;
+    }
+    unbatched_entities_.erase(std::remove_if(unbatched_entities_.begin(), unbatched_entities_.end(),
+                                             [id](const CADEntityPtr& entity) { return entity->id == id; }),
+                              unbatched_entities_.end());
+}
+
+void PrecisionRenderContext::clear_drawing() {
+    for (auto& group : line_groups_) {
+        release_line_group(*group);
+    }
+    for (auto& [definition, block] : block_groups_) {
+        release_block_group(*block);
+    }
+    line_groups_.clear();
+    block_groups_.clear();
+    drawn_entities_.clear();
+    unbatched_entities_.clear();
+    entity_index_.clear();
+}
+
+void PrecisionRenderContext::sync_entity(EntityID id, DrawnEntity& drawn) {
+    const CADEntity& entity = *drawn.entity;
+    drawn.revision = entity.revision;
+    drawn.visible = entity.visible;
+    
+    const CADLayer* layer = get_layer(entity.layer);
+    if (!entity.visible || (layer && !layer->visible)) {
+        drop_entity(drawn, id);
+        return;
+    }
+    if (const auto* reference = dynamic_cast<const CADBlockReference*>(&entity)) {
+        sync_block_reference(id, drawn, *reference);
+        return;
+    }
+    
+    std::vector<Point3D> points = get_entity_polyline(entity);
+    if (points.size() < 2) {
+        drop_entity(drawn, id);
+        return;
+    }
+    
+    // Batched and indexed in world space, which the transform may move
+    // the entity's own bounds out of
+    BoundingBox3D bounds(Point3D::Constant(std::numeric_limits<Precision>::infinity()),
+                         Point3D::Constant(-std::numeric_limits<Precision>::infinity()));
+    for (const Point3D& point : points) {
+        bounds.min = bounds.min.cwiseMin(point);
+        bounds.max = bounds.max.cwiseMax(point);
+    }
+    
+    const CADLayer default_layer;
+    const CADLayer& style = layer ? *layer : default_layer;
+    LineGroup& group = get_line_group(line_groups_, thickness_to_line_weight(style.line_weight), style.linetype,
+                                      points.front());
+    if (drawn.group && drawn.group != &group) {
+        drawn.group->batch.remove_entity(id);
+    }
+    drawn.group = &group;
+    group.batch.set_entity(id, points, cad_color_to_rgba(entity.color));
+    entity_index_.insert(id, bounds);
+}
+
+void PrecisionRenderContext::drop_entity(DrawnEntity& drawn, EntityID id) {
+    if (drawn.group) {
+        drawn.group->batch.remove_entity(id);
+        drawn.group = nullptr;
+    }
+    remove_block_instance(drawn, id);
+    entity_index_.remove(id);
+}
+
+std::vector<Point3D> PrecisionRenderContext::get_entity_polyline(const CADEntity& entity) {
+    std::vector<Point3D> points;
+    if (const auto* line = dynamic_cast<const CADLine*>(&entity)) {
+        points = {line->start, line->end};
+    } else if (const auto* arc = dynamic_cast<const CADArc*>(&entity)) {
+        points = tessellate_arc(arc->center, arc->normal, arc->radius, arc->start_angle, arc->end_angle);
+    }
+    for (Point3D& point : points) {
+        point = (entity.transform * point.homogeneous()).hnormalized();
+    }
+    return points;
+}
+
+PrecisionRenderContext::LineGroup& PrecisionRenderContext::get_line_group(
+    std::vector<std::unique_ptr<LineGroup>>& groups, LineWeight weight, const std::string& linetype,
+    const Point3D& origin) {
+    for (auto& group : groups) {
+        if (group->weight == weight && group->linetype == linetype) {
+            return *group;
+        }
+    }
+    
+    // The first entity fixes the origin, keeping the group's single
+    // precision positions small near it
+    groups.push_back(std::make_unique<LineGroup>(LineGroup{weight, linetype, LineBatch(origin)}));
+    return *groups.back();
+}
+
+void PrecisionRenderContext::render_drawing() {
+    if (synced_layer_revision_ != layer_revision_) {
+        synced_layer_revision_ = layer_revision_;
+        for (auto& [id, drawn] : drawn_entities_) {
+            sync_entity(id, drawn);
+        }
+    }
+    
+    // A drawing wholly in view is drawn a buffer per style without visiting
+    // the index's leaves
+    const ViewFrustum& frustum = viewport_.get_frustum();
+    const bool cull = settings_.enable_frustum_culling && !entity_index_.empty() &&
+                      frustum.classify(entity_index_.get_total_bounds()) != ViewFrustum::Containment::Inside;
+    size_t visible = entity_index_.size();
+    if (cull) {
+        for (auto& group : line_groups_) {
+            group->visible.clear();
+        }
+        for (auto& [definition, block] : block_groups_) {
+            block->visible.clear();
+        }
+        visible = 0;
+        entity_index_.query(frustum, [&](EntityID id) {
+            auto it = drawn_entities_.find(id);
+            if (it == drawn_entities_.end()) {
+                return;
+            }
+            if (it->second.group) {
+                it->second.group->visible.push_back(id);
+                visible++;
+            } else if (it->second.block) {
+                it->second.block->visible.push_back(id);
+                visible++;
+            }
+        });
+    }
+    rendered_entities_count_ += visible;
+    culled_entities_count_ += entity_index_.size() - visible;
+    
+    const bool has_lines = !line_groups_.empty() || !block_groups_.empty();
+    if (rendering_engine_ && has_lines && (line_pipeline_id_ != 0 || create_line_pipeline())) {
+        // Blocks whose definition or layers changed are rebuilt first, so
+        // their styles get pattern rows with everything else
+        for (auto& [definition, block] : block_groups_) {
+            if (!block->built || block->revision != definition->revision ||
+                block->layer_revision != layer_revision_) {
+                build_block(*block);
+            }
+        }
+        
+        // Rows first: the texture is rebuilt before any draw reads it
+        auto assign_rows = [this](std::vector<std::unique_ptr<LineGroup>>& groups) {
+            for (auto& group : groups) {
+                const TechnicalLinetype* linetype = get_linetype(group->linetype);
+                group->pattern_row = linetype ? linetype_patterns_.get_row(*linetype) : 0;
+            }
+        };
+        assign_rows(line_groups_);
+        for (auto& [definition, block] : block_groups_) {
+            assign_rows(block->styles);
+        }
+        if (!upload_linetype_patterns()) {
+            return;
+        }
+        
+        for (auto& group : line_groups_) {
+            LineBatch& batch = group->batch;
+            if (batch.get_unused_segment_count() > batch.get_used_segment_count() + 4096) {
+                batch.compact();
+            }
+            if (batch.get_used_segment_count() == 0) {
+                continue;
+            }
+            
+            std::vector<LineBatch::Range> ranges;
+            if (cull) {
+                ranges = batch.get_draw_ranges(group->visible);
+            } else {
+                ranges.push_back({0, static_cast<uint32_t>(batch.get_segments().size())});
+            }
+            draw_line_group(*group, ranges);
+        }
+        
+        for (auto& [definition, block] : block_groups_) {
+            std::vector<BlockInstanceBatch::Range> ranges;
+            if (cull) {
+                ranges = block->instances.get_draw_ranges(block->visible);
+            } else {
+                ranges.push_back({0, static_cast<uint32_t>(block->instances.size())});
+            }
+            draw_block_group(*block, ranges);
+        }
+    }
+    
+    for (const CADEntityPtr& entity : unbatched_entities_) {
+        if (entity->visible && (!settings_.enable_frustum_culling || viewport_.is_bounds_visible(entity->bounds))) {
+            render_entity(*entity);
+            rendered_entities_count_++;
+        } else {
+            culled_entities_count_++;
+        }
+    }
+}
+
+bool PrecisionRenderContext::prepare_line_group(LineGroup& group, const Point3D& origin) {
+    using namespace QuantumCanvas::Rendering;
+    
+    // Only the segments written since the last frame go up, unless the
+    // buffer has to grow
+    const auto& segments = group.batch.get_segments();
+    if (group.segment_buffer_id == 0 || group.segment_capacity < segments.size()) {
+        if (group.segment_buffer_id != 0) {
+            rendering_engine_->destroy_resource(group.segment_buffer_id);
+        }
+        group.segment_capacity = std::max(segments.size(), group.segment_capacity * 2);
+        group.segment_buffer_id = rendering_engine_->create_buffer(group.segment_capacity * sizeof(LineSegment),
+                                                                   BufferUsage::Storage | BufferUsage::CopyDst);
+        if (group.segment_buffer_id == 0) {
+            group.segment_capacity = 0;
+            return false;
+        }
+        group.batch.take_dirty_ranges();
+        rendering_engine_->update_buffer(group.segment_buffer_id, 0, segments.size() * sizeof(LineSegment),
+                                         segments.data());
+    } else {
+        for (const LineBatch::Range& range : group.batch.take_dirty_ranges()) {
+            rendering_engine_->update_buffer(group.segment_buffer_id, range.first * sizeof(LineSegment),
+                                             range.count * sizeof(LineSegment), &segments[range.first]);
+        }
+    }
+    
+    // The origin is folded in in double precision, as for meshes
+    LineStyle style;
+    Matrix4D model = Matrix4D::Identity();
+    model.col(3).head<3>() = origin;
+    const Eigen::Matrix4f view_projection = (viewport_.get_view_projection_matrix() * model).cast<float>();
+    std::copy(view_projection.data(), view_projection.data() + 16, style.view_projection.begin());
+    const auto& rect = viewport_.get_viewport_rect();
+    style.viewport = {static_cast<float>(rect.width), static_cast<float>(rect.height)};
+    
+    // Weights stay the same on screen at any zoom; so do patterns measured
+    // in screen millimetres, which scale by the drawing units per pixel
+    const Precision pixels_per_mm = settings_.display_dpi / MM_PER_INCH;
+    style.width = static_cast<float>(std::max<Precision>(
+        1.0, line_weight_to_thickness(group.weight) * settings_.line_weight_scale * pixels_per_mm));
+    style.pattern_row = static_cast<float>(group.pattern_row);
+    Precision pattern_scale = settings_.linetype_scale;
+    if (settings_.screen_space_linetypes) {
+        pattern_scale *= pixels_per_mm * viewport_.screen_to_world_vector(Vector2D(1.0, 0.0)).norm();
+    }
+    style.pattern_scale = static_cast<float>(pattern_scale);
+    
+    // Every prepare gets its own ring copy, so a frame that renders the
+    // drawing twice, say for two viewports, keeps both styles
+    group.style = rendering_engine_->upload(&style, sizeof(LineStyle));
+    if (!group.style.is_valid()) {
+        if (group.uniform_buffer_id == 0) {
+            group.uniform_buffer_id = rendering_engine_->create_buffer(sizeof(LineStyle),
+                                                                       BufferUsage::Uniform | BufferUsage::CopyDst);
+            if (group.uniform_buffer_id == 0) {
+                return false;
+            }
+        }
+        rendering_engine_->update_buffer(group.uniform_buffer_id, 0, sizeof(LineStyle), &style);
+        group.style.buffer = group.uniform_buffer_id;
+    }
+    return true;
+}
+
+void PrecisionRenderContext::draw_line_group(LineGroup& group, const std::vector<LineBatch::Range>& ranges) {
+    using namespace QuantumCanvas::Rendering;
+    
+    if (!prepare_line_group(group, group.batch.get_origin())) {
+        return;
+    }
+    
+    // Six vertices per segment, expanded to a screen-space quad in the shader
+    for (const LineBatch::Range& range : ranges) {
+        DrawCall call;
+        call.vertexCount = 6;
+        call.instanceCount = range.count;
+        call.firstInstance = range.first;
+        call.pipelineId = line_pipeline_id_;
+        call.uniformBuffers = {group.style.buffer, group.segment_buffer_id};
+        call.uniformOffsets = {static_cast<uint32_t>(group.style.offset), 0};
+        call.textures = {linetype_texture_id_};
+        call.cullFace = false;
+        call.blendEnabled = settings_.enable_antialiasing;
+        rendering_engine_->submit_draw_call(call);
+    }
+}
+
+void PrecisionRenderContext::release_line_group(LineGroup& group) {
+    for (auto* buffer : {&group.segment_buffer_id, &group.uniform_buffer_id}) {
+        if (*buffer != 0 && rendering_engine_) {
+            rendering_engine_->destroy_resource(*buffer);
+        }
+        *buffer = 0;
+    }
+    group.segment_capacity = 0;
+}
+
+bool PrecisionRenderContext::upload_linetype_patterns() {
+    using namespace QuantumCanvas::Rendering;
+    
+    if (linetype_texture_id_ != 0 && !linetype_patterns_.is_dirty()) {
+        return true;
+    }
+    if (linetype_texture_id_ != 0) {
+        rendering_engine_->destroy_resource(linetype_texture_id_);
+    }
+    
+    TextureDescriptor desc;
+    desc.width = LinetypePatternTable::PATTERN_TEXELS;
+    desc.height = linetype_patterns_.get_row_count();
+    desc.format = TextureDescriptor::Format::R32Float;
+    desc.usage = static_cast<uint32_t>(TextureDescriptor::Usage::TextureBinding) |
+                 static_cast<uint32_t>(TextureDescriptor::Usage::CopyDst);
+    linetype_texture_id_ = rendering_engine_->create_texture(desc, linetype_patterns_.get_texels().data());
+    linetype_patterns_.clear_dirty();
+    return linetype_texture_id_ != 0;
+}
+
+std::vector<Point3D> PrecisionRenderContext::tessellate_arc(const Point3D& center, const Vector3D& normal,
+                                                            Precision radius, Precision start_angle,
+                                                            Precision end_angle) {
+    // The same in-plane axes as CADArc::start_point()
+    const Vector3D n = normal.norm() > GEOMETRIC_TOLERANCE ? normal.normalized() : Vector3D::UnitZ();
+    Vector3D u_axis = Vector3D::UnitX();
+    Vector3D v_axis = n.cross(u_axis).normalized();
+    if (v_axis.norm() < 0.5) {
+        u_axis = Vector3D::UnitY();
+        v_axis = n.cross(u_axis).normalized();
+    }
+    u_axis = v_axis.cross(n).normalized();
+    
+    // Chords deviate from the arc by at most the tolerance, floored at a
+    // thousandth of the radius so huge drawings stay cheap to batch
+    const Precision sweep = end_angle - start_angle;
+    const Precision tolerance = std::max(settings_.curve_tolerance, radius * 1e-3);
+    const Precision step = radius > tolerance ? 2.0 * std::acos(1.0 - tolerance / radius) : constants::HALF_PI;
+    const int segments = std::clamp(static_cast<int>(std::ceil(std::abs(sweep) / step)), 1, 1024);
+    
+    std::vector<Point3D> points;
+    points.reserve(segments + 1);
+    for (int i = 0; i <= segments; ++i) {
+        const Precision angle = start_angle + sweep * i / segments;
+        points.push_back(center + radius * (std::cos(angle) * u_axis + std::sin(angle) * v_axis));
+    }
+    return points;
+}
+
+bool PrecisionRenderContext::create_line_pipeline() {
+    const std::string source = std::string(LINE_SHADER_COMMON) + R"(
+// LinetypePatternTable: period, element count, then signed element lengths
+@group(0) @binding(2) var patterns: texture_2d<f32>;
+
+// One instance per segment
+@vertex
+fn vs_main(@builtin(vertex_index) vertex: u32, @builtin(instance_index) instance: u32) -> VertexOutput {
+    let segment = segments[instance];
+    if (segment.distance < 0.0) {
+        return unused_vertex();
+    }
+    return expand_segment(style.viewProjection * vec4<f32>(segment.start, 1.0),
+                          style.viewProjection * vec4<f32>(segment.end, 1.0),
+                          vertex, segment.distance, length(segment.end - segment.start), segment.color);
+}
+)";
+    line_pipeline_id_ = rendering_engine_->createPipeline(source.c_str());
+    return line_pipeline_id_ != 0;
+}
+
+// =============================================================================
+// PrecisionRenderContext Block Instancing Implementation
+// =============================================================================
+
+void PrecisionRenderContext::sync_block_reference(EntityID id, DrawnEntity& drawn,
+                                                  const CADBlockReference& reference) {
+    if (!reference.definition) {
+        drop_entity(drawn, id);
+        return;
+    }
+    
+    auto [it, added] = block_groups_.try_emplace(reference.definition.get());
+    if (added) {
+        // The first reference fixes the placements' origin
+        it->second = std::make_unique<BlockGroup>();
+        it->second->definition = reference.definition;
+        it->second->instances = BlockInstanceBatch(reference.transform.col(3).head<3>());
+    }
+    BlockGroup& block = *it->second;
+    if (drawn.block != &block) {
+        remove_block_instance(drawn, id);
+        drawn.block = &block;
+    }
+    
+    // Block segments are relative to the base point, so the reference's own
+    // transform places them
+    block.instances.set_instance(id, reference.transform);
+    entity_index_.insert(id, reference.bounds);
+}
+
+void PrecisionRenderContext::remove_block_instance(DrawnEntity& drawn, EntityID id) {
+    BlockGroup* block = drawn.block;
+    if (!block) {
+        return;
+    }
+    drawn.block = nullptr;
+    block->instances.remove_instance(id);
+    if (block->instances.empty()) {
+        release_block_group(*block);
+        block_groups_.erase(block->definition.get());
+    }
+}
+
+void PrecisionRenderContext::build_block(BlockGroup& block) {
+    for (auto& style : block.styles) {
+        release_line_group(*style);
+    }
+    block.styles.clear();
+    block.unbatched.clear();
+    
+    const CADBlockDefinition& definition = *block.definition;
+    EntityID next_id = 1;
+    for (const CADEntityPtr& entity : definition.entities) {
+        if (!entity || !entity->visible) {
+            continue;
+        }
+        const CADLayer* layer = get_layer(entity->layer);
+        if (layer && !layer->visible) {
+            continue;
+        }
+        
+        std::vector<Point3D> points = get_entity_polyline(*entity);
+        if (points.size() < 2) {
+            block.unbatched.push_back(entity);
+            continue;
+        }
+        const CADLayer default_layer;
+        const CADLayer& style = layer ? *layer : default_layer;
+        LineGroup& group = get_line_group(block.styles, thickness_to_line_weight(style.line_weight), style.linetype,
+                                          definition.base_point);
+        group.batch.set_entity(next_id++, points, cad_color_to_rgba(entity->color));
+    }
+    
+    block.built = true;
+    block.revision = definition.revision;
+    block.layer_revision = layer_revision_;
+}
+
+void PrecisionRenderContext::draw_block_group(BlockGroup& block, const std::vector<BlockInstanceBatch::Range>& ranges) {
+    using namespace QuantumCanvas::Rendering;
+    
+    if (block.instances.empty() || (block_line_pipeline_id_ == 0 && !create_block_line_pipeline())) {
+        return;
+    }
+    
+    // Placements are uploaded as they change, not per frame
+    const auto& placements = block.instances.get_placements();
+    if (block.placement_buffer_id == 0 || block.placement_capacity < placements.size()) {
+        if (block.placement_buffer_id != 0) {
+            rendering_engine_->destroy_resource(block.placement_buffer_id);
+        }
+        block.placement_capacity = std::max(placements.size(), block.placement_capacity * 2);
+        block.placement_buffer_id = rendering_engine_->create_buffer(block.placement_capacity * sizeof(BlockPlacement),
+                                                                     BufferUsage::Storage | BufferUsage::CopyDst);
+        if (block.placement_buffer_id == 0) {
+            block.placement_capacity = 0;
+            return;
+        }
+        block.instances.take_dirty_ranges();
+        rendering_engine_->update_buffer(block.placement_buffer_id, 0, placements.size() * sizeof(BlockPlacement),
+                                         placements.data());
+    } else {
+        for (const BlockInstanceBatch::Range& range : block.instances.take_dirty_ranges()) {
+            rendering_engine_->update_buffer(block.placement_buffer_id, range.first * sizeof(BlockPlacement),
+                                             range.count * sizeof(BlockPlacement), &placements[range.first]);
+        }
+    }
+    
+    // One call per style and visible range: the vertices walk the block's
+    // segments, the instances its placements
+    for (auto& style : block.styles) {
+        const auto segment_count = static_cast<uint32_t>(style->batch.get_segments().size());
+        if (segment_count == 0 || !prepare_line_group(*style, block.instances.get_origin())) {
+            continue;
+        }
+        for (const BlockInstanceBatch::Range& range : ranges) {
+            DrawCall call;
+            call.vertexCount = 6 * segment_count;
+            call.instanceCount = range.count;
+            call.firstInstance = range.first;
+            call.pipelineId = block_line_pipeline_id_;
+            call.uniformBuffers = {style->style.buffer, style->segment_buffer_id, block.placement_buffer_id};
+            call.uniformOffsets = {static_cast<uint32_t>(style->style.offset), 0, 0};
+            call.textures = {linetype_texture_id_};
+            call.cullFace = false;
+            call.blendEnabled = settings_.enable_antialiasing;
+            rendering_engine_->submit_draw_call(call);
+        }
+    }
+    
+    // Whatever the block holds besides lines and arcs is drawn at each
+    // visible placement
+    if (block.unbatched.empty()) {
+        return;
+    }
+    for (const BlockInstanceBatch::Range& range : ranges) {
+        for (uint32_t slot = range.first; slot < range.first + range.count; ++slot) {
+            auto it = drawn_entities_.find(block.instances.get_ids()[slot]);
+            if (it == drawn_entities_.end()) {
+                continue;
+            }
+            push_transform(static_cast<const CADBlockReference&>(*it->second.entity).get_block_transform());
+            for (const CADEntityPtr& entity : block.unbatched) {
+                render_entity(*entity);
+            }
+            pop_transform();
+        }
+    }
+}
+
+void PrecisionRenderContext::release_block_group(BlockGroup& block) {
+    for (auto& style : block.styles) {
+        release_line_group(*style);
+    }
+    if (block.placement_buffer_id != 0 && rendering_engine_) {
+        rendering_engine_->destroy_resource(block.placement_buffer_id);
+    }
+    block.placement_buffer_id = 0;
+    block.placement_capacity = 0;
+}
+
+bool PrecisionRenderContext::create_block_line_pipeline() {
+    const std::string source = std::string(LINE_SHADER_COMMON) + R"(
+// BlockPlacement
+struct BlockPlacement {
+    model: mat4x4<f32>,
+    distanceScale: f32,
+};
+
+@group(0) @binding(2) var<storage, read> placements: array<BlockPlacement>;
+// LinetypePatternTable: period, element count, then signed element lengths
+@group(0) @binding(3) var patterns: texture_2d<f32>;
+
+// One instance per placement; the vertices walk the block's segments
+@vertex
+fn vs_main(@builtin(vertex_index) vertex: u32, @builtin(instance_index) instance: u32) -> VertexOutput {
+    let segment = segments[vertex / 6u];
+    if (segment.distance < 0.0) {
+        return unused_vertex();
+    }
+    let placement = placements[instance];
+    let transform = style.viewProjection * placement.model;
+    return expand_segment(transform * vec4<f32>(segment.start, 1.0), transform * vec4<f32>(segment.end, 1.0),
+                          vertex % 6u, segment.distance * placement.distanceScale,
+                          length(segment.end - segment.start) * placement.distanceScale, segment.color);
+}
+)";
+    block_line_pipeline_id_ = rendering_engine_->createPipeline(source.c_str());
+    return block_line_pipeline_id_ != 0;
+}
+
+
+// =============================================================================
+// PrecisionRenderContext Immediate Lines and NURBS Implementation
+// =============================================================================
+
+void PrecisionRenderContext::render_line_segment(const Point3D& start, const Point3D& end) {
+    render_polyline({start, end});
+}
+
+void PrecisionRenderContext::render_polyline(const std::vector<Point3D>& points, bool closed) {
+    if (points.size() < 2) {
+        return;
+    }
+    
+    std::vector<Point3D> world;
+    world.reserve(points.size() + 1);
+    for (const Point3D& point : points) {
+        world.push_back((current_transform_ * point.homogeneous()).hnormalized());
+    }
+    if (closed) {
+        world.push_back(world.front());
+    }
+    
+    LineGroup* group = nullptr;
+    for (auto& candidate : immediate_line_groups_) {
+        if (candidate->weight == current_line_weight_ && candidate->linetype == current_linetype_) {
+            group = candidate.get();
+            break;
+        }
+    }
+    if (!group) {
+        immediate_line_groups_.push_back(
+            std::make_unique<LineGroup>(LineGroup{current_line_weight_, current_linetype_, LineBatch(world.front())}));
+        group = immediate_line_groups_.back().get();
+    } else if (group->batch.get_entity_count() == 0) {
+        // Each frame re-bases the batch near what it draws
+        group->batch = LineBatch(world.front());
+    }
+    
+    // Each polyline is its own entity of the batch, so dash patterns restart
+    const auto id = static_cast<EntityID>(group->batch.get_entity_count() + 1);
+    group->batch.set_entity(id, world, cad_color_to_rgba(current_color_));
+}
+
+void PrecisionRenderContext::flush_lines() {
+    if (!rendering_engine_ || (line_pipeline_id_ == 0 && !create_line_pipeline())) {
+        for (auto& group : immediate_line_groups_) {
+            group->batch.clear();
+        }
+        return;
+    }
+    
+    for (auto& group : immediate_line_groups_) {
+        const TechnicalLinetype* linetype = get_linetype(group->linetype);
+        group->pattern_row = linetype ? linetype_patterns_.get_row(*linetype) : 0;
+    }
+    if (!upload_linetype_patterns()) {
+        return;
+    }
+    
+    // Buffers stay allocated across frames; only their contents are redone
+    bool drawn = false;
+    for (auto& group : immediate_line_groups_) {
+        const auto count = static_cast<uint32_t>(group->batch.get_segments().size());
+        if (count > 0) {
+            draw_line_group(*group, {{0, count}});
+            drawn = true;
+        }
+        group->batch.clear();
+    }
+    if (drawn) {
+        rendering_engine_->flush();
+    }
+}
+
+Precision PrecisionRenderContext::get_lod_tolerance(const BoundingBox3D& model_bounds) const {
+    // The box around the transformed corners holds the transformed geometry
+    BoundingBox3D bounds(Point3D::Constant(std::numeric_limits<Precision>::infinity()),
+                         Point3D::Constant(-std::numeric_limits<Precision>::infinity()));
+    for (int corner = 0; corner < 8; ++corner) {
+        const Point3D point((corner & 1) ? model_bounds.max.x() : model_bounds.min.x(),
+                            (corner & 2) ? model_bounds.max.y() : model_bounds.min.y(),
+                            (corner & 4) ? model_bounds.max.z() : model_bounds.min.z());
+        const Point3D world = (current_transform_ * point.homogeneous()).hnormalized();
+        bounds.min = bounds.min.cwiseMin(world);
+        bounds.max = bounds.max.cwiseMax(world);
+    }
+    if (settings_.enable_frustum_culling && !viewport_.is_bounds_visible(bounds)) {
+        return 0.0;
+    }
+    
+    // World tolerance back into model units by the transform's largest scale
+    const Precision scale = std::max(current_transform_.topLeftCorner<3, 3>().colwise().norm().maxCoeff(),
+                                     GEOMETRIC_TOLERANCE);
+    const Precision world = settings_.screen_space_error * viewport_.get_world_units_per_pixel(bounds);
+    TessellationTolerance tolerance;
+    tolerance.chordal = std::max(world / scale, settings_.curve_tolerance);
+    return tolerance.quantized().chordal;
+}
+
+void PrecisionRenderContext::render_nurbs_curve(const NURBSCurve& curve) {
+    if (curve.control_points.size() < 2) {
+        return;
+    }
+    const Precision tolerance = get_lod_tolerance(curve.bounds());
+    if (tolerance <= 0.0) {
+        culled_entities_count_++;
+        return;
+    }
+    
+    const uint64_t key = fingerprint(curve);
+    auto polyline = curve_cache_.find(key, tolerance);
+    if (polyline) {
+        tessellation_cache_hits_++;
+    } else {
+        tessellation_cache_misses_++;
+        polyline = curve_cache_.insert(key, tolerance,
+                                       tessellate_curve(curve, tolerance, settings_.max_tessellation_depth));
+    }
+    render_polyline(*polyline);
+    
+    if (settings_.show_control_points) {
+        render_polyline(curve.control_points);
+    }
+}
+
+void PrecisionRenderContext::render_nurbs_surface(const NURBSSurface& surface, bool show_control_net) {
+    if (surface.control_points.size() < 2 || surface.control_points[0].size() < 2) {
+        return;
+    }
+    const Precision tolerance = get_lod_tolerance(surface.bounds());
+    if (tolerance <= 0.0) {
+        culled_entities_count_++;
+        return;
+    }
+    
+    MeshCache::Key key;
+    key.face_id = static_cast<size_t>(fingerprint(surface));
+    key.tolerance.chordal = tolerance;
+    key.tolerance = key.tolerance.quantized();
+    auto mesh = surface_cache_.find(key);
+    if (mesh) {
+        tessellation_cache_hits_++;
+    } else {
+        tessellation_cache_misses_++;
+        mesh = surface_cache_.insert(key, tessellate_surface(surface, tolerance, settings_.max_tessellation_depth));
+    }
+    render_mesh(std::move(mesh));
+    
+    if (show_control_net || settings_.show_control_points) {
+        const auto& net = surface.control_points;
+        for (const auto& row : net) {
+            render_polyline(row);
+        }
+        for (size_t c = 0; c < net[0].size(); ++c) {
+            std::vector<Point3D> column;
+            for (const auto& row : net) {
+                if (c < row.size()) {
+                    column.push_back(row[c]);
+                }
+            }
+            render_polyline(column);
+        }
+    }
+}
+
+// =============================================================================
+// PrecisionRenderContext Mesh Implementation
+// =============================================================================
+
+void PrecisionRenderContext::render_mesh(std::shared_ptr<const IndexedMesh> mesh, const Matrix4D& transform) {
+    if (!mesh || mesh->empty()) {
+        return;
+    }
+    queued_meshes_.push_back({std::move(mesh), current_transform_ * transform, current_color_});
+}
+
+void PrecisionRenderContext::flush_meshes() {
+    using namespace QuantumCanvas::Rendering;
+    
+    if (queued_meshes_.empty() || !rendering_engine_ || (mesh_pipeline_id_ == 0 && !create_mesh_pipeline())) {
+        queued_meshes_.clear();
+        return;
+    }
+    
+    // Placements of one mesh are adjacent, to be drawn as one instanced call
+    std::stable_sort(queued_meshes_.begin(), queued_meshes_.end(), [](const QueuedMesh& a, const QueuedMesh& b) {
+        return a.mesh.get() < b.mesh.get();
+    });
+    
+    // Matrices are composed in double precision with the mesh origin folded
+    // in, so only the small mesh-relative positions meet single precision
+    const Matrix4D& view = viewport_.get_view_matrix();
+    const Matrix4D& view_projection = viewport_.get_view_projection_matrix();
+    mesh_instances_.clear();
+    for (const QueuedMesh& queued : queued_meshes_) {
+        Matrix4D model = queued.transform;
+        model.col(3) += model.leftCols<3>() * queued.mesh->origin;
+        const Eigen::Matrix4f mvp = (view_projection * model).cast<float>();
+        const Matrix3D normal = (view.topLeftCorner<3, 3>() * model.topLeftCorner<3, 3>()).inverse().transpose();
+        
+        MeshInstance instance;
+        std::copy(mvp.data(), mvp.data() + 16, instance.model_view_projection.begin());
+        for (int column = 0; column < 3; ++column) {
+            for (int row = 0; row < 3; ++row) {
+                instance.normal_matrix[column * 4 + row] = static_cast<float>(normal(row, column));
+            }
+        }
+        instance.color = {static_cast<float>(queued.color.r), static_cast<float>(queued.color.g),
+                          static_cast<float>(queued.color.b), static_cast<float>(queued.color.a)};
+        mesh_instances_.push_back(instance);
+    }
+    
+    // From the upload ring, so each call this frame keeps its own instances;
+    // the instance buffer only holds those that miss a full ring
+    const size_t bytes = mesh_instances_.size() * sizeof(MeshInstance);
+    UploadAllocation instances = rendering_engine_->upload(mesh_instances_.data(), bytes);
+    if (!instances.is_valid()) {
+        if (mesh_instance_buffer_id_ == 0 || mesh_instance_capacity_ < bytes) {
+            if (mesh_instance_buffer_id_ != 0) {
+                rendering_engine_->destroy_resource(mesh_instance_buffer_id_);
+            }
+            mesh_instance_capacity_ = std::max(bytes, mesh_instance_capacity_ * 2);
+            mesh_instance_buffer_id_ = rendering_engine_->create_buffer(mesh_instance_capacity_,
+                                                                        BufferUsage::Storage | BufferUsage::CopyDst);
+            if (mesh_instance_buffer_id_ == 0) {
+                mesh_instance_capacity_ = 0;
+                queued_meshes_.clear();
+                return;
+            }
+        }
+        rendering_engine_->update_buffer(mesh_instance_buffer_id_, 0, bytes, mesh_instances_.data());
+        instances.buffer = mesh_instance_buffer_id_;
+    }
+    
+    for (size_t first = 0; first < queued_meshes_.size();) {
+        const auto& mesh = queued_meshes_[first].mesh;
+        size_t last = first + 1;
+        while (last < queued_meshes_.size() && queued_meshes_[last].mesh == mesh) {
+            last++;
+        }
+        
+        // A resident entry for a dead mesh at the same address is stale
+        GpuMesh& gpu = gpu_meshes_[mesh.get()];
+        if (gpu.mesh.lock() == mesh) {
+            tessellation_cache_hits_++;
+        } else {
+            tessellation_cache_misses_++;
+            release_mesh(gpu);
+            if (!upload_mesh(*mesh, gpu)) {
+                gpu_meshes_.erase(mesh.get());
+                first = last;
+                continue;
+            }
+        }
+        
+        DrawCall call;
+        call.vertexCount = static_cast<uint32_t>(mesh->indices.size());
+        call.vertexBufferId = gpu.vertex_buffer_id;
+        call.indexBufferId = gpu.index_buffer_id;
+        call.firstInstance = static_cast<uint32_t>(first);
+        call.instanceCount = static_cast<uint32_t>(last - first);
+        call.pipelineId = mesh_pipeline_id_;
+        call.uniformBuffers = {instances.buffer};
+        call.uniformOffsets = {static_cast<uint32_t>(instances.offset)};
+        call.cullFace = false;  // Shells may be open or inconsistently oriented
+        rendering_engine_->submit_draw_call(call);
+        first = last;
+    }
+    queued_meshes_.clear();
+    
+    for (auto it = gpu_meshes_.begin(); it != gpu_meshes_.end();) {
+        if (it->second.mesh.expired()) {
+            release_mesh(it->second);
+            it = gpu_meshes_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool PrecisionRenderContext::upload_mesh(const IndexedMesh& mesh, GpuMesh& gpu) {
+    using namespace QuantumCanvas::Rendering;
+    
+    const size_t vertex_bytes = mesh.vertices.size() * sizeof(MeshVertex);
+    const size_t index_bytes = mesh.indices.size() * sizeof(uint32_t);
+    gpu.vertex_buffer_id = rendering_engine_->create_buffer(vertex_bytes, BufferUsage::Vertex | BufferUsage::CopyDst);
+    gpu.index_buffer_id = rendering_engine_->create_buffer(index_bytes, BufferUsage::Index | BufferUsage::CopyDst);
+    if (gpu.vertex_buffer_id == 0 || gpu.index_buffer_id == 0) {
+        release_mesh(gpu);
+        return false;
+    }
+    
+    // The mesh is already laid out as the shader reads it
+    rendering_engine_->update_buffer(gpu.vertex_buffer_id, 0, vertex_bytes, mesh.vertices.data());
+    rendering_engine_->update_buffer(gpu.index_buffer_id, 0, index_bytes, mesh.indices.data());
+    return true;
+}
+
+void PrecisionRenderContext::release_mesh(GpuMesh& gpu) {
+    for (auto* buffer : {&gpu.vertex_buffer_id, &gpu.index_buffer_id}) {
+        if (*buffer != 0) {
+            rendering_engine_->destroy_resource(*buffer);
+            *buffer = 0;
+        }
+    }
+}
+
+bool PrecisionRenderContext::create_mesh_pipeline() {
+    mesh_pipeline_id_ = rendering_engine_->createPipeline(R"(
+// MeshInstance
+struct MeshInstance {
+    modelViewProjection: mat4x4<f32>,
+    normal0: vec4<f32>,
+    normal1: vec4<f32>,
+    normal2: vec4<f32>,
+    color: vec4<f32>,
+};
+
+@group(0) @binding(0) var<storage, read> instances: array<MeshInstance>;
+
+// MeshVertex
+struct VertexInput {
+    @location(0) position: vec3<f32>,
+    @location(1) normal: vec3<f32>,
+};
+
+struct VertexOutput {
+    @builtin(position) position: vec4<f32>,
+    @location(0) normal: vec3<f32>,
+    @location(1) color: vec4<f32>,
+};
+
+@vertex
+fn vs_main(in: VertexInput, @builtin(instance_index) index: u32) -> VertexOutput {
+    let instance = instances[index];
+    var out: VertexOutput;
+    out.position = instance.modelViewProjection * vec4<f32>(in.position, 1.0);
+    out.normal = mat3x3<f32>(instance.normal0.xyz, instance.normal1.xyz, instance.normal2.xyz) * in.normal;
+    out.color = instance.color;
+    return out;
+}
+
+// A headlight along the view axis, lighting both sides of a face alike
+@fragment
+fn fs_main(in: VertexOutput) -> @location(0) vec4<f32> {
+    let length_n = length(in.normal);
+    let facing = select(1.0, abs(in.normal.z) / length_n, length_n > 0.0);
+    return vec4<f32>(in.color.rgb * (0.25 + 0.75 * facing), in.color.a);
+}
+)");
+    return mesh_pipeline_id_ != 0;
+}
+
 // =============================================================================
 // Utility Functions Implementation
 // =============================================================================
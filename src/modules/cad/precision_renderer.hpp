@@ -12,7 +12,13 @@
 
 #include "cad_types.hpp"
 #include "cad_common.hpp"
+#include "mesh_cache.hpp"
+#include "entity_index.hpp"
+#include "line_batch.hpp"
+#include "block_instances.hpp"
+#include "nurbs_tessellator.hpp"
 #include "../../core/rendering/rendering_engine.hpp"
+#include "../../core/rendering/text_batch.hpp"
 
 #include <memory>
 #include <vector>
@@ -70,9 +76,15 @@ struct PrecisionRenderSettings {
     bool enable_antialiasing = true;
     bool enable_line_smoothing = true;
     Precision line_weight_scale = 1.0;
+    Precision display_dpi = 96.0;          ///< Line weights are millimetres at this density
+    
+    // Linetype settings
+    Precision linetype_scale = 1.0;        ///< Scales every dash pattern
+    bool screen_space_linetypes = false;   ///< Pattern lengths in millimetres on screen, not drawing units
     
     // Curve tessellation settings
-    Precision curve_tolerance = 1e-6;
+    Precision curve_tolerance = 1e-6;     ///< Finest tolerance any zoom asks for, drawing units
+    Precision screen_space_error = 0.5;   ///< NURBS stay within this many pixels of exact
     int max_tessellation_depth = 8;
     bool adaptive_tessellation = true;
     
@@ -118,7 +130,7 @@ private:
     Matrix4D view_matrix_;
     Matrix4D projection_matrix_;
     Matrix4D view_projection_matrix_;
-    BoundingBox3D view_frustum_;
+    ViewFrustum view_frustum_;
     bool matrices_dirty_;
 
 public:
@@ -156,9 +168,14 @@ public:
     const Matrix4D& get_view_projection_matrix() const;
     
     // Frustum culling
+    const ViewFrustum& get_frustum() const;
     bool is_point_visible(const Point3D& point) const;
     bool is_bounds_visible(const BoundingBox3D& bounds) const;
     
+    /// Size of a pixel in world units at the part of bounds nearest the
+    /// camera; the same everywhere in an orthographic view
+    Precision get_world_units_per_pixel(const BoundingBox3D& bounds) const;
+    
 private:
     void update_matrices();
     void update_frustum();
@@ -204,7 +221,7 @@ public:
     Precision get_total_length() const { return total_length_; }
     bool is_continuous() const { return is_continuous_; }
     
-    // Pattern evaluation
+    // Pattern evaluation, matching the line shader's
     bool is_visible_at_parameter(Precision t) const;
     Precision get_dash_phase(Precision start_param) const;
     
@@ -219,10 +236,49 @@ public:
     static TechnicalLinetype divide();
 };
 
+/// Dash patterns of the linetypes in use, packed for the line shader
+///
+/// Each linetype is a row of PATTERN_TEXELS single-channel texels: the
+/// period, the element count, then the element lengths in drawing units,
+/// negative for gaps. The shader walks its row with textureLoad against the
+/// distance along the line, so dashes are exact at any zoom and a dashed
+/// segment costs no more to draw than a continuous one. Row 0 is the
+/// continuous pattern.
+class LinetypePatternTable {
+public:
+    static constexpr uint32_t PATTERN_TEXELS = 64;
+    static constexpr uint32_t MAX_ELEMENTS = PATTERN_TEXELS - 2;
+    
+    LinetypePatternTable();
+    
+    /// The linetype's row, added or rewritten if its pattern changed
+    uint32_t get_row(const TechnicalLinetype& linetype);
+    uint32_t get_row_count() const { return static_cast<uint32_t>(texels_.size() / PATTERN_TEXELS); }
+    const std::vector<float>& get_texels() const { return texels_; }
+    
+    /// Set by changed rows until the texture is rebuilt
+    bool is_dirty() const { return dirty_; }
+    void clear_dirty() { dirty_ = false; }
+
+private:
+    std::unordered_map<std::string, uint32_t> rows_;
+    std::vector<float> texels_;
+    bool dirty_ = true;
+};
+
 // =============================================================================
 // Precision Rendering Context
 // =============================================================================
 
+/// One placement of a mesh as the mesh shader reads it; matches struct
+/// MeshInstance there
+struct MeshInstance {
+    std::array<float, 16> model_view_projection{};  ///< Column-major, from mesh-relative positions
+    std::array<float, 12> normal_matrix{};          ///< To view space, three padded columns
+    std::array<float, 4> color{};
+};
+static_assert(sizeof(MeshInstance) == 128, "MeshInstance must match the shader's layout");
+
 /// High-precision rendering context for CAD operations
 class PrecisionRenderContext {
 private:
@@ -240,6 +296,88 @@ private:
     std::string current_linetype_;
     Precision current_line_scale_;
     
+    // Text, drawn from the glyph atlas shared with the vector renderer
+    std::unique_ptr<QuantumCanvas::Rendering::TextBatch> text_batch_ =
+        std::make_unique<QuantumCanvas::Rendering::TextBatch>();
+    std::optional<QuantumCanvas::Rendering::FontId> current_font_;
+    QuantumCanvas::Rendering::ResourceId text_uniform_id_ = 0;
+    
+    // Shaded meshes; GPU buffers live as long as the mesh they hold
+    struct GpuMesh {
+        std::weak_ptr<const IndexedMesh> mesh;
+        QuantumCanvas::Rendering::ResourceId vertex_buffer_id = 0;
+        QuantumCanvas::Rendering::ResourceId index_buffer_id = 0;
+    };
+    struct QueuedMesh {
+        std::shared_ptr<const IndexedMesh> mesh;
+        Matrix4D transform;
+        Color color;
+    };
+    std::unordered_map<const IndexedMesh*, GpuMesh> gpu_meshes_;
+    std::vector<QueuedMesh> queued_meshes_;
+    std::vector<MeshInstance> mesh_instances_;
+    QuantumCanvas::Rendering::PipelineId mesh_pipeline_id_ = 0;
+    QuantumCanvas::Rendering::ResourceId mesh_instance_buffer_id_ = 0;  // When the upload ring is full
+    size_t mesh_instance_capacity_ = 0;  // In bytes
+    
+    // Lines and arcs of the drawing, batched by line weight and linetype into
+    // buffers that persist across frames; only edited entities are re-uploaded
+    struct LineGroup {
+        LineWeight weight;
+        std::string linetype;
+        LineBatch batch;
+        QuantumCanvas::Rendering::ResourceId segment_buffer_id = 0;
+        size_t segment_capacity = 0;  // In segments
+        QuantumCanvas::Rendering::ResourceId uniform_buffer_id = 0;  // When the upload ring is full
+        QuantumCanvas::Rendering::UploadAllocation style;  // This frame's, from prepare_line_group()
+        uint32_t pattern_row = 0;       // In linetype_patterns_
+        std::vector<EntityID> visible;  // Scratch for the frame's culling
+    };
+    // Blocks of the drawing, each uploaded once however many references
+    // place it: its lines are batched per style relative to the base point,
+    // and every style is drawn with one instanced call over the placements
+    struct BlockGroup {
+        CADBlockDefinitionPtr definition;
+        bool built = false;
+        uint64_t revision = 0;            // Of the definition when its lines were built
+        uint64_t layer_revision = 0;
+        std::vector<std::unique_ptr<LineGroup>> styles;
+        std::vector<CADEntityPtr> unbatched;  // Drawn at each visible placement
+        BlockInstanceBatch instances;
+        QuantumCanvas::Rendering::ResourceId placement_buffer_id = 0;
+        size_t placement_capacity = 0;    // In placements
+        std::vector<EntityID> visible;    // Scratch for the frame's culling
+    };
+    struct DrawnEntity {
+        CADEntityPtr entity;
+        uint64_t revision = 0;
+        uint64_t generation = 0;       // Last set_drawing() that listed it
+        LineGroup* group = nullptr;    // Null while hidden
+        BlockGroup* block = nullptr;   // For block references; null while hidden
+        bool visible = false;          // The entity's own flag when last synced
+    };
+    std::vector<std::unique_ptr<LineGroup>> line_groups_;
+    std::unordered_map<const CADBlockDefinition*, std::unique_ptr<BlockGroup>> block_groups_;
+    std::unordered_map<EntityID, DrawnEntity> drawn_entities_;
+    std::vector<CADEntityPtr> unbatched_entities_;  // Drawn one by one each frame
+    EntityIndex entity_index_;
+    uint64_t drawing_generation_ = 0;
+    uint64_t layer_revision_ = 0;        // Bumped when layers or linetypes change
+    uint64_t synced_layer_revision_ = 0;
+    QuantumCanvas::Rendering::PipelineId line_pipeline_id_ = 0;
+    QuantumCanvas::Rendering::PipelineId block_line_pipeline_id_ = 0;
+    LinetypePatternTable linetype_patterns_;
+    QuantumCanvas::Rendering::ResourceId linetype_texture_id_ = 0;
+    
+    // Polylines drawn immediately, gathered per style until flush_lines()
+    std::vector<std::unique_ptr<LineGroup>> immediate_line_groups_;
+    
+    // NURBS tessellations by level of detail; a level is a power-of-two
+    // tolerance, so zooming within a factor of two and orbiting at the same
+    // distance draw what is already cached
+    PolylineCache curve_cache_;
+    MeshCache surface_cache_{size_t(64) << 20};
+    
     // Performance tracking
     mutable size_t rendered_entities_count_;
     mutable size_t culled_entities_count_;
@@ -282,26 +420,78 @@ public:
     
     // Entity rendering
     void render_entity(const CADEntity& entity);
+    /// Shorthand for set_drawing() followed by render_drawing()
     void render_entities(const CADEntityCollection& entities);
+    
+    // Retained drawing
+    /// Makes the collection the drawing, uploading entities that are new or
+    /// whose revision changed and dropping those no longer listed. Lines and
+    /// arcs with an ID are batched on the GPU, and block references with an
+    /// ID are instanced from one copy of their block; other entities are
+    /// drawn one by one each frame.
+    void set_drawing(const CADEntityCollection& entities);
+    /// Adds or re-uploads one entity of the drawing
+    void update_entity(const CADEntityPtr& entity);
+    void remove_entity(EntityID id);
+    void clear_drawing();
+    /// Draws the parts of the drawing inside the view frustum, one draw per
+    /// run of visible segments in each style
+    void render_drawing();
+    const EntityIndex& get_entity_index() const { return entity_index_; }
+    /// Blocks with at least one reference in the drawing
+    size_t get_resident_block_count() const { return block_groups_.size(); }
     void render_point(const CADPoint& point);
     void render_line(const CADLine& line);
     void render_arc(const CADArc& arc);
     
     // Primitive rendering with sub-pixel precision
+    /// Queues lines in the current color, weight and linetype, placed by the
+    /// current transform
     void render_line_segment(const Point3D& start, const Point3D& end);
     void render_polyline(const std::vector<Point3D>& points, bool closed = false);
+    /// Draws the lines queued since the last call, one draw per style; call
+    /// once per frame before end_frame()
+    void flush_lines();
     void render_circle(const Point3D& center, const Vector3D& normal, Precision radius);
     void render_arc_segment(const Point3D& center, const Vector3D& normal, 
                            Precision radius, Precision start_angle, Precision end_angle);
     
     // Curve rendering with adaptive tessellation
     void render_bezier_curve(const CubicBezier2D& curve, const Matrix4D& transform = Matrix4D::Identity());
+    /// Tessellates to settings().screen_space_error at the current zoom,
+    /// reusing the cached level of detail when there is one; the curve is
+    /// queued as lines, the surface as a mesh in the current color
     void render_nurbs_curve(const NURBSCurve& curve);
     void render_nurbs_surface(const NURBSSurface& surface, bool show_control_net = false);
     
+    // Shaded mesh rendering
+    /// Queues a tessellated mesh, drawn in the current color and placed by
+    /// transform on top of the current one. The mesh is uploaded on first
+    /// use and stays resident until it is released.
+    void render_mesh(std::shared_ptr<const IndexedMesh> mesh, const Matrix4D& transform = Matrix4D::Identity());
+    /// Draws the meshes queued since the last call, one instanced draw per
+    /// distinct mesh; call once per frame before end_frame()
+    void flush_meshes();
+    size_t get_resident_mesh_count() const { return gpu_meshes_.size(); }
+    
     // Text rendering (for annotations)
+    /// Queues a line of text on its baseline at position, advancing along
+    /// direction in the plane facing +Z. height is the em size in world
+    /// units; the oblique angle (radians) slants the glyphs toward direction.
     void render_text(const std::string& text, const Point3D& position, 
-                    const Vector3D& direction, Precision height);
+                    const Vector3D& direction, Precision height,
+                    Precision width_factor = 1.0, Precision oblique_angle = 0.0);
+    /// Draws the text queued since the last call, one draw per atlas page;
+    /// call once per frame before end_frame()
+    void flush_text();
+    
+    /// Selects a font registered with the glyph atlas; false leaves the
+    /// current one, initially the atlas's default
+    bool set_font(const std::string& name);
+    void set_glyph_atlas(std::shared_ptr<QuantumCanvas::Rendering::GlyphAtlas> atlas);
+    QuantumCanvas::Rendering::GlyphAtlas& get_glyph_atlas() { return text_batch_->atlas(); }
+    std::shared_ptr<QuantumCanvas::Rendering::GlyphAtlas> get_shared_glyph_atlas() const { return text_batch_->shared_atlas(); }
+    std::optional<QuantumCanvas::Rendering::FontId> get_font() const;
     
     // Utility rendering
     void render_coordinate_system(const Point3D& origin, const Matrix3D& axes, Precision scale = 1.0);
@@ -321,16 +511,41 @@ public:
     bool export_to_svg(const std::string& filename);
 
 private:
-    // Internal rendering helpers
-    void setup_line_pattern(const TechnicalLinetype& linetype, Precision scale);
-    void render_patterned_line(const Point3D& start, const Point3D& end);
-    
     // Tessellation and curve subdivision
-    std::vector<Point3D> tessellate_curve(const std::function<Point3D(Precision)>& curve_func,
-                                         Precision start_t, Precision end_t);
+    /// Model-space tolerance for geometry with these model bounds, rounded
+    /// down to a power of two; zero if the bounds are out of view
+    Precision get_lod_tolerance(const BoundingBox3D& model_bounds) const;
     std::vector<Point3D> tessellate_arc(const Point3D& center, const Vector3D& normal,
                                        Precision radius, Precision start_angle, Precision end_angle);
     
+    // Retained line batches
+    void sync_entity(EntityID id, DrawnEntity& drawn);
+    void drop_entity(DrawnEntity& drawn, EntityID id);
+    /// The line or arc as a world-space polyline; empty for other entities
+    std::vector<Point3D> get_entity_polyline(const CADEntity& entity);
+    LineGroup& get_line_group(std::vector<std::unique_ptr<LineGroup>>& groups, LineWeight weight,
+                              const std::string& linetype, const Point3D& origin);
+    /// Uploads the group's changed segments and its style, for positions
+    /// relative to origin
+    bool prepare_line_group(LineGroup& group, const Point3D& origin);
+    void draw_line_group(LineGroup& group, const std::vector<LineBatch::Range>& ranges);
+    void release_line_group(LineGroup& group);
+    bool upload_linetype_patterns();
+    bool create_line_pipeline();
+    
+    // Instanced blocks
+    void sync_block_reference(EntityID id, DrawnEntity& drawn, const CADBlockReference& reference);
+    void remove_block_instance(DrawnEntity& drawn, EntityID id);
+    void build_block(BlockGroup& block);
+    void draw_block_group(BlockGroup& block, const std::vector<BlockInstanceBatch::Range>& ranges);
+    void release_block_group(BlockGroup& block);
+    bool create_block_line_pipeline();
+    
+    // Mesh upload and pipeline
+    bool create_mesh_pipeline();
+    bool upload_mesh(const IndexedMesh& mesh, GpuMesh& gpu);
+    void release_mesh(GpuMesh& gpu);
+    
     // Culling and visibility
     bool is_entity_visible(const CADEntity& entity) const;
     bool is_line_visible(const Point3D& start, const Point3D& end) const;
@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+#include "../face_bvh.hpp"
+#include <cmath>
+#include <vector>
+
+using namespace qcs::cad;
+
+namespace {
+
+// The facets of a tessellated sphere, the kind of imported part whose
+// Booleans pair a few thousand faces out of tens of thousands
+std::vector<BoundingBox3D> sphere_faces(size_t count, const Point3D& center) {
+    const auto rings = static_cast<size_t>(std::sqrt(static_cast<double>(count) / 2.0)) + 1;
+    const size_t segments = count / rings + 1;
+    std::vector<BoundingBox3D> faces;
+    auto point = [&](size_t ring, size_t segment) {
+        const Precision theta = M_PI * ring / rings, phi = 2.0 * M_PI * segment / segments;
+        return Point3D(center + Vector3D(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi),
+                                         std::cos(theta)));
+    };
+    for (size_t ring = 0; ring < rings && faces.size() < count; ++ring) {
+        for (size_t segment = 0; segment < segments && faces.size() < count; ++segment) {
+            BoundingBox3D bounds(point(ring, segment), point(ring, segment));
+            bounds.expand(point(ring + 1, segment));
+            bounds.expand(point(ring, segment + 1));
+            bounds.expand(point(ring + 1, segment + 1));
+            faces.push_back(bounds);
+        }
+    }
+    return faces;
+}
+
+// Two overlapping spheres: build both hierarchies and pair their faces
+void BM_FacePairsBVH(benchmark::State& state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto first = sphere_faces(count, Point3D::Zero());
+    const auto second = sphere_faces(count, Point3D(1.0, 0.3, 0.2));
+
+    size_t pairs = 0;
+    for (auto _ : state) {
+        const FaceBVH a(first), b(second);
+        pairs = find_overlapping_faces(a, b).size();
+        benchmark::DoNotOptimize(pairs);
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(2 * count));
+    state.counters["pairs"] = static_cast<double>(pairs);
+}
+
+// The all-pairs test the hierarchies replace
+void BM_FacePairsBruteForce(benchmark::State& state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto first = sphere_faces(count, Point3D::Zero());
+    const auto second = sphere_faces(count, Point3D(1.0, 0.3, 0.2));
+
+    for (auto _ : state) {
+        size_t pairs = 0;
+        for (const auto& a : first) {
+            for (const auto& b : second) {
+                pairs += a.intersects(b);
+            }
+        }
+        benchmark::DoNotOptimize(pairs);
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(2 * count));
+}
+
+BENCHMARK(BM_FacePairsBVH)->Arg(5000)->Arg(50000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FacePairsBruteForce)->Arg(5000)->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include "../constraint_solver.hpp"
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace qcs::cad;
+
+namespace {
+
+constexpr int CHAIN_LINKS = 2000;
+
+// A chain of unit links hanging from a fixed point, one cluster that every
+// drag of its free end re-solves whole
+struct Linkage {
+    ConstraintSolver solver;
+    std::vector<std::pair<VariableID, VariableID>> points;
+
+    Linkage() {
+        ConstraintSystem& system = *solver.get_system();
+        VariableManager& manager = system.get_variable_manager();
+        for (int i = 0; i <= CHAIN_LINKS; ++i) {
+            points.emplace_back(manager.create_variable("x", i * 0.8), manager.create_variable("y", 0.3 * (i % 2)));
+        }
+        manager.get_variable(points[0].first)->set_fixed(true);
+        manager.get_variable(points[0].second)->set_fixed(true);
+        for (size_t i = 0; i + 1 < points.size(); ++i) {
+            system.add_constraint(std::make_unique<DistanceConstraint>(
+                i, points[i].first, points[i].second, points[i + 1].first, points[i + 1].second, 1.0));
+        }
+        system.solve();
+    }
+
+    std::vector<VariableID> handle() const { return {points.back().first, points.back().second}; }
+};
+
+// The pointer circles the end's resting place a little each frame
+std::vector<Precision> pointer_at(int64_t frame, Precision x0, Precision y0) {
+    const Precision angle = 0.05 * static_cast<Precision>(frame);
+    return {x0 + 2.0 * std::cos(angle) - 2.0, y0 + 2.0 * std::sin(angle)};
+}
+
+// A drag session: warm-started frames that reuse the cluster's
+// factorisation, each limited to the given iteration budget
+void BM_DragSession(benchmark::State& state) {
+    Linkage linkage;
+    const VariableManager& manager = linkage.solver.get_system()->get_variable_manager();
+    const Precision x0 = manager.get_variable(linkage.points.back().first)->get_value();
+    const Precision y0 = manager.get_variable(linkage.points.back().second)->get_value();
+    const int budget = static_cast<int>(state.range(0));
+
+    linkage.solver.begin_drag(linkage.handle());
+    int64_t frame = 0, converged = 0;
+    for (auto _ : state) {
+        const SolverStatus status = linkage.solver.drag_to(pointer_at(++frame, x0, y0), budget);
+        converged += status == SolverStatus::Converged;
+        benchmark::DoNotOptimize(status);
+    }
+    linkage.solver.end_drag();
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["converged"] = benchmark::Counter(static_cast<double>(converged) / static_cast<double>(frame));
+}
+
+// The same drag as one-shot solve_drag() calls, each setting up the
+// cluster and factorising afresh and iterating to convergence
+void BM_DragColdSolve(benchmark::State& state) {
+    Linkage linkage;
+    ConstraintSystem& system = *linkage.solver.get_system();
+    const VariableManager& manager = system.get_variable_manager();
+    const Precision x0 = manager.get_variable(linkage.points.back().first)->get_value();
+    const Precision y0 = manager.get_variable(linkage.points.back().second)->get_value();
+
+    int64_t frame = 0;
+    for (auto _ : state) {
+        const SolverStatus status = system.solve_drag(linkage.handle(), pointer_at(++frame, x0, y0));
+        benchmark::DoNotOptimize(status);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_DragSession)->Arg(1)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DragColdSolve)->Unit(benchmark::kMillisecond);
+
+} // namespace
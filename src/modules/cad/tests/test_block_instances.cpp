@@ -0,0 +1,147 @@
+/**
+ * @file test_block_instances.cpp
+ * @brief Unit tests for block definitions, references and placement storage
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Base points, placed bounds, dense slots, dirty ranges and draw ranges
+ */
+
+#include <gtest/gtest.h>
+#include "../block_instances.hpp"
+#include "../cad_common.hpp"
+#include <cmath>
+
+namespace qcs::cad::test {
+
+namespace {
+
+// A unit square of lines around (10, 10), with its base point at the corner
+std::shared_ptr<CADBlockDefinition> square_block() {
+    auto block = std::make_shared<CADBlockDefinition>();
+    block->name = "Square";
+    block->base_point = Point3D(10, 10, 0);
+    const Point3D corners[] = {Point3D(10, 10, 0), Point3D(11, 10, 0), Point3D(11, 11, 0), Point3D(10, 11, 0)};
+    for (int i = 0; i < 4; ++i) {
+        block->entities.push_back(std::make_shared<CADLine>(corners[i], corners[(i + 1) % 4]));
+    }
+    block->mark_modified();
+    return block;
+}
+
+Matrix4D placement(const Point3D& position, Precision angle, Precision scale) {
+    Eigen::Affine3d transform = Eigen::Translation3d(position) * Eigen::AngleAxisd(angle, Vector3D::UnitZ()) *
+                                Eigen::Scaling(scale);
+    return transform.matrix();
+}
+
+} // namespace
+
+// =============================================================================
+// Block Reference Tests
+// =============================================================================
+
+TEST(BlockInstancesTest, ReferencesPlaceTheBasePoint) {
+    const auto block = square_block();
+    EXPECT_EQ(block->revision, 1u);
+    EXPECT_NEAR((block->bounds.min - Point3D(10, 10, 0)).norm(), 0.0, 1e-12);
+    EXPECT_NEAR((block->bounds.max - Point3D(11, 11, 0)).norm(), 0.0, 1e-12);
+
+    const CADBlockReference reference(block, placement(Point3D(100, 50, 0), constants::HALF_PI, 2.0), 42);
+    const Point3D far_corner = (reference.get_block_transform() * Point3D(11, 11, 0).homogeneous()).hnormalized();
+    EXPECT_NEAR((far_corner - Point3D(98, 52, 0)).norm(), 0.0, 1e-12);
+    EXPECT_NEAR((reference.bounds.min - Point3D(98, 50, 0)).norm(), 0.0, 1e-12);
+    EXPECT_NEAR((reference.bounds.max - Point3D(100, 52, 0)).norm(), 0.0, 1e-12);
+
+    // Copies share the definition rather than its entities
+    const auto copy = reference.clone();
+    EXPECT_EQ(static_cast<const CADBlockReference&>(*copy).definition.get(), block.get());
+    EXPECT_EQ(block.use_count(), 3);
+}
+
+// =============================================================================
+// Placement Storage Tests
+// =============================================================================
+
+TEST(BlockInstancesTest, PlacementsAreRelativeToTheOrigin) {
+    BlockInstanceBatch batch(Point3D(1e6, 0, 0));
+    batch.set_instance(7, placement(Point3D(1e6 + 0.25, 3, 0), 0.0, 4.0));
+
+    ASSERT_EQ(batch.size(), 1u);
+    const BlockPlacement& stored = batch.get_placements()[0];
+    EXPECT_FLOAT_EQ(stored.model[0], 4.0f);
+    EXPECT_FLOAT_EQ(stored.model[12], 0.25f);
+    EXPECT_FLOAT_EQ(stored.model[13], 3.0f);
+    EXPECT_FLOAT_EQ(stored.model[15], 1.0f);
+    EXPECT_FLOAT_EQ(stored.distance_scale, 4.0f);
+
+    // Moving a reference rewrites its slot
+    batch.take_dirty_ranges();
+    batch.set_instance(7, placement(Point3D(1e6, 0, 0), 0.0, 1.0));
+    EXPECT_EQ(batch.size(), 1u);
+    EXPECT_FLOAT_EQ(batch.get_placements()[0].model[12], 0.0f);
+    const auto dirty = batch.take_dirty_ranges();
+    ASSERT_EQ(dirty.size(), 1u);
+    EXPECT_EQ(dirty[0].first, 0u);
+    EXPECT_EQ(dirty[0].count, 1u);
+}
+
+TEST(BlockInstancesTest, RemovalKeepsSlotsDense) {
+    BlockInstanceBatch batch;
+    for (EntityID id = 1; id <= 100; ++id) {
+        batch.set_instance(id, placement(Point3D(static_cast<Precision>(id), 0, 0), 0.0, 1.0));
+    }
+    const auto initial = batch.take_dirty_ranges();
+    ASSERT_EQ(initial.size(), 1u);
+    EXPECT_EQ(initial[0].count, 100u);
+
+    // The last placement moves into the freed slot; only that slot goes up
+    EXPECT_TRUE(batch.remove_instance(10));
+    EXPECT_FALSE(batch.remove_instance(10));
+    EXPECT_EQ(batch.size(), 99u);
+    EXPECT_EQ(batch.get_ids()[9], 100u);
+    EXPECT_FLOAT_EQ(batch.get_placements()[9].model[12], 100.0f);
+    const auto moved = batch.take_dirty_ranges();
+    ASSERT_EQ(moved.size(), 1u);
+    EXPECT_EQ(moved[0].first, 9u);
+
+    // Removing the last needs no upload at all
+    EXPECT_TRUE(batch.remove_instance(99));
+    EXPECT_FALSE(batch.has_dirty_ranges());
+    for (size_t slot = 0; slot < batch.size(); ++slot) {
+        EXPECT_TRUE(batch.contains(batch.get_ids()[slot]));
+    }
+
+    batch.clear();
+    EXPECT_TRUE(batch.empty());
+    EXPECT_FALSE(batch.has_dirty_ranges());
+}
+
+TEST(BlockInstancesTest, DrawRangesMergeNearbySlots) {
+    BlockInstanceBatch batch;
+    for (EntityID id = 1; id <= 1000; ++id) {
+        batch.set_instance(id, Matrix4D::Identity());
+    }
+
+    // Slots 0-2 and 5 merge across the small gap; 500 stands alone
+    const std::vector<EntityID> visible{1, 2, 3, 6, 501, 5000};
+    auto ranges = batch.get_draw_ranges(visible, 4);
+    ASSERT_EQ(ranges.size(), 2u);
+    EXPECT_EQ(ranges[0].first, 0u);
+    EXPECT_EQ(ranges[0].count, 6u);
+    EXPECT_EQ(ranges[1].first, 500u);
+    EXPECT_EQ(ranges[1].count, 1u);
+
+    // Past the range budget, gaps widen until everything fits
+    std::vector<EntityID> scattered;
+    for (EntityID id = 1; id <= 1000; id += 10) {
+        scattered.push_back(id);
+    }
+    ranges = batch.get_draw_ranges(scattered, 1, 4);
+    EXPECT_LE(ranges.size(), 4u);
+    EXPECT_EQ(ranges.front().first, 0u);
+    EXPECT_EQ(ranges.back().first + ranges.back().count, 991u);
+}
+
+} // namespace qcs::cad::test
@@ -0,0 +1,209 @@
+/**
+ * @file test_brep_store.cpp
+ * @brief Unit tests for the index-based half-edge B-rep store
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Twin pairing, traversal, validation, face removal and compaction
+ */
+
+#include <gtest/gtest.h>
+#include "../brep_store.hpp"
+
+namespace qcs::cad::test {
+
+namespace {
+
+// Unit cube, faces wound counter-clockwise seen from outside
+struct Cube {
+    BRepStore store;
+    SolidHandle solid;
+    ShellHandle shell;
+    std::array<VertexHandle, 8> v;
+    std::vector<FaceHandle> faces;
+
+    Cube() {
+        solid = store.add_solid();
+        shell = store.add_shell(solid);
+        for (uint32_t i = 0; i < 8; ++i) {
+            v[i] = store.add_vertex(Point3D(i & 1, (i >> 1) & 1, (i >> 2) & 1));
+        }
+        add({v[0], v[2], v[3], v[1]});  // z = 0
+        add({v[4], v[5], v[7], v[6]});  // z = 1
+        add({v[0], v[1], v[5], v[4]});  // y = 0
+        add({v[2], v[6], v[7], v[3]});  // y = 1
+        add({v[0], v[4], v[6], v[2]});  // x = 0
+        add({v[1], v[3], v[7], v[5]});  // x = 1
+    }
+
+    FaceHandle add(std::vector<VertexHandle> boundary) {
+        faces.push_back(store.add_face(shell, boundary));
+        return faces.back();
+    }
+};
+
+} // namespace
+
+// =============================================================================
+// Construction and Traversal Tests
+// =============================================================================
+
+TEST(BRepStoreTest, CubePairsEveryEdge) {
+    Cube cube;
+    EXPECT_EQ(cube.store.get_vertex_count(), 8u);
+    EXPECT_EQ(cube.store.get_edge_count(), 12u);
+    EXPECT_EQ(cube.store.get_half_edge_count(), 24u);
+    EXPECT_EQ(cube.store.get_face_count(), 6u);
+    EXPECT_EQ(cube.store.validate(cube.solid), ValidationState::Valid);
+
+    // Every corner has three edges and three faces around it
+    for (VertexHandle vertex : cube.v) {
+        std::vector<FaceHandle> around;
+        cube.store.for_each_outgoing(vertex, [&](HalfEdgeHandle he) {
+            EXPECT_EQ(cube.store.half_edge(he).origin, vertex);
+            around.push_back(cube.store.face_of(he));
+        });
+        EXPECT_EQ(around.size(), 3u);
+    }
+
+    const auto [first, second] = cube.store.get_edge_faces(cube.store.half_edge(cube.store.loop(
+        cube.store.face(cube.faces[0]).outer).first).edge);
+    EXPECT_EQ(first, cube.faces[0]);
+    EXPECT_TRUE(second.is_valid());
+    EXPECT_NE(second, first);
+}
+
+TEST(BRepStoreTest, ViewsMirrorTopologyAccessors) {
+    Cube cube;
+    const SolidView solid(cube.store, cube.solid);
+    EXPECT_TRUE(solid.is_valid_solid());
+    EXPECT_TRUE(solid.get_inner_shells().empty());
+
+    const auto faces = solid.get_outer_shell().get_faces();
+    ASSERT_EQ(faces.size(), 6u);
+    const WireView wire = faces[0].get_outer_boundary();
+    EXPECT_EQ(wire.get_edge_count(), 4u);
+    EXPECT_TRUE(wire.is_closed());
+
+    Precision perimeter = 0.0;
+    for (const EdgeView& edge : wire.get_edges()) {
+        perimeter += edge.length();
+        EXPECT_FALSE(edge.is_closed());
+    }
+    EXPECT_DOUBLE_EQ(perimeter, 4.0);
+    EXPECT_EQ(wire.get_vertices()[1].get_position(), Point3D(0, 1, 0));
+}
+
+TEST(BRepStoreTest, HolesAndExplicitEdgeKeys) {
+    // Two arcs between the same two vertices close a circular hole
+    BRepStore store;
+    const SolidHandle solid = store.add_solid();
+    const ShellHandle shell = store.add_shell(solid);
+    std::vector<VertexHandle> outer;
+    for (const Point3D& p : {Point3D(-2, -2, 0), Point3D(2, -2, 0), Point3D(2, 2, 0), Point3D(-2, 2, 0)}) {
+        outer.push_back(store.add_vertex(p));
+    }
+    const VertexHandle a = store.add_vertex(Point3D(1, 0, 0)), b = store.add_vertex(Point3D(-1, 0, 0));
+    const std::vector<uint64_t> outer_keys{1, 2, 3, 4};
+    const FaceHandle face = store.add_face(shell, outer, outer_keys);
+    const std::vector<VertexHandle> hole{a, b};
+    const std::vector<uint64_t> hole_keys{10, 11};
+    store.add_hole(face, hole, hole_keys);
+
+    EXPECT_EQ(store.get_edge_count(), 6u);
+    EXPECT_EQ(FaceView(store, face).get_inner_boundaries().size(), 1u);
+
+    int loops = 0;
+    store.for_each_loop(face, [&](LoopHandle) { loops++; });
+    EXPECT_EQ(loops, 2);
+
+    // A mismatched key count is rejected
+    const std::vector<uint64_t> short_keys{1};
+    EXPECT_THROW(store.add_face(shell, outer, short_keys), std::invalid_argument);
+}
+
+// =============================================================================
+// Validation Tests
+// =============================================================================
+
+TEST(BRepStoreTest, ReportsOpenFlippedAndNonManifold) {
+    {
+        Cube cube;
+        cube.store.remove_face(cube.faces[1]);
+        EXPECT_EQ(cube.store.validate(cube.solid), ValidationState::OpenVolume);
+    }
+    {
+        Cube cube;
+        cube.store.remove_face(cube.faces[1]);
+        cube.add({cube.v[4], cube.v[6], cube.v[7], cube.v[5]});  // Wound inwards
+        EXPECT_EQ(cube.store.validate(cube.solid), ValidationState::InvalidOrientation);
+    }
+    {
+        // A fin on the edge from v0 to v1: three faces meet there
+        Cube cube;
+        const VertexHandle fin = cube.store.add_vertex(Point3D(0.5, -1, -1));
+        cube.add({cube.v[1], cube.v[0], fin});
+        EXPECT_EQ(cube.store.validate(cube.solid), ValidationState::NonManifold);
+    }
+}
+
+// =============================================================================
+// Editing Tests
+// =============================================================================
+
+TEST(BRepStoreTest, RemoveAndCompact) {
+    Cube cube;
+    const size_t full_bytes = cube.store.memory_usage();
+    cube.store.remove_face(cube.faces[0]);
+    EXPECT_EQ(cube.store.get_face_count(), 5u);
+    EXPECT_EQ(cube.store.get_half_edge_count(), 20u);
+    EXPECT_EQ(cube.store.get_edge_count(), 12u);  // The bottom edges stay, open
+
+    // The fan around a bottom corner now stops at the open edges on both sides
+    size_t fan = 0;
+    cube.store.for_each_outgoing(cube.v[0], [&](HalfEdgeHandle he) {
+        EXPECT_TRUE(cube.store.is_alive(he));
+        fan++;
+    });
+    EXPECT_EQ(fan, 2u);
+
+    // Removing the four sides leaves the top alone, and the bottom corners unused
+    for (size_t i = 2; i < 6; ++i) {
+        cube.store.remove_face(cube.faces[i]);
+    }
+    cube.store.compact();
+    EXPECT_EQ(cube.store.get_vertex_count(), 4u);
+    EXPECT_EQ(cube.store.get_edge_count(), 4u);
+    EXPECT_EQ(cube.store.get_face_count(), 1u);
+    EXPECT_LE(cube.store.memory_usage(), full_bytes);
+    EXPECT_EQ(ShellView(cube.store, cube.shell).get_face_count(), 1u);
+    EXPECT_EQ(cube.store.validate(cube.solid), ValidationState::OpenVolume);
+
+    // Survivors are renumbered and their neighbours found through the rebuilt index
+    std::vector<VertexHandle> top;
+    cube.store.for_each_face(cube.shell, [&](FaceHandle face) {
+        WireView wire(cube.store, cube.store.face(face).outer);
+        for (const VertexView& vertex : wire.get_vertices()) {
+            top.push_back(vertex.get_handle());
+        }
+    });
+    ASSERT_EQ(top.size(), 4u);
+    EXPECT_EQ(top[0].index, 0u);
+    cube.store.add_face(cube.shell, std::vector<VertexHandle>{top[1], top[0], top[3]});
+    EXPECT_EQ(cube.store.get_edge_count(), 5u);
+    EXPECT_EQ(cube.store.validate(cube.solid), ValidationState::OpenVolume);
+}
+
+TEST(BRepStoreTest, CopiesAreIndependent) {
+    Cube cube;
+    BRepStore copy = cube.store;
+    copy.remove_face(cube.faces[0]);
+    copy.set_vertex_position(cube.v[0], Point3D(-1, -1, -1));
+
+    EXPECT_EQ(cube.store.validate(cube.solid), ValidationState::Valid);
+    EXPECT_EQ(cube.store.vertex(cube.v[0]).position, Point3D(0, 0, 0));
+    EXPECT_EQ(copy.validate(cube.solid), ValidationState::OpenVolume);
+}
+
+} // namespace qcs::cad::test
@@ -11,7 +11,10 @@
 #include <gtest/gtest.h>
 #include "../constraint_solver.hpp"
 #include "../cad_common.hpp"
+#include <algorithm>
 #include <cmath>
+#include <memory>
+#include <string>
 
 namespace qcs::cad::test {
 
@@ -91,6 +94,28 @@ TEST(ConstraintSolverTest, VariableManager) {
     EXPECT_EQ(manager.get_variable(id1), nullptr);
 }
 
+TEST(ConstraintSolverTest, VariableStorage) {
+    VariableManager manager;
+    VariableID x = manager.create_variable("x", 1.0);
+    VariableID y = manager.create_variable("y", 2.0);
+    
+    // Objects and the dense values are views of the same storage
+    ConstraintVariable* var = manager.get_variable(x);
+    var->set_bounds(0.0, 5.0);
+    manager.set_value(x, 7.0);
+    EXPECT_EQ(var->get_value(), 5.0);
+    var->set_value(3.0);
+    EXPECT_EQ(manager.get_values()[x], 3.0);
+    EXPECT_EQ(manager.get_values()[y], 2.0);
+    
+    // Slots outlive removal; the ID just stops naming a variable
+    manager.remove_variable(x);
+    EXPECT_FALSE(manager.contains(x));
+    EXPECT_TRUE(manager.contains(y));
+    EXPECT_EQ(manager.create_variable("z", 4.0), y + 1);
+    EXPECT_EQ(manager.get_id_limit(), y + 2u);
+}
+
 // =============================================================================
 // Distance Constraint Tests
 // =============================================================================
@@ -374,6 +399,279 @@ TEST(ConstraintSolverTest, ErrorHandling) {
     }
 }
 
+TEST(ConstraintSolverTest, BatchedEvaluation) {
+    VariableManager manager;
+    std::vector<VariableID> v;
+    for (int i = 0; i < 8; ++i) {
+        v.push_back(manager.create_variable("v" + std::to_string(i), 0.3 * i * i - i));
+    }
+    std::vector<std::unique_ptr<GeometricConstraint>> constraints;
+    constraints.push_back(std::make_unique<DistanceConstraint>(0, v[0], v[1], v[2], v[3], 2.0));
+    constraints.push_back(std::make_unique<HorizontalConstraint>(1, v[1], v[3]));
+    constraints.push_back(std::make_unique<ParallelConstraint>(2, v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]));
+    constraints.push_back(std::make_unique<DistanceConstraint>(3, v[4], v[5], v[6], v[7], 1.0));
+    constraints.push_back(std::make_unique<PerpendicularConstraint>(4, v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]));
+    constraints.push_back(std::make_unique<VerticalConstraint>(5, v[2], v[6]));
+    constraints.push_back(std::make_unique<CoincidentConstraint>(6, v[0], v[1], v[6], v[7]));
+    
+    std::vector<const GeometricConstraint*> rows;
+    for (const auto& constraint : constraints) {
+        rows.push_back(constraint.get());
+    }
+    ConstraintEvaluator evaluator;
+    evaluator.prepare(rows);
+    EXPECT_EQ(evaluator.get_row_count(), constraints.size());
+    EXPECT_EQ(evaluator.get_batch_count(), 6u);  // The two distances share one
+    
+    // Rows keep their order whatever batch evaluated them
+    evaluator.evaluate_residuals(manager.get_values());
+    evaluator.evaluate_gradients(manager.get_values());
+    for (size_t row = 0; row < constraints.size(); ++row) {
+        EXPECT_DOUBLE_EQ(evaluator.get_residuals()[row], constraints[row]->evaluate_error(manager));
+        const std::vector<Precision> expected = constraints[row]->evaluate_gradient(manager);
+        const auto gradient = evaluator.get_gradient(row);
+        ASSERT_EQ(gradient.size(), expected.size());
+        for (size_t k = 0; k < expected.size(); ++k) {
+            EXPECT_DOUBLE_EQ(gradient[k], expected[k]);
+        }
+    }
+}
+
+TEST(ConstraintSolverTest, ClusterDecomposition) {
+    ConstraintSystem system;
+    VariableManager& manager = system.get_variable_manager();
+    
+    // Two chains of unit links hanging from fixed points share nothing
+    std::vector<std::vector<std::pair<VariableID, VariableID>>> chains(2);
+    size_t id = 0;
+    for (auto& chain : chains) {
+        for (int i = 0; i < 5; ++i) {
+            chain.emplace_back(manager.create_variable("x", i * 1.2), manager.create_variable("y", 0.1 * i));
+        }
+        manager.get_variable(chain[0].first)->set_fixed(true);
+        manager.get_variable(chain[0].second)->set_fixed(true);
+        for (size_t i = 0; i + 1 < chain.size(); ++i) {
+            system.add_constraint(std::make_unique<DistanceConstraint>(
+                id++, chain[i].first, chain[i].second, chain[i + 1].first, chain[i + 1].second, 1.0));
+        }
+    }
+    
+    EXPECT_EQ(system.get_cluster_count(), 2u);
+    EXPECT_EQ(system.solve(), SolverStatus::Converged);
+    EXPECT_EQ(system.get_last_solved_cluster_count(), 2u);
+    
+    // Dragging the end of one chain leaves the other alone
+    const Precision untouched = manager.get_variable(chains[1][4].first)->get_value();
+    EXPECT_EQ(system.solve_drag({chains[0][4].first, chains[0][4].second}, {2.0, 2.0}),
+              SolverStatus::Converged);
+    EXPECT_EQ(system.get_last_solved_cluster_count(), 1u);
+    EXPECT_DOUBLE_EQ(manager.get_variable(chains[0][4].first)->get_value(), 2.0);
+    EXPECT_DOUBLE_EQ(manager.get_variable(chains[1][4].first)->get_value(), untouched);
+    for (size_t i = 0; i < id; ++i) {
+        EXPECT_NEAR(system.get_constraint(i)->evaluate_error(manager), 0.0, 1e-9);
+    }
+}
+
+TEST(ConstraintSolverTest, DragSessionConvergesOverFrames) {
+    ConstraintSystem system;
+    VariableManager& manager = system.get_variable_manager();
+    
+    // A chain of unit links hanging from a fixed point
+    std::vector<std::pair<VariableID, VariableID>> chain;
+    for (int i = 0; i < 10; ++i) {
+        chain.emplace_back(manager.create_variable("x", i * 1.0), manager.create_variable("y", 0.0));
+    }
+    manager.get_variable(chain[0].first)->set_fixed(true);
+    manager.get_variable(chain[0].second)->set_fixed(true);
+    for (size_t i = 0; i + 1 < chain.size(); ++i) {
+        system.add_constraint(std::make_unique<DistanceConstraint>(
+            i, chain[i].first, chain[i].second, chain[i + 1].first, chain[i + 1].second, 1.0));
+    }
+    ASSERT_EQ(system.solve(), SolverStatus::Converged);
+    
+    auto total_error = [&]() {
+        Precision error = 0.0;
+        for (size_t i = 0; i + 1 < chain.size(); ++i) {
+            const Precision residual = system.get_constraint(i)->evaluate_error(manager);
+            error += residual * residual;
+        }
+        return std::sqrt(error);
+    };
+    
+    // One iteration a frame cannot settle a long pull, but no frame leaves
+    // the sketch worse than it found it and later frames finish the job
+    system.begin_drag({chain.back().first, chain.back().second});
+    EXPECT_TRUE(system.is_dragging());
+    EXPECT_EQ(system.drag_to({4.0, 5.0}, 1), SolverStatus::MaxIterations);
+    Precision previous = total_error();
+    int frames = 0;
+    SolverStatus status = SolverStatus::MaxIterations;
+    while (status == SolverStatus::MaxIterations && frames++ < 100) {
+        status = system.continue_drag(1);
+        EXPECT_LE(total_error(), previous + 1e-12);
+        previous = total_error();
+    }
+    EXPECT_EQ(status, SolverStatus::Converged);
+    EXPECT_NEAR(total_error(), 0.0, 1e-8);
+    
+    // Small moves from the settled state converge within the budget
+    for (int frame = 1; frame <= 5; ++frame) {
+        EXPECT_EQ(system.drag_to({4.0 + 0.05 * frame, 5.0}, 8), SolverStatus::Converged);
+    }
+    EXPECT_DOUBLE_EQ(manager.get_variable(chain.back().first)->get_value(), 4.25);
+    system.end_drag();
+    EXPECT_FALSE(system.is_dragging());
+    EXPECT_EQ(system.continue_drag(), SolverStatus::Failed);
+}
+
+namespace {
+
+/// Gauss-Newton over the whole system with dense least-squares steps, as a
+/// reference for the sparse cluster solves
+std::vector<Precision> dense_gauss_newton(const ConstraintSystem& system, const std::vector<size_t>& constraints,
+                                          const std::vector<VariableID>& free, int iterations) {
+    using Matrix = Eigen::Matrix<Precision, Eigen::Dynamic, Eigen::Dynamic>;
+    using Vector = Eigen::Matrix<Precision, Eigen::Dynamic, 1>;
+    
+    const VariableValues start = system.get_variable_manager().get_values();
+    std::vector<Precision> values(start.begin(), start.end());
+    const auto rows = static_cast<Eigen::Index>(constraints.size());
+    const auto cols = static_cast<Eigen::Index>(free.size());
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        Matrix jacobian = Matrix::Zero(rows, cols);
+        Vector residuals(rows);
+        for (Eigen::Index row = 0; row < rows; ++row) {
+            const GeometricConstraint* constraint = system.get_constraint(constraints[row]);
+            const auto& variables = constraint->get_variables();
+            std::vector<Precision> gradient(variables.size());
+            residuals[row] = constraint->evaluate_error(values);
+            constraint->evaluate_gradient(values, gradient);
+            for (size_t k = 0; k < variables.size(); ++k) {
+                auto col = std::find(free.begin(), free.end(), variables[k]);
+                if (col != free.end()) {
+                    jacobian(row, col - free.begin()) += gradient[k];
+                }
+            }
+        }
+        const Vector delta = jacobian.completeOrthogonalDecomposition().solve(-residuals);
+        for (Eigen::Index col = 0; col < cols; ++col) {
+            values[free[col]] += delta[col];
+        }
+    }
+    return values;
+}
+
+} // namespace
+
+TEST(ConstraintSolverTest, SparseSolveMatchesDenseGaussNewton) {
+    ConstraintSystem system;
+    VariableManager& manager = system.get_variable_manager();
+    
+    // A 3-4-5 triangle hanging from a fixed corner, its second corner held
+    // level with the first
+    const VariableID ax = manager.create_variable("ax", 0.0);
+    const VariableID ay = manager.create_variable("ay", 0.0);
+    manager.get_variable(ax)->set_fixed(true);
+    manager.get_variable(ay)->set_fixed(true);
+    const std::vector<VariableID> free = {
+        manager.create_variable("bx", 2.7), manager.create_variable("by", 0.0),
+        manager.create_variable("cx", 2.8), manager.create_variable("cy", 4.3)};
+    const VariableID bx = free[0], by = free[1], cx = free[2], cy = free[3];
+    const std::vector<size_t> constraints = {
+        system.add_constraint(std::make_unique<DistanceConstraint>(0, ax, ay, bx, by, 3.0)),
+        system.add_constraint(std::make_unique<DistanceConstraint>(1, bx, by, cx, cy, 4.0)),
+        system.add_constraint(std::make_unique<DistanceConstraint>(2, ax, ay, cx, cy, 5.0)),
+        system.add_constraint(std::make_unique<HorizontalConstraint>(3, ay, by))};
+    
+    const std::vector<Precision> expected = dense_gauss_newton(system, constraints, free, 20);
+    EXPECT_EQ(system.solve(), SolverStatus::Converged);
+    for (VariableID id : free) {
+        EXPECT_NEAR(manager.get_value(id), expected[id], 1e-9);
+    }
+    EXPECT_NEAR(manager.get_value(bx), 3.0, 1e-9);
+    EXPECT_NEAR(manager.get_value(cx), 3.0, 1e-9);
+    EXPECT_NEAR(manager.get_value(cy), 4.0, 1e-9);
+}
+
+TEST(ConstraintSolverTest, SparseLeastSquaresMatchesDense) {
+    ConstraintSystem system;
+    VariableManager& manager = system.get_variable_manager();
+    
+    // Distances to three fixed anchors that no point meets exactly, so the
+    // solve settles on the least-squares point
+    std::vector<std::pair<VariableID, VariableID>> anchors;
+    for (const auto& [x, y] : std::vector<std::pair<Precision, Precision>>{{0.0, 0.0}, {10.0, 0.0}, {0.0, 10.0}}) {
+        anchors.emplace_back(manager.create_variable("x", x), manager.create_variable("y", y));
+        manager.get_variable(anchors.back().first)->set_fixed(true);
+        manager.get_variable(anchors.back().second)->set_fixed(true);
+    }
+    const std::vector<VariableID> free = {manager.create_variable("px", 4.0), manager.create_variable("py", 3.0)};
+    const Precision lengths[] = {5.0, 6.0, 8.0};
+    std::vector<size_t> constraints;
+    for (size_t i = 0; i < anchors.size(); ++i) {
+        constraints.push_back(system.add_constraint(std::make_unique<DistanceConstraint>(
+            i, anchors[i].first, anchors[i].second, free[0], free[1], lengths[i])));
+    }
+    
+    const std::vector<Precision> expected = dense_gauss_newton(system, constraints, free, 50);
+    EXPECT_NE(system.solve(), SolverStatus::Converged);
+    EXPECT_NEAR(manager.get_value(free[0]), expected[free[0]], 1e-9);
+    EXPECT_NEAR(manager.get_value(free[1]), expected[free[1]], 1e-9);
+}
+
+TEST(ConstraintSolverTest, SymbolicAnalysisIsReused) {
+    ConstraintSystem system;
+    VariableManager& manager = system.get_variable_manager();
+    
+    // A point six units from each of two fixed anchors
+    const VariableID ax = manager.create_variable("ax", 0.0);
+    const VariableID ay = manager.create_variable("ay", 0.0);
+    const VariableID bx = manager.create_variable("bx", 10.0);
+    const VariableID by = manager.create_variable("by", 0.0);
+    for (VariableID id : {ax, ay, bx, by}) {
+        manager.get_variable(id)->set_fixed(true);
+    }
+    const VariableID px = manager.create_variable("px", 4.0);
+    const VariableID py = manager.create_variable("py", 3.0);
+    system.add_constraint(std::make_unique<DistanceConstraint>(0, ax, ay, px, py, 6.0));
+    system.add_constraint(std::make_unique<DistanceConstraint>(1, bx, by, px, py, 6.0));
+    
+    ASSERT_EQ(system.solve(), SolverStatus::Converged);
+    const size_t analysed = system.get_symbolic_factorization_count();
+    const size_t factorised = system.get_numeric_factorization_count();
+    EXPECT_GT(analysed, 0u);
+    EXPECT_GT(factorised, analysed);
+    
+    // New values, same structure: refactored, not reanalysed
+    manager.set_value(px, 2.0);
+    manager.set_value(py, 7.0);
+    ASSERT_EQ(system.solve(), SolverStatus::Converged);
+    EXPECT_EQ(system.get_symbolic_factorization_count(), analysed);
+    EXPECT_GT(system.get_numeric_factorization_count(), factorised);
+    
+    // Dragging the end of a two-link arm analyses the drag cluster once
+    const VariableID cx = manager.create_variable("cx", 20.0);
+    const VariableID cy = manager.create_variable("cy", 0.0);
+    manager.get_variable(cx)->set_fixed(true);
+    manager.get_variable(cy)->set_fixed(true);
+    const VariableID rx = manager.create_variable("rx", 24.0);
+    const VariableID ry = manager.create_variable("ry", 4.5);
+    const VariableID qx = manager.create_variable("qx", 27.0);
+    const VariableID qy = manager.create_variable("qy", 0.0);
+    system.add_constraint(std::make_unique<DistanceConstraint>(2, cx, cy, rx, ry, 6.0));
+    system.add_constraint(std::make_unique<DistanceConstraint>(3, rx, ry, qx, qy, 5.0));
+    
+    system.begin_drag({qx, qy});
+    ASSERT_EQ(system.drag_to({27.1, 0.0}, 20), SolverStatus::Converged);
+    const size_t drag_analysed = system.get_symbolic_factorization_count();
+    EXPECT_GT(drag_analysed, analysed);
+    for (int frame = 2; frame <= 10; ++frame) {
+        EXPECT_EQ(system.drag_to({27.0 + 0.1 * frame, 0.1 * frame}, 20), SolverStatus::Converged);
+    }
+    system.end_drag();
+    EXPECT_EQ(system.get_symbolic_factorization_count(), drag_analysed);
+}
+
 TEST(ConstraintSolverTest, PerformanceBaseline) {
     VariableManager manager;
     
@@ -0,0 +1,128 @@
+/**
+ * @file test_entity_index.cpp
+ * @brief Unit tests for the entity bounds hierarchy and view frustum
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Frustum planes, incremental edits and culling against a brute force scan
+ */
+
+#include <gtest/gtest.h>
+#include "../entity_index.hpp"
+#include "../precision_renderer.hpp"
+#include <algorithm>
+#include <random>
+
+namespace qcs::cad::test {
+
+namespace {
+
+BoundingBox3D box(Precision x0, Precision y0, Precision x1, Precision y1) {
+    return BoundingBox3D(Point3D(x0, y0, 0), Point3D(x1, y1, 0));
+}
+
+// Looks straight down at the XY plane, showing [-5, 5] on both axes
+CADViewport top_view() {
+    CADViewport viewport(100, 100);
+    viewport.look_at(Point3D(0, 0, 10), Point3D::Zero(), Vector3D::UnitY());
+    viewport.set_orthographic(true, 10.0);
+    viewport.set_clipping_planes(0.1, 100.0);
+    return viewport;
+}
+
+std::vector<EntityID> sorted(std::vector<EntityID> ids) {
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+} // namespace
+
+// =============================================================================
+// View Frustum Tests
+// =============================================================================
+
+TEST(EntityIndexTest, FrustumClassifiesBoxes) {
+    const CADViewport viewport = top_view();
+    const ViewFrustum& frustum = viewport.get_frustum();
+
+    EXPECT_EQ(frustum.classify(box(-1, -1, 1, 1)), ViewFrustum::Containment::Inside);
+    EXPECT_EQ(frustum.classify(box(4, 4, 6, 6)), ViewFrustum::Containment::Intersecting);
+    EXPECT_EQ(frustum.classify(box(6, -1, 7, 1)), ViewFrustum::Containment::Outside);
+    EXPECT_TRUE(frustum.contains(Point3D(4.9, -4.9, 0)));
+    EXPECT_FALSE(frustum.contains(Point3D(0, 0, 20)));  // Behind the camera
+
+    // A box around the whole view has no corner inside it, but is seen
+    EXPECT_TRUE(viewport.is_bounds_visible(box(-50, -50, 50, 50)));
+    EXPECT_FALSE(viewport.is_bounds_visible(box(-50, 6, 50, 7)));
+}
+
+// =============================================================================
+// Index Tests
+// =============================================================================
+
+TEST(EntityIndexTest, EditsKeepQueriesExact) {
+    EntityIndex index;
+    index.insert(1, box(0, 0, 1, 1));
+    index.insert(2, box(2, 0, 3, 1));
+    index.insert(3, box(0, 2, 1, 3));
+    EXPECT_EQ(index.size(), 3u);
+
+    std::vector<EntityID> hits;
+    index.query(box(0.5, 0.5, 2.5, 0.6), hits);
+    EXPECT_EQ(sorted(hits), (std::vector<EntityID>{1, 2}));
+
+    // A small move stays within the margin; a large one reinserts
+    index.insert(1, box(0.05, 0, 1.05, 1));
+    index.insert(2, box(10, 10, 11, 11));
+    hits.clear();
+    index.query(box(0.5, 0.5, 2.5, 0.6), hits);
+    EXPECT_EQ(hits, (std::vector<EntityID>{1}));
+    EXPECT_EQ(index.get_bounds(1)->min.x(), 0.05);
+
+    EXPECT_TRUE(index.remove(3));
+    EXPECT_FALSE(index.remove(3));
+    EXPECT_FALSE(index.contains(3));
+    EXPECT_EQ(index.get_bounds(3), nullptr);
+    EXPECT_EQ(index.get_total_bounds().max.x(), 11.0 + 0.1);
+}
+
+TEST(EntityIndexTest, FrustumQueryMatchesBruteForce) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<Precision> position(-20.0, 20.0), extent(0.0, 0.5);
+    std::vector<std::pair<EntityID, BoundingBox3D>> entities;
+    for (EntityID id = 1; id <= 5000; ++id) {
+        const Precision x = position(rng), y = position(rng);
+        entities.emplace_back(id, box(x, y, x + extent(rng), y + extent(rng)));
+    }
+
+    EntityIndex index;
+    index.build(entities);
+    EXPECT_EQ(index.size(), entities.size());
+    EXPECT_LE(index.height(), 2u * 13u + 8u);
+
+    // Incremental edits after the build: move some, drop others
+    for (size_t i = 0; i < entities.size(); i += 7) {
+        auto& [id, bounds] = entities[i];
+        bounds = box(bounds.min.x() + 3, bounds.min.y(), bounds.max.x() + 3, bounds.max.y());
+        index.insert(id, bounds);
+    }
+    for (size_t i = 3; i < entities.size(); i += 11) {
+        index.remove(entities[i].first);
+    }
+
+    const CADViewport viewport = top_view();
+    std::vector<EntityID> expected;
+    for (size_t i = 0; i < entities.size(); ++i) {
+        if (index.contains(entities[i].first) && viewport.get_frustum().intersects(entities[i].second)) {
+            expected.push_back(entities[i].first);
+        }
+    }
+
+    std::vector<EntityID> visible;
+    index.query(viewport.get_frustum(), visible);
+    EXPECT_EQ(sorted(visible), expected);
+    EXPECT_LT(visible.size(), index.size() / 4);
+}
+
+} // namespace qcs::cad::test
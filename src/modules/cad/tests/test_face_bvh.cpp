@@ -0,0 +1,174 @@
+/**
+ * @file test_face_bvh.cpp
+ * @brief Unit tests for face hierarchies and the Boolean broad phase
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Pair culling checked against brute force, progress and cancellation
+ */
+
+#include <gtest/gtest.h>
+#include "../face_bvh.hpp"
+#include <algorithm>
+#include <atomic>
+#include <random>
+
+namespace qcs::cad::test {
+
+namespace {
+
+// Small boxes scattered through a cube, like the faces of a finely
+// tessellated part
+std::vector<BoundingBox3D> scattered_boxes(size_t count, unsigned seed, Precision offset = 0.0) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<Precision> position(0.0, 10.0);
+    std::uniform_real_distribution<Precision> extent(0.01, 0.4);
+    std::vector<BoundingBox3D> boxes;
+    for (size_t i = 0; i < count; ++i) {
+        const Point3D min(position(rng) + offset, position(rng), position(rng));
+        boxes.emplace_back(min, min + Vector3D(extent(rng), extent(rng), extent(rng)));
+    }
+    return boxes;
+}
+
+std::vector<FacePair> brute_force_pairs(const std::vector<BoundingBox3D>& first,
+                                        const std::vector<BoundingBox3D>& second, Precision tolerance) {
+    const Vector3D margin = Vector3D::Constant(tolerance);
+    std::vector<FacePair> pairs;
+    for (FaceIndex i = 0; i < first.size(); ++i) {
+        const BoundingBox3D a(first[i].min - margin, first[i].max + margin);
+        for (FaceIndex j = 0; j < second.size(); ++j) {
+            if (a.intersects(BoundingBox3D(second[j].min - margin, second[j].max + margin))) {
+                pairs.emplace_back(i, j);
+            }
+        }
+    }
+    return pairs;
+}
+
+} // namespace
+
+// =============================================================================
+// FaceBVH Tests
+// =============================================================================
+
+TEST(FaceBVHTest, BuildsBalancedTree) {
+    const auto boxes = scattered_boxes(1000, 1);
+    FaceBVH bvh(boxes);
+    EXPECT_EQ(bvh.get_face_count(), boxes.size());
+
+    // Every face has its own leaf, holding its grown bounds
+    const FaceBVH::Tree& tree = bvh.get_tree();
+    ASSERT_EQ(tree.size(), boxes.size());
+    for (FaceIndex face = 0; face < boxes.size(); ++face) {
+        const BoundingBox3D* bounds = tree.bounds(face);
+        ASSERT_NE(bounds, nullptr);
+        EXPECT_TRUE(bounds->contains(boxes[face].min));
+        EXPECT_TRUE(bounds->contains(boxes[face].max));
+    }
+
+    // And every interior node bounds its children
+    size_t leaves = 0;
+    std::vector<int32_t> stack{tree.root()};
+    while (!stack.empty()) {
+        const FaceBVH::Tree::Node& node = tree.node(stack.back());
+        stack.pop_back();
+        if (node.is_leaf()) {
+            leaves++;
+            continue;
+        }
+        for (int32_t child : {node.child1, node.child2}) {
+            EXPECT_TRUE(FaceBVH::Tree::encloses(node.bounds, tree.node(child).bounds));
+            stack.push_back(child);
+        }
+    }
+    EXPECT_EQ(leaves, boxes.size());
+    EXPECT_LE(tree.height(), 2u * 10u + 8u);
+}
+
+TEST(FaceBVHTest, QueryMatchesBruteForce) {
+    const auto boxes = scattered_boxes(500, 2);
+    FaceBVH bvh(boxes, 0.0);
+
+    const BoundingBox3D region(Point3D(2.0, 3.0, 4.0), Point3D(5.0, 5.0, 6.0));
+    std::vector<FaceIndex> found;
+    bvh.query(region, found);
+    std::sort(found.begin(), found.end());
+
+    std::vector<FaceIndex> expected;
+    for (FaceIndex i = 0; i < boxes.size(); ++i) {
+        if (boxes[i].intersects(region)) {
+            expected.push_back(i);
+        }
+    }
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(found, expected);
+}
+
+TEST(FaceBVHTest, SkipsInvalidAndDegenerateFaces) {
+    // Invalid bounds overlap nothing; coincident ones still split into leaves
+    std::vector<BoundingBox3D> boxes(20, BoundingBox3D(Point3D::Zero(), Point3D::Ones()));
+    boxes.push_back(BoundingBox3D(Point3D::Ones(), Point3D::Zero()));
+    FaceBVH bvh(boxes);
+
+    std::vector<FaceIndex> found;
+    bvh.query(BoundingBox3D(Point3D::Constant(0.5), Point3D::Constant(0.5)), found);
+    EXPECT_EQ(found.size(), 20u);
+    EXPECT_EQ(std::count(found.begin(), found.end(), FaceIndex(20)), 0);
+
+    EXPECT_TRUE(FaceBVH(std::vector<BoundingBox3D>{}).empty());
+}
+
+// =============================================================================
+// Broad Phase Tests
+// =============================================================================
+
+TEST(FaceBVHTest, OverlappingFacesMatchBruteForce) {
+    const Precision tolerance = 0.05;
+    const auto first = scattered_boxes(1500, 3);
+    const auto second = scattered_boxes(1200, 4, 3.0);
+    const FaceBVH a(first, tolerance / 2), b(second, tolerance / 2);
+
+    const auto pairs = find_overlapping_faces(a, b);
+    EXPECT_EQ(pairs, brute_force_pairs(first, second, tolerance / 2));
+    EXPECT_FALSE(pairs.empty());
+
+    // Solids far apart are culled at the roots
+    const FaceBVH far(scattered_boxes(100, 5, 100.0));
+    EXPECT_TRUE(find_overlapping_faces(a, far).empty());
+    EXPECT_TRUE(find_overlapping_faces(a, FaceBVH()).empty());
+}
+
+TEST(FaceBVHTest, TouchingFacesPairWithinTolerance) {
+    const std::vector<BoundingBox3D> left{BoundingBox3D(Point3D::Zero(), Point3D::Ones())};
+    const std::vector<BoundingBox3D> right{BoundingBox3D(Point3D(1.0 + 0.5 * GEOMETRIC_TOLERANCE, 0, 0),
+                                                         Point3D(2.0, 1.0, 1.0))};
+    EXPECT_EQ(find_overlapping_faces(FaceBVH(left, 0.0), FaceBVH(right, 0.0)).size(), 0u);
+    EXPECT_EQ(find_overlapping_faces(FaceBVH(left), FaceBVH(right)).size(), 1u);
+}
+
+TEST(FaceBVHTest, ReportsProgressAndCancels) {
+    std::vector<FacePair> pairs(10000);
+    for (FaceIndex i = 0; i < pairs.size(); ++i) {
+        pairs[i] = {i, i};
+    }
+
+    std::atomic<size_t> visited{0};
+    std::vector<Precision> reports;
+    EXPECT_TRUE(for_each_face_pair(pairs, [&](const FacePair&) { visited++; },
+                                   [&](Precision progress) { reports.push_back(progress); return true; }));
+    EXPECT_EQ(visited, pairs.size());
+    ASSERT_FALSE(reports.empty());
+    EXPECT_TRUE(std::is_sorted(reports.begin(), reports.end()));
+    EXPECT_DOUBLE_EQ(reports.back(), 1.0);
+
+    // Cancelling at the first report leaves the remaining slices untouched
+    visited = 0;
+    EXPECT_FALSE(for_each_face_pair(pairs, [&](const FacePair&) { visited++; },
+                                    [](Precision) { return false; }));
+    EXPECT_GT(visited, 0u);
+    EXPECT_LT(visited, pairs.size());
+}
+
+} // namespace qcs::cad::test
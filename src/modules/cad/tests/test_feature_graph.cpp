@@ -0,0 +1,207 @@
+/**
+ * @file test_feature_graph.cpp
+ * @brief Unit tests for the feature dependency graph
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Incremental regeneration, branch independence, failures and suppression
+ */
+
+#include <gtest/gtest.h>
+#include "../feature_graph.hpp"
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+
+namespace qcs::cad::test {
+
+namespace {
+
+// The graph never looks inside results, so a tag cast to the result type
+// stands in for a solid
+struct Tag {
+    size_t feature_id;
+    size_t run;
+};
+
+FeatureGraph::Result make_result(size_t feature_id, size_t run) {
+    auto tag = std::make_shared<Tag>(Tag{feature_id, run});
+    return FeatureGraph::Result(tag, reinterpret_cast<TopologyEntity*>(tag.get()));
+}
+
+const Tag& tag_of(const FeatureGraph::Result& result) {
+    return *reinterpret_cast<const Tag*>(result.get());
+}
+
+// Records what ran and what each run was given
+struct Recorder {
+    std::mutex mutex;
+    std::vector<size_t> executed;
+    std::unordered_map<size_t, std::vector<FeatureGraph::Result>> inputs;
+    std::unordered_map<size_t, bool> fail;
+    size_t runs = 0;
+
+    FeatureGraph::ExecuteFn callback() {
+        return [this](size_t id, const std::vector<FeatureGraph::Result>& given) {
+            std::lock_guard<std::mutex> lock(mutex);
+            executed.push_back(id);
+            inputs[id] = given;
+            return fail[id] ? FeatureGraph::Result() : make_result(id, ++runs);
+        };
+    }
+
+    void reset() {
+        executed.clear();
+        inputs.clear();
+    }
+};
+
+} // namespace
+
+// =============================================================================
+// Regeneration Tests
+// =============================================================================
+
+TEST(FeatureGraphTest, EditNearTheEndRunsOnlyWhatFollows) {
+    FeatureGraph graph;
+    graph.add_feature(0);
+    for (size_t id = 1; id < 300; ++id) {
+        const size_t previous = id - 1;
+        graph.add_feature(id, {&previous, 1});
+    }
+
+    Recorder recorder;
+    auto stats = graph.regenerate(recorder.callback());
+    EXPECT_EQ(stats.executed, 300u);
+    EXPECT_EQ(stats.reused, 0u);
+    for (size_t i = 0; i < recorder.executed.size(); ++i) {
+        EXPECT_EQ(recorder.executed[i], i);
+    }
+
+    const auto before = graph.get_result(289);
+    recorder.reset();
+    graph.set_revision(290, 1);
+    EXPECT_FALSE(graph.is_dirty(289));
+    EXPECT_TRUE(graph.is_dirty(299));
+
+    stats = graph.regenerate(recorder.callback());
+    EXPECT_EQ(stats.executed, 10u);
+    EXPECT_EQ(stats.reused, 290u);
+    EXPECT_EQ(graph.get_result(289), before);
+    EXPECT_EQ(recorder.inputs[290].front(), before);
+
+    // Same revision again: nothing to do
+    graph.set_revision(290, 1);
+    EXPECT_EQ(graph.regenerate(recorder.callback()).executed, 0u);
+}
+
+TEST(FeatureGraphTest, BranchesRegenerateIndependently) {
+    // base -> {left, right} -> join
+    FeatureGraph graph;
+    const size_t base = 1, left = 2, right = 3, join = 4;
+    graph.add_feature(base);
+    graph.add_feature(left, {&base, 1});
+    graph.add_feature(right, {&base, 1});
+    const std::vector<size_t> both{right, left};
+    graph.add_feature(join, both);
+
+    Recorder recorder;
+    graph.regenerate(recorder.callback());
+    ASSERT_EQ(recorder.executed.size(), 4u);
+    EXPECT_EQ(recorder.executed.front(), base);
+    EXPECT_EQ(recorder.executed.back(), join);
+
+    // Inputs arrive in the order the dependencies were given
+    ASSERT_EQ(recorder.inputs[join].size(), 2u);
+    EXPECT_EQ(tag_of(recorder.inputs[join][0]).feature_id, right);
+    EXPECT_EQ(tag_of(recorder.inputs[join][1]).feature_id, left);
+
+    recorder.reset();
+    graph.mark_dirty(left);
+    const auto stats = graph.regenerate(recorder.callback());
+    EXPECT_EQ(stats.executed, 2u);
+    EXPECT_EQ(stats.reused, 2u);
+    EXPECT_EQ(recorder.executed, (std::vector<size_t>{left, join}));
+
+    EXPECT_EQ(graph.get_downstream(base).size(), 4u);
+    EXPECT_EQ(graph.get_downstream(right), (std::vector<size_t>{right, join}));
+}
+
+TEST(FeatureGraphTest, FailuresBlockDownstreamUntilFixed) {
+    FeatureGraph graph;
+    const size_t a = 1, b = 2, c = 3, other = 4;
+    graph.add_feature(a);
+    graph.add_feature(b, {&a, 1});
+    graph.add_feature(c, {&b, 1});
+    graph.add_feature(other);
+
+    Recorder recorder;
+    recorder.fail[a] = true;
+    auto stats = graph.regenerate(recorder.callback());
+    EXPECT_EQ(stats.executed, 2u);  // a and the unrelated feature
+    EXPECT_EQ(stats.failed, 3u);
+    EXPECT_TRUE(graph.has_failed(c));
+    EXPECT_EQ(graph.get_result(c), nullptr);
+    EXPECT_NE(graph.get_result(other), nullptr);
+    EXPECT_TRUE(graph.is_dirty(c));
+
+    recorder.reset();
+    recorder.fail[a] = false;
+    stats = graph.regenerate(recorder.callback());
+    EXPECT_EQ(recorder.executed, (std::vector<size_t>{a, b, c}));
+    EXPECT_EQ(stats.failed, 0u);
+    EXPECT_FALSE(graph.has_failed(c));
+    EXPECT_FALSE(graph.is_dirty(c));
+}
+
+TEST(FeatureGraphTest, SuppressedFeaturesPassTheirInputThrough) {
+    FeatureGraph graph;
+    const size_t sketch = 1, fillet = 2, shell = 3;
+    graph.add_feature(sketch);
+    graph.add_feature(fillet, {&sketch, 1});
+    graph.add_feature(shell, {&fillet, 1});
+
+    Recorder recorder;
+    graph.regenerate(recorder.callback());
+    recorder.reset();
+
+    graph.set_suppressed(fillet, true);
+    graph.regenerate(recorder.callback());
+    EXPECT_EQ(recorder.executed, (std::vector<size_t>{shell}));
+    EXPECT_EQ(recorder.inputs[shell].front(), graph.get_result(sketch));
+}
+
+// =============================================================================
+// Editing Tests
+// =============================================================================
+
+TEST(FeatureGraphTest, EditingKeepsTheGraphAcyclic) {
+    FeatureGraph graph;
+    const size_t a = 1, b = 2, c = 3, missing = 99;
+    graph.add_feature(a);
+    graph.add_feature(b, {&a, 1});
+    graph.add_feature(c, {&b, 1});
+
+    EXPECT_THROW(graph.add_feature(a), std::invalid_argument);
+    EXPECT_THROW(graph.add_feature(missing + 1, {&missing, 1}), std::invalid_argument);
+    EXPECT_THROW(graph.set_dependencies(a, {&c, 1}), std::invalid_argument);
+    EXPECT_THROW(graph.set_dependencies(a, {&a, 1}), std::invalid_argument);
+    EXPECT_EQ(graph.get_dependencies(a).size(), 0u);
+
+    // Rewiring c straight onto a leaves b a leaf
+    graph.set_dependencies(c, {&a, 1});
+    EXPECT_TRUE(graph.get_dependents(b).empty());
+    EXPECT_EQ(graph.get_dependents(a).size(), 2u);
+
+    Recorder recorder;
+    graph.regenerate(recorder.callback());
+    graph.remove_feature(a);
+    EXPECT_FALSE(graph.contains(a));
+    EXPECT_TRUE(graph.get_dependencies(c).empty());
+    EXPECT_TRUE(graph.is_dirty(b));
+    EXPECT_TRUE(graph.is_dirty(c));
+    EXPECT_EQ(graph.size(), 2u);
+}
+
+} // namespace qcs::cad::test
@@ -0,0 +1,124 @@
+/**
+ * @file test_line_batch.cpp
+ * @brief Unit tests for persistent per-style segment storage
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * In-place edits, span reuse, dirty ranges, draw ranges and compaction
+ */
+
+#include <gtest/gtest.h>
+#include "../line_batch.hpp"
+
+namespace qcs::cad::test {
+
+namespace {
+
+std::vector<Point3D> polyline(Precision x, size_t points) {
+    std::vector<Point3D> result;
+    for (size_t i = 0; i < points; ++i) {
+        result.emplace_back(x, static_cast<Precision>(i), 0);
+    }
+    return result;
+}
+
+} // namespace
+
+// =============================================================================
+// Editing Tests
+// =============================================================================
+
+TEST(LineBatchTest, SegmentsAreRelativeToTheOrigin) {
+    LineBatch batch(Point3D(1e6, 0, 0));
+    const std::vector<Point3D> points{Point3D(1e6 + 0.25, 0, 0), Point3D(1e6 + 0.25, 3, 0), Point3D(1e6 + 4.25, 3, 0)};
+    batch.set_entity(7, points, 0xFF0000FFu);
+
+    const auto& segments = batch.get_segments();
+    ASSERT_EQ(segments.size(), 2u);
+    EXPECT_FLOAT_EQ(segments[0].start[0], 0.25f);
+    EXPECT_FLOAT_EQ(segments[1].end[0], 4.25f);
+    EXPECT_FLOAT_EQ(segments[0].distance, 0.0f);
+    EXPECT_FLOAT_EQ(segments[1].distance, 3.0f);  // Dashes carry on around the corner
+    EXPECT_EQ(segments[1].color, 0xFF0000FFu);
+    EXPECT_EQ(batch.get_span(7).count, 2u);
+    EXPECT_EQ(batch.get_span(8).count, 0u);
+}
+
+TEST(LineBatchTest, EditsRewriteOnlyTheirSpan) {
+    LineBatch batch;
+    for (EntityID id = 1; id <= 100; ++id) {
+        batch.set_entity(id, polyline(static_cast<Precision>(id), 3), 0);
+    }
+    EXPECT_EQ(batch.take_dirty_ranges().size(), 1u);
+    EXPECT_FALSE(batch.has_dirty_ranges());
+
+    // A shorter polyline fits in place; its spare slot goes unused
+    batch.set_entity(50, polyline(50, 2), 0);
+    auto dirty = batch.take_dirty_ranges();
+    ASSERT_EQ(dirty.size(), 1u);
+    EXPECT_EQ(dirty[0].first, 98u);
+    EXPECT_EQ(dirty[0].count, 2u);
+    EXPECT_FALSE(batch.get_segments()[99].is_used());
+    EXPECT_EQ(batch.get_used_segment_count(), 199u);
+
+    // A longer one moves to the end; a removed span is reused by an
+    // entity needing exactly as many segments
+    batch.set_entity(10, polyline(10, 5), 0);
+    EXPECT_EQ(batch.get_span(10).first, 200u);
+    batch.remove_entity(20);
+    batch.set_entity(101, polyline(101, 3), 0);
+    EXPECT_EQ(batch.get_span(101).first, 38u);
+    EXPECT_EQ(batch.get_segments().size(), 204u);
+
+    dirty = batch.take_dirty_ranges(0);
+    ASSERT_EQ(dirty.size(), 3u);
+    EXPECT_EQ(dirty[0].first, 18u);
+    EXPECT_EQ(dirty[1].first, 38u);
+    EXPECT_EQ(dirty[2].first, 200u);
+}
+
+TEST(LineBatchTest, DrawRangesMergeNearbySpans) {
+    LineBatch batch;
+    for (EntityID id = 1; id <= 1000; ++id) {
+        batch.set_entity(id, polyline(static_cast<Precision>(id), 2), 0);
+    }
+
+    const std::vector<EntityID> visible{5, 6, 7, 9, 500, 501, 999, 12345};
+    auto ranges = batch.get_draw_ranges(visible, 1);
+    ASSERT_EQ(ranges.size(), 3u);
+    EXPECT_EQ(ranges[0].first, 4u);
+    EXPECT_EQ(ranges[0].count, 5u);  // Takes in entity 8 rather than draw twice
+    EXPECT_EQ(ranges[1].count, 2u);
+    EXPECT_EQ(ranges[2].first, 998u);
+
+    ranges = batch.get_draw_ranges(visible, 1, 2);
+    EXPECT_LE(ranges.size(), 2u);
+    EXPECT_EQ(ranges.front().first, 4u);
+    EXPECT_EQ(ranges.back().first + ranges.back().count, 999u);
+}
+
+TEST(LineBatchTest, CompactionDropsUnusedSlots) {
+    LineBatch batch;
+    for (EntityID id = 1; id <= 10; ++id) {
+        batch.set_entity(id, polyline(static_cast<Precision>(id), 4), 0);
+    }
+    for (EntityID id = 1; id <= 10; id += 2) {
+        batch.remove_entity(id);
+    }
+    EXPECT_EQ(batch.get_unused_segment_count(), 15u);
+    batch.take_dirty_ranges();
+
+    batch.compact();
+    EXPECT_EQ(batch.get_segments().size(), 15u);
+    EXPECT_EQ(batch.get_unused_segment_count(), 0u);
+    EXPECT_EQ(batch.get_span(2).first, 0u);
+    EXPECT_EQ(batch.get_span(10).first, 12u);
+    EXPECT_FLOAT_EQ(batch.get_segments()[12].start[0], 10.0f);
+
+    const auto dirty = batch.take_dirty_ranges();
+    ASSERT_EQ(dirty.size(), 1u);
+    EXPECT_EQ(dirty[0].count, 15u);
+}
+
+} // namespace qcs::cad::test
@@ -0,0 +1,177 @@
+/**
+ * @file test_mesh_cache.cpp
+ * @brief Unit tests for indexed display meshes and the mesh cache
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Vertex welding, precision far from the origin, revisions and eviction
+ */
+
+#include <gtest/gtest.h>
+#include "../mesh_cache.hpp"
+#include <cmath>
+
+namespace qcs::cad::test {
+
+namespace {
+
+using Triangle = std::array<Point3D, 3>;
+
+// A w x h grid of unit squares, two triangles each, as a tessellator emits it
+std::vector<Triangle> grid(int w, int h, const Point3D& origin = Point3D::Zero()) {
+    std::vector<Triangle> triangles;
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            const Point3D a = origin + Point3D(x, y, 0), b = origin + Point3D(x + 1, y, 0);
+            const Point3D c = origin + Point3D(x + 1, y + 1, 0), d = origin + Point3D(x, y + 1, 0);
+            triangles.push_back({a, b, c});
+            triangles.push_back({a, c, d});
+        }
+    }
+    return triangles;
+}
+
+} // namespace
+
+// =============================================================================
+// IndexedMesh Tests
+// =============================================================================
+
+TEST(MeshCacheTest, WeldsSharedVertices) {
+    const auto triangles = grid(10, 10);
+    const IndexedMesh mesh = IndexedMesh::from_triangles(triangles, 7);
+
+    EXPECT_EQ(mesh.get_vertex_count(), 121u);
+    EXPECT_EQ(mesh.get_triangle_count(), 200u);
+    ASSERT_EQ(mesh.faces.size(), 1u);
+    EXPECT_EQ(mesh.faces[0].face_id, 7u);
+    EXPECT_EQ(mesh.faces[0].index_count, 600u);
+
+    // Normals included, well under half the soup's size
+    const size_t indexed_bytes = mesh.vertices.size() * sizeof(MeshVertex) + mesh.indices.size() * sizeof(uint32_t);
+    EXPECT_LT(indexed_bytes * 5, triangles.size() * sizeof(Triangle) * 2);
+
+    for (uint32_t i = 0; i < mesh.indices.size(); ++i) {
+        const Point3D& expected = triangles[i / 3][i % 3];
+        EXPECT_EQ(mesh.get_position(mesh.indices[i]), expected);
+    }
+    for (const MeshVertex& vertex : mesh.vertices) {
+        EXPECT_FLOAT_EQ(vertex.normal[2], 1.0f);
+    }
+}
+
+TEST(MeshCacheTest, DropsCollapsedTriangles) {
+    std::vector<Triangle> triangles = grid(1, 1);
+    triangles.push_back({Point3D(0, 0, 0), Point3D(-0.0, 0, 0), Point3D(1, 0, 0)});  // -0 welds with +0
+    const IndexedMesh mesh = IndexedMesh::from_triangles(triangles);
+    EXPECT_EQ(mesh.get_triangle_count(), 2u);
+    EXPECT_EQ(mesh.get_vertex_count(), 4u);
+
+    EXPECT_TRUE(IndexedMesh::from_triangles({}).empty());
+}
+
+TEST(MeshCacheTest, KeepsPrecisionFarFromOrigin) {
+    // Single precision world coordinates would be 0.25 apart out here
+    const Point3D far(4.0e6, -3.0e6, 2.0e6);
+    std::vector<Triangle> triangles{{far, far + Vector3D(1e-3, 0, 0), far + Vector3D(0, 1e-3, 0)}};
+    const IndexedMesh mesh = IndexedMesh::from_triangles(triangles);
+    for (uint32_t i = 0; i < 3; ++i) {
+        EXPECT_NEAR((mesh.get_position(mesh.indices[i]) - triangles[0][i]).norm(), 0.0, 1e-9);
+    }
+}
+
+TEST(MeshCacheTest, AppendRebasesFaces) {
+    IndexedMesh solid;
+    const IndexedMesh first = IndexedMesh::from_triangles(grid(2, 2), 1);
+    const IndexedMesh second = IndexedMesh::from_triangles(grid(3, 1, Point3D(100, 0, 5)), 2);
+    solid.append(first);
+    solid.append(second);
+
+    EXPECT_EQ(solid.get_vertex_count(), first.get_vertex_count() + second.get_vertex_count());
+    ASSERT_EQ(solid.faces.size(), 2u);
+    EXPECT_EQ(solid.faces[1].face_id, 2u);
+    EXPECT_EQ(solid.faces[1].first_index, first.indices.size());
+
+    for (uint32_t i = 0; i < second.indices.size(); ++i) {
+        const uint32_t vertex = solid.indices[solid.faces[1].first_index + i];
+        EXPECT_NEAR((solid.get_position(vertex) - second.get_position(second.indices[i])).norm(), 0.0, 1e-5);
+    }
+    EXPECT_EQ(solid.bounds.max.x(), 103.0);
+}
+
+// =============================================================================
+// MeshCache Tests
+// =============================================================================
+
+TEST(MeshCacheTest, FinerMeshesServeCoarserRequests) {
+    MeshCache cache;
+    int tessellations = 0;
+    auto tessellate = [&]() {
+        tessellations++;
+        return IndexedMesh::from_triangles(grid(4, 4));
+    };
+
+    const TessellationTolerance fine{1e-4, 0.1}, coarse{1e-2, 0.5};
+    auto mesh = cache.get_or_create({3, 0, fine}, tessellate);
+    EXPECT_EQ(cache.get_or_create({3, 0, coarse}, tessellate), mesh);
+    EXPECT_EQ(tessellations, 1);
+
+    // Of several that would do, the coarsest
+    auto medium = cache.insert({3, 0, {1e-3, 0.2}}, IndexedMesh::from_triangles(grid(2, 2)));
+    EXPECT_EQ(cache.find({3, 0, coarse}), medium);
+    EXPECT_EQ(cache.find({3, 0, fine}), mesh);
+    EXPECT_EQ(cache.find({3, 0, {1e-5, 0.1}}), nullptr);
+
+    const auto stats = cache.get_stats();
+    EXPECT_EQ(stats.hits, 3u);
+    EXPECT_EQ(stats.misses, 2u);
+
+    // Zoom-derived tolerances collapse onto powers of two
+    EXPECT_EQ(TessellationTolerance({0.0030, 0.3}).quantized(), TessellationTolerance({0.0023, 0.27}).quantized());
+    EXPECT_TRUE(TessellationTolerance({0.0030, 0.3}).quantized().satisfies({0.0030, 0.3}));
+}
+
+TEST(MeshCacheTest, NewRevisionsReplaceOldOnes) {
+    MeshCache cache;
+    const TessellationTolerance tolerance;
+    auto old_mesh = cache.insert({1, 4, tolerance}, IndexedMesh::from_triangles(grid(1, 1)));
+    cache.insert({2, 0, tolerance}, IndexedMesh::from_triangles(grid(1, 1)));
+    EXPECT_EQ(cache.size(), 2u);
+
+    auto new_mesh = cache.insert({1, 5, tolerance}, IndexedMesh::from_triangles(grid(2, 1)));
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.find({1, 4, tolerance}), nullptr);
+    EXPECT_EQ(cache.find({1, 5, tolerance}), new_mesh);
+
+    // A late tessellation of the old revision is handed back but not kept
+    auto late = cache.insert({1, 4, tolerance}, IndexedMesh::from_triangles(grid(1, 1)));
+    EXPECT_NE(late, nullptr);
+    EXPECT_EQ(cache.size(), 2u);
+
+    cache.invalidate(1);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_EQ(cache.find({1, 5, tolerance}), nullptr);
+    EXPECT_EQ(old_mesh->get_triangle_count(), 2u);  // Callers keep what they hold
+}
+
+TEST(MeshCacheTest, EvictsLeastRecentlyUsed) {
+    const size_t bytes = IndexedMesh::from_triangles(grid(8, 8)).memory_usage();
+    MeshCache cache(bytes * 4);
+    const TessellationTolerance tolerance;
+    for (size_t face = 0; face < 4; ++face) {
+        cache.insert({face, 0, tolerance}, IndexedMesh::from_triangles(grid(8, 8)));
+    }
+    EXPECT_EQ(cache.get_stats().evictions, 0u);
+
+    // Touch the oldest, then overflow: the next oldest go
+    ASSERT_NE(cache.find({0, 0, tolerance}), nullptr);
+    cache.insert({4, 0, tolerance}, IndexedMesh::from_triangles(grid(8, 8)));
+    EXPECT_LE(cache.memory_usage(), bytes * 3);
+    EXPECT_NE(cache.find({0, 0, tolerance}), nullptr);
+    EXPECT_EQ(cache.find({1, 0, tolerance}), nullptr);
+    EXPECT_NE(cache.find({4, 0, tolerance}), nullptr);
+    EXPECT_EQ(cache.get_stats().evictions, 2u);
+}
+
+} // namespace qcs::cad::test
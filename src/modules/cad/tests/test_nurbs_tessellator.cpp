@@ -0,0 +1,237 @@
+/**
+ * @file test_nurbs_tessellator.cpp
+ * @brief Unit tests for batched NURBS evaluation and tessellation
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Basis tables, exact conics, tolerance bounds and level-of-detail caching
+ */
+
+#include <gtest/gtest.h>
+#include "../nurbs_tessellator.hpp"
+#include "../precision_renderer.hpp"
+#include <cmath>
+
+namespace qcs::cad::test {
+
+namespace {
+
+const Precision HALF_SQRT2 = std::sqrt(0.5);
+
+// Full unit circle in the XY plane: nine rational quadratic control points
+NURBSCurve unit_circle() {
+    NURBSCurve circle(2);
+    circle.control_points = {Point3D(1, 0, 0),  Point3D(1, 1, 0),   Point3D(0, 1, 0),
+                             Point3D(-1, 1, 0), Point3D(-1, 0, 0),  Point3D(-1, -1, 0),
+                             Point3D(0, -1, 0), Point3D(1, -1, 0),  Point3D(1, 0, 0)};
+    circle.weights = {1, HALF_SQRT2, 1, HALF_SQRT2, 1, HALF_SQRT2, 1, HALF_SQRT2, 1};
+    circle.knot_vector = {0, 0, 0, 0.25, 0.25, 0.5, 0.5, 0.75, 0.75, 1, 1, 1};
+    return circle;
+}
+
+// Quarter of a unit cylinder about Z, of height 2
+NURBSSurface quarter_cylinder() {
+    NURBSSurface surface(2, 1);
+    surface.control_points = {{Point3D(1, 0, 0), Point3D(1, 0, 2)},
+                              {Point3D(1, 1, 0), Point3D(1, 1, 2)},
+                              {Point3D(0, 1, 0), Point3D(0, 1, 2)}};
+    surface.weights = {{1, 1}, {HALF_SQRT2, HALF_SQRT2}, {1, 1}};
+    surface.u_knots = {0, 0, 0, 1, 1, 1};
+    surface.v_knots = {0, 0, 1, 1};
+    return surface;
+}
+
+Precision radial_error(const Point3D& point) {
+    return std::abs(Vector2D(point.x(), point.y()).norm() - 1.0);
+}
+
+} // namespace
+
+// =============================================================================
+// Basis Function Tests
+// =============================================================================
+
+TEST(NURBSTessellatorTest, BasisPartitionsUnityWithMatchingDerivatives) {
+    const std::vector<Precision> knots{0, 0, 0, 0, 0.3, 0.5, 0.5, 1, 1, 1, 1};
+    std::vector<Precision> params;
+    for (int i = 0; i <= 100; ++i) {
+        params.push_back(i / 100.0);
+    }
+    const BasisTable table = evaluate_basis(knots, 3, 7, params, true);
+    ASSERT_EQ(table.size(), params.size());
+    EXPECT_EQ(table.spans.front(), 3u);
+    EXPECT_EQ(table.spans.back(), 6u);  // The end of the range belongs to the last span
+    EXPECT_EQ(table.spans[40], 4u);
+    EXPECT_EQ(table.spans[50], 6u);
+
+    for (size_t i = 0; i < params.size(); ++i) {
+        Precision sum = 0.0, derivative_sum = 0.0;
+        for (int k = 0; k <= 3; ++k) {
+            EXPECT_GE(table.get_values(i)[k], -1e-15);
+            sum += table.get_values(i)[k];
+            derivative_sum += table.get_derivatives(i)[k];
+        }
+        EXPECT_NEAR(sum, 1.0, 1e-12);
+        EXPECT_NEAR(derivative_sum, 0.0, 1e-9);
+    }
+
+    // Derivatives against central differences, away from knots
+    const std::vector<Precision> probe{0.2 - 1e-6, 0.2, 0.2 + 1e-6};
+    const BasisTable near = evaluate_basis(knots, 3, 7, probe, true);
+    for (int k = 0; k <= 3; ++k) {
+        const Precision difference = (near.get_values(2)[k] - near.get_values(0)[k]) / 2e-6;
+        EXPECT_NEAR(near.get_derivatives(1)[k], difference, 1e-5);
+    }
+
+    EXPECT_THROW(evaluate_basis(knots, 3, 8, params), std::invalid_argument);
+    const std::vector<Precision> unsorted{0, 0, 1, 0.5, 1, 1};
+    EXPECT_THROW(evaluate_basis(unsorted, 1, 4, params), std::invalid_argument);
+}
+
+// =============================================================================
+// Evaluation Tests
+// =============================================================================
+
+TEST(NURBSTessellatorTest, RationalCurvesAreExactConics) {
+    const NURBSCurve circle = unit_circle();
+    EXPECT_TRUE(circle.is_rational());
+
+    std::vector<Precision> params;
+    for (int i = 0; i <= 64; ++i) {
+        params.push_back(i / 64.0);
+    }
+    std::vector<Point3D> points;
+    std::vector<Vector3D> tangents;
+    evaluate_curve(circle, params, points, &tangents);
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_NEAR(radial_error(points[i]), 0.0, 1e-12);
+        EXPECT_NEAR(tangents[i].dot(points[i] - Point3D::Zero()), 0.0, 1e-9);  // Tangent to the circle
+    }
+    EXPECT_NEAR((circle.evaluate(0.25) - Point3D(0, 1, 0)).norm(), 0.0, 1e-12);
+    EXPECT_NEAR((circle.tangent(0.0) - Vector3D::UnitY()).norm(), 0.0, 1e-12);
+
+    // Mismatched knots fall back to clamped uniform ones
+    NURBSCurve line(3);
+    line.control_points = {Point3D(0, 0, 0), Point3D(2, 0, 0)};
+    EXPECT_EQ(get_parameter_range(line), (std::pair<Precision, Precision>(0.0, 1.0)));
+    EXPECT_NEAR(line.evaluate(0.25).x(), 0.5, 1e-12);
+}
+
+TEST(NURBSTessellatorTest, SurfaceGridHasExactPointsAndNormals) {
+    const NURBSSurface surface = quarter_cylinder();
+    const std::vector<Precision> u{0.0, 0.3, 0.5, 1.0}, v{0.0, 0.5, 1.0};
+    SurfaceGrid grid;
+    evaluate_surface_grid(surface, u, v, grid);
+    ASSERT_EQ(grid.points.size(), 12u);
+
+    for (size_t i = 0; i < u.size(); ++i) {
+        for (size_t j = 0; j < v.size(); ++j) {
+            const Point3D& point = grid.points[grid.index(i, j)];
+            const Vector3D& normal = grid.normals[grid.index(i, j)];
+            EXPECT_NEAR(radial_error(point), 0.0, 1e-12);
+            EXPECT_NEAR(point.z(), 2.0 * v[j], 1e-12);
+            EXPECT_NEAR((normal - Vector3D(point.x(), point.y(), 0)).norm(), 0.0, 1e-9);  // Outward
+        }
+    }
+    EXPECT_NEAR((surface.normal(0.0, 0.5) - Vector3D::UnitX()).norm(), 0.0, 1e-12);
+}
+
+// =============================================================================
+// Tessellation Tests
+// =============================================================================
+
+TEST(NURBSTessellatorTest, CurveTessellationMeetsTolerance) {
+    const NURBSCurve circle = unit_circle();
+    const auto coarse = tessellate_curve(circle, 1e-2);
+    const auto fine = tessellate_curve(circle, 1e-4);
+    EXPECT_LT(coarse.size(), fine.size());
+    EXPECT_LT(fine.size(), 400u);  // Roughly pi / sqrt(2 tolerance) chords are needed
+
+    for (const auto* polyline : {&coarse, &fine}) {
+        const Precision tolerance = polyline == &coarse ? 1e-2 : 1e-4;
+        EXPECT_NEAR(((*polyline).front() - (*polyline).back()).norm(), 0.0, 1e-12);
+        for (size_t i = 0; i + 1 < polyline->size(); ++i) {
+            const Point3D& a = (*polyline)[i];
+            const Point3D& b = (*polyline)[i + 1];
+            EXPECT_NEAR(radial_error(a), 0.0, 1e-12);
+            // A chord's sagitta on the unit circle
+            const Precision chord = (b - a).norm();
+            EXPECT_LE(1.0 - std::sqrt(1.0 - chord * chord / 4.0), tolerance);
+        }
+    }
+    EXPECT_THROW(tessellate_curve(circle, 0.0), std::invalid_argument);
+}
+
+TEST(NURBSTessellatorTest, SurfaceTessellationIsAGridWithinTolerance) {
+    const NURBSSurface surface = quarter_cylinder();
+    const IndexedMesh coarse = tessellate_surface(surface, 1e-2);
+    const IndexedMesh fine = tessellate_surface(surface, 1e-4);
+    EXPECT_LT(coarse.get_triangle_count(), fine.get_triangle_count());
+    ASSERT_EQ(fine.faces.size(), 1u);
+
+    // One row of cells along the straight direction
+    const size_t columns = fine.get_vertex_count() / 2;
+    EXPECT_EQ(fine.get_triangle_count(), 2 * (columns - 1));
+    for (uint32_t i = 0; i < fine.get_vertex_count(); ++i) {
+        EXPECT_NEAR(radial_error(fine.get_position(i)), 0.0, 1e-6);
+    }
+    for (size_t t = 0; t < fine.indices.size(); t += 3) {
+        const Point3D a = fine.get_position(fine.indices[t]);
+        const Point3D b = fine.get_position(fine.indices[t + 1]);
+        const Point3D c = fine.get_position(fine.indices[t + 2]);
+        const Point3D centroid = (a + b + c) / 3.0;
+        EXPECT_LE(radial_error(centroid), 1e-4);
+        EXPECT_GT((b - a).cross(c - a).dot(centroid - Point3D(0, 0, centroid.z())), 0.0);  // Faces outward
+    }
+}
+
+// =============================================================================
+// Level of Detail Tests
+// =============================================================================
+
+TEST(NURBSTessellatorTest, CacheServesTheCoarsestFineEnoughLevel) {
+    PolylineCache cache(100);
+    const uint64_t key = fingerprint(unit_circle());
+    EXPECT_EQ(cache.find(key, 1.0), nullptr);
+
+    cache.insert(key, 0.25, std::vector<Point3D>(10));
+    cache.insert(key, 0.0625, std::vector<Point3D>(40));
+    EXPECT_EQ(cache.find(key, 0.5)->size(), 10u);
+    EXPECT_EQ(cache.find(key, 0.1)->size(), 40u);
+    EXPECT_EQ(cache.find(key, 0.03), nullptr);
+    EXPECT_EQ(cache.get_point_count(), 50u);
+
+    // Edited geometry hashes differently
+    NURBSCurve moved = unit_circle();
+    moved.control_points[3].z() = 1e-9;
+    EXPECT_NE(fingerprint(moved), key);
+
+    // Over the budget, the least recently used level goes
+    cache.find(key, 0.5);
+    cache.insert(fingerprint(moved), 0.25, std::vector<Point3D>(60));
+    EXPECT_EQ(cache.find(key, 0.1), nullptr);
+    EXPECT_EQ(cache.find(key, 0.5)->size(), 10u);
+    EXPECT_EQ(cache.get_stats().evictions, 1u);
+}
+
+TEST(NURBSTessellatorTest, PixelSizeFollowsZoomNotOrbit) {
+    CADViewport viewport(200, 100);
+    viewport.look_at(Point3D(0, 0, 10), Point3D::Zero(), Vector3D::UnitY());
+    viewport.set_orthographic(true, 10.0);
+    viewport.set_clipping_planes(0.1, 100.0);
+    const BoundingBox3D bounds(Point3D(-1, -1, -1), Point3D(1, 1, 1));
+    EXPECT_DOUBLE_EQ(viewport.get_world_units_per_pixel(bounds), 0.1);
+
+    // In perspective, the nearest corner sets the pixel size, at any angle
+    viewport.set_orthographic(false);
+    viewport.set_field_of_view(constants::HALF_PI);
+    const Precision front = viewport.get_world_units_per_pixel(bounds);
+    EXPECT_NEAR(front, 2.0 * 9.0 / 100.0, 1e-12);
+    viewport.look_at(Point3D(10, 0, 0), Point3D::Zero(), Vector3D::UnitY());
+    EXPECT_NEAR(viewport.get_world_units_per_pixel(bounds), front, 1e-12);
+    viewport.look_at(Point3D(0, 0, 20), Point3D::Zero(), Vector3D::UnitY());
+    EXPECT_NEAR(viewport.get_world_units_per_pixel(bounds), 2.0 * front * 19.0 / 18.0, 1e-12);
+}
+
+} // namespace qcs::cad::test
@@ -0,0 +1,86 @@
+/**
+ * @file test_precision_renderer.cpp
+ * @brief Unit tests for the precision renderer
+ * @version 1.0.0
+ * @date 2025-09-03
+ *
+ * QuantumCanvas Studio - CAD Graphics Engine
+ * Technical linetypes and the pattern table the line shader reads
+ */
+
+#include <gtest/gtest.h>
+#include "../precision_renderer.hpp"
+
+namespace qcs::cad::test {
+
+// =============================================================================
+// Technical Linetype Tests
+// =============================================================================
+
+TEST(TechnicalLinetypeTest, DashesAndDotsAreDrawn) {
+    // Dash 5, gap 2.5
+    const TechnicalLinetype dashed = TechnicalLinetype::dashed();
+    EXPECT_FALSE(dashed.is_continuous());
+    EXPECT_DOUBLE_EQ(dashed.get_total_length(), 7.5);
+    EXPECT_TRUE(dashed.is_visible_at_parameter(1.0 / 7.5));
+    EXPECT_FALSE(dashed.is_visible_at_parameter(6.0 / 7.5));
+
+    // Line 6, gap 1, dot 0.5, gap 1, dot 0.5, gap 1
+    const TechnicalLinetype divide = TechnicalLinetype::divide();
+    EXPECT_TRUE(divide.is_visible_at_parameter(7.25 / 10.0));
+    EXPECT_FALSE(divide.is_visible_at_parameter(7.75 / 10.0));
+    EXPECT_TRUE(TechnicalLinetype::continuous().is_visible_at_parameter(0.3));
+}
+
+// =============================================================================
+// Linetype Pattern Table Tests
+// =============================================================================
+
+TEST(LinetypePatternTableTest, RowsHoldSignedElementLengths) {
+    LinetypePatternTable table;
+    EXPECT_EQ(table.get_row_count(), 1u);
+    EXPECT_EQ(table.get_row(TechnicalLinetype::continuous()), 0u);
+
+    const uint32_t center = table.get_row(TechnicalLinetype::center());
+    const uint32_t hidden = table.get_row(TechnicalLinetype::hidden());
+    EXPECT_EQ(center, 1u);
+    EXPECT_EQ(hidden, 2u);
+    EXPECT_EQ(table.get_row(TechnicalLinetype::center()), center);
+    EXPECT_EQ(table.get_texels().size(), 3u * LinetypePatternTable::PATTERN_TEXELS);
+
+    // Line 6, gap 1, line 1, gap 1
+    const float* row = table.get_texels().data() + center * LinetypePatternTable::PATTERN_TEXELS;
+    EXPECT_FLOAT_EQ(row[0], 9.0f);
+    EXPECT_FLOAT_EQ(row[1], 4.0f);
+    EXPECT_FLOAT_EQ(row[2], 6.0f);
+    EXPECT_FLOAT_EQ(row[3], -1.0f);
+    EXPECT_FLOAT_EQ(row[5], -1.0f);
+    EXPECT_FLOAT_EQ(row[6], 0.0f);
+    EXPECT_FLOAT_EQ(table.get_texels()[0], 0.0f);  // Continuous has no period
+}
+
+TEST(LinetypePatternTableTest, RedefinitionRewritesItsRow) {
+    LinetypePatternTable table;
+    TechnicalLinetype custom("Custom");
+    custom.add_element(LinePatternElement::Dash, 2.0);
+    custom.add_element(LinePatternElement::Gap, 1.0, 0.5);
+    custom.finalize_pattern();
+
+    const uint32_t row = table.get_row(custom);
+    EXPECT_TRUE(table.is_dirty());
+    table.clear_dirty();
+    EXPECT_EQ(table.get_row(custom), row);
+    EXPECT_FALSE(table.is_dirty());
+
+    custom.add_element(LinePatternElement::Dot, 0.25);
+    custom.finalize_pattern();
+    EXPECT_EQ(table.get_row(custom), row);
+    EXPECT_TRUE(table.is_dirty());
+    EXPECT_EQ(table.get_row_count(), 2u);
+    const float* texels = table.get_texels().data() + row * LinetypePatternTable::PATTERN_TEXELS;
+    EXPECT_FLOAT_EQ(texels[0], 2.75f);
+    EXPECT_FLOAT_EQ(texels[3], -0.5f);
+    EXPECT_FLOAT_EQ(texels[4], 0.25f);
+}
+
+} // namespace qcs::cad::test
@@ -0,0 +1,297 @@
+#include "asset_cache.hpp"
+#include <stdexcept>
+#include <vector>
+
+namespace QuantumCanvas::IO {
+
+// DecodedAssetCache::Pool
+template <typename T>
+std::shared_ptr<const T> DecodedAssetCache::Pool<T>::find(uint64_t key) {
+    auto it = slots.find(key);
+    if (it == slots.end()) {
+        return nullptr;
+    }
+    std::shared_ptr<const T> asset = it->second.live.lock();
+    if (!asset) {
+        slots.erase(it);  // Evicted earlier and since released everywhere
+        return nullptr;
+    }
+    keep(key, it->second, asset);
+    return asset;
+}
+
+template <typename T>
+void DecodedAssetCache::Pool<T>::insert(uint64_t key, std::shared_ptr<const T> asset, uint64_t bytes) {
+    Slot& slot = slots[key];
+    if (slot.kept) {
+        keptBytes -= slot.bytes;
+        lru.erase(slot.lru);
+        slot.kept.reset();
+    }
+    slot.live = asset;
+    slot.bytes = bytes;
+    keep(key, slot, std::move(asset));
+
+    // Evicted slots are otherwise only dropped when looked up again
+    if (slots.size() > 2 * lru.size() + 64) {
+        sweep();
+    }
+}
+
+template <typename T>
+uint64_t DecodedAssetCache::Pool<T>::evict(uint64_t budget, std::vector<std::shared_ptr<const T>>& dropped) {
+    uint64_t count = 0;
+    while (keptBytes > budget && !lru.empty()) {
+        const uint64_t key = lru.back();
+        lru.pop_back();
+        Slot& slot = slots[key];
+        keptBytes -= slot.bytes;
+        dropped.push_back(std::move(slot.kept));
+        ++count;
+    }
+    return count;
+}
+
+template <typename T>
+void DecodedAssetCache::Pool<T>::keep(uint64_t key, Slot& slot, std::shared_ptr<const T> asset) {
+    if (slot.kept) {
+        lru.splice(lru.begin(), lru, slot.lru);
+        return;
+    }
+    // In use again after an eviction: it counts against the budget once more
+    slot.kept = std::move(asset);
+    lru.push_front(key);
+    slot.lru = lru.begin();
+    keptBytes += slot.bytes;
+}
+
+template <typename T>
+void DecodedAssetCache::Pool<T>::sweep() {
+    for (auto it = slots.begin(); it != slots.end();) {
+        it = !it->second.kept && it->second.live.expired() ? slots.erase(it) : std::next(it);
+    }
+}
+
+// DecodedAssetCache
+DecodedAssetCache::DecodedAssetCache(Decoder decoder, Uploader uploader, Releaser releaser,
+                                     const Settings& settings)
+    : decoder_(std::move(decoder))
+    , uploader_(std::move(uploader))
+    , releaser_(std::make_shared<const Releaser>(std::move(releaser)))
+    , settings_(settings) {
+    if (!decoder_) {
+        throw std::invalid_argument("Asset cache needs a decoder");
+    }
+}
+
+DecodedAssetCache::ImageHandle DecodedAssetCache::image(const std::filesystem::path& filePath) {
+    if (const auto key = stampedKey(filePath)) {
+        if (ImageHandle cached = findImage(*key)) {
+            return cached;
+        }
+    }
+    std::shared_ptr<const ByteSource> source;
+    const uint64_t key = readKey(filePath, source);
+    return image(key, source);
+}
+
+DecodedAssetCache::ImageHandle DecodedAssetCache::image(const std::shared_ptr<const ByteSource>& source) {
+    if (!source) {
+        throw std::invalid_argument("Asset source is null");
+    }
+    return image(ContentHasher::hash(source->bytes()), source);
+}
+
+DecodedAssetCache::TextureHandle DecodedAssetCache::texture(const std::filesystem::path& filePath) {
+    if (const auto key = stampedKey(filePath)) {
+        if (TextureHandle cached = findTexture(*key)) {
+            return cached;
+        }
+        if (ImageHandle cached = findImage(*key)) {
+            return texture(*key, cached);
+        }
+    }
+    std::shared_ptr<const ByteSource> source;
+    const uint64_t key = readKey(filePath, source);
+    if (TextureHandle cached = findTexture(key)) {
+        return cached;
+    }
+    return texture(key, image(key, source));
+}
+
+DecodedAssetCache::TextureHandle DecodedAssetCache::texture(const std::shared_ptr<const ByteSource>& source) {
+    if (!source) {
+        throw std::invalid_argument("Asset source is null");
+    }
+    const uint64_t key = ContentHasher::hash(source->bytes());
+    if (TextureHandle cached = findTexture(key)) {
+        return cached;
+    }
+    return texture(key, image(key, source));
+}
+
+void DecodedAssetCache::setSettings(const Settings& settings) {
+    // Declared first, so what is let go is destroyed after the lock is released
+    std::vector<ImageHandle> droppedImages;
+    std::vector<TextureHandle> droppedTextures;
+    std::lock_guard<std::mutex> lock(mutex_);
+    settings_ = settings;
+    stats_.evictions += images_.evict(settings_.ramBudget, droppedImages);
+    stats_.evictions += textures_.evict(settings_.vramBudget, droppedTextures);
+}
+
+DecodedAssetCache::Settings DecodedAssetCache::getSettings() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return settings_;
+}
+
+void DecodedAssetCache::clear() {
+    std::vector<ImageHandle> droppedImages;
+    std::vector<TextureHandle> droppedTextures;
+    std::lock_guard<std::mutex> lock(mutex_);
+    images_.evict(0, droppedImages);
+    textures_.evict(0, droppedTextures);
+    images_.sweep();
+    textures_.sweep();
+    paths_.clear();
+}
+
+DecodedAssetCache::Stats DecodedAssetCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.imageBytes = images_.keptBytes;
+    stats.textureBytes = textures_.keptBytes;
+    stats.imageCount = images_.lru.size();
+    stats.textureCount = textures_.lru.size();
+    return stats;
+}
+
+std::optional<uint64_t> DecodedAssetCache::stampedKey(const std::filesystem::path& filePath) {
+    std::error_code error;
+    const auto modified = std::filesystem::last_write_time(filePath, error);
+    if (error) {
+        return std::nullopt;
+    }
+    const auto size = std::filesystem::file_size(filePath, error);
+    if (error) {
+        return std::nullopt;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = paths_.find(filePath.string());
+    if (it == paths_.end() || it->second.modified != modified || it->second.size != size) {
+        return std::nullopt;
+    }
+    return it->second.key;
+}
+
+uint64_t DecodedAssetCache::readKey(const std::filesystem::path& filePath,
+                                    std::shared_ptr<const ByteSource>& source) {
+    // Stamped before reading, so a write racing the read leaves a stale stamp, not a wrong key
+    std::error_code error;
+    const auto modified = std::filesystem::last_write_time(filePath, error);
+
+    source = std::make_shared<const ByteSource>(ByteSource::open(filePath, ByteSource::Access::Sequential));
+    const uint64_t key = ContentHasher::hash(source->bytes());
+
+    if (!error) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        paths_[filePath.string()] = {modified, source->size(), key};
+    }
+    return key;
+}
+
+DecodedAssetCache::ImageHandle DecodedAssetCache::image(uint64_t key,
+                                                        const std::shared_ptr<const ByteSource>& source) {
+    std::promise<ImageHandle> promise;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (ImageHandle cached = images_.find(key)) {
+            stats_.imageHits++;
+            return cached;
+        }
+        // Another thread is decoding the same content
+        auto pending = decoding_.find(key);
+        if (pending != decoding_.end()) {
+            std::shared_future<ImageHandle> decoded = pending->second;
+            stats_.imageHits++;
+            lock.unlock();
+            return decoded.get();
+        }
+        decoding_.emplace(key, promise.get_future().share());
+        stats_.imageMisses++;
+    }
+
+    ImageHandle decoded;
+    try {
+        decoded = decoder_(source);
+        if (!decoded) {
+            throw std::runtime_error("Cannot decode image asset");
+        }
+    }
+    catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            decoding_.erase(key);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    std::vector<ImageHandle> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        images_.insert(key, decoded, decoded->memoryUsage());
+        stats_.evictions += images_.evict(settings_.ramBudget, dropped);
+        decoding_.erase(key);
+    }
+    promise.set_value(decoded);
+    return decoded;
+}
+
+DecodedAssetCache::ImageHandle DecodedAssetCache::findImage(uint64_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ImageHandle cached = images_.find(key);
+    if (cached) {
+        stats_.imageHits++;
+    }
+    return cached;
+}
+
+DecodedAssetCache::TextureHandle DecodedAssetCache::texture(uint64_t key, const ImageHandle& image) {
+    // Uploaded outside the lock; a racing upload of the same content loses below
+    const Upload upload = uploader_ ? uploader_(*image) : Upload();
+    if (upload.id == 0) {
+        throw std::runtime_error("Cannot upload texture asset");
+    }
+    TextureHandle uploaded(new Rendering::ResourceId(upload.id),
+                           [releaser = releaser_](const Rendering::ResourceId* id) {
+                               if (*releaser) {
+                                   (*releaser)(*id);
+                               }
+                               delete id;
+                           });
+
+    std::vector<TextureHandle> dropped;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (TextureHandle existing = textures_.find(key)) {
+        dropped.push_back(std::move(uploaded));
+        stats_.textureHits++;
+        return existing;
+    }
+    textures_.insert(key, uploaded, upload.bytes);
+    stats_.textureMisses++;
+    stats_.evictions += textures_.evict(settings_.vramBudget, dropped);
+    return uploaded;
+}
+
+DecodedAssetCache::TextureHandle DecodedAssetCache::findTexture(uint64_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TextureHandle cached = textures_.find(key);
+    if (cached) {
+        stats_.textureHits++;
+    }
+    return cached;
+}
+
+} // namespace QuantumCanvas::IO
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "byte_source.hpp"
+#include "../raster/raster_image.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace QuantumCanvas::Rendering {
+using ResourceId = uint64_t;
+}
+
+namespace QuantumCanvas::IO {
+
+// Decoded images and their GPU textures, shared by every module and document
+// that uses the same file contents
+//
+// Assets are keyed by a hash of every byte of the encoded file, so a brush
+// texture, a pattern fill and a placed image read from the same file, or
+// from copies of it, decode once and upload once. Handles are shared_ptrs
+// to immutable data: images are handed out const, and a texture handle
+// destroys its ResourceId when the last holder drops it. The cache keeps
+// the most recently used assets alive within a RAM budget for images and a
+// VRAM budget for textures; an asset still held elsewhere stays shared when
+// the cache lets go of it, and one larger than its whole budget is handed
+// out but not kept. Thread-safe; concurrent requests for the same content
+// wait on a single decode.
+class DecodedAssetCache final {
+public:
+    using ImageHandle = std::shared_ptr<const Raster::Image>;
+    using TextureHandle = std::shared_ptr<const Rendering::ResourceId>;
+
+    struct Settings {
+        uint64_t ramBudget = 512ull * 1024 * 1024;   // Bytes of allocated image tiles
+        uint64_t vramBudget = 256ull * 1024 * 1024;  // Bytes of texture storage
+    };
+
+    struct Upload {
+        Rendering::ResourceId id = 0;  // 0 = failed
+        uint64_t bytes = 0;
+    };
+
+    // Supplied by the owner, which knows the format handlers and the device.
+    // The decoder returns null or throws for content it cannot read; the
+    // releaser must stay callable for as long as any texture handle lives.
+    using Decoder = std::function<std::shared_ptr<Raster::Image>(const std::shared_ptr<const ByteSource>& source)>;
+    using Uploader = std::function<Upload(const Raster::Image& image)>;
+    using Releaser = std::function<void(Rendering::ResourceId id)>;
+
+    struct Stats {
+        uint64_t imageHits = 0;
+        uint64_t imageMisses = 0;    // Decodes
+        uint64_t textureHits = 0;
+        uint64_t textureMisses = 0;  // Uploads
+        uint64_t evictions = 0;
+        uint64_t imageBytes = 0;     // Kept by the cache
+        uint64_t textureBytes = 0;
+        size_t imageCount = 0;
+        size_t textureCount = 0;
+    };
+
+    DecodedAssetCache(Decoder decoder, Uploader uploader, Releaser releaser)
+        : DecodedAssetCache(std::move(decoder), std::move(uploader), std::move(releaser), Settings()) {}
+    DecodedAssetCache(Decoder decoder, Uploader uploader, Releaser releaser, const Settings& settings);
+
+    // Disable copy and move
+    DecodedAssetCache(const DecodedAssetCache&) = delete;
+    DecodedAssetCache& operator=(const DecodedAssetCache&) = delete;
+
+    // Throw std::runtime_error if the file cannot be read or decoded. Paths
+    // remember the hash of the contents they had, so asking again for an
+    // unchanged file costs a stat.
+    ImageHandle image(const std::filesystem::path& filePath);
+    ImageHandle image(const std::shared_ptr<const ByteSource>& source);  // Bytes embedded in a document
+    TextureHandle texture(const std::filesystem::path& filePath);
+    TextureHandle texture(const std::shared_ptr<const ByteSource>& source);
+
+    void setSettings(const Settings& settings);  // Evicts down to the new budgets
+    Settings getSettings() const;
+    void clear();  // Lets go of everything; handles held elsewhere stay valid
+    Stats getStats() const;
+
+private:
+    // Assets by content hash: weak references keep everything still in use
+    // shareable, strong ones keep the most recently used within budget
+    template <typename T>
+    struct Pool {
+        struct Slot {
+            std::weak_ptr<const T> live;
+            std::shared_ptr<const T> kept;  // Null once evicted
+            uint64_t bytes = 0;
+            std::list<uint64_t>::iterator lru;
+        };
+
+        std::unordered_map<uint64_t, Slot> slots;
+        std::list<uint64_t> lru;  // Kept slots, most recent first
+        uint64_t keptBytes = 0;
+
+        std::shared_ptr<const T> find(uint64_t key);
+        void insert(uint64_t key, std::shared_ptr<const T> asset, uint64_t bytes);
+        // Moves kept assets out, least recent first, until within budget; returns how many
+        uint64_t evict(uint64_t budget, std::vector<std::shared_ptr<const T>>& dropped);
+        void keep(uint64_t key, Slot& slot, std::shared_ptr<const T> asset);
+        void sweep();
+    };
+
+    struct PathStamp {
+        std::filesystem::file_time_type modified;
+        uint64_t size = 0;
+        uint64_t key = 0;
+    };
+
+    Decoder decoder_;
+    Uploader uploader_;
+    std::shared_ptr<const Releaser> releaser_;  // Shared with the texture handles
+    Settings settings_;
+
+    mutable std::mutex mutex_;
+    Pool<Raster::Image> images_;
+    Pool<Rendering::ResourceId> textures_;
+    std::unordered_map<uint64_t, std::shared_future<ImageHandle>> decoding_;
+    std::unordered_map<std::string, PathStamp> paths_;
+    Stats stats_;
+
+    // Key remembered for the path, if the file is unchanged since
+    std::optional<uint64_t> stampedKey(const std::filesystem::path& filePath);
+    // Reads and hashes the file, remembering the key for the path
+    uint64_t readKey(const std::filesystem::path& filePath, std::shared_ptr<const ByteSource>& source);
+    ImageHandle image(uint64_t key, const std::shared_ptr<const ByteSource>& source);
+    ImageHandle findImage(uint64_t key);
+    TextureHandle texture(uint64_t key, const ImageHandle& image);
+    TextureHandle findTexture(uint64_t key);
+};
+
+} // namespace QuantumCanvas::IO
@@ -0,0 +1,312 @@
+#include "batch_engine.hpp"
+#include "../../core/kernel/task_scheduler.hpp"
+#include "../../core/kernel/telemetry.hpp"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace QuantumCanvas::IO {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::chrono::microseconds since(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+}
+
+// Reads the mapping through once, so the process step finds it resident
+void faultIn(const ByteSource& source) {
+    constexpr size_t PAGE_SIZE = 4096;
+    source.prefetch(0, source.size());
+    volatile uint8_t sink = 0;
+    for (size_t offset = 0; offset < source.size(); offset += PAGE_SIZE) {
+        sink = sink + source.data()[offset];
+    }
+}
+
+// Largest cost on top, then the earliest submitted
+bool lowerPriority(const auto& a, const auto& b) {
+    return a.cost != b.cost ? a.cost < b.cost : a.sequence > b.sequence;
+}
+
+} // namespace
+
+// BatchStats
+double BatchStats::megabytesPerSecond() const {
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0.0 ? double(bytesRead + bytesWritten) / (1024.0 * 1024.0) / seconds : 0.0;
+}
+
+double BatchStats::filesPerSecond() const {
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0.0 ? double(filesCompleted + filesFailed) / seconds : 0.0;
+}
+
+// BatchEngine::Batch
+BatchEngine::Batch::Batch(size_t jobCount)
+    : remaining_(jobCount), started_(Clock::now()) {
+}
+
+BatchStats BatchEngine::Batch::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // A scheduler worker that blocked here could starve the process steps
+    // queued behind it, so it runs them while it waits
+    while (remaining_ > 0 && scheduler_ && scheduler_->is_worker_thread()) {
+        lock.unlock();
+        if (!scheduler_->try_run_pending_task()) {
+            std::this_thread::yield();
+        }
+        lock.lock();
+    }
+    done_.wait(lock, [this] { return remaining_ == 0; });
+    return stats_;
+}
+
+bool BatchEngine::Batch::isDone() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return remaining_ == 0;
+}
+
+BatchStats BatchEngine::Batch::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    BatchStats stats = stats_;
+    if (remaining_ > 0) {
+        stats.elapsed = since(started_);
+    }
+    return stats;
+}
+
+void BatchEngine::Batch::finish(bool failed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    (failed ? stats_.filesFailed : stats_.filesCompleted)++;
+    if (--remaining_ == 0) {
+        stats_.elapsed = since(started_);
+        done_.notify_all();
+    }
+}
+
+// BatchEngine
+BatchEngine::BatchEngine(std::shared_ptr<Core::TaskScheduler> scheduler, const Settings& settings)
+    : settings_(settings), scheduler_(std::move(scheduler)) {
+    settings_.ioThreads = std::max<uint32_t>(settings_.ioThreads, 1);
+    for (uint32_t i = 0; i < settings_.ioThreads; ++i) {
+        ioThreads_.emplace_back([this] { ioLoop(); });
+    }
+}
+
+BatchEngine::~BatchEngine() {
+    std::vector<Task> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        cancelled.swap(pending_);
+    }
+    wake_.notify_all();
+
+    for (Task& task : cancelled) {
+        finish(task, std::make_exception_ptr(std::runtime_error("Batch engine shut down")));
+    }
+    for (std::thread& thread : ioThreads_) {
+        thread.join();
+    }
+}
+
+std::shared_ptr<BatchEngine::Batch> BatchEngine::submit(std::vector<Job> jobs) {
+    std::shared_ptr<Batch> batch(new Batch(jobs.size()));
+    batch->scheduler_ = scheduler_;
+    if (jobs.empty()) {
+        return batch;
+    }
+
+    // Sizes come from the directory entry; files that cannot be stat'ed fail when read
+    std::vector<Task> tasks(jobs.size());
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        Task& task = tasks[i];
+        task.cost = jobs[i].cost;
+        if (task.cost == 0 && !jobs[i].inputPath.empty()) {
+            std::error_code error;
+            const auto size = std::filesystem::file_size(jobs[i].inputPath, error);
+            task.cost = error ? 0 : size;
+        }
+        task.job = std::move(jobs[i]);
+        task.batch = batch;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            throw std::runtime_error("Batch engine is shutting down");
+        }
+        for (Task& task : tasks) {
+            task.sequence = nextSequence_++;
+            pending_.push_back(std::move(task));
+            std::push_heap(pending_.begin(), pending_.end(), lowerPriority<Task, Task>);
+        }
+    }
+    wake_.notify_all();
+    return batch;
+}
+
+bool BatchEngine::canStartRead() const {
+    if (stopping_ || pending_.empty()) {
+        return false;
+    }
+    return bytesInFlight_ == 0 || bytesInFlight_ + pending_.front().cost <= settings_.memoryBudget;
+}
+
+void BatchEngine::ioLoop() {
+    for (;;) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [this] {
+            return !writes_.empty() || canStartRead() || (stopping_ && processing_ == 0);
+        });
+
+        // Writes first: they free memory for the next reads
+        if (!writes_.empty()) {
+            Task task = std::move(writes_.front());
+            writes_.pop_front();
+            lock.unlock();
+            write(task);
+            continue;
+        }
+        if (canStartRead()) {
+            std::pop_heap(pending_.begin(), pending_.end(), lowerPriority<Task, Task>);
+            Task task = std::move(pending_.back());
+            pending_.pop_back();
+            bytesInFlight_ += task.cost;
+            recordInFlight(*task.batch);
+            lock.unlock();
+            read(std::move(task));
+            continue;
+        }
+        return;  // Stopping, with nothing left to write
+    }
+}
+
+void BatchEngine::read(Task task) {
+    if (!task.job.inputPath.empty()) {
+        const auto started = Clock::now();
+        try {
+            auto source = std::make_shared<const ByteSource>(
+                ByteSource::open(task.job.inputPath, ByteSource::Access::Sequential));
+            faultIn(*source);
+            task.input = std::move(source);
+        }
+        catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                bytesInFlight_ -= task.cost;
+            }
+            wake_.notify_all();
+            finish(task, std::current_exception());
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(task.batch->mutex_);
+        task.batch->stats_.bytesRead += task.input->size();
+        task.batch->stats_.readTime += since(started);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++processing_;
+    }
+    if (scheduler_) {
+        scheduler_->submit([this, task = std::move(task)]() mutable { process(task); });
+    }
+    else {
+        process(task);
+    }
+}
+
+void BatchEngine::process(Task& task) {
+    QCS_TRACE_SCOPE("io.batch_job");
+    const auto started = Clock::now();
+    std::exception_ptr error;
+    try {
+        if (task.job.process) {
+            task.output = task.job.process(task.input);
+        }
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+    task.input.reset();
+    {
+        std::lock_guard<std::mutex> lock(task.batch->mutex_);
+        task.batch->stats_.processTime += since(started);
+    }
+
+    const bool writeOutput = !error && !task.job.outputPath.empty();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --processing_;
+        bytesInFlight_ -= task.cost;
+        if (writeOutput) {
+            // The output is held until written, in place of the input
+            task.cost = task.output.size();
+            bytesInFlight_ += task.cost;
+            recordInFlight(*task.batch);
+            writes_.push_back(std::move(task));
+        }
+    }
+    wake_.notify_all();
+
+    if (!writeOutput) {
+        finish(task, error);
+    }
+}
+
+void BatchEngine::write(Task& task) {
+    const auto started = Clock::now();
+    std::exception_ptr error;
+    try {
+        std::ofstream file(task.job.outputPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("Cannot open file for writing: " + task.job.outputPath.string());
+        }
+        file.write(reinterpret_cast<const char*>(task.output.data()), std::streamsize(task.output.size()));
+        if (!file) {
+            throw std::runtime_error("Failed to write file: " + task.job.outputPath.string());
+        }
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+    {
+        std::lock_guard<std::mutex> lock(task.batch->mutex_);
+        if (!error) {
+            task.batch->stats_.bytesWritten += task.output.size();
+        }
+        task.batch->stats_.writeTime += since(started);
+    }
+
+    task.output = {};
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bytesInFlight_ -= task.cost;
+    }
+    wake_.notify_all();
+    finish(task, error);
+}
+
+void BatchEngine::finish(Task& task, std::exception_ptr error) {
+    if (task.job.onDone) {
+        try {
+            task.job.onDone(error);
+        }
+        catch (...) {
+            // A failing callback must not take the I/O thread down
+        }
+    }
+    task.batch->finish(error != nullptr);
+}
+
+// Called with mutex_ held
+void BatchEngine::recordInFlight(Batch& batch) {
+    std::lock_guard<std::mutex> lock(batch.mutex_);
+    batch.stats_.peakBytesInFlight = std::max(batch.stats_.peakBytesInFlight, bytesInFlight_);
+}
+
+} // namespace QuantumCanvas::IO
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "byte_source.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace QuantumCanvas::Core {
+class TaskScheduler;
+}
+
+namespace QuantumCanvas::IO {
+
+struct BatchStats {
+    size_t filesCompleted = 0;
+    size_t filesFailed = 0;
+    uint64_t bytesRead = 0;
+    uint64_t bytesWritten = 0;
+    uint64_t peakBytesInFlight = 0;
+    std::chrono::microseconds readTime{0};     // Summed over the I/O threads
+    std::chrono::microseconds processTime{0};  // Summed over the CPU pool
+    std::chrono::microseconds writeTime{0};
+    std::chrono::microseconds elapsed{0};      // From submission to the last job finishing
+
+    // Bytes read and written, and files finished, per second of elapsed time
+    double megabytesPerSecond() const;
+    double filesPerSecond() const;
+};
+
+// Batches of file jobs, with disk and CPU work kept on separate threads
+//
+// A job's input is mapped and faulted in on one of the engine's I/O threads,
+// with read-ahead; its process step then runs on the task scheduler on pages
+// already in memory, and the bytes it returns are written on an I/O thread
+// again. Disk waits never hold a CPU worker and decodes never wait on the
+// disk. Queued jobs start largest first, which shortens the batch's tail,
+// and a memory budget bounds the bytes read or produced but not yet
+// consumed, so a batch of large files holds only a few at once. A job
+// larger than the whole budget still runs, alone.
+class BatchEngine final {
+public:
+    struct Settings {
+        uint32_t ioThreads = 2;
+        uint64_t memoryBudget = 512ull * 1024 * 1024;
+    };
+
+    struct Job {
+        std::filesystem::path inputPath;   // Empty = nothing to read
+        std::filesystem::path outputPath;  // Where process's bytes go; empty = nowhere
+        uint64_t cost = 0;                 // Bytes held while in flight; 0 = the input's size
+
+        // Runs on the CPU pool with the mapped input, null without one
+        std::function<std::vector<uint8_t>(const std::shared_ptr<const ByteSource>& input)> process;
+        // Runs once the job is over, with the exception that ended it, if any
+        std::function<void(std::exception_ptr error)> onDone;
+    };
+
+    // Jobs submitted together
+    class Batch final {
+    public:
+        BatchStats wait();  // Until every job has finished
+        bool isDone() const;
+        BatchStats getStats() const;  // So far
+
+    private:
+        friend class BatchEngine;
+
+        explicit Batch(size_t jobCount);
+
+        mutable std::mutex mutex_;
+        std::condition_variable done_;
+        size_t remaining_;
+        BatchStats stats_;
+        std::chrono::steady_clock::time_point started_;
+        std::shared_ptr<Core::TaskScheduler> scheduler_;  // Helped by waits on its workers
+
+        void finish(bool failed);
+    };
+
+    // Null scheduler runs process steps on the I/O threads
+    explicit BatchEngine(std::shared_ptr<Core::TaskScheduler> scheduler = nullptr)
+        : BatchEngine(std::move(scheduler), Settings()) {}
+    BatchEngine(std::shared_ptr<Core::TaskScheduler> scheduler, const Settings& settings);
+    ~BatchEngine();  // Fails jobs not yet started and waits for the rest
+
+    BatchEngine(const BatchEngine&) = delete;
+    BatchEngine& operator=(const BatchEngine&) = delete;
+
+    // Returns at once; jobs queue behind any earlier batch's that are larger
+    std::shared_ptr<Batch> submit(std::vector<Job> jobs);
+    BatchStats run(std::vector<Job> jobs) { return submit(std::move(jobs))->wait(); }
+
+    const Settings& getSettings() const { return settings_; }
+
+private:
+    struct Task {
+        Job job;
+        std::shared_ptr<Batch> batch;
+        uint64_t cost = 0;
+        uint64_t sequence = 0;  // Submission order, among equal costs
+        std::shared_ptr<const ByteSource> input;
+        std::vector<uint8_t> output;
+    };
+
+    Settings settings_;
+    std::shared_ptr<Core::TaskScheduler> scheduler_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<Task> pending_;  // Heap, largest cost on top
+    std::deque<Task> writes_;
+    uint64_t bytesInFlight_ = 0;
+    uint64_t nextSequence_ = 0;
+    size_t processing_ = 0;  // Jobs on the CPU pool
+    bool stopping_ = false;
+    std::vector<std::thread> ioThreads_;
+
+    void ioLoop();
+    bool canStartRead() const;
+    void read(Task task);
+    void process(Task& task);
+    void write(Task& task);
+    void finish(Task& task, std::exception_ptr error);
+    void recordInFlight(Batch& batch);
+};
+
+} // namespace QuantumCanvas::IO
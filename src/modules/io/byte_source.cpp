@@ -0,0 +1,130 @@
+#include "byte_source.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace QuantumCanvas::IO {
+
+namespace {
+
+// Fallback for files that cannot be mapped
+std::vector<uint8_t> readWholeFile(const std::filesystem::path& filePath) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open file: " + filePath.string());
+    }
+
+    std::vector<uint8_t> buffer;
+    char chunk[64 * 1024];
+    while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0) {
+        buffer.insert(buffer.end(), chunk, chunk + file.gcount());
+    }
+    if (file.bad()) {
+        throw std::runtime_error("Error reading file: " + filePath.string());
+    }
+    return buffer;
+}
+
+} // namespace
+
+ByteSource::~ByteSource() {
+    release();
+}
+
+ByteSource::ByteSource(ByteSource&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+    , mapped_(std::move(other.mapped_))
+    , buffer_(std::move(other.buffer_)) {
+    // Moving the mapping or the vector keeps their storage, so data_ still points into it
+}
+
+ByteSource& ByteSource::operator=(ByteSource&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapped_ = std::move(other.mapped_);
+        buffer_ = std::move(other.buffer_);
+    }
+    return *this;
+}
+
+ByteSource ByteSource::fromBuffer(std::vector<uint8_t> buffer) {
+    ByteSource source;
+    source.buffer_ = std::move(buffer);
+    source.data_ = source.buffer_.data();
+    source.size_ = source.buffer_.size();
+    return source;
+}
+
+ByteSource ByteSource::open(const std::filesystem::path& filePath, Access access) {
+    // Pipes and other special files are never mapped, and opening one to
+    // find that out could block, so only regular files are tried
+    std::error_code error;
+    ByteSource source;
+    if (std::filesystem::is_regular_file(filePath, error) && source.mapped_.open(filePath, access)) {
+        source.data_ = source.mapped_.data();
+        source.size_ = source.mapped_.size();
+        return source;
+    }
+
+    // Missing files throw here; empty files read as an empty buffer
+    return fromBuffer(readWholeFile(filePath));
+}
+
+void ByteSource::prefetch(size_t offset, size_t length) const {
+    mapped_.prefetch(offset, length);
+}
+
+void ByteSource::release() {
+    mapped_.close();
+    data_ = nullptr;
+    size_ = 0;
+    buffer_.clear();
+}
+
+ByteSpan ByteSource::subspan(size_t offset, size_t length) const {
+    if (offset >= size_) {
+        return {};
+    }
+    return {data_ + offset, std::min(length, size_ - offset)};
+}
+
+// ContentHasher
+void ContentHasher::update(ByteSpan data) {
+    size_t i = 0;
+    for (; i + 32 <= data.size(); i += 32) {
+        for (size_t lane = 0; lane < 4; ++lane) {
+            uint64_t word;
+            std::memcpy(&word, data.data() + i + lane * 8, 8);
+            lanes_[lane] = (lanes_[lane] ^ word) * FNV_PRIME;
+        }
+    }
+    // The tail is folded in byte by byte
+    for (; i < data.size(); ++i) {
+        lanes_[0] = (lanes_[0] ^ data[i]) * FNV_PRIME;
+    }
+}
+
+uint64_t ContentHasher::finish(uint64_t size) const {
+    uint64_t hash = size * FNV_PRIME;
+    for (uint64_t lane : lanes_) {
+        hash = (hash ^ lane) * FNV_PRIME;
+        hash ^= hash >> 29;
+    }
+    // SplitMix64 finalizer, so every input bit reaches every output bit
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+    return hash ^ (hash >> 31);
+}
+
+uint64_t ContentHasher::hash(ByteSpan data) {
+    ContentHasher hasher;
+    hasher.update(data);
+    return hasher.finish(data.size());
+}
+
+} // namespace QuantumCanvas::IO
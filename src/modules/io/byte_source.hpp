@@ -0,0 +1,81 @@
+#pragma once
+
+#include "../../core/memory/memory_manager.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace QuantumCanvas::IO {
+
+// Read-only bytes handed to format handlers and codecs
+using ByteSpan = std::span<const uint8_t>;
+
+// Owner of a file's bytes, memory-mapped where the platform allows
+//
+// Mapping copies nothing and reads nothing up front: pages are faulted in as
+// a parser touches them, so sniffing magic bytes or reading a header costs a
+// few pages however large the file is. Handlers and codecs are given a
+// ByteSpan of bytes() and must not keep it past the source's lifetime; async
+// loads share the source itself to keep the mapping alive. Files the OS
+// cannot map, such as pipes, are read into an owned buffer instead, so
+// callers never need a second code path.
+class ByteSource final {
+public:
+    // How the caller will walk the bytes, passed on as a read-ahead hint
+    using Access = Core::MappedFile::Access;
+
+    ByteSource() = default;
+    ~ByteSource();
+
+    // Disable copy, enable move
+    ByteSource(const ByteSource&) = delete;
+    ByteSource& operator=(const ByteSource&) = delete;
+    ByteSource(ByteSource&& other) noexcept;
+    ByteSource& operator=(ByteSource&& other) noexcept;
+
+    // Throws std::runtime_error if the file cannot be opened or read
+    static ByteSource open(const std::filesystem::path& filePath, Access access = Access::Normal);
+    static ByteSource fromBuffer(std::vector<uint8_t> buffer);
+
+    ByteSpan bytes() const { return {data_, size_}; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    bool isMapped() const { return mapped_.is_open(); }
+
+    // Bytes [offset, offset + length), clamped to the end of the source
+    ByteSpan subspan(size_t offset, size_t length = SIZE_MAX) const;
+
+    // Asks the OS to start reading a range in ahead of use; no-op when unmapped
+    void prefetch(size_t offset, size_t length) const;
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    Core::MappedFile mapped_;       // The file, if mapped
+    std::vector<uint8_t> buffer_;   // Owned bytes otherwise
+
+    void release();
+};
+
+// Incremental 64-bit hash of file contents, for cache keys
+//
+// FNV-1a over 64-bit words in four independent lanes, which keeps the
+// multiplies out of each other's way, with a SplitMix64 finalizer. Not
+// cryptographic: keys identify content, they do not authenticate it.
+class ContentHasher final {
+public:
+    void update(ByteSpan data);
+    uint64_t finish(uint64_t size) const;  // size: total bytes hashed, or a stand-in for them
+
+    static uint64_t hash(ByteSpan data);   // Every byte
+
+private:
+    static constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+    static constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+    uint64_t lanes_[4] = {FNV_OFFSET, FNV_OFFSET ^ 1, FNV_OFFSET ^ 2, FNV_OFFSET ^ 3};
+};
+
+} // namespace QuantumCanvas::IO
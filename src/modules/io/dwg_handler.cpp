@@ -0,0 +1,43 @@
+#include "dwg_handler.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace QuantumCanvas::IO {
+
+namespace DWGUtils {
+
+std::vector<std::array<float, 16>> getInsertTransforms(const DWGInsert& insert, const DWGBlock& block) {
+    const double c = std::cos(static_cast<double>(insert.rotation));
+    const double s = std::sin(static_cast<double>(insert.rotation));
+    const double sx = insert.scale[0];
+    const double sy = insert.scale[1];
+
+    const uint32_t rows = std::max<uint32_t>(insert.rowCount, 1);
+    const uint32_t columns = std::max<uint32_t>(insert.columnCount, 1);
+    std::vector<std::array<float, 16>> transforms;
+    transforms.reserve(static_cast<size_t>(rows) * columns);
+
+    for (uint32_t row = 0; row < rows; ++row) {
+        for (uint32_t column = 0; column < columns; ++column) {
+            // position + R * (cell offset + S * (p - basePoint)); array spacing is unscaled
+            const double localX = column * static_cast<double>(insert.columnSpacing) - sx * block.basePoint[0];
+            const double localY = row * static_cast<double>(insert.rowSpacing) - sy * block.basePoint[1];
+
+            std::array<float, 16> m{};
+            m[0] = static_cast<float>(c * sx);
+            m[1] = static_cast<float>(s * sx);
+            m[4] = static_cast<float>(-s * sy);
+            m[5] = static_cast<float>(c * sy);
+            m[10] = 1.0f;
+            m[12] = static_cast<float>(insert.position[0] + c * localX - s * localY);
+            m[13] = static_cast<float>(insert.position[1] + s * localX + c * localY);
+            m[15] = 1.0f;
+            transforms.push_back(m);
+        }
+    }
+    return transforms;
+}
+
+} // namespace DWGUtils
+
+} // namespace QuantumCanvas::IO
@@ -221,6 +221,9 @@ struct DWGEntity {
         0.0f, 0.0f, 1.0f, 0.0f,
         0.0f, 0.0f, 0.0f, 1.0f
     };
+
+    // Entities are owned through unique_ptr<DWGEntity>
+    virtual ~DWGEntity() = default;
 };
 
 // Specific entity types
@@ -388,9 +391,10 @@ public:
     FormatCapabilities getCapabilities() const override;
     
     FormatDetectionResult detectFormat(const std::filesystem::path& filePath) const override;
-    FormatDetectionResult detectFormat(const std::vector<uint8_t>& data) const override;
+    FormatDetectionResult detectFormat(ByteSpan data) const override;
     
     FileInfo getFileInfo(const std::filesystem::path& filePath) const override;
+    FileInfo getFileInfo(ByteSpan data) const override;
     
     std::future<std::shared_ptr<Document>> loadDocument(
         const std::filesystem::path& filePath,
@@ -400,6 +404,14 @@ public:
         const std::filesystem::path& filePath,
         const LoadOptions& options) override;
     
+    std::future<std::shared_ptr<Document>> loadDocument(
+        std::shared_ptr<const ByteSource> source,
+        const LoadOptions& options) override;
+    
+    std::future<std::shared_ptr<Image>> loadImage(
+        std::shared_ptr<const ByteSource> source,
+        const LoadOptions& options) override;
+    
     std::future<bool> saveDocument(
         const std::shared_ptr<Document>& document,
         const std::filesystem::path& filePath,
@@ -430,7 +442,7 @@ public:
     struct ConversionSettings {
         bool preserveLayerStructure = true;
         bool convertTextToPath = false;
-        bool flattenBlocks = false;
+        bool flattenBlocks = false;  // false keeps definitions shared, inserts become placements
         bool includeInvisibleLayers = false;
         bool includeLockedLayers = true;
         bool includePaperSpace = false;
@@ -559,6 +571,8 @@ namespace DWGUtils {
     bool isValidBlockName(const std::string& name);
     std::string generateUniqueBlockName(const std::string& baseName, 
                                        const std::vector<DWGBlock>& existingBlocks);
+    // Column-major placement per array cell, from block to drawing coordinates
+    std::vector<std::array<float, 16>> getInsertTransforms(const DWGInsert& insert, const DWGBlock& block);
     
     // Text utilities
     std::array<float, 4> calculateTextBounds(const DWGText& text);
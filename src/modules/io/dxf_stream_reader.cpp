@@ -0,0 +1,863 @@
+#include "dxf_stream_reader.hpp"
+#include "../../core/kernel/kernel_manager.hpp"
+#include "../../core/kernel/task_scheduler.hpp"
+#include "../../core/kernel/telemetry.hpp"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+
+namespace QuantumCanvas::IO {
+
+namespace {
+
+constexpr float DEGREES_TO_RADIANS = 3.14159265358979323846f / 180.0f;
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+    return text;
+}
+
+// Values keep their leading spaces, which are significant in text
+std::string_view stripLineEnd(std::string_view text) {
+    if (!text.empty() && text.back() == '\r') text.remove_suffix(1);
+    return text;
+}
+
+bool parseCode(std::string_view line, int& code) {
+    line = trim(line);
+    auto [end, error] = std::from_chars(line.data(), line.data() + line.size(), code);
+    return error == std::errc() && end == line.data() + line.size();
+}
+
+float toFloat(std::string_view value) {
+    value = trim(value);
+    double result = 0.0;
+    std::from_chars(value.data(), value.data() + value.size(), result);
+    return static_cast<float>(result);
+}
+
+int toInt(std::string_view value) {
+    value = trim(value);
+    long long result = 0;
+    std::from_chars(value.data(), value.data() + value.size(), result);
+    return static_cast<int>(result);
+}
+
+uint32_t toHandle(std::string_view value) {
+    value = trim(value);
+    uint64_t result = 0;
+    std::from_chars(value.data(), value.data() + value.size(), result, 16);
+    return static_cast<uint32_t>(result);
+}
+
+std::array<float, 3> trueColor(std::string_view value) {
+    const auto rgb = static_cast<uint32_t>(toInt(value));
+    return {((rgb >> 16) & 0xFF) / 255.0f, ((rgb >> 8) & 0xFF) / 255.0f, (rgb & 0xFF) / 255.0f};
+}
+
+// Group code/value pairs read from a stream in large blocks. Pairs are
+// returned as views into the buffer, valid until the next call; bytes from
+// 'keep' on survive refills, so a caller can hold on to the start of a chunk.
+class PairScanner {
+public:
+    PairScanner(std::istream& input, size_t readSize)
+        : input_(input), readSize_(std::max<size_t>(readSize, 4096)) {}
+
+    bool next(int& code, std::string_view& value, size_t& pairStart) {
+        for (;;) {
+            const size_t codeEnd = buffer_.find('\n', pos_);
+            const size_t valueEnd = codeEnd == std::string::npos ? std::string::npos : buffer_.find('\n', codeEnd + 1);
+            if (valueEnd == std::string::npos && !eof_) {
+                refill();
+                continue;
+            }
+            if (codeEnd == std::string::npos) {
+                return false;
+            }
+
+            // The last value of a file may lack its line end
+            const size_t end = valueEnd == std::string::npos ? buffer_.size() : valueEnd;
+            pairStart = pos_;
+            pos_ = valueEnd == std::string::npos ? buffer_.size() : valueEnd + 1;
+            const std::string_view text(buffer_);
+            if (!parseCode(text.substr(pairStart, codeEnd - pairStart), code)) {
+                throw std::runtime_error("Malformed DXF group code at byte " + std::to_string(base_ + pairStart));
+            }
+            value = stripLineEnd(text.substr(codeEnd + 1, end - codeEnd - 1));
+            return true;
+        }
+    }
+
+    // Reads the first block, for format checks before any pair is taken
+    std::string_view peek(size_t bytes) {
+        while (buffer_.size() < bytes && !eof_) {
+            refill();
+        }
+        return std::string_view(buffer_).substr(0, bytes);
+    }
+
+    const std::string& buffer() const { return buffer_; }
+    uint64_t fileOffset(size_t bufferOffset) const { return base_ + bufferOffset; }
+    size_t position() const { return pos_; }
+    size_t keep = 0;
+
+private:
+    std::istream& input_;
+    size_t readSize_;
+    std::string buffer_;
+    size_t pos_ = 0;
+    uint64_t base_ = 0;  // File offset of buffer_[0]
+    bool eof_ = false;
+
+    void refill() {
+        const size_t drop = std::min(keep, pos_);
+        if (drop > 0) {
+            buffer_.erase(0, drop);
+            base_ += drop;
+            pos_ -= drop;
+            keep -= drop;
+        }
+        const size_t size = buffer_.size();
+        buffer_.resize(size + readSize_);
+        input_.read(buffer_.data() + size, static_cast<std::streamsize>(readSize_));
+        const auto got = static_cast<size_t>(input_.gcount());
+        buffer_.resize(size + got);
+        eof_ = got == 0;
+    }
+};
+
+// Calls fn(code, value) for every pair of an in-memory chunk
+template <typename Fn>
+void forEachPair(std::string_view text, Fn&& fn) {
+    size_t pos = 0;
+    while (pos < text.size()) {
+        const size_t codeEnd = text.find('\n', pos);
+        if (codeEnd == std::string_view::npos) {
+            return;
+        }
+        size_t valueEnd = text.find('\n', codeEnd + 1);
+        if (valueEnd == std::string_view::npos) {
+            valueEnd = text.size();
+        }
+        int code = 0;
+        if (parseCode(text.substr(pos, codeEnd - pos), code)) {
+            fn(code, stripLineEnd(text.substr(codeEnd + 1, valueEnd - codeEnd - 1)));
+        }
+        pos = valueEnd + 1;
+    }
+}
+
+// Builds entities from pairs fed one at a time; group code 0 ends one
+// entity and starts the next
+class EntityParser {
+public:
+    explicit EntityParser(bool includePaperSpace) : includePaperSpace_(includePaperSpace) {}
+
+    std::vector<std::unique_ptr<DWGEntity>> entities;
+    std::vector<DWGInsert> inserts;
+    size_t skipped = 0;
+
+    void feed(int code, std::string_view value) {
+        if (code == 0) {
+            complete();
+            begin(trim(value));
+            return;
+        }
+        if (code == 67) {
+            paperSpace_ = toInt(value) == 1;
+            return;
+        }
+        switch (kind_) {
+            case Kind::Entity: feedEntity(code, value); break;
+            case Kind::Insert: feedInsert(code, value); break;
+            case Kind::Vertex: feedVertex(code, value); break;
+            case Kind::Attribute:
+                if (code == 2) attributeTag_ = std::string(trim(value));
+                else if (code == 1) attributeValue_ = std::string(value);
+                break;
+            case Kind::None:
+                break;
+        }
+    }
+
+    void finish() {
+        complete();
+        kind_ = Kind::None;
+        if (polyline_) {
+            keep(std::move(polyline_), polylinePaperSpace_);
+        }
+    }
+
+private:
+    enum class Kind { None, Entity, Insert, Vertex, Attribute };
+
+    bool includePaperSpace_;
+    Kind kind_ = Kind::None;
+    bool paperSpace_ = false;
+    bool text_ = false;          // entity_ is TEXT or MTEXT
+    bool heavyPolyline_ = false; // entity_ is a POLYLINE, whose vertices follow
+    std::unique_ptr<DWGEntity> entity_;
+    std::unique_ptr<DWGPolyline> polyline_;  // Open POLYLINE, until SEQEND
+    bool polylinePaperSpace_ = false;
+    DWGPolyline::Vertex vertex_;
+    DWGInsert insert_;
+    bool lastInsertKept_ = false;
+    std::string attributeTag_, attributeValue_;
+
+    void keep(std::unique_ptr<DWGEntity> entity, bool paperSpace) {
+        if (includePaperSpace_ || !paperSpace) {
+            entities.push_back(std::move(entity));
+        }
+    }
+
+    void complete() {
+        switch (kind_) {
+            case Kind::Entity:
+                if (heavyPolyline_) {
+                    polyline_.reset(static_cast<DWGPolyline*>(entity_.release()));
+                    polylinePaperSpace_ = paperSpace_;
+                } else {
+                    keep(std::move(entity_), paperSpace_);
+                }
+                break;
+            case Kind::Insert:
+                lastInsertKept_ = includePaperSpace_ || !paperSpace_;
+                if (lastInsertKept_) {
+                    inserts.push_back(std::move(insert_));
+                }
+                break;
+            case Kind::Vertex:
+                if (polyline_) {
+                    polyline_->vertices.push_back(vertex_);
+                }
+                break;
+            case Kind::Attribute:
+                if (lastInsertKept_ && !inserts.empty() && !attributeTag_.empty()) {
+                    inserts.back().attributeValues[attributeTag_] = attributeValue_;
+                }
+                break;
+            case Kind::None:
+                break;
+        }
+        entity_.reset();
+    }
+
+    void begin(std::string_view type) {
+        kind_ = Kind::Entity;
+        paperSpace_ = false;
+        text_ = false;
+        heavyPolyline_ = false;
+        if (type == "VERTEX") {
+            kind_ = Kind::Vertex;
+            vertex_ = {};
+        } else if (type == "SEQEND") {
+            kind_ = Kind::None;
+            if (polyline_) {
+                keep(std::move(polyline_), polylinePaperSpace_);
+            }
+        } else if (type == "ATTRIB") {
+            kind_ = Kind::Attribute;
+            attributeTag_.clear();
+            attributeValue_.clear();
+        } else if (type == "INSERT") {
+            kind_ = Kind::Insert;
+            insert_ = {};
+        } else if (type == "LINE") {
+            entity_ = std::make_unique<DWGLine>();
+        } else if (type == "CIRCLE") {
+            entity_ = std::make_unique<DWGCircle>();
+        } else if (type == "ARC") {
+            entity_ = std::make_unique<DWGArc>();
+        } else if (type == "LWPOLYLINE") {
+            entity_ = std::make_unique<DWGPolyline>();
+        } else if (type == "POLYLINE") {
+            auto polyline = std::make_unique<DWGPolyline>();
+            polyline->type = DWGEntityType::Polyline;
+            entity_ = std::move(polyline);
+            heavyPolyline_ = true;
+        } else if (type == "TEXT" || type == "MTEXT") {
+            auto text = std::make_unique<DWGText>();
+            if (type == "MTEXT") text->type = DWGEntityType::MText;
+            entity_ = std::move(text);
+            text_ = true;
+        } else {
+            kind_ = Kind::None;
+            skipped++;
+        }
+    }
+
+    static bool feedCommon(DWGEntity& entity, int code, std::string_view value) {
+        switch (code) {
+            case 5: entity.id = toHandle(value); return true;
+            case 8: entity.layer = std::string(trim(value)); return true;
+            case 6: entity.linetype = std::string(trim(value)); return true;
+            case 62: entity.colorIndex = static_cast<uint16_t>(std::abs(toInt(value))); return true;
+            case 420: entity.color = trueColor(value); return true;
+            case 370: {
+                const int weight = toInt(value);  // Hundredths of a millimetre; negative = by layer or block
+                entity.lineweight = weight >= 0 ? weight / 100.0f : -1.0f;
+                return true;
+            }
+            case 60: entity.visible = toInt(value) == 0; return true;
+            case 38: entity.elevation = toFloat(value); return true;
+            case 39: entity.thickness = toFloat(value); return true;
+            case 210: entity.normal[0] = toFloat(value); return true;
+            case 220: entity.normal[1] = toFloat(value); return true;
+            case 230: entity.normal[2] = toFloat(value); return true;
+            case 440: entity.transparency = 1.0f - (static_cast<uint32_t>(toInt(value)) & 0xFF) / 255.0f; return true;
+            default: return false;
+        }
+    }
+
+    void feedEntity(int code, std::string_view value) {
+        DWGEntity& entity = *entity_;
+        if (feedCommon(entity, code, value)) {
+            return;
+        }
+        switch (entity.type) {
+            case DWGEntityType::Line: {
+                auto& line = static_cast<DWGLine&>(entity);
+                if (code == 10) line.startPoint[0] = toFloat(value);
+                else if (code == 20) line.startPoint[1] = toFloat(value);
+                else if (code == 11) line.endPoint[0] = toFloat(value);
+                else if (code == 21) line.endPoint[1] = toFloat(value);
+                break;
+            }
+            case DWGEntityType::Circle: {
+                auto& circle = static_cast<DWGCircle&>(entity);
+                if (code == 10) circle.center[0] = toFloat(value);
+                else if (code == 20) circle.center[1] = toFloat(value);
+                else if (code == 40) circle.radius = toFloat(value);
+                break;
+            }
+            case DWGEntityType::Arc: {
+                auto& arc = static_cast<DWGArc&>(entity);
+                if (code == 10) arc.center[0] = toFloat(value);
+                else if (code == 20) arc.center[1] = toFloat(value);
+                else if (code == 40) arc.radius = toFloat(value);
+                else if (code == 50) arc.startAngle = toFloat(value) * DEGREES_TO_RADIANS;
+                else if (code == 51) arc.endAngle = toFloat(value) * DEGREES_TO_RADIANS;
+                break;
+            }
+            case DWGEntityType::LWPolyline:
+            case DWGEntityType::Polyline: {
+                auto& polyline = static_cast<DWGPolyline&>(entity);
+                if (code == 70) {
+                    polyline.closed = (toInt(value) & 1) != 0;
+                } else if (code == 43) {
+                    polyline.constantWidth = toFloat(value);
+                } else if (!heavyPolyline_) {
+                    // Each 10 starts a vertex; the codes after it describe that vertex
+                    if (code == 10) {
+                        DWGPolyline::Vertex vertex;
+                        vertex.position[0] = toFloat(value);
+                        vertex.vertexId = static_cast<uint32_t>(polyline.vertices.size());
+                        polyline.vertices.push_back(vertex);
+                    } else if (!polyline.vertices.empty()) {
+                        auto& vertex = polyline.vertices.back();
+                        if (code == 20) vertex.position[1] = toFloat(value);
+                        else if (code == 42) vertex.bulge = toFloat(value);
+                        else if (code == 40) vertex.startWidth = toFloat(value);
+                        else if (code == 41) vertex.endWidth = toFloat(value);
+                    }
+                }
+                break;
+            }
+            case DWGEntityType::Text:
+            case DWGEntityType::MText: {
+                auto& text = static_cast<DWGText&>(entity);
+                if (code == 1 || code == 3) text.content += value;  // MTEXT splits long strings over 3s, then a 1
+                else if (code == 10) text.position[0] = toFloat(value);
+                else if (code == 20) text.position[1] = toFloat(value);
+                else if (code == 40) text.height = toFloat(value);
+                else if (code == 50) text.rotation = toFloat(value) * DEGREES_TO_RADIANS;
+                else if (code == 41 && entity.type == DWGEntityType::Text) text.widthFactor = toFloat(value);
+                else if (code == 51) text.obliqueAngle = toFloat(value) * DEGREES_TO_RADIANS;
+                else if (code == 7) text.style = std::string(trim(value));
+                else if (code == 72) text.horizontalAlign = static_cast<DWGText::HorizontalAlignment>(toInt(value));
+                else if (code == 73) text.verticalAlign = static_cast<DWGText::VerticalAlignment>(toInt(value));
+                else if (code == 11) text.alignmentPoint[0] = toFloat(value);
+                else if (code == 21) text.alignmentPoint[1] = toFloat(value);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void feedInsert(int code, std::string_view value) {
+        switch (code) {
+            case 5: insert_.entityId = toHandle(value); break;
+            case 2: insert_.blockName = std::string(trim(value)); break;
+            case 10: insert_.position[0] = toFloat(value); break;
+            case 20: insert_.position[1] = toFloat(value); break;
+            case 41: insert_.scale[0] = toFloat(value); break;
+            case 42: insert_.scale[1] = toFloat(value); break;
+            case 50: insert_.rotation = toFloat(value) * DEGREES_TO_RADIANS; break;
+            case 70: insert_.columnCount = static_cast<uint32_t>(std::max(1, toInt(value))); break;
+            case 71: insert_.rowCount = static_cast<uint32_t>(std::max(1, toInt(value))); break;
+            case 44: insert_.columnSpacing = toFloat(value); break;
+            case 45: insert_.rowSpacing = toFloat(value); break;
+            default: break;
+        }
+    }
+
+    void feedVertex(int code, std::string_view value) {
+        if (code == 10) vertex_.position[0] = toFloat(value);
+        else if (code == 20) vertex_.position[1] = toFloat(value);
+        else if (code == 42) vertex_.bulge = toFloat(value);
+        else if (code == 40) vertex_.startWidth = toFloat(value);
+        else if (code == 41) vertex_.endWidth = toFloat(value);
+        else if (code == 5) vertex_.vertexId = toHandle(value);
+    }
+};
+
+// Parses HEADER, TABLES and BLOCKS as their pairs stream past. Returns true
+// when the ENTITIES section begins, false at the end of the file.
+class TablesParser {
+public:
+    TablesParser(DWGDrawingTables& tables, bool includePaperSpace)
+        : tables_(tables), includePaperSpace_(includePaperSpace) {}
+
+    bool feed(int code, std::string_view value) {
+        if (code == 0 && trim(value) == "SECTION") {
+            finishRecord();
+            awaitingName_ = true;
+            return false;
+        }
+        if (awaitingName_ && code == 2) {
+            awaitingName_ = false;
+            section_ = std::string(trim(value));
+            return section_ == "ENTITIES";
+        }
+        if (code == 0 && trim(value) == "ENDSEC") {
+            finishRecord();
+            section_.clear();
+            return false;
+        }
+
+        if (section_ == "HEADER") feedHeader(code, value);
+        else if (section_ == "TABLES") feedTables(code, value);
+        else if (section_ == "BLOCKS") feedBlocks(code, value);
+        return false;
+    }
+
+private:
+    DWGDrawingTables& tables_;
+    bool includePaperSpace_;
+    bool awaitingName_ = false;
+    std::string section_;
+
+    // HEADER
+    std::string variable_;
+
+    // TABLES
+    enum class Record { None, Layer, TextStyle } record_ = Record::None;
+    DWGLayer layer_;
+    DWGTextStyle style_;
+
+    // BLOCKS
+    bool inBlockHeader_ = false;
+    DWGBlock block_;
+    std::unique_ptr<EntityParser> blockParser_;
+    uint32_t nextSyntheticId_ = UINT32_MAX;
+
+    void feedHeader(int code, std::string_view value) {
+        DWGFileInfo& info = tables_.info;
+        if (code == 9) {
+            variable_ = std::string(trim(value));
+        } else if (variable_ == "$ACADVER" && code == 1) {
+            info.version = std::string(trim(value));
+        } else if (variable_ == "$INSUNITS" && code == 70) {
+            info.units = static_cast<DWGUnits>(toInt(value));
+        } else if (variable_ == "$CLAYER" && code == 8) {
+            info.currentLayer = std::string(trim(value));
+        } else if (variable_ == "$TEXTSTYLE" && code == 7) {
+            info.currentTextStyle = std::string(trim(value));
+        } else if (variable_ == "$DIMSTYLE" && code == 2) {
+            info.currentDimStyle = std::string(trim(value));
+        } else if (variable_ == "$TEXTSIZE" && code == 40) {
+            info.textSize = toFloat(value);
+        } else if (code == 10 || code == 20) {
+            const size_t axis = code == 10 ? 0 : 1;
+            if (variable_ == "$EXTMIN") info.extMin[axis] = toFloat(value);
+            else if (variable_ == "$EXTMAX") info.extMax[axis] = toFloat(value);
+            else if (variable_ == "$LIMMIN") info.limMin[axis] = toFloat(value);
+            else if (variable_ == "$LIMMAX") info.limMax[axis] = toFloat(value);
+        }
+    }
+
+    void feedTables(int code, std::string_view value) {
+        if (code == 0) {
+            finishRecord();
+            const std::string_view type = trim(value);
+            if (type == "LAYER") {
+                record_ = Record::Layer;
+                layer_ = {};
+            } else if (type == "STYLE") {
+                record_ = Record::TextStyle;
+                style_ = {};
+            }
+            return;
+        }
+
+        if (record_ == Record::Layer) {
+            switch (code) {
+                case 2: layer_.name = std::string(trim(value)); break;
+                case 62: {
+                    const int color = toInt(value);  // Negative while the layer is off
+                    layer_.colorIndex = static_cast<uint16_t>(std::abs(color));
+                    layer_.visible = color >= 0;
+                    break;
+                }
+                case 420: layer_.color = trueColor(value); break;
+                case 6: layer_.linetype = std::string(trim(value)); break;
+                case 370: if (toInt(value) >= 0) layer_.lineweight = toInt(value) / 100.0f; break;
+                case 70:
+                    layer_.frozen = (toInt(value) & 1) != 0;
+                    layer_.locked = (toInt(value) & 4) != 0;
+                    break;
+                case 290: layer_.plottable = toInt(value) != 0; break;
+                default: break;
+            }
+        } else if (record_ == Record::TextStyle) {
+            switch (code) {
+                case 2: style_.name = std::string(trim(value)); break;
+                case 3: style_.fontName = std::string(trim(value)); break;
+                case 4: style_.bigFontName = std::string(trim(value)); break;
+                case 40: style_.height = toFloat(value); break;
+                case 41: style_.widthFactor = toFloat(value); break;
+                case 50: style_.obliqueAngle = toFloat(value); break;
+                case 70: style_.vertical = (toInt(value) & 4) != 0; break;
+                case 71:
+                    style_.backwards = (toInt(value) & 2) != 0;
+                    style_.upsideDown = (toInt(value) & 4) != 0;
+                    break;
+                default: break;
+            }
+        }
+    }
+
+    void finishRecord() {
+        if (record_ == Record::Layer && !layer_.name.empty()) {
+            tables_.layers.push_back(std::move(layer_));
+        } else if (record_ == Record::TextStyle && !style_.name.empty()) {
+            tables_.textStyles.push_back(std::move(style_));
+        }
+        record_ = Record::None;
+    }
+
+    void feedBlocks(int code, std::string_view value) {
+        if (code == 0) {
+            const std::string_view type = trim(value);
+            if (type == "BLOCK") {
+                inBlockHeader_ = true;
+                block_ = {};
+                blockParser_ = std::make_unique<EntityParser>(includePaperSpace_);
+                return;
+            }
+            if (type == "ENDBLK") {
+                finishBlock();
+                return;
+            }
+            inBlockHeader_ = false;
+        }
+
+        if (inBlockHeader_) {
+            switch (code) {
+                case 2: block_.name = std::string(trim(value)); break;
+                case 10: block_.basePoint[0] = toFloat(value); break;
+                case 20: block_.basePoint[1] = toFloat(value); break;
+                case 4: block_.description = std::string(value); break;
+                case 70: block_.isLayout = block_.name.rfind("*Paper_Space", 0) == 0 ||
+                                           block_.name.rfind("*Model_Space", 0) == 0; break;
+                default: break;
+            }
+        } else if (blockParser_) {
+            blockParser_->feed(code, value);
+        }
+    }
+
+    void finishBlock() {
+        if (!blockParser_) {
+            return;
+        }
+        blockParser_->finish();
+        for (auto& entity : blockParser_->entities) {
+            if (entity->id == 0) entity->id = nextSyntheticId_--;
+            block_.entityIds.push_back(entity->id);
+            tables_.blockEntities.push_back(std::move(entity));
+        }
+        for (auto& insert : blockParser_->inserts) {
+            if (insert.entityId == 0) insert.entityId = nextSyntheticId_--;
+            block_.entityIds.push_back(insert.entityId);
+            tables_.blockInserts.push_back(std::move(insert));
+        }
+        if (!block_.name.empty()) {
+            tables_.blocks.push_back(std::move(block_));
+        }
+        blockParser_.reset();
+        inBlockHeader_ = false;
+    }
+};
+
+// Hands parsed batches to the callback in sequence order, one at a time.
+// Whichever thread completes the next awaited batch drains everything ready
+// behind it; others leave theirs and return to parsing.
+struct OrderedDelivery {
+    OrderedDelivery(const DXFStreamReader::BatchCallback& callback, std::chrono::steady_clock::time_point startTime)
+        : onBatch(callback), start(startTime) {}
+
+    const DXFStreamReader::BatchCallback& onBatch;
+    std::chrono::steady_clock::time_point start;
+
+    std::mutex mutex;
+    std::map<size_t, DWGEntityBatch> ready;
+    size_t next = 0;
+    bool delivering = false;
+    std::atomic<bool> cancelled{false};
+    std::atomic<size_t> delivered{0};
+    DXFStreamReader::Result result;  // Guarded by mutex
+
+    void deliver(DWGEntityBatch batch) {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.emplace(batch.sequence, std::move(batch));
+        if (delivering) {
+            return;
+        }
+        delivering = true;
+        for (auto it = ready.find(next); it != ready.end(); it = ready.find(next)) {
+            DWGEntityBatch current = std::move(it->second);
+            ready.erase(it);
+            ++next;
+            if (cancelled.load(std::memory_order_relaxed)) {
+                delivered.fetch_add(1, std::memory_order_release);
+                continue;
+            }
+
+            if (result.batchCount++ == 0) {
+                result.timeToFirstBatch = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start);
+            }
+            result.entityCount += current.entities.size() + current.inserts.size();
+            lock.unlock();
+            const bool keepGoing = onBatch(std::move(current));
+            lock.lock();
+            if (!keepGoing) {
+                cancelled.store(true, std::memory_order_relaxed);
+            }
+            delivered.fetch_add(1, std::memory_order_release);
+        }
+        delivering = false;
+    }
+};
+
+} // namespace
+
+// =============================================================================
+// DXFStreamReader
+// =============================================================================
+
+DXFStreamReader::DXFStreamReader(std::shared_ptr<Core::TaskScheduler> scheduler)
+    : scheduler_(std::move(scheduler)) {
+}
+
+bool DXFStreamReader::isASCIIDXF(ByteSpan data) {
+    const std::string_view text(reinterpret_cast<const char*>(data.data()), data.size());
+    const size_t codeEnd = text.find('\n');
+    if (codeEnd == std::string_view::npos) {
+        return false;
+    }
+    int code = -1;
+    if (!parseCode(text.substr(0, codeEnd), code)) {
+        return false;
+    }
+    const size_t valueEnd = text.find('\n', codeEnd + 1);
+    const std::string_view value = trim(text.substr(codeEnd + 1, valueEnd == std::string_view::npos
+                                                                     ? std::string_view::npos
+                                                                     : valueEnd - codeEnd - 1));
+    return code == 999 || (code == 0 && value == "SECTION");
+}
+
+DXFStreamReader::Result DXFStreamReader::read(const std::filesystem::path& filePath,
+                                              const TablesCallback& onTables,
+                                              const BatchCallback& onBatch,
+                                              const Options& options) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open file: " + filePath.string());
+    }
+    std::error_code error;
+    const uint64_t size = std::filesystem::file_size(filePath, error);
+    return readStream(file, error ? 0 : size, onTables, onBatch, options);
+}
+
+DXFStreamReader::Result DXFStreamReader::read(std::istream& input, const TablesCallback& onTables,
+                                              const BatchCallback& onBatch, const Options& options) {
+    return readStream(input, 0, onTables, onBatch, options);
+}
+
+DXFStreamReader::Result DXFStreamReader::readStream(std::istream& input, uint64_t totalBytes,
+                                                    const TablesCallback& onTables,
+                                                    const BatchCallback& onBatch,
+                                                    const Options& options) {
+    QCS_TRACE_SCOPE("io.dxf_read");
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&start]() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    };
+
+    PairScanner scanner(input, options.readSize);
+    const std::string_view head = scanner.peek(32);
+    if (head.substr(0, 4) == "AC10") {
+        throw std::runtime_error("Binary DWG needs the ODA SDK; save the drawing as ASCII DXF to stream it");
+    }
+    if (head.substr(0, 18) == "AutoCAD Binary DXF") {
+        throw std::runtime_error("Binary DXF is not supported; save the drawing as ASCII DXF");
+    }
+
+    // Header, tables and blocks, in the order they stream past
+    tables_ = {};
+    TablesParser tablesParser(tables_, options.includePaperSpace);
+    int code = 0;
+    std::string_view value;
+    size_t pairStart = 0;
+    bool entitiesFound = false;
+    while (!entitiesFound && scanner.next(code, value, pairStart)) {
+        scanner.keep = scanner.position();
+        entitiesFound = tablesParser.feed(code, value);
+    }
+
+    OrderedDelivery delivery(onBatch, start);
+    delivery.result.timeToTables = elapsed();
+    if (onTables) {
+        onTables(tables_);
+    }
+    if (!entitiesFound) {
+        delivery.result.totalTime = elapsed();
+        delivery.result.bytesRead = scanner.fileOffset(scanner.buffer().size());
+        return delivery.result;
+    }
+
+    auto scheduler = scheduler_ ? scheduler_ : Core::KernelManager::instance().get_service<Core::TaskScheduler>();
+    const bool parallel = scheduler && scheduler->is_initialized();
+    const size_t maxInFlight = options.maxChunksInFlight > 0
+        ? options.maxChunksInFlight
+        : 2 * static_cast<size_t>(parallel ? scheduler->concurrency() : 1);
+
+    Core::TaskGroup group;
+    std::atomic<size_t> skipped{0};
+    size_t submitted = 0;
+
+    auto parseChunk = [&delivery, &skipped, &options](const std::string& chunk, size_t sequence, uint64_t end) {
+        try {
+            EntityParser parser(options.includePaperSpace);
+            forEachPair(chunk, [&parser](int c, std::string_view v) { parser.feed(c, v); });
+            parser.finish();
+            skipped.fetch_add(parser.skipped, std::memory_order_relaxed);
+
+            DWGEntityBatch batch;
+            batch.sequence = sequence;
+            batch.entities = std::move(parser.entities);
+            batch.inserts = std::move(parser.inserts);
+            batch.bytesParsed = end;
+            delivery.deliver(std::move(batch));
+        } catch (...) {
+            // Later batches can never be delivered; stop the producer waiting on them
+            delivery.cancelled.store(true, std::memory_order_relaxed);
+            throw;
+        }
+    };
+
+    // Chunks are cut on the calling thread, which only finds line ends and
+    // group codes; parsing values and building entities runs on the pool
+    auto emit = [&](size_t end) {
+        const std::string& buffer = scanner.buffer();
+        auto chunk = std::make_shared<std::string>(buffer, scanner.keep, end - scanner.keep);
+        const uint64_t endOffset = scanner.fileOffset(end);
+        const size_t sequence = submitted++;
+        scanner.keep = end;
+
+        if (parallel) {
+            scheduler->submit(group, [parseChunk, chunk, sequence, endOffset]() {
+                parseChunk(*chunk, sequence, endOffset);
+            });
+            while (submitted - delivery.delivered.load(std::memory_order_acquire) >= maxInFlight &&
+                   !delivery.cancelled.load(std::memory_order_relaxed)) {
+                if (!scheduler->try_run_pending_task()) {
+                    std::this_thread::yield();
+                }
+            }
+        } else {
+            parseChunk(*chunk, sequence, endOffset);
+        }
+
+        if (options.progressCallback && totalBytes > 0 &&
+            !options.progressCallback(static_cast<float>(endOffset) / static_cast<float>(totalBytes))) {
+            delivery.cancelled.store(true, std::memory_order_relaxed);
+        }
+    };
+
+    try {
+        scanner.keep = scanner.position();
+        size_t target = std::max<size_t>(options.firstChunkSize, 1);
+        bool ended = false;
+        while (!delivery.cancelled.load(std::memory_order_relaxed)) {
+            if (!scanner.next(code, value, pairStart)) {
+                break;
+            }
+            if (code != 0) {
+                continue;
+            }
+            const std::string_view type = trim(value);
+            if (type == "ENDSEC") {
+                ended = true;
+                break;
+            }
+            // Vertices, attributes and their SEQEND stay with their owner
+            if (pairStart - scanner.keep >= target && type != "VERTEX" && type != "ATTRIB" && type != "SEQEND") {
+                emit(pairStart);
+                target = std::max<size_t>(options.chunkSize, 1);
+            }
+        }
+
+        const size_t end = ended ? pairStart : scanner.buffer().size();
+        if (!delivery.cancelled.load(std::memory_order_relaxed) && end > scanner.keep) {
+            emit(end);
+        }
+        if (parallel) {
+            scheduler->wait(group);
+        }
+    } catch (...) {
+        // Tasks still hold references into this frame
+        delivery.cancelled.store(true, std::memory_order_relaxed);
+        if (parallel) {
+            try {
+                scheduler->wait(group);
+            } catch (...) {
+            }
+        }
+        throw;
+    }
+
+    Result result;
+    {
+        std::lock_guard<std::mutex> lock(delivery.mutex);
+        result = delivery.result;
+    }
+    result.cancelled = delivery.cancelled.load();
+    result.skippedEntityCount = skipped.load();
+    result.bytesRead = scanner.fileOffset(scanner.position());
+    result.totalTime = elapsed();
+    return result;
+}
+
+} // namespace QuantumCanvas::IO
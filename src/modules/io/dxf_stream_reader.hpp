@@ -0,0 +1,106 @@
+#pragma once
+
+#include "dwg_handler.hpp"
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace QuantumCanvas::Core {
+class TaskScheduler;
+}
+
+namespace QuantumCanvas::IO {
+
+// Entities from one chunk of a drawing's ENTITIES section
+struct DWGEntityBatch {
+    size_t sequence = 0;        // Batches arrive in file order: 0, 1, 2, ...
+    std::vector<std::unique_ptr<DWGEntity>> entities;
+    std::vector<DWGInsert> inserts;
+    uint64_t bytesParsed = 0;   // File offset of the end of this batch
+};
+
+// Everything a drawing defines ahead of its entities
+struct DWGDrawingTables {
+    DWGFileInfo info;
+    std::vector<DWGLayer> layers;
+    std::vector<DWGTextStyle> textStyles;
+    std::vector<DWGBlock> blocks;
+
+    // Contents of the blocks, referenced from DWGBlock::entityIds; entities
+    // without a handle are given IDs counting down from UINT32_MAX
+    std::vector<std::unique_ptr<DWGEntity>> blockEntities;
+    std::vector<DWGInsert> blockInserts;  // Nested block references
+};
+
+// Single-pass streaming reader for ASCII DXF drawings
+//
+// The file is read once, front to back. Header, tables and blocks are parsed
+// as they stream past and handed over before the first entity; the ENTITIES
+// section is cut at entity boundaries into chunks that are parsed in
+// parallel on the task scheduler and delivered in file order as each one
+// completes, so a viewer can draw while the rest of the file is still being
+// read. Reading stops at the end of the ENTITIES section; OBJECTS are never
+// touched. Only a bounded number of chunks are in flight at once, so memory
+// use does not grow with the file.
+//
+// Binary DWG needs the ODA SDK to decode; its entities can be fed to the same
+// callbacks, but this reader rejects DWG input.
+class DXFStreamReader final {
+public:
+    struct Options {
+        size_t chunkSize = size_t(4) << 20;         // ENTITIES bytes per parse task
+        size_t firstChunkSize = size_t(256) << 10;  // Smaller, so the first batch shows sooner
+        size_t readSize = size_t(8) << 20;          // Bytes per read from the stream
+        size_t maxChunksInFlight = 0;               // 0 = twice the scheduler's concurrency
+        bool includePaperSpace = false;
+        std::function<bool(float)> progressCallback;  // Return false to cancel
+    };
+
+    // Called once, before any batch
+    using TablesCallback = std::function<void(const DWGDrawingTables&)>;
+    // Called in file order and never concurrently, from whichever thread
+    // finished the batch; return false to stop reading
+    using BatchCallback = std::function<bool(DWGEntityBatch&&)>;
+
+    struct Result {
+        bool cancelled = false;
+        size_t batchCount = 0;
+        size_t entityCount = 0;        // Entities and inserts delivered
+        size_t skippedEntityCount = 0; // Entity types with no DWG representation
+        uint64_t bytesRead = 0;
+        std::chrono::microseconds timeToTables{0};
+        std::chrono::microseconds timeToFirstBatch{0};
+        std::chrono::microseconds totalTime{0};
+    };
+
+    // Without a scheduler, the kernel's is used; without either, chunks are
+    // parsed on the calling thread
+    explicit DXFStreamReader(std::shared_ptr<Core::TaskScheduler> scheduler = nullptr);
+
+    // Throws std::runtime_error if the input cannot be read or is not ASCII
+    // DXF. The tables stay available from the reader afterwards.
+    Result read(const std::filesystem::path& filePath, const TablesCallback& onTables,
+                const BatchCallback& onBatch, const Options& options);
+    Result read(std::istream& input, const TablesCallback& onTables,
+                const BatchCallback& onBatch, const Options& options);
+
+    const DWGDrawingTables& getTables() const { return tables_; }
+    DWGDrawingTables takeTables() { return std::move(tables_); }
+
+    // True for ASCII DXF, judged from the first bytes of data
+    static bool isASCIIDXF(ByteSpan data);
+
+private:
+    std::shared_ptr<Core::TaskScheduler> scheduler_;
+    DWGDrawingTables tables_;
+
+    Result readStream(std::istream& input, uint64_t totalBytes, const TablesCallback& onTables,
+                      const BatchCallback& onBatch, const Options& options);
+};
+
+} // namespace QuantumCanvas::IO
@@ -1,6 +1,8 @@
 #include "file_format_manager.hpp"
+#include "image_codecs.hpp"
+#include "qcsx_handler.hpp"
 #include "../../core/kernel/kernel_manager.hpp"
-#include <fstream>
+#include "../../core/kernel/task_scheduler.hpp"
 #include <algorithm>
 #include <thread>
 #include <future>
@@ -51,68 +53,6 @@ void FileFormatManager::initializeFormatNames() {
     formatNames_[FileFormat::Unknown] = "Unknown Format";
 }
 
-// Thread pool implementation for async operations
-class FileFormatManager::ThreadPool {
-private:
-    std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> tasks_;
-    std::mutex queueMutex_;
-    std::condition_variable condition_;
-    std::atomic<bool> stop_{false};
-
-public:
-    explicit ThreadPool(size_t numThreads) {
-        for (size_t i = 0; i < numThreads; ++i) {
-            workers_.emplace_back([this] {
-                while (true) {
-                    std::function<void()> task;
-                    {
-                        std::unique_lock<std::mutex> lock(queueMutex_);
-                        condition_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
-                        
-                        if (stop_ && tasks_.empty()) break;
-                        
-                        task = std::move(tasks_.front());
-                        tasks_.pop();
-                    }
-                    task();
-                }
-            });
-        }
-    }
-
-    ~ThreadPool() {
-        {
-            std::unique_lock<std::mutex> lock(queueMutex_);
-            stop_ = true;
-        }
-        condition_.notify_all();
-        for (std::thread& worker : workers_) {
-            worker.join();
-        }
-    }
-
-    template<class F, class... Args>
-    auto enqueue(F&& f, Args&&... args) -> std::future<typename std::result_of<F(Args...)>::type> {
-        using return_type = typename std::result_of<F(Args...)>::type;
-
-        auto task = std::make_shared<std::packaged_task<return_type()>>(
-            std::bind(std::forward<F>(f), std::forward<Args>(args)...)
-        );
-
-        std::future<return_type> res = task->get_future();
-        {
-            std::unique_lock<std::mutex> lock(queueMutex_);
-            if (stop_) {
-                throw std::runtime_error("enqueue on stopped ThreadPool");
-            }
-            tasks_.emplace([task]() { (*task)(); });
-        }
-        condition_.notify_one();
-        return res;
-    }
-};
-
 FileFormatManager::FileFormatManager(Rendering::RenderingEngine& engine)
     : engine_(engine) {
     
@@ -125,6 +65,7 @@ FileFormatManager::FileFormatManager(Rendering::RenderingEngine& engine)
     if (maxConcurrency_ == 0) {
         maxConcurrency_ = std::max(1u, std::thread::hardware_concurrency());
     }
+    registerTelemetry();
 }
 
 FileFormatManager::~FileFormatManager() {
@@ -142,7 +83,7 @@ FileFormatManager::FileFormatManager(FileFormatManager&& other) noexcept
     , maxConcurrency_(other.maxConcurrency_)
     , memoryBudget_(other.memoryBudget_)
     , cacheEnabled_(other.cacheEnabled_)
-    , threadPool_(std::move(other.threadPool_))
+    , scheduler_(std::move(other.scheduler_))
     , fileCache_(std::move(other.fileCache_))
     , maxCacheSize_(other.maxCacheSize_)
     , currentCacheMemory_(other.currentCacheMemory_)
@@ -151,6 +92,19 @@ FileFormatManager::FileFormatManager(FileFormatManager&& other) noexcept
     , maxErrorLogSize_(other.maxErrorLogSize_)
     , magicPatterns_(std::move(other.magicPatterns_)) {
     
+    // The pipeline's stages point at the manager they were made for
+    other.thumbnails_.reset();
+    thumbnailCacheDirectory_ = std::move(other.thumbnailCacheDirectory_);
+    thumbnailCacheBytes_ = other.thumbnailCacheBytes_;
+    other.batchEngine_.reset();
+    other.assets_.reset();
+    if (initialized_) {
+        createThumbnailPipeline();
+        createBatchEngine();
+        createAssetCache();
+    }
+    registerTelemetry();
+    
     other.initialized_ = false;
 }
 
@@ -168,7 +122,7 @@ FileFormatManager& FileFormatManager::operator=(FileFormatManager&& other) noexc
         maxConcurrency_ = other.maxConcurrency_;
         memoryBudget_ = other.memoryBudget_;
         cacheEnabled_ = other.cacheEnabled_;
-        threadPool_ = std::move(other.threadPool_);
+        scheduler_ = std::move(other.scheduler_);
         fileCache_ = std::move(other.fileCache_);
         maxCacheSize_ = other.maxCacheSize_;
         currentCacheMemory_ = other.currentCacheMemory_;
@@ -177,6 +131,17 @@ FileFormatManager& FileFormatManager::operator=(FileFormatManager&& other) noexc
         maxErrorLogSize_ = other.maxErrorLogSize_;
         magicPatterns_ = std::move(other.magicPatterns_);
         
+        other.thumbnails_.reset();
+        thumbnailCacheDirectory_ = std::move(other.thumbnailCacheDirectory_);
+        thumbnailCacheBytes_ = other.thumbnailCacheBytes_;
+        other.batchEngine_.reset();
+        other.assets_.reset();
+        if (initialized_) {
+            createThumbnailPipeline();
+            createBatchEngine();
+            createAssetCache();
+        }
+        
         other.initialized_ = false;
     }
     return *this;
@@ -186,8 +151,13 @@ bool FileFormatManager::initialize() {
     if (initialized_) return true;
     
     try {
-        // Initialize thread pool
-        threadPool_ = std::make_unique<ThreadPool>(maxConcurrency_);
+        // Async work goes to the kernel's shared scheduler. A standalone
+        // manager (no kernel service registered) gets a private one.
+        scheduler_ = Core::KernelManager::instance().get_service<Core::TaskScheduler>();
+        if (!scheduler_) {
+            scheduler_ = std::make_shared<Core::TaskScheduler>(maxConcurrency_);
+            scheduler_->initialize();
+        }
         
         // Initialize magic byte patterns for format detection
         initializeMagicPatterns();
@@ -201,6 +171,10 @@ bool FileFormatManager::initialize() {
         // Create default presets
         createDefaultPresets();
         
+        createThumbnailPipeline();
+        createBatchEngine();
+        createAssetCache();
+        
         initialized_ = true;
         return true;
     }
@@ -218,8 +192,14 @@ bool FileFormatManager::initialize() {
 void FileFormatManager::shutdown() {
     if (!initialized_) return;
     
-    // Reset thread pool
-    threadPool_.reset();
+    // Stop thumbnail and batch work before the handlers it calls go away.
+    // Asset handles held elsewhere outlive the cache.
+    thumbnails_.reset();
+    batchEngine_.reset();
+    assets_.reset();
+    
+    // Release the scheduler; a private one drains its queue on destruction
+    scheduler_.reset();
     
     // Clear handlers
     {
@@ -290,16 +270,8 @@ FormatDetectionResult FileFormatManager::detectFormat(const std::filesystem::pat
     }
     
     // First try extension-based detection
-    std::string extension = FormatUtils::getFileExtension(filePath);
-    FileFormat formatByExt = detectFormatByExtension(extension);
-    
-    // If extension detection succeeded with high confidence, use it
-    if (formatByExt != FileFormat::Unknown) {
-        FormatDetectionResult result;
-        result.format = formatByExt;
-        result.confidence = 0.7f;  // Medium confidence for extension-based detection
-        result.detectionMethod = "extension";
-        result.possibleExtensions.push_back(extension);
+    FormatDetectionResult result = detectByExtension(filePath);
+    if (result.isSupported()) {
         return result;
     }
     
@@ -319,7 +291,7 @@ FormatDetectionResult FileFormatManager::detectFormat(const std::filesystem::pat
     }
 }
 
-FormatDetectionResult FileFormatManager::detectFormat(const std::vector<uint8_t>& data) const {
+FormatDetectionResult FileFormatManager::detectFormat(ByteSpan data) const {
     if (data.empty()) {
         return FormatDetectionResult{FileFormat::Unknown, 0.0f, "", {}, "empty_data"};
     }
@@ -374,14 +346,17 @@ FileInfo FileFormatManager::getFileInfo(const std::filesystem::path& filePath) c
     }
     
     try {
+        // Map the file once; a header probe faults in only the pages it reads
+        ByteSource source = ByteSource::open(filePath, ByteSource::Access::Random);
+        
         // Basic file properties
-        info.fileSize = std::filesystem::file_size(filePath);
+        info.fileSize = source.size();
         info.lastModified = std::chrono::system_clock::from_time_t(
             std::chrono::system_clock::to_time_t(
                 std::filesystem::last_write_time(filePath)));
         
         // Detect format
-        FormatDetectionResult detection = detectFormat(filePath);
+        FormatDetectionResult detection = detectMappedFormat(filePath, source.bytes());
         info.format = detection.format;
         
         // Get detailed info from handler
@@ -389,7 +364,7 @@ FileInfo FileFormatManager::getFileInfo(const std::filesystem::path& filePath) c
             const IFormatHandler* handler = getHandler(info.format);
             if (handler) {
                 try {
-                    FileInfo detailedInfo = handler->getFileInfo(filePath);
+                    FileInfo detailedInfo = handler->getFileInfo(source.bytes());
                     // Merge detailed info with basic info
                     info.dimensions = detailedInfo.dimensions;
                     info.bitDepth = detailedInfo.bitDepth;
@@ -425,40 +400,12 @@ std::future<std::shared_ptr<Document>> FileFormatManager::loadDocument(
     const std::filesystem::path& filePath,
     const LoadOptions& options) {
     
-    return threadPool_->enqueue([this, filePath, options]() -> std::shared_ptr<Document> {
-        auto startTime = std::chrono::high_resolution_clock::now();
-        
+    return scheduler_->async([this, filePath, options]() -> std::shared_ptr<Document> {
         try {
-            // Detect format
-            FormatDetectionResult detection = detectFormat(filePath);
-            if (!detection.isSupported()) {
-                throw std::runtime_error("Unsupported file format: " + filePath.string());
-            }
-            
-            // Get handler
-            IFormatHandler* handler = getHandler(detection.format);
-            if (!handler) {
-                throw std::runtime_error("No handler available for format");
-            }
-            
-            // Load document
-            auto future = handler->loadDocument(filePath, options);
-            auto document = future.get();
-            
-            // Update statistics
-            auto endTime = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-            
-            {
-                std::lock_guard<std::mutex> lock(statsMutex_);
-                stats_.documentsLoaded++;
-                stats_.bytesRead += std::filesystem::file_size(filePath);
-                stats_.totalLoadTime += duration;
-                stats_.formatUsageCount[detection.format]++;
-                stats_.formatProcessingTime[detection.format] += duration;
-            }
-            
-            return document;
+            // Map the file once; detection and the handler both read the mapping
+            auto source = std::make_shared<const ByteSource>(
+                ByteSource::open(filePath, ByteSource::Access::Sequential));
+            return loadMappedDocument(filePath, source, options);
         }
         catch (const std::exception& e) {
             ErrorInfo error;
@@ -477,9 +424,7 @@ std::future<std::shared_ptr<Image>> FileFormatManager::loadImage(
     const std::filesystem::path& filePath,
     const LoadOptions& options) {
     
-    return threadPool_->enqueue([this, filePath, options]() -> std::shared_ptr<Image> {
-        auto startTime = std::chrono::high_resolution_clock::now();
-        
+    return scheduler_->async([this, filePath, options]() -> std::shared_ptr<Image> {
         try {
             // Check cache first
             if (cacheEnabled_) {
@@ -502,21 +447,10 @@ std::future<std::shared_ptr<Image>> FileFormatManager::loadImage(
                 stats_.cacheMisses++;
             }
             
-            // Detect format
-            FormatDetectionResult detection = detectFormat(filePath);
-            if (!detection.isSupported()) {
-                throw std::runtime_error("Unsupported file format: " + filePath.string());
-            }
-            
-            // Get handler
-            IFormatHandler* handler = getHandler(detection.format);
-            if (!handler) {
-                throw std::runtime_error("No handler available for format");
-            }
-            
-            // Load image
-            auto future = handler->loadImage(filePath, options);
-            auto image = future.get();
+            // Map the file once; detection and the handler both read the mapping
+            auto source = std::make_shared<const ByteSource>(
+                ByteSource::open(filePath, ByteSource::Access::Sequential));
+            auto image = loadMappedImage(filePath, source, options);
             
             // Update cache if enabled
             if (cacheEnabled_ && image) {
@@ -524,19 +458,6 @@ std::future<std::shared_ptr<Image>> FileFormatManager::loadImage(
                 updateCache(filePath.string(), info, image);
             }
             
-            // Update statistics
-            auto endTime = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-            
-            {
-                std::lock_guard<std::mutex> lock(statsMutex_);
-                stats_.imagesLoaded++;
-                stats_.bytesRead += std::filesystem::file_size(filePath);
-                stats_.totalLoadTime += duration;
-                stats_.formatUsageCount[detection.format]++;
-                stats_.formatProcessingTime[detection.format] += duration;
-            }
-            
             return image;
         }
         catch (const std::exception& e) {
@@ -558,50 +479,9 @@ std::future<bool> FileFormatManager::saveDocument(
     const std::filesystem::path& filePath,
     const SaveOptions& options) {
     
-    return threadPool_->enqueue([this, document, filePath, options]() -> bool {
-        auto startTime = std::chrono::high_resolution_clock::now();
-        
+    return scheduler_->async([this, document, filePath, options]() -> bool {
         try {
-            if (!document) {
-                throw std::runtime_error("Document is null");
-            }
-            
-            // Determine format from file extension
-            std::string extension = FormatUtils::getFileExtension(filePath);
-            FileFormat format = detectFormatByExtension(extension);
-            
-            if (format == FileFormat::Unknown) {
-                throw std::runtime_error("Cannot determine output format from extension: " + extension);
-            }
-            
-            // Get handler
-            IFormatHandler* handler = getHandler(format);
-            if (!handler || !handler->canSave()) {
-                throw std::runtime_error("No handler available for saving format");
-            }
-            
-            // Save document
-            auto future = handler->saveDocument(document, filePath, options);
-            bool success = future.get();
-            
-            if (success) {
-                // Update statistics
-                auto endTime = std::chrono::high_resolution_clock::now();
-                auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-                
-                {
-                    std::lock_guard<std::mutex> lock(statsMutex_);
-                    stats_.documentsSaved++;
-                    if (std::filesystem::exists(filePath)) {
-                        stats_.bytesWritten += std::filesystem::file_size(filePath);
-                    }
-                    stats_.totalSaveTime += duration;
-                    stats_.formatUsageCount[format]++;
-                    stats_.formatProcessingTime[format] += duration;
-                }
-            }
-            
-            return success;
+            return saveDocumentAs(document, filePath, options);
         }
         catch (const std::exception& e) {
             ErrorInfo error;
@@ -621,50 +501,9 @@ std::future<bool> FileFormatManager::saveImage(
     const std::filesystem::path& filePath,
     const SaveOptions& options) {
     
-    return threadPool_->enqueue([this, image, filePath, options]() -> bool {
-        auto startTime = std::chrono::high_resolution_clock::now();
-        
+    return scheduler_->async([this, image, filePath, options]() -> bool {
         try {
-            if (!image) {
-                throw std::runtime_error("Image is null");
-            }
-            
-            // Determine format from file extension
-            std::string extension = FormatUtils::getFileExtension(filePath);
-            FileFormat format = detectFormatByExtension(extension);
-            
-            if (format == FileFormat::Unknown) {
-                throw std::runtime_error("Cannot determine output format from extension: " + extension);
-            }
-            
-            // Get handler
-            IFormatHandler* handler = getHandler(format);
-            if (!handler || !handler->canSave()) {
-                throw std::runtime_error("No handler available for saving format");
-            }
-            
-            // Save image
-            auto future = handler->saveImage(image, filePath, options);
-            bool success = future.get();
-            
-            if (success) {
-                // Update statistics
-                auto endTime = std::chrono::high_resolution_clock::now();
-                auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-                
-                {
-                    std::lock_guard<std::mutex> lock(statsMutex_);
-                    stats_.imagesSaved++;
-                    if (std::filesystem::exists(filePath)) {
-                        stats_.bytesWritten += std::filesystem::file_size(filePath);
-                    }
-                    stats_.totalSaveTime += duration;
-                    stats_.formatUsageCount[format]++;
-                    stats_.formatProcessingTime[format] += duration;
-                }
-            }
-            
-            return success;
+            return saveImageAs(image, filePath, options);
         }
         catch (const std::exception& e) {
             ErrorInfo error;
@@ -679,6 +518,444 @@ std::future<bool> FileFormatManager::saveImage(
     });
 }
 
+// Batch operations
+BatchStats FileFormatManager::processBatchLoad(std::vector<BatchLoadJob> jobs) {
+    std::vector<BatchEngine::Job> batch;
+    batch.reserve(jobs.size());
+    for (BatchLoadJob& job : jobs) {
+        auto promise = std::make_shared<std::promise<std::shared_ptr<Document>>>(std::move(job.promise));
+        BatchEngine::Job load;
+        load.inputPath = job.inputPath;
+        load.process = [this, filePath = job.inputPath, options = job.options, promise]
+                       (const std::shared_ptr<const ByteSource>& source) {
+            promise->set_value(loadMappedDocument(filePath, source, options));
+            return std::vector<uint8_t>();
+        };
+        load.onDone = [this, filePath = job.inputPath, promise](std::exception_ptr error) {
+            if (!error) return;
+            ErrorInfo info;
+            info.severity = ErrorInfo::Error;
+            info.message = "Failed to load document in batch";
+            info.filePath = filePath.string();
+            info.timestamp = std::chrono::system_clock::now();
+            logError(info);
+            promise->set_exception(error);
+        };
+        batch.push_back(std::move(load));
+    }
+    return batchEngine_->run(std::move(batch));
+}
+
+BatchStats FileFormatManager::processBatchSave(std::vector<BatchSaveJob> jobs) {
+    std::vector<BatchEngine::Job> batch;
+    batch.reserve(jobs.size());
+    for (BatchSaveJob& job : jobs) {
+        auto promise = std::make_shared<std::promise<bool>>(std::move(job.promise));
+        // Handlers write their own files, so the whole save is the process
+        // step; there is nothing for the I/O threads to read or write
+        BatchEngine::Job save;
+        save.process = [this, document = job.document, filePath = job.outputPath, options = job.options, promise]
+                       (const std::shared_ptr<const ByteSource>&) {
+            promise->set_value(saveDocumentAs(document, filePath, options));
+            return std::vector<uint8_t>();
+        };
+        save.onDone = [this, filePath = job.outputPath, promise](std::exception_ptr error) {
+            if (!error) return;
+            ErrorInfo info;
+            info.severity = ErrorInfo::Error;
+            info.message = "Failed to save document in batch";
+            info.filePath = filePath.string();
+            info.timestamp = std::chrono::system_clock::now();
+            logError(info);
+            promise->set_value(false);
+        };
+        batch.push_back(std::move(save));
+    }
+    return batchEngine_->run(std::move(batch));
+}
+
+// A one-job batch: the input is read on the engine's I/O threads, decoded
+// and re-encoded on the scheduler
+std::future<bool> FileFormatManager::convertFile(
+    const std::filesystem::path& inputPath,
+    const std::filesystem::path& outputPath,
+    const LoadOptions& loadOptions,
+    const SaveOptions& saveOptions) {
+    
+    auto promise = std::make_shared<std::promise<bool>>();
+    auto future = promise->get_future();
+    
+    BatchEngine::Job job;
+    job.inputPath = inputPath;
+    job.process = [this, inputPath, outputPath, loadOptions, saveOptions, promise]
+                  (const std::shared_ptr<const ByteSource>& source) {
+        auto image = loadMappedImage(inputPath, source, loadOptions);
+        if (!image) {
+            throw std::runtime_error("Nothing to convert in " + inputPath.string());
+        }
+        const bool success = saveImageAs(image, outputPath, saveOptions);
+        if (success) {
+            std::lock_guard<std::mutex> lock(statsMutex_);
+            stats_.conversionsPerformed++;
+        }
+        promise->set_value(success);
+        return std::vector<uint8_t>();
+    };
+    job.onDone = [this, inputPath, promise](std::exception_ptr error) {
+        if (!error) return;
+        ErrorInfo info;
+        info.severity = ErrorInfo::Error;
+        info.filePath = inputPath.string();
+        info.timestamp = std::chrono::system_clock::now();
+        try {
+            std::rethrow_exception(error);
+        }
+        catch (const std::exception& e) {
+            info.message = "Failed to convert file: " + std::string(e.what());
+        }
+        catch (...) {
+            info.message = "Failed to convert file";
+        }
+        logError(info);
+        promise->set_value(false);
+    };
+    
+    std::vector<BatchEngine::Job> jobs;
+    jobs.push_back(std::move(job));
+    batchEngine_->submit(std::move(jobs));
+    return future;
+}
+
+// Load and save steps shared by the single-file and batch paths
+std::shared_ptr<Document> FileFormatManager::loadMappedDocument(
+    const std::filesystem::path& filePath,
+    const std::shared_ptr<const ByteSource>& source,
+    const LoadOptions& options) {
+    
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    // Detect format
+    FormatDetectionResult detection = detectMappedFormat(filePath, source->bytes());
+    if (!detection.isSupported()) {
+        throw std::runtime_error("Unsupported file format: " + filePath.string());
+    }
+    
+    // Get handler
+    IFormatHandler* handler = getHandler(detection.format);
+    if (!handler) {
+        throw std::runtime_error("No handler available for format");
+    }
+    
+    // Load document
+    auto future = handler->loadDocument(source, options);
+    auto document = future.get();
+    
+    // Update statistics
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+    
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.documentsLoaded++;
+        stats_.bytesRead += source->size();
+        stats_.totalLoadTime += duration;
+        stats_.formatUsageCount[detection.format]++;
+        stats_.formatProcessingTime[detection.format] += duration;
+    }
+    
+    return document;
+}
+
+std::shared_ptr<Image> FileFormatManager::loadMappedImage(
+    const std::filesystem::path& filePath,
+    const std::shared_ptr<const ByteSource>& source,
+    const LoadOptions& options) {
+    
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    // Detect format
+    FormatDetectionResult detection = detectMappedFormat(filePath, source->bytes());
+    if (!detection.isSupported()) {
+        throw std::runtime_error("Unsupported file format: " + filePath.string());
+    }
+    
+    // Get handler
+    IFormatHandler* handler = getHandler(detection.format);
+    if (!handler) {
+        throw std::runtime_error("No handler available for format");
+    }
+    
+    // Load image
+    auto future = handler->loadImage(source, options);
+    auto image = future.get();
+    
+    // Update statistics
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+    
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.imagesLoaded++;
+        stats_.bytesRead += source->size();
+        stats_.totalLoadTime += duration;
+        stats_.formatUsageCount[detection.format]++;
+        stats_.formatProcessingTime[detection.format] += duration;
+    }
+    
+    return image;
+}
+
+bool FileFormatManager::saveDocumentAs(
+    const std::shared_ptr<Document>& document,
+    const std::filesystem::path& filePath,
+    const SaveOptions& options) {
+    
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    if (!document) {
+        throw std::runtime_error("Document is null");
+    }
+    
+    // Determine format from file extension
+    std::string extension = FormatUtils::getFileExtension(filePath);
+    FileFormat format = detectFormatByExtension(extension);
+    
+    if (format == FileFormat::Unknown) {
+        throw std::runtime_error("Cannot determine output format from extension: " + extension);
+    }
+    
+    // Get handler
+    IFormatHandler* handler = getHandler(format);
+    if (!handler || !handler->canSave()) {
+        throw std::runtime_error("No handler available for saving format");
+    }
+    
+    // Save document
+    auto future = handler->saveDocument(document, filePath, options);
+    bool success = future.get();
+    
+    if (success) {
+        // Update statistics
+        auto endTime = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+        
+        {
+            std::lock_guard<std::mutex> lock(statsMutex_);
+            stats_.documentsSaved++;
+            if (std::filesystem::exists(filePath)) {
+                stats_.bytesWritten += std::filesystem::file_size(filePath);
+            }
+            stats_.totalSaveTime += duration;
+            stats_.formatUsageCount[format]++;
+            stats_.formatProcessingTime[format] += duration;
+        }
+    }
+    
+    return success;
+}
+
+bool FileFormatManager::saveImageAs(
+    const std::shared_ptr<Image>& image,
+    const std::filesystem::path& filePath,
+    const SaveOptions& options) {
+    
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    if (!image) {
+        throw std::runtime_error("Image is null");
+    }
+    
+    // Determine format from file extension
+    std::string extension = FormatUtils::getFileExtension(filePath);
+    FileFormat format = detectFormatByExtension(extension);
+    
+    if (format == FileFormat::Unknown) {
+        throw std::runtime_error("Cannot determine output format from extension: " + extension);
+    }
+    
+    // Get handler
+    IFormatHandler* handler = getHandler(format);
+    if (!handler || !handler->canSave()) {
+        throw std::runtime_error("No handler available for saving format");
+    }
+    
+    // Save image
+    auto future = handler->saveImage(image, filePath, options);
+    bool success = future.get();
+    
+    if (success) {
+        // Update statistics
+        auto endTime = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+        
+        {
+            std::lock_guard<std::mutex> lock(statsMutex_);
+            stats_.imagesSaved++;
+            if (std::filesystem::exists(filePath)) {
+                stats_.bytesWritten += std::filesystem::file_size(filePath);
+            }
+            stats_.totalSaveTime += duration;
+            stats_.formatUsageCount[format]++;
+            stats_.formatProcessingTime[format] += duration;
+        }
+    }
+    
+    return success;
+}
+
+std::future<std::shared_ptr<Image>> FileFormatManager::generateThumbnail(
+    const std::filesystem::path& filePath,
+    const std::array<uint32_t, 2>& size) {
+    
+    return scheduler_->async([this, filePath, size]() -> std::shared_ptr<Image> {
+        auto thumbnail = thumbnails_->generate(filePath, size);
+        if (thumbnail) {
+            std::lock_guard<std::mutex> lock(statsMutex_);
+            stats_.thumbnailsGenerated++;
+        }
+        return thumbnail;
+    });
+}
+
+void FileFormatManager::prefetchThumbnails(
+    const std::vector<std::filesystem::path>& filePaths,
+    const std::array<uint32_t, 2>& size,
+    ThumbnailPipeline::ReadyCallback onReady) {
+    
+    if (!thumbnails_) return;
+    
+    thumbnails_->prefetch(filePaths, size,
+        [this, onReady = std::move(onReady)](const std::filesystem::path& filePath, std::shared_ptr<Image> thumbnail) {
+            if (thumbnail) {
+                std::lock_guard<std::mutex> lock(statsMutex_);
+                stats_.thumbnailsGenerated++;
+            }
+            if (onReady) {
+                onReady(filePath, std::move(thumbnail));
+            }
+        });
+}
+
+void FileFormatManager::cancelThumbnailPrefetch() {
+    if (thumbnails_) {
+        thumbnails_->cancelPrefetch();
+    }
+}
+
+void FileFormatManager::setThumbnailCacheDirectory(const std::filesystem::path& directory, uint64_t maxBytes) {
+    thumbnailCacheDirectory_ = directory;
+    thumbnailCacheBytes_ = maxBytes;
+}
+
+void FileFormatManager::createThumbnailPipeline() {
+    // Without a usable cache directory thumbnails are still generated, just
+    // not kept between calls
+    std::shared_ptr<ThumbnailCache> cache;
+    try {
+        std::filesystem::path directory = thumbnailCacheDirectory_;
+        if (directory.empty()) {
+            directory = std::filesystem::temp_directory_path() / "QuantumCanvas" / "thumbnails";
+        }
+        cache = std::make_shared<ThumbnailCache>(directory, thumbnailCacheBytes_);
+    }
+    catch (const std::exception& e) {
+        ErrorInfo error;
+        error.severity = ErrorInfo::Warning;
+        error.message = "Thumbnail cache disabled: " + std::string(e.what());
+        error.timestamp = std::chrono::system_clock::now();
+        logError(error);
+    }
+    
+    ThumbnailPipeline::Stages stages;
+    
+    // Previews of formats only their handler understands, such as QCSX
+    stages.embeddedPreview = [this](const std::shared_ptr<const ByteSource>& source,
+                                    const std::array<uint32_t, 2>& size) -> std::shared_ptr<Image> {
+        const IFormatHandler* handler = getHandler(detectByMagicBytes(source->bytes()).format);
+        return handler ? handler->extractThumbnail(source->bytes(), size) : nullptr;
+    };
+    
+    // Codecs that decode regions reduce while decoding; other formats are
+    // loaded at the thumbnail's target size by their handler
+    stages.reducedDecode = [this](const std::shared_ptr<const ByteSource>& source,
+                                  const std::array<uint32_t, 2>& size) -> std::shared_ptr<Image> {
+        const FormatDetectionResult detection = detectByMagicBytes(source->bytes());
+        IFormatHandler* handler = getHandler(detection.format);
+        if (!handler) {
+            return nullptr;
+        }
+        
+        IImageCodec* codec = ImageCodecRegistry::instance().getCodec(detection.format);
+        const std::array<uint32_t, 2> dimensions = handler->getFileInfo(source->bytes()).dimensions;
+        if (codec && codec->supportsRegionDecode() && dimensions[0] > 0 && dimensions[1] > 0) {
+            DecodeRegion region;
+            region.scaleDenominator = DecodeRegion::scaleForZoom(
+                std::min(float(size[0]) / float(dimensions[0]), float(size[1]) / float(dimensions[1])));
+            const auto outputSize = region.outputSize(dimensions);
+            auto image = std::make_shared<Image>(outputSize[0], outputSize[1]);
+            if (codec->decodeRegion(source->bytes(), region, *image)) {
+                return image;
+            }
+        }
+        
+        LoadOptions options;
+        options.targetSize = size;
+        return handler->loadImage(source, options).get();
+    };
+    
+    thumbnails_ = std::make_unique<ThumbnailPipeline>(std::move(cache), std::move(stages), scheduler_);
+}
+
+void FileFormatManager::createBatchEngine() {
+    // Files read ahead of decoding share the manager's memory budget
+    BatchEngine::Settings settings;
+    settings.memoryBudget = memoryBudget_;
+    batchEngine_ = std::make_unique<BatchEngine>(scheduler_, settings);
+}
+
+void FileFormatManager::createAssetCache() {
+    auto decode = [this](const std::shared_ptr<const ByteSource>& source) -> std::shared_ptr<Image> {
+        const FormatDetectionResult detection = detectByMagicBytes(source->bytes());
+        IFormatHandler* handler = getHandler(detection.format);
+        if (!handler) {
+            throw std::runtime_error("Unsupported asset format");
+        }
+        return handler->loadImage(source, LoadOptions()).get();
+    };
+    
+    // Assets are sampled, not painted into, so they go up as 8-bit RGBA
+    auto upload = [&engine = engine_](const Image& image) {
+        using Format = Rendering::TextureDescriptor::Format;
+        using Usage = Rendering::TextureDescriptor::Usage;
+        Rendering::TextureDescriptor desc;
+        desc.width = image.width();
+        desc.height = image.height();
+        desc.format = Format::RGBA8Unorm;
+        desc.usage = static_cast<uint32_t>(Usage::TextureBinding) | static_cast<uint32_t>(Usage::CopyDst);
+        
+        std::vector<uint8_t> texels(size_t(image.width()) * image.height() * Image::CHANNELS);
+        for (uint32_t y = 0; y < image.height(); ++y) {
+            uint8_t* row = texels.data() + size_t(y) * image.width() * Image::CHANNELS;
+            for (uint32_t x = 0; x < image.width(); ++x) {
+                const Image::Pixel pixel = image.getPixel(x, y);
+                for (uint32_t c = 0; c < Image::CHANNELS; ++c) {
+                    row[size_t(x) * Image::CHANNELS + c] =
+                        static_cast<uint8_t>(std::clamp(pixel[c], 0.0f, 1.0f) * 255.0f + 0.5f);
+                }
+            }
+        }
+        
+        DecodedAssetCache::Upload result;
+        result.id = engine.create_texture(desc, texels.data());
+        result.bytes = texels.size();
+        return result;
+    };
+    
+    auto release = [&engine = engine_](Rendering::ResourceId id) { engine.destroy_resource(id); };
+    
+    assets_ = std::make_unique<DecodedAssetCache>(std::move(decode), std::move(upload), std::move(release));
+}
+
 bool FileFormatManager::validateFile(const std::filesystem::path& filePath) const {
     try {
         if (!std::filesystem::exists(filePath) || !std::filesystem::is_regular_file(filePath)) {
@@ -708,6 +985,30 @@ void FileFormatManager::resetStats() {
     stats_ = FileFormatStats{};
 }
 
+namespace {
+
+void writeTelemetry(const FileFormatManager::FileFormatStats& stats, Core::MetricWriter& writer) {
+    writer.counter("documents_loaded", stats.documentsLoaded);
+    writer.counter("documents_saved", stats.documentsSaved);
+    writer.counter("images_loaded", stats.imagesLoaded);
+    writer.counter("images_saved", stats.imagesSaved);
+    writer.counter("conversions", stats.conversionsPerformed);
+    writer.counter("thumbnails_generated", stats.thumbnailsGenerated);
+    writer.counter("bytes_read", stats.bytesRead);
+    writer.counter("bytes_written", stats.bytesWritten);
+    writer.counter("load_us", static_cast<uint64_t>(stats.totalLoadTime.count()));
+    writer.counter("save_us", static_cast<uint64_t>(stats.totalSaveTime.count()));
+    writer.counter("cache_hits", stats.cacheHits);
+    writer.counter("cache_misses", stats.cacheMisses);
+}
+
+} // namespace
+
+void FileFormatManager::registerTelemetry() {
+    telemetrySource_ = Core::Telemetry::instance().add_stats_source(
+        "io.formats", *this, &FileFormatManager::getStats, writeTelemetry);
+}
+
 std::vector<FileFormatManager::ErrorInfo> FileFormatManager::getRecentErrors() const {
     std::lock_guard<std::mutex> lock(errorMutex_);
     return errorLog_;
@@ -720,9 +1021,10 @@ void FileFormatManager::clearErrorLog() {
 
 // Private implementation methods
 void FileFormatManager::registerBuiltInHandlers() {
-    // TODO: Register built-in format handlers
-    // This would be implemented with actual format handlers
-    // For now, we'll have placeholder implementations
+    // Raster images go through ImageCodecRegistry rather than a handler.
+    // The vector and CAD handlers (SVG, AI, PDF, DWG) are only declared so
+    // far; they are registered here once they are implemented.
+    registerHandler(std::make_unique<QCSXHandler>(engine_));
 }
 
 void FileFormatManager::buildExtensionMap() {
@@ -821,10 +1123,13 @@ void FileFormatManager::initializeMagicPatterns() {
     // ICO: \0\0\1\0
     magicPatterns_.push_back({{0x00, 0x00, 0x01, 0x00}, {}, 0, FileFormat::ICO, 1.0f});
     
+    // QCSX: QCSX\r\n\x1a\n
+    magicPatterns_.push_back({{'Q', 'C', 'S', 'X', 0x0D, 0x0A, 0x1A, 0x0A}, {}, 0, FileFormat::QCSX, 1.0f});
+    
     // Add more patterns as needed...
 }
 
-FormatDetectionResult FileFormatManager::detectByMagicBytes(const std::vector<uint8_t>& data) const {
+FormatDetectionResult FileFormatManager::detectByMagicBytes(ByteSpan data) const {
     for (const auto& pattern : magicPatterns_) {
         if (data.size() < pattern.offset + pattern.pattern.size()) {
             continue;
@@ -861,23 +1166,41 @@ FormatDetectionResult FileFormatManager::detectByMagicBytes(const std::vector<ui
 }
 
 FormatDetectionResult FileFormatManager::detectByContent(const std::filesystem::path& filePath) const {
+    ByteSource source;
     try {
-        std::ifstream file(filePath, std::ios::binary);
-        if (!file) {
-            return FormatDetectionResult{FileFormat::Unknown, 0.0f, "", {}, "cannot_open_file"};
-        }
-        
-        // Read first 64 bytes for magic byte detection
-        std::vector<uint8_t> buffer(64);
-        file.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
-        size_t bytesRead = file.gcount();
-        buffer.resize(bytesRead);
-        
-        return detectByMagicBytes(buffer);
+        source = ByteSource::open(filePath, ByteSource::Access::Random);
     }
     catch (const std::exception& e) {
-        return FormatDetectionResult{FileFormat::Unknown, 0.0f, "", {}, "content_detection_error"};
+        return FormatDetectionResult{FileFormat::Unknown, 0.0f, "", {}, "cannot_open_file"};
     }
+    
+    // Magic bytes sit in the first 64 bytes; only that page is read
+    return detectByMagicBytes(source.subspan(0, 64));
+}
+
+FormatDetectionResult FileFormatManager::detectByExtension(const std::filesystem::path& filePath) const {
+    std::string extension = FormatUtils::getFileExtension(filePath);
+    FileFormat formatByExt = detectFormatByExtension(extension);
+    if (formatByExt == FileFormat::Unknown) {
+        return FormatDetectionResult{FileFormat::Unknown, 0.0f, "", {}, "unknown_extension"};
+    }
+    
+    FormatDetectionResult result;
+    result.format = formatByExt;
+    result.confidence = 0.7f;  // Medium confidence for extension-based detection
+    result.detectionMethod = "extension";
+    result.possibleExtensions.push_back(extension);
+    return result;
+}
+
+FormatDetectionResult FileFormatManager::detectMappedFormat(const std::filesystem::path& filePath,
+                                                            ByteSpan data) const {
+    FormatDetectionResult result = detectByExtension(filePath);
+    if (result.isSupported()) {
+        return result;
+    }
+    
+    return detectFormat(data);
 }
 
 void FileFormatManager::updateCache(const std::string& filePath, const FileInfo& info,
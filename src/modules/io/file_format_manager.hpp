@@ -2,6 +2,12 @@
 
 #include "../../core/rendering/rendering_engine.hpp"
 #include "../../core/memory/memory_manager.hpp"
+#include "../../core/kernel/telemetry.hpp"
+#include "../raster/raster_image.hpp"
+#include "asset_cache.hpp"
+#include "batch_engine.hpp"
+#include "byte_source.hpp"
+#include "thumbnail_pipeline.hpp"
 #include <memory>
 #include <vector>
 #include <unordered_map>
@@ -14,14 +20,20 @@
 #include <chrono>
 #include <variant>
 
+namespace QuantumCanvas::Core {
+class TaskScheduler;
+}
+
 namespace QuantumCanvas::IO {
 
 // Forward declarations
 class Document;
-class Image;
 class VectorPath;
 class Layer;
 
+// Codecs decode into and encode from the raster module's tiled image
+using Image = Raster::Image;
+
 // Supported file formats
 enum class FileFormat {
     // Raster formats
@@ -197,6 +209,10 @@ struct SaveOptions {
     bool preserveMetadata = true;
     bool stripPersonalMetadata = false;
     
+    // Encode bands concurrently on the task scheduler where the format
+    // allows it: PNG, baseline JPEG, and Deflate or uncompressed TIFF
+    bool parallelEncode = true;
+    
     // Format-specific options
     struct PNGOptions {
         uint8_t compressionLevel = 6;  // 0-9
@@ -231,6 +247,7 @@ struct SaveOptions {
         bool saveHistory = false;
         bool savePreview = true;
         std::array<uint32_t, 2> previewSize{256, 256};
+        bool incrementalSave = true;  // Append changed tiles when saving over the opened file
     } qcsxOptions;
     
     // Progress callback
@@ -288,12 +305,14 @@ public:
     virtual std::vector<std::string> getMimeTypes() const = 0;
     virtual FormatCapabilities getCapabilities() const = 0;
     
-    // Format detection
+    // Format detection. Byte overloads read the manager's mapping of the
+    // file in place; the span is only valid for the duration of the call.
     virtual FormatDetectionResult detectFormat(const std::filesystem::path& filePath) const = 0;
-    virtual FormatDetectionResult detectFormat(const std::vector<uint8_t>& data) const = 0;
+    virtual FormatDetectionResult detectFormat(ByteSpan data) const = 0;
     
-    // File information
+    // File information; should parse no further than the header
     virtual FileInfo getFileInfo(const std::filesystem::path& filePath) const = 0;
+    virtual FileInfo getFileInfo(ByteSpan data) const = 0;
     
     // Load operations
     virtual std::future<std::shared_ptr<Document>> loadDocument(
@@ -304,6 +323,16 @@ public:
         const std::filesystem::path& filePath,
         const LoadOptions& options) = 0;
     
+    // Loads from an already mapped file; the shared source keeps the mapping
+    // alive until the load completes
+    virtual std::future<std::shared_ptr<Document>> loadDocument(
+        std::shared_ptr<const ByteSource> source,
+        const LoadOptions& options) = 0;
+    
+    virtual std::future<std::shared_ptr<Image>> loadImage(
+        std::shared_ptr<const ByteSource> source,
+        const LoadOptions& options) = 0;
+    
     // Save operations
     virtual std::future<bool> saveDocument(
         const std::shared_ptr<Document>& document,
@@ -315,6 +344,12 @@ public:
         const std::filesystem::path& filePath,
         const SaveOptions& options) = 0;
     
+    // Preview stored in the file for formats the thumbnail pipeline cannot
+    // read previews from itself; null when there is none
+    virtual std::shared_ptr<Image> extractThumbnail(ByteSpan data, const std::array<uint32_t, 2>& size) const {
+        return nullptr;
+    }
+    
     // Validation
     virtual bool validateFile(const std::filesystem::path& filePath) const = 0;
     virtual bool canLoad() const = 0;
@@ -346,7 +381,7 @@ public:
     
     // Format detection
     FormatDetectionResult detectFormat(const std::filesystem::path& filePath) const;
-    FormatDetectionResult detectFormat(const std::vector<uint8_t>& data) const;
+    FormatDetectionResult detectFormat(ByteSpan data) const;
     FileFormat detectFormatByExtension(const std::string& extension) const;
     std::vector<FileFormat> getSupportedFormats() const;
     
@@ -390,8 +425,11 @@ public:
         std::promise<bool> promise;
     };
     
-    void processBatchLoad(const std::vector<BatchLoadJob>& jobs);
-    void processBatchSave(const std::vector<BatchSaveJob>& jobs);
+    // Files are read on the batch engine's I/O threads, largest first within
+    // the memory budget, and decoded or encoded on the scheduler. Each job's
+    // promise is fulfilled as it finishes; the call returns once all have.
+    BatchStats processBatchLoad(std::vector<BatchLoadJob> jobs);
+    BatchStats processBatchSave(std::vector<BatchSaveJob> jobs);
     
     // Format conversion
     std::future<bool> convertFile(
@@ -400,11 +438,30 @@ public:
         const LoadOptions& loadOptions = {},
         const SaveOptions& saveOptions = {});
     
-    // Thumbnail generation
+    // Thumbnail generation, through the content-keyed disk cache, embedded
+    // previews and reduced decodes (see ThumbnailPipeline); null when the
+    // file has no thumbnail
     std::future<std::shared_ptr<Image>> generateThumbnail(
         const std::filesystem::path& filePath,
         const std::array<uint32_t, 2>& size = {256, 256});
     
+    // Queues thumbnails for the files a browser shows, in order, replacing
+    // the previous list; onReady runs on a worker as each one completes
+    void prefetchThumbnails(
+        const std::vector<std::filesystem::path>& filePaths,
+        const std::array<uint32_t, 2>& size = {256, 256},
+        ThumbnailPipeline::ReadyCallback onReady = {});
+    void cancelThumbnailPrefetch();
+    
+    // Takes effect on the next initialize()
+    void setThumbnailCacheDirectory(const std::filesystem::path& directory,
+                                    uint64_t maxBytes = 256ull * 1024 * 1024);
+    const std::filesystem::path& getThumbnailCacheDirectory() const { return thumbnailCacheDirectory_; }
+    
+    // Decoded images and textures shared by brushes, pattern fills and placed
+    // images across documents (see DecodedAssetCache); null until initialize()
+    DecodedAssetCache* getAssetCache() const { return assets_.get(); }
+    
     // File validation
     bool validateFile(const std::filesystem::path& filePath) const;
     std::vector<std::string> validateFiles(const std::vector<std::filesystem::path>& filePaths) const;
@@ -439,7 +496,8 @@ public:
     void unloadFormatPlugin(const std::string& pluginName);
     std::vector<std::string> getLoadedPlugins() const;
     
-    // Performance settings
+    // Performance settings. Only sizes the private scheduler used when the
+    // kernel has none registered; takes effect on the next initialize().
     void setMaxConcurrency(uint32_t maxThreads) { maxConcurrency_ = maxThreads; }
     uint32_t getMaxConcurrency() const { return maxConcurrency_; }
     
@@ -452,7 +510,7 @@ public:
     // Statistics
     struct FileFormatStats {
         uint32_t documentsLoaded = 0;
-        uint32_t documentsLoaded = 0;
+        uint32_t documentsSaved = 0;
         uint32_t imagesLoaded = 0;
         uint32_t imagesSaved = 0;
         uint32_t conversionsPerformed = 0;
@@ -515,9 +573,19 @@ private:
     size_t memoryBudget_ = 2LL * 1024 * 1024 * 1024;  // 2GB default
     bool cacheEnabled_ = true;
     
-    // Thread pool for async operations
-    class ThreadPool;
-    std::unique_ptr<ThreadPool> threadPool_;
+    // Scheduler for async operations, shared with the kernel when available
+    std::shared_ptr<Core::TaskScheduler> scheduler_;
+    
+    // Thumbnails; the pipeline's stages call back into this manager
+    std::filesystem::path thumbnailCacheDirectory_;  // Empty = QuantumCanvas/thumbnails in the temp directory
+    uint64_t thumbnailCacheBytes_ = 256ull * 1024 * 1024;
+    std::unique_ptr<ThumbnailPipeline> thumbnails_;
+    
+    // Batch loads, saves and conversions
+    std::unique_ptr<BatchEngine> batchEngine_;
+    
+    // Shared decoded assets; the decoder calls back into this manager
+    std::unique_ptr<DecodedAssetCache> assets_;
     
     // Cache for thumbnails and metadata
     struct CacheEntry {
@@ -543,13 +611,31 @@ private:
     size_t maxErrorLogSize_ = 1000;
     
     // Internal methods
+    std::shared_ptr<Document> loadMappedDocument(const std::filesystem::path& filePath,
+                                                 const std::shared_ptr<const ByteSource>& source,
+                                                 const LoadOptions& options);
+    std::shared_ptr<Image> loadMappedImage(const std::filesystem::path& filePath,
+                                           const std::shared_ptr<const ByteSource>& source,
+                                           const LoadOptions& options);
+    bool saveDocumentAs(const std::shared_ptr<Document>& document,
+                        const std::filesystem::path& filePath, const SaveOptions& options);
+    bool saveImageAs(const std::shared_ptr<Image>& image,
+                     const std::filesystem::path& filePath, const SaveOptions& options);
     void registerBuiltInHandlers();
     void buildExtensionMap();
     void createDefaultPresets();
+    void createThumbnailPipeline();
+    void createBatchEngine();
+    void createAssetCache();
     
-    FormatDetectionResult detectByMagicBytes(const std::vector<uint8_t>& data) const;
+    FormatDetectionResult detectByMagicBytes(ByteSpan data) const;
     FormatDetectionResult detectByContent(const std::filesystem::path& filePath) const;
     
+    FormatDetectionResult detectByExtension(const std::filesystem::path& filePath) const;
+    
+    // Extension first, then the magic bytes of the mapped file
+    FormatDetectionResult detectMappedFormat(const std::filesystem::path& filePath, ByteSpan data) const;
+    
     void updateCache(const std::string& filePath, const FileInfo& info, 
                     std::shared_ptr<Image> thumbnail = nullptr);
     void cleanupCache();
@@ -568,6 +654,9 @@ private:
     std::vector<MagicPattern> magicPatterns_;
     void initializeMagicPatterns();
     
+    Core::Telemetry::SourceRegistration telemetrySource_;
+    void registerTelemetry();
+    
     // Format name mapping
     static std::unordered_map<FileFormat, std::string> formatNames_;
     static void initializeFormatNames();
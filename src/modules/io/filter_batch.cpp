@@ -0,0 +1,196 @@
+#include "filter_batch.hpp"
+#include "batch_engine.hpp"
+#include "../../core/kernel/task_scheduler.hpp"
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+
+namespace QuantumCanvas::IO {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Bilinear resample, sampling the way FilterProcessor::generatePreview does
+Raster::Image resampleImage(const Raster::Image& input, const std::array<uint32_t, 2>& size) {
+    Raster::Image result(size[0], size[1], input.fillColor());
+
+    float scaleX = static_cast<float>(input.width()) / size[0];
+    float scaleY = static_cast<float>(input.height()) / size[1];
+
+    Core::parallel_for(0, size[1], 16, [&](size_t y) {
+        for (uint32_t x = 0; x < size[0]; ++x) {
+            result.setPixel(x, static_cast<uint32_t>(y), input.sampleBilinear(x * scaleX, y * scaleY));
+        }
+    });
+
+    return result;
+}
+
+// Thrown by a job's process step that finds the batch cancelled, so the
+// engine writes nothing for it
+struct JobCancelled {};
+
+} // namespace
+
+// FilterBatch
+FilterBatch::FilterBatch(Raster::FilterProcessor& processor, CodecLookup codecs)
+    : processor_(processor)
+    , codecs_(std::move(codecs)) {
+    if (!codecs_) {
+        codecs_ = [](const std::filesystem::path& path) {
+            auto& registry = ImageCodecRegistry::instance();
+            return registry.getCodec(registry.detectFormat(path));
+        };
+    }
+}
+
+FilterBatchStats FilterBatch::run(const std::vector<FilterBatchJob>& jobs, ProgressCallback progress,
+                                  const std::atomic<bool>* cancel) {
+    FilterBatchStats stats;
+    if (!processor_.isInitialized()) {
+        return stats;
+    }
+
+    std::cout << "[FilterBatch] Processing batch of " << jobs.size() << " jobs" << std::endl;
+
+    std::mutex statsMutex;
+    std::atomic<uint32_t> decodedJobs{0};
+
+    auto scheduler = Core::KernelManager::instance().get_service<Core::TaskScheduler>();
+    const bool parallel = scheduler && processor_.getMaxConcurrency() > 1;
+    BatchEngine::Settings settings;
+    settings.memoryBudget = processor_.getMemoryBudget();
+    if (!parallel) {
+        settings.ioThreads = 1;
+    }
+    BatchEngine engine(parallel ? scheduler : nullptr, settings);
+
+    auto recordStage = [&](FilterBatchStageStats FilterBatchStats::*stage, const Raster::Image& image,
+                           Clock::time_point start) {
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+        std::lock_guard<std::mutex> lock(statsMutex);
+        FilterBatchStageStats& stageStats = stats.*stage;
+        stageStats.items++;
+        stageStats.pixels += static_cast<uint64_t>(image.width()) * image.height();
+        stageStats.busyTime += duration;
+    };
+
+    auto report = [&](size_t jobIndex, FilterBatchStatus status, const std::string& message) {
+        {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            switch (status) {
+                case FilterBatchStatus::Succeeded: stats.jobsSucceeded++; break;
+                case FilterBatchStatus::Failed:    stats.jobsFailed++;    break;
+                case FilterBatchStatus::Skipped:   stats.jobsSkipped++;   break;
+                case FilterBatchStatus::Cancelled: stats.jobsCancelled++; break;
+            }
+        }
+        if (progress) {
+            progress(jobIndex, status, message);
+        }
+    };
+
+    // Decode from the mapped input, filter, encode to the bytes the engine writes
+    auto processJob = [&](const FilterBatchJob& job, const ByteSource& input) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) {
+            throw JobCancelled{};
+        }
+
+        auto stageStart = Clock::now();
+        IImageCodec* decoder = codecs_(job.inputPath);
+        std::shared_ptr<Raster::Image> decoded = decoder && decoder->canDecode() ? decoder->decode(input.bytes()) : nullptr;
+        if (!decoded) {
+            throw std::runtime_error("Failed to decode " + job.inputPath);
+        }
+        recordStage(&FilterBatchStats::decode, *decoded, stageStart);
+
+        const uint32_t open = ++decodedJobs;
+        {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            stats.peakInFlightJobs = std::max(stats.peakInFlightJobs, open);
+        }
+
+        std::vector<uint8_t> encoded;
+        try {
+            stageStart = Clock::now();
+            auto output = std::make_shared<Raster::Image>();
+            {
+                bool resize = job.outputSize[0] > 0 && job.outputSize[1] > 0 && job.outputSize != decoded->getSize();
+                Raster::Image filterInput = resize ? resampleImage(*decoded, job.outputSize) : *decoded;
+                decoded.reset();
+
+                if (!processor_.applyFilterChain(job.filterChain, filterInput, *output)) {
+                    throw std::runtime_error("Filter application failed");
+                }
+            }
+            recordStage(&FilterBatchStats::filter, *output, stageStart);
+
+            // The output doesn't exist yet, so its format comes from the extension
+            stageStart = Clock::now();
+            IImageCodec* encoder = codecs_(job.outputPath);
+            if (!encoder || !encoder->canEncode()) {
+                throw std::runtime_error("No encoder for " + job.outputPath);
+            }
+            encoded = encoder->encode(output);
+            if (encoded.empty()) {
+                throw std::runtime_error("Failed to encode " + job.outputPath);
+            }
+            recordStage(&FilterBatchStats::encode, *output, stageStart);
+        } catch (...) {
+            --decodedJobs;
+            throw;
+        }
+        --decodedJobs;
+        return encoded;
+    };
+
+    std::vector<BatchEngine::Job> batch;
+    batch.reserve(jobs.size());
+    for (size_t jobIndex = 0; jobIndex < jobs.size(); ++jobIndex) {
+        const FilterBatchJob& job = jobs[jobIndex];
+        if (!job.overwriteExisting && std::filesystem::exists(job.outputPath)) {
+            report(jobIndex, FilterBatchStatus::Skipped, "Skipped: output exists");
+            continue;
+        }
+
+        BatchEngine::Job filter;
+        filter.inputPath = job.inputPath;
+        filter.outputPath = job.outputPath;
+        std::error_code error;
+        const auto inputSize = std::filesystem::file_size(job.inputPath, error);
+        filter.cost = error ? 0 : std::max<uint64_t>(inputSize, 1) * DECODE_EXPANSION;
+        filter.process = [&processJob, &job](const std::shared_ptr<const ByteSource>& input) {
+            return processJob(job, *input);
+        };
+        filter.onDone = [&report, jobIndex](std::exception_ptr error) {
+            if (!error) {
+                report(jobIndex, FilterBatchStatus::Succeeded, {});
+                return;
+            }
+            try {
+                std::rethrow_exception(error);
+            } catch (const JobCancelled&) {
+                report(jobIndex, FilterBatchStatus::Cancelled, "Cancelled");
+            } catch (const std::exception& e) {
+                report(jobIndex, FilterBatchStatus::Failed, e.what());
+            } catch (...) {
+                report(jobIndex, FilterBatchStatus::Failed, "Unknown error");
+            }
+        };
+        batch.push_back(std::move(filter));
+    }
+
+    const BatchStats engineStats = engine.run(std::move(batch));
+    stats.peakInFlightBytes = engineStats.peakBytesInFlight;
+    stats.wallTime = engineStats.elapsed;
+
+    std::cout << "[FilterBatch] Batch processing complete: " << stats.jobsSucceeded << " succeeded, "
+              << stats.jobsFailed << " failed, " << stats.jobsSkipped << " skipped, "
+              << stats.jobsCancelled << " cancelled; decode " << stats.decode.itemsPerSecond()
+              << "/s, filter " << stats.filter.itemsPerSecond() << "/s, encode "
+              << stats.encode.itemsPerSecond() << "/s per thread" << std::endl;
+    return stats;
+}
+
+} // namespace QuantumCanvas::IO
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "image_codecs.hpp"
+#include "../raster/filter_processor.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace QuantumCanvas::IO {
+
+enum class FilterBatchStatus {
+    Succeeded,
+    Failed,
+    Skipped,    // Output existed and overwriteExisting was off
+    Cancelled   // Not decoded before the batch was cancelled
+};
+
+struct FilterBatchJob {
+    std::string inputPath;
+    std::string outputPath;
+    Raster::FilterChain filterChain;
+    std::array<uint32_t, 2> outputSize{0, 0};  // 0,0 = keep original size
+    bool overwriteExisting = false;
+};
+
+struct FilterBatchStageStats {
+    uint64_t items = 0;
+    uint64_t pixels = 0;
+    std::chrono::microseconds busyTime{0};  // Summed over threads
+
+    double itemsPerSecond() const {
+        return busyTime.count() > 0 ? items * 1e6 / static_cast<double>(busyTime.count()) : 0.0;
+    }
+    double megapixelsPerSecond() const {
+        return busyTime.count() > 0 ? static_cast<double>(pixels) / static_cast<double>(busyTime.count()) : 0.0;
+    }
+};
+
+struct FilterBatchStats {
+    FilterBatchStageStats decode;
+    FilterBatchStageStats filter;
+    FilterBatchStageStats encode;
+    uint32_t jobsSucceeded = 0;
+    uint32_t jobsFailed = 0;
+    uint32_t jobsSkipped = 0;
+    uint32_t jobsCancelled = 0;
+    size_t peakInFlightBytes = 0;  // As the batch engine charged them
+    uint32_t peakInFlightJobs = 0;   // Between decode and encode at once
+    std::chrono::microseconds wallTime{0};
+};
+
+// Decodes, filters through a Raster::FilterProcessor and encodes every job,
+// as a BatchEngine batch: inputs are read and outputs written on the
+// engine's I/O threads, and each job's process step decodes from the mapped
+// input, filters and encodes to bytes on the shared scheduler. The engine
+// starts the largest inputs first while their estimated decoded size fits
+// the processor's memory budget. A processor with a concurrency of 1 runs
+// the jobs one at a time on a single I/O thread.
+class FilterBatch final {
+public:
+    // Codec for a path; the default asks ImageCodecRegistry by the path's format
+    using CodecLookup = std::function<IImageCodec*(const std::filesystem::path& path)>;
+    // Runs on worker threads, once per job
+    using ProgressCallback = std::function<void(size_t jobIndex, FilterBatchStatus status, const std::string& message)>;
+
+    explicit FilterBatch(Raster::FilterProcessor& processor, CodecLookup codecs = nullptr);
+
+    // Returns once every job has finished. Jobs whose output exists are
+    // skipped before anything is read. After cancel is set, jobs not yet
+    // decoded finish as Cancelled; running ones complete.
+    FilterBatchStats run(const std::vector<FilterBatchJob>& jobs, ProgressCallback progress = nullptr,
+                         const std::atomic<bool>* cancel = nullptr);
+
+    // Inputs are charged this many times their file size against the
+    // budget, since an image decodes to several times its compressed size
+    static constexpr uint64_t DECODE_EXPANSION = 8;
+
+private:
+    Raster::FilterProcessor& processor_;
+    CodecLookup codecs_;
+};
+
+} // namespace QuantumCanvas::IO
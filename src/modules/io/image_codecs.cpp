@@ -0,0 +1,84 @@
+#include "image_codecs.hpp"
+
+namespace QuantumCanvas::IO {
+
+// IImageCodec defaults
+
+bool IImageCodec::decodeRegion(ByteSpan data, const DecodeRegion& region, Image& target,
+                               const LoadOptions& options) {
+    // Without a native region decoder, decode everything and reduce it
+    std::shared_ptr<Image> decoded = decode(data, options);
+    if (!decoded) {
+        return false;
+    }
+    
+    RegionDecodeSink sink(target, region, decoded->getSize(), Image::CHANNELS,
+                          RegionDecodeSink::SampleType::Float32);
+    sink.writeImage(*decoded);
+    return true;
+}
+
+// Sampled size estimates
+
+size_t PNGCodec::estimateFileSize(const std::shared_ptr<Image>& image, float quality) const {
+    if (!image || image->empty()) {
+        return 0;
+    }
+    return ParallelEncoders::estimatePNGSize(*image, CodecUtils::parallelEncodeSettings(FileFormat::PNG, {}));
+}
+
+size_t JPEGCodec::estimateFileSize(const std::shared_ptr<Image>& image, float quality) const {
+    if (!image || image->empty()) {
+        return 0;
+    }
+    SaveOptions options;
+    options.quality = quality;
+    return ParallelEncoders::estimateJPEGSize(*image, CodecUtils::parallelEncodeSettings(FileFormat::JPEG, options));
+}
+
+size_t TIFFCodec::estimateFileSize(const std::shared_ptr<Image>& image, float quality) const {
+    if (!image || image->empty()) {
+        return 0;
+    }
+    SaveOptions options;
+    options.compression = FormatCapabilities::CompressionSettings::ZIP;
+    return ParallelEncoders::estimateTIFFSize(*image, CodecUtils::parallelEncodeSettings(FileFormat::TIFF, options));
+}
+
+// CodecUtils
+
+bool CodecUtils::canEncodeInParallel(FileFormat format, const SaveOptions& options) {
+    if (!options.parallelEncode) {
+        return false;
+    }
+    
+    switch (format) {
+        case FileFormat::PNG:
+            return !options.pngOptions.interlaced;
+        case FileFormat::JPEG:
+            return !options.jpegOptions.progressive && options.jpegOptions.smoothing == 0;
+        case FileFormat::TIFF:
+            return !options.tiffOptions.bigTiff &&
+                   (options.compression == FormatCapabilities::CompressionSettings::None ||
+                    options.compression == FormatCapabilities::CompressionSettings::ZIP);
+        default:
+            return false;
+    }
+}
+
+ParallelEncodeSettings CodecUtils::parallelEncodeSettings(FileFormat format, const SaveOptions& options) {
+    ParallelEncodeSettings settings;
+    settings.quality = options.quality;
+    settings.tiffTiled = options.tiffOptions.tiled;
+    settings.tiffTileSize = options.tiffOptions.tileSize;
+    settings.tiffPredictor = options.tiffOptions.predictor;
+    if (format == FileFormat::TIFF) {
+        settings.compressionLevel = options.compression == FormatCapabilities::CompressionSettings::ZIP ? 6 : 0;
+    }
+    else {
+        settings.compressionLevel = options.pngOptions.compressionLevel;
+    }
+    return settings;  // Null scheduler: the kernel's shared one
+}
+
+} // namespace QuantumCanvas::IO
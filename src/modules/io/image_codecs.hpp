@@ -1,6 +1,8 @@
 #pragma once
 
 #include "file_format_manager.hpp"
+#include "parallel_encoders.hpp"
+#include "region_decode.hpp"
 #include "../../core/memory/memory_manager.hpp"
 #include <memory>
 #include <vector>
@@ -11,9 +13,6 @@
 
 namespace QuantumCanvas::IO {
 
-// Forward declarations
-class Image;
-
 // Image codec interface for different formats
 class IImageCodec {
 public:
@@ -41,17 +40,31 @@ public:
     
     // Format detection
     virtual bool canDecodeFile(const std::filesystem::path& filePath) const = 0;
-    virtual bool canDecodeData(const std::vector<uint8_t>& data) const = 0;
+    virtual bool canDecodeData(ByteSpan data) const = 0;
     
-    // Decoding
+    // Decoding. Codecs read the bytes in place, typically straight from a
+    // ByteSource mapping; decoding a path maps the file and decodes that.
+    // Decoded images never refer back to the bytes.
     virtual std::shared_ptr<Image> decode(
         const std::filesystem::path& filePath,
         const LoadOptions& options = {}) = 0;
     
     virtual std::shared_ptr<Image> decode(
-        const std::vector<uint8_t>& data,
+        ByteSpan data,
         const LoadOptions& options = {}) = 0;
     
+    // Region-of-interest decoding. Decodes region of the source into target,
+    // writing its tiles directly through a RegionDecodeSink; target must
+    // already be sized to hold the output. Codecs with a native region
+    // decoder touch only what the region needs; the default decodes the
+    // whole image and reduces it.
+    virtual bool supportsRegionDecode() const { return false; }
+    virtual bool decodeRegion(
+        ByteSpan data,
+        const DecodeRegion& region,
+        Image& target,
+        const LoadOptions& options = {});
+    
     // Encoding
     virtual std::vector<uint8_t> encode(
         const std::shared_ptr<Image>& image,
@@ -67,7 +80,8 @@ public:
     virtual bool supportsStreamingEncode() const { return false; }
     
     // Quality estimation for lossy formats
-    virtual float estimateQuality(const std::vector<uint8_t>& data) const { return 1.0f; }
+    virtual float estimateQuality(ByteSpan data) const { return 1.0f; }
+    // Expected encoded size, from a sample of the image rather than a trial encode
     virtual size_t estimateFileSize(const std::shared_ptr<Image>& image, float quality) const = 0;
 };
 
@@ -94,13 +108,21 @@ public:
     std::vector<uint8_t> getSupportedChannelCounts() const override { return {1, 2, 3, 4}; }
     
     bool canDecodeFile(const std::filesystem::path& filePath) const override;
-    bool canDecodeData(const std::vector<uint8_t>& data) const override;
+    bool canDecodeData(ByteSpan data) const override;
     
     std::shared_ptr<Image> decode(const std::filesystem::path& filePath, 
                                  const LoadOptions& options = {}) override;
-    std::shared_ptr<Image> decode(const std::vector<uint8_t>& data,
+    std::shared_ptr<Image> decode(ByteSpan data,
                                  const LoadOptions& options = {}) override;
     
+    // Row bands through libpng, stopping after the region's last row;
+    // interlaced files are decoded whole
+    bool supportsRegionDecode() const override { return true; }
+    bool decodeRegion(ByteSpan data, const DecodeRegion& region, Image& target,
+                      const LoadOptions& options = {}) override;
+    
+    // Row bands deflated concurrently (ParallelEncoders::encodePNG) unless
+    // interlaced or parallelEncode is off, which go through libpng
     std::vector<uint8_t> encode(const std::shared_ptr<Image>& image,
                                const SaveOptions& options = {}) override;
     bool encode(const std::shared_ptr<Image>& image,
@@ -165,20 +187,29 @@ public:
     std::vector<uint8_t> getSupportedChannelCounts() const override { return {1, 3}; }
     
     bool canDecodeFile(const std::filesystem::path& filePath) const override;
-    bool canDecodeData(const std::vector<uint8_t>& data) const override;
+    bool canDecodeData(ByteSpan data) const override;
     
     std::shared_ptr<Image> decode(const std::filesystem::path& filePath,
                                  const LoadOptions& options = {}) override;
-    std::shared_ptr<Image> decode(const std::vector<uint8_t>& data,
+    std::shared_ptr<Image> decode(ByteSpan data,
                                  const LoadOptions& options = {}) override;
     
+    // Decodes in the DCT domain at the largest of 1/2, 1/4 and 1/8 that
+    // divides the scale, cropping scanlines and skipping rows outside the region
+    bool supportsRegionDecode() const override { return true; }
+    bool decodeRegion(ByteSpan data, const DecodeRegion& region, Image& target,
+                      const LoadOptions& options = {}) override;
+    
+    // Bands of MCU rows encoded concurrently (ParallelEncoders::encodeJPEG)
+    // with standard Huffman tables; progressive output, or parallelEncode
+    // off, is a single libjpeg pass honouring optimizeHuffman
     std::vector<uint8_t> encode(const std::shared_ptr<Image>& image,
                                const SaveOptions& options = {}) override;
     bool encode(const std::shared_ptr<Image>& image,
                const std::filesystem::path& filePath,
                const SaveOptions& options = {}) override;
     
-    float estimateQuality(const std::vector<uint8_t>& data) const override;
+    float estimateQuality(ByteSpan data) const override;
     size_t estimateFileSize(const std::shared_ptr<Image>& image, float quality) const override;
 
 private:
@@ -246,13 +277,20 @@ public:
     std::vector<uint8_t> getSupportedChannelCounts() const override { return {1, 3, 4}; }
     
     bool canDecodeFile(const std::filesystem::path& filePath) const override;
-    bool canDecodeData(const std::vector<uint8_t>& data) const override;
+    bool canDecodeData(ByteSpan data) const override;
     
     std::shared_ptr<Image> decode(const std::filesystem::path& filePath,
                                  const LoadOptions& options = {}) override;
-    std::shared_ptr<Image> decode(const std::vector<uint8_t>& data,
+    std::shared_ptr<Image> decode(ByteSpan data,
                                  const LoadOptions& options = {}) override;
     
+    // Reads only the tiles or strips overlapping the region
+    bool supportsRegionDecode() const override { return true; }
+    bool decodeRegion(ByteSpan data, const DecodeRegion& region, Image& target,
+                      const LoadOptions& options = {}) override;
+    
+    // Strips or tiles compressed concurrently (ParallelEncoders::encodeTIFF)
+    // for Deflate or no compression; LZW, JPEG and BigTIFF go through libtiff
     std::vector<uint8_t> encode(const std::shared_ptr<Image>& image,
                                const SaveOptions& options = {}) override;
     bool encode(const std::shared_ptr<Image>& image,
@@ -323,11 +361,11 @@ public:
     std::vector<uint8_t> getSupportedChannelCounts() const override { return {3, 4}; }
     
     bool canDecodeFile(const std::filesystem::path& filePath) const override;
-    bool canDecodeData(const std::vector<uint8_t>& data) const override;
+    bool canDecodeData(ByteSpan data) const override;
     
     std::shared_ptr<Image> decode(const std::filesystem::path& filePath,
                                  const LoadOptions& options = {}) override;
-    std::shared_ptr<Image> decode(const std::vector<uint8_t>& data,
+    std::shared_ptr<Image> decode(ByteSpan data,
                                  const LoadOptions& options = {}) override;
     
     std::vector<uint8_t> encode(const std::shared_ptr<Image>& image,
@@ -340,9 +378,9 @@ public:
     
     // WebP-specific methods
     bool isAnimated(const std::filesystem::path& filePath) const;
-    bool isAnimated(const std::vector<uint8_t>& data) const;
+    bool isAnimated(ByteSpan data) const;
     std::vector<std::shared_ptr<Image>> decodeAnimation(const std::filesystem::path& filePath);
-    std::vector<std::shared_ptr<Image>> decodeAnimation(const std::vector<uint8_t>& data);
+    std::vector<std::shared_ptr<Image>> decodeAnimation(ByteSpan data);
 
 private:
     Core::MemoryManager& memoryManager_;
@@ -357,7 +395,7 @@ private:
         uint32_t frameCount;
     };
     
-    WebPFeatures analyzeWebPFeatures(const std::vector<uint8_t>& data) const;
+    WebPFeatures analyzeWebPFeatures(ByteSpan data) const;
     
     // Encoding configuration
     void configureEncoder(void* config, const SaveOptions& options, bool hasAlpha);
@@ -387,11 +425,11 @@ public:
     std::vector<uint8_t> getSupportedChannelCounts() const override { return {3}; }
     
     bool canDecodeFile(const std::filesystem::path& filePath) const override;
-    bool canDecodeData(const std::vector<uint8_t>& data) const override;
+    bool canDecodeData(ByteSpan data) const override;
     
     std::shared_ptr<Image> decode(const std::filesystem::path& filePath,
                                  const LoadOptions& options = {}) override;
-    std::shared_ptr<Image> decode(const std::vector<uint8_t>& data,
+    std::shared_ptr<Image> decode(ByteSpan data,
                                  const LoadOptions& options = {}) override;
     
     std::vector<uint8_t> encode(const std::shared_ptr<Image>& image,
@@ -485,7 +523,7 @@ public:
     
     // Format detection and selection
     FileFormat detectFormat(const std::filesystem::path& filePath) const;
-    FileFormat detectFormat(const std::vector<uint8_t>& data) const;
+    FileFormat detectFormat(ByteSpan data) const;
     std::vector<FileFormat> getSupportedFormats() const;
     
     // Codec queries
@@ -518,7 +556,7 @@ namespace CodecUtils {
     };
     
     std::vector<MagicBytes> getAllMagicBytes();
-    FileFormat detectByMagicBytes(const std::vector<uint8_t>& data);
+    FileFormat detectByMagicBytes(ByteSpan data);
     
     // Quality estimation
     float estimateImageQuality(const std::shared_ptr<Image>& original,
@@ -542,6 +580,11 @@ namespace CodecUtils {
     // Progressive encoding support
     bool shouldUseProgressiveEncoding(const std::shared_ptr<Image>& image);
     
+    // Parallel encoding: whether the options allow the banded encoder for a
+    // format, and its settings from them
+    bool canEncodeInParallel(FileFormat format, const SaveOptions& options);
+    ParallelEncodeSettings parallelEncodeSettings(FileFormat format, const SaveOptions& options);
+    
     // Memory optimization for large images
     size_t calculateOptimalTileSize(const std::array<uint32_t, 2>& imageSize, 
                                    uint8_t channels, uint8_t bitDepth);
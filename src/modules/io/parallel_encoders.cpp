@@ -0,0 +1,734 @@
+#include "parallel_encoders.hpp"
+#include "../../core/kernel/task_scheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <csetjmp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <zlib.h>
+#include <jpeglib.h>
+
+namespace QuantumCanvas::IO {
+
+using Raster::Image;
+
+namespace {
+
+using Bytes = std::span<const uint8_t>;
+
+// Uncompressed bytes per band when rowsPerTask is 0
+constexpr size_t TARGET_BAND_BYTES = 256 * 1024;
+// Uncompressed bytes per band the estimates compress
+constexpr size_t SAMPLE_BAND_BYTES = 64 * 1024;
+// Bands the estimates sample
+constexpr uint32_t SAMPLE_BANDS = 16;
+// Deflate window
+constexpr size_t WINDOW_BYTES = 32 * 1024;
+
+template <typename Fn>
+void forEachTask(const ParallelEncodeSettings& settings, size_t count, Fn&& fn) {
+    if (settings.scheduler) {
+        settings.scheduler->parallel_for(0, count, 1, std::forward<Fn>(fn));
+    }
+    else {
+        Core::parallel_for(0, count, 1, std::forward<Fn>(fn));
+    }
+}
+
+void requireImage(const Image& image, const char* encoder) {
+    if (image.empty()) {
+        throw std::invalid_argument(std::string(encoder) + ": cannot encode an empty image");
+    }
+}
+
+// Rows per band, rounded up to a multiple of alignment
+uint32_t bandRows(uint32_t requested, size_t targetBytes, size_t rowBytes, uint32_t alignment) {
+    uint32_t rows = requested;
+    if (rows == 0) {
+        rows = static_cast<uint32_t>(std::clamp<size_t>(targetBytes / std::max<size_t>(rowBytes, 1), 8, 1u << 16));
+    }
+    return (rows + alignment - 1) / alignment * alignment;
+}
+
+// Up to SAMPLE_BANDS evenly spaced indices in [0, count), or all of them
+std::vector<uint32_t> sampleIndices(uint32_t count) {
+    std::vector<uint32_t> indices;
+    if (count <= SAMPLE_BANDS) {
+        for (uint32_t i = 0; i < count; ++i) {
+            indices.push_back(i);
+        }
+        return indices;
+    }
+
+    for (uint32_t i = 0; i < SAMPLE_BANDS; ++i) {
+        indices.push_back(static_cast<uint32_t>(uint64_t(2 * i + 1) * count / (2 * SAMPLE_BANDS)));
+    }
+    return indices;
+}
+
+uint8_t toByte(float value) {
+    return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+// Columns [x0, x1) of row y as interleaved 8-bit RGB or RGBA
+void readRow(const Image& image, uint32_t y, uint32_t x0, uint32_t x1, uint32_t channels, uint8_t* out) {
+    const uint32_t tileY = y / Image::TILE_SIZE;
+    const size_t rowOffset = size_t(y % Image::TILE_SIZE) * Image::TILE_STRIDE;
+    for (uint32_t x = x0; x < x1;) {
+        const uint32_t tileX = x / Image::TILE_SIZE;
+        const uint32_t end = std::min(x1, (tileX + 1) * Image::TILE_SIZE);
+        const float* tile = image.tileData(tileX, tileY);
+        for (; x < end; ++x) {
+            const float* pixel = tile ? tile + rowOffset + (x % Image::TILE_SIZE) * Image::CHANNELS
+                                      : image.fillColor().data();
+            for (uint32_t c = 0; c < channels; ++c) {
+                *out++ = toByte(pixel[c]);
+            }
+        }
+    }
+}
+
+void put16BE(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void put32BE(std::vector<uint8_t>& out, uint32_t value) {
+    put16BE(out, value >> 16);
+    put16BE(out, value & 0xFFFF);
+}
+
+void put16LE(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void put32LE(std::vector<uint8_t>& out, uint32_t value) {
+    put16LE(out, value & 0xFFFF);
+    put16LE(out, value >> 16);
+}
+
+// PNG
+
+constexpr size_t PNG_FIXED_BYTES = 8 + 25 + 12 + 2 + 4;  // Signature, IHDR, IEND, zlib header and Adler-32
+constexpr size_t PNG_CHUNK_BYTES = 12;
+
+uint8_t paeth(uint8_t a, uint8_t b, uint8_t c) {
+    const int p = int(a) + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    return (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+}
+
+// Filters one row with the type giving the smallest sum of absolute signed
+// bytes, the heuristic libpng uses; out receives the type byte and the row
+void filterRow(const uint8_t* row, const uint8_t* prior, size_t length, uint32_t bpp,
+               uint8_t* out, std::vector<uint8_t>& scratch) {
+    scratch.resize(length * 5);
+    for (size_t i = 0; i < length; ++i) {
+        const uint8_t left = i >= bpp ? row[i - bpp] : 0;
+        const uint8_t up = prior ? prior[i] : 0;
+        const uint8_t upLeft = (prior && i >= bpp) ? prior[i - bpp] : 0;
+        scratch[i] = row[i];
+        scratch[length + i] = static_cast<uint8_t>(row[i] - left);
+        scratch[length * 2 + i] = static_cast<uint8_t>(row[i] - up);
+        scratch[length * 3 + i] = static_cast<uint8_t>(row[i] - ((left + up) >> 1));
+        scratch[length * 4 + i] = static_cast<uint8_t>(row[i] - paeth(left, up, upLeft));
+    }
+
+    uint32_t best = 0;
+    uint64_t bestCost = UINT64_MAX;
+    for (uint32_t type = 0; type < 5; ++type) {
+        uint64_t cost = 0;
+        for (size_t i = 0; i < length; ++i) {
+            cost += std::abs(int(static_cast<int8_t>(scratch[length * type + i])));
+        }
+        if (cost < bestCost) {
+            bestCost = cost;
+            best = type;
+        }
+    }
+
+    out[0] = static_cast<uint8_t>(best);
+    std::memcpy(out + 1, scratch.data() + length * best, length);
+}
+
+// Filtered rows [y0, y1), each prefixed with its filter type. A row's filter
+// depends only on it and the row above, so any band can be refiltered alone.
+std::vector<uint8_t> filterRows(const Image& image, uint32_t y0, uint32_t y1, uint32_t channels) {
+    const size_t length = size_t(image.width()) * channels;
+    std::vector<uint8_t> filtered((length + 1) * (y1 - y0));
+    std::vector<uint8_t> prior(length);
+    std::vector<uint8_t> row(length);
+    std::vector<uint8_t> scratch;
+
+    if (y0 > 0) {
+        readRow(image, y0 - 1, 0, image.width(), channels, prior.data());
+    }
+    for (uint32_t y = y0; y < y1; ++y) {
+        readRow(image, y, 0, image.width(), channels, row.data());
+        filterRow(row.data(), y > 0 ? prior.data() : nullptr, length, channels,
+                  filtered.data() + (length + 1) * (y - y0), scratch);
+        std::swap(row, prior);
+    }
+    return filtered;
+}
+
+// Raw deflate of data with the window primed by dictionary, ending on a
+// byte boundary with a sync flush, or with the final block when last
+std::vector<uint8_t> deflateBand(Bytes data, Bytes dictionary, int level, bool last) {
+    z_stream stream{};
+    if (deflateInit2(&stream, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("PNG encoder: failed to initialize deflate");
+    }
+    if (!dictionary.empty()) {
+        deflateSetDictionary(&stream, dictionary.data(), static_cast<uInt>(dictionary.size()));
+    }
+
+    std::vector<uint8_t> out(deflateBound(&stream, data.size()) + 64);
+    const uint8_t* next = data.data();
+    size_t remaining = data.size();
+    for (;;) {
+        if (stream.avail_in == 0 && remaining > 0) {
+            const size_t chunk = std::min<size_t>(remaining, 1u << 30);
+            stream.next_in = const_cast<Bytef*>(next);
+            stream.avail_in = static_cast<uInt>(chunk);
+            next += chunk;
+            remaining -= chunk;
+        }
+        if (out.size() - stream.total_out < 64) {
+            out.resize(out.size() * 2);
+        }
+        stream.next_out = out.data() + stream.total_out;
+        stream.avail_out = static_cast<uInt>(std::min<size_t>(out.size() - stream.total_out, 1u << 30));
+
+        const int flush = remaining > 0 ? Z_NO_FLUSH : (last ? Z_FINISH : Z_SYNC_FLUSH);
+        const int status = deflate(&stream, flush);
+        if (status == Z_STREAM_ERROR) {
+            deflateEnd(&stream);
+            throw std::runtime_error("PNG encoder: deflate failed");
+        }
+        if (remaining == 0 && stream.avail_in == 0 && (last ? status == Z_STREAM_END : stream.avail_out != 0)) {
+            break;
+        }
+    }
+
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return out;
+}
+
+struct PNGBand {
+    std::vector<uint8_t> compressed;
+    uLong adler = 0;
+    size_t length = 0;  // Filtered bytes
+};
+
+PNGBand compressPNGBand(const Image& image, uint32_t y0, uint32_t y1, uint32_t channels, int level, bool last) {
+    // The window is primed with the tail of the band above, refiltered here
+    // rather than waited for
+    const size_t rowBytes = size_t(image.width()) * channels + 1;
+    const auto primedRows = static_cast<uint32_t>(std::min<size_t>(y0, (WINDOW_BYTES + rowBytes - 1) / rowBytes));
+    const std::vector<uint8_t> filtered = filterRows(image, y0 - primedRows, y1, channels);
+
+    const size_t prefix = primedRows * rowBytes;
+    const size_t dictionaryBytes = std::min(prefix, WINDOW_BYTES);
+    const Bytes all(filtered);
+    const Bytes band = all.subspan(prefix);
+
+    PNGBand result;
+    result.compressed = deflateBand(band, all.subspan(prefix - dictionaryBytes, dictionaryBytes), level, last);
+    result.adler = adler32_z(adler32(0, Z_NULL, 0), band.data(), band.size());
+    result.length = band.size();
+    return result;
+}
+
+void writeChunk(std::vector<uint8_t>& out, const char* type, std::initializer_list<Bytes> parts) {
+    size_t length = 0;
+    for (const Bytes& part : parts) {
+        length += part.size();
+    }
+    if (length > 0x7FFFFFFF) {
+        throw std::runtime_error("PNG encoder: chunk exceeds 2 GiB");
+    }
+
+    put32BE(out, static_cast<uint32_t>(length));
+    const size_t typeOffset = out.size();
+    out.insert(out.end(), type, type + 4);
+    for (const Bytes& part : parts) {
+        out.insert(out.end(), part.begin(), part.end());
+    }
+    put32BE(out, static_cast<uint32_t>(crc32_z(crc32(0, Z_NULL, 0), out.data() + typeOffset, length + 4)));
+}
+
+// TIFF
+
+constexpr uint16_t TIFF_SHORT = 3;
+constexpr uint16_t TIFF_LONG = 4;
+constexpr uint16_t TIFF_RATIONAL = 5;
+constexpr size_t TIFF_FIXED_BYTES = 8 + 2 + 20 * 12 + 4 + 8 + 16;  // Header, IFD, sample sizes, resolutions
+
+// Strips or tiles, numbered row by row
+struct TIFFLayout {
+    bool tiled;
+    uint32_t blockWidth;
+    uint32_t blockHeight;
+    uint32_t across;
+    uint32_t down;
+    uint32_t channels;
+
+    TIFFLayout(const Image& image, const ParallelEncodeSettings& settings) {
+        tiled = settings.tiffTiled;
+        channels = settings.alpha ? 4 : 3;
+        if (tiled) {
+            blockWidth = blockHeight = std::max<uint32_t>((settings.tiffTileSize + 15) / 16 * 16, 16);
+            across = (image.width() + blockWidth - 1) / blockWidth;
+        }
+        else {
+            blockWidth = image.width();
+            blockHeight = std::min(bandRows(settings.rowsPerTask, TARGET_BAND_BYTES, size_t(image.width()) * channels, 1),
+                                   image.height());
+            across = 1;
+        }
+        down = (image.height() + blockHeight - 1) / blockHeight;
+    }
+
+    uint32_t count() const { return across * down; }
+};
+
+// One strip or tile as interleaved samples, predicted when asked and
+// compressed unless level is 0. Tiles are padded to full size with zeros;
+// the last strip holds only the remaining rows.
+std::vector<uint8_t> compressTIFFBlock(const Image& image, const TIFFLayout& layout, uint32_t index,
+                                       int level, bool predict) {
+    const uint32_t x0 = (index % layout.across) * layout.blockWidth;
+    const uint32_t y0 = (index / layout.across) * layout.blockHeight;
+    const uint32_t rows = layout.tiled ? layout.blockHeight : std::min(layout.blockHeight, image.height() - y0);
+    const size_t rowBytes = size_t(layout.blockWidth) * layout.channels;
+
+    std::vector<uint8_t> block(rowBytes * rows, 0);
+    const uint32_t x1 = std::min(x0 + layout.blockWidth, image.width());
+    for (uint32_t r = 0; r < rows && y0 + r < image.height(); ++r) {
+        uint8_t* row = block.data() + rowBytes * r;
+        readRow(image, y0 + r, x0, x1, layout.channels, row);
+        if (predict) {
+            for (size_t i = rowBytes; i-- > layout.channels;) {
+                row[i] = static_cast<uint8_t>(row[i] - row[i - layout.channels]);
+            }
+        }
+    }
+    if (level == 0) {
+        return block;
+    }
+
+    uLongf compressedSize = compressBound(static_cast<uLong>(block.size()));
+    std::vector<uint8_t> compressed(compressedSize);
+    if (compress2(compressed.data(), &compressedSize, block.data(), static_cast<uLong>(block.size()), level) != Z_OK) {
+        throw std::runtime_error("TIFF encoder: deflate failed");
+    }
+    compressed.resize(compressedSize);
+    return compressed;
+}
+
+// JPEG
+
+constexpr uint32_t JPEG_MCU_ROWS = 16;  // Luma rows per MCU with 4:2:0 chroma
+
+struct JPEGError {
+    jpeg_error_mgr manager;
+    std::jmp_buf jump;
+};
+
+void jpegErrorExit(j_common_ptr info) {
+    std::longjmp(reinterpret_cast<JPEGError*>(info->err)->jump, 1);
+}
+
+// Encodes interleaved RGB rows into a malloc'd buffer the caller frees.
+// Only trivially destructible locals live here, so the error longjmp skips
+// no destructors.
+bool encodeJPEGBand(const uint8_t* rgb, uint32_t width, uint32_t height, int quality,
+                    unsigned int restartInterval, unsigned char** output, unsigned long* outputSize) {
+    jpeg_compress_struct info;
+    JPEGError error;
+    info.err = jpeg_std_error(&error.manager);
+    error.manager.error_exit = jpegErrorExit;
+    *output = nullptr;
+    *outputSize = 0;
+    if (setjmp(error.jump)) {
+        jpeg_destroy_compress(&info);
+        std::free(*output);
+        *output = nullptr;
+        return false;
+    }
+
+    jpeg_create_compress(&info);
+    jpeg_mem_dest(&info, output, outputSize);
+    info.image_width = width;
+    info.image_height = height;
+    info.input_components = 3;
+    info.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&info);
+    jpeg_set_quality(&info, quality, TRUE);
+    info.optimize_coding = FALSE;  // Every band must share the standard tables
+    info.restart_interval = restartInterval;
+
+    jpeg_start_compress(&info, TRUE);
+    while (info.next_scanline < info.image_height) {
+        JSAMPROW row = const_cast<JSAMPROW>(rgb + size_t(info.next_scanline) * width * 3);
+        jpeg_write_scanlines(&info, &row, 1);
+    }
+    jpeg_finish_compress(&info);
+    jpeg_destroy_compress(&info);
+    return true;
+}
+
+// One band of whole MCU rows, encoded as a complete JPEG
+struct JPEGBand {
+    unsigned char* data = nullptr;
+    unsigned long size = 0;
+    size_t scanOffset = 0;  // First entropy-coded byte
+    size_t frameOffset = 0; // SOF marker
+
+    JPEGBand() = default;
+    JPEGBand(const JPEGBand&) = delete;
+    JPEGBand& operator=(const JPEGBand&) = delete;
+    ~JPEGBand() { std::free(data); }
+
+    // Entropy-coded data, without the closing EOI
+    Bytes entropy() const { return {data + scanOffset, size - 2 - scanOffset}; }
+};
+
+int jpegQuality(float quality) {
+    return static_cast<int>(std::clamp(std::lround(quality * 100.0f), 1L, 100L));
+}
+
+void encodeJPEGRows(const Image& image, uint32_t y0, uint32_t y1, int quality, unsigned int restartInterval,
+                    JPEGBand& band) {
+    std::vector<uint8_t> rgb(size_t(image.width()) * 3 * (y1 - y0));
+    for (uint32_t y = y0; y < y1; ++y) {
+        readRow(image, y, 0, image.width(), 3, rgb.data() + size_t(image.width()) * 3 * (y - y0));
+    }
+    if (!encodeJPEGBand(rgb.data(), image.width(), y1 - y0, quality, restartInterval, &band.data, &band.size)) {
+        throw std::runtime_error("JPEG encoder: libjpeg failed to encode a band");
+    }
+
+    // Walk the marker segments up to the start of scan
+    size_t offset = 2;
+    while (offset + 4 <= band.size && band.data[offset] == 0xFF) {
+        const uint8_t marker = band.data[offset + 1];
+        const size_t length = (size_t(band.data[offset + 2]) << 8) | band.data[offset + 3];
+        if (marker == 0xC0 || marker == 0xC1) {
+            band.frameOffset = offset;
+        }
+        offset += 2 + length;
+        if (marker == 0xDA) {
+            band.scanOffset = offset;
+            break;
+        }
+    }
+    if (band.scanOffset == 0 || band.frameOffset == 0 || band.scanOffset + 2 > band.size ||
+        band.data[band.size - 2] != 0xFF || band.data[band.size - 1] != 0xD9) {
+        throw std::runtime_error("JPEG encoder: unexpected libjpeg output");
+    }
+}
+
+} // namespace
+
+// PNG
+
+std::vector<uint8_t> ParallelEncoders::encodePNG(const Image& image, const ParallelEncodeSettings& settings) {
+    requireImage(image, "PNG encoder");
+    const uint32_t channels = settings.alpha ? 4 : 3;
+    const int level = std::min<int>(settings.compressionLevel, 9);
+    const uint32_t rows = bandRows(settings.rowsPerTask, TARGET_BAND_BYTES, size_t(image.width()) * channels + 1, 1);
+    const size_t bandCount = (image.height() + rows - 1) / rows;
+
+    std::vector<PNGBand> bands(bandCount);
+    forEachTask(settings, bandCount, [&](size_t index) {
+        const auto y0 = static_cast<uint32_t>(index * rows);
+        bands[index] = compressPNGBand(image, y0, std::min(y0 + rows, image.height()), channels, level,
+                                       index + 1 == bandCount);
+    });
+
+    // Concatenated, the bands are one deflate stream
+    uLong adler = adler32(0, Z_NULL, 0);
+    size_t total = PNG_FIXED_BYTES;
+    for (const PNGBand& band : bands) {
+        adler = adler32_combine(adler, band.adler, static_cast<z_off_t>(band.length));
+        total += band.compressed.size() + PNG_CHUNK_BYTES;
+    }
+
+    std::vector<uint8_t> out;
+    out.reserve(total);
+    const uint8_t signature[] = {137, 80, 78, 71, 13, 10, 26, 10};
+    out.insert(out.end(), std::begin(signature), std::end(signature));
+
+    std::vector<uint8_t> header;
+    put32BE(header, image.width());
+    put32BE(header, image.height());
+    header.insert(header.end(), {8, static_cast<uint8_t>(channels == 4 ? 6 : 2), 0, 0, 0});
+    writeChunk(out, "IHDR", {header});
+
+    // zlib header with the matching level hint, and the combined checksum
+    const uint8_t zlibHeader[] = {0x78, static_cast<uint8_t>(level <= 1 ? 0x01 : level <= 5 ? 0x5E : level == 6 ? 0x9C : 0xDA)};
+    std::vector<uint8_t> trailer;
+    put32BE(trailer, static_cast<uint32_t>(adler));
+    for (size_t i = 0; i < bandCount; ++i) {
+        writeChunk(out, "IDAT", {i == 0 ? Bytes(zlibHeader) : Bytes(), bands[i].compressed,
+                                 i + 1 == bandCount ? Bytes(trailer) : Bytes()});
+    }
+    writeChunk(out, "IEND", {});
+    return out;
+}
+
+size_t ParallelEncoders::estimatePNGSize(const Image& image, const ParallelEncodeSettings& settings) {
+    requireImage(image, "PNG encoder");
+    const uint32_t channels = settings.alpha ? 4 : 3;
+    const int level = std::min<int>(settings.compressionLevel, 9);
+    const uint32_t rows = std::min(bandRows(0, SAMPLE_BAND_BYTES, size_t(image.width()) * channels + 1, 1), image.height());
+    const std::vector<uint32_t> samples = sampleIndices((image.height() + rows - 1) / rows);
+
+    std::vector<size_t> compressed(samples.size());
+    std::vector<uint32_t> sampledRows(samples.size());
+    forEachTask(settings, samples.size(), [&](size_t i) {
+        const uint32_t y0 = samples[i] * rows;
+        const uint32_t y1 = std::min(y0 + rows, image.height());
+        compressed[i] = compressPNGBand(image, y0, y1, channels, level, y1 == image.height()).compressed.size();
+        sampledRows[i] = y1 - y0;
+    });
+
+    double bytes = 0.0;
+    uint64_t coveredRows = 0;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        bytes += double(compressed[i]);
+        coveredRows += sampledRows[i];
+    }
+
+    // One IDAT chunk per band the encoder would write
+    const uint32_t encodeRows = bandRows(settings.rowsPerTask, TARGET_BAND_BYTES, size_t(image.width()) * channels + 1, 1);
+    const size_t chunks = (image.height() + encodeRows - 1) / encodeRows;
+    return PNG_FIXED_BYTES + chunks * PNG_CHUNK_BYTES +
+           static_cast<size_t>(std::llround(bytes * image.height() / double(coveredRows)));
+}
+
+// TIFF
+
+std::vector<uint8_t> ParallelEncoders::encodeTIFF(const Image& image, const ParallelEncodeSettings& settings) {
+    requireImage(image, "TIFF encoder");
+    const TIFFLayout layout(image, settings);
+    const int level = std::min<int>(settings.compressionLevel, 9);
+    const bool predict = level > 0 && settings.tiffPredictor == 2;
+
+    std::vector<std::vector<uint8_t>> blocks(layout.count());
+    forEachTask(settings, blocks.size(), [&](size_t index) {
+        blocks[index] = compressTIFFBlock(image, layout, static_cast<uint32_t>(index), level, predict);
+    });
+
+    // Header, blocks in order, the arrays the IFD points to, then the IFD
+    uint64_t size = 8;
+    for (const auto& block : blocks) {
+        size += block.size();
+    }
+    size += (size & 1) + 8 * uint64_t(blocks.size()) + TIFF_FIXED_BYTES;
+    if (size > UINT32_MAX) {
+        throw std::runtime_error("TIFF encoder: output exceeds 4 GiB; BigTIFF is not supported");
+    }
+
+    std::vector<uint8_t> out;
+    out.reserve(static_cast<size_t>(size));
+    out.insert(out.end(), {'I', 'I', 42, 0});
+    put32LE(out, 0);  // IFD offset, patched below
+
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> byteCounts;
+    for (const auto& block : blocks) {
+        offsets.push_back(static_cast<uint32_t>(out.size()));
+        byteCounts.push_back(static_cast<uint32_t>(block.size()));
+        out.insert(out.end(), block.begin(), block.end());
+    }
+    if (out.size() & 1) {
+        out.push_back(0);
+    }
+
+    struct Entry {
+        uint16_t tag;
+        uint16_t type;
+        uint32_t count;
+        uint32_t value;  // The value itself when it fits, otherwise an offset
+    };
+    std::vector<Entry> entries;
+
+    auto array = [&](uint16_t tag, const std::vector<uint32_t>& values) {
+        if (values.size() == 1) {
+            entries.push_back({tag, TIFF_LONG, 1, values[0]});
+            return;
+        }
+        entries.push_back({tag, TIFF_LONG, static_cast<uint32_t>(values.size()), static_cast<uint32_t>(out.size())});
+        for (uint32_t value : values) {
+            put32LE(out, value);
+        }
+    };
+
+    entries.push_back({256, TIFF_LONG, 1, image.width()});
+    entries.push_back({257, TIFF_LONG, 1, image.height()});
+    if (layout.channels > 2) {
+        entries.push_back({258, TIFF_SHORT, layout.channels, static_cast<uint32_t>(out.size())});
+        for (uint32_t c = 0; c < layout.channels; ++c) {
+            put16LE(out, 8);
+        }
+    }
+    entries.push_back({259, TIFF_SHORT, 1, level > 0 ? 8u : 1u});  // Adobe Deflate or none
+    entries.push_back({262, TIFF_SHORT, 1, 2});                    // RGB
+    entries.push_back({277, TIFF_SHORT, 1, layout.channels});
+    entries.push_back({282, TIFF_RATIONAL, 1, static_cast<uint32_t>(out.size())});
+    put32LE(out, 72);
+    put32LE(out, 1);
+    entries.push_back({283, TIFF_RATIONAL, 1, static_cast<uint32_t>(out.size())});
+    put32LE(out, 72);
+    put32LE(out, 1);
+    entries.push_back({284, TIFF_SHORT, 1, 1});  // Chunky
+    entries.push_back({296, TIFF_SHORT, 1, 2});  // Inches
+    if (predict) {
+        entries.push_back({317, TIFF_SHORT, 1, 2});
+    }
+    if (layout.tiled) {
+        entries.push_back({322, TIFF_LONG, 1, layout.blockWidth});
+        entries.push_back({323, TIFF_LONG, 1, layout.blockHeight});
+        array(324, offsets);
+        array(325, byteCounts);
+    }
+    else {
+        array(273, offsets);
+        entries.push_back({278, TIFF_LONG, 1, layout.blockHeight});
+        array(279, byteCounts);
+    }
+    if (layout.channels == 4) {
+        entries.push_back({338, TIFF_SHORT, 1, 2});  // Unassociated alpha
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.tag < b.tag; });
+
+    if (out.size() & 1) {
+        out.push_back(0);
+    }
+    const auto ifdOffset = static_cast<uint32_t>(out.size());
+    std::memcpy(out.data() + 4, &ifdOffset, 4);  // TIFF is written little-endian; so are supported hosts
+    put16LE(out, static_cast<uint32_t>(entries.size()));
+    for (const Entry& entry : entries) {
+        put16LE(out, entry.tag);
+        put16LE(out, entry.type);
+        put32LE(out, entry.count);
+        put32LE(out, entry.value);
+    }
+    put32LE(out, 0);  // No further IFDs
+    return out;
+}
+
+size_t ParallelEncoders::estimateTIFFSize(const Image& image, const ParallelEncodeSettings& settings) {
+    requireImage(image, "TIFF encoder");
+    const TIFFLayout layout(image, settings);
+    const int level = std::min<int>(settings.compressionLevel, 9);
+    const bool predict = level > 0 && settings.tiffPredictor == 2;
+    const std::vector<uint32_t> samples = sampleIndices(layout.count());
+
+    std::vector<size_t> compressed(samples.size());
+    forEachTask(settings, samples.size(), [&](size_t i) {
+        compressed[i] = compressTIFFBlock(image, layout, samples[i], level, predict).size();
+    });
+
+    double bytes = 0.0;
+    for (size_t size : compressed) {
+        bytes += double(size);
+    }
+    return TIFF_FIXED_BYTES + 8 * size_t(layout.count()) +
+           static_cast<size_t>(std::llround(bytes * layout.count() / double(samples.size())));
+}
+
+// JPEG
+
+std::vector<uint8_t> ParallelEncoders::encodeJPEG(const Image& image, const ParallelEncodeSettings& settings) {
+    requireImage(image, "JPEG encoder");
+    if (image.width() > JPEG_MAX_DIMENSION || image.height() > JPEG_MAX_DIMENSION) {
+        throw std::invalid_argument("JPEG encoder: images are limited to 65500 pixels a side");
+    }
+
+    // A restart interval of one MCU row lets bands start on any MCU row
+    const int quality = jpegQuality(settings.quality);
+    const auto restartInterval = (image.width() + JPEG_MCU_ROWS - 1) / JPEG_MCU_ROWS;
+    const uint32_t rows = bandRows(settings.rowsPerTask, TARGET_BAND_BYTES, size_t(image.width()) * 3, JPEG_MCU_ROWS);
+    const size_t bandCount = (image.height() + rows - 1) / rows;
+
+    std::vector<JPEGBand> bands(bandCount);
+    forEachTask(settings, bandCount, [&](size_t index) {
+        const auto y0 = static_cast<uint32_t>(index * rows);
+        encodeJPEGRows(image, y0, std::min(y0 + rows, image.height()), quality, restartInterval, bands[index]);
+    });
+
+    size_t total = bands[0].scanOffset + 2;
+    for (const JPEGBand& band : bands) {
+        total += band.entropy().size() + 2;
+    }
+
+    // The first band's headers, with the frame's height made the image's
+    std::vector<uint8_t> out;
+    out.reserve(total);
+    out.insert(out.end(), bands[0].data, bands[0].data + bands[0].scanOffset);
+    out[bands[0].frameOffset + 5] = static_cast<uint8_t>(image.height() >> 8);
+    out[bands[0].frameOffset + 6] = static_cast<uint8_t>(image.height());
+
+    // Each band numbers its restart markers from RST0; number them globally
+    // and add the one between bands. 0xFF in entropy data is always followed
+    // by a stuffed zero, so any RSTn found is a real marker.
+    const uint32_t intervalsPerBand = rows / JPEG_MCU_ROWS;
+    for (size_t index = 0; index < bandCount; ++index) {
+        const Bytes entropy = bands[index].entropy();
+        const size_t start = out.size();
+        out.insert(out.end(), entropy.begin(), entropy.end());
+
+        uint64_t interval = uint64_t(index) * intervalsPerBand;
+        for (size_t i = start; i + 1 < out.size(); ++i) {
+            if (out[i] == 0xFF && out[i + 1] >= 0xD0 && out[i + 1] <= 0xD7) {
+                out[++i] = static_cast<uint8_t>(0xD0 + interval++ % 8);
+            }
+        }
+        if (index + 1 < bandCount) {
+            out.push_back(0xFF);
+            out.push_back(static_cast<uint8_t>(0xD0 + interval % 8));
+        }
+    }
+    out.push_back(0xFF);
+    out.push_back(0xD9);
+    return out;
+}
+
+size_t ParallelEncoders::estimateJPEGSize(const Image& image, const ParallelEncodeSettings& settings) {
+    requireImage(image, "JPEG encoder");
+    const int quality = jpegQuality(settings.quality);
+    const auto restartInterval = (image.width() + JPEG_MCU_ROWS - 1) / JPEG_MCU_ROWS;
+    const uint32_t rows = bandRows(0, SAMPLE_BAND_BYTES, size_t(image.width()) * 3, JPEG_MCU_ROWS);
+    const std::vector<uint32_t> samples = sampleIndices((image.height() + rows - 1) / rows);
+
+    std::vector<JPEGBand> bands(samples.size());
+    std::vector<uint32_t> sampledRows(samples.size());
+    forEachTask(settings, samples.size(), [&](size_t i) {
+        const uint32_t y0 = samples[i] * rows;
+        const uint32_t y1 = std::min(y0 + rows, image.height());
+        encodeJPEGRows(image, y0, y1, quality, restartInterval, bands[i]);
+        sampledRows[i] = y1 - y0;
+    });
+
+    double bytes = 0.0;
+    uint64_t coveredRows = 0;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        bytes += double(bands[i].entropy().size() + 2);  // Each band ends with a restart marker
+        coveredRows += sampledRows[i];
+    }
+    return bands[0].scanOffset + 2 + static_cast<size_t>(std::llround(bytes * image.height() / double(coveredRows)));
+}
+
+} // namespace QuantumCanvas::IO
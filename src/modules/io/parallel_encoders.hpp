@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../raster/raster_image.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace QuantumCanvas::Core {
+class TaskScheduler;
+}
+
+namespace QuantumCanvas::IO {
+
+// Settings shared by the parallel encoders
+struct ParallelEncodeSettings {
+    uint8_t compressionLevel = 6;  // zlib level, 0-9, for PNG and TIFF
+    float quality = 0.9f;          // JPEG, 0-1
+    bool alpha = true;             // RGBA rather than RGB; JPEG always writes RGB
+    uint32_t rowsPerTask = 0;      // Rows per band or strip; 0 = chosen from the row size
+
+    // TIFF layout
+    bool tiffTiled = false;
+    uint32_t tiffTileSize = 256;   // Rounded up to a multiple of 16
+    uint8_t tiffPredictor = 2;     // 1 = none, 2 = horizontal differencing
+
+    // Null runs on the kernel's shared scheduler, or inline without one
+    Core::TaskScheduler* scheduler = nullptr;
+};
+
+// Encoders that split an image into bands compressed concurrently on the
+// task scheduler and stitched into one standard file
+//
+// PNG: each band of rows is filtered and deflated on its own, its window
+// primed with the last 32 KiB of the band above and ended with a sync flush,
+// so the concatenated bands form one zlib stream whose Adler-32 is combined
+// from the bands'. The output is a plain non-interlaced PNG.
+//
+// TIFF: strips or tiles are independent by design, so each is compressed
+// with Deflate (or stored, at level 0) concurrently and written in order.
+// Classic TIFF only; output over 4 GiB throws.
+//
+// JPEG: bands of whole MCU rows are encoded by libjpeg concurrently with a
+// restart marker after every MCU row and the standard Huffman tables, then
+// joined with their restart markers renumbered. The result is byte for byte
+// what a single libjpeg pass with the same restart interval produces;
+// optimized Huffman tables and progressive scans need that single pass.
+//
+// All throw std::invalid_argument for empty images and std::runtime_error
+// when compression fails.
+namespace ParallelEncoders {
+    std::vector<uint8_t> encodePNG(const Raster::Image& image, const ParallelEncodeSettings& settings = {});
+    std::vector<uint8_t> encodeTIFF(const Raster::Image& image, const ParallelEncodeSettings& settings = {});
+    std::vector<uint8_t> encodeJPEG(const Raster::Image& image, const ParallelEncodeSettings& settings = {});
+
+    // Encoded sizes estimated from a few bands spread over the image, each
+    // compressed exactly as the encoder would; images small enough are
+    // encoded whole
+    size_t estimatePNGSize(const Raster::Image& image, const ParallelEncodeSettings& settings = {});
+    size_t estimateTIFFSize(const Raster::Image& image, const ParallelEncodeSettings& settings = {});
+    size_t estimateJPEGSize(const Raster::Image& image, const ParallelEncodeSettings& settings = {});
+}
+
+} // namespace QuantumCanvas::IO
@@ -0,0 +1,808 @@
+#include "qcsx_archive.hpp"
+#include "../../core/kernel/task_scheduler.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <zlib.h>
+
+namespace QuantumCanvas::IO {
+
+using Raster::Image;
+using ChunkRef = QCSXArchive::ChunkRef;
+
+namespace {
+
+constexpr uint8_t MAGIC[8] = {'Q', 'C', 'S', 'X', 0x0D, 0x0A, 0x1A, 0x0A};
+constexpr uint32_t FORMAT_VERSION = 1;
+constexpr size_t SLOT_BYTES = 64;
+constexpr uint64_t DATA_OFFSET = 2 * SLOT_BYTES;  // Chunks start after both header slots
+constexpr size_t TILE_BYTES = Image::TILE_FLOATS * sizeof(float);
+constexpr size_t SAVE_BATCH = 64;  // Tiles compressed per round, which bounds a save's memory
+
+constexpr uint8_t CODEC_STORED = 0;
+constexpr uint8_t CODEC_DEFLATE = 1;
+
+uint32_t checksum(const uint8_t* data, size_t size) {
+    return static_cast<uint32_t>(crc32_z(crc32(0, Z_NULL, 0), data, size));
+}
+
+uint32_t tilesFor(uint32_t pixels) {
+    return (pixels + Image::TILE_SIZE - 1) / Image::TILE_SIZE;
+}
+
+template<typename Fn>
+void parallelFor(Core::TaskScheduler* scheduler, size_t count, Fn&& fn) {
+    if (scheduler) {
+        scheduler->parallel_for(0, count, 1, std::forward<Fn>(fn));
+    }
+    else {
+        Core::parallel_for(0, count, 1, std::forward<Fn>(fn));
+    }
+}
+
+// Little-endian table of contents and header fields
+class TocWriter {
+public:
+    std::vector<uint8_t> bytes;
+
+    void u8(uint8_t value) { bytes.push_back(value); }
+    void u32(uint32_t value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            bytes.push_back(static_cast<uint8_t>(value >> shift));
+        }
+    }
+    void u64(uint64_t value) {
+        u32(static_cast<uint32_t>(value));
+        u32(static_cast<uint32_t>(value >> 32));
+    }
+    void f32(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, 4);
+        u32(bits);
+    }
+    void blob(const void* data, size_t size) {
+        u32(static_cast<uint32_t>(size));
+        const auto* begin = static_cast<const uint8_t*>(data);
+        bytes.insert(bytes.end(), begin, begin + size);
+    }
+    void chunk(const ChunkRef& ref) {
+        u64(ref.offset);
+        u32(ref.storedBytes);
+        u32(ref.rawBytes);
+        u8(ref.codec);
+        u32(ref.checksum);
+    }
+};
+
+class TocReader {
+public:
+    explicit TocReader(ByteSpan data) : data_(data) {}
+
+    size_t remaining() const { return data_.size() - pos_; }
+
+    uint8_t u8() { return *take(1); }
+    uint32_t u32() {
+        const uint8_t* p = take(4);
+        return p[0] | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+    }
+    uint64_t u64() {
+        const uint64_t low = u32();
+        return low | (uint64_t(u32()) << 32);
+    }
+    float f32() {
+        const uint32_t bits = u32();
+        float value;
+        std::memcpy(&value, &bits, 4);
+        return value;
+    }
+    ByteSpan blob() {
+        const uint32_t size = u32();
+        return {take(size), size};
+    }
+    ChunkRef chunk() {
+        ChunkRef ref;
+        ref.offset = u64();
+        ref.storedBytes = u32();
+        ref.rawBytes = u32();
+        ref.codec = u8();
+        ref.checksum = u32();
+        return ref;
+    }
+
+private:
+    ByteSpan data_;
+    size_t pos_ = 0;
+
+    const uint8_t* take(size_t size) {
+        if (size > remaining()) {
+            throw std::runtime_error("Truncated QCSX table of contents");
+        }
+        const uint8_t* p = data_.data() + pos_;
+        pos_ += size;
+        return p;
+    }
+};
+
+// Header slot: magic, version, generation, table of contents location and
+// checksum, then a checksum of the slot itself in the last four bytes
+struct Slot {
+    uint64_t generation = 0;
+    uint64_t tocOffset = 0;
+    uint64_t tocBytes = 0;
+    uint32_t tocChecksum = 0;
+};
+
+std::vector<uint8_t> encodeSlot(const Slot& slot) {
+    TocWriter out;
+    out.bytes.assign(MAGIC, MAGIC + sizeof(MAGIC));
+    out.u32(FORMAT_VERSION);
+    out.u32(0);  // Flags
+    out.u64(slot.generation);
+    out.u64(slot.tocOffset);
+    out.u64(slot.tocBytes);
+    out.u32(slot.tocChecksum);
+    out.bytes.resize(SLOT_BYTES - 4, 0);
+    out.u32(checksum(out.bytes.data(), SLOT_BYTES - 4));
+    return out.bytes;
+}
+
+std::optional<Slot> decodeSlot(ByteSpan data, size_t offset) {
+    if (data.size() < offset + SLOT_BYTES) {
+        return std::nullopt;
+    }
+    if (std::memcmp(data.data() + offset, MAGIC, sizeof(MAGIC)) != 0) {
+        return std::nullopt;
+    }
+    TocReader fields(data.subspan(offset + sizeof(MAGIC), SLOT_BYTES - sizeof(MAGIC)));
+    if (fields.u32() != FORMAT_VERSION) {
+        return std::nullopt;
+    }
+    fields.u32();
+    Slot slot;
+    slot.generation = fields.u64();
+    slot.tocOffset = fields.u64();
+    slot.tocBytes = fields.u64();
+    slot.tocChecksum = fields.u32();
+
+    TocReader tail(data.subspan(offset + SLOT_BYTES - 4, 4));
+    if (tail.u32() != checksum(data.data() + offset, SLOT_BYTES - 4)) {
+        return std::nullopt;
+    }
+    if (slot.tocOffset < DATA_OFFSET || slot.tocOffset > data.size() ||
+        slot.tocBytes > data.size() - slot.tocOffset ||
+        checksum(data.data() + slot.tocOffset, slot.tocBytes) != slot.tocChecksum) {
+        return std::nullopt;
+    }
+    return slot;
+}
+
+void checkRef(const ChunkRef& ref, size_t fileBytes) {
+    if (ref.offset != 0 && (ref.offset < DATA_OFFSET || ref.offset > fileBytes ||
+                            ref.storedBytes > fileBytes - ref.offset)) {
+        throw std::runtime_error("QCSX chunk lies outside the file");
+    }
+}
+
+// Deflates raw unless that saves nothing; ref gets everything but the offset
+std::vector<uint8_t> encodeChunk(const uint8_t* raw, size_t rawBytes, uint8_t level, ChunkRef& ref) {
+    std::vector<uint8_t> stored;
+    ref.codec = CODEC_STORED;
+    if (level > 0) {
+        uLongf size = compressBound(static_cast<uLong>(rawBytes));
+        stored.resize(size);
+        if (compress2(stored.data(), &size, raw, static_cast<uLong>(rawBytes), std::min<int>(level, 9)) == Z_OK &&
+            size < rawBytes) {
+            stored.resize(size);
+            ref.codec = CODEC_DEFLATE;
+        }
+    }
+    if (ref.codec == CODEC_STORED) {
+        stored.assign(raw, raw + rawBytes);
+    }
+    ref.storedBytes = static_cast<uint32_t>(stored.size());
+    ref.rawBytes = static_cast<uint32_t>(rawBytes);
+    ref.checksum = checksum(stored.data(), stored.size());
+    return stored;
+}
+
+void decodeChunk(ByteSpan file, const ChunkRef& ref, uint8_t* out, size_t rawBytes) {
+    checkRef(ref, file.size());
+    const uint8_t* stored = file.data() + ref.offset;
+    if (ref.rawBytes != rawBytes || checksum(stored, ref.storedBytes) != ref.checksum) {
+        throw std::runtime_error("QCSX chunk checksum mismatch");
+    }
+    if (ref.codec == CODEC_STORED && ref.storedBytes == rawBytes) {
+        std::memcpy(out, stored, rawBytes);
+        return;
+    }
+    uLongf size = static_cast<uLongf>(rawBytes);
+    if (ref.codec != CODEC_DEFLATE || uncompress(out, &size, stored, ref.storedBytes) != Z_OK || size != rawBytes) {
+        throw std::runtime_error("Corrupt QCSX chunk");
+    }
+}
+
+// Tiles are stored as four byte planes, which groups the slowly varying
+// exponent bytes of neighbouring floats and deflates far better
+std::vector<uint8_t> shuffleTile(const float* pixels) {
+    std::vector<uint8_t> planes(TILE_BYTES);
+    const auto* bytes = reinterpret_cast<const uint8_t*>(pixels);
+    for (size_t i = 0; i < Image::TILE_FLOATS; ++i) {
+        for (size_t plane = 0; plane < sizeof(float); ++plane) {
+            planes[plane * Image::TILE_FLOATS + i] = bytes[i * sizeof(float) + plane];
+        }
+    }
+    return planes;
+}
+
+void decodeTile(ByteSpan file, const ChunkRef& ref, float* pixels) {
+    std::vector<uint8_t> planes(TILE_BYTES);
+    decodeChunk(file, ref, planes.data(), TILE_BYTES);
+    auto* bytes = reinterpret_cast<uint8_t*>(pixels);
+    for (size_t i = 0; i < Image::TILE_FLOATS; ++i) {
+        for (size_t plane = 0; plane < sizeof(float); ++plane) {
+            bytes[i * sizeof(float) + plane] = planes[plane * Image::TILE_FLOATS + i];
+        }
+    }
+}
+
+std::shared_ptr<Image> decodePreview(ByteSpan file, const ChunkRef& ref, const std::array<uint32_t, 2>& size) {
+    if (ref.offset == 0 || size[0] == 0 || size[1] == 0) {
+        return nullptr;
+    }
+    std::vector<uint8_t> rgba(size_t(size[0]) * size[1] * 4);
+    decodeChunk(file, ref, rgba.data(), rgba.size());
+
+    auto image = std::make_shared<Image>(size[0], size[1]);
+    const uint8_t* pixel = rgba.data();
+    for (uint32_t y = 0; y < size[1]; ++y) {
+        for (uint32_t x = 0; x < size[0]; ++x, pixel += 4) {
+            image->setPixel(x, y, {pixel[0] / 255.0f, pixel[1] / 255.0f, pixel[2] / 255.0f, pixel[3] / 255.0f});
+        }
+    }
+    image->clearDirtyTiles();
+    return image;
+}
+
+// Appends chunks to a file, tracking where the next one goes
+class ChunkFile {
+public:
+    ChunkFile(const std::filesystem::path& path, bool append, uint64_t end)
+        : path_(path)
+        , end_(end) {
+        if (append) {
+            file_.open(path, std::ios::binary | std::ios::in | std::ios::out);
+            file_.seekp(static_cast<std::streamoff>(end));
+        }
+        else {
+            file_.open(path, std::ios::binary | std::ios::out | std::ios::trunc);
+            const std::vector<uint8_t> slots(DATA_OFFSET, 0);
+            file_.write(reinterpret_cast<const char*>(slots.data()), DATA_OFFSET);
+        }
+        check();
+    }
+
+    uint64_t end() const { return end_; }
+    uint64_t bytesWritten() const { return written_; }
+
+    uint64_t write(const uint8_t* data, size_t size) {
+        const uint64_t offset = end_;
+        file_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        check();
+        end_ += size;
+        written_ += size;
+        return offset;
+    }
+
+    void writeAt(uint64_t offset, const std::vector<uint8_t>& data) {
+        file_.seekp(static_cast<std::streamoff>(offset));
+        file_.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        check();
+        written_ += data.size();
+    }
+
+    void flush() {
+        file_.flush();
+        check();
+    }
+
+    void close() {
+        file_.close();
+        check();
+    }
+
+private:
+    std::filesystem::path path_;
+    std::fstream file_;
+    uint64_t end_;
+    uint64_t written_ = 0;
+
+    void check() {
+        if (!file_) {
+            throw std::runtime_error("Failed to write QCSX file: " + path_.string());
+        }
+    }
+};
+
+} // namespace
+
+// QCSXArchive
+
+QCSXArchive::QCSXArchive(const std::filesystem::path& filePath)
+    : filePath_(filePath)
+    , writable_(true)
+    , source_(std::make_shared<const ByteSource>(ByteSource::open(filePath, ByteSource::Access::Random)))
+    , contents_(parse(source_->bytes())) {
+}
+
+QCSXArchive::QCSXArchive(std::shared_ptr<const ByteSource> source)
+    : source_(std::move(source)) {
+    if (!source_) {
+        throw std::invalid_argument("QCSXArchive needs a byte source");
+    }
+    contents_ = parse(source_->bytes());
+}
+
+bool QCSXArchive::isQCSX(ByteSpan data) {
+    return data.size() >= DATA_OFFSET && std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) == 0;
+}
+
+std::optional<QCSXArchive::Info> QCSXArchive::readInfo(ByteSpan data) {
+    try {
+        return parse(data).info;
+    }
+    catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+std::shared_ptr<Image> QCSXArchive::readPreview(ByteSpan data) {
+    try {
+        const Contents contents = parse(data);
+        return decodePreview(data, contents.preview, contents.previewSize);
+    }
+    catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+QCSXArchive::Contents QCSXArchive::parse(ByteSpan data) {
+    if (!isQCSX(data)) {
+        throw std::runtime_error("Not a QCSX file");
+    }
+
+    // The newer intact slot wins; a save interrupted before its slot was
+    // written leaves the older one current
+    std::optional<Slot> slot = decodeSlot(data, 0);
+    std::optional<Slot> other = decodeSlot(data, SLOT_BYTES);
+    size_t slotIndex = 0;
+    if (other && (!slot || other->generation > slot->generation)) {
+        slot = other;
+        slotIndex = 1;
+    }
+    if (!slot) {
+        throw std::runtime_error("QCSX file has no intact table of contents");
+    }
+
+    Contents contents;
+    contents.slot = slotIndex;
+    contents.info.generation = slot->generation;
+    contents.info.fileBytes = data.size();
+    contents.info.liveBytes = DATA_OFFSET + slot->tocBytes;
+
+    TocReader toc(data.subspan(slot->tocOffset, slot->tocBytes));
+    contents.info.canvasSize[0] = toc.u32();
+    contents.info.canvasSize[1] = toc.u32();
+    const uint32_t layerCount = toc.u32();
+    for (uint32_t i = 0; i < layerCount; ++i) {
+        StoredLayer layer;
+        QCSXLayerInfo& info = layer.info;
+        info.id = toc.u32();
+        info.parentId = toc.u32();
+        const ByteSpan type = toc.blob();
+        info.type.assign(reinterpret_cast<const char*>(type.data()), type.size());
+        const ByteSpan properties = toc.blob();
+        info.properties.assign(properties.begin(), properties.end());
+
+        info.hasImage = toc.u8() != 0;
+        if (info.hasImage) {
+            info.imageSize[0] = toc.u32();
+            info.imageSize[1] = toc.u32();
+            for (float& channel : info.fill) {
+                channel = toc.f32();
+            }
+            const uint32_t tileCount = toc.u32();
+            if (tileCount != uint64_t(tilesFor(info.imageSize[0])) * tilesFor(info.imageSize[1]) ||
+                tileCount > toc.remaining() / 21) {
+                throw std::runtime_error("QCSX layer tile table does not match its size");
+            }
+            layer.tiles.resize(tileCount);
+            for (ChunkRef& ref : layer.tiles) {
+                ref = toc.chunk();
+                checkRef(ref, data.size());
+                if (ref.offset != 0) {
+                    info.storedTiles++;
+                    info.storedBytes += ref.storedBytes;
+                }
+            }
+            contents.info.liveBytes += info.storedBytes;
+        }
+        contents.layers.push_back(std::move(layer));
+    }
+
+    if (toc.u8() != 0) {
+        contents.previewSize[0] = toc.u32();
+        contents.previewSize[1] = toc.u32();
+        contents.preview = toc.chunk();
+        checkRef(contents.preview, data.size());
+        contents.info.hasPreview = contents.preview.offset != 0;
+        contents.info.liveBytes += contents.preview.storedBytes;
+    }
+
+    contents.info.layerCount = contents.layers.size();
+    return contents;
+}
+
+QCSXArchive::Info QCSXArchive::getInfo() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return contents_.info;
+}
+
+std::vector<QCSXLayerInfo> QCSXArchive::getLayers() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<QCSXLayerInfo> layers;
+    layers.reserve(contents_.layers.size());
+    for (const StoredLayer& layer : contents_.layers) {
+        layers.push_back(layer.info);
+    }
+    return layers;
+}
+
+std::optional<size_t> QCSXArchive::findLayer(uint32_t layerId) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < contents_.layers.size(); ++i) {
+        if (contents_.layers[i].info.id == layerId) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+std::shared_ptr<Image> QCSXArchive::loadImage(size_t layerIndex) {
+    std::shared_ptr<const ByteSource> source;
+    QCSXLayerInfo info;
+    std::vector<ChunkRef> tiles;
+    uint64_t saveCount;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (layerIndex >= contents_.layers.size()) {
+            throw std::invalid_argument("QCSX layer index out of range");
+        }
+        info = contents_.layers[layerIndex].info;
+        tiles = contents_.layers[layerIndex].tiles;
+        source = source_;
+        saveCount = saveCount_;
+    }
+    if (!info.hasImage) {
+        return nullptr;
+    }
+
+    auto image = std::make_shared<Image>(info.imageSize[0], info.imageSize[1], info.fill);
+    std::vector<size_t> stored;
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        if (tiles[i].offset != 0) {
+            stored.push_back(i);
+        }
+    }
+
+    // Distinct tiles, so workers never share one
+    const ByteSpan data = source->bytes();
+    const uint32_t tilesX = image->tilesX();
+    Core::parallel_for(0, stored.size(), 1, [&](size_t i) {
+        const size_t tile = stored[i];
+        decodeTile(data, tiles[tile], image->mutableTileData(tile % tilesX, tile / tilesX));
+    });
+    image->clearDirtyTiles();
+
+    // Skipped if a save replaced the layer meanwhile; the next save then
+    // recompresses the layer instead of trusting a stale snapshot
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (saveCount_ == saveCount) {
+        contents_.layers[layerIndex].snapshot = std::make_shared<const Image>(*image);
+    }
+    return image;
+}
+
+bool QCSXArchive::loadRegion(size_t layerIndex, const DecodeRegion& region, Image& target) const {
+    std::shared_ptr<const ByteSource> source;
+    QCSXLayerInfo info;
+    std::vector<ChunkRef> tiles;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (layerIndex >= contents_.layers.size()) {
+            throw std::invalid_argument("QCSX layer index out of range");
+        }
+        info = contents_.layers[layerIndex].info;
+        tiles = contents_.layers[layerIndex].tiles;
+        source = source_;
+    }
+    if (!info.hasImage) {
+        return false;
+    }
+
+    RegionDecodeSink sink(target, region, info.imageSize, Image::CHANNELS, RegionDecodeSink::SampleType::Float32);
+    const uint32_t tilesX = tilesFor(info.imageSize[0]);
+    std::vector<size_t> needed;
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        const uint32_t x = static_cast<uint32_t>(i % tilesX) * Image::TILE_SIZE;
+        const uint32_t y = static_cast<uint32_t>(i / tilesX) * Image::TILE_SIZE;
+        if (sink.intersects(x, y, Image::TILE_SIZE, Image::TILE_SIZE)) {
+            needed.push_back(i);
+        }
+    }
+
+    // Unstored tiles read as the fill, written as one repeated row
+    const std::vector<Image::Pixel> fillRow(Image::TILE_SIZE, info.fill);
+    const ByteSpan data = source->bytes();
+    std::mutex sinkMutex;
+    Core::parallel_for(0, needed.size(), 1, [&](size_t i) {
+        const size_t tile = needed[i];
+        const uint32_t x = static_cast<uint32_t>(tile % tilesX) * Image::TILE_SIZE;
+        const uint32_t y = static_cast<uint32_t>(tile / tilesX) * Image::TILE_SIZE;
+        const uint32_t width = std::min(Image::TILE_SIZE, info.imageSize[0] - x);
+        const uint32_t height = std::min(Image::TILE_SIZE, info.imageSize[1] - y);
+
+        if (tiles[tile].offset == 0) {
+            std::lock_guard<std::mutex> lock(sinkMutex);
+            sink.write(x, y, width, height, fillRow.data(), 0);
+            return;
+        }
+        std::vector<float> pixels(Image::TILE_FLOATS);
+        decodeTile(data, tiles[tile], pixels.data());
+        std::lock_guard<std::mutex> lock(sinkMutex);
+        sink.write(x, y, width, height, pixels.data(), Image::TILE_STRIDE * sizeof(float));
+    });
+    return true;
+}
+
+std::shared_ptr<Image> QCSXArchive::loadPreview() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return source_ ? decodePreview(source_->bytes(), contents_.preview, contents_.previewSize) : nullptr;
+}
+
+QCSXArchive::SaveStats QCSXArchive::save(const std::filesystem::path& filePath,
+                                         const std::array<uint32_t, 2>& canvasSize,
+                                         const std::vector<QCSXLayer>& layers,
+                                         const Image* preview,
+                                         const QCSXSaveSettings& settings) {
+    std::lock_guard<std::mutex> saveLock(saveMutex_);
+
+    Contents previous;
+    std::shared_ptr<const ByteSource> previousSource;
+    bool sameFile = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        previous = contents_;
+        previousSource = source_;
+        std::error_code error;
+        sameFile = writable_ && source_ && std::filesystem::equivalent(filePath, filePath_, error);
+    }
+    const ByteSpan previousData = previousSource ? previousSource->bytes() : ByteSpan{};
+
+    // Appending needs the file as it was opened, and pays off only while
+    // most of it is still live
+    SaveStats stats;
+    std::error_code error;
+    const uint64_t deadBytes = previous.info.fileBytes - std::min(previous.info.liveBytes, previous.info.fileBytes);
+    stats.incremental = settings.incremental && sameFile &&
+        std::filesystem::file_size(filePath, error) == previousData.size() && !error &&
+        double(deadBytes) <= double(settings.compactThreshold) * double(previous.info.fileBytes);
+
+    std::unordered_map<uint32_t, const StoredLayer*> previousById;
+    for (const StoredLayer& layer : previous.layers) {
+        previousById[layer.info.id] = &layer;
+    }
+
+    // Tiles to compress, and when rewriting, stored chunks to copy across
+    struct PendingTile {
+        size_t layer;
+        size_t tile;
+        const float* pixels;
+    };
+    struct CopiedChunk {
+        size_t layer;
+        size_t tile;
+        ChunkRef from;
+    };
+    std::vector<PendingTile> pending;
+    std::vector<CopiedChunk> copies;
+
+    Contents next;
+    next.info.canvasSize = canvasSize;
+    next.info.layerCount = layers.size();
+    next.info.generation = previous.info.generation + 1;
+    next.layers.resize(layers.size());
+
+    for (size_t index = 0; index < layers.size(); ++index) {
+        const QCSXLayer& layer = layers[index];
+        StoredLayer& stored = next.layers[index];
+        stored.info.id = layer.id;
+        stored.info.parentId = layer.parentId;
+        stored.info.type = layer.type;
+        stored.info.properties = layer.properties;
+
+        auto found = previousById.find(layer.id);
+        const StoredLayer* old = found != previousById.end() ? found->second : nullptr;
+        auto reuse = [&](size_t tile, const ChunkRef& ref) {
+            if (stats.incremental) {
+                stored.tiles[tile] = ref;
+                stats.chunksReused++;
+            }
+            else {
+                copies.push_back({index, tile, ref});
+            }
+        };
+
+        if (layer.image) {
+            auto snapshot = std::make_shared<const Image>(*layer.image);
+            stored.info.hasImage = !snapshot->empty();
+            stored.info.imageSize = snapshot->getSize();
+            stored.info.fill = snapshot->fillColor();
+            stored.tiles.resize(snapshot->tileCount());
+
+            const Image* before = old && old->snapshot && old->snapshot->getSize() == snapshot->getSize() &&
+                old->snapshot->fillColor() == snapshot->fillColor() ? old->snapshot.get() : nullptr;
+            for (uint32_t ty = 0; ty < snapshot->tilesY(); ++ty) {
+                for (uint32_t tx = 0; tx < snapshot->tilesX(); ++tx) {
+                    const size_t tile = size_t(ty) * snapshot->tilesX() + tx;
+                    const float* pixels = snapshot->tileData(tx, ty);
+                    if (!pixels) {
+                        continue;
+                    }
+                    if (before && before->tileData(tx, ty) == pixels && old->tiles[tile].offset != 0) {
+                        reuse(tile, old->tiles[tile]);
+                    }
+                    else {
+                        pending.push_back({index, tile, pixels});
+                    }
+                }
+            }
+            stored.snapshot = std::move(snapshot);
+        }
+        else if (old && old->info.hasImage) {
+            stored.info.hasImage = true;
+            stored.info.imageSize = old->info.imageSize;
+            stored.info.fill = old->info.fill;
+            stored.tiles.resize(old->tiles.size());
+            stored.snapshot = old->snapshot;
+            for (size_t tile = 0; tile < old->tiles.size(); ++tile) {
+                if (old->tiles[tile].offset != 0) {
+                    reuse(tile, old->tiles[tile]);
+                }
+            }
+        }
+    }
+
+    const std::filesystem::path temporary = filePath.string() + ".tmp";
+    const std::filesystem::path& target = stats.incremental ? filePath : temporary;
+    uint64_t tocBytes = 0;
+    try {
+        ChunkFile file(target, stats.incremental, stats.incremental ? previousData.size() : DATA_OFFSET);
+
+        for (const CopiedChunk& copy : copies) {
+            checkRef(copy.from, previousData.size());
+            ChunkRef ref = copy.from;
+            ref.offset = file.write(previousData.data() + copy.from.offset, copy.from.storedBytes);
+            next.layers[copy.layer].tiles[copy.tile] = ref;
+            stats.chunksReused++;
+        }
+
+        for (size_t first = 0; first < pending.size(); first += SAVE_BATCH) {
+            const size_t count = std::min(SAVE_BATCH, pending.size() - first);
+            std::vector<std::vector<uint8_t>> encoded(count);
+            std::vector<ChunkRef> refs(count);
+            parallelFor(settings.scheduler, count, [&](size_t i) {
+                const std::vector<uint8_t> planes = shuffleTile(pending[first + i].pixels);
+                encoded[i] = encodeChunk(planes.data(), planes.size(), settings.compressionLevel, refs[i]);
+            });
+            for (size_t i = 0; i < count; ++i) {
+                refs[i].offset = file.write(encoded[i].data(), encoded[i].size());
+                next.layers[pending[first + i].layer].tiles[pending[first + i].tile] = refs[i];
+            }
+            stats.chunksWritten += count;
+        }
+
+        if (preview && !preview->empty()) {
+            std::vector<uint8_t> rgba;
+            rgba.reserve(size_t(preview->width()) * preview->height() * 4);
+            for (uint32_t y = 0; y < preview->height(); ++y) {
+                for (uint32_t x = 0; x < preview->width(); ++x) {
+                    for (float channel : preview->getPixel(x, y)) {
+                        rgba.push_back(static_cast<uint8_t>(std::clamp(channel, 0.0f, 1.0f) * 255.0f + 0.5f));
+                    }
+                }
+            }
+            const std::vector<uint8_t> stored = encodeChunk(rgba.data(), rgba.size(), 6, next.preview);
+            next.preview.offset = file.write(stored.data(), stored.size());
+            next.previewSize = preview->getSize();
+            next.info.hasPreview = true;
+        }
+
+        TocWriter toc;
+        toc.u32(canvasSize[0]);
+        toc.u32(canvasSize[1]);
+        toc.u32(static_cast<uint32_t>(next.layers.size()));
+        for (const StoredLayer& layer : next.layers) {
+            toc.u32(layer.info.id);
+            toc.u32(layer.info.parentId);
+            toc.blob(layer.info.type.data(), layer.info.type.size());
+            toc.blob(layer.info.properties.data(), layer.info.properties.size());
+            toc.u8(layer.info.hasImage ? 1 : 0);
+            if (layer.info.hasImage) {
+                toc.u32(layer.info.imageSize[0]);
+                toc.u32(layer.info.imageSize[1]);
+                for (float channel : layer.info.fill) {
+                    toc.f32(channel);
+                }
+                toc.u32(static_cast<uint32_t>(layer.tiles.size()));
+                for (const ChunkRef& ref : layer.tiles) {
+                    toc.chunk(ref);
+                }
+            }
+        }
+        toc.u8(next.info.hasPreview ? 1 : 0);
+        if (next.info.hasPreview) {
+            toc.u32(next.previewSize[0]);
+            toc.u32(next.previewSize[1]);
+            toc.chunk(next.preview);
+        }
+
+        Slot slot;
+        slot.generation = next.info.generation;
+        slot.tocBytes = tocBytes = toc.bytes.size();
+        slot.tocChecksum = checksum(toc.bytes.data(), toc.bytes.size());
+        slot.tocOffset = file.write(toc.bytes.data(), toc.bytes.size());
+
+        // Everything the slot points at is written before the slot is
+        file.flush();
+        next.slot = stats.incremental ? 1 - previous.slot : 0;
+        file.writeAt(next.slot * SLOT_BYTES, encodeSlot(slot));
+        file.close();
+        stats.bytesWritten = file.bytesWritten();
+
+        if (!stats.incremental) {
+            std::filesystem::rename(temporary, filePath);
+        }
+    }
+    catch (...) {
+        if (!stats.incremental) {
+            std::filesystem::remove(temporary, error);
+        }
+        throw;
+    }
+
+    // What this save stored, for the next one to compare against
+    next.info.liveBytes = DATA_OFFSET + tocBytes + next.preview.storedBytes;
+    for (StoredLayer& layer : next.layers) {
+        for (const ChunkRef& ref : layer.tiles) {
+            if (ref.offset != 0) {
+                layer.info.storedTiles++;
+                layer.info.storedBytes += ref.storedBytes;
+            }
+        }
+        next.info.liveBytes += layer.info.storedBytes;
+    }
+    auto source = std::make_shared<const ByteSource>(ByteSource::open(filePath, ByteSource::Access::Random));
+    next.info.fileBytes = source->size();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    contents_ = std::move(next);
+    source_ = std::move(source);
+    filePath_ = filePath;
+    writable_ = true;
+    saveCount_++;
+    return stats;
+}
+
+} // namespace QuantumCanvas::IO
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "byte_source.hpp"
+#include "region_decode.hpp"
+#include "../raster/raster_image.hpp"
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace QuantumCanvas::Core {
+class TaskScheduler;
+}
+
+namespace QuantumCanvas::IO {
+
+struct QCSXSaveSettings {
+    uint8_t compressionLevel = 6;   // zlib level for tiles; 0 stores them uncompressed
+    bool incremental = true;        // Append changed chunks when saving over the opened file
+    float compactThreshold = 0.5f;  // Rewrite the file instead once this fraction of it is dead
+
+    // Null runs on the kernel's shared scheduler, or inline without one
+    Core::TaskScheduler* scheduler = nullptr;
+};
+
+// A layer as written: Layer::serialize() carries the properties, the
+// archive the pixels
+struct QCSXLayer {
+    uint32_t id = 0;        // Layer::getId(); matches a layer's chunks across saves
+    uint32_t parentId = 0;  // Enclosing group's id, 0 at the top level
+    std::string type;       // Layer::getLayerType()
+    std::vector<uint8_t> properties;
+
+    // Null keeps the pixels stored under id without loading them, or none
+    // for a layer the archive has not stored
+    std::shared_ptr<const Raster::Image> image;
+};
+
+// A layer as read, before any of its pixels are
+struct QCSXLayerInfo {
+    uint32_t id = 0;
+    uint32_t parentId = 0;
+    std::string type;
+    std::vector<uint8_t> properties;
+
+    bool hasImage = false;
+    std::array<uint32_t, 2> imageSize{0, 0};
+    Raster::Image::Pixel fill{0.0f, 0.0f, 0.0f, 0.0f};
+    size_t storedTiles = 0;   // Tiles that differ from the fill and have a chunk
+    uint64_t storedBytes = 0;
+};
+
+// Chunked, random-access QCSX container
+//
+// A file is two header slots, chunks, and a table of contents listing the
+// layers and, for each raster layer, one chunk per allocated 256x256 tile.
+// Opening reads the newer valid header and the table of contents only;
+// layers are loaded when asked for, whole or by region, so opening costs
+// the same for any document size. Tiles are float RGBA split into byte
+// planes and deflated, each on its own, in parallel on the task scheduler.
+//
+// Saving over the opened file appends only the tiles that changed, then a
+// new table of contents, then flips the older header slot to point at it,
+// so the previous version stays readable until the flip and an autosave
+// costs what was painted since the last one. Changed tiles are found by
+// identity: images handed out by loadImage() and images passed to save()
+// are kept as copy-on-write snapshots, so a tile still shared with the
+// snapshot is unchanged. Once dead chunks pass the compaction threshold,
+// or when saving elsewhere, the whole file is rewritten under a temporary
+// name and renamed into place, copying unchanged chunks without
+// recompressing them.
+//
+// Loads may run concurrently with each other and with save(); each reads
+// the version current when it started. Failures throw std::runtime_error.
+class QCSXArchive final {
+public:
+    // Where a chunk lies in the file
+    struct ChunkRef {
+        uint64_t offset = 0;  // 0 = no chunk
+        uint32_t storedBytes = 0;
+        uint32_t rawBytes = 0;
+        uint8_t codec = 0;
+        uint32_t checksum = 0;  // CRC-32 of the stored bytes
+    };
+
+    struct Info {
+        std::array<uint32_t, 2> canvasSize{0, 0};
+        size_t layerCount = 0;
+        bool hasPreview = false;
+        uint64_t generation = 0;  // Saves since the file was created
+        uint64_t fileBytes = 0;
+        uint64_t liveBytes = 0;   // Headers, chunks and table the current version refers to
+    };
+
+    struct SaveStats {
+        bool incremental = false;
+        size_t chunksWritten = 0;   // Compressed by this save
+        size_t chunksReused = 0;    // Left in place or copied as stored
+        uint64_t bytesWritten = 0;
+    };
+
+    QCSXArchive() = default;  // Nothing stored yet; the first save writes a whole file
+    explicit QCSXArchive(const std::filesystem::path& filePath);
+    explicit QCSXArchive(std::shared_ptr<const ByteSource> source);  // Read-only; saves never append
+
+    QCSXArchive(const QCSXArchive&) = delete;
+    QCSXArchive& operator=(const QCSXArchive&) = delete;
+
+    const std::filesystem::path& filePath() const { return filePath_; }
+    Info getInfo() const;
+    std::vector<QCSXLayerInfo> getLayers() const;
+    std::optional<size_t> findLayer(uint32_t layerId) const;
+
+    // Null for layers without pixels. Records the image for change detection.
+    std::shared_ptr<Raster::Image> loadImage(size_t layerIndex);
+    // Decodes only the tiles region touches; target must hold the output
+    bool loadRegion(size_t layerIndex, const DecodeRegion& region, Raster::Image& target) const;
+    std::shared_ptr<Raster::Image> loadPreview() const;
+
+    // Layers in order, groups before their children. The preview, if any,
+    // is stored as 8-bit RGBA for thumbnails.
+    SaveStats save(const std::filesystem::path& filePath,
+                   const std::array<uint32_t, 2>& canvasSize,
+                   const std::vector<QCSXLayer>& layers,
+                   const Raster::Image* preview = nullptr,
+                   const QCSXSaveSettings& settings = {});
+
+    // Header-only queries on a mapped file
+    static bool isQCSX(ByteSpan data);
+    static std::optional<Info> readInfo(ByteSpan data);
+    static std::shared_ptr<Raster::Image> readPreview(ByteSpan data);
+
+private:
+    struct StoredLayer {
+        QCSXLayerInfo info;
+        std::vector<ChunkRef> tiles;  // Row-major, one per tile of the image
+        // What the stored tiles hold, as of the last load or save; null until
+        // the layer's pixels have been seen
+        std::shared_ptr<const Raster::Image> snapshot;
+    };
+
+    struct Contents {
+        Info info;
+        std::vector<StoredLayer> layers;
+        ChunkRef preview;
+        std::array<uint32_t, 2> previewSize{0, 0};
+        size_t slot = 0;  // Header slot holding this version; the next append uses the other
+    };
+
+    std::filesystem::path filePath_;
+    bool writable_ = false;
+
+    std::mutex saveMutex_;      // One save at a time
+    mutable std::mutex mutex_;  // Guards what follows, held briefly
+    std::shared_ptr<const ByteSource> source_;
+    Contents contents_;
+    uint64_t saveCount_ = 0;  // Distinguishes loads that raced a save
+
+    static Contents parse(ByteSpan data);
+};
+
+} // namespace QuantumCanvas::IO
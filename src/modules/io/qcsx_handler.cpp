@@ -0,0 +1,310 @@
+#include "qcsx_handler.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace QuantumCanvas::IO {
+
+namespace {
+
+// The handler works on the caller's thread; the manager already calls it
+// from a scheduler task
+template<typename T, typename Fn>
+std::future<T> runNow(Fn&& fn) {
+    std::promise<T> promise;
+    try {
+        promise.set_value(fn());
+    }
+    catch (...) {
+        promise.set_exception(std::current_exception());
+    }
+    return promise.get_future();
+}
+
+void appendLayer(const Raster::Layer& layer, uint32_t parentId, std::vector<QCSXLayer>& out) {
+    QCSXLayer record;
+    record.id = layer.getId();
+    record.parentId = parentId;
+    record.type = layer.getLayerType();
+
+    if (const auto* group = dynamic_cast<const Raster::LayerGroup*>(&layer)) {
+        // Children are records of their own, not part of the group's bytes
+        record.properties = group->Layer::serialize();
+        out.push_back(std::move(record));
+        for (size_t i = 0; i < group->getLayerCount(); ++i) {
+            appendLayer(*group->getLayer(i), layer.getId(), out);
+        }
+        return;
+    }
+
+    record.properties = layer.serialize();
+    if (const auto* raster = dynamic_cast<const Raster::RasterLayer*>(&layer)) {
+        if (const Image* image = raster->getImage()) {
+            record.image = std::make_shared<const Image>(*image);
+        }
+    }
+    out.push_back(std::move(record));
+}
+
+} // namespace
+
+QCSXHandler::QCSXHandler(Rendering::RenderingEngine& engine)
+    : engine_(engine) {
+}
+
+QCSXHandler::~QCSXHandler() = default;
+
+FormatCapabilities QCSXHandler::getCapabilities() const {
+    FormatCapabilities capabilities;
+    capabilities.supportsLayers = true;
+    capabilities.supportsRasterData = true;
+    capabilities.supportsMetadata = true;
+    capabilities.supportsCompression = true;
+    capabilities.supportsTransparency = true;
+    capabilities.supportsEffects = true;
+    capabilities.supportedBitDepths = {32};
+    capabilities.supportedColorModes = {FormatCapabilities::RGBA};
+    capabilities.maxWidth = UINT32_MAX;
+    capabilities.maxHeight = UINT32_MAX;
+    capabilities.compression.supportedTypes = {FormatCapabilities::CompressionSettings::None,
+                                               FormatCapabilities::CompressionSettings::ZIP};
+    capabilities.compression.defaultType = FormatCapabilities::CompressionSettings::ZIP;
+    return capabilities;
+}
+
+FormatDetectionResult QCSXHandler::detectFormat(const std::filesystem::path& filePath) const {
+    try {
+        return detectFormat(ByteSource::open(filePath, ByteSource::Access::Random).bytes());
+    }
+    catch (const std::exception&) {
+        return FormatDetectionResult{FileFormat::Unknown, 0.0f, "", {}, "file_not_found"};
+    }
+}
+
+FormatDetectionResult QCSXHandler::detectFormat(ByteSpan data) const {
+    if (!QCSXArchive::isQCSX(data)) {
+        return FormatDetectionResult{};
+    }
+    return FormatDetectionResult{FileFormat::QCSX, 1.0f, "application/x-quantumcanvas", {".qcsx"}, "magic"};
+}
+
+FileInfo QCSXHandler::getFileInfo(const std::filesystem::path& filePath) const {
+    FileInfo info;
+    try {
+        const ByteSource source = ByteSource::open(filePath, ByteSource::Access::Random);
+        info = getFileInfo(source.bytes());
+    }
+    catch (const std::exception& e) {
+        info.errorMessage = e.what();
+    }
+    info.filePath = filePath;
+    return info;
+}
+
+FileInfo QCSXHandler::getFileInfo(ByteSpan data) const {
+    FileInfo info;
+    info.format = FileFormat::QCSX;
+    info.fileSize = data.size();
+
+    const std::optional<QCSXArchive::Info> archive = QCSXArchive::readInfo(data);
+    if (!archive) {
+        info.errorMessage = "Not an intact QCSX file";
+        return info;
+    }
+    info.dimensions = archive->canvasSize;
+    info.bitDepth = 32;
+    info.channels = Image::CHANNELS;
+    info.layerCount = static_cast<uint32_t>(archive->layerCount);
+    info.hasTransparency = true;
+    info.isValid = true;
+    return info;
+}
+
+std::future<std::shared_ptr<Document>> QCSXHandler::loadDocument(
+    const std::filesystem::path& filePath,
+    const LoadOptions& options) {
+
+    return loadDocument(std::make_shared<const ByteSource>(
+        ByteSource::open(filePath, ByteSource::Access::Random)), options);
+}
+
+std::future<std::shared_ptr<Image>> QCSXHandler::loadImage(
+    const std::filesystem::path& filePath,
+    const LoadOptions& options) {
+
+    return runNow<std::shared_ptr<Image>>([&] {
+        QCSXArchive archive(filePath);
+        return flatten(archive, options);
+    });
+}
+
+std::future<std::shared_ptr<Document>> QCSXHandler::loadDocument(
+    std::shared_ptr<const ByteSource> source,
+    const LoadOptions& options) {
+
+    // There is no document model to fill yet; layered files are opened
+    // through QCSXArchive and restoreLayers()
+    return runNow<std::shared_ptr<Document>>([]() -> std::shared_ptr<Document> {
+        throw std::runtime_error("QCSX documents open through QCSXArchive");
+    });
+}
+
+std::future<std::shared_ptr<Image>> QCSXHandler::loadImage(
+    std::shared_ptr<const ByteSource> source,
+    const LoadOptions& options) {
+
+    return runNow<std::shared_ptr<Image>>([&] {
+        QCSXArchive archive(std::move(source));
+        return flatten(archive, options);
+    });
+}
+
+std::future<bool> QCSXHandler::saveDocument(
+    const std::shared_ptr<Document>& document,
+    const std::filesystem::path& filePath,
+    const SaveOptions& options) {
+
+    return runNow<bool>([]() -> bool {
+        throw std::runtime_error("QCSX documents save through QCSXArchive");
+    });
+}
+
+std::future<bool> QCSXHandler::saveImage(
+    const std::shared_ptr<Image>& image,
+    const std::filesystem::path& filePath,
+    const SaveOptions& options) {
+
+    return runNow<bool>([&] {
+        if (!image || image->empty()) {
+            throw std::invalid_argument("Cannot save an empty image as QCSX");
+        }
+        Raster::RasterLayer layer(std::make_unique<Image>(*image), "Background");
+        const std::shared_ptr<Image> preview = makePreview(*image, options);
+        QCSXArchive archive;
+        archive.save(filePath, image->getSize(), archiveLayers({&layer}), preview.get(), saveSettings(options));
+        return true;
+    });
+}
+
+std::shared_ptr<Image> QCSXHandler::extractThumbnail(ByteSpan data, const std::array<uint32_t, 2>& size) const {
+    return QCSXArchive::readPreview(data);
+}
+
+bool QCSXHandler::validateFile(const std::filesystem::path& filePath) const {
+    return getFileInfo(filePath).isValid;
+}
+
+std::vector<QCSXLayer> QCSXHandler::archiveLayers(const std::vector<const Raster::Layer*>& layers) {
+    std::vector<QCSXLayer> records;
+    for (const Raster::Layer* layer : layers) {
+        if (layer) {
+            appendLayer(*layer, 0, records);
+        }
+    }
+    return records;
+}
+
+std::vector<std::unique_ptr<Raster::Layer>> QCSXHandler::restoreLayers(QCSXArchive& archive, bool loadPixels) {
+    const std::vector<QCSXLayerInfo> records = archive.getLayers();
+    std::vector<std::unique_ptr<Raster::Layer>> roots;
+    std::unordered_map<uint32_t, Raster::LayerGroup*> groups;
+
+    for (size_t index = 0; index < records.size(); ++index) {
+        const QCSXLayerInfo& record = records[index];
+        std::unique_ptr<Raster::Layer> layer;
+        Raster::RasterLayer* raster = nullptr;
+        if (record.type == "RasterLayer") {
+            auto created = std::make_unique<Raster::RasterLayer>();
+            raster = created.get();
+            layer = std::move(created);
+        }
+        else if (record.type == "AdjustmentLayer") {
+            layer = std::make_unique<Raster::AdjustmentLayer>(Raster::AdjustmentLayer::Brightness);
+        }
+        else if (record.type == "LayerGroup") {
+            auto group = std::make_unique<Raster::LayerGroup>();
+            groups[record.id] = group.get();
+            layer = std::move(group);
+        }
+        else {
+            continue;  // Written by a newer version
+        }
+
+        if (!layer->deserialize(record.properties)) {
+            throw std::runtime_error("Corrupt QCSX layer properties: " + record.type);
+        }
+        if (raster && loadPixels && record.hasImage) {
+            raster->setImage(std::make_unique<Image>(*archive.loadImage(index)));
+        }
+
+        auto parent = groups.find(record.parentId);
+        if (record.parentId != 0 && parent != groups.end()) {
+            parent->second->addLayer(std::move(layer));
+        }
+        else {
+            roots.push_back(std::move(layer));
+        }
+    }
+    return roots;
+}
+
+bool QCSXHandler::loadPixels(QCSXArchive& archive, Raster::RasterLayer& layer) {
+    const std::optional<size_t> index = archive.findLayer(layer.getId());
+    if (!index) {
+        return false;
+    }
+    std::shared_ptr<Image> image = archive.loadImage(*index);
+    if (!image) {
+        return false;
+    }
+    layer.setImage(std::make_unique<Image>(*image));
+    return true;
+}
+
+QCSXSaveSettings QCSXHandler::saveSettings(const SaveOptions& options) {
+    QCSXSaveSettings settings;
+    settings.compressionLevel = options.qcsxOptions.compressImages ? options.qcsxOptions.compressionLevel : 0;
+    settings.incremental = options.qcsxOptions.incrementalSave;
+    return settings;
+}
+
+std::shared_ptr<Image> QCSXHandler::makePreview(const Image& image, const SaveOptions& options) {
+    if (!options.qcsxOptions.savePreview || image.empty()) {
+        return nullptr;
+    }
+    return ThumbnailPipeline::fit(image, options.qcsxOptions.previewSize);
+}
+
+std::shared_ptr<Image> QCSXHandler::flatten(QCSXArchive& archive, const LoadOptions& options) const {
+    const QCSXArchive::Info info = archive.getInfo();
+    const std::vector<QCSXLayerInfo> layers = archive.getLayers();
+
+    // A lone raster layer is the image, decoded reduced when a smaller one will do
+    if (layers.size() == 1 && layers[0].hasImage) {
+        const auto& size = layers[0].imageSize;
+        if (options.targetSize[0] > 0 && options.targetSize[1] > 0) {
+            DecodeRegion region;
+            region.scaleDenominator = DecodeRegion::scaleForZoom(
+                std::min(float(options.targetSize[0]) / float(size[0]), float(options.targetSize[1]) / float(size[1])));
+            if (region.scaleDenominator > 1) {
+                const auto outputSize = region.outputSize(size);
+                auto image = std::make_shared<Image>(outputSize[0], outputSize[1]);
+                archive.loadRegion(0, region, *image);
+                return image;
+            }
+        }
+        return archive.loadImage(0);
+    }
+
+    std::vector<std::unique_ptr<Raster::Layer>> tree = restoreLayers(archive, true);
+    std::vector<Raster::Layer*> roots;
+    for (const auto& layer : tree) {
+        roots.push_back(layer.get());
+    }
+    auto image = std::make_shared<Image>(info.canvasSize[0], info.canvasSize[1]);
+    Raster::LayerCompositor compositor(engine_);
+    compositor.compositeToImage(roots, *image);
+    return image;
+}
+
+} // namespace QuantumCanvas::IO
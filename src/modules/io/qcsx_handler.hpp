@@ -0,0 +1,85 @@
+#pragma once
+
+#include "file_format_manager.hpp"
+#include "qcsx_archive.hpp"
+#include "../raster/layer_compositor.hpp"
+#include <memory>
+#include <vector>
+
+namespace QuantumCanvas::IO {
+
+// Native QuantumCanvas format, stored through QCSXArchive
+//
+// Documents keep their archive open: restoreLayers() rebuilds the layer
+// tree from the table of contents alone and loadPixels() fills raster
+// layers when they are first shown, and saving the archiveLayers() of the
+// tree back through the same QCSXArchive appends only what changed.
+// Handler loads and saves go through a fresh archive each time: images
+// save as one raster layer, and layered files load as their CPU composite.
+class QCSXHandler final : public IFormatHandler {
+public:
+    explicit QCSXHandler(Rendering::RenderingEngine& engine);
+    ~QCSXHandler() override;
+
+    // IFormatHandler interface
+    FileFormat getFormat() const override { return FileFormat::QCSX; }
+    std::vector<std::string> getExtensions() const override { return {".qcsx"}; }
+    std::vector<std::string> getMimeTypes() const override { return {"application/x-quantumcanvas"}; }
+    FormatCapabilities getCapabilities() const override;
+
+    FormatDetectionResult detectFormat(const std::filesystem::path& filePath) const override;
+    FormatDetectionResult detectFormat(ByteSpan data) const override;
+
+    FileInfo getFileInfo(const std::filesystem::path& filePath) const override;
+    FileInfo getFileInfo(ByteSpan data) const override;
+
+    std::future<std::shared_ptr<Document>> loadDocument(
+        const std::filesystem::path& filePath,
+        const LoadOptions& options) override;
+
+    std::future<std::shared_ptr<Image>> loadImage(
+        const std::filesystem::path& filePath,
+        const LoadOptions& options) override;
+
+    std::future<std::shared_ptr<Document>> loadDocument(
+        std::shared_ptr<const ByteSource> source,
+        const LoadOptions& options) override;
+
+    std::future<std::shared_ptr<Image>> loadImage(
+        std::shared_ptr<const ByteSource> source,
+        const LoadOptions& options) override;
+
+    std::future<bool> saveDocument(
+        const std::shared_ptr<Document>& document,
+        const std::filesystem::path& filePath,
+        const SaveOptions& options) override;
+
+    std::future<bool> saveImage(
+        const std::shared_ptr<Image>& image,
+        const std::filesystem::path& filePath,
+        const SaveOptions& options) override;
+
+    // The preview saved with the file
+    std::shared_ptr<Image> extractThumbnail(ByteSpan data, const std::array<uint32_t, 2>& size) const override;
+
+    bool validateFile(const std::filesystem::path& filePath) const override;
+    bool canLoad() const override { return true; }
+    bool canSave() const override { return true; }
+
+    // Layer trees. archiveLayers() lists groups before their children;
+    // raster layers contribute a copy-on-write snapshot of their image, or
+    // nothing (keeping what is stored) if their pixels were never loaded.
+    static std::vector<QCSXLayer> archiveLayers(const std::vector<const Raster::Layer*>& layers);
+    static std::vector<std::unique_ptr<Raster::Layer>> restoreLayers(QCSXArchive& archive, bool loadPixels = false);
+    static bool loadPixels(QCSXArchive& archive, Raster::RasterLayer& layer);
+
+    static QCSXSaveSettings saveSettings(const SaveOptions& options);
+    static std::shared_ptr<Image> makePreview(const Image& image, const SaveOptions& options);
+
+private:
+    Rendering::RenderingEngine& engine_;
+
+    std::shared_ptr<Image> flatten(QCSXArchive& archive, const LoadOptions& options) const;
+};
+
+} // namespace QuantumCanvas::IO
@@ -0,0 +1,251 @@
+#include "region_decode.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace QuantumCanvas::IO {
+
+using Raster::Image;
+
+// DecodeRegion
+
+std::array<uint32_t, 4> DecodeRegion::resolve(const std::array<uint32_t, 2>& sourceSize) const {
+    if (rect == std::array<uint32_t, 4>{0, 0, 0, 0}) {
+        return {0, 0, sourceSize[0], sourceSize[1]};
+    }
+
+    const uint32_t x1 = std::min(rect[2], sourceSize[0]);
+    const uint32_t y1 = std::min(rect[3], sourceSize[1]);
+    return {std::min(rect[0], x1), std::min(rect[1], y1), x1, y1};
+}
+
+std::array<uint32_t, 2> DecodeRegion::outputSize(const std::array<uint32_t, 2>& sourceSize) const {
+    const std::array<uint32_t, 4> source = resolve(sourceSize);
+    const uint32_t n = std::max<uint32_t>(scaleDenominator, 1);
+    return {(source[2] - source[0] + n - 1) / n, (source[3] - source[1] + n - 1) / n};
+}
+
+DecodeRegion DecodeRegion::forView(const std::array<uint32_t, 4>& visibleRect, float zoom) {
+    DecodeRegion region;
+    region.rect = visibleRect;
+    region.scaleDenominator = scaleForZoom(zoom);
+    return region;
+}
+
+uint32_t DecodeRegion::scaleForZoom(float zoom) {
+    uint32_t scale = 1;
+    while (zoom > 0.0f && scale < (1u << 16) && zoom * static_cast<float>(scale * 2) <= 1.0f) {
+        scale *= 2;
+    }
+    return scale;
+}
+
+uint32_t DecodeRegion::nativeScaleFor(uint32_t scaleDenominator, const std::vector<uint32_t>& nativeScales) {
+    uint32_t best = 1;
+    for (uint32_t scale : nativeScales) {
+        if (scale > best && scaleDenominator % scale == 0) {
+            best = scale;
+        }
+    }
+    return best;
+}
+
+// RegionDecodeSink
+
+RegionDecodeSink::RegionDecodeSink(Image& target, const DecodeRegion& region,
+                                   const std::array<uint32_t, 2>& sourceSize, uint32_t channels,
+                                   SampleType sampleType, uint32_t inputScale)
+    : target_(target)
+    , targetOrigin_(region.targetOrigin)
+    , channels_(channels)
+    , sampleType_(sampleType) {
+    const uint32_t n = std::max<uint32_t>(region.scaleDenominator, 1);
+    if (channels < 1 || channels > 4) {
+        throw std::invalid_argument("RegionDecodeSink: channels must be 1 to 4");
+    }
+    if (inputScale == 0 || n % inputScale != 0) {
+        throw std::invalid_argument("RegionDecodeSink: input scale must divide the region's scale");
+    }
+
+    cellSize_ = n / inputScale;
+    inputSize_ = {(sourceSize[0] + inputScale - 1) / inputScale, (sourceSize[1] + inputScale - 1) / inputScale};
+    outputSize_ = region.outputSize(sourceSize);
+
+    // Rounded outward to whole input pixels, then cut to whole output cells
+    const std::array<uint32_t, 4> source = region.resolve(sourceSize);
+    for (int axis = 0; axis < 2; ++axis) {
+        const uint32_t begin = source[axis] / inputScale;
+        const uint32_t end = (source[axis + 2] + inputScale - 1) / inputScale;
+        inputRect_[axis] = begin;
+        inputRect_[axis + 2] = static_cast<uint32_t>(
+            std::min<uint64_t>({end, inputSize_[axis], begin + uint64_t(outputSize_[axis]) * cellSize_}));
+    }
+
+    auto cellWeights = [this](uint32_t begin, uint32_t end, uint32_t count) {
+        std::vector<float> weights(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint64_t cellBegin = begin + uint64_t(i) * cellSize_;
+            const uint64_t cellEnd = std::min<uint64_t>(cellBegin + cellSize_, end);
+            weights[i] = 1.0f / static_cast<float>(cellEnd - cellBegin);
+        }
+        return weights;
+    };
+    columnWeights_ = cellWeights(inputRect_[0], inputRect_[2], outputSize_[0]);
+    rowWeights_ = cellWeights(inputRect_[1], inputRect_[3], outputSize_[1]);
+
+    // Contributions accumulate, so the output starts at zero
+    const uint32_t x0 = std::min(targetOrigin_[0], target_.width());
+    const uint32_t y0 = std::min(targetOrigin_[1], target_.height());
+    const uint32_t x1 = static_cast<uint32_t>(std::min<uint64_t>(uint64_t(x0) + outputSize_[0], target_.width()));
+    const uint32_t y1 = static_cast<uint32_t>(std::min<uint64_t>(uint64_t(y0) + outputSize_[1], target_.height()));
+    for (uint32_t ty = y0 / Image::TILE_SIZE; x0 < x1 && ty * Image::TILE_SIZE < y1; ++ty) {
+        for (uint32_t tx = x0 / Image::TILE_SIZE; tx * Image::TILE_SIZE < x1; ++tx) {
+            float* tile = target_.mutableTileData(tx, ty);
+            const uint32_t tileX = tx * Image::TILE_SIZE;
+            const uint32_t tileY = ty * Image::TILE_SIZE;
+            const uint32_t cx0 = std::max(x0, tileX) - tileX;
+            const uint32_t cx1 = std::min(x1, tileX + Image::TILE_SIZE) - tileX;
+            const uint32_t cy0 = std::max(y0, tileY) - tileY;
+            const uint32_t cy1 = std::min(y1, tileY + Image::TILE_SIZE) - tileY;
+            for (uint32_t y = cy0; y < cy1; ++y) {
+                std::fill_n(tile + y * Image::TILE_STRIDE + cx0 * Image::CHANNELS,
+                            size_t(cx1 - cx0) * Image::CHANNELS, 0.0f);
+            }
+        }
+    }
+}
+
+bool RegionDecodeSink::intersects(uint32_t x, uint32_t y, uint32_t width, uint32_t height) const {
+    return uint64_t(x) + width > inputRect_[0] && x < inputRect_[2] &&
+           uint64_t(y) + height > inputRect_[1] && y < inputRect_[3];
+}
+
+size_t RegionDecodeSink::bytesPerPixel() const {
+    switch (sampleType_) {
+        case SampleType::UInt8: return channels_;
+        case SampleType::UInt16: return channels_ * sizeof(uint16_t);
+        case SampleType::Float32: return channels_ * sizeof(float);
+    }
+    return channels_;
+}
+
+Image::Pixel RegionDecodeSink::readPixel(const uint8_t* pixel) const {
+    float samples[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    for (uint32_t c = 0; c < channels_; ++c) {
+        switch (sampleType_) {
+            case SampleType::UInt8:
+                samples[c] = pixel[c] * (1.0f / 255.0f);
+                break;
+            case SampleType::UInt16: {
+                uint16_t value;
+                std::memcpy(&value, pixel + c * sizeof(uint16_t), sizeof(value));
+                samples[c] = value * (1.0f / 65535.0f);
+                break;
+            }
+            case SampleType::Float32:
+                std::memcpy(&samples[c], pixel + c * sizeof(float), sizeof(float));
+                break;
+        }
+    }
+
+    switch (channels_) {
+        case 1: return {samples[0], samples[0], samples[0], 1.0f};
+        case 2: return {samples[0], samples[0], samples[0], samples[1]};
+        case 3: return {samples[0], samples[1], samples[2], 1.0f};
+        default: return {samples[0], samples[1], samples[2], samples[3]};
+    }
+}
+
+void RegionDecodeSink::write(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                             const void* samples, size_t rowStride) {
+    const uint32_t x0 = std::max(x, inputRect_[0]);
+    const uint32_t x1 = static_cast<uint32_t>(std::min<uint64_t>(uint64_t(x) + width, inputRect_[2]));
+    const uint32_t y0 = std::max(y, inputRect_[1]);
+    const uint32_t y1 = static_cast<uint32_t>(std::min<uint64_t>(uint64_t(y) + height, inputRect_[3]));
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    const size_t pixelBytes = bytesPerPixel();
+    const auto* bytes = static_cast<const uint8_t*>(samples);
+    for (uint32_t iy = y0; iy < y1; ++iy) {
+        const uint32_t oy = (iy - inputRect_[1]) / cellSize_;
+        const uint64_t dy = uint64_t(targetOrigin_[1]) + oy;
+        if (dy >= target_.height()) {
+            break;
+        }
+
+        const uint8_t* row = bytes + (iy - y) * rowStride;
+        const float rowWeight = rowWeights_[oy];
+        const uint32_t tileY = static_cast<uint32_t>(dy / Image::TILE_SIZE);
+        const size_t rowOffset = (dy % Image::TILE_SIZE) * Image::TILE_STRIDE;
+
+        uint32_t cachedTile = UINT32_MAX;
+        float* tile = nullptr;
+        for (uint32_t ix = x0; ix < x1;) {
+            const uint32_t ox = (ix - inputRect_[0]) / cellSize_;
+            const uint64_t dx = uint64_t(targetOrigin_[0]) + ox;
+            if (dx >= target_.width()) {
+                break;
+            }
+
+            // Sum the row's pixels in this cell before weighting them, which
+            // keeps large cells accurate in single precision
+            const auto cellEnd = static_cast<uint32_t>(
+                std::min<uint64_t>(x1, inputRect_[0] + (uint64_t(ox) + 1) * cellSize_));
+            Image::Pixel sum{0.0f, 0.0f, 0.0f, 0.0f};
+            for (; ix < cellEnd; ++ix) {
+                const Image::Pixel pixel = readPixel(row + size_t(ix - x) * pixelBytes);
+                for (uint32_t c = 0; c < Image::CHANNELS; ++c) {
+                    sum[c] += pixel[c];
+                }
+            }
+
+            const uint32_t tileX = static_cast<uint32_t>(dx / Image::TILE_SIZE);
+            if (tileX != cachedTile) {
+                tile = target_.mutableTileData(tileX, tileY);
+                cachedTile = tileX;
+            }
+
+            const float weight = rowWeight * columnWeights_[ox];
+            float* out = tile + rowOffset + (dx % Image::TILE_SIZE) * Image::CHANNELS;
+            for (uint32_t c = 0; c < Image::CHANNELS; ++c) {
+                out[c] += weight * sum[c];
+            }
+        }
+    }
+}
+
+void RegionDecodeSink::writeImage(const Image& decoded) {
+    if (sampleType_ != SampleType::Float32 || channels_ != Image::CHANNELS) {
+        throw std::invalid_argument("RegionDecodeSink: writeImage needs 4-channel float samples");
+    }
+
+    std::vector<float> fillRow;
+    for (uint32_t ty = 0; ty < decoded.tilesY(); ++ty) {
+        for (uint32_t tx = 0; tx < decoded.tilesX(); ++tx) {
+            const uint32_t x = tx * Image::TILE_SIZE;
+            const uint32_t y = ty * Image::TILE_SIZE;
+            const uint32_t width = std::min(Image::TILE_SIZE, decoded.width() - x);
+            const uint32_t height = std::min(Image::TILE_SIZE, decoded.height() - y);
+            if (!intersects(x, y, width, height)) {
+                continue;
+            }
+
+            if (const float* tile = decoded.tileData(tx, ty)) {
+                write(x, y, width, height, tile, Image::TILE_STRIDE * sizeof(float));
+            }
+            else {
+                // Unallocated tiles read as the fill color; repeat one row of it
+                if (fillRow.empty()) {
+                    for (uint32_t i = 0; i < Image::TILE_SIZE; ++i) {
+                        fillRow.insert(fillRow.end(), decoded.fillColor().begin(), decoded.fillColor().end());
+                    }
+                }
+                write(x, y, width, height, fillRow.data(), 0);
+            }
+        }
+    }
+}
+
+} // namespace QuantumCanvas::IO
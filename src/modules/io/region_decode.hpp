@@ -0,0 +1,104 @@
+#pragma once
+
+#include "../raster/raster_image.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace QuantumCanvas::IO {
+
+// Part of a source image to decode, and the scale to decode it at
+struct DecodeRegion {
+    std::array<uint32_t, 4> rect{0, 0, 0, 0};    // {x0, y0, x1, y1} in source pixels; empty = whole image
+    uint32_t scaleDenominator = 1;               // Decode at 1/n of the source resolution
+    std::array<uint32_t, 2> targetOrigin{0, 0};  // Target pixel receiving the region's top-left output pixel
+
+    // rect clamped to the source; the whole source when rect is empty
+    std::array<uint32_t, 4> resolve(const std::array<uint32_t, 2>& sourceSize) const;
+    // Pixels written to the target: each output pixel averages an n x n
+    // cell of source pixels, cells at the right and bottom edges fewer
+    std::array<uint32_t, 2> outputSize(const std::array<uint32_t, 2>& sourceSize) const;
+
+    // The visible part of a source shown at zoom (screen pixels per source
+    // pixel), at the coarsest power-of-two scale that keeps full detail, so a
+    // fit-to-screen view decodes about as many pixels as it shows
+    static DecodeRegion forView(const std::array<uint32_t, 4>& visibleRect, float zoom);
+    static uint32_t scaleForZoom(float zoom);
+    // Largest of a codec's native reductions that divides the requested one
+    static uint32_t nativeScaleFor(uint32_t scaleDenominator, const std::vector<uint32_t>& nativeScales);
+};
+
+// Writes decoded source pixels straight into the tiles of a Raster::Image,
+// clipped to a region and box-filtered down to its scale
+//
+// Codecs push whatever they decode: full-width rows from sequential PNG and
+// JPEG decoders, or tiles and strips from TIFF, in any order. Pixels outside
+// the region are dropped, so a codec can ask intersects() first and skip
+// blocks it does not need. Each source pixel contributes a fixed weight to
+// one output pixel, so no intermediate full-resolution buffer exists; the
+// target holds only the reduced region.
+//
+// A codec that reduces natively, such as JPEG scaling in the DCT domain,
+// passes its own factor as inputScale and writes pixels in its reduced
+// coordinates; the sink reduces by what remains. inputScale must divide the
+// region's scale denominator.
+//
+// Not thread-safe: blocks written from several threads must not share
+// target tiles, or must be serialized.
+class RegionDecodeSink final {
+public:
+    enum class SampleType {
+        UInt8,
+        UInt16,   // Native byte order
+        Float32
+    };
+
+    // channels: 1 gray, 2 gray + alpha, 3 RGB, 4 RGBA. Zeroes the output
+    // rectangle in target; output beyond the target's bounds is dropped.
+    // Throws std::invalid_argument for bad channel counts or scales.
+    RegionDecodeSink(Raster::Image& target, const DecodeRegion& region,
+                     const std::array<uint32_t, 2>& sourceSize, uint32_t channels,
+                     SampleType sampleType, uint32_t inputScale = 1);
+
+    // Pixels the codec decodes, in its own coordinates
+    const std::array<uint32_t, 2>& inputSize() const { return inputSize_; }
+    // The input rectangle {x0, y0, x1, y1} that reaches the output
+    const std::array<uint32_t, 4>& inputRect() const { return inputRect_; }
+    bool intersects(uint32_t x, uint32_t y, uint32_t width, uint32_t height) const;
+    // Sequential decoders can stop before this input row
+    uint32_t endInputRow() const { return inputRect_[3]; }
+
+    const std::array<uint32_t, 2>& outputSize() const { return outputSize_; }
+
+    // A width x height block of input pixels at (x, y), rows rowStride bytes
+    // apart; a stride of zero repeats the first row
+    void write(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+               const void* samples, size_t rowStride);
+    void writeRows(uint32_t y, uint32_t rowCount, const void* samples, size_t rowStride) {
+        write(0, y, inputSize_[0], rowCount, samples, rowStride);
+    }
+
+    // Feeds a fully decoded image, for codecs without a region decoder;
+    // requires Float32 samples with 4 channels
+    void writeImage(const Raster::Image& decoded);
+
+private:
+    Raster::Image& target_;
+    std::array<uint32_t, 2> targetOrigin_;
+    std::array<uint32_t, 2> inputSize_;
+    std::array<uint32_t, 4> inputRect_;
+    std::array<uint32_t, 2> outputSize_;
+    uint32_t cellSize_;  // Input pixels per output pixel, per axis
+    uint32_t channels_;
+    SampleType sampleType_;
+
+    // 1 / input pixels averaged into each output column and row
+    std::vector<float> columnWeights_;
+    std::vector<float> rowWeights_;
+
+    Raster::Image::Pixel readPixel(const uint8_t* pixel) const;
+    size_t bytesPerPixel() const;
+};
+
+} // namespace QuantumCanvas::IO
@@ -0,0 +1,787 @@
+#include "svg_stream_parser.hpp"
+#include "../../core/kernel/telemetry.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <stdexcept>
+#include <zlib.h>
+
+namespace QuantumCanvas::IO {
+
+namespace {
+
+constexpr float DEGREES_TO_RADIANS = 3.14159265358979323846f / 180.0f;
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool isGzip(ByteSpan data) {
+    return data.size() >= 2 && data[0] == 0x1F && data[1] == 0x8B;
+}
+
+std::vector<uint8_t> inflateGzip(ByteSpan data) {
+    z_stream stream{};
+    if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) {
+        throw std::runtime_error("Cannot initialize gzip decompression");
+    }
+
+    std::vector<uint8_t> output(std::max<size_t>(data.size() * 4, 1 << 16));
+    size_t consumed = 0;
+    int status = Z_OK;
+    while (status != Z_STREAM_END) {
+        if (stream.avail_in == 0 && consumed < data.size()) {
+            const size_t chunk = std::min<size_t>(data.size() - consumed, UINT_MAX);
+            stream.next_in = const_cast<Bytef*>(data.data() + consumed);
+            stream.avail_in = static_cast<uInt>(chunk);
+            consumed += chunk;
+        }
+        if (stream.total_out == output.size()) {
+            output.resize(output.size() * 2);
+        }
+        const size_t produced = stream.total_out;
+        stream.next_out = output.data() + produced;
+        stream.avail_out = static_cast<uInt>(std::min<size_t>(output.size() - produced, UINT_MAX));
+
+        status = inflate(&stream, Z_NO_FLUSH);
+        if (status != Z_OK && status != Z_STREAM_END) {
+            inflateEnd(&stream);
+            throw std::runtime_error("Corrupt gzip-compressed SVG");
+        }
+        if (status == Z_OK && stream.avail_in == 0 && consumed == data.size() && stream.avail_out != 0) {
+            inflateEnd(&stream);
+            throw std::runtime_error("Truncated gzip-compressed SVG");
+        }
+    }
+    output.resize(stream.total_out);
+    inflateEnd(&stream);
+    return output;
+}
+
+void appendUtf8(uint32_t codePoint, std::string& out) {
+    if (codePoint < 0x80) {
+        out += static_cast<char>(codePoint);
+    }
+    else if (codePoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+    else if (codePoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+    else {
+        out += static_cast<char>(0xF0 | (codePoint >> 18));
+        out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+// Numbers, flags and command letters from path data and point lists, with
+// any mix of whitespace and commas between them
+class NumberScanner {
+public:
+    explicit NumberScanner(std::string_view text) : text_(text) {}
+
+    bool atEnd() {
+        skipSeparators();
+        return pos_ >= text_.size();
+    }
+
+    bool startsNumber() {
+        skipSeparators();
+        if (pos_ >= text_.size()) {
+            return false;
+        }
+        const char c = text_[pos_];
+        return (c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+';
+    }
+
+    bool number(float& value) {
+        if (!startsNumber()) {
+            return false;
+        }
+        const char* begin = text_.data() + pos_;
+        const char* end = text_.data() + text_.size();
+        if (*begin == '+') {
+            ++begin;  // from_chars takes no leading plus
+        }
+        const auto [next, error] = std::from_chars(begin, end, value);
+        if (error != std::errc()) {
+            return false;
+        }
+        pos_ = static_cast<size_t>(next - text_.data());
+        return true;
+    }
+
+    // Arc flags are a single digit and need no separator: "a1 1 0 01 5 5"
+    bool flag(float& value) {
+        skipSeparators();
+        if (pos_ >= text_.size() || (text_[pos_] != '0' && text_[pos_] != '1')) {
+            return false;
+        }
+        value = text_[pos_++] == '1' ? 1.0f : 0.0f;
+        return true;
+    }
+
+    char command() {
+        skipSeparators();
+        return pos_ < text_.size() ? text_[pos_++] : '\0';
+    }
+
+private:
+    std::string_view text_;
+    size_t pos_ = 0;
+
+    void skipSeparators() {
+        while (pos_ < text_.size() && (isSpace(text_[pos_]) || text_[pos_] == ',')) {
+            ++pos_;
+        }
+    }
+};
+
+bool isPathCommand(char c) {
+    switch (c) {
+        case 'M': case 'm': case 'L': case 'l': case 'H': case 'h': case 'V': case 'v':
+        case 'C': case 'c': case 'S': case 's': case 'Q': case 'q': case 'T': case 't':
+        case 'A': case 'a': case 'Z': case 'z':
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Element names whose character data is kept
+bool keepsText(SVGNameTable::Id name) {
+    return name == SVGNameTable::Text || name == SVGNameTable::Tspan || name == SVGNameTable::Title ||
+           name == SVGNameTable::Desc || name == SVGNameTable::Style;
+}
+
+} // namespace
+
+// SVGTokenizer
+SVGTokenizer::Token SVGTokenizer::next() {
+    if (pendingEnd_) {
+        pendingEnd_ = false;
+        attributes_.clear();
+        return Token::EndElement;
+    }
+
+    while (pos_ < input_.size()) {
+        if (input_[pos_] != '<') {
+            const size_t end = std::min(input_.find('<', pos_), input_.size());
+            text_ = input_.substr(pos_, end - pos_);
+            cdata_ = false;
+            pos_ = end;
+            return Token::Text;
+        }
+
+        const std::string_view rest = input_.substr(pos_);
+        if (rest.starts_with("<!--")) {
+            pos_ += 4;
+            skipPast("-->", "comment");
+        }
+        else if (rest.starts_with("<![CDATA[")) {
+            const size_t start = pos_ + 9;
+            const size_t end = input_.find("]]>", start);
+            if (end == std::string_view::npos) {
+                fail("Unterminated CDATA section");
+            }
+            text_ = input_.substr(start, end - start);
+            cdata_ = true;
+            pos_ = end + 3;
+            return Token::Text;
+        }
+        else if (rest.starts_with("<!")) {
+            skipDeclaration();
+        }
+        else if (rest.starts_with("<?")) {
+            pos_ += 2;
+            skipPast("?>", "processing instruction");
+        }
+        else {
+            return readTag();
+        }
+    }
+    return Token::End;
+}
+
+SVGTokenizer::Token SVGTokenizer::readTag() {
+    ++pos_;  // '<'
+    const bool closing = pos_ < input_.size() && input_[pos_] == '/';
+    if (closing) {
+        ++pos_;
+    }
+    name_ = readName();
+    if (name_.empty()) {
+        fail("Expected an element name");
+    }
+    attributes_.clear();
+
+    if (closing) {
+        skipWhitespace();
+        if (pos_ >= input_.size() || input_[pos_] != '>') {
+            fail("Expected '>' to close </" + std::string(name_) + ">");
+        }
+        ++pos_;
+        return Token::EndElement;
+    }
+
+    for (;;) {
+        skipWhitespace();
+        if (pos_ >= input_.size()) {
+            fail("Unterminated <" + std::string(name_) + "> tag");
+        }
+        if (input_[pos_] == '>') {
+            ++pos_;
+            return Token::StartElement;
+        }
+        if (input_[pos_] == '/') {
+            if (pos_ + 1 >= input_.size() || input_[pos_ + 1] != '>') {
+                fail("Expected '/>' in <" + std::string(name_) + ">");
+            }
+            pos_ += 2;
+            pendingEnd_ = true;
+            return Token::StartElement;
+        }
+
+        Attribute attribute;
+        attribute.name = readName();
+        if (attribute.name.empty()) {
+            fail("Expected an attribute name in <" + std::string(name_) + ">");
+        }
+        skipWhitespace();
+        if (pos_ >= input_.size() || input_[pos_] != '=') {
+            fail("Expected '=' after attribute " + std::string(attribute.name));
+        }
+        ++pos_;
+        skipWhitespace();
+        if (pos_ >= input_.size() || (input_[pos_] != '"' && input_[pos_] != '\'')) {
+            fail("Expected a quoted value for attribute " + std::string(attribute.name));
+        }
+        const char quote = input_[pos_++];
+        const size_t end = input_.find(quote, pos_);
+        if (end == std::string_view::npos) {
+            fail("Unterminated value of attribute " + std::string(attribute.name));
+        }
+        attribute.value = input_.substr(pos_, end - pos_);
+        pos_ = end + 1;
+        attributes_.push_back(attribute);
+    }
+}
+
+void SVGTokenizer::skipPast(std::string_view terminator, const char* construct) {
+    const size_t end = input_.find(terminator, pos_);
+    if (end == std::string_view::npos) {
+        fail(std::string("Unterminated ") + construct);
+    }
+    pos_ = end + terminator.size();
+}
+
+// <!DOCTYPE ...>, possibly with an internal subset in brackets; the
+// entities it declares are not expanded
+void SVGTokenizer::skipDeclaration() {
+    int depth = 0;
+    char quote = '\0';
+    for (size_t i = pos_ + 2; i < input_.size(); ++i) {
+        const char c = input_[i];
+        if (quote != '\0') {
+            if (c == quote) quote = '\0';
+        }
+        else if (c == '"' || c == '\'') {
+            quote = c;
+        }
+        else if (c == '[') {
+            ++depth;
+        }
+        else if (c == ']') {
+            --depth;
+        }
+        else if (c == '>' && depth <= 0) {
+            pos_ = i + 1;
+            return;
+        }
+    }
+    fail("Unterminated declaration");
+}
+
+std::string_view SVGTokenizer::readName() {
+    const size_t start = pos_;
+    while (pos_ < input_.size()) {
+        const char c = input_[pos_];
+        if (isSpace(c) || c == '/' || c == '>' || c == '=' || c == '<' || c == '"' || c == '\'') {
+            break;
+        }
+        ++pos_;
+    }
+    return input_.substr(start, pos_ - start);
+}
+
+void SVGTokenizer::skipWhitespace() {
+    while (pos_ < input_.size() && isSpace(input_[pos_])) {
+        ++pos_;
+    }
+}
+
+void SVGTokenizer::fail(const std::string& message) const {
+    throw std::runtime_error("Malformed SVG at byte " + std::to_string(pos_) + ": " + message);
+}
+
+void SVGTokenizer::decodeEntities(std::string_view raw, std::string& out) {
+    out.reserve(out.size() + raw.size());
+    size_t pos = 0;
+    while (pos < raw.size()) {
+        const size_t amp = raw.find('&', pos);
+        if (amp == std::string_view::npos) {
+            out.append(raw.substr(pos));
+            return;
+        }
+        out.append(raw.substr(pos, amp - pos));
+
+        const size_t semicolon = raw.find(';', amp);
+        if (semicolon == std::string_view::npos || semicolon - amp > 10) {
+            out += '&';
+            pos = amp + 1;
+            continue;
+        }
+        const std::string_view reference = raw.substr(amp + 1, semicolon - amp - 1);
+        pos = semicolon + 1;
+
+        if (reference == "lt") out += '<';
+        else if (reference == "gt") out += '>';
+        else if (reference == "amp") out += '&';
+        else if (reference == "quot") out += '"';
+        else if (reference == "apos") out += '\'';
+        else if (reference.size() > 1 && reference[0] == '#') {
+            const bool hex = reference[1] == 'x' || reference[1] == 'X';
+            const std::string_view digits = reference.substr(hex ? 2 : 1);
+            uint32_t codePoint = 0;
+            const auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), codePoint, hex ? 16 : 10);
+            if (error == std::errc() && end == digits.data() + digits.size() && codePoint <= 0x10FFFF) {
+                appendUtf8(codePoint, out);
+            }
+            else {
+                out.append(raw.substr(amp, pos - amp));
+            }
+        }
+        else {
+            out.append(raw.substr(amp, pos - amp));  // Declared in a DOCTYPE, or a typo
+        }
+    }
+}
+
+// SVGNameTable
+SVGNameTable::SVGNameTable() {
+    static constexpr std::array<std::string_view, KnownCount> known = {
+        "svg", "g", "path", "rect", "circle", "ellipse", "line", "polyline", "polygon",
+        "text", "tspan", "use", "symbol", "defs", "linearGradient", "radialGradient", "stop", "pattern",
+        "title", "desc", "style",
+        "id", "class", "transform", "d", "points", "x", "y", "width", "height", "viewBox",
+        "href", "xlink:href", "fill", "stroke", "opacity"
+    };
+    for (std::string_view name : known) {
+        intern(name);
+    }
+}
+
+SVGNameTable::Id SVGNameTable::intern(std::string_view name) {
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    const Id id = static_cast<Id>(names_.size());
+    names_.emplace_back(name);
+    ids_.emplace(names_.back(), id);
+    return id;
+}
+
+SVGNameTable::Id SVGNameTable::find(std::string_view name) const {
+    auto it = ids_.find(name);
+    return it != ids_.end() ? it->second : None;
+}
+
+// SVGPathStore
+uint32_t SVGPathStore::addPathData(std::string_view data) {
+    const size_t firstVerb = verbs_.size();
+    const size_t firstPoint = points_.size();
+
+    NumberScanner in(data);
+    float cx = 0.0f, cy = 0.0f;  // Current point
+    float sx = 0.0f, sy = 0.0f;  // Start of the subpath, where Z returns to
+    float kx = 0.0f, ky = 0.0f;  // Last control point, reflected by S and T
+    char previous = '\0';        // Last command, in upper case
+    char command = '\0';
+    bool complete = true;
+
+    auto emit = [this](SVGPathVerb verb, std::initializer_list<float> points) {
+        verbs_.push_back(verb);
+        points_.insert(points_.end(), points);
+    };
+
+    while (!in.atEnd()) {
+        if (in.startsNumber()) {
+            // Repeated arguments repeat the command; after a moveto, as lineto
+            if (command == '\0' || command == 'Z' || command == 'z') {
+                complete = false;
+                break;
+            }
+            if (command == 'M') command = 'L';
+            else if (command == 'm') command = 'l';
+        }
+        else {
+            command = in.command();
+            if (!isPathCommand(command)) {
+                complete = false;
+                break;
+            }
+        }
+        if (verbs_.size() == firstVerb && command != 'M' && command != 'm') {
+            complete = false;  // Path data must begin with a moveto
+            break;
+        }
+
+        const bool relative = command >= 'a';
+        const char upper = relative ? static_cast<char>(command - ('a' - 'A')) : command;
+        const float ox = relative ? cx : 0.0f;
+        const float oy = relative ? cy : 0.0f;
+        float v[7];
+        auto read = [&](int count) {
+            for (int i = 0; i < count; ++i) {
+                if (!in.number(v[i])) return false;
+            }
+            return true;
+        };
+
+        bool ok = true;
+        switch (upper) {
+            case 'M':
+                if ((ok = read(2))) {
+                    cx = sx = ox + v[0];
+                    cy = sy = oy + v[1];
+                    emit(SVGPathVerb::MoveTo, {cx, cy});
+                }
+                break;
+
+            case 'L':
+                if ((ok = read(2))) {
+                    cx = ox + v[0];
+                    cy = oy + v[1];
+                    emit(SVGPathVerb::LineTo, {cx, cy});
+                }
+                break;
+
+            case 'H':
+                if ((ok = read(1))) {
+                    cx = ox + v[0];
+                    emit(SVGPathVerb::LineTo, {cx, cy});
+                }
+                break;
+
+            case 'V':
+                if ((ok = read(1))) {
+                    cy = oy + v[0];
+                    emit(SVGPathVerb::LineTo, {cx, cy});
+                }
+                break;
+
+            case 'C':
+            case 'S': {
+                float x1, y1;
+                if (upper == 'C') {
+                    if (!(ok = read(6))) break;
+                    x1 = ox + v[0];
+                    y1 = oy + v[1];
+                    std::copy(v + 2, v + 6, v);
+                }
+                else {
+                    if (!(ok = read(4))) break;
+                    const bool smooth = previous == 'C' || previous == 'S';
+                    x1 = smooth ? 2.0f * cx - kx : cx;
+                    y1 = smooth ? 2.0f * cy - ky : cy;
+                }
+                kx = ox + v[0];
+                ky = oy + v[1];
+                cx = ox + v[2];
+                cy = oy + v[3];
+                emit(SVGPathVerb::CurveTo, {x1, y1, kx, ky, cx, cy});
+                break;
+            }
+
+            case 'Q':
+            case 'T':
+                if (upper == 'Q') {
+                    if (!(ok = read(4))) break;
+                    kx = ox + v[0];
+                    ky = oy + v[1];
+                    cx = ox + v[2];
+                    cy = oy + v[3];
+                }
+                else {
+                    if (!(ok = read(2))) break;
+                    const bool smooth = previous == 'Q' || previous == 'T';
+                    kx = smooth ? 2.0f * cx - kx : cx;
+                    ky = smooth ? 2.0f * cy - ky : cy;
+                    cx = ox + v[0];
+                    cy = oy + v[1];
+                }
+                emit(SVGPathVerb::QuadTo, {kx, ky, cx, cy});
+                break;
+
+            case 'A': {
+                ok = in.number(v[0]) && in.number(v[1]) && in.number(v[2]) &&
+                     in.flag(v[3]) && in.flag(v[4]) && in.number(v[5]) && in.number(v[6]);
+                if (!ok) break;
+                const float x = ox + v[5];
+                const float y = oy + v[6];
+                if (x == cx && y == cy) {
+                    break;  // Arcs to the current point are omitted
+                }
+                if (v[0] == 0.0f || v[1] == 0.0f) {
+                    emit(SVGPathVerb::LineTo, {x, y});
+                }
+                else {
+                    emit(SVGPathVerb::ArcTo, {x, y, std::abs(v[0]), std::abs(v[1]),
+                                              v[2] * DEGREES_TO_RADIANS, v[3], v[4]});
+                }
+                cx = x;
+                cy = y;
+                break;
+            }
+
+            case 'Z':
+                emit(SVGPathVerb::ClosePath, {});
+                cx = sx;
+                cy = sy;
+                break;
+        }
+        if (!ok) {
+            complete = false;
+            break;
+        }
+        previous = upper;
+    }
+    return finish(firstVerb, firstPoint, complete);
+}
+
+uint32_t SVGPathStore::addPoints(std::string_view points, bool closed) {
+    const size_t firstVerb = verbs_.size();
+    const size_t firstPoint = points_.size();
+
+    NumberScanner in(points);
+    bool complete = true;
+    while (!in.atEnd()) {
+        float x, y;
+        if (!in.number(x) || !in.number(y)) {
+            complete = false;  // Odd coordinate count or junk: keep the pairs before it
+            break;
+        }
+        verbs_.push_back(verbs_.size() == firstVerb ? SVGPathVerb::MoveTo : SVGPathVerb::LineTo);
+        points_.push_back(x);
+        points_.push_back(y);
+    }
+    if (closed && verbs_.size() > firstVerb) {
+        verbs_.push_back(SVGPathVerb::ClosePath);
+    }
+    return finish(firstVerb, firstPoint, complete);
+}
+
+uint32_t SVGPathStore::finish(size_t firstVerb, size_t firstPoint, bool complete) {
+    Range range;
+    range.firstVerb = static_cast<uint32_t>(firstVerb);
+    range.verbCount = static_cast<uint32_t>(verbs_.size() - firstVerb);
+    range.firstPoint = static_cast<uint32_t>(firstPoint);
+    range.pointCount = static_cast<uint32_t>(points_.size() - firstPoint);
+    range.complete = complete;
+    ranges_.push_back(range);
+    return static_cast<uint32_t>(ranges_.size() - 1);
+}
+
+SVGPathStore::Path SVGPathStore::get(uint32_t index) const {
+    const Range& range = ranges_.at(index);
+    Path path;
+    path.verbs = std::span<const SVGPathVerb>(verbs_.data() + range.firstVerb, range.verbCount);
+    path.points = std::span<const float>(points_.data() + range.firstPoint, range.pointCount);
+    path.complete = range.complete;
+    return path;
+}
+
+// SVGElementStore
+SVGElementStore SVGElementStore::parse(std::shared_ptr<const ByteSource> source) {
+    if (!source) {
+        throw std::invalid_argument("No SVG source to parse");
+    }
+    QCS_TRACE_SCOPE("io.svg_parse");
+    const auto started = std::chrono::steady_clock::now();
+
+    if (isGzip(source->bytes())) {
+        source = std::make_shared<const ByteSource>(ByteSource::fromBuffer(inflateGzip(source->bytes())));
+    }
+    SVGElementStore store;
+    store.source_ = std::move(source);
+    store.build();
+
+    store.stats_.parseTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started);
+    return store;
+}
+
+SVGElementStore SVGElementStore::parse(const std::filesystem::path& filePath) {
+    return parse(std::make_shared<const ByteSource>(ByteSource::open(filePath, ByteSource::Access::Sequential)));
+}
+
+SVGElementStore SVGElementStore::parseText(std::string_view text) {
+    return parse(std::make_shared<const ByteSource>(ByteSource::fromBuffer(
+        std::vector<uint8_t>(text.begin(), text.end()))));
+}
+
+void SVGElementStore::build() {
+    const std::string_view input(reinterpret_cast<const char*>(source_->data()), source_->size());
+    SVGTokenizer tokens(input);
+    std::vector<uint32_t> open;       // Elements whose end tag is still to come
+    std::vector<uint32_t> lastChild;  // Of each open element, for linking siblings
+
+    for (;;) {
+        switch (tokens.next()) {
+            case SVGTokenizer::Token::StartElement: {
+                if (open.empty() && !elements_.empty()) {
+                    throw std::runtime_error("SVG has more than one root element");
+                }
+                const uint32_t index = static_cast<uint32_t>(elements_.size());
+                Element element;
+                element.name = names_.intern(tokens.name());
+                if (open.empty() && element.name != SVGNameTable::Svg) {
+                    throw std::runtime_error("Not an SVG document: the root element is <" +
+                                             std::string(tokens.name()) + ">");
+                }
+                if (!open.empty()) {
+                    element.parent = open.back();
+                    uint32_t& last = lastChild.back();
+                    (last == None ? elements_[element.parent].firstChild : elements_[last].nextSibling) = index;
+                    last = index;
+                }
+
+                element.firstAttribute = static_cast<uint32_t>(attributes_.size());
+                element.attributeCount = static_cast<uint32_t>(tokens.attributes().size());
+                std::string_view geometry;
+                bool hasGeometry = false;
+                for (const SVGTokenizer::Attribute& raw : tokens.attributes()) {
+                    Attribute attribute{names_.intern(raw.name), decoded(raw.value)};
+                    if (attribute.name == SVGNameTable::IdAttribute) {
+                        ids_.emplace(attribute.value, index);
+                    }
+                    else if ((attribute.name == SVGNameTable::D && element.name == SVGNameTable::Path) ||
+                             (attribute.name == SVGNameTable::Points &&
+                              (element.name == SVGNameTable::Polyline || element.name == SVGNameTable::Polygon))) {
+                        geometry = attribute.value;
+                        hasGeometry = true;
+                    }
+                    attributes_.push_back(attribute);
+                }
+                if (hasGeometry) {
+                    element.path = element.name == SVGNameTable::Path
+                        ? paths_.addPathData(geometry)
+                        : paths_.addPoints(geometry, element.name == SVGNameTable::Polygon);
+                    if (!paths_.get(element.path).complete) {
+                        ++stats_.malformedPathCount;
+                    }
+                }
+
+                elements_.push_back(element);
+                open.push_back(index);
+                lastChild.push_back(None);
+                break;
+            }
+
+            case SVGTokenizer::Token::EndElement:
+                if (open.empty() || names_.name(elements_[open.back()].name) != tokens.name()) {
+                    throw std::runtime_error("Mismatched </" + std::string(tokens.name()) + "> at byte " +
+                                             std::to_string(tokens.offset()));
+                }
+                open.pop_back();
+                lastChild.pop_back();
+                break;
+
+            case SVGTokenizer::Token::Text:
+                // Text outside the root can only be whitespace; it is ignored either way
+                if (!open.empty() && keepsText(elements_[open.back()].name)) {
+                    appendText(elements_[open.back()], tokens.text(), tokens.isCData());
+                }
+                break;
+
+            case SVGTokenizer::Token::End:
+                if (!open.empty()) {
+                    throw std::runtime_error("SVG ends inside <" +
+                                             std::string(names_.name(elements_[open.back()].name)) + ">");
+                }
+                if (elements_.empty()) {
+                    throw std::runtime_error("Not an SVG document: no root element");
+                }
+                stats_.elementCount = elements_.size();
+                stats_.attributeCount = attributes_.size();
+                stats_.pathCount = paths_.size();
+                stats_.bytesParsed = source_->size();
+                return;
+        }
+    }
+}
+
+std::string_view SVGElementStore::decoded(std::string_view raw) {
+    if (raw.find('&') == std::string_view::npos) {
+        return raw;
+    }
+    std::string& value = strings_.emplace_back();
+    SVGTokenizer::decodeEntities(raw, value);
+    return value;
+}
+
+void SVGElementStore::appendText(Element& element, std::string_view raw, bool literal) {
+    const std::string_view piece = literal ? raw : decoded(raw);
+    if (element.text.empty()) {
+        element.text = piece;
+        return;
+    }
+    std::string& joined = strings_.emplace_back(element.text);
+    joined.append(piece);
+    element.text = joined;
+}
+
+std::span<const SVGElementStore::Attribute> SVGElementStore::attributes(uint32_t index) const {
+    const Element& element = elements_[index];
+    return std::span<const Attribute>(attributes_.data() + element.firstAttribute, element.attributeCount);
+}
+
+std::string_view SVGElementStore::attribute(uint32_t index, SVGNameTable::Id name) const {
+    for (const Attribute& attribute : attributes(index)) {
+        if (attribute.name == name) {
+            return attribute.value;
+        }
+    }
+    return {};
+}
+
+bool SVGElementStore::hasAttribute(uint32_t index, SVGNameTable::Id name) const {
+    const auto list = attributes(index);
+    return std::any_of(list.begin(), list.end(), [name](const Attribute& attribute) { return attribute.name == name; });
+}
+
+float SVGElementStore::number(uint32_t index, SVGNameTable::Id name, float fallback) const {
+    float value = fallback;
+    NumberScanner in(attribute(index, name));
+    return in.number(value) ? value : fallback;
+}
+
+uint32_t SVGElementStore::findById(std::string_view id) const {
+    auto it = ids_.find(id);
+    return it != ids_.end() ? it->second : None;
+}
+
+SVGPathStore::Path SVGElementStore::path(uint32_t index) const {
+    const uint32_t path = elements_[index].path;
+    return path == None ? SVGPathStore::Path{} : paths_.get(path);
+}
+
+} // namespace QuantumCanvas::IO
@@ -0,0 +1,250 @@
+#pragma once
+
+#include "byte_source.hpp"
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace QuantumCanvas::IO {
+
+// Pull tokenizer over XML text
+//
+// One pass and no allocation per token: names, attribute values and text
+// are views into the input, still entity-encoded; decodeEntities() resolves
+// them where needed. Comments, processing instructions and the DOCTYPE are
+// skipped, CDATA sections come back as text, and a self-closing tag yields
+// StartElement then EndElement. Nesting is left to the caller. Malformed
+// markup throws std::runtime_error naming the byte offset.
+class SVGTokenizer final {
+public:
+    enum class Token {
+        StartElement,
+        EndElement,
+        Text,
+        End
+    };
+
+    struct Attribute {
+        std::string_view name;
+        std::string_view value;  // As written, between the quotes
+    };
+
+    explicit SVGTokenizer(std::string_view input) : input_(input) {}
+
+    Token next();
+
+    std::string_view name() const { return name_; }  // Start and end elements
+    const std::vector<Attribute>& attributes() const { return attributes_; }
+    std::string_view text() const { return text_; }
+    bool isCData() const { return cdata_; }  // Text is literal, with no references to decode
+    size_t offset() const { return pos_; }
+
+    // Appends raw with the predefined and numeric character references resolved
+    static void decodeEntities(std::string_view raw, std::string& out);
+
+private:
+    std::string_view input_;
+    size_t pos_ = 0;
+    std::string_view name_;
+    std::string_view text_;
+    std::vector<Attribute> attributes_;
+    bool cdata_ = false;
+    bool pendingEnd_ = false;  // A self-closing tag still owes its EndElement
+
+    Token readTag();
+    void skipPast(std::string_view terminator, const char* construct);
+    void skipDeclaration();
+    std::string_view readName();
+    void skipWhitespace();
+    [[noreturn]] void fail(const std::string& message) const;
+};
+
+// Element and attribute names, interned to small integers
+class SVGNameTable final {
+public:
+    using Id = uint32_t;
+    static constexpr Id None = UINT32_MAX;
+
+    // Names the importer looks up, interned first so their ids are constants.
+    // Element and attribute names share ids ("style" is both).
+    enum Known : Id {
+        Svg, G, Path, Rect, Circle, Ellipse, Line, Polyline, Polygon,
+        Text, Tspan, Use, Symbol, Defs, LinearGradient, RadialGradient, Stop, Pattern,
+        Title, Desc, Style,
+        IdAttribute, Class, Transform, D, Points, X, Y, Width, Height, ViewBox,
+        Href, XlinkHref, Fill, Stroke, Opacity,
+        KnownCount
+    };
+
+    SVGNameTable();
+
+    // Disable copy, enable move
+    SVGNameTable(const SVGNameTable&) = delete;
+    SVGNameTable& operator=(const SVGNameTable&) = delete;
+    SVGNameTable(SVGNameTable&&) = default;
+    SVGNameTable& operator=(SVGNameTable&&) = default;
+
+    Id intern(std::string_view name);
+    Id find(std::string_view name) const;  // None if never interned
+    std::string_view name(Id id) const { return names_[id]; }
+    size_t size() const { return names_.size(); }
+
+private:
+    std::deque<std::string> names_;  // A deque, so the map's keys stay valid
+    std::unordered_map<std::string_view, Id> ids_;
+};
+
+// Path commands as VectorRenderer's tessellators walk them: absolute
+// coordinates, one verb per command, followed by its points in the order
+// they read PathCommand::points
+enum class SVGPathVerb : uint8_t {
+    MoveTo,    // x y
+    LineTo,    // x y
+    CurveTo,   // x1 y1 x2 y2 x y
+    QuadTo,    // x1 y1 x y
+    ArcTo,     // x y rx ry rotation(radians) largeArc sweep
+    ClosePath
+};
+
+// Packed geometry of every path in a document
+//
+// Two shared arrays, verbs and points, with each path a range of both;
+// relative, horizontal/vertical and smooth commands are resolved while
+// decoding, so the renderer consumes the spans as they are.
+class SVGPathStore final {
+public:
+    struct Path {
+        std::span<const SVGPathVerb> verbs;
+        std::span<const float> points;
+        bool complete = true;  // False if decoding stopped at an error
+
+        bool empty() const { return verbs.empty(); }
+    };
+
+    static constexpr uint32_t pointCount(SVGPathVerb verb) {
+        constexpr uint32_t counts[] = {2, 2, 6, 4, 7, 0};
+        return counts[static_cast<uint8_t>(verb)];
+    }
+
+    // Both return the new path's index. As the SVG error rules require, a
+    // path keeps the commands before the first error in its data.
+    uint32_t addPathData(std::string_view data);                // d=""
+    uint32_t addPoints(std::string_view points, bool closed);   // polyline/polygon points=""
+
+    Path get(uint32_t index) const;
+    size_t size() const { return ranges_.size(); }
+    const std::vector<SVGPathVerb>& verbs() const { return verbs_; }
+    const std::vector<float>& points() const { return points_; }
+
+private:
+    struct Range {
+        uint32_t firstVerb = 0;
+        uint32_t verbCount = 0;
+        uint32_t firstPoint = 0;
+        uint32_t pointCount = 0;
+        bool complete = true;
+    };
+
+    std::vector<SVGPathVerb> verbs_;
+    std::vector<float> points_;
+    std::vector<Range> ranges_;
+
+    uint32_t finish(size_t firstVerb, size_t firstPoint, bool complete);
+};
+
+// Arena-backed SVG element tree, built in one streaming pass
+//
+// Elements and attributes live in flat arrays linked by index, names are
+// interned, and attribute values stay views into the mapped source unless
+// they contained character references, so a document costs its mapping
+// plus a few dozen bytes per element instead of an XML node tree and a
+// shared_ptr element graph. path d="" and polyline/polygon points="" are
+// decoded into the path store as they are parsed. Other shapes, styles and
+// transforms are left as attributes for the importer to read.
+//
+// Move-only: views point into the source and string pool it keeps.
+class SVGElementStore final {
+public:
+    static constexpr uint32_t None = UINT32_MAX;
+
+    struct Element {
+        SVGNameTable::Id name = SVGNameTable::None;
+        uint32_t parent = None;
+        uint32_t firstChild = None;
+        uint32_t nextSibling = None;
+        uint32_t firstAttribute = 0;
+        uint32_t attributeCount = 0;
+        uint32_t path = None;   // Into paths(), for path, polyline and polygon
+        std::string_view text;  // Character data of text, tspan, title, desc and style
+    };
+
+    struct Attribute {
+        SVGNameTable::Id name = SVGNameTable::None;
+        std::string_view value;  // Decoded
+    };
+
+    struct Stats {
+        size_t elementCount = 0;
+        size_t attributeCount = 0;
+        size_t pathCount = 0;
+        size_t malformedPathCount = 0;  // Paths cut short by bad data
+        uint64_t bytesParsed = 0;       // After decompressing .svgz
+        std::chrono::microseconds parseTime{0};
+    };
+
+    // Gzip-compressed input (.svgz) is inflated first. Throws
+    // std::runtime_error on malformed XML or a root element other than <svg>.
+    static SVGElementStore parse(std::shared_ptr<const ByteSource> source);
+    static SVGElementStore parse(const std::filesystem::path& filePath);
+    static SVGElementStore parseText(std::string_view text);  // Copies text
+
+    // Disable copy, enable move
+    SVGElementStore(const SVGElementStore&) = delete;
+    SVGElementStore& operator=(const SVGElementStore&) = delete;
+    SVGElementStore(SVGElementStore&&) = default;
+    SVGElementStore& operator=(SVGElementStore&&) = default;
+
+    uint32_t root() const { return 0; }  // The <svg> element
+    size_t size() const { return elements_.size(); }
+    const Element& element(uint32_t index) const { return elements_[index]; }
+    std::span<const Attribute> attributes(uint32_t index) const;
+
+    // Empty if absent
+    std::string_view attribute(uint32_t index, SVGNameTable::Id name) const;
+    bool hasAttribute(uint32_t index, SVGNameTable::Id name) const;
+    // Leading number of the attribute, ignoring any unit; fallback if absent or not a number
+    float number(uint32_t index, SVGNameTable::Id name, float fallback = 0.0f) const;
+
+    uint32_t findById(std::string_view id) const;  // None if no element has it
+    bool is(uint32_t index, SVGNameTable::Id name) const { return elements_[index].name == name; }
+
+    const SVGNameTable& names() const { return names_; }
+    const SVGPathStore& paths() const { return paths_; }
+    SVGPathStore::Path path(uint32_t index) const;  // Empty for elements without geometry
+    const Stats& stats() const { return stats_; }
+
+private:
+    SVGElementStore() = default;
+
+    std::shared_ptr<const ByteSource> source_;  // What the views point into
+    std::deque<std::string> strings_;           // Decoded values and joined text
+    SVGNameTable names_;
+    std::vector<Element> elements_;
+    std::vector<Attribute> attributes_;
+    SVGPathStore paths_;
+    std::unordered_map<std::string_view, uint32_t> ids_;
+    Stats stats_;
+
+    void build();
+    std::string_view decoded(std::string_view raw);
+    void appendText(Element& element, std::string_view raw, bool literal);
+};
+
+} // namespace QuantumCanvas::IO
@@ -0,0 +1,282 @@
+#include "thumbnail_cache.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+
+namespace QuantumCanvas::IO {
+
+using Raster::Image;
+
+namespace {
+
+constexpr char ENTRY_MAGIC[4] = {'Q', 'T', 'H', 'B'};
+constexpr uint32_t ENTRY_VERSION = 1;
+constexpr size_t ENTRY_HEADER_BYTES = 28;  // Magic, version, width, height, hash, data bytes
+constexpr const char* ENTRY_EXTENSION = ".qthumb";
+
+constexpr size_t FULL_HASH_LIMIT = 8 * 1024 * 1024;
+constexpr size_t SAMPLE_BLOCKS = 16;
+constexpr size_t SAMPLE_BLOCK_BYTES = 64 * 1024;
+
+void put32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+uint32_t get32(const uint8_t* data) {
+    return data[0] | (uint32_t(data[1]) << 8) | (uint32_t(data[2]) << 16) | (uint32_t(data[3]) << 24);
+}
+
+uint8_t toByte(float value) {
+    return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+std::shared_ptr<Image> readEntry(const std::filesystem::path& path, uint64_t contentHash,
+                                 const std::array<uint32_t, 2>& size) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return nullptr;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.size() < ENTRY_HEADER_BYTES || std::memcmp(bytes.data(), ENTRY_MAGIC, 4) != 0 ||
+        get32(bytes.data() + 4) != ENTRY_VERSION) {
+        return nullptr;
+    }
+
+    const uint32_t width = get32(bytes.data() + 8);
+    const uint32_t height = get32(bytes.data() + 12);
+    const uint64_t hash = get32(bytes.data() + 16) | (uint64_t(get32(bytes.data() + 20)) << 32);
+    const uint32_t dataBytes = get32(bytes.data() + 24);
+    if (hash != contentHash || width == 0 || height == 0 || width > size[0] || height > size[1] ||
+        bytes.size() != ENTRY_HEADER_BYTES + dataBytes) {
+        return nullptr;
+    }
+
+    std::vector<uint8_t> rgba(size_t(width) * height * 4);
+    uLongf rgbaSize = static_cast<uLongf>(rgba.size());
+    if (uncompress(rgba.data(), &rgbaSize, bytes.data() + ENTRY_HEADER_BYTES, dataBytes) != Z_OK ||
+        rgbaSize != rgba.size()) {
+        return nullptr;
+    }
+
+    auto image = std::make_shared<Image>(width, height);
+    const uint8_t* pixel = rgba.data();
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x, pixel += 4) {
+            image->setPixel(x, y, {pixel[0] / 255.0f, pixel[1] / 255.0f, pixel[2] / 255.0f, pixel[3] / 255.0f});
+        }
+    }
+    image->clearDirtyTiles();
+    return image;
+}
+
+} // namespace
+
+ThumbnailCache::ThumbnailCache(std::filesystem::path directory, uint64_t maxBytes)
+    : directory_(std::move(directory))
+    , maxBytes_(maxBytes) {
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+    if (!std::filesystem::is_directory(directory_, error)) {
+        throw std::runtime_error("Cannot create thumbnail cache directory: " + directory_.string());
+    }
+
+    // Index what earlier sessions left; leftover temporaries are removed
+    for (const auto& item : std::filesystem::directory_iterator(directory_, error)) {
+        if (!item.is_regular_file(error)) {
+            continue;
+        }
+        const std::string name = item.path().filename().string();
+        if (item.path().extension() == ENTRY_EXTENSION) {
+            Entry entry;
+            entry.bytes = item.file_size(error);
+            entry.lastUse = item.last_write_time(error);
+            diskUsage_ += entry.bytes;
+            entries_[name] = entry;
+        }
+        else if (name.find(".qthumb.tmp") != std::string::npos) {
+            std::filesystem::remove(item.path(), error);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    evictLocked();
+}
+
+uint64_t ThumbnailCache::contentHash(ByteSpan data) {
+    if (data.size() <= FULL_HASH_LIMIT) {
+        return ContentHasher::hash(data);
+    }
+
+    // First and last blocks always, the rest evenly spaced between them
+    ContentHasher hash;
+    for (size_t block = 0; block < SAMPLE_BLOCKS; ++block) {
+        const size_t offset = (data.size() - SAMPLE_BLOCK_BYTES) / (SAMPLE_BLOCKS - 1) * block;
+        hash.update(data.subspan(block + 1 == SAMPLE_BLOCKS ? data.size() - SAMPLE_BLOCK_BYTES : offset,
+                                 SAMPLE_BLOCK_BYTES));
+    }
+    return hash.finish(data.size());
+}
+
+std::string ThumbnailCache::entryName(uint64_t contentHash, const std::array<uint32_t, 2>& size) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%016llx_%ux%u%s", static_cast<unsigned long long>(contentHash),
+                  size[0], size[1], ENTRY_EXTENSION);
+    return name;
+}
+
+std::shared_ptr<Image> ThumbnailCache::find(uint64_t contentHash, const std::array<uint32_t, 2>& size) {
+    const std::string name = entryName(contentHash, size);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (entries_.find(name) == entries_.end()) {
+            return nullptr;
+        }
+    }
+
+    const std::filesystem::path path = directory_ / name;
+    std::shared_ptr<Image> image = readEntry(path, contentHash, size);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(name);
+    if (!image) {
+        if (it != entries_.end()) {
+            removeLocked(name);
+        }
+        return nullptr;
+    }
+
+    // Record the use on disk too, for the next session's eviction order
+    std::error_code error;
+    const auto now = std::filesystem::file_time_type::clock::now();
+    std::filesystem::last_write_time(path, now, error);
+    if (it != entries_.end()) {
+        it->second.lastUse = now;
+    }
+    return image;
+}
+
+void ThumbnailCache::store(uint64_t contentHash, const std::array<uint32_t, 2>& size, const Image& thumbnail) {
+    if (thumbnail.empty()) {
+        return;
+    }
+
+    std::vector<uint8_t> rgba;
+    rgba.reserve(size_t(thumbnail.width()) * thumbnail.height() * 4);
+    for (uint32_t y = 0; y < thumbnail.height(); ++y) {
+        for (uint32_t x = 0; x < thumbnail.width(); ++x) {
+            for (float channel : thumbnail.getPixel(x, y)) {
+                rgba.push_back(toByte(channel));
+            }
+        }
+    }
+
+    uLongf dataBytes = compressBound(static_cast<uLong>(rgba.size()));
+    std::vector<uint8_t> bytes(ENTRY_HEADER_BYTES + dataBytes);
+    if (compress2(bytes.data() + ENTRY_HEADER_BYTES, &dataBytes, rgba.data(), static_cast<uLong>(rgba.size()), 6) != Z_OK) {
+        return;
+    }
+
+    std::vector<uint8_t> header(ENTRY_MAGIC, ENTRY_MAGIC + 4);
+    put32(header, ENTRY_VERSION);
+    put32(header, thumbnail.width());
+    put32(header, thumbnail.height());
+    put32(header, static_cast<uint32_t>(contentHash));
+    put32(header, static_cast<uint32_t>(contentHash >> 32));
+    put32(header, static_cast<uint32_t>(dataBytes));
+    std::copy(header.begin(), header.end(), bytes.begin());
+    bytes.resize(ENTRY_HEADER_BYTES + dataBytes);
+
+    // Written aside and renamed, which replaces an existing entry atomically
+    static std::atomic<uint64_t> writeCounter{0};
+    const std::string name = entryName(contentHash, size);
+    const std::filesystem::path path = directory_ / name;
+    const std::filesystem::path temporary = directory_ /
+        (name + ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + "_" +
+         std::to_string(writeCounter.fetch_add(1)));
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file) {
+            std::error_code error;
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return;
+    }
+
+    auto it = entries_.find(name);
+    if (it != entries_.end()) {
+        diskUsage_ -= it->second.bytes;
+    }
+    Entry& entry = entries_[name];
+    entry.bytes = bytes.size();
+    entry.lastUse = std::filesystem::file_time_type::clock::now();
+    diskUsage_ += entry.bytes;
+    evictLocked();
+}
+
+void ThumbnailCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!entries_.empty()) {
+        removeLocked(entries_.begin()->first);
+    }
+}
+
+uint64_t ThumbnailCache::diskUsage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return diskUsage_;
+}
+
+size_t ThumbnailCache::entryCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+void ThumbnailCache::evictLocked() {
+    if (diskUsage_ <= maxBytes_) {
+        return;
+    }
+
+    std::vector<std::pair<std::filesystem::file_time_type, std::string>> byAge;
+    byAge.reserve(entries_.size());
+    for (const auto& [name, entry] : entries_) {
+        byAge.emplace_back(entry.lastUse, name);
+    }
+    std::sort(byAge.begin(), byAge.end());
+
+    for (const auto& [lastUse, name] : byAge) {
+        if (diskUsage_ <= maxBytes_) {
+            break;
+        }
+        removeLocked(name);
+    }
+}
+
+void ThumbnailCache::removeLocked(const std::string& name) {
+    auto it = entries_.find(name);
+    if (it == entries_.end()) {
+        return;
+    }
+
+    std::error_code error;
+    std::filesystem::remove(directory_ / name, error);
+    diskUsage_ -= it->second.bytes;
+    entries_.erase(it);
+}
+
+} // namespace QuantumCanvas::IO
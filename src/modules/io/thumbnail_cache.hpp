@@ -0,0 +1,62 @@
+#pragma once
+
+#include "byte_source.hpp"
+#include "../raster/raster_image.hpp"
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace QuantumCanvas::IO {
+
+// Thumbnails on disk, keyed by a hash of the source file's contents, so
+// renamed, moved and copied files hit the cache and edited ones miss it
+//
+// Each entry is one file holding deflated 8-bit RGBA, named after the hash
+// and the requested size. Files are written under a temporary name and
+// renamed into place, so concurrent writers and readers never see partial
+// entries. The least recently used entries are deleted once the directory
+// exceeds its budget; use is recorded in the file's modification time and
+// survives restarts. Thread-safe.
+class ThumbnailCache final {
+public:
+    // Creates the directory if needed; throws std::runtime_error if it cannot
+    explicit ThumbnailCache(std::filesystem::path directory, uint64_t maxBytes = 256ull * 1024 * 1024);
+
+    // 64-bit hash of a file's bytes. Files over 8 MiB hash their size and 16
+    // sampled 64 KiB blocks instead of every byte, so a lookup never reads all
+    // of a large file; an edit that keeps the size and misses every sampled
+    // block keeps the old thumbnail.
+    static uint64_t contentHash(ByteSpan data);
+
+    // Null on a miss or an unreadable entry, which is deleted
+    std::shared_ptr<Raster::Image> find(uint64_t contentHash, const std::array<uint32_t, 2>& size);
+    void store(uint64_t contentHash, const std::array<uint32_t, 2>& size, const Raster::Image& thumbnail);
+    void clear();
+
+    const std::filesystem::path& directory() const { return directory_; }
+    uint64_t diskUsage() const;
+    size_t entryCount() const;
+
+private:
+    struct Entry {
+        uint64_t bytes = 0;
+        std::filesystem::file_time_type lastUse;
+    };
+
+    std::filesystem::path directory_;
+    uint64_t maxBytes_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;  // By file name
+    uint64_t diskUsage_ = 0;
+
+    static std::string entryName(uint64_t contentHash, const std::array<uint32_t, 2>& size);
+    void evictLocked();
+    void removeLocked(const std::string& name);
+};
+
+} // namespace QuantumCanvas::IO
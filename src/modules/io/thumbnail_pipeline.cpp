@@ -0,0 +1,549 @@
+#include "thumbnail_pipeline.hpp"
+#include "region_decode.hpp"
+#include "../../core/kernel/task_scheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <csetjmp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <png.h>
+#include <jpeglib.h>
+
+namespace QuantumCanvas::IO {
+
+using Raster::Image;
+
+namespace {
+
+uint16_t read16LE(ByteSpan data, size_t offset) {
+    return static_cast<uint16_t>(data[offset] | (data[offset + 1] << 8));
+}
+
+uint32_t read32LE(ByteSpan data, size_t offset) {
+    return read16LE(data, offset) | (uint32_t(read16LE(data, offset + 2)) << 16);
+}
+
+bool contains(ByteSpan data, uint64_t offset, uint64_t length) {
+    return offset <= data.size() && length <= data.size() - offset;
+}
+
+bool isJPEG(ByteSpan data) {
+    return data.size() >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF;
+}
+
+// Interleaved 8-bit samples, 1 to 4 channels, into a new image
+std::shared_ptr<Image> imageFromSamples(const uint8_t* samples, uint32_t width, uint32_t height,
+                                        uint32_t channels, size_t rowStride) {
+    auto image = std::make_shared<Image>(width, height);
+    RegionDecodeSink sink(*image, DecodeRegion{}, {width, height}, channels, RegionDecodeSink::SampleType::UInt8);
+    sink.writeRows(0, height, samples, rowStride);
+    image->clearDirtyTiles();
+    return image;
+}
+
+// EXIF thumbnail in a TIFF structure: IFD1's JPEGInterchangeFormat and
+// JPEGInterchangeFormatLength tags
+std::optional<ByteSpan> thumbnailInTIFF(ByteSpan tiff) {
+    if (tiff.size() < 8) {
+        return std::nullopt;
+    }
+
+    const bool little = tiff[0] == 'I' && tiff[1] == 'I';
+    if (!little && !(tiff[0] == 'M' && tiff[1] == 'M')) {
+        return std::nullopt;
+    }
+    auto u16 = [&](size_t offset) -> uint32_t {
+        return little ? read16LE(tiff, offset) : uint32_t(tiff[offset] << 8 | tiff[offset + 1]);
+    };
+    auto u32 = [&](size_t offset) -> uint32_t {
+        return little ? read32LE(tiff, offset) : (u16(offset) << 16 | u16(offset + 2));
+    };
+    if (u16(2) != 42) {
+        return std::nullopt;
+    }
+
+    const uint32_t ifd0 = u32(4);
+    if (!contains(tiff, ifd0, 2)) {
+        return std::nullopt;
+    }
+    const uint64_t next = ifd0 + 2 + 12ull * u16(ifd0);
+    if (!contains(tiff, next, 4)) {
+        return std::nullopt;
+    }
+    const uint32_t ifd1 = u32(next);
+    if (ifd1 == 0 || !contains(tiff, ifd1, 2) || !contains(tiff, ifd1 + 2, 12ull * u16(ifd1))) {
+        return std::nullopt;
+    }
+
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    for (uint32_t i = 0, count = u16(ifd1); i < count; ++i) {
+        const size_t entry = ifd1 + 2 + 12 * size_t(i);
+        const uint32_t tag = u16(entry);
+        const uint32_t value = u16(entry + 2) == 3 ? u16(entry + 8) : u32(entry + 8);
+        if (tag == 0x0201) {
+            offset = value;
+        }
+        else if (tag == 0x0202) {
+            length = value;
+        }
+    }
+
+    if (length < 4 || !contains(tiff, offset, length) || !isJPEG(tiff.subspan(offset, length))) {
+        return std::nullopt;
+    }
+    return tiff.subspan(offset, length);
+}
+
+struct JPEGError {
+    jpeg_error_mgr manager;
+    std::jmp_buf jump;
+};
+
+void jpegErrorExit(j_common_ptr info) {
+    std::longjmp(reinterpret_cast<JPEGError*>(info->err)->jump, 1);
+}
+
+void jpegSilence(j_common_ptr) {}
+
+// Decodes into a malloc'd buffer the caller frees. Only trivially
+// destructible locals live here, so the error longjmp skips no destructors.
+bool readJPEG(const uint8_t* data, size_t size, uint32_t minWidth, uint32_t minHeight,
+              unsigned char** pixels, uint32_t* width, uint32_t* height, uint32_t* channels, bool* adobeCMYK) {
+    jpeg_decompress_struct info;
+    JPEGError error;
+    info.err = jpeg_std_error(&error.manager);
+    error.manager.error_exit = jpegErrorExit;
+    error.manager.output_message = jpegSilence;
+    *pixels = nullptr;
+    if (setjmp(error.jump)) {
+        jpeg_destroy_decompress(&info);
+        std::free(*pixels);
+        *pixels = nullptr;
+        return false;
+    }
+
+    jpeg_create_decompress(&info);
+    jpeg_mem_src(&info, data, static_cast<unsigned long>(size));
+    jpeg_read_header(&info, TRUE);
+
+    // libjpeg converts CMYK only to CMYK
+    *adobeCMYK = info.jpeg_color_space == JCS_CMYK || info.jpeg_color_space == JCS_YCCK;
+    info.out_color_space = *adobeCMYK ? JCS_CMYK : JCS_RGB;
+
+    // Largest reduction that keeps both sides at least the minimum
+    unsigned int denominator = 1;
+    while (denominator < 8 && minWidth > 0 && minHeight > 0 &&
+           (info.image_width + denominator * 2 - 1) / (denominator * 2) >= minWidth &&
+           (info.image_height + denominator * 2 - 1) / (denominator * 2) >= minHeight) {
+        denominator *= 2;
+    }
+    info.scale_num = 1;
+    info.scale_denom = denominator;
+    info.dct_method = JDCT_IFAST;
+
+    jpeg_start_decompress(&info);
+    *width = info.output_width;
+    *height = info.output_height;
+    *channels = static_cast<uint32_t>(info.output_components);
+    const size_t stride = size_t(*width) * *channels;
+    *pixels = static_cast<unsigned char*>(std::malloc(stride * *height));
+    if (!*pixels) {
+        jpeg_destroy_decompress(&info);
+        return false;
+    }
+    while (info.output_scanline < info.output_height) {
+        JSAMPROW row = *pixels + stride * info.output_scanline;
+        jpeg_read_scanlines(&info, &row, 1);
+    }
+    jpeg_finish_decompress(&info);
+    jpeg_destroy_decompress(&info);
+    return true;
+}
+
+} // namespace
+
+// EmbeddedPreview
+
+std::optional<ByteSpan> EmbeddedPreview::findExifThumbnail(ByteSpan data) {
+    if (!isJPEG(data)) {
+        return thumbnailInTIFF(data);
+    }
+
+    // APP segments come before the first scan
+    size_t offset = 2;
+    while (offset + 4 <= data.size() && data[offset] == 0xFF) {
+        const uint8_t marker = data[offset + 1];
+        if (marker == 0xFF) {
+            ++offset;  // Fill byte
+            continue;
+        }
+        if (marker == 0xDA || marker == 0xD9) {
+            break;
+        }
+
+        const size_t length = size_t(data[offset + 2]) << 8 | data[offset + 3];
+        if (length < 2 || !contains(data, offset + 2, length)) {
+            break;
+        }
+        if (marker == 0xE1 && length >= 8 && std::memcmp(data.data() + offset + 4, "Exif\0\0", 6) == 0) {
+            if (auto thumbnail = thumbnailInTIFF(data.subspan(offset + 10, length - 8))) {
+                return thumbnail;
+            }
+        }
+        offset += 2 + length;
+    }
+    return std::nullopt;
+}
+
+std::optional<EmbeddedPreview::DWGPreview> EmbeddedPreview::findDWGPreview(ByteSpan data) {
+    static constexpr uint8_t SENTINEL[16] = {0x1F, 0x25, 0x6D, 0x07, 0xD4, 0x36, 0x28, 0x28,
+                                             0x9D, 0x57, 0xCA, 0x3F, 0x9D, 0x44, 0x10, 0x2B};
+    if (data.size() < 0x11 || std::memcmp(data.data(), "AC10", 4) != 0) {
+        return std::nullopt;
+    }
+
+    // The file header's image seeker points at the preview section
+    const uint32_t section = read32LE(data, 0x0D);
+    if (!contains(data, section, 21) || std::memcmp(data.data() + section, SENTINEL, 16) != 0) {
+        return std::nullopt;
+    }
+
+    std::optional<DWGPreview> preview;
+    const uint32_t count = data[section + 20];
+    for (uint32_t i = 0; i < count && contains(data, section + 21 + 9ull * i, 9); ++i) {
+        const size_t entry = section + 21 + 9 * size_t(i);
+        const uint8_t code = data[entry];
+        const uint32_t start = read32LE(data, entry + 1);
+        const uint32_t size = read32LE(data, entry + 5);
+        if (size == 0 || !contains(data, start, size)) {
+            continue;
+        }
+        if (code == 6) {
+            return DWGPreview{DWGPreview::Type::PNG, data.subspan(start, size)};
+        }
+        if (code == 2) {
+            preview = DWGPreview{DWGPreview::Type::BMP, data.subspan(start, size)};
+        }
+    }
+    return preview;
+}
+
+std::shared_ptr<Image> EmbeddedPreview::decodeJPEG(ByteSpan data, const std::array<uint32_t, 2>& minSize) {
+    unsigned char* pixels = nullptr;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t channels = 0;
+    bool adobeCMYK = false;
+    if (!readJPEG(data.data(), data.size(), minSize[0], minSize[1], &pixels, &width, &height, &channels, &adobeCMYK)) {
+        return nullptr;
+    }
+
+    std::shared_ptr<Image> image;
+    if (adobeCMYK) {
+        // Adobe writes CMYK inverted, so each channel times K is the RGB value
+        std::vector<uint8_t> rgb(size_t(width) * height * 3);
+        for (size_t i = 0; i < size_t(width) * height; ++i) {
+            const uint8_t* cmyk = pixels + i * 4;
+            for (int c = 0; c < 3; ++c) {
+                rgb[i * 3 + c] = static_cast<uint8_t>(cmyk[c] * cmyk[3] / 255);
+            }
+        }
+        image = imageFromSamples(rgb.data(), width, height, 3, size_t(width) * 3);
+    }
+    else if (width > 0 && height > 0) {
+        image = imageFromSamples(pixels, width, height, channels, size_t(width) * channels);
+    }
+    std::free(pixels);
+    return image;
+}
+
+std::shared_ptr<Image> EmbeddedPreview::decodePNG(ByteSpan data) {
+    png_image png{};
+    png.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_memory(&png, data.data(), data.size())) {
+        return nullptr;
+    }
+
+    png.format = PNG_FORMAT_RGBA;
+    std::vector<uint8_t> pixels(PNG_IMAGE_SIZE(png));
+    if (!png_image_finish_read(&png, nullptr, pixels.data(), 0, nullptr) || png.width == 0 || png.height == 0) {
+        png_image_free(&png);
+        return nullptr;
+    }
+    return imageFromSamples(pixels.data(), png.width, png.height, 4, size_t(png.width) * 4);
+}
+
+std::shared_ptr<Image> EmbeddedPreview::decodeDIB(ByteSpan data) {
+    if (data.size() < 40) {
+        return nullptr;
+    }
+
+    const uint32_t headerSize = read32LE(data, 0);
+    const auto width = static_cast<int32_t>(read32LE(data, 4));
+    const auto signedHeight = static_cast<int32_t>(read32LE(data, 8));
+    const uint32_t bitCount = read16LE(data, 14);
+    const uint32_t compression = read32LE(data, 16);
+    const uint32_t colorsUsed = read32LE(data, 32);
+    const bool bottomUp = signedHeight > 0;
+    const uint32_t height = static_cast<uint32_t>(bottomUp ? signedHeight : -int64_t(signedHeight));
+
+    const bool bitFields = compression == 3 && bitCount == 32;
+    if (headerSize < 40 || width <= 0 || height == 0 || width > 16384 || height > 16384 ||
+        (compression != 0 && !bitFields) ||
+        (bitCount != 1 && bitCount != 4 && bitCount != 8 && bitCount != 24 && bitCount != 32)) {
+        return nullptr;
+    }
+
+    // Palette, or the three channel masks of a BITFIELDS header
+    const uint32_t paletteSize = bitCount <= 8 ? (colorsUsed ? std::min(colorsUsed, 1u << bitCount) : 1u << bitCount) : 0;
+    const uint64_t palette = headerSize + (bitFields && headerSize == 40 ? 12 : 0);
+    const uint64_t pixels = palette + 4ull * paletteSize;
+    const size_t stride = (size_t(width) * bitCount + 31) / 32 * 4;
+    if (!contains(data, pixels, uint64_t(stride) * height)) {
+        return nullptr;
+    }
+
+    std::vector<uint8_t> rgb(size_t(width) * height * 3);
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint8_t* row = data.data() + pixels + stride * (bottomUp ? height - 1 - y : y);
+        uint8_t* out = rgb.data() + size_t(y) * width * 3;
+        for (int32_t x = 0; x < width; ++x, out += 3) {
+            const uint8_t* bgr;
+            if (bitCount <= 8) {
+                const uint32_t bit = uint32_t(x) * bitCount;
+                const uint32_t index = (row[bit / 8] >> (8 - bitCount - bit % 8)) & ((1u << bitCount) - 1);
+                if (index >= paletteSize) {
+                    out[0] = out[1] = out[2] = 0;
+                    continue;
+                }
+                bgr = data.data() + palette + 4 * index;
+            }
+            else {
+                bgr = row + size_t(x) * (bitCount / 8);
+            }
+            out[0] = bgr[2];
+            out[1] = bgr[1];
+            out[2] = bgr[0];
+        }
+    }
+    return imageFromSamples(rgb.data(), static_cast<uint32_t>(width), height, 3, size_t(width) * 3);
+}
+
+bool EmbeddedPreview::isLargeEnough(const Image& preview, const std::array<uint32_t, 2>& size) {
+    return uint64_t(std::max(preview.width(), preview.height())) * 2 >= std::max(size[0], size[1]);
+}
+
+std::shared_ptr<Image> EmbeddedPreview::extract(ByteSpan data, const std::array<uint32_t, 2>& size) {
+    std::shared_ptr<Image> preview;
+    if (auto exif = findExifThumbnail(data)) {
+        preview = decodeJPEG(*exif);
+    }
+    else if (auto dwg = findDWGPreview(data)) {
+        preview = dwg->type == DWGPreview::Type::PNG ? decodePNG(dwg->data) : decodeDIB(dwg->data);
+    }
+    return preview && isLargeEnough(*preview, size) ? preview : nullptr;
+}
+
+// ThumbnailPipeline
+
+ThumbnailPipeline::ThumbnailPipeline(std::shared_ptr<ThumbnailCache> cache, Stages stages,
+                                     std::shared_ptr<Core::TaskScheduler> scheduler)
+    : cache_(std::move(cache))
+    , stages_(std::move(stages))
+    , scheduler_(std::move(scheduler))
+    , prefetchGroup_(std::make_unique<Core::TaskGroup>()) {
+}
+
+ThumbnailPipeline::~ThumbnailPipeline() {
+    cancelPrefetch();
+    waitForPrefetch();
+}
+
+std::shared_ptr<Image> ThumbnailPipeline::generate(const std::filesystem::path& filePath,
+                                                   const std::array<uint32_t, 2>& size, Source* source) {
+    const std::string key = filePath.string() + '|' + std::to_string(size[0]) + 'x' + std::to_string(size[1]);
+
+    // The first request for a file and size does the work; the rest wait on it
+    std::promise<Result> promise;
+    std::shared_future<Result> pending;
+    bool owner = false;
+    {
+        std::lock_guard<std::mutex> lock(inFlightMutex_);
+        auto it = inFlight_.find(key);
+        if (it != inFlight_.end()) {
+            pending = it->second;
+        }
+        else {
+            pending = promise.get_future().share();
+            inFlight_.emplace(key, pending);
+            owner = true;
+        }
+    }
+
+    if (owner) {
+        Result result;
+        result.image = produce(filePath, size, result.source);
+        promise.set_value(result);
+
+        std::lock_guard<std::mutex> lock(inFlightMutex_);
+        inFlight_.erase(key);
+    }
+
+    const Result& result = pending.get();
+    if (source) {
+        *source = result.source;
+    }
+    return result.image;
+}
+
+std::shared_ptr<Image> ThumbnailPipeline::produce(const std::filesystem::path& filePath,
+                                                  const std::array<uint32_t, 2>& size, Source& source) {
+    source = Source::None;
+    try {
+        auto bytes = std::make_shared<const ByteSource>(ByteSource::open(filePath, ByteSource::Access::Random));
+        const ByteSpan data = bytes->bytes();
+
+        uint64_t hash = 0;
+        if (cache_) {
+            hash = ThumbnailCache::contentHash(data);
+            if (std::shared_ptr<Image> cached = cache_->find(hash, size)) {
+                source = Source::Cache;
+                std::lock_guard<std::mutex> lock(statsMutex_);
+                stats_.cacheHits++;
+                return cached;
+            }
+        }
+
+        std::shared_ptr<Image> image = EmbeddedPreview::extract(data, size);
+        if (!image && stages_.embeddedPreview) {
+            image = stages_.embeddedPreview(bytes, size);
+            if (image && (image->empty() || !EmbeddedPreview::isLargeEnough(*image, size))) {
+                image.reset();
+            }
+        }
+        if (image) {
+            source = Source::EmbeddedPreview;
+        }
+        else {
+            if (isJPEG(data)) {
+                image = EmbeddedPreview::decodeJPEG(data, size);
+            }
+            if (!image && stages_.reducedDecode) {
+                image = stages_.reducedDecode(bytes, size);
+            }
+            if (image && !image->empty()) {
+                source = Source::ReducedDecode;
+            }
+        }
+
+        if (source == Source::None) {
+            std::lock_guard<std::mutex> lock(statsMutex_);
+            stats_.failures++;
+            return nullptr;
+        }
+
+        std::shared_ptr<Image> thumbnail = fit(*image, size);
+        if (cache_) {
+            cache_->store(hash, size, *thumbnail);
+        }
+
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        (source == Source::EmbeddedPreview ? stats_.embeddedPreviews : stats_.reducedDecodes)++;
+        return thumbnail;
+    }
+    catch (const std::exception&) {
+        source = Source::None;
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.failures++;
+        return nullptr;
+    }
+}
+
+void ThumbnailPipeline::prefetch(const std::vector<std::filesystem::path>& filePaths,
+                                 const std::array<uint32_t, 2>& size, ReadyCallback onReady) {
+    const uint64_t generation = prefetchGeneration_.fetch_add(1) + 1;
+    for (const std::filesystem::path& filePath : filePaths) {
+        auto task = [this, filePath, size, onReady, generation]() {
+            // A newer prefetch replaced this one before it started
+            if (prefetchGeneration_.load(std::memory_order_acquire) != generation) {
+                std::lock_guard<std::mutex> lock(statsMutex_);
+                stats_.prefetchesDropped++;
+                return;
+            }
+
+            std::shared_ptr<Image> thumbnail = generate(filePath, size);
+            if (onReady) {
+                try {
+                    onReady(filePath, std::move(thumbnail));
+                }
+                catch (...) {
+                    // Callbacks must not throw; nothing would observe it
+                }
+            }
+        };
+
+        if (scheduler_) {
+            scheduler_->submit(*prefetchGroup_, std::move(task), Core::TaskPriority::Background);
+        }
+        else {
+            task();
+        }
+    }
+}
+
+void ThumbnailPipeline::cancelPrefetch() {
+    prefetchGeneration_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void ThumbnailPipeline::waitForPrefetch() {
+    if (scheduler_) {
+        scheduler_->wait(*prefetchGroup_);
+    }
+}
+
+ThumbnailPipeline::Stats ThumbnailPipeline::getStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    return stats_;
+}
+
+std::shared_ptr<Image> ThumbnailPipeline::fit(const Image& image, const std::array<uint32_t, 2>& size) {
+    if (image.width() <= size[0] && image.height() <= size[1]) {
+        return std::make_shared<Image>(image);  // Shares the tiles
+    }
+
+    const double scale = std::min(double(size[0]) / image.width(), double(size[1]) / image.height());
+    const std::array<uint32_t, 2> fitted{
+        std::max<uint32_t>(1, static_cast<uint32_t>(std::lround(image.width() * scale))),
+        std::max<uint32_t>(1, static_cast<uint32_t>(std::lround(image.height() * scale)))};
+
+    // Whole factors by box filter, which averages every source pixel
+    std::shared_ptr<Image> reduced;
+    DecodeRegion region;
+    region.scaleDenominator = std::max<uint32_t>(1, static_cast<uint32_t>(1.0 / scale));
+    if (region.scaleDenominator > 1) {
+        reduced = std::make_shared<Image>(region.outputSize(image.getSize())[0], region.outputSize(image.getSize())[1]);
+        RegionDecodeSink sink(*reduced, region, image.getSize(), Image::CHANNELS, RegionDecodeSink::SampleType::Float32);
+        sink.writeImage(image);
+        if (reduced->getSize() == fitted) {
+            reduced->clearDirtyTiles();
+            return reduced;
+        }
+    }
+
+    // The remaining factor, under two, by interpolation
+    const Image& source = reduced ? *reduced : image;
+    const float stepX = float(source.width()) / fitted[0];
+    const float stepY = float(source.height()) / fitted[1];
+    auto result = std::make_shared<Image>(fitted[0], fitted[1]);
+    for (uint32_t y = 0; y < fitted[1]; ++y) {
+        for (uint32_t x = 0; x < fitted[0]; ++x) {
+            result->setPixel(x, y, source.sampleBilinear((x + 0.5f) * stepX - 0.5f, (y + 0.5f) * stepY - 0.5f));
+        }
+    }
+    result->clearDirtyTiles();
+    return result;
+}
+
+} // namespace QuantumCanvas::IO
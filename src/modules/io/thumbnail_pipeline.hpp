@@ -0,0 +1,147 @@
+#pragma once
+
+#include "byte_source.hpp"
+#include "thumbnail_cache.hpp"
+#include "../raster/raster_image.hpp"
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace QuantumCanvas::Core {
+class TaskScheduler;
+class TaskGroup;
+}
+
+namespace QuantumCanvas::IO {
+
+// Preview images stored inside files, found by reading only their headers
+namespace EmbeddedPreview {
+    // JPEG thumbnail in the EXIF IFD1 of a JPEG (APP1 segment) or of a
+    // TIFF-based file such as TIFF, DNG and most camera RAW formats
+    std::optional<ByteSpan> findExifThumbnail(ByteSpan data);
+
+    // Preview AutoCAD stores in R13 and later drawings: a headerless BMP,
+    // or a PNG from R2013 on. WMF previews are ignored.
+    struct DWGPreview {
+        enum class Type { BMP, PNG };
+        Type type;
+        ByteSpan data;
+    };
+    std::optional<DWGPreview> findDWGPreview(ByteSpan data);
+
+    // decodeJPEG decodes at the smallest DCT scale (1/1 to 1/8) whose sides
+    // still reach minSize, so it doubles as the reduced decode of whole JPEG
+    // files. decodeDIB reads uncompressed 1, 4, 8, 24 and 32-bit DIBs. All
+    // return null on data they cannot decode.
+    std::shared_ptr<Raster::Image> decodeJPEG(ByteSpan data, const std::array<uint32_t, 2>& minSize = {0, 0});
+    std::shared_ptr<Raster::Image> decodePNG(ByteSpan data);
+    std::shared_ptr<Raster::Image> decodeDIB(ByteSpan data);
+
+    // The EXIF or DWG preview of data, if it has one at least half of size
+    // on its longer side; smaller previews would look blurred when shown
+    std::shared_ptr<Raster::Image> extract(ByteSpan data, const std::array<uint32_t, 2>& size);
+    bool isLargeEnough(const Raster::Image& preview, const std::array<uint32_t, 2>& size);
+}
+
+// Thumbnails for file browsers, produced by the cheapest source that works:
+//
+//   1. the disk cache, keyed by the file's content hash
+//   2. an embedded preview: EXIF and DWG built in, others from the owner
+//   3. a reduced decode: JPEG built in via DCT scaling, others from the owner
+//
+// and then fitted to the requested size. Files are mapped, so previews read
+// only the header pages. Concurrent requests for the same file and size share
+// one generation.
+//
+// prefetch() serves scrolling lists: it queues files on the scheduler in the
+// given order and replaces any earlier prefetch, so queued files that scrolled
+// out of view are dropped before they are read.
+class ThumbnailPipeline final {
+public:
+    using Stage = std::function<std::shared_ptr<Raster::Image>(const std::shared_ptr<const ByteSource>& source,
+                                                               const std::array<uint32_t, 2>& size)>;
+
+    // Format-specific stages supplied by the owner; either may be empty, and
+    // either may return null to pass the file on
+    struct Stages {
+        Stage embeddedPreview;  // Formats the pipeline cannot read previews from
+        Stage reducedDecode;    // Sides of at least size where the format allows it
+    };
+
+    enum class Source {
+        None,
+        Cache,
+        EmbeddedPreview,
+        ReducedDecode
+    };
+
+    struct Stats {
+        uint64_t cacheHits = 0;
+        uint64_t embeddedPreviews = 0;
+        uint64_t reducedDecodes = 0;
+        uint64_t failures = 0;
+        uint64_t prefetchesDropped = 0;
+    };
+
+    using ReadyCallback = std::function<void(const std::filesystem::path& filePath,
+                                             std::shared_ptr<Raster::Image> thumbnail)>;
+
+    // Null cache skips the disk cache; null scheduler runs prefetches inline
+    ThumbnailPipeline(std::shared_ptr<ThumbnailCache> cache, Stages stages,
+                      std::shared_ptr<Core::TaskScheduler> scheduler = nullptr);
+    ~ThumbnailPipeline();  // Drops queued prefetches and waits for running ones
+
+    ThumbnailPipeline(const ThumbnailPipeline&) = delete;
+    ThumbnailPipeline& operator=(const ThumbnailPipeline&) = delete;
+
+    // Fits within size, aspect ratio kept; null when no stage produced one or
+    // the file cannot be read. Thread-safe.
+    std::shared_ptr<Raster::Image> generate(const std::filesystem::path& filePath,
+                                            const std::array<uint32_t, 2>& size = {256, 256},
+                                            Source* source = nullptr);
+
+    // onReady runs on the worker that produced each thumbnail, null ones included
+    void prefetch(const std::vector<std::filesystem::path>& filePaths,
+                  const std::array<uint32_t, 2>& size = {256, 256},
+                  ReadyCallback onReady = {});
+    void cancelPrefetch();
+    void waitForPrefetch();
+
+    Stats getStats() const;
+
+    // Scales down to fit within size, box-filtering whole factors and
+    // interpolating the rest; never enlarges
+    static std::shared_ptr<Raster::Image> fit(const Raster::Image& image, const std::array<uint32_t, 2>& size);
+
+private:
+    std::shared_ptr<ThumbnailCache> cache_;
+    Stages stages_;
+    std::shared_ptr<Core::TaskScheduler> scheduler_;
+    std::unique_ptr<Core::TaskGroup> prefetchGroup_;
+    std::atomic<uint64_t> prefetchGeneration_{0};
+
+    struct Result {
+        std::shared_ptr<Raster::Image> image;
+        Source source = Source::None;
+    };
+
+    // Generations in progress, by path and size
+    std::mutex inFlightMutex_;
+    std::unordered_map<std::string, std::shared_future<Result>> inFlight_;
+
+    mutable std::mutex statsMutex_;
+    Stats stats_;
+
+    std::shared_ptr<Raster::Image> produce(const std::filesystem::path& filePath,
+                                           const std::array<uint32_t, 2>& size, Source& source);
+};
+
+} // namespace QuantumCanvas::IO
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "file_format_manager.hpp"
+#include "svg_stream_parser.hpp"
 #include "../../core/math/vector2.hpp"
 #include "../../core/math/vector3.hpp"
 #include <memory>
@@ -526,9 +527,10 @@ public:
     FormatCapabilities getCapabilities() const override;
     
     FormatDetectionResult detectFormat(const std::filesystem::path& filePath) const override;
-    FormatDetectionResult detectFormat(const std::vector<uint8_t>& data) const override;
+    FormatDetectionResult detectFormat(ByteSpan data) const override;
     
     FileInfo getFileInfo(const std::filesystem::path& filePath) const override;
+    FileInfo getFileInfo(ByteSpan data) const override;
     
     std::future<std::shared_ptr<Document>> loadDocument(
         const std::filesystem::path& filePath,
@@ -538,6 +540,14 @@ public:
         const std::filesystem::path& filePath,
         const LoadOptions& options) override;
     
+    std::future<std::shared_ptr<Document>> loadDocument(
+        std::shared_ptr<const ByteSource> source,
+        const LoadOptions& options) override;
+    
+    std::future<std::shared_ptr<Image>> loadImage(
+        std::shared_ptr<const ByteSource> source,
+        const LoadOptions& options) override;
+    
     std::future<bool> saveDocument(
         const std::shared_ptr<Document>& document,
         const std::filesystem::path& filePath,
@@ -556,6 +566,12 @@ public:
     SVG::SVGDocument parseSVG(const std::filesystem::path& filePath) const;
     SVG::SVGDocument parseSVG(const std::string& svgContent) const;
     
+    // One streaming pass into an arena, without the XML node tree and
+    // SVGElement objects parseSVG() builds; for large exports
+    static SVGElementStore parseSVGStream(std::shared_ptr<const ByteSource> source) {
+        return SVGElementStore::parse(std::move(source));
+    }
+    
     std::string generateSVG(const std::shared_ptr<Document>& document, 
                            const SaveOptions& options = {}) const;
     
@@ -638,9 +654,10 @@ public:
     FormatCapabilities getCapabilities() const override;
     
     FormatDetectionResult detectFormat(const std::filesystem::path& filePath) const override;
-    FormatDetectionResult detectFormat(const std::vector<uint8_t>& data) const override;
+    FormatDetectionResult detectFormat(ByteSpan data) const override;
     
     FileInfo getFileInfo(const std::filesystem::path& filePath) const override;
+    FileInfo getFileInfo(ByteSpan data) const override;
     
     std::future<std::shared_ptr<Document>> loadDocument(
         const std::filesystem::path& filePath,
@@ -650,6 +667,14 @@ public:
         const std::filesystem::path& filePath,
         const LoadOptions& options) override;
     
+    std::future<std::shared_ptr<Document>> loadDocument(
+        std::shared_ptr<const ByteSource> source,
+        const LoadOptions& options) override;
+    
+    std::future<std::shared_ptr<Image>> loadImage(
+        std::shared_ptr<const ByteSource> source,
+        const LoadOptions& options) override;
+    
     std::future<bool> saveDocument(
         const std::shared_ptr<Document>& document,
         const std::filesystem::path& filePath,
@@ -700,9 +725,10 @@ public:
     FormatCapabilities getCapabilities() const override;
     
     FormatDetectionResult detectFormat(const std::filesystem::path& filePath) const override;
-    FormatDetectionResult detectFormat(const std::vector<uint8_t>& data) const override;
+    FormatDetectionResult detectFormat(ByteSpan data) const override;
     
     FileInfo getFileInfo(const std::filesystem::path& filePath) const override;
+    FileInfo getFileInfo(ByteSpan data) const override;
     
     std::future<std::shared_ptr<Document>> loadDocument(
         const std::filesystem::path& filePath,
@@ -712,6 +738,14 @@ public:
         const std::filesystem::path& filePath,
         const LoadOptions& options) override;
     
+    std::future<std::shared_ptr<Document>> loadDocument(
+        std::shared_ptr<const ByteSource> source,
+        const LoadOptions& options) override;
+    
+    std::future<std::shared_ptr<Image>> loadImage(
+        std::shared_ptr<const ByteSource> source,
+        const LoadOptions& options) override;
+    
     std::future<bool> saveDocument(
         const std::shared_ptr<Document>& document,
         const std::filesystem::path& filePath,
@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+#include "../blend_kernels.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace QuantumCanvas::Raster;
+
+namespace {
+
+constexpr size_t TILE_PIXELS = size_t(Image::TILE_SIZE) * Image::TILE_SIZE;
+
+const std::pair<BlendMode, const char*> MODES[] = {
+    {BlendMode::Normal, "Normal"},
+    {BlendMode::Multiply, "Multiply"},
+    {BlendMode::Screen, "Screen"},
+    {BlendMode::Overlay, "Overlay"},
+    {BlendMode::SoftLight, "SoftLight"},
+    {BlendMode::ColorDodge, "ColorDodge"},
+    {BlendMode::Difference, "Difference"},
+};
+
+const CpuBlend::Isa ISAS[] = {
+    CpuBlend::Isa::Scalar,
+    CpuBlend::Isa::AVX2,
+    CpuBlend::Isa::AVX512,
+    CpuBlend::Isa::NEON,
+};
+
+// One tile of premultiplied pixels per layer, as blendImage() feeds the kernels
+std::vector<float> randomPlanes(uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::vector<float> data(TILE_PIXELS * 4);
+    for (size_t i = 0; i < TILE_PIXELS; ++i) {
+        float alpha = unit(rng);
+        for (size_t c = 0; c < 3; ++c) {
+            data[c * TILE_PIXELS + i] = unit(rng) * alpha;
+        }
+        data[3 * TILE_PIXELS + i] = alpha;
+    }
+    return data;
+}
+
+template <typename T, typename P>
+P planesOf(T* data) {
+    return {data, data + TILE_PIXELS, data + TILE_PIXELS * 2, data + TILE_PIXELS * 3};
+}
+
+void BM_BlendTile(benchmark::State& state, BlendMode mode, CpuBlend::Isa isa) {
+    const auto overlay = randomPlanes(1);
+    const auto initialBase = randomPlanes(2);
+    auto base = initialBase;
+
+    auto basePlanes = planesOf<float, CpuBlend::Planes>(base.data());
+    auto overlayPlanes = planesOf<const float, CpuBlend::ConstPlanes>(overlay.data());
+
+    // Blending in place repeatedly would decay the base into denormals, so
+    // every iteration starts from the same pixels
+    for (auto _ : state) {
+        std::copy(initialBase.begin(), initialBase.end(), base.begin());
+        CpuBlend::blend(isa, mode, basePlanes, overlayPlanes, TILE_PIXELS, 0.8f);
+        benchmark::DoNotOptimize(base.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * TILE_PIXELS));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * TILE_PIXELS * 3 * 4 * sizeof(float)));
+}
+
+// Whole 4K image including the interleaved/planar conversions. The target
+// persists across iterations like a composite target does; Normal converges
+// instead of decaying towards denormals when applied repeatedly.
+void BM_BlendImage4K(benchmark::State& state, CpuBlend::Isa isa) {
+    Image target(3840, 2160, {1.0f, 1.0f, 1.0f, 1.0f});
+    Image overlay(3840, 2160);
+    for (uint32_t y = 0; y < overlay.height(); y += 3) {
+        for (uint32_t x = 0; x < overlay.width(); x += 3) {
+            overlay.setPixel(x, y, {0.8f, 0.3f, 0.1f, 0.6f});
+        }
+    }
+
+    CpuBlend::setActiveIsa(isa);
+    CpuBlend::blendImage(target, overlay, BlendMode::Normal, 1.0f);  // Allocates the target's tiles
+    for (auto _ : state) {
+        CpuBlend::blendImage(target, overlay, BlendMode::Normal, 1.0f);
+        benchmark::ClobberMemory();
+    }
+    CpuBlend::setActiveIsa(CpuBlend::detectIsa());
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * target.width() * target.height()));
+}
+
+// ISAs this machine lacks aren't registered, so the scalar reference is
+// always the first row to compare against
+const bool registered = [] {
+    for (auto isa : ISAS) {
+        if (!CpuBlend::isIsaAvailable(isa)) continue;
+
+        for (const auto& [mode, name] : MODES) {
+            std::string benchmarkName = std::string("BlendTile/") + name + "/" + CpuBlend::isaName(isa);
+            benchmark::RegisterBenchmark(benchmarkName.c_str(), BM_BlendTile, mode, isa);
+        }
+        std::string imageName = std::string("BlendImage4K/Normal/") + CpuBlend::isaName(isa);
+        benchmark::RegisterBenchmark(imageName.c_str(), BM_BlendImage4K, isa)->Unit(benchmark::kMillisecond);
+    }
+    return true;
+}();
+
+} // namespace
@@ -0,0 +1,254 @@
+#include "blend_kernels.hpp"
+#include "internal/blend_kernels_impl.hpp"
+#include "../../core/kernel/task_scheduler.hpp"
+#include "../../core/kernel/telemetry.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+namespace QuantumCanvas::Raster::CpuBlend {
+
+namespace Detail {
+
+namespace {
+
+// One pixel per "vector"; the reference the SIMD kernels are checked against
+struct ScalarVec {
+    using Mask = bool;
+    static constexpr size_t LANES = 1;
+
+    float v;
+
+    static ScalarVec load(const float* p) { return {*p}; }
+    static ScalarVec broadcast(float x) { return {x}; }
+    void store(float* p) const { *p = v; }
+
+    friend ScalarVec operator+(ScalarVec a, ScalarVec b) { return {a.v + b.v}; }
+    friend ScalarVec operator-(ScalarVec a, ScalarVec b) { return {a.v - b.v}; }
+    friend ScalarVec operator*(ScalarVec a, ScalarVec b) { return {a.v * b.v}; }
+    friend ScalarVec operator/(ScalarVec a, ScalarVec b) { return {a.v / b.v}; }
+    friend ScalarVec vmin(ScalarVec a, ScalarVec b) { return {std::min(a.v, b.v)}; }
+    friend ScalarVec vmax(ScalarVec a, ScalarVec b) { return {std::max(a.v, b.v)}; }
+    friend ScalarVec vabs(ScalarVec a) { return {std::fabs(a.v)}; }
+    friend ScalarVec vsqrt(ScalarVec a) { return {std::sqrt(a.v)}; }
+    friend bool lessEqual(ScalarVec a, ScalarVec b) { return a.v <= b.v; }
+    friend bool less(ScalarVec a, ScalarVec b) { return a.v < b.v; }
+    friend ScalarVec select(bool mask, ScalarVec ifTrue, ScalarVec ifFalse) { return mask ? ifTrue : ifFalse; }
+};
+
+} // namespace
+
+size_t blendScalar(BlendMode mode, const Planes& base, const ConstPlanes& overlay, size_t count, float opacity) {
+    return blendPlanes<ScalarVec>(mode, base, overlay, count, opacity);
+}
+
+} // namespace Detail
+
+namespace {
+
+bool cpuHasIsa(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar:
+            return true;
+        case Isa::AVX2:
+#if defined(QUANTUM_CANVAS_HAVE_AVX2) && (defined(__GNUC__) || defined(__clang__))
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+            return false;
+#endif
+        case Isa::AVX512:
+#if defined(QUANTUM_CANVAS_HAVE_AVX512) && (defined(__GNUC__) || defined(__clang__))
+            return __builtin_cpu_supports("avx512f");
+#else
+            return false;
+#endif
+        case Isa::NEON:
+            // NEON is part of the AArch64 baseline
+#if defined(QUANTUM_CANVAS_HAVE_NEON)
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+std::atomic<Isa>& activeIsaSlot() {
+    static std::atomic<Isa> isa{detectIsa()};
+    return isa;
+}
+
+// Premultiplied fill for pixels of a tile nobody allocated
+void fillPlanes(const Planes& planes, const Image::Pixel& color, size_t count) {
+    std::fill_n(planes[0], count, color[0] * color[3]);
+    std::fill_n(planes[1], count, color[1] * color[3]);
+    std::fill_n(planes[2], count, color[2] * color[3]);
+    std::fill_n(planes[3], count, color[3]);
+}
+
+} // namespace
+
+bool isSupported(BlendMode mode) {
+    switch (mode) {
+        case BlendMode::Dissolve:
+        case BlendMode::DarkerColor:
+        case BlendMode::LighterColor:
+        case BlendMode::Hue:
+        case BlendMode::Saturation:
+        case BlendMode::Color:
+        case BlendMode::Luminosity:
+            return false;
+        default:
+            return mode <= BlendMode::Add;
+    }
+}
+
+Isa detectIsa() {
+    for (Isa isa : {Isa::AVX512, Isa::AVX2, Isa::NEON}) {
+        if (cpuHasIsa(isa)) {
+            return isa;
+        }
+    }
+    return Isa::Scalar;
+}
+
+Isa activeIsa() {
+    return activeIsaSlot().load(std::memory_order_relaxed);
+}
+
+void setActiveIsa(Isa isa) {
+    activeIsaSlot().store(isIsaAvailable(isa) ? isa : detectIsa(), std::memory_order_relaxed);
+}
+
+bool isIsaAvailable(Isa isa) {
+    return cpuHasIsa(isa);
+}
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return "Scalar";
+        case Isa::AVX2: return "AVX2";
+        case Isa::AVX512: return "AVX-512";
+        case Isa::NEON: return "NEON";
+    }
+    return "Unknown";
+}
+
+bool blend(BlendMode mode, const Planes& base, const ConstPlanes& overlay, size_t count, float opacity) {
+    return blend(activeIsa(), mode, base, overlay, count, opacity);
+}
+
+bool blend(Isa isa, BlendMode mode, const Planes& base, const ConstPlanes& overlay,
+           size_t count, float opacity) {
+    if (!isSupported(mode)) {
+        return false;
+    }
+    if (!isIsaAvailable(isa)) {
+        isa = Isa::Scalar;
+    }
+
+    size_t done = 0;
+    switch (isa) {
+#if defined(QUANTUM_CANVAS_HAVE_AVX512)
+        case Isa::AVX512: done = Detail::blendAvx512(mode, base, overlay, count, opacity); break;
+#endif
+#if defined(QUANTUM_CANVAS_HAVE_AVX2)
+        case Isa::AVX2: done = Detail::blendAvx2(mode, base, overlay, count, opacity); break;
+#endif
+#if defined(QUANTUM_CANVAS_HAVE_NEON)
+        case Isa::NEON: done = Detail::blendNeon(mode, base, overlay, count, opacity); break;
+#endif
+        default: break;
+    }
+
+    // Pixels past the last full vector
+    if (done < count) {
+        Planes baseTail = {base[0] + done, base[1] + done, base[2] + done, base[3] + done};
+        ConstPlanes overlayTail = {overlay[0] + done, overlay[1] + done, overlay[2] + done, overlay[3] + done};
+        Detail::blendScalar(mode, baseTail, overlayTail, count - done, opacity);
+    }
+    return true;
+}
+
+void loadPremultiplied(const float* rgba, const Planes& planes, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const float* p = rgba + i * 4;
+        planes[0][i] = p[0] * p[3];
+        planes[1][i] = p[1] * p[3];
+        planes[2][i] = p[2] * p[3];
+        planes[3][i] = p[3];
+    }
+}
+
+void storeStraight(const ConstPlanes& planes, float* rgba, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        float alpha = planes[3][i];
+        float scale = alpha > 0.0f ? 1.0f / alpha : 0.0f;
+        float* p = rgba + i * 4;
+        p[0] = planes[0][i] * scale;
+        p[1] = planes[1][i] * scale;
+        p[2] = planes[2][i] * scale;
+        p[3] = alpha;
+    }
+}
+
+bool blendImage(Image& base, const Image& overlay, BlendMode mode, float opacity) {
+    QCS_TRACE_SCOPE("raster.blend_image");
+    if (!isSupported(mode) || base.getSize() != overlay.getSize()) {
+        return false;
+    }
+
+    constexpr uint32_t tileSize = Image::TILE_SIZE;
+    constexpr size_t tilePixels = size_t(tileSize) * tileSize;
+    const Isa isa = activeIsa();
+
+    // A transparent overlay fill changes nothing, except under Replace which
+    // fades the base towards it
+    const bool fillIsNoop = overlay.fillColor()[3] * opacity <= 0.0f && mode != BlendMode::Replace;
+
+    Core::parallel_for(0, base.tileCount(), 1, [&](size_t index) {
+        uint32_t tileX = static_cast<uint32_t>(index % base.tilesX());
+        uint32_t tileY = static_cast<uint32_t>(index / base.tilesX());
+
+        const float* overlayTile = overlay.tileData(tileX, tileY);
+        if (!overlayTile && fillIsNoop) {
+            return;
+        }
+
+        thread_local std::vector<float> scratch(tilePixels * 8);
+        Planes basePlanes = {scratch.data(), scratch.data() + tilePixels,
+                             scratch.data() + tilePixels * 2, scratch.data() + tilePixels * 3};
+        Planes overlayPlanes = {scratch.data() + tilePixels * 4, scratch.data() + tilePixels * 5,
+                                scratch.data() + tilePixels * 6, scratch.data() + tilePixels * 7};
+
+        if (const float* baseTile = base.tileData(tileX, tileY)) {
+            loadPremultiplied(baseTile, basePlanes, tilePixels);
+        } else {
+            fillPlanes(basePlanes, base.fillColor(), tilePixels);
+        }
+        if (overlayTile) {
+            loadPremultiplied(overlayTile, overlayPlanes, tilePixels);
+        } else {
+            fillPlanes(overlayPlanes, overlay.fillColor(), tilePixels);
+        }
+
+        blend(isa, mode, basePlanes,
+              {overlayPlanes[0], overlayPlanes[1], overlayPlanes[2], overlayPlanes[3]},
+              tilePixels, opacity);
+
+        // Only pixels inside the image are written, so edge tiles keep the
+        // fill color beyond the border
+        uint32_t validX = std::min(tileSize, base.width() - tileX * tileSize);
+        uint32_t validY = std::min(tileSize, base.height() - tileY * tileSize);
+        float* dst = base.mutableTileData(tileX, tileY);
+        for (uint32_t y = 0; y < validY; ++y) {
+            size_t row = size_t(y) * tileSize;
+            storeStraight({basePlanes[0] + row, basePlanes[1] + row, basePlanes[2] + row, basePlanes[3] + row},
+                          dst + y * Image::TILE_STRIDE, validX);
+        }
+    });
+    return true;
+}
+
+} // namespace QuantumCanvas::Raster::CpuBlend
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "blend_mode.hpp"
+#include "raster_image.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace QuantumCanvas::Raster::CpuBlend {
+
+// CPU blend kernels for machines without a usable GPU adapter and for
+// headless rendering. Pixels are premultiplied RGBA in planar (SoA) form,
+// one contiguous plane per channel, so every lane of a vector holds the
+// same channel of consecutive pixels.
+//
+// Separable modes follow the W3C compositing formula
+//     co = cs * (1 - ab) + cb * (1 - as) + as * ab * B(Cb, Cs)
+// on premultiplied values; the GPU blend shader uses straight alpha, and
+// both agree wherever the base is opaque.
+using Planes = std::array<float*, 4>;
+using ConstPlanes = std::array<const float*, 4>;
+
+enum class Isa : uint8_t {
+    Scalar,
+    AVX2,
+    AVX512,
+    NEON
+};
+
+// Everything but the non-separable modes (DarkerColor, LighterColor, Hue,
+// Saturation, Color, Luminosity), Dissolve and custom modes
+bool isSupported(BlendMode mode);
+
+// Best instruction set this build and CPU both support; the active one
+// starts there and can be lowered for benchmarks and tests
+Isa detectIsa();
+Isa activeIsa();
+void setActiveIsa(Isa isa);  // Clamped to detectIsa()
+bool isIsaAvailable(Isa isa);
+const char* isaName(Isa isa);
+
+// base = blend(base, overlay * opacity). Returns false, leaving base
+// untouched, when the mode is unsupported.
+bool blend(BlendMode mode, const Planes& base, const ConstPlanes& overlay,
+           size_t count, float opacity);
+bool blend(Isa isa, BlendMode mode, const Planes& base, const ConstPlanes& overlay,
+           size_t count, float opacity);
+
+// Conversions between Image's interleaved straight RGBA and premultiplied planes
+void loadPremultiplied(const float* rgba, const Planes& planes, size_t count);
+void storeStraight(const ConstPlanes& planes, float* rgba, size_t count);
+
+// Blends overlay onto base pixel for pixel, tile by tile in parallel. Images
+// must have the same size. Tiles neither side has allocated are skipped when
+// the overlay's fill leaves the base unchanged.
+bool blendImage(Image& base, const Image& overlay, BlendMode mode, float opacity);
+
+} // namespace QuantumCanvas::Raster::CpuBlend
@@ -0,0 +1,40 @@
+#include "internal/blend_kernels_impl.hpp"
+#include <immintrin.h>
+
+// Compiled with -mavx2 -mfma; only called after the CPU was checked
+namespace QuantumCanvas::Raster::CpuBlend::Detail {
+
+namespace {
+
+struct Avx2Vec {
+    using Mask = __m256;
+    static constexpr size_t LANES = 8;
+
+    __m256 v;
+
+    static Avx2Vec load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    static Avx2Vec broadcast(float x) { return {_mm256_set1_ps(x)}; }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+
+    friend Avx2Vec operator+(Avx2Vec a, Avx2Vec b) { return {_mm256_add_ps(a.v, b.v)}; }
+    friend Avx2Vec operator-(Avx2Vec a, Avx2Vec b) { return {_mm256_sub_ps(a.v, b.v)}; }
+    friend Avx2Vec operator*(Avx2Vec a, Avx2Vec b) { return {_mm256_mul_ps(a.v, b.v)}; }
+    friend Avx2Vec operator/(Avx2Vec a, Avx2Vec b) { return {_mm256_div_ps(a.v, b.v)}; }
+    friend Avx2Vec vmin(Avx2Vec a, Avx2Vec b) { return {_mm256_min_ps(a.v, b.v)}; }
+    friend Avx2Vec vmax(Avx2Vec a, Avx2Vec b) { return {_mm256_max_ps(a.v, b.v)}; }
+    friend Avx2Vec vabs(Avx2Vec a) { return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)}; }
+    friend Avx2Vec vsqrt(Avx2Vec a) { return {_mm256_sqrt_ps(a.v)}; }
+    friend Mask lessEqual(Avx2Vec a, Avx2Vec b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ); }
+    friend Mask less(Avx2Vec a, Avx2Vec b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+    friend Avx2Vec select(Mask mask, Avx2Vec ifTrue, Avx2Vec ifFalse) {
+        return {_mm256_blendv_ps(ifFalse.v, ifTrue.v, mask)};
+    }
+};
+
+} // namespace
+
+size_t blendAvx2(BlendMode mode, const Planes& base, const ConstPlanes& overlay, size_t count, float opacity) {
+    return blendPlanes<Avx2Vec>(mode, base, overlay, count, opacity);
+}
+
+} // namespace QuantumCanvas::Raster::CpuBlend::Detail
@@ -0,0 +1,40 @@
+#include "internal/blend_kernels_impl.hpp"
+#include <immintrin.h>
+
+// Compiled with -mavx512f; only called after the CPU was checked
+namespace QuantumCanvas::Raster::CpuBlend::Detail {
+
+namespace {
+
+struct Avx512Vec {
+    using Mask = __mmask16;
+    static constexpr size_t LANES = 16;
+
+    __m512 v;
+
+    static Avx512Vec load(const float* p) { return {_mm512_loadu_ps(p)}; }
+    static Avx512Vec broadcast(float x) { return {_mm512_set1_ps(x)}; }
+    void store(float* p) const { _mm512_storeu_ps(p, v); }
+
+    friend Avx512Vec operator+(Avx512Vec a, Avx512Vec b) { return {_mm512_add_ps(a.v, b.v)}; }
+    friend Avx512Vec operator-(Avx512Vec a, Avx512Vec b) { return {_mm512_sub_ps(a.v, b.v)}; }
+    friend Avx512Vec operator*(Avx512Vec a, Avx512Vec b) { return {_mm512_mul_ps(a.v, b.v)}; }
+    friend Avx512Vec operator/(Avx512Vec a, Avx512Vec b) { return {_mm512_div_ps(a.v, b.v)}; }
+    friend Avx512Vec vmin(Avx512Vec a, Avx512Vec b) { return {_mm512_min_ps(a.v, b.v)}; }
+    friend Avx512Vec vmax(Avx512Vec a, Avx512Vec b) { return {_mm512_max_ps(a.v, b.v)}; }
+    friend Avx512Vec vabs(Avx512Vec a) { return {_mm512_abs_ps(a.v)}; }
+    friend Avx512Vec vsqrt(Avx512Vec a) { return {_mm512_sqrt_ps(a.v)}; }
+    friend Mask lessEqual(Avx512Vec a, Avx512Vec b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ); }
+    friend Mask less(Avx512Vec a, Avx512Vec b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ); }
+    friend Avx512Vec select(Mask mask, Avx512Vec ifTrue, Avx512Vec ifFalse) {
+        return {_mm512_mask_blend_ps(mask, ifFalse.v, ifTrue.v)};
+    }
+};
+
+} // namespace
+
+size_t blendAvx512(BlendMode mode, const Planes& base, const ConstPlanes& overlay, size_t count, float opacity) {
+    return blendPlanes<Avx512Vec>(mode, base, overlay, count, opacity);
+}
+
+} // namespace QuantumCanvas::Raster::CpuBlend::Detail
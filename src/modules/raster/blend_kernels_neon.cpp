@@ -0,0 +1,40 @@
+#include "internal/blend_kernels_impl.hpp"
+#include <arm_neon.h>
+
+// AArch64 only: vdivq_f32 and vsqrtq_f32 are not in 32-bit NEON
+namespace QuantumCanvas::Raster::CpuBlend::Detail {
+
+namespace {
+
+struct NeonVec {
+    using Mask = uint32x4_t;
+    static constexpr size_t LANES = 4;
+
+    float32x4_t v;
+
+    static NeonVec load(const float* p) { return {vld1q_f32(p)}; }
+    static NeonVec broadcast(float x) { return {vdupq_n_f32(x)}; }
+    void store(float* p) const { vst1q_f32(p, v); }
+
+    friend NeonVec operator+(NeonVec a, NeonVec b) { return {vaddq_f32(a.v, b.v)}; }
+    friend NeonVec operator-(NeonVec a, NeonVec b) { return {vsubq_f32(a.v, b.v)}; }
+    friend NeonVec operator*(NeonVec a, NeonVec b) { return {vmulq_f32(a.v, b.v)}; }
+    friend NeonVec operator/(NeonVec a, NeonVec b) { return {vdivq_f32(a.v, b.v)}; }
+    friend NeonVec vmin(NeonVec a, NeonVec b) { return {vminq_f32(a.v, b.v)}; }
+    friend NeonVec vmax(NeonVec a, NeonVec b) { return {vmaxq_f32(a.v, b.v)}; }
+    friend NeonVec vabs(NeonVec a) { return {vabsq_f32(a.v)}; }
+    friend NeonVec vsqrt(NeonVec a) { return {vsqrtq_f32(a.v)}; }
+    friend Mask lessEqual(NeonVec a, NeonVec b) { return vcleq_f32(a.v, b.v); }
+    friend Mask less(NeonVec a, NeonVec b) { return vcltq_f32(a.v, b.v); }
+    friend NeonVec select(Mask mask, NeonVec ifTrue, NeonVec ifFalse) {
+        return {vbslq_f32(mask, ifTrue.v, ifFalse.v)};
+    }
+};
+
+} // namespace
+
+size_t blendNeon(BlendMode mode, const Planes& base, const ConstPlanes& overlay, size_t count, float opacity) {
+    return blendPlanes<NeonVec>(mode, base, overlay, count, opacity);
+}
+
+} // namespace QuantumCanvas::Raster::CpuBlend::Detail
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+namespace QuantumCanvas::Raster {
+
+// Blend modes supported by the compositor
+enum class BlendMode : uint16_t {
+    // Normal blend modes
+    Normal = 0,
+    Dissolve,
+    
+    // Darkening blend modes
+    Darken,
+    Multiply,
+    ColorBurn,
+    LinearBurn,
+    DarkerColor,
+    
+    // Lightening blend modes
+    Lighten,
+    Screen,
+    ColorDodge,
+    LinearDodge,
+    LighterColor,
+    
+    // Contrast blend modes
+    Overlay,
+    SoftLight,
+    HardLight,
+    VividLight,
+    LinearLight,
+    PinLight,
+    HardMix,
+    
+    // Comparative blend modes
+    Difference,
+    Exclusion,
+    Subtract,
+    Divide,
+    
+    // Component blend modes
+    Hue,
+    Saturation,
+    Color,
+    Luminosity,
+    
+    // Special blend modes
+    Behind,      // Paint behind existing pixels
+    Clear,       // Clear/erase pixels
+    Replace,     // Replace pixels entirely
+    Add,         // Additive blending
+    
+    // Custom blend modes
+    Custom = 1000  // Starting point for user-defined blend modes
+};
+
+} // namespace QuantumCanvas::Raster
@@ -1,8 +1,10 @@
 #include "brush_engine.hpp"
 #include "../../core/rendering/rendering_engine.hpp"
 #include "../../core/memory/memory_manager.hpp"
+#include "../../core/kernel/task_scheduler.hpp"
 #include <iostream>
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <random>
 #include <cassert>
@@ -13,38 +15,6 @@
 
 namespace QuantumCanvas::Raster {
 
-// Forward declaration for Image class (would be implemented separately)
-class Image {
-public:
-    uint32_t width = 0;
-    uint32_t height = 0;
-    std::vector<uint8_t> data;
-    
-    Image(uint32_t w, uint32_t h) : width(w), height(h) {
-        data.resize(w * h * 4); // RGBA
-    }
-    
-    void setPixel(uint32_t x, uint32_t y, const std::array<float, 4>& color) {
-        if (x >= width || y >= height) return;
-        size_t idx = (y * width + x) * 4;
-        data[idx + 0] = static_cast<uint8_t>(color[0] * 255);
-        data[idx + 1] = static_cast<uint8_t>(color[1] * 255);
-        data[idx + 2] = static_cast<uint8_t>(color[2] * 255);
-        data[idx + 3] = static_cast<uint8_t>(color[3] * 255);
-    }
-    
-    std::array<float, 4> getPixel(uint32_t x, uint32_t y) const {
-        if (x >= width || y >= height) return {0.0f, 0.0f, 0.0f, 0.0f};
-        size_t idx = (y * width + x) * 4;
-        return {
-            data[idx + 0] / 255.0f,
-            data[idx + 1] / 255.0f,
-            data[idx + 2] / 255.0f,
-            data[idx + 3] / 255.0f
-        };
-    }
-};
-
 // FluidSimulator implementation for realistic paint behavior
 FluidSimulator::FluidSimulator(Rendering::RenderingEngine& engine)
     : engine_(engine) {
@@ -55,32 +25,13 @@ FluidSimulator::~FluidSimulator() {
 }
 
 bool FluidSimulator::initialize(const std::array<uint32_t, 2>& gridSize) {
-    if (initialized_) {
+    if (initialized_ && gridSize == gridSize_) {
         return true;
     }
     
     gridSize_ = gridSize;
-    
-    // Create GPU textures for fluid simulation
-    velocityTexture_ = engine_.create_texture_2d(
-        gridSize[0], gridSize[1], Rendering::TextureFormat::RG32Float,
-        Rendering::TextureUsage::Storage | Rendering::TextureUsage::Sampled
-    );
-    
-    paintTexture_ = engine_.create_texture_2d(
-        gridSize[0], gridSize[1], Rendering::TextureFormat::RGBA32Float,
-        Rendering::TextureUsage::Storage | Rendering::TextureUsage::Sampled
-    );
-    
-    pressureTexture_ = engine_.create_texture_2d(
-        gridSize[0], gridSize[1], Rendering::TextureFormat::R32Float,
-        Rendering::TextureUsage::Storage | Rendering::TextureUsage::Sampled
-    );
-    
-    if (!createSimulationShaders()) {
-        std::cerr << "[FluidSimulator] Failed to create simulation shaders" << std::endl;
-        return false;
-    }
+    medium_.reset(gridSize[0], gridSize[1]);
+    updateParameters();
     
     initialized_ = true;
     std::cout << "[FluidSimulator] Initialized with grid size " << gridSize[0] << "x" << gridSize[1] << std::endl;
@@ -92,7 +43,7 @@ void FluidSimulator::shutdown() {
         return;
     }
     
-    destroyResources();
+    medium_.reset(0, 0);
     initialized_ = false;
     std::cout << "[FluidSimulator] Shutdown complete" << std::endl;
 }
@@ -102,62 +53,20 @@ void FluidSimulator::step(float deltaTime) {
         return;
     }
     
-    // Simplified fluid simulation steps:
-    // 1. Advection - move paint with velocity field
-    // 2. Diffusion - spread velocity and paint
-    // 3. Pressure projection - ensure incompressibility
-    
-    // For now, just apply simple diffusion
-    applyDiffusion(deltaTime);
+    medium_.step(deltaTime);
 }
 
-void FluidSimulator::addPaint(const std::array<float, 2>& position, 
-                             const std::array<float, 4>& color,
-                             float amount, float viscosity) {
+void FluidSimulator::addPaint(const std::array<float, 2>& position, float radius,
+                             const std::array<float, 4>& color, float amount) {
     if (!initialized_) {
         return;
     }
     
-    // Convert world position to grid coordinates
-    uint32_t gridX = static_cast<uint32_t>(position[0] * gridSize_[0]);
-    uint32_t gridY = static_cast<uint32_t>(position[1] * gridSize_[1]);
-    
-    if (gridX >= gridSize_[0] || gridY >= gridSize_[1]) {
-        return;
-    }
-    
-    // Add paint to the simulation (would update GPU texture)
-    // This is a simplified CPU implementation
+    medium_.deposit(position[0], position[1], radius, color, amount);
 }
 
-bool FluidSimulator::createSimulationShaders() {
-    // Create compute shaders for fluid simulation
-    // This would require actual compute shader code
-    
-    // For now, return true as placeholder
-    return true;
-}
-
-void FluidSimulator::destroyResources() {
-    if (velocityTexture_ != 0) {
-        engine_.destroy_texture(velocityTexture_);
-        velocityTexture_ = 0;
-    }
-    
-    if (paintTexture_ != 0) {
-        engine_.destroy_texture(paintTexture_);
-        paintTexture_ = 0;
-    }
-    
-    if (pressureTexture_ != 0) {
-        engine_.destroy_texture(pressureTexture_);
-        pressureTexture_ = 0;
-    }
-}
-
-void FluidSimulator::applyDiffusion(float deltaTime) {
-    // Apply diffusion using compute shader
-    // This would dispatch the diffusion compute shader
+void FluidSimulator::updateParameters() {
+    medium_.setParameters(viscosity_, diffusion_, evaporation_);
 }
 
 // BrushStroke implementation
@@ -255,7 +164,7 @@ bool BrushEngine::Initialize() {
     }
     
     // Initialize bristle data
-    bristle_data_ = std::make_unique<BristleData>();
+    bristle_data_ = std::make_unique<BristleSet>();
     
     std::cout << "[BrushEngine] Initialization complete" << std::endl;
     return true;
@@ -473,7 +382,7 @@ void BrushEngine::RenderTexturedBrush(const BrushDab& dab, const BrushSettings&
 }
 
 void BrushEngine::RenderBristleBrush(const BrushDab& dab, const BrushSettings& settings) {
-    if (!bristle_data_ || settings.bristle_count == 0) {
+    if (!bristle_data_ || bristle_data_->empty()) {
         RenderRoundBrush(dab, settings);
         return;
     }
@@ -482,49 +391,27 @@ void BrushEngine::RenderBristleBrush(const BrushDab& dab, const BrushSettings& s
     UpdateBristleSimulation(dab, settings);
     
     // Render individual bristles
-    for (size_t i = 0; i < bristle_data_->positions.size(); ++i) {
+    const float* x = bristle_data_->x();
+    const float* y = bristle_data_->y();
+    const float* pressure = bristle_data_->pressure();
+    for (size_t i = 0; i < bristle_data_->size(); ++i) {
         BrushDab bristle_dab = dab;
-        bristle_dab.position.x = bristle_data_->positions[i].x;
-        bristle_dab.position.y = bristle_data_->positions[i].y;
+        bristle_dab.position.x = x[i];
+        bristle_dab.position.y = y[i];
         bristle_dab.size *= 0.3f; // Smaller size for individual bristles
-        bristle_dab.opacity *= bristle_data_->pressures[i];
+        bristle_dab.opacity *= pressure[i];
         
         RenderRoundBrush(bristle_dab, settings);
     }
 }
 
 void BrushEngine::UpdateBristleSimulation(const BrushDab& dab, const BrushSettings& settings) {
-    if (!bristle_data_ || bristle_data_->positions.empty()) {
+    if (!bristle_data_ || bristle_data_->empty()) {
         return;
     }
     
-    // Simple bristle physics simulation
-    for (size_t i = 0; i < bristle_data_->positions.size(); ++i) {
-        auto& pos = bristle_data_->positions[i];
-        auto& vel = bristle_data_->velocities[i];
-        auto& pressure = bristle_data_->pressures[i];
-        
-        // Apply forces toward brush center with stiffness
-        float dx = dab.position.x - pos.x;
-        float dy = dab.position.y - pos.y;
-        
-        float spring_force = settings.bristle_stiffness * 0.1f;
-        vel.x += dx * spring_force;
-        vel.y += dy * spring_force;
-        
-        // Apply damping
-        vel.x *= 0.9f;
-        vel.y *= 0.9f;
-        
-        // Update position
-        pos.x += vel.x;
-        pos.y += vel.y;
-        
-        // Update pressure based on distance from center
-        float distance = std::sqrt(dx * dx + dy * dy);
-        float max_distance = dab.size * 0.5f;
-        pressure = std::max(0.1f, 1.0f - distance / max_distance) * dab.pressure;
-    }
+    bristle_data_->step(dab.position.x, dab.position.y, dab.size * 0.5f, dab.pressure,
+                        settings.bristle_stiffness);
 }
 
 void BrushEngine::InitializeBristles(uint32_t count, float stiffness, float length) {
@@ -532,34 +419,7 @@ void BrushEngine::InitializeBristles(uint32_t count, float stiffness, float leng
         return;
     }
     
-    bristle_data_->positions.clear();
-    bristle_data_->velocities.clear();
-    bristle_data_->pressures.clear();
-    
-    bristle_data_->positions.reserve(count);
-    bristle_data_->velocities.reserve(count);
-    bristle_data_->pressures.reserve(count);
-    
-    // Arrange bristles in a circle
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> angle_dist(0.0f, 2.0f * M_PI);
-    std::uniform_real_distribution<float> radius_dist(0.0f, 1.0f);
-    
-    for (uint32_t i = 0; i < count; ++i) {
-        float angle = angle_dist(gen);
-        float radius = radius_dist(gen) * length;
-        
-        bristle_data_->positions.push_back({
-            radius * std::cos(angle),
-            radius * std::sin(angle),
-            0.0f
-        });
-        
-        bristle_data_->velocities.push_back({0.0f, 0.0f, 0.0f});
-        bristle_data_->pressures.push_back(1.0f);
-    }
-    
+    bristle_data_->reset(count, length);
     std::cout << "[BrushEngine] Initialized " << count << " bristles" << std::endl;
 }
 
@@ -625,6 +485,824 @@ void BrushEngine::ApplyBlendMode(BlendMode mode, const Core::Math::Vector3& base
     }
 }
 
+namespace {
+
+// Batches smaller than this stamp on the CPU even when accelerated; below it
+// the copy through the batch texture costs more than the dabs
+constexpr size_t MIN_GPU_BATCH_DABS = 256;
+
+// Flow rate of thin paint on the least absorbent paper, cells squared per second
+constexpr float MEDIUM_DIFFUSION = 8.0f;
+
+// Must match @workgroup_size of the dab shader
+constexpr uint32_t DAB_WORKGROUP_SIZE = 16;
+
+StrokePoint interpolatePoint(const StrokePoint& a, const StrokePoint& b, float t) {
+    auto lerp = [t](float from, float to) { return from + (to - from) * t; };
+    StrokePoint point = b;
+    point.position = {lerp(a.position[0], b.position[0]), lerp(a.position[1], b.position[1])};
+    point.pressure = lerp(a.pressure, b.pressure);
+    point.tilt = lerp(a.tilt, b.tilt);
+    point.velocity = lerp(a.velocity, b.velocity);
+    point.computedSize = lerp(a.computedSize, b.computedSize);
+    point.computedOpacity = lerp(a.computedOpacity, b.computedOpacity);
+    point.computedFlow = lerp(a.computedFlow, b.computedFlow);
+    return point;
+}
+
+// Pixels {x0, y0, x1, y1} a dab can touch, clamped to a width x height image
+template <typename Dab>
+std::array<uint32_t, 4> dabPixelBounds(const Dab& dab, uint32_t width, uint32_t height) {
+    auto clampTo = [](float value, uint32_t limit) {
+        return static_cast<uint32_t>(std::clamp(value, 0.0f, static_cast<float>(limit)));
+    };
+    return {clampTo(std::floor(dab.x - dab.radius), width), clampTo(std::floor(dab.y - dab.radius), height),
+            clampTo(std::ceil(dab.x + dab.radius), width), clampTo(std::ceil(dab.y + dab.radius), height)};
+}
+
+// Dab indices per square bin of a region, row-major; bin b holds
+// indices[offsets[b], offsets[b + 1]) in batch order
+struct BinnedDabs {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> indices;
+};
+
+template <typename Dab>
+BinnedDabs binDabs(const std::vector<Dab>& dabs, const std::array<uint32_t, 2>& origin,
+                   const std::array<uint32_t, 2>& size, uint32_t binSize) {
+    const uint32_t binsX = (size[0] + binSize - 1) / binSize;
+    const uint32_t binsY = (size[1] + binSize - 1) / binSize;
+    
+    // Binned rectangle of every dab, or an empty one when it misses the region
+    std::vector<std::array<uint32_t, 4>> spans(dabs.size());
+    BinnedDabs bins;
+    bins.offsets.assign(static_cast<size_t>(binsX) * binsY + 1, 0);
+    for (size_t i = 0; i < dabs.size(); ++i) {
+        Dab local = dabs[i];
+        local.x -= static_cast<float>(origin[0]);
+        local.y -= static_cast<float>(origin[1]);
+        auto bounds = dabPixelBounds(local, size[0], size[1]);
+        if (bounds[0] >= bounds[2] || bounds[1] >= bounds[3]) {
+            spans[i] = {0, 0, 0, 0};
+            continue;
+        }
+        spans[i] = {bounds[0] / binSize, bounds[1] / binSize, (bounds[2] - 1) / binSize + 1, (bounds[3] - 1) / binSize + 1};
+        for (uint32_t by = spans[i][1]; by < spans[i][3]; ++by) {
+            for (uint32_t bx = spans[i][0]; bx < spans[i][2]; ++bx) {
+                bins.offsets[by * binsX + bx + 1]++;
+            }
+        }
+    }
+    
+    for (size_t b = 1; b < bins.offsets.size(); ++b) {
+        bins.offsets[b] += bins.offsets[b - 1];
+    }
+    
+    // Filling in batch order keeps every bin sorted
+    bins.indices.resize(bins.offsets.back());
+    std::vector<uint32_t> cursor(bins.offsets.begin(), bins.offsets.end() - 1);
+    for (size_t i = 0; i < dabs.size(); ++i) {
+        for (uint32_t by = spans[i][1]; by < spans[i][3]; ++by) {
+            for (uint32_t bx = spans[i][0]; bx < spans[i][2]; ++bx) {
+                bins.indices[cursor[by * binsX + bx]++] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+    return bins;
+}
+
+} // namespace
+
+// CPU dab rasterization into tiled images
+void BrushEngine::applyStroke(Image& targetImage, const BrushStroke& stroke) {
+    for (const auto& point : stroke.points) {
+        renderDab(targetImage, point, stroke.settings);
+    }
+    
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats_.strokesRendered++;
+}
+
+void BrushEngine::applyDab(Image& targetImage, const StrokePoint& point, 
+                           const BrushSettings& settings) {
+    renderDab(targetImage, point, settings);
+}
+
+float BrushEngine::calculateSpacing(const BrushSettings& settings, const StrokePoint& point) const {
+    float size = point.computedSize > 0.0f ? point.computedSize : settings.size;
+    return std::max(1.0f, settings.spacing * size);
+}
+
+template <typename Fn>
+float BrushEngine::walkDabs(const StrokePoint& from, const StrokePoint& to, float distanceToNext,
+                            const BrushSettings& settings, Fn&& fn) const {
+    float dx = to.position[0] - from.position[0];
+    float dy = to.position[1] - from.position[1];
+    float length = std::sqrt(dx * dx + dy * dy);
+    
+    float travelled = distanceToNext;
+    while (travelled <= length) {
+        StrokePoint dab = interpolatePoint(from, to, length > 0.0f ? travelled / length : 1.0f);
+        fn(dab);
+        travelled += calculateSpacing(settings, dab);
+    }
+    return travelled - length;
+}
+
+void BrushEngine::beginStroke(const BrushSettings& settings) {
+    currentStrokeSettings_ = settings;
+    recentStrokePointCount_ = 0;
+    distanceToNextDab_ = 0.0f;
+    predictedPoints_.clear();
+    strokeActive_ = true;
+}
+
+void BrushEngine::addStrokePoint(Image& targetImage, const StrokePoint& point) {
+    if (!strokeActive_ || targetImage.empty()) {
+        return;
+    }
+    
+    const BrushSettings& settings = currentStrokeSettings_;
+    if (recentStrokePointCount_ == 0) {
+        renderDab(targetImage, point, settings);
+        lastDabPosition_ = point.position;
+        distanceToNextDab_ = calculateSpacing(settings, point);
+    } else {
+        distanceToNextDab_ = walkDabs(recentStrokePoints_[recentStrokePointCount_ - 1], point,
+                                      distanceToNextDab_, settings, [&](const StrokePoint& dab) {
+            renderDab(targetImage, dab, settings);
+            lastDabPosition_ = dab.position;
+        });
+    }
+    
+    if (recentStrokePointCount_ == STROKE_HISTORY) {
+        std::move(recentStrokePoints_.begin() + 1, recentStrokePoints_.end(), recentStrokePoints_.begin());
+        --recentStrokePointCount_;
+    }
+    recentStrokePoints_[recentStrokePointCount_++] = point;
+    
+    updatePrediction(targetImage);
+}
+
+void BrushEngine::endStroke() {
+    if (!strokeActive_) {
+        return;
+    }
+    
+    strokeActive_ = false;
+    recentStrokePointCount_ = 0;
+    predictedPoints_.clear();
+    predictionOverlay_ = Image();
+    
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats_.strokesRendered++;
+}
+
+std::vector<StrokePoint> BrushEngine::predictStrokeTail() const {
+    const auto& points = recentStrokePoints_;
+    const size_t n = recentStrokePointCount_;
+    if (!config_.enableStrokePrediction || n < 2 || config_.predictionHorizonMs <= 0.0f) {
+        return {};
+    }
+    
+    auto elapsedMs = [](const StrokePoint& a, const StrokePoint& b) {
+        return std::chrono::duration<float, std::milli>(b.timestamp - a.timestamp).count();
+    };
+    
+    // Velocity from the last segment, acceleration from the two before it
+    const StrokePoint& last = points[n - 1];
+    const StrokePoint& previous = points[n - 2];
+    float dt = elapsedMs(previous, last);
+    if (dt <= 0.0f) {
+        return {};
+    }
+    std::array<float, 2> velocity{(last.position[0] - previous.position[0]) / dt,
+                                  (last.position[1] - previous.position[1]) / dt};
+    std::array<float, 2> acceleration{0.0f, 0.0f};
+    if (n >= 3) {
+        float dtBefore = elapsedMs(points[n - 3], previous);
+        if (dtBefore > 0.0f) {
+            for (int i = 0; i < 2; ++i) {
+                float velocityBefore = (previous.position[i] - points[n - 3].position[i]) / dtBefore;
+                acceleration[i] = (velocity[i] - velocityBefore) / (0.5f * (dt + dtBefore));
+            }
+        }
+    }
+    
+    // A braking stroke stops, it does not turn back within the horizon
+    const float horizon = config_.predictionHorizonMs;
+    float endVelocityAlong = (velocity[0] + acceleration[0] * horizon) * velocity[0] +
+                             (velocity[1] + acceleration[1] * horizon) * velocity[1];
+    if (endVelocityAlong < 0.0f) {
+        acceleration = {0.0f, 0.0f};
+    }
+    
+    auto displacement = [&](float t, int i) {
+        return velocity[i] * t + 0.5f * acceleration[i] * t * t;
+    };
+    float reachX = displacement(horizon, 0);
+    float reachY = displacement(horizon, 1);
+    float reach = std::sqrt(reachX * reachX + reachY * reachY);
+    if (reach < 0.5f) {
+        return {};
+    }
+    float scale = std::min(1.0f, config_.maxPredictionDistance / reach);
+    
+    // Size and opacity follow the pressure trend, within reason
+    auto extrapolate = [&](float a, float b, float t) {
+        if (b <= 0.0f) {
+            return b;
+        }
+        return std::max(0.25f * b, b + (b - a) / dt * t);
+    };
+    
+    constexpr int PREDICTION_SAMPLES = 4;
+    std::vector<StrokePoint> tail;
+    tail.reserve(PREDICTION_SAMPLES);
+    for (int k = 1; k <= PREDICTION_SAMPLES; ++k) {
+        float t = horizon * k / PREDICTION_SAMPLES;
+        StrokePoint point = last;
+        point.position = {last.position[0] + displacement(t, 0) * scale,
+                          last.position[1] + displacement(t, 1) * scale};
+        point.pressure = std::clamp(last.pressure + (last.pressure - previous.pressure) / dt * t, 0.0f, 1.0f);
+        point.computedSize = extrapolate(previous.computedSize, last.computedSize, t);
+        point.computedOpacity = std::min(1.0f, extrapolate(previous.computedOpacity, last.computedOpacity, t));
+        point.timestamp = last.timestamp + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::duration<float, std::milli>(t));
+        tail.push_back(point);
+    }
+    return tail;
+}
+
+void BrushEngine::updatePrediction(const Image& targetImage) {
+    // The previous guess is dropped whether or not it was right
+    if (predictionOverlay_.getSize() != targetImage.getSize()) {
+        predictionOverlay_.reset(targetImage.width(), targetImage.height());
+    } else if (predictionOverlay_.allocatedTileCount() > 0) {
+        predictionOverlay_.clear({0.0f, 0.0f, 0.0f, 0.0f});
+    }
+    
+    // An erased tail cannot be shown as a layer over the canvas
+    const BrushSettings& settings = currentStrokeSettings_;
+    predictedPoints_.clear();
+    if (settings.blendMode == BrushBlendMode::Clear) {
+        return;
+    }
+    predictedPoints_ = predictStrokeTail();
+    
+    // Continue the committed dab spacing so the tail lines up with the dabs
+    // that will replace it
+    float distanceToNext = distanceToNextDab_;
+    const StrokePoint* from = &recentStrokePoints_[recentStrokePointCount_ - 1];
+    for (const auto& point : predictedPoints_) {
+        distanceToNext = walkDabs(*from, point, distanceToNext, settings, [&](const StrokePoint& dab) {
+            stampDabTiles(predictionOverlay_, makeDabInstance(dab, settings));
+        });
+        from = &point;
+    }
+}
+
+void BrushEngine::setMediumProperties(float viscosity, float absorption, float drying) {
+    mediumViscosity_ = viscosity;
+    mediumAbsorption_ = std::clamp(absorption, 0.0f, 1.0f);
+    mediumDrying_ = drying;
+    
+    if (fluidSimulator_) {
+        // Paper that soaks up more water lets less of it flow
+        fluidSimulator_->setViscosity(mediumViscosity_);
+        fluidSimulator_->setDiffusion(MEDIUM_DIFFUSION * (1.0f - mediumAbsorption_));
+        fluidSimulator_->setEvaporation(mediumDrying_);
+    }
+}
+
+void BrushEngine::simulateMedium(Image& image, float deltaTime) {
+    PaintMedium* medium = wetMedium(image);
+    if (!medium) {
+        return;
+    }
+    
+    fluidSimulator_->step(deltaTime);
+    medium->releaseDryTiles(image);
+}
+
+PaintMedium* BrushEngine::wetMedium(const Image& targetImage) {
+    if (!mediumSimulation_ || targetImage.empty()) {
+        return nullptr;
+    }
+    
+    if (!fluidSimulator_) {
+        fluidSimulator_ = std::make_unique<FluidSimulator>(engine_);
+        setMediumProperties(mediumViscosity_, mediumAbsorption_, mediumDrying_);
+    }
+    
+    // A canvas of another size starts a fresh medium
+    if (!fluidSimulator_->isInitialized() || fluidSimulator_->getGridSize() != targetImage.getSize()) {
+        fluidSimulator_->initialize(targetImage.getSize());
+    }
+    return &fluidSimulator_->medium();
+}
+
+void BrushEngine::renderDab(Image& targetImage, const StrokePoint& point, 
+                            const BrushSettings& settings) {
+    // Wet dabs go into the medium and reach the canvas when they dry
+    if (settings.blendMode != BrushBlendMode::Clear) {
+        if (PaintMedium* medium = wetMedium(targetImage)) {
+            DabInstance dab = makeDabInstance(point, settings);
+            medium->deposit(dab.x, dab.y, dab.radius, dab.color,
+                            point.computedFlow > 0.0f ? point.computedFlow : settings.flow);
+            
+            std::lock_guard<std::mutex> lock(statsMutex_);
+            stats_.dabsRendered++;
+            return;
+        }
+    }
+    
+    uint64_t pixels = stampDabTiles(targetImage, makeDabInstance(point, settings));
+    
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats_.dabsRendered++;
+    stats_.pixelsProcessed += pixels;
+}
+
+uint64_t BrushEngine::stampDabTiles(Image& targetImage, const DabInstance& dab) {
+    auto bounds = dabPixelBounds(dab, targetImage.width(), targetImage.height());
+    if (dab.radius <= 0.0f || bounds[0] >= bounds[2] || bounds[1] >= bounds[3]) {
+        return 0;
+    }
+    
+    // Only tiles under the dab's bounding box are allocated or unshared, so
+    // a stroke costs memory for the area it covers and leaves the rest of
+    // the canvas shared with any undo snapshot
+    uint64_t pixels = 0;
+    for (uint32_t ty = bounds[1] / Image::TILE_SIZE; ty <= (bounds[3] - 1) / Image::TILE_SIZE; ++ty) {
+        for (uint32_t tx = bounds[0] / Image::TILE_SIZE; tx <= (bounds[2] - 1) / Image::TILE_SIZE; ++tx) {
+            pixels += stampDab(targetImage, dab, tx, ty);
+        }
+    }
+    return pixels;
+}
+
+BrushEngine::DabInstance BrushEngine::makeDabInstance(const StrokePoint& point,
+                                                      const BrushSettings& settings) const {
+    float size = point.computedSize > 0.0f ? point.computedSize : settings.size;
+    float opacity = point.computedOpacity > 0.0f ? point.computedOpacity : settings.opacity;
+    float flow = point.computedFlow > 0.0f ? point.computedFlow : settings.flow;
+    const auto& color = settings.color;
+    
+    DabInstance dab;
+    dab.color = {color[0], color[1], color[2], std::clamp(opacity * flow * color[3], 0.0f, 1.0f)};
+    dab.x = point.position[0];
+    dab.y = point.position[1];
+    dab.radius = size * 0.5f;
+    dab.hardness = std::clamp(settings.hardness, 0.0f, 1.0f);
+    dab.erase = settings.blendMode == BrushBlendMode::Clear ? 1 : 0;
+    return dab;
+}
+
+uint64_t BrushEngine::stampDab(Image& targetImage, const DabInstance& dab, uint32_t tileX, uint32_t tileY) {
+    auto bounds = dabPixelBounds(dab, targetImage.width(), targetImage.height());
+    uint32_t originX = tileX * Image::TILE_SIZE;
+    uint32_t originY = tileY * Image::TILE_SIZE;
+    uint32_t x0 = std::max(bounds[0], originX);
+    uint32_t y0 = std::max(bounds[1], originY);
+    uint32_t x1 = std::min(bounds[2], originX + Image::TILE_SIZE);
+    uint32_t y1 = std::min(bounds[3], originY + Image::TILE_SIZE);
+    if (x0 >= x1 || y0 >= y1) {
+        return 0;
+    }
+    
+    float* tile = targetImage.mutableTileData(tileX, tileY);
+    uint64_t pixels = 0;
+    for (uint32_t y = y0; y < y1; ++y) {
+        for (uint32_t x = x0; x < x1; ++x) {
+            float dx = x + 0.5f - dab.x;
+            float dy = y + 0.5f - dab.y;
+            float distance = std::sqrt(dx * dx + dy * dy) / dab.radius;
+            if (distance >= 1.0f) {
+                continue;
+            }
+            
+            // Solid core out to the hardness radius, linear falloff beyond it
+            float coverage = distance <= dab.hardness ? 1.0f : (1.0f - distance) / (1.0f - dab.hardness);
+            float alpha = coverage * dab.color[3];
+            
+            float* dst = tile + (y - originY) * Image::TILE_STRIDE + (x - originX) * Image::CHANNELS;
+            if (dab.erase) {
+                dst[3] *= 1.0f - alpha;
+            } else {
+                for (int c = 0; c < 3; ++c) {
+                    dst[c] = dab.color[c] * alpha + dst[c] * (1.0f - alpha);
+                }
+                dst[3] = alpha + dst[3] * (1.0f - alpha);
+            }
+            ++pixels;
+        }
+    }
+    return pixels;
+}
+
+// Batched dab stamping
+void BrushEngine::beginBatch() {
+    batchState_.active = true;
+    batchState_.dabs.clear();
+    batchState_.flows.clear();
+    batchState_.strokeCount = 0;
+}
+
+void BrushEngine::addStrokeToBatch(const BrushStroke& stroke) {
+    if (!batchState_.active) {
+        return;
+    }
+    
+    batchState_.dabs.reserve(batchState_.dabs.size() + stroke.points.size());
+    batchState_.flows.reserve(batchState_.dabs.size() + stroke.points.size());
+    for (const auto& point : stroke.points) {
+        DabInstance dab = makeDabInstance(point, stroke.settings);
+        if (dab.radius > 0.0f) {
+            batchState_.dabs.push_back(dab);
+            batchState_.flows.push_back(point.computedFlow > 0.0f ? point.computedFlow : stroke.settings.flow);
+        }
+    }
+    batchState_.strokeCount++;
+}
+
+void BrushEngine::renderBatch(Image& targetImage) {
+    auto& dabs = batchState_.dabs;
+    if (!batchState_.active || dabs.empty() || targetImage.empty()) {
+        dabs.clear();
+        batchState_.flows.clear();
+        return;
+    }
+    const size_t dabCount = dabs.size();
+    
+    // Wet dabs go into the medium as renderDab() sends them, and only the
+    // erasing ones are left to stamp. The medium keeps no order with the
+    // canvas until it dries, so splitting them off changes no pixel.
+    bool wet = std::any_of(dabs.begin(), dabs.end(), [](const DabInstance& dab) { return !dab.erase; });
+    if (PaintMedium* medium = wet ? wetMedium(targetImage) : nullptr) {
+        size_t kept = 0;
+        for (size_t i = 0; i < dabs.size(); ++i) {
+            if (dabs[i].erase) {
+                dabs[kept++] = dabs[i];
+            } else {
+                medium->deposit(dabs[i].x, dabs[i].y, dabs[i].radius, dabs[i].color, batchState_.flows[i]);
+            }
+        }
+        dabs.resize(kept);
+    }
+    
+    // Small batches do not pay for the round trip through the batch texture
+    if (!dabs.empty()) {
+        bool rendered = config_.enableGPUAcceleration && dabs.size() >= MIN_GPU_BATCH_DABS &&
+                        renderBatchOnGPU(targetImage);
+        if (!rendered) {
+            renderBatchOnCPU(targetImage);
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats_.dabsRendered += static_cast<uint32_t>(dabCount);
+    stats_.strokesRendered += batchState_.strokeCount;
+    dabs.clear();
+    batchState_.flows.clear();
+    batchState_.strokeCount = 0;
+}
+
+void BrushEngine::renderBatch(Rendering::ResourceId targetTexture, const std::array<uint32_t, 2>& size) {
+    if (!batchState_.active || batchState_.dabs.empty() || targetTexture == 0) {
+        batchState_.dabs.clear();
+        batchState_.flows.clear();
+        return;
+    }
+    
+    if (dispatchDabs(targetTexture, {0, 0}, size)) {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.dabsRendered += static_cast<uint32_t>(batchState_.dabs.size());
+        stats_.strokesRendered += batchState_.strokeCount;
+    } else {
+        std::cerr << "[BrushEngine] Failed to stamp batch of " << batchState_.dabs.size() << " dabs" << std::endl;
+    }
+    batchState_.dabs.clear();
+    batchState_.flows.clear();
+    batchState_.strokeCount = 0;
+}
+
+void BrushEngine::endBatch() {
+    batchState_.active = false;
+    batchState_.dabs.clear();
+    batchState_.flows.clear();
+    batchState_.strokeCount = 0;
+    releaseBatchResources();
+}
+
+void BrushEngine::renderBatchOnCPU(Image& targetImage) {
+    // Dabs never cross into each other's tiles, so tiles stamp in parallel,
+    // each running through its dabs in batch order
+    BinnedDabs bins = binDabs(batchState_.dabs, {0, 0}, targetImage.getSize(), Image::TILE_SIZE);
+    const uint32_t binsX = (targetImage.width() + Image::TILE_SIZE - 1) / Image::TILE_SIZE;
+    
+    std::vector<uint32_t> occupied;
+    for (uint32_t bin = 0; bin + 1 < bins.offsets.size(); ++bin) {
+        if (bins.offsets[bin] != bins.offsets[bin + 1]) {
+            occupied.push_back(bin);
+        }
+    }
+    
+    std::atomic<uint64_t> pixels{0};
+    Core::parallel_for(0, occupied.size(), 1, [&](size_t i) {
+        uint32_t bin = occupied[i];
+        uint64_t tilePixels = 0;
+        for (uint32_t k = bins.offsets[bin]; k < bins.offsets[bin + 1]; ++k) {
+            tilePixels += stampDab(targetImage, batchState_.dabs[bins.indices[k]], bin % binsX, bin / binsX);
+        }
+        pixels.fetch_add(tilePixels, std::memory_order_relaxed);
+    });
+    
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats_.pixelsProcessed += pixels.load();
+}
+
+bool BrushEngine::renderBatchOnGPU(Image& targetImage) {
+    if (!engine_.is_initialized() || getDabPipeline() == 0) {
+        return false;
+    }
+    
+    // Stamp the region the batch covers, snapped to tiles so that it is
+    // copied in and out a tile row at a time
+    std::array<uint32_t, 4> region{targetImage.width(), targetImage.height(), 0, 0};
+    for (const auto& dab : batchState_.dabs) {
+        auto bounds = dabPixelBounds(dab, targetImage.width(), targetImage.height());
+        if (bounds[0] < bounds[2] && bounds[1] < bounds[3]) {
+            region = {std::min(region[0], bounds[0]), std::min(region[1], bounds[1]),
+                      std::max(region[2], bounds[2]), std::max(region[3], bounds[3])};
+        }
+    }
+    if (region[0] >= region[2] || region[1] >= region[3]) {
+        return true;
+    }
+    region[0] -= region[0] % Image::TILE_SIZE;
+    region[1] -= region[1] % Image::TILE_SIZE;
+    const std::array<uint32_t, 2> regionSize{region[2] - region[0], region[3] - region[1]};
+    if (regionSize[0] > batchState_.batchSize[0] || regionSize[1] > batchState_.batchSize[1]) {
+        return false;
+    }
+    
+    auto& textureSize = batchState_.batchTextureSize;
+    if (batchState_.batchTextureId == 0 || textureSize[0] < regionSize[0] || textureSize[1] < regionSize[1]) {
+        if (batchState_.batchTextureId != 0) {
+            engine_.destroy_resource(batchState_.batchTextureId);
+        }
+        
+        using Usage = Rendering::TextureDescriptor::Usage;
+        Rendering::TextureDescriptor desc;
+        desc.width = std::max(textureSize[0], regionSize[0]);
+        desc.height = std::max(textureSize[1], regionSize[1]);
+        desc.format = Rendering::TextureDescriptor::Format::RGBA32Float;
+        desc.usage = static_cast<uint32_t>(Usage::StorageBinding) |
+                     static_cast<uint32_t>(Usage::CopySrc) | static_cast<uint32_t>(Usage::CopyDst);
+        batchState_.batchTextureId = engine_.create_texture(desc);
+        textureSize = {desc.width, desc.height};
+        if (batchState_.batchTextureId == 0) {
+            textureSize = {0, 0};
+            return false;
+        }
+    }
+    
+    // Only tiles under a dab make the trip; the rest of the region is
+    // never read back, so it can hold anything
+    const uint32_t tileX0 = region[0] / Image::TILE_SIZE;
+    const uint32_t tileY0 = region[1] / Image::TILE_SIZE;
+    BinnedDabs tiles = binDabs(batchState_.dabs, {region[0], region[1]}, regionSize, Image::TILE_SIZE);
+    const uint32_t binsX = (regionSize[0] + Image::TILE_SIZE - 1) / Image::TILE_SIZE;
+    
+    const size_t rowFloats = static_cast<size_t>(textureSize[0]) * Image::CHANNELS;
+    std::vector<float> texels(rowFloats * textureSize[1]);
+    auto forEachTouchedTile = [&](auto&& fn) {
+        for (uint32_t bin = 0; bin + 1 < tiles.offsets.size(); ++bin) {
+            if (tiles.offsets[bin] != tiles.offsets[bin + 1]) {
+                fn(tileX0 + bin % binsX, tileY0 + bin / binsX);
+            }
+        }
+    };
+    
+    forEachTouchedTile([&](uint32_t tx, uint32_t ty) {
+        const float* tile = targetImage.tileData(tx, ty);
+        const auto& fill = targetImage.fillColor();
+        uint32_t x = tx * Image::TILE_SIZE - region[0];
+        uint32_t width = std::min(Image::TILE_SIZE, region[2] - tx * Image::TILE_SIZE);
+        for (uint32_t row = 0; row < Image::TILE_SIZE; ++row) {
+            uint32_t y = ty * Image::TILE_SIZE + row;
+            if (y >= region[3]) {
+                break;
+            }
+            float* dst = texels.data() + (y - region[1]) * rowFloats + static_cast<size_t>(x) * Image::CHANNELS;
+            if (tile) {
+                std::copy_n(tile + row * Image::TILE_STRIDE, width * Image::CHANNELS, dst);
+            } else {
+                for (uint32_t i = 0; i < width; ++i) {
+                    std::copy(fill.begin(), fill.end(), dst + i * Image::CHANNELS);
+                }
+            }
+        }
+    });
+    
+    engine_.write_texture(batchState_.batchTextureId, texels.data());
+    if (!dispatchDabs(batchState_.batchTextureId, {region[0], region[1]}, regionSize)) {
+        return false;
+    }
+    // read_texture() only waits for submitted work
+    engine_.flush();
+    if (!engine_.read_texture(batchState_.batchTextureId, texels.data())) {
+        return false;
+    }
+    
+    uint64_t pixels = 0;
+    forEachTouchedTile([&](uint32_t tx, uint32_t ty) {
+        float* tile = targetImage.mutableTileData(tx, ty);
+        uint32_t x = tx * Image::TILE_SIZE - region[0];
+        uint32_t width = std::min(Image::TILE_SIZE, region[2] - tx * Image::TILE_SIZE);
+        for (uint32_t row = 0; row < Image::TILE_SIZE; ++row) {
+            uint32_t y = ty * Image::TILE_SIZE + row;
+            if (y >= region[3]) {
+                break;
+            }
+            const float* src = texels.data() + (y - region[1]) * rowFloats + static_cast<size_t>(x) * Image::CHANNELS;
+            std::copy_n(src, width * Image::CHANNELS, tile + row * Image::TILE_STRIDE);
+            pixels += width;
+        }
+    });
+    
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats_.pixelsProcessed += pixels;
+    return true;
+}
+
+bool BrushEngine::dispatchDabs(Rendering::ResourceId targetTexture, const std::array<uint32_t, 2>& origin,
+                               const std::array<uint32_t, 2>& size) {
+    Rendering::PipelineId pipeline = getDabPipeline();
+    if (pipeline == 0 || size[0] == 0 || size[1] == 0) {
+        return false;
+    }
+    
+    // Each workgroup walks the dabs binned to its square in batch order
+    BinnedDabs bins = binDabs(batchState_.dabs, origin, size, DAB_WORKGROUP_SIZE);
+    std::vector<uint32_t> binData;
+    binData.reserve(bins.offsets.size() + bins.indices.size());
+    binData.insert(binData.end(), bins.offsets.begin(), bins.offsets.end());
+    binData.insert(binData.end(), bins.indices.begin(), bins.indices.end());
+    
+    struct DabBatchUniforms {
+        std::array<float, 2> origin;
+        std::array<uint32_t, 2> size;
+        uint32_t binsX;
+        uint32_t binCount;
+        uint32_t padding[2];
+    };
+    DabBatchUniforms uniforms{};
+    uniforms.origin = {static_cast<float>(origin[0]), static_cast<float>(origin[1])};
+    uniforms.size = size;
+    uniforms.binsX = (size[0] + DAB_WORKGROUP_SIZE - 1) / DAB_WORKGROUP_SIZE;
+    uniforms.binCount = static_cast<uint32_t>(bins.offsets.size() - 1);
+    
+    // Each batch gets its own ring space, so batches recorded this frame
+    // never overwrite each other's inputs. The ring grows after a frame that
+    // runs out; until then the caller stamps on the CPU.
+    auto uniformUpload = engine_.upload(&uniforms, sizeof(uniforms));
+    auto dabUpload = engine_.upload(batchState_.dabs.data(), batchState_.dabs.size() * sizeof(DabInstance));
+    auto binUpload = engine_.upload(binData.data(), binData.size() * sizeof(uint32_t));
+    if (!uniformUpload.is_valid() || !dabUpload.is_valid() || !binUpload.is_valid()) {
+        return false;
+    }
+    
+    Rendering::ComputeDispatch dispatch;
+    dispatch.pipelineId = pipeline;
+    dispatch.workgroupsX = uniforms.binsX;
+    dispatch.workgroupsY = (size[1] + DAB_WORKGROUP_SIZE - 1) / DAB_WORKGROUP_SIZE;
+    dispatch.buffers = {uniformUpload.buffer, dabUpload.buffer, binUpload.buffer};
+    dispatch.bufferOffsets = {static_cast<uint32_t>(uniformUpload.offset), static_cast<uint32_t>(dabUpload.offset),
+                              static_cast<uint32_t>(binUpload.offset)};
+    dispatch.textures = {targetTexture};
+    engine_.submit_compute(dispatch);
+    return true;
+}
+
+Rendering::PipelineId BrushEngine::getDabPipeline() {
+    if (brushPipelineId_ != 0) {
+        return brushPipelineId_;
+    }
+    
+    // One invocation per pixel, folding in the pixel's dabs in order; the
+    // compositing matches stampDab()
+    brushPipelineId_ = engine_.createPipeline(R"(
+struct Dab {
+    color: vec4<f32>,
+    center: vec2<f32>,
+    radius: f32,
+    hardness: f32,
+    erase: u32,
+    padding0: u32,
+    padding1: u32,
+    padding2: u32,
+};
+
+struct DabBatchUniforms {
+    origin: vec2<f32>,
+    size: vec2<u32>,
+    bins_x: u32,
+    bin_count: u32,
+    padding: vec2<u32>,
+};
+
+@group(0) @binding(0) var<uniform> batch: DabBatchUniforms;
+@group(0) @binding(1) var<storage, read> dabs: array<Dab>;
+@group(0) @binding(2) var<storage, read> bins: array<u32>;
+@group(0) @binding(3) var canvas: texture_storage_2d<rgba32float, read_write>;
+
+@compute @workgroup_size(16, 16)
+fn cs_main(@builtin(global_invocation_id) id: vec3<u32>,
+           @builtin(workgroup_id) group: vec3<u32>) {
+    if (id.x >= batch.size.x || id.y >= batch.size.y) {
+        return;
+    }
+    
+    let bin = group.y * batch.bins_x + group.x;
+    let p = batch.origin + vec2<f32>(id.xy) + vec2<f32>(0.5, 0.5);
+    var dst = textureLoad(canvas, vec2<i32>(id.xy));
+    
+    for (var i = bins[bin]; i < bins[bin + 1u]; i = i + 1u) {
+        let dab = dabs[bins[batch.bin_count + 1u + i]];
+        let distance = length(p - dab.center) / dab.radius;
+        if (distance >= 1.0) {
+            continue;
+        }
+        
+        var coverage = 1.0;
+        if (distance > dab.hardness) {
+            coverage = (1.0 - distance) / (1.0 - dab.hardness);
+        }
+        let alpha = coverage * dab.color.a;
+        
+        if (dab.erase != 0u) {
+            dst.a = dst.a * (1.0 - alpha);
+        } else {
+            dst = vec4<f32>(dab.color.rgb * alpha + dst.rgb * (1.0 - alpha), alpha + dst.a * (1.0 - alpha));
+        }
+    }
+    
+    textureStore(canvas, vec2<i32>(id.xy), dst);
+}
+)");
+    
+    if (brushPipelineId_ == 0) {
+        std::cerr << "[BrushEngine] Failed to create dab pipeline; batches stamp on the CPU" << std::endl;
+    }
+    return brushPipelineId_;
+}
+
+void BrushEngine::releaseBatchResources() {
+    if (batchState_.batchTextureId != 0) {
+        engine_.destroy_resource(batchState_.batchTextureId);
+        batchState_.batchTextureId = 0;
+    }
+    batchState_.batchTextureSize = {0, 0};
+}
+
+void BrushEngine::setTextureSource(TextureSource source) {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    textureSource_ = std::move(source);
+}
+
+Rendering::ResourceId BrushEngine::loadBrushTexture(const std::filesystem::path& path) {
+    TextureSource source;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        auto it = loadedTextures_.find(path.string());
+        if (it != loadedTextures_.end()) {
+            return *it->second;
+        }
+        source = textureSource_;
+    }
+    if (!source) {
+        std::cerr << "[BrushEngine] No texture source for " << path << std::endl;
+        return 0;
+    }
+    
+    TextureHandle texture;
+    try {
+        texture = source(path);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "[BrushEngine] Failed to load brush texture " << path << ": " << e.what() << std::endl;
+        return 0;
+    }
+    if (!texture) {
+        return 0;
+    }
+    
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    return *loadedTextures_.emplace(path.string(), std::move(texture)).first->second;
+}
+
 // BrushUtils implementation
 namespace BrushUtils {
     float SmoothStep(float edge0, float edge1, float x) {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "raster_image.hpp"
+#include "paint_medium.hpp"
 #include "../../core/rendering/rendering_engine.hpp"
 #include <array>
 #include <vector>
@@ -10,7 +12,6 @@
 namespace QuantumCanvas::Raster {
 
 // Forward declarations
-class Image;
 class BrushStroke;
 class FluidSimulator;
 
@@ -37,6 +38,11 @@ struct BrushEngineConfig {
     float fluidViscosity = 0.5f;
     float fluidDensity = 1.0f;
     uint32_t fluidSteps = 8;
+    
+    // Stroke prediction settings
+    bool enableStrokePrediction = true;
+    float predictionHorizonMs = 16.0f;     // How far ahead of the stylus to draw
+    float maxPredictionDistance = 48.0f;   // Pixels; caps overshoot on sudden stops
 };
 
 // Brush tip shapes
@@ -227,17 +233,40 @@ public:
     void applyDab(Image& targetImage, const StrokePoint& point, 
                   const BrushSettings& settings);
     
-    // Real-time stroke rendering
+    // Real-time stroke rendering. addStrokePoint() commits dabs up to the
+    // new point into the target at the brush spacing, then extrapolates the
+    // stroke predictionHorizonMs ahead from the position and pressure history
+    // and draws that tail into the prediction overlay, replacing the previous
+    // one. Display the overlay over the canvas until the next point; only
+    // confirmed dabs ever reach the target, so a wrong guess costs nothing.
     void beginStroke(const BrushSettings& settings);
     void addStrokePoint(Image& targetImage, const StrokePoint& point);
     void endStroke();
     bool isStrokeActive() const { return strokeActive_; }
     
-    // Batch rendering for performance
+    // Transparent except for the predicted tail, which is composited Normal
+    // over transparent black; empty between strokes and for erasing brushes
+    const Image& getPredictionOverlay() const { return predictionOverlay_; }
+    const std::vector<StrokePoint>& getPredictedPoints() const { return predictedPoints_; }
+    
+    // Batch rendering for performance. Strokes added to a batch are expanded
+    // into dabs up front and renderBatch() stamps all of them in one pass:
+    // a single compute dispatch when accelerated, otherwise tiles in
+    // parallel. Each pixel sees the dabs covering it in the order they were
+    // added, so every blend mode composites as applyStroke() would, and with
+    // medium simulation on wet dabs are deposited into the medium as it
+    // does. Rendering empties the batch; call it once per frame while a
+    // batch is open.
     void beginBatch();
     void addStrokeToBatch(const BrushStroke& stroke);
     void renderBatch(Image& targetImage);
+    // For canvases kept on the device as RGBA32Float storage textures. The
+    // medium simulation lives beside an Image, so these dabs all stamp
+    // directly, wet or not.
+    void renderBatch(Rendering::ResourceId targetTexture, const std::array<uint32_t, 2>& size);
     void endBatch();
+    bool isBatchActive() const { return batchState_.active; }
+    size_t getBatchDabCount() const { return batchState_.dabs.size(); }
     
     // Brush preview generation
     Image generateBrushPreview(const BrushSettings& settings, 
@@ -248,7 +277,14 @@ public:
     void setMediumProperties(float viscosity, float absorption, float drying);
     void simulateMedium(Image& image, float deltaTime);
     
-    // Texture management
+    // Texture management. Brush textures come from the texture source, which
+    // the application points at the IO module's shared asset cache so brushes,
+    // pattern fills and placed images share decodes and uploads; the engine
+    // holds each handle it is given for its lifetime. 0 without a source or
+    // on failure.
+    using TextureHandle = std::shared_ptr<const Rendering::ResourceId>;
+    using TextureSource = std::function<TextureHandle(const std::filesystem::path& path)>;
+    void setTextureSource(TextureSource source);
     Rendering::ResourceId loadBrushTexture(const std::filesystem::path& path);
     void createProceduralTexture(const std::string& name, 
                                 std::function<float(float, float)> generator,
@@ -300,17 +336,48 @@ private:
     mutable std::mutex cacheMutex_;
     std::unordered_map<uint64_t, BrushCacheEntry> brushCache_;
     
+    // Loaded brush textures, by path
+    TextureSource textureSource_;
+    std::unordered_map<std::string, TextureHandle> loadedTextures_;
+    
     // Current stroke state
     std::atomic<bool> strokeActive_{false};
     BrushSettings currentStrokeSettings_;
-    std::vector<StrokePoint> currentStrokePoints_;
+    // Only the newest points, oldest first: prediction reads no further
+    // back, and a long stroke would otherwise grow this for its whole length
+    static constexpr size_t STROKE_HISTORY = 3;
+    std::array<StrokePoint, STROKE_HISTORY> recentStrokePoints_{};
+    size_t recentStrokePointCount_ = 0;
     std::array<float, 2> lastDabPosition_{0.0f, 0.0f};
+    float distanceToNextDab_ = 0.0f;
+    
+    // Predicted tail of the current stroke, redrawn on every point
+    Image predictionOverlay_;
+    std::vector<StrokePoint> predictedPoints_;
+    
+    // One dab as the stamping pass sees it; the layout matches the Dab
+    // struct of the dab shader (48 bytes, 16-byte aligned)
+    struct DabInstance {
+        std::array<float, 4> color;   // RGB and the dab's strength
+        float x = 0.0f;
+        float y = 0.0f;
+        float radius = 0.0f;
+        float hardness = 0.0f;
+        uint32_t erase = 0;
+        uint32_t padding[3] = {0, 0, 0};
+    };
     
     // Batch rendering state
     struct BatchState {
         bool active = false;
-        std::vector<BrushStroke> strokes;
+        std::vector<DabInstance> dabs;
+        std::vector<float> flows;  // Per dab, the water a wet dab deposits
+        uint32_t strokeCount = 0;
+        
+        // Image batches whose dabs fit in batchSize are stamped through this
+        // texture, which grows to the largest region seen
         Rendering::ResourceId batchTextureId = 0;
+        std::array<uint32_t, 2> batchTextureSize{0, 0};
         std::array<uint32_t, 2> batchSize{2048, 2048};
     };
     BatchState batchState_;
@@ -337,6 +404,16 @@ private:
     void renderGPUDab(const StrokePoint& point, const BrushSettings& settings,
                      Rendering::ResourceId targetTexture);
     
+    DabInstance makeDabInstance(const StrokePoint& point, const BrushSettings& settings) const;
+    uint64_t stampDabTiles(Image& targetImage, const DabInstance& dab);
+    uint64_t stampDab(Image& targetImage, const DabInstance& dab, uint32_t tileX, uint32_t tileY);
+    void renderBatchOnCPU(Image& targetImage);
+    bool renderBatchOnGPU(Image& targetImage);
+    bool dispatchDabs(Rendering::ResourceId targetTexture, const std::array<uint32_t, 2>& origin,
+                      const std::array<uint32_t, 2>& size);
+    Rendering::PipelineId getDabPipeline();
+    void releaseBatchResources();
+    
     Rendering::ResourceId getCachedBrushTexture(const BrushSettings& settings);
     Rendering::ResourceId generateBrushTexture(const BrushSettings& settings);
     
@@ -347,8 +424,17 @@ private:
     void updateDynamicsUniforms(const BrushDynamics& dynamics);
     
     float calculateSpacing(const BrushSettings& settings, const StrokePoint& point) const;
+    PaintMedium* wetMedium(const Image& targetImage);
     bool shouldPlaceDab(const StrokePoint& point, const BrushSettings& settings) const;
     
+    // Calls fn for each dab position on the segment from -> to, given the
+    // distance still to go to the next dab; returns that distance at the end
+    template <typename Fn>
+    float walkDabs(const StrokePoint& from, const StrokePoint& to, float distanceToNext,
+                   const BrushSettings& settings, Fn&& fn) const;
+    std::vector<StrokePoint> predictStrokeTail() const;
+    void updatePrediction(const Image& targetImage);
+    
     void cleanupBrushCache();
     uint64_t hashBrushSettings(const BrushSettings& settings) const;
     
@@ -366,7 +452,10 @@ private:
                        const BrushSettings& settings);
 };
 
-// Fluid simulation for realistic paint behavior
+// Fluid simulation for realistic paint behavior. Wet paint lives in a
+// PaintMedium on the CPU: only tiles around the painted area exist and
+// only wet ones are simulated, so a step costs what the brush has touched
+// rather than the whole grid.
 class FluidSimulator {
 public:
     explicit FluidSimulator(Rendering::RenderingEngine& engine);
@@ -374,22 +463,24 @@ public:
     
     bool initialize(const std::array<uint32_t, 2>& gridSize);
     void shutdown();
+    bool isInitialized() const { return initialized_; }
+    const std::array<uint32_t, 2>& getGridSize() const { return gridSize_; }
     
     // Simulation step
     void step(float deltaTime);
     
-    // Add paint to simulation
-    void addPaint(const std::array<float, 2>& position, 
-                 const std::array<float, 4>& color,
-                 float amount, float viscosity);
+    // Add paint to simulation; position and radius in grid cells
+    void addPaint(const std::array<float, 2>& position, float radius,
+                 const std::array<float, 4>& color, float amount);
     
-    // Get paint distribution for rendering
-    Rendering::ResourceId getPaintTexture() const { return paintTexture_; }
+    // Wet paint, one cell per canvas pixel
+    PaintMedium& medium() { return medium_; }
+    const PaintMedium& medium() const { return medium_; }
     
     // Configuration
-    void setViscosity(float viscosity) { viscosity_ = viscosity; }
-    void setDiffusion(float diffusion) { diffusion_ = diffusion; }
-    void setEvaporation(float evaporation) { evaporation_ = evaporation; }
+    void setViscosity(float viscosity) { viscosity_ = viscosity; updateParameters(); }
+    void setDiffusion(float diffusion) { diffusion_ = diffusion; updateParameters(); }
+    void setEvaporation(float evaporation) { evaporation_ = evaporation; updateParameters(); }
     
 private:
     Rendering::RenderingEngine& engine_;
@@ -397,22 +488,15 @@ private:
     
     // Simulation parameters
     float viscosity_ = 0.5f;
-    float diffusion_ = 0.1f;
+    float diffusion_ = 8.0f;     // Cells squared per second
     float evaporation_ = 0.01f;
     
-    // GPU resources
-    Rendering::PipelineId advectionPipelineId_ = 0;
-    Rendering::PipelineId diffusionPipelineId_ = 0;
-    Rendering::PipelineId pressurePipelineId_ = 0;
-    Rendering::ResourceId velocityTexture_ = 0;
-    Rendering::ResourceId paintTexture_ = 0;
-    Rendering::ResourceId pressureTexture_ = 0;
+    PaintMedium medium_;
     
     // Simulation state
     bool initialized_ = false;
     
-    bool createSimulationShaders();
-    void destroyResources();
+    void updateParameters();
 };
 
 } // namespace QuantumCanvas::Raster
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "color_lut.hpp"
+#include "../../core/kernel/task_scheduler.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace QuantumCanvas::Raster {
+
+namespace Detail {
+
+// Per-ISA kernels; each returns how many leading pixels it converted
+size_t applyLUTAvx2(const float* table, uint32_t size, float* r, float* g, float* b, size_t count);
+
+} // namespace Detail
+
+namespace {
+
+// Clamps to [0, 1], sending NaN to 0 like the vector kernels
+inline float unit(float x) {
+    return std::max(0.0f, std::min(x, 1.0f));
+}
+
+// Tetrahedral interpolation of one color. The tetrahedron is picked by
+// ordering the fractional parts: its corners walk from the cell's origin
+// along the axis of the largest fraction, then the middle one, to the far
+// corner. The AVX2 kernel computes the same corners lane by lane.
+inline std::array<float, 3> tetrahedral(const float* table, uint32_t size, float r, float g, float b) {
+    const float scale = static_cast<float>(size - 1);
+    const float last = static_cast<float>(size - 2);
+    float pr = unit(r) * scale;
+    float pg = unit(g) * scale;
+    float pb = unit(b) * scale;
+    float ir = std::min(std::floor(pr), last);
+    float ig = std::min(std::floor(pg), last);
+    float ib = std::min(std::floor(pb), last);
+    float fr = pr - ir;
+    float fg = pg - ig;
+    float fb = pb - ib;
+
+    const uint32_t strideR = 3;
+    const uint32_t strideG = 3 * size;
+    const uint32_t strideB = 3 * size * size;
+    uint32_t base = static_cast<uint32_t>(ib) * strideB + static_cast<uint32_t>(ig) * strideG +
+                    static_cast<uint32_t>(ir) * strideR;
+
+    // Ties resolve so the largest and smallest axes always differ
+    uint32_t largest = (fr >= fg && fr >= fb) ? strideR : (fg >= fb ? strideG : strideB);
+    uint32_t smallest = (fb <= fr && fb <= fg) ? strideB : (fg <= fr ? strideG : strideR);
+    float hi = std::max({fr, fg, fb});
+    float lo = std::min({fr, fg, fb});
+    float mid = fr + fg + fb - hi - lo;
+
+    const float* c0 = table + base;
+    const float* c1 = table + base + largest;
+    const float* c2 = table + base + strideR + strideG + strideB - smallest;
+    const float* c3 = table + base + strideR + strideG + strideB;
+
+    std::array<float, 3> result;
+    for (int c = 0; c < 3; ++c) {
+        result[c] = c0[c] + hi * (c1[c] - c0[c]) + mid * (c2[c] - c1[c]) + lo * (c3[c] - c2[c]);
+    }
+    return result;
+}
+
+} // namespace
+
+ColorLUT::ColorLUT(const Transform& transform, uint32_t size)
+    : size_(std::clamp(size, MIN_SIZE, MAX_SIZE)) {
+    table_.resize(size_t(size_) * size_ * size_ * 3);
+
+    const float step = 1.0f / static_cast<float>(size_ - 1);
+    Core::parallel_for(0, size_, 1, [&](size_t blue) {
+        float* slice = table_.data() + blue * size_ * size_ * 3;
+        for (uint32_t green = 0; green < size_; ++green) {
+            for (uint32_t red = 0; red < size_; ++red) {
+                auto rgb = transform({red * step, green * step, blue * step});
+                float* entry = slice + (size_t(green) * size_ + red) * 3;
+                entry[0] = rgb[0];
+                entry[1] = rgb[1];
+                entry[2] = rgb[2];
+            }
+        }
+    });
+}
+
+std::vector<float> ColorLUT::toRGBA() const {
+    std::vector<float> rgba(table_.size() / 3 * 4);
+    for (size_t i = 0, n = table_.size() / 3; i < n; ++i) {
+        rgba[i * 4 + 0] = table_[i * 3 + 0];
+        rgba[i * 4 + 1] = table_[i * 3 + 1];
+        rgba[i * 4 + 2] = table_[i * 3 + 2];
+        rgba[i * 4 + 3] = 1.0f;
+    }
+    return rgba;
+}
+
+std::array<float, 3> ColorLUT::apply(const std::array<float, 3>& rgb) const {
+    if (empty()) {
+        return rgb;
+    }
+    return tetrahedral(table_.data(), size_, rgb[0], rgb[1], rgb[2]);
+}
+
+void ColorLUT::apply(float* r, float* g, float* b, size_t count) const {
+    apply(CpuBlend::activeIsa(), r, g, b, count);
+}
+
+void ColorLUT::apply(CpuBlend::Isa isa, float* r, float* g, float* b, size_t count) const {
+    if (empty()) {
+        return;
+    }
+
+    size_t done = 0;
+#if defined(QUANTUM_CANVAS_HAVE_AVX2)
+    // AVX-512 machines have AVX2 too, and the gathers dominate either way
+    if ((isa == CpuBlend::Isa::AVX2 || isa == CpuBlend::Isa::AVX512) &&
+        CpuBlend::isIsaAvailable(CpuBlend::Isa::AVX2)) {
+        done = Detail::applyLUTAvx2(table_.data(), size_, r, g, b, count);
+    }
+#else
+    (void)isa;
+#endif
+
+    for (size_t i = done; i < count; ++i) {
+        auto rgb = tetrahedral(table_.data(), size_, r[i], g[i], b[i]);
+        r[i] = rgb[0];
+        g[i] = rgb[1];
+        b[i] = rgb[2];
+    }
+}
+
+void ColorLUT::applyToImage(Image& image) const {
+    if (empty() || image.empty()) {
+        return;
+    }
+
+    constexpr uint32_t tileSize = Image::TILE_SIZE;
+    const CpuBlend::Isa isa = CpuBlend::activeIsa();
+
+    const Image::Pixel& fill = image.fillColor();
+    auto fillRGB = apply({fill[0], fill[1], fill[2]});
+    const bool fillUnchanged = fillRGB[0] == fill[0] && fillRGB[1] == fill[1] && fillRGB[2] == fill[2];
+
+    Core::parallel_for(0, image.tileCount(), 1, [&](size_t index) {
+        uint32_t tileX = static_cast<uint32_t>(index % image.tilesX());
+        uint32_t tileY = static_cast<uint32_t>(index / image.tilesX());
+        if (fillUnchanged && !image.isTileAllocated(tileX, tileY)) {
+            return;
+        }
+
+        // Only pixels inside the image are converted, so edge tiles keep the
+        // fill color beyond the border
+        uint32_t validX = std::min(tileSize, image.width() - tileX * tileSize);
+        uint32_t validY = std::min(tileSize, image.height() - tileY * tileSize);
+        applyToTile(isa, image.mutableTileData(tileX, tileY), validX, validY);
+    });
+}
+
+void ColorLUT::applyToTile(CpuBlend::Isa isa, float* tile, uint32_t validX, uint32_t validY) const {
+    constexpr size_t tilePixels = size_t(Image::TILE_SIZE) * Image::TILE_SIZE;
+    thread_local std::vector<float> scratch(tilePixels * 3);
+    float* r = scratch.data();
+    float* g = r + tilePixels;
+    float* b = g + tilePixels;
+
+    size_t count = 0;
+    for (uint32_t y = 0; y < validY; ++y) {
+        const float* row = tile + y * Image::TILE_STRIDE;
+        for (uint32_t x = 0; x < validX; ++x, ++count) {
+            r[count] = row[x * 4 + 0];
+            g[count] = row[x * 4 + 1];
+            b[count] = row[x * 4 + 2];
+        }
+    }
+
+    apply(isa, r, g, b, count);
+
+    count = 0;
+    for (uint32_t y = 0; y < validY; ++y) {
+        float* row = tile + y * Image::TILE_STRIDE;
+        for (uint32_t x = 0; x < validX; ++x, ++count) {
+            row[x * 4 + 0] = r[count];
+            row[x * 4 + 1] = g[count];
+            row[x * 4 + 2] = b[count];
+        }
+    }
+}
+
+} // namespace QuantumCanvas::Raster
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "blend_kernels.hpp"
+#include "raster_image.hpp"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace QuantumCanvas::Raster {
+
+// A color transform sampled on a size^3 grid over the unit RGB cube and
+// evaluated by tetrahedral interpolation: each lookup blends the four
+// corners of the tetrahedron around the color, which reproduces affine
+// transforms exactly and, unlike trilinear interpolation, keeps the neutral
+// axis on the grey diagonal. Evaluating a LUT costs the same whatever the
+// transform behind it, so full-image conversions and soft proofs run at a
+// few gathers and multiply-adds per pixel. Inputs are clamped to [0, 1].
+class ColorLUT {
+public:
+    static constexpr uint32_t MIN_SIZE = 17;
+    static constexpr uint32_t MAX_SIZE = 65;
+    static constexpr uint32_t DEFAULT_SIZE = 33;
+
+    using Transform = std::function<std::array<float, 3>(const std::array<float, 3>&)>;
+
+    ColorLUT() = default;
+
+    // Samples the transform at every grid point, in parallel on the shared
+    // scheduler, so it must be safe to call concurrently. The size is
+    // clamped to [MIN_SIZE, MAX_SIZE].
+    explicit ColorLUT(const Transform& transform, uint32_t size = DEFAULT_SIZE);
+
+    uint32_t size() const { return size_; }
+    bool empty() const { return table_.empty(); }
+
+    // RGB triples, red varying fastest, then green, then blue
+    const std::vector<float>& data() const { return table_; }
+    std::vector<float> toRGBA() const;  // The same with a padding channel, for 3D textures
+
+    std::array<float, 3> apply(const std::array<float, 3>& rgb) const;
+
+    // In place on planar channels, with the active CPU blend instruction set
+    void apply(float* r, float* g, float* b, size_t count) const;
+    void apply(CpuBlend::Isa isa, float* r, float* g, float* b, size_t count) const;
+
+    // Transforms the RGB of every pixel, tile by tile in parallel, leaving
+    // alpha alone. Unallocated tiles stay unallocated when the transform
+    // maps the fill color onto itself.
+    void applyToImage(Image& image) const;
+
+    // The same on the top-left validX x validY pixels of one image tile
+    void applyToTile(CpuBlend::Isa isa, float* tile, uint32_t validX, uint32_t validY) const;
+
+private:
+    uint32_t size_ = 0;
+    std::vector<float> table_;
+};
+
+} // namespace QuantumCanvas::Raster
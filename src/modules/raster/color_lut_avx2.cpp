@@ -0,0 +1,76 @@
+#include <immintrin.h>
+#include <cstddef>
+#include <cstdint>
+
+// Compiled with -mavx2 -mfma; only called after the CPU was checked
+namespace QuantumCanvas::Raster::Detail {
+
+// Eight pixels at a time: the corner offsets of each lane's tetrahedron are
+// computed in integer registers and the twelve corner values gathered from
+// the table. Matches tetrahedral() in color_lut.cpp.
+size_t applyLUTAvx2(const float* table, uint32_t size, float* r, float* g, float* b, size_t count) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 scale = _mm256_set1_ps(static_cast<float>(size - 1));
+    const __m256 last = _mm256_set1_ps(static_cast<float>(size - 2));
+    const __m256i strideR = _mm256_set1_epi32(3);
+    const __m256i strideG = _mm256_set1_epi32(static_cast<int>(3 * size));
+    const __m256i strideB = _mm256_set1_epi32(static_cast<int>(3 * size * size));
+    const __m256i strideAll = _mm256_add_epi32(strideR, _mm256_add_epi32(strideG, strideB));
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        // max before min sends NaN to 0
+        __m256 pr = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(r + i), zero), one), scale);
+        __m256 pg = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(g + i), zero), one), scale);
+        __m256 pb = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(b + i), zero), one), scale);
+        __m256 ir = _mm256_min_ps(_mm256_floor_ps(pr), last);
+        __m256 ig = _mm256_min_ps(_mm256_floor_ps(pg), last);
+        __m256 ib = _mm256_min_ps(_mm256_floor_ps(pb), last);
+        __m256 fr = _mm256_sub_ps(pr, ir);
+        __m256 fg = _mm256_sub_ps(pg, ig);
+        __m256 fb = _mm256_sub_ps(pb, ib);
+
+        __m256i base = _mm256_add_epi32(
+            _mm256_add_epi32(_mm256_mullo_epi32(_mm256_cvttps_epi32(ib), strideB),
+                             _mm256_mullo_epi32(_mm256_cvttps_epi32(ig), strideG)),
+            _mm256_mullo_epi32(_mm256_cvttps_epi32(ir), strideR));
+
+        // Same tie-breaking as the scalar path
+        __m256 rLargest = _mm256_and_ps(_mm256_cmp_ps(fr, fg, _CMP_GE_OQ), _mm256_cmp_ps(fr, fb, _CMP_GE_OQ));
+        __m256 gOverB = _mm256_cmp_ps(fg, fb, _CMP_GE_OQ);
+        __m256i largest = _mm256_castps_si256(_mm256_blendv_ps(
+            _mm256_blendv_ps(_mm256_castsi256_ps(strideB), _mm256_castsi256_ps(strideG), gOverB),
+            _mm256_castsi256_ps(strideR), rLargest));
+
+        __m256 bSmallest = _mm256_and_ps(_mm256_cmp_ps(fb, fr, _CMP_LE_OQ), _mm256_cmp_ps(fb, fg, _CMP_LE_OQ));
+        __m256 gUnderR = _mm256_cmp_ps(fg, fr, _CMP_LE_OQ);
+        __m256i smallest = _mm256_castps_si256(_mm256_blendv_ps(
+            _mm256_blendv_ps(_mm256_castsi256_ps(strideR), _mm256_castsi256_ps(strideG), gUnderR),
+            _mm256_castsi256_ps(strideB), bSmallest));
+
+        __m256 hi = _mm256_max_ps(fr, _mm256_max_ps(fg, fb));
+        __m256 lo = _mm256_min_ps(fr, _mm256_min_ps(fg, fb));
+        __m256 mid = _mm256_sub_ps(_mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(fr, fg), fb), hi), lo);
+
+        __m256i i0 = base;
+        __m256i i1 = _mm256_add_epi32(base, largest);
+        __m256i i3 = _mm256_add_epi32(base, strideAll);
+        __m256i i2 = _mm256_sub_epi32(i3, smallest);
+
+        float* planes[3] = {r + i, g + i, b + i};
+        for (int c = 0; c < 3; ++c) {
+            __m256 c0 = _mm256_i32gather_ps(table + c, i0, 4);
+            __m256 c1 = _mm256_i32gather_ps(table + c, i1, 4);
+            __m256 c2 = _mm256_i32gather_ps(table + c, i2, 4);
+            __m256 c3 = _mm256_i32gather_ps(table + c, i3, 4);
+            __m256 v = _mm256_fmadd_ps(hi, _mm256_sub_ps(c1, c0), c0);
+            v = _mm256_fmadd_ps(mid, _mm256_sub_ps(c2, c1), v);
+            v = _mm256_fmadd_ps(lo, _mm256_sub_ps(c3, c2), v);
+            _mm256_storeu_ps(planes[c], v);
+        }
+    }
+    return i;
+}
+
+} // namespace QuantumCanvas::Raster::Detail
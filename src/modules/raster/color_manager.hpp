@@ -1,8 +1,10 @@
 #pragma once
 
 #include "../../core/rendering/rendering_engine.hpp"
+#include "../../core/kernel/telemetry.hpp"
 #include "../../core/math/vector3.hpp"
 #include "../../core/math/vector4.hpp"
+#include "color_lut.hpp"
 #include <memory>
 #include <vector>
 #include <unordered_map>
@@ -12,6 +14,7 @@
 #include <filesystem>
 #include <atomic>
 #include <mutex>
+#include <span>
 #include <chrono>
 
 namespace QuantumCanvas::Raster {
@@ -146,7 +149,7 @@ class ColorProfile {
 public:
     explicit ColorProfile(ColorSpace colorSpace = ColorSpace::sRGB);
     explicit ColorProfile(const std::filesystem::path& iccProfilePath);
-    explicit ColorProfile(const std::vector<uint8_t>& iccData);
+    explicit ColorProfile(std::span<const uint8_t> iccData);  // e.g. straight from a mapped file
     ~ColorProfile();
     
     // Profile information
@@ -197,7 +200,7 @@ private:
     std::string lastError_;
     
     // ICC profile parsing
-    bool parseICCProfile(const std::vector<uint8_t>& data);
+    bool parseICCProfile(std::span<const uint8_t> data);
     void initializeStandardProfile(ColorSpace colorSpace);
     void calculateMatrices();
 };
@@ -286,33 +289,57 @@ public:
     SoftProofingEngine() = default;
     ~SoftProofingEngine() = default;
     
-    // Proofing setup
-    void setSourceProfile(std::shared_ptr<ColorProfile> profile) { sourceProfile_ = profile; }
-    void setTargetProfile(std::shared_ptr<ColorProfile> profile) { targetProfile_ = profile; }
-    void setDisplayProfile(std::shared_ptr<ColorProfile> profile) { displayProfile_ = profile; }
+    // Proofing setup; any change rebuilds the LUTs and proofs in full
+    void setSourceProfile(std::shared_ptr<ColorProfile> profile) { sourceProfile_ = profile; invalidate(); }
+    void setTargetProfile(std::shared_ptr<ColorProfile> profile) { targetProfile_ = profile; invalidate(); }
+    void setDisplayProfile(std::shared_ptr<ColorProfile> profile) { displayProfile_ = profile; invalidate(); }
     
-    void setRenderingIntent(RenderingIntent intent) { renderingIntent_ = intent; }
+    void setRenderingIntent(RenderingIntent intent) { renderingIntent_ = intent; invalidate(); }
     RenderingIntent getRenderingIntent() const { return renderingIntent_; }
     
-    void setGamutWarning(bool enable) { gamutWarning_ = enable; }
+    void setGamutWarning(bool enable) { gamutWarning_ = enable; invalidate(); }
     bool getGamutWarning() const { return gamutWarning_; }
     
-    void setGamutWarningColor(const std::array<float, 3>& color) { gamutWarningColor_ = color; }
+    void setGamutWarningColor(const std::array<float, 3>& color) { gamutWarningColor_ = color; invalidate(); }
     
-    // Proofing operations
-    void generateProof(const Image& sourceImage, Image& proofImage);
-    void generateGamutMask(const Image& sourceImage, Image& gamutMask);
+    void setLUTSize(uint32_t size) { lutSize_ = size; invalidate(); }
+    uint32_t getLUTSize() const { return lutSize_; }
+    
+    // Proofing operations. The whole source -> print -> display chain is
+    // baked into one LUT when first needed after a setting changes.
+    //
+    // Proofs, masks and analyses are incremental. Each keeps a copy of the
+    // source as it last processed it, sharing its tiles; the source
+    // unshares a tile when writing it, so only tiles written since are
+    // processed again. Callers that recomposite the source in full pass the
+    // compositor's damage for the frame instead (document-space rects, as
+    // from Layer::collectDamage()), and only tiles under it are redone.
+    using DamageRects = std::vector<std::array<float, 4>>;
+    
+    void generateProof(const Image& sourceImage, Image& proofImage, const DamageRects* damage = nullptr);
+    const ColorLUT& getProofLUT();
+    
+    // Opaque white where the source is outside the target gamut, transparent
+    // elsewhere; tiles entirely in gamut are left unallocated
+    void generateGamutMask(const Image& sourceImage, Image& gamutMask, const DamageRects* damage = nullptr);
+    
+    // Gamut analysis. Statistics are kept per tile and summed on each call.
+    // Delta E is CIE76 between the source color and its printed color.
+    static constexpr size_t MAX_REPORTED_PIXELS = 4096;  // Of outOfGamutPixels
+    static constexpr size_t MAX_PIXELS_PER_TILE = 64;
     
-    // Gamut analysis
     struct GamutAnalysis {
         float inGamutPercentage;
         float outOfGamutPercentage;
-        std::array<float, 3> maxDeltaE;
+        std::array<float, 3> maxDeltaE;  // Largest |dL|, |da| and |db|
         float averageDeltaE;
-        std::vector<std::array<uint32_t, 2>> outOfGamutPixels;
+        std::vector<std::array<uint32_t, 2>> outOfGamutPixels;  // A sample, in tile order
     };
     
-    GamutAnalysis analyzeGamut(const Image& image);
+    GamutAnalysis analyzeGamut(const Image& image, const DamageRects* damage = nullptr);
+    
+    // Drops the cached proof, mask and analysis, keeping the LUTs
+    void resetIncrementalState();
 
 private:
     std::shared_ptr<ColorProfile> sourceProfile_;
@@ -321,8 +348,56 @@ private:
     RenderingIntent renderingIntent_ = RenderingIntent::Perceptual;
     bool gamutWarning_ = false;
     std::array<float, 3> gamutWarningColor_{1.0f, 0.0f, 1.0f}; // Magenta
+    uint32_t lutSize_ = ColorLUT::DEFAULT_SIZE;
+    std::shared_ptr<const ColorLUT> proofLUT_;
+    std::shared_ptr<const ColorLUT> gamutLUT_;     // Gamut distance, delta E
+    std::shared_ptr<const ColorLUT> labErrorLUT_;  // |dL|, |da|, |db|
+    uint64_t settingsVersion_ = 1;
+    
+    // The source as one of the outputs last saw it
+    struct SourceSnapshot {
+        Image image;
+        uint64_t settingsVersion = 0;
+    };
+    
+    struct TileGamut {
+        uint32_t inGamut = 0;
+        uint32_t outOfGamut = 0;
+        double deltaESum = 0.0;
+        std::array<float, 3> maxLabError{0.0f, 0.0f, 0.0f};
+        std::vector<std::array<uint32_t, 2>> outOfGamutPixels;
+    };
+    
+    Image proof_;
+    Image gamutMask_;
+    SourceSnapshot proofSource_;
+    SourceSnapshot maskSource_;
+    SourceSnapshot analysisSource_;
+    std::vector<TileGamut> tileGamut_;
+    
+    void invalidate() {
+        proofLUT_.reset();
+        gamutLUT_.reset();
+        labErrorLUT_.reset();
+        ++settingsVersion_;
+    }
     
-    std::array<float, 3> simulatePrintColor(const std::array<float, 3>& sourceColor);
+    // Tile indices of the source to process again for an output, updating
+    // its snapshot. All tiles when the output can't be updated in place;
+    // fullRebuild tells the caller to reset the output first.
+    std::vector<size_t> changedTiles(const Image& source, SourceSnapshot& snapshot,
+                                     const DamageRects* damage, bool& fullRebuild) const;
+    
+    const ColorLUT& getGamutLUT();
+    const ColorLUT& getLabErrorLUT();
+    
+    std::array<float, 3> printColor(const std::array<float, 3>& sourceColor,
+                                    const ColorProfile& source,
+                                    const ColorProfile& target) const;
+    std::array<float, 3> simulatePrintColor(const std::array<float, 3>& sourceColor,
+                                            const ColorProfile& source,
+                                            const ColorProfile& target,
+                                            const ColorProfile& display) const;
 };
 
 // Main color management system
@@ -369,7 +444,21 @@ public:
                      const ColorProfile& targetProfile,
                      RenderingIntent intent = RenderingIntent::Perceptual);
     
-    // GPU-accelerated color conversion
+    // Source/target/intent transforms baked into LUTs, built on first use and
+    // cached. A LUT captures the gamut mapper as it was when built, so clear
+    // the cache after reconfiguring it.
+    std::shared_ptr<const ColorLUT> getConversionLUT(const ColorProfile& sourceProfile,
+                                                     const ColorProfile& targetProfile,
+                                                     RenderingIntent intent = RenderingIntent::Perceptual);
+    void clearLUTCache() { cleanupLUTCache(); }
+    
+    // Grid points per axis of new LUTs; changing it clears the cache
+    void setLUTSize(uint32_t size);
+    uint32_t getLUTSize() const { return lutSize_; }
+    
+    // GPU-accelerated color conversion, with the LUT as a 3D texture.
+    // Textures are RGBA32Float; alpha is copied. Returns false when nothing
+    // was recorded, including when this frame's upload ring is full.
     bool convertImageGPU(Rendering::ResourceId sourceTexture,
                         Rendering::ResourceId targetTexture,
                         const std::array<uint32_t, 2>& size,
@@ -469,20 +558,27 @@ private:
     ColorManagerStats stats_;
     
     // LUT cache for complex conversions
+    static constexpr size_t MAX_CACHED_LUTS = 16;
+    
     struct LUTCacheEntry {
         std::string sourceProfileName;
         std::string targetProfileName;
         RenderingIntent intent;
-        Rendering::ResourceId lutTextureId;
+        std::shared_ptr<const ColorLUT> lut;
+        Rendering::ResourceId lutTextureId = 0;  // Uploaded on first GPU use
         std::array<uint32_t, 3> lutSize;
         std::chrono::system_clock::time_point creationTime;
-        uint32_t accessCount;
+        uint32_t accessCount = 0;
     };
     
     mutable std::mutex lutCacheMutex_;
     std::unordered_map<uint64_t, LUTCacheEntry> lutCache_;
+    uint32_t lutSize_ = ColorLUT::DEFAULT_SIZE;
+    
+    Core::Telemetry::SourceRegistration telemetrySource_;
     
     // Internal methods
+    void registerTelemetry();
     bool createGPUResources();
     void destroyGPUResources();
     
@@ -493,9 +589,20 @@ private:
                                  const std::string& targetProfile,
                                  RenderingIntent intent) const;
     
-    Rendering::ResourceId createConversionLUT(const ColorProfile& sourceProfile,
-                                             const ColorProfile& targetProfile,
-                                             RenderingIntent intent);
+    // Finds or builds the cache entry; lutCacheMutex_ must be held
+    LUTCacheEntry& acquireLUT(const ColorProfile& sourceProfile,
+                              const ColorProfile& targetProfile,
+                              RenderingIntent intent);
+    
+    // Uploads a LUT as an RGBA32Float 3D texture
+    Rendering::ResourceId createConversionLUT(const ColorLUT& lut);
+    Rendering::PipelineId getColorConversionPipeline();
+    
+    // What convertColor() computes, without statistics
+    std::array<float, 3> transformColor(const std::array<float, 3>& color,
+                                        const ColorProfile& sourceProfile,
+                                        const ColorProfile& targetProfile,
+                                        RenderingIntent intent);
     
     void cleanupLUTCache();
     
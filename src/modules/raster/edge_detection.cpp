@@ -0,0 +1,409 @@
+#include "edge_detection.hpp"
+#include "gaussian_blur.hpp"
+#include "../../core/kernel/task_scheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace QuantumCanvas::Raster::Edges {
+
+namespace {
+
+constexpr uint32_t TILE = Image::TILE_SIZE;
+constexpr size_t CH = Image::CHANNELS;
+
+// Non-maximum suppression classes
+constexpr uint8_t NO_EDGE = 0;
+constexpr uint8_t WEAK_EDGE = 1;
+constexpr uint8_t STRONG_EDGE = 2;
+
+// Gradient directions, quantized to the neighbour pair they point between
+enum Sector : uint8_t {
+    Horizontal,   // Compare left and right
+    Falling,      // Top-left and bottom-right
+    Vertical,     // Above and below
+    Rising        // Bottom-left and top-right
+};
+
+constexpr float TAN_22_5 = 0.41421356f;
+constexpr float TAN_67_5 = 2.41421356f;
+
+// The last few rows of a pipeline stage, indexed by image row
+template <typename T>
+class RowWindow {
+public:
+    RowWindow(size_t rows, size_t width) : rows_(static_cast<int64_t>(rows)), width_(width), data_(rows * width) {}
+
+    T* operator[](int64_t y) {
+        return data_.data() + static_cast<size_t>(((y % rows_) + rows_) % rows_) * width_;
+    }
+
+private:
+    int64_t rows_;
+    size_t width_;
+    std::vector<T> data_;
+};
+
+// Grey levels of row y, one float per pixel
+void greyRow(const Image& image, uint32_t y, float* __restrict dst) {
+    const uint32_t width = image.width();
+    const uint32_t tileY = y / TILE;
+    const size_t rowOffset = size_t(y % TILE) * Image::TILE_STRIDE;
+
+    for (uint32_t x0 = 0; x0 < width; x0 += TILE) {
+        const uint32_t count = std::min(TILE, width - x0);
+        if (const float* tile = image.tileData(x0 / TILE, tileY)) {
+            const float* __restrict src = tile + rowOffset;
+            for (uint32_t i = 0; i < count; ++i) {
+                dst[x0 + i] = (src[i * CH] + src[i * CH + 1] + src[i * CH + 2]) * (1.0f / 3.0f);
+            }
+        } else {
+            const Image::Pixel& fill = image.fillColor();
+            std::fill_n(dst + x0, count, (fill[0] + fill[1] + fill[2]) * (1.0f / 3.0f));
+        }
+    }
+}
+
+// Sobel derivatives of the middle of three rows over [1, width - 1); the
+// border columns get no gradient
+void sobelRow(const float* __restrict above, const float* __restrict row, const float* __restrict below,
+              uint32_t width, float* __restrict gx, float* __restrict gy) {
+    gx[0] = gy[0] = 0.0f;
+    gx[width - 1] = gy[width - 1] = 0.0f;
+    for (uint32_t x = 1; x + 1 < width; ++x) {
+        gx[x] = (above[x + 1] - above[x - 1]) + 2.0f * (row[x + 1] - row[x - 1]) + (below[x + 1] - below[x - 1]);
+        gy[x] = (below[x - 1] + 2.0f * below[x] + below[x + 1]) - (above[x - 1] + 2.0f * above[x] + above[x + 1]);
+    }
+}
+
+// Rows [y0, y1) of band 'band', leaving out the image's border rows
+struct BandRows {
+    uint32_t y0;
+    uint32_t y1;
+    uint32_t first;
+    uint32_t last;
+};
+
+BandRows bandRows(const Image& image, size_t band) {
+    BandRows rows;
+    rows.y0 = static_cast<uint32_t>(band) * TILE;
+    rows.y1 = std::min(rows.y0 + TILE, image.height());
+    rows.first = std::max(rows.y0, 1u);
+    rows.last = std::min(rows.y1, image.height() - 1);
+    return rows;
+}
+
+// Fused grey, smoothing, gradient and suppression for the rows of one band.
+// Every stage keeps only the rows the next one still reads: 2r + 1 rows
+// blurred horizontally, three smoothed rows and three rows of gradient.
+class CannyBand {
+public:
+    CannyBand(const Image& input, const std::vector<float>& kernel, float lowThreshold, float highThreshold)
+        : input_(input)
+        , width_(input.width())
+        , height_(input.height())
+        , kernel_(kernel)
+        , radius_(static_cast<int64_t>(kernel.size() / 2))
+        , low_(lowThreshold)
+        , high_(highThreshold)
+        , rowBlurred_(kernel.size(), width_)
+        , smoothed_(3, width_)
+        , magnitude_(3, width_)
+        , sectors_(3, width_)
+        , padded_(width_ + 2 * kernel.size())
+        , gx_(width_)
+        , gy_(width_) {}
+
+    // Classifies rows [first, last) into classes, row-major with the image's width
+    void run(uint32_t first, uint32_t last, uint8_t* classes) {
+        nextBlurred_ = int64_t(first) - 2 - radius_;
+        nextSmoothed_ = int64_t(first) - 2;
+        nextGradient_ = int64_t(first) - 1;
+
+        for (uint32_t y = first; y < last; ++y) {
+            ensureGradient(y + 1);
+            suppress(y, classes + size_t(y) * width_);
+        }
+    }
+
+private:
+    void blurRow(int64_t y) {
+        // Clamp-to-edge rows, then columns
+        const uint32_t sourceRow = static_cast<uint32_t>(std::clamp<int64_t>(y, 0, height_ - 1));
+        float* line = padded_.data();
+        greyRow(input_, sourceRow, line + radius_);
+        std::fill_n(line, radius_, line[radius_]);
+        std::fill_n(line + radius_ + width_, radius_, line[radius_ + width_ - 1]);
+
+        float* __restrict out = rowBlurred_[y];
+        std::fill_n(out, width_, 0.0f);
+        for (size_t k = 0; k < kernel_.size(); ++k) {
+            const float* __restrict in = line + k;
+            const float weight = kernel_[k];
+            for (uint32_t x = 0; x < width_; ++x) {
+                out[x] += in[x] * weight;
+            }
+        }
+    }
+
+    void smoothRow(int64_t y) {
+        float* __restrict out = smoothed_[y];
+        std::fill_n(out, width_, 0.0f);
+        for (size_t k = 0; k < kernel_.size(); ++k) {
+            const float* __restrict in = rowBlurred_[y - radius_ + static_cast<int64_t>(k)];
+            const float weight = kernel_[k];
+            for (uint32_t x = 0; x < width_; ++x) {
+                out[x] += in[x] * weight;
+            }
+        }
+    }
+
+    void ensureSmoothed(int64_t y) {
+        for (; nextSmoothed_ <= y; ++nextSmoothed_) {
+            for (; nextBlurred_ <= nextSmoothed_ + radius_; ++nextBlurred_) {
+                blurRow(nextBlurred_);
+            }
+            smoothRow(nextSmoothed_);
+        }
+    }
+
+    void ensureGradient(int64_t y) {
+        for (; nextGradient_ <= y; ++nextGradient_) {
+            const int64_t row = nextGradient_;
+            float* magnitude = magnitude_[row];
+            uint8_t* sectors = sectors_[row];
+
+            // Border rows have no gradient, so suppression sees zeros there
+            if (row <= 0 || row >= int64_t(height_) - 1) {
+                std::fill_n(magnitude, width_, 0.0f);
+                std::fill_n(sectors, width_, Horizontal);
+                continue;
+            }
+
+            ensureSmoothed(row + 1);
+            sobelRow(smoothed_[row - 1], smoothed_[row], smoothed_[row + 1], width_, gx_.data(), gy_.data());
+
+            for (uint32_t x = 0; x < width_; ++x) {
+                float gx = gx_[x];
+                float gy = gy_[x];
+                magnitude[x] = std::sqrt(gx * gx + gy * gy);
+
+                float ax = std::fabs(gx);
+                float ay = std::fabs(gy);
+                if (ay <= TAN_22_5 * ax) {
+                    sectors[x] = Horizontal;
+                } else if (ay >= TAN_67_5 * ax) {
+                    sectors[x] = Vertical;
+                } else {
+                    // Rows grow downwards, so equal signs point along the falling diagonal
+                    sectors[x] = (gx > 0) == (gy > 0) ? Falling : Rising;
+                }
+            }
+        }
+    }
+
+    void suppress(int64_t y, uint8_t* classes) {
+        const float* above = magnitude_[y - 1];
+        const float* row = magnitude_[y];
+        const float* below = magnitude_[y + 1];
+        const uint8_t* sectors = sectors_[y];
+
+        for (uint32_t x = 1; x + 1 < width_; ++x) {
+            float m = row[x];
+            if (m <= low_) {
+                continue;
+            }
+
+            float before, after;
+            switch (sectors[x]) {
+                case Horizontal: before = row[x - 1];   after = row[x + 1];   break;
+                case Falling:    before = above[x - 1]; after = below[x + 1]; break;
+                case Vertical:   before = above[x];     after = below[x];     break;
+                default:         before = below[x - 1]; after = above[x + 1]; break;
+            }
+
+            // Strict on one side, so plateaus thin to a single pixel
+            if (m > before && m >= after) {
+                classes[x] = m > high_ ? STRONG_EDGE : WEAK_EDGE;
+            }
+        }
+    }
+
+    const Image& input_;
+    const uint32_t width_;
+    const uint32_t height_;
+    const std::vector<float>& kernel_;
+    const int64_t radius_;
+    const float low_;
+    const float high_;
+
+    RowWindow<float> rowBlurred_;
+    RowWindow<float> smoothed_;
+    RowWindow<float> magnitude_;
+    RowWindow<uint8_t> sectors_;
+    std::vector<float> padded_;
+    std::vector<float> gx_;
+    std::vector<float> gy_;
+
+    int64_t nextBlurred_ = 0;
+    int64_t nextSmoothed_ = 0;
+    int64_t nextGradient_ = 0;
+};
+
+// Promotes weak edges 8-connected to the seeds on the stack, within rows
+// [y0, y1)
+void floodStrong(std::vector<uint8_t>& classes, uint32_t width, uint32_t y0, uint32_t y1,
+                 std::vector<size_t>& stack) {
+    while (!stack.empty()) {
+        size_t index = stack.back();
+        stack.pop_back();
+
+        const uint32_t x = static_cast<uint32_t>(index % width);
+        const uint32_t y = static_cast<uint32_t>(index / width);
+        for (uint32_t ny = std::max(y, y0 + 1) - 1; ny <= std::min(y + 1, y1 - 1); ++ny) {
+            for (uint32_t nx = std::max(x, 1u) - 1; nx <= std::min(x + 1, width - 1); ++nx) {
+                size_t neighbour = size_t(ny) * width + nx;
+                if (classes[neighbour] == WEAK_EDGE) {
+                    classes[neighbour] = STRONG_EDGE;
+                    stack.push_back(neighbour);
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+void sobel(const Image& input, Image& output) {
+    const uint32_t width = input.width();
+    const uint32_t height = input.height();
+
+    // A uniform region has no edges
+    output.reset(width, height, {0.0f, 0.0f, 0.0f, 1.0f});
+    if (width < 3 || height < 3) {
+        return;
+    }
+
+    Core::parallel_for(0, input.tilesY(), 1, [&](size_t band) {
+        const BandRows rows = bandRows(input, band);
+
+        std::vector<uint8_t> active(input.tilesX());
+        bool anyActive = false;
+        for (uint32_t tx = 0; tx < input.tilesX(); ++tx) {
+            int64_t x0 = int64_t(tx) * TILE;
+            active[tx] = !input.isRegionUniform(x0 - 1, int64_t(rows.y0) - 1, x0 + TILE + 1, int64_t(rows.y1) + 1);
+            anyActive = anyActive || active[tx];
+        }
+        if (!anyActive || rows.first >= rows.last) {
+            return;
+        }
+
+        RowWindow<float> grey(3, width);
+        std::vector<float> gx(width);
+        std::vector<float> gy(width);
+
+        int64_t nextGrey = int64_t(rows.first) - 1;
+        for (uint32_t y = rows.first; y < rows.last; ++y) {
+            for (; nextGrey <= int64_t(y) + 1; ++nextGrey) {
+                greyRow(input, static_cast<uint32_t>(nextGrey), grey[nextGrey]);
+            }
+            sobelRow(grey[y - 1], grey[y], grey[y + 1], width, gx.data(), gy.data());
+
+            for (uint32_t tx = 0; tx < input.tilesX(); ++tx) {
+                if (!active[tx]) {
+                    continue;
+                }
+                const uint32_t x0 = tx * TILE;
+                float* dst = output.mutableTileData(tx, static_cast<uint32_t>(band)) + size_t(y % TILE) * Image::TILE_STRIDE;
+                for (uint32_t x = std::max(x0, 1u); x < std::min(x0 + TILE, width - 1); ++x) {
+                    float magnitude = std::min(std::sqrt(gx[x] * gx[x] + gy[x] * gy[x]), 1.0f);
+                    float* pixel = dst + size_t(x - x0) * CH;
+                    pixel[0] = magnitude;
+                    pixel[1] = magnitude;
+                    pixel[2] = magnitude;
+                    pixel[3] = 1.0f;
+                }
+            }
+        }
+    });
+}
+
+void canny(const Image& input, Image& output, float lowThreshold, float highThreshold) {
+    const uint32_t width = input.width();
+    const uint32_t height = input.height();
+
+    output.reset(width, height, {0.0f, 0.0f, 0.0f, 1.0f});
+    if (width < 3 || height < 3) {
+        return;
+    }
+
+    const std::vector<float> kernel = Blur::gaussianKernel(CANNY_SIGMA);
+    // Smoothing, then one row each for the gradient and the suppression
+    const int64_t halo = static_cast<int64_t>(kernel.size() / 2) + 2;
+
+    std::vector<uint8_t> classes(size_t(width) * height, NO_EDGE);
+    const size_t bands = input.tilesY();
+
+    // Suppression, then hysteresis inside each band
+    Core::parallel_for(0, bands, 1, [&](size_t band) {
+        const BandRows rows = bandRows(input, band);
+        if (rows.first >= rows.last ||
+            input.isRegionUniform(0, int64_t(rows.y0) - halo, width, int64_t(rows.y1) + halo)) {
+            return;
+        }
+
+        CannyBand(input, kernel, lowThreshold, highThreshold).run(rows.first, rows.last, classes.data());
+
+        std::vector<size_t> stack;
+        for (size_t i = size_t(rows.y0) * width; i < size_t(rows.y1) * width; ++i) {
+            if (classes[i] == STRONG_EDGE) {
+                stack.push_back(i);
+            }
+        }
+        floodStrong(classes, width, rows.y0, rows.y1, stack);
+    });
+
+    // An edge can leave its band: weak pixels across a band border from a
+    // strong one seed a flood over the whole image
+    std::vector<size_t> stack;
+    for (size_t band = 1; band < bands; ++band) {
+        const uint32_t y = static_cast<uint32_t>(band) * TILE;
+        for (uint32_t x = 0; x < width; ++x) {
+            for (uint32_t nx = std::max(x, 1u) - 1; nx <= std::min(x + 1, width - 1); ++nx) {
+                size_t upper = size_t(y - 1) * width + x;
+                size_t lower = size_t(y) * width + nx;
+                if (classes[upper] == STRONG_EDGE && classes[lower] == WEAK_EDGE) {
+                    classes[lower] = STRONG_EDGE;
+                    stack.push_back(lower);
+                } else if (classes[lower] == STRONG_EDGE && classes[upper] == WEAK_EDGE) {
+                    classes[upper] = STRONG_EDGE;
+                    stack.push_back(upper);
+                }
+            }
+        }
+    }
+    floodStrong(classes, width, 0, height, stack);
+
+    Core::parallel_for(0, bands, 1, [&](size_t band) {
+        const BandRows rows = bandRows(input, band);
+        std::vector<float*> tiles(input.tilesX(), nullptr);
+
+        for (uint32_t y = rows.y0; y < rows.y1; ++y) {
+            const uint8_t* row = classes.data() + size_t(y) * width;
+            for (uint32_t x = 0; x < width; ++x) {
+                if (row[x] != STRONG_EDGE) {
+                    continue;
+                }
+                float*& tile = tiles[x / TILE];
+                if (!tile) {
+                    tile = output.mutableTileData(x / TILE, static_cast<uint32_t>(band));
+                }
+                float* pixel = tile + size_t(y % TILE) * Image::TILE_STRIDE + size_t(x % TILE) * CH;
+                std::fill_n(pixel, CH, 1.0f);
+            }
+        }
+    });
+}
+
+} // namespace QuantumCanvas::Raster::Edges
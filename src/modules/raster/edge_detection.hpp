@@ -0,0 +1,25 @@
+#pragma once
+
+#include "raster_image.hpp"
+
+namespace QuantumCanvas::Raster::Edges {
+
+// Canny smooths the grey levels with this sigma before taking the gradient
+constexpr float CANNY_SIGMA = 1.0f;
+
+// Sobel gradient magnitude of the grey level (r + g + b) / 3, clamped to
+// [0, 1] and written to every color channel with alpha 1. Pixels on the
+// image border have no full neighbourhood and no edge. Each band of tiles
+// streams its rows through a three-line window, bands run in parallel on
+// the shared scheduler, and tiles whose neighbourhood is uniform are left
+// unallocated.
+void sobel(const Image& input, Image& output);
+
+// Canny edge detection. Grey conversion, Gaussian smoothing, the Sobel
+// gradient and non-maximum suppression run fused over rolling line windows,
+// one band of tiles per task. Suppressed maxima above highThreshold are
+// edges, and so are those above lowThreshold connected to one; edges come
+// out white, everything else black.
+void canny(const Image& input, Image& output, float lowThreshold, float highThreshold);
+
+} // namespace QuantumCanvas::Raster::Edges
@@ -1,14 +1,17 @@
 #include "filter_processor.hpp"
+#include "gaussian_blur.hpp"
+#include "edge_detection.hpp"
 #include "../../core/rendering/rendering_engine.hpp"
 #include "../../core/memory/memory_manager.hpp"
+#include "../../core/kernel/task_scheduler.hpp"
 #include <iostream>
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <random>
 #include <cassert>
 #include <fstream>
 #include <thread>
-#include <future>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -16,59 +19,208 @@
 
 namespace QuantumCanvas::Raster {
 
-// Forward declaration for Image class (simplified implementation)
-class Image {
-public:
-    uint32_t width = 0;
-    uint32_t height = 0;
-    std::vector<float> data; // RGBA float data
-    
-    Image(uint32_t w, uint32_t h) : width(w), height(h) {
-        data.resize(w * h * 4); // RGBA
+namespace {
+
+// Visits the image tile by tile as [x0, x1) x [y0, y1) rectangles. Filters
+// skip a tile when its input neighbourhood is uniform: the output there is
+// the filtered fill color, which they set as the output's fill instead.
+template <typename Fn>
+void forEachTile(const Image& image, Fn&& fn) {
+    for (uint32_t ty = 0; ty < image.tilesY(); ++ty) {
+        for (uint32_t tx = 0; tx < image.tilesX(); ++tx) {
+            uint32_t x0 = tx * Image::TILE_SIZE;
+            uint32_t y0 = ty * Image::TILE_SIZE;
+            fn(x0, y0, std::min(x0 + Image::TILE_SIZE, image.width()),
+               std::min(y0 + Image::TILE_SIZE, image.height()));
+        }
     }
-    
-    void setPixel(uint32_t x, uint32_t y, const std::array<float, 4>& color) {
-        if (x >= width || y >= height) return;
-        size_t idx = (y * width + x) * 4;
-        data[idx + 0] = color[0];
-        data[idx + 1] = color[1];
-        data[idx + 2] = color[2];
-        data[idx + 3] = color[3];
+}
+
+// Fused stages give up on tiling past this halo, where recomputing the
+// overlap of neighbouring crops would cost more than a full pass
+constexpr int MAX_FUSED_HALO = static_cast<int>(Image::TILE_SIZE) / 2;
+
+// Copies a width x height block between images a tile run at a time. The
+// destination block must still read as its fill; where the source is
+// unallocated and both fills agree, nothing gets allocated.
+void copyRegion(const Image& src, uint32_t srcX, uint32_t srcY, uint32_t width, uint32_t height,
+                Image& dst, uint32_t dstX, uint32_t dstY) {
+    constexpr uint32_t tileSize = Image::TILE_SIZE;
+    const bool sameFill = src.fillColor() == dst.fillColor();
+
+    for (uint32_t row = 0; row < height; ++row) {
+        uint32_t sy = srcY + row;
+        uint32_t dy = dstY + row;
+        for (uint32_t col = 0; col < width;) {
+            uint32_t sx = srcX + col;
+            uint32_t dx = dstX + col;
+            uint32_t run = std::min({width - col, tileSize - sx % tileSize, tileSize - dx % tileSize});
+
+            const float* srcTile = src.tileData(sx / tileSize, sy / tileSize);
+            if (srcTile || !sameFill) {
+                float* out = dst.mutableTileData(dx / tileSize, dy / tileSize)
+                             + (dy % tileSize) * Image::TILE_STRIDE + (dx % tileSize) * Image::CHANNELS;
+                if (srcTile) {
+                    const float* in = srcTile + (sy % tileSize) * Image::TILE_STRIDE + (sx % tileSize) * Image::CHANNELS;
+                    std::copy(in, in + run * Image::CHANNELS, out);
+                } else {
+                    for (uint32_t i = 0; i < run; ++i) {
+                        std::copy(src.fillColor().begin(), src.fillColor().end(), out + i * Image::CHANNELS);
+                    }
+                }
+            }
+            col += run;
+        }
     }
+}
+
+// Runs point-wise filters back to back over each pixel in a single pass
+void mapPixels(const Image& input, Image& output, const std::vector<Filter*>& filters) {
+    auto map = [&](Image::Pixel pixel) {
+        for (const Filter* filter : filters) {
+            pixel = filter->applyToPixel(pixel);
+        }
+        return pixel;
+    };
+
+    output.reset(input.width(), input.height(), map(input.fillColor()));
+    forEachTile(input, [&](uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1) {
+        const float* src = input.tileData(x0 / Image::TILE_SIZE, y0 / Image::TILE_SIZE);
+        if (!src) {
+            return;
+        }
+        
+        float* dst = output.mutableTileData(x0 / Image::TILE_SIZE, y0 / Image::TILE_SIZE);
+        for (uint32_t y = 0; y < y1 - y0; ++y) {
+            for (uint32_t x = 0; x < x1 - x0; ++x) {
+                size_t offset = y * Image::TILE_STRIDE + x * Image::CHANNELS;
+                Image::Pixel pixel = map({src[offset], src[offset + 1], src[offset + 2], src[offset + 3]});
+                std::copy(pixel.begin(), pixel.end(), dst + offset);
+            }
+        }
+    });
+}
+
+// Applies the steps of a fused stage in order, ping-ponging between two
+// scratch images and writing the last step straight into output
+bool runSteps(const std::vector<std::vector<Filter*>>& steps, const Image& input, Image& output) {
+    const Image* current = &input;
+    Image scratch[2];
     
-    std::array<float, 4> getPixel(uint32_t x, uint32_t y) const {
-        if (x >= width || y >= height) return {0.0f, 0.0f, 0.0f, 0.0f};
-        size_t idx = (y * width + x) * 4;
-        return {data[idx + 0], data[idx + 1], data[idx + 2], data[idx + 3]};
+    for (size_t i = 0; i < steps.size(); ++i) {
+        Image& target = i + 1 == steps.size() ? output : scratch[i % 2];
+        if (steps[i].size() > 1 || steps[i].front()->isPointwise()) {
+            mapPixels(*current, target, steps[i]);
+        } else if (!steps[i].front()->apply(*current, target)) {
+            return false;
+        }
+        current = &target;
     }
+    return true;
+}
+
+// Filter kernels run one invocation per pixel in square workgroups
+constexpr uint32_t FILTER_WORKGROUP_SIZE = 16;
+
+// Pipelines and uniforms are set up through the filters, so GPU chains
+// work on copies
+std::vector<std::unique_ptr<Filter>> cloneEnabledFilters(const FilterChain& chain) {
+    std::vector<std::unique_ptr<Filter>> filters;
+    for (size_t i = 0; i < chain.getFilterCount(); ++i) {
+        const Filter* filter = chain.getFilter(i);
+        if (filter && filter->isEnabled()) {
+            filters.push_back(filter->clone());
+        }
+    }
+    return filters;
+}
+
+// Images cross to the GPU as tightly packed RGBA32Float rows
+void packImage(const Image& image, std::vector<float>& texels) {
+    const size_t rowFloats = size_t(image.width()) * Image::CHANNELS;
+    texels.resize(rowFloats * image.height());
+    forEachTile(image, [&](uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1) {
+        const float* src = image.tileData(x0 / Image::TILE_SIZE, y0 / Image::TILE_SIZE);
+        for (uint32_t y = y0; y < y1; ++y) {
+            float* dst = texels.data() + y * rowFloats + size_t(x0) * Image::CHANNELS;
+            if (src) {
+                const float* row = src + (y - y0) * Image::TILE_STRIDE;
+                std::copy(row, row + size_t(x1 - x0) * Image::CHANNELS, dst);
+            } else {
+                for (uint32_t x = x0; x < x1; ++x, dst += Image::CHANNELS) {
+                    std::copy(image.fillColor().begin(), image.fillColor().end(), dst);
+                }
+            }
+        }
+    });
+}
+
+void unpackImage(const std::vector<float>& texels, uint32_t width, uint32_t height, Image& image) {
+    const size_t rowFloats = size_t(width) * Image::CHANNELS;
+    image.reset(width, height);
+    forEachTile(image, [&](uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1) {
+        float* dst = image.mutableTileData(x0 / Image::TILE_SIZE, y0 / Image::TILE_SIZE);
+        for (uint32_t y = y0; y < y1; ++y) {
+            const float* row = texels.data() + y * rowFloats + size_t(x0) * Image::CHANNELS;
+            std::copy(row, row + size_t(x1 - x0) * Image::CHANNELS, dst + (y - y0) * Image::TILE_STRIDE);
+        }
+    });
+}
+
+// Bilinear resample, sampling the way generatePreview does
+Image resampleImage(const Image& input, const std::array<uint32_t, 2>& size) {
+    Image result(size[0], size[1], input.fillColor());
     
-    std::array<float, 4> sampleBilinear(float x, float y) const {
-        x = std::clamp(x, 0.0f, static_cast<float>(width - 1));
-        y = std::clamp(y, 0.0f, static_cast<float>(height - 1));
-        
-        int x1 = static_cast<int>(x);
-        int y1 = static_cast<int>(y);
-        int x2 = std::min(x1 + 1, static_cast<int>(width - 1));
-        int y2 = std::min(y1 + 1, static_cast<int>(height - 1));
-        
-        float fx = x - x1;
-        float fy = y - y1;
-        
-        auto p11 = getPixel(x1, y1);
-        auto p12 = getPixel(x1, y2);
-        auto p21 = getPixel(x2, y1);
-        auto p22 = getPixel(x2, y2);
-        
-        std::array<float, 4> result;
-        for (int i = 0; i < 4; ++i) {
-            float top = p11[i] * (1 - fx) + p21[i] * fx;
-            float bottom = p12[i] * (1 - fx) + p22[i] * fx;
-            result[i] = top * (1 - fy) + bottom * fy;
+    float scaleX = static_cast<float>(input.width()) / size[0];
+    float scaleY = static_cast<float>(input.height()) / size[1];
+    
+    Core::parallel_for(0, size[1], 16, [&](size_t y) {
+        for (uint32_t x = 0; x < size[0]; ++x) {
+            result.setPixel(x, static_cast<uint32_t>(y), input.sampleBilinear(x * scaleX, y * scaleY));
+        }
+    });
+    
+    return result;
+}
+
+// Next mip level: every pixel averages a 2x2 block, clamped at odd edges
+Image halveImage(const Image& input) {
+    const uint32_t width = std::max(input.width() / 2, 1u);
+    const uint32_t height = std::max(input.height() / 2, 1u);
+    Image result(width, height, input.fillColor());
+    
+    Core::parallel_for(0, result.tileCount(), 1, [&](size_t index) {
+        uint32_t x0 = static_cast<uint32_t>(index % result.tilesX()) * Image::TILE_SIZE;
+        uint32_t y0 = static_cast<uint32_t>(index / result.tilesX()) * Image::TILE_SIZE;
+        uint32_t x1 = std::min(x0 + Image::TILE_SIZE, width);
+        uint32_t y1 = std::min(y0 + Image::TILE_SIZE, height);
+        if (input.isRegionUniform(int64_t(x0) * 2, int64_t(y0) * 2, int64_t(x1) * 2, int64_t(y1) * 2)) {
+            return;
         }
         
-        return result;
-    }
-};
+        for (uint32_t y = y0; y < y1; ++y) {
+            uint32_t sy0 = std::min(y * 2, input.height() - 1);
+            uint32_t sy1 = std::min(y * 2 + 1, input.height() - 1);
+            for (uint32_t x = x0; x < x1; ++x) {
+                uint32_t sx0 = std::min(x * 2, input.width() - 1);
+                uint32_t sx1 = std::min(x * 2 + 1, input.width() - 1);
+                Image::Pixel a = input.getPixel(sx0, sy0);
+                Image::Pixel b = input.getPixel(sx1, sy0);
+                Image::Pixel c = input.getPixel(sx0, sy1);
+                Image::Pixel d = input.getPixel(sx1, sy1);
+                Image::Pixel average;
+                for (int ch = 0; ch < 4; ++ch) {
+                    average[ch] = (a[ch] + b[ch] + c[ch] + d[ch]) * 0.25f;
+                }
+                result.setPixel(x, y, average);
+            }
+        }
+    });
+    
+    return result;
+}
+
+} // namespace
 
 // Filter base implementation
 Filter::Filter(const std::string& name, FilterCategory category) 
@@ -112,24 +264,19 @@ bool Filter::deserialize(const std::vector<uint8_t>& data) {
 }
 
 Image Filter::generatePreview(const Image& input, const std::array<uint32_t, 2>& previewSize) {
-    // Create scaled down version for preview
-    Image preview(previewSize[0], previewSize[1]);
-    
-    float scaleX = static_cast<float>(input.width) / previewSize[0];
-    float scaleY = static_cast<float>(input.height) / previewSize[1];
-    
-    for (uint32_t y = 0; y < previewSize[1]; ++y) {
-        for (uint32_t x = 0; x < previewSize[0]; ++x) {
-            float srcX = x * scaleX;
-            float srcY = y * scaleY;
-            auto pixel = input.sampleBilinear(srcX, srcY);
-            preview.setPixel(x, y, pixel);
-        }
+    // Halve first so bilinear sampling doesn't skip detail, then resample
+    Image source = input;
+    while (source.width() >= previewSize[0] * 2 && source.height() >= previewSize[1] * 2) {
+        source = halveImage(source);
     }
+    Image preview = resampleImage(source, previewSize);
+    
+    // Run a copy whose pixel-sized parameters match the smaller image
+    auto proxy = clone();
+    proxy->scaleSpatialParameters(static_cast<float>(previewSize[0]) / std::max(input.width(), 1u));
     
-    // Apply filter to preview
     Image result(previewSize[0], previewSize[1]);
-    apply(preview, result);
+    proxy->apply(preview, result);
     
     return result;
 }
@@ -163,19 +310,9 @@ bool GaussianBlurFilter::apply(const Image& input, Image& output) {
         return true;
     }
     
-    // Generate Gaussian kernel
-    std::vector<float> kernel;
-    int kernelSize;
-    generateKernel(radius * quality, kernel, kernelSize);
-    
-    // Apply separable Gaussian blur (horizontal then vertical)
-    Image temp(input.width, input.height);
-    
-    // Horizontal pass
-    applyGaussian1D(input, temp, kernel, true);
-    
-    // Vertical pass
-    applyGaussian1D(temp, output, kernel, false);
+    // Separable blur; large sigmas switch to a box cascade whose cost
+    // doesn't grow with the radius
+    Blur::gaussianBlur(input, output, radius * quality);
     
     return true;
 }
@@ -191,6 +328,15 @@ size_t GaussianBlurFilter::getRequiredMemory(const std::array<uint32_t, 2>& imag
     return imageSize[0] * imageSize[1] * 4 * sizeof(float) * 2; // Input + temp buffer
 }
 
+int GaussianBlurFilter::getHaloRadius() const {
+    float radius = getParameterValue<float>("radius");
+    return radius > 0 ? Blur::support(radius * getParameterValue<float>("quality")) : 0;
+}
+
+void GaussianBlurFilter::scaleSpatialParameters(float scale) {
+    setParameter("radius", getParameterValue<float>("radius") * scale);
+}
+
 std::unique_ptr<Filter> GaussianBlurFilter::clone() const {
     auto cloned = std::make_unique<GaussianBlurFilter>();
     cloned->parameters_ = parameters_;
@@ -200,88 +346,61 @@ std::unique_ptr<Filter> GaussianBlurFilter::clone() const {
 }
 
 Rendering::PipelineId GaussianBlurFilter::createFilterPipeline(Rendering::RenderingEngine& engine) {
-    // Would create GPU pipeline
-    return 0;
-}
+    // One invocation per pixel and pass, clamping to the borders like
+    // Blur::gaussianBlur(); the weights are those of Blur::gaussianKernel()
+    Rendering::PipelineId pipeline = engine.createPipeline(R"(
+struct BlurUniforms {
+    direction: vec2<i32>,
+    radius: i32,
+    sigma: f32,
+};
 
-void GaussianBlurFilter::updateFilterUniforms(Rendering::RenderingEngine& engine, 
-                                             Rendering::ResourceId uniformBuffer) {
-    // Would update GPU uniforms
-}
+@group(0) @binding(0) var<uniform> params: BlurUniforms;
+@group(0) @binding(1) var source: texture_2d<f32>;
+@group(0) @binding(2) var target: texture_storage_2d<rgba32float, write>;
 
-void GaussianBlurFilter::generateKernel(float sigma, std::vector<float>& kernel, int& kernelSize) {
-    // Calculate kernel size (should be odd)
-    kernelSize = static_cast<int>(std::ceil(sigma * 3.0f)) * 2 + 1;
-    kernel.resize(kernelSize);
-    
-    float sum = 0.0f;
-    int center = kernelSize / 2;
+@compute @workgroup_size(16, 16)
+fn cs_main(@builtin(global_invocation_id) id: vec3<u32>) {
+    let size = vec2<i32>(textureDimensions(source));
+    let p = vec2<i32>(id.xy);
+    if (p.x >= size.x || p.y >= size.y) {
+        return;
+    }
     
-    // Generate Gaussian weights
-    for (int i = 0; i < kernelSize; ++i) {
-        float x = i - center;
-        kernel[i] = std::exp(-(x * x) / (2 * sigma * sigma));
-        sum += kernel[i];
+    var sum = vec4<f32>(0.0);
+    var total = 0.0;
+    for (var i = -params.radius; i <= params.radius; i = i + 1) {
+        let x = f32(i);
+        let weight = exp(-(x * x) / (2.0 * params.sigma * params.sigma));
+        let q = clamp(p + params.direction * i, vec2<i32>(0), size - vec2<i32>(1));
+        sum = sum + textureLoad(source, q, 0) * weight;
+        total = total + weight;
     }
     
-    // Normalize kernel
-    for (float& weight : kernel) {
-        weight /= sum;
+    textureStore(target, p, sum / total);
+}
+)");
+    
+    if (pipeline == 0) {
+        std::cerr << "[GaussianBlurFilter] Failed to create blur pipeline; blurs run on the CPU" << std::endl;
     }
+    return pipeline;
 }
 
-void GaussianBlurFilter::applyGaussian1D(const Image& input, Image& output, 
-                                        const std::vector<float>& kernel, bool horizontal) {
-    int kernelSize = static_cast<int>(kernel.size());
-    int center = kernelSize / 2;
-    
-    output.width = input.width;
-    output.height = input.height;
-    output.data.resize(input.data.size());
+void GaussianBlurFilter::updateFilterUniforms(Rendering::RenderingEngine& engine, 
+                                             Rendering::ResourceId uniformBuffer, uint32_t pass) {
+    struct BlurUniforms {
+        std::array<int32_t, 2> direction;
+        int32_t radius;
+        float sigma;
+    };
     
-    if (horizontal) {
-        // Horizontal convolution
-        for (uint32_t y = 0; y < input.height; ++y) {
-            for (uint32_t x = 0; x < input.width; ++x) {
-                std::array<float, 4> sum = {0, 0, 0, 0};
-                
-                for (int k = 0; k < kernelSize; ++k) {
-                    int sampleX = static_cast<int>(x) + k - center;
-                    sampleX = std::clamp(sampleX, 0, static_cast<int>(input.width - 1));
-                    
-                    auto pixel = input.getPixel(sampleX, y);
-                    float weight = kernel[k];
-                    
-                    for (int c = 0; c < 4; ++c) {
-                        sum[c] += pixel[c] * weight;
-                    }
-                }
-                
-                output.setPixel(x, y, sum);
-            }
-        }
-    } else {
-        // Vertical convolution
-        for (uint32_t y = 0; y < input.height; ++y) {
-            for (uint32_t x = 0; x < input.width; ++x) {
-                std::array<float, 4> sum = {0, 0, 0, 0};
-                
-                for (int k = 0; k < kernelSize; ++k) {
-                    int sampleY = static_cast<int>(y) + k - center;
-                    sampleY = std::clamp(sampleY, 0, static_cast<int>(input.height - 1));
-                    
-                    auto pixel = input.getPixel(x, sampleY);
-                    float weight = kernel[k];
-                    
-                    for (int c = 0; c < 4; ++c) {
-                        sum[c] += pixel[c] * weight;
-                    }
-                }
-                
-                output.setPixel(x, y, sum);
-            }
-        }
-    }
+    // A radius of 0 is a plain copy
+    float sigma = std::max(getParameterValue<float>("radius"), 0.0f) * getParameterValue<float>("quality");
+    BlurUniforms uniforms{{pass == 0 ? 1 : 0, pass == 0 ? 0 : 1},
+                          sigma > 0.0f ? static_cast<int32_t>(std::ceil(sigma * 3.0f)) : 0,
+                          sigma > 0.0f ? sigma : 1.0f};
+    engine.update_buffer(uniformBuffer, 0, sizeof(uniforms), &uniforms);
 }
 
 // UnsharpMaskFilter implementation
@@ -314,35 +433,39 @@ bool UnsharpMaskFilter::apply(const Image& input, Image& output) {
     GaussianBlurFilter blur;
     blur.setParameter("radius", radius);
     
-    Image blurred(input.width, input.height);
+    Image blurred;
     blur.apply(input, blurred);
     
     // Apply unsharp mask formula: original + amount * (original - blurred)
-    output.width = input.width;
-    output.height = input.height;
-    output.data.resize(input.data.size());
-    
-    for (uint32_t y = 0; y < input.height; ++y) {
-        for (uint32_t x = 0; x < input.width; ++x) {
-            auto original = input.getPixel(x, y);
-            auto blur_pixel = blurred.getPixel(x, y);
-            
-            std::array<float, 4> result;
-            for (int c = 0; c < 3; ++c) { // Don't modify alpha
-                float diff = original[c] - blur_pixel[c];
+    output.reset(input.width(), input.height(), input.fillColor());
+    
+    forEachTile(input, [&](uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1) {
+        if (input.isRegionUniform(x0, y0, x1, y1) && blurred.isRegionUniform(x0, y0, x1, y1)) {
+            return;
+        }
+        
+        for (uint32_t y = y0; y < y1; ++y) {
+            for (uint32_t x = x0; x < x1; ++x) {
+                auto original = input.getPixel(x, y);
+                auto blur_pixel = blurred.getPixel(x, y);
                 
-                // Apply threshold
-                if (std::abs(diff) > threshold) {
-                    result[c] = std::clamp(original[c] + amount * diff, 0.0f, 1.0f);
-                } else {
-                    result[c] = original[c];
+                std::array<float, 4> result;
+                for (int c = 0; c < 3; ++c) { // Don't modify alpha
+                    float diff = original[c] - blur_pixel[c];
+                
+                    // Apply threshold
+                    if (std::abs(diff) > threshold) {
+                        result[c] = std::clamp(original[c] + amount * diff, 0.0f, 1.0f);
+                    } else {
+                        result[c] = original[c];
+                    }
                 }
+                result[3] = original[3]; // Preserve alpha
+                
+                output.setPixel(x, y, result);
             }
-            result[3] = original[3]; // Preserve alpha
-            
-            output.setPixel(x, y, result);
         }
-    }
+    });
     
     return true;
 }
@@ -357,6 +480,14 @@ size_t UnsharpMaskFilter::getRequiredMemory(const std::array<uint32_t, 2>& image
     return imageSize[0] * imageSize[1] * 4 * sizeof(float) * 2; // Input + blurred
 }
 
+int UnsharpMaskFilter::getHaloRadius() const {
+    return Blur::support(getParameterValue<float>("radius"));
+}
+
+void UnsharpMaskFilter::scaleSpatialParameters(float scale) {
+    setParameter("radius", getParameterValue<float>("radius") * scale);
+}
+
 std::unique_ptr<Filter> UnsharpMaskFilter::clone() const {
     auto cloned = std::make_unique<UnsharpMaskFilter>();
     cloned->parameters_ = parameters_;
@@ -370,7 +501,7 @@ Rendering::PipelineId UnsharpMaskFilter::createFilterPipeline(Rendering::Renderi
 }
 
 void UnsharpMaskFilter::updateFilterUniforms(Rendering::RenderingEngine& engine, 
-                                            Rendering::ResourceId uniformBuffer) {
+                                            Rendering::ResourceId uniformBuffer, uint32_t pass) {
 }
 
 // EdgeDetectionFilter implementation
@@ -393,21 +524,14 @@ EdgeDetectionFilter::EdgeDetectionFilter() : Filter("EdgeDetection", FilterCateg
 bool EdgeDetectionFilter::apply(const Image& input, Image& output) {
     EdgeMethod method = static_cast<EdgeMethod>(getParameterValue<int>("method"));
     
-    output.width = input.width;
-    output.height = input.height;
-    output.data.resize(input.data.size());
-    
     switch (method) {
-        case EdgeMethod::Sobel:
-            applySobel(input, output);
-            break;
         case EdgeMethod::Canny: {
             float threshold = getParameterValue<float>("threshold");
-            applyCanny(input, output, threshold * 0.5f, threshold);
+            Edges::canny(input, output, threshold * 0.5f, threshold);
             break;
         }
         default:
-            applySobel(input, output); // Default to Sobel
+            Edges::sobel(input, output); // Default to Sobel
             break;
     }
     
@@ -424,6 +548,12 @@ size_t EdgeDetectionFilter::getRequiredMemory(const std::array<uint32_t, 2>& ima
     return imageSize[0] * imageSize[1] * 4 * sizeof(float) * 2;
 }
 
+int EdgeDetectionFilter::getHaloRadius() const {
+    // Hysteresis follows a Canny edge as far as it goes
+    EdgeMethod method = static_cast<EdgeMethod>(getParameterValue<int>("method"));
+    return method == EdgeMethod::Canny ? -1 : 1;
+}
+
 std::unique_ptr<Filter> EdgeDetectionFilter::clone() const {
     auto cloned = std::make_unique<EdgeDetectionFilter>();
     cloned->parameters_ = parameters_;
@@ -437,70 +567,22 @@ Rendering::PipelineId EdgeDetectionFilter::createFilterPipeline(Rendering::Rende
 }
 
 void EdgeDetectionFilter::updateFilterUniforms(Rendering::RenderingEngine& engine, 
-                                              Rendering::ResourceId uniformBuffer) {
+                                              Rendering::ResourceId uniformBuffer, uint32_t pass) {
 }
 
-void EdgeDetectionFilter::applySobel(const Image& input, Image& output) {
-    // Sobel operators
-    float sobelX[3][3] = {{-1, 0, 1}, {-2, 0, 2}, {-1, 0, 1}};
-    float sobelY[3][3] = {{-1, -2, -1}, {0, 0, 0}, {1, 2, 1}};
-    
-    for (uint32_t y = 1; y < input.height - 1; ++y) {
-        for (uint32_t x = 1; x < input.width - 1; ++x) {
-            float gx = 0, gy = 0;
-            
-            // Apply Sobel operators
-            for (int dy = -1; dy <= 1; ++dy) {
-                for (int dx = -1; dx <= 1; ++dx) {
-                    auto pixel = input.getPixel(x + dx, y + dy);
-                    float intensity = (pixel[0] + pixel[1] + pixel[2]) / 3.0f; // Convert to grayscale
-                    
-                    gx += intensity * sobelX[dy + 1][dx + 1];
-                    gy += intensity * sobelY[dy + 1][dx + 1];
-                }
-            }
-            
-            float magnitude = std::sqrt(gx * gx + gy * gy);
-            magnitude = std::clamp(magnitude, 0.0f, 1.0f);
-            
-            output.setPixel(x, y, {magnitude, magnitude, magnitude, 1.0f});
-        }
-    }
+// FilterChain implementation
+void FilterChain::addFilter(std::unique_ptr<Filter> filter) {
+    filters_.push_back(std::move(filter));
 }
 
-void EdgeDetectionFilter::applyCanny(const Image& input, Image& output, 
-                                    float lowThreshold, float highThreshold) {
-    // Simplified Canny edge detection
-    // 1. Apply Gaussian blur
-    GaussianBlurFilter blur;
-    blur.setParameter("radius", 1.0f);
-    
-    Image smoothed(input.width, input.height);
-    blur.apply(input, smoothed);
-    
-    // 2. Apply Sobel for gradient calculation
-    applySobel(smoothed, output);
-    
-    // 3. Apply thresholding (simplified)
-    for (uint32_t y = 0; y < output.height; ++y) {
-        for (uint32_t x = 0; x < output.width; ++x) {
-            auto pixel = output.getPixel(x, y);
-            float intensity = pixel[0];
-            
-            if (intensity > highThreshold) {
-                output.setPixel(x, y, {1.0f, 1.0f, 1.0f, 1.0f}); // Strong edge
-            } else if (intensity > lowThreshold) {
-                output.setPixel(x, y, {0.5f, 0.5f, 0.5f, 1.0f}); // Weak edge
-            } else {
-                output.setPixel(x, y, {0.0f, 0.0f, 0.0f, 1.0f}); // No edge
-            }
+FilterChain FilterChain::clone() const {
+    FilterChain copy;
+    for (const auto& filter : filters_) {
+        if (filter) {
+            copy.addFilter(filter->clone());
         }
     }
-}
-
-// FilterChain implementation
-void FilterChain::addFilter(std::unique_ptr<Filter> filter) {
-    filters_.push_back(std::move(filter));
+    return copy;
 }
 
 void FilterChain::insertFilter(size_t index, std::unique_ptr<Filter> filter) {
@@ -553,47 +635,133 @@ const Filter* FilterChain::getFilter(size_t index) const {
     return filters_[index].get();
 }
 
-bool FilterChain::apply(const Image& input, Image& output) {
-    if (filters_.empty()) {
+bool FilterChain::apply(const Image& input, Image& output, const std::atomic<bool>* cancel) const {
+    QCS_TRACE_SCOPE("raster.filter_chain");
+    auto cancelled = [cancel] { return cancel && cancel->load(std::memory_order_relaxed); };
+    
+    std::vector<FusedStage> stages = planStages();
+    if (stages.empty()) {
         output = input;
         return true;
     }
     
-    Image temp1 = input;
-    Image temp2(input.width, input.height);
+    // Copies share tiles, so this snapshot is cheap and lets output alias input
+    Image source = input;
+    Image intermediate;
+    
+    for (size_t i = 0; i < stages.size(); ++i) {
+        Image& target = i + 1 == stages.size() ? output : intermediate;
+        if (cancelled()) {
+            return false;
+        }
+        
+        bool success = stages[i].tiled ? applyTiledStage(stages[i], source, target, cancel)
+                                       : stages[i].steps.front().front()->apply(source, target);
+        if (!success) {
+            return false;
+        }
+        
+        if (&target == &intermediate) {
+            source = intermediate;
+        }
+    }
+    
+    return true;
+}
+
+std::vector<FilterChain::FusedStage> FilterChain::planStages() const {
+    std::vector<FusedStage> stages;
     
-    for (size_t i = 0; i < filters_.size(); ++i) {
-        if (!filters_[i] || !filters_[i]->isEnabled()) {
+    for (const auto& filter : filters_) {
+        if (!filter || !filter->isEnabled()) {
             continue;
         }
         
-        bool success = false;
-        if (i % 2 == 0) {
-            success = filters_[i]->apply(temp1, temp2);
-        } else {
-            success = filters_[i]->apply(temp2, temp1);
+        int halo = filter->getHaloRadius();
+        if (halo < 0 || halo > MAX_FUSED_HALO) {
+            // Needs the whole image, or so much of it that tiling doesn't pay
+            FusedStage stage;
+            stage.steps.push_back({filter.get()});
+            stage.tiled = false;
+            stages.push_back(std::move(stage));
+            continue;
         }
         
-        if (!success) {
-            return false;
+        if (stages.empty() || !stages.back().tiled || stages.back().halo + halo > MAX_FUSED_HALO) {
+            stages.emplace_back();
         }
+        
+        FusedStage& stage = stages.back();
+        if (filter->isPointwise() && !stage.steps.empty() && stage.steps.back().front()->isPointwise()) {
+            stage.steps.back().push_back(filter.get());
+        } else {
+            stage.steps.push_back({filter.get()});
+        }
+        stage.halo += halo;
     }
     
-    // Copy final result to output
-    if ((filters_.size() - 1) % 2 == 0) {
-        output = temp2;
-    } else {
-        output = temp1;
+    return stages;
+}
+
+bool FilterChain::applyTiledStage(const FusedStage& stage, const Image& input, Image& output,
+                                  const std::atomic<bool>* cancel) const {
+    // Tiles whose halo is uniform come out as the stage applied to the fill,
+    // found by running it on a single pixel
+    Image probe(1, 1, input.fillColor());
+    Image probed;
+    if (!runSteps(stage.steps, probe, probed)) {
+        return false;
     }
+    output.reset(input.width(), input.height(), probed.fillColor());
+    
+    const int64_t halo = stage.halo;
+    std::atomic<bool> success{true};
+    
+    // Each task owns one output tile, so only a few crops are alive at once
+    Core::parallel_for(0, input.tileCount(), 1, [&](size_t index) {
+        uint32_t tileX = static_cast<uint32_t>(index % input.tilesX());
+        uint32_t tileY = static_cast<uint32_t>(index / input.tilesX());
+        uint32_t x0 = tileX * Image::TILE_SIZE;
+        uint32_t y0 = tileY * Image::TILE_SIZE;
+        uint32_t x1 = std::min(x0 + Image::TILE_SIZE, input.width());
+        uint32_t y1 = std::min(y0 + Image::TILE_SIZE, input.height());
+        
+        if (input.isRegionUniform(x0 - halo, y0 - halo, x1 + halo, y1 + halo) ||
+            !success.load(std::memory_order_relaxed)) {
+            return;
+        }
+        if (cancel && cancel->load(std::memory_order_relaxed)) {
+            success.store(false, std::memory_order_relaxed);
+            return;
+        }
+        
+        // The crop's own borders are at least one halo away from the tile,
+        // except where they are the image's borders too
+        uint32_t cropX0 = static_cast<uint32_t>(std::max<int64_t>(x0 - halo, 0));
+        uint32_t cropY0 = static_cast<uint32_t>(std::max<int64_t>(y0 - halo, 0));
+        uint32_t cropX1 = static_cast<uint32_t>(std::min<int64_t>(x1 + halo, input.width()));
+        uint32_t cropY1 = static_cast<uint32_t>(std::min<int64_t>(y1 + halo, input.height()));
+        
+        Image crop(cropX1 - cropX0, cropY1 - cropY0, input.fillColor());
+        copyRegion(input, cropX0, cropY0, crop.width(), crop.height(), crop, 0, 0);
+        
+        Image result;
+        if (!runSteps(stage.steps, crop, result)) {
+            success.store(false, std::memory_order_relaxed);
+            return;
+        }
+        copyRegion(result, x0 - cropX0, y0 - cropY0, x1 - x0, y1 - y0, output, x0, y0);
+    });
     
-    return true;
+    return success.load();
 }
 
 bool FilterChain::applyGPU(Rendering::ResourceId inputTexture, 
                           Rendering::ResourceId outputTexture,
                           const std::array<uint32_t, 2>& size) {
-    // GPU filter chain would pipeline multiple filters
-    return false; // Fall back to CPU for now
+    // Pipelines and intermediate textures belong to the processor; chains
+    // run on the GPU through FilterProcessor::applyFilterChainGPU()
+    return false;
 }
 
 float FilterChain::getTotalComplexityScore() const {
@@ -607,11 +775,25 @@ float FilterChain::getTotalComplexityScore() const {
 }
 
 size_t FilterChain::getTotalRequiredMemory(const std::array<uint32_t, 2>& imageSize) const {
+    const size_t imageBytes = size_t(imageSize[0]) * imageSize[1] * 4 * sizeof(float);
     size_t maxMemory = 0;
-    for (const auto& filter : filters_) {
-        if (filter && filter->isEnabled()) {
-            maxMemory = std::max(maxMemory, filter->getRequiredMemory(imageSize));
+    
+    for (const auto& stage : planStages()) {
+        if (!stage.tiled) {
+            // The filter's own needs plus the intermediate it writes
+            maxMemory = std::max(maxMemory, stage.steps.front().front()->getRequiredMemory(imageSize) + imageBytes);
+            continue;
         }
+        
+        // Per worker: a crop, the two scratch images its steps ping-pong
+        // through and the result, each at most the tile plus halo
+        size_t cropSide = Image::TILE_SIZE + 2 * size_t(stage.halo);
+        std::array<uint32_t, 2> cropSize = {static_cast<uint32_t>(cropSide), static_cast<uint32_t>(cropSide)};
+        size_t stepMemory = 0;
+        for (const auto& step : stage.steps) {
+            stepMemory = std::max(stepMemory, step.front()->getRequiredMemory(cropSize));
+        }
+        maxMemory = std::max(maxMemory, std::max(stepMemory, cropSide * cropSide * 4 * sizeof(float) * 4));
     }
     return maxMemory;
 }
@@ -650,21 +832,49 @@ void FilterChain::optimizeFilterOrder() {
 }
 
 void FilterChain::mergeCompatibleFilters() {
-    // Would implement filter merging optimization
-    // For example, merge multiple blur filters into one
+    // Two Gaussian blurs in a row are one blur whose variance is their sum
+    auto sigmaOf = [](const Filter& blur) {
+        auto radius = blur.getParameter("radius");
+        auto quality = blur.getParameter("quality");
+        if (!std::holds_alternative<float>(radius) || !std::holds_alternative<float>(quality)) {
+            return -1.0f;
+        }
+        return std::get<float>(radius) * std::get<float>(quality);
+    };
+    
+    for (size_t i = 0; i + 1 < filters_.size();) {
+        auto* first = dynamic_cast<GaussianBlurFilter*>(filters_[i].get());
+        auto* second = dynamic_cast<GaussianBlurFilter*>(filters_[i + 1].get());
+        float firstSigma = first ? sigmaOf(*first) : -1.0f;
+        float secondSigma = second ? sigmaOf(*second) : -1.0f;
+        
+        if (firstSigma <= 0 || secondSigma <= 0 ||
+            first->getOpacity() < 1.0f || second->getOpacity() < 1.0f) {
+            ++i;
+            continue;
+        }
+        
+        first->setParameter("radius", std::sqrt(firstSigma * firstSigma + secondSigma * secondSigma));
+        first->setParameter("quality", 1.0f);
+        filters_.erase(filters_.begin() + i + 1);
+    }
 }
 
 // FilterProcessor implementation
-FilterProcessor::FilterProcessor(Rendering::RenderingEngine& engine) : engine_(engine) {
-    maxConcurrency_ = std::thread::hardware_concurrency();
-    if (maxConcurrency_ == 0) {
-        maxConcurrency_ = 4; // Default to 4 threads
-    }
+FilterProcessor::FilterProcessor(Rendering::RenderingEngine& engine)
+    : engine_(engine)
+    , previewRefines_(std::make_unique<Core::TaskGroup>()) {
+    // Work runs on the kernel's shared scheduler; this only caps how much of it a batch may use
+    auto scheduler = Core::KernelManager::instance().get_service<Core::TaskScheduler>();
+    maxConcurrency_ = scheduler ? scheduler->concurrency() : 1;
+    registerTelemetry();
     
     std::cout << "[FilterProcessor] Initialized with " << maxConcurrency_ << " threads" << std::endl;
 }
 
 FilterProcessor::~FilterProcessor() {
+    // Previews run without initialize(), so shutdown() alone may skip this
+    cancelPreviewRefines();
     shutdown();
 }
 
@@ -676,7 +886,9 @@ FilterProcessor::FilterProcessor(FilterProcessor&& other) noexcept
     , memoryBudget_(other.memoryBudget_)
     , preferGPU_(other.preferGPU_)
     , maxConcurrency_(other.maxConcurrency_)
+    , previewRefines_(std::make_unique<Core::TaskGroup>())
     , stats_(other.stats_) {
+    registerTelemetry();
 }
 
 FilterProcessor& FilterProcessor::operator=(FilterProcessor&& other) noexcept {
@@ -760,6 +972,7 @@ bool FilterProcessor::applyFilter(Filter* filter, const Image& input, Image& out
         return false;
     }
     
+    Rendering::ProfileScope profileScope(engine_.profiler(), filter->getName(), "filters");
     auto start_time = std::chrono::high_resolution_clock::now();
     
     bool success = false;
@@ -779,7 +992,7 @@ bool FilterProcessor::applyFilter(Filter* filter, const Image& input, Image& out
         
         std::lock_guard<std::mutex> lock(statsMutex_);
         stats_.filtersApplied++;
-        stats_.pixelsProcessed += input.width * input.height;
+        stats_.pixelsProcessed += static_cast<uint64_t>(input.width()) * input.height();
         stats_.processingTime += duration;
     }
     
@@ -794,7 +1007,8 @@ bool FilterProcessor::applyFilterGPU(Filter* filter,
         return false;
     }
     
-    return filter->applyGPU(inputTexture, outputTexture, size);
+    return applyFilterInternal(filter, inputTexture, outputTexture, size) ||
+           filter->applyGPU(inputTexture, outputTexture, size);
 }
 
 bool FilterProcessor::applyFilterChain(const FilterChain& chain, const Image& input, Image& output) {
@@ -812,7 +1026,7 @@ bool FilterProcessor::applyFilterChain(const FilterChain& chain, const Image& in
         
         std::lock_guard<std::mutex> lock(statsMutex_);
         stats_.chainsApplied++;
-        stats_.pixelsProcessed += input.width * input.height;
+        stats_.pixelsProcessed += static_cast<uint64_t>(input.width()) * input.height();
         stats_.processingTime += duration;
         stats_.averageComplexityScore = chain.getTotalComplexityScore();
     }
@@ -824,64 +1038,284 @@ bool FilterProcessor::applyFilterChainGPU(const FilterChain& chain,
                                         Rendering::ResourceId inputTexture,
                                         Rendering::ResourceId outputTexture,
                                         const std::array<uint32_t, 2>& size) {
-    return chain.applyGPU(inputTexture, outputTexture, size);
+    if (!initialized_ || inputTexture == 0 || outputTexture == 0) {
+        return false;
+    }
+    
+    Rendering::ProfileScope profileScope(engine_.profiler(), "filter_chain_gpu", "filters");
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    std::vector<std::unique_ptr<Filter>> filters = cloneEnabledFilters(chain);
+    std::vector<ChainRun> runs = planChainRuns(filters);
+    
+    constexpr auto format = Rendering::TextureDescriptor::Format::RGBA32Float;
+    Rendering::ResourceId scratch[2] = {0, 0};
+    Rendering::ResourceId current = inputTexture;
+    size_t passes = 0;
+    bool success = true;
+    
+    for (size_t r = 0; r < runs.size() && success; ++r) {
+        const ChainRun& run = runs[r];
+        const size_t steps = run.gpu ? run.end - run.begin : 1;
+        
+        for (size_t step = 0; step < steps && success; ++step) {
+            // The last pass writes the output; the others alternate scratch textures
+            Rendering::ResourceId target = outputTexture;
+            if (r + 1 < runs.size() || step + 1 < steps) {
+                Rendering::ResourceId& slot = scratch[passes++ % 2];
+                if (slot == 0) {
+                    slot = acquirePooledTexture(size, format);
+                }
+                target = slot;
+            }
+            if (target == 0) {
+                success = false;
+                break;
+            }
+            
+            if (run.gpu) {
+                success = applyFilterInternal(filters[run.begin + step].get(), current, target, size);
+            } else {
+                FilterChain cpuChain;
+                for (size_t i = run.begin; i < run.end; ++i) {
+                    cpuChain.addFilter(std::move(filters[i]));
+                }
+                success = applyChainOnCPU(cpuChain, current, target, size);
+            }
+            current = target;
+        }
+    }
+    
+    // Later dispatches reading these are recorded after ours, so the
+    // textures can go back to the pool before the frame is submitted
+    for (Rendering::ResourceId texture : scratch) {
+        if (texture != 0) {
+            releasePooledTexture(texture);
+        }
+    }
+    
+    if (success) {
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        size_t poolMemory = getMemoryUsage();
+        
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.chainsApplied++;
+        stats_.pixelsProcessed += static_cast<uint64_t>(size[0]) * size[1];
+        stats_.processingTime += duration;
+        stats_.gpuMemoryUsed = poolMemory;
+        stats_.averageComplexityScore = chain.getTotalComplexityScore();
+    }
+    
+    return success;
 }
 
-void FilterProcessor::processBatch(const std::vector<BatchJob>& jobs,
-                                 std::function<void(size_t, bool, const std::string&)> progressCallback) {
-    if (!initialized_) {
-        return;
+std::vector<FilterProcessor::ChainRun> FilterProcessor::planChainRuns(const FilterChain& chain) {
+    return planChainRuns(cloneEnabledFilters(chain));
+}
+
+std::vector<FilterProcessor::ChainRun> FilterProcessor::planChainRuns(
+    const std::vector<std::unique_ptr<Filter>>& filters) {
+    // Consecutive filters with a kernel stay on the device; consecutive ones
+    // without share a single round trip through the CPU. An empty chain is
+    // one empty CPU run, i.e. a copy.
+    std::vector<ChainRun> runs;
+    for (size_t i = 0; i < filters.size(); ++i) {
+        bool gpu = getFilterPipeline(filters[i].get()) != 0;
+        if (!runs.empty() && runs.back().gpu == gpu) {
+            runs.back().end = i + 1;
+        } else {
+            runs.push_back({i, i + 1, gpu});
+        }
+    }
+    if (runs.empty()) {
+        runs.push_back({0, 0, false});
     }
+    return runs;
+}
+
+Rendering::PipelineId FilterProcessor::getFilterPipeline(Filter* filter) {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
     
-    std::cout << "[FilterProcessor] Processing batch of " << jobs.size() << " jobs" << std::endl;
+    auto it = filterPipelines_.find(filter->getName());
+    if (it != filterPipelines_.end()) {
+        return it->second;
+    }
     
-    // Process jobs in parallel
-    const size_t numThreads = std::min(maxConcurrency_, static_cast<uint32_t>(jobs.size()));
-    std::vector<std::future<void>> futures;
+    // 0 is cached as well, so filters without a kernel are asked only once
+    Rendering::PipelineId pipeline = filter->createFilterPipeline(engine_);
+    filterPipelines_[filter->getName()] = pipeline;
+    return pipeline;
+}
+
+Rendering::ResourceId FilterProcessor::acquireStageUniformBuffer() {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
     
-    for (size_t threadIndex = 0; threadIndex < numThreads; ++threadIndex) {
-        futures.push_back(std::async(std::launch::async, [&, threadIndex]() {
-            for (size_t jobIndex = threadIndex; jobIndex < jobs.size(); jobIndex += numThreads) {
-                const auto& job = jobs[jobIndex];
-                
-                try {
-                    // Load input image (simplified)
-                    Image input(1024, 1024); // Dummy size
-                    
-                    // Apply filter chain
-                    Image output(input.width, input.height);
-                    bool success = applyFilterChain(job.filterChain, input, output);
-                    
-                    if (progressCallback) {
-                        progressCallback(jobIndex, success, success ? "" : "Filter application failed");
-                    }
-                    
-                } catch (const std::exception& e) {
-                    if (progressCallback) {
-                        progressCallback(jobIndex, false, e.what());
-                    }
-                }
+    uint64_t frame = engine_.profiler().frame_number();
+    if (frame != stageUniformFrame_) {
+        stageUniformFrame_ = frame;
+        stageUniformBuffersUsed_ = 0;
+    }
+    
+    if (stageUniformBuffersUsed_ == stageUniformBuffers_.size()) {
+        Rendering::ResourceId buffer = engine_.create_buffer(
+            1024, // 1KB for filter parameters
+            Rendering::BufferUsage::Uniform | Rendering::BufferUsage::Dynamic
+        );
+        if (buffer == 0) {
+            return 0;
+        }
+        stageUniformBuffers_.push_back(buffer);
+    }
+    
+    return stageUniformBuffers_[stageUniformBuffersUsed_++];
+}
+
+Rendering::ResourceId FilterProcessor::acquirePooledTexture(const std::array<uint32_t, 2>& size,
+                                                          Rendering::TextureDescriptor::Format format) {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    
+    for (auto& entry : texturePool_) {
+        if (!entry.inUse && entry.size == size && entry.format == format) {
+            entry.inUse = true;
+            return entry.textureId;
+        }
+    }
+    
+    using Usage = Rendering::TextureDescriptor::Usage;
+    Rendering::TextureDescriptor desc;
+    desc.width = size[0];
+    desc.height = size[1];
+    desc.format = format;
+    desc.usage = static_cast<uint32_t>(Usage::StorageBinding) | static_cast<uint32_t>(Usage::TextureBinding) |
+                 static_cast<uint32_t>(Usage::CopySrc) | static_cast<uint32_t>(Usage::CopyDst);
+    
+    Rendering::ResourceId texture = engine_.create_texture(desc);
+    if (texture != 0) {
+        size_t memorySize = static_cast<size_t>(size[0]) * size[1] * Rendering::bytes_per_pixel(format);
+        texturePool_.push_back({texture, size, format, memorySize, true});
+    }
+    return texture;
+}
+
+void FilterProcessor::releasePooledTexture(Rendering::ResourceId textureId) {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    
+    for (auto& entry : texturePool_) {
+        if (entry.textureId == textureId) {
+            entry.inUse = false;
+            return;
+        }
+    }
+}
+
+bool FilterProcessor::applyFilterInternal(Filter* filter,
+                                        Rendering::ResourceId inputTexture,
+                                        Rendering::ResourceId outputTexture,
+                                        const std::array<uint32_t, 2>& size) {
+    Rendering::PipelineId pipeline = getFilterPipeline(filter);
+    if (pipeline == 0) {
+        return false;
+    }
+    
+    // Passes before the last alternate through pooled textures; like the
+    // chain's, they go back to the pool once recorded
+    const uint32_t passes = std::max(filter->getGPUPassCount(), 1u);
+    Rendering::ResourceId scratch[2] = {0, 0};
+    Rendering::ResourceId current = inputTexture;
+    bool success = true;
+    
+    for (uint32_t pass = 0; pass < passes && success; ++pass) {
+        Rendering::ResourceId target = outputTexture;
+        if (pass + 1 < passes) {
+            Rendering::ResourceId& slot = scratch[pass % 2];
+            if (slot == 0) {
+                slot = acquirePooledTexture(size, Rendering::TextureDescriptor::Format::RGBA32Float);
             }
-        }));
+            target = slot;
+        }
+        
+        Rendering::ResourceId uniformBuffer = target != 0 ? acquireStageUniformBuffer() : 0;
+        if (uniformBuffer == 0) {
+            success = false;
+            break;
+        }
+        filter->updateFilterUniforms(engine_, uniformBuffer, pass);
+        
+        Rendering::ComputeDispatch dispatch;
+        dispatch.pipelineId = pipeline;
+        dispatch.workgroupsX = (size[0] + FILTER_WORKGROUP_SIZE - 1) / FILTER_WORKGROUP_SIZE;
+        dispatch.workgroupsY = (size[1] + FILTER_WORKGROUP_SIZE - 1) / FILTER_WORKGROUP_SIZE;
+        dispatch.buffers = {uniformBuffer};
+        dispatch.textures = {current, target};
+        engine_.submit_compute(dispatch);
+        current = target;
     }
     
-    // Wait for all threads to complete
-    for (auto& future : futures) {
-        future.wait();
+    for (Rendering::ResourceId texture : scratch) {
+        if (texture != 0) {
+            releasePooledTexture(texture);
+        }
     }
+    return success;
+}
+
+bool FilterProcessor::applyChainOnCPU(const FilterChain& chain,
+                                    Rendering::ResourceId inputTexture,
+                                    Rendering::ResourceId outputTexture,
+                                    const std::array<uint32_t, 2>& size) {
+    // The input may be the output of GPU stages recorded this frame
+    engine_.flush();
+    
+    std::vector<float> texels(static_cast<size_t>(size[0]) * size[1] * Image::CHANNELS);
+    if (!engine_.read_texture(inputTexture, texels.data())) {
+        return false;
+    }
+    
+    Image input;
+    unpackImage(texels, size[0], size[1], input);
     
-    std::cout << "[FilterProcessor] Batch processing complete" << std::endl;
+    Image output;
+    if (chain.getFilterCount() == 0) {
+        output = input;
+    } else if (!chain.apply(input, output) || output.getSize() != size) {
+        return false;
+    }
+    
+    packImage(output, texels);
+    engine_.write_texture(outputTexture, texels.data());
+    return true;
 }
 
 void FilterProcessor::beginPreview() {
     previewActive_ = true;
     
-    // Create preview texture
-    previewTexture_ = engine_.create_texture_2d(
-        previewSize_[0], previewSize_[1], 
-        Rendering::TextureFormat::RGBA8Unorm,
-        Rendering::TextureUsage::RenderTarget | Rendering::TextureUsage::Sampled
-    );
+    std::lock_guard<std::mutex> lock(previewMutex_);
+    previewImage_ = Image();
+    previewScale_ = 1.0f;
+    previewRefined_ = false;
+    ++previewVersion_;
+}
+
+void FilterProcessor::setPreviewSource(const Image& source) {
+    if (previewCancel_) {
+        previewCancel_->store(true);
+    }
+    
+    previewSource_ = source;
+    previewPyramid_.clear();
+    
+    // Down to a level smaller than any preview asks for; a third of the
+    // source's memory at most
+    const Image* level = &previewSource_;
+    while (level->width() > 64 && level->height() > 64) {
+        previewPyramid_.push_back(halveImage(*level));
+        level = &previewPyramid_.back();
+    }
+    
+    if (previewChain_) {
+        updatePreviewChain(*previewChain_);
+    }
 }
 
 void FilterProcessor::updatePreviewFilter(Filter* filter) {
@@ -900,13 +1334,128 @@ void FilterProcessor::updatePreviewChain(const FilterChain& chain) {
         return;
     }
     
-    previewChain_ = std::make_unique<FilterChain>(chain);
+    // Whatever refine is running is for older parameters
+    if (previewCancel_) {
+        previewCancel_->store(true);
+    }
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    previewCancel_ = cancel;
+    
+    // Copy first: the caller may be passing our own previewChain_
+    auto refineChain = std::make_shared<FilterChain>(chain.clone());
+    previewChain_ = std::make_unique<FilterChain>(chain.clone());
+    
+    Image source = previewSource_.empty() ? Image(previewSize_[0], previewSize_[1]) : previewSource_;
+    
+    // The smallest pyramid level that still fills the preview at its fitted size
+    float fit = std::min({1.0f, static_cast<float>(previewSize_[0]) / source.width(),
+                          static_cast<float>(previewSize_[1]) / source.height()});
+    const Image* proxySource = &source;
+    for (const Image& level : previewPyramid_) {
+        if (level.width() < source.width() * fit || level.height() < source.height() * fit) {
+            break;
+        }
+        proxySource = &level;
+    }
+    
+    float scale = static_cast<float>(proxySource->width()) / source.width();
+    FilterChain proxyChain = chain.clone();
+    if (proxySource != &source) {
+        for (size_t i = 0; i < proxyChain.getFilterCount(); ++i) {
+            proxyChain.getFilter(i)->scaleSpatialParameters(scale);
+        }
+    }
     
-    // Apply to preview (would use actual preview input)
-    Image previewInput(previewSize_[0], previewSize_[1]);
-    Image previewOutput(previewSize_[0], previewSize_[1]);
+    Image proxy;
+    if (!applyFilterChain(proxyChain, *proxySource, proxy)) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(previewMutex_);
+        previewImage_ = std::move(proxy);
+        previewScale_ = scale;
+        previewRefined_ = proxySource == &source;
+        ++previewVersion_;
+    }
     
-    applyFilterChain(*previewChain_, previewInput, previewOutput);
+    if (proxySource == &source) {
+        return;
+    }
+    
+    // Refine at full resolution in the background. The result is dropped if
+    // another update came in meanwhile; checking under the lock orders it
+    // against that update's proxy.
+    auto refine = [this, refineChain, source, cancel]() {
+        Image refined;
+        if (!refineChain->apply(source, refined, cancel.get())) {
+            return;
+        }
+        
+        std::lock_guard<std::mutex> lock(previewMutex_);
+        if (cancel->load()) {
+            return;
+        }
+        previewImage_ = std::move(refined);
+        previewScale_ = 1.0f;
+        previewRefined_ = true;
+        ++previewVersion_;
+    };
+    
+    auto scheduler = Core::KernelManager::instance().get_service<Core::TaskScheduler>();
+    if (scheduler) {
+        scheduler->submit(*previewRefines_, refine, Core::TaskPriority::Background);
+    } else {
+        refine();
+    }
+}
+
+Image FilterProcessor::getPreviewImage() const {
+    std::lock_guard<std::mutex> lock(previewMutex_);
+    return previewImage_;
+}
+
+float FilterProcessor::getPreviewScale() const {
+    std::lock_guard<std::mutex> lock(previewMutex_);
+    return previewScale_;
+}
+
+bool FilterProcessor::isPreviewRefined() const {
+    std::lock_guard<std::mutex> lock(previewMutex_);
+    return previewRefined_;
+}
+
+Rendering::ResourceId FilterProcessor::getPreviewTexture() {
+    Image image;
+    {
+        std::lock_guard<std::mutex> lock(previewMutex_);
+        if (previewVersion_ == previewUploadedVersion_ || previewImage_.empty()) {
+            return previewTexture_;
+        }
+        image = previewImage_;
+        previewUploadedVersion_ = previewVersion_;
+    }
+    
+    // The refined result is larger than the proxy, so the texture follows it
+    if (previewTexture_ == 0 || previewTextureSize_ != image.getSize()) {
+        if (previewTexture_ != 0) {
+            engine_.destroy_resource(previewTexture_);
+        }
+        
+        using Usage = Rendering::TextureDescriptor::Usage;
+        Rendering::TextureDescriptor desc;
+        desc.width = image.width();
+        desc.height = image.height();
+        desc.format = Rendering::TextureDescriptor::Format::RGBA32Float;
+        desc.usage = static_cast<uint32_t>(Usage::TextureBinding) | static_cast<uint32_t>(Usage::CopyDst);
+        previewTexture_ = engine_.create_texture(desc);
+        previewTextureSize_ = image.getSize();
+    }
+    
+    std::vector<float> texels;
+    packImage(image, texels);
+    engine_.write_texture(previewTexture_, texels.data());
+    return previewTexture_;
 }
 
 void FilterProcessor::endPreview() {
@@ -914,15 +1463,36 @@ void FilterProcessor::endPreview() {
         return;
     }
     
+    cancelPreviewRefines();
+    
     if (previewTexture_ != 0) {
-        engine_.destroy_texture(previewTexture_);
+        engine_.destroy_resource(previewTexture_);
         previewTexture_ = 0;
+        previewTextureSize_ = {0, 0};
     }
     
     previewChain_.reset();
+    previewSource_ = Image();
+    previewPyramid_.clear();
+    {
+        std::lock_guard<std::mutex> lock(previewMutex_);
+        previewImage_ = Image();
+    }
     previewActive_ = false;
 }
 
+void FilterProcessor::cancelPreviewRefines() {
+    // Refines write into this processor, so let them finish first
+    if (previewCancel_) {
+        previewCancel_->store(true);
+        previewCancel_.reset();
+    }
+    auto scheduler = Core::KernelManager::instance().get_service<Core::TaskScheduler>();
+    if (scheduler) {
+        scheduler->wait(*previewRefines_);
+    }
+}
+
 size_t FilterProcessor::getMemoryUsage() const {
     std::lock_guard<std::mutex> lock(cacheMutex_);
     
@@ -930,6 +1500,9 @@ size_t FilterProcessor::getMemoryUsage() const {
     for (const auto& [hash, entry] : textureCache_) {
         totalMemory += entry.memorySize;
     }
+    for (const auto& entry : texturePool_) {
+        totalMemory += entry.memorySize;
+    }
     
     return totalMemory;
 }
@@ -939,10 +1512,19 @@ void FilterProcessor::clearCache() {
     
     for (const auto& [hash, entry] : textureCache_) {
         if (entry.textureId != 0) {
-            engine_.destroy_texture(entry.textureId);
+            engine_.destroy_resource(entry.textureId);
         }
     }
     
+    // Textures of a chain still being recorded stay pooled
+    std::erase_if(texturePool_, [this](const PooledTexture& entry) {
+        if (entry.inUse) {
+            return false;
+        }
+        engine_.destroy_resource(entry.textureId);
+        return true;
+    });
+    
     textureCache_.clear();
     std::cout << "[FilterProcessor] Cache cleared" << std::endl;
 }
@@ -957,6 +1539,26 @@ void FilterProcessor::resetStats() {
     stats_ = FilterProcessorStats{};
 }
 
+namespace {
+
+void writeTelemetry(const FilterProcessor::FilterProcessorStats& stats, Core::MetricWriter& writer) {
+    writer.counter("filters_applied", stats.filtersApplied);
+    writer.counter("chains_applied", stats.chainsApplied);
+    writer.counter("pixels_processed", stats.pixelsProcessed);
+    writer.counter("processing_us", static_cast<uint64_t>(stats.processingTime.count()));
+    writer.counter("gpu_us", static_cast<uint64_t>(stats.gpuTime.count()));
+    writer.counter("cache_hits", stats.cacheHits);
+    writer.counter("cache_misses", stats.cacheMisses);
+    writer.gauge("gpu_memory_bytes", static_cast<double>(stats.gpuMemoryUsed));
+}
+
+} // namespace
+
+void FilterProcessor::registerTelemetry() {
+    telemetrySource_ = Core::Telemetry::instance().add_stats_source(
+        "raster.filters", *this, &FilterProcessor::getStats, writeTelemetry);
+}
+
 bool FilterProcessor::createUniformBuffers() {
     // Create uniform buffer for filter parameters
     filterUniformBuffer_ = engine_.create_buffer(
@@ -969,9 +1571,16 @@ bool FilterProcessor::createUniformBuffers() {
 
 void FilterProcessor::destroyResources() {
     if (filterUniformBuffer_ != 0) {
-        engine_.destroy_buffer(filterUniformBuffer_);
+        engine_.destroy_resource(filterUniformBuffer_);
         filterUniformBuffer_ = 0;
     }
+    
+    for (Rendering::ResourceId buffer : stageUniformBuffers_) {
+        engine_.destroy_resource(buffer);
+    }
+    stageUniformBuffers_.clear();
+    stageUniformBuffersUsed_ = 0;
+    filterPipelines_.clear();
 }
 
 void FilterProcessor::registerBuiltInFilters() {
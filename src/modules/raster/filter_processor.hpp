@@ -1,6 +1,8 @@
 #pragma once
 
+#include "raster_image.hpp"
 #include "../../core/rendering/rendering_engine.hpp"
+#include "../../core/kernel/telemetry.hpp"
 #include "../../core/math/vector2.hpp"
 #include "../../core/math/vector3.hpp"
 #include "../../core/math/vector4.hpp"
@@ -14,10 +16,13 @@
 #include <atomic>
 #include <mutex>
 
+namespace QuantumCanvas::Core {
+class TaskGroup;
+}
+
 namespace QuantumCanvas::Raster {
 
 // Forward declarations
-class Image;
 class FilterChain;
 
 // Filter categories for organization
@@ -128,6 +133,18 @@ public:
     virtual bool isGPUAccelerated() const { return true; }
     virtual float getComplexityScore() const { return 1.0f; }
     
+    // Tiled chain execution. With a halo of r, every output pixel depends only
+    // on input pixels at most r away (borders clamped to the image), so a chain
+    // may run the filter on crops; -1 means it needs the whole image.
+    virtual int getHaloRadius() const { return -1; }
+    // Point-wise filters map each pixel on its own; adjacent ones share a pass
+    virtual bool isPointwise() const { return false; }
+    virtual Image::Pixel applyToPixel(const Image::Pixel& pixel) const { return pixel; }
+    
+    // Proxy previews run on a downscaled image; filters whose parameters are
+    // in pixels scale them so the proxy looks like the full-size result
+    virtual void scaleSpatialParameters(float scale) {}
+    
     // Serialization
     virtual std::vector<uint8_t> serialize() const;
     virtual bool deserialize(const std::vector<uint8_t>& data);
@@ -156,10 +173,16 @@ protected:
     template<typename T>
     T getParameterValue(const std::string& name) const;
     
-    // GPU helper methods
+    // GPU helper methods. A pipeline of 0 means the filter has no GPU
+    // kernel; FilterProcessor caches pipelines by filter name. A kernel may
+    // take several passes, each reading the previous one's output, and its
+    // uniforms are written once per pass.
     virtual Rendering::PipelineId createFilterPipeline(Rendering::RenderingEngine& engine) = 0;
+    virtual uint32_t getGPUPassCount() const { return 1; }
     virtual void updateFilterUniforms(Rendering::RenderingEngine& engine, 
-                                     Rendering::ResourceId uniformBuffer) = 0;
+                                     Rendering::ResourceId uniformBuffer, uint32_t pass) = 0;
+    
+    friend class FilterProcessor;
 };
 
 // Template implementation for type-safe parameter access
@@ -196,18 +219,17 @@ public:
     size_t getRequiredMemory(const std::array<uint32_t, 2>& imageSize) const override;
     bool supportsInPlace() const override { return false; }
     float getComplexityScore() const override { return 2.0f; }
+    int getHaloRadius() const override;
+    void scaleSpatialParameters(float scale) override;
     
     std::unique_ptr<Filter> clone() const override;
 
 protected:
+    // Horizontal then vertical, each an exact kernel of 2 * ceil(3 * sigma) + 1 taps
     Rendering::PipelineId createFilterPipeline(Rendering::RenderingEngine& engine) override;
+    uint32_t getGPUPassCount() const override { return 2; }
     void updateFilterUniforms(Rendering::RenderingEngine& engine, 
-                             Rendering::ResourceId uniformBuffer) override;
-
-private:
-    void generateKernel(float sigma, std::vector<float>& kernel, int& kernelSize);
-    void applyGaussian1D(const Image& input, Image& output, 
-                        const std::vector<float>& kernel, bool horizontal);
+                             Rendering::ResourceId uniformBuffer, uint32_t pass) override;
 };
 
 // Unsharp mask filter for sharpening
@@ -223,13 +245,15 @@ public:
     
     size_t getRequiredMemory(const std::array<uint32_t, 2>& imageSize) const override;
     float getComplexityScore() const override { return 3.0f; }
+    int getHaloRadius() const override;
+    void scaleSpatialParameters(float scale) override;
     
     std::unique_ptr<Filter> clone() const override;
 
 protected:
     Rendering::PipelineId createFilterPipeline(Rendering::RenderingEngine& engine) override;
     void updateFilterUniforms(Rendering::RenderingEngine& engine, 
-                             Rendering::ResourceId uniformBuffer) override;
+                             Rendering::ResourceId uniformBuffer, uint32_t pass) override;
 };
 
 // Edge detection filter (Sobel, Canny, etc.)
@@ -253,17 +277,14 @@ public:
     
     size_t getRequiredMemory(const std::array<uint32_t, 2>& imageSize) const override;
     float getComplexityScore() const override { return 2.5f; }
+    int getHaloRadius() const override;
     
     std::unique_ptr<Filter> clone() const override;
 
 protected:
     Rendering::PipelineId createFilterPipeline(Rendering::RenderingEngine& engine) override;
     void updateFilterUniforms(Rendering::RenderingEngine& engine, 
-                             Rendering::ResourceId uniformBuffer) override;
-
-private:
-    void applySobel(const Image& input, Image& output);
-    void applyCanny(const Image& input, Image& output, float lowThreshold, float highThreshold);
+                             Rendering::ResourceId uniformBuffer, uint32_t pass) override;
 };
 
 // Distortion filter (barrel, pincushion, wave, etc.)
@@ -296,7 +317,7 @@ public:
 protected:
     Rendering::PipelineId createFilterPipeline(Rendering::RenderingEngine& engine) override;
     void updateFilterUniforms(Rendering::RenderingEngine& engine, 
-                             Rendering::ResourceId uniformBuffer) override;
+                             Rendering::ResourceId uniformBuffer, uint32_t pass) override;
 
 private:
     std::array<float, 2> distortPoint(const std::array<float, 2>& point, 
@@ -329,19 +350,22 @@ public:
     size_t getRequiredMemory(const std::array<uint32_t, 2>& imageSize) const override;
     bool supportsInPlace() const override { return true; }
     float getComplexityScore() const override { return 1.5f; }
+    int getHaloRadius() const override { return 0; }
+    bool isPointwise() const override { return true; }
+    Image::Pixel applyToPixel(const Image::Pixel& pixel) const override { return adjustPixel(pixel, adjustmentType_); }
     
     std::unique_ptr<Filter> clone() const override;
 
 protected:
     Rendering::PipelineId createFilterPipeline(Rendering::RenderingEngine& engine) override;
     void updateFilterUniforms(Rendering::RenderingEngine& engine, 
-                             Rendering::ResourceId uniformBuffer) override;
+                             Rendering::ResourceId uniformBuffer, uint32_t pass) override;
 
 private:
     AdjustmentType adjustmentType_;
     
     void setupParametersForType(AdjustmentType type);
-    std::array<float, 4> adjustPixel(const std::array<float, 4>& pixel, AdjustmentType type);
+    std::array<float, 4> adjustPixel(const std::array<float, 4>& pixel, AdjustmentType type) const;
 };
 
 // Custom shader filter for user-defined effects
@@ -370,7 +394,7 @@ public:
 protected:
     Rendering::PipelineId createFilterPipeline(Rendering::RenderingEngine& engine) override;
     void updateFilterUniforms(Rendering::RenderingEngine& engine, 
-                             Rendering::ResourceId uniformBuffer) override;
+                             Rendering::ResourceId uniformBuffer, uint32_t pass) override;
 
 private:
     std::string shaderCode_;
@@ -386,6 +410,10 @@ public:
     FilterChain() = default;
     ~FilterChain() = default;
     
+    // Filters are owned, so copies go through clone()
+    FilterChain(FilterChain&&) = default;
+    FilterChain& operator=(FilterChain&&) = default;
+    
     // Chain management
     void addFilter(std::unique_ptr<Filter> filter);
     void insertFilter(size_t index, std::unique_ptr<Filter> filter);
@@ -393,13 +421,16 @@ public:
     void moveFilter(size_t fromIndex, size_t toIndex);
     void clear();
     
+    FilterChain clone() const;
+    
     // Filter access
     size_t getFilterCount() const { return filters_.size(); }
     Filter* getFilter(size_t index);
     const Filter* getFilter(size_t index) const;
     
-    // Chain application
-    bool apply(const Image& input, Image& output);
+    // Chain application. Setting cancel makes a running apply() stop early
+    // and return false.
+    bool apply(const Image& input, Image& output, const std::atomic<bool>* cancel = nullptr) const;
     bool applyGPU(Rendering::ResourceId inputTexture, 
                  Rendering::ResourceId outputTexture,
                  const std::array<uint32_t, 2>& size);
@@ -418,6 +449,19 @@ public:
 private:
     std::vector<std::unique_ptr<Filter>> filters_;
     
+    // Consecutive filters apply() runs together. A tiled stage streams the
+    // image through its steps one output tile (plus halo) at a time; a step
+    // of several filters is a single point-wise pass.
+    struct FusedStage {
+        std::vector<std::vector<Filter*>> steps;
+        int halo = 0;
+        bool tiled = true;
+    };
+    
+    std::vector<FusedStage> planStages() const;
+    bool applyTiledStage(const FusedStage& stage, const Image& input, Image& output,
+                         const std::atomic<bool>* cancel) const;
+    
     void optimizeFilterOrder();
     void mergeCompatibleFilters();
 };
@@ -453,33 +497,46 @@ public:
                        Rendering::ResourceId outputTexture,
                        const std::array<uint32_t, 2>& size);
     
-    // Filter chain application
+    // Filter chain application. The GPU path takes RGBA32Float textures and
+    // keeps the image on the device between filters, ping-ponging through
+    // pooled textures; runs of filters without a GPU kernel are read back
+    // once, applied on the CPU and uploaded again. GPU stages run when the
+    // frame is submitted, and a frame's chains should be recorded on one
+    // thread, as they share the pool.
     bool applyFilterChain(const FilterChain& chain, const Image& input, Image& output);
     bool applyFilterChainGPU(const FilterChain& chain,
                             Rendering::ResourceId inputTexture,
                             Rendering::ResourceId outputTexture,
                             const std::array<uint32_t, 2>& size);
     
-    // Real-time preview system
+    // How applyFilterChainGPU() splits a chain, counting its enabled filters
+    // only: consecutive ones with a GPU kernel share a device run, the
+    // others a round trip through the CPU
+    struct ChainRun {
+        size_t begin;
+        size_t end;
+        bool gpu;
+    };
+    std::vector<ChainRun> planChainRuns(const FilterChain& chain);
+    
+    // Real-time preview system. An update first renders on the smallest
+    // level of the source's mip pyramid that still covers the preview size,
+    // with spatial parameters scaled to match, then refines at full
+    // resolution on the shared scheduler. A newer update cancels a refine
+    // still in progress, so dragging a slider only ever pays for the proxy.
     void beginPreview();
+    void setPreviewSource(const Image& source);
+    void setPreviewSize(const std::array<uint32_t, 2>& size) { previewSize_ = size; }
     void updatePreviewFilter(Filter* filter);
     void updatePreviewChain(const FilterChain& chain);
-    Rendering::ResourceId getPreviewTexture() const { return previewTexture_; }
+    Image getPreviewImage() const;      // Newest result, proxy or refined
+    float getPreviewScale() const;      // Of getPreviewImage(), relative to the source
+    bool isPreviewRefined() const;
+    // Uploads the newest result first when it changed; call on the render thread
+    Rendering::ResourceId getPreviewTexture();
     void endPreview();
     bool isPreviewActive() const { return previewActive_; }
     
-    // Batch processing
-    struct BatchJob {
-        std::string inputPath;
-        std::string outputPath;
-        FilterChain filterChain;
-        std::array<uint32_t, 2> outputSize{0, 0};  // 0,0 = keep original size
-        bool overwriteExisting = false;
-    };
-    
-    void processBatch(const std::vector<BatchJob>& jobs,
-                     std::function<void(size_t, bool, const std::string&)> progressCallback = nullptr);
-    
     // Memory management
     void setMemoryBudget(size_t budgetBytes) { memoryBudget_ = budgetBytes; }
     size_t getMemoryBudget() const { return memoryBudget_; }
@@ -528,12 +585,26 @@ private:
     std::array<uint32_t, 2> previewSize_{512, 512};
     std::unique_ptr<FilterChain> previewChain_;
     
+    Image previewSource_;
+    std::vector<Image> previewPyramid_;  // Level i is the source halved i + 1 times
+    
+    mutable std::mutex previewMutex_;    // Guards the result, written by refines too
+    Image previewImage_;
+    float previewScale_ = 1.0f;
+    bool previewRefined_ = false;
+    uint64_t previewVersion_ = 0;
+    uint64_t previewUploadedVersion_ = 0;
+    std::array<uint32_t, 2> previewTextureSize_{0, 0};
+    
+    std::shared_ptr<std::atomic<bool>> previewCancel_;  // Of the newest refine
+    std::unique_ptr<Core::TaskGroup> previewRefines_;
+    
     // Memory management
     size_t memoryBudget_ = 1024 * 1024 * 1024;  // 1GB default
     
     // Performance settings
     bool preferGPU_ = true;
-    uint32_t maxConcurrency_ = 0;  // 0 = auto-detect
+    uint32_t maxConcurrency_ = 0;  // Shared scheduler concurrency; 1 = run batches serially
     
     // Resource cache
     struct CacheEntry {
@@ -547,22 +618,57 @@ private:
     mutable std::mutex cacheMutex_;
     std::unordered_map<uint64_t, CacheEntry> textureCache_;
     
+    // Intermediate textures of GPU chains, reused across calls by size and
+    // format. Guarded by cacheMutex_.
+    struct PooledTexture {
+        Rendering::ResourceId textureId;
+        std::array<uint32_t, 2> size;
+        Rendering::TextureDescriptor::Format format;
+        size_t memorySize;
+        bool inUse;
+    };
+    
+    std::vector<PooledTexture> texturePool_;
+    
+    // Dispatches run when the frame is submitted, so no two GPU stages of a
+    // frame share a uniform buffer; the buffers are reused from the next frame
+    std::vector<Rendering::ResourceId> stageUniformBuffers_;
+    size_t stageUniformBuffersUsed_ = 0;
+    uint64_t stageUniformFrame_ = 0;
+    
     // Statistics
     mutable std::mutex statsMutex_;
     FilterProcessorStats stats_;
     
+    Core::Telemetry::SourceRegistration telemetrySource_;
+    
     // Internal methods
+    void registerTelemetry();
     bool createUniformBuffers();
     void destroyResources();
+    void cancelPreviewRefines();
     
     Rendering::ResourceId getCachedTexture(const std::array<uint32_t, 2>& size, uint64_t contentHash);
     void storeCachedTexture(const std::array<uint32_t, 2>& size, uint64_t contentHash, 
                            Rendering::ResourceId textureId);
     
+    Rendering::PipelineId getFilterPipeline(Filter* filter);
+    std::vector<ChainRun> planChainRuns(const std::vector<std::unique_ptr<Filter>>& filters);
+    Rendering::ResourceId acquireStageUniformBuffer();
+    Rendering::ResourceId acquirePooledTexture(const std::array<uint32_t, 2>& size,
+                                              Rendering::TextureDescriptor::Format format);
+    void releasePooledTexture(Rendering::ResourceId textureId);
+    
+    // Records one GPU stage, all of its passes; false if the filter has no kernel
     bool applyFilterInternal(Filter* filter,
                             Rendering::ResourceId inputTexture,
                             Rendering::ResourceId outputTexture,
                             const std::array<uint32_t, 2>& size);
+    // Reads the input back, applies the chain on the CPU and uploads the result
+    bool applyChainOnCPU(const FilterChain& chain,
+                        Rendering::ResourceId inputTexture,
+                        Rendering::ResourceId outputTexture,
+                        const std::array<uint32_t, 2>& size);
     
     void cleanupCache();
     uint64_t calculateContentHash(const Image& image);
@@ -0,0 +1,349 @@
+#include "gaussian_blur.hpp"
+#include "../../core/kernel/task_scheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace QuantumCanvas::Raster::Blur {
+
+namespace {
+
+constexpr uint32_t TILE = Image::TILE_SIZE;
+constexpr size_t CH = Image::CHANNELS;
+
+// Pixels per block of the direct convolution; every tap streams over the
+// same block, which stays in L1 while this many output pixels accumulate
+constexpr size_t CONVOLVE_BLOCK = 256;
+
+// Columns the vertical pass transposes at a time. Each tile row read
+// supplies this many contiguous pixels instead of one.
+constexpr uint32_t COLUMN_GROUP = 16;
+
+// One-dimensional blur of an edge-padded, interleaved RGBA line:
+// in holds count + 2 * padding pixels, out receives count.
+class LineBlur {
+public:
+    LineBlur(float sigma, Method method) {
+        if (method == Method::Auto) {
+            method = sigma >= BOX_CASCADE_MIN_SIGMA ? Method::BoxCascade : Method::Direct;
+        }
+        if (method == Method::BoxCascade) {
+            boxes_ = true;
+            radii_ = boxRadii(sigma);
+            padding_ = radii_[0] + radii_[1] + radii_[2];
+        } else {
+            kernel_ = gaussianKernel(sigma);
+            padding_ = static_cast<int>(kernel_.size() / 2);
+        }
+    }
+
+    int padding() const { return padding_; }
+
+    void operator()(const float* in, float* out, size_t count) const {
+        if (boxes_) {
+            cascade(in, out, count);
+        } else {
+            convolve(in, out, count);
+        }
+    }
+
+private:
+    void convolve(const float* in, float* out, size_t count) const {
+        for (size_t start = 0; start < count; start += CONVOLVE_BLOCK) {
+            size_t floats = std::min(CONVOLVE_BLOCK, count - start) * CH;
+            float* __restrict dst = out + start * CH;
+            std::fill_n(dst, floats, 0.0f);
+            for (size_t k = 0; k < kernel_.size(); ++k) {
+                const float* __restrict src = in + (start + k) * CH;
+                const float weight = kernel_[k];
+                // Channels are interleaved, so one weight covers a run of
+                // floats and this loop vectorizes as is
+                for (size_t i = 0; i < floats; ++i) {
+                    dst[i] += weight * src[i];
+                }
+            }
+        }
+    }
+
+    // Sliding-window mean over 2 * radius + 1 pixels; src holds count +
+    // 2 * radius pixels. Sums are kept in double so long lines don't drift.
+    static void box(const float* src, float* dst, size_t count, int radius) {
+        const size_t window = size_t(radius) * 2 + 1;
+        const double scale = 1.0 / double(window);
+        double sum[CH] = {};
+        for (size_t i = 0; i < window; ++i) {
+            for (size_t c = 0; c < CH; ++c) {
+                sum[c] += src[i * CH + c];
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t c = 0; c < CH; ++c) {
+                dst[i * CH + c] = static_cast<float>(sum[c] * scale);
+            }
+            if (i + 1 < count) {
+                for (size_t c = 0; c < CH; ++c) {
+                    sum[c] += double(src[(i + window) * CH + c]) - double(src[i * CH + c]);
+                }
+            }
+        }
+    }
+
+    void cascade(const float* in, float* out, size_t count) const {
+        thread_local std::vector<float> first;
+        thread_local std::vector<float> second;
+
+        size_t firstCount = count + 2 * size_t(radii_[1] + radii_[2]);
+        size_t secondCount = count + 2 * size_t(radii_[2]);
+        first.resize(firstCount * CH);
+        second.resize(secondCount * CH);
+
+        box(in, first.data(), firstCount, radii_[0]);
+        box(first.data(), second.data(), secondCount, radii_[1]);
+        box(second.data(), out, count, radii_[2]);
+    }
+
+    bool boxes_ = false;
+    std::vector<float> kernel_;
+    std::array<int, 3> radii_ = {0, 0, 0};
+    int padding_ = 0;
+};
+
+// Copies pixels [xBegin, xEnd) of row y into dst, a tile run at a time;
+// coordinates outside the image repeat the edge pixel
+void readRow(const Image& image, uint32_t y, int64_t xBegin, int64_t xEnd, float* dst) {
+    const int64_t width = image.width();
+    const uint32_t tileY = y / TILE;
+    const size_t rowOffset = size_t(y % TILE) * Image::TILE_STRIDE;
+
+    int64_t x = xBegin;
+    if (x < 0) {
+        Image::Pixel edge = image.getPixel(0, y);
+        for (; x < std::min<int64_t>(xEnd, 0); ++x, dst += CH) {
+            std::memcpy(dst, edge.data(), CH * sizeof(float));
+        }
+    }
+    while (x < std::min(xEnd, width)) {
+        uint32_t tileX = static_cast<uint32_t>(x / TILE);
+        int64_t runEnd = std::min({xEnd, width, int64_t(tileX + 1) * TILE});
+        size_t floats = size_t(runEnd - x) * CH;
+        if (const float* tile = image.tileData(tileX, tileY)) {
+            std::memcpy(dst, tile + rowOffset + size_t(x % TILE) * CH, floats * sizeof(float));
+        } else {
+            for (size_t i = 0; i < floats; i += CH) {
+                std::memcpy(dst + i, image.fillColor().data(), CH * sizeof(float));
+            }
+        }
+        dst += floats;
+        x = runEnd;
+    }
+    if (x < xEnd) {
+        Image::Pixel edge = image.getPixel(static_cast<uint32_t>(width - 1), y);
+        for (; x < xEnd; ++x, dst += CH) {
+            std::memcpy(dst, edge.data(), CH * sizeof(float));
+        }
+    }
+}
+
+void horizontalPass(const Image& input, Image& output, const LineBlur& blur) {
+    const int64_t padding = blur.padding();
+
+    Core::parallel_for(0, input.tilesY(), 1, [&](size_t band) {
+        const uint32_t tileY = static_cast<uint32_t>(band);
+        const uint32_t y0 = tileY * TILE;
+        const uint32_t y1 = std::min(y0 + TILE, input.height());
+
+        // Tiles whose neighbourhood is uniform keep the output's fill
+        std::vector<uint8_t> needed(input.tilesX(), 0);
+        uint32_t first = input.tilesX();
+        uint32_t last = 0;
+        for (uint32_t tileX = 0; tileX < input.tilesX(); ++tileX) {
+            int64_t x0 = int64_t(tileX) * TILE;
+            if (!input.isRegionUniform(x0 - padding, y0, x0 + TILE + padding, y1)) {
+                needed[tileX] = 1;
+                first = std::min(first, tileX);
+                last = tileX;
+            }
+        }
+        if (first > last) {
+            return;
+        }
+
+        // Only the span between the first and last such tile is blurred
+        const int64_t spanBegin = int64_t(first) * TILE;
+        const int64_t spanEnd = std::min<int64_t>(int64_t(last + 1) * TILE, input.width());
+        const size_t spanCount = size_t(spanEnd - spanBegin);
+
+        thread_local std::vector<float> line;
+        thread_local std::vector<float> blurred;
+        line.resize((spanCount + 2 * size_t(padding)) * CH);
+        blurred.resize(spanCount * CH);
+
+        for (uint32_t y = y0; y < y1; ++y) {
+            readRow(input, y, spanBegin - padding, spanEnd + padding, line.data());
+            blur(line.data(), blurred.data(), spanCount);
+
+            const size_t rowOffset = size_t(y - y0) * Image::TILE_STRIDE;
+            for (uint32_t tileX = first; tileX <= last; ++tileX) {
+                if (!needed[tileX]) {
+                    continue;
+                }
+                int64_t x0 = int64_t(tileX) * TILE;
+                size_t pixels = size_t(std::min<int64_t>(x0 + TILE, input.width()) - x0);
+                std::memcpy(output.mutableTileData(tileX, tileY) + rowOffset,
+                            blurred.data() + size_t(x0 - spanBegin) * CH, pixels * CH * sizeof(float));
+            }
+        }
+    });
+}
+
+void verticalPass(const Image& input, Image& output, const LineBlur& blur) {
+    const int64_t padding = blur.padding();
+    const int64_t height = input.height();
+
+    Core::parallel_for(0, input.tilesX(), 1, [&](size_t strip) {
+        const uint32_t tileX = static_cast<uint32_t>(strip);
+        const uint32_t x0 = tileX * TILE;
+        const uint32_t x1 = std::min(x0 + TILE, input.width());
+
+        std::vector<uint8_t> needed(input.tilesY(), 0);
+        uint32_t first = input.tilesY();
+        uint32_t last = 0;
+        for (uint32_t tileY = 0; tileY < input.tilesY(); ++tileY) {
+            int64_t y0 = int64_t(tileY) * TILE;
+            if (!input.isRegionUniform(x0, y0 - padding, x1, y0 + TILE + padding)) {
+                needed[tileY] = 1;
+                first = std::min(first, tileY);
+                last = tileY;
+            }
+        }
+        if (first > last) {
+            return;
+        }
+
+        const int64_t spanBegin = int64_t(first) * TILE;
+        const int64_t spanEnd = std::min<int64_t>(int64_t(last + 1) * TILE, height);
+        const size_t spanCount = size_t(spanEnd - spanBegin);
+        const size_t lineFloats = (spanCount + 2 * size_t(padding)) * CH;
+
+        // Column c of the group becomes the contiguous line at c * lineFloats
+        thread_local std::vector<float> lines;
+        thread_local std::vector<float> blurred;
+        lines.resize(lineFloats * COLUMN_GROUP);
+        blurred.resize(spanCount * CH * COLUMN_GROUP);
+
+        for (uint32_t gx0 = x0; gx0 < x1; gx0 += COLUMN_GROUP) {
+            const uint32_t columns = std::min(COLUMN_GROUP, x1 - gx0);
+            const size_t groupFloats = size_t(columns) * CH;
+            const size_t columnOffset = size_t(gx0 - x0) * CH;
+
+            // Transpose the group into lines, clamping rows to the image
+            float row[COLUMN_GROUP * CH];
+            for (int64_t i = 0; i < int64_t(spanCount) + 2 * padding; ++i) {
+                uint32_t y = static_cast<uint32_t>(std::clamp<int64_t>(spanBegin - padding + i, 0, height - 1));
+                const float* src;
+                if (const float* tile = input.tileData(tileX, y / TILE)) {
+                    src = tile + size_t(y % TILE) * Image::TILE_STRIDE + columnOffset;
+                } else {
+                    for (size_t f = 0; f < groupFloats; f += CH) {
+                        std::memcpy(row + f, input.fillColor().data(), CH * sizeof(float));
+                    }
+                    src = row;
+                }
+                for (uint32_t c = 0; c < columns; ++c) {
+                    std::memcpy(lines.data() + c * lineFloats + size_t(i) * CH, src + c * CH, CH * sizeof(float));
+                }
+            }
+
+            for (uint32_t c = 0; c < columns; ++c) {
+                blur(lines.data() + c * lineFloats, blurred.data() + c * spanCount * CH, spanCount);
+            }
+
+            // And back into the tiles that need it
+            for (uint32_t tileY = first; tileY <= last; ++tileY) {
+                if (!needed[tileY]) {
+                    continue;
+                }
+                float* tile = output.mutableTileData(tileX, tileY);
+                int64_t y0 = int64_t(tileY) * TILE;
+                int64_t y1 = std::min<int64_t>(y0 + TILE, height);
+                for (int64_t y = y0; y < y1; ++y) {
+                    float* dst = tile + size_t(y - y0) * Image::TILE_STRIDE + columnOffset;
+                    size_t index = size_t(y - spanBegin) * CH;
+                    for (uint32_t c = 0; c < columns; ++c) {
+                        std::memcpy(dst + c * CH, blurred.data() + c * spanCount * CH + index, CH * sizeof(float));
+                    }
+                }
+            }
+        }
+    });
+}
+
+} // namespace
+
+std::vector<float> gaussianKernel(float sigma) {
+    const int center = static_cast<int>(std::ceil(sigma * 3.0f));
+    std::vector<float> kernel(size_t(center) * 2 + 1);
+
+    float sum = 0.0f;
+    for (int i = 0; i < static_cast<int>(kernel.size()); ++i) {
+        float x = static_cast<float>(i - center);
+        kernel[i] = std::exp(-(x * x) / (2.0f * sigma * sigma));
+        sum += kernel[i];
+    }
+    for (float& weight : kernel) {
+        weight /= sum;
+    }
+    return kernel;
+}
+
+int support(float sigma, Method method) {
+    return sigma > 0.0f ? LineBlur(sigma, method).padding() : 0;
+}
+
+std::array<int, 3> boxRadii(float sigma) {
+    // Widths wl and wl + 2 (both odd), m boxes of the former, so that the
+    // summed variance (w^2 - 1) / 12 comes closest to sigma^2
+    constexpr int boxes = 3;
+    const double variance = double(sigma) * sigma;
+    int lower = static_cast<int>(std::floor(std::sqrt(12.0 * variance / boxes + 1.0)));
+    if (lower % 2 == 0) {
+        --lower;
+    }
+    lower = std::max(lower, 1);
+    double lowerCount = (12.0 * variance - boxes * lower * lower - 4.0 * boxes * lower - 3.0 * boxes)
+                        / (-4.0 * lower - 4.0);
+    int m = std::clamp(static_cast<int>(std::lround(lowerCount)), 0, boxes);
+
+    std::array<int, 3> radii;
+    for (int i = 0; i < boxes; ++i) {
+        int width = i < m ? lower : lower + 2;
+        radii[i] = (width - 1) / 2;
+    }
+    return radii;
+}
+
+void gaussianBlur(const Image& input, Image& output, float sigma, Method method) {
+    if (!(sigma > 0.0f)) {
+        output = input;
+        return;
+    }
+
+    // Blurring a uniform region leaves it unchanged
+    output.reset(input.width(), input.height(), input.fillColor());
+    if (input.width() == 0 || input.height() == 0) {
+        return;
+    }
+
+    LineBlur blur(sigma, method);
+    if (blur.padding() == 0) {
+        output = input;
+        return;
+    }
+
+    Image temp;
+    temp.reset(input.width(), input.height(), input.fillColor());
+    horizontalPass(input, temp, blur);
+    verticalPass(temp, output, blur);
+}
+
+} // namespace QuantumCanvas::Raster::Blur
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "raster_image.hpp"
+#include <array>
+#include <vector>
+
+namespace QuantumCanvas::Raster::Blur {
+
+// Direct convolution costs O(sigma) per pixel; from this sigma on, Auto
+// switches to the three-box cascade, whose cost doesn't depend on sigma
+constexpr float BOX_CASCADE_MIN_SIGMA = 6.0f;
+
+enum class Method {
+    Auto,
+    Direct,      // Exact Gaussian kernel of 2 * ceil(3 * sigma) + 1 taps
+    BoxCascade   // Three box blurs, within a few percent of the Gaussian
+};
+
+// Separable Gaussian blur with clamp-to-edge borders. Both passes run on
+// contiguous lines: rows are read straight from the tiles, and the
+// vertical pass transposes narrow column strips into lines first. Bands of
+// tiles run in parallel on the shared scheduler, and tiles whose
+// neighbourhood is uniform are left unallocated.
+void gaussianBlur(const Image& input, Image& output, float sigma, Method method = Method::Auto);
+
+// Normalized weights, centre tap in the middle
+std::vector<float> gaussianKernel(float sigma);
+
+// Pixels an output pixel reads on each side, along either axis
+int support(float sigma, Method method = Method::Auto);
+
+// Radii of three successive box blurs whose combined variance best matches sigma
+std::array<int, 3> boxRadii(float sigma);
+
+} // namespace QuantumCanvas::Raster::Blur
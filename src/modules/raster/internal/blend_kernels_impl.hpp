@@ -0,0 +1,211 @@
+#pragma once
+
+// Blend kernel template shared by the per-ISA translation units. Each unit
+// includes this with its own vector type V, which provides:
+//
+//   static constexpr size_t LANES;
+//   static V load(const float*);   void store(float*) const;
+//   static V broadcast(float);
+//   V operator+ - * / (V, V);
+//   vmin, vmax, vabs, vsqrt (V...) -> V
+//   lessEqual(V, V), less(V, V) -> V::Mask;  select(V::Mask, V ifTrue, V ifFalse) -> V
+//
+// Only inline code lives here so every unit gets its own copy compiled for
+// its instruction set.
+
+#include "../blend_kernels.hpp"
+
+namespace QuantumCanvas::Raster::CpuBlend::Detail {
+
+constexpr float DIVIDE_EPSILON = 1e-5f;
+
+template <typename V>
+inline V clamp01(V x) {
+    return vmin(vmax(x, V::broadcast(0.0f)), V::broadcast(1.0f));
+}
+
+template <typename V>
+inline V colorBurn(V b, V s) {
+    V one = V::broadcast(1.0f);
+    V burned = one - vmin(one, (one - b) / vmax(s, V::broadcast(DIVIDE_EPSILON)));
+    return select(lessEqual(one, b), one, burned);
+}
+
+template <typename V>
+inline V colorDodge(V b, V s) {
+    V one = V::broadcast(1.0f);
+    V zero = V::broadcast(0.0f);
+    V dodged = vmin(one, b / vmax(one - s, V::broadcast(DIVIDE_EPSILON)));
+    return select(lessEqual(b, zero), zero, dodged);
+}
+
+// B(Cb, Cs) on straight colors, for modes that don't simplify on
+// premultiplied values. Matches blend_rgb() in the GPU blend shader.
+template <BlendMode M, typename V>
+inline V straightBlend(V b, V s) {
+    V one = V::broadcast(1.0f);
+    V half = V::broadcast(0.5f);
+    V two = V::broadcast(2.0f);
+    if constexpr (M == BlendMode::ColorBurn) {
+        return colorBurn(b, s);
+    } else if constexpr (M == BlendMode::ColorDodge) {
+        return colorDodge(b, s);
+    } else if constexpr (M == BlendMode::SoftLight) {
+        V cubic = ((V::broadcast(16.0f) * b - V::broadcast(12.0f)) * b + V::broadcast(4.0f)) * b;
+        V d = select(lessEqual(b, V::broadcast(0.25f)), cubic, vsqrt(b));
+        V darkened = b - (one - two * s) * b * (one - b);
+        V lightened = b + (two * s - one) * (d - b);
+        return select(lessEqual(s, half), darkened, lightened);
+    } else if constexpr (M == BlendMode::VividLight) {
+        return select(lessEqual(s, half), colorBurn(b, two * s), colorDodge(b, two * (s - half)));
+    } else if constexpr (M == BlendMode::LinearLight) {
+        return clamp01(b + two * s - one);
+    } else if constexpr (M == BlendMode::PinLight) {
+        return select(less(s, half), vmin(b, two * s), vmax(b, two * s - one));
+    } else if constexpr (M == BlendMode::HardMix) {
+        return select(lessEqual(one, b + s), one, V::broadcast(0.0f));
+    } else {
+        static_assert(M == BlendMode::Divide, "not a straight-color blend mode");
+        return vmin(b / vmax(s, V::broadcast(DIVIDE_EPSILON)), one);
+    }
+}
+
+// as * ab * B(Cb, Cs) from premultiplied cb, ab, cs, as
+template <BlendMode M, typename V>
+inline V blendTerm(V cb, V ab, V cs, V as) {
+    V two = V::broadcast(2.0f);
+    if constexpr (M == BlendMode::Multiply) {
+        return cs * cb;
+    } else if constexpr (M == BlendMode::Screen) {
+        return cs * ab + cb * as - cs * cb;
+    } else if constexpr (M == BlendMode::Darken) {
+        return vmin(cs * ab, cb * as);
+    } else if constexpr (M == BlendMode::Lighten) {
+        return vmax(cs * ab, cb * as);
+    } else if constexpr (M == BlendMode::LinearDodge || M == BlendMode::Add) {
+        return vmin(cs * ab + cb * as, as * ab);
+    } else if constexpr (M == BlendMode::LinearBurn) {
+        return vmax(cs * ab + cb * as - as * ab, V::broadcast(0.0f));
+    } else if constexpr (M == BlendMode::Difference) {
+        return vabs(cs * ab - cb * as);
+    } else if constexpr (M == BlendMode::Exclusion) {
+        return cs * ab + cb * as - two * cs * cb;
+    } else if constexpr (M == BlendMode::Subtract) {
+        return vmax(cb * as - cs * ab, V::broadcast(0.0f));
+    } else if constexpr (M == BlendMode::HardLight || M == BlendMode::Overlay) {
+        // Overlay is hard light with the layers swapped
+        V multiplied = two * cs * cb;
+        V screened = as * ab - two * (ab - cb) * (as - cs);
+        V mask = M == BlendMode::HardLight ? two * cs - as : two * cb - ab;
+        return select(lessEqual(mask, V::broadcast(0.0f)), multiplied, screened);
+    } else {
+        V epsilon = V::broadcast(DIVIDE_EPSILON);
+        V b = cb / vmax(ab, epsilon);
+        V s = cs / vmax(as, epsilon);
+        return as * ab * straightBlend<M>(b, s);
+    }
+}
+
+template <BlendMode M, typename V>
+inline void blendLoop(const Planes& base, const ConstPlanes& overlay, size_t count, float opacity) {
+    const V one = V::broadcast(1.0f);
+    const V op = V::broadcast(opacity);
+    const V keep = V::broadcast(1.0f - opacity);
+
+    for (size_t i = 0; i < count; i += V::LANES) {
+        V cr = V::load(base[0] + i);
+        V cg = V::load(base[1] + i);
+        V cb = V::load(base[2] + i);
+        V ab = V::load(base[3] + i);
+        V sr = V::load(overlay[0] + i) * op;
+        V sg = V::load(overlay[1] + i) * op;
+        V sb = V::load(overlay[2] + i) * op;
+        V as = V::load(overlay[3] + i) * op;
+
+        if constexpr (M == BlendMode::Clear) {
+            V erase = one - as;
+            cr = cr * erase;
+            cg = cg * erase;
+            cb = cb * erase;
+            ab = ab * erase;
+        } else if constexpr (M == BlendMode::Behind) {
+            V uncovered = one - ab;
+            cr = cr + sr * uncovered;
+            cg = cg + sg * uncovered;
+            cb = cb + sb * uncovered;
+            ab = ab + as * uncovered;
+        } else if constexpr (M == BlendMode::Replace) {
+            cr = cr * keep + sr;
+            cg = cg * keep + sg;
+            cb = cb * keep + sb;
+            ab = ab * keep + as;
+        } else if constexpr (M == BlendMode::Normal) {
+            V uncovered = one - as;
+            cr = sr + cr * uncovered;
+            cg = sg + cg * uncovered;
+            cb = sb + cb * uncovered;
+            ab = as + ab * uncovered;
+        } else {
+            V invAs = one - as;
+            V invAb = one - ab;
+            cr = sr * invAb + cr * invAs + blendTerm<M>(cr, ab, sr, as);
+            cg = sg * invAb + cg * invAs + blendTerm<M>(cg, ab, sg, as);
+            cb = sb * invAb + cb * invAs + blendTerm<M>(cb, ab, sb, as);
+            ab = as + ab * invAs;
+        }
+
+        cr.store(base[0] + i);
+        cg.store(base[1] + i);
+        cb.store(base[2] + i);
+        ab.store(base[3] + i);
+    }
+}
+
+// Blends the first count - count % V::LANES pixels and returns how many that
+// was, or ~0 when the mode is unsupported
+template <typename V>
+inline size_t blendPlanes(BlendMode mode, const Planes& base, const ConstPlanes& overlay,
+                          size_t count, float opacity) {
+    size_t vectorCount = count - count % V::LANES;
+
+    switch (mode) {
+#define QC_BLEND_CASE(M) \
+        case BlendMode::M: blendLoop<BlendMode::M, V>(base, overlay, vectorCount, opacity); break;
+        QC_BLEND_CASE(Normal)
+        QC_BLEND_CASE(Darken)
+        QC_BLEND_CASE(Multiply)
+        QC_BLEND_CASE(ColorBurn)
+        QC_BLEND_CASE(LinearBurn)
+        QC_BLEND_CASE(Lighten)
+        QC_BLEND_CASE(Screen)
+        QC_BLEND_CASE(ColorDodge)
+        QC_BLEND_CASE(LinearDodge)
+        QC_BLEND_CASE(Overlay)
+        QC_BLEND_CASE(SoftLight)
+        QC_BLEND_CASE(HardLight)
+        QC_BLEND_CASE(VividLight)
+        QC_BLEND_CASE(LinearLight)
+        QC_BLEND_CASE(PinLight)
+        QC_BLEND_CASE(HardMix)
+        QC_BLEND_CASE(Difference)
+        QC_BLEND_CASE(Exclusion)
+        QC_BLEND_CASE(Subtract)
+        QC_BLEND_CASE(Divide)
+        QC_BLEND_CASE(Behind)
+        QC_BLEND_CASE(Clear)
+        QC_BLEND_CASE(Replace)
+        QC_BLEND_CASE(Add)
+#undef QC_BLEND_CASE
+        default:
+            return ~size_t(0);
+    }
+    return vectorCount;
+}
+
+// Per-ISA entry points; the ones a build doesn't compile aren't referenced
+size_t blendScalar(BlendMode mode, const Planes& base, const ConstPlanes& overlay, size_t count, float opacity);
+size_t blendAvx2(BlendMode mode, const Planes& base, const ConstPlanes& overlay, size_t count, float opacity);
+size_t blendAvx512(BlendMode mode, const Planes& base, const ConstPlanes& overlay, size_t count, float opacity);
+size_t blendNeon(BlendMode mode, const Planes& base, const ConstPlanes& overlay, size_t count, float opacity);
+
+} // namespace QuantumCanvas::Raster::CpuBlend::Detail
@@ -1,13 +1,23 @@
 #include "layer_compositor.hpp"
-#include "image.hpp"
+#include "blend_kernels.hpp"
 #include "../../core/memory/memory_manager.hpp"
+#include "../../core/kernel/task_scheduler.hpp"
 #include <algorithm>
 #include <cmath>
 #include <chrono>
+#include <functional>
 #include <stdexcept>
 
 namespace QuantumCanvas::Raster {
 
+namespace {
+
+uint64_t hashCombine(uint64_t hash, uint64_t value) {
+    return hash ^ (value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2));
+}
+
+} // namespace
+
 // Layer implementation
 uint32_t Layer::nextId_ = 1;
 
@@ -25,7 +35,11 @@ Layer::Layer(Layer&& other) noexcept
     , transform_(other.transform_)
     , mask_(std::move(other.mask_))
     , effects_(std::move(other.effects_))
-    , dirty_(other.dirty_.load()) {
+    , dirty_(other.dirty_.load())
+    , generation_(other.generation_)
+    , damageRects_(std::move(other.damageRects_))
+    , fullyDamaged_(other.fullyDamaged_)
+    , compositedBounds_(other.compositedBounds_) {
     other.id_ = 0;
 }
 
@@ -40,6 +54,10 @@ Layer& Layer::operator=(Layer&& other) noexcept {
         mask_ = std::move(other.mask_);
         effects_ = std::move(other.effects_);
         dirty_ = other.dirty_.load();
+        generation_ = other.generation_;
+        damageRects_ = std::move(other.damageRects_);
+        fullyDamaged_ = other.fullyDamaged_;
+        compositedBounds_ = other.compositedBounds_;
         other.id_ = 0;
     }
     return *this;
@@ -69,6 +87,44 @@ void Layer::removeEffect(size_t index) {
     }
 }
 
+void Layer::addDamage(const std::array<float, 4>& documentRect) {
+    if (fullyDamaged_) return;
+    
+    if (damageRects_.size() >= MAX_DAMAGE_RECTS) {
+        auto merged = documentRect;
+        for (const auto& rect : damageRects_) {
+            merged = LayerUtils::unionBounds(merged, rect);
+        }
+        damageRects_.assign(1, merged);
+        return;
+    }
+    damageRects_.push_back(documentRect);
+}
+
+void Layer::collectDamage(std::vector<std::array<float, 4>>& damage) const {
+    if (fullyDamaged_) {
+        damage.push_back(compositedBounds_);
+        damage.push_back(getDocumentBounds());
+        return;
+    }
+    damage.insert(damage.end(), damageRects_.begin(), damageRects_.end());
+}
+
+void Layer::clearDamage() {
+    damageRects_.clear();
+    fullyDamaged_ = false;
+    compositedBounds_ = getDocumentBounds();
+    markClean();
+}
+
+uint64_t Layer::getContentHash() const {
+    return hashCombine(id_, generation_);
+}
+
+std::array<float, 4> Layer::getDocumentBounds() const {
+    return LayerUtils::transformBounds(getBounds(), transform_.getMatrix());
+}
+
 std::vector<uint8_t> Layer::serialize() const {
     // Basic serialization - would need proper format in production
     std::vector<uint8_t> data;
@@ -137,6 +193,9 @@ bool Layer::deserialize(const std::vector<uint8_t>& data) {
     
     std::memcpy(&transform_, data.data() + offset, sizeof(transform_));
     
+    // Layers created after a restore must not reuse a restored id
+    nextId_ = std::max(nextId_, id_ + 1);
+    
     markDirty();
     return true;
 }
@@ -262,7 +321,7 @@ void RasterLayer::setImage(std::unique_ptr<Image> image) {
 void RasterLayer::resize(const std::array<uint32_t, 2>& newSize) {
     if (!image_) return;
     
-    // image_->resize(newSize); // Would need Image::resize implementation
+    image_->resize(newSize);
     textureDirty_ = true;
     markDirty();
 }
@@ -270,11 +329,46 @@ void RasterLayer::resize(const std::array<uint32_t, 2>& newSize) {
 void RasterLayer::clear(const std::array<float, 4>& color) {
     if (!image_) return;
     
-    // image_->clear(color); // Would need Image::clear implementation
+    image_->clear(color);
     textureDirty_ = true;
     markDirty();
 }
 
+void RasterLayer::restoreSnapshot(const Image& snapshot) {
+    if (image_) {
+        *image_ = snapshot;
+    } else {
+        image_ = std::make_unique<Image>(snapshot);
+    }
+    textureDirty_ = true;
+    markDirty();
+}
+
+void RasterLayer::collectDamage(std::vector<std::array<float, 4>>& damage) const {
+    Layer::collectDamage(damage);
+    if (fullyDamaged_ || !image_) return;
+    
+    auto matrix = transform_.getMatrix();
+    for (const auto& rect : image_->getDirtyRects()) {
+        std::array<float, 4> contentRect = {
+            static_cast<float>(rect[0]), static_cast<float>(rect[1]),
+            static_cast<float>(rect[2]), static_cast<float>(rect[3])
+        };
+        damage.push_back(LayerUtils::transformBounds(contentRect, matrix));
+    }
+}
+
+void RasterLayer::clearDamage() {
+    Layer::clearDamage();
+    if (image_) {
+        image_->clearDirtyTiles();
+    }
+}
+
+uint64_t RasterLayer::getContentHash() const {
+    return hashCombine(Layer::getContentHash(), image_ ? image_->generation() : 0);
+}
+
 void RasterLayer::updateTexture() const {
     if (!image_ || !textureDirty_) return;
     
@@ -284,14 +378,8 @@ void RasterLayer::updateTexture() const {
 }
 
 std::vector<uint8_t> RasterLayer::serialize() const {
-    auto baseData = Layer::serialize();
-    
-    if (image_) {
-        // auto imageData = image_->serialize(); // Would need Image serialization
-        // baseData.insert(baseData.end(), imageData.begin(), imageData.end());
-    }
-    
-    return baseData;
+    // Pixels are stored by the QCSX archive, tile by tile, beside these bytes
+    return Layer::serialize();
 }
 
 bool RasterLayer::deserialize(const std::vector<uint8_t>& data) {
@@ -406,7 +494,37 @@ bool AdjustmentLayer::deserialize(const std::vector<uint8_t>& data) {
         return false;
     }
     
-    // Deserialize adjustment data
+    // Adjustment type and parameters follow the base properties
+    size_t offset = Layer::serialize().size();
+    uint32_t paramCount = 0;
+    if (data.size() < offset + sizeof(adjustmentType_) + sizeof(paramCount)) {
+        return false;
+    }
+    std::memcpy(&adjustmentType_, data.data() + offset, sizeof(adjustmentType_));
+    offset += sizeof(adjustmentType_);
+    std::memcpy(&paramCount, data.data() + offset, sizeof(paramCount));
+    offset += sizeof(paramCount);
+    
+    parameters_.clear();
+    for (uint32_t i = 0; i < paramCount; ++i) {
+        uint32_t nameLen = 0;
+        if (data.size() < offset + sizeof(nameLen)) {
+            return false;
+        }
+        std::memcpy(&nameLen, data.data() + offset, sizeof(nameLen));
+        offset += sizeof(nameLen);
+        
+        float value = 0.0f;
+        if (data.size() < offset + nameLen + sizeof(value)) {
+            return false;
+        }
+        std::string name(reinterpret_cast<const char*>(data.data() + offset), nameLen);
+        offset += nameLen;
+        std::memcpy(&value, data.data() + offset, sizeof(value));
+        offset += sizeof(value);
+        parameters_[std::move(name)] = value;
+    }
+    
     parametersDirty_ = true;
     return true;
 }
@@ -536,11 +654,51 @@ void LayerGroup::setIsolated(bool isolated) {
     markDirty();
 }
 
+void LayerGroup::collectDamage(std::vector<std::array<float, 4>>& damage) const {
+    Layer::collectDamage(damage);
+    if (fullyDamaged_) return;
+    
+    std::vector<std::array<float, 4>> childDamage;
+    for (const auto& layer : layers_) {
+        layer->collectDamage(childDamage);
+    }
+    
+    auto matrix = transform_.getMatrix();
+    for (const auto& rect : childDamage) {
+        damage.push_back(LayerUtils::transformBounds(rect, matrix));
+    }
+}
+
+void LayerGroup::clearDamage() {
+    Layer::clearDamage();
+    for (auto& layer : layers_) {
+        layer->clearDamage();
+    }
+}
+
+uint64_t LayerGroup::getContentHash() const {
+    return hashCombine(Layer::getContentHash(), getChildrenHash());
+}
+
+uint64_t LayerGroup::getChildrenHash() const {
+    uint64_t hash = layers_.size();
+    for (const auto& layer : layers_) {
+        hash = hashCombine(hash, layer->getContentHash());
+    }
+    return hash;
+}
+
+void LayerGroup::setCompositeTexture(Rendering::ResourceId texture, const std::array<uint32_t, 2>& size) {
+    groupTexture_ = texture;
+    groupSize_ = size;
+    contentDirty_ = false;
+}
+
 void LayerGroup::updateGroupTexture() const {
     if (!contentDirty_) return;
     
-    // Composite all child layers into group texture
-    // This would use LayerCompositor to render all layers
+    // LayerCompositor renders the children and hands the texture back
+    // through setCompositeTexture(); until then there is nothing to show
     contentDirty_ = false;
 }
 
@@ -574,7 +732,9 @@ bool LayerGroup::deserialize(const std::vector<uint8_t>& data) {
 
 // LayerCompositor implementation
 LayerCompositor::LayerCompositor(Rendering::RenderingEngine& engine)
-    : engine_(engine) {}
+    : engine_(engine) {
+    registerTelemetry();
+}
 
 LayerCompositor::~LayerCompositor() {
     shutdown();
@@ -584,6 +744,7 @@ LayerCompositor::LayerCompositor(LayerCompositor&& other) noexcept
     : engine_(other.engine_)
     , initialized_(other.initialized_.load())
     , blendPipelines_(std::move(other.blendPipelines_))
+    , blendPermutations_(other.blendPermutations_)
     , transformPipelineId_(other.transformPipelineId_)
     , maskPipelineId_(other.maskPipelineId_)
     , effectPipelines_(std::move(other.effectPipelines_))
@@ -595,9 +756,19 @@ LayerCompositor::LayerCompositor(LayerCompositor&& other) noexcept
     , colorSpace_(other.colorSpace_)
     , clippingMask_(other.clippingMask_)
     , hasClippingMask_(other.hasClippingMask_)
-    , stats_(other.stats_) {
+    , stats_(other.stats_)
+    , frameGraph_(std::move(other.frameGraph_))
+    , sceneCache_(std::move(other.sceneCache_))
+    , groupComposites_(std::move(other.groupComposites_))
+    , groupLru_(std::move(other.groupLru_))
+    , groupCacheBudget_(other.groupCacheBudget_)
+    , groupCacheBytes_(other.groupCacheBytes_)
+    , compositeSerial_(other.compositeSerial_)
+    , clearRegionPipelineId_(other.clearRegionPipelineId_) {
     
     other.initialized_ = false;
+    other.clearRegionPipelineId_ = 0;
+    other.groupCacheBytes_ = 0;
     other.transformPipelineId_ = 0;
     other.maskPipelineId_ = 0;
     other.blendUniformId_ = 0;
@@ -613,6 +784,7 @@ LayerCompositor& LayerCompositor::operator=(LayerCompositor&& other) noexcept {
         
         initialized_ = other.initialized_.load();
         blendPipelines_ = std::move(other.blendPipelines_);
+        blendPermutations_ = other.blendPermutations_;
         transformPipelineId_ = other.transformPipelineId_;
         maskPipelineId_ = other.maskPipelineId_;
         effectPipelines_ = std::move(other.effectPipelines_);
@@ -625,8 +797,18 @@ LayerCompositor& LayerCompositor::operator=(LayerCompositor&& other) noexcept {
         clippingMask_ = other.clippingMask_;
         hasClippingMask_ = other.hasClippingMask_;
         stats_ = other.stats_;
+        frameGraph_ = std::move(other.frameGraph_);
+        sceneCache_ = std::move(other.sceneCache_);
+        groupComposites_ = std::move(other.groupComposites_);
+        groupLru_ = std::move(other.groupLru_);
+        groupCacheBudget_ = other.groupCacheBudget_;
+        groupCacheBytes_ = other.groupCacheBytes_;
+        compositeSerial_ = other.compositeSerial_;
+        clearRegionPipelineId_ = other.clearRegionPipelineId_;
         
         other.initialized_ = false;
+        other.clearRegionPipelineId_ = 0;
+        other.groupCacheBytes_ = 0;
         other.transformPipelineId_ = 0;
         other.maskPipelineId_ = 0;
         other.blendUniformId_ = 0;
@@ -676,19 +858,130 @@ void LayerCompositor::compositeToTarget(const std::vector<Layer*>& layers,
                                        const std::array<float, 4>& bounds) {
     if (!initialized_ || layers.empty()) return;
     
+    Rendering::ProfileScope profileScope(engine_.profiler(), "composite_layers", "compositor");
     auto startTime = std::chrono::high_resolution_clock::now();
     
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.layersComposited = 0;
+        stats_.blendOperations = 0;
+        stats_.transformOperations = 0;
+        stats_.pixelsProcessed = 0;
+        stats_.gpuMemoryUsed = 0;
+        stats_.tilesComposited = 0;
+        stats_.tilesReused = 0;
+        stats_.groupCacheHits = 0;
+        stats_.groupCacheEvictions = 0;
+    }
+    
+    ++compositeSerial_;
+    compositeStack(layers, targetTexture, targetSize, bounds, sceneCache_);
+    trimGroupComposites();
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    
     std::lock_guard<std::mutex> lock(statsMutex_);
-    stats_.layersComposited = 0;
-    stats_.blendOperations = 0;
-    stats_.transformOperations = 0;
-    stats_.pixelsProcessed = static_cast<uint64_t>(targetSize[0]) * targetSize[1];
+    stats_.compositionTime = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+}
+
+size_t LayerCompositor::compositeStack(const std::vector<Layer*>& layers,
+                                       Rendering::ResourceId targetTexture,
+                                       const std::array<uint32_t, 2>& targetSize,
+                                       const std::array<float, 4>& bounds,
+                                       CompositeCache& cache) {
+    constexpr uint32_t tileSize = COMPOSITE_TILE_SIZE;
+    const uint32_t tilesX = (targetSize[0] + tileSize - 1) / tileSize;
+    const uint32_t tilesY = (targetSize[1] + tileSize - 1) / tileSize;
+    const size_t tileCount = size_t(tilesX) * tilesY;
+    
+    // Damage has to be collected before nested groups consume their children's
+    std::vector<std::array<float, 4>> damage;
+    std::vector<uint32_t> layerIds;
+    layerIds.reserve(layers.size());
+    for (Layer* layer : layers) {
+        if (!layer) continue;
+        layerIds.push_back(layer->getId());
+        layer->collectDamage(damage);
+    }
     
-    // Set render target
-    engine_.setRenderTarget(targetTexture, targetSize);
+    bool fullRepaint = !cache.valid || cache.target != targetTexture ||
+                       cache.size != targetSize || cache.layerIds != layerIds;
+    
+    std::vector<uint8_t> damagedTiles;
+    size_t damagedCount = tileCount;
+    if (!fullRepaint) {
+        damagedTiles.assign(tileCount, 0);
+        damagedCount = 0;
+        for (const auto& rect : damage) {
+            float x0 = std::clamp(rect[0], 0.0f, static_cast<float>(targetSize[0]));
+            float y0 = std::clamp(rect[1], 0.0f, static_cast<float>(targetSize[1]));
+            float x1 = std::clamp(rect[2], 0.0f, static_cast<float>(targetSize[0]));
+            float y1 = std::clamp(rect[3], 0.0f, static_cast<float>(targetSize[1]));
+            if (x0 >= x1 || y0 >= y1) continue;
+            
+            uint32_t tx1 = static_cast<uint32_t>(std::ceil(x1 / tileSize));
+            uint32_t ty1 = static_cast<uint32_t>(std::ceil(y1 / tileSize));
+            for (uint32_t ty = static_cast<uint32_t>(y0) / tileSize; ty < ty1; ++ty) {
+                for (uint32_t tx = static_cast<uint32_t>(x0) / tileSize; tx < tx1; ++tx) {
+                    auto& tile = damagedTiles[ty * tilesX + tx];
+                    damagedCount += tile == 0;
+                    tile = 1;
+                }
+            }
+        }
+        fullRepaint = damagedCount == tileCount;
+    }
     
-    // Clear target if needed
-    engine_.clearRenderTarget({0.0f, 0.0f, 0.0f, 0.0f});
+    cache.valid = true;
+    cache.target = targetTexture;
+    cache.size = targetSize;
+    cache.layerIds = std::move(layerIds);
+    
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.tilesComposited += static_cast<uint32_t>(damagedCount);
+        stats_.tilesReused += static_cast<uint32_t>(tileCount - damagedCount);
+    }
+    if (damagedCount == 0) return 0;
+    
+    // Repainted regions: runs of damaged tiles per row, merged with the run
+    // above when they span the same columns
+    compositeRegions_.clear();
+    if (fullRepaint) {
+        compositeRegions_.push_back({0, 0, static_cast<int32_t>(targetSize[0]), static_cast<int32_t>(targetSize[1])});
+    } else {
+        // Rectangles ending at the previous row, which may still grow down
+        std::vector<std::array<int32_t, 4>> open;
+        std::vector<std::array<int32_t, 4>> next;
+        for (uint32_t ty = 0; ty < tilesY; ++ty) {
+            next.clear();
+            for (uint32_t tx = 0; tx < tilesX; ++tx) {
+                if (!damagedTiles[ty * tilesX + tx]) continue;
+                
+                uint32_t runEnd = tx;
+                while (runEnd < tilesX && damagedTiles[ty * tilesX + runEnd]) ++runEnd;
+                
+                int32_t x = static_cast<int32_t>(tx * tileSize);
+                int32_t y = static_cast<int32_t>(ty * tileSize);
+                int32_t w = static_cast<int32_t>(std::min(runEnd * tileSize, targetSize[0])) - x;
+                int32_t h = static_cast<int32_t>(std::min((ty + 1) * tileSize, targetSize[1])) - y;
+                
+                auto above = std::find_if(open.begin(), open.end(),
+                                          [&](const auto& r) { return r[0] == x && r[2] == w; });
+                if (above != open.end()) {
+                    next.push_back({x, (*above)[1], w, (*above)[3] + h});
+                    open.erase(above);
+                } else {
+                    next.push_back({x, y, w, h});
+                }
+                tx = runEnd;
+            }
+            
+            compositeRegions_.insert(compositeRegions_.end(), open.begin(), open.end());
+            std::swap(open, next);
+        }
+        compositeRegions_.insert(compositeRegions_.end(), open.begin(), open.end());
+    }
     
     // Calculate effective bounds
     auto effectiveBounds = bounds;
@@ -696,18 +989,206 @@ void LayerCompositor::compositeToTarget(const std::vector<Layer*>& layers,
         effectiveBounds = calculateLayerBounds(layers);
     }
     
-    // Composite each visible layer
+    auto touchesRegions = [this](const std::array<float, 4>& layerBounds) {
+        return std::any_of(compositeRegions_.begin(), compositeRegions_.end(), [&](const auto& r) {
+            std::array<float, 4> region = {static_cast<float>(r[0]), static_cast<float>(r[1]),
+                                           static_cast<float>(r[0] + r[2]), static_cast<float>(r[1] + r[3])};
+            return LayerUtils::boundsOverlap(layerBounds, region);
+        });
+    };
+    
+    // Collect visible layers into frame scratch memory (no heap traffic per frame).
+    // Pass-through groups blend their children straight into this stack.
+    Core::FrameVector<Layer*> visibleLayers{Core::FrameAllocator<Layer*>(&engine_.frame_arena())};
+    Core::FrameVector<LayerGroup*> cachedGroups{Core::FrameAllocator<LayerGroup*>(&engine_.frame_arena())};
+    visibleLayers.reserve(layers.size());
+    
+    std::function<void(Layer*)> collectVisible = [&](Layer* layer) {
+        if (!layer || !layer->isVisible()) return;
+        
+        if (fullRepaint ? !layerIntersectsBounds(layer, effectiveBounds)
+                        : !touchesRegions(layer->getDocumentBounds())) {
+            return;
+        }
+        
+        if (auto* group = dynamic_cast<LayerGroup*>(layer)) {
+            if (group->isPassThrough()) {
+                for (size_t i = 0; i < group->getLayerCount(); ++i) {
+                    collectVisible(group->getLayer(i));
+                }
+                return;
+            }
+            cachedGroups.push_back(group);
+        }
+        visibleLayers.push_back(layer);
+    };
+    for (Layer* layer : layers) {
+        collectVisible(layer);
+    }
+    
+    // Group composites record their own graphs, so they run before this one
+    // and compositeRegions_ is rebuilt afterwards
+    if (!cachedGroups.empty()) {
+        auto regions = compositeRegions_;
+        for (LayerGroup* group : cachedGroups) {
+            updateGroupComposite(group, targetSize);
+        }
+        compositeRegions_ = std::move(regions);
+    }
+    
+    // Build the frame graph: clear, then per layer its effect chain and blend
+    if (!frameGraph_) {
+        frameGraph_ = std::make_unique<Rendering::RenderGraph>();
+    }
+    auto& graph = *frameGraph_;
+    graph.reset();
+    
+    Rendering::RGTextureDesc targetDesc;
+    targetDesc.width = targetSize[0];
+    targetDesc.height = targetSize[1];
+    auto target = graph.import_texture("composite_target", targetTexture, targetDesc);
+    
+    if (fullRepaint) {
+        // No draw needed; the render pass load op clears the target
+        graph.add_pass("clear_target", Rendering::RGPassType::Render, [&](Rendering::RenderGraphBuilder& builder) {
+            target = builder.write_color(target, Rendering::RGLoadOp::Clear);
+        }, nullptr);
+    } else {
+        // Undamaged tiles keep their pixels, so only the regions are cleared
+        graph.add_pass("clear_damage", Rendering::RGPassType::Render, [&](Rendering::RenderGraphBuilder& builder) {
+            target = builder.write_color(target);
+        }, [this](Rendering::RenderPassContext&) {
+            engine_.setPipeline(clearRegionPipelineId_);
+            for (const auto& region : compositeRegions_) {
+                engine_.setScissorRect(region);
+                engine_.drawFullscreenQuad();
+            }
+        });
+    }
+    
+    // addLayerPasses takes statsMutex_ itself
+    for (Layer* layer : visibleLayers) {
+        target = addLayerPasses(graph, layer, target, targetSize);
+    }
+    
+    graph.mark_output(target);
+    graph.execute(engine_);
+    engine_.setScissorRect({0, 0, static_cast<int32_t>(targetSize[0]), static_cast<int32_t>(targetSize[1])});
+    
     for (Layer* layer : layers) {
-        if (!layer || !layer->isVisible()) continue;
+        if (layer) {
+            layer->clearDamage();
+        }
+    }
+    
+    uint64_t repaintedPixels = 0;
+    for (const auto& region : compositeRegions_) {
+        repaintedPixels += static_cast<uint64_t>(region[2]) * region[3];
+    }
+    
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats_.layersComposited += static_cast<uint32_t>(visibleLayers.size());
+    stats_.pixelsProcessed += repaintedPixels;
+    stats_.gpuMemoryUsed = std::max(stats_.gpuMemoryUsed, graph.get_compile_stats().transientBytesAllocated);
+    return damagedCount;
+}
+
+void LayerCompositor::updateGroupComposite(LayerGroup* group, const std::array<uint32_t, 2>& size) {
+    // References into an unordered_map survive the inserts nested groups make
+    auto [entry, inserted] = groupComposites_.try_emplace(group->getId());
+    auto& composite = entry->second;
+    if (inserted) {
+        groupLru_.push_front(group->getId());
+        composite.lruPosition = groupLru_.begin();
+    } else {
+        groupLru_.splice(groupLru_.begin(), groupLru_, composite.lruPosition);
+    }
+    composite.lastUsed = compositeSerial_;
+    
+    // Nothing under the group changed, so neither did its composite
+    uint64_t childrenHash = group->getChildrenHash();
+    if (composite.texture != 0 && composite.cache.valid && composite.cache.size == size &&
+        composite.childrenHash == childrenHash) {
+        group->setCompositeTexture(composite.texture, size);
         
-        if (!layerIntersectsBounds(layer, effectiveBounds)) continue;
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.groupCacheHits++;
+        return;
+    }
+    
+    if (composite.texture == 0 || composite.cache.size != size) {
+        if (composite.texture != 0) {
+            engine_.destroyTexture(composite.texture);
+            groupCacheBytes_ -= composite.bytes;
+            composite.bytes = 0;
+        }
+        composite.texture = engine_.createTexture(size[0], size[1],
+                                                  Rendering::PixelFormat::RGBA8,
+                                                  Rendering::TextureUsage::RenderTarget | Rendering::TextureUsage::Sampled);
+        composite.cache = CompositeCache{};
+        if (composite.texture == 0) return;
         
-        compositeLayer(layer, targetTexture, targetSize, effectiveBounds);
-        stats_.layersComposited++;
+        composite.bytes = size_t(size[0]) * size[1] * 4;
+        groupCacheBytes_ += composite.bytes;
     }
     
-    auto endTime = std::chrono::high_resolution_clock::now();
-    stats_.compositionTime = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+    std::vector<Layer*> children;
+    children.reserve(group->getLayerCount());
+    for (size_t i = 0; i < group->getLayerCount(); ++i) {
+        children.push_back(group->getLayer(i));
+    }
+    
+    size_t repainted = compositeStack(children, composite.texture, size, {0.0f, 0.0f, 0.0f, 0.0f}, composite.cache);
+    group->setCompositeTexture(composite.texture, size);
+    
+    // Taken after compositing, which consumed the children's dirty tiles
+    composite.childrenHash = group->getChildrenHash();
+    
+    if (repainted == 0) {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.groupCacheHits++;
+    }
+}
+
+void LayerCompositor::invalidateCompositeCache() {
+    sceneCache_.valid = false;
+    for (auto& [id, composite] : groupComposites_) {
+        composite.cache.valid = false;
+    }
+}
+
+void LayerCompositor::releaseGroupComposites() {
+    for (auto& [id, composite] : groupComposites_) {
+        if (composite.texture != 0) {
+            engine_.destroyTexture(composite.texture);
+        }
+    }
+    groupComposites_.clear();
+    groupLru_.clear();
+    groupCacheBytes_ = 0;
+}
+
+void LayerCompositor::trimGroupComposites() {
+    // Composites used by this call are read by the graph that just ran, and
+    // everything ahead of them in the list was used by it as well
+    uint32_t evicted = 0;
+    while (groupCacheBytes_ > groupCacheBudget_ && !groupLru_.empty()) {
+        auto entry = groupComposites_.find(groupLru_.back());
+        if (entry->second.lastUsed == compositeSerial_) break;
+        
+        if (entry->second.texture != 0) {
+            engine_.destroyTexture(entry->second.texture);
+        }
+        groupCacheBytes_ -= entry->second.bytes;
+        groupComposites_.erase(entry);
+        groupLru_.pop_back();
+        ++evicted;
+    }
+    
+    if (evicted > 0) {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.groupCacheEvictions += evicted;
+    }
 }
 
 Rendering::ResourceId LayerCompositor::compositeToTexture(const std::vector<Layer*>& layers,
@@ -726,6 +1207,100 @@ Rendering::ResourceId LayerCompositor::compositeToTexture(const std::vector<Laye
     return targetTexture;
 }
 
+void LayerCompositor::compositeToImage(const std::vector<Layer*>& layers, Image& target) {
+    if (target.empty()) return;
+    
+    Rendering::ProfileScope profileScope(engine_.profiler(), "composite_layers_cpu", "compositor");
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    uint32_t composited = 0;
+    for (Layer* layer : layers) {
+        composited += compositeLayerToImage(layer, target);
+    }
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats_.layersComposited = composited;
+    stats_.blendOperations = composited;
+    stats_.pixelsProcessed = static_cast<uint64_t>(composited) * target.width() * target.height();
+    stats_.compositionTime = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+}
+
+uint32_t LayerCompositor::compositeLayerToImage(Layer* layer, Image& target) {
+    if (!layer || !layer->isVisible()) return 0;
+    
+    BlendMode mode = layer->getBlendMode();
+    if (!CpuBlend::isSupported(mode)) {
+        mode = BlendMode::Normal;
+    }
+    
+    if (auto* group = dynamic_cast<LayerGroup*>(layer)) {
+        uint32_t composited = 0;
+        if (group->isPassThrough()) {
+            for (size_t i = 0; i < group->getLayerCount(); ++i) {
+                composited += compositeLayerToImage(group->getLayer(i), target);
+            }
+            return composited;
+        }
+        
+        Image flattened(target.width(), target.height());
+        for (size_t i = 0; i < group->getLayerCount(); ++i) {
+            composited += compositeLayerToImage(group->getLayer(i), flattened);
+        }
+        blendLayerImage(group, flattened, target, mode);
+        return composited + 1;
+    }
+    
+    if (auto* raster = dynamic_cast<RasterLayer*>(layer)) {
+        if (raster->getImage() && !raster->getImage()->empty()) {
+            blendLayerImage(raster, *raster->getImage(), target, mode);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void LayerCompositor::blendLayerImage(const Layer* layer, const Image& source, Image& target, BlendMode mode) {
+    static const std::array<float, 9> identity = {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+    auto matrix = layer->getTransform().getMatrix();
+    
+    if (matrix == identity && source.getSize() == target.getSize()) {
+        CpuBlend::blendImage(target, source, mode, layer->getOpacity());
+        return;
+    }
+    
+    // Resample into document space first, touching only the tiles under the layer
+    std::array<float, 4> targetBounds = {0.0f, 0.0f, static_cast<float>(target.width()), static_cast<float>(target.height())};
+    auto bounds = LayerUtils::intersectBounds(layer->getDocumentBounds(), targetBounds);
+    if (bounds[0] >= bounds[2] || bounds[1] >= bounds[3]) return;
+    
+    auto inverse = LayerUtils::invertMatrix(matrix);
+    uint32_t x0 = static_cast<uint32_t>(bounds[0]);
+    uint32_t y0 = static_cast<uint32_t>(bounds[1]);
+    uint32_t x1 = static_cast<uint32_t>(std::ceil(bounds[2]));
+    uint32_t y1 = static_cast<uint32_t>(std::ceil(bounds[3]));
+    
+    Image placed(target.width(), target.height());
+    const float sourceWidth = static_cast<float>(source.width());
+    const float sourceHeight = static_cast<float>(source.height());
+    
+    // One band of tile rows per task, so no two tasks write the same tile
+    constexpr uint32_t tileSize = Image::TILE_SIZE;
+    Core::parallel_for(y0 / tileSize, (y1 + tileSize - 1) / tileSize, 1, [&](size_t band) {
+        uint32_t bandEnd = std::min(y1, static_cast<uint32_t>(band + 1) * tileSize);
+        for (uint32_t y = std::max(y0, static_cast<uint32_t>(band) * tileSize); y < bandEnd; ++y) {
+            for (uint32_t x = x0; x < x1; ++x) {
+                auto p = LayerUtils::transformPoint({x + 0.5f, y + 0.5f}, inverse);
+                if (p[0] < 0.0f || p[1] < 0.0f || p[0] >= sourceWidth || p[1] >= sourceHeight) continue;
+                placed.setPixel(x, y, source.sampleBilinear(p[0] - 0.5f, p[1] - 0.5f));
+            }
+        }
+    });
+    
+    CpuBlend::blendImage(target, placed, mode, layer->getOpacity());
+}
+
 void LayerCompositor::compositeLayer(Layer* layer,
                                     Rendering::ResourceId targetTexture,
                                     const std::array<uint32_t, 2>& targetSize,
@@ -747,12 +1322,10 @@ void LayerCompositor::compositeLayer(Layer* layer,
         applyLayerMask(layer, contentTexture);
     }
     
-    // Apply layer effects
-    auto processedTexture = contentTexture;
-    const auto& effects = layer->getEffects();
-    for (const auto& effect : effects) {
+    // Apply layer effects; applyLayerEffects runs the whole chain
+    auto processedTexture = applyLayerEffects(layer, contentTexture, layer->getContentSize());
+    for (const auto& effect : layer->getEffects()) {
         if (effect.enabled) {
-            processedTexture = applyLayerEffects(layer, processedTexture, layer->getContentSize());
             stats_.effectsApplied++;
         }
     }
@@ -763,6 +1336,85 @@ void LayerCompositor::compositeLayer(Layer* layer,
     stats_.blendOperations++;
 }
 
+Rendering::RGResourceHandle LayerCompositor::addLayerPasses(Rendering::RenderGraph& graph,
+                                                            Layer* layer,
+                                                            Rendering::RGResourceHandle target,
+                                                            const std::array<uint32_t, 2>& targetSize) {
+    auto contentTexture = layer->getContentTexture();
+    if (contentTexture == 0) return target;
+    
+    auto blendPipeline = getBlendPipeline(layer->getBlendMode(), layer->getOpacity());
+    if (blendPipeline == 0) return target;
+    
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    
+    const auto contentSize = layer->getContentSize();
+    Rendering::RGTextureDesc contentDesc;
+    contentDesc.width = contentSize[0];
+    contentDesc.height = contentSize[1];
+    auto current = graph.import_texture("layer_content", contentTexture, contentDesc);
+    
+    // Each effect renders into a fresh transient; the graph aliases them, so
+    // only an effect's input and output are ever backed at the same time
+    for (const auto& effect : layer->getEffects()) {
+        if (!effect.enabled) continue;
+        
+        auto it = effectPipelines_.find(effect.type);
+        if (it == effectPipelines_.end()) continue;
+        
+        Rendering::PipelineId pipeline = it->second;
+        auto input = current;
+        graph.add_pass("layer_effect", Rendering::RGPassType::Render, [&](Rendering::RenderGraphBuilder& builder) {
+            builder.read(input);
+            current = builder.write_color(builder.create_texture("effect_output", contentDesc),
+                                          Rendering::RGLoadOp::Clear);
+        }, [this, effect, pipeline, input](Rendering::RenderPassContext& context) {
+            auto uniforms = updateEffectUniforms(effect);
+            
+            engine_.setPipeline(pipeline);
+            engine_.setTexture(0, context.get_texture(input));
+            engine_.setUniformBuffer(0, uniforms.buffer, uniforms.offset);
+            engine_.drawFullscreenQuad();
+        });
+        stats_.effectsApplied++;
+    }
+    
+    // Blends load the target, so consecutive blends share one render pass.
+    // The blend is drawn once per repainted region the layer overlaps.
+    auto processed = current;
+    auto base = target;
+    auto layerBounds = layer->getDocumentBounds();
+    graph.add_pass("layer_blend", Rendering::RGPassType::Render, [&](Rendering::RenderGraphBuilder& builder) {
+        builder.read(processed);
+        target = builder.write_color(target);
+    }, [this, layer, processed, base, blendPipeline, targetSize, layerBounds](Rendering::RenderPassContext& context) {
+        applyLayerTransform(layer, targetSize);
+        if (layer->hasMask()) {
+            applyLayerMask(layer, context.get_texture(processed));
+        }
+        auto uniforms = updateBlendUniforms(layer->getOpacity());
+        
+        engine_.setPipeline(blendPipeline);
+        engine_.setTexture(0, context.get_texture(base));
+        engine_.setTexture(1, context.get_texture(processed));
+        engine_.setUniformBuffer(0, uniforms.buffer, uniforms.offset);
+        for (const auto& region : compositeRegions_) {
+            std::array<float, 4> regionBounds = {
+                static_cast<float>(region[0]), static_cast<float>(region[1]),
+                static_cast<float>(region[0] + region[2]), static_cast<float>(region[1] + region[3])
+            };
+            if (!LayerUtils::boundsOverlap(layerBounds, regionBounds)) continue;
+            
+            engine_.setScissorRect(region);
+            engine_.drawFullscreenQuad();
+        }
+    });
+    stats_.transformOperations++;
+    stats_.blendOperations++;
+    
+    return target;
+}
+
 void LayerCompositor::blendTextures(Rendering::ResourceId baseTexture,
                                    Rendering::ResourceId overlayTexture,
                                    Rendering::ResourceId targetTexture,
@@ -771,17 +1423,17 @@ void LayerCompositor::blendTextures(Rendering::ResourceId baseTexture,
                                    const std::array<uint32_t, 2>& size) {
     if (!initialized_) return;
     
-    auto pipeline = getBlendPipeline(blendMode);
+    auto pipeline = getBlendPipeline(blendMode, opacity);
     if (pipeline == 0) return;
     
     // Update blend uniforms
-    updateBlendUniforms(blendMode, opacity);
+    auto uniforms = updateBlendUniforms(opacity);
     
     // Set pipeline and textures
     engine_.setPipeline(pipeline);
     engine_.setTexture(0, baseTexture);
     engine_.setTexture(1, overlayTexture);
-    engine_.setUniformBuffer(0, blendUniformId_);
+    engine_.setUniformBuffer(0, uniforms.buffer, uniforms.offset);
     
     // Draw fullscreen quad
     engine_.drawFullscreenQuad();
@@ -820,11 +1472,11 @@ Rendering::ResourceId LayerCompositor::applyLayerEffects(Layer* layer,
                                                   Rendering::PixelFormat::RGBA8,
                                                   Rendering::TextureUsage::RenderTarget);
         
-        updateEffectUniforms(effect);
+        auto uniforms = updateEffectUniforms(effect);
         
         engine_.setPipeline(it->second);
         engine_.setTexture(0, currentTexture);
-        engine_.setUniformBuffer(0, effectUniformId_);
+        engine_.setUniformBuffer(0, uniforms.buffer, uniforms.offset);
         engine_.setRenderTarget(effectTexture, size);
         engine_.drawFullscreenQuad();
         
@@ -859,28 +1511,84 @@ void LayerCompositor::resetStats() {
     stats_ = CompositionStats{};
 }
 
+namespace {
+
+void writeTelemetry(const LayerCompositor::CompositionStats& stats, Core::MetricWriter& writer) {
+    writer.counter("layers_composited", stats.layersComposited);
+    writer.counter("effects_applied", stats.effectsApplied);
+    writer.counter("pixels_processed", stats.pixelsProcessed);
+    writer.counter("composition_us", static_cast<uint64_t>(stats.compositionTime.count()));
+    writer.counter("gpu_us", static_cast<uint64_t>(stats.gpuTime.count()));
+    writer.counter("blend_operations", stats.blendOperations);
+    writer.counter("transform_operations", stats.transformOperations);
+    writer.counter("group_cache_hits", stats.groupCacheHits);
+    writer.counter("group_cache_evictions", stats.groupCacheEvictions);
+    // Of the last composite
+    writer.gauge("tiles_composited", stats.tilesComposited);
+    writer.gauge("tiles_reused", stats.tilesReused);
+    writer.gauge("gpu_memory_bytes", static_cast<double>(stats.gpuMemoryUsed));
+}
+
+} // namespace
+
+void LayerCompositor::registerTelemetry() {
+    telemetrySource_ = Core::Telemetry::instance().add_stats_source(
+        "raster.compositor", *this, &LayerCompositor::getStats, writeTelemetry);
+}
+
 bool LayerCompositor::createBlendPipelines() {
     // Create pipelines for each blend mode
-    const std::array<BlendMode, 25> blendModes = {
+    const std::array<BlendMode, 31> blendModes = {
         BlendMode::Normal, BlendMode::Dissolve,
         BlendMode::Darken, BlendMode::Multiply, BlendMode::ColorBurn, BlendMode::LinearBurn, BlendMode::DarkerColor,
         BlendMode::Lighten, BlendMode::Screen, BlendMode::ColorDodge, BlendMode::LinearDodge, BlendMode::LighterColor,
         BlendMode::Overlay, BlendMode::SoftLight, BlendMode::HardLight, BlendMode::VividLight,
         BlendMode::LinearLight, BlendMode::PinLight, BlendMode::HardMix,
         BlendMode::Difference, BlendMode::Exclusion, BlendMode::Subtract, BlendMode::Divide,
-        BlendMode::Hue, BlendMode::Saturation
+        BlendMode::Hue, BlendMode::Saturation, BlendMode::Color, BlendMode::Luminosity,
+        BlendMode::Behind, BlendMode::Clear, BlendMode::Replace, BlendMode::Add
     };
     
-    for (auto mode : blendModes) {
-        auto shaderCode = getBlendModeShaderCode(mode);
-        auto pipelineId = engine_.createPipeline(shaderCode);
-        if (pipelineId == 0) {
+    // Layers are mostly partially transparent or fully opaque; other
+    // variants compile lazily in getBlendPipeline()
+    std::vector<Rendering::PermutationKey> keys;
+    keys.reserve(blendModes.size() * 2);
+    for (BlendMode mode : blendModes) {
+        keys.push_back(blendPermutationKey(mode, 0.5f));
+        keys.push_back(blendPermutationKey(mode, 1.0f));
+    }
+    
+    // Shader compilation dominates startup, so build the variants in parallel
+    auto* compiler = engine_.get_shader_compiler();
+    if (compiler && compiler->is_initialized()) {
+        if (blendPermutations_ == 0) {
+            blendPermutations_ = compiler->register_permutations(blendShaderTemplate());
+        }
+        compiler->precompile_permutations(blendPermutations_, keys);
+    }
+    
+    std::vector<Rendering::PipelineId> pipelineIds(keys.size());
+    Core::parallel_for(0, keys.size(), 1, [&](size_t i) {
+        pipelineIds[i] = engine_.createPipeline(blendShaderTemplate().variant_source(keys[i]));
+    });
+    
+    std::lock_guard<std::mutex> lock(blendPipelinesMutex_);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (pipelineIds[i] == 0) {
             return false;
         }
-        blendPipelines_[mode] = pipelineId;
+        blendPipelines_[keys[i]] = pipelineIds[i];
     }
     
-    return true;
+    // Incremental composites clear their damaged regions with scissored quads
+    clearRegionPipelineId_ = engine_.createPipeline(R"(
+@fragment
+fn fs_main() -> @location(0) vec4<f32> {
+    return vec4<f32>(0.0, 0.0, 0.0, 0.0);
+}
+)");
+    
+    return clearRegionPipelineId_ != 0;
 }
 
 bool LayerCompositor::createEffectPipelines() {
@@ -894,13 +1602,17 @@ bool LayerCompositor::createEffectPipelines() {
         LayerEffect::Satin
     };
     
-    for (auto type : effectTypes) {
+    std::array<Rendering::PipelineId, effectTypes.size()> pipelineIds{};
+    Core::parallel_for(0, effectTypes.size(), 1, [&](size_t i) {
         // Create effect-specific pipeline
-        auto pipelineId = engine_.createPipeline("effect_shader");
-        if (pipelineId == 0) {
+        pipelineIds[i] = engine_.createPipeline("effect_shader");
+    });
+    
+    for (size_t i = 0; i < effectTypes.size(); ++i) {
+        if (pipelineIds[i] == 0) {
             return false;
         }
-        effectPipelines_[type] = pipelineId;
+        effectPipelines_[effectTypes[i]] = pipelineIds[i];
     }
     
     return true;
@@ -916,12 +1628,20 @@ bool LayerCompositor::createUniformBuffers() {
 }
 
 void LayerCompositor::destroyResources() {
+    releaseGroupComposites();
+    invalidateCompositeCache();
+    
     // Destroy all pipelines
     for (auto& [mode, pipeline] : blendPipelines_) {
         engine_.destroyPipeline(pipeline);
     }
     blendPipelines_.clear();
     
+    if (clearRegionPipelineId_ != 0) {
+        engine_.destroyPipeline(clearRegionPipelineId_);
+        clearRegionPipelineId_ = 0;
+    }
+    
     for (auto& [type, pipeline] : effectPipelines_) {
         engine_.destroyPipeline(pipeline);
     }
@@ -951,12 +1671,12 @@ void LayerCompositor::applyLayerTransform(Layer* layer, const std::array<uint32_
     if (!layer) return;
     
     const auto& transform = layer->getTransform();
-    updateTransformUniforms(transform, targetSize);
+    auto uniforms = updateTransformUniforms(transform, targetSize);
     
     // Apply transform pipeline if needed
     if (transformPipelineId_ != 0) {
         engine_.setPipeline(transformPipelineId_);
-        engine_.setUniformBuffer(0, transformUniformId_);
+        engine_.setUniformBuffer(0, uniforms.buffer, uniforms.offset);
     }
 }
 
@@ -980,30 +1700,34 @@ void LayerCompositor::applyLayerEffect(const LayerEffect& effect,
     auto it = effectPipelines_.find(effect.type);
     if (it == effectPipelines_.end()) return;
     
-    updateEffectUniforms(effect);
+    auto uniforms = updateEffectUniforms(effect);
     
     engine_.setPipeline(it->second);
     engine_.setTexture(0, sourceTexture);
-    engine_.setUniformBuffer(0, effectUniformId_);
+    engine_.setUniformBuffer(0, uniforms.buffer, uniforms.offset);
     engine_.setRenderTarget(targetTexture, size);
     engine_.drawFullscreenQuad();
 }
 
-void LayerCompositor::updateBlendUniforms(BlendMode mode, float opacity) {
+Rendering::UploadAllocation LayerCompositor::updateBlendUniforms(float opacity) {
+    // The mode is baked into the pipeline's shader variant
     struct BlendUniforms {
-        uint32_t blendMode;
         float opacity;
-        float padding[2];
+        float padding[3];
     };
     
     BlendUniforms uniforms{};
-    uniforms.blendMode = static_cast<uint32_t>(mode);
     uniforms.opacity = opacity;
     
-    engine_.updateBuffer(blendUniformId_, &uniforms, sizeof(uniforms));
+    auto allocation = engine_.upload(&uniforms, sizeof(uniforms));
+    if (!allocation.is_valid()) {
+        engine_.updateBuffer(blendUniformId_, &uniforms, sizeof(uniforms));
+        allocation.buffer = blendUniformId_;
+    }
+    return allocation;
 }
 
-void LayerCompositor::updateTransformUniforms(const LayerTransform& transform,
+Rendering::UploadAllocation LayerCompositor::updateTransformUniforms(const LayerTransform& transform,
                                              const std::array<uint32_t, 2>& targetSize) {
     struct TransformUniforms {
         std::array<float, 16> matrix;
@@ -1024,10 +1748,15 @@ void LayerCompositor::updateTransformUniforms(const LayerTransform& transform,
     
     uniforms.targetSize = {static_cast<float>(targetSize[0]), static_cast<float>(targetSize[1])};
     
-    engine_.updateBuffer(transformUniformId_, &uniforms, sizeof(uniforms));
+    auto allocation = engine_.upload(&uniforms, sizeof(uniforms));
+    if (!allocation.is_valid()) {
+        engine_.updateBuffer(transformUniformId_, &uniforms, sizeof(uniforms));
+        allocation.buffer = transformUniformId_;
+    }
+    return allocation;
 }
 
-void LayerCompositor::updateEffectUniforms(const LayerEffect& effect) {
+Rendering::UploadAllocation LayerCompositor::updateEffectUniforms(const LayerEffect& effect) {
     struct EffectUniforms {
         uint32_t effectType;
         uint32_t blendMode;
@@ -1048,24 +1777,53 @@ void LayerCompositor::updateEffectUniforms(const LayerEffect& effect) {
         }
     }
     
-    engine_.updateBuffer(effectUniformId_, &uniforms, sizeof(uniforms));
+    auto allocation = engine_.upload(&uniforms, sizeof(uniforms));
+    if (!allocation.is_valid()) {
+        engine_.updateBuffer(effectUniformId_, &uniforms, sizeof(uniforms));
+        allocation.buffer = effectUniformId_;
+    }
+    return allocation;
 }
 
-Rendering::PipelineId LayerCompositor::getBlendPipeline(BlendMode mode) {
-    auto it = blendPipelines_.find(mode);
-    if (it != blendPipelines_.end()) {
-        return it->second;
+Rendering::PipelineId LayerCompositor::getBlendPipeline(BlendMode mode, float opacity) {
+    // Check custom blend modes
+    if (mode >= BlendMode::Custom) {
+        auto customIt = customBlendPipelines_.find(mode);
+        if (customIt != customBlendPipelines_.end()) {
+            return customIt->second;
+        }
+        
+        // Fallback to Normal blend mode
+        mode = BlendMode::Normal;
     }
     
-    // Check custom blend modes
-    auto customIt = customBlendPipelines_.find(mode);
-    if (customIt != customBlendPipelines_.end()) {
-        return customIt->second;
+    const auto key = blendPermutationKey(mode, opacity);
+    {
+        std::lock_guard<std::mutex> lock(blendPipelinesMutex_);
+        auto it = blendPipelines_.find(key);
+        if (it != blendPipelines_.end()) {
+            return it->second;
+        }
     }
     
-    // Fallback to Normal blend mode
-    auto normalIt = blendPipelines_.find(BlendMode::Normal);
-    return (normalIt != blendPipelines_.end()) ? normalIt->second : 0;
+    auto pipeline = createBlendPipeline(key);
+    
+    std::lock_guard<std::mutex> lock(blendPipelinesMutex_);
+    auto [it, inserted] = blendPipelines_.emplace(key, pipeline);
+    if (!inserted && pipeline != 0) {
+        // Another thread created the same variant first
+        engine_.destroyPipeline(pipeline);
+    }
+    return it->second;
+}
+
+Rendering::PipelineId LayerCompositor::createBlendPipeline(Rendering::PermutationKey key) {
+    // Goes through the compiler so the variant lands in the shader caches
+    auto* compiler = engine_.get_shader_compiler();
+    if (compiler && blendPermutations_ != 0 && !compiler->get_permutation(blendPermutations_, key)) {
+        return 0;
+    }
+    return engine_.createPipeline(blendShaderTemplate().variant_source(key));
 }
 
 std::array<float, 4> LayerCompositor::calculateLayerBounds(const std::vector<Layer*>& layers) {
@@ -1090,45 +1848,171 @@ bool LayerCompositor::layerIntersectsBounds(Layer* layer, const std::array<float
     return LayerUtils::boundsOverlap(layerBounds, bounds);
 }
 
-std::string LayerCompositor::getBlendModeShaderCode(BlendMode mode) {
-    switch (mode) {
-        case BlendMode::Normal:
-            return R"(
-                vec4 blend(vec4 base, vec4 overlay, float opacity) {
-                    return mix(base, overlay, overlay.a * opacity);
-                }
-            )";
-        
-        case BlendMode::Multiply:
-            return R"(
-                vec4 blend(vec4 base, vec4 overlay, float opacity) {
-                    vec3 result = base.rgb * overlay.rgb;
-                    return vec4(mix(base.rgb, result, overlay.a * opacity), base.a);
-                }
-            )";
-        
-        case BlendMode::Screen:
-            return R"(
-                vec4 blend(vec4 base, vec4 overlay, float opacity) {
-                    vec3 result = 1.0 - (1.0 - base.rgb) * (1.0 - overlay.rgb);
-                    return vec4(mix(base.rgb, result, overlay.a * opacity), base.a);
-                }
-            )";
-        
-        case BlendMode::Overlay:
-            return R"(
-                vec4 blend(vec4 base, vec4 overlay, float opacity) {
-                    vec3 result;
-                    result.r = base.r < 0.5 ? 2.0 * base.r * overlay.r : 1.0 - 2.0 * (1.0 - base.r) * (1.0 - overlay.r);
-                    result.g = base.g < 0.5 ? 2.0 * base.g * overlay.g : 1.0 - 2.0 * (1.0 - base.g) * (1.0 - overlay.g);
-                    result.b = base.b < 0.5 ? 2.0 * base.b * overlay.b : 1.0 - 2.0 * (1.0 - base.b) * (1.0 - overlay.b);
-                    return vec4(mix(base.rgb, result, overlay.a * opacity), base.a);
-                }
-            )";
+const Rendering::ShaderPermutationTemplate& LayerCompositor::blendShaderTemplate() {
+    static const Rendering::ShaderPermutationTemplate blendTemplate = [] {
+        Rendering::ShaderPermutationTemplate tmpl;
+        tmpl.name = "layer_blend";
+        tmpl.stage = Rendering::ShaderStage::Fragment;
+        tmpl.entry_point = "fs_main";
+        tmpl.features = {"FULL_OPACITY"};
+        tmpl.constants = {{"BLEND_MODE", 5}};
         
-        default:
-            return getBlendModeShaderCode(BlendMode::Normal);
+        // BLEND_MODE values are the BlendMode enumerators
+        tmpl.source = R"(
+struct BlendUniforms {
+    opacity: f32,
+    padding: vec3<f32>,
+};
+
+@group(0) @binding(0) var<uniform> uniforms: BlendUniforms;
+@group(0) @binding(1) var base_texture: texture_2d<f32>;
+@group(0) @binding(2) var overlay_texture: texture_2d<f32>;
+@group(0) @binding(3) var texture_sampler: sampler;
+
+struct VertexOutput {
+    @builtin(position) position: vec4<f32>,
+    @location(0) uv: vec2<f32>,
+};
+
+fn lum(c: vec3<f32>) -> f32 {
+    return dot(c, vec3<f32>(0.3, 0.59, 0.11));
+}
+
+fn clip_color(c: vec3<f32>) -> vec3<f32> {
+    let l = lum(c);
+    let n = min(min(c.r, c.g), c.b);
+    let x = max(max(c.r, c.g), c.b);
+    var result = c;
+    if (n < 0.0) {
+        result = l + (result - l) * l / (l - n);
+    }
+    if (x > 1.0) {
+        result = l + (result - l) * (1.0 - l) / (x - l);
+    }
+    return result;
+}
+
+fn set_lum(c: vec3<f32>, l: f32) -> vec3<f32> {
+    return clip_color(c + (l - lum(c)));
+}
+
+fn sat(c: vec3<f32>) -> f32 {
+    return max(max(c.r, c.g), c.b) - min(min(c.r, c.g), c.b);
+}
+
+fn set_sat(c: vec3<f32>, s: f32) -> vec3<f32> {
+    let n = min(min(c.r, c.g), c.b);
+    let x = max(max(c.r, c.g), c.b);
+    if (x <= n) {
+        return vec3<f32>(0.0);
+    }
+    return (c - n) * s / (x - n);
+}
+
+fn color_burn(b: vec3<f32>, s: vec3<f32>) -> vec3<f32> {
+    let burned = 1.0 - min(vec3<f32>(1.0), (1.0 - b) / max(s, vec3<f32>(1e-5)));
+    return select(burned, vec3<f32>(1.0), b >= vec3<f32>(1.0));
+}
+
+fn color_dodge(b: vec3<f32>, s: vec3<f32>) -> vec3<f32> {
+    let dodged = min(vec3<f32>(1.0), b / max(1.0 - s, vec3<f32>(1e-5)));
+    return select(dodged, vec3<f32>(0.0), b <= vec3<f32>(0.0));
+}
+
+fn hard_light(b: vec3<f32>, s: vec3<f32>) -> vec3<f32> {
+    let multiplied = b * 2.0 * s;
+    let screened = 1.0 - (1.0 - b) * (1.0 - (2.0 * s - 1.0));
+    return select(screened, multiplied, s <= vec3<f32>(0.5));
+}
+
+fn soft_light(b: vec3<f32>, s: vec3<f32>) -> vec3<f32> {
+    let d = select(sqrt(b), ((16.0 * b - 12.0) * b + 4.0) * b, b <= vec3<f32>(0.25));
+    let darkened = b - (1.0 - 2.0 * s) * b * (1.0 - b);
+    let lightened = b + (2.0 * s - 1.0) * (d - b);
+    return select(lightened, darkened, s <= vec3<f32>(0.5));
+}
+
+fn blend_rgb(b: vec3<f32>, s: vec3<f32>) -> vec3<f32> {
+    switch BLEND_MODE {
+        case 2u: { return min(b, s); }
+        case 3u: { return b * s; }
+        case 4u: { return color_burn(b, s); }
+        case 5u: { return max(b + s - 1.0, vec3<f32>(0.0)); }
+        case 6u: { return select(s, b, lum(b) < lum(s)); }
+        case 7u: { return max(b, s); }
+        case 8u: { return 1.0 - (1.0 - b) * (1.0 - s); }
+        case 9u: { return color_dodge(b, s); }
+        case 10u, 30u: { return min(b + s, vec3<f32>(1.0)); }
+        case 11u: { return select(s, b, lum(b) > lum(s)); }
+        case 12u: { return hard_light(s, b); }
+        case 13u: { return soft_light(b, s); }
+        case 14u: { return hard_light(b, s); }
+        case 15u: {
+            return select(color_dodge(b, 2.0 * (s - 0.5)), color_burn(b, 2.0 * s), s <= vec3<f32>(0.5));
+        }
+        case 16u: { return clamp(b + 2.0 * s - 1.0, vec3<f32>(0.0), vec3<f32>(1.0)); }
+        case 17u: { return select(max(b, 2.0 * s - 1.0), min(b, 2.0 * s), s < vec3<f32>(0.5)); }
+        case 18u: { return select(vec3<f32>(0.0), vec3<f32>(1.0), b + s >= vec3<f32>(1.0)); }
+        case 19u: { return abs(b - s); }
+        case 20u: { return b + s - 2.0 * b * s; }
+        case 21u: { return max(b - s, vec3<f32>(0.0)); }
+        case 22u: { return min(b / max(s, vec3<f32>(1e-5)), vec3<f32>(1.0)); }
+        case 23u: { return set_lum(set_sat(s, sat(b)), lum(b)); }
+        case 24u: { return set_lum(set_sat(b, sat(s)), lum(b)); }
+        case 25u: { return set_lum(s, lum(b)); }
+        case 26u: { return set_lum(b, lum(s)); }
+        default: { return s; }
+    }
+}
+
+@fragment
+fn fs_main(in: VertexOutput) -> @location(0) vec4<f32> {
+    let base = textureSample(base_texture, texture_sampler, in.uv);
+    let overlay = textureSample(overlay_texture, texture_sampler, in.uv);
+    let opacity = select(uniforms.opacity, 1.0, FULL_OPACITY);
+    let alpha = overlay.a * opacity;
+    
+    switch BLEND_MODE {
+        case 1u: {
+            // Dissolve keeps or drops whole pixels
+            let noise = fract(sin(dot(in.position.xy, vec2<f32>(12.9898, 78.233))) * 43758.5453);
+            return select(base, vec4<f32>(overlay.rgb, max(base.a, overlay.a)), noise < alpha);
+        }
+        case 27u: {
+            // Behind paints only where the base is transparent
+            let out_alpha = base.a + alpha * (1.0 - base.a);
+            let rgb = base.rgb * base.a + overlay.rgb * alpha * (1.0 - base.a);
+            return vec4<f32>(rgb / max(out_alpha, 1e-5), out_alpha);
+        }
+        case 28u: {
+            return vec4<f32>(base.rgb, base.a * (1.0 - alpha));
+        }
+        case 29u: {
+            return mix(base, overlay, opacity);
+        }
+        default: {}
+    }
+    
+    let blended = blend_rgb(base.rgb, overlay.rgb);
+    return vec4<f32>(mix(base.rgb, blended, alpha), base.a + alpha * (1.0 - base.a));
+}
+)";
+        return tmpl;
+    }();
+    return blendTemplate;
+}
+
+Rendering::PermutationKey LayerCompositor::blendPermutationKey(BlendMode mode, float opacity) {
+    // Resolved once; constant values are packed linearly, so a mode's key is
+    // a multiple of the key for mode 1
+    static const Rendering::PermutationKey fullOpacityBit = blendShaderTemplate().feature_bit("FULL_OPACITY");
+    static const Rendering::PermutationKey modeUnit = blendShaderTemplate().constant_value("BLEND_MODE", 1);
+    
+    auto key = modeUnit * static_cast<Rendering::PermutationKey>(mode);
+    if (opacity >= 1.0f) {
+        key |= fullOpacityBit;
     }
+    return key;
 }
 
 // LayerUtils implementation
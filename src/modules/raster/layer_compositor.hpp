@@ -1,12 +1,18 @@
 #pragma once
 
+#include "blend_mode.hpp"
+#include "raster_image.hpp"
 #include "../../core/rendering/rendering_engine.hpp"
+#include "../../core/rendering/render_graph.hpp"
+#include "../../core/rendering/shader_compiler.hpp"
 #include "../../core/memory/memory_manager.hpp"
+#include "../../core/kernel/telemetry.hpp"
 #include <memory>
 #include <vector>
 #include <unordered_map>
 #include <string>
 #include <functional>
+#include <list>
 #include <array>
 #include <atomic>
 #include <mutex>
@@ -14,61 +20,9 @@
 namespace QuantumCanvas::Raster {
 
 // Forward declarations
-class Image;
 class Layer;
 class LayerGroup;
 
-// Blend modes supported by the compositor
-enum class BlendMode : uint16_t {
-    // Normal blend modes
-    Normal = 0,
-    Dissolve,
-    
-    // Darkening blend modes
-    Darken,
-    Multiply,
-    ColorBurn,
-    LinearBurn,
-    DarkerColor,
-    
-    // Lightening blend modes
-    Lighten,
-    Screen,
-    ColorDodge,
-    LinearDodge,
-    LighterColor,
-    
-    // Contrast blend modes
-    Overlay,
-    SoftLight,
-    HardLight,
-    VividLight,
-    LinearLight,
-    PinLight,
-    HardMix,
-    
-    // Comparative blend modes
-    Difference,
-    Exclusion,
-    Subtract,
-    Divide,
-    
-    // Component blend modes
-    Hue,
-    Saturation,
-    Color,
-    Luminosity,
-    
-    // Special blend modes
-    Behind,      // Paint behind existing pixels
-    Clear,       // Clear/erase pixels
-    Replace,     // Replace pixels entirely
-    Add,         // Additive blending
-    
-    // Custom blend modes
-    Custom = 1000  // Starting point for user-defined blend modes
-};
-
 // Layer composition flags
 enum class LayerFlags : uint32_t {
     None = 0,
@@ -223,26 +177,26 @@ public:
     
     // Blending properties
     BlendMode getBlendMode() const { return blendMode_; }
-    void setBlendMode(BlendMode mode) { blendMode_ = mode; }
+    void setBlendMode(BlendMode mode) { blendMode_ = mode; markDirty(); }
     float getOpacity() const { return opacity_; }
-    void setOpacity(float opacity) { opacity_ = std::clamp(opacity, 0.0f, 1.0f); }
+    void setOpacity(float opacity) { opacity_ = std::clamp(opacity, 0.0f, 1.0f); markDirty(); }
     
-    // Transform
+    // Transform; call markDirty() after editing through the mutable reference
     const LayerTransform& getTransform() const { return transform_; }
-    void setTransform(const LayerTransform& transform) { transform_ = transform; }
+    void setTransform(const LayerTransform& transform) { transform_ = transform; markDirty(); }
     LayerTransform& getTransform() { return transform_; }
     
-    // Layer mask
+    // Layer mask; call markDirty() after editing through the mutable pointer
     const LayerMask* getMask() const { return mask_.get(); }
     LayerMask* getMask() { return mask_.get(); }
-    void setMask(std::unique_ptr<LayerMask> mask) { mask_ = std::move(mask); }
-    void clearMask() { mask_.reset(); }
+    void setMask(std::unique_ptr<LayerMask> mask) { mask_ = std::move(mask); markDirty(); }
+    void clearMask() { mask_.reset(); markDirty(); }
     bool hasMask() const { return mask_ != nullptr; }
     
-    // Layer effects
-    void addEffect(const LayerEffect& effect) { effects_.push_back(effect); }
+    // Layer effects; call markDirty() after editing through the mutable reference
+    void addEffect(const LayerEffect& effect) { effects_.push_back(effect); markDirty(); }
     void removeEffect(size_t index);
-    void clearEffects() { effects_.clear(); }
+    void clearEffects() { effects_.clear(); markDirty(); }
     const std::vector<LayerEffect>& getEffects() const { return effects_; }
     std::vector<LayerEffect>& getEffects() { return effects_; }
     
@@ -254,11 +208,26 @@ public:
     // Layer type identification
     virtual std::string getLayerType() const = 0;
     
-    // Dirty flag for optimization
+    // Dirty flag for optimization; markDirty() also damages the whole layer
+    // and advances the generation
     bool isDirty() const { return dirty_; }
-    void markDirty() { dirty_ = true; }
+    void markDirty() { dirty_ = true; fullyDamaged_ = true; ++generation_; }
     void markClean() { dirty_ = false; }
     
+    // Changes whenever the layer would composite differently: properties,
+    // mask and effects through the generation, plus content for layers that
+    // have it. Cached composites compare hashes instead of tracking edits.
+    uint64_t getGeneration() const { return generation_; }
+    virtual uint64_t getContentHash() const;
+    
+    // Damage for incremental compositing, in document space. A fully damaged
+    // layer covers what it covered at the last composite plus what it covers
+    // now, so moves and hides repaint both places.
+    void addDamage(const std::array<float, 4>& documentRect);
+    virtual void collectDamage(std::vector<std::array<float, 4>>& damage) const;
+    virtual void clearDamage();  // Called by the compositor once composited
+    std::array<float, 4> getDocumentBounds() const;
+    
     // Serialization
     virtual std::vector<uint8_t> serialize() const;
     virtual bool deserialize(const std::vector<uint8_t>& data);
@@ -273,6 +242,14 @@ protected:
     std::unique_ptr<LayerMask> mask_;
     std::vector<LayerEffect> effects_;
     mutable std::atomic<bool> dirty_{true};
+    uint64_t generation_ = 0;
+    
+    // Damage since the last composite; past MAX_DAMAGE_RECTS rectangles
+    // are merged into their union
+    static constexpr size_t MAX_DAMAGE_RECTS = 32;
+    std::vector<std::array<float, 4>> damageRects_;
+    bool fullyDamaged_ = true;
+    std::array<float, 4> compositedBounds_{0.0f, 0.0f, 0.0f, 0.0f};
     
     static uint32_t nextId_;
 };
@@ -299,6 +276,15 @@ public:
     void resize(const std::array<uint32_t, 2>& newSize);
     void clear(const std::array<float, 4>& color = {0.0f, 0.0f, 0.0f, 0.0f});
     
+    // Undo snapshots share tiles with the layer until either side is painted
+    Image snapshot() const { return image_ ? *image_ : Image{}; }
+    void restoreSnapshot(const Image& snapshot);
+    
+    // Painted tiles of the image count as damage
+    void collectDamage(std::vector<std::array<float, 4>>& damage) const override;
+    void clearDamage() override;
+    uint64_t getContentHash() const override;
+    
     // Serialization
     std::vector<uint8_t> serialize() const override;
     bool deserialize(const std::vector<uint8_t>& data) override;
@@ -390,6 +376,19 @@ public:
     bool isIsolated() const { return hasFlag(getFlags(), LayerFlags::Isolated); }
     void setIsolated(bool isolated);
     
+    // Children's damage, mapped through the group transform
+    void collectDamage(std::vector<std::array<float, 4>>& damage) const override;
+    void clearDamage() override;
+    uint64_t getContentHash() const override;
+    
+    // Covers the children only, i.e. what the flattened composite depends on
+    uint64_t getChildrenHash() const;
+    
+    // Cached composite of the children, kept up to date by LayerCompositor.
+    // It stays valid until the group is next composited; the compositor may
+    // evict it in between.
+    void setCompositeTexture(Rendering::ResourceId texture, const std::array<uint32_t, 2>& size);
+    
     // Serialization
     std::vector<uint8_t> serialize() const override;
     bool deserialize(const std::vector<uint8_t>& data) override;
@@ -420,7 +419,12 @@ public:
     void shutdown();
     bool isInitialized() const { return initialized_; }
     
-    // Layer stack composition
+    // Layer stack composition. Compositing the same stack into the same
+    // target again repaints only the COMPOSITE_TILE_SIZE tiles covered by
+    // layer damage; a different target or stack is repainted in full.
+    // Groups that aren't pass-through keep their own cached composite.
+    static constexpr uint32_t COMPOSITE_TILE_SIZE = Image::TILE_SIZE;
+    
     void compositeToTarget(const std::vector<Layer*>& layers, 
                           Rendering::ResourceId targetTexture,
                           const std::array<uint32_t, 2>& targetSize,
@@ -430,6 +434,26 @@ public:
                                            const std::array<uint32_t, 2>& size,
                                            const std::array<float, 4>& bounds = {0.0f, 0.0f, 0.0f, 0.0f});
     
+    // CPU fallback for machines without a usable GPU adapter and for headless
+    // rendering; works without initialize(). Raster layers and groups are
+    // blended with the kernels in blend_kernels.hpp. Masks, effects and
+    // adjustment layers need the GPU path and are left out, and modes the
+    // kernels lack are blended as Normal.
+    void compositeToImage(const std::vector<Layer*>& layers, Image& target);
+    
+    // Force the next compositeToTarget() to repaint everything, e.g. after
+    // the target's contents were lost
+    void invalidateCompositeCache();
+    void releaseGroupComposites();
+    
+    // Group composites whose children's content hash is unchanged are reused
+    // as they are. Beyond the budget the least recently used ones are freed
+    // after each compositeToTarget(); those it used are kept regardless.
+    static constexpr size_t DEFAULT_GROUP_CACHE_BUDGET = 256ull * 1024 * 1024;
+    void setGroupCacheBudget(size_t bytes) { groupCacheBudget_ = bytes; }
+    size_t getGroupCacheBudget() const { return groupCacheBudget_; }
+    size_t getGroupCacheUsage() const { return groupCacheBytes_; }
+    
     // Single layer composition
     void compositeLayer(Layer* layer,
                        Rendering::ResourceId targetTexture,
@@ -474,6 +498,10 @@ public:
         size_t gpuMemoryUsed = 0;
         uint32_t blendOperations = 0;
         uint32_t transformOperations = 0;
+        uint32_t tilesComposited = 0;   // Repainted this call, including group composites
+        uint32_t tilesReused = 0;       // Left as they were
+        uint32_t groupCacheHits = 0;    // Groups blended from their cached composite unchanged
+        uint32_t groupCacheEvictions = 0;
     };
     
     CompositionStats getStats() const;
@@ -483,8 +511,11 @@ private:
     Rendering::RenderingEngine& engine_;
     std::atomic<bool> initialized_{false};
     
-    // GPU pipelines for different blend modes
-    std::unordered_map<BlendMode, Rendering::PipelineId> blendPipelines_;
+    // Blend pipelines by permutation key; variants outside the precompiled
+    // set are created on first use
+    std::unordered_map<Rendering::PermutationKey, Rendering::PipelineId> blendPipelines_;
+    std::mutex blendPipelinesMutex_;
+    Rendering::PermutationSetId blendPermutations_ = 0;
     Rendering::PipelineId transformPipelineId_ = 0;
     Rendering::PipelineId maskPipelineId_ = 0;
     
@@ -511,12 +542,63 @@ private:
     mutable std::mutex statsMutex_;
     CompositionStats stats_;
     
+    // Rebuilt by every compositeToTarget; effect outputs are graph transients
+    // so deep stacks share a couple of pooled textures
+    std::unique_ptr<Rendering::RenderGraph> frameGraph_;
+    
+    // What a target holds, so the next composite into it can be incremental.
+    // Damage is consumed by the composite that repaints it, which is why only
+    // the last top-level target is tracked.
+    struct CompositeCache {
+        bool valid = false;
+        Rendering::ResourceId target = 0;
+        std::array<uint32_t, 2> size{0, 0};
+        std::vector<uint32_t> layerIds;  // The stack, in order
+    };
+    struct GroupComposite {
+        Rendering::ResourceId texture = 0;
+        CompositeCache cache;
+        uint64_t childrenHash = 0;       // LayerGroup::getChildrenHash() when last composited
+        size_t bytes = 0;
+        uint64_t lastUsed = 0;           // compositeSerial_ of the last use
+        std::list<uint32_t>::iterator lruPosition;
+    };
+    CompositeCache sceneCache_;
+    std::unordered_map<uint32_t, GroupComposite> groupComposites_;  // By group layer id
+    std::list<uint32_t> groupLru_;                                  // Group ids, most recently used first
+    size_t groupCacheBudget_ = DEFAULT_GROUP_CACHE_BUDGET;
+    size_t groupCacheBytes_ = 0;
+    uint64_t compositeSerial_ = 0;
+    std::vector<std::array<int32_t, 4>> compositeRegions_;          // Scissor rects {x, y, w, h} of the graph being recorded
+    Rendering::PipelineId clearRegionPipelineId_ = 0;
+    
+    Core::Telemetry::SourceRegistration telemetrySource_;
+    
     // Internal methods
+    void registerTelemetry();
     bool createBlendPipelines();
     bool createEffectPipelines();
     bool createUniformBuffers();
     void destroyResources();
     
+    // Returns the number of tiles repainted
+    size_t compositeStack(const std::vector<Layer*>& layers,
+                          Rendering::ResourceId targetTexture,
+                          const std::array<uint32_t, 2>& targetSize,
+                          const std::array<float, 4>& bounds,
+                          CompositeCache& cache);
+    void updateGroupComposite(LayerGroup* group, const std::array<uint32_t, 2>& size);
+    void trimGroupComposites();
+    
+    // CPU path
+    uint32_t compositeLayerToImage(Layer* layer, Image& target);
+    void blendLayerImage(const Layer* layer, const Image& source, Image& target, BlendMode mode);
+    
+    Rendering::RGResourceHandle addLayerPasses(Rendering::RenderGraph& graph,
+                                               Layer* layer,
+                                               Rendering::RGResourceHandle target,
+                                               const std::array<uint32_t, 2>& targetSize);
+    
     void applyLayerTransform(Layer* layer, const std::array<uint32_t, 2>& targetSize);
     void applyLayerMask(Layer* layer, Rendering::ResourceId sourceTexture);
     void applyLayerEffect(const LayerEffect& effect, 
@@ -524,18 +606,24 @@ private:
                          Rendering::ResourceId targetTexture,
                          const std::array<uint32_t, 2>& size);
     
-    void updateBlendUniforms(BlendMode mode, float opacity);
-    void updateTransformUniforms(const LayerTransform& transform, 
+    // Uniforms go through the engine's upload ring, so every draw keeps its
+    // own values; the fixed buffers are only used when the ring is full
+    Rendering::UploadAllocation updateBlendUniforms(float opacity);
+    Rendering::UploadAllocation updateTransformUniforms(const LayerTransform& transform, 
                                 const std::array<uint32_t, 2>& targetSize);
-    void updateEffectUniforms(const LayerEffect& effect);
+    Rendering::UploadAllocation updateEffectUniforms(const LayerEffect& effect);
     
-    Rendering::PipelineId getBlendPipeline(BlendMode mode);
+    Rendering::PipelineId getBlendPipeline(BlendMode mode, float opacity);
+    Rendering::PipelineId createBlendPipeline(Rendering::PermutationKey key);
     
     std::array<float, 4> calculateLayerBounds(const std::vector<Layer*>& layers);
     bool layerIntersectsBounds(Layer* layer, const std::array<float, 4>& bounds);
     
-    // Blend mode implementations (used by shaders)
-    static std::string getBlendModeShaderCode(BlendMode mode);
+    // All blend modes are permutations of one shader: the mode is the
+    // BLEND_MODE specialization constant and opacity 1 the FULL_OPACITY bit,
+    // so a variant never branches on the mode at runtime
+    static const Rendering::ShaderPermutationTemplate& blendShaderTemplate();
+    static Rendering::PermutationKey blendPermutationKey(BlendMode mode, float opacity);
 };
 
 // Utility functions for layer composition
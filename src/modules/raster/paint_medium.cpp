@@ -0,0 +1,405 @@
+#include "paint_medium.hpp"
+#include "../../core/kernel/task_scheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace QuantumCanvas::Raster {
+
+namespace {
+
+constexpr uint32_t CELLS = PaintMedium::TILE_CELLS;
+constexpr uint32_t PADDED = CELLS + 2;
+
+// Largest flow rate per step for which the explicit five-point update stays
+// stable; faster flows take several substeps
+constexpr float MAX_STEP_RATE = 0.2f;
+
+// How readily a cell with this much water passes pigment on
+inline float mobility(float water) {
+    return water / (water + 0.05f);
+}
+
+} // namespace
+
+// BristleSet implementation
+void BristleSet::reset(uint32_t count, float spread, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    restX_.resize(count);
+    restY_.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        // Uniform over the disc rather than bunched at the centre
+        float angle = unit(rng) * 6.28318530718f;
+        float radius = std::sqrt(unit(rng)) * spread;
+        restX_[i] = radius * std::cos(angle);
+        restY_[i] = radius * std::sin(angle);
+    }
+
+    x_ = restX_;
+    y_ = restY_;
+    vx_.assign(count, 0.0f);
+    vy_.assign(count, 0.0f);
+    pressure_.assign(count, 1.0f);
+}
+
+void BristleSet::clear() {
+    for (auto* v : {&restX_, &restY_, &x_, &y_, &vx_, &vy_, &pressure_}) {
+        v->clear();
+    }
+}
+
+void BristleSet::step(float centerX, float centerY, float radius, float pressure,
+                      float stiffness, float damping) {
+    const size_t n = x_.size();
+    const float spring = stiffness * 0.1f;
+    const float inverseRadius = radius > 0.0f ? 1.0f / radius : 0.0f;
+
+    float* x = x_.data();
+    float* y = y_.data();
+    float* vx = vx_.data();
+    float* vy = vy_.data();
+    float* p = pressure_.data();
+    const float* restX = restX_.data();
+    const float* restY = restY_.data();
+
+    // Separate loops without branches, so each one vectorizes on its own
+    for (size_t i = 0; i < n; ++i) {
+        vx[i] = (vx[i] + (centerX + restX[i] * radius - x[i]) * spring) * damping;
+        vy[i] = (vy[i] + (centerY + restY[i] * radius - y[i]) * spring) * damping;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        x[i] += vx[i];
+        y[i] += vy[i];
+    }
+    for (size_t i = 0; i < n; ++i) {
+        float dx = x[i] - centerX;
+        float dy = y[i] - centerY;
+        float distance = std::sqrt(dx * dx + dy * dy) * inverseRadius;
+        p[i] = std::max(0.1f, 1.0f - distance) * pressure;
+    }
+}
+
+// PaintMedium implementation
+struct PaintMedium::Tile {
+    // Planar: water, then premultiplied r, g, b, a
+    std::array<std::array<float, CELLS * CELLS>, 5> cells{};
+    std::array<std::array<float, CELLS * CELLS>, 5> next{};
+    bool wet = false;
+};
+
+PaintMedium::PaintMedium() = default;
+
+PaintMedium::PaintMedium(uint32_t width, uint32_t height) {
+    reset(width, height);
+}
+
+PaintMedium::~PaintMedium() = default;
+PaintMedium::PaintMedium(PaintMedium&&) noexcept = default;
+PaintMedium& PaintMedium::operator=(PaintMedium&&) noexcept = default;
+
+void PaintMedium::reset(uint32_t width, uint32_t height) {
+    width_ = width;
+    height_ = height;
+    tilesX_ = (width + CELLS - 1) / CELLS;
+    tilesY_ = (height + CELLS - 1) / CELLS;
+    tiles_.clear();
+    tiles_.resize(static_cast<size_t>(tilesX_) * tilesY_);
+    wet_.clear();
+}
+
+void PaintMedium::setParameters(float viscosity, float diffusion, float evaporation) {
+    viscosity_ = std::max(0.0f, viscosity);
+    diffusion_ = std::max(0.0f, diffusion);
+    evaporation_ = std::clamp(evaporation, 0.0f, 1.0f);
+}
+
+PaintMedium::Tile& PaintMedium::ensureTile(uint32_t tileX, uint32_t tileY) {
+    auto& tile = tiles_[static_cast<size_t>(tileY) * tilesX_ + tileX];
+    if (!tile) {
+        tile = std::make_unique<Tile>();
+    }
+    return *tile;
+}
+
+void PaintMedium::markWet(uint32_t index) {
+    Tile& tile = *tiles_[index];
+    if (!tile.wet) {
+        tile.wet = true;
+        wet_.push_back(index);
+    }
+}
+
+void PaintMedium::deposit(float x, float y, float radius, const std::array<float, 4>& color, float water) {
+    if (radius <= 0.0f || width_ == 0 || height_ == 0) {
+        return;
+    }
+
+    auto clampTo = [](float value, uint32_t limit) {
+        return static_cast<uint32_t>(std::clamp(value, 0.0f, static_cast<float>(limit)));
+    };
+    uint32_t x0 = clampTo(std::floor(x - radius), width_);
+    uint32_t y0 = clampTo(std::floor(y - radius), height_);
+    uint32_t x1 = clampTo(std::ceil(x + radius), width_);
+    uint32_t y1 = clampTo(std::ceil(y + radius), height_);
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    for (uint32_t ty = y0 / CELLS; ty <= (y1 - 1) / CELLS; ++ty) {
+        for (uint32_t tx = x0 / CELLS; tx <= (x1 - 1) / CELLS; ++tx) {
+            Tile& tile = ensureTile(tx, ty);
+            uint32_t originX = tx * CELLS;
+            uint32_t originY = ty * CELLS;
+
+            for (uint32_t cy = std::max(y0, originY); cy < std::min(y1, originY + CELLS); ++cy) {
+                for (uint32_t cx = std::max(x0, originX); cx < std::min(x1, originX + CELLS); ++cx) {
+                    float dx = cx + 0.5f - x;
+                    float dy = cy + 0.5f - y;
+                    float coverage = 1.0f - std::sqrt(dx * dx + dy * dy) / radius;
+                    if (coverage <= 0.0f) {
+                        continue;
+                    }
+
+                    size_t i = (cy - originY) * CELLS + (cx - originX);
+                    float alpha = std::clamp(color[3] * coverage, 0.0f, 1.0f);
+                    tile.cells[0][i] += water * coverage;
+                    for (int c = 0; c < 3; ++c) {
+                        tile.cells[c + 1][i] = color[c] * alpha + tile.cells[c + 1][i] * (1.0f - alpha);
+                    }
+                    tile.cells[4][i] = alpha + tile.cells[4][i] * (1.0f - alpha);
+                }
+            }
+            markWet(ty * tilesX_ + tx);
+        }
+    }
+}
+
+void PaintMedium::spreadToNeighbours() {
+    // Water at a tile border would flow into the neighbour, so it has to be
+    // simulated too. Only borders are scanned; new tiles join the wet list
+    // and are checked in the same pass.
+    for (size_t w = 0; w < wet_.size(); ++w) {
+        uint32_t index = wet_[w];
+        uint32_t tx = index % tilesX_;
+        uint32_t ty = index / tilesX_;
+        const auto& water = tiles_[index]->cells[0];
+
+        auto borderWet = [&](uint32_t start, uint32_t stride) {
+            for (uint32_t k = 0; k < CELLS; ++k) {
+                if (water[start + k * stride] >= DRY_WATER) {
+                    return true;
+                }
+            }
+            return false;
+        };
+        auto spread = [&](uint32_t nx, uint32_t ny) {
+            ensureTile(nx, ny);
+            markWet(ny * tilesX_ + nx);
+        };
+
+        if (tx > 0 && borderWet(0, CELLS)) {
+            spread(tx - 1, ty);
+        }
+        if (tx + 1 < tilesX_ && borderWet(CELLS - 1, CELLS)) {
+            spread(tx + 1, ty);
+        }
+        if (ty > 0 && borderWet(0, 1)) {
+            spread(tx, ty - 1);
+        }
+        if (ty + 1 < tilesY_ && borderWet((CELLS - 1) * CELLS, 1)) {
+            spread(tx, ty + 1);
+        }
+    }
+}
+
+void PaintMedium::step(float deltaTime) {
+    if (wet_.empty() || deltaTime <= 0.0f) {
+        return;
+    }
+
+    float rate = diffusion_ * deltaTime / (1.0f + viscosity_);
+    int substeps = std::max(1, static_cast<int>(std::ceil(rate / MAX_STEP_RATE)));
+    rate /= substeps;
+
+    for (int s = 0; s < substeps && rate > 0.0f; ++s) {
+        spreadToNeighbours();
+
+        Core::parallel_for(0, wet_.size(), 1, [&](size_t w) {
+            uint32_t index = wet_[w];
+            uint32_t tx = index % tilesX_;
+            uint32_t ty = index / tilesX_;
+            Tile& tile = *tiles_[index];
+
+            // Gather the tile with a one-cell halo. Missing neighbours and the
+            // canvas edge mirror the border cell, so nothing flows out there.
+            const Tile* left = tx > 0 ? tiles_[index - 1].get() : nullptr;
+            const Tile* right = tx + 1 < tilesX_ ? tiles_[index + 1].get() : nullptr;
+            const Tile* up = ty > 0 ? tiles_[index - tilesX_].get() : nullptr;
+            const Tile* down = ty + 1 < tilesY_ ? tiles_[index + tilesX_].get() : nullptr;
+
+            std::array<std::array<float, PADDED * PADDED>, 5> padded;
+            for (int q = 0; q < 5; ++q) {
+                const auto& own = tile.cells[q];
+                auto& dst = padded[q];
+                for (uint32_t y = 0; y < CELLS; ++y) {
+                    std::copy_n(own.data() + y * CELLS, CELLS, dst.data() + (y + 1) * PADDED + 1);
+                    dst[(y + 1) * PADDED] = left ? left->cells[q][y * CELLS + CELLS - 1] : own[y * CELLS];
+                    dst[(y + 1) * PADDED + CELLS + 1] = right ? right->cells[q][y * CELLS] : own[y * CELLS + CELLS - 1];
+                }
+                for (uint32_t x = 0; x < CELLS; ++x) {
+                    dst[x + 1] = up ? up->cells[q][(CELLS - 1) * CELLS + x] : own[x];
+                    dst[(CELLS + 1) * PADDED + x + 1] = down ? down->cells[q][x] : own[(CELLS - 1) * CELLS + x];
+                }
+            }
+
+            const float* water = padded[0].data();
+            for (uint32_t y = 0; y < CELLS; ++y) {
+                const size_t row = (y + 1) * PADDED + 1;
+                float* nextWater = tile.next[0].data() + y * CELLS;
+                for (uint32_t x = 0; x < CELLS; ++x) {
+                    size_t i = row + x;
+                    nextWater[x] = water[i] + rate * (water[i - 1] + water[i + 1] + water[i - PADDED] +
+                                                      water[i + PADDED] - 4.0f * water[i]);
+                }
+
+                // Pigment crosses an edge only as far as the drier side allows,
+                // the same in both directions, so none is created or lost
+                for (int q = 1; q < 5; ++q) {
+                    const float* p = padded[q].data();
+                    float* nextPigment = tile.next[q].data() + y * CELLS;
+                    for (uint32_t x = 0; x < CELLS; ++x) {
+                        size_t i = row + x;
+                        float flow = mobility(std::min(water[i], water[i - 1])) * (p[i - 1] - p[i]) +
+                                     mobility(std::min(water[i], water[i + 1])) * (p[i + 1] - p[i]) +
+                                     mobility(std::min(water[i], water[i - PADDED])) * (p[i - PADDED] - p[i]) +
+                                     mobility(std::min(water[i], water[i + PADDED])) * (p[i + PADDED] - p[i]);
+                        nextPigment[x] = p[i] + rate * flow;
+                    }
+                }
+            }
+        });
+
+        for (uint32_t index : wet_) {
+            std::swap(tiles_[index]->cells, tiles_[index]->next);
+        }
+    }
+
+    // Evaporate, then drop tiles that have dried from the wet list
+    const float keep = std::max(0.0f, 1.0f - evaporation_ * deltaTime);
+    Core::parallel_for(0, wet_.size(), 1, [&](size_t w) {
+        Tile& tile = *tiles_[wet_[w]];
+        float wettest = 0.0f;
+        for (float& water : tile.cells[0]) {
+            water *= keep;
+            wettest = std::max(wettest, water);
+        }
+        tile.wet = wettest >= DRY_WATER;
+    });
+    wet_.erase(std::remove_if(wet_.begin(), wet_.end(), [&](uint32_t index) { return !tiles_[index]->wet; }),
+               wet_.end());
+}
+
+size_t PaintMedium::releaseDryTiles(Image& canvas) {
+    if (canvas.getSize() != std::array<uint32_t, 2>{width_, height_}) {
+        return 0;
+    }
+
+    size_t released = 0;
+    for (uint32_t index = 0; index < tiles_.size(); ++index) {
+        auto& tile = tiles_[index];
+        if (!tile || tile->wet) {
+            continue;
+        }
+
+        uint32_t originX = (index % tilesX_) * CELLS;
+        uint32_t originY = (index / tilesX_) * CELLS;
+        const auto& alphaPlane = tile->cells[4];
+        if (std::any_of(alphaPlane.begin(), alphaPlane.end(), [](float a) { return a > 0.0f; })) {
+            // A medium tile never straddles two canvas tiles
+            float* dst = canvas.mutableTileData(originX / Image::TILE_SIZE, originY / Image::TILE_SIZE);
+            uint32_t localX = originX % Image::TILE_SIZE;
+            uint32_t localY = originY % Image::TILE_SIZE;
+
+            for (uint32_t y = 0; y < CELLS && originY + y < height_; ++y) {
+                for (uint32_t x = 0; x < CELLS && originX + x < width_; ++x) {
+                    size_t i = y * CELLS + x;
+                    float a = std::min(alphaPlane[i], 1.0f);
+                    if (a <= 0.0f) {
+                        continue;
+                    }
+
+                    float* pixel = dst + (localY + y) * Image::TILE_STRIDE + (localX + x) * Image::CHANNELS;
+                    float baseAlpha = pixel[3] * (1.0f - a);
+                    float outAlpha = a + baseAlpha;
+                    for (int c = 0; c < 3; ++c) {
+                        pixel[c] = (tile->cells[c + 1][i] + pixel[c] * baseAlpha) / outAlpha;
+                    }
+                    pixel[3] = outAlpha;
+                }
+            }
+        }
+
+        tile.reset();
+        ++released;
+    }
+    return released;
+}
+
+void PaintMedium::renderWet(Image& overlay) const {
+    if (overlay.getSize() != std::array<uint32_t, 2>{width_, height_}) {
+        return;
+    }
+
+    for (uint32_t index : wet_) {
+        const Tile& tile = *tiles_[index];
+        uint32_t originX = (index % tilesX_) * CELLS;
+        uint32_t originY = (index / tilesX_) * CELLS;
+        float* dst = overlay.mutableTileData(originX / Image::TILE_SIZE, originY / Image::TILE_SIZE);
+        uint32_t localX = originX % Image::TILE_SIZE;
+        uint32_t localY = originY % Image::TILE_SIZE;
+
+        for (uint32_t y = 0; y < CELLS && originY + y < height_; ++y) {
+            for (uint32_t x = 0; x < CELLS && originX + x < width_; ++x) {
+                size_t i = y * CELLS + x;
+                float a = std::min(tile.cells[4][i], 1.0f);
+                float* pixel = dst + (localY + y) * Image::TILE_STRIDE + (localX + x) * Image::CHANNELS;
+                for (int c = 0; c < 3; ++c) {
+                    pixel[c] = a > 0.0f ? tile.cells[c + 1][i] / a : 0.0f;
+                }
+                pixel[3] = a;
+            }
+        }
+    }
+}
+
+float PaintMedium::water(uint32_t x, uint32_t y) const {
+    if (x >= width_ || y >= height_) {
+        return 0.0f;
+    }
+    const auto& tile = tiles_[(y / CELLS) * tilesX_ + x / CELLS];
+    return tile ? tile->cells[0][(y % CELLS) * CELLS + x % CELLS] : 0.0f;
+}
+
+std::array<float, 4> PaintMedium::pigment(uint32_t x, uint32_t y) const {
+    if (x >= width_ || y >= height_) {
+        return {0.0f, 0.0f, 0.0f, 0.0f};
+    }
+    const auto& tile = tiles_[(y / CELLS) * tilesX_ + x / CELLS];
+    if (!tile) {
+        return {0.0f, 0.0f, 0.0f, 0.0f};
+    }
+    size_t i = (y % CELLS) * CELLS + x % CELLS;
+    return {tile->cells[1][i], tile->cells[2][i], tile->cells[3][i], tile->cells[4][i]};
+}
+
+size_t PaintMedium::tileCount() const {
+    return std::count_if(tiles_.begin(), tiles_.end(), [](const auto& tile) { return tile != nullptr; });
+}
+
+size_t PaintMedium::wetTileCount() const {
+    return wet_.size();
+}
+
+} // namespace QuantumCanvas::Raster
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "raster_image.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace QuantumCanvas::Raster {
+
+// Bristles of a bristle brush, one array per quantity, so that each update
+// is a handful of straight loops over floats that the compiler vectorizes.
+// Bristles are springs pulling towards their rest offset from the brush
+// centre, scaled by the brush radius.
+class BristleSet {
+public:
+    // Rest offsets are spread over a disc of the given radius (in brush
+    // radii), deterministically for a given seed
+    void reset(uint32_t count, float spread, uint32_t seed = 1);
+    void clear();
+
+    size_t size() const { return x_.size(); }
+    bool empty() const { return x_.empty(); }
+
+    // One simulation step towards a dab at (centerX, centerY). Each
+    // bristle's pressure falls off with its distance from the centre.
+    void step(float centerX, float centerY, float radius, float pressure,
+              float stiffness, float damping = 0.9f);
+
+    const float* x() const { return x_.data(); }
+    const float* y() const { return y_.data(); }
+    const float* pressure() const { return pressure_.data(); }
+
+private:
+    std::vector<float> restX_;
+    std::vector<float> restY_;
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> vx_;
+    std::vector<float> vy_;
+    std::vector<float> pressure_;
+};
+
+// Wet paint sitting on a canvas, one cell per canvas pixel. Water and the
+// premultiplied pigment it carries diffuse between neighbouring cells and
+// the water evaporates. Cells live in sparse TILE_CELLS-square tiles that
+// exist only where paint was deposited or has flowed, and only wet tiles
+// are simulated, in parallel on the shared scheduler. Cost therefore
+// follows the wet area around the brush, not the canvas size. Tiles that
+// have dried are composited into the canvas and dropped by releaseDryTiles().
+class PaintMedium {
+public:
+    static constexpr uint32_t TILE_CELLS = 32;
+
+    // Below this much water a cell no longer moves pigment, and a tile
+    // whose cells are all below it is dry
+    static constexpr float DRY_WATER = 1e-3f;
+
+    PaintMedium();
+    PaintMedium(uint32_t width, uint32_t height);
+    ~PaintMedium();
+
+    PaintMedium(PaintMedium&&) noexcept;
+    PaintMedium& operator=(PaintMedium&&) noexcept;
+
+    // Discards all paint
+    void reset(uint32_t width, uint32_t height);
+    uint32_t width() const { return width_; }
+    uint32_t height() const { return height_; }
+
+    // Viscosity slows the flow; diffusion is the flow rate of thin paint in
+    // cells per second; evaporation is the fraction of water lost per second
+    void setParameters(float viscosity, float diffusion, float evaporation);
+
+    // Adds water over a disc and mixes the color into the pigment there
+    void deposit(float x, float y, float radius, const std::array<float, 4>& color, float water);
+
+    void step(float deltaTime);
+
+    // Composites the pigment of dry tiles over the image (Normal, straight
+    // RGBA) and frees them. The image must be the medium's size.
+    size_t releaseDryTiles(Image& canvas);
+
+    // Draws the wet paint into an overlay of the medium's size, straight
+    // RGBA, leaving the rest of it untouched
+    void renderWet(Image& overlay) const;
+
+    float water(uint32_t x, uint32_t y) const;
+    std::array<float, 4> pigment(uint32_t x, uint32_t y) const;  // Premultiplied
+
+    size_t tileCount() const;
+    size_t wetTileCount() const;
+
+private:
+    struct Tile;
+
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    uint32_t tilesX_ = 0;
+    uint32_t tilesY_ = 0;
+    std::vector<std::unique_ptr<Tile>> tiles_;
+    std::vector<uint32_t> wet_;  // Indices of wet tiles
+
+    float viscosity_ = 0.5f;
+    float diffusion_ = 0.1f;
+    float evaporation_ = 0.01f;
+
+    Tile& ensureTile(uint32_t tileX, uint32_t tileY);
+    void markWet(uint32_t index);
+    void spreadToNeighbours();
+};
+
+} // namespace QuantumCanvas::Raster
@@ -0,0 +1,297 @@
+#include "raster_image.hpp"
+#include <algorithm>
+
+namespace QuantumCanvas::Raster {
+
+namespace {
+
+uint32_t tilesFor(uint32_t pixels) {
+    return (pixels + Image::TILE_SIZE - 1) / Image::TILE_SIZE;
+}
+
+size_t pixelOffset(uint32_t localX, uint32_t localY) {
+    return localY * Image::TILE_STRIDE + localX * Image::CHANNELS;
+}
+
+} // namespace
+
+Image::Image(uint32_t width, uint32_t height, const Pixel& fill) {
+    reset(width, height, fill);
+}
+
+Image::Image(const Image& other)
+    : width_(other.width_)
+    , height_(other.height_)
+    , tilesX_(other.tilesX_)
+    , tilesY_(other.tilesY_)
+    , fill_(other.fill_)
+    , tiles_(other.tiles_)
+    , dirty_(other.dirty_)
+    , generation_(other.generation()) {}
+
+Image& Image::operator=(const Image& other) {
+    if (this != &other) {
+        width_ = other.width_;
+        height_ = other.height_;
+        tilesX_ = other.tilesX_;
+        tilesY_ = other.tilesY_;
+        fill_ = other.fill_;
+        tiles_ = other.tiles_;
+        dirty_ = other.dirty_;
+        generation_.store(other.generation(), std::memory_order_relaxed);
+    }
+    return *this;
+}
+
+Image::Pixel Image::getPixel(uint32_t x, uint32_t y) const {
+    if (x >= width_ || y >= height_) {
+        return {0.0f, 0.0f, 0.0f, 0.0f};
+    }
+
+    const auto& tile = tiles_[(y / TILE_SIZE) * tilesX_ + x / TILE_SIZE];
+    if (!tile) {
+        return fill_;
+    }
+
+    const float* p = tile->pixels.data() + pixelOffset(x % TILE_SIZE, y % TILE_SIZE);
+    return {p[0], p[1], p[2], p[3]};
+}
+
+void Image::setPixel(uint32_t x, uint32_t y, const Pixel& color) {
+    if (x >= width_ || y >= height_) {
+        return;
+    }
+
+    uint32_t tileX = x / TILE_SIZE;
+    uint32_t tileY = y / TILE_SIZE;
+
+    // Writing the fill color into an unallocated tile changes nothing
+    if (!tiles_[tileY * tilesX_ + tileX] && color == fill_) {
+        return;
+    }
+
+    float* p = mutableTileData(tileX, tileY) + pixelOffset(x % TILE_SIZE, y % TILE_SIZE);
+    p[0] = color[0];
+    p[1] = color[1];
+    p[2] = color[2];
+    p[3] = color[3];
+}
+
+Image::Pixel Image::sampleBilinear(float x, float y) const {
+    if (empty()) {
+        return {0.0f, 0.0f, 0.0f, 0.0f};
+    }
+
+    x = std::clamp(x, 0.0f, static_cast<float>(width_ - 1));
+    y = std::clamp(y, 0.0f, static_cast<float>(height_ - 1));
+
+    int x1 = static_cast<int>(x);
+    int y1 = static_cast<int>(y);
+    int x2 = std::min(x1 + 1, static_cast<int>(width_ - 1));
+    int y2 = std::min(y1 + 1, static_cast<int>(height_ - 1));
+
+    float fx = x - x1;
+    float fy = y - y1;
+
+    auto p11 = getPixel(x1, y1);
+    auto p12 = getPixel(x1, y2);
+    auto p21 = getPixel(x2, y1);
+    auto p22 = getPixel(x2, y2);
+
+    Pixel result;
+    for (int i = 0; i < 4; ++i) {
+        float top = p11[i] * (1 - fx) + p21[i] * fx;
+        float bottom = p12[i] * (1 - fx) + p22[i] * fx;
+        result[i] = top * (1 - fy) + bottom * fy;
+    }
+
+    return result;
+}
+
+void Image::reset(uint32_t width, uint32_t height, const Pixel& fill) {
+    width_ = width;
+    height_ = height;
+    tilesX_ = tilesFor(width);
+    tilesY_ = tilesFor(height);
+    fill_ = fill;
+    tiles_.assign(size_t(tilesX_) * tilesY_, nullptr);
+    dirty_.assign(tiles_.size(), 1);
+    generation_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Image::resize(const std::array<uint32_t, 2>& newSize) {
+    uint32_t newTilesX = tilesFor(newSize[0]);
+    uint32_t newTilesY = tilesFor(newSize[1]);
+
+    std::vector<std::shared_ptr<Tile>> tiles(size_t(newTilesX) * newTilesY);
+    for (uint32_t ty = 0; ty < std::min(tilesY_, newTilesY); ++ty) {
+        for (uint32_t tx = 0; tx < std::min(tilesX_, newTilesX); ++tx) {
+            tiles[ty * newTilesX + tx] = std::move(tiles_[ty * tilesX_ + tx]);
+        }
+    }
+
+    bool shrankX = newSize[0] < width_;
+    bool shrankY = newSize[1] < height_;
+
+    width_ = newSize[0];
+    height_ = newSize[1];
+    tilesX_ = newTilesX;
+    tilesY_ = newTilesY;
+    tiles_ = std::move(tiles);
+    dirty_.assign(tiles_.size(), 1);
+    generation_.fetch_add(1, std::memory_order_relaxed);
+
+    // Edge tiles that now straddle the border still hold the cropped pixels;
+    // reset them so that growing again exposes the fill color
+    for (uint32_t ty = 0; ty < tilesY_; ++ty) {
+        for (uint32_t tx = 0; tx < tilesX_; ++tx) {
+            bool edge = (shrankX && tx == tilesX_ - 1) || (shrankY && ty == tilesY_ - 1);
+            if (edge && tiles_[ty * tilesX_ + tx]) {
+                mutableTileData(tx, ty);
+                fillOutside(*tiles_[ty * tilesX_ + tx], tx, ty);
+            }
+        }
+    }
+}
+
+void Image::clear(const Pixel& color) {
+    fill_ = color;
+    std::fill(tiles_.begin(), tiles_.end(), nullptr);
+    std::fill(dirty_.begin(), dirty_.end(), 1);
+    generation_.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t Image::compact() {
+    size_t released = 0;
+    for (auto& tile : tiles_) {
+        if (!tile) {
+            continue;
+        }
+
+        bool uniform = true;
+        for (size_t i = 0; i < TILE_FLOATS && uniform; i += CHANNELS) {
+            uniform = tile->pixels[i + 0] == fill_[0] && tile->pixels[i + 1] == fill_[1] &&
+                      tile->pixels[i + 2] == fill_[2] && tile->pixels[i + 3] == fill_[3];
+        }
+
+        if (uniform) {
+            tile.reset();
+            ++released;
+        }
+    }
+    return released;
+}
+
+bool Image::isTileAllocated(uint32_t tileX, uint32_t tileY) const {
+    return tileX < tilesX_ && tileY < tilesY_ && tiles_[tileY * tilesX_ + tileX] != nullptr;
+}
+
+bool Image::isTileShared(uint32_t tileX, uint32_t tileY) const {
+    return isTileAllocated(tileX, tileY) && tiles_[tileY * tilesX_ + tileX].use_count() > 1;
+}
+
+const float* Image::tileData(uint32_t tileX, uint32_t tileY) const {
+    if (!isTileAllocated(tileX, tileY)) {
+        return nullptr;
+    }
+    return tiles_[tileY * tilesX_ + tileX]->pixels.data();
+}
+
+float* Image::mutableTileData(uint32_t tileX, uint32_t tileY) {
+    if (tileX >= tilesX_ || tileY >= tilesY_) {
+        return nullptr;
+    }
+
+    // Whoever records the generation also clears the dirty tiles, so counting
+    // clean-to-dirty transitions catches every later write
+    auto& dirty = dirty_[tileY * tilesX_ + tileX];
+    if (!dirty) {
+        dirty = 1;
+        generation_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    auto& tile = tiles_[tileY * tilesX_ + tileX];
+    if (!tile) {
+        tile = makeFilledTile();
+    } else if (tile.use_count() > 1) {
+        tile = std::make_shared<Tile>(*tile);
+    }
+    return tile->pixels.data();
+}
+
+bool Image::isRegionUniform(int64_t x0, int64_t y0, int64_t x1, int64_t y1) const {
+    x0 = std::max<int64_t>(x0, 0);
+    y0 = std::max<int64_t>(y0, 0);
+    x1 = std::min<int64_t>(x1, width_);
+    y1 = std::min<int64_t>(y1, height_);
+    if (x0 >= x1 || y0 >= y1) {
+        return true;
+    }
+
+    for (int64_t ty = y0 / TILE_SIZE; ty <= (y1 - 1) / TILE_SIZE; ++ty) {
+        for (int64_t tx = x0 / TILE_SIZE; tx <= (x1 - 1) / TILE_SIZE; ++tx) {
+            if (tiles_[ty * tilesX_ + tx]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool Image::hasDirtyTiles() const {
+    return std::find(dirty_.begin(), dirty_.end(), 1) != dirty_.end();
+}
+
+std::vector<std::array<uint32_t, 4>> Image::getDirtyRects() const {
+    std::vector<std::array<uint32_t, 4>> rects;
+    for (uint32_t ty = 0; ty < tilesY_; ++ty) {
+        for (uint32_t tx = 0; tx < tilesX_; ++tx) {
+            if (dirty_[ty * tilesX_ + tx]) {
+                rects.push_back({tx * TILE_SIZE, ty * TILE_SIZE,
+                                 std::min((tx + 1) * TILE_SIZE, width_),
+                                 std::min((ty + 1) * TILE_SIZE, height_)});
+            }
+        }
+    }
+    return rects;
+}
+
+void Image::clearDirtyTiles() {
+    std::fill(dirty_.begin(), dirty_.end(), 0);
+}
+
+size_t Image::allocatedTileCount() const {
+    return static_cast<size_t>(std::count_if(tiles_.begin(), tiles_.end(),
+                                             [](const auto& tile) { return tile != nullptr; }));
+}
+
+size_t Image::memoryUsage() const {
+    return allocatedTileCount() * sizeof(Tile);
+}
+
+size_t Image::uniqueMemoryUsage() const {
+    size_t count = static_cast<size_t>(std::count_if(tiles_.begin(), tiles_.end(),
+                                                     [](const auto& tile) { return tile && tile.use_count() == 1; }));
+    return count * sizeof(Tile);
+}
+
+std::shared_ptr<Image::Tile> Image::makeFilledTile() const {
+    auto tile = std::make_shared_for_overwrite<Tile>();
+    for (size_t i = 0; i < TILE_FLOATS; i += CHANNELS) {
+        std::copy(fill_.begin(), fill_.end(), tile->pixels.begin() + i);
+    }
+    return tile;
+}
+
+void Image::fillOutside(Tile& tile, uint32_t tileX, uint32_t tileY) {
+    uint32_t validX = std::min(TILE_SIZE, width_ - tileX * TILE_SIZE);
+    uint32_t validY = std::min(TILE_SIZE, height_ - tileY * TILE_SIZE);
+
+    for (uint32_t y = 0; y < TILE_SIZE; ++y) {
+        for (uint32_t x = (y < validY ? validX : 0); x < TILE_SIZE; ++x) {
+            std::copy(fill_.begin(), fill_.end(), tile.pixels.begin() + pixelOffset(x, y));
+        }
+    }
+}
+
+} // namespace QuantumCanvas::Raster
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace QuantumCanvas::Raster {
+
+// RGBA float image stored as TILE_SIZE x TILE_SIZE tiles.
+//
+// Tiles are allocated on first write; until then they read as the fill
+// color, so memory follows the painted area rather than the canvas size.
+// Copies share tiles and a tile is duplicated only when one of the copies
+// writes to it, which makes a copy an O(tiles) snapshot suitable for undo.
+//
+// Distinct tiles may be written from different threads, but copying an
+// image while another thread writes to it (or to a copy of it) is a race.
+class Image {
+public:
+    static constexpr uint32_t TILE_SIZE = 256;
+    static constexpr uint32_t CHANNELS = 4;
+    static constexpr size_t TILE_FLOATS = size_t(TILE_SIZE) * TILE_SIZE * CHANNELS;
+    static constexpr size_t TILE_STRIDE = size_t(TILE_SIZE) * CHANNELS;  // Floats per tile row
+
+    using Pixel = std::array<float, 4>;
+
+    Image() = default;
+    Image(uint32_t width, uint32_t height, const Pixel& fill = {0.0f, 0.0f, 0.0f, 0.0f});
+    Image(const Image& other);
+    Image& operator=(const Image& other);
+
+    uint32_t width() const { return width_; }
+    uint32_t height() const { return height_; }
+    std::array<uint32_t, 2> getSize() const { return {width_, height_}; }
+    bool empty() const { return width_ == 0 || height_ == 0; }
+    const Pixel& fillColor() const { return fill_; }
+
+    // Pixel access; out-of-range reads return transparent black and writes are dropped
+    Pixel getPixel(uint32_t x, uint32_t y) const;
+    void setPixel(uint32_t x, uint32_t y, const Pixel& color);
+    Pixel sampleBilinear(float x, float y) const;
+
+    // Discards all content
+    void reset(uint32_t width, uint32_t height, const Pixel& fill = {0.0f, 0.0f, 0.0f, 0.0f});
+    // Keeps content anchored at the top-left; new area reads as the fill color
+    void resize(const std::array<uint32_t, 2>& newSize);
+    // Releases every tile, so clearing is O(tiles) regardless of content
+    void clear(const Pixel& color);
+    // Releases tiles whose pixels all equal the fill color
+    size_t compact();
+
+    // Tile access. Tile pixels are row-major with TILE_STRIDE floats per row;
+    // pixels of edge tiles beyond the image bounds hold the fill color.
+    uint32_t tilesX() const { return tilesX_; }
+    uint32_t tilesY() const { return tilesY_; }
+    size_t tileCount() const { return tiles_.size(); }
+    bool isTileAllocated(uint32_t tileX, uint32_t tileY) const;
+    bool isTileShared(uint32_t tileX, uint32_t tileY) const;
+    const float* tileData(uint32_t tileX, uint32_t tileY) const;  // Null if unallocated
+    float* mutableTileData(uint32_t tileX, uint32_t tileY);       // Allocates or unshares
+
+    // True when no allocated tile overlaps [x0, x1) x [y0, y1), i.e. the
+    // whole region reads as the fill color. Coordinates are clamped.
+    bool isRegionUniform(int64_t x0, int64_t y0, int64_t x1, int64_t y1) const;
+
+    // Tiles written since the last clearDirtyTiles(), as pixel rectangles
+    // {x0, y0, x1, y1}; reset(), resize() and clear() dirty every tile
+    bool hasDirtyTiles() const;
+    std::vector<std::array<uint32_t, 4>> getDirtyRects() const;
+    void clearDirtyTiles();
+
+    // Advances when a clean tile is first written and on reset/resize/clear.
+    // Read together with clearDirtyTiles(), an unchanged generation means
+    // unchanged pixels.
+    uint64_t generation() const { return generation_.load(std::memory_order_relaxed); }
+
+    // Memory
+    size_t allocatedTileCount() const;
+    size_t memoryUsage() const;        // Bytes of all allocated tiles, shared or not
+    size_t uniqueMemoryUsage() const;  // Bytes of tiles only this image references
+
+private:
+    struct Tile {
+        std::array<float, TILE_FLOATS> pixels;
+    };
+
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    uint32_t tilesX_ = 0;
+    uint32_t tilesY_ = 0;
+    Pixel fill_{0.0f, 0.0f, 0.0f, 0.0f};
+    std::vector<std::shared_ptr<Tile>> tiles_;
+    std::vector<uint8_t> dirty_;  // Per tile; bytes so distinct tiles can be written concurrently
+    std::atomic<uint64_t> generation_{0};
+
+    std::shared_ptr<Tile> makeFilledTile() const;
+    void fillOutside(Tile& tile, uint32_t tileX, uint32_t tileY);
+};
+
+} // namespace QuantumCanvas::Raster
@@ -0,0 +1,340 @@
+#include "stroke_recording.hpp"
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <type_traits>
+
+namespace QuantumCanvas::Raster {
+
+namespace {
+
+using namespace StrokeRecording;
+
+constexpr uint8_t MAGIC[4] = {'Q', 'C', 'S', 'R'};
+
+// Point fields in encoding order
+enum PointField : size_t {
+    FieldX,
+    FieldY,
+    FieldPressure,
+    FieldTilt,
+    FieldBearing,
+    FieldRotation,
+    FieldVelocity,
+    FieldTime,
+    FIELD_COUNT
+};
+
+inline bool predictsLinearly(size_t field) {
+    return field == FieldX || field == FieldY || field == FieldTime;
+}
+
+void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void writeSigned(std::vector<uint8_t>& out, int64_t value) {
+    writeVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+// Bounds-checked reads; a failed read leaves ok false and the cursor at end
+struct Cursor {
+    const uint8_t* data;
+    size_t size;
+    size_t offset = 0;
+    bool ok = true;
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (offset >= size) {
+                break;
+            }
+            uint8_t byte = data[offset++];
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        ok = false;
+        offset = size;
+        return 0;
+    }
+
+    int64_t signedVarint() {
+        uint64_t value = varint();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    void bytes(void* dst, size_t count) {
+        if (size - offset < count) {
+            ok = false;
+            offset = size;
+            std::memset(dst, 0, count);
+            return;
+        }
+        std::memcpy(dst, data + offset, count);
+        offset += count;
+    }
+};
+
+// Every settings field in encoding order. Appending fields needs a VERSION bump.
+template <typename Settings, typename Fn>
+void forEachSettingsField(Settings& s, Fn&& fn) {
+    fn(s.size); fn(s.opacity); fn(s.flow); fn(s.spacing); fn(s.hardness); fn(s.density);
+    fn(s.tipShape); fn(s.angle); fn(s.roundness);
+    fn(s.textureId); fn(s.textureScale); fn(s.textureStrength); fn(s.invertTexture);
+    fn(s.color); fn(s.blendMode);
+
+    auto& d = s.dynamics;
+    fn(d.sizeFromPressure); fn(d.sizePressureSensitivity); fn(d.sizeFromVelocity); fn(d.sizeVelocitySensitivity);
+    fn(d.minSize); fn(d.maxSize);
+    fn(d.opacityFromPressure); fn(d.opacityPressureSensitivity);
+    fn(d.opacityFromVelocity); fn(d.opacityVelocitySensitivity);
+    fn(d.flowFromPressure); fn(d.flowPressureSensitivity);
+    fn(d.colorFromPressure); fn(d.pressureColor); fn(d.colorFromVelocity); fn(d.velocityColor);
+    fn(d.textureFromPressure); fn(d.texturePressureScale); fn(d.textureFromAngle);
+    fn(d.scatterAmount); fn(d.jitterAmount);
+    fn(d.enableDualBrush); fn(d.dualBrushBlending); fn(d.dualBrushMode);
+
+    fn(s.enableWetEdges); fn(s.enableBuildup); fn(s.enableSmoothing); fn(s.smoothingStrength);
+    fn(s.airbrushing); fn(s.airbrushRate);
+}
+
+void writeSettings(std::vector<uint8_t>& out, const BrushSettings& settings) {
+    forEachSettingsField(settings, [&](const auto& field) {
+        using T = std::decay_t<decltype(field)>;
+        if constexpr (std::is_same_v<T, float>) {
+            uint8_t bytes[4];
+            std::memcpy(bytes, &field, 4);
+            out.insert(out.end(), bytes, bytes + 4);
+        } else if constexpr (std::is_same_v<T, std::array<float, 4>>) {
+            for (float value : field) {
+                uint8_t bytes[4];
+                std::memcpy(bytes, &value, 4);
+                out.insert(out.end(), bytes, bytes + 4);
+            }
+        } else if constexpr (std::is_same_v<T, bool>) {
+            out.push_back(field ? 1 : 0);
+        } else {  // Enums and resource ids
+            writeVarint(out, static_cast<uint64_t>(field));
+        }
+    });
+}
+
+void readSettings(Cursor& in, BrushSettings& settings) {
+    forEachSettingsField(settings, [&](auto& field) {
+        using T = std::decay_t<decltype(field)>;
+        if constexpr (std::is_same_v<T, float>) {
+            in.bytes(&field, 4);
+        } else if constexpr (std::is_same_v<T, std::array<float, 4>>) {
+            in.bytes(field.data(), 16);
+        } else if constexpr (std::is_same_v<T, bool>) {
+            uint8_t byte = 0;
+            in.bytes(&byte, 1);
+            field = byte != 0;
+        } else {
+            field = static_cast<T>(in.varint());
+        }
+    });
+}
+
+int64_t quantise(float value, float step) {
+    return std::isfinite(value) ? static_cast<int64_t>(std::llround(value / step)) : 0;
+}
+
+int64_t toMicroseconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+// StrokeWriter implementation
+StrokeWriter::StrokeWriter(std::ostream& out, bool appendTo) : out_(out) {
+    if (!appendTo) {
+        uint8_t header[HEADER_SIZE] = {MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3],
+                                       static_cast<uint8_t>(VERSION), 0, 0, 0};
+        out_.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+        bytesWritten_ += HEADER_SIZE;
+    }
+}
+
+void StrokeWriter::beginStroke(const BrushSettings& settings, uint64_t strokeId) {
+    record_.clear();
+    points_.clear();
+    pointCount_ = 0;
+    startTime_ = 0;
+
+    writeVarint(record_, strokeId);
+    writeSettings(record_, settings);
+    strokeActive_ = true;
+}
+
+void StrokeWriter::addPoint(const StrokePoint& point) {
+    if (!strokeActive_) {
+        return;
+    }
+
+    int64_t time = toMicroseconds(point.timestamp);
+    if (pointCount_ == 0) {
+        startTime_ = time;
+    }
+
+    std::array<int64_t, FIELD_COUNT> q;
+    q[FieldX] = quantise(point.position[0], POSITION_STEP);
+    q[FieldY] = quantise(point.position[1], POSITION_STEP);
+    q[FieldPressure] = quantise(point.pressure, PRESSURE_STEP);
+    q[FieldTilt] = quantise(point.tilt, ANGLE_STEP);
+    q[FieldBearing] = quantise(point.bearing, ANGLE_STEP);
+    q[FieldRotation] = quantise(point.rotation, ANGLE_STEP);
+    q[FieldVelocity] = quantise(point.velocity, VELOCITY_STEP);
+    q[FieldTime] = time - startTime_;
+
+    for (size_t f = 0; f < FIELD_COUNT; ++f) {
+        int64_t predicted = 0;
+        if (pointCount_ >= 2 && predictsLinearly(f)) {
+            predicted = 2 * last_[f] - beforeLast_[f];
+        } else if (pointCount_ >= 1) {
+            predicted = last_[f];
+        }
+        writeSigned(points_, q[f] - predicted);
+    }
+
+    beforeLast_ = last_;
+    last_ = q;
+    pointCount_++;
+}
+
+bool StrokeWriter::endStroke() {
+    if (!strokeActive_) {
+        return false;
+    }
+    strokeActive_ = false;
+
+    writeSigned(record_, startTime_);
+    writeVarint(record_, pointCount_);
+
+    std::vector<uint8_t> prefix;
+    writeVarint(prefix, record_.size() + points_.size());
+    out_.write(reinterpret_cast<const char*>(prefix.data()), prefix.size());
+    out_.write(reinterpret_cast<const char*>(record_.data()), record_.size());
+    out_.write(reinterpret_cast<const char*>(points_.data()), points_.size());
+    if (!out_) {
+        return false;
+    }
+
+    bytesWritten_ += prefix.size() + record_.size() + points_.size();
+    strokesWritten_++;
+    return true;
+}
+
+bool StrokeWriter::writeStroke(const BrushStroke& stroke) {
+    beginStroke(stroke.settings, stroke.strokeId);
+    for (const auto& point : stroke.points) {
+        addPoint(point);
+    }
+    return endStroke();
+}
+
+// StrokeReader implementation
+StrokeReader::StrokeReader(const uint8_t* data, size_t size) : data_(data), size_(size) {
+    if (!data || size < HEADER_SIZE || std::memcmp(data, MAGIC, 4) != 0 || data[4] != VERSION) {
+        return;
+    }
+    valid_ = true;
+
+    Cursor cursor{data, size, HEADER_SIZE};
+    while (cursor.offset < size) {
+        uint64_t length = cursor.varint();
+        if (!cursor.ok || length > size - cursor.offset) {
+            break;  // Truncated by an interrupted write
+        }
+        records_.push_back({cursor.offset, static_cast<size_t>(length)});
+        cursor.offset += length;
+    }
+}
+
+uint64_t StrokeReader::strokeId(size_t index) const {
+    if (index >= records_.size()) {
+        return 0;
+    }
+    Cursor cursor{data_ + records_[index].offset, records_[index].size};
+    return cursor.varint();
+}
+
+bool StrokeReader::readStroke(size_t index, BrushStroke& stroke) const {
+    if (index >= records_.size()) {
+        return false;
+    }
+
+    Cursor in{data_ + records_[index].offset, records_[index].size};
+    BrushStroke result;
+    result.strokeId = in.varint();
+    readSettings(in, result.settings);
+    int64_t startTime = in.signedVarint();
+    uint64_t pointCount = in.varint();
+    if (!in.ok || pointCount > in.size - in.offset) {  // At least a byte per field per point
+        return false;
+    }
+
+    result.points.reserve(pointCount);
+    std::array<int64_t, FIELD_COUNT> last{};
+    std::array<int64_t, FIELD_COUNT> beforeLast{};
+    for (uint64_t i = 0; i < pointCount; ++i) {
+        std::array<int64_t, FIELD_COUNT> q;
+        for (size_t f = 0; f < FIELD_COUNT; ++f) {
+            int64_t predicted = 0;
+            if (i >= 2 && predictsLinearly(f)) {
+                predicted = 2 * last[f] - beforeLast[f];
+            } else if (i >= 1) {
+                predicted = last[f];
+            }
+            q[f] = predicted + in.signedVarint();
+        }
+        if (!in.ok) {
+            return false;
+        }
+
+        StrokePoint point;
+        point.position = {q[FieldX] * POSITION_STEP, q[FieldY] * POSITION_STEP};
+        point.pressure = q[FieldPressure] * PRESSURE_STEP;
+        point.tilt = q[FieldTilt] * ANGLE_STEP;
+        point.bearing = q[FieldBearing] * ANGLE_STEP;
+        point.rotation = q[FieldRotation] * ANGLE_STEP;
+        point.velocity = q[FieldVelocity] * VELOCITY_STEP;
+        point.timestamp = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::microseconds(startTime + q[FieldTime])));
+        result.points.push_back(point);
+
+        beforeLast = last;
+        last = q;
+    }
+
+    stroke = std::move(result);
+    return true;
+}
+
+// BrushStroke serialization: a recording holding just this stroke
+std::vector<uint8_t> BrushStroke::serialize() const {
+    std::ostringstream out(std::ios::binary);
+    StrokeWriter writer(out);
+    writer.writeStroke(*this);
+
+    std::string bytes = out.str();
+    return std::vector<uint8_t>(bytes.begin(), bytes.end());
+}
+
+bool BrushStroke::deserialize(const std::vector<uint8_t>& data) {
+    StrokeReader reader(data.data(), data.size());
+    if (!reader.isValid() || reader.strokeCount() != 1) {
+        return false;
+    }
+    return reader.readStroke(0, *this);
+}
+
+} // namespace QuantumCanvas::Raster
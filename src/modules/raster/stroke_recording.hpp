@@ -0,0 +1,90 @@
+#pragma once
+
+#include "brush_engine.hpp"
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace QuantumCanvas::Raster {
+
+// Compact stroke recordings for replay and time-lapse.
+//
+// A recording is an 8-byte header followed by one length-prefixed record
+// per stroke, so it can be appended to while drawing and a crash loses at
+// most the stroke in progress. Each record carries the stroke id, its
+// settings and its points. Point fields are quantised to the steps below and
+// stored as zigzag varints: position and timestamp as the error of a linear
+// prediction from the two previous points, the other fields as deltas. A
+// smooth stroke costs around 8 bytes per point instead of sizeof(StrokePoint).
+// Timestamps are kept to the microsecond. Computed point properties are
+// not stored; the engine derives them again.
+namespace StrokeRecording {
+
+constexpr uint32_t VERSION = 1;
+constexpr float POSITION_STEP = 1.0f / 16.0f;   // Pixels
+constexpr float PRESSURE_STEP = 1.0f / 4096.0f;
+constexpr float ANGLE_STEP = 1.0f / 4096.0f;    // Tilt, bearing and rotation
+constexpr float VELOCITY_STEP = 1.0f / 16.0f;
+constexpr size_t HEADER_SIZE = 8;
+
+} // namespace StrokeRecording
+
+// Appends strokes to a stream. Points are encoded as they arrive; a stroke
+// reaches the stream as one record when it ends.
+class StrokeWriter {
+public:
+    // Writes the header unless the stream already holds a recording to
+    // continue, in which case appendTo must be true
+    explicit StrokeWriter(std::ostream& out, bool appendTo = false);
+
+    void beginStroke(const BrushSettings& settings, uint64_t strokeId);
+    void addPoint(const StrokePoint& point);
+    bool endStroke();  // False if the stream failed
+    bool isStrokeActive() const { return strokeActive_; }
+
+    // A whole stroke at once
+    bool writeStroke(const BrushStroke& stroke);
+
+    size_t strokesWritten() const { return strokesWritten_; }
+    uint64_t bytesWritten() const { return bytesWritten_; }
+
+private:
+    std::ostream& out_;
+    bool strokeActive_ = false;
+    std::vector<uint8_t> record_;     // Stroke header of the open stroke
+    std::vector<uint8_t> points_;     // Its encoded points
+    uint64_t pointCount_ = 0;
+    int64_t startTime_ = 0;           // Of the first point, microseconds since the epoch
+    std::array<int64_t, 8> last_{};   // Quantised fields of the last two points
+    std::array<int64_t, 8> beforeLast_{};
+    size_t strokesWritten_ = 0;
+    uint64_t bytesWritten_ = 0;
+};
+
+// Random access to the strokes of a recording held in memory, e.g. a
+// Core::MappedFile. Opening indexes the records by hopping over their
+// length prefixes, without decoding any points; a truncated last record is
+// left out. The data must outlive the reader.
+class StrokeReader {
+public:
+    StrokeReader(const uint8_t* data, size_t size);
+
+    bool isValid() const { return valid_; }
+    size_t strokeCount() const { return records_.size(); }
+
+    bool readStroke(size_t index, BrushStroke& stroke) const;
+    uint64_t strokeId(size_t index) const;
+
+private:
+    struct Record {
+        size_t offset;
+        size_t size;
+    };
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool valid_ = false;
+    std::vector<Record> records_;
+};
+
+} // namespace QuantumCanvas::Raster
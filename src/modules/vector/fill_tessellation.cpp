@@ -0,0 +1,386 @@
+#include "fill_tessellation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace QuantumCanvas::Vector {
+
+namespace {
+
+using Point = FillCurveBuilder::Point;
+
+Point evaluate(const FillCurve& c, float t) {
+    const float mt = 1.0f - t;
+    const float a = mt * mt * mt;
+    const float b = 3.0f * mt * mt * t;
+    const float d = 3.0f * mt * t * t;
+    const float e = t * t * t;
+    return {a * c.p0[0] + b * c.p1[0] + d * c.p2[0] + e * c.p3[0],
+            a * c.p0[1] + b * c.p1[1] + d * c.p2[1] + e * c.p3[1]};
+}
+
+VectorVertex fill_vertex(const Point& position, float t) {
+    VectorVertex vertex;
+    vertex.position = position;
+    vertex.texCoord = {t, 0.0f};
+    vertex.color = {1.0f, 1.0f, 1.0f, 1.0f};
+    vertex.coverage = 1.0f;
+    return vertex;
+}
+
+// A flattened edge, top to bottom; winding is +1 for edges running down
+struct Edge {
+    float x0, y0, x1, y1;
+    int winding;
+
+    float x_at(float y) const { return x0 + (x1 - x0) * (y - y0) / (y1 - y0); }
+};
+
+struct Span {
+    float top;     // x at the top of the slab
+    float bottom;  // and at its bottom
+    int winding;
+};
+
+// Emits the trapezoids of one slab holding no crossings between top and
+// bottom, where spans are ordered left to right
+void emit_slab(const std::vector<Span>& spans, float top, float bottom, std::vector<VectorVertex>& vertices,
+               std::vector<uint32_t>& indices) {
+    int winding = 0;
+    const Span* left = nullptr;
+    for (const Span& span : spans) {
+        const int previous = winding;
+        winding += span.winding;
+        if (previous == 0 && winding != 0) {
+            left = &span;
+        } else if (previous != 0 && winding == 0 && left) {
+            const uint32_t base = static_cast<uint32_t>(vertices.size());
+            vertices.push_back(fill_vertex({left->top, top}, 0.0f));
+            vertices.push_back(fill_vertex({span.top, top}, 0.0f));
+            vertices.push_back(fill_vertex({span.bottom, bottom}, 0.0f));
+            vertices.push_back(fill_vertex({left->bottom, bottom}, 0.0f));
+            if (span.top > left->top) {
+                indices.insert(indices.end(), {base, base + 1, base + 2});
+            }
+            if (span.bottom > left->bottom) {
+                indices.insert(indices.end(), {base, base + 2, base + 3});
+            }
+        }
+    }
+}
+
+} // namespace
+
+uint32_t flattened_segment_count(const FillCurve& c, float tolerance) {
+    auto secondDifference = [](const Point& a, const Point& b, const Point& d) {
+        float x = a[0] - 2.0f * b[0] + d[0];
+        float y = a[1] - 2.0f * b[1] + d[1];
+        return std::sqrt(x * x + y * y);
+    };
+    float m = std::max(secondDifference(c.p0, c.p1, c.p2), secondDifference(c.p1, c.p2, c.p3));
+    float n = std::ceil(std::sqrt(0.75f * m / tolerance));
+    return static_cast<uint32_t>(std::clamp(n, 1.0f, static_cast<float>(GPUTessellator::MAX_SEGMENTS_PER_CURVE)));
+}
+
+// FillCurveBuilder
+FillCurveBuilder::FillCurveBuilder(float tolerance) : tolerance_(std::max(tolerance, 1e-4f)) {}
+
+void FillCurveBuilder::begin_path() {
+    current_ = {0.0f, 0.0f};
+    subpathStart_ = current_;
+    subpathHasCurves_ = false;
+    subpaths_ = 0;
+    polygon_.clear();
+}
+
+void FillCurveBuilder::move_to(const Point& point) {
+    current_ = point;
+    subpathStart_ = point;
+    subpathHasCurves_ = false;
+}
+
+void FillCurveBuilder::line_to(const Point& b) {
+    const Point a = current_;
+    add_cubic(a, {a[0] + (b[0] - a[0]) / 3.0f, a[1] + (b[1] - a[1]) / 3.0f},
+              {a[0] + (b[0] - a[0]) * 2.0f / 3.0f, a[1] + (b[1] - a[1]) * 2.0f / 3.0f}, b);
+}
+
+void FillCurveBuilder::quad_to(const Point& control, const Point& end) {
+    const Point start = current_;
+    add_cubic(start,
+              {start[0] + (2.0f / 3.0f) * (control[0] - start[0]), start[1] + (2.0f / 3.0f) * (control[1] - start[1])},
+              {end[0] + (2.0f / 3.0f) * (control[0] - end[0]), end[1] + (2.0f / 3.0f) * (control[1] - end[1])}, end);
+}
+
+void FillCurveBuilder::cubic_to(const Point& control1, const Point& control2, const Point& point) {
+    add_cubic(current_, control1, control2, point);
+}
+
+void FillCurveBuilder::arc_to(const Point& end, float rx, float ry, float rotation, bool largeArc, bool sweep) {
+    const Point start = current_;
+    rx = std::abs(rx);
+    ry = std::abs(ry);
+    if (rx < 1e-6f || ry < 1e-6f || (start[0] == end[0] && start[1] == end[1])) {
+        line_to(end);
+        return;
+    }
+
+    // Converted to centre form
+    const float c = std::cos(rotation);
+    const float s = std::sin(rotation);
+    const float hx = 0.5f * (start[0] - end[0]);
+    const float hy = 0.5f * (start[1] - end[1]);
+    const float x1 = c * hx + s * hy;
+    const float y1 = -s * hx + c * hy;
+
+    // Radii too small to reach the end point grow just enough
+    float lambda = (x1 * x1) / (rx * rx) + (y1 * y1) / (ry * ry);
+    if (lambda > 1.0f) {
+        rx *= std::sqrt(lambda);
+        ry *= std::sqrt(lambda);
+    }
+
+    float num = rx * rx * ry * ry - rx * rx * y1 * y1 - ry * ry * x1 * x1;
+    float den = rx * rx * y1 * y1 + ry * ry * x1 * x1;
+    float coef = std::sqrt(std::max(0.0f, num / den)) * (largeArc == sweep ? -1.0f : 1.0f);
+    const float cxp = coef * rx * y1 / ry;
+    const float cyp = -coef * ry * x1 / rx;
+    const float cx = c * cxp - s * cyp + 0.5f * (start[0] + end[0]);
+    const float cy = s * cxp + c * cyp + 0.5f * (start[1] + end[1]);
+
+    auto angle = [](float ux, float uy, float vx, float vy) {
+        return std::atan2(ux * vy - uy * vx, ux * vx + uy * vy);
+    };
+    const float theta = angle(1.0f, 0.0f, (x1 - cxp) / rx, (y1 - cyp) / ry);
+    float delta = angle((x1 - cxp) / rx, (y1 - cyp) / ry, (-x1 - cxp) / rx, (-y1 - cyp) / ry);
+    if (!sweep && delta > 0.0f) {
+        delta -= 2.0f * static_cast<float>(M_PI);
+    } else if (sweep && delta < 0.0f) {
+        delta += 2.0f * static_cast<float>(M_PI);
+    }
+
+    const int pieces = std::max(1, static_cast<int>(std::ceil(std::abs(delta) / (0.5f * static_cast<float>(M_PI)) - 1e-4f)));
+    const float step = delta / pieces;
+    const float k = 4.0f / 3.0f * std::tan(step / 4.0f);
+    auto point = [&](float t) {
+        return Point{cx + rx * std::cos(t) * c - ry * std::sin(t) * s, cy + rx * std::cos(t) * s + ry * std::sin(t) * c};
+    };
+    auto tangent = [&](float t) {
+        return Point{-rx * std::sin(t) * c - ry * std::cos(t) * s, -rx * std::sin(t) * s + ry * std::cos(t) * c};
+    };
+
+    Point from = start;
+    for (int i = 0; i < pieces; ++i) {
+        float t0 = theta + step * i;
+        float t1 = t0 + step;
+        Point to = i + 1 == pieces ? end : point(t1);
+        auto d0 = tangent(t0);
+        auto d1 = tangent(t1);
+        add_cubic(from, {from[0] + k * d0[0], from[1] + k * d0[1]}, {to[0] - k * d1[0], to[1] - k * d1[1]}, to);
+        from = to;
+    }
+}
+
+void FillCurveBuilder::close_path() {
+    // The closing edge's fan triangle is degenerate, so nothing is emitted
+    current_ = subpathStart_;
+}
+
+void FillCurveBuilder::end_path() {
+    Path path;
+    const uint32_t firstCurve = paths_.empty() ? 0 : paths_.back().firstCurve + paths_.back().curveCount;
+    path.firstCurve = firstCurve;
+    path.curveCount = static_cast<uint32_t>(curves_.size()) - firstCurve;
+    path.firstSegment = path.curveCount > 0 ? curves_[firstCurve].firstSegment : segmentCount_;
+    path.segmentCount = segmentCount_ - path.firstSegment;
+
+    if (path.curveCount > 0) {
+        path.bounds = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                       std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+        for (uint32_t i = firstCurve; i < firstCurve + path.curveCount; ++i) {
+            for (const Point* p : {&curves_[i].p0, &curves_[i].p1, &curves_[i].p2, &curves_[i].p3}) {
+                path.bounds[0] = std::min(path.bounds[0], (*p)[0]);
+                path.bounds[1] = std::min(path.bounds[1], (*p)[1]);
+                path.bounds[2] = std::max(path.bounds[2], (*p)[0]);
+                path.bounds[3] = std::max(path.bounds[3], (*p)[1]);
+            }
+        }
+    }
+    path.convex = subpaths_ == 1 && polygon_is_convex();
+    paths_.push_back(path);
+    begin_path();
+}
+
+void FillCurveBuilder::add_cubic(const Point& p0, const Point& p1, const Point& p2, const Point& p3) {
+    FillCurve curve{p0, p1, p2, p3, subpathStart_, segmentCount_, 0};
+    curve.segmentCount = flattened_segment_count(curve, tolerance_);
+    segmentCount_ += curve.segmentCount;
+    curves_.push_back(curve);
+    current_ = p3;
+
+    if (!subpathHasCurves_) {
+        subpathHasCurves_ = true;
+        subpaths_++;
+    }
+    if (subpaths_ == 1) {
+        if (polygon_.empty()) {
+            polygon_.push_back(p0);
+        }
+        polygon_.insert(polygon_.end(), {p1, p2, p3});
+    }
+}
+
+bool FillCurveBuilder::polygon_is_convex() const {
+    // Closed through the subpath's start; every turn has the same sign and
+    // they add up to one revolution, so the polygon doesn't wind twice
+    std::vector<Point> edges;
+    for (size_t i = 0; i < polygon_.size(); ++i) {
+        const Point& a = polygon_[i];
+        const Point& b = polygon_[(i + 1) % polygon_.size()];
+        Point edge{b[0] - a[0], b[1] - a[1]};
+        if (edge[0] != 0.0f || edge[1] != 0.0f) {
+            edges.push_back(edge);
+        }
+    }
+    if (edges.size() < 3) {
+        return false;
+    }
+
+    int sign = 0;
+    float turning = 0.0f;
+    for (size_t i = 0; i < edges.size(); ++i) {
+        const Point& u = edges[i];
+        const Point& v = edges[(i + 1) % edges.size()];
+        const float cross = u[0] * v[1] - u[1] * v[0];
+        const float dot = u[0] * v[0] + u[1] * v[1];
+        const float scale = std::sqrt((u[0] * u[0] + u[1] * u[1]) * (v[0] * v[0] + v[1] * v[1]));
+        if (std::abs(cross) <= 1e-6f * scale) {
+            if (dot < 0.0f) {
+                return false;  // Doubles back
+            }
+            continue;
+        }
+        const int turn = cross > 0.0f ? 1 : -1;
+        if (sign != 0 && turn != sign) {
+            return false;
+        }
+        sign = turn;
+        turning += std::atan2(cross, dot);
+    }
+    return sign != 0 && std::abs(turning) <= 2.0f * static_cast<float>(M_PI) + 1e-3f;
+}
+
+// Triangulation
+void build_fan_vertices(const FillCurve* curves, size_t count, std::vector<VectorVertex>& vertices) {
+    for (size_t i = 0; i < count; ++i) {
+        const FillCurve& c = curves[i];
+        for (uint32_t segment = 0; segment < c.segmentCount; ++segment) {
+            float t0 = static_cast<float>(segment) / static_cast<float>(c.segmentCount);
+            float t1 = static_cast<float>(segment + 1) / static_cast<float>(c.segmentCount);
+            vertices.push_back(fill_vertex(c.anchor, 0.0f));
+            vertices.push_back(fill_vertex(evaluate(c, t0), t0));
+            vertices.push_back(fill_vertex(evaluate(c, t1), t1));
+        }
+    }
+}
+
+void triangulate_fill(const FillCurve* curves, size_t count, std::vector<VectorVertex>& vertices,
+                      std::vector<uint32_t>& indices) {
+    // Flattened edges, each subpath closed back to its anchor
+    std::vector<Edge> edges;
+    auto addEdge = [&edges](const Point& a, const Point& b) {
+        if (a[1] < b[1]) {
+            edges.push_back({a[0], a[1], b[0], b[1], 1});
+        } else if (a[1] > b[1]) {
+            edges.push_back({b[0], b[1], a[0], a[1], -1});
+        }
+    };
+    for (size_t i = 0; i < count; ++i) {
+        const FillCurve& c = curves[i];
+        const bool continues = i > 0 && curves[i - 1].anchor == c.anchor && curves[i - 1].p3 == c.p0;
+        if (i > 0 && !continues) {
+            addEdge(curves[i - 1].p3, curves[i - 1].anchor);
+        }
+        Point from = c.p0;
+        for (uint32_t segment = 1; segment <= c.segmentCount; ++segment) {
+            Point to = segment == c.segmentCount ? c.p3 : evaluate(c, static_cast<float>(segment) / c.segmentCount);
+            addEdge(from, to);
+            from = to;
+        }
+    }
+    if (count > 0) {
+        addEdge(curves[count - 1].p3, curves[count - 1].anchor);
+    }
+    if (edges.empty()) {
+        return;
+    }
+
+    std::vector<float> heights;
+    heights.reserve(edges.size() * 2);
+    for (const Edge& edge : edges) {
+        heights.push_back(edge.y0);
+        heights.push_back(edge.y1);
+    }
+    std::sort(heights.begin(), heights.end());
+    heights.erase(std::unique(heights.begin(), heights.end()), heights.end());
+    std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) { return a.y0 < b.y0; });
+
+    // Every edge spans whole slabs between consecutive heights. Slabs are
+    // split again where edges cross, so each piece is a row of trapezoids.
+    std::vector<const Edge*> active;
+    std::vector<Span> spans;
+    size_t next = 0;
+    for (size_t h = 0; h + 1 < heights.size(); ++h) {
+        float top = heights[h];
+        const float bottom = heights[h + 1];
+        active.erase(std::remove_if(active.begin(), active.end(), [top](const Edge* e) { return e->y1 <= top; }),
+                     active.end());
+        while (next < edges.size() && edges[next].y0 <= top) {
+            active.push_back(&edges[next++]);
+        }
+        if (active.empty()) {
+            continue;
+        }
+
+        size_t splits = active.size() * active.size() + 4;  // Against float stalls
+        while (top < bottom) {
+            spans.clear();
+            for (const Edge* edge : active) {
+                spans.push_back({edge->x_at(top), edge->x_at(bottom), edge->winding});
+            }
+            std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) {
+                return a.top < b.top || (a.top == b.top && a.bottom < b.bottom);
+            });
+
+            // The first crossing is between neighbours at the top
+            float end = bottom;
+            if (splits > 0) {
+                splits--;
+                for (size_t k = 0; k + 1 < spans.size(); ++k) {
+                    if (spans[k].bottom > spans[k + 1].bottom) {
+                        const float gapTop = spans[k + 1].top - spans[k].top;
+                        const float gapBottom = spans[k].bottom - spans[k + 1].bottom;
+                        end = std::min(end, top + (bottom - top) * gapTop / (gapTop + gapBottom));
+                    }
+                }
+            }
+            if (!(end > top)) {
+                end = bottom;
+            }
+            if (end < bottom) {
+                const float f = (end - top) / (bottom - top);
+                for (Span& span : spans) {
+                    span.bottom = span.top + (span.bottom - span.top) * f;
+                }
+            }
+            emit_slab(spans, top, end, vertices, indices);
+            top = end;
+        }
+    }
+}
+
+} // namespace QuantumCanvas::Vector
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "vector_renderer.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace QuantumCanvas::Vector {
+
+// One cubic of a fill's outline, as the GPU fill shader reads it; lines,
+// quadratics and arcs are turned into cubics
+struct FillCurve {
+    std::array<float, 2> p0;
+    std::array<float, 2> p1;
+    std::array<float, 2> p2;
+    std::array<float, 2> p3;
+    std::array<float, 2> anchor;  // Start of the curve's subpath, the apex of its fan
+    uint32_t firstSegment;        // Over all the builder's curves
+    uint32_t segmentCount;
+};
+static_assert(sizeof(FillCurve) == 48, "FillCurve must match the WGSL layout");
+
+// Wang's formula: chords needed for a flattened cubic to stay within the
+// tolerance, computed up front so every segment is independent on the GPU
+uint32_t flattened_segment_count(const FillCurve& curve, float tolerance);
+
+// Turns path outlines into FillCurves. Paths are added between
+// begin_path() and end_path(); their curves are appended to one list, so a
+// batch of paths is flattened in one dispatch. Fills close implicitly.
+class FillCurveBuilder {
+public:
+    using Point = std::array<float, 2>;
+
+    struct Path {
+        uint32_t firstCurve = 0;
+        uint32_t curveCount = 0;
+        uint32_t firstSegment = 0;
+        uint32_t segmentCount = 0;
+        std::array<float, 4> bounds{0.0f, 0.0f, 0.0f, 0.0f};  // Of the control points
+        // One subpath with a convex control polygon. The curve is then
+        // convex too, and its fan covers the fill exactly once.
+        bool convex = false;
+    };
+
+    explicit FillCurveBuilder(float tolerance);
+
+    void begin_path();
+    void move_to(const Point& point);
+    void line_to(const Point& point);
+    void quad_to(const Point& control, const Point& point);
+    void cubic_to(const Point& control1, const Point& control2, const Point& point);
+    // SVG endpoint arc; one cubic per quarter turn or less
+    void arc_to(const Point& point, float rx, float ry, float rotation, bool largeArc, bool sweep);
+    void close_path();
+    void end_path();
+
+    float tolerance() const { return tolerance_; }
+    const std::vector<FillCurve>& curves() const { return curves_; }
+    const std::vector<Path>& paths() const { return paths_; }
+    uint32_t segment_count() const { return segmentCount_; }
+
+private:
+    float tolerance_;
+    std::vector<FillCurve> curves_;
+    std::vector<Path> paths_;
+    uint32_t segmentCount_ = 0;
+
+    Point current_{0.0f, 0.0f};
+    Point subpathStart_{0.0f, 0.0f};
+    bool subpathHasCurves_ = false;
+    uint32_t subpaths_ = 0;       // Of the open path, with curves
+    std::vector<Point> polygon_;  // The open path's control points, for the convexity test
+
+    void add_cubic(const Point& p0, const Point& p1, const Point& p2, const Point& p3);
+    bool polygon_is_convex() const;
+};
+
+// Fans each curve's segments from its anchor: the triangles the GPU fill
+// shader writes, non-indexed. Exact only for convex paths.
+void build_fan_vertices(const FillCurve* curves, size_t count, std::vector<VectorVertex>& vertices);
+
+// Triangles covering where the outline's winding number is non-zero, for
+// any outline, with no two overlapping: the flattened edges are swept
+// into trapezoids between consecutive vertex heights and edge crossings
+void triangulate_fill(const FillCurve* curves, size_t count, std::vector<VectorVertex>& vertices,
+                      std::vector<uint32_t>& indices);
+
+} // namespace QuantumCanvas::Vector
@@ -0,0 +1,45 @@
+#include "instance_batch.hpp"
+
+namespace QuantumCanvas::Vector {
+
+void InstanceBatch::add(std::shared_ptr<TessellatedPath> tessellation, const VectorInstance& instance) {
+    if (!tessellation) {
+        return;
+    }
+    auto [it, created] = slots_.try_emplace(tessellation.get(), used_);
+    if (created) {
+        if (used_ == pending_.size()) {
+            pending_.emplace_back();
+        }
+        pending_[used_].tessellation = std::move(tessellation);
+        used_++;
+    }
+    pending_[it->second].instances.push_back(instance);
+    instance_count_++;
+}
+
+void InstanceBatch::clear() {
+    for (size_t i = 0; i < used_; ++i) {
+        pending_[i].tessellation.reset();
+        pending_[i].instances.clear();
+    }
+    used_ = 0;
+    slots_.clear();
+    instance_count_ = 0;
+    groups_.clear();
+    instances_.clear();
+}
+
+void InstanceBatch::layout() {
+    groups_.clear();
+    instances_.clear();
+    instances_.reserve(instance_count_);
+    for (size_t i = 0; i < used_; ++i) {
+        const Pending& pending = pending_[i];
+        groups_.push_back({pending.tessellation, static_cast<uint32_t>(instances_.size()),
+                           static_cast<uint32_t>(pending.instances.size())});
+        instances_.insert(instances_.end(), pending.instances.begin(), pending.instances.end());
+    }
+}
+
+} // namespace QuantumCanvas::Vector
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace QuantumCanvas::Vector {
+
+struct TessellatedPath;
+
+// One placement of a cached tessellation, as the instanced fill shader reads
+// it; matches struct Instance there
+struct VectorInstance {
+    std::array<float, 4> linear{1.0f, 0.0f, 0.0f, 1.0f};  // a, b, c, d of the affine transform
+    std::array<float, 2> translation{0.0f, 0.0f};
+    std::array<float, 2> padding{0.0f, 0.0f};
+    std::array<float, 4> color{1.0f, 1.0f, 1.0f, 1.0f};   // Multiplies the vertex colors
+};
+static_assert(sizeof(VectorInstance) == 48, "VectorInstance must match the shader's layout");
+
+// Instances collected over a batch, grouped by tessellation so that each
+// distinct mesh takes one instanced draw however often it is placed
+//
+// Groups are laid out in the order of their first instance, and instances
+// keep their order within a group. Groups do not interleave, so instances of
+// different meshes that overlap are stacked by mesh, not by when they were
+// added.
+class InstanceBatch {
+public:
+    struct Group {
+        std::shared_ptr<TessellatedPath> tessellation;
+        uint32_t firstInstance = 0;  // Into instances()
+        uint32_t instanceCount = 0;
+    };
+
+    void add(std::shared_ptr<TessellatedPath> tessellation, const VectorInstance& instance);
+    void clear();  // Keeps capacity for the next batch
+
+    bool empty() const { return instance_count_ == 0; }
+    size_t instance_count() const { return instance_count_; }
+    size_t group_count() const { return used_; }
+
+    // Lays the instances out contiguously, group by group; valid until the
+    // next add() or clear()
+    void layout();
+    const std::vector<Group>& groups() const { return groups_; }
+    const std::vector<VectorInstance>& instances() const { return instances_; }
+
+private:
+    struct Pending {
+        std::shared_ptr<TessellatedPath> tessellation;
+        std::vector<VectorInstance> instances;
+    };
+
+    std::vector<Pending> pending_;  // First used_ slots are live; the rest keep capacity
+    size_t used_ = 0;
+    std::unordered_map<const TessellatedPath*, size_t> slots_;
+    size_t instance_count_ = 0;
+
+    std::vector<Group> groups_;
+    std::vector<VectorInstance> instances_;
+};
+
+} // namespace QuantumCanvas::Vector
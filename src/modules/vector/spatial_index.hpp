@@ -0,0 +1,27 @@
+#pragma once
+
+#include "../../core/spatial/dynamic_bvh.hpp"
+#include <array>
+#include <cstddef>
+
+namespace QuantumCanvas::Vector {
+
+class VectorObject;
+
+// Reads the rectangles the vector module stores as min_x, min_y, max_x, max_y
+struct RectAxes {
+    using Scalar = float;
+    using Rect = std::array<float, 4>;
+
+    static float lower(const Rect& rect, size_t axis) { return rect[axis]; }
+    static float upper(const Rect& rect, size_t axis) { return rect[axis + 2]; }
+    static Rect make(const std::array<float, 2>& lower, const std::array<float, 2>& upper) {
+        return {lower[0], lower[1], upper[0], upper[1]};
+    }
+};
+
+// Object bounds for view culling and hit testing in large documents. The
+// margin passed to the constructor is a fraction of each object's larger side.
+using SpatialIndex = Core::DynamicBVH<2, RectAxes::Rect, const VectorObject*, RectAxes>;
+
+} // namespace QuantumCanvas::Vector
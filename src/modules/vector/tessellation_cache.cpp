@@ -0,0 +1,249 @@
+#include "tessellation_cache.hpp"
+#include "vector_renderer.hpp"
+#include "../../core/kernel/task_scheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace QuantumCanvas::Vector {
+
+size_t tessellation_bytes(const TessellatedPath& tessellation) {
+    return sizeof(TessellatedPath) +
+           tessellation.vertices.capacity() * sizeof(VectorVertex) +
+           tessellation.indices.capacity() * sizeof(uint32_t);
+}
+
+TessellationCache::TessellationCache(size_t byte_budget)
+    : byte_budget_(byte_budget) {
+}
+
+TessellationCache::~TessellationCache() {
+    wait_idle();
+}
+
+int32_t TessellationCache::lod_level(float tolerance) {
+    float clamped = std::clamp(tolerance, 1e-6f, 1e6f);
+    return static_cast<int32_t>(std::floor(std::log2(clamped) * LEVELS_PER_OCTAVE));
+}
+
+float TessellationCache::level_tolerance(int32_t level) {
+    return std::exp2(static_cast<float>(level) / LEVELS_PER_OCTAVE);
+}
+
+TessellationCache::Lookup TessellationCache::acquire(uint64_t path_id, float tolerance, Tessellator tessellate) {
+    const int32_t level = lod_level(tolerance);
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto [path, created] = paths_.try_emplace(path_id);
+    PathEntry& entry = path->second;
+    if (created) {
+        entry.generation = next_generation_++;
+    }
+    const uint64_t generation = entry.generation;
+
+    auto exact = entry.levels.find(level);
+    if (exact != entry.levels.end()) {
+        lru_.splice(lru_.begin(), lru_, exact->second.lru);
+        stats_.hits++;
+        return {exact->second.tessellation, level, true};
+    }
+
+    if (!entry.levels.empty()) {
+        // Stand in with the nearest level, the finer one on a tie
+        auto above = entry.levels.lower_bound(level);
+        auto nearest = above;
+        if (above == entry.levels.end()) {
+            nearest = std::prev(above);
+        } else if (above != entry.levels.begin()) {
+            auto below = std::prev(above);
+            if (level - below->first <= above->first - level) {
+                nearest = below;
+            }
+        }
+        lru_.splice(lru_.begin(), lru_, nearest->second.lru);
+        stats_.nearest_hits++;
+        Lookup result{nearest->second.tessellation, nearest->first, false};
+
+        bool first_request = entry.pending.insert(level).second;
+        if (first_request) {
+            stats_.scheduled++;
+        }
+        lock.unlock();
+
+        // Outside the lock, as the scheduler may run the task inline
+        if (first_request) {
+            schedule(path_id, level, generation, std::move(tessellate));
+        }
+        return result;
+    }
+
+    // Nothing to show yet, so tessellate here. Pending keeps the entry from
+    // being dropped by eviction meanwhile.
+    stats_.misses++;
+    entry.pending.insert(level);
+    lock.unlock();
+    auto tessellation = tessellate(level_tolerance(level));
+
+    lock.lock();
+    auto current = paths_.find(path_id);
+    if (current != paths_.end() && current->second.generation == generation) {
+        current->second.pending.erase(level);
+        if (tessellation) {
+            insert_locked(path_id, level, tessellation);
+        }
+    }
+    return {tessellation, level, true};
+}
+
+std::shared_ptr<TessellatedPath> TessellationCache::find(uint64_t path_id, int32_t level) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto path = paths_.find(path_id);
+    if (path == paths_.end()) {
+        return nullptr;
+    }
+    auto it = path->second.levels.find(level);
+    if (it == path->second.levels.end()) {
+        return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second.lru);
+    return it->second.tessellation;
+}
+
+void TessellationCache::insert(uint64_t path_id, int32_t level, std::shared_ptr<TessellatedPath> tessellation) {
+    if (!tessellation) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [path, created] = paths_.try_emplace(path_id);
+    if (created) {
+        path->second.generation = next_generation_++;
+    }
+    insert_locked(path_id, level, std::move(tessellation));
+}
+
+void TessellationCache::invalidate(uint64_t path_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto path = paths_.find(path_id);
+    if (path == paths_.end()) {
+        return;
+    }
+    for (auto it = path->second.levels.begin(); it != path->second.levels.end();) {
+        auto next = std::next(it);
+        erase_level_locked(path->second, it);
+        it = next;
+    }
+    paths_.erase(path);
+}
+
+void TessellationCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    paths_.clear();
+    lru_.clear();
+    bytes_used_ = 0;
+}
+
+void TessellationCache::set_byte_budget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    byte_budget_ = bytes;
+    evict_locked(nullptr);
+}
+
+size_t TessellationCache::byte_budget() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return byte_budget_;
+}
+
+size_t TessellationCache::bytes_used() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_used_;
+}
+
+size_t TessellationCache::entry_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+}
+
+void TessellationCache::wait_idle() {
+    auto scheduler = Core::KernelManager::instance().get_service<Core::TaskScheduler>();
+    while (in_flight_.load(std::memory_order_acquire) > 0) {
+        if (!scheduler || !scheduler->try_run_pending_task()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+TessellationCache::Stats TessellationCache::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void TessellationCache::insert_locked(uint64_t path_id, int32_t level,
+                                      std::shared_ptr<TessellatedPath> tessellation) {
+    PathEntry& entry = paths_[path_id];
+    auto existing = entry.levels.find(level);
+    if (existing != entry.levels.end()) {
+        erase_level_locked(entry, existing);
+    }
+
+    Level& slot = entry.levels[level];
+    slot.bytes = tessellation_bytes(*tessellation);
+    slot.tessellation = std::move(tessellation);
+    slot.lru = lru_.insert(lru_.begin(), Key{path_id, level});
+    bytes_used_ += slot.bytes;
+
+    Key keep{path_id, level};
+    evict_locked(&keep);
+}
+
+void TessellationCache::evict_locked(const Key* keep) {
+    // The entry just inserted stays even if it alone exceeds the budget
+    while (bytes_used_ > byte_budget_ && !lru_.empty()) {
+        Key victim = lru_.back();
+        if (keep && victim.path_id == keep->path_id && victim.level == keep->level) {
+            break;
+        }
+        auto path = paths_.find(victim.path_id);
+        erase_level_locked(path->second, path->second.levels.find(victim.level));
+        if (path->second.levels.empty() && path->second.pending.empty()) {
+            paths_.erase(path);
+        }
+        stats_.evictions++;
+    }
+}
+
+void TessellationCache::erase_level_locked(PathEntry& entry, std::map<int32_t, Level>::iterator it) {
+    bytes_used_ -= it->second.bytes;
+    lru_.erase(it->second.lru);
+    entry.levels.erase(it);
+}
+
+void TessellationCache::schedule(uint64_t path_id, int32_t level, uint64_t generation, Tessellator tessellate) {
+    in_flight_.fetch_add(1, std::memory_order_relaxed);
+    auto task = [this, path_id, level, generation, tessellate = std::move(tessellate)]() {
+        struct InFlightGuard {
+            std::atomic<size_t>& count;
+            ~InFlightGuard() { count.fetch_sub(1, std::memory_order_release); }
+        } guard{in_flight_};
+
+        auto tessellation = tessellate(level_tolerance(level));
+
+        // Dropped if the path was edited meanwhile
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto path = paths_.find(path_id);
+        if (path == paths_.end() || path->second.generation != generation) {
+            return;
+        }
+        path->second.pending.erase(level);
+        if (tessellation) {
+            insert_locked(path_id, level, std::move(tessellation));
+        }
+    };
+
+    auto scheduler = Core::KernelManager::instance().get_service<Core::TaskScheduler>();
+    if (scheduler) {
+        scheduler->submit(std::move(task), Core::TaskPriority::Background);
+    } else {
+        task();
+    }
+}
+
+} // namespace QuantumCanvas::Vector
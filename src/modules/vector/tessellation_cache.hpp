@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+namespace QuantumCanvas::Vector {
+
+struct TessellatedPath;
+
+// Bytes a cached tessellation accounts for against the budget
+size_t tessellation_bytes(const TessellatedPath& tessellation);
+
+// Tessellations keyed by path ID and level of detail, evicted least
+// recently used first once their total size passes a byte budget
+//
+// A level stands for a document-space tolerance, quantised to
+// LEVELS_PER_OCTAVE steps per halving so that small zoom changes reuse the
+// same mesh. When a path is requested at a level that is not cached, the
+// nearest cached level is returned at once and the requested one is
+// tessellated on the kernel's task scheduler; the next request after it
+// lands gets the exact level. Only a path with no cached level at all is
+// tessellated on the calling thread.
+class TessellationCache {
+public:
+    static constexpr size_t DEFAULT_BYTE_BUDGET = 64 * 1024 * 1024;
+    static constexpr int32_t LEVELS_PER_OCTAVE = 2;
+
+    // Must be safe to run on a worker thread
+    using Tessellator = std::function<std::shared_ptr<TessellatedPath>(float tolerance)>;
+
+    explicit TessellationCache(size_t byte_budget = DEFAULT_BYTE_BUDGET);
+    ~TessellationCache();  // Waits for scheduled tessellations
+
+    TessellationCache(const TessellationCache&) = delete;
+    TessellationCache& operator=(const TessellationCache&) = delete;
+
+    // Finer tolerances give lower levels. A level's tolerance never exceeds
+    // the tolerances that map to it.
+    static int32_t lod_level(float tolerance);
+    static float level_tolerance(int32_t level);
+
+    struct Lookup {
+        std::shared_ptr<TessellatedPath> tessellation;
+        int32_t level = 0;      // Of the returned tessellation
+        bool exact = false;     // False while the requested level is pending
+    };
+
+    Lookup acquire(uint64_t path_id, float tolerance, Tessellator tessellate);
+    std::shared_ptr<TessellatedPath> find(uint64_t path_id, int32_t level);
+    void insert(uint64_t path_id, int32_t level, std::shared_ptr<TessellatedPath> tessellation);
+
+    // Drops every level of an edited path; results still being computed
+    // for it are discarded when they land
+    void invalidate(uint64_t path_id);
+    void clear();
+
+    void set_byte_budget(size_t bytes);
+    size_t byte_budget() const;
+    size_t bytes_used() const;
+    size_t entry_count() const;
+
+    // Helps run scheduled tessellations until none are left
+    void wait_idle();
+
+    struct Stats {
+        uint64_t hits = 0;           // Requested level was cached
+        uint64_t nearest_hits = 0;   // Another level stood in
+        uint64_t misses = 0;         // Nothing cached; tessellated inline
+        uint64_t scheduled = 0;      // Tessellations sent to workers
+        uint64_t evictions = 0;
+    };
+    Stats get_stats() const;
+
+private:
+    struct Key {
+        uint64_t path_id;
+        int32_t level;
+    };
+    using LruList = std::list<Key>;
+
+    struct Level {
+        std::shared_ptr<TessellatedPath> tessellation;
+        size_t bytes = 0;
+        LruList::iterator lru;
+    };
+
+    struct PathEntry {
+        std::map<int32_t, Level> levels;
+        std::set<int32_t> pending;
+        uint64_t generation = 0;  // Bumped by invalidate()
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, PathEntry> paths_;
+    LruList lru_;  // Most recently used first
+    size_t byte_budget_;
+    size_t bytes_used_ = 0;
+    uint64_t next_generation_ = 1;
+    Stats stats_;
+    std::atomic<size_t> in_flight_{0};
+
+    void insert_locked(uint64_t path_id, int32_t level, std::shared_ptr<TessellatedPath> tessellation);
+    void evict_locked(const Key* keep);
+    void erase_level_locked(PathEntry& entry, std::map<int32_t, Level>::iterator it);
+    void schedule(uint64_t path_id, int32_t level, uint64_t generation, Tessellator tessellate);
+};
+
+} // namespace QuantumCanvas::Vector
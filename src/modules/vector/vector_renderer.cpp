@@ -1,10 +1,13 @@
 #include "vector_renderer.hpp"
+#include "fill_tessellation.hpp"
 #include "../../core/rendering/rendering_engine.hpp"
 #include "../../core/rendering/shader_compiler.hpp"
 #include <iostream>
 #include <algorithm>
 #include <cmath>
 #include <cassert>
+#include <cstring>
+#include <limits>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -319,41 +322,271 @@ void PathTessellator::tessellateEllipticalArc(const std::array<float, 2>& start,
 }
 
 // GPUTessellator implementation (GPU-accelerated tessellation)
+namespace {
+
+struct FillParams {
+    uint32_t curveCount;
+    uint32_t segmentCount;
+    uint32_t segmentsPerRow;  // Invocations per row of workgroups
+    uint32_t padding;
+};
+
+void add_fill_path(const VectorPath& path, FillCurveBuilder& builder) {
+    builder.begin_path();
+    for (const auto& cmd : path.commands) {
+        switch (cmd.type) {
+            case PathCommandType::MoveTo:
+                builder.move_to({cmd.points[0], cmd.points[1]});
+                break;
+            case PathCommandType::LineTo:
+                builder.line_to({cmd.points[0], cmd.points[1]});
+                break;
+            case PathCommandType::CurveTo:
+                builder.cubic_to({cmd.points[0], cmd.points[1]}, {cmd.points[2], cmd.points[3]},
+                                 {cmd.points[4], cmd.points[5]});
+                break;
+            case PathCommandType::QuadTo:
+                builder.quad_to({cmd.points[0], cmd.points[1]}, {cmd.points[2], cmd.points[3]});
+                break;
+            case PathCommandType::ArcTo:
+                builder.arc_to({cmd.points[0], cmd.points[1]}, cmd.points[2], cmd.points[3], cmd.points[4],
+                               cmd.points[5] > 0.5f, cmd.points[6] > 0.5f);
+                break;
+            case PathCommandType::ClosePath:
+                builder.close_path();
+                break;
+        }
+    }
+    builder.end_path();
+}
+
+} // namespace
+
 GPUTessellator::GPUTessellator(Rendering::RenderingEngine& engine)
     : engine_(engine) {
+}
+
+GPUTessellator::~GPUTessellator() {
+    shutdown();
+}
+
+bool GPUTessellator::initialize() {
+    if (initialized_) {
+        return true;
+    }
+    if (!engine_.is_initialized()) {
+        return false;
+    }
     
-    // Initialize GPU resources for tessellation
-    initialized_ = initializeGPUResources();
-    
+    initialized_ = create_compute_shaders();
     if (initialized_) {
         std::cout << "[GPUTessellator] GPU tessellation initialized" << std::endl;
     } else {
         std::cout << "[GPUTessellator] Falling back to CPU tessellation" << std::endl;
     }
+    return initialized_;
 }
 
-GPUTessellator::~GPUTessellator() {
-    // Cleanup GPU resources
+void GPUTessellator::shutdown() {
+    std::lock_guard<std::mutex> lock(batch_mutex_);
+    destroy_resources();
+    initialized_ = false;
 }
 
-bool GPUTessellator::tessellate(const VectorPath& path, std::vector<VectorVertex>& vertices) {
-    if (!initialized_) {
-        return false; // Fall back to CPU tessellation
+std::shared_ptr<TessellatedPath> GPUTessellator::tessellate_path(const VectorPath& path, float tolerance) {
+    return tessellate_paths({&path}, tolerance).front();
+}
+
+std::vector<std::shared_ptr<TessellatedPath>> GPUTessellator::tessellate_paths(
+    const std::vector<const VectorPath*>& paths, float tolerance) {
+    FillCurveBuilder builder(tolerance);
+    for (const VectorPath* path : paths) {
+        add_fill_path(*path, builder);
     }
+    return tessellate_fills(builder);
+}
+
+std::vector<std::shared_ptr<TessellatedPath>> GPUTessellator::tessellate_fills(const FillCurveBuilder& builder) {
+    const auto& curves = builder.curves();
+    const auto& paths = builder.paths();
     
-    // Upload path data to GPU
-    // Run tessellation compute shader
-    // Download results
+    // Convex fills are fanned on the GPU, their curves renumbered into one
+    // list; the others are triangulated here
+    std::vector<FillCurve> gpuCurves;
+    std::vector<size_t> gpuPaths;
+    uint32_t segmentCount = 0;
+    std::vector<std::shared_ptr<TessellatedPath>> results;
+    results.reserve(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        const FillCurveBuilder::Path& path = paths[i];
+        auto result = std::make_shared<TessellatedPath>();
+        result->bounds = path.bounds;
+        result->isConvex = path.convex;
+        result->triangleCount = 0;
+        if (path.convex) {
+            for (uint32_t c = path.firstCurve; c < path.firstCurve + path.curveCount; ++c) {
+                FillCurve curve = curves[c];
+                curve.firstSegment = curve.firstSegment - path.firstSegment + segmentCount;
+                gpuCurves.push_back(curve);
+            }
+            result->firstVertex = segmentCount * 3;
+            result->triangleCount = path.segmentCount;
+            segmentCount += path.segmentCount;
+            gpuPaths.push_back(i);
+        } else if (path.curveCount > 0) {
+            triangulate_fill(curves.data() + path.firstCurve, path.curveCount, result->vertices, result->indices);
+            result->triangleCount = static_cast<uint32_t>(result->indices.size() / 3);
+        }
+        results.push_back(std::move(result));
+    }
+    if (segmentCount == 0) {
+        return results;
+    }
     
-    // For now, return false to use CPU tessellation
-    return false;
+    // The same fans, when the GPU can't take them
+    auto fanOnCPU = [&]() {
+        for (size_t i : gpuPaths) {
+            auto& result = *results[i];
+            result.vertices.reserve(size_t(result.triangleCount) * 3);
+            build_fan_vertices(curves.data() + paths[i].firstCurve, paths[i].curveCount, result.vertices);
+            result.firstVertex = 0;
+        }
+    };
+    
+    // Control points in, triangles out; the vertices never touch the CPU.
+    // The inputs come from the upload ring, so every batch recorded this
+    // frame keeps its own.
+    const uint32_t workgroups = (segmentCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    const uint32_t workgroupsX = std::min(workgroups, 65535u);
+    FillParams params{static_cast<uint32_t>(gpuCurves.size()), segmentCount, workgroupsX * WORKGROUP_SIZE, 0};
+    
+    std::lock_guard<std::mutex> lock(batch_mutex_);
+    Rendering::UploadAllocation paramsUpload;
+    Rendering::UploadAllocation curvesUpload;
+    if (initialize()) {
+        paramsUpload = engine_.upload(&params, sizeof(params));
+        curvesUpload = engine_.upload(gpuCurves.data(), gpuCurves.size() * sizeof(FillCurve));
+    }
+    if (!paramsUpload.is_valid() || !curvesUpload.is_valid()) {
+        fanOnCPU();
+        return results;
+    }
+    
+    const size_t vertexBytes = size_t(segmentCount) * 3 * sizeof(VectorVertex);
+    Rendering::ResourceId vertexBuffer = engine_.create_buffer(
+        vertexBytes, Rendering::BufferUsage::Storage | Rendering::BufferUsage::Vertex);
+    if (vertexBuffer == 0) {
+        std::cerr << "[GPUTessellator] Failed to allocate tessellation buffers" << std::endl;
+        fanOnCPU();
+        return results;
+    }
+    
+    Rendering::ComputeDispatch dispatch;
+    dispatch.pipelineId = fillTessellationId_;
+    dispatch.workgroupsX = workgroupsX;
+    dispatch.workgroupsY = (workgroups + workgroupsX - 1) / workgroupsX;
+    dispatch.buffers = {paramsUpload.buffer, curvesUpload.buffer, vertexBuffer};
+    dispatch.bufferOffsets = {static_cast<uint32_t>(paramsUpload.offset), static_cast<uint32_t>(curvesUpload.offset), 0};
+    engine_.submit_compute(dispatch);
+    
+    Rendering::RenderingEngine& engine = engine_;
+    std::shared_ptr<const void> owner(nullptr, [&engine, vertexBuffer](const void*) {
+        engine.destroy_resource(vertexBuffer);
+    });
+    for (size_t i : gpuPaths) {
+        results[i]->vertexBufferId = vertexBuffer;
+        results[i]->isUploaded = true;
+        results[i]->gpuBufferOwner = owner;
+    }
+    return results;
+}
+
+bool GPUTessellator::create_compute_shaders() {
+    // One invocation per flattened segment: find its curve, evaluate both
+    // ends and write the fan triangle. Workgroup rows cover counts beyond
+    // one dispatch dimension.
+    fillTessellationId_ = engine_.createPipeline(R"(
+struct Curve {
+    p0: vec2<f32>,
+    p1: vec2<f32>,
+    p2: vec2<f32>,
+    p3: vec2<f32>,
+    anchor: vec2<f32>,
+    firstSegment: u32,
+    segmentCount: u32,
+};
+
+struct Params {
+    curveCount: u32,
+    segmentCount: u32,
+    segmentsPerRow: u32,
+    padding: u32,
+};
+
+// VectorVertex
+struct Vertex {
+    x: f32, y: f32,
+    u: f32, v: f32,
+    r: f32, g: f32, b: f32, a: f32,
+    coverage: f32,
+};
+
+@group(0) @binding(0) var<uniform> params: Params;
+@group(0) @binding(1) var<storage, read> curves: array<Curve>;
+@group(0) @binding(2) var<storage, read_write> vertices: array<Vertex>;
+
+fn evaluate(c: Curve, t: f32) -> vec2<f32> {
+    let mt = 1.0 - t;
+    return mt * mt * mt * c.p0 + 3.0 * mt * mt * t * c.p1 + 3.0 * mt * t * t * c.p2 + t * t * t * c.p3;
+}
+
+fn makeVertex(p: vec2<f32>, t: f32) -> Vertex {
+    return Vertex(p.x, p.y, t, 0.0, 1.0, 1.0, 1.0, 1.0, 1.0);
 }
 
-bool GPUTessellator::initializeGPUResources() {
-    // Create tessellation compute shader
-    // Allocate GPU buffers for path data and results
-    // This would require compute shader implementation
-    return false; // Not yet implemented
+@compute @workgroup_size(64)
+fn main(@builtin(global_invocation_id) id: vec3<u32>) {
+    let segment = id.y * params.segmentsPerRow + id.x;
+    if (segment >= params.segmentCount) {
+        return;
+    }
+
+    // The last curve starting at or before this segment
+    var lo = 0u;
+    var hi = params.curveCount - 1u;
+    loop {
+        if (lo >= hi) {
+            break;
+        }
+        let mid = (lo + hi + 1u) / 2u;
+        if (curves[mid].firstSegment <= segment) {
+            lo = mid;
+        } else {
+            hi = mid - 1u;
+        }
+    }
+
+    let c = curves[lo];
+    let local = segment - c.firstSegment;
+    let t0 = f32(local) / f32(c.segmentCount);
+    let t1 = f32(local + 1u) / f32(c.segmentCount);
+    let base = segment * 3u;
+    vertices[base] = makeVertex(c.anchor, 0.0);
+    vertices[base + 1u] = makeVertex(evaluate(c, t0), t0);
+    vertices[base + 2u] = makeVertex(evaluate(c, t1), t1);
+}
+)");
+    return fillTessellationId_ != 0;
+}
+
+void GPUTessellator::destroy_resources() {
+    for (Rendering::ResourceId* buffer : {&controlPointsBufferId_, &outputVerticesBufferId_,
+                                          &outputIndicesBufferId_, &parametersBufferId_}) {
+        if (*buffer != 0) {
+            engine_.destroy_resource(*buffer);
+            *buffer = 0;
+        }
+    }
 }
 
 // VectorRenderer implementation
@@ -448,6 +681,7 @@ void VectorRenderer::shutdown() {
         engine_.destroy_pipeline(pipeline_id_);
         pipeline_id_ = 0;
     }
+    destroy_resources();
     
     initialized_ = false;
     std::cout << "[VectorRenderer] Shutdown complete" << std::endl;
@@ -459,6 +693,7 @@ void VectorRenderer::render(const std::vector<VectorPath>& paths, const VectorTr
         return;
     }
     
+    Rendering::ProfileScope profile_scope(engine_.profiler(), "vector_render", "vector");
     auto start_time = std::chrono::high_resolution_clock::now();
     
     // Begin batch
@@ -487,20 +722,23 @@ void VectorRenderer::render(const std::vector<VectorPath>& paths, const VectorTr
 void VectorRenderer::renderPath(const VectorPath& path, const VectorTransform& transform) {
     // Tessellate path
     std::vector<VectorVertex> vertices;
-    
-    // Try GPU tessellation first
-    bool gpu_tessellated = false;
-    if (gpu_tessellator_ && config_.enableGPUTessellation) {
-        gpu_tessellated = gpu_tessellator_->tessellate(path, vertices);
-        if (gpu_tessellated) {
-            stats_.gpu_tessellations++;
+    {
+        Rendering::ProfileScope profile_scope(engine_.profiler(), "tessellate", "vector");
+        
+        // Try GPU tessellation first
+        bool gpu_tessellated = false;
+        if (gpu_tessellator_ && config_.enableGPUTessellation) {
+            gpu_tessellated = gpu_tessellator_->tessellate(path, vertices);
+            if (gpu_tessellated) {
+                stats_.gpu_tessellations++;
+            }
+        }
+        
+        // Fall back to CPU tessellation
+        if (!gpu_tessellated) {
+            vertices = tessellator_->tessellate(path);
+            stats_.cpu_tessellations++;
         }
-    }
-    
-    // Fall back to CPU tessellation
-    if (!gpu_tessellated) {
-        vertices = tessellator_->tessellate(path);
-        stats_.cpu_tessellations++;
     }
     
     if (vertices.empty()) {
@@ -518,6 +756,525 @@ void VectorRenderer::renderPath(const VectorPath& path, const VectorTransform& t
     stats_.vertices_generated += vertices.size();
 }
 
+std::shared_ptr<TessellatedPath> VectorRenderer::tessellate_path(const VectorPath& path) {
+    // The tolerance is in pixels; in document units it shrinks as we zoom in
+    const float tolerance = get_tessellation_tolerance() / std::max(view_scale_, 1e-6f);
+    const uint64_t path_id = compute_path_hash(path);
+    
+    if (auto cached = tessellation_cache_->find(path_id, TessellationCache::lod_level(tolerance))) {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.tessellationCacheHits++;
+        return cached;
+    }
+    
+    // Workers may tessellate after the caller's path is gone, so they get a copy
+    auto start_time = std::chrono::high_resolution_clock::now();
+    auto owned = std::make_shared<const VectorPath>(path);
+    auto lookup = tessellation_cache_->acquire(path_id, tolerance, [this, owned](float level_tolerance) {
+        return tessellate_path_internal(*owned, level_tolerance);
+    });
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - start_time);
+    
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    if (lookup.exact) {
+        stats_.tessellationCacheMisses++;
+        stats_.tessellationTime += duration;
+        if (lookup.tessellation) {
+            stats_.trianglesGenerated += lookup.tessellation->triangleCount;
+        }
+    } else {
+        stats_.tessellationLODFallbacks++;
+    }
+    return lookup.tessellation;
+}
+
+void VectorRenderer::prepare_tessellations(const std::vector<const VectorPath*>& paths) {
+    const float tolerance = get_tessellation_tolerance() / std::max(view_scale_, 1e-6f);
+    const int32_t level = TessellationCache::lod_level(tolerance);
+    
+    std::vector<const VectorPath*> missing;
+    std::vector<uint64_t> ids;
+    for (const VectorPath* path : paths) {
+        uint64_t id = compute_path_hash(*path);
+        if (!tessellation_cache_->find(id, level)) {
+            missing.push_back(path);
+            ids.push_back(id);
+        }
+    }
+    if (missing.empty() || !tessellator_) {
+        return;
+    }
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    auto tessellations = tessellator_->tessellate_paths(missing, TessellationCache::level_tolerance(level));
+    uint32_t triangles = 0;
+    for (size_t i = 0; i < tessellations.size(); ++i) {
+        triangles += tessellations[i]->triangleCount;
+        tessellation_cache_->insert(ids[i], level, std::move(tessellations[i]));
+    }
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - start_time);
+    
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.tessellationCacheMisses += static_cast<uint32_t>(missing.size());
+    stats_.trianglesGenerated += triangles;
+    stats_.tessellationTime += duration;
+}
+
+void VectorRenderer::cache_tessellation(const VectorPath& path, std::shared_ptr<TessellatedPath> tessellation) {
+    const float tolerance = get_tessellation_tolerance() / std::max(view_scale_, 1e-6f);
+    tessellation_cache_->insert(compute_path_hash(path), TessellationCache::lod_level(tolerance),
+                                std::move(tessellation));
+}
+
+void VectorRenderer::clear_tessellation_cache() {
+    tessellation_cache_->clear();
+}
+
+std::shared_ptr<TessellatedPath> VectorRenderer::tessellate_path_internal(const VectorPath& path, float tolerance) {
+    return tessellator_ ? tessellator_->tessellate_path(path, tolerance) : nullptr;
+}
+
+void VectorRenderer::render_objects(const std::vector<std::shared_ptr<VectorObject>>& objects) {
+    uint32_t visible = 0;
+    for (const auto& object : objects) {
+        if (!object) {
+            continue;
+        }
+        if (view_bounds_) {
+            const auto* bounds = object_index_.bounds(object.get());
+            if (bounds && !((*bounds)[0] <= (*view_bounds_)[2] && (*view_bounds_)[0] <= (*bounds)[2] &&
+                            (*bounds)[1] <= (*view_bounds_)[3] && (*view_bounds_)[1] <= (*bounds)[3])) {
+                continue;
+            }
+        }
+        render_object(*object);
+        visible++;
+    }
+    
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.objectsTotal += static_cast<uint32_t>(objects.size());
+    stats_.objectsVisible += visible;
+}
+
+void VectorRenderer::index_object(std::shared_ptr<VectorObject> object, const std::array<float, 4>& bounds) {
+    if (!object) {
+        return;
+    }
+    const VectorObject* key = object.get();
+    auto [it, inserted] = indexed_objects_.try_emplace(key);
+    if (inserted) {
+        it->second.object = std::move(object);
+        it->second.order = next_object_order_++;
+    }
+    object_index_.insert(key, bounds);
+}
+
+void VectorRenderer::index_objects(
+    const std::vector<std::pair<std::shared_ptr<VectorObject>, std::array<float, 4>>>& objects) {
+    // Bulk loads build the tree in one pass instead of inserting one by one
+    clear_object_index();
+    std::vector<std::pair<SpatialIndex::Key, SpatialIndex::Bounds>> items;
+    items.reserve(objects.size());
+    indexed_objects_.reserve(objects.size());
+    for (const auto& [object, bounds] : objects) {
+        if (!object) {
+            continue;
+        }
+        if (indexed_objects_.try_emplace(object.get(), IndexedObject{object, next_object_order_}).second) {
+            next_object_order_++;
+        }
+        items.emplace_back(object.get(), bounds);
+    }
+    object_index_.build(items);
+}
+
+bool VectorRenderer::unindex_object(const VectorObject& object) {
+    indexed_objects_.erase(&object);
+    return object_index_.remove(&object);
+}
+
+void VectorRenderer::clear_object_index() {
+    object_index_.clear();
+    indexed_objects_.clear();
+    next_object_order_ = 0;
+}
+
+void VectorRenderer::render_indexed_objects() {
+    visible_scratch_.clear();
+    if (view_bounds_) {
+        object_index_.query(*view_bounds_, [this](SpatialIndex::Key key) {
+            visible_scratch_.emplace_back(indexed_objects_.at(key).order, key);
+        });
+    } else {
+        for (const auto& [key, entry] : indexed_objects_) {
+            visible_scratch_.emplace_back(entry.order, key);
+        }
+    }
+    
+    // The tree returns objects in spatial order; paint in document order
+    std::sort(visible_scratch_.begin(), visible_scratch_.end());
+    for (const auto& visible : visible_scratch_) {
+        render_object(*visible.second);
+    }
+    
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.objectsTotal += static_cast<uint32_t>(object_index_.size());
+    stats_.objectsVisible += static_cast<uint32_t>(visible_scratch_.size());
+}
+
+void VectorRenderer::begin_batch() {
+    batch_state_.active = true;
+    batch_state_.vertices.clear();
+    batch_state_.indices.clear();
+    batch_state_.instances.clear();
+    batch_state_.drawCalls.clear();
+    text_batch_->clear();
+}
+
+void VectorRenderer::add_to_batch(const VectorPath& path, const VectorFillStyle& fill, 
+                                  const VectorStrokeStyle& stroke) {
+    if (!batch_state_.active) {
+        begin_batch();
+    }
+    auto tessellation = tessellate_path(path);
+    if (!tessellation) {
+        return;
+    }
+    // GPU fills have no CPU vertices to merge, so they are placed as is
+    if (tessellation->is_gpu_resident()) {
+        add_instance(std::move(tessellation), {1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f}, fill.color);
+    } else {
+        add_to_batch_internal(*tessellation, fill, stroke);
+    }
+}
+
+void VectorRenderer::add_to_batch_internal(const TessellatedPath& tessellation, 
+                                           const VectorFillStyle& fill,
+                                           const VectorStrokeStyle& stroke) {
+    (void)stroke;
+    if (tessellation.vertices.empty()) {
+        return;
+    }
+    
+    auto& batch = batch_state_;
+    const uint32_t base = static_cast<uint32_t>(batch.vertices.size());
+    for (VectorVertex vertex : tessellation.vertices) {
+        for (size_t c = 0; c < 4; ++c) {
+            vertex.color[c] *= fill.color[c];
+        }
+        batch.vertices.push_back(vertex);
+    }
+    if (tessellation.indices.empty()) {
+        for (uint32_t i = 0; i < tessellation.vertices.size(); ++i) {
+            batch.indices.push_back(base + i);
+        }
+    } else {
+        for (uint32_t index : tessellation.indices) {
+            batch.indices.push_back(base + index);
+        }
+    }
+    flush_batch_if_needed();
+}
+
+bool VectorRenderer::add_instance(std::shared_ptr<TessellatedPath> tessellation,
+                                  const std::array<float, 6>& transform,
+                                  const std::array<float, 4>& color) {
+    if (!tessellation || (tessellation->vertices.empty() && !tessellation->is_gpu_resident())) {
+        return false;
+    }
+    if (!batch_state_.active) {
+        begin_batch();
+    }
+    
+    VectorInstance instance;
+    instance.linear = {transform[0], transform[1], transform[2], transform[3]};
+    instance.translation = {transform[4], transform[5]};
+    instance.color = color;
+    batch_state_.instances.add(std::move(tessellation), instance);
+    flush_batch_if_needed();
+    return true;
+}
+
+float VectorRenderer::add_text(Rendering::FontId font, std::string_view utf8, const std::array<float, 2>& origin,
+                               float size, const std::array<float, 4>& color) {
+    if (!batch_state_.active) {
+        begin_batch();
+    }
+    float width = text_batch_->add_text(font, utf8, {origin[0], origin[1], 0.0f}, {size, 0.0f, 0.0f},
+                                        {0.0f, -size, 0.0f}, color);
+    return width * size;
+}
+
+void VectorRenderer::flush_batch_if_needed() {
+    if (batch_state_.vertices.size() >= BatchState::maxVertices ||
+        batch_state_.instances.instance_count() >= BatchState::maxInstances) {
+        render_batch();
+    }
+}
+
+bool VectorRenderer::ensure_batch_buffer(Rendering::ResourceId& buffer, size_t& capacity, size_t bytes,
+                                         Rendering::BufferUsage usage) {
+    if (buffer != 0 && capacity >= bytes) {
+        return true;
+    }
+    if (buffer != 0) {
+        engine_.destroy_resource(buffer);
+    }
+    capacity = std::max(bytes, capacity * 2);
+    buffer = engine_.create_buffer(capacity, usage | Rendering::BufferUsage::CopyDst);
+    return buffer != 0;
+}
+
+void VectorRenderer::upload_tessellation_to_gpu(TessellatedPath& tessellation) {
+    if (tessellation.isUploaded || tessellation.vertices.empty()) {
+        return;
+    }
+    
+    const size_t vertexBytes = tessellation.vertices.size() * sizeof(VectorVertex);
+    const size_t indexBytes = tessellation.indices.size() * sizeof(uint32_t);
+    Rendering::ResourceId vertexBuffer = engine_.create_buffer(
+        vertexBytes, Rendering::BufferUsage::Vertex | Rendering::BufferUsage::CopyDst);
+    Rendering::ResourceId indexBuffer = indexBytes == 0 ? 0 : engine_.create_buffer(
+        indexBytes, Rendering::BufferUsage::Index | Rendering::BufferUsage::CopyDst);
+    if (vertexBuffer == 0 || (indexBytes != 0 && indexBuffer == 0)) {
+        for (Rendering::ResourceId buffer : {vertexBuffer, indexBuffer}) {
+            if (buffer != 0) {
+                engine_.destroy_resource(buffer);
+            }
+        }
+        return;
+    }
+    engine_.update_buffer(vertexBuffer, 0, vertexBytes, tessellation.vertices.data());
+    if (indexBuffer != 0) {
+        engine_.update_buffer(indexBuffer, 0, indexBytes, tessellation.indices.data());
+    }
+    
+    // Released with the tessellation, e.g. when the cache evicts it
+    Rendering::RenderingEngine& engine = engine_;
+    tessellation.gpuBufferOwner = std::shared_ptr<const void>(nullptr, [&engine, vertexBuffer, indexBuffer](const void*) {
+        engine.destroy_resource(vertexBuffer);
+        if (indexBuffer != 0) {
+            engine.destroy_resource(indexBuffer);
+        }
+    });
+    tessellation.vertexBufferId = vertexBuffer;
+    tessellation.indexBufferId = indexBuffer;
+    tessellation.isUploaded = true;
+}
+
+void VectorRenderer::render_batch() {
+    auto& batch = batch_state_;
+    if (batch.indices.empty() && batch.instances.empty() && text_batch_->empty()) {
+        return;
+    }
+    Rendering::ProfileScope profile_scope(engine_.profiler(), "vector_batch", "vector");
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    auto discard = [this, &batch]() {
+        batch.vertices.clear();
+        batch.indices.clear();
+        batch.instances.clear();
+        batch.drawCalls.clear();
+        text_batch_->clear();
+    };
+    if (instancedFillPipelineId_ == 0 && !create_instanced_pipeline()) {
+        std::cerr << "[VectorRenderer] Failed to create instanced fill pipeline" << std::endl;
+        discard();
+        return;
+    }
+    
+    // Slot 0 is the identity placement the merged paths are drawn with; the
+    // groups' instances follow it
+    batch.instances.layout();
+    const VectorInstance identity;
+    const size_t vertexBytes = batch.vertices.size() * sizeof(VectorVertex);
+    const size_t indexBytes = batch.indices.size() * sizeof(uint32_t);
+    const size_t instanceBytes = (1 + batch.instances.instance_count()) * sizeof(VectorInstance);
+    
+    // Each batch streams through its own ring space, so batches recorded in
+    // one frame never overwrite each other; the batch buffers take over only
+    // when this frame's ring is full. fill gets a write(offset, data, size)
+    // into whichever was chosen.
+    auto stage = [&](size_t bytes, size_t alignment, Rendering::ResourceId& fallback, size_t& capacity,
+                     Rendering::BufferUsage usage, auto&& fill) {
+        Rendering::UploadAllocation allocation = engine_.allocate_upload(bytes, alignment);
+        if (allocation.is_valid()) {
+            fill([&](size_t offset, const void* data, size_t size) {
+                std::memcpy(static_cast<uint8_t*>(allocation.data) + offset, data, size);
+            });
+        } else if (ensure_batch_buffer(fallback, capacity, bytes, usage)) {
+            fill([&](size_t offset, const void* data, size_t size) {
+                engine_.update_buffer(fallback, offset, size, data);
+            });
+            allocation.buffer = fallback;
+        }
+        return allocation;
+    };
+    
+    Rendering::UploadAllocation instances = stage(
+        instanceBytes, Rendering::UploadRing::UNIFORM_ALIGNMENT, batch.batchInstanceBufferId, batch.instanceCapacity,
+        Rendering::BufferUsage::Storage, [&](auto&& write) {
+            write(0, &identity, sizeof(identity));
+            if (!batch.instances.empty()) {
+                write(sizeof(identity), batch.instances.instances().data(),
+                      batch.instances.instance_count() * sizeof(VectorInstance));
+            }
+        });
+    Rendering::UploadAllocation vertices;
+    Rendering::UploadAllocation indices;
+    if (!batch.indices.empty()) {
+        vertices = stage(vertexBytes, alignof(VectorVertex), batch.batchVertexBufferId, batch.vertexCapacity,
+                         Rendering::BufferUsage::Vertex,
+                         [&](auto&& write) { write(0, batch.vertices.data(), vertexBytes); });
+        indices = stage(indexBytes, sizeof(uint32_t), batch.batchIndexBufferId, batch.indexCapacity,
+                        Rendering::BufferUsage::Index,
+                        [&](auto&& write) { write(0, batch.indices.data(), indexBytes); });
+    }
+    if (instances.buffer == 0 || (!batch.indices.empty() && (vertices.buffer == 0 || indices.buffer == 0))) {
+        std::cerr << "[VectorRenderer] Failed to allocate batch buffers" << std::endl;
+        discard();
+        return;
+    }
+    
+    // Ordered, blended 2D draws: no depth, either winding
+    auto makeDrawCall = [&](Rendering::ResourceId vertexBuffer, Rendering::ResourceId indexBuffer,
+                            uint32_t count, uint32_t firstInstance, uint32_t instanceCount) {
+        Rendering::DrawCall call;
+        call.vertexCount = count;
+        call.vertexBufferId = vertexBuffer;
+        call.indexBufferId = indexBuffer;
+        call.firstInstance = firstInstance;
+        call.instanceCount = instanceCount;
+        call.pipelineId = instancedFillPipelineId_;
+        call.uniformBuffers = {transformUniformId_, instances.buffer};
+        call.uniformOffsets = {0, static_cast<uint32_t>(instances.offset)};
+        call.depthTest = false;
+        call.depthWrite = false;
+        call.cullFace = false;
+        call.blendEnabled = true;
+        batch.drawCalls.push_back(std::move(call));
+    };
+    
+    if (!batch.indices.empty()) {
+        makeDrawCall(vertices.buffer, indices.buffer, static_cast<uint32_t>(batch.indices.size()), 0, 1);
+        batch.drawCalls.back().vertexBufferOffset = vertices.offset;
+        batch.drawCalls.back().indexBufferOffset = indices.offset;
+    }
+    uint32_t meshVertices = 0;
+    for (const auto& group : batch.instances.groups()) {
+        TessellatedPath& mesh = *group.tessellation;
+        upload_tessellation_to_gpu(mesh);
+        if (!mesh.isUploaded) {
+            continue;
+        }
+        size_t count = mesh.indices.empty() ? mesh.vertices.size() : mesh.indices.size();
+        if (mesh.is_gpu_resident()) {
+            count = size_t(mesh.triangleCount) * 3;
+        }
+        makeDrawCall(mesh.vertexBufferId, mesh.indexBufferId, static_cast<uint32_t>(count),
+                     1 + group.firstInstance, group.instanceCount);
+        batch.drawCalls.back().firstVertex = mesh.firstVertex;
+        meshVertices += static_cast<uint32_t>(mesh.vertices.size());
+    }
+    for (const auto& call : batch.drawCalls) {
+        engine_.submit_draw_call(call);
+    }
+    
+    // Text goes over the paths, a draw per atlas page
+    const uint32_t glyphs = static_cast<uint32_t>(text_batch_->glyph_count());
+    const uint32_t textDraws = text_batch_->render(engine_, transformUniformId_);
+    
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - start_time);
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.batchesRendered++;
+        stats_.drawCalls += static_cast<uint32_t>(batch.drawCalls.size()) + textDraws;
+        stats_.glyphsRendered += glyphs;
+        stats_.instancesRendered += static_cast<uint32_t>(batch.instances.instance_count());
+        stats_.verticesUploaded += static_cast<uint32_t>(batch.vertices.size()) + meshVertices;
+        stats_.renderTime += duration;
+    }
+    discard();
+}
+
+void VectorRenderer::end_batch() {
+    render_batch();
+    batch_state_.active = false;
+}
+
+bool VectorRenderer::create_instanced_pipeline() {
+    // Each vertex is placed by its instance's transform; the merged batch
+    // paths are already in document space and use the identity in slot 0
+    instancedFillPipelineId_ = engine_.createPipeline(R"(
+struct Transform {
+    viewProjection: mat4x4<f32>,
+};
+
+// VectorInstance
+struct Instance {
+    linear: vec4<f32>,
+    translation: vec2<f32>,
+    padding: vec2<f32>,
+    color: vec4<f32>,
+};
+
+@group(0) @binding(0) var<uniform> transform: Transform;
+@group(0) @binding(1) var<storage, read> instances: array<Instance>;
+
+// VectorVertex
+struct VertexInput {
+    @location(0) position: vec2<f32>,
+    @location(1) texCoord: vec2<f32>,
+    @location(2) color: vec4<f32>,
+    @location(3) coverage: f32,
+};
+
+struct VertexOutput {
+    @builtin(position) position: vec4<f32>,
+    @location(0) color: vec4<f32>,
+};
+
+@vertex
+fn vs_main(in: VertexInput, @builtin(instance_index) index: u32) -> VertexOutput {
+    let instance = instances[index];
+    let p = vec2<f32>(instance.linear.x * in.position.x + instance.linear.z * in.position.y,
+                      instance.linear.y * in.position.x + instance.linear.w * in.position.y) +
+            instance.translation;
+    
+    var out: VertexOutput;
+    out.position = transform.viewProjection * vec4<f32>(p, 0.0, 1.0);
+    out.color = in.color * instance.color;
+    out.color.a *= in.coverage;
+    return out;
+}
+
+@fragment
+fn fs_main(in: VertexOutput) -> @location(0) vec4<f32> {
+    return in.color;
+}
+)");
+    return instancedFillPipelineId_ != 0;
+}
+
+void VectorRenderer::destroy_resources() {
+    auto& batch = batch_state_;
+    for (Rendering::ResourceId* buffer : {&batch.batchVertexBufferId, &batch.batchIndexBufferId,
+                                          &batch.batchInstanceBufferId}) {
+        if (*buffer != 0) {
+            engine_.destroy_resource(*buffer);
+            *buffer = 0;
+        }
+    }
+    batch.vertexCapacity = 0;
+    batch.indexCapacity = 0;
+    batch.instanceCapacity = 0;
+    batch.instances.clear();
+    text_batch_ = std::make_unique<Rendering::TextBatch>(text_batch_->shared_atlas());
+}
+
 void VectorRenderer::beginBatch() {
     current_vertices_.clear();
     current_indices_.clear();
@@ -529,20 +1286,27 @@ void VectorRenderer::endBatch() {
         return;
     }
     
-    // Upload vertex data
-    engine_.update_buffer(vertex_buffer_id_, 0, 
-                         current_vertices_.data(), 
-                         current_vertices_.size() * sizeof(VectorVertex));
+    const size_t vertex_bytes = current_vertices_.size() * sizeof(VectorVertex);
+    const size_t index_bytes = current_indices_.size() * sizeof(uint32_t);
     
-    // Upload index data
-    engine_.update_buffer(index_buffer_id_, 0,
-                         current_indices_.data(),
-                         current_indices_.size() * sizeof(uint32_t));
+    // Stream the batch through the upload ring; fall back to the batch
+    // buffers only when this frame's ring space is exhausted
+    auto vertices = engine_.upload(current_vertices_.data(), vertex_bytes, alignof(VectorVertex));
+    auto indices = engine_.upload(current_indices_.data(), index_bytes, sizeof(uint32_t));
+    
+    if (!vertices.is_valid()) {
+        engine_.update_buffer(vertex_buffer_id_, 0, current_vertices_.data(), vertex_bytes);
+        vertices.buffer = vertex_buffer_id_;
+    }
+    if (!indices.is_valid()) {
+        engine_.update_buffer(index_buffer_id_, 0, current_indices_.data(), index_bytes);
+        indices.buffer = index_buffer_id_;
+    }
     
     // Set pipeline and buffers
     engine_.set_pipeline(pipeline_id_);
-    engine_.set_vertex_buffer(0, vertex_buffer_id_, 0, sizeof(VectorVertex));
-    engine_.set_index_buffer(index_buffer_id_, Rendering::IndexFormat::Uint32, 0);
+    engine_.set_vertex_buffer(0, vertices.buffer, vertices.offset, sizeof(VectorVertex));
+    engine_.set_index_buffer(indices.buffer, Rendering::IndexFormat::Uint32, indices.offset);
     
     // Draw
     engine_.draw_indexed(current_indices_.size(), 1, 0, 0, 0);
@@ -1,9 +1,14 @@
 #pragma once
 
 #include "../../core/rendering/rendering_engine.hpp"
+#include "../../core/rendering/text_batch.hpp"
+#include "instance_batch.hpp"
+#include "spatial_index.hpp"
+#include "tessellation_cache.hpp"
 #include <vector>
 #include <memory>
 #include <array>
+#include <optional>
 
 namespace QuantumCanvas::Vector {
 
@@ -11,6 +16,7 @@ namespace QuantumCanvas::Vector {
 class VectorPath;
 class VectorObject;
 class GPUTessellator;
+class FillCurveBuilder;
 
 // Vector rendering configuration
 struct VectorRenderConfig {
@@ -67,6 +73,15 @@ struct TessellatedPath {
     Rendering::ResourceId vertexBufferId = 0;
     Rendering::ResourceId indexBufferId = 0;
     bool isUploaded = false;
+    
+    // Fills tessellated on the GPU keep no vertices here: they are
+    // triangleCount triangles of vertexBufferId from firstVertex, not
+    // indexed. The paths of one batch share the vertex buffer, released
+    // with the last of them.
+    uint32_t firstVertex = 0;
+    std::shared_ptr<const void> gpuBufferOwner;
+    
+    bool is_gpu_resident() const { return vertices.empty() && isUploaded; }
 };
 
 // Fill styles for vector objects
@@ -99,6 +114,8 @@ struct VectorFillStyle {
     // Pattern settings
     struct Pattern {
         Rendering::ResourceId textureId = 0;
+        // Keeps textureId alive when it came from the shared asset cache
+        std::shared_ptr<const Rendering::ResourceId> texture;
         std::array<float, 2> scale{1.0f, 1.0f};
         std::array<float, 2> offset{0.0f, 0.0f};
         float rotation = 0.0f;
@@ -153,27 +170,71 @@ public:
     void render_path(const VectorPath& path, const VectorFillStyle& fill, 
                     const VectorStrokeStyle& stroke = {});
     
-    // Batch rendering for performance
+    // Batch rendering for performance. The batch's GPU buffers grow to fit
+    // and are reused from frame to frame, so large batches are not split.
     void begin_batch();
     void add_to_batch(const VectorPath& path, const VectorFillStyle& fill, 
                      const VectorStrokeStyle& stroke = {});
+    // Places a cached tessellation again with its own transform (a, b, c, d,
+    // tx, ty) and a color multiplying its vertex colors. All placements of
+    // one tessellation in a batch are drawn with a single instanced call,
+    // after the batch's merged paths, as are the GPU-resident fills
+    // add_to_batch() places. False for an empty tessellation.
+    bool add_instance(std::shared_ptr<TessellatedPath> tessellation, const std::array<float, 6>& transform,
+                      const std::array<float, 4>& color = {1.0f, 1.0f, 1.0f, 1.0f});
+    // A line of text from its baseline origin, size in document units per
+    // em; document y runs down. Drawn from the glyph atlas after the batch's
+    // paths. Returns the line's width in document units.
+    float add_text(Rendering::FontId font, std::string_view utf8, const std::array<float, 2>& origin,
+                   float size, const std::array<float, 4>& color = {0.0f, 0.0f, 0.0f, 1.0f});
     void render_batch();
     void end_batch();
     
-    // Direct object rendering
+    // Direct object rendering. With a view set, objects are culled against
+    // it: indexed objects by their indexed bounds, others are always drawn.
     void render_object(const VectorObject& object);
     void render_objects(const std::vector<std::shared_ptr<VectorObject>>& objects);
     
+    // Persistent scene index. Documents register their objects once and
+    // report edits as they happen; render_indexed_objects() then visits only
+    // what overlaps the view, in registration order, whatever the document size.
+    void index_object(std::shared_ptr<VectorObject> object, const std::array<float, 4>& bounds); // Inserts or moves
+    void index_objects(const std::vector<std::pair<std::shared_ptr<VectorObject>, std::array<float, 4>>>& objects);
+    bool unindex_object(const VectorObject& object);
+    void clear_object_index();
+    const SpatialIndex& get_object_index() const { return object_index_; }
+    void render_indexed_objects();
+    
+    // Document-space rectangle being drawn (min_x, min_y, max_x, max_y)
+    void set_view_bounds(const std::array<float, 4>& bounds) { view_bounds_ = bounds; }
+    void clear_view_bounds() { view_bounds_.reset(); }
+    const std::optional<std::array<float, 4>>& get_view_bounds() const { return view_bounds_; }
+    
     // Advanced rendering modes
     void render_with_clipping(const VectorPath& clipPath, 
                              const std::vector<std::shared_ptr<VectorObject>>& objects);
     void render_with_effects(const std::vector<std::shared_ptr<VectorObject>>& objects,
                             const std::vector<class VectorEffect*>& effects);
     
-    // Tessellation control
+    // Tessellation control. Paths are tessellated to the configured pixel
+    // tolerance at the current view scale; after a zoom the nearest cached
+    // level of detail is returned while the new one is computed on workers.
     std::shared_ptr<TessellatedPath> tessellate_path(const VectorPath& path);
     void cache_tessellation(const VectorPath& path, std::shared_ptr<TessellatedPath> tessellation);
     void clear_tessellation_cache();
+    // Tessellates, in one GPU batch, those of the paths not yet cached at
+    // the current level of detail; for large or animated documents
+    void prepare_tessellations(const std::vector<const VectorPath*>& paths);
+    void set_tessellation_cache_budget(size_t bytes) { tessellation_cache_->set_byte_budget(bytes); }
+    const TessellationCache& get_tessellation_cache() const { return *tessellation_cache_; }
+    
+    // Glyph atlas text is drawn from; shared with the CAD annotations by default
+    void set_glyph_atlas(std::shared_ptr<Rendering::GlyphAtlas> atlas) { text_batch_->set_atlas(std::move(atlas)); }
+    Rendering::GlyphAtlas& get_glyph_atlas() { return text_batch_->atlas(); }
+    
+    // Pixels per document unit
+    void set_view_scale(float scale) { view_scale_ = scale; }
+    float get_view_scale() const { return view_scale_; }
     
     // Configuration
     void update_config(const VectorRenderConfig& config);
@@ -185,8 +246,14 @@ public:
         uint32_t trianglesGenerated = 0;
         uint32_t tessellationCacheHits = 0;
         uint32_t tessellationCacheMisses = 0;
+        uint32_t tessellationLODFallbacks = 0;  // Another level drawn while the exact one is computed
         uint32_t batchesRendered = 0;
+        uint32_t drawCalls = 0;
+        uint32_t instancesRendered = 0;     // Placements drawn by instanced calls
+        uint32_t glyphsRendered = 0;
         uint32_t verticesUploaded = 0;
+        uint32_t objectsTotal = 0;          // Considered for drawing
+        uint32_t objectsVisible = 0;        // Of those, drawn after view culling
         std::chrono::microseconds tessellationTime{0};
         std::chrono::microseconds renderTime{0};
         size_t gpuMemoryUsed = 0;
@@ -209,26 +276,49 @@ private:
     Rendering::PipelineId gradientPipelineId_ = 0;
     Rendering::PipelineId patternPipelineId_ = 0;
     Rendering::PipelineId tessellationComputeId_ = 0;
+    Rendering::PipelineId instancedFillPipelineId_ = 0;  // Also draws the merged batch paths
     
     // Uniform buffers
     Rendering::ResourceId transformUniformId_ = 0;
     Rendering::ResourceId styleUniformId_ = 0;
     
-    // Tessellation cache
-    mutable std::mutex tessellation_cache_mutex_;
-    std::unordered_map<uint64_t, std::shared_ptr<TessellatedPath>> tessellation_cache_;
-    size_t max_cache_size_ = 1000;
+    // Tessellation cache, by path and level of detail
+    std::unique_ptr<TessellationCache> tessellation_cache_ = std::make_unique<TessellationCache>();
+    float view_scale_ = 1.0f;
     
-    // Batch rendering state
+    // Text of the current batch
+    std::unique_ptr<Rendering::TextBatch> text_batch_ = std::make_unique<Rendering::TextBatch>();
+    
+    // Scene index; order keeps draw order independent of the tree's layout
+    struct IndexedObject {
+        std::shared_ptr<VectorObject> object;
+        uint64_t order = 0;
+    };
+    SpatialIndex object_index_;
+    std::unordered_map<const VectorObject*, IndexedObject> indexed_objects_;
+    uint64_t next_object_order_ = 0;
+    std::optional<std::array<float, 4>> view_bounds_;
+    std::vector<std::pair<uint64_t, SpatialIndex::Key>> visible_scratch_;  // Order, object
+    
+    // Batch rendering state. Buffers keep their capacity between batches.
+    // The GPU ones only hold batches that miss the frame's upload ring, and
+    // grow by doubling to the largest of those.
     struct BatchState {
         bool active = false;
         std::vector<VectorVertex> vertices;
         std::vector<uint32_t> indices;
+        InstanceBatch instances;
         std::vector<Rendering::DrawCall> drawCalls;
         Rendering::ResourceId batchVertexBufferId = 0;
         Rendering::ResourceId batchIndexBufferId = 0;
-        size_t maxVertices = 65536;
-        size_t maxIndices = 196608;
+        Rendering::ResourceId batchInstanceBufferId = 0;
+        size_t vertexCapacity = 0;    // In bytes
+        size_t indexCapacity = 0;
+        size_t instanceCapacity = 0;
+        
+        // Flush points bounding the memory a batch holds, not buffer sizes
+        static constexpr size_t maxVertices = size_t(1) << 22;
+        static constexpr size_t maxInstances = size_t(1) << 20;
     };
     BatchState batch_state_;
     
@@ -241,7 +331,7 @@ private:
     bool create_uniforms();
     void destroy_resources();
     
-    std::shared_ptr<TessellatedPath> tessellate_path_internal(const VectorPath& path);
+    std::shared_ptr<TessellatedPath> tessellate_path_internal(const VectorPath& path, float tolerance);
     void upload_tessellation_to_gpu(TessellatedPath& tessellation);
     
     void render_fill(const TessellatedPath& tessellation, const VectorFillStyle& fill);
@@ -256,9 +346,11 @@ private:
                               const VectorFillStyle& fill,
                               const VectorStrokeStyle& stroke);
     void flush_batch_if_needed();
+    bool ensure_batch_buffer(Rendering::ResourceId& buffer, size_t& capacity, size_t bytes,
+                             Rendering::BufferUsage usage);
+    bool create_instanced_pipeline();
     
     uint64_t compute_path_hash(const VectorPath& path) const;
-    void cleanup_tessellation_cache();
     
     // Curve quality mapping
     float get_tessellation_tolerance() const;
@@ -283,8 +375,20 @@ public:
         const std::vector<std::array<float, 2>>& controlPoints,
         float tolerance);
     
-    // Tessellate complex paths
+    // Tessellate complex fills, one result per path. Convex fills are
+    // flattened and fanned by a compute shader straight into a vertex
+    // buffer, so the CPU only walks the path commands and uploads control
+    // points; batching many paths costs one dispatch. A fan only covers a
+    // convex fill exactly once, so the others are triangulated on the CPU
+    // into TessellatedPath::vertices, as are the fans without a GPU.
     std::shared_ptr<TessellatedPath> tessellate_path(const VectorPath& path, float tolerance);
+    std::vector<std::shared_ptr<TessellatedPath>> tessellate_paths(const std::vector<const VectorPath*>& paths,
+                                                                   float tolerance);
+    std::vector<std::shared_ptr<TessellatedPath>> tessellate_fills(const FillCurveBuilder& builder);
+    bool is_gpu_available() const { return initialized_; }
+    
+    static constexpr uint32_t WORKGROUP_SIZE = 64;
+    static constexpr uint32_t MAX_SEGMENTS_PER_CURVE = 1024;
     
     // Stroke tessellation
     std::shared_ptr<TessellatedPath> tessellate_stroke(const VectorPath& path, 
@@ -304,6 +408,10 @@ private:
     Rendering::ResourceId outputIndicesBufferId_ = 0;
     Rendering::ResourceId parametersBufferId_ = 0;
     
+    Rendering::PipelineId fillTessellationId_ = 0;
+    bool initialized_ = false;
+    std::mutex batch_mutex_;  // Guards initialization and shutdown
+    
     bool create_compute_shaders();
     void destroy_resources();
     
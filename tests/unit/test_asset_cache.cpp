@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/io/asset_cache.hpp"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace QuantumCanvas::IO;
+using QuantumCanvas::Raster::Image;
+
+namespace {
+
+class AssetCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory_ = std::filesystem::temp_directory_path() / "qcs_asset_cache_test";
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+    }
+
+    void TearDown() override {
+        std::error_code error;
+        std::filesystem::remove_all(directory_, error);
+    }
+
+    std::filesystem::path writeFile(const std::string& name, const std::string& contents) const {
+        const auto filePath = directory_ / name;
+        std::ofstream(filePath, std::ios::binary) << contents;
+        return filePath;
+    }
+
+    // "Decodes" a 1-tile image whose first pixel's red channel is the file's first byte
+    DecodedAssetCache makeCache(const DecodedAssetCache::Settings& settings = {}) {
+        return DecodedAssetCache(
+            [this](const std::shared_ptr<const ByteSource>& source) -> std::shared_ptr<Image> {
+                decodes_++;
+                if (source->empty() || source->data()[0] == '!') {
+                    throw std::runtime_error("Not an image");
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                auto image = std::make_shared<Image>(16, 16);
+                image->setPixel(0, 0, {float(source->data()[0]), 0.0f, 0.0f, 1.0f});
+                return image;
+            },
+            [this](const Image& image) {
+                DecodedAssetCache::Upload upload;
+                upload.id = ++nextTexture_;
+                upload.bytes = uint64_t(image.width()) * image.height() * 4;
+                return upload;
+            },
+            [this](QuantumCanvas::Rendering::ResourceId id) {
+                std::lock_guard<std::mutex> lock(releasedMutex_);
+                released_.insert(id);
+            },
+            settings);
+    }
+
+    size_t releasedCount() {
+        std::lock_guard<std::mutex> lock(releasedMutex_);
+        return released_.size();
+    }
+
+    std::filesystem::path directory_;
+    std::atomic<int> decodes_{0};
+    std::atomic<QuantumCanvas::Rendering::ResourceId> nextTexture_{0};
+    std::mutex releasedMutex_;
+    std::set<QuantumCanvas::Rendering::ResourceId> released_;
+};
+
+const uint64_t TILE_BYTES = Image::TILE_FLOATS * sizeof(float);
+
+} // namespace
+
+TEST_F(AssetCacheTest, SharesOneDecodeAcrossPathsWithTheSameContents) {
+    DecodedAssetCache cache = makeCache();
+    const auto brush = writeFile("brush.png", "A-texture");
+    const auto copy = writeFile("copy of brush.png", "A-texture");
+    const auto other = writeFile("other.png", "B-texture");
+
+    auto first = cache.image(brush);
+    EXPECT_EQ(cache.image(copy), first);
+    EXPECT_EQ(cache.image(std::make_shared<const ByteSource>(
+                  ByteSource::fromBuffer(std::vector<uint8_t>{'A', '-', 't', 'e', 'x', 't', 'u', 'r', 'e'}))),
+              first);
+    EXPECT_NE(cache.image(other), first);
+    EXPECT_EQ(first->getPixel(0, 0)[0], float('A'));
+    EXPECT_EQ(decodes_, 2);
+
+    const auto stats = cache.getStats();
+    EXPECT_EQ(stats.imageMisses, 2u);
+    EXPECT_EQ(stats.imageHits, 2u);
+    EXPECT_EQ(stats.imageCount, 2u);
+    EXPECT_EQ(stats.imageBytes, 2 * TILE_BYTES);
+
+    // An edited file is a different asset
+    writeFile("brush.png", "C-texture!");
+    EXPECT_NE(cache.image(brush), first);
+    EXPECT_EQ(decodes_, 3);
+}
+
+TEST_F(AssetCacheTest, EvictsToTheBudgetButKeepsHeldAssetsShared) {
+    DecodedAssetCache::Settings settings;
+    settings.ramBudget = 2 * TILE_BYTES;
+    DecodedAssetCache cache = makeCache(settings);
+
+    auto held = cache.image(writeFile("a.png", "a"));
+    cache.image(writeFile("b.png", "b"));
+    cache.image(writeFile("c.png", "c"));
+    EXPECT_EQ(cache.getStats().imageCount, 2u);
+    EXPECT_EQ(cache.getStats().evictions, 1u);
+
+    // The evicted image is still held here, so asking again shares it
+    EXPECT_EQ(cache.image(directory_ / "a.png"), held);
+    EXPECT_EQ(decodes_, 3);
+
+    // Released everywhere, an evicted image decodes again
+    cache.setSettings({0, settings.vramBudget});
+    EXPECT_EQ(cache.getStats().imageCount, 0u);
+    held.reset();
+    cache.image(directory_ / "b.png");
+    EXPECT_EQ(decodes_, 4);
+}
+
+TEST_F(AssetCacheTest, ReleasesTexturesOnlyWhenUnusedAndEvicted) {
+    DecodedAssetCache::Settings settings;
+    settings.vramBudget = 16 * 16 * 4;  // One texture
+    DecodedAssetCache cache = makeCache(settings);
+    const auto pattern = writeFile("pattern.png", "p");
+
+    auto texture = cache.texture(pattern);
+    ASSERT_NE(texture, nullptr);
+    EXPECT_EQ(cache.texture(pattern), texture);
+    EXPECT_EQ(cache.texture(writeFile("same.png", "p")), texture);
+    EXPECT_EQ(cache.getStats().textureMisses, 1u);
+    EXPECT_EQ(decodes_, 1);
+
+    // Evicted by a second texture, but still held: nothing is released yet
+    const QuantumCanvas::Rendering::ResourceId id = *texture;
+    auto second = cache.texture(writeFile("second.png", "s"));
+    EXPECT_EQ(cache.getStats().evictions, 1u);
+    EXPECT_EQ(releasedCount(), 0u);
+    texture.reset();
+    EXPECT_EQ(released_.count(id), 1u);
+
+    // Clearing lets go of the cache's reference only
+    cache.clear();
+    EXPECT_EQ(releasedCount(), 1u);
+    second.reset();
+    EXPECT_EQ(releasedCount(), 2u);
+}
+
+TEST_F(AssetCacheTest, DecodesOnceUnderConcurrentRequests) {
+    DecodedAssetCache cache = makeCache();
+    const auto placed = writeFile("placed.png", "x");
+
+    std::vector<std::thread> threads;
+    std::vector<DecodedAssetCache::ImageHandle> images(8);
+    for (size_t i = 0; i < images.size(); ++i) {
+        threads.emplace_back([&, i] { images[i] = cache.image(placed); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(decodes_, 1);
+    for (const auto& image : images) {
+        EXPECT_EQ(image, images[0]);
+    }
+}
+
+TEST_F(AssetCacheTest, ReportsUnreadableAssets) {
+    DecodedAssetCache cache = makeCache();
+    EXPECT_THROW(cache.image(directory_ / "missing.png"), std::runtime_error);
+
+    const auto broken = writeFile("broken.png", "!");
+    EXPECT_THROW(cache.image(broken), std::runtime_error);
+    EXPECT_THROW(cache.texture(broken), std::runtime_error);
+    EXPECT_EQ(decodes_, 2);  // Failures are not cached
+    EXPECT_EQ(cache.getStats().imageCount, 0u);
+}
@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/io/batch_engine.hpp"
+#include "../../src/core/kernel/task_scheduler.hpp"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace QuantumCanvas::IO;
+using QuantumCanvas::Core::TaskScheduler;
+
+namespace {
+
+class BatchEngineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory_ = std::filesystem::temp_directory_path() / "qcs_batch_engine_test";
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+    }
+
+    void TearDown() override {
+        std::error_code error;
+        std::filesystem::remove_all(directory_, error);
+    }
+
+    std::filesystem::path path(const std::string& name) const { return directory_ / name; }
+
+    std::filesystem::path writeFile(const std::string& name, size_t size, uint8_t fill = 0x5A) const {
+        const auto filePath = path(name);
+        std::ofstream file(filePath, std::ios::binary);
+        const std::vector<char> bytes(size, char(fill));
+        file.write(bytes.data(), std::streamsize(bytes.size()));
+        return filePath;
+    }
+
+    static std::vector<uint8_t> readFile(const std::filesystem::path& filePath) {
+        std::ifstream file(filePath, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), {});
+    }
+
+    std::filesystem::path directory_;
+};
+
+} // namespace
+
+TEST_F(BatchEngineTest, StartsLargestJobsFirst) {
+    std::vector<std::filesystem::path> inputs = {
+        writeFile("small.bin", 1000), writeFile("large.bin", 30000), writeFile("medium.bin", 9000)};
+
+    // One I/O thread and no scheduler: jobs run one at a time, in queue order
+    BatchEngine::Settings settings;
+    settings.ioThreads = 1;
+    BatchEngine engine(nullptr, settings);
+
+    std::vector<size_t> order;
+    std::mutex orderMutex;
+    std::vector<BatchEngine::Job> jobs;
+    for (const auto& input : inputs) {
+        BatchEngine::Job job;
+        job.inputPath = input;
+        job.process = [&](const std::shared_ptr<const ByteSource>& source) {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(source->size());
+            return std::vector<uint8_t>();
+        };
+        jobs.push_back(std::move(job));
+    }
+
+    const BatchStats stats = engine.run(std::move(jobs));
+    EXPECT_EQ(order, (std::vector<size_t>{30000, 9000, 1000}));
+    EXPECT_EQ(stats.filesCompleted, 3u);
+    EXPECT_EQ(stats.filesFailed, 0u);
+    EXPECT_EQ(stats.bytesRead, 40000u);
+}
+
+TEST_F(BatchEngineTest, KeepsBytesInFlightWithinTheBudget) {
+    TaskScheduler scheduler(3);
+    ASSERT_TRUE(scheduler.initialize());
+    std::shared_ptr<TaskScheduler> shared(&scheduler, [](TaskScheduler*) {});
+
+    BatchEngine::Settings settings;
+    settings.ioThreads = 4;
+    settings.memoryBudget = 25000;
+    BatchEngine engine(shared, settings);
+
+    std::vector<BatchEngine::Job> jobs;
+    for (int i = 0; i < 12; ++i) {
+        BatchEngine::Job job;
+        job.inputPath = writeFile("in" + std::to_string(i) + ".bin", 10000);
+        job.process = [](const std::shared_ptr<const ByteSource>&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            return std::vector<uint8_t>();
+        };
+        jobs.push_back(std::move(job));
+    }
+
+    // A job over the whole budget still runs, on its own
+    BatchEngine::Job huge;
+    huge.inputPath = writeFile("huge.bin", 60000);
+    jobs.push_back(std::move(huge));
+
+    const BatchStats stats = engine.run(std::move(jobs));
+    EXPECT_EQ(stats.filesCompleted, 13u);
+    EXPECT_EQ(stats.peakBytesInFlight, 60000u);
+
+    // Without it, the ten-kilobyte files run at most two at a time
+    std::vector<BatchEngine::Job> smallJobs;
+    for (int i = 0; i < 12; ++i) {
+        BatchEngine::Job job;
+        job.inputPath = path("in" + std::to_string(i) + ".bin");
+        smallJobs.push_back(std::move(job));
+    }
+    EXPECT_LE(engine.run(std::move(smallJobs)).peakBytesInFlight, 20000u);
+    scheduler.shutdown();
+}
+
+TEST_F(BatchEngineTest, WritesProcessedOutput) {
+    TaskScheduler scheduler(3);
+    ASSERT_TRUE(scheduler.initialize());
+    std::shared_ptr<TaskScheduler> shared(&scheduler, [](TaskScheduler*) {});
+    BatchEngine engine(shared);
+
+    std::vector<BatchEngine::Job> jobs;
+    for (int i = 0; i < 8; ++i) {
+        BatchEngine::Job job;
+        job.inputPath = writeFile("in" + std::to_string(i) + ".bin", 5000 + i, uint8_t(i));
+        job.outputPath = path("out" + std::to_string(i) + ".bin");
+        job.process = [](const std::shared_ptr<const ByteSource>& source) {
+            std::vector<uint8_t> output(source->data(), source->data() + source->size());
+            for (uint8_t& byte : output) {
+                byte ^= 0xFF;
+            }
+            return output;
+        };
+        jobs.push_back(std::move(job));
+    }
+
+    const BatchStats stats = engine.run(std::move(jobs));
+    EXPECT_EQ(stats.filesCompleted, 8u);
+    EXPECT_EQ(stats.bytesRead, stats.bytesWritten);
+    EXPECT_GT(stats.megabytesPerSecond(), 0.0);
+    EXPECT_GT(stats.filesPerSecond(), 0.0);
+
+    for (int i = 0; i < 8; ++i) {
+        const std::vector<uint8_t> output = readFile(path("out" + std::to_string(i) + ".bin"));
+        ASSERT_EQ(output.size(), size_t(5000 + i));
+        EXPECT_EQ(output.front(), uint8_t(~i));
+        EXPECT_EQ(output.back(), uint8_t(~i));
+    }
+    scheduler.shutdown();
+}
+
+TEST_F(BatchEngineTest, ReportsFailuresPerJob) {
+    BatchEngine engine;
+
+    std::atomic<int> failures{0};
+    std::atomic<int> successes{0};
+    auto onDone = [&](std::exception_ptr error) { (error ? failures : successes)++; };
+
+    std::vector<BatchEngine::Job> jobs(4);
+    jobs[0].inputPath = path("missing.bin");  // Read fails
+    jobs[1].inputPath = writeFile("bad.bin", 100);
+    jobs[1].process = [](const std::shared_ptr<const ByteSource>&) -> std::vector<uint8_t> {
+        throw std::runtime_error("Decode failed");
+    };
+    jobs[2].inputPath = writeFile("good.bin", 100);
+    jobs[2].outputPath = directory_ / "no_such_directory" / "out.bin";  // Write fails
+    jobs[2].process = [](const std::shared_ptr<const ByteSource>&) { return std::vector<uint8_t>(10); };
+    jobs[3].process = [](const std::shared_ptr<const ByteSource>& source) {  // Nothing to read
+        EXPECT_EQ(source, nullptr);
+        return std::vector<uint8_t>();
+    };
+    for (auto& job : jobs) {
+        job.onDone = onDone;
+    }
+
+    const BatchStats stats = engine.run(std::move(jobs));
+    EXPECT_EQ(stats.filesFailed, 3u);
+    EXPECT_EQ(stats.filesCompleted, 1u);
+    EXPECT_EQ(failures, 3);
+    EXPECT_EQ(successes, 1);
+}
+
+TEST_F(BatchEngineTest, WaitsFromASchedulerWorker) {
+    auto scheduler = std::make_shared<TaskScheduler>(1);
+    ASSERT_TRUE(scheduler->initialize());
+    BatchEngine engine(scheduler);
+
+    std::vector<BatchEngine::Job> jobs;
+    for (int i = 0; i < 4; ++i) {
+        BatchEngine::Job job;
+        job.inputPath = writeFile("in" + std::to_string(i) + ".bin", 1000);
+        job.process = [](const std::shared_ptr<const ByteSource>&) { return std::vector<uint8_t>(); };
+        jobs.push_back(std::move(job));
+    }
+
+    // The only worker blocks in wait(), so it has to run the process steps itself
+    auto future = scheduler->async([&engine, &jobs] { return engine.run(std::move(jobs)).filesCompleted; });
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    EXPECT_EQ(future.get(), 4u);
+    scheduler->shutdown();
+}
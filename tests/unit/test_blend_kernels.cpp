@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/raster/blend_kernels.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace QuantumCanvas::Raster;
+
+namespace {
+
+// Premultiplied planes with a pixel count that leaves a scalar tail on every ISA
+struct PlanarBuffer {
+    explicit PlanarBuffer(size_t count) : data(count * 4), count(count) {}
+
+    CpuBlend::Planes planes() {
+        return {data.data(), data.data() + count, data.data() + count * 2, data.data() + count * 3};
+    }
+    CpuBlend::ConstPlanes constPlanes() const {
+        return {data.data(), data.data() + count, data.data() + count * 2, data.data() + count * 3};
+    }
+
+    std::vector<float> data;
+    size_t count;
+};
+
+PlanarBuffer randomPixels(size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    PlanarBuffer buffer(count);
+    auto planes = buffer.planes();
+    for (size_t i = 0; i < count; ++i) {
+        float alpha = unit(rng);
+        for (int c = 0; c < 3; ++c) {
+            planes[c][i] = unit(rng) * alpha;
+        }
+        planes[3][i] = alpha;
+    }
+    return buffer;
+}
+
+std::vector<BlendMode> supportedModes() {
+    std::vector<BlendMode> modes;
+    for (uint16_t m = 0; m <= static_cast<uint16_t>(BlendMode::Add); ++m) {
+        if (CpuBlend::isSupported(static_cast<BlendMode>(m))) {
+            modes.push_back(static_cast<BlendMode>(m));
+        }
+    }
+    return modes;
+}
+
+} // namespace
+
+TEST(BlendKernelsTest, ScalarMatchesClosedForms) {
+    // Opaque base, half transparent overlay at half opacity: as = 0.25
+    PlanarBuffer base(1);
+    PlanarBuffer overlay(1);
+    auto b = base.planes();
+    auto o = overlay.planes();
+
+    auto reset = [&] {
+        b[0][0] = 0.6f; b[1][0] = 0.2f; b[2][0] = 1.0f; b[3][0] = 1.0f;
+        o[0][0] = 0.4f; o[1][0] = 0.1f; o[2][0] = 0.0f; o[3][0] = 0.5f;  // Straight 0.8, 0.2, 0
+    };
+
+    reset();
+    ASSERT_TRUE(CpuBlend::blend(CpuBlend::Isa::Scalar, BlendMode::Normal, b, overlay.constPlanes(), 1, 0.5f));
+    EXPECT_NEAR(b[0][0], 0.6f * 0.75f + 0.8f * 0.25f, 1e-6f);
+    EXPECT_NEAR(b[3][0], 1.0f, 1e-6f);
+
+    reset();
+    ASSERT_TRUE(CpuBlend::blend(CpuBlend::Isa::Scalar, BlendMode::Multiply, b, overlay.constPlanes(), 1, 0.5f));
+    EXPECT_NEAR(b[0][0], 0.6f * 0.75f + 0.6f * 0.8f * 0.25f, 1e-6f);
+    EXPECT_NEAR(b[2][0], 0.75f, 1e-6f);
+
+    reset();
+    ASSERT_TRUE(CpuBlend::blend(CpuBlend::Isa::Scalar, BlendMode::Screen, b, overlay.constPlanes(), 1, 0.5f));
+    EXPECT_NEAR(b[1][0], 0.2f * 0.75f + (1.0f - 0.8f * 0.8f) * 0.25f, 1e-6f);
+
+    reset();
+    ASSERT_TRUE(CpuBlend::blend(CpuBlend::Isa::Scalar, BlendMode::Clear, b, overlay.constPlanes(), 1, 0.5f));
+    EXPECT_NEAR(b[3][0], 0.75f, 1e-6f);
+}
+
+TEST(BlendKernelsTest, EveryIsaMatchesScalar) {
+    const size_t count = 1000 + 13;
+    const auto overlay = randomPixels(count, 7);
+    const auto base = randomPixels(count, 11);
+
+    for (auto isa : {CpuBlend::Isa::AVX2, CpuBlend::Isa::AVX512, CpuBlend::Isa::NEON}) {
+        if (!CpuBlend::isIsaAvailable(isa)) continue;
+
+        for (BlendMode mode : supportedModes()) {
+            auto expected = base;
+            auto actual = base;
+            ASSERT_TRUE(CpuBlend::blend(CpuBlend::Isa::Scalar, mode, expected.planes(), overlay.constPlanes(), count, 0.7f));
+            ASSERT_TRUE(CpuBlend::blend(isa, mode, actual.planes(), overlay.constPlanes(), count, 0.7f));
+
+            for (size_t i = 0; i < expected.data.size(); ++i) {
+                ASSERT_NEAR(actual.data[i], expected.data[i], 1e-4f)
+                    << CpuBlend::isaName(isa) << " mode " << static_cast<int>(mode) << " value " << i;
+            }
+        }
+    }
+}
+
+TEST(BlendKernelsTest, RejectsNonSeparableModes) {
+    PlanarBuffer base(4);
+    PlanarBuffer overlay(4);
+    EXPECT_FALSE(CpuBlend::isSupported(BlendMode::Hue));
+    EXPECT_FALSE(CpuBlend::isSupported(BlendMode::Custom));
+    EXPECT_FALSE(CpuBlend::blend(BlendMode::Luminosity, base.planes(), overlay.constPlanes(), 4, 1.0f));
+}
+
+TEST(BlendKernelsTest, BlendImageTouchesOnlyOverlayTiles) {
+    const Image::Pixel white = {1.0f, 1.0f, 1.0f, 1.0f};
+    Image base(600, 300, white);
+    Image overlay(600, 300);
+    overlay.setPixel(520, 10, {1.0f, 0.0f, 0.0f, 1.0f});
+
+    ASSERT_TRUE(CpuBlend::blendImage(base, overlay, BlendMode::Multiply, 1.0f));
+    EXPECT_EQ(base.allocatedTileCount(), 1u);
+
+    auto red = base.getPixel(520, 10);
+    EXPECT_NEAR(red[0], 1.0f, 1e-6f);
+    EXPECT_NEAR(red[1], 0.0f, 1e-6f);
+    EXPECT_EQ(base.getPixel(521, 10), white);
+
+    // Edge tile pixels beyond the border keep the fill color
+    base.resize({1024, 300});
+    EXPECT_EQ(base.getPixel(700, 10), white);
+
+    Image mismatched(10, 10);
+    EXPECT_FALSE(CpuBlend::blendImage(base, mismatched, BlendMode::Normal, 1.0f));
+}
@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/raster/brush_engine.hpp"
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace QuantumCanvas::Raster;
+
+namespace {
+
+// A small hard brush, so each dab only touches a few pixels around its center
+BrushSettings smallBrush() {
+    BrushSettings settings;
+    settings.size = 4.0f;
+    settings.spacing = 0.25f;
+    settings.hardness = 1.0f;
+    settings.color = {1.0f, 0.0f, 0.0f, 1.0f};
+    return settings;
+}
+
+StrokePoint pointAt(float x, float y, int ms) {
+    StrokePoint point;
+    point.position = {x, y};
+    point.timestamp = std::chrono::system_clock::time_point{} + std::chrono::milliseconds(ms);
+    return point;
+}
+
+float alphaAt(const Image& image, uint32_t x, uint32_t y) {
+    return image.getPixel(x, y)[3];
+}
+
+float maxDifference(const Image& a, const Image& b) {
+    float worst = 0.0f;
+    for (uint32_t y = 0; y < a.height(); ++y) {
+        for (uint32_t x = 0; x < a.width(); ++x) {
+            Image::Pixel pa = a.getPixel(x, y);
+            Image::Pixel pb = b.getPixel(x, y);
+            for (int c = 0; c < 4; ++c) {
+                worst = std::max(worst, std::fabs(pa[c] - pb[c]));
+            }
+        }
+    }
+    return worst;
+}
+
+class BrushPredictionTest : public ::testing::Test {
+protected:
+    BrushEngine makeBrushEngine(bool prediction) {
+        BrushEngineConfig config;
+        config.enableStrokePrediction = prediction;
+        return BrushEngine(engine, config);
+    }
+
+    QuantumCanvas::Rendering::RenderingEngine engine;
+};
+
+// Straight runs of soft dabs, close enough to overlap, that cross the
+// tile corner at (256, 256)
+BrushStroke strokeAcross(const BrushSettings& settings, float y0, float y1) {
+    BrushStroke stroke;
+    stroke.settings = settings;
+    for (int i = 0; i <= 40; ++i) {
+        float t = i / 40.0f;
+        stroke.points.push_back(pointAt(200.0f + 112.0f * t, y0 + (y1 - y0) * t, i));
+    }
+    return stroke;
+}
+
+class BrushBatchTest : public ::testing::Test {
+protected:
+    BrushEngine makeBrushEngine() {
+        BrushEngineConfig config;
+        config.enableGPUAcceleration = false;
+        config.enableStrokePrediction = false;
+        return BrushEngine(engine, config);
+    }
+
+    std::vector<BrushStroke> overlappingStrokes() const {
+        BrushSettings paint = smallBrush();
+        paint.size = 24.0f;
+        paint.hardness = 0.3f;
+        paint.opacity = 0.7f;
+        BrushSettings eraser = paint;
+        eraser.blendMode = BrushBlendMode::Clear;
+        BrushSettings glaze = paint;
+        glaze.color = {0.0f, 1.0f, 0.0f, 0.8f};
+        return {strokeAcross(paint, 200.0f, 312.0f), strokeAcross(eraser, 312.0f, 200.0f),
+                strokeAcross(glaze, 256.0f, 256.0f)};
+    }
+
+    QuantumCanvas::Rendering::RenderingEngine engine;
+};
+
+} // namespace
+
+TEST_F(BrushPredictionTest, ExtrapolatesTheStrokeAheadOfTheStylus) {
+    BrushEngine brushes = makeBrushEngine(true);
+    Image canvas(128, 128);
+
+    // 10 pixels every 8 ms: the default 16 ms horizon reaches 20 pixels ahead
+    brushes.beginStroke(smallBrush());
+    for (int i = 0; i < 3; ++i) {
+        brushes.addStrokePoint(canvas, pointAt(10.0f + 10.0f * i, 64.0f, 8 * i));
+    }
+
+    const auto& predicted = brushes.getPredictedPoints();
+    ASSERT_EQ(predicted.size(), 4u);
+    EXPECT_NEAR(predicted.front().position[0], 35.0f, 1e-3f);
+    EXPECT_NEAR(predicted.back().position[0], 50.0f, 1e-3f);
+    EXPECT_NEAR(predicted.back().position[1], 64.0f, 1e-3f);
+
+    // The tail is only in the overlay; the canvas stops at the last point
+    EXPECT_GT(alphaAt(brushes.getPredictionOverlay(), 45, 64), 0.0f);
+    EXPECT_EQ(alphaAt(canvas, 45, 64), 0.0f);
+    EXPECT_GT(alphaAt(canvas, 30, 64), 0.0f);
+}
+
+TEST_F(BrushPredictionTest, RealDabsReplaceThePredictedOnes) {
+    BrushEngine brushes = makeBrushEngine(true);
+    BrushEngine unpredicted = makeBrushEngine(false);
+    Image canvas(128, 128);
+    Image reference(128, 128);
+
+    brushes.beginStroke(smallBrush());
+    unpredicted.beginStroke(smallBrush());
+    for (int i = 0; i < 5; ++i) {
+        StrokePoint point = pointAt(10.0f + 10.0f * i, 64.0f, 8 * i);
+        brushes.addStrokePoint(canvas, point);
+        unpredicted.addStrokePoint(reference, point);
+    }
+
+    // Pixels predicted after the third point are now committed in the
+    // canvas and gone from the overlay, which starts past the newest point
+    EXPECT_GT(alphaAt(canvas, 45, 64), 0.0f);
+    EXPECT_EQ(alphaAt(brushes.getPredictionOverlay(), 45, 64), 0.0f);
+    EXPECT_GT(alphaAt(brushes.getPredictionOverlay(), 60, 64), 0.0f);
+
+    // Guesses never reach the canvas
+    EXPECT_EQ(maxDifference(canvas, reference), 0.0f);
+
+    brushes.endStroke();
+    EXPECT_TRUE(brushes.getPredictedPoints().empty());
+    EXPECT_TRUE(brushes.getPredictionOverlay().empty());
+}
+
+TEST_F(BrushPredictionTest, PredictsFromTheNewestPointsOnly) {
+    BrushEngine brushes = makeBrushEngine(true);
+    Image canvas(512, 512);
+
+    // A long run to the right, then three points straight down
+    brushes.beginStroke(smallBrush());
+    int ms = 0;
+    for (int i = 0; i < 40; ++i, ms += 8) {
+        brushes.addStrokePoint(canvas, pointAt(10.0f + 10.0f * i, 20.0f, ms));
+    }
+    for (int i = 1; i <= 3; ++i, ms += 8) {
+        brushes.addStrokePoint(canvas, pointAt(400.0f, 20.0f + 10.0f * i, ms));
+    }
+
+    const auto& predicted = brushes.getPredictedPoints();
+    ASSERT_FALSE(predicted.empty());
+    for (const auto& point : predicted) {
+        EXPECT_NEAR(point.position[0], 400.0f, 1e-3f);
+        EXPECT_GT(point.position[1], 50.0f);
+    }
+}
+
+TEST_F(BrushPredictionTest, ErasingBrushesPredictNothing) {
+    BrushEngine brushes = makeBrushEngine(true);
+    Image canvas(128, 128, {0.0f, 0.0f, 1.0f, 1.0f});
+
+    BrushSettings eraser = smallBrush();
+    eraser.blendMode = BrushBlendMode::Clear;
+    brushes.beginStroke(eraser);
+    for (int i = 0; i < 3; ++i) {
+        brushes.addStrokePoint(canvas, pointAt(10.0f + 10.0f * i, 64.0f, 8 * i));
+    }
+    EXPECT_TRUE(brushes.getPredictedPoints().empty());
+    EXPECT_EQ(alphaAt(brushes.getPredictionOverlay(), 45, 64), 0.0f);
+}
+
+TEST_F(BrushBatchTest, MatchesAppliedStrokesAcrossTiles) {
+    BrushEngine batched = makeBrushEngine();
+    BrushEngine applied = makeBrushEngine();
+    Image canvas(512, 512, {0.0f, 0.0f, 1.0f, 0.5f});
+    Image reference(512, 512, {0.0f, 0.0f, 1.0f, 0.5f});
+
+    auto strokes = overlappingStrokes();
+    batched.beginBatch();
+    for (const auto& stroke : strokes) {
+        batched.addStrokeToBatch(stroke);
+        applied.applyStroke(reference, stroke);
+    }
+    EXPECT_EQ(batched.getBatchDabCount(), 3u * 41u);
+    batched.renderBatch(canvas);
+    batched.endBatch();
+
+    // Every tile around the corner was painted, erased and glazed over
+    for (uint32_t y : {250u, 262u}) {
+        for (uint32_t x : {250u, 262u}) {
+            EXPECT_NE(canvas.getPixel(x, y)[1], 0.0f);
+        }
+    }
+    EXPECT_EQ(maxDifference(canvas, reference), 0.0f);
+    EXPECT_EQ(batched.getBatchDabCount(), 0u);
+    EXPECT_EQ(batched.getStats().dabsRendered, applied.getStats().dabsRendered);
+    EXPECT_EQ(batched.getStats().pixelsProcessed, applied.getStats().pixelsProcessed);
+}
+
+TEST_F(BrushBatchTest, WetDabsGoToTheMediumLikeAppliedStrokes) {
+    BrushEngine batched = makeBrushEngine();
+    BrushEngine applied = makeBrushEngine();
+    batched.enableMediumSimulation(true);
+    applied.enableMediumSimulation(true);
+    Image canvas(512, 512, {0.0f, 0.0f, 1.0f, 0.5f});
+    Image reference(512, 512, {0.0f, 0.0f, 1.0f, 0.5f});
+
+    auto strokes = overlappingStrokes();
+    batched.beginBatch();
+    for (const auto& stroke : strokes) {
+        batched.addStrokeToBatch(stroke);
+        applied.applyStroke(reference, stroke);
+    }
+    batched.renderBatch(canvas);
+    batched.endBatch();
+
+    // Only the eraser reached the canvas; the paint is still wet
+    EXPECT_EQ(canvas.getPixel(206, 206)[0], 0.0f);
+    EXPECT_LT(canvas.getPixel(256, 256)[3], 0.5f);
+    EXPECT_EQ(maxDifference(canvas, reference), 0.0f);
+    EXPECT_EQ(batched.getStats().dabsRendered, applied.getStats().dabsRendered);
+}
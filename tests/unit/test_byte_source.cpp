@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/io/byte_source.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace QuantumCanvas::IO;
+
+namespace {
+
+// A file in the temp directory, removed when it goes out of scope
+class TempFile {
+public:
+    TempFile(const std::string& name, const std::vector<uint8_t>& contents)
+        : path_(std::filesystem::temp_directory_path() / name) {
+        std::ofstream file(path_, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+    }
+    ~TempFile() {
+        std::error_code error;
+        std::filesystem::remove(path_, error);
+    }
+    const std::filesystem::path& path() const { return path_; }
+
+private:
+    std::filesystem::path path_;
+};
+
+std::vector<uint8_t> pattern(size_t size) {
+    std::vector<uint8_t> bytes(size);
+    for (size_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<uint8_t>(i * 31 + (i >> 8));
+    }
+    return bytes;
+}
+
+} // namespace
+
+TEST(ByteSourceTest, MapsFileContents) {
+    const std::vector<uint8_t> contents = pattern(300 * 1024 + 17);
+    TempFile file("qcs_byte_source_test.bin", contents);
+
+    ByteSource source = ByteSource::open(file.path(), ByteSource::Access::Random);
+    ASSERT_EQ(source.size(), contents.size());
+#ifndef _WIN32
+    EXPECT_TRUE(source.isMapped());
+#endif
+    EXPECT_TRUE(std::equal(contents.begin(), contents.end(), source.bytes().begin()));
+
+    // Ranges are clamped to the end of the file
+    ByteSpan head = source.subspan(0, 8);
+    ASSERT_EQ(head.size(), 8u);
+    EXPECT_EQ(head[7], contents[7]);
+    EXPECT_EQ(source.subspan(contents.size() - 4).size(), 4u);
+    EXPECT_TRUE(source.subspan(contents.size()).empty());
+    EXPECT_TRUE(source.subspan(contents.size() + 100, 10).empty());
+
+    source.prefetch(4097, 70000);
+    source.prefetch(contents.size() - 1, 1000);
+    EXPECT_EQ(source.bytes()[4097], contents[4097]);
+}
+
+TEST(ByteSourceTest, EmptyAndMissingFiles) {
+    TempFile empty("qcs_byte_source_empty.bin", {});
+    ByteSource source = ByteSource::open(empty.path());
+    EXPECT_TRUE(source.empty());
+    EXPECT_FALSE(source.isMapped());
+    EXPECT_TRUE(source.subspan(0, 64).empty());
+
+    EXPECT_THROW(ByteSource::open(std::filesystem::temp_directory_path() / "qcs_byte_source_missing.bin"),
+                 std::runtime_error);
+}
+
+TEST(ByteSourceTest, MovesKeepTheBytes) {
+    std::vector<uint8_t> contents = pattern(1000);
+    const uint8_t* storage = contents.data();
+    ByteSource buffered = ByteSource::fromBuffer(std::move(contents));
+    EXPECT_FALSE(buffered.isMapped());
+    EXPECT_EQ(buffered.data(), storage);
+
+    ByteSource moved(std::move(buffered));
+    EXPECT_EQ(moved.data(), storage);
+    EXPECT_EQ(moved.size(), 1000u);
+    EXPECT_TRUE(buffered.empty());
+
+    // Assigning a mapping over a buffer releases the buffer
+    TempFile file("qcs_byte_source_move.bin", pattern(5000));
+    moved = ByteSource::open(file.path());
+    EXPECT_EQ(moved.size(), 5000u);
+    EXPECT_EQ(moved.bytes()[4999], pattern(5000)[4999]);
+}
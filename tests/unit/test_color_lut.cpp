@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/raster/color_lut.hpp"
+#include <cmath>
+#include <random>
+
+using namespace QuantumCanvas::Raster;
+
+namespace {
+
+// Smooth and strongly non-linear, like a gamma-encoded profile conversion
+std::array<float, 3> curvedTransform(const std::array<float, 3>& rgb) {
+    return {std::pow(rgb[0], 1.8f) * 0.9f + 0.1f * rgb[1],
+            std::pow(rgb[1], 2.2f),
+            rgb[2] * rgb[2] * (3.0f - 2.0f * rgb[2]) * 0.8f + 0.2f * rgb[0] * rgb[1]};
+}
+
+} // namespace
+
+TEST(ColorLUTTest, ReproducesAffineTransformsExactly) {
+    ColorLUT lut([](const std::array<float, 3>& c) {
+        return std::array<float, 3>{0.5f * c[0] + 0.25f * c[1] + 0.1f, c[2] - 0.3f * c[0], 0.2f + 0.7f * c[1]};
+    }, 17);
+    ASSERT_EQ(lut.size(), 17u);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (int i = 0; i < 1000; ++i) {
+        std::array<float, 3> c{unit(rng), unit(rng), unit(rng)};
+        auto out = lut.apply(c);
+        EXPECT_NEAR(out[0], 0.5f * c[0] + 0.25f * c[1] + 0.1f, 1e-5f);
+        EXPECT_NEAR(out[1], c[2] - 0.3f * c[0], 1e-5f);
+        EXPECT_NEAR(out[2], 0.2f + 0.7f * c[1], 1e-5f);
+    }
+
+    // Out-of-range inputs are clamped to the cube
+    auto clamped = lut.apply({-1.0f, 2.0f, 0.5f});
+    EXPECT_NEAR(clamped[0], 0.35f, 1e-5f);
+    EXPECT_NEAR(clamped[2], 0.9f, 1e-5f);
+}
+
+TEST(ColorLUTTest, ErrorShrinksWithGridSize) {
+    ColorLUT small(curvedTransform, ColorLUT::MIN_SIZE);
+    ColorLUT large(curvedTransform, ColorLUT::MAX_SIZE);
+    EXPECT_EQ(ColorLUT(curvedTransform, 200).size(), ColorLUT::MAX_SIZE);
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    float smallError = 0.0f;
+    float largeError = 0.0f;
+    for (int i = 0; i < 2000; ++i) {
+        std::array<float, 3> c{unit(rng), unit(rng), unit(rng)};
+        auto exact = curvedTransform(c);
+        auto a = small.apply(c);
+        auto b = large.apply(c);
+        for (int k = 0; k < 3; ++k) {
+            smallError = std::max(smallError, std::abs(a[k] - exact[k]));
+            largeError = std::max(largeError, std::abs(b[k] - exact[k]));
+        }
+    }
+    EXPECT_LT(smallError, 0.01f);
+    EXPECT_LT(largeError, smallError * 0.25f);
+}
+
+TEST(ColorLUTTest, VectorKernelsMatchScalar) {
+    ColorLUT lut(curvedTransform, 33);
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(-0.1f, 1.1f);
+    const size_t count = 1003;
+    std::vector<float> r(count), g(count), b(count);
+    for (size_t i = 0; i < count; ++i) {
+        r[i] = dist(rng);
+        g[i] = dist(rng);
+        b[i] = dist(rng);
+    }
+    // Grid points and ties between fractions
+    r[0] = g[0] = b[0] = 0.5f;
+    r[1] = 1.0f; g[1] = 0.0f; b[1] = 1.0f;
+    r[2] = 0.25f; g[2] = 0.25f; b[2] = 0.7f;
+
+    std::vector<float> sr = r, sg = g, sb = b;
+    lut.apply(CpuBlend::Isa::Scalar, sr.data(), sg.data(), sb.data(), count);
+    for (size_t i = 0; i < count; ++i) {
+        auto expected = lut.apply({r[i], g[i], b[i]});
+        ASSERT_EQ(sr[i], expected[0]);
+        ASSERT_EQ(sg[i], expected[1]);
+        ASSERT_EQ(sb[i], expected[2]);
+    }
+
+    for (CpuBlend::Isa isa : {CpuBlend::Isa::AVX2, CpuBlend::Isa::AVX512, CpuBlend::Isa::NEON}) {
+        if (!CpuBlend::isIsaAvailable(isa)) {
+            continue;
+        }
+        std::vector<float> vr = r, vg = g, vb = b;
+        lut.apply(isa, vr.data(), vg.data(), vb.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            EXPECT_NEAR(vr[i], sr[i], 1e-5f) << CpuBlend::isaName(isa) << " pixel " << i;
+            EXPECT_NEAR(vg[i], sg[i], 1e-5f) << CpuBlend::isaName(isa) << " pixel " << i;
+            EXPECT_NEAR(vb[i], sb[i], 1e-5f) << CpuBlend::isaName(isa) << " pixel " << i;
+        }
+    }
+}
+
+TEST(ColorLUTTest, ImagesKeepAlphaAndUntouchedTiles) {
+    ColorLUT lut(curvedTransform, 33);
+
+    // A black fill maps onto itself, so unpainted tiles stay unallocated
+    Image image(600, 300, {0.0f, 0.0f, 0.0f, 1.0f});
+    image.setPixel(10, 20, {0.2f, 0.6f, 0.9f, 0.5f});
+    image.setPixel(599, 299, {1.0f, 0.5f, 0.25f, 1.0f});
+    ASSERT_EQ(image.allocatedTileCount(), 2u);
+
+    lut.applyToImage(image);
+    EXPECT_EQ(image.allocatedTileCount(), 2u);
+
+    auto expected = lut.apply({0.2f, 0.6f, 0.9f});
+    Image::Pixel p = image.getPixel(10, 20);
+    EXPECT_FLOAT_EQ(p[0], expected[0]);
+    EXPECT_FLOAT_EQ(p[1], expected[1]);
+    EXPECT_FLOAT_EQ(p[2], expected[2]);
+    EXPECT_FLOAT_EQ(p[3], 0.5f);
+
+    expected = lut.apply({1.0f, 0.5f, 0.25f});
+    p = image.getPixel(599, 299);
+    EXPECT_NEAR(p[0], expected[0], 1e-5f);
+    EXPECT_NEAR(p[2], expected[2], 1e-5f);
+    EXPECT_EQ(image.getPixel(300, 100), (Image::Pixel{0.0f, 0.0f, 0.0f, 1.0f}));
+
+    // A fill the transform changes has to be converted everywhere
+    Image grey(300, 300, {0.5f, 0.5f, 0.5f, 1.0f});
+    lut.applyToImage(grey);
+    EXPECT_EQ(grey.allocatedTileCount(), grey.tileCount());
+    EXPECT_NEAR(grey.getPixel(280, 280)[1], lut.apply({0.5f, 0.5f, 0.5f})[1], 1e-6f);
+}
@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/io/dxf_stream_reader.hpp"
+#include "../../src/core/kernel/task_scheduler.hpp"
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace QuantumCanvas::IO;
+
+namespace {
+
+// Writes DXF group code/value pairs, one per line
+class DXFWriter {
+public:
+    DXFWriter& operator()(int code, const std::string& value) {
+        text_ += std::to_string(code) + "\n" + value + "\n";
+        return *this;
+    }
+    DXFWriter& line(int handle, float x0, float y0, float x1, float y1, const std::string& layer = "0") {
+        std::ostringstream h;
+        h << std::hex << std::uppercase << handle;
+        return (*this)(0, "LINE")(5, h.str())(8, layer)(10, std::to_string(x0))(20, std::to_string(y0))
+                      (11, std::to_string(x1))(21, std::to_string(y1));
+    }
+    const std::string& str() const { return text_; }
+
+private:
+    std::string text_;
+};
+
+// Header, a layer, a text style, one block with a circle, then the given
+// entities and an OBJECTS section the reader should never reach
+std::string drawing(const std::string& entities) {
+    DXFWriter dxf;
+    dxf(999, "test drawing")
+       (0, "SECTION")(2, "HEADER")
+       (9, "$ACADVER")(1, "AC1027")
+       (9, "$INSUNITS")(70, "6")
+       (9, "$EXTMIN")(10, "-5.0")(20, "-2.0")(30, "0.0")
+       (9, "$EXTMAX")(10, "100.0")(20, "50.0")(30, "0.0")
+       (9, "$CLAYER")(8, "Walls")
+       (0, "ENDSEC")
+       (0, "SECTION")(2, "TABLES")
+       (0, "TABLE")(2, "LAYER")(70, "2")
+       (0, "LAYER")(2, "Walls")(70, "4")(62, "-3")(6, "DASHED")(370, "50")
+       (0, "LAYER")(2, "0")(70, "0")(62, "7")(6, "CONTINUOUS")
+       (0, "ENDTAB")
+       (0, "TABLE")(2, "STYLE")
+       (0, "STYLE")(2, "Notes")(3, "arial.ttf")(40, "0.0")(41, "0.8")(71, "2")
+       (0, "ENDTAB")
+       (0, "ENDSEC")
+       (0, "SECTION")(2, "BLOCKS")
+       (0, "BLOCK")(8, "0")(2, "Bolt")(70, "0")(10, "1.0")(20, "2.0")
+       (0, "CIRCLE")(8, "0")(10, "1.0")(20, "2.0")(40, "0.5")
+       (0, "ENDBLK")
+       (0, "ENDSEC")
+       (0, "SECTION")(2, "ENTITIES");
+    return dxf.str() + entities + "  0\r\nENDSEC\r\n  0\r\nSECTION\r\n  2\r\nOBJECTS\r\n  0\r\nJUNK\r\n";
+}
+
+} // namespace
+
+TEST(DXFStreamReaderTest, ParsesTablesAndEntities) {
+    DXFWriter entities;
+    entities(0, "ARC")(5, "2A")(8, "Walls")(62, "1")(10, "0.0")(20, "0.0")(40, "3.0")(50, "90.0")(51, "180.0")
+            (0, "LWPOLYLINE")(5, "2B")(8, "0")(90, "3")(70, "1")(43, "0.25")
+                (10, "0.0")(20, "0.0")(42, "1.0")(10, "4.0")(20, "0.0")(10, "4.0")(20, "3.0")
+            (0, "POLYLINE")(5, "2C")(8, "0")(66, "1")(10, "0.0")(20, "0.0")
+            (0, "VERTEX")(8, "0")(10, "1.0")(20, "1.0")
+            (0, "VERTEX")(8, "0")(10, "2.0")(20, "3.0")(42, "0.5")
+            (0, "SEQEND")(8, "0")
+            (0, "MTEXT")(5, "2D")(8, "0")(10, "7.0")(20, "8.0")(40, "2.5")(3, "Hello, ")(1, "world")
+            (0, "INSERT")(5, "2E")(8, "0")(66, "1")(2, "Bolt")(10, "10.0")(20, "20.0")(41, "2.0")(42, "2.0")
+                (50, "90.0")(70, "3")(44, "5.0")
+            (0, "ATTRIB")(8, "0")(1, "M8")(2, "SIZE")
+            (0, "SEQEND")(8, "0")
+            (0, "3DFACE")(8, "0")(10, "0.0")(20, "0.0")
+            (0, "LINE")(5, "2F")(8, "0")(67, "1")(10, "0.0")(20, "0.0")(11, "1.0")(21, "1.0");
+
+    std::istringstream input(drawing(entities.str()));
+    DXFStreamReader reader;
+    bool tablesSeen = false;
+    std::vector<std::unique_ptr<DWGEntity>> parsed;
+    std::vector<DWGInsert> inserts;
+    const auto result = reader.read(input,
+        [&](const DWGDrawingTables& tables) {
+            tablesSeen = true;
+            EXPECT_TRUE(parsed.empty());
+            EXPECT_EQ(tables.info.version, "AC1027");
+            EXPECT_EQ(tables.info.units, DWGUnits::Meters);
+            EXPECT_FLOAT_EQ(tables.info.extMin[0], -5.0f);
+            EXPECT_FLOAT_EQ(tables.info.extMax[1], 50.0f);
+            EXPECT_EQ(tables.info.currentLayer, "Walls");
+        },
+        [&](DWGEntityBatch&& batch) {
+            for (auto& entity : batch.entities) parsed.push_back(std::move(entity));
+            for (auto& insert : batch.inserts) inserts.push_back(std::move(insert));
+            return true;
+        },
+        {});
+
+    EXPECT_TRUE(tablesSeen);
+    EXPECT_FALSE(result.cancelled);
+    EXPECT_EQ(result.skippedEntityCount, 1u);  // The 3DFACE; the paper space line is filtered
+
+    const DWGDrawingTables& tables = reader.getTables();
+    ASSERT_EQ(tables.layers.size(), 2u);
+    EXPECT_EQ(tables.layers[0].name, "Walls");
+    EXPECT_FALSE(tables.layers[0].visible);
+    EXPECT_TRUE(tables.layers[0].locked);
+    EXPECT_EQ(tables.layers[0].colorIndex, 3);
+    EXPECT_EQ(tables.layers[0].linetype, "DASHED");
+    EXPECT_FLOAT_EQ(tables.layers[0].lineweight, 0.5f);
+    ASSERT_EQ(tables.textStyles.size(), 1u);
+    EXPECT_EQ(tables.textStyles[0].fontName, "arial.ttf");
+    EXPECT_TRUE(tables.textStyles[0].backwards);
+
+    ASSERT_EQ(tables.blocks.size(), 1u);
+    EXPECT_EQ(tables.blocks[0].name, "Bolt");
+    EXPECT_FLOAT_EQ(tables.blocks[0].basePoint[1], 2.0f);
+    ASSERT_EQ(tables.blocks[0].entityIds.size(), 1u);
+    ASSERT_EQ(tables.blockEntities.size(), 1u);
+    EXPECT_EQ(tables.blockEntities[0]->id, tables.blocks[0].entityIds[0]);
+    EXPECT_EQ(tables.blockEntities[0]->type, DWGEntityType::Circle);
+
+    ASSERT_EQ(parsed.size(), 4u);
+    const auto& arc = static_cast<const DWGArc&>(*parsed[0]);
+    EXPECT_EQ(arc.type, DWGEntityType::Arc);
+    EXPECT_EQ(arc.id, 0x2Au);
+    EXPECT_EQ(arc.layer, "Walls");
+    EXPECT_EQ(arc.colorIndex, 1);
+    EXPECT_NEAR(arc.startAngle, 3.14159265f / 2.0f, 1e-6f);
+    EXPECT_NEAR(arc.endAngle, 3.14159265f, 1e-6f);
+
+    const auto& light = static_cast<const DWGPolyline&>(*parsed[1]);
+    EXPECT_EQ(light.type, DWGEntityType::LWPolyline);
+    EXPECT_TRUE(light.closed);
+    EXPECT_FLOAT_EQ(light.constantWidth, 0.25f);
+    ASSERT_EQ(light.vertices.size(), 3u);
+    EXPECT_FLOAT_EQ(light.vertices[0].bulge, 1.0f);
+    EXPECT_FLOAT_EQ(light.vertices[2].position[1], 3.0f);
+
+    const auto& heavy = static_cast<const DWGPolyline&>(*parsed[2]);
+    EXPECT_EQ(heavy.type, DWGEntityType::Polyline);
+    ASSERT_EQ(heavy.vertices.size(), 2u);
+    EXPECT_FLOAT_EQ(heavy.vertices[1].position[0], 2.0f);
+    EXPECT_FLOAT_EQ(heavy.vertices[1].bulge, 0.5f);
+
+    const auto& text = static_cast<const DWGText&>(*parsed[3]);
+    EXPECT_EQ(text.type, DWGEntityType::MText);
+    EXPECT_EQ(text.content, "Hello, world");
+
+    ASSERT_EQ(inserts.size(), 1u);
+    EXPECT_EQ(inserts[0].blockName, "Bolt");
+    EXPECT_FLOAT_EQ(inserts[0].scale[0], 2.0f);
+    EXPECT_NEAR(inserts[0].rotation, 3.14159265f / 2.0f, 1e-6f);
+    EXPECT_EQ(inserts[0].columnCount, 3u);
+    EXPECT_EQ(inserts[0].attributeValues.at("SIZE"), "M8");
+    EXPECT_EQ(result.entityCount, 5u);
+}
+
+TEST(DXFStreamReaderTest, ChunksArriveInFileOrder) {
+    constexpr int LINE_COUNT = 5000;
+    DXFWriter entities;
+    for (int i = 0; i < LINE_COUNT; ++i) {
+        entities.line(i + 1, static_cast<float>(i), 0.0f, static_cast<float>(i), 1.0f);
+    }
+    const std::string text = drawing(entities.str());
+
+    auto scheduler = std::make_shared<QuantumCanvas::Core::TaskScheduler>(4);
+    ASSERT_TRUE(scheduler->initialize());
+    DXFStreamReader reader(scheduler);
+
+    DXFStreamReader::Options options;
+    options.firstChunkSize = 512;
+    options.chunkSize = 4096;
+    options.readSize = 4096;  // Chunks straddle reads
+    std::vector<float> progress;
+    options.progressCallback = [&progress](float value) {
+        progress.push_back(value);
+        return true;
+    };
+
+    std::istringstream input(text);
+    size_t expectedSequence = 0;
+    uint32_t expectedId = 1;
+    uint64_t lastBytes = 0;
+    const auto result = reader.read(input, nullptr,
+        [&](DWGEntityBatch&& batch) {
+            EXPECT_EQ(batch.sequence, expectedSequence++);
+            EXPECT_GT(batch.bytesParsed, lastBytes);
+            lastBytes = batch.bytesParsed;
+            for (const auto& entity : batch.entities) {
+                EXPECT_EQ(entity->id, expectedId++);
+            }
+            return true;
+        },
+        options);
+
+    EXPECT_EQ(expectedId, static_cast<uint32_t>(LINE_COUNT + 1));
+    EXPECT_GT(result.batchCount, 50u);
+    EXPECT_EQ(result.entityCount, static_cast<size_t>(LINE_COUNT));
+    EXPECT_LT(result.bytesRead, text.size());  // OBJECTS is never read
+    EXPECT_TRUE(progress.empty());  // Stream size unknown
+
+    // Stopping from the callback ends the read early
+    std::istringstream again(text);
+    size_t delivered = 0;
+    const auto stopped = reader.read(again, nullptr,
+        [&delivered](DWGEntityBatch&&) { return ++delivered < 3; }, options);
+    EXPECT_TRUE(stopped.cancelled);
+    EXPECT_EQ(delivered, 3u);
+    EXPECT_EQ(stopped.batchCount, 3u);
+
+    scheduler->shutdown();
+}
+
+TEST(DXFStreamReaderTest, RejectsBinaryInput) {
+    std::istringstream dwg(std::string("AC1032\0\0\0\0\0\0", 12));
+    DXFStreamReader reader;
+    auto ignore = [](DWGEntityBatch&&) { return true; };
+    EXPECT_THROW(reader.read(dwg, nullptr, ignore, {}), std::runtime_error);
+
+    std::istringstream binary(std::string("AutoCAD Binary DXF\r\n\x1a\0", 22));
+    EXPECT_THROW(reader.read(binary, nullptr, ignore, {}), std::runtime_error);
+
+    const std::string ascii = "  0\r\nSECTION\r\n";
+    EXPECT_TRUE(DXFStreamReader::isASCIIDXF(std::vector<uint8_t>(ascii.begin(), ascii.end())));
+    const std::string dwgHead = "AC1027";
+    EXPECT_FALSE(DXFStreamReader::isASCIIDXF(std::vector<uint8_t>(dwgHead.begin(), dwgHead.end())));
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/raster/edge_detection.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace QuantumCanvas::Raster;
+
+namespace {
+
+float grey(const Image& image, uint32_t x, uint32_t y) {
+    Image::Pixel p = image.getPixel(x, y);
+    return (p[0] + p[1] + p[2]) / 3.0f;
+}
+
+// Per-pixel Sobel through the accessors, as the filter used to compute it
+Image referenceSobel(const Image& input) {
+    const int kx[3][3] = {{-1, 0, 1}, {-2, 0, 2}, {-1, 0, 1}};
+    const int ky[3][3] = {{-1, -2, -1}, {0, 0, 0}, {1, 2, 1}};
+
+    Image output;
+    output.reset(input.width(), input.height(), {0.0f, 0.0f, 0.0f, 1.0f});
+    for (uint32_t y = 1; y + 1 < input.height(); ++y) {
+        for (uint32_t x = 1; x + 1 < input.width(); ++x) {
+            float gx = 0.0f;
+            float gy = 0.0f;
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    float g = grey(input, x + dx, y + dy);
+                    gx += g * kx[dy + 1][dx + 1];
+                    gy += g * ky[dy + 1][dx + 1];
+                }
+            }
+            float m = std::min(std::sqrt(gx * gx + gy * gy), 1.0f);
+            output.setPixel(x, y, {m, m, m, 1.0f});
+        }
+    }
+    return output;
+}
+
+} // namespace
+
+TEST(EdgeDetectionTest, SobelMatchesReference) {
+    Image input(300, 900, {0.5f, 0.5f, 0.5f, 1.0f});
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (uint32_t y = 600; y < 640; ++y) {
+        for (uint32_t x = 0; x < 300; ++x) {
+            input.setPixel(x, y, {unit(rng), unit(rng), unit(rng), 1.0f});
+        }
+    }
+
+    Image output;
+    Edges::sobel(input, output);
+    Image reference = referenceSobel(input);
+
+    float worst = 0.0f;
+    for (uint32_t y = 0; y < input.height(); ++y) {
+        for (uint32_t x = 0; x < input.width(); ++x) {
+            worst = std::max(worst, std::fabs(output.getPixel(x, y)[0] - reference.getPixel(x, y)[0]));
+        }
+    }
+    EXPECT_LT(worst, 1e-5f);
+    EXPECT_FALSE(output.isTileAllocated(0, 0));
+}
+
+TEST(EdgeDetectionTest, CannyTracesThinEdges) {
+    // A vertical step that crosses a band border
+    Image input(200, 600, {0.0f, 0.0f, 0.0f, 1.0f});
+    for (uint32_t y = 0; y < 600; ++y) {
+        for (uint32_t x = 100; x < 200; ++x) {
+            input.setPixel(x, y, {1.0f, 1.0f, 1.0f, 1.0f});
+        }
+    }
+
+    Image output;
+    Edges::canny(input, output, 0.2f, 0.4f);
+
+    for (uint32_t y : {10u, 255u, 256u, 400u}) {
+        int edges = 0;
+        for (uint32_t x = 1; x + 1 < 200; ++x) {
+            edges += output.getPixel(x, y)[0] > 0.5f ? 1 : 0;
+        }
+        EXPECT_EQ(edges, 1) << "row " << y;
+    }
+}
+
+TEST(EdgeDetectionTest, CannyHysteresisKeepsConnectedWeakEdges) {
+    // A step that fades out to the left; its faint end is only an edge
+    // through its connection to the strong one
+    Image input(400, 300, {0.0f, 0.0f, 0.0f, 1.0f});
+    for (uint32_t y = 150; y < 300; ++y) {
+        for (uint32_t x = 0; x < 400; ++x) {
+            float level = 0.1f + 0.9f * x / 399.0f;
+            input.setPixel(x, y, {level, level, level, 1.0f});
+        }
+    }
+
+    Image connected;
+    Edges::canny(input, connected, 0.1f, 1.0f);
+    EXPECT_GT(connected.getPixel(5, 149)[0] + connected.getPixel(5, 150)[0], 0.5f);
+    EXPECT_GT(connected.getPixel(300, 149)[0] + connected.getPixel(300, 150)[0], 0.5f);
+
+    // Without a strong edge nothing survives
+    Image faint(400, 300, {0.0f, 0.0f, 0.0f, 1.0f});
+    for (uint32_t y = 150; y < 300; ++y) {
+        for (uint32_t x = 0; x < 400; ++x) {
+            faint.setPixel(x, y, {0.1f, 0.1f, 0.1f, 1.0f});
+        }
+    }
+    Image none;
+    Edges::canny(faint, none, 0.1f, 1.0f);
+    EXPECT_EQ(none.allocatedTileCount(), 0u);
+}
@@ -0,0 +1,270 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/vector/fill_tessellation.hpp"
+#include <cmath>
+#include <functional>
+#include <vector>
+
+using namespace QuantumCanvas::Vector;
+
+namespace {
+
+constexpr float PI = 3.14159265358979f;
+
+struct Mesh {
+    std::vector<VectorVertex> vertices;
+    std::vector<uint32_t> indices;
+};
+
+Mesh triangulate(const FillCurveBuilder& builder, size_t path = 0) {
+    const auto& range = builder.paths()[path];
+    Mesh mesh;
+    triangulate_fill(builder.curves().data() + range.firstCurve, range.curveCount, mesh.vertices, mesh.indices);
+    return mesh;
+}
+
+void addPolygon(FillCurveBuilder& builder, const std::vector<FillCurveBuilder::Point>& points) {
+    builder.move_to(points[0]);
+    for (size_t i = 1; i < points.size(); ++i) {
+        builder.line_to(points[i]);
+    }
+    builder.close_path();
+}
+
+float triangleArea(const VectorVertex& a, const VectorVertex& b, const VectorVertex& c) {
+    return 0.5f * ((b.position[0] - a.position[0]) * (c.position[1] - a.position[1]) -
+                   (c.position[0] - a.position[0]) * (b.position[1] - a.position[1]));
+}
+
+float meshArea(const Mesh& mesh) {
+    float area = 0.0f;
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        area += std::abs(triangleArea(mesh.vertices[mesh.indices[i]], mesh.vertices[mesh.indices[i + 1]],
+                                      mesh.vertices[mesh.indices[i + 2]]));
+    }
+    return area;
+}
+
+bool contains(const VectorVertex& a, const VectorVertex& b, const VectorVertex& c, float x, float y) {
+    VectorVertex p;
+    p.position = {x, y};
+    float d0 = triangleArea(a, b, p);
+    float d1 = triangleArea(b, c, p);
+    float d2 = triangleArea(c, a, p);
+    return (d0 >= 0 && d1 >= 0 && d2 >= 0) || (d0 <= 0 && d1 <= 0 && d2 <= 0);
+}
+
+// Samples a grid off the edges' coordinates: every sample must be covered
+// by exactly one triangle inside the fill and by none outside
+void expectCoversExactly(const Mesh& mesh, const std::function<bool(float, float)>& inside, float extent) {
+    for (float y = 0.37f; y < extent; y += 1.13f) {
+        for (float x = 0.29f; x < extent; x += 1.07f) {
+            int covering = 0;
+            for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+                covering += contains(mesh.vertices[mesh.indices[i]], mesh.vertices[mesh.indices[i + 1]],
+                                     mesh.vertices[mesh.indices[i + 2]], x, y);
+            }
+            ASSERT_EQ(covering, inside(x, y) ? 1 : 0) << "at " << x << ", " << y;
+        }
+    }
+}
+
+} // namespace
+
+TEST(FillTessellationTest, WangsFormulaBoundsTheFlatteningError) {
+    // Straight cubics need one chord
+    FillCurve line{{0, 0}, {10, 0}, {20, 0}, {30, 0}, {0, 0}, 0, 0};
+    EXPECT_EQ(flattened_segment_count(line, 0.25f), 1u);
+
+    // Second differences of 100 * sqrt(2): ceil(sqrt(0.75 * 141.42 / tolerance))
+    FillCurve arch{{0, 0}, {0, 100}, {100, 100}, {100, 0}, {0, 0}, 0, 0};
+    EXPECT_EQ(flattened_segment_count(arch, 0.25f), 21u);
+    EXPECT_EQ(flattened_segment_count(arch, 1.0f), 11u);
+    EXPECT_EQ(flattened_segment_count(arch, 1e-9f), GPUTessellator::MAX_SEGMENTS_PER_CURVE);
+
+    // Every chord's midpoint stays within the tolerance of the curve
+    const uint32_t n = flattened_segment_count(arch, 0.25f);
+    auto at = [&](float t) {
+        float mt = 1.0f - t;
+        return std::array<float, 2>{3 * mt * t * t * 100 + t * t * t * 100, 3 * mt * mt * t * 100 + 3 * mt * t * t * 100};
+    };
+    for (uint32_t i = 0; i < n; ++i) {
+        auto a = at(float(i) / n);
+        auto b = at(float(i + 1) / n);
+        auto m = at((i + 0.5f) / n);
+        float error = std::hypot(m[0] - 0.5f * (a[0] + b[0]), m[1] - 0.5f * (a[1] + b[1]));
+        EXPECT_LE(error, 0.25f);
+    }
+}
+
+TEST(FillTessellationTest, BuilderRecordsPathsSegmentsAndBounds) {
+    FillCurveBuilder builder(0.25f);
+    builder.begin_path();
+    addPolygon(builder, {{10, 10}, {30, 10}, {30, 20}});
+    builder.end_path();
+    builder.begin_path();
+    builder.move_to({0, 0});
+    builder.quad_to({50, 80}, {100, 0});
+    builder.end_path();
+    builder.begin_path();
+    builder.end_path();
+
+    const auto& paths = builder.paths();
+    ASSERT_EQ(paths.size(), 3u);
+    EXPECT_EQ(paths[0].curveCount, 2u);  // The closing edge adds no curve
+    EXPECT_EQ(paths[0].segmentCount, 2u);
+    EXPECT_EQ(paths[0].bounds, (std::array<float, 4>{10, 10, 30, 20}));
+    EXPECT_EQ(paths[1].firstCurve, 2u);
+    EXPECT_EQ(paths[1].firstSegment, 2u);
+    EXPECT_GT(paths[1].segmentCount, 1u);
+    EXPECT_EQ(paths[2].curveCount, 0u);
+    EXPECT_EQ(builder.segment_count(), paths[1].firstSegment + paths[1].segmentCount);
+
+    // Quadratics are degree-raised exactly: the cubic's controls are 2/3 of
+    // the way to the quadratic's
+    const FillCurve& quad = builder.curves()[2];
+    EXPECT_NEAR(quad.p1[0], 100.0f / 3.0f, 1e-4f);
+    EXPECT_NEAR(quad.p1[1], 160.0f / 3.0f, 1e-4f);
+    EXPECT_NEAR(quad.p2[0], 200.0f / 3.0f, 1e-4f);
+    for (const FillCurve& curve : builder.curves()) {
+        EXPECT_EQ(curve.anchor, curve.firstSegment < 2 ? (std::array<float, 2>{10, 10}) : (std::array<float, 2>{0, 0}));
+    }
+}
+
+TEST(FillTessellationTest, ArcsBecomeQuarterTurnCubicsOnTheEllipse) {
+    // A half circle of radius 50 around (50, 0)
+    FillCurveBuilder builder(0.01f);
+    builder.begin_path();
+    builder.move_to({100, 0});
+    builder.arc_to({0, 0}, 50, 50, 0, false, true);
+    builder.end_path();
+
+    const auto& curves = builder.curves();
+    ASSERT_EQ(curves.size(), 2u);
+    EXPECT_EQ(curves.back().p3, (std::array<float, 2>{0, 0}));
+    for (const FillCurve& curve : curves) {
+        for (float t : {0.0f, 0.25f, 0.5f, 0.75f, 1.0f}) {
+            float mt = 1.0f - t;
+            float x = mt * mt * mt * curve.p0[0] + 3 * mt * mt * t * curve.p1[0] + 3 * mt * t * t * curve.p2[0] +
+                      t * t * t * curve.p3[0];
+            float y = mt * mt * mt * curve.p0[1] + 3 * mt * mt * t * curve.p1[1] + 3 * mt * t * t * curve.p2[1] +
+                      t * t * t * curve.p3[1];
+            EXPECT_NEAR(std::hypot(x - 50.0f, y), 50.0f, 0.02f);
+            EXPECT_GE(y, -1e-3f);  // Sweeping positive turns through +y
+        }
+    }
+
+    // Radii too small to reach the end grow to a half turn
+    FillCurveBuilder small(0.01f);
+    small.begin_path();
+    small.move_to({100, 0});
+    small.arc_to({0, 0}, 10, 10, 0, false, true);
+    small.end_path();
+    EXPECT_EQ(small.curves().size(), 2u);
+    EXPECT_NEAR(small.curves()[0].p3[0], 50.0f, 1e-3f);
+    EXPECT_NEAR(small.curves()[0].p3[1], 50.0f, 1e-3f);
+}
+
+TEST(FillTessellationTest, DetectsConvexPaths) {
+    auto convex = [](const std::function<void(FillCurveBuilder&)>& add) {
+        FillCurveBuilder builder(0.25f);
+        builder.begin_path();
+        add(builder);
+        builder.end_path();
+        return builder.paths()[0].convex;
+    };
+
+    EXPECT_TRUE(convex([](FillCurveBuilder& b) { addPolygon(b, {{0, 0}, {10, 0}, {10, 10}, {0, 10}}); }));
+    EXPECT_TRUE(convex([](FillCurveBuilder& b) {
+        b.move_to({100, 50});
+        b.arc_to({0, 50}, 50, 50, 0, false, true);
+        b.arc_to({100, 50}, 50, 50, 0, false, true);
+    }));
+    EXPECT_FALSE(convex([](FillCurveBuilder& b) { addPolygon(b, {{0, 0}, {20, 0}, {20, 10}, {10, 10}, {10, 20}, {0, 20}}); }));
+    EXPECT_FALSE(convex([](FillCurveBuilder& b) {
+        addPolygon(b, {{0, 0}, {10, 0}, {10, 10}});
+        addPolygon(b, {{20, 0}, {30, 0}, {30, 10}});
+    }));
+    // Turns one way throughout but winds twice
+    EXPECT_FALSE(convex([](FillCurveBuilder& b) {
+        std::vector<FillCurveBuilder::Point> star;
+        for (int i = 0; i < 5; ++i) {
+            star.push_back({50 + 40 * std::cos(i * 4 * PI / 5), 50 + 40 * std::sin(i * 4 * PI / 5)});
+        }
+        addPolygon(b, star);
+    }));
+}
+
+TEST(FillTessellationTest, FansOfConvexPathsCoverTheirArea) {
+    FillCurveBuilder builder(0.05f);
+    builder.begin_path();
+    builder.move_to({100, 50});
+    builder.arc_to({0, 50}, 50, 50, 0, false, true);
+    builder.arc_to({100, 50}, 50, 50, 0, false, true);
+    builder.end_path();
+
+    Mesh fan;
+    build_fan_vertices(builder.curves().data(), builder.curves().size(), fan.vertices);
+    ASSERT_EQ(fan.vertices.size(), size_t(builder.segment_count()) * 3);
+    for (uint32_t i = 0; i < fan.vertices.size(); ++i) {
+        fan.indices.push_back(i);
+    }
+    EXPECT_NEAR(meshArea(fan), PI * 50 * 50, PI * 50 * 50 * 0.005f);
+    EXPECT_NEAR(meshArea(fan), meshArea(triangulate(builder)), 1.0f);
+}
+
+TEST(FillTessellationTest, TriangulatesConcaveShapesAndHoles) {
+    // An L
+    FillCurveBuilder l(0.25f);
+    l.begin_path();
+    addPolygon(l, {{0, 0}, {20, 0}, {20, 10}, {10, 10}, {10, 20}, {0, 20}});
+    l.end_path();
+    Mesh mesh = triangulate(l);
+    EXPECT_NEAR(meshArea(mesh), 300.0f, 1e-2f);
+    expectCoversExactly(mesh, [](float x, float y) { return x < 20 && y < 20 && (x < 10 || y < 10); }, 22.0f);
+
+    // A square with a hole wound the other way
+    FillCurveBuilder ring(0.25f);
+    ring.begin_path();
+    addPolygon(ring, {{0, 0}, {30, 0}, {30, 30}, {0, 30}});
+    addPolygon(ring, {{10, 10}, {10, 20}, {20, 20}, {20, 10}});
+    ring.end_path();
+    mesh = triangulate(ring);
+    EXPECT_NEAR(meshArea(mesh), 800.0f, 1e-2f);
+    expectCoversExactly(mesh, [](float x, float y) {
+        return x < 30 && y < 30 && !(x > 10 && x < 20 && y > 10 && y < 20);
+    }, 32.0f);
+
+    // Wound the same way, non-zero fills it
+    FillCurveBuilder filled(0.25f);
+    filled.begin_path();
+    addPolygon(filled, {{0, 0}, {30, 0}, {30, 30}, {0, 30}});
+    addPolygon(filled, {{10, 10}, {20, 10}, {20, 20}, {10, 20}});
+    filled.end_path();
+    EXPECT_NEAR(meshArea(triangulate(filled)), 900.0f, 1e-2f);
+}
+
+TEST(FillTessellationTest, TriangulatesSelfIntersectingOutlines) {
+    // A bow tie crossing at (10, 10)
+    FillCurveBuilder bowTie(0.25f);
+    bowTie.begin_path();
+    addPolygon(bowTie, {{0, 0}, {20, 20}, {20, 0}, {0, 20}});
+    bowTie.end_path();
+    Mesh mesh = triangulate(bowTie);
+    EXPECT_NEAR(meshArea(mesh), 200.0f, 1e-2f);
+    expectCoversExactly(mesh, [](float x, float y) {
+        return x < 20 && y < 20 && ((x < 10) ? (y > x && y < 20 - x) : (y < x && y > 20 - x));
+    }, 22.0f);
+
+    // A pentagram: non-zero fills the middle too
+    FillCurveBuilder star(0.25f);
+    star.begin_path();
+    std::vector<FillCurveBuilder::Point> points;
+    for (int i = 0; i < 5; ++i) {
+        points.push_back({50 + 40 * std::sin(i * 4 * PI / 5), 50 - 40 * std::cos(i * 4 * PI / 5)});
+    }
+    addPolygon(star, points);
+    star.end_path();
+    // Pentagram area for circumradius R: 10 R^2 tan(pi/10) / (3 - tan^2(pi/10))
+    const float t = std::tan(PI / 10);
+    EXPECT_NEAR(meshArea(triangulate(star)), 10 * 1600 * t / (3 - t * t), 0.5f);
+}
@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/io/filter_batch.hpp"
+#include "../../src/core/kernel/kernel_manager.hpp"
+#include "../../src/core/kernel/task_scheduler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace QuantumCanvas::IO;
+using QuantumCanvas::Core::KernelManager;
+using QuantumCanvas::Core::TaskScheduler;
+using QuantumCanvas::Raster::FilterProcessor;
+
+namespace {
+
+// Decodes an input file's text through an in-memory table and encodes an
+// image as its size. Tracks how many jobs sit between decode and encode at once.
+class FakeCodec final : public IImageCodec {
+public:
+    FileFormat getFormat() const override { return FileFormat::PNG; }
+    std::string getCodecName() const override { return "fake"; }
+    std::string getCodecVersion() const override { return "1"; }
+
+    bool canEncode() const override { return true; }
+    bool canDecode() const override { return true; }
+    bool supportsLosslessCompression() const override { return true; }
+    bool supportsLossyCompression() const override { return false; }
+    bool supportsTransparency() const override { return true; }
+
+    std::vector<uint8_t> getSupportedBitDepths() const override { return {8}; }
+    std::vector<uint8_t> getSupportedChannelCounts() const override { return {4}; }
+
+    bool canDecodeFile(const std::filesystem::path&) const override { return false; }
+    bool canDecodeData(ByteSpan data) const override { return images.count(key(data)) > 0; }
+
+    std::shared_ptr<Image> decode(const std::filesystem::path&, const LoadOptions& = {}) override { return nullptr; }
+    std::shared_ptr<Image> decode(ByteSpan data, const LoadOptions& = {}) override {
+        auto found = images.find(key(data));
+        if (found == images.end()) {
+            return nullptr;
+        }
+        const int open = ++inFlight;
+        int peak = peakInFlight.load();
+        while (open > peak && !peakInFlight.compare_exchange_weak(peak, open)) {
+        }
+        if (onDecode) {
+            onDecode(found->first);
+        }
+        return std::make_shared<Image>(found->second);
+    }
+
+    std::vector<uint8_t> encode(const std::shared_ptr<Image>& image, const SaveOptions& = {}) override {
+        --inFlight;
+        const std::string size = std::to_string(image->width()) + "x" + std::to_string(image->height());
+        return std::vector<uint8_t>(size.begin(), size.end());
+    }
+    bool encode(const std::shared_ptr<Image>&, const std::filesystem::path&, const SaveOptions& = {}) override {
+        return false;
+    }
+
+    size_t estimateFileSize(const std::shared_ptr<Image>&, float) const override { return 0; }
+
+    static std::string key(ByteSpan data) { return std::string(data.begin(), data.end()); }
+
+    std::map<std::string, Image> images;  // By input file contents
+    std::function<void(const std::string&)> onDecode;
+
+    std::atomic<int> inFlight{0};
+    std::atomic<int> peakInFlight{0};
+};
+
+class FilterBatchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto& kernel = KernelManager::instance();
+        if (!kernel.has_service<TaskScheduler>()) {
+            kernel.register_service(std::make_shared<TaskScheduler>(2));
+        }
+
+        directory_ = std::filesystem::temp_directory_path() / "qcs_filter_batch_test";
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+
+        processor = std::make_unique<FilterProcessor>(engine);
+        ASSERT_TRUE(processor->initialize());
+    }
+
+    void TearDown() override {
+        processor.reset();
+        std::error_code error;
+        std::filesystem::remove_all(directory_, error);
+    }
+
+    FilterBatch makeBatch() {
+        return FilterBatch(*processor, [this](const std::filesystem::path&) -> IImageCodec* { return &codec; });
+    }
+
+    // A job reading name.in, which holds the name, and writing name.out, in
+    // the test directory. One pixel differs, so the image holds a tile.
+    FilterBatchJob addJob(const std::string& name, uint32_t size = 32) {
+        FilterBatchJob job;
+        job.inputPath = (directory_ / (name + ".in")).string();
+        job.outputPath = (directory_ / (name + ".out")).string();
+        std::ofstream(job.inputPath, std::ios::binary) << name;
+        Image image(size, size, {0.25f, 0.5f, 0.75f, 1.0f});
+        image.setPixel(0, 0, {1.0f, 1.0f, 1.0f, 1.0f});
+        codec.images[name] = image;
+        return job;
+    }
+
+    static std::string readFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    QuantumCanvas::Rendering::RenderingEngine engine;
+    std::unique_ptr<FilterProcessor> processor;
+    FakeCodec codec;
+    std::filesystem::path directory_;
+};
+
+} // namespace
+
+// FilterBatch
+TEST_F(FilterBatchTest, RunsSeriallyInJobOrder) {
+    processor->setMaxConcurrency(1);
+    std::vector<FilterBatchJob> jobs;
+    for (const char* name : {"a", "b", "c"}) {
+        jobs.push_back(addJob(name));
+    }
+    jobs[1].outputSize = {8, 8};
+
+    std::vector<size_t> order;
+    FilterBatchStats stats = makeBatch().run(jobs, [&](size_t index, FilterBatchStatus status, const std::string&) {
+        EXPECT_EQ(status, FilterBatchStatus::Succeeded);
+        order.push_back(index);
+    });
+
+    // Equal inputs start in submission order; the engine writes the encoded bytes
+    EXPECT_EQ(order, (std::vector<size_t>{0, 1, 2}));
+    EXPECT_EQ(readFile(jobs[0].outputPath), "32x32");
+    EXPECT_EQ(readFile(jobs[1].outputPath), "8x8");
+    EXPECT_EQ(readFile(jobs[2].outputPath), "32x32");
+
+    EXPECT_EQ(stats.jobsSucceeded, 3u);
+    EXPECT_EQ(stats.decode.items, 3u);
+    EXPECT_EQ(stats.encode.items, 3u);
+    EXPECT_EQ(stats.peakInFlightJobs, 1u);
+}
+
+TEST_F(FilterBatchTest, KeepsJobsWithinTheMemoryBudget) {
+    // Every job outgrows a one byte budget, so each runs alone
+    processor->setMaxConcurrency(4);
+    processor->setMemoryBudget(1);
+    std::vector<FilterBatchJob> jobs;
+    for (int i = 0; i < 8; ++i) {
+        jobs.push_back(addJob("job" + std::to_string(i)));
+    }
+
+    FilterBatchStats stats = makeBatch().run(jobs);
+    EXPECT_EQ(stats.jobsSucceeded, 8u);
+    EXPECT_EQ(stats.peakInFlightJobs, 1u);
+    EXPECT_EQ(codec.peakInFlight.load(), 1);
+}
+
+TEST_F(FilterBatchTest, ReportsSkippedAndFailedJobsApart) {
+    processor->setMaxConcurrency(1);
+    std::vector<FilterBatchJob> jobs;
+    for (const char* name : {"existing", "missing", "overwritten"}) {
+        jobs.push_back(addJob(name));
+    }
+    std::filesystem::remove(jobs[1].inputPath);
+    std::ofstream(jobs[0].outputPath) << "old";
+    std::ofstream(jobs[2].outputPath) << "old";
+    jobs[2].overwriteExisting = true;
+
+    std::vector<FilterBatchStatus> statuses(jobs.size());
+    FilterBatchStats stats = makeBatch().run(jobs, [&](size_t index, FilterBatchStatus status, const std::string&) {
+        statuses[index] = status;
+    });
+
+    EXPECT_EQ(statuses, (std::vector<FilterBatchStatus>{FilterBatchStatus::Skipped, FilterBatchStatus::Failed,
+                                                        FilterBatchStatus::Succeeded}));
+    EXPECT_EQ(stats.jobsSkipped, 1u);
+    EXPECT_EQ(stats.jobsFailed, 1u);
+    EXPECT_EQ(stats.jobsSucceeded, 1u);
+    EXPECT_EQ(stats.jobsCancelled, 0u);
+    EXPECT_EQ(readFile(jobs[0].outputPath), "old");
+    EXPECT_EQ(readFile(jobs[2].outputPath), "32x32");
+}
+
+TEST_F(FilterBatchTest, CancelledJobsAreNotStarted) {
+    processor->setMaxConcurrency(1);
+    std::vector<FilterBatchJob> jobs;
+    for (const char* name : {"a", "b", "c"}) {
+        jobs.push_back(addJob(name));
+    }
+
+    // Cancelled while the first job runs, which still completes
+    std::atomic<bool> cancel{false};
+    codec.onDecode = [&](const std::string&) { cancel.store(true); };
+
+    std::vector<FilterBatchStatus> statuses(jobs.size());
+    FilterBatchStats stats = makeBatch().run(
+        jobs, [&](size_t index, FilterBatchStatus status, const std::string&) { statuses[index] = status; }, &cancel);
+
+    EXPECT_EQ(statuses, (std::vector<FilterBatchStatus>{FilterBatchStatus::Succeeded, FilterBatchStatus::Cancelled,
+                                                        FilterBatchStatus::Cancelled}));
+    EXPECT_EQ(stats.jobsSucceeded, 1u);
+    EXPECT_EQ(stats.jobsCancelled, 2u);
+    EXPECT_EQ(stats.jobsFailed, 0u);
+    EXPECT_TRUE(std::filesystem::exists(jobs[0].outputPath));
+    EXPECT_FALSE(std::filesystem::exists(jobs[1].outputPath));
+}
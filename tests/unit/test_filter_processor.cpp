@@ -0,0 +1,501 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/raster/filter_processor.hpp"
+#include "../../src/core/kernel/kernel_manager.hpp"
+#include "../../src/core/kernel/task_scheduler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <random>
+#include <thread>
+
+using namespace QuantumCanvas::Raster;
+using QuantumCanvas::Core::KernelManager;
+using QuantumCanvas::Core::TaskScheduler;
+
+namespace {
+
+// Test filters
+// Averages the pixel with the four exactly r away, clamped to the image
+// borders, so any pixel a crop gets wrong near its edge shows up
+class CrossSampleFilter final : public Filter {
+public:
+    explicit CrossSampleFilter(int radius) : Filter("CrossSample", FilterCategory::Custom), radius_(radius) {}
+
+    bool apply(const Image& input, Image& output) override {
+        const int width = static_cast<int>(input.width());
+        const int height = static_cast<int>(input.height());
+        output.reset(input.width(), input.height(), input.fillColor());
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                const Image::Pixel samples[] = {
+                    input.getPixel(x, y),
+                    input.getPixel(std::max(x - radius_, 0), y),
+                    input.getPixel(std::min(x + radius_, width - 1), y),
+                    input.getPixel(x, std::max(y - radius_, 0)),
+                    input.getPixel(x, std::min(y + radius_, height - 1)),
+                };
+                Image::Pixel sum = {0, 0, 0, 0};
+                for (const auto& sample : samples) {
+                    for (int c = 0; c < 4; ++c) {
+                        sum[c] += sample[c] * 0.2f;
+                    }
+                }
+                output.setPixel(x, y, sum);
+            }
+        }
+        return true;
+    }
+
+    bool applyGPU(QuantumCanvas::Rendering::ResourceId, QuantumCanvas::Rendering::ResourceId,
+                  const std::array<uint32_t, 2>&) override {
+        return false;
+    }
+    size_t getRequiredMemory(const std::array<uint32_t, 2>& imageSize) const override {
+        return size_t(imageSize[0]) * imageSize[1] * 4 * sizeof(float);
+    }
+    int getHaloRadius() const override { return radius_; }
+    std::unique_ptr<Filter> clone() const override { return std::make_unique<CrossSampleFilter>(radius_); }
+
+protected:
+    QuantumCanvas::Rendering::PipelineId createFilterPipeline(QuantumCanvas::Rendering::RenderingEngine&) override {
+        return 0;
+    }
+    void updateFilterUniforms(QuantumCanvas::Rendering::RenderingEngine&, QuantumCanvas::Rendering::ResourceId,
+                              uint32_t) override {}
+
+private:
+    int radius_;
+};
+
+class ScaleFilter final : public Filter {
+public:
+    ScaleFilter(float scale, float bias) : Filter("Scale", FilterCategory::Color), scale_(scale), bias_(bias) {}
+
+    bool apply(const Image& input, Image& output) override {
+        output.reset(input.width(), input.height(), applyToPixel(input.fillColor()));
+        for (uint32_t y = 0; y < input.height(); ++y) {
+            for (uint32_t x = 0; x < input.width(); ++x) {
+                output.setPixel(x, y, applyToPixel(input.getPixel(x, y)));
+            }
+        }
+        return true;
+    }
+
+    bool applyGPU(QuantumCanvas::Rendering::ResourceId, QuantumCanvas::Rendering::ResourceId,
+                  const std::array<uint32_t, 2>&) override {
+        return false;
+    }
+    size_t getRequiredMemory(const std::array<uint32_t, 2>& imageSize) const override {
+        return size_t(imageSize[0]) * imageSize[1] * 4 * sizeof(float);
+    }
+    int getHaloRadius() const override { return 0; }
+    bool isPointwise() const override { return true; }
+    Image::Pixel applyToPixel(const Image::Pixel& pixel) const override {
+        return {pixel[0] * scale_ + bias_, pixel[1] * scale_ + bias_, pixel[2] * scale_ + bias_, pixel[3]};
+    }
+    std::unique_ptr<Filter> clone() const override { return std::make_unique<ScaleFilter>(scale_, bias_); }
+
+protected:
+    QuantumCanvas::Rendering::PipelineId createFilterPipeline(QuantumCanvas::Rendering::RenderingEngine&) override {
+        return 0;
+    }
+    void updateFilterUniforms(QuantumCanvas::Rendering::RenderingEngine&, QuantumCanvas::Rendering::ResourceId,
+                              uint32_t) override {}
+
+private:
+    float scale_;
+    float bias_;
+};
+
+// Stands in for a filter with a GPU kernel; planning a chain only asks for
+// the pipeline, so it is never dispatched
+class KernelFilter final : public Filter {
+public:
+    explicit KernelFilter(const std::string& name) : Filter(name, FilterCategory::Custom) {}
+
+    bool apply(const Image& input, Image& output) override {
+        output = input;
+        return true;
+    }
+
+    bool applyGPU(QuantumCanvas::Rendering::ResourceId, QuantumCanvas::Rendering::ResourceId,
+                  const std::array<uint32_t, 2>&) override {
+        return false;
+    }
+    size_t getRequiredMemory(const std::array<uint32_t, 2>& imageSize) const override {
+        return size_t(imageSize[0]) * imageSize[1] * 4 * sizeof(float);
+    }
+    std::unique_ptr<Filter> clone() const override { return std::make_unique<KernelFilter>(name_); }
+
+protected:
+    QuantumCanvas::Rendering::PipelineId createFilterPipeline(QuantumCanvas::Rendering::RenderingEngine&) override {
+        return 1;
+    }
+    void updateFilterUniforms(QuantumCanvas::Rendering::RenderingEngine&, QuantumCanvas::Rendering::ResourceId,
+                              uint32_t) override {}
+};
+
+// Each filter on its own over the whole image, the result fusing must match
+Image applyUnfused(FilterChain& chain, const Image& input) {
+    Image current = input;
+    for (size_t i = 0; i < chain.getFilterCount(); ++i) {
+        Filter* filter = chain.getFilter(i);
+        if (!filter->isEnabled()) {
+            continue;
+        }
+        Image next;
+        EXPECT_TRUE(filter->apply(current, next));
+        current = next;
+    }
+    return current;
+}
+
+float maxDifference(const Image& a, const Image& b) {
+    EXPECT_EQ(a.getSize(), b.getSize());
+    float worst = 0.0f;
+    for (uint32_t y = 0; y < a.height(); ++y) {
+        for (uint32_t x = 0; x < a.width(); ++x) {
+            Image::Pixel pa = a.getPixel(x, y);
+            Image::Pixel pb = b.getPixel(x, y);
+            for (int c = 0; c < 4; ++c) {
+                worst = std::max(worst, std::fabs(pa[c] - pb[c]));
+            }
+        }
+    }
+    return worst;
+}
+
+// 3 x 3 tiles, the last row and column partial, with noise across the
+// borders at 256 and 512 and fill elsewhere
+Image tiledTestImage() {
+    Image image(700, 600, {0.2f, 0.4f, 0.6f, 1.0f});
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (uint32_t y = 220; y < 560; ++y) {
+        for (uint32_t x = 230; x < 540; ++x) {
+            if ((x / 7 + y / 5) % 3 != 0) {
+                image.setPixel(x, y, {unit(rng), unit(rng), unit(rng), 1.0f});
+            }
+        }
+    }
+    return image;
+}
+
+// Refines run on full-size images; the gate holds them there so a test can
+// observe the proxy or tear down while one is running
+struct Gate {
+    std::atomic<bool> open{true};
+    std::atomic<int> running{0};
+};
+
+class GatedOffsetFilter final : public Filter {
+public:
+    GatedOffsetFilter(std::shared_ptr<Gate> gate, float offset)
+        : Filter("GatedOffset", FilterCategory::Custom), gate_(std::move(gate)), offset_(offset) {}
+
+    bool apply(const Image& input, Image& output) override {
+        const bool fullSize = input.width() > 64;
+        if (fullSize) {
+            gate_->running.fetch_add(1);
+            while (!gate_->open.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        output = input;
+        for (uint32_t y = 0; y < input.height(); ++y) {
+            for (uint32_t x = 0; x < input.width(); ++x) {
+                Image::Pixel pixel = input.getPixel(x, y);
+                pixel[0] += offset_;
+                output.setPixel(x, y, pixel);
+            }
+        }
+        if (fullSize) {
+            gate_->running.fetch_sub(1);
+        }
+        return true;
+    }
+
+    bool applyGPU(QuantumCanvas::Rendering::ResourceId, QuantumCanvas::Rendering::ResourceId,
+                  const std::array<uint32_t, 2>&) override {
+        return false;
+    }
+
+    size_t getRequiredMemory(const std::array<uint32_t, 2>& imageSize) const override {
+        return size_t(imageSize[0]) * imageSize[1] * 4 * sizeof(float);
+    }
+
+    std::unique_ptr<Filter> clone() const override {
+        return std::make_unique<GatedOffsetFilter>(gate_, offset_);
+    }
+
+protected:
+    QuantumCanvas::Rendering::PipelineId createFilterPipeline(QuantumCanvas::Rendering::RenderingEngine&) override {
+        return 0;
+    }
+    void updateFilterUniforms(QuantumCanvas::Rendering::RenderingEngine&, QuantumCanvas::Rendering::ResourceId,
+                              uint32_t) override {}
+
+private:
+    std::shared_ptr<Gate> gate_;
+    float offset_;
+};
+
+FilterChain offsetChain(const std::shared_ptr<Gate>& gate, float offset) {
+    FilterChain chain;
+    chain.addFilter(std::make_unique<GatedOffsetFilter>(gate, offset));
+    return chain;
+}
+
+bool waitFor(const std::function<bool()>& condition) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// Opens the gate once the caller is blocked waiting on the refine
+std::thread openLater(const std::shared_ptr<Gate>& gate) {
+    return std::thread([gate]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        gate->open.store(true);
+    });
+}
+
+class FilterPreviewTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Refines go to the kernel's scheduler; without one they run inline
+        auto& kernel = KernelManager::instance();
+        if (!kernel.has_service<TaskScheduler>()) {
+            kernel.register_service(std::make_shared<TaskScheduler>(2));
+        }
+
+        processor = std::make_unique<FilterProcessor>(engine);
+        ASSERT_TRUE(processor->initialize());
+
+        // 256 pixels wide, so a 32 pixel preview starts on the 64 pixel level
+        source.reset(256, 256, {0.25f, 0.5f, 0.75f, 1.0f});
+        processor->beginPreview();
+        processor->setPreviewSize({32, 32});
+        processor->setPreviewSource(source);
+    }
+
+    void TearDown() override {
+        gate->open.store(true);
+        processor.reset();
+    }
+
+    QuantumCanvas::Rendering::RenderingEngine engine;
+    std::unique_ptr<FilterProcessor> processor;
+    std::shared_ptr<Gate> gate = std::make_shared<Gate>();
+    Image source;
+};
+
+} // namespace
+
+TEST_F(FilterPreviewTest, ShowsTheProxyThenTheRefinedResult) {
+    gate->open.store(false);
+    processor->updatePreviewChain(offsetChain(gate, 0.125f));
+
+    Image proxy = processor->getPreviewImage();
+    EXPECT_EQ(proxy.width(), 64u);
+    EXPECT_FLOAT_EQ(processor->getPreviewScale(), 0.25f);
+    EXPECT_FALSE(processor->isPreviewRefined());
+    EXPECT_FLOAT_EQ(proxy.getPixel(10, 10)[0], 0.375f);
+
+    gate->open.store(true);
+    ASSERT_TRUE(waitFor([&] { return processor->isPreviewRefined(); }));
+
+    Image refined = processor->getPreviewImage();
+    EXPECT_EQ(refined.getSize(), source.getSize());
+    EXPECT_FLOAT_EQ(processor->getPreviewScale(), 1.0f);
+    EXPECT_FLOAT_EQ(refined.getPixel(200, 200)[0], 0.375f);
+    EXPECT_FLOAT_EQ(refined.getPixel(200, 200)[1], 0.5f);
+}
+
+TEST_F(FilterPreviewTest, NewerUpdateDropsTheOlderRefine) {
+    gate->open.store(false);
+    processor->updatePreviewChain(offsetChain(gate, 0.125f));
+    ASSERT_TRUE(waitFor([&] { return gate->running.load() == 1; }));
+
+    // The first refine is still running when the second update lands
+    processor->updatePreviewChain(offsetChain(gate, 0.5f));
+    EXPECT_FALSE(processor->isPreviewRefined());
+    EXPECT_FLOAT_EQ(processor->getPreviewImage().getPixel(10, 10)[0], 0.75f);
+
+    gate->open.store(true);
+    ASSERT_TRUE(waitFor([&] { return processor->isPreviewRefined(); }));
+    ASSERT_TRUE(waitFor([&] { return gate->running.load() == 0; }));
+    EXPECT_FLOAT_EQ(processor->getPreviewImage().getPixel(200, 200)[0], 0.75f);
+}
+
+TEST_F(FilterPreviewTest, EndPreviewWaitsForTheRunningRefine) {
+    gate->open.store(false);
+    processor->updatePreviewChain(offsetChain(gate, 0.125f));
+    ASSERT_TRUE(waitFor([&] { return gate->running.load() == 1; }));
+
+    std::thread opener = openLater(gate);
+    processor->endPreview();
+    opener.join();
+
+    // The cancelled refine finished inside endPreview and published nothing
+    EXPECT_EQ(gate->running.load(), 0);
+    EXPECT_FALSE(processor->isPreviewActive());
+    EXPECT_TRUE(processor->getPreviewImage().empty());
+    EXPECT_FALSE(processor->isPreviewRefined());
+}
+
+TEST_F(FilterPreviewTest, DestructionWaitsForTheRunningRefine) {
+    gate->open.store(false);
+    processor->updatePreviewChain(offsetChain(gate, 0.125f));
+    ASSERT_TRUE(waitFor([&] { return gate->running.load() == 1; }));
+
+    // The refine writes into the processor, so it must be done before the memory goes
+    std::thread opener = openLater(gate);
+    processor.reset();
+    opener.join();
+    EXPECT_EQ(gate->running.load(), 0);
+}
+
+TEST(FilterChainTest, FusedTiledChainMatchesUnfusedAcrossTileBorders) {
+    FilterChain chain;
+    chain.addFilter(std::make_unique<CrossSampleFilter>(3));
+    chain.addFilter(std::make_unique<ScaleFilter>(0.5f, 0.1f));
+    chain.addFilter(std::make_unique<ScaleFilter>(1.5f, -0.05f));
+    chain.addFilter(std::make_unique<CrossSampleFilter>(40));
+    chain.addFilter(std::make_unique<ScaleFilter>(0.9f, 0.0f));
+
+    Image input = tiledTestImage();
+    Image fused;
+    ASSERT_TRUE(chain.apply(input, fused));
+    Image expected = applyUnfused(chain, input);
+
+    EXPECT_LT(maxDifference(fused, expected), 1e-5f);
+    for (uint32_t x : {255u, 256u, 511u, 512u}) {
+        for (uint32_t y : {255u, 256u, 511u, 512u}) {
+            EXPECT_NEAR(fused.getPixel(x, y)[0], expected.getPixel(x, y)[0], 1e-5f) << x << ", " << y;
+        }
+    }
+}
+
+TEST(FilterChainTest, HalosLargerThanATileMatchUnfused) {
+    Image input = tiledTestImage();
+
+    // One filter reaching past a whole tile runs untiled
+    FilterChain wide;
+    wide.addFilter(std::make_unique<CrossSampleFilter>(int(Image::TILE_SIZE) + 44));
+    wide.addFilter(std::make_unique<ScaleFilter>(0.5f, 0.25f));
+    Image fused;
+    ASSERT_TRUE(wide.apply(input, fused));
+    EXPECT_LT(maxDifference(fused, applyUnfused(wide, input)), 1e-5f);
+
+    // Halos that add up to more than a tile split into several tiled stages
+    FilterChain deep;
+    for (int radius : {90, 100, 60, 110, 30}) {
+        deep.addFilter(std::make_unique<CrossSampleFilter>(radius));
+    }
+    ASSERT_TRUE(deep.apply(input, fused));
+    EXPECT_LT(maxDifference(fused, applyUnfused(deep, input)), 1e-5f);
+}
+
+TEST(FilterChainTest, RealFiltersMatchUnfused) {
+    FilterChain chain;
+    auto blur = std::make_unique<GaussianBlurFilter>();
+    blur->setParameter("radius", 2.5f);
+    chain.addFilter(std::move(blur));
+    chain.addFilter(std::make_unique<EdgeDetectionFilter>());
+    chain.addFilter(std::make_unique<ScaleFilter>(2.0f, 0.0f));
+
+    Image input = tiledTestImage();
+    Image fused;
+    ASSERT_TRUE(chain.apply(input, fused));
+    EXPECT_LT(maxDifference(fused, applyUnfused(chain, input)), 1e-4f);
+}
+
+TEST(FilterChainTest, UniformTilesSkipTheFilters) {
+    Image input(1024, 1024, {1.0f, 0.0f, 0.0f, 1.0f});
+    input.setPixel(10, 10, {0.0f, 0.0f, 1.0f, 1.0f});
+
+    FilterChain chain;
+    chain.addFilter(std::make_unique<CrossSampleFilter>(4));
+    chain.addFilter(std::make_unique<ScaleFilter>(0.5f, 0.25f));
+
+    Image output;
+    ASSERT_TRUE(chain.apply(input, output));
+
+    // Only the tile the halo of the dot reaches is computed
+    EXPECT_TRUE(output.isTileAllocated(0, 0));
+    EXPECT_FALSE(output.isTileAllocated(1, 0));
+    EXPECT_FALSE(output.isTileAllocated(0, 1));
+    EXPECT_FALSE(output.isTileAllocated(3, 3));
+    EXPECT_EQ(output.getPixel(700, 700), (Image::Pixel{0.75f, 0.25f, 0.25f, 1.0f}));
+    EXPECT_LT(maxDifference(output, applyUnfused(chain, input)), 1e-6f);
+}
+
+TEST(FilterChainTest, OptimizeMergesConsecutiveBlurs) {
+    FilterChain chain;
+    for (float radius : {3.0f, 4.0f}) {
+        auto blur = std::make_unique<GaussianBlurFilter>();
+        blur->setParameter("radius", radius);
+        chain.addFilter(std::move(blur));
+    }
+    chain.optimize();
+
+    // Variances add: sqrt(3^2 + 4^2)
+    ASSERT_EQ(chain.getFilterCount(), 1u);
+    EXPECT_FLOAT_EQ(std::get<float>(chain.getFilter(0)->getParameter("radius")), 5.0f);
+    EXPECT_FLOAT_EQ(std::get<float>(chain.getFilter(0)->getParameter("quality")), 1.0f);
+}
+
+TEST(FilterChainTest, OptimizeKeepsBlursWithPartialOpacity) {
+    FilterChain chain;
+    for (float opacity : {1.0f, 0.5f}) {
+        auto blur = std::make_unique<GaussianBlurFilter>();
+        blur->setParameter("radius", 3.0f);
+        blur->setOpacity(opacity);
+        chain.addFilter(std::move(blur));
+    }
+    chain.optimize();
+    EXPECT_EQ(chain.getFilterCount(), 2u);
+}
+
+TEST(FilterChainGPUTest, MixedChainsSplitIntoDeviceAndCPURuns) {
+    QuantumCanvas::Rendering::RenderingEngine engine;
+    FilterProcessor processor(engine);
+
+    // The disabled filter leaves the two CPU filters around it in one run
+    FilterChain chain;
+    chain.addFilter(std::make_unique<KernelFilter>("KernelA"));
+    chain.addFilter(std::make_unique<KernelFilter>("KernelB"));
+    chain.addFilter(std::make_unique<ScaleFilter>(0.5f, 0.1f));
+    auto disabled = std::make_unique<KernelFilter>("KernelC");
+    disabled->setEnabled(false);
+    chain.addFilter(std::move(disabled));
+    chain.addFilter(std::make_unique<CrossSampleFilter>(2));
+    chain.addFilter(std::make_unique<KernelFilter>("KernelA"));
+
+    auto runs = processor.planChainRuns(chain);
+    ASSERT_EQ(runs.size(), 3u);
+    EXPECT_TRUE(runs[0].gpu);
+    EXPECT_EQ(runs[0].begin, 0u);
+    EXPECT_EQ(runs[0].end, 2u);
+    EXPECT_FALSE(runs[1].gpu);
+    EXPECT_EQ(runs[1].begin, 2u);
+    EXPECT_EQ(runs[1].end, 4u);
+    EXPECT_TRUE(runs[2].gpu);
+    EXPECT_EQ(runs[2].begin, 4u);
+    EXPECT_EQ(runs[2].end, 5u);
+
+    // Nothing to run is one empty CPU run, i.e. a copy
+    auto empty = processor.planChainRuns(FilterChain());
+    ASSERT_EQ(empty.size(), 1u);
+    EXPECT_FALSE(empty[0].gpu);
+    EXPECT_EQ(empty[0].begin, empty[0].end);
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/raster/gaussian_blur.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace QuantumCanvas::Raster;
+
+namespace {
+
+// Per-tap reference with clamp-to-edge borders
+Image referenceBlur(const Image& input, float sigma) {
+    std::vector<float> kernel = Blur::gaussianKernel(sigma);
+    int center = static_cast<int>(kernel.size() / 2);
+    int width = static_cast<int>(input.width());
+    int height = static_cast<int>(input.height());
+
+    auto pass = [&](const Image& src, bool horizontal) {
+        Image dst;
+        dst.reset(src.width(), src.height());
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                Image::Pixel sum = {0, 0, 0, 0};
+                for (int k = 0; k < static_cast<int>(kernel.size()); ++k) {
+                    int sx = horizontal ? std::clamp(x + k - center, 0, width - 1) : x;
+                    int sy = horizontal ? y : std::clamp(y + k - center, 0, height - 1);
+                    Image::Pixel p = src.getPixel(sx, sy);
+                    for (int c = 0; c < 4; ++c) {
+                        sum[c] += p[c] * kernel[k];
+                    }
+                }
+                dst.setPixel(x, y, sum);
+            }
+        }
+        return dst;
+    };
+    return pass(pass(input, true), false);
+}
+
+float maxDifference(const Image& a, const Image& b) {
+    float worst = 0.0f;
+    for (uint32_t y = 0; y < a.height(); ++y) {
+        for (uint32_t x = 0; x < a.width(); ++x) {
+            Image::Pixel pa = a.getPixel(x, y);
+            Image::Pixel pb = b.getPixel(x, y);
+            for (int c = 0; c < 4; ++c) {
+                worst = std::max(worst, std::fabs(pa[c] - pb[c]));
+            }
+        }
+    }
+    return worst;
+}
+
+// Noise over a region that crosses tile borders, fill elsewhere
+Image noisyImage(uint32_t width, uint32_t height) {
+    Image image;
+    image.reset(width, height, {0.2f, 0.4f, 0.6f, 1.0f});
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (uint32_t y = 200; y < 330; ++y) {
+        for (uint32_t x = 230; x < std::min(width, 290u); ++x) {
+            image.setPixel(x, y, {unit(rng), unit(rng), unit(rng), unit(rng)});
+        }
+    }
+    return image;
+}
+
+} // namespace
+
+TEST(GaussianBlurTest, DirectMatchesReference) {
+    Image input = noisyImage(300, 340);
+    Image output;
+    Blur::gaussianBlur(input, output, 2.5f, Blur::Method::Direct);
+
+    EXPECT_LT(maxDifference(output, referenceBlur(input, 2.5f)), 1e-5f);
+}
+
+TEST(GaussianBlurTest, BoxCascadeApproximatesGaussian) {
+    std::array<int, 3> radii = Blur::boxRadii(10.0f);
+    float variance = 0.0f;
+    for (int r : radii) {
+        variance += ((2.0f * r + 1.0f) * (2.0f * r + 1.0f) - 1.0f) / 12.0f;
+    }
+    EXPECT_NEAR(std::sqrt(variance), 10.0f, 0.5f);
+
+    Image input = noisyImage(300, 340);
+    Image output;
+    Blur::gaussianBlur(input, output, 10.0f, Blur::Method::BoxCascade);
+
+    EXPECT_LT(maxDifference(output, referenceBlur(input, 10.0f)), 0.02f);
+}
+
+TEST(GaussianBlurTest, UniformTilesStayUnallocated) {
+    Image input;
+    input.reset(1024, 1024, {1.0f, 0.0f, 0.0f, 1.0f});
+    input.setPixel(10, 10, {0.0f, 0.0f, 1.0f, 1.0f});
+
+    Image output;
+    Blur::gaussianBlur(input, output, 3.0f);
+
+    EXPECT_TRUE(output.isTileAllocated(0, 0));
+    EXPECT_FALSE(output.isTileAllocated(2, 0));
+    EXPECT_FALSE(output.isTileAllocated(0, 2));
+    EXPECT_FALSE(output.isTileAllocated(3, 3));
+    EXPECT_EQ(output.getPixel(700, 700), input.fillColor());
+    EXPECT_LT(output.getPixel(10, 10)[2], 0.1f);
+    EXPECT_GT(output.getPixel(10, 10)[2], 0.0f);
+}
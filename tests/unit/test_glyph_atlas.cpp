@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+#include "../../src/core/rendering/glyph_atlas.hpp"
+#include "../../src/core/rendering/text_batch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+using namespace QuantumCanvas::Rendering;
+
+namespace {
+
+using Polygon = std::vector<std::array<float, 2>>;
+
+GlyphOutline::Contour polygon_contour(const Polygon& points, bool reversed = false) {
+    GlyphOutline::Contour contour;
+    const size_t n = points.size();
+    for (size_t i = 0; i < n; ++i) {
+        GlyphOutline::Edge edge;
+        size_t a = reversed ? n - i : i;
+        size_t b = reversed ? n - i - 1 : i + 1;
+        edge.points[0] = points[a % n];
+        edge.points[1] = points[b % n];
+        contour.push_back(edge);
+    }
+    return contour;
+}
+
+bool inside_polygon(const Polygon& points, float x, float y) {
+    bool inside = false;
+    for (size_t i = 0, j = points.size() - 1; i < points.size(); j = i++) {
+        if ((points[i][1] > y) != (points[j][1] > y) &&
+            x < (points[j][0] - points[i][0]) * (y - points[i][1]) / (points[j][1] - points[i][1]) + points[i][0]) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+float distance_to_polygon(const Polygon& points, float x, float y) {
+    float best = 1e9f;
+    for (size_t i = 0, j = points.size() - 1; i < points.size(); j = i++) {
+        float dx = points[i][0] - points[j][0], dy = points[i][1] - points[j][1];
+        float t = std::clamp(((x - points[j][0]) * dx + (y - points[j][1]) * dy) / (dx * dx + dy * dy), 0.0f, 1.0f);
+        best = std::min(best, std::hypot(x - points[j][0] - t * dx, y - points[j][1] - t * dy));
+    }
+    return best;
+}
+
+// Reconstructs coverage the way the text shader does: bilinear samples of
+// the channels, then their median
+struct Field {
+    uint32_t width, height;
+    float scale, originX, originY;
+    std::vector<uint8_t> texels;
+
+    float channel(int x, int y, int c) const {
+        x = std::clamp(x, 0, int(width) - 1);
+        y = std::clamp(y, 0, int(height) - 1);
+        return texels[(size_t(y) * width + x) * 4 + c] / 255.0f;
+    }
+
+    float sample(float emX, float emY, int c) const {
+        float fx = (emX - originX) * scale - 0.5f;
+        float fy = (originY - emY) * scale - 0.5f;
+        int x0 = int(std::floor(fx)), y0 = int(std::floor(fy));
+        float tx = fx - x0, ty = fy - y0;
+        float top = channel(x0, y0, c) * (1 - tx) + channel(x0 + 1, y0, c) * tx;
+        float bottom = channel(x0, y0 + 1, c) * (1 - tx) + channel(x0 + 1, y0 + 1, c) * tx;
+        return top * (1 - ty) + bottom * ty;
+    }
+
+    bool inside(float emX, float emY) const {
+        float r = sample(emX, emY, 0), g = sample(emX, emY, 1), b = sample(emX, emY, 2);
+        return std::max(std::min(r, g), std::min(std::max(r, g), b)) > 0.5f;
+    }
+};
+
+Field render_field(const GlyphOutline& outline) {
+    Field field{48, 48, GlyphAtlas::EM_SIZE, -0.25f, 1.25f, {}};
+    field.texels.resize(size_t(field.width) * field.height * 4);
+    GlyphAtlas::render_distance_field(outline, field.scale, field.originX, field.originY,
+                                      field.width, field.height, field.texels.data(), field.width * 4);
+    return field;
+}
+
+// A square glyph as large as the given number of em
+GlyphProvider square_font(int* calls, float size = 1.0f) {
+    return [calls, size](char32_t codepoint) -> std::optional<GlyphOutline> {
+        if (calls) {
+            ++*calls;
+        }
+        GlyphOutline outline;
+        outline.advance = size * 1.2f;
+        if (codepoint != U' ') {
+            outline.contours.push_back(polygon_contour({{0, 0}, {size, 0}, {size, size}, {0, size}}));
+        }
+        return outline;
+    };
+}
+
+} // namespace
+
+TEST(GlyphAtlasTest, DistanceFieldKeepsSharpCorners) {
+    // An L with a concave corner, and a frame with a hole wound the other way
+    const Polygon ell{{0.1f, 0.1f}, {0.9f, 0.1f}, {0.9f, 0.35f}, {0.35f, 0.35f}, {0.35f, 0.9f}, {0.1f, 0.9f}};
+    const Polygon outer{{0.1f, 0.1f}, {0.9f, 0.1f}, {0.9f, 0.9f}, {0.1f, 0.9f}};
+    const Polygon hole{{0.3f, 0.3f}, {0.7f, 0.3f}, {0.7f, 0.7f}, {0.3f, 0.7f}};
+
+    struct Case {
+        GlyphOutline outline;
+        std::function<bool(float, float)> inside;
+        std::function<float(float, float)> distance;
+    };
+    std::vector<Case> cases;
+    for (bool reversed : {false, true}) {
+        GlyphOutline outline;
+        outline.contours.push_back(polygon_contour(ell, reversed));
+        cases.push_back({outline, [&](float x, float y) { return inside_polygon(ell, x, y); },
+                         [&](float x, float y) { return distance_to_polygon(ell, x, y); }});
+
+        GlyphOutline frame;
+        frame.contours.push_back(polygon_contour(outer, reversed));
+        frame.contours.push_back(polygon_contour(hole, !reversed));
+        cases.push_back({frame,
+                         [&](float x, float y) { return inside_polygon(outer, x, y) && !inside_polygon(hole, x, y); },
+                         [&](float x, float y) {
+                             return std::min(distance_to_polygon(outer, x, y), distance_to_polygon(hole, x, y));
+                         }});
+    }
+
+    // A single-channel field rounds corners off by about a texel; the
+    // multi-channel one must get every point a tenth of a texel off the
+    // outline right, corners included
+    const float texel = 1.0f / GlyphAtlas::EM_SIZE;
+    for (const Case& c : cases) {
+        Field field = render_field(c.outline);
+        int wrong = 0;
+        for (int i = 0; i < 200; ++i) {
+            for (int j = 0; j < 200; ++j) {
+                float x = i / 200.0f, y = j / 200.0f;
+                if (c.distance(x, y) > 0.1f * texel && field.inside(x, y) != c.inside(x, y)) {
+                    wrong++;
+                }
+            }
+        }
+        EXPECT_EQ(wrong, 0);
+    }
+}
+
+TEST(GlyphAtlasTest, RendersEachGlyphOnce) {
+    GlyphAtlas atlas;
+    int calls = 0;
+    FontId font = atlas.register_font("Square", square_font(&calls));
+    EXPECT_EQ(atlas.find_font("Square"), font);
+    EXPECT_FALSE(atlas.find_font("Missing").has_value());
+
+    std::vector<GlyphAtlas::PlacedGlyph> placed;
+    float advance = atlas.layout(font, "AB A\xC3\xA9", placed);
+    EXPECT_EQ(calls, 4);  // A, B, space, e-acute
+    ASSERT_EQ(placed.size(), 5u);
+    EXPECT_FLOAT_EQ(advance, 6.0f);
+    EXPECT_FLOAT_EQ(placed[3].x, 3.6f);
+    EXPECT_TRUE(placed[2].glyph.empty);
+    EXPECT_EQ(atlas.page_count(), 1u);
+    EXPECT_EQ(atlas.get_stats().hits, 1u);
+
+    // The quad covers the outline plus the distance margin, texel for texel
+    const auto& glyph = placed[0].glyph;
+    EXPECT_LT(glyph.plane[0], 0.0f);
+    EXPECT_GT(glyph.plane[2], 1.0f);
+    EXPECT_NEAR((glyph.uv[2] - glyph.uv[0]) * GlyphAtlas::PAGE_SIZE,
+                (glyph.plane[2] - glyph.plane[0]) * GlyphAtlas::EM_SIZE, 1e-3f);
+    EXPECT_NEAR((glyph.uv[3] - glyph.uv[1]) * GlyphAtlas::PAGE_SIZE,
+                (glyph.plane[3] - glyph.plane[1]) * GlyphAtlas::EM_SIZE, 1e-3f);
+
+    // Glyphs do not overlap in the page
+    const auto& other = placed[1].glyph;
+    EXPECT_TRUE(glyph.uv[2] <= other.uv[0] || other.uv[2] <= glyph.uv[0] ||
+                glyph.uv[3] <= other.uv[1] || other.uv[3] <= glyph.uv[1]);
+
+    placed.clear();
+    atlas.layout(font, "BA", placed);
+    EXPECT_EQ(calls, 4);
+}
+
+TEST(GlyphAtlasTest, RecyclesLeastRecentlyUsedPages) {
+    // Glyphs big enough to fill a page each
+    GlyphAtlas atlas(2);
+    FontId font = atlas.register_font("Large", square_font(nullptr, 16.0f));
+
+    ASSERT_TRUE(atlas.glyph(font, U'A').has_value());
+    atlas.begin_frame();
+    ASSERT_TRUE(atlas.glyph(font, U'B').has_value());
+    atlas.begin_frame();
+    atlas.glyph(font, U'B');
+    auto c = atlas.glyph(font, U'C');  // Takes A's page, the older one
+    ASSERT_TRUE(c.has_value());
+    EXPECT_EQ(atlas.page_count(), 2u);
+    EXPECT_EQ(atlas.get_stats().pageEvictions, 1u);
+    EXPECT_EQ(atlas.glyph_count(), 2u);
+
+    // Pages used this frame are never recycled; the extra page goes at the
+    // next frame
+    auto a = atlas.glyph(font, U'A');
+    ASSERT_TRUE(a.has_value());
+    EXPECT_EQ(atlas.page_count(), 3u);
+    EXPECT_EQ(atlas.get_stats().pageEvictions, 1u);
+    atlas.begin_frame();
+    EXPECT_EQ(atlas.page_count(), 2u);
+    EXPECT_EQ(atlas.glyph_count(), 2u);
+}
+
+TEST(GlyphAtlasTest, TextBatchPlacesQuadsAlongBaseline) {
+    auto atlas = std::make_shared<GlyphAtlas>();
+    FontId font = atlas->register_font("Square", square_font(nullptr));
+    TextBatch batch(atlas);
+
+    // Two units per em along +x, three up +y; a space leaves no quad
+    float advance = batch.add_text(font, "A A", {10, 20, 0}, {2, 0, 0}, {0, 3, 0}, {1, 0, 0, 1});
+    EXPECT_FLOAT_EQ(advance, 3.6f);
+    EXPECT_EQ(batch.glyph_count(), 2u);
+
+    std::vector<GlyphInstance> instances;
+    std::vector<std::pair<uint32_t, uint32_t>> pages;
+    batch.gather(instances, pages);
+    ASSERT_EQ(instances.size(), 2u);
+    ASSERT_EQ(pages.size(), 1u);
+    EXPECT_EQ(pages[0].second, 2u);
+
+    const auto glyph = atlas->glyph(font, U'A');
+    ASSERT_TRUE(glyph.has_value());
+    EXPECT_FLOAT_EQ(instances[0].origin[0], 10 + 2 * glyph->plane[0]);
+    EXPECT_FLOAT_EQ(instances[0].origin[1], 20 + 3 * glyph->plane[1]);
+    EXPECT_FLOAT_EQ(instances[1].origin[0] - instances[0].origin[0], 2 * 2.4f);
+    EXPECT_FLOAT_EQ(instances[0].xAxis[0], 2 * (glyph->plane[2] - glyph->plane[0]));
+    EXPECT_FLOAT_EQ(instances[0].yAxis[1], 3 * (glyph->plane[3] - glyph->plane[1]));
+    EXPECT_EQ(instances[0].uv, glyph->uv);
+
+    // Quads of a page recycled since they were placed are dropped
+    atlas->clear();
+    batch.gather(instances, pages);
+    EXPECT_TRUE(instances.empty());
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/vector/instance_batch.hpp"
+#include "../../src/modules/vector/vector_renderer.hpp"
+
+using namespace QuantumCanvas::Vector;
+
+namespace {
+
+VectorInstance placedAt(float x, float y) {
+    VectorInstance instance;
+    instance.translation = {x, y};
+    return instance;
+}
+
+} // namespace
+
+TEST(InstanceBatchTest, GroupsPlacementsByTessellation) {
+    auto marker = std::make_shared<TessellatedPath>();
+    auto hatch = std::make_shared<TessellatedPath>();
+    auto label = std::make_shared<TessellatedPath>();
+
+    InstanceBatch batch;
+    for (int i = 0; i < 1000; ++i) {
+        batch.add(i % 2 == 0 ? marker : hatch, placedAt(static_cast<float>(i), 0.0f));
+    }
+    batch.add(label, placedAt(-1.0f, 0.0f));
+    batch.add(nullptr, placedAt(0.0f, 0.0f));
+
+    EXPECT_EQ(batch.instance_count(), 1001u);
+    EXPECT_EQ(batch.group_count(), 3u);
+
+    batch.layout();
+    const auto& groups = batch.groups();
+    const auto& instances = batch.instances();
+    ASSERT_EQ(groups.size(), 3u);
+    ASSERT_EQ(instances.size(), 1001u);
+
+    // First-placed order, each group contiguous and in placement order
+    EXPECT_EQ(groups[0].tessellation, marker);
+    EXPECT_EQ(groups[1].tessellation, hatch);
+    EXPECT_EQ(groups[2].tessellation, label);
+    uint32_t next = 0;
+    for (const auto& group : groups) {
+        EXPECT_EQ(group.firstInstance, next);
+        next += group.instanceCount;
+    }
+    EXPECT_EQ(groups[0].instanceCount, 500u);
+    EXPECT_EQ(groups[2].instanceCount, 1u);
+    for (uint32_t i = 0; i < 500; ++i) {
+        EXPECT_EQ(instances[groups[0].firstInstance + i].translation[0], static_cast<float>(2 * i));
+        EXPECT_EQ(instances[groups[1].firstInstance + i].translation[0], static_cast<float>(2 * i + 1));
+    }
+    EXPECT_EQ(instances[groups[2].firstInstance].translation[0], -1.0f);
+}
+
+TEST(InstanceBatchTest, ClearReleasesTessellations) {
+    auto marker = std::make_shared<TessellatedPath>();
+    auto hatch = std::make_shared<TessellatedPath>();
+
+    InstanceBatch batch;
+    batch.add(marker, placedAt(0.0f, 0.0f));
+    batch.add(hatch, placedAt(1.0f, 0.0f));
+    batch.layout();
+    batch.clear();
+
+    EXPECT_TRUE(batch.empty());
+    EXPECT_EQ(batch.group_count(), 0u);
+    EXPECT_TRUE(batch.groups().empty());
+    EXPECT_EQ(marker.use_count(), 1);
+    EXPECT_EQ(hatch.use_count(), 1);
+
+    // Reused slots start empty
+    batch.add(hatch, placedAt(2.0f, 0.0f));
+    batch.layout();
+    ASSERT_EQ(batch.groups().size(), 1u);
+    EXPECT_EQ(batch.groups()[0].tessellation, hatch);
+    EXPECT_EQ(batch.groups()[0].instanceCount, 1u);
+    EXPECT_EQ(batch.instances()[0].translation[0], 2.0f);
+}
@@ -0,0 +1,298 @@
+#include <gtest/gtest.h>
+#include "../../src/core/kernel/kernel_manager.hpp"
+#include "../../src/core/kernel/task_scheduler.hpp"
+#include <vector>
+#include <thread>
+#include <string>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+
+using namespace QuantumCanvas::Core;
+
+namespace {
+
+// Minimal event carrying a producer id and sequence number
+class TestEvent : public IEvent {
+public:
+    TestEvent(uint32_t producer, uint32_t sequence, int* destroyed = nullptr)
+        : producer_(producer), sequence_(sequence), destroyed_(destroyed) {}
+    ~TestEvent() override {
+        if (destroyed_) {
+            ++*destroyed_;
+        }
+    }
+
+    EventType type() const override { return 1000; }
+    std::chrono::system_clock::time_point timestamp() const override { return {}; }
+    std::string source() const override { return "test"; }
+    size_t size() const override { return sizeof(*this); }
+
+    uint32_t producer() const { return producer_; }
+    uint32_t sequence() const { return sequence_; }
+
+private:
+    uint32_t producer_;
+    uint32_t sequence_;
+    int* destroyed_;
+};
+
+// Too large for inline storage, exercises the heap path
+class LargeTestEvent : public TestEvent {
+public:
+    using TestEvent::TestEvent;
+    char payload[256] = {};
+};
+
+} // namespace
+
+TEST(EventQueueTest, InlineAndHeapEvents) {
+    static_assert(EventQueue::fits_inline<TestEvent>);
+    static_assert(!EventQueue::fits_inline<LargeTestEvent>);
+
+    EventQueue queue(16);
+    int destroyed = 0;
+
+    EXPECT_TRUE(queue.try_emplace<TestEvent>(0u, 1u, &destroyed));
+    EXPECT_TRUE(queue.try_emplace<LargeTestEvent>(0u, 2u, &destroyed));
+    std::unique_ptr<IEvent> published = std::make_unique<TestEvent>(0u, 3u, &destroyed);
+    EXPECT_TRUE(queue.try_push(published));
+    EXPECT_EQ(published, nullptr);
+    EXPECT_EQ(queue.size_approx(), 3u);
+
+    std::vector<uint32_t> order;
+    size_t consumed = queue.consume([&order](const IEvent& event, EventQueue::Clock::time_point) {
+        order.push_back(static_cast<const TestEvent&>(event).sequence());
+    }, 16);
+
+    EXPECT_EQ(consumed, 3u);
+    EXPECT_EQ(order, (std::vector<uint32_t>{1, 2, 3}));
+    EXPECT_EQ(destroyed, 3);
+    EXPECT_EQ(queue.size_approx(), 0u);
+}
+
+TEST(EventQueueTest, BoundedCapacity) {
+    EventQueue queue(4);
+    EXPECT_EQ(queue.capacity(), 4u);
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.try_emplace<TestEvent>(0u, i));
+    }
+    EXPECT_FALSE(queue.try_emplace<TestEvent>(0u, 4u));
+
+    // A failed push leaves ownership with the caller
+    std::unique_ptr<IEvent> rejected = std::make_unique<TestEvent>(0u, 5u);
+    EXPECT_FALSE(queue.try_push(rejected));
+    EXPECT_NE(rejected, nullptr);
+
+    // Consuming frees slots for reuse
+    queue.consume([](const IEvent&, EventQueue::Clock::time_point) {}, 2);
+    EXPECT_TRUE(queue.try_emplace<TestEvent>(0u, 6u));
+    EXPECT_TRUE(queue.try_push(rejected));
+}
+
+TEST(EventQueueTest, MultipleProducers) {
+    const uint32_t num_producers = 4;
+    const uint32_t events_per_producer = 20000;
+    EventQueue queue(1024);
+
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < num_producers; ++p) {
+        producers.emplace_back([&queue, p, events_per_producer]() {
+            for (uint32_t i = 0; i < events_per_producer; ++i) {
+                while (!queue.try_emplace<TestEvent>(p, i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Events from each producer arrive in the order that producer published them
+    std::vector<uint32_t> next_expected(num_producers, 0);
+    size_t received = 0;
+    bool ordered = true;
+    while (received < num_producers * events_per_producer) {
+        received += queue.consume([&](const IEvent& event, EventQueue::Clock::time_point) {
+            const auto& test_event = static_cast<const TestEvent&>(event);
+            ordered &= test_event.sequence() == next_expected[test_event.producer()];
+            next_expected[test_event.producer()] = test_event.sequence() + 1;
+        }, 256);
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    EXPECT_TRUE(ordered);
+    for (uint32_t p = 0; p < num_producers; ++p) {
+        EXPECT_EQ(next_expected[p], events_per_producer);
+    }
+}
+
+namespace {
+
+// Records sequences; the first event publishes a burst from inside dispatch
+class RecordingHandler : public IEventHandler {
+public:
+    RecordingHandler(KernelManager& kernel, uint32_t burst_start, uint32_t burst_size)
+        : kernel_(kernel), burst_start_(burst_start), burst_size_(burst_size) {}
+
+    void handle_event(const IEvent& event) override {
+        sequences.push_back(static_cast<const TestEvent&>(event).sequence());
+        if (sequences.size() == 1) {
+            for (uint32_t i = 0; i < burst_size_; ++i) {
+                if (i % 2) {
+                    kernel_.emplace_event<TestEvent>(0u, burst_start_ + i);
+                } else {
+                    kernel_.publish_event(std::make_unique<TestEvent>(0u, burst_start_ + i));
+                }
+            }
+        }
+    }
+    bool can_handle(EventType type) const override { return type == 1000; }
+
+    std::vector<uint32_t> sequences;
+
+private:
+    KernelManager& kernel_;
+    uint32_t burst_start_;
+    uint32_t burst_size_;
+};
+
+} // namespace
+
+TEST(KernelEventsTest, OverflowKeepsPublishOrder) {
+    auto& kernel = KernelManager::instance();
+
+    // The burst fills the ring behind the batch and spills into overflow
+    const uint32_t initial = 10;
+    const uint32_t burst = KernelManager::EVENT_QUEUE_CAPACITY - initial + 50;
+    RecordingHandler handler(kernel, initial, burst);
+    kernel.subscribe(1000, &handler);
+
+    for (uint32_t sequence = 0; sequence < initial; ++sequence) {
+        kernel.publish_event(std::make_unique<TestEvent>(0u, sequence));
+    }
+    for (int batch = 0; batch < 4; ++batch) {
+        kernel.process_events();
+    }
+    kernel.unsubscribe(1000, &handler);
+
+    std::vector<uint32_t> expected(initial + burst);
+    std::iota(expected.begin(), expected.end(), 0u);
+    EXPECT_EQ(handler.sequences, expected);
+}
+
+TEST(TaskSchedulerTest, ParallelForCoversRange) {
+    TaskScheduler scheduler(4);
+    ASSERT_TRUE(scheduler.initialize());
+
+    std::vector<std::atomic<int>> hits(10000);
+    scheduler.parallel_for(0, hits.size(), 7, [&hits](size_t i) {
+        hits[i].fetch_add(1, std::memory_order_relaxed);
+    });
+
+    for (const auto& hit : hits) {
+        EXPECT_EQ(hit.load(), 1);
+    }
+
+    // Nested loops run on the same pool without deadlocking
+    std::atomic<size_t> total{0};
+    scheduler.parallel_for(0, 16, 1, [&](size_t) {
+        scheduler.parallel_for(0, 100, 10, [&](size_t) {
+            total.fetch_add(1, std::memory_order_relaxed);
+        });
+    });
+    EXPECT_EQ(total.load(), 1600u);
+
+    scheduler.shutdown();
+}
+
+TEST(TaskSchedulerTest, AsyncAndExceptions) {
+    TaskScheduler scheduler(2);
+    ASSERT_TRUE(scheduler.initialize());
+
+    auto result = scheduler.async([]() { return 42; });
+    EXPECT_EQ(result.get(), 42);
+
+    auto failed = scheduler.async([]() -> int { throw std::runtime_error("task failed"); });
+    EXPECT_THROW(failed.get(), std::runtime_error);
+
+    EXPECT_THROW(scheduler.parallel_for(0, 1000, 1, [](size_t i) {
+        if (i == 500) {
+            throw std::runtime_error("loop failed");
+        }
+    }), std::runtime_error);
+
+    scheduler.shutdown();
+
+    // After shutdown work runs inline on the caller
+    auto inline_result = scheduler.async([]() { return 7; });
+    EXPECT_EQ(inline_result.get(), 7);
+}
+
+TEST(TaskSchedulerTest, TaskGraphOrdering) {
+    TaskScheduler scheduler(3);
+    ASSERT_TRUE(scheduler.initialize());
+
+    // Diamond: a -> (b, c) -> d
+    std::atomic<int> a_done{0}, b_done{0}, c_done{0};
+    std::atomic<int> violations{0};
+    TaskGraph graph;
+    auto a = graph.add_task([&]() { a_done = 1; });
+    auto b = graph.add_task([&]() { violations += a_done != 1; b_done = 1; });
+    auto c = graph.add_task([&]() { violations += a_done != 1; c_done = 1; }, TaskPriority::Interactive);
+    auto d = graph.add_task([&]() { violations += b_done != 1 || c_done != 1; });
+    graph.add_dependency(a, b);
+    graph.add_dependency(a, c);
+    graph.add_dependency(b, d);
+    graph.add_dependency(c, d);
+
+    scheduler.run(graph);
+    EXPECT_EQ(violations.load(), 0);
+
+    // Graphs can be re-run
+    a_done = b_done = c_done = 0;
+    scheduler.run(graph);
+    EXPECT_EQ(violations.load(), 0);
+
+    TaskGraph cyclic;
+    auto x = cyclic.add_task([]() {});
+    auto y = cyclic.add_task([]() {});
+    cyclic.add_dependency(x, y);
+    cyclic.add_dependency(y, x);
+    EXPECT_THROW(scheduler.run(cyclic), std::invalid_argument);
+
+    scheduler.shutdown();
+}
+
+TEST(TaskSchedulerTest, WorkIsStolenAcrossWorkers) {
+    TaskScheduler scheduler(4);
+    ASSERT_TRUE(scheduler.initialize());
+
+    // A single task fans out from one worker's deque; idle workers must steal.
+    // future::get() blocks without helping, so the root runs on a worker.
+    std::atomic<int> completed{0};
+    auto root = scheduler.async([&]() {
+        TaskGroup children;
+        for (int i = 0; i < 256; ++i) {
+            scheduler.submit(children, [&completed]() {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                completed.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+        scheduler.wait(children);
+    });
+    root.get();
+
+    EXPECT_EQ(completed.load(), 256);
+
+    auto stats = scheduler.get_stats();
+    EXPECT_EQ(stats.worker_count, 4u);
+    EXPECT_EQ(stats.tasks_submitted, 257u);
+    EXPECT_GE(stats.tasks_executed, 256u);  // The root may still be finishing its bookkeeping
+    EXPECT_GT(stats.tasks_stolen, 0u);
+    EXPECT_EQ(stats.tasks_queued, 0u);
+
+    scheduler.shutdown();
+}
@@ -4,6 +4,8 @@
 #include <thread>
 #include <chrono>
 #include <random>
+#include <fstream>
+#include <filesystem>
 
 using namespace QuantumCanvas::Core;
 
@@ -79,6 +81,105 @@ TEST_F(MemoryManagerTest, AlignedAllocation) {
     manager->deallocate_aligned(ptr2, 2048, 4096);
 }
 
+TEST_F(MemoryManagerTest, OwnershipIndependentOfSize) {
+    // Frees resolve the owning pool or span from the address alone
+    void* small = manager->allocate(48);
+    void* large = manager->allocate(3 * 1024 * 1024);
+    ASSERT_NE(small, nullptr);
+    ASSERT_NE(large, nullptr);
+    EXPECT_TRUE(manager->owns(small));
+    EXPECT_TRUE(manager->owns(large));
+    
+    int local = 0;
+    EXPECT_FALSE(manager->owns(&local));
+    
+    manager->deallocate(small, 4096);
+    manager->deallocate(large, 1);
+    manager->flush_thread_cache();
+    EXPECT_GT(manager->get_stats().size_class_cached_bytes, 0u);
+    
+    // The pool block went back to its own pool and is handed out again
+    void* again = manager->allocate(48);
+    EXPECT_EQ(again, small);
+    manager->deallocate(again, 48);
+}
+
+TEST_F(MemoryManagerTest, SizeClassReuse) {
+    const size_t tile_size = 256 * 256 * 4 * sizeof(float); // 1MB float RGBA tile
+    
+    void* first = manager->allocate(tile_size);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % MemoryManager::SPAN_PAGE_SIZE, 0u);
+    manager->deallocate(first, tile_size);
+    EXPECT_GE(manager->get_stats().size_class_cached_bytes, tile_size);
+    
+    // A slightly smaller request in the same class reuses the cached span
+    void* second = manager->allocate(tile_size - 1000);
+    EXPECT_EQ(second, first);
+    EXPECT_EQ(manager->get_stats().size_class_hits, 1u);
+    manager->deallocate(second, tile_size - 1000);
+    
+    // Trimming returns cached spans to the system
+    manager->trim_size_class_cache();
+    EXPECT_EQ(manager->get_stats().size_class_cached_bytes, 0u);
+    EXPECT_FALSE(manager->owns(first));
+    
+    // With the cache disabled spans are released immediately
+    manager->set_size_class_cache_limit(0);
+    void* third = manager->allocate(tile_size);
+    manager->deallocate(third, tile_size);
+    EXPECT_EQ(manager->get_stats().size_class_cached_bytes, 0u);
+    
+    auto stats = manager->get_stats();
+    EXPECT_EQ(stats.current_usage, 0u);
+}
+
+TEST_F(MemoryManagerTest, HugePageBacking) {
+    const size_t layer_size = 32 * 1024 * 1024;
+    
+    // The hint forces a huge-page aligned mapping even with the mode disabled
+    void* layer = manager->allocate_aligned(layer_size, 64, AllocationHint::HugePages);
+    ASSERT_NE(layer, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(layer) % MemoryManager::HUGE_PAGE_SIZE, 0u);
+    std::memset(layer, 0x5A, layer_size);
+    
+    auto stats = manager->get_stats();
+    EXPECT_GE(stats.large_span_bytes, layer_size);
+    EXPECT_LE(stats.huge_page_bytes, stats.large_span_bytes);
+    EXPECT_LE(stats.huge_page_coverage(), 1.0);
+    
+    // Opting out keeps ordinary pages even above the threshold
+    manager->set_huge_page_mode(HugePageMode::Transparent);
+    void* staging = manager->allocate_aligned(layer_size, 64, AllocationHint::NoHugePages);
+    ASSERT_NE(staging, nullptr);
+    EXPECT_EQ(manager->get_stats().huge_page_bytes, stats.huge_page_bytes);
+    
+    manager->deallocate_aligned(layer, layer_size, 64);
+    manager->deallocate_aligned(staging, layer_size, 64);
+    
+    stats = manager->get_stats();
+    EXPECT_EQ(stats.large_span_bytes, 0u);
+    EXPECT_EQ(stats.huge_page_bytes, 0u);
+    EXPECT_EQ(stats.current_usage, 0u);
+}
+
+TEST_F(MemoryManagerTest, NumaPreferredNode) {
+    MemoryManager::set_thread_numa_node(0);
+    EXPECT_EQ(MemoryManager::get_thread_numa_node(), 0);
+    
+    // Binding is best effort; the allocation must succeed either way
+    const size_t size = 20 * 1024 * 1024;
+    void* ptr = manager->allocate(size);
+    ASSERT_NE(ptr, nullptr);
+    std::memset(ptr, 0, size);
+    EXPECT_LE(manager->get_stats().numa_bound_bytes, manager->get_stats().large_span_bytes);
+    manager->deallocate(ptr, size);
+    EXPECT_EQ(manager->get_stats().numa_bound_bytes, 0u);
+    
+    MemoryManager::set_thread_numa_node(-1);
+    EXPECT_EQ(MemoryManager::get_thread_numa_node(), -1);
+}
+
 TEST_F(MemoryManagerTest, ObjectAllocation) {
     // Test object allocation
     struct TestObject {
@@ -252,6 +353,219 @@ TEST_F(MemoryManagerTest, Performance) {
     std::cout << "Average allocation time: " << avg_time << "μs" << std::endl;
 }
 
+TEST_F(MemoryManagerTest, CrossThreadFree) {
+    // Blocks allocated on one thread and freed on another must return to the pools
+    const int count = 200;
+    std::vector<void*> ptrs(count);
+    
+    std::thread producer([&]() {
+        for (int i = 0; i < count; ++i) {
+            ptrs[i] = manager->allocate(128);
+            ASSERT_NE(ptrs[i], nullptr);
+        }
+    });
+    producer.join();
+    
+    std::thread consumer([&]() {
+        for (int i = 0; i < count; ++i) {
+            manager->deallocate(ptrs[i], 128);
+        }
+        manager->flush_thread_cache();
+    });
+    consumer.join();
+    
+    auto stats = manager->get_stats();
+    EXPECT_EQ(stats.allocation_count, stats.deallocation_count);
+    EXPECT_EQ(stats.current_usage, 0u);
+}
+
+TEST_F(MemoryManagerTest, ContentionBenchmark) {
+    // Tile-sized churn from many workers at once, as filter batches and brush threads do
+    const int num_threads = std::max(4u, std::thread::hardware_concurrency());
+    const int ops_per_thread = 20000;
+    
+    auto run = [&](bool thread_cache) {
+        manager->set_thread_cache_enabled(thread_cache);
+        std::vector<std::thread> threads;
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([this, t, ops_per_thread]() {
+                std::mt19937 rng(t);
+                std::uniform_int_distribution<size_t> size_dist(16, 4096);
+                std::vector<std::pair<void*, size_t>> live;
+                live.reserve(16);
+                
+                for (int i = 0; i < ops_per_thread; ++i) {
+                    size_t size = size_dist(rng);
+                    live.emplace_back(manager->allocate(size), size);
+                    if (live.size() == 16) {
+                        for (const auto& [ptr, sz] : live) {
+                            manager->deallocate(ptr, sz);
+                        }
+                        live.clear();
+                    }
+                }
+                for (const auto& [ptr, sz] : live) {
+                    manager->deallocate(ptr, sz);
+                }
+                manager->flush_thread_cache();
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::micro>(end - start).count();
+    };
+    
+    double locked_us = run(false);
+    double cached_us = run(true);
+    
+    double total_ops = 2.0 * num_threads * ops_per_thread;
+    std::cout << "Contention benchmark (" << num_threads << " threads): "
+              << "locked " << (total_ops / locked_us) << " Mops/s, "
+              << "thread-cached " << (total_ops / cached_us) << " Mops/s" << std::endl;
+    
+    auto stats = manager->get_stats();
+    EXPECT_EQ(stats.allocation_count, stats.deallocation_count);
+    EXPECT_EQ(stats.current_usage, 0u);
+}
+
+TEST_F(MemoryManagerTest, FrameArena) {
+    FrameArena& arena = manager->frame_arena();
+    
+    void* a = arena.allocate(24, 8);
+    void* b = arena.allocate(100, 64);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 64, 0u);
+    EXPECT_GE(arena.bytes_used(), 124u);
+    
+    // Arena memory is not accounted as pool/heap usage
+    EXPECT_EQ(manager->get_total_allocated(), 0u);
+    
+    // Objects created in the arena are destroyed on end_frame
+    static int destroyed = 0;
+    struct Tracked {
+        ~Tracked() { ++destroyed; }
+    };
+    destroyed = 0;
+    arena.create<Tracked>();
+    arena.create<Tracked>();
+    
+    uint64_t frame = arena.frame_index();
+    manager->end_frame();
+    EXPECT_EQ(destroyed, 2);
+    EXPECT_EQ(arena.bytes_used(), 0u);
+    EXPECT_EQ(arena.frame_index(), frame + 1);
+}
+
+TEST_F(MemoryManagerTest, FrameArenaSteadyState) {
+    FrameArena& arena = manager->frame_arena();
+    size_t frame_bytes = arena.capacity() * 3;
+    
+    // First frame overflows the initial block
+    FrameVector<uint8_t> first{FrameAllocator<uint8_t>(&arena)};
+    first.resize(frame_bytes);
+    EXPECT_GT(arena.overflow_count(), 0u);
+    manager->end_frame();
+    
+    // Overflow blocks were coalesced, so the same workload no longer grows the arena
+    size_t overflows = arena.overflow_count();
+    size_t capacity = arena.capacity();
+    for (int frame = 0; frame < 4; ++frame) {
+        FrameVector<uint8_t> scratch{FrameAllocator<uint8_t>(&arena)};
+        scratch.reserve(frame_bytes);
+        scratch.resize(frame_bytes);
+        manager->end_frame();
+    }
+    EXPECT_EQ(arena.overflow_count(), overflows);
+    EXPECT_EQ(arena.capacity(), capacity);
+    EXPECT_GE(arena.high_water_mark(), frame_bytes);
+}
+
+TEST_F(MemoryManagerTest, FrameArenaThreadSafety) {
+    FrameArena& arena = manager->frame_arena();
+    const int num_threads = 4;
+    const int allocs_per_thread = 5000;
+    std::vector<std::vector<uint32_t*>> results(num_threads);
+    std::vector<std::thread> threads;
+    
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < allocs_per_thread; ++i) {
+                auto* value = arena.allocate_array<uint32_t>(16);
+                for (int j = 0; j < 16; ++j) {
+                    value[j] = static_cast<uint32_t>(t * allocs_per_thread + i);
+                }
+                results[t].push_back(value);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    // No two threads were handed overlapping memory
+    for (int t = 0; t < num_threads; ++t) {
+        for (int i = 0; i < allocs_per_thread; ++i) {
+            for (int j = 0; j < 16; ++j) {
+                ASSERT_EQ(results[t][i][j], static_cast<uint32_t>(t * allocs_per_thread + i));
+            }
+        }
+    }
+    manager->end_frame();
+}
+
+TEST(MappedFileTest, MapsWholeFile) {
+    auto path = std::filesystem::temp_directory_path() / "qcs_mapped_file_test.bin";
+    std::vector<uint8_t> contents(100000);
+    for (size_t i = 0; i < contents.size(); ++i) {
+        contents[i] = static_cast<uint8_t>(i * 31);
+    }
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(contents.data()), contents.size());
+    }
+
+    MappedFile file;
+    ASSERT_TRUE(file.open(path));
+    ASSERT_EQ(file.size(), contents.size());
+    EXPECT_EQ(std::memcmp(file.data(), contents.data(), contents.size()), 0);
+
+    MappedFile moved = std::move(file);
+    EXPECT_FALSE(file.is_open());
+    EXPECT_TRUE(moved.is_open());
+
+    moved.close();
+    std::filesystem::remove(path);
+    EXPECT_FALSE(moved.open(path));
+}
+
+TEST(MappedFileTest, AccessHintsAndPrefetch) {
+    auto path = std::filesystem::temp_directory_path() / "qcs_mapped_file_hint_test.bin";
+    std::vector<uint8_t> contents(3 * 4096 + 5, 0x5a);
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(contents.data()), contents.size());
+    }
+
+    MappedFile file;
+    file.prefetch(0, 100);  // Closed: no-op
+    ASSERT_TRUE(file.open(path, MappedFile::Access::Random));
+    file.prefetch(4097, 5000);
+    file.prefetch(contents.size() - 1, 1000);  // Clamped to the file
+    file.prefetch(contents.size() + 10, 10);
+    EXPECT_EQ(file.data()[contents.size() - 1], 0x5a);
+
+    ASSERT_TRUE(file.open(path, MappedFile::Access::Sequential));
+    EXPECT_EQ(file.size(), contents.size());
+
+    file.close();
+    std::filesystem::remove(path);
+}
+
 // Test fixture for stress testing
 class MemoryManagerStressTest : public MemoryManagerTest {
 protected:
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/raster/paint_medium.hpp"
+#include <cmath>
+
+using namespace QuantumCanvas::Raster;
+
+namespace {
+
+float totalWater(const PaintMedium& medium, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1) {
+    double sum = 0.0;
+    for (uint32_t y = y0; y < y1; ++y) {
+        for (uint32_t x = x0; x < x1; ++x) {
+            sum += medium.water(x, y);
+        }
+    }
+    return static_cast<float>(sum);
+}
+
+} // namespace
+
+TEST(PaintMediumTest, BristlesSettleAroundTheDab) {
+    BristleSet bristles;
+    bristles.reset(37, 1.0f);
+    ASSERT_EQ(bristles.size(), 37u);
+
+    for (int i = 0; i < 200; ++i) {
+        bristles.step(100.0f, 50.0f, 10.0f, 0.8f, 1.0f);
+    }
+    for (size_t i = 0; i < bristles.size(); ++i) {
+        float dx = bristles.x()[i] - 100.0f;
+        float dy = bristles.y()[i] - 50.0f;
+        EXPECT_LE(std::sqrt(dx * dx + dy * dy), 10.0f + 1e-3f);
+        EXPECT_GE(bristles.pressure()[i], 0.08f - 1e-6f);
+        EXPECT_LE(bristles.pressure()[i], 0.8f + 1e-6f);
+    }
+}
+
+TEST(PaintMediumTest, FlowStaysLocalAndConservesWater) {
+    // A large canvas with one dab: only tiles near it may ever exist
+    PaintMedium medium(4096, 4096);
+    medium.setParameters(0.0f, 20.0f, 0.0f);
+    medium.deposit(1000.0f, 1000.0f, 6.0f, {1.0f, 0.0f, 0.0f, 1.0f}, 1.0f);
+    float before = totalWater(medium, 800, 800, 1200, 1200);
+    ASSERT_GT(before, 0.0f);
+
+    for (int i = 0; i < 20; ++i) {
+        medium.step(0.05f);
+    }
+
+    EXPECT_LT(medium.tileCount(), 16u);
+    EXPECT_NEAR(totalWater(medium, 800, 800, 1200, 1200), before, before * 1e-3f);
+    EXPECT_GT(medium.water(1010, 1000), 0.0f);
+    EXPECT_GT(medium.pigment(1003, 1000)[3], 0.0f);
+}
+
+TEST(PaintMediumTest, DryPaintIsReleasedIntoTheCanvas) {
+    PaintMedium medium(300, 300);
+    medium.setParameters(0.5f, 4.0f, 1.0f);
+    medium.deposit(150.0f, 150.0f, 8.0f, {0.0f, 0.0f, 1.0f, 1.0f}, 0.5f);
+
+    Image canvas(300, 300, {1.0f, 1.0f, 1.0f, 1.0f});
+    EXPECT_EQ(medium.releaseDryTiles(canvas), 0u);
+
+    for (int i = 0; i < 200 && medium.wetTileCount() > 0; ++i) {
+        medium.step(0.1f);
+    }
+    ASSERT_EQ(medium.wetTileCount(), 0u);
+
+    EXPECT_GT(medium.releaseDryTiles(canvas), 0u);
+    EXPECT_EQ(medium.tileCount(), 0u);
+
+    Image::Pixel centre = canvas.getPixel(150, 150);
+    EXPECT_LT(centre[0], 0.5f);
+    EXPECT_GT(centre[2], 0.9f);
+    EXPECT_FLOAT_EQ(canvas.getPixel(5, 5)[0], 1.0f);
+    EXPECT_FALSE(canvas.isTileAllocated(1, 1));
+}
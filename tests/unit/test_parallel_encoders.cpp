@@ -0,0 +1,269 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/io/parallel_encoders.hpp"
+#include "../../src/core/kernel/task_scheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <vector>
+#include <zlib.h>
+#include <png.h>
+#include <jpeglib.h>
+
+using namespace QuantumCanvas::IO;
+using QuantumCanvas::Core::TaskScheduler;
+using QuantumCanvas::Raster::Image;
+
+namespace {
+
+// Gradients with noise and a translucent patch; the bottom-right tiles are left unallocated
+Image testImage(uint32_t width, uint32_t height) {
+    Image image(width, height, {0.2f, 0.4f, 0.6f, 1.0f});
+    uint32_t seed = 12345;
+    for (uint32_t y = 0; y < std::min(height, 300u); ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            seed = seed * 1664525u + 1013904223u;
+            const float noise = float(seed >> 24) / 255.0f * 0.1f;
+            const float alpha = (x > 40 && x < 90 && y > 10 && y < 70) ? 0.5f : 1.0f;
+            image.setPixel(x, y, {float(x) / width + noise, float(y) / height, 0.5f + noise, alpha});
+        }
+    }
+    return image;
+}
+
+uint8_t toByte(float value) {
+    return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+std::vector<uint8_t> expectedSamples(const Image& image, uint32_t channels) {
+    std::vector<uint8_t> samples;
+    for (uint32_t y = 0; y < image.height(); ++y) {
+        for (uint32_t x = 0; x < image.width(); ++x) {
+            const Image::Pixel pixel = image.getPixel(x, y);
+            for (uint32_t c = 0; c < channels; ++c) {
+                samples.push_back(toByte(pixel[c]));
+            }
+        }
+    }
+    return samples;
+}
+
+uint32_t read16LE(const std::vector<uint8_t>& data, size_t offset) {
+    return data[offset] | (uint32_t(data[offset + 1]) << 8);
+}
+
+uint32_t read32LE(const std::vector<uint8_t>& data, size_t offset) {
+    return read16LE(data, offset) | (read16LE(data, offset + 2) << 16);
+}
+
+// Tags of the first IFD; arrays of LONGs are read through their offsets
+std::map<uint16_t, std::vector<uint32_t>> readIFD(const std::vector<uint8_t>& tiff) {
+    std::map<uint16_t, std::vector<uint32_t>> tags;
+    const uint32_t ifd = read32LE(tiff, 4);
+    const uint32_t count = read16LE(tiff, ifd);
+    for (uint32_t i = 0; i < count; ++i) {
+        const size_t entry = ifd + 2 + 12 * i;
+        const auto tag = static_cast<uint16_t>(read16LE(tiff, entry));
+        const uint32_t type = read16LE(tiff, entry + 2);
+        const uint32_t values = read32LE(tiff, entry + 4);
+        if (type == 4 && values > 1) {
+            for (uint32_t v = 0; v < values; ++v) {
+                tags[tag].push_back(read32LE(tiff, read32LE(tiff, entry + 8) + 4 * v));
+            }
+        }
+        else {
+            tags[tag].push_back(type == 3 && values == 1 ? read16LE(tiff, entry + 8) : read32LE(tiff, entry + 8));
+        }
+    }
+    return tags;
+}
+
+std::vector<uint8_t> inflateZlib(const uint8_t* data, size_t size, size_t expected) {
+    std::vector<uint8_t> out(expected);
+    uLongf outSize = static_cast<uLongf>(expected);
+    EXPECT_EQ(uncompress(out.data(), &outSize, data, static_cast<uLong>(size)), Z_OK);
+    EXPECT_EQ(outSize, expected);
+    return out;
+}
+
+// A single-pass libjpeg encode with a restart marker after every MCU row
+std::vector<uint8_t> serialJPEG(const Image& image, int quality) {
+    const std::vector<uint8_t> rgb = expectedSamples(image, 3);
+    jpeg_compress_struct info;
+    jpeg_error_mgr error;
+    info.err = jpeg_std_error(&error);
+    jpeg_create_compress(&info);
+    unsigned char* buffer = nullptr;
+    unsigned long size = 0;
+    jpeg_mem_dest(&info, &buffer, &size);
+    info.image_width = image.width();
+    info.image_height = image.height();
+    info.input_components = 3;
+    info.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&info);
+    jpeg_set_quality(&info, quality, TRUE);
+    info.optimize_coding = FALSE;
+    info.restart_interval = (image.width() + 15) / 16;
+    jpeg_start_compress(&info, TRUE);
+    while (info.next_scanline < info.image_height) {
+        JSAMPROW row = const_cast<JSAMPROW>(rgb.data() + size_t(info.next_scanline) * image.width() * 3);
+        jpeg_write_scanlines(&info, &row, 1);
+    }
+    jpeg_finish_compress(&info);
+    jpeg_destroy_compress(&info);
+
+    std::vector<uint8_t> result(buffer, buffer + size);
+    std::free(buffer);
+    return result;
+}
+
+double relativeError(size_t estimate, size_t actual) {
+    return std::abs(double(estimate) - double(actual)) / double(actual);
+}
+
+} // namespace
+
+class ParallelEncodersTest : public ::testing::Test {
+protected:
+    void SetUp() override { ASSERT_TRUE(scheduler.initialize()); }
+    void TearDown() override { scheduler.shutdown(); }
+
+    TaskScheduler scheduler{3};
+};
+
+TEST_F(ParallelEncodersTest, PNGBandsFormOneStream) {
+    const Image image = testImage(517, 600);
+    for (bool alpha : {true, false}) {
+        ParallelEncodeSettings settings;
+        settings.alpha = alpha;
+        settings.rowsPerTask = 37;
+        settings.scheduler = &scheduler;
+        const std::vector<uint8_t> png = ParallelEncoders::encodePNG(image, settings);
+
+        png_image decoded{};
+        decoded.version = PNG_IMAGE_VERSION;
+        ASSERT_TRUE(png_image_begin_read_from_memory(&decoded, png.data(), png.size())) << decoded.message;
+        EXPECT_EQ(decoded.width, 517u);
+        EXPECT_EQ(decoded.height, 600u);
+        decoded.format = alpha ? PNG_FORMAT_RGBA : PNG_FORMAT_RGB;
+        std::vector<uint8_t> pixels(PNG_IMAGE_SIZE(decoded));
+        ASSERT_TRUE(png_image_finish_read(&decoded, nullptr, pixels.data(), 0, nullptr)) << decoded.message;
+        EXPECT_EQ(pixels, expectedSamples(image, alpha ? 4 : 3));
+    }
+
+    // Single band, inline, stored
+    ParallelEncodeSettings stored;
+    stored.compressionLevel = 0;
+    const Image small = testImage(9, 5);
+    const std::vector<uint8_t> png = ParallelEncoders::encodePNG(small, stored);
+    png_image decoded{};
+    decoded.version = PNG_IMAGE_VERSION;
+    ASSERT_TRUE(png_image_begin_read_from_memory(&decoded, png.data(), png.size()));
+    decoded.format = PNG_FORMAT_RGBA;
+    std::vector<uint8_t> pixels(PNG_IMAGE_SIZE(decoded));
+    ASSERT_TRUE(png_image_finish_read(&decoded, nullptr, pixels.data(), 0, nullptr));
+    EXPECT_EQ(pixels, expectedSamples(small, 4));
+
+    EXPECT_THROW(ParallelEncoders::encodePNG(Image()), std::invalid_argument);
+}
+
+TEST_F(ParallelEncodersTest, TIFFStripsAndTilesInflate) {
+    const Image image = testImage(300, 400);
+    const std::vector<uint8_t> rgba = expectedSamples(image, 4);
+
+    ParallelEncodeSettings settings;
+    settings.rowsPerTask = 48;
+    settings.scheduler = &scheduler;
+    const std::vector<uint8_t> strips = ParallelEncoders::encodeTIFF(image, settings);
+    ASSERT_EQ(std::memcmp(strips.data(), "II*\0", 4), 0);
+
+    auto tags = readIFD(strips);
+    EXPECT_EQ(tags[256][0], 300u);
+    EXPECT_EQ(tags[257][0], 400u);
+    EXPECT_EQ(tags[259][0], 8u);
+    EXPECT_EQ(tags[277][0], 4u);
+    EXPECT_EQ(tags[278][0], 48u);
+    EXPECT_EQ(tags[317][0], 2u);
+    EXPECT_EQ(tags[338][0], 2u);
+    ASSERT_EQ(tags[273].size(), 9u);
+    ASSERT_EQ(tags[279].size(), 9u);
+    for (uint32_t strip = 0; strip < 9; ++strip) {
+        const uint32_t rows = std::min(48u, 400 - strip * 48);
+        std::vector<uint8_t> samples = inflateZlib(strips.data() + tags[273][strip], tags[279][strip], size_t(rows) * 1200);
+        for (uint32_t r = 0; r < rows; ++r) {
+            for (size_t i = 4; i < 1200; ++i) {
+                samples[r * 1200 + i] = static_cast<uint8_t>(samples[r * 1200 + i] + samples[r * 1200 + i - 4]);
+            }
+        }
+        ASSERT_TRUE(std::equal(samples.begin(), samples.end(), rgba.begin() + size_t(strip) * 48 * 1200)) << strip;
+    }
+
+    // Tiles pad past the right and bottom edges
+    settings.tiffTiled = true;
+    settings.tiffTileSize = 120;
+    settings.tiffPredictor = 1;
+    settings.alpha = false;
+    const std::vector<uint8_t> tiled = ParallelEncoders::encodeTIFF(image, settings);
+    tags = readIFD(tiled);
+    EXPECT_EQ(tags[322][0], 128u);
+    EXPECT_EQ(tags[323][0], 128u);
+    EXPECT_EQ(tags.count(317), 0u);
+    EXPECT_EQ(tags.count(338), 0u);
+    ASSERT_EQ(tags[324].size(), 3u * 4u);
+
+    const std::vector<uint8_t> rgb = expectedSamples(image, 3);
+    for (uint32_t tile = 0; tile < 12; ++tile) {
+        const std::vector<uint8_t> samples = inflateZlib(tiled.data() + tags[324][tile], tags[325][tile], 128 * 128 * 3);
+        const uint32_t x0 = (tile % 3) * 128;
+        const uint32_t y0 = (tile / 3) * 128;
+        for (uint32_t y = y0; y < std::min(y0 + 128, 400u); ++y) {
+            for (uint32_t x = x0; x < std::min(x0 + 128, 300u); ++x) {
+                for (uint32_t c = 0; c < 3; ++c) {
+                    ASSERT_EQ(samples[((y - y0) * 128 + (x - x0)) * 3 + c], rgb[(size_t(y) * 300 + x) * 3 + c]);
+                }
+            }
+        }
+    }
+}
+
+TEST_F(ParallelEncodersTest, JPEGMatchesSinglePassRestartEncoding) {
+    const Image image = testImage(301, 203);
+    ParallelEncodeSettings settings;
+    settings.quality = 0.85f;
+    settings.rowsPerTask = 20;  // Rounded up to 32, whole MCU rows
+    settings.scheduler = &scheduler;
+
+    const std::vector<uint8_t> parallel = ParallelEncoders::encodeJPEG(image, settings);
+    EXPECT_EQ(parallel, serialJPEG(image, 85));
+
+    jpeg_decompress_struct info;
+    jpeg_error_mgr error;
+    info.err = jpeg_std_error(&error);
+    jpeg_create_decompress(&info);
+    jpeg_mem_src(&info, parallel.data(), parallel.size());
+    ASSERT_EQ(jpeg_read_header(&info, TRUE), JPEG_HEADER_OK);
+    EXPECT_EQ(info.image_width, 301u);
+    EXPECT_EQ(info.image_height, 203u);
+    jpeg_destroy_decompress(&info);
+}
+
+TEST_F(ParallelEncodersTest, SampledEstimatesTrackEncodedSizes) {
+    const Image image = testImage(1500, 2000);
+    ParallelEncodeSettings settings;
+    settings.scheduler = &scheduler;
+
+    EXPECT_LT(relativeError(ParallelEncoders::estimatePNGSize(image, settings),
+                            ParallelEncoders::encodePNG(image, settings).size()), 0.2);
+    EXPECT_LT(relativeError(ParallelEncoders::estimateTIFFSize(image, settings),
+                            ParallelEncoders::encodeTIFF(image, settings).size()), 0.2);
+    EXPECT_LT(relativeError(ParallelEncoders::estimateJPEGSize(image, settings),
+                            ParallelEncoders::encodeJPEG(image, settings).size()), 0.2);
+
+    // Small enough to sample every band: the estimate is the encode
+    const Image small = testImage(200, 100);
+    const size_t actual = ParallelEncoders::encodeTIFF(small, settings).size();
+    EXPECT_LT(relativeError(ParallelEncoders::estimateTIFFSize(small, settings), actual), 0.05);
+}
@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/io/qcsx_archive.hpp"
+#include "../../src/core/kernel/task_scheduler.hpp"
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+using namespace QuantumCanvas::IO;
+using QuantumCanvas::Core::TaskScheduler;
+using QuantumCanvas::Raster::Image;
+
+namespace {
+
+class QCSXArchiveTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory_ = std::filesystem::temp_directory_path() / "qcs_qcsx_archive_test";
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+        ASSERT_TRUE(scheduler_.initialize());
+        settings_.scheduler = &scheduler_;
+    }
+
+    void TearDown() override {
+        scheduler_.shutdown();
+        std::error_code error;
+        std::filesystem::remove_all(directory_, error);
+    }
+
+    std::filesystem::path path(const std::string& name) const { return directory_ / name; }
+
+    // Paints a gradient over part of a 1100x700 canvas, so some tiles stay unallocated
+    static std::shared_ptr<Image> painted() {
+        auto image = std::make_shared<Image>(1100, 700, Image::Pixel{0.0f, 0.0f, 0.0f, 0.0f});
+        for (uint32_t y = 100; y < 600; ++y) {
+            for (uint32_t x = 0; x < 700; ++x) {
+                image->setPixel(x, y, {x / 700.0f, y / 700.0f, 0.25f, 1.0f});
+            }
+        }
+        return image;
+    }
+
+    static std::vector<QCSXLayer> document(std::shared_ptr<const Image> pixels) {
+        std::vector<QCSXLayer> layers(3);
+        layers[0].id = 7;
+        layers[0].type = "LayerGroup";
+        layers[0].properties = {1, 2, 3};
+        layers[1].id = 8;
+        layers[1].parentId = 7;
+        layers[1].type = "RasterLayer";
+        layers[1].properties = {4, 5};
+        layers[1].image = std::move(pixels);
+        layers[2].id = 9;
+        layers[2].type = "AdjustmentLayer";
+        return layers;
+    }
+
+    static void expectSamePixels(const Image& a, const Image& b) {
+        ASSERT_EQ(a.getSize(), b.getSize());
+        for (uint32_t y = 0; y < a.height(); y += 7) {
+            for (uint32_t x = 0; x < a.width(); x += 7) {
+                ASSERT_EQ(a.getPixel(x, y), b.getPixel(x, y)) << x << ", " << y;
+            }
+        }
+    }
+
+    TaskScheduler scheduler_{3};
+    QCSXSaveSettings settings_;
+    std::filesystem::path directory_;
+};
+
+} // namespace
+
+TEST_F(QCSXArchiveTest, RoundTripsLayersLazily) {
+    auto pixels = painted();
+    Image preview(64, 40, {1.0f, 0.5f, 0.0f, 1.0f});
+    QCSXArchive archive;
+    auto stats = archive.save(path("doc.qcsx"), {1100, 700}, document(pixels), &preview, settings_);
+    EXPECT_FALSE(stats.incremental);
+    EXPECT_EQ(stats.chunksWritten, pixels->allocatedTileCount());
+
+    QCSXArchive opened(path("doc.qcsx"));
+    const auto info = opened.getInfo();
+    EXPECT_EQ(info.canvasSize, (std::array<uint32_t, 2>{1100, 700}));
+    EXPECT_EQ(info.layerCount, 3u);
+    EXPECT_EQ(info.generation, 1u);
+    EXPECT_EQ(info.liveBytes, info.fileBytes);
+    EXPECT_TRUE(info.hasPreview);
+
+    const auto layers = opened.getLayers();
+    ASSERT_EQ(layers.size(), 3u);
+    EXPECT_EQ(layers[0].type, "LayerGroup");
+    EXPECT_EQ(layers[0].properties, (std::vector<uint8_t>{1, 2, 3}));
+    EXPECT_FALSE(layers[0].hasImage);
+    EXPECT_EQ(layers[1].parentId, 7u);
+    EXPECT_TRUE(layers[1].hasImage);
+    EXPECT_EQ(layers[1].storedTiles, pixels->allocatedTileCount());
+    EXPECT_LT(layers[1].storedBytes, pixels->allocatedTileCount() * Image::TILE_FLOATS * sizeof(float) / 2);
+    EXPECT_EQ(opened.findLayer(9), std::optional<size_t>(2));
+    EXPECT_FALSE(opened.findLayer(10).has_value());
+
+    EXPECT_EQ(opened.loadImage(0), nullptr);
+    auto loaded = opened.loadImage(1);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->allocatedTileCount(), pixels->allocatedTileCount());
+    expectSamePixels(*loaded, *pixels);
+    EXPECT_THROW(opened.loadImage(3), std::invalid_argument);
+
+    auto storedPreview = opened.loadPreview();
+    ASSERT_NE(storedPreview, nullptr);
+    EXPECT_EQ(storedPreview->getSize(), preview.getSize());
+    EXPECT_NEAR(storedPreview->getPixel(3, 3)[1], 0.5f, 1.0f / 255.0f);
+
+    // Header-only queries read a mapping directly
+    const auto bytes = ByteSource::open(path("doc.qcsx"));
+    EXPECT_TRUE(QCSXArchive::isQCSX(bytes.bytes()));
+    EXPECT_EQ(QCSXArchive::readInfo(bytes.bytes())->layerCount, 3u);
+    EXPECT_NE(QCSXArchive::readPreview(bytes.bytes()), nullptr);
+    EXPECT_FALSE(QCSXArchive::readInfo(ByteSpan(bytes.bytes()).first(100)).has_value());
+}
+
+TEST_F(QCSXArchiveTest, LoadsRegionsFromTheTilesTheyTouch) {
+    auto pixels = painted();
+    QCSXArchive archive;
+    archive.save(path("doc.qcsx"), {1100, 700}, document(pixels), nullptr, settings_);
+
+    DecodeRegion region;
+    region.rect = {200, 150, 900, 650};
+    region.scaleDenominator = 2;
+    const auto outputSize = region.outputSize(pixels->getSize());
+
+    Image expected(outputSize[0], outputSize[1]);
+    RegionDecodeSink(expected, region, pixels->getSize(), 4, RegionDecodeSink::SampleType::Float32).writeImage(*pixels);
+    Image actual(outputSize[0], outputSize[1], {1.0f, 1.0f, 1.0f, 1.0f});
+    ASSERT_TRUE(archive.loadRegion(1, region, actual));
+    for (uint32_t y = 0; y < outputSize[1]; y += 5) {
+        for (uint32_t x = 0; x < outputSize[0]; x += 5) {
+            const auto a = actual.getPixel(x, y);
+            const auto e = expected.getPixel(x, y);
+            for (int c = 0; c < 4; ++c) {
+                ASSERT_NEAR(a[c], e[c], 1e-6f) << x << ", " << y;
+            }
+        }
+    }
+    EXPECT_FALSE(archive.loadRegion(2, region, actual));
+}
+
+TEST_F(QCSXArchiveTest, SavesOverTheFileIncrementally) {
+    auto pixels = painted();
+    const size_t tiles = pixels->allocatedTileCount();
+    QCSXArchive().save(path("doc.qcsx"), {1100, 700}, document(pixels), nullptr, settings_);
+
+    // Edit one tile of the loaded layer; the other raster content is untouched
+    QCSXArchive archive(path("doc.qcsx"));
+    const uint64_t sizeBefore = archive.getInfo().fileBytes;
+    auto image = archive.loadImage(1);
+    image->setPixel(300, 300, {1.0f, 1.0f, 1.0f, 1.0f});
+
+    auto layers = document(image);
+    auto stats = archive.save(path("doc.qcsx"), {1100, 700}, layers, nullptr, settings_);
+    EXPECT_TRUE(stats.incremental);
+    EXPECT_EQ(stats.chunksWritten, 1u);
+    EXPECT_EQ(stats.chunksReused, tiles - 1);
+    EXPECT_LT(stats.bytesWritten, (sizeBefore - 128) / tiles * 2 + 4096);
+    EXPECT_EQ(archive.getInfo().generation, 2u);
+    EXPECT_LT(archive.getInfo().liveBytes, archive.getInfo().fileBytes);
+
+    // Unloaded layers keep their stored pixels without being read
+    layers[1].image = nullptr;
+    stats = archive.save(path("doc.qcsx"), {1100, 700}, layers, nullptr, settings_);
+    EXPECT_TRUE(stats.incremental);
+    EXPECT_EQ(stats.chunksWritten, 0u);
+    EXPECT_EQ(stats.chunksReused, tiles);
+
+    QCSXArchive reopened(path("doc.qcsx"));
+    EXPECT_EQ(reopened.getInfo().generation, 3u);
+    auto reloaded = reopened.loadImage(1);
+    EXPECT_EQ(reloaded->getPixel(300, 300), (Image::Pixel{1.0f, 1.0f, 1.0f, 1.0f}));
+    EXPECT_EQ(reloaded->getPixel(301, 300), pixels->getPixel(301, 300));
+
+    // Images passed to save() are what the next save compares against
+    reloaded->setPixel(10, 120, {0.0f, 1.0f, 0.0f, 1.0f});
+    stats = reopened.save(path("doc.qcsx"), {1100, 700}, document(reloaded), nullptr, settings_);
+    EXPECT_EQ(stats.chunksWritten, 1u);
+    reloaded->setPixel(650, 550, {0.0f, 0.0f, 1.0f, 1.0f});
+    stats = reopened.save(path("doc.qcsx"), {1100, 700}, document(reloaded), nullptr, settings_);
+    EXPECT_EQ(stats.chunksWritten, 1u);
+    expectSamePixels(*QCSXArchive(path("doc.qcsx")).loadImage(1), *reloaded);
+}
+
+TEST_F(QCSXArchiveTest, RewritesOnceMostlyDeadOrSavedElsewhere) {
+    auto image = painted();
+    QCSXArchive archive;
+    auto stats = archive.save(path("doc.qcsx"), {1100, 700}, document(image), nullptr, settings_);
+    const uint64_t compactSize = archive.getInfo().fileBytes;
+
+    // Repainting everything doubles the file; the next such save compacts it
+    image->clear({0.5f, 0.5f, 0.5f, 1.0f});
+    for (uint32_t y = 0; y < 700; y += 3) {
+        for (uint32_t x = 0; x < 1100; x += 3) {
+            image->setPixel(x, y, {0.1f, 0.2f, 0.3f, 1.0f});
+        }
+    }
+    stats = archive.save(path("doc.qcsx"), {1100, 700}, document(image), nullptr, settings_);
+    EXPECT_TRUE(stats.incremental);
+    image->setPixel(0, 0, {1.0f, 0.0f, 0.0f, 1.0f});
+    stats = archive.save(path("doc.qcsx"), {1100, 700}, document(image), nullptr, settings_);
+    EXPECT_FALSE(stats.incremental);
+    EXPECT_EQ(stats.chunksWritten, 1u);
+    EXPECT_EQ(stats.chunksReused, image->allocatedTileCount() - 1);
+    EXPECT_EQ(archive.getInfo().liveBytes, archive.getInfo().fileBytes);
+    EXPECT_FALSE(std::filesystem::exists(path("doc.qcsx.tmp")));
+    EXPECT_NE(archive.getInfo().fileBytes, compactSize);
+
+    // Save As copies stored chunks without recompressing them
+    stats = archive.save(path("copy.qcsx"), {1100, 700}, document(image), nullptr, settings_);
+    EXPECT_FALSE(stats.incremental);
+    EXPECT_EQ(stats.chunksWritten, 0u);
+    expectSamePixels(*QCSXArchive(path("copy.qcsx")).loadImage(1), *image);
+    expectSamePixels(*QCSXArchive(path("doc.qcsx")).loadImage(1), *image);
+}
+
+TEST_F(QCSXArchiveTest, FallsBackToThePreviousVersion) {
+    auto image = painted();
+    QCSXArchive archive;
+    archive.save(path("doc.qcsx"), {1100, 700}, document(image), nullptr, settings_);
+    const Image::Pixel original = image->getPixel(50, 150);
+    image->setPixel(50, 150, {1.0f, 1.0f, 1.0f, 1.0f});
+    archive.save(path("doc.qcsx"), {1100, 700}, document(image), nullptr, settings_);
+
+    // A torn write of the newer header slot leaves version 1 current
+    {
+        std::fstream file(path("doc.qcsx"), std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(64 + 20);
+        file.put(0x5A);
+    }
+    QCSXArchive recovered(path("doc.qcsx"));
+    EXPECT_EQ(recovered.getInfo().generation, 1u);
+    EXPECT_EQ(recovered.loadImage(1)->getPixel(50, 150), original);
+
+    // Damaged chunks are reported, not decoded
+    {
+        std::fstream file(path("doc.qcsx"), std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(200);
+        file.put(0x00);
+        file.seekp(201);
+        file.put(0x01);
+    }
+    QCSXArchive damaged(path("doc.qcsx"));
+    EXPECT_THROW(damaged.loadImage(1), std::runtime_error);
+
+    std::ofstream(path("junk.qcsx")) << "not a document";
+    EXPECT_THROW(QCSXArchive{path("junk.qcsx")}, std::runtime_error);
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/raster/raster_image.hpp"
+
+using namespace QuantumCanvas::Raster;
+
+namespace {
+
+const Image::Pixel RED = {1.0f, 0.0f, 0.0f, 1.0f};
+const Image::Pixel CLEAR = {0.0f, 0.0f, 0.0f, 0.0f};
+
+} // namespace
+
+TEST(RasterImageTest, AllocatesTilesOnlyWhereWritten) {
+    Image image(4096, 4096);
+    EXPECT_EQ(image.tileCount(), 16u * 16u);
+    EXPECT_EQ(image.allocatedTileCount(), 0u);
+
+    image.setPixel(1000, 2000, RED);
+    EXPECT_EQ(image.allocatedTileCount(), 1u);
+    EXPECT_TRUE(image.isTileAllocated(1000 / Image::TILE_SIZE, 2000 / Image::TILE_SIZE));
+    EXPECT_EQ(image.getPixel(1000, 2000), RED);
+    EXPECT_EQ(image.getPixel(1001, 2000), CLEAR);
+    EXPECT_EQ(image.getPixel(3000, 100), CLEAR);
+
+    // Writing the fill color into an empty tile stays sparse
+    image.setPixel(3000, 100, CLEAR);
+    EXPECT_EQ(image.allocatedTileCount(), 1u);
+}
+
+TEST(RasterImageTest, CopiesShareTilesUntilWritten) {
+    Image image(1024, 1024);
+    image.setPixel(10, 10, RED);
+    image.setPixel(600, 600, RED);
+
+    Image snapshot = image;
+    EXPECT_TRUE(image.isTileShared(0, 0));
+    EXPECT_EQ(image.uniqueMemoryUsage(), 0u);
+
+    image.setPixel(11, 10, RED);
+    EXPECT_FALSE(image.isTileShared(0, 0));
+    EXPECT_TRUE(image.isTileShared(2, 2));
+    EXPECT_EQ(snapshot.getPixel(11, 10), CLEAR);
+    EXPECT_EQ(snapshot.getPixel(10, 10), RED);
+    EXPECT_EQ(image.getPixel(11, 10), RED);
+}
+
+TEST(RasterImageTest, ResizeKeepsContentAndDropsCroppedPixels) {
+    Image image(512, 512);
+    image.setPixel(100, 100, RED);
+    image.setPixel(300, 100, RED);
+
+    image.resize({290, 512});
+    EXPECT_EQ(image.getSize()[0], 290u);
+    EXPECT_EQ(image.getPixel(100, 100), RED);
+    EXPECT_EQ(image.getPixel(300, 100), CLEAR);
+
+    image.resize({1024, 512});
+    EXPECT_EQ(image.getPixel(100, 100), RED);
+    EXPECT_EQ(image.getPixel(300, 100), CLEAR);
+}
+
+TEST(RasterImageTest, ClearAndCompactReleaseTiles) {
+    Image image(1024, 1024);
+    image.setPixel(10, 10, RED);
+    image.setPixel(700, 700, RED);
+    image.setPixel(700, 700, CLEAR);
+    EXPECT_EQ(image.allocatedTileCount(), 2u);
+
+    EXPECT_EQ(image.compact(), 1u);
+    EXPECT_EQ(image.allocatedTileCount(), 1u);
+    EXPECT_EQ(image.getPixel(10, 10), RED);
+
+    image.clear(RED);
+    EXPECT_EQ(image.allocatedTileCount(), 0u);
+    EXPECT_EQ(image.getPixel(700, 700), RED);
+}
+
+TEST(RasterImageTest, RegionUniformity) {
+    Image image(1024, 1024);
+    image.setPixel(300, 300, RED);
+
+    EXPECT_TRUE(image.isRegionUniform(0, 0, 256, 256));
+    EXPECT_FALSE(image.isRegionUniform(0, 0, 257, 257));
+    EXPECT_FALSE(image.isRegionUniform(-10, -10, 2000, 2000));
+    EXPECT_TRUE(image.isRegionUniform(600, 600, 5000, 5000));
+}
+
+TEST(RasterImageTest, DirtyTilesTrackWrites) {
+    Image image(600, 600);
+    EXPECT_TRUE(image.hasDirtyTiles());
+    image.clearDirtyTiles();
+    EXPECT_FALSE(image.hasDirtyTiles());
+
+    image.setPixel(520, 10, RED);
+    auto rects = image.getDirtyRects();
+    ASSERT_EQ(rects.size(), 1u);
+    EXPECT_EQ(rects[0], (std::array<uint32_t, 4>{512, 0, 600, 256}));
+
+    // Reads and no-op writes leave tiles clean
+    image.clearDirtyTiles();
+    image.getPixel(520, 10);
+    image.setPixel(10, 10, CLEAR);
+    EXPECT_FALSE(image.hasDirtyTiles());
+
+    image.clear(RED);
+    EXPECT_EQ(image.getDirtyRects().size(), image.tileCount());
+}
+
+TEST(RasterImageTest, GenerationFollowsContentChanges) {
+    Image image(512, 512);
+    image.clearDirtyTiles();
+    uint64_t generation = image.generation();
+
+    image.getPixel(10, 10);
+    image.setPixel(10, 10, CLEAR);
+    EXPECT_EQ(image.generation(), generation);
+
+    image.setPixel(10, 10, RED);
+    EXPECT_NE(image.generation(), generation);
+
+    // Once recorded, every later write is seen again
+    image.clearDirtyTiles();
+    generation = image.generation();
+    image.setPixel(11, 10, RED);
+    EXPECT_NE(image.generation(), generation);
+
+    Image copy = image;
+    EXPECT_EQ(copy.generation(), image.generation());
+}
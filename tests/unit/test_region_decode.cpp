@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/io/region_decode.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace QuantumCanvas::IO;
+using QuantumCanvas::Raster::Image;
+
+namespace {
+
+// Interleaved samples of a synthetic source
+template <typename T>
+struct Source {
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;
+    std::vector<T> samples;
+
+    Source(uint32_t w, uint32_t h, uint32_t c, T maxValue) : width(w), height(h), channels(c), samples(size_t(w) * h * c) {
+        for (uint32_t y = 0; y < h; ++y) {
+            for (uint32_t x = 0; x < w; ++x) {
+                for (uint32_t k = 0; k < c; ++k) {
+                    samples[(size_t(y) * w + x) * c + k] = static_cast<T>((x * 7 + y * 13 + k * 61) % (uint32_t(maxValue) + 1));
+                }
+            }
+        }
+    }
+    const T* at(uint32_t x, uint32_t y) const { return &samples[(size_t(y) * width + x) * channels]; }
+    size_t stride() const { return size_t(width) * channels * sizeof(T); }
+};
+
+// Mean of one channel over [x0, x1) x [y0, y1), normalized by maxValue
+template <typename T>
+float boxMean(const Source<T>& source, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1, uint32_t channel, float maxValue) {
+    double sum = 0.0;
+    for (uint32_t y = y0; y < y1; ++y) {
+        for (uint32_t x = x0; x < x1; ++x) {
+            sum += source.at(x, y)[channel];
+        }
+    }
+    return static_cast<float>(sum / (double(x1 - x0) * (y1 - y0)) / maxValue);
+}
+
+} // namespace
+
+TEST(RegionDecodeTest, CopiesRegionsAtFullScale) {
+    const Source<uint8_t> source(600, 300, 3, 255);
+    Image target(512, 512, {1.0f, 0.0f, 0.0f, 1.0f});
+
+    DecodeRegion region;
+    region.rect = {100, 50, 400, 250};
+    region.targetOrigin = {10, 20};
+    RegionDecodeSink sink(target, region, {600, 300}, 3, RegionDecodeSink::SampleType::UInt8);
+    EXPECT_EQ(sink.outputSize(), (std::array<uint32_t, 2>{300, 200}));
+    EXPECT_EQ(sink.endInputRow(), 250u);
+
+    // A sequential decoder pushing row bands, stopping after the last row needed
+    for (uint32_t y = 0; y < sink.endInputRow(); y += 16) {
+        const uint32_t rows = std::min<uint32_t>(16, source.height - y);
+        sink.writeRows(y, rows, source.at(0, y), source.stride());
+    }
+
+    for (uint32_t y : {0u, 99u, 199u}) {
+        for (uint32_t x : {0u, 150u, 299u}) {
+            const Image::Pixel pixel = target.getPixel(10 + x, 20 + y);
+            const uint8_t* expected = source.at(100 + x, 50 + y);
+            EXPECT_FLOAT_EQ(pixel[0], expected[0] / 255.0f);
+            EXPECT_FLOAT_EQ(pixel[1], expected[1] / 255.0f);
+            EXPECT_FLOAT_EQ(pixel[2], expected[2] / 255.0f);
+            EXPECT_FLOAT_EQ(pixel[3], 1.0f);
+        }
+    }
+
+    // Everything outside the output keeps the target's contents
+    EXPECT_EQ(target.getPixel(9, 20), target.fillColor());
+    EXPECT_EQ(target.getPixel(310, 20), target.fillColor());
+    EXPECT_EQ(target.getPixel(10, 220), target.fillColor());
+}
+
+TEST(RegionDecodeTest, BoxFiltersBlocksInAnyOrder) {
+    const Source<uint16_t> source(1003, 701, 4, 65535);
+    DecodeRegion region;
+    region.scaleDenominator = 8;
+    const auto outputSize = region.outputSize({1003, 701});
+    EXPECT_EQ(outputSize, (std::array<uint32_t, 2>{126, 88}));
+
+    Image target(outputSize[0], outputSize[1]);
+    RegionDecodeSink sink(target, region, {1003, 701}, 4, RegionDecodeSink::SampleType::UInt16);
+
+    // Tiles of a TIFF, written last to first
+    constexpr uint32_t BLOCK = 64;
+    for (uint32_t by = (source.height + BLOCK - 1) / BLOCK; by-- > 0;) {
+        for (uint32_t bx = (source.width + BLOCK - 1) / BLOCK; bx-- > 0;) {
+            const uint32_t x = bx * BLOCK;
+            const uint32_t y = by * BLOCK;
+            ASSERT_TRUE(sink.intersects(x, y, BLOCK, BLOCK));
+            sink.write(x, y, std::min(BLOCK, source.width - x), std::min(BLOCK, source.height - y),
+                       source.at(x, y), source.stride());
+        }
+    }
+
+    for (uint32_t oy = 0; oy < outputSize[1]; ++oy) {
+        for (uint32_t ox = 0; ox < outputSize[0]; ++ox) {
+            const uint32_t x1 = std::min(ox * 8 + 8, source.width);
+            const uint32_t y1 = std::min(oy * 8 + 8, source.height);
+            const Image::Pixel pixel = target.getPixel(ox, oy);
+            for (uint32_t c = 0; c < 4; ++c) {
+                ASSERT_NEAR(pixel[c], boxMean(source, ox * 8, oy * 8, x1, y1, c, 65535.0f), 1e-5f)
+                    << "at " << ox << "," << oy << " channel " << c;
+            }
+        }
+    }
+}
+
+TEST(RegionDecodeTest, SkipsBlocksOutsideTheRegion) {
+    Image target(64, 64);
+    DecodeRegion region;
+    region.rect = {300, 300, 500, 420};
+    region.scaleDenominator = 4;
+    RegionDecodeSink sink(target, region, {30000, 30000}, 1, RegionDecodeSink::SampleType::UInt8);
+
+    EXPECT_EQ(sink.outputSize(), (std::array<uint32_t, 2>{50, 30}));
+    EXPECT_FALSE(sink.intersects(0, 0, 256, 256));
+    EXPECT_TRUE(sink.intersects(256, 256, 256, 256));
+    EXPECT_FALSE(sink.intersects(512, 256, 256, 256));
+    EXPECT_FALSE(sink.intersects(256, 420, 256, 256));
+    EXPECT_EQ(sink.endInputRow(), 420u);
+
+    const std::vector<uint8_t> white(30000, 255);
+    sink.write(0, 0, 30000, 1, white.data(), 0);  // Entirely above the region: dropped
+    EXPECT_FLOAT_EQ(target.getPixel(0, 0)[0], 0.0f);
+    sink.write(0, 300, 30000, 120, white.data(), 0);
+    EXPECT_FLOAT_EQ(target.getPixel(0, 0)[0], 1.0f);
+    EXPECT_FLOAT_EQ(target.getPixel(49, 29)[3], 1.0f);
+    EXPECT_FLOAT_EQ(target.getPixel(50, 0)[3], 0.0f);
+}
+
+TEST(RegionDecodeTest, CodecScalingReducesTheRest) {
+    const Source<uint8_t> source(800, 600, 1, 255);
+    DecodeRegion region = DecodeRegion::forView({0, 0, 800, 600}, 0.3f);
+    ASSERT_EQ(region.scaleDenominator, 2u);
+    region.scaleDenominator = 4;
+
+    // A DCT-scaling decoder picks its largest factor dividing the request
+    const uint32_t nativeScale = DecodeRegion::nativeScaleFor(region.scaleDenominator, {1, 2, 8});
+    ASSERT_EQ(nativeScale, 2u);
+
+    Image target(200, 150);
+    RegionDecodeSink sink(target, region, {800, 600}, 1, RegionDecodeSink::SampleType::Float32, nativeScale);
+    ASSERT_EQ(sink.inputSize(), (std::array<uint32_t, 2>{400, 300}));
+
+    std::vector<float> halfRow(400);
+    for (uint32_t y = 0; y < 300; ++y) {
+        for (uint32_t x = 0; x < 400; ++x) {
+            halfRow[x] = boxMean(source, x * 2, y * 2, x * 2 + 2, y * 2 + 2, 0, 255.0f);
+        }
+        sink.writeRows(y, 1, halfRow.data(), 0);
+    }
+
+    for (uint32_t oy : {0u, 77u, 149u}) {
+        for (uint32_t ox : {0u, 101u, 199u}) {
+            EXPECT_NEAR(target.getPixel(ox, oy)[0], boxMean(source, ox * 4, oy * 4, ox * 4 + 4, oy * 4 + 4, 0, 255.0f),
+                        1e-5f);
+        }
+    }
+
+    EXPECT_EQ(DecodeRegion::scaleForZoom(1.5f), 1u);
+    EXPECT_EQ(DecodeRegion::scaleForZoom(0.5f), 2u);
+    EXPECT_EQ(DecodeRegion::scaleForZoom(1080.0f / 30000.0f), 16u);
+    EXPECT_THROW(RegionDecodeSink(target, region, {800, 600}, 1, RegionDecodeSink::SampleType::UInt8, 3),
+                 std::invalid_argument);
+    EXPECT_THROW(RegionDecodeSink(target, region, {800, 600}, 5, RegionDecodeSink::SampleType::UInt8),
+                 std::invalid_argument);
+}
+
+TEST(RegionDecodeTest, ReducesFullyDecodedImages) {
+    // Half painted, half left at the fill color
+    Image decoded(600, 300, {0.0f, 0.0f, 1.0f, 1.0f});
+    for (uint32_t y = 0; y < 300; ++y) {
+        for (uint32_t x = 0; x < 256; ++x) {
+            decoded.setPixel(x, y, {1.0f, 0.0f, 0.0f, 1.0f});
+        }
+    }
+
+    DecodeRegion region;
+    region.rect = {200, 0, 600, 300};
+    region.scaleDenominator = 112;
+    Image target(4, 3);
+    RegionDecodeSink sink(target, region, decoded.getSize(), 4, RegionDecodeSink::SampleType::Float32);
+    sink.writeImage(decoded);
+
+    // The first cell straddles the painted edge: 56 of its 112 columns are red
+    EXPECT_EQ(sink.outputSize(), (std::array<uint32_t, 2>{4, 3}));
+    EXPECT_NEAR(target.getPixel(0, 0)[0], 0.5f, 1e-5f);
+    EXPECT_NEAR(target.getPixel(0, 0)[2], 0.5f, 1e-5f);
+    EXPECT_NEAR(target.getPixel(3, 2)[2], 1.0f, 1e-5f);
+    EXPECT_NEAR(target.getPixel(3, 2)[3], 1.0f, 1e-5f);
+}
@@ -0,0 +1,662 @@
+#include <gtest/gtest.h>
+#include "../../src/core/rendering/render_graph.hpp"
+#include "../../src/core/rendering/command_list.hpp"
+#include "../../src/core/rendering/upload_ring.hpp"
+#include "../../src/core/rendering/readback_pool.hpp"
+#include "../../src/core/rendering/profiler.hpp"
+#include "../../src/core/kernel/task_scheduler.hpp"
+#include <vector>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+
+using namespace QuantumCanvas::Rendering;
+
+namespace {
+
+RGTextureDesc layer_desc(uint32_t width = 1024, uint32_t height = 1024) {
+    RGTextureDesc desc;
+    desc.width = width;
+    desc.height = height;
+    return desc;
+}
+
+// Builds the pass structure LayerCompositor produces: per layer, a chain of
+// effect passes into transients followed by a blend into the shared target
+RGResourceHandle add_layer(RenderGraph& graph, RGResourceHandle target, ResourceId content, int effects) {
+    RGResourceHandle current = graph.import_texture("content", content, layer_desc());
+
+    for (int i = 0; i < effects; ++i) {
+        RGResourceHandle input = current;
+        graph.add_pass("effect", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+            builder.read(input);
+            current = builder.create_texture("effect_output", layer_desc());
+            current = builder.write_color(current, RGLoadOp::Clear);
+        }, nullptr);
+    }
+
+    RGResourceHandle processed = current;
+    graph.add_pass("blend", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+        builder.read(processed);
+        target = builder.write_color(target);
+    }, nullptr);
+
+    return target;
+}
+
+DrawCall opaque_draw(PipelineId pipeline, ResourceId texture) {
+    DrawCall call;
+    call.pipelineId = pipeline;
+    call.vertexCount = 6;
+    call.textures = {texture};
+    return call;
+}
+
+DrawCall blended_draw(uint32_t vertexCount) {
+    DrawCall call;
+    call.pipelineId = 1;
+    call.vertexCount = vertexCount;  // Tags the draw so tests can check order
+    call.blendEnabled = true;
+    return call;
+}
+
+} // namespace
+
+TEST(RenderGraphTest, CullsUnusedPasses) {
+    RenderGraph graph;
+    RGResourceHandle target = graph.import_texture("target", 1, layer_desc());
+
+    // Writes a transient nobody reads
+    RGPassId unused = graph.add_pass("unused", RGPassType::Compute, [](RenderGraphBuilder& builder) {
+        auto scratch = builder.create_buffer("scratch", {4096, 0});
+        builder.write(scratch);
+    }, nullptr);
+
+    // Same, but flagged as having side effects
+    RGPassId readback = graph.add_pass("readback", RGPassType::Copy, [](RenderGraphBuilder& builder) {
+        auto staging = builder.create_buffer("staging", {4096, 0});
+        builder.write(staging, RGAccess::CopyDst);
+        builder.set_side_effect();
+    }, nullptr);
+
+    RGPassId draw = graph.add_pass("draw", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+        target = builder.write_color(target, RGLoadOp::Clear);
+    }, nullptr);
+
+    graph.compile();
+
+    EXPECT_TRUE(graph.is_pass_culled(unused));
+    EXPECT_FALSE(graph.is_pass_culled(readback));
+    EXPECT_FALSE(graph.is_pass_culled(draw));
+    EXPECT_EQ(graph.get_compile_stats().passesCulled, 1u);
+}
+
+TEST(RenderGraphTest, ClearedWriteDropsEarlierProducer) {
+    RenderGraph graph;
+    RGResourceHandle target = graph.import_texture("target", 1, layer_desc());
+
+    RGPassId overwritten = graph.add_pass("overwritten", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+        target = builder.write_color(target, RGLoadOp::Load);
+    }, nullptr);
+    RGPassId clear = graph.add_pass("clear", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+        target = builder.write_color(target, RGLoadOp::Clear);
+    }, nullptr);
+
+    graph.compile();
+
+    EXPECT_TRUE(graph.is_pass_culled(overwritten));
+    EXPECT_FALSE(graph.is_pass_culled(clear));
+}
+
+TEST(RenderGraphTest, MergesBlendsIntoOneRenderPass) {
+    RenderGraph graph;
+    RGResourceHandle target = graph.import_texture("target", 1, layer_desc());
+
+    graph.add_pass("clear", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+        target = builder.write_color(target, RGLoadOp::Clear);
+    }, nullptr);
+    for (ResourceId layer = 0; layer < 8; ++layer) {
+        target = add_layer(graph, target, 100 + layer, 0);
+    }
+
+    graph.compile();
+
+    const auto& stats = graph.get_compile_stats();
+    EXPECT_EQ(stats.passesCulled, 0u);
+    EXPECT_EQ(stats.passesMerged, 8u);
+    EXPECT_EQ(stats.renderPassCount, 1u);
+    EXPECT_EQ(stats.hazardSplits, 0u);
+}
+
+TEST(RenderGraphTest, AliasesTransientsAcrossLayers) {
+    const int layers = 32;
+    const int effectsPerLayer = 3;
+
+    RenderGraph graph;
+    RGResourceHandle target = graph.import_texture("target", 1, layer_desc());
+
+    for (int layer = 0; layer < layers; ++layer) {
+        target = add_layer(graph, target, 100 + layer, effectsPerLayer);
+    }
+
+    graph.compile();
+
+    const auto& stats = graph.get_compile_stats();
+    EXPECT_EQ(stats.transientResources, static_cast<uint32_t>(layers * effectsPerLayer));
+
+    // A chain only needs its input and output alive at once, and the next
+    // layer starts after the previous blend, so two allocations cover all
+    EXPECT_EQ(stats.physicalResources, 2u);
+    EXPECT_EQ(stats.transientBytesAllocated, 2 * layer_desc().estimate_size());
+    EXPECT_EQ(stats.transientBytesRequested, layers * effectsPerLayer * layer_desc().estimate_size());
+}
+
+TEST(RenderGraphTest, OutputTransientsOutliveTheirLastPass) {
+    RenderGraph graph;
+    RGResourceHandle target = graph.import_texture("target", 1, layer_desc());
+    RGResourceHandle result;
+    RGResourceHandle scratch;
+
+    graph.add_pass("produce", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+        result = builder.write_color(builder.create_texture("result", layer_desc()), RGLoadOp::Clear);
+    }, nullptr);
+    graph.mark_output(result);
+
+    // Compatible, and first used after 'result' was last touched
+    graph.add_pass("scratch", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+        scratch = builder.write_color(builder.create_texture("scratch", layer_desc()), RGLoadOp::Clear);
+    }, nullptr);
+    graph.add_pass("resolve", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+        builder.read(scratch);
+        target = builder.write_color(target);
+    }, nullptr);
+
+    graph.compile();
+
+    ASSERT_NE(graph.get_physical_slot(result), RGResourceHandle::INVALID_INDEX);
+    EXPECT_NE(graph.get_physical_slot(result), graph.get_physical_slot(scratch));
+    EXPECT_EQ(graph.get_compile_stats().physicalResources, 2u);
+}
+
+TEST(RenderGraphTest, IncompatibleTransientsDoNotAlias) {
+    RenderGraph graph;
+    RGResourceHandle target = graph.import_texture("target", 1, layer_desc());
+    RGResourceHandle small;
+    RGResourceHandle large;
+
+    graph.add_pass("small", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+        small = builder.write_color(builder.create_texture("small", layer_desc(256, 256)), RGLoadOp::Clear);
+    }, nullptr);
+    graph.add_pass("large", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+        builder.read(small);
+        large = builder.write_color(builder.create_texture("large", layer_desc(512, 512)), RGLoadOp::Clear);
+    }, nullptr);
+    graph.add_pass("resolve", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+        builder.read(large);
+        target = builder.write_color(target);
+    }, nullptr);
+
+    graph.compile();
+
+    EXPECT_NE(graph.get_physical_slot(small), graph.get_physical_slot(large));
+    EXPECT_EQ(graph.get_compile_stats().physicalResources, 2u);
+}
+
+TEST(RenderGraphTest, StateChangesEndTheRenderPass) {
+    RenderGraph graph;
+    RGResourceHandle target = graph.import_texture("target", 1, layer_desc());
+    RGResourceHandle data = graph.import_buffer("data", 2, {1 << 20, 0});
+
+    // Same attachment throughout; only the storage buffer's state differs
+    graph.add_pass("clear", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+        target = builder.write_color(target, RGLoadOp::Clear);
+    }, nullptr);
+    RGPassId generate = graph.add_pass("generate", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+        data = builder.write(data);
+        target = builder.write_color(target);
+    }, nullptr);
+    RGPassId consume = graph.add_pass("consume", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+        builder.read(data, RGAccess::StorageRead);
+        target = builder.write_color(target);
+    }, nullptr);
+    RGPassId overlay = graph.add_pass("overlay", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+        builder.read(data, RGAccess::StorageRead);
+        target = builder.write_color(target);
+    }, nullptr);
+
+    graph.compile();
+
+    // Write-to-read splits; a second read in the same state does not
+    EXPECT_TRUE(graph.is_pass_merged(generate));
+    EXPECT_FALSE(graph.is_pass_merged(consume));
+    EXPECT_TRUE(graph.is_pass_merged(overlay));
+    EXPECT_EQ(graph.get_compile_stats().hazardSplits, 1u);
+    EXPECT_EQ(graph.get_compile_stats().renderPassCount, 2u);
+}
+
+TEST(RenderGraphTest, RejectsStaleWrites) {
+    RenderGraph graph;
+    RGResourceHandle target = graph.import_texture("target", 1, layer_desc());
+    RGResourceHandle original = target;
+
+    graph.add_pass("first", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+        target = builder.write_color(target);
+    }, nullptr);
+
+    EXPECT_THROW(graph.add_pass("stale", RGPassType::Render, [&](RenderGraphBuilder& builder) {
+        builder.write_color(original);
+    }, nullptr), std::logic_error);
+}
+
+TEST(CommandListTest, SortsOpaqueDrawsByState) {
+    CommandList list;
+    for (int i = 0; i < 4; ++i) {
+        list.draw(opaque_draw(1 + i % 2, 10));
+    }
+
+    CommandListMerger merger;
+    merger.merge({&list});
+
+    const auto& commands = merger.commands();
+    ASSERT_EQ(commands.size(), 4u);
+    EXPECT_EQ(commands[0].draw->pipelineId, commands[1].draw->pipelineId);
+    EXPECT_EQ(commands[2].draw->pipelineId, commands[3].draw->pipelineId);
+    EXPECT_EQ(merger.stats().stateChanges, 2u);
+    EXPECT_EQ(merger.stats().batchedDrawCalls, 2u);
+    EXPECT_EQ(merger.stats().triangleCount, 8u);
+}
+
+TEST(CommandListTest, KeepsOrderDependentDrawsInRecordingOrder) {
+    CommandList first;
+    CommandList second;
+    ComputeDispatch dispatch;
+
+    first.draw(blended_draw(3));
+    first.draw(opaque_draw(2, 10));
+    first.draw(blended_draw(6));
+    second.dispatch(dispatch);
+    second.draw(blended_draw(9));
+    second.draw(opaque_draw(1, 10));
+
+    CommandListMerger merger;
+    merger.merge({&first, &second});
+
+    const auto& commands = merger.commands();
+    ASSERT_EQ(commands.size(), 6u);
+
+    // Compute, then sorted opaque draws, then blended draws list by list
+    EXPECT_NE(commands[0].dispatch, nullptr);
+    EXPECT_EQ(commands[1].draw->pipelineId, 1u);
+    EXPECT_EQ(commands[2].draw->pipelineId, 2u);
+    EXPECT_EQ(commands[3].draw->vertexCount, 3u);
+    EXPECT_EQ(commands[4].draw->vertexCount, 6u);
+    EXPECT_EQ(commands[5].draw->vertexCount, 9u);
+}
+
+TEST(CommandListTest, MergesListsRecordedInParallel) {
+    const int threadCount = 8;
+    const int drawsPerThread = 1000;
+
+    std::vector<std::unique_ptr<CommandList>> lists;
+    std::vector<CommandList*> listPointers;
+    for (int t = 0; t < threadCount; ++t) {
+        lists.push_back(std::make_unique<CommandList>());
+        listPointers.push_back(lists.back().get());
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < drawsPerThread; ++i) {
+                lists[t]->draw(opaque_draw(1 + (i * 7 + t) % 16, 100 + i % 4));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    QuantumCanvas::Core::TaskScheduler scheduler(4);
+    ASSERT_TRUE(scheduler.initialize());
+
+    CommandListMerger merger;
+    merger.merge(listPointers, &scheduler);
+    scheduler.shutdown();
+
+    const auto& commands = merger.commands();
+    ASSERT_EQ(commands.size(), static_cast<size_t>(threadCount * drawsPerThread));
+    for (size_t i = 1; i < commands.size(); ++i) {
+        ASSERT_LE(CommandList::compute_sort_key(*commands[i - 1].draw),
+                  CommandList::compute_sort_key(*commands[i].draw));
+    }
+
+    // 16 pipelines x 4 textures
+    EXPECT_EQ(merger.stats().stateChanges, 64u);
+}
+
+TEST(UploadRingTest, AlignsAndRefusesWhenFull) {
+    std::vector<uint8_t> memory(2 * 1024);
+    UploadRing ring;
+    ring.attach(7, memory.data(), 1024, 2);
+
+    auto first = ring.allocate(16);
+    auto second = ring.allocate(16);
+    ASSERT_TRUE(first.is_valid());
+    ASSERT_TRUE(second.is_valid());
+    EXPECT_EQ(first.buffer, 7u);
+    EXPECT_EQ(first.offset, 0u);
+    EXPECT_EQ(second.offset, UploadRing::UNIFORM_ALIGNMENT);
+
+    auto vertices = ring.allocate(100, 4);
+    ASSERT_TRUE(vertices.is_valid());
+    EXPECT_EQ(vertices.offset, UploadRing::UNIFORM_ALIGNMENT + 16);
+
+    EXPECT_FALSE(ring.allocate(1024).is_valid());
+    EXPECT_EQ(ring.overflows_this_frame(), 1u);
+}
+
+TEST(UploadRingTest, EachFrameInFlightGetsItsOwnRegion) {
+    std::vector<uint8_t> memory(3 * 1024);
+    UploadRing ring;
+    ring.attach(1, memory.data(), 1024, 3);
+
+    for (uint32_t frame = 0; frame < 6; ++frame) {
+        ring.begin_frame(frame);
+        auto allocation = ring.allocate(64);
+        ASSERT_TRUE(allocation.is_valid());
+        EXPECT_EQ(allocation.offset, (frame % 3) * 1024u);
+    }
+    EXPECT_EQ(ring.bytes_last_frame(), 64u);
+    EXPECT_EQ(ring.total_bytes(), 6 * 64u);
+}
+
+TEST(UploadRingTest, HandsOutEachAllocatedRangeOnceForWriting) {
+    std::vector<uint8_t> memory(2 * 1024);
+    UploadRing ring;
+    ring.attach(1, memory.data(), 1024, 2);
+    ring.begin_frame(1);
+
+    EXPECT_EQ(ring.take_unwritten().size, 0u);
+
+    auto first = ring.allocate(16);
+    auto second = ring.allocate(16);
+    auto range = ring.take_unwritten();
+    EXPECT_EQ(range.offset, 1024u);
+    EXPECT_EQ(range.size, UploadRing::UNIFORM_ALIGNMENT + 16);
+    EXPECT_EQ(range.data, memory.data() + first.offset);
+    EXPECT_EQ(ring.take_unwritten().size, 0u);
+
+    // A second submit in the frame writes only what came after the first
+    auto third = ring.allocate(8, 4);
+    range = ring.take_unwritten();
+    EXPECT_EQ(range.offset, second.offset + 16);
+    EXPECT_EQ(range.offset + range.size, third.offset + 8);
+
+    // The next frame's region starts over
+    ring.begin_frame(2);
+    ring.allocate(32);
+    range = ring.take_unwritten();
+    EXPECT_EQ(range.offset, 0u);
+    EXPECT_EQ(range.size, 32u);
+}
+
+TEST(UploadRingTest, ConcurrentAllocationsDoNotOverlap) {
+    const int threadCount = 8;
+    const int allocationsPerThread = 200;
+
+    std::vector<uint8_t> memory(threadCount * allocationsPerThread * UploadRing::UNIFORM_ALIGNMENT);
+    UploadRing ring;
+    ring.attach(1, memory.data(), memory.size(), 1);
+
+    std::vector<std::vector<uint64_t>> offsets(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < allocationsPerThread; ++i) {
+                auto allocation = ring.allocate(32);
+                if (allocation.is_valid()) {
+                    offsets[t].push_back(allocation.offset);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<uint64_t> all;
+    for (const auto& perThread : offsets) {
+        all.insert(all.end(), perThread.begin(), perThread.end());
+    }
+    ASSERT_EQ(all.size(), static_cast<size_t>(threadCount * allocationsPerThread));
+
+    std::sort(all.begin(), all.end());
+    for (size_t i = 1; i < all.size(); ++i) {
+        EXPECT_GE(all[i] - all[i - 1], UploadRing::UNIFORM_ALIGNMENT);
+    }
+}
+
+namespace {
+
+int unmapCount = 0;
+int releaseCount = 0;
+
+std::shared_ptr<ReadbackPool> make_readback_pool(size_t idleBudget = ReadbackPool::DEFAULT_IDLE_BUDGET) {
+    unmapCount = 0;
+    releaseCount = 0;
+    return std::make_shared<ReadbackPool>([](WGPUBuffer*) { ++unmapCount; },
+                                          [](WGPUBuffer*) { ++releaseCount; }, idleBudget);
+}
+
+// What the engine does for a 2x2 RGBA8 texture, with fake buffer handles
+Readback start_readback(ReadbackPool& pool, size_t size, uintptr_t& nextBuffer, ReadbackSlot** started = nullptr) {
+    ReadbackSlot* slot = pool.acquire(size);
+    if (!slot->buffer) {
+        slot->buffer = reinterpret_cast<WGPUBuffer*>(nextBuffer++);
+    }
+    slot->width = 2;
+    slot->height = 2;
+    slot->rowBytes = 8;
+    slot->paddedRowBytes = 256;
+    if (started) {
+        *started = slot;
+    }
+    return pool.track(slot);
+}
+
+} // namespace
+
+TEST(ReadbackPoolTest, CopiesPaddedRowsOnceMapped) {
+    auto pool = make_readback_pool();
+    uintptr_t nextBuffer = 0x1000;
+    ReadbackSlot* slot = nullptr;
+    Readback readback = start_readback(*pool, 512, nextBuffer, &slot);
+    EXPECT_EQ(slot->capacity, ReadbackPool::MIN_CAPACITY);
+
+    std::vector<uint8_t> pixels(8);
+    EXPECT_FALSE(readback.is_ready());
+    EXPECT_FALSE(readback.copy_to(pixels.data()));
+
+    std::vector<uint8_t> staging(512, 0);
+    for (uint8_t i = 0; i < 8; ++i) {
+        staging[i] = i;
+        staging[256 + i] = static_cast<uint8_t>(100 + i);
+    }
+    ReadbackPool::complete(*slot, staging.data());
+    ASSERT_TRUE(readback.succeeded());
+
+    std::vector<uint8_t> rows(2 * 16, 0xFF);
+    ASSERT_TRUE(readback.copy_to(rows.data(), 16));
+    EXPECT_EQ(rows[7], 7);
+    EXPECT_EQ(rows[8], 0xFF);
+    EXPECT_EQ(rows[16], 100);
+    EXPECT_EQ(rows[23], 107);
+}
+
+TEST(ReadbackPoolTest, ReusesBuffersBySizeClass) {
+    auto pool = make_readback_pool();
+    uintptr_t nextBuffer = 0x1000;
+    std::vector<uint8_t> staging(512);
+
+    ReadbackSlot* first = nullptr;
+    {
+        Readback readback = start_readback(*pool, 1000, nextBuffer, &first);
+        ReadbackPool::complete(*first, staging.data());
+    }
+    EXPECT_EQ(unmapCount, 1);
+    EXPECT_EQ(pool->idle_bytes(), ReadbackPool::MIN_CAPACITY);
+
+    // Same size class: the same buffer, not a new one
+    ReadbackSlot* second = nullptr;
+    Readback again = start_readback(*pool, 60000, nextBuffer, &second);
+    EXPECT_EQ(second, first);
+    EXPECT_EQ(pool->buffers_created(), 1u);
+
+    ReadbackSlot* large = nullptr;
+    Readback bigger = start_readback(*pool, 200 * 1024, nextBuffer, &large);
+    EXPECT_EQ(large->capacity, 256u * 1024);
+    EXPECT_EQ(pool->buffers_created(), 2u);
+    EXPECT_EQ(pool->pending(), 2u);
+}
+
+TEST(ReadbackPoolTest, DroppedReadbacksFinishBeforeReuse) {
+    auto pool = make_readback_pool();
+    uintptr_t nextBuffer = 0x1000;
+    std::vector<uint8_t> staging(512);
+
+    ReadbackSlot* slot = nullptr;
+    start_readback(*pool, 512, nextBuffer, &slot).reset();
+
+    // The map callback still needs the slot
+    pool->collect();
+    EXPECT_EQ(pool->idle_bytes(), 0u);
+    EXPECT_EQ(pool->pending(), 1u);
+
+    ReadbackPool::complete(*slot, staging.data());
+    pool->collect();
+    EXPECT_EQ(unmapCount, 1);
+    EXPECT_EQ(pool->pending(), 0u);
+    EXPECT_EQ(pool->idle_bytes(), ReadbackPool::MIN_CAPACITY);
+}
+
+TEST(ReadbackPoolTest, ReleasesLargestIdleBuffersOverBudget) {
+    auto pool = make_readback_pool(ReadbackPool::MIN_CAPACITY * 3);
+    uintptr_t nextBuffer = 0x1000;
+    std::vector<uint8_t> staging(512);
+
+    std::vector<Readback> readbacks;
+    std::vector<ReadbackSlot*> slots;
+    for (size_t size : {size_t(1000), size_t(2000), ReadbackPool::MIN_CAPACITY * 2}) {
+        ReadbackSlot* slot = nullptr;
+        readbacks.push_back(start_readback(*pool, size, nextBuffer, &slot));
+        ReadbackPool::complete(*slot, staging.data());
+    }
+    readbacks.clear();
+
+    // 4 units idle against a budget of 3: the 2-unit buffer goes
+    EXPECT_EQ(releaseCount, 1);
+    EXPECT_EQ(pool->idle_bytes(), ReadbackPool::MIN_CAPACITY * 2);
+    EXPECT_EQ(pool->buffer_count(), 2u);
+}
+
+TEST(ReadbackPoolTest, ShutdownFailsHeldReadbacks) {
+    auto pool = make_readback_pool();
+    uintptr_t nextBuffer = 0x1000;
+    std::vector<uint8_t> staging(512);
+
+    ReadbackSlot* slot = nullptr;
+    Readback readback = start_readback(*pool, 512, nextBuffer, &slot);
+    ReadbackPool::complete(*slot, staging.data());
+    ASSERT_TRUE(readback.succeeded());
+
+    pool->shutdown();
+    EXPECT_EQ(unmapCount, 1);
+    EXPECT_EQ(releaseCount, 1);
+    EXPECT_TRUE(readback.is_ready());
+    EXPECT_FALSE(readback.succeeded());
+
+    std::vector<uint8_t> pixels(16);
+    EXPECT_FALSE(readback.copy_to(pixels.data()));
+    readback.reset();
+    EXPECT_EQ(pool->buffer_count(), 0u);
+}
+
+TEST(ProfilerTest, DisabledScopesRecordNothing) {
+    Profiler profiler;
+    profiler.begin_frame();
+    {
+        ProfileScope scope(profiler, "ignored", "test");
+    }
+    profiler.end_frame();
+
+    EXPECT_TRUE(profiler.get_events().empty());
+}
+
+TEST(ProfilerTest, NestedScopesAndTimings) {
+    Profiler profiler;
+    profiler.set_enabled(true);
+
+    profiler.begin_frame();
+    {
+        ProfileScope outer(profiler, "outer", "test");
+        for (int i = 0; i < 3; ++i) {
+            ProfileScope inner(profiler, "inner", "test");
+        }
+    }
+    profiler.end_frame();
+
+    auto events = profiler.get_events();
+    ASSERT_EQ(events.size(), 4u);
+    for (const auto& event : events) {
+        EXPECT_EQ(event.domain, ProfileDomain::Cpu);
+        EXPECT_LE(event.beginNs, event.endNs);
+        EXPECT_EQ(event.depth, event.name == "outer" ? 0u : 1u);
+    }
+
+    auto timings = profiler.get_last_frame_timings();
+    auto inner = std::find_if(timings.begin(), timings.end(),
+                              [](const ScopeTiming& timing) { return timing.name == "inner"; });
+    ASSERT_NE(inner, timings.end());
+    EXPECT_EQ(inner->count, 3u);
+}
+
+TEST(ProfilerTest, KeepsOnlyFrameHistory) {
+    Profiler profiler(4);
+    profiler.set_enabled(true);
+
+    for (int frame = 0; frame < 10; ++frame) {
+        profiler.begin_frame();
+        {
+            ProfileScope scope(profiler, "frame_" + std::to_string(frame), "test");
+        }
+        profiler.end_frame();
+    }
+
+    auto events = profiler.get_events();
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events.front().name, "frame_6");
+    EXPECT_EQ(events.back().name, "frame_9");
+    EXPECT_EQ(profiler.get_events(2).size(), 2u);
+}
+
+TEST(ProfilerTest, ExportsChromeTrace) {
+    Profiler profiler;
+    profiler.set_enabled(true);
+
+    profiler.begin_frame();
+    std::thread worker([&profiler]() {
+        ProfileScope scope(profiler, "worker \"task\"", "test");
+    });
+    worker.join();
+    profiler.end_frame();
+
+    std::string trace = profiler.export_chrome_trace();
+    EXPECT_NE(trace.find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(trace.find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.find("worker \\\"task\\\""), std::string::npos);
+
+    // Categories and track labels survive the export through Telemetry
+    EXPECT_NE(trace.find("\"cat\":\"test\""), std::string::npos);
+    EXPECT_NE(trace.find("{\"name\":\"GPU\"}"), std::string::npos);
+}
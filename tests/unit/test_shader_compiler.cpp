@@ -3,6 +3,12 @@
 #include <memory>
 #include <fstream>
 #include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 using namespace QuantumCanvas::Rendering;
 
@@ -13,16 +19,23 @@ protected:
         // Mock device - in real tests this would be a real WGPU device
         mock_device = reinterpret_cast<WGPUDevice*>(0x1234); // Mock pointer
         
+        // Fresh disk cache, so no test warms up from another's shaders
+        cache_dir = std::filesystem::temp_directory_path() / "qcs_shader_compiler_test";
+        std::filesystem::remove_all(cache_dir);
+        compiler->set_cache_directory(cache_dir);
+        
         ASSERT_TRUE(compiler->initialize(mock_device));
     }
 
     void TearDown() override {
         compiler->shutdown();
         compiler.reset();
+        std::filesystem::remove_all(cache_dir);
     }
 
     std::unique_ptr<ShaderCompiler> compiler;
     WGPUDevice* mock_device;
+    std::filesystem::path cache_dir;
     
     // Helper to create temporary shader files
     std::filesystem::path createTempShaderFile(const std::string& content, const std::string& extension) {
@@ -36,6 +49,35 @@ protected:
         
         return shader_path;
     }
+    
+    // Runs one session that compiles desc into a disk cache at dir, then
+    // drops the pre-warm list so the next session only loads it on demand
+    void writeDiskCache(const std::filesystem::path& dir, const ShaderDescriptor& desc,
+                        uint64_t fingerprint = 0) {
+        ShaderCompiler session;
+        session.set_cache_directory(dir);
+        session.set_device_fingerprint(fingerprint);
+        ASSERT_TRUE(session.initialize(mock_device));
+        ASSERT_NE(session.compile_shader(desc), nullptr);
+        session.shutdown();
+        ASSERT_TRUE(std::filesystem::exists(session.cache_file_path()));
+        std::filesystem::remove(session.prewarm_list_path());
+    }
+    
+    static ShaderDescriptor diskCacheShader() {
+        ShaderDescriptor desc;
+        desc.stage = ShaderStage::Fragment;
+        desc.source = "@fragment fn fs_main() -> @location(0) vec4<f32> { return vec4<f32>(0.75); }";
+        desc.entry_point = "fs_main";
+        return desc;
+    }
+    
+    // Overwrites bytes of a cache file in place
+    static void patchFile(const std::filesystem::path& path, size_t offset, const std::string& bytes) {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
 };
 
 TEST_F(ShaderCompilerTest, Initialization) {
@@ -226,6 +268,208 @@ fn fs_main() -> @location(0) vec4<f32> {
     EXPECT_TRUE(compiled_shaders[1]->compilation_result().success);
 }
 
+TEST_F(ShaderCompilerTest, BatchFuturesShareDuplicateCompiles) {
+    ShaderDescriptor first;
+    first.stage = ShaderStage::Vertex;
+    first.source = "@vertex fn vs_main() -> @builtin(position) vec4<f32> { return vec4<f32>(0.5); }";
+    first.entry_point = "vs_main";
+    
+    ShaderDescriptor second = first;
+    second.source += " // second";
+    
+    auto invocations = compiler->get_stats().compiler_invocations;
+    auto futures = compiler->compile_shaders_batch({first, second, first});
+    ASSERT_EQ(futures.size(), 3u);
+    
+    auto a = futures[0].get();
+    auto b = futures[1].get();
+    auto c = futures[2].get();
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(a, c);
+    EXPECT_NE(a, b);
+    
+    // The duplicate joined the first compile or hit the cache after it
+    EXPECT_EQ(compiler->get_stats().compiler_invocations, invocations + 2);
+    EXPECT_EQ(compiler->compile_shader(first), a);
+}
+
+TEST_F(ShaderCompilerTest, ThrowingCompileReleasesWaitersAndLaterCallers) {
+    ShaderDescriptor desc;
+    desc.stage = ShaderStage::Vertex;
+    desc.source = "@vertex fn vs_main() -> @builtin(position) vec4<f32> { return undefined_call(); }";
+    desc.entry_point = "vs_main";
+    
+    // Slow enough that the second thread finds the compile in progress
+    compiler->set_error_callback([](const std::string&, const ShaderDescriptor&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        throw std::runtime_error("error callback failed");
+    });
+    
+    std::thread waiter([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        // A broken promise would surface as std::future_error instead
+        EXPECT_THROW(compiler->compile_shader(desc), std::runtime_error);
+    });
+    EXPECT_THROW(compiler->compile_shader(desc), std::runtime_error);
+    waiter.join();
+    
+    // Nothing is left pending: the next request compiles again
+    compiler->set_error_callback(nullptr);
+    auto invocations = compiler->get_stats().compiler_invocations;
+    EXPECT_EQ(compiler->compile_shader(desc), nullptr);
+    EXPECT_EQ(compiler->get_stats().compiler_invocations, invocations + 1);
+}
+
+TEST_F(ShaderCompilerTest, PrewarmCompilesLastSessionsShaders) {
+    auto session_dir = std::filesystem::temp_directory_path() / "qcs_prewarm_test";
+    std::filesystem::remove_all(session_dir);
+    
+    ShaderDescriptor desc;
+    desc.stage = ShaderStage::Fragment;
+    desc.source = "@fragment fn fs_main() -> @location(0) vec4<f32> { return vec4<f32>(0.25); }";
+    desc.entry_point = "fs_main";
+    
+    {
+        ShaderCompiler session;
+        session.set_cache_directory(session_dir);
+        ASSERT_TRUE(session.initialize(mock_device));
+        ASSERT_NE(session.compile_shader(desc), nullptr);
+        session.shutdown();
+    }
+    
+    ShaderCompiler next;
+    next.set_cache_directory(session_dir);
+    auto list = next.load_prewarm_list();
+    EXPECT_TRUE(std::any_of(list.begin(), list.end(), [&](const ShaderDescriptor& entry) {
+        return entry.source == desc.source && entry.entry_point == desc.entry_point;
+    }));
+    
+    ASSERT_TRUE(next.initialize(mock_device));
+    EXPECT_EQ(next.get_stats().shaders_prewarmed, list.size());
+    
+    // Already resident, so the first real request neither compiles nor decodes
+    auto before = next.get_stats();
+    EXPECT_NE(next.compile_shader(desc), nullptr);
+    EXPECT_EQ(next.get_stats().cache_hits, before.cache_hits + 1);
+    EXPECT_EQ(next.get_stats().compiler_invocations, before.compiler_invocations);
+    
+    next.shutdown();
+    std::filesystem::remove_all(session_dir);
+}
+
+TEST_F(ShaderCompilerTest, DiskCacheRoundTrip) {
+    auto dir = std::filesystem::temp_directory_path() / "qcs_disk_cache_test";
+    std::filesystem::remove_all(dir);
+    auto desc = diskCacheShader();
+    writeDiskCache(dir, desc);
+    
+    ShaderCompiler next;
+    next.set_cache_directory(dir);
+    ASSERT_TRUE(next.initialize(mock_device));
+    
+    auto before = next.get_stats();
+    auto shader = next.compile_shader(desc);
+    ASSERT_NE(shader, nullptr);
+    EXPECT_NE(shader->module(), nullptr);
+    EXPECT_EQ(next.get_stats().disk_cache_hits, before.disk_cache_hits + 1);
+    EXPECT_EQ(next.get_stats().compiler_invocations, before.compiler_invocations);
+    EXPECT_EQ(shader->compilation_result().bindings.size(), 
+              compiler->compile_shader(desc)->compilation_result().bindings.size());
+    
+    next.shutdown();
+    std::filesystem::remove_all(dir);
+}
+
+TEST_F(ShaderCompilerTest, DiskCacheRejectsOtherDeviceFingerprint) {
+    auto dir = std::filesystem::temp_directory_path() / "qcs_disk_cache_test";
+    std::filesystem::remove_all(dir);
+    auto desc = diskCacheShader();
+    writeDiskCache(dir, desc, 0x1111);
+    
+    ShaderCompiler next;
+    next.set_cache_directory(dir);
+    next.set_device_fingerprint(0x2222);
+    ASSERT_TRUE(next.initialize(mock_device));
+    
+    auto before = next.get_stats();
+    EXPECT_NE(next.compile_shader(desc), nullptr);
+    EXPECT_EQ(next.get_stats().disk_cache_hits, 0);
+    EXPECT_EQ(next.get_stats().compiler_invocations, before.compiler_invocations + 1);
+    
+    next.shutdown();
+    std::filesystem::remove_all(dir);
+}
+
+TEST_F(ShaderCompilerTest, DiskCacheRejectsOtherFormatOrCompilerVersion) {
+    auto dir = std::filesystem::temp_directory_path() / "qcs_disk_cache_test";
+    auto desc = diskCacheShader();
+    
+    // Header: magic[8], format version u32, entry count u32, fingerprint u64, compiler version u64
+    for (size_t offset : {size_t{8}, size_t{24}}) {
+        std::filesystem::remove_all(dir);
+        writeDiskCache(dir, desc);
+        patchFile(dir / "shader_cache.bin", offset, std::string(4, '\x7f'));
+        
+        ShaderCompiler next;
+        next.set_cache_directory(dir);
+        ASSERT_TRUE(next.initialize(mock_device));
+        
+        auto before = next.get_stats();
+        EXPECT_NE(next.compile_shader(desc), nullptr);
+        EXPECT_EQ(next.get_stats().disk_cache_hits, 0) << "header offset " << offset;
+        EXPECT_EQ(next.get_stats().compiler_invocations, before.compiler_invocations + 1);
+        next.shutdown();
+    }
+    std::filesystem::remove_all(dir);
+}
+
+TEST_F(ShaderCompilerTest, DiskCacheSurvivesTruncatedAndCorruptFiles) {
+    auto dir = std::filesystem::temp_directory_path() / "qcs_disk_cache_test";
+    auto desc = diskCacheShader();
+    
+    std::filesystem::remove_all(dir);
+    writeDiskCache(dir, desc);
+    const auto cache_path = dir / "shader_cache.bin";
+    const auto full_size = std::filesystem::file_size(cache_path);
+    
+    // Truncated inside the header, inside the index and inside the blobs,
+    // then blobs overwritten with garbage
+    std::vector<std::function<void()>> damage = {
+        [&] { std::filesystem::resize_file(cache_path, 12); },
+        [&] { std::filesystem::resize_file(cache_path, 40); },
+        [&] { std::filesystem::resize_file(cache_path, full_size - 8); },
+        [&] { patchFile(cache_path, 64, std::string(full_size - 64, '\xff')); },
+    };
+    
+    for (size_t i = 0; i < damage.size(); ++i) {
+        std::filesystem::remove_all(dir);
+        writeDiskCache(dir, desc);
+        damage[i]();
+        
+        ShaderCompiler next;
+        next.set_cache_directory(dir);
+        ASSERT_TRUE(next.initialize(mock_device)) << "damage " << i;
+        
+        // Whatever cannot be decoded is compiled again
+        auto shader = next.compile_shader(desc);
+        ASSERT_NE(shader, nullptr) << "damage " << i;
+        EXPECT_NE(shader->module(), nullptr);
+        next.shutdown();
+        std::filesystem::remove(next.prewarm_list_path());
+        
+        // The rewritten file loads cleanly
+        ShaderCompiler again;
+        again.set_cache_directory(dir);
+        ASSERT_TRUE(again.initialize(mock_device));
+        auto before = again.get_stats();
+        EXPECT_NE(again.compile_shader(desc), nullptr);
+        EXPECT_EQ(again.get_stats().disk_cache_hits, before.disk_cache_hits + 1) << "damage " << i;
+        again.shutdown();
+    }
+    std::filesystem::remove_all(dir);
+}
+
 TEST_F(ShaderCompilerTest, PipelineCreation) {
     // Create temporary shader files
     const std::string vertex_content = R"(
@@ -310,6 +554,52 @@ fn vs_main() -> @builtin(position) vec4<f32> {
     EXPECT_NE(processed.find(shader_source), std::string::npos);
 }
 
+TEST_F(ShaderCompilerTest, PermutationVariants) {
+    ShaderPermutationTemplate tmpl;
+    tmpl.name = "test_fill";
+    tmpl.stage = ShaderStage::Fragment;
+    tmpl.entry_point = "fs_main";
+    tmpl.features = {"USE_TEXTURE", "PREMULTIPLIED"};
+    tmpl.constants = {{"FILL_TYPE", 3}};
+    tmpl.source = R"(
+@fragment
+fn fs_main() -> @location(0) vec4<f32> {
+    if (USE_TEXTURE) {
+        return vec4<f32>(f32(FILL_TYPE), 0.0, 0.0, 1.0);
+    }
+    return vec4<f32>(0.0, 1.0, 0.0, 1.0);
+}
+)";
+
+    EXPECT_EQ(tmpl.key_bits(), 5u);
+    EXPECT_EQ(tmpl.feature_bit("USE_TEXTURE"), 1u);
+    EXPECT_EQ(tmpl.feature_bit("PREMULTIPLIED"), 2u);
+    EXPECT_EQ(tmpl.feature_bit("UNKNOWN"), 0u);
+    EXPECT_EQ(tmpl.constant_value("FILL_TYPE", 5), 5u << 2);
+
+    auto set = compiler->register_permutations(tmpl);
+    ASSERT_NE(set, 0u);
+
+    PermutationKey key = tmpl.feature_bit("USE_TEXTURE") | tmpl.constant_value("FILL_TYPE", 5);
+    auto desc = compiler->make_permutation_descriptor(set, key);
+    EXPECT_NE(desc.source.find("const USE_TEXTURE: bool = true;"), std::string::npos);
+    EXPECT_NE(desc.source.find("const PREMULTIPLIED: bool = false;"), std::string::npos);
+    EXPECT_NE(desc.source.find("const FILL_TYPE: u32 = 5u;"), std::string::npos);
+
+    // Lazily compiled once, then served from the variant cache
+    auto first = compiler->get_permutation(set, key);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(compiler->get_permutation(set, key).get(), first.get());
+
+    EXPECT_EQ(compiler->precompile_permutations(set, {key, 0, tmpl.feature_bit("PREMULTIPLIED")}), 3u);
+    EXPECT_EQ(compiler->get_stats().permutation_variants, 3u);
+
+    // A layout wider than the key is rejected
+    ShaderPermutationTemplate wide = tmpl;
+    wide.constants = {{"TOO_WIDE", 63}};
+    EXPECT_EQ(compiler->register_permutations(wide), 0u);
+}
+
 TEST_F(ShaderCompilerTest, ErrorCallback) {
     std::string captured_error;
     ShaderDescriptor captured_desc;
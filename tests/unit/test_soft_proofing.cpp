@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/raster/color_manager.hpp"
+#include "../../src/modules/raster/raster_image.hpp"
+
+using namespace QuantumCanvas::Raster;
+
+namespace {
+
+// Wide-gamut source proofed against sRGB, so saturated colors print out of gamut
+SoftProofingEngine makeEngine() {
+    SoftProofingEngine engine;
+    engine.setSourceProfile(ColorProfile::AdobeRGB());
+    engine.setTargetProfile(ColorProfile::sRGB());
+    engine.setDisplayProfile(ColorProfile::sRGB());
+    engine.setLUTSize(ColorLUT::MIN_SIZE);
+    return engine;
+}
+
+Image makeSource() {
+    Image image(700, 520, {0.5f, 0.5f, 0.5f, 1.0f});
+    for (uint32_t y = 0; y < 40; ++y) {
+        for (uint32_t x = 0; x < 40; ++x) {
+            image.setPixel(20 + x, 30 + y, {0.0f, 0.9f, 0.1f, 1.0f});
+            image.setPixel(600 + x, 400 + y, {0.3f, 0.4f, 0.5f, 0.5f});
+        }
+    }
+    return image;
+}
+
+void expectSameImage(const Image& a, const Image& b) {
+    ASSERT_EQ(a.getSize(), b.getSize());
+    for (uint32_t y = 0; y < a.height(); y += 7) {
+        for (uint32_t x = 0; x < a.width(); x += 7) {
+            Image::Pixel pa = a.getPixel(x, y);
+            Image::Pixel pb = b.getPixel(x, y);
+            for (int c = 0; c < 4; ++c) {
+                ASSERT_NEAR(pa[c], pb[c], 1e-6f) << x << ", " << y;
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(SoftProofingTest, IncrementalProofMatchesFullProof) {
+    SoftProofingEngine engine = makeEngine();
+    Image source = makeSource();
+    Image proof;
+    engine.generateProof(source, proof);
+
+    auto expected = engine.getProofLUT().apply({0.0f, 0.9f, 0.1f});
+    EXPECT_NEAR(proof.getPixel(30, 40)[1], expected[1], 1e-6f);
+    EXPECT_FLOAT_EQ(proof.getPixel(610, 410)[3], 0.5f);
+
+    // Painting one tile redoes only that tile; the others stay shared with
+    // the previous proof
+    Image previous = proof;
+    source.setPixel(300, 300, {1.0f, 0.0f, 0.0f, 1.0f});
+    engine.generateProof(source, proof);
+    EXPECT_NE(proof.tileData(1, 1), previous.tileData(1, 1));
+    EXPECT_EQ(proof.tileData(0, 0), previous.tileData(0, 0));
+    EXPECT_EQ(proof.tileData(2, 1), previous.tileData(2, 1));
+
+    SoftProofingEngine fresh = makeEngine();
+    Image full;
+    fresh.generateProof(source, full);
+    expectSameImage(proof, full);
+
+    // Damage limits the work when the source was rewritten in full
+    Image repainted = source;
+    repainted.mutableTileData(0, 0);
+    repainted.mutableTileData(2, 2);
+    repainted.setPixel(650, 450, {0.0f, 0.0f, 1.0f, 1.0f});
+    previous = proof;
+    SoftProofingEngine::DamageRects damage = {{640.0f, 440.0f, 660.0f, 460.0f}};
+    engine.generateProof(repainted, proof, &damage);
+    EXPECT_EQ(proof.tileData(0, 0), previous.tileData(0, 0));
+    auto blue = engine.getProofLUT().apply({0.0f, 0.0f, 1.0f});
+    EXPECT_NEAR(proof.getPixel(650, 450)[2], blue[2], 1e-6f);
+
+    // A setting change rebuilds everything
+    engine.setRenderingIntent(RenderingIntent::RelativeColorimetric);
+    engine.generateProof(repainted, proof);
+    SoftProofingEngine colorimetric = makeEngine();
+    colorimetric.setRenderingIntent(RenderingIntent::RelativeColorimetric);
+    colorimetric.generateProof(repainted, full);
+    expectSameImage(proof, full);
+}
+
+TEST(SoftProofingTest, GamutMaskCoversOnlyOutOfGamutTiles) {
+    SoftProofingEngine engine = makeEngine();
+    Image source = makeSource();
+    Image mask;
+    engine.generateGamutMask(source, mask);
+
+    EXPECT_EQ(mask.getPixel(30, 40), (Image::Pixel{1.0f, 1.0f, 1.0f, 1.0f}));
+    EXPECT_EQ(mask.getPixel(100, 100)[3], 0.0f);
+    EXPECT_EQ(mask.getPixel(610, 410)[3], 0.0f);
+    EXPECT_EQ(mask.allocatedTileCount(), 1u);
+
+    // Repainting the saturated patch in gamut clears it on the next update
+    for (uint32_t y = 0; y < 40; ++y) {
+        for (uint32_t x = 0; x < 40; ++x) {
+            source.setPixel(20 + x, 30 + y, {0.4f, 0.5f, 0.4f, 1.0f});
+        }
+    }
+    engine.generateGamutMask(source, mask);
+    EXPECT_EQ(mask.getPixel(30, 40)[3], 0.0f);
+}
+
+TEST(SoftProofingTest, IncrementalAnalysisMatchesFreshAnalysis) {
+    SoftProofingEngine engine = makeEngine();
+    Image source = makeSource();
+    auto first = engine.analyzeGamut(source);
+
+    const float total = 700.0f * 520.0f;
+    EXPECT_NEAR(first.outOfGamutPercentage, 100.0f * 1600.0f / total, 1e-3f);
+    EXPECT_NEAR(first.inGamutPercentage + first.outOfGamutPercentage, 100.0f, 1e-3f);
+    ASSERT_EQ(first.outOfGamutPixels.size(), SoftProofingEngine::MAX_PIXELS_PER_TILE);
+    EXPECT_EQ(first.outOfGamutPixels[0], (std::array<uint32_t, 2>{20, 30}));
+    EXPECT_GT(first.averageDeltaE, 0.0f);
+    EXPECT_GT(first.maxDeltaE[1], 1.0f);
+
+    for (uint32_t x = 0; x < 100; ++x) {
+        source.setPixel(300 + x, 300, {0.1f, 1.0f, 0.0f, 1.0f});
+    }
+    auto incremental = engine.analyzeGamut(source);
+    SoftProofingEngine fresh = makeEngine();
+    auto full = fresh.analyzeGamut(source);
+
+    EXPECT_GT(incremental.outOfGamutPercentage, first.outOfGamutPercentage);
+    EXPECT_FLOAT_EQ(incremental.outOfGamutPercentage, full.outOfGamutPercentage);
+    EXPECT_FLOAT_EQ(incremental.averageDeltaE, full.averageDeltaE);
+    EXPECT_EQ(incremental.maxDeltaE, full.maxDeltaE);
+    EXPECT_EQ(incremental.outOfGamutPixels, full.outOfGamutPixels);
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/vector/spatial_index.hpp"
+#include <algorithm>
+#include <random>
+
+using namespace QuantumCanvas::Vector;
+
+namespace {
+
+// The index only compares keys, so distinct addresses stand in for objects
+std::vector<SpatialIndex::Key> makeKeys(size_t count) {
+    static std::vector<char> storage;
+    storage.resize(std::max(storage.size(), count));
+    std::vector<SpatialIndex::Key> keys;
+    for (size_t i = 0; i < count; ++i) {
+        keys.push_back(reinterpret_cast<SpatialIndex::Key>(&storage[i]));
+    }
+    return keys;
+}
+
+SpatialIndex::Bounds randomBounds(std::mt19937& rng) {
+    std::uniform_real_distribution<float> position(0.0f, 10000.0f);
+    std::uniform_real_distribution<float> extent(0.0f, 60.0f);
+    float x = position(rng);
+    float y = position(rng);
+    return {x, y, x + extent(rng), y + extent(rng)};
+}
+
+bool overlaps(const SpatialIndex::Bounds& a, const SpatialIndex::Bounds& b) {
+    return a[0] <= b[2] && b[0] <= a[2] && a[1] <= b[3] && b[1] <= a[3];
+}
+
+void expectMatchesBruteForce(const SpatialIndex& index,
+                             const std::vector<SpatialIndex::Key>& keys,
+                             const std::vector<SpatialIndex::Bounds>& bounds,
+                             const std::vector<bool>& present,
+                             std::mt19937& rng) {
+    for (int q = 0; q < 50; ++q) {
+        SpatialIndex::Bounds view = randomBounds(rng);
+        view[2] += 500.0f;
+        view[3] += 300.0f;
+
+        std::vector<SpatialIndex::Key> found;
+        index.query(view, found);
+        std::vector<SpatialIndex::Key> expected;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (present[i] && overlaps(bounds[i], view)) {
+                expected.push_back(keys[i]);
+            }
+        }
+        std::sort(found.begin(), found.end());
+        std::sort(expected.begin(), expected.end());
+        ASSERT_EQ(found, expected);
+    }
+}
+
+} // namespace
+
+TEST(SpatialIndexTest, QueriesMatchBruteForce) {
+    const size_t count = 5000;
+    std::mt19937 rng(5);
+    auto keys = makeKeys(count);
+    std::vector<SpatialIndex::Bounds> bounds(count);
+    std::vector<bool> present(count, true);
+
+    SpatialIndex built;
+    SpatialIndex inserted;
+    std::vector<std::pair<SpatialIndex::Key, SpatialIndex::Bounds>> items;
+    for (size_t i = 0; i < count; ++i) {
+        bounds[i] = randomBounds(rng);
+        items.emplace_back(keys[i], bounds[i]);
+        inserted.insert(keys[i], bounds[i]);
+    }
+    built.build(items);
+    ASSERT_EQ(built.size(), count);
+    ASSERT_EQ(inserted.size(), count);
+    // SAH splits trade a level or two of balance for cheaper queries
+    EXPECT_LE(built.height(), 13u + 3u);
+    EXPECT_LE(inserted.height(), 2u * 13u + 8u);
+
+    expectMatchesBruteForce(built, keys, bounds, present, rng);
+    expectMatchesBruteForce(inserted, keys, bounds, present, rng);
+
+    // Touching borders count as overlap
+    std::vector<SpatialIndex::Key> found;
+    built.query({bounds[0][2], bounds[0][3], bounds[0][2] + 1.0f, bounds[0][3] + 1.0f}, found);
+    EXPECT_NE(std::find(found.begin(), found.end(), keys[0]), found.end());
+}
+
+TEST(SpatialIndexTest, StaysCorrectThroughEdits) {
+    const size_t count = 3000;
+    std::mt19937 rng(9);
+    auto keys = makeKeys(count);
+    std::vector<SpatialIndex::Bounds> bounds(count);
+    std::vector<bool> present(count, true);
+
+    SpatialIndex index;
+    std::vector<std::pair<SpatialIndex::Key, SpatialIndex::Bounds>> items;
+    for (size_t i = 0; i < count; ++i) {
+        bounds[i] = randomBounds(rng);
+        items.emplace_back(keys[i], bounds[i]);
+    }
+    index.build(items);
+
+    std::uniform_int_distribution<size_t> pick(0, count - 1);
+    std::uniform_real_distribution<float> nudge(-2.0f, 2.0f);
+    for (int step = 0; step < 20000; ++step) {
+        size_t i = pick(rng);
+        if (!present[i]) {
+            bounds[i] = randomBounds(rng);
+            index.insert(keys[i], bounds[i]);
+            present[i] = true;
+        } else if (step % 7 == 0) {
+            EXPECT_TRUE(index.remove(keys[i]));
+            present[i] = false;
+        } else if (step % 3 == 0) {
+            // Moves far away and so has to leave its enlarged box
+            bounds[i] = randomBounds(rng);
+            index.insert(keys[i], bounds[i]);
+        } else {
+            float dx = nudge(rng);
+            float dy = nudge(rng);
+            bounds[i] = {bounds[i][0] + dx, bounds[i][1] + dy, bounds[i][2] + dx, bounds[i][3] + dy};
+            index.insert(keys[i], bounds[i]);
+        }
+    }
+
+    size_t live = static_cast<size_t>(std::count(present.begin(), present.end(), true));
+    EXPECT_EQ(index.size(), live);
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(index.contains(keys[i]), present[i]);
+        if (present[i]) {
+            ASSERT_EQ(*index.bounds(keys[i]), bounds[i]);
+        }
+    }
+    EXPECT_LE(index.height(), 2u * 12u + 8u);
+    expectMatchesBruteForce(index, keys, bounds, present, rng);
+
+    EXPECT_FALSE(index.remove(nullptr));
+    index.clear();
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.height(), 0u);
+}
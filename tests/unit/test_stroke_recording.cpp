@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/raster/stroke_recording.hpp"
+#include <cmath>
+#include <sstream>
+
+using namespace QuantumCanvas::Raster;
+
+namespace {
+
+BrushStroke makeStroke(uint64_t id, size_t count, float phase) {
+    BrushSettings settings;
+    settings.size = 12.5f + phase;
+    settings.color = {0.2f, 0.4f, 0.6f, 1.0f};
+    settings.blendMode = BrushBlendMode::Multiply;
+    settings.dynamics.sizeFromVelocity = true;
+
+    BrushStroke stroke;
+    stroke.settings = settings;
+    stroke.strokeId = id;
+    auto start = std::chrono::system_clock::time_point(std::chrono::seconds(1700000000));
+    for (size_t i = 0; i < count; ++i) {
+        float t = static_cast<float>(i);
+        StrokePoint point;
+        point.position = {100.0f + 3.0f * t, 200.0f + 40.0f * std::sin(t * 0.05f + phase)};
+        point.pressure = 0.5f + 0.3f * std::sin(t * 0.02f);
+        point.tilt = 0.3f;
+        point.velocity = 180.0f;
+        point.timestamp = start + std::chrono::microseconds(8000 * i);
+        stroke.points.push_back(point);
+    }
+    return stroke;
+}
+
+std::vector<uint8_t> bytesOf(const std::ostringstream& out) {
+    std::string s = out.str();
+    return std::vector<uint8_t>(s.begin(), s.end());
+}
+
+void expectSameStroke(const BrushStroke& expected, const BrushStroke& actual) {
+    EXPECT_EQ(actual.strokeId, expected.strokeId);
+    EXPECT_FLOAT_EQ(actual.settings.size, expected.settings.size);
+    EXPECT_EQ(actual.settings.blendMode, expected.settings.blendMode);
+    EXPECT_EQ(actual.settings.color, expected.settings.color);
+    EXPECT_EQ(actual.settings.dynamics.sizeFromVelocity, expected.settings.dynamics.sizeFromVelocity);
+    ASSERT_EQ(actual.points.size(), expected.points.size());
+    for (size_t i = 0; i < expected.points.size(); ++i) {
+        const auto& a = actual.points[i];
+        const auto& e = expected.points[i];
+        EXPECT_NEAR(a.position[0], e.position[0], StrokeRecording::POSITION_STEP);
+        EXPECT_NEAR(a.position[1], e.position[1], StrokeRecording::POSITION_STEP);
+        EXPECT_NEAR(a.pressure, e.pressure, StrokeRecording::PRESSURE_STEP);
+        EXPECT_NEAR(a.tilt, e.tilt, StrokeRecording::ANGLE_STEP);
+        EXPECT_NEAR(a.velocity, e.velocity, StrokeRecording::VELOCITY_STEP);
+        EXPECT_EQ(std::chrono::duration_cast<std::chrono::microseconds>(a.timestamp - e.timestamp).count(), 0);
+    }
+}
+
+} // namespace
+
+TEST(StrokeRecordingTest, RoundTripsCompactly) {
+    BrushStroke stroke = makeStroke(42, 500, 0.0f);
+    std::vector<uint8_t> data = stroke.serialize();
+
+    // Far below the in-memory size of the points
+    EXPECT_LT(data.size(), stroke.points.size() * 12);
+    EXPECT_LT(data.size() * 4, stroke.points.size() * sizeof(StrokePoint));
+
+    BrushStroke decoded;
+    ASSERT_TRUE(decoded.deserialize(data));
+    expectSameStroke(stroke, decoded);
+}
+
+TEST(StrokeRecordingTest, AppendsAndReadsByIndex) {
+    std::ostringstream out(std::ios::binary);
+    std::vector<BrushStroke> strokes;
+    {
+        StrokeWriter writer(out);
+        for (uint64_t id = 1; id <= 3; ++id) {
+            strokes.push_back(makeStroke(id * 10, 50 + id * 20, static_cast<float>(id)));
+            writer.beginStroke(strokes.back().settings, strokes.back().strokeId);
+            for (const auto& point : strokes.back().points) {
+                writer.addPoint(point);
+            }
+            EXPECT_TRUE(writer.endStroke());
+        }
+        EXPECT_EQ(writer.strokesWritten(), 3u);
+        EXPECT_EQ(writer.bytesWritten(), out.str().size());
+    }
+    {
+        // A later session continues the same recording
+        StrokeWriter writer(out, true);
+        strokes.push_back(makeStroke(99, 10, 0.5f));
+        EXPECT_TRUE(writer.writeStroke(strokes.back()));
+    }
+
+    std::vector<uint8_t> data = bytesOf(out);
+    StrokeReader reader(data.data(), data.size());
+    ASSERT_TRUE(reader.isValid());
+    ASSERT_EQ(reader.strokeCount(), 4u);
+    EXPECT_EQ(reader.strokeId(3), 99u);
+
+    for (size_t i : {2u, 0u, 3u, 1u}) {
+        BrushStroke decoded;
+        ASSERT_TRUE(reader.readStroke(i, decoded));
+        expectSameStroke(strokes[i], decoded);
+    }
+    BrushStroke missing;
+    EXPECT_FALSE(reader.readStroke(4, missing));
+}
+
+TEST(StrokeRecordingTest, IgnoresTruncatedTailAndBadHeader) {
+    std::ostringstream out(std::ios::binary);
+    StrokeWriter writer(out);
+    writer.writeStroke(makeStroke(1, 40, 0.0f));
+    writer.writeStroke(makeStroke(2, 40, 1.0f));
+
+    std::vector<uint8_t> data = bytesOf(out);
+    data.resize(data.size() - 5);
+    StrokeReader reader(data.data(), data.size());
+    ASSERT_TRUE(reader.isValid());
+    EXPECT_EQ(reader.strokeCount(), 1u);
+    EXPECT_EQ(reader.strokeId(0), 1u);
+
+    data[0] = 'X';
+    StrokeReader corrupt(data.data(), data.size());
+    EXPECT_FALSE(corrupt.isValid());
+    EXPECT_EQ(corrupt.strokeCount(), 0u);
+}
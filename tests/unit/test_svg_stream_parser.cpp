@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/io/svg_stream_parser.hpp"
+#include <cmath>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+using namespace QuantumCanvas::IO;
+
+namespace {
+
+std::vector<SVGPathVerb> verbsOf(const SVGPathStore::Path& path) {
+    return std::vector<SVGPathVerb>(path.verbs.begin(), path.verbs.end());
+}
+
+std::vector<float> pointsOf(const SVGPathStore::Path& path) {
+    return std::vector<float>(path.points.begin(), path.points.end());
+}
+
+std::vector<uint8_t> gzip(const std::string& text) {
+    z_stream stream{};
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    std::vector<uint8_t> output(deflateBound(&stream, text.size()));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(text.data()));
+    stream.avail_in = static_cast<uInt>(text.size());
+    stream.next_out = output.data();
+    stream.avail_out = static_cast<uInt>(output.size());
+    deflate(&stream, Z_FINISH);
+    output.resize(stream.total_out);
+    deflateEnd(&stream);
+    return output;
+}
+
+const char* const DOCUMENT = R"(<?xml version="1.0" encoding="UTF-8"?>
+<!DOCTYPE svg PUBLIC "-//W3C//DTD SVG 1.1//EN" "http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd" [
+  <!ENTITY ns "http://www.w3.org/2000/svg">
+]>
+<!-- exported by a GIS tool -->
+<svg xmlns="http://www.w3.org/2000/svg" width="200mm" height="100" viewBox="0 0 200 100">
+  <title>Roads &amp; rivers</title>
+  <g id="layer1" class="roads">
+    <path id="r1" d="M10,20 L30 40" stroke="#000"/>
+    <polygon id="lake" points="0,0 10,0 10,10"/>
+  </g>
+  <text x="5" y="95">A &lt; B<tspan>!</tspan> &#x263A;<![CDATA[ <raw> ]]></text>
+  <rect width="20" height="10" fill='url("#grad")'/>
+</svg>
+)";
+
+} // namespace
+
+TEST(SVGStreamParserTest, TokenizesWithoutBuildingATree) {
+    SVGTokenizer tokens(R"(<a x="1" y='2'><b/>text<!-- c --><?pi?></a>)");
+
+    ASSERT_EQ(tokens.next(), SVGTokenizer::Token::StartElement);
+    EXPECT_EQ(tokens.name(), "a");
+    ASSERT_EQ(tokens.attributes().size(), 2u);
+    EXPECT_EQ(tokens.attributes()[1].name, "y");
+    EXPECT_EQ(tokens.attributes()[1].value, "2");
+
+    ASSERT_EQ(tokens.next(), SVGTokenizer::Token::StartElement);
+    EXPECT_EQ(tokens.name(), "b");
+    ASSERT_EQ(tokens.next(), SVGTokenizer::Token::EndElement);
+    EXPECT_EQ(tokens.name(), "b");
+    ASSERT_EQ(tokens.next(), SVGTokenizer::Token::Text);
+    EXPECT_EQ(tokens.text(), "text");
+    ASSERT_EQ(tokens.next(), SVGTokenizer::Token::EndElement);
+    EXPECT_EQ(tokens.name(), "a");
+    EXPECT_EQ(tokens.next(), SVGTokenizer::Token::End);
+
+    SVGTokenizer broken(R"(<a x="1></a>)");
+    EXPECT_THROW(broken.next(), std::runtime_error);
+
+    std::string decoded;
+    SVGTokenizer::decodeEntities("&lt;&#65;&#x42;&bogus;&", decoded);
+    EXPECT_EQ(decoded, "<AB&bogus;&");
+}
+
+TEST(SVGStreamParserTest, BuildsAnIndexedElementTree) {
+    const SVGElementStore svg = SVGElementStore::parseText(DOCUMENT);
+    const SVGNameTable& names = svg.names();
+
+    ASSERT_TRUE(svg.is(svg.root(), SVGNameTable::Svg));
+    EXPECT_EQ(svg.number(svg.root(), SVGNameTable::Width), 200.0f);
+    EXPECT_EQ(svg.attribute(svg.root(), SVGNameTable::ViewBox), "0 0 200 100");
+    EXPECT_EQ(svg.stats().elementCount, 8u);
+    EXPECT_EQ(svg.stats().pathCount, 2u);
+
+    // Children in document order, linked by index
+    std::vector<std::string_view> children;
+    for (uint32_t child = svg.element(svg.root()).firstChild; child != SVGElementStore::None;
+         child = svg.element(child).nextSibling) {
+        children.push_back(names.name(svg.element(child).name));
+    }
+    EXPECT_EQ(children, (std::vector<std::string_view>{"title", "g", "text", "rect"}));
+
+    const uint32_t road = svg.findById("r1");
+    ASSERT_NE(road, SVGElementStore::None);
+    EXPECT_EQ(svg.element(road).parent, svg.findById("layer1"));
+    EXPECT_EQ(svg.attribute(road, SVGNameTable::Stroke), "#000");
+    EXPECT_FALSE(svg.hasAttribute(road, SVGNameTable::Fill));
+    EXPECT_EQ(svg.findById("missing"), SVGElementStore::None);
+
+    // Unknown names are interned as they are met
+    const SVGNameTable::Id xmlns = names.find("xmlns");
+    ASSERT_NE(xmlns, SVGNameTable::None);
+    EXPECT_EQ(svg.attribute(svg.root(), xmlns), "http://www.w3.org/2000/svg");
+
+    // Text is decoded and joined across runs; tspans keep their own
+    const uint32_t text = svg.element(svg.findById("layer1")).nextSibling;
+    EXPECT_EQ(svg.element(text).text, "A < B \xE2\x98\xBA <raw> ");
+    EXPECT_EQ(svg.element(svg.element(text).firstChild).text, "!");
+    EXPECT_EQ(svg.element(svg.element(svg.root()).firstChild).text, "Roads & rivers");
+
+    const uint32_t rect = svg.element(text).nextSibling;
+    EXPECT_EQ(svg.attribute(rect, SVGNameTable::Fill), "url(\"#grad\")");
+}
+
+TEST(SVGStreamParserTest, DecodesPathDataIntoPackedCommands) {
+    const SVGElementStore svg = SVGElementStore::parseText(DOCUMENT);
+
+    const SVGPathStore::Path road = svg.path(svg.findById("r1"));
+    EXPECT_EQ(verbsOf(road), (std::vector<SVGPathVerb>{SVGPathVerb::MoveTo, SVGPathVerb::LineTo}));
+    EXPECT_EQ(pointsOf(road), (std::vector<float>{10, 20, 30, 40}));
+
+    const SVGPathStore::Path lake = svg.path(svg.findById("lake"));
+    EXPECT_EQ(verbsOf(lake), (std::vector<SVGPathVerb>{SVGPathVerb::MoveTo, SVGPathVerb::LineTo,
+                                                       SVGPathVerb::LineTo, SVGPathVerb::ClosePath}));
+    EXPECT_TRUE(svg.path(svg.root()).empty());
+
+    // Relative, shorthand and smooth commands come out absolute
+    SVGPathStore store;
+    const SVGPathStore::Path path = store.get(store.addPathData(
+        "m10 10h5v5l-5-5zM0,0c1,0 2,1 2,2s1,2 2,2Q5 0 6 0t2 0a5 5 90 0 1 10 0"));
+    EXPECT_TRUE(path.complete);
+    EXPECT_EQ(verbsOf(path), (std::vector<SVGPathVerb>{
+        SVGPathVerb::MoveTo, SVGPathVerb::LineTo, SVGPathVerb::LineTo, SVGPathVerb::LineTo, SVGPathVerb::ClosePath,
+        SVGPathVerb::MoveTo, SVGPathVerb::CurveTo, SVGPathVerb::CurveTo,
+        SVGPathVerb::QuadTo, SVGPathVerb::QuadTo, SVGPathVerb::ArcTo}));
+    EXPECT_EQ(pointsOf(path), (std::vector<float>{
+        10, 10, 15, 10, 15, 15, 10, 10,
+        0, 0, 1, 0, 2, 1, 2, 2,
+        2, 3, 3, 4, 4, 4,         // Reflected first control point
+        5, 0, 6, 0, 7, 0, 8, 0,   // Reflected quadratic control
+        18, 0, 5, 5, 90.0f * 3.14159265358979323846f / 180.0f, 0, 1}));
+}
+
+TEST(SVGStreamParserTest, KeepsPathsUpToTheirFirstError) {
+    SVGPathStore store;
+
+    // Compact numbers: "1.5.5" is 1.5 then .5, "-1-2" is -1 then -2
+    const SVGPathStore::Path compact = store.get(store.addPathData("M1.5.5L-1-2"));
+    EXPECT_EQ(pointsOf(compact), (std::vector<float>{1.5f, 0.5f, -1, -2}));
+
+    const SVGPathStore::Path broken = store.get(store.addPathData("M 0 0 L 10 10 L 20 # L 30 30"));
+    EXPECT_FALSE(broken.complete);
+    EXPECT_EQ(verbsOf(broken), (std::vector<SVGPathVerb>{SVGPathVerb::MoveTo, SVGPathVerb::LineTo}));
+
+    EXPECT_TRUE(store.get(store.addPathData("L 1 1")).empty());  // Must start with a moveto
+    EXPECT_EQ(store.get(store.addPoints("0,0 5,5 9", false)).verbs.size(), 2u);
+
+    const SVGElementStore svg = SVGElementStore::parseText(
+        R"(<svg><path d="M0 0 L"/><path d="M0 0 1 1"/></svg>)");
+    EXPECT_EQ(svg.stats().malformedPathCount, 1u);
+    EXPECT_EQ(verbsOf(svg.path(2)), (std::vector<SVGPathVerb>{SVGPathVerb::MoveTo, SVGPathVerb::LineTo}));
+}
+
+TEST(SVGStreamParserTest, RejectsMalformedDocuments) {
+    EXPECT_THROW(SVGElementStore::parseText("<svg><g></svg>"), std::runtime_error);
+    EXPECT_THROW(SVGElementStore::parseText("<svg><g>"), std::runtime_error);
+    EXPECT_THROW(SVGElementStore::parseText("<html></html>"), std::runtime_error);
+    EXPECT_THROW(SVGElementStore::parseText("<svg/><svg/>"), std::runtime_error);
+    EXPECT_THROW(SVGElementStore::parseText("<!-- only a comment -->"), std::runtime_error);
+}
+
+TEST(SVGStreamParserTest, InflatesCompressedSVG) {
+    const std::vector<uint8_t> compressed = gzip(DOCUMENT);
+    const SVGElementStore svg = SVGElementStore::parse(
+        std::make_shared<const ByteSource>(ByteSource::fromBuffer(compressed)));
+
+    EXPECT_EQ(svg.stats().bytesParsed, std::string(DOCUMENT).size());
+    EXPECT_EQ(pointsOf(svg.path(svg.findById("r1"))), (std::vector<float>{10, 20, 30, 40}));
+
+    std::vector<uint8_t> truncated(compressed.begin(), compressed.begin() + compressed.size() / 2);
+    EXPECT_THROW(SVGElementStore::parse(std::make_shared<const ByteSource>(ByteSource::fromBuffer(truncated))),
+                 std::runtime_error);
+}
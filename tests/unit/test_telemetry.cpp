@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include "../../src/core/kernel/telemetry.hpp"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace QuantumCanvas::Core;
+
+// The registry is process-wide, so every test uses metric names of its own
+
+TEST(TelemetryTest, CountersSumOverThreads) {
+    Telemetry& telemetry = Telemetry::instance();
+    const Counter counter = telemetry.counter("test.sum.items");
+    EXPECT_EQ(telemetry.counter("test.sum.items").id(), counter.id());
+
+    constexpr int THREADS = 8, ADDS = 100000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&counter] {
+            for (int i = 0; i < ADDS; ++i) {
+                counter.add();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    counter.add(5);
+
+    // Slabs of the exited threads keep what they counted
+    const auto snapshot = telemetry.snapshot();
+    const auto* value = snapshot.find_counter("test.sum.items");
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(value->value, uint64_t(THREADS) * ADDS + 5);
+
+    // A thread started afterwards takes over a finished one's slab
+    std::thread([&counter] { counter.add(10); }).join();
+    EXPECT_EQ(telemetry.snapshot().find_counter("test.sum.items")->value, uint64_t(THREADS) * ADDS + 15);
+}
+
+TEST(TelemetryTest, HistogramsBucketByBitWidth) {
+    const Histogram histogram = Telemetry::instance().histogram("test.bucket.sizes", "bytes");
+    for (uint64_t value : {0, 1, 2, 3, 100, 1000, 1000, 1000}) {
+        histogram.record(value);
+    }
+
+    const auto snapshot = Telemetry::instance().snapshot();
+    const auto* value = snapshot.find_histogram("test.bucket.sizes");
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(value->unit, "bytes");
+    EXPECT_EQ(value->count, 8u);
+    EXPECT_EQ(value->sum, 3106u);
+    EXPECT_EQ(value->buckets[0], 1u);   // 0
+    EXPECT_EQ(value->buckets[1], 1u);   // 1
+    EXPECT_EQ(value->buckets[2], 2u);   // 2-3
+    EXPECT_EQ(value->buckets[7], 1u);   // 64-127
+    EXPECT_EQ(value->buckets[10], 3u);  // 512-1023
+    EXPECT_EQ(value->quantile(0.0), 0u);
+    EXPECT_EQ(value->quantile(0.5), 3u);
+    EXPECT_EQ(value->quantile(1.0), 1023u);
+}
+
+TEST(TelemetryTest, SourcesWriteIntoSnapshots) {
+    Telemetry& telemetry = Telemetry::instance();
+    uint64_t drawn = 7;
+    auto first = telemetry.add_source("test.source", [&](MetricWriter& writer) {
+        writer.counter("drawn", drawn);
+        writer.gauge("load", 0.5);
+    });
+    auto second = telemetry.add_source("test.source", [](MetricWriter& writer) { writer.counter("drawn", 3); });
+
+    auto snapshot = telemetry.snapshot();
+    std::vector<uint32_t> instances;
+    for (const auto& counter : snapshot.counters) {
+        if (counter.name == "test.source.drawn") {
+            EXPECT_TRUE(counter.from_source);
+            instances.push_back(counter.instance);
+        }
+    }
+    EXPECT_EQ(instances, (std::vector<uint32_t>{0, 1}));
+    EXPECT_EQ(snapshot.find_counter("test.source.drawn")->value, 7u);
+    EXPECT_DOUBLE_EQ(snapshot.find_gauge("test.source.load")->value, 0.5);
+
+    // Unregistered sources drop out; their instance number is free again
+    first.reset();
+    snapshot = telemetry.snapshot();
+    EXPECT_EQ(snapshot.find_counter("test.source.drawn")->value, 3u);
+    EXPECT_EQ(snapshot.find_gauge("test.source.load"), nullptr);
+
+    auto third = telemetry.add_source("test.source", [](MetricWriter& writer) { writer.gauge("load", 1.0); });
+    EXPECT_EQ(telemetry.snapshot().find_gauge("test.source.load")->instance, 0u);
+}
+
+TEST(TelemetryTest, SpansAreCapturedAsTraceEvents) {
+    Telemetry& telemetry = Telemetry::instance();
+    telemetry.start_capture();
+    {
+        QCS_TRACE_SCOPE("test.trace.outer");
+        std::thread([] { QCS_TRACE_SCOPE("test.trace.worker"); }).join();
+        QCS_TRACE_SCOPE("test.trace.inner");
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const TraceCapture capture = telemetry.stop_capture();
+    EXPECT_FALSE(telemetry.is_capturing());
+
+    std::vector<std::string> names;
+    uint32_t outerThread = 0, workerThread = 0;
+    for (const auto& event : capture.events) {
+        const std::string& name = capture.span_names.at(event.span);
+        if (name.rfind("test.trace.", 0) != 0) {
+            continue;
+        }
+        names.push_back(name);
+        (name == "test.trace.worker" ? workerThread : outerThread) = event.thread;
+        if (name == "test.trace.inner") {
+            EXPECT_GE(event.duration_ns, 1000000u);
+        }
+    }
+    EXPECT_EQ(names, (std::vector<std::string>{"test.trace.outer", "test.trace.worker", "test.trace.inner"}));
+    EXPECT_NE(outerThread, workerThread);
+
+    // Spans fill their histograms whether or not a capture runs
+    { QCS_TRACE_SCOPE("test.trace.outer"); }
+    const auto snapshot = telemetry.snapshot();
+    const auto* outer = snapshot.find_histogram("test.trace.outer");
+    ASSERT_NE(outer, nullptr);
+    EXPECT_EQ(outer->count, 2u);
+    EXPECT_EQ(outer->unit, "ns");
+
+    const std::string json = to_chrome_trace(capture);
+    EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("\"name\":\"test.trace.inner\",\"cat\":\"test\",\"ph\":\"X\""), std::string::npos);
+}
+
+TEST(TelemetryTest, FullTraceRingsKeepTheNewestEvents) {
+    Telemetry& telemetry = Telemetry::instance();
+    const Histogram span = telemetry.span("test.ring.step");
+    telemetry.start_capture(4);
+    for (int i = 0; i < 10; ++i) {
+        TraceSpan scope(span);
+    }
+    const TraceCapture capture = telemetry.stop_capture();
+
+    size_t kept = 0;
+    for (const auto& event : capture.events) {
+        kept += event.span == span.id();
+    }
+    EXPECT_EQ(kept, 4u);
+    EXPECT_GE(capture.dropped, 6u);
+}
+
+TEST(TelemetryTest, DisabledUpdatesAreDropped) {
+    const Counter counter = Telemetry::instance().counter("test.disabled.items");
+    counter.add(2);
+    Telemetry::set_enabled(false);
+    counter.add(100);
+    { QCS_TRACE_SCOPE("test.disabled.span"); }
+    Telemetry::set_enabled(true);
+
+    const auto snapshot = Telemetry::instance().snapshot();
+    EXPECT_EQ(snapshot.find_counter("test.disabled.items")->value, 2u);
+    EXPECT_EQ(snapshot.find_histogram("test.disabled.span")->count, 0u);
+
+    // Unregistered handles are inert
+    Counter().add();
+    Histogram().record(1);
+}
+
+TEST(TelemetryTest, ExportsPrometheusText) {
+    Telemetry& telemetry = Telemetry::instance();
+    telemetry.counter("test.prom.files-read").add(3);
+    telemetry.span("test.prom.load").record(5);
+    auto first = telemetry.add_source("test.prom.pool", [](MetricWriter& writer) { writer.gauge("depth", 2); });
+    auto second = telemetry.add_source("test.prom.pool", [](MetricWriter& writer) { writer.gauge("depth", 4); });
+
+    const std::string text = to_prometheus(telemetry.snapshot());
+    EXPECT_NE(text.find("# TYPE qcs_test_prom_files_read_total counter\nqcs_test_prom_files_read_total 3\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("# TYPE qcs_test_prom_pool_depth gauge\n"
+                        "qcs_test_prom_pool_depth{instance=\"0\"} 2\n"
+                        "qcs_test_prom_pool_depth{instance=\"1\"} 4\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("# TYPE qcs_test_prom_load_nanoseconds histogram\n"), std::string::npos);
+    EXPECT_NE(text.find("qcs_test_prom_load_nanoseconds_bucket{le=\"3\"} 0\n"
+                        "qcs_test_prom_load_nanoseconds_bucket{le=\"7\"} 1\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("qcs_test_prom_load_nanoseconds_bucket{le=\"+Inf\"} 1\n"
+                        "qcs_test_prom_load_nanoseconds_sum 5\n"
+                        "qcs_test_prom_load_nanoseconds_count 1\n"),
+              std::string::npos);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/vector/tessellation_cache.hpp"
+#include "../../src/modules/vector/vector_renderer.hpp"
+#include <atomic>
+#include <cmath>
+
+using namespace QuantumCanvas::Vector;
+
+namespace {
+
+// Finer tolerances give more vertices, like a real curve
+std::shared_ptr<TessellatedPath> makeMesh(float tolerance, size_t scale = 1) {
+    auto mesh = std::make_shared<TessellatedPath>();
+    size_t vertices = scale * static_cast<size_t>(std::ceil(16.0f / tolerance));
+    mesh->vertices.resize(vertices);
+    mesh->vertices.shrink_to_fit();
+    mesh->triangleCount = static_cast<uint32_t>(vertices);
+    return mesh;
+}
+
+} // namespace
+
+TEST(TessellationCacheTest, QuantisesToleranceIntoLevels) {
+    EXPECT_EQ(TessellationCache::lod_level(1.0f), 0);
+    EXPECT_EQ(TessellationCache::lod_level(0.5f), -TessellationCache::LEVELS_PER_OCTAVE);
+    EXPECT_EQ(TessellationCache::lod_level(0.26f), TessellationCache::lod_level(0.3f));
+
+    for (float tolerance : {0.013f, 0.25f, 0.3f, 1.0f, 7.5f}) {
+        float level = TessellationCache::level_tolerance(TessellationCache::lod_level(tolerance));
+        EXPECT_LE(level, tolerance * 1.0001f);
+        EXPECT_GT(level, tolerance / std::exp2(1.0f / TessellationCache::LEVELS_PER_OCTAVE) * 0.9999f);
+    }
+}
+
+TEST(TessellationCacheTest, ShowsNearestLevelWhileRetessellating) {
+    TessellationCache cache;
+    std::atomic<int> calls{0};
+    auto tessellate = [&calls](float tolerance) {
+        calls++;
+        return makeMesh(tolerance);
+    };
+
+    // Nothing cached: tessellated on the spot
+    auto first = cache.acquire(7, 1.0f, tessellate);
+    ASSERT_TRUE(first.tessellation);
+    EXPECT_TRUE(first.exact);
+    EXPECT_EQ(calls.load(), 1);
+    EXPECT_EQ(cache.acquire(7, 1.1f, tessellate).tessellation, first.tessellation);
+
+    // Zooming in shows the coarse mesh until the fine one lands
+    auto zoomed = cache.acquire(7, 0.1f, tessellate);
+    EXPECT_FALSE(zoomed.exact);
+    EXPECT_EQ(zoomed.level, first.level);
+    EXPECT_EQ(zoomed.tessellation, first.tessellation);
+    cache.wait_idle();
+    EXPECT_EQ(calls.load(), 2);
+
+    auto fine = cache.acquire(7, 0.1f, tessellate);
+    EXPECT_TRUE(fine.exact);
+    EXPECT_EQ(fine.level, TessellationCache::lod_level(0.1f));
+    EXPECT_GT(fine.tessellation->vertices.size(), first.tessellation->vertices.size());
+
+    // Between the two, the nearer level stands in
+    auto between = cache.acquire(7, 0.15f, tessellate);
+    EXPECT_EQ(between.level, fine.level);
+    cache.wait_idle();
+
+    auto stats = cache.get_stats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.nearest_hits, 2u);
+    EXPECT_EQ(stats.scheduled, 2u);
+    EXPECT_EQ(cache.entry_count(), 3u);
+}
+
+TEST(TessellationCacheTest, EvictsLeastRecentlyUsedByBytes) {
+    const size_t meshBytes = tessellation_bytes(*makeMesh(1.0f));
+    TessellationCache cache(meshBytes * 3);
+    for (uint64_t id = 1; id <= 3; ++id) {
+        cache.insert(id, 0, makeMesh(1.0f));
+    }
+    EXPECT_EQ(cache.bytes_used(), meshBytes * 3);
+
+    // Touching path 1 makes path 2 the oldest
+    EXPECT_TRUE(cache.find(1, 0));
+    cache.insert(4, 0, makeMesh(1.0f));
+    EXPECT_FALSE(cache.find(2, 0));
+    EXPECT_TRUE(cache.find(1, 0));
+    EXPECT_TRUE(cache.find(3, 0));
+    EXPECT_EQ(cache.get_stats().evictions, 1u);
+
+    // One mesh over budget on its own is still kept
+    cache.insert(5, 0, makeMesh(1.0f, 10));
+    EXPECT_TRUE(cache.find(5, 0));
+    EXPECT_EQ(cache.entry_count(), 1u);
+
+    cache.set_byte_budget(0);
+    EXPECT_EQ(cache.entry_count(), 0u);
+    EXPECT_EQ(cache.bytes_used(), 0u);
+}
+
+TEST(TessellationCacheTest, InvalidateDropsEveryLevel) {
+    TessellationCache cache;
+    auto tessellate = [](float tolerance) { return makeMesh(tolerance); };
+    cache.acquire(3, 1.0f, tessellate);
+    cache.acquire(3, 0.25f, tessellate);   // Scheduled
+    cache.invalidate(3);
+    cache.wait_idle();
+
+    EXPECT_FALSE(cache.find(3, TessellationCache::lod_level(1.0f)));
+    EXPECT_FALSE(cache.find(3, TessellationCache::lod_level(0.25f)));
+    EXPECT_EQ(cache.bytes_used(), 0u);
+    EXPECT_TRUE(cache.acquire(3, 0.25f, tessellate).exact);
+}
@@ -0,0 +1,318 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/io/thumbnail_pipeline.hpp"
+#include "../../src/modules/io/parallel_encoders.hpp"
+#include "../../src/core/kernel/task_scheduler.hpp"
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace QuantumCanvas::IO;
+using QuantumCanvas::Core::TaskScheduler;
+using QuantumCanvas::Raster::Image;
+
+namespace {
+
+// A fresh directory in the temp directory, removed with its contents
+class TempDirectory {
+public:
+    explicit TempDirectory(const std::string& name) : path_(std::filesystem::temp_directory_path() / name) {
+        std::filesystem::remove_all(path_);
+        std::filesystem::create_directories(path_);
+    }
+    ~TempDirectory() {
+        std::error_code error;
+        std::filesystem::remove_all(path_, error);
+    }
+    const std::filesystem::path& path() const { return path_; }
+
+    std::filesystem::path write(const std::string& name, const std::vector<uint8_t>& contents) const {
+        std::ofstream file(path_ / name, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+        return path_ / name;
+    }
+
+private:
+    std::filesystem::path path_;
+};
+
+Image solid(uint32_t width, uint32_t height, const Image::Pixel& color) {
+    Image image(width, height);
+    image.clear(color);
+    return image;
+}
+
+void put16(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void put32(std::vector<uint8_t>& out, uint32_t value) {
+    put16(out, value & 0xFFFF);
+    put16(out, value >> 16);
+}
+
+// A JPEG with an EXIF APP1 segment whose IFD1 holds the given thumbnail
+std::vector<uint8_t> withExifThumbnail(const std::vector<uint8_t>& jpeg, const std::vector<uint8_t>& thumbnail) {
+    std::vector<uint8_t> tiff = {'I', 'I', 42, 0};
+    put32(tiff, 8);   // IFD0: no entries, then IFD1
+    put16(tiff, 0);
+    put32(tiff, 14);
+    put16(tiff, 2);   // IFD1
+    for (uint32_t tag : {0x0201u, 0x0202u}) {
+        put16(tiff, tag);
+        put16(tiff, 4);
+        put32(tiff, 1);
+        put32(tiff, tag == 0x0201 ? 14 + 2 + 24 + 4 : static_cast<uint32_t>(thumbnail.size()));
+    }
+    put32(tiff, 0);
+    tiff.insert(tiff.end(), thumbnail.begin(), thumbnail.end());
+
+    std::vector<uint8_t> out(jpeg.begin(), jpeg.begin() + 2);
+    const size_t length = 2 + 6 + tiff.size();
+    out.insert(out.end(), {0xFF, 0xE1, static_cast<uint8_t>(length >> 8), static_cast<uint8_t>(length)});
+    out.insert(out.end(), {'E', 'x', 'i', 'f', 0, 0});
+    out.insert(out.end(), tiff.begin(), tiff.end());
+    out.insert(out.end(), jpeg.begin() + 2, jpeg.end());
+    return out;
+}
+
+// An R2000 drawing header pointing at a preview section holding an 8-bit DIB
+std::vector<uint8_t> drawingWithPreview(uint32_t width, uint32_t height) {
+    std::vector<uint8_t> dib;
+    put32(dib, 40);
+    put32(dib, width);
+    put32(dib, height);  // Bottom-up
+    put16(dib, 1);
+    put16(dib, 8);
+    put32(dib, 0);
+    put32(dib, 0);
+    put32(dib, 0);
+    put32(dib, 0);
+    put32(dib, 2);
+    put32(dib, 0);
+    dib.insert(dib.end(), {0, 0, 0, 0, 255, 128, 0, 0});  // Black, then BGR for RGB (0, 128, 255)
+    const size_t stride = (width + 3) / 4 * 4;
+    for (uint32_t row = 0; row < height; ++row) {
+        // Bottom-up: the last row stored is the top one, drawn in palette entry 1
+        for (size_t x = 0; x < stride; ++x) {
+            dib.push_back(row + 1 == height ? 1 : 0);
+        }
+    }
+
+    std::vector<uint8_t> dwg = {'A', 'C', '1', '0', '1', '5'};
+    dwg.resize(0x0D, 0);
+    put32(dwg, 0x40);
+    dwg.resize(0x40, 0);
+    dwg.insert(dwg.end(), {0x1F, 0x25, 0x6D, 0x07, 0xD4, 0x36, 0x28, 0x28,
+                           0x9D, 0x57, 0xCA, 0x3F, 0x9D, 0x44, 0x10, 0x2B});
+    put32(dwg, static_cast<uint32_t>(dib.size() + 10));
+    dwg.push_back(1);
+    dwg.push_back(2);  // BMP
+    put32(dwg, 0x40 + 16 + 4 + 1 + 9);
+    put32(dwg, static_cast<uint32_t>(dib.size()));
+    dwg.insert(dwg.end(), dib.begin(), dib.end());
+    return dwg;
+}
+
+} // namespace
+
+TEST(ThumbnailPipelineTest, CacheStoresByContentAndEvicts) {
+    TempDirectory directory("qcs_thumbnail_cache_test");
+    const std::vector<uint8_t> contents(100000, 7);
+    std::vector<uint8_t> edited = contents;
+    edited[4321] ^= 1;
+    const uint64_t hash = ThumbnailCache::contentHash(contents);
+    EXPECT_EQ(hash, ThumbnailCache::contentHash(std::vector<uint8_t>(100000, 7)));
+    EXPECT_NE(hash, ThumbnailCache::contentHash(edited));
+    EXPECT_NE(hash, ThumbnailCache::contentHash(ByteSpan(contents).first(99999)));
+
+    // Large files hash samples, which still cover both ends
+    std::vector<uint8_t> large(20 * 1024 * 1024, 1);
+    const uint64_t largeHash = ThumbnailCache::contentHash(large);
+    large.back() = 2;
+    EXPECT_NE(largeHash, ThumbnailCache::contentHash(large));
+
+    {
+        ThumbnailCache cache(directory.path());
+        EXPECT_EQ(cache.find(hash, {256, 256}), nullptr);
+        cache.store(hash, {256, 256}, solid(200, 100, {1.0f, 0.5f, 0.0f, 1.0f}));
+        auto found = cache.find(hash, {256, 256});
+        ASSERT_NE(found, nullptr);
+        EXPECT_EQ(found->getSize(), (std::array<uint32_t, 2>{200, 100}));
+        EXPECT_NEAR(found->getPixel(10, 10)[1], 0.5f, 1.0f / 255.0f);
+        EXPECT_EQ(cache.find(hash, {128, 128}), nullptr);  // Sizes are separate entries
+    }
+
+    // A later session finds the entry; a damaged one is dropped
+    ThumbnailCache reopened(directory.path(), 1);
+    EXPECT_EQ(reopened.entryCount(), 0u);  // Over the one-byte budget on open
+    ThumbnailCache cache(directory.path());
+    cache.store(hash, {64, 64}, solid(64, 64, {0.0f, 0.0f, 1.0f, 1.0f}));
+    ASSERT_EQ(cache.entryCount(), 1u);
+    for (const auto& item : std::filesystem::directory_iterator(directory.path())) {
+        std::filesystem::resize_file(item.path(), 20);
+    }
+    EXPECT_EQ(cache.find(hash, {64, 64}), nullptr);
+    EXPECT_EQ(cache.entryCount(), 0u);
+    EXPECT_EQ(cache.diskUsage(), 0u);
+
+    // Least recently used entries go first; the budget holds two entries
+    auto noise = [](uint64_t seed) {
+        Image image(40, 40);
+        uint32_t state = static_cast<uint32_t>(seed) * 2654435761u;
+        for (uint32_t i = 0; i < 1600; ++i) {
+            state = state * 1664525u + 1013904223u;
+            image.setPixel(i % 40, i / 40, {float(state >> 24) / 255.0f, 0.0f, 0.0f, 1.0f});
+        }
+        return image;
+    };
+    cache.store(99, {64, 64}, noise(99));
+    const uint64_t entryBytes = cache.diskUsage();
+    cache.clear();
+
+    ThumbnailCache small(directory.path(), entryBytes * 5 / 2);
+    for (uint64_t key = 1; key <= 6; ++key) {
+        small.store(key, {64, 64}, noise(key));
+        if (key >= 2) {
+            ASSERT_NE(small.find(1, {64, 64}), nullptr) << key;  // Kept fresh by use
+        }
+    }
+    EXPECT_LE(small.diskUsage(), entryBytes * 5 / 2);
+    EXPECT_EQ(small.entryCount(), 2u);
+    EXPECT_NE(small.find(6, {64, 64}), nullptr);
+    EXPECT_EQ(small.find(2, {64, 64}), nullptr);
+}
+
+TEST(ThumbnailPipelineTest, UsesEmbeddedExifThumbnails) {
+    TempDirectory directory("qcs_thumbnail_exif_test");
+    const std::vector<uint8_t> mainImage = ParallelEncoders::encodeJPEG(solid(1600, 1200, {0.0f, 0.0f, 1.0f, 1.0f}));
+    const std::vector<uint8_t> preview = ParallelEncoders::encodeJPEG(solid(160, 120, {1.0f, 0.0f, 0.0f, 1.0f}));
+    const std::vector<uint8_t> jpeg = withExifThumbnail(mainImage, preview);
+    const auto path = directory.write("photo.jpg", jpeg);
+
+    auto found = EmbeddedPreview::findExifThumbnail(jpeg);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->size(), preview.size());
+
+    ThumbnailPipeline pipeline(std::make_shared<ThumbnailCache>(directory.path() / "cache"), {});
+    ThumbnailPipeline::Source source;
+    auto thumbnail = pipeline.generate(path, {256, 256}, &source);
+    ASSERT_NE(thumbnail, nullptr);
+    EXPECT_EQ(source, ThumbnailPipeline::Source::EmbeddedPreview);
+    EXPECT_EQ(thumbnail->getSize(), (std::array<uint32_t, 2>{160, 120}));
+    EXPECT_GT(thumbnail->getPixel(80, 60)[0], 0.9f);
+
+    thumbnail = pipeline.generate(path, {256, 256}, &source);
+    EXPECT_EQ(source, ThumbnailPipeline::Source::Cache);
+    EXPECT_GT(thumbnail->getPixel(80, 60)[0], 0.9f);
+
+    // Too small for a larger thumbnail: the photo is decoded at half scale instead
+    thumbnail = pipeline.generate(path, {512, 512}, &source);
+    ASSERT_NE(thumbnail, nullptr);
+    EXPECT_EQ(source, ThumbnailPipeline::Source::ReducedDecode);
+    EXPECT_EQ(thumbnail->getSize(), (std::array<uint32_t, 2>{512, 384}));
+    EXPECT_GT(thumbnail->getPixel(256, 192)[2], 0.9f);
+
+    auto reduced = EmbeddedPreview::decodeJPEG(mainImage, {300, 200});
+    ASSERT_NE(reduced, nullptr);
+    EXPECT_EQ(reduced->getSize(), (std::array<uint32_t, 2>{400, 300}));
+
+    const auto stats = pipeline.getStats();
+    EXPECT_EQ(stats.embeddedPreviews, 1u);
+    EXPECT_EQ(stats.cacheHits, 1u);
+    EXPECT_EQ(stats.reducedDecodes, 1u);
+}
+
+TEST(ThumbnailPipelineTest, ReadsDrawingPreviews) {
+    TempDirectory directory("qcs_thumbnail_dwg_test");
+    const std::vector<uint8_t> drawing = drawingWithPreview(181, 120);
+    auto preview = EmbeddedPreview::findDWGPreview(drawing);
+    ASSERT_TRUE(preview.has_value());
+    EXPECT_EQ(preview->type, EmbeddedPreview::DWGPreview::Type::BMP);
+
+    auto image = EmbeddedPreview::decodeDIB(preview->data);
+    ASSERT_NE(image, nullptr);
+    EXPECT_EQ(image->getSize(), (std::array<uint32_t, 2>{181, 120}));
+    EXPECT_NEAR(image->getPixel(5, 0)[1], 128.0f / 255.0f, 1e-5f);
+    EXPECT_NEAR(image->getPixel(5, 0)[2], 1.0f, 1e-5f);
+    EXPECT_FLOAT_EQ(image->getPixel(5, 1)[2], 0.0f);
+
+    ThumbnailPipeline pipeline(nullptr, {});
+    ThumbnailPipeline::Source source;
+    auto thumbnail = pipeline.generate(directory.write("plan.dwg", drawing), {128, 128}, &source);
+    ASSERT_NE(thumbnail, nullptr);
+    EXPECT_EQ(source, ThumbnailPipeline::Source::EmbeddedPreview);
+    EXPECT_EQ(thumbnail->getSize(), (std::array<uint32_t, 2>{128, 85}));
+
+    // Not a drawing, no stages: nothing to show
+    EXPECT_EQ(pipeline.generate(directory.write("notes.txt", {'h', 'i'}), {128, 128}, &source), nullptr);
+    EXPECT_EQ(source, ThumbnailPipeline::Source::None);
+    EXPECT_EQ(pipeline.getStats().failures, 1u);
+}
+
+TEST(ThumbnailPipelineTest, FitsWithinTheRequestedSize) {
+    Image wide = solid(1000, 500, {0.2f, 0.4f, 0.6f, 1.0f});
+    auto fitted = ThumbnailPipeline::fit(wide, {256, 256});
+    EXPECT_EQ(fitted->getSize(), (std::array<uint32_t, 2>{256, 128}));
+    EXPECT_NEAR(fitted->getPixel(100, 100)[2], 0.6f, 1e-5f);
+
+    fitted = ThumbnailPipeline::fit(wide, {500, 500});  // Exactly half: box filter only
+    EXPECT_EQ(fitted->getSize(), (std::array<uint32_t, 2>{500, 250}));
+    EXPECT_EQ(ThumbnailPipeline::fit(wide, {2000, 2000})->getSize(), wide.getSize());
+}
+
+TEST(ThumbnailPipelineTest, PrefetchReplacesQueuedRequests) {
+    TempDirectory directory("qcs_thumbnail_prefetch_test");
+    TaskScheduler scheduler(2);
+    ASSERT_TRUE(scheduler.initialize());
+    auto shared = std::shared_ptr<TaskScheduler>(&scheduler, [](TaskScheduler*) {});
+
+    std::vector<std::filesystem::path> first;
+    std::vector<std::filesystem::path> second;
+    for (int i = 0; i < 20; ++i) {
+        first.push_back(directory.write("old" + std::to_string(i) + ".bin", {uint8_t(i)}));
+    }
+    for (int i = 0; i < 3; ++i) {
+        second.push_back(directory.write("new" + std::to_string(i) + ".bin", {uint8_t(100 + i)}));
+    }
+
+    // The decoder holds the first files until the list has scrolled on
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> decodes{0};
+    ThumbnailPipeline::Stages stages;
+    stages.reducedDecode = [&](const std::shared_ptr<const ByteSource>&, const std::array<uint32_t, 2>&) {
+        released.wait();
+        decodes++;
+        return std::make_shared<Image>(solid(300, 300, {0.0f, 1.0f, 0.0f, 1.0f}));
+    };
+
+    {
+        ThumbnailPipeline pipeline(nullptr, stages, shared);
+        std::mutex readyMutex;
+        std::set<std::string> ready;
+        auto onReady = [&](const std::filesystem::path& path, std::shared_ptr<Image> thumbnail) {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            EXPECT_NE(thumbnail, nullptr);
+            ready.insert(path.filename().string());
+        };
+
+        pipeline.prefetch(first, {64, 64}, onReady);
+        pipeline.prefetch(second, {64, 64}, onReady);
+        release.set_value();
+        pipeline.waitForPrefetch();
+
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_EQ(ready.count("new" + std::to_string(i) + ".bin"), 1u);
+        }
+        EXPECT_GE(pipeline.getStats().prefetchesDropped, 18u);
+        EXPECT_LE(decodes.load(), 5);
+    }
+    scheduler.shutdown();
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "../../src/modules/vector/vector_renderer.hpp"
+#include "../../src/modules/vector/fill_tessellation.hpp"
+#include <array>
+#include <memory>
+#include <vector>
+
+using namespace QuantumCanvas::Vector;
+
+namespace {
+
+constexpr std::array<float, 6> IDENTITY = {1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+
+void addPolygon(FillCurveBuilder& builder, const std::vector<FillCurveBuilder::Point>& points) {
+    builder.begin_path();
+    builder.move_to(points[0]);
+    for (size_t i = 1; i < points.size(); ++i) {
+        builder.line_to(points[i]);
+    }
+    builder.close_path();
+    builder.end_path();
+}
+
+class VectorRendererTest : public ::testing::Test {
+protected:
+    QuantumCanvas::Rendering::RenderingEngine engine;
+};
+
+} // namespace
+
+TEST_F(VectorRendererTest, TessellatesOneResultPerPath) {
+    FillCurveBuilder builder(0.25f);
+    addPolygon(builder, {{0, 0}, {20, 0}, {20, 10}, {10, 10}, {10, 20}, {0, 20}});
+    addPolygon(builder, {{0, 0}, {10, 0}, {10, 10}, {0, 10}});
+    builder.begin_path();
+    builder.end_path();
+
+    // Without a GPU both come back as CPU triangles: the L triangulated,
+    // the square fanned
+    GPUTessellator tessellator(engine);
+    auto fills = tessellator.tessellate_fills(builder);
+    ASSERT_EQ(fills.size(), 3u);
+    EXPECT_FALSE(fills[0]->isConvex);
+    EXPECT_FALSE(fills[0]->indices.empty());
+    EXPECT_TRUE(fills[1]->isConvex);
+    EXPECT_EQ(fills[1]->vertices.size(), size_t(fills[1]->triangleCount) * 3);
+    EXPECT_EQ(fills[1]->bounds, (std::array<float, 4>{0, 0, 10, 10}));
+    EXPECT_EQ(fills[2]->triangleCount, 0u);
+}
+
+TEST_F(VectorRendererTest, TessellatedFillsReachASubmittedDraw) {
+    FillCurveBuilder builder(0.25f);
+    addPolygon(builder, {{0, 0}, {20, 0}, {20, 10}, {10, 10}, {10, 20}, {0, 20}});
+    addPolygon(builder, {{0, 0}, {10, 0}, {10, 10}, {0, 10}});
+    GPUTessellator tessellator(engine);
+    auto fills = tessellator.tessellate_fills(builder);
+
+    // A fill the GPU wrote: no CPU vertices, drawn from its own buffer
+    auto resident = std::make_shared<TessellatedPath>();
+    resident->vertexBufferId = 1;
+    resident->isUploaded = true;
+    resident->firstVertex = 6;
+    resident->triangleCount = 4;
+    ASSERT_TRUE(resident->is_gpu_resident());
+
+    VectorRenderer renderer(engine);
+    renderer.begin_batch();
+    EXPECT_TRUE(renderer.add_instance(fills[0], IDENTITY));
+    EXPECT_TRUE(renderer.add_instance(fills[1], IDENTITY));
+    EXPECT_TRUE(renderer.add_instance(resident, IDENTITY, {1.0f, 0.0f, 0.0f, 1.0f}));
+    EXPECT_FALSE(renderer.add_instance(std::make_shared<TessellatedPath>(), IDENTITY));
+    renderer.end_batch();
+
+    auto stats = renderer.get_stats();
+    EXPECT_EQ(stats.batchesRendered, 1u);
+    EXPECT_EQ(stats.drawCalls, 3u);
+    EXPECT_EQ(stats.instancesRendered, 3u);
+}
+
+TEST_F(VectorRendererTest, TessellatorResultsAreInstanced) {
+    FillCurveBuilder builder(0.25f);
+    addPolygon(builder, {{0, 0}, {20, 0}, {20, 10}, {10, 10}, {10, 20}, {0, 20}});
+    addPolygon(builder, {{0, 0}, {10, 0}, {10, 10}, {0, 10}});
+    GPUTessellator tessellator(engine);
+    auto fills = tessellator.tessellate_fills(builder);
+
+    // Every placement of one tessellation shares its instanced draw
+    VectorRenderer renderer(engine);
+    renderer.begin_batch();
+    for (float x : {0.0f, 50.0f, 100.0f}) {
+        EXPECT_TRUE(renderer.add_instance(fills[1], {1.0f, 0.0f, 0.0f, 1.0f, x, 0.0f}));
+    }
+    EXPECT_TRUE(renderer.add_instance(fills[0], IDENTITY));
+    renderer.end_batch();
+
+    auto stats = renderer.get_stats();
+    EXPECT_EQ(stats.drawCalls, 2u);
+    EXPECT_EQ(stats.instancesRendered, 4u);
+}